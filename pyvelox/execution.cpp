@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "execution.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/json.h>
+#include <pybind11/stl.h>
+#include <velox/exec/Task.h>
+#include <velox/vector/arrow/Abi.h>
+#include <velox/vector/arrow/Bridge.h>
+#include "context.h"
+
+namespace facebook::velox::py {
+
+namespace py = pybind11;
+
+namespace {
+
+folly::CPUThreadPoolExecutor* driverExecutor() {
+  static auto* executor = new folly::CPUThreadPoolExecutor(
+      std::max<size_t>(std::thread::hardware_concurrency(), 1));
+  return executor;
+}
+
+void registerSerDe() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    Type::registerSerDe();
+    common::Filter::registerSerDe();
+    core::PlanNode::registerSerDe();
+    core::ITypedExpr::registerSerDe();
+  });
+}
+
+// Owns the results of a task. The result vectors use memory of the task's
+// pools, so the arrays exported from them keep the task alive until released.
+struct TaskResults {
+  std::shared_ptr<exec::Task> task;
+  std::vector<RowVectorPtr> vectors;
+};
+
+struct ExportedArrayHolder {
+  void (*release)(ArrowArray*);
+  void* privateData;
+  std::shared_ptr<exec::Task> task;
+};
+
+void releaseExportedArray(ArrowArray* array) {
+  auto* holder = static_cast<ExportedArrayHolder*>(array->private_data);
+  array->release = holder->release;
+  array->private_data = holder->privateData;
+  array->release(array);
+  delete holder;
+}
+
+// Runs 'plan' with 'numDrivers' drivers. Called without holding the GIL.
+TaskResults runPlan(
+    const core::PlanNodePtr& plan,
+    int32_t numDrivers,
+    std::unordered_map<std::string, std::string> config) {
+  static std::atomic<int64_t> taskCounter{0};
+
+  auto queryCtx =
+      std::make_shared<core::QueryCtx>(driverExecutor(), std::move(config));
+  auto results = std::make_shared<std::vector<RowVectorPtr>>();
+  auto mutex = std::make_shared<std::mutex>();
+  auto task = exec::Task::create(
+      fmt::format("pyvelox.{}", taskCounter++),
+      core::PlanFragment{plan},
+      0,
+      std::move(queryCtx),
+      [results, mutex](RowVectorPtr vector, ContinueFuture* /*future*/) {
+        if (vector) {
+          // Loads lazy columns on the driver thread so that the results can
+          // be exported as is.
+          for (auto& child : vector->children()) {
+            child = BaseVector::loadedVectorShared(child);
+          }
+          std::lock_guard<std::mutex> l(*mutex);
+          results->push_back(std::move(vector));
+        }
+        return exec::BlockingReason::kNotBlocked;
+      });
+  exec::Task::start(task, numDrivers);
+  task->taskCompletionFuture(0).wait();
+  if (auto error = task->error()) {
+    std::rethrow_exception(error);
+  }
+  VELOX_CHECK(
+      task->isFinished(),
+      "Task {} ended in state {}",
+      task->taskId(),
+      task->state());
+  std::lock_guard<std::mutex> l(*mutex);
+  return TaskResults{std::move(task), std::move(*results)};
+}
+
+// Exports 'vector' to a pyarrow.RecordBatch that references the buffers of
+// 'vector' without copying.
+py::object toRecordBatch(
+    const RowVectorPtr& vector,
+    const std::shared_ptr<exec::Task>& task) {
+  auto* pool = PyVeloxContext::getSingletonInstance().pool();
+  auto arrowArray = std::make_unique<ArrowArray>();
+  exportToArrow(vector, *arrowArray, pool);
+  arrowArray->private_data = new ExportedArrayHolder{
+      arrowArray->release, arrowArray->private_data, task};
+  arrowArray->release = releaseExportedArray;
+
+  auto arrowSchema = std::make_unique<ArrowSchema>();
+  exportToArrow(vector, *arrowSchema);
+
+  py::module arrowModule = py::module::import("pyarrow");
+  return arrowModule.attr("RecordBatch")
+      .attr("_import_from_c")(
+          reinterpret_cast<uintptr_t>(arrowArray.get()),
+          reinterpret_cast<uintptr_t>(arrowSchema.get()));
+}
+
+} // namespace
+
+void addExecutionBindings(py::module& m, bool asModuleLocalDefinitions) {
+  m.def(
+      "execute_plan",
+      [](const std::string& plan,
+         int32_t numDrivers,
+         std::unordered_map<std::string, std::string> config) {
+        VELOX_USER_CHECK_GT(numDrivers, 0);
+        registerSerDe();
+        auto planNode = ISerializable::deserialize<core::PlanNode>(
+            folly::parseJson(plan),
+            PyVeloxContext::getSingletonInstance().pool());
+
+        TaskResults results;
+        {
+          py::gil_scoped_release release;
+          results = runPlan(planNode, numDrivers, std::move(config));
+        }
+
+        py::list batches;
+        for (const auto& vector : results.vectors) {
+          batches.append(toRecordBatch(vector, results.task));
+        }
+        return batches;
+      },
+      R"delimiter(
+        Runs a serialized plan and returns its results.
+
+        The plan runs on a process wide thread pool without holding the GIL.
+        The results are exported through the Arrow C data interface and
+        reference the memory of the Velox vectors, so converting fixed width
+        columns without nulls to NumPy with to_numpy(zero_copy_only=True)
+        copies nothing either.
+
+        Parameters
+        ----------
+        plan : str
+              JSON of a plan serialized with PlanNode::serialize().
+        num_drivers : int
+              Number of threads that run each pipeline of the plan.
+        config : Dict[str, str]
+              Query configuration, e.g. {'preferred_output_batch_rows': '4096'}.
+
+        Returns
+        -------
+        List[pyarrow.RecordBatch]
+
+        Examples
+        --------
+
+        >>> import pyvelox.pyvelox as pv
+        >>> batches = pv.execute_plan(plan_json, num_drivers=4)
+        >>> table = pyarrow.Table.from_batches(batches)
+      )delimiter",
+      py::arg("plan"),
+      py::arg("num_drivers") = 1,
+      py::arg("config") = std::unordered_map<std::string, std::string>{});
+}
+
+} // namespace facebook::velox::py
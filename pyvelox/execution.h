@@ -14,27 +14,21 @@
  * limitations under the License.
  */
 
-#include "velox/dwio/common/Common.h"
+#pragma once
 
-#include <folly/Conv.h>
+#include <pybind11/pybind11.h>
 
-namespace facebook::velox::dwio::common {
+namespace facebook::velox::py {
 
-std::string compressionKindToString(CompressionKind kind) {
-  switch (static_cast<int32_t>(kind)) {
-    case CompressionKind_NONE:
-      return "none";
-    case CompressionKind_ZLIB:
-      return "zlib";
-    case CompressionKind_SNAPPY:
-      return "snappy";
-    case CompressionKind_LZO:
-      return "lzo";
-    case CompressionKind_ZSTD:
-      return "zstd";
-    case CompressionKind_LZ4:
-      return "lz4";
-  }
-  return folly::to<std::string>("unknown - ", kind);
-}
-} // namespace facebook::velox::dwio::common
+namespace py = pybind11;
+
+/// Adds bindings for executing serialized plans to module m.
+///
+/// @param m Module to add bindings to.
+/// @param asModuleLocalDefinitions If true then these bindings are only
+///  visible inside the module. Refer to
+///  https://pybind11.readthedocs.io/en/stable/advanced/classes.html#module-local-class-bindings
+///  for further details.
+void addExecutionBindings(py::module& m, bool asModuleLocalDefinitions = true);
+
+} // namespace facebook::velox::py
@@ -0,0 +1,78 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import base64
+import json
+import shutil
+import tempfile
+import unittest
+from os import path
+
+import pyarrow as pa
+import pyvelox.pyvelox as pv
+
+
+class TestPlanExecution(unittest.TestCase):
+    def setUp(self):
+        self.test_dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.test_dir)
+
+    def make_values_plan(self, num_rows, parallelizable):
+        struct = pa.StructArray.from_arrays(
+            [
+                pa.array(range(num_rows), type=pa.int64()),
+                pa.array([float(i) / 2 for i in range(num_rows)]),
+            ],
+            names=["a", "b"],
+        )
+        file_path = path.join(self.test_dir, "values.bin")
+        pv.save_vector(pv.import_from_arrow(struct), file_path)
+        with open(file_path, "rb") as f:
+            data = base64.b64encode(f.read()).decode("ascii")
+        return json.dumps(
+            {
+                "name": "ValuesNode",
+                "id": "0",
+                "data": data,
+                "parallelizable": parallelizable,
+                "repeatTimes": 1,
+            }
+        )
+
+    def test_execute_values(self):
+        batches = pv.execute_plan(self.make_values_plan(100, False))
+        table = pa.Table.from_batches(batches)
+        self.assertEqual(table.num_rows, 100)
+        self.assertEqual(table.column_names, ["a", "b"])
+        self.assertListEqual(table.column("a").to_pylist(), list(range(100)))
+
+        # Fixed width columns without nulls convert to NumPy without copies.
+        values = batches[0].column(0).to_numpy(zero_copy_only=True)
+        self.assertEqual(values[99], 99)
+
+    def test_multiple_drivers(self):
+        num_drivers = 4
+        batches = pv.execute_plan(
+            self.make_values_plan(10, True), num_drivers=num_drivers
+        )
+        table = pa.Table.from_batches(batches)
+        # Each driver produces all rows of a parallelizable ValuesNode.
+        self.assertEqual(table.num_rows, 10 * num_drivers)
+        self.assertEqual(sum(table.column("a").to_pylist()), 45 * num_drivers)
+
+    def test_invalid_num_drivers(self):
+        with self.assertRaises(Exception):
+            pv.execute_plan(self.make_values_plan(10, False), num_drivers=0)
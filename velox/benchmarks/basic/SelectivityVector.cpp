@@ -19,6 +19,8 @@
 
 #include <gflags/gflags.h>
 
+#include "velox/common/base/RawVector.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
@@ -41,7 +43,9 @@ class SelectivityVectorBenchmark
         rows99PerCent_(vectorSize),
         rows50PerCent_(vectorSize),
         rows10PerCent_(vectorSize),
-        rows1PerCent_(vectorSize) {
+        rows1PerCent_(vectorSize),
+        rowsDenseRuns_(vectorSize),
+        indices_(vectorSize) {
     VectorFuzzer::Options opts;
     opts.vectorSize = vectorSize_;
     opts.nullRatio = 0;
@@ -70,11 +74,17 @@ class SelectivityVectorBenchmark
       }
     }
 
+    // Runs of 1000 selected rows separated by 24 unselected ones.
+    for (size_t i = 0; i < vectorSize_; ++i) {
+      rowsDenseRuns_.setValid(i, i % 1024 < 1000);
+    }
+
     rowsAll_.updateBounds();
     rows99PerCent_.updateBounds();
     rows50PerCent_.updateBounds();
     rows10PerCent_.updateBounds();
     rows1PerCent_.updateBounds();
+    rowsDenseRuns_.updateBounds();
   }
 
   size_t runBaseline() {
@@ -108,6 +118,54 @@ class SelectivityVectorBenchmark
     return run(rows99PerCent_);
   }
 
+  size_t runSelectivityDenseRuns() {
+    return run(rowsDenseRuns_);
+  }
+
+  const SelectivityVector& rows(int32_t percent) const {
+    switch (percent) {
+      case 100:
+        return rowsAll_;
+      case 99:
+        return rows99PerCent_;
+      case 50:
+        return rows50PerCent_;
+      case 10:
+        return rows10PerCent_;
+      case 1:
+        return rows1PerCent_;
+      default:
+        return rowsDenseRuns_;
+    }
+  }
+
+  // Sums the selected values with a plain loop over each run of selected
+  // rows.
+  size_t runRanges(const SelectivityVector& rows) {
+    const int64_t* flatBuffer = flatVector_->values()->as<int64_t>();
+    size_t sum = 0;
+    rows.applyToSelectedRanges([&](auto begin, auto end) {
+      for (auto row = begin; row < end; ++row) {
+        sum += flatBuffer[row];
+      }
+    });
+    folly::doNotOptimizeAway(sum);
+    return vectorSize_;
+  }
+
+  // Sums the selected values after extracting the selected row numbers.
+  size_t runIndices(const SelectivityVector& rows) {
+    const int64_t* flatBuffer = flatVector_->values()->as<int64_t>();
+    const auto numIndices = simd::indicesOfSetBits(
+        rows.asRange().bits(), rows.begin(), rows.end(), indices_.data());
+    size_t sum = 0;
+    for (auto i = 0; i < numIndices; ++i) {
+      sum += flatBuffer[indices_[i]];
+    }
+    folly::doNotOptimizeAway(sum);
+    return vectorSize_;
+  }
+
  private:
   size_t run(const SelectivityVector& rows) {
     const int64_t* flatBuffer = flatVector_->values()->as<int64_t>();
@@ -126,6 +184,8 @@ class SelectivityVectorBenchmark
   SelectivityVector rows50PerCent_;
   SelectivityVector rows10PerCent_;
   SelectivityVector rows1PerCent_;
+  SelectivityVector rowsDenseRuns_;
+  raw_vector<int32_t> indices_;
 };
 
 std::unique_ptr<SelectivityVectorBenchmark> benchmark;
@@ -161,6 +221,27 @@ BENCHMARK(sumSelectivity1PerCent) {
   run([] { benchmark->runSelectivity1PerCent(); });
 }
 
+BENCHMARK(sumSelectivityDenseRuns) {
+  run([] { benchmark->runSelectivityDenseRuns(); });
+}
+
+BENCHMARK_DRAW_LINE();
+
+#define RANGES_AND_INDICES_BENCHMARKS(name, percent)                \
+  BENCHMARK(sumRanges##name) {                                      \
+    run([] { benchmark->runRanges(benchmark->rows(percent)); });    \
+  }                                                                 \
+  BENCHMARK(sumIndices##name) {                                     \
+    run([] { benchmark->runIndices(benchmark->rows(percent)); });   \
+  }
+
+RANGES_AND_INDICES_BENCHMARKS(All, 100)
+RANGES_AND_INDICES_BENCHMARKS(99PerCent, 99)
+RANGES_AND_INDICES_BENCHMARKS(50PerCent, 50)
+RANGES_AND_INDICES_BENCHMARKS(10PerCent, 10)
+RANGES_AND_INDICES_BENCHMARKS(1PerCent, 1)
+RANGES_AND_INDICES_BENCHMARKS(DenseRuns, 0)
+
 } // namespace
 
 int main(int argc, char* argv[]) {
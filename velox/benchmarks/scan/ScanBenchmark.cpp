@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/file/FileSystems.h"
+#include "velox/connectors/hive/HiveConnector.h"
+#include "velox/dwio/common/tests/utils/DataSetBuilder.h"
+#include "velox/dwio/common/tests/utils/FilterGenerator.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/dwio/parquet/RegisterParquetReader.h"
+#include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+DEFINE_int32(num_batches, 20, "Number of batches in each file");
+DEFINE_int32(batch_size, 10'000, "Number of rows in each batch");
+DEFINE_int32(num_drivers, 1, "Number of drivers of the TableScan");
+DEFINE_int32(num_splits_per_file, 1, "Number of splits of each file");
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+// Scans files of one column with TableScan through the Hive connector and
+// compares the DWRF reader with the native and DuckDB Parquet readers. The
+// matrix covers the column type, dictionary or plain encoding, the null ratio
+// and the selectivity of a filter on the column, which TableScan pushes into
+// the ScanSpec of the reader. The files of a data set are written once and
+// scanned by all the benchmarks of the data set. Consecutive benchmarks of a
+// data set check that the readers return the same number of rows.
+
+namespace {
+
+enum class ScanReader { kDwrf, kNativeParquet, kDuckDbParquet };
+
+const char* readerName(ScanReader reader) {
+  switch (reader) {
+    case ScanReader::kDwrf:
+      return "dwrf";
+    case ScanReader::kNativeParquet:
+      return "nativeParquet";
+    case ScanReader::kDuckDbParquet:
+      return "duckDbParquet";
+  }
+  VELOX_UNREACHABLE();
+}
+
+struct ColumnSpec {
+  std::string name;
+  TypePtr type;
+  // The subfield the filters and the value distributions apply to. Empty if
+  // the column is not filtered.
+  std::string filterField;
+  bool isNested;
+};
+
+struct DataSetSpec {
+  const ColumnSpec* column;
+  // If true, the filtered field has 1000 distinct values and the writers use
+  // dictionaries. Otherwise the values are random and the writers don't use
+  // dictionaries.
+  bool dictionary;
+  uint8_t nullPct;
+
+  std::string toString() const {
+    return fmt::format(
+        "{}_{}_nulls{}",
+        column->name,
+        dictionary ? "dict" : "plain",
+        nullPct);
+  }
+};
+
+class ScanBenchmark {
+ public:
+  ScanBenchmark() {
+    filesystems::registerLocalFileSystem();
+    dwrf::registerDwrfReaderFactory();
+    parquet::registerParquetReaderFactory(parquet::ParquetReaderType::NATIVE);
+    ioExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(8);
+    executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        std::thread::hardware_concurrency());
+    auto hiveConnector =
+        connector::getConnectorFactory(
+            connector::hive::HiveConnectorFactory::kHiveConnectorName)
+            ->newConnector(kHiveConnectorId, nullptr, ioExecutor_.get());
+    connector::registerConnector(hiveConnector);
+  }
+
+  ~ScanBenchmark() {
+    connector::unregisterConnector(kHiveConnectorId);
+    parquet::unregisterParquetReaderFactory();
+    dwrf::unregisterDwrfReaderFactory();
+  }
+
+  // Writes the DWRF and Parquet files of 'spec' unless they are the files of
+  // the previous benchmark.
+  void prepare(const DataSetSpec& spec) {
+    const auto name = spec.toString();
+    if (name == dataSetName_) {
+      return;
+    }
+    dataSetName_ = name;
+    numRowsBySelectPct_.clear();
+    filtersBySelectPct_.clear();
+    rowType_ = ROW({"c0"}, {spec.column->type});
+    filterField_ = spec.column->filterField;
+    DataSetBuilder builder(*pool_, 0);
+    builder.makeDataset(rowType_, FLAGS_num_batches, FLAGS_batch_size);
+    if (spec.dictionary) {
+      makeLowCardinality(builder, *spec.column);
+    }
+    builder.withNullsForField(common::Subfield("c0"), spec.nullPct);
+    batches_ = builder.build();
+    writeDwrf(spec.dictionary);
+    writeParquet(spec.dictionary);
+  }
+
+  // Scans the files of the prepared data set with 'reader' with a filter that
+  // passes 'selectPct' percent of the rows.
+  void scan(ScanReader reader, int32_t selectPct) {
+    folly::BenchmarkSuspender suspender;
+    setParquetReader(reader);
+    auto filters = makeFilters(selectPct);
+    core::PlanNodeId scanId;
+    auto plan = PlanBuilder()
+                    .tableScan(
+                        rowType_,
+                        HiveConnectorTestBase::makeTableHandle(
+                            std::move(filters)),
+                        HiveConnectorTestBase::allRegularColumns(rowType_))
+                    .capturePlanNodeId(scanId)
+                    .planNode();
+    CursorParameters params;
+    params.planNode = plan;
+    params.maxDrivers = FLAGS_num_drivers;
+    params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    const auto format = reader == ScanReader::kDwrf ? FileFormat::DWRF
+                                                    : FileFormat::PARQUET;
+    const auto& path =
+        reader == ScanReader::kDwrf ? dwrfFile_->path : parquetFile_->path;
+    suspender.dismiss();
+
+    TaskCursor cursor(params);
+    cursor.start();
+    for (const auto& split : HiveConnectorTestBase::makeHiveConnectorSplits(
+             path, FLAGS_num_splits_per_file, format)) {
+      cursor.task()->addSplit(scanId, Split(split));
+    }
+    cursor.task()->noMoreSplits(scanId);
+    int64_t numRows = 0;
+    while (cursor.moveNext()) {
+      auto& result = cursor.current();
+      for (auto& child : result->children()) {
+        child->loadedVector();
+      }
+      numRows += result->size();
+    }
+
+    suspender.rehire();
+    auto it = numRowsBySelectPct_.find(selectPct);
+    if (it == numRowsBySelectPct_.end()) {
+      numRowsBySelectPct_[selectPct] = numRows;
+    } else {
+      VELOX_CHECK_EQ(
+          it->second,
+          numRows,
+          "Row count mismatch of {} at {}% selected in {}",
+          readerName(reader),
+          selectPct,
+          dataSetName_);
+    }
+  }
+
+ private:
+  static void makeLowCardinality(
+      DataSetBuilder& builder,
+      const ColumnSpec& column) {
+    if (column.filterField.empty()) {
+      return;
+    }
+    const common::Subfield field(column.filterField);
+    auto type = column.type;
+    if (column.isNested) {
+      type = type->childAt(0);
+    }
+    switch (type->kind()) {
+      case TypeKind::BIGINT:
+        builder.withIntDistributionForField<int64_t>(
+            field, 0, 1'000, 0, 0, 0, 0, true);
+        break;
+      case TypeKind::DOUBLE:
+        builder.withQuantizedFloatForField<double>(field, 1'000, true);
+        break;
+      case TypeKind::VARCHAR:
+        builder.withStringDistributionForField(field, 1'000, true, false);
+        break;
+      default:
+        VELOX_UNSUPPORTED("Unsupported filter type {}", type->toString());
+    }
+  }
+
+  void writeDwrf(bool dictionary) {
+    dwrfFile_ = TempFilePath::create();
+    auto config = std::make_shared<dwrf::Config>();
+    const float threshold = dictionary ? 1.0 : 0.0;
+    config->set(dwrf::Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD, threshold);
+    config->set(dwrf::Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, threshold);
+    dwrf::WriterOptions options;
+    options.config = config;
+    options.schema = rowType_;
+    auto writerPool = rootPool_->addAggregateChild("ScanBenchmark.dwrf");
+    options.memoryPool = writerPool.get();
+    dwrf::Writer writer(
+        std::make_unique<LocalFileSink>(dwrfFile_->path), options);
+    for (const auto& batch : *batches_) {
+      writer.write(batch);
+    }
+    writer.close();
+  }
+
+  void writeParquet(bool dictionary) {
+    parquetFile_ = TempFilePath::create();
+    parquet::WriterOptions options;
+    options.enableDictionary = dictionary;
+    options.memoryPool = pool_.get();
+    parquet::Writer writer(
+        std::make_unique<LocalFileSink>(parquetFile_->path), options);
+    for (const auto& batch : *batches_) {
+      writer.write(batch);
+    }
+    writer.close();
+  }
+
+  // Makes the filter with the range of values that passes 'selectPct' of the
+  // rows. 100 makes no filter.
+  SubfieldFilters makeFilters(int32_t selectPct) {
+    if (selectPct == 100) {
+      return {};
+    }
+    auto it = filtersBySelectPct_.find(selectPct);
+    if (it == filtersBySelectPct_.end()) {
+      const auto values = getChildBySubfield(
+          batches_->front().get(), common::Subfield(filterField_), rowType_);
+      const auto kind = filterKind(values->type());
+      std::vector<FilterSpec> specs;
+      specs.emplace_back(filterField_, 0, selectPct, kind, false, false);
+      FilterGenerator generator(rowType_, 0);
+      std::vector<uint64_t> hitRows;
+      it = filtersBySelectPct_
+               .emplace(
+                   selectPct,
+                   generator.makeSubfieldFilters(
+                       specs, *batches_, nullptr, hitRows))
+               .first;
+    }
+    return FilterGenerator::cloneSubfieldFilters(it->second);
+  }
+
+  static FilterKind filterKind(const TypePtr& type) {
+    switch (type->kind()) {
+      case TypeKind::BIGINT:
+        return FilterKind::kBigintRange;
+      case TypeKind::DOUBLE:
+        return FilterKind::kDoubleRange;
+      case TypeKind::VARCHAR:
+        return FilterKind::kBytesRange;
+      default:
+        VELOX_UNSUPPORTED("Unsupported filter type {}", type->toString());
+    }
+  }
+
+  // Registers the Parquet reader of 'reader' as the reader of Parquet files.
+  void setParquetReader(ScanReader reader) {
+    if (reader == ScanReader::kDwrf || reader == parquetReader_) {
+      return;
+    }
+    parquet::unregisterParquetReaderFactory();
+    parquet::registerParquetReaderFactory(
+        reader == ScanReader::kNativeParquet
+            ? parquet::ParquetReaderType::NATIVE
+            : parquet::ParquetReaderType::DUCKDB);
+    parquetReader_ = reader;
+  }
+
+  std::shared_ptr<memory::MemoryPool> rootPool_{
+      memory::defaultMemoryManager().addRootPool("ScanBenchmark")};
+  std::shared_ptr<memory::MemoryPool> pool_{
+      rootPool_->addLeafChild("ScanBenchmark.data")};
+  std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  ScanReader parquetReader_{ScanReader::kNativeParquet};
+
+  std::string dataSetName_;
+  std::string filterField_;
+  RowTypePtr rowType_;
+  std::unique_ptr<std::vector<RowVectorPtr>> batches_;
+  std::shared_ptr<TempFilePath> dwrfFile_;
+  std::shared_ptr<TempFilePath> parquetFile_;
+  std::unordered_map<int32_t, SubfieldFilters> filtersBySelectPct_;
+  // The number of rows of the first scan of the data set by selectivity.
+  std::unordered_map<int32_t, int64_t> numRowsBySelectPct_;
+};
+
+std::unique_ptr<ScanBenchmark> benchmark;
+
+const std::vector<ColumnSpec>& columnSpecs() {
+  static const std::vector<ColumnSpec> specs = {
+      {"bigint", BIGINT(), "c0", false},
+      {"double", DOUBLE(), "c0", false},
+      {"varchar", VARCHAR(), "c0", false},
+      {"struct", ROW({"a", "b"}, {BIGINT(), VARCHAR()}), "c0.a", true},
+      {"array", ARRAY(BIGINT()), "", true},
+      {"map", MAP(BIGINT(), BIGINT()), "", true},
+  };
+  return specs;
+}
+
+void registerBenchmarks() {
+  for (const auto& column : columnSpecs()) {
+    for (auto dictionary : {true, false}) {
+      for (uint8_t nullPct : {0, 20, 50}) {
+        const DataSetSpec spec{&column, dictionary, nullPct};
+        std::vector<int32_t> selectPcts = {100};
+        if (!column.filterField.empty()) {
+          selectPcts = {100, 50, 10, 1};
+        }
+        for (auto selectPct : selectPcts) {
+          for (auto reader :
+               {ScanReader::kDwrf,
+                ScanReader::kNativeParquet,
+                ScanReader::kDuckDbParquet}) {
+            // The DuckDB reader is compared on flat columns only.
+            if (column.isNested && reader == ScanReader::kDuckDbParquet) {
+              continue;
+            }
+            folly::addBenchmark(
+                __FILE__,
+                fmt::format(
+                    "{}_select{}_{}",
+                    spec.toString(),
+                    selectPct,
+                    readerName(reader)),
+                [spec, selectPct, reader]() -> unsigned {
+                  {
+                    folly::BenchmarkSuspender suspender;
+                    benchmark->prepare(spec);
+                  }
+                  benchmark->scan(reader, selectPct);
+                  return 1;
+                });
+          }
+        }
+        folly::addBenchmark(__FILE__, "-", []() -> unsigned { return 0; });
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<ScanBenchmark>();
+  registerBenchmarks();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
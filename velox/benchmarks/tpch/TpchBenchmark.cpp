@@ -19,22 +19,31 @@
 #include <sys/time.h>
 
 #include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/String.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fstream>
 
+#include "velox/common/base/Fs.h"
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/tpch/TpchConnector.h"
+#include "velox/connectors/tpch/TpchConnectorSplit.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
 #include "velox/dwio/parquet/RegisterParquetReader.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Split.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TpchQueryBuilder.h"
 #include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
@@ -46,6 +55,12 @@ using namespace facebook::velox::exec::test;
 using namespace facebook::velox::dwio::common;
 
 namespace {
+const std::string kTpchConnectorId = "test-tpch";
+
+// The TPC-H queries that TpchQueryBuilder has plans for.
+const std::vector<int32_t> kQueryIds = {
+    1, 3, 5, 6, 7, 8, 9, 10, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22};
+
 static bool notEmpty(const char* /*flagName*/, const std::string& value) {
   return !value.empty();
 }
@@ -164,6 +179,39 @@ DEFINE_bool(
     "Runs one warmup of the query before "
     "measured run. Use to run warm after clearing caches.");
 
+DEFINE_double(
+    scale_factor,
+    0,
+    "If > 0, generates the TPC-H tables at this scale factor with the tpch "
+    "connector into --data_path. Tables that already have files there are "
+    "not generated again. The tables are written in DWRF with dates as "
+    "strings, so --data_format must be dwrf");
+
+DEFINE_bool(spill, false, "Enables spilling of aggregations, joins and sorts");
+DEFINE_string(
+    spill_path,
+    "",
+    "Directory for spill files with --spill. A temporary directory if empty");
+DEFINE_int64(
+    spill_memory_threshold_mb,
+    0,
+    "If > 0, aggregations, joins and sorts spill when their memory exceeds "
+    "this. Makes --spill spill without memory pressure");
+
+DEFINE_string(
+    queries,
+    "",
+    "Comma separated TPC-H query numbers to run with --result_json. All "
+    "queries if empty");
+DEFINE_string(
+    result_json,
+    "",
+    "If set, runs each of --queries --num_repeats times and writes the "
+    "timings and stats of each run with the benchmark flags as JSON to this "
+    "file. The JSON of runs with different --result_label, e.g. the commit, "
+    "can be compared");
+DEFINE_string(result_label, "", "Label of the run in --result_json");
+
 DEFINE_validator(data_path, &notEmpty);
 DEFINE_validator(data_format, &validateDataFormat);
 
@@ -245,16 +293,119 @@ class TpchBenchmark {
             connector::hive::HiveConnectorFactory::kHiveConnectorName)
             ->newConnector(kHiveConnectorId, nullptr, ioExecutor_.get());
     connector::registerConnector(hiveConnector);
+    auto tpchConnector =
+        connector::getConnectorFactory(
+            connector::tpch::TpchConnectorFactory::kTpchConnectorName)
+            ->newConnector(kTpchConnectorId, nullptr);
+    connector::registerConnector(tpchConnector);
+
+    queryExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        std::thread::hardware_concurrency());
+    if (FLAGS_spill) {
+      if (FLAGS_spill_path.empty()) {
+        spillTempDirectory_ = TempDirectoryPath::create();
+        spillDirectory_ = spillTempDirectory_->path;
+      } else {
+        spillDirectory_ = FLAGS_spill_path;
+      }
+    }
+  }
+
+  std::shared_ptr<core::QueryCtx> makeQueryCtx() {
+    std::unordered_map<std::string, std::string> config;
+    if (FLAGS_spill) {
+      config[core::QueryConfig::kSpillEnabled] = "true";
+      if (FLAGS_spill_memory_threshold_mb > 0) {
+        const auto threshold =
+            std::to_string(FLAGS_spill_memory_threshold_mb << 20);
+        config[core::QueryConfig::kAggregationSpillMemoryThreshold] =
+            threshold;
+        config[core::QueryConfig::kJoinSpillMemoryThreshold] = threshold;
+        config[core::QueryConfig::kOrderBySpillMemoryThreshold] = threshold;
+      }
+    }
+    return std::make_shared<core::QueryCtx>(
+        queryExecutor_.get(), std::move(config));
+  }
+
+  // Writes the TPC-H tables at --scale_factor to --data_path. Each Driver
+  // generates a part of a table with the tpch connector and writes it to a
+  // file.
+  void generateTpchData() {
+    VELOX_USER_CHECK_EQ(
+        FLAGS_data_format,
+        "dwrf",
+        "Generated TPC-H data is written in DWRF");
+    dwrf::registerDwrfWriterFactory();
+    for (const auto& tableName : TpchQueryBuilder::getTableNames()) {
+      const auto tablePath = fmt::format("{}/{}", FLAGS_data_path, tableName);
+      if (fs::exists(tablePath) && !fs::is_empty(tablePath)) {
+        LOG(INFO) << "Using existing data of " << tableName;
+        continue;
+      }
+      fs::create_directories(tablePath);
+      generateTable(tpch::fromTableName(tableName), tablePath);
+    }
+  }
+
+  void generateTable(tpch::Table table, const std::string& tablePath) {
+    const auto schema = tpch::getTableSchema(table);
+    std::vector<std::string> projections;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < schema->size(); ++i) {
+      const auto& name = schema->nameOf(i);
+      if (schema->childAt(i)->kind() == TypeKind::DATE) {
+        // DWRF does not support dates, see TpchQueryBuilder.
+        projections.push_back(
+            fmt::format("cast({} as varchar) as {}", name, name));
+        types.push_back(VARCHAR());
+      } else {
+        projections.push_back(name);
+        types.push_back(schema->childAt(i));
+      }
+    }
+    auto insertHandle = std::make_shared<core::InsertTableHandle>(
+        kHiveConnectorId,
+        HiveConnectorTestBase::makeHiveInsertTableHandle(
+            schema->names(),
+            types,
+            {},
+            HiveConnectorTestBase::makeLocationHandle(tablePath)));
+    auto names = schema->names();
+    auto plan = PlanBuilder()
+                    .tableScan(table, std::move(names), FLAGS_scale_factor)
+                    .project(projections)
+                    .tableWrite(schema->names(), insertHandle)
+                    .planNode();
+    std::vector<exec::Split> splits;
+    for (auto i = 0; i < FLAGS_num_drivers; ++i) {
+      splits.push_back(exec::Split(
+          std::make_shared<connector::tpch::TpchConnectorSplit>(
+              kTpchConnectorId, FLAGS_num_drivers, i)));
+    }
+    uint64_t micros = 0;
+    {
+      MicrosecondTimer timer(&micros);
+      AssertQueryBuilder(plan)
+          .maxDrivers(FLAGS_num_drivers)
+          .splits(std::move(splits))
+          .copyResults(pool_.get());
+    }
+    LOG(INFO) << "Generated " << tpch::toTableName(table) << " at scale factor "
+              << FLAGS_scale_factor << " in " << succinctMicros(micros);
   }
 
   std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
-      const TpchPlan& tpchPlan) {
+      const TpchPlan& tpchPlan,
+      int32_t numRepeats = FLAGS_num_repeats) {
     int32_t repeat = 0;
     try {
       for (;;) {
         CursorParameters params;
         params.maxDrivers = FLAGS_num_drivers;
         params.planNode = tpchPlan.plan;
+        params.queryCtx = makeQueryCtx();
+        params.spillDirectory = spillDirectory_;
         const int numSplitsPerFile = FLAGS_num_splits_per_file;
 
         bool noMoreSplits = false;
@@ -276,7 +427,7 @@ class TpchBenchmark {
         };
         auto result = readCursor(params, addSplits);
         ensureTaskCompletion(result.first->task().get());
-        if (++repeat >= FLAGS_num_repeats) {
+        if (++repeat >= numRepeats) {
           return result;
         }
       }
@@ -329,6 +480,82 @@ class TpchBenchmark {
     }
   }
 
+  // Runs --queries and writes the stats of each run to --result_json.
+  void runToJson() {
+    std::vector<int32_t> queryIds;
+    if (FLAGS_queries.empty()) {
+      queryIds = kQueryIds;
+    } else {
+      std::vector<std::string> ids;
+      folly::split(',', FLAGS_queries, ids);
+      for (const auto& id : ids) {
+        queryIds.push_back(folly::to<int32_t>(id));
+      }
+    }
+
+    folly::dynamic queries = folly::dynamic::array;
+    for (auto queryId : queryIds) {
+      const auto tpchPlan = queryBuilder->getQueryPlan(queryId);
+      folly::dynamic runs = folly::dynamic::array;
+      for (auto i = 0; i < FLAGS_num_repeats; ++i) {
+        runs.push_back(runQueryToJson(tpchPlan));
+      }
+      queries.push_back(
+          folly::dynamic::object("query", queryId)("runs", std::move(runs)));
+    }
+
+    folly::dynamic result = folly::dynamic::object;
+    result["label"] = FLAGS_result_label;
+    result["dataFormat"] = FLAGS_data_format;
+    result["scaleFactor"] = FLAGS_scale_factor;
+    result["numDrivers"] = FLAGS_num_drivers;
+    result["numSplitsPerFile"] = FLAGS_num_splits_per_file;
+    result["spill"] = FLAGS_spill;
+    result["spillMemoryThresholdMb"] = FLAGS_spill_memory_threshold_mb;
+    result["cacheGb"] = FLAGS_cache_gb;
+    result["ssdCacheGb"] = FLAGS_ssd_cache_gb;
+    result["queries"] = std::move(queries);
+    std::ofstream out(FLAGS_result_json);
+    out << folly::toPrettyJson(result) << std::endl;
+    VELOX_CHECK(out.good(), "Failed to write {}", FLAGS_result_json);
+  }
+
+  folly::dynamic runQueryToJson(const TpchPlan& tpchPlan) {
+    uint64_t micros = 0;
+    std::shared_ptr<Task> task;
+    {
+      MicrosecondTimer timer(&micros);
+      auto [cursor, results] = run(tpchPlan, 1);
+      if (cursor == nullptr) {
+        return folly::dynamic::object("error", true);
+      }
+      task = cursor->task();
+    }
+    const auto stats = task->taskStats();
+    uint64_t cpuNanos = 0;
+    uint64_t rawInputBytes = 0;
+    uint64_t spilledBytes = 0;
+    for (const auto& pipeline : stats.pipelineStats) {
+      for (const auto& op : pipeline.operatorStats) {
+        cpuNanos += op.addInputTiming.cpuNanos + op.getOutputTiming.cpuNanos +
+            op.finishTiming.cpuNanos;
+        if (op.operatorType == "TableScan") {
+          rawInputBytes += op.rawInputBytes;
+        }
+        spilledBytes += op.spilledBytes;
+      }
+    }
+    folly::dynamic run = folly::dynamic::object;
+    run["wallMicros"] = micros;
+    run["executionMillis"] =
+        stats.executionEndTimeMs - stats.executionStartTimeMs;
+    run["cpuNanos"] = cpuNanos;
+    run["rawInputBytes"] = rawInputBytes;
+    run["peakMemoryBytes"] = task->pool()->peakBytes();
+    run["spilledBytes"] = spilledBytes;
+    return run;
+  }
+
   void readCombinations() {
     std::ifstream file(FLAGS_test_flags_file);
     std::string line;
@@ -447,7 +674,14 @@ class TpchBenchmark {
 
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
   std::unique_ptr<folly::IOThreadPoolExecutor> cacheExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> queryExecutor_;
   std::shared_ptr<memory::MemoryAllocator> allocator_;
+  std::shared_ptr<memory::MemoryPool> pool_ =
+      memory::addDefaultLeafMemoryPool();
+
+  // Set with --spill.
+  std::shared_ptr<TempDirectoryPath> spillTempDirectory_;
+  std::string spillDirectory_;
 
   // Parameter combinations to try. Each element specifies a flag and possible
   // values. All permutations are tried.
@@ -555,10 +789,15 @@ BENCHMARK(q22) {
 
 int tpchBenchmarkMain() {
   benchmark.initialize();
+  if (FLAGS_scale_factor > 0) {
+    benchmark.generateTpchData();
+  }
   queryBuilder =
       std::make_shared<TpchQueryBuilder>(toFileFormat(FLAGS_data_format));
   queryBuilder->initialize(FLAGS_data_path);
-  if (FLAGS_test_flags_file.empty()) {
+  if (!FLAGS_result_json.empty()) {
+    benchmark.runToJson();
+  } else if (FLAGS_test_flags_file.empty()) {
     RunStats ignore;
     benchmark.runMain(std::cout, ignore);
   } else {
@@ -438,6 +438,46 @@ forEachSetBit(const uint64_t* bits, int32_t begin, int32_t end, Callable func) {
   forEachBit(bits, begin, end, true, func);
 }
 
+/// Invokes a function for each maximal run of consecutive set bits. The
+/// function takes the first bit of the run and the bit after its last bit.
+/// Lets callers use plain loops over dense selections.
+template <typename Callable>
+void forEachSetRange(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    Callable func) {
+  // First bit of a run that continues past the current word, -1 if none.
+  int32_t runBegin = -1;
+  forEachWord(begin, end, [&](int32_t idx, uint64_t mask) {
+    uint64_t word = bits[idx] & mask;
+    const int32_t wordBegin = idx * 64;
+    if (runBegin >= 0) {
+      if (word == ~0ULL) {
+        return;
+      }
+      const auto runEnd = __builtin_ctzll(~word);
+      func(runBegin, wordBegin + runEnd);
+      runBegin = -1;
+      word &= ~0ULL << runEnd;
+    }
+    while (word) {
+      const auto first = __builtin_ctzll(word);
+      const uint64_t unset = ~word & (~0ULL << first);
+      if (!unset) {
+        runBegin = wordBegin + first;
+        return;
+      }
+      const auto last = __builtin_ctzll(unset);
+      func(wordBegin + first, wordBegin + last);
+      word &= ~0ULL << last;
+    }
+  });
+  if (runBegin >= 0) {
+    func(runBegin, end);
+  }
+}
+
 /// Invokes a function for each unset bit.
 template <typename Callable>
 inline void forEachUnsetBit(
@@ -47,6 +47,16 @@ class SelectivityInfo {
     return numOut_;
   }
 
+  uint64_t timeClocks() const {
+    return timeClocks_;
+  }
+
+  void add(const SelectivityInfo& other) {
+    numIn_ += other.numIn_;
+    numOut_ += other.numOut_;
+    timeClocks_ += other.timeClocks_;
+  }
+
  private:
   uint64_t numIn_ = 0;
   uint64_t numOut_ = 0;
@@ -164,6 +164,36 @@ struct BitMask<T, A, 8> {
   }
 };
 
+#if XSIMD_WITH_AVX512F
+// Writes the positions of the set bits of 'word' plus 'row' to 'result' and
+// returns the end of the written positions. Compress stores write exactly the
+// selected lanes, so this does not write past the last position.
+inline int32_t* indicesOfSetBitsAvx512(
+    uint64_t word,
+    int32_t row,
+    int32_t* result) {
+  if (__builtin_popcountll(word) <= 4) {
+    // Few bits are faster to find one by one.
+    do {
+      *result++ = __builtin_ctzll(word) + row;
+      word &= word - 1;
+    } while (word);
+    return result;
+  }
+  const auto iota =
+      _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  for (auto i = 0; i < 64; i += 16) {
+    const __mmask16 mask = word >> i;
+    if (mask) {
+      _mm512_mask_compressstoreu_epi32(
+          result, mask, _mm512_add_epi32(iota, _mm512_set1_epi32(row + i)));
+      result += __builtin_popcount(mask);
+    }
+  }
+  return result;
+}
+#endif
+
 } // namespace detail
 
 template <typename A>
@@ -202,7 +232,12 @@ int32_t indicesOfSetBits(
         }
       }
     }
-    if (result - originalResult < (row >> 2)) {
+    if constexpr (xsimd::batch<int32_t, A>::size == 16) {
+#if XSIMD_WITH_AVX512F
+      result = detail::indicesOfSetBitsAvx512(word, row, result);
+#endif
+      row += 64;
+    } else if (result - originalResult < (row >> 2)) {
       do {
         *result++ = __builtin_ctzll(word) + row;
         word = word & (word - 1);
@@ -1248,6 +1283,107 @@ struct ReinterpretBatch<int64_t, uint64_t, A> {
 
 } // namespace detail
 
+template <typename T, typename Op, typename A>
+void transform(
+    const T* left,
+    const T* right,
+    T* result,
+    int32_t size,
+    Op op,
+    const A&) {
+  constexpr int32_t kBatchSize = xsimd::batch<T, A>::size;
+  int32_t i = 0;
+  for (; i + kBatchSize <= size; i += kBatchSize) {
+    op(xsimd::batch<T, A>::load_unaligned(left + i),
+       xsimd::batch<T, A>::load_unaligned(right + i))
+        .store_unaligned(result + i);
+  }
+  for (; i < size; ++i) {
+    result[i] = op(left[i], right[i]);
+  }
+}
+
+template <typename T, typename Op, typename A>
+void transformUnary(
+    const T* input,
+    T* result,
+    int32_t size,
+    Op op,
+    const A&) {
+  constexpr int32_t kBatchSize = xsimd::batch<T, A>::size;
+  int32_t i = 0;
+  for (; i + kBatchSize <= size; i += kBatchSize) {
+    op(xsimd::batch<T, A>::load_unaligned(input + i))
+        .store_unaligned(result + i);
+  }
+  for (; i < size; ++i) {
+    result[i] = op(input[i]);
+  }
+}
+
+template <typename A>
+size_t findSubstring(
+    const char* text,
+    size_t size,
+    const char* needle,
+    size_t needleSize,
+    const A& arch) {
+  if (needleSize == 0) {
+    return 0;
+  }
+  if (needleSize > size) {
+    return std::string_view::npos;
+  }
+  using Batch = xsimd::batch<uint8_t, A>;
+  const auto first = Batch::broadcast(needle[0]);
+  const auto last = Batch::broadcast(needle[needleSize - 1]);
+  // Number of offsets where 'needle' fits in 'text'.
+  const size_t numOffsets = size - needleSize + 1;
+  size_t offset = 0;
+  for (; offset + Batch::size <= numOffsets; offset += Batch::size) {
+    const auto firstBytes =
+        Batch::load_unaligned(reinterpret_cast<const uint8_t*>(text + offset));
+    const auto lastBytes = Batch::load_unaligned(
+        reinterpret_cast<const uint8_t*>(text + offset + needleSize - 1));
+    auto candidates = static_cast<uint32_t>(
+        toBitMask((firstBytes == first) & (lastBytes == last), arch));
+    while (candidates) {
+      const auto candidate = offset + __builtin_ctz(candidates);
+      if (memcmp(text + candidate, needle, needleSize) == 0) {
+        return candidate;
+      }
+      candidates &= candidates - 1;
+    }
+  }
+  for (; offset < numOffsets; ++offset) {
+    if (text[offset] == needle[0] &&
+        memcmp(text + offset, needle, needleSize) == 0) {
+      return offset;
+    }
+  }
+  return std::string_view::npos;
+}
+
+template <typename T, typename A>
+int32_t indexOf(const T* values, int32_t size, T value, const A& arch) {
+  using Batch = xsimd::batch<T, A>;
+  const auto target = Batch::broadcast(value);
+  int32_t i = 0;
+  for (; i + static_cast<int32_t>(Batch::size) <= size; i += Batch::size) {
+    const auto matches = static_cast<uint64_t>(
+        toBitMask(Batch::load_unaligned(values + i) == target, arch));
+    if (matches) {
+      return i + __builtin_ctzll(matches);
+    }
+  }
+  for (; i < size; ++i) {
+    if (values[i] == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
 template <typename T, typename U, typename A>
 xsimd::batch<T, A> reinterpretBatch(xsimd::batch<U, A> data, const A& arch) {
   return detail::ReinterpretBatch<T, U, A>::apply(data, arch);
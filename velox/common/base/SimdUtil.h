@@ -17,6 +17,8 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <string_view>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
 
@@ -365,6 +367,44 @@ xsimd::batch<T, A> setAll(T value, const A& = {}) {
   }
 }
 
+// Sets 'result[i]' to 'op(left[i], right[i])' for 'size' elements. 'op' is
+// called with batches of T and with scalars for the tail. 'result' may be
+// the same as 'left' or 'right'.
+template <typename T, typename Op, typename A = xsimd::default_arch>
+void transform(
+    const T* left,
+    const T* right,
+    T* result,
+    int32_t size,
+    Op op,
+    const A& = {});
+
+// Sets 'result[i]' to 'op(input[i])' for 'size' elements.
+template <typename T, typename Op, typename A = xsimd::default_arch>
+void transformUnary(
+    const T* input,
+    T* result,
+    int32_t size,
+    Op op,
+    const A& = {});
+
+// Returns the offset of the first occurrence of the 'needleSize' bytes at
+// 'needle' in the 'size' bytes at 'text' or std::string_view::npos if not
+// found. Candidate offsets are found a batch at a time by comparing the first
+// and last bytes of 'needle' and are then checked with memcmp.
+template <typename A = xsimd::default_arch>
+size_t findSubstring(
+    const char* text,
+    size_t size,
+    const char* needle,
+    size_t needleSize,
+    const A& = {});
+
+// Returns the index of the first element of 'values' equal to 'value' or -1
+// if none is. Compares a batch of T at a time.
+template <typename T, typename A = xsimd::default_arch>
+int32_t indexOf(const T* values, int32_t size, T value, const A& = {});
+
 // Adds 'bytes' bytes to an address of arbitrary type.
 template <typename T>
 inline T* addBytes(T* pointer, int32_t bytes) {
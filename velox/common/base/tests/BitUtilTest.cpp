@@ -459,6 +459,49 @@ TEST_F(BitUtilTest, forEachBit) {
   ASSERT_EQ(totalBits - 1, count);
 }
 
+TEST_F(BitUtilTest, forEachSetRange) {
+  constexpr int32_t kNumWords = 5;
+  std::vector<uint64_t> data(kNumWords);
+  auto test = [&](int32_t begin, int32_t end) {
+    // Runs made from the individual set bits.
+    std::vector<std::pair<int32_t, int32_t>> expected;
+    forEachSetBit(data.data(), begin, end, [&](int32_t row) {
+      if (!expected.empty() && expected.back().second == row) {
+        expected.back().second = row + 1;
+      } else {
+        expected.emplace_back(row, row + 1);
+      }
+    });
+    std::vector<std::pair<int32_t, int32_t>> ranges;
+    forEachSetRange(data.data(), begin, end, [&](int32_t first, int32_t last) {
+      ranges.emplace_back(first, last);
+    });
+    EXPECT_EQ(expected, ranges) << begin << " " << end;
+  };
+  auto testBounds = [&]() {
+    for (auto begin : {0, 1, 63, 64, 65, 130}) {
+      for (auto end : {131, 191, 192, 193, 319, 320}) {
+        test(begin, end);
+      }
+    }
+  };
+
+  testBounds();
+  std::fill(data.begin(), data.end(), ~0ULL);
+  testBounds();
+  // Runs that cross word boundaries.
+  std::fill(data.begin(), data.end(), 0);
+  fillBits(data.data(), 10, 200, true);
+  fillBits(data.data(), 250, 256, true);
+  setBit(data.data(), 319);
+  testBounds();
+  // Alternating bits and short runs.
+  for (auto i = 0; i < kNumWords; ++i) {
+    data[i] = i % 2 ? 0x5555555555555555ULL : 0xf0f00ff00000ffffULL;
+  }
+  testBounds();
+}
+
 TEST_F(BitUtilTest, hash) {
   std::unordered_set<size_t> hashes;
   const char* text = "Forget the night, come live with us in forests of azure";
@@ -118,6 +118,72 @@ TEST_F(SimdUtilTest, setAll) {
   }
 }
 
+TEST_F(SimdUtilTest, transform) {
+  // Sizes with and without a tail after the last full batch.
+  for (auto size : {0, 3, 64, 1'001}) {
+    std::vector<int64_t> left(size);
+    std::vector<int64_t> right(size);
+    for (auto i = 0; i < size; ++i) {
+      left[i] = i;
+      right[i] = i * 3;
+    }
+    std::vector<int64_t> result(size);
+    simd::transform(
+        left.data(), right.data(), result.data(), size, [](auto x, auto y) {
+          return x ^ y;
+        });
+    for (auto i = 0; i < size; ++i) {
+      ASSERT_EQ(result[i], left[i] ^ right[i]);
+    }
+
+    // The result may be an input.
+    simd::transformUnary(
+        left.data(), left.data(), size, [](auto x) { return ~x; });
+    for (auto i = 0; i < size; ++i) {
+      ASSERT_EQ(left[i], ~i);
+    }
+  }
+
+  std::vector<double> values = {1.5, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::vector<double> result(values.size());
+  simd::transform(
+      values.data(),
+      values.data(),
+      result.data(),
+      values.size(),
+      [](auto x, auto y) { return x * y; });
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(result[i], values[i] * values[i]);
+  }
+}
+
+TEST_F(SimdUtilTest, findSubstring) {
+  std::string text;
+  for (auto i = 0; i < 200; ++i) {
+    text += 'a' + i % 7;
+  }
+  for (auto needleSize = 1; needleSize < 40; ++needleSize) {
+    for (auto start = 0; start + needleSize <= text.size(); start += 13) {
+      const auto needle = text.substr(start, needleSize);
+      for (auto size : {needleSize, 31, 64, 100, 200}) {
+        if (size < needleSize) {
+          continue;
+        }
+        ASSERT_EQ(
+            simd::findSubstring(
+                text.data(), size, needle.data(), needle.size()),
+            std::string_view(text.data(), size).find(needle))
+            << needle << " " << size;
+      }
+    }
+  }
+  EXPECT_EQ(simd::findSubstring(text.data(), text.size(), "", 0), 0);
+  EXPECT_EQ(
+      simd::findSubstring(text.data(), text.size(), "xyz", 3),
+      std::string_view::npos);
+  EXPECT_EQ(simd::findSubstring("ab", 2, "abc", 3), std::string_view::npos);
+}
+
 TEST_F(SimdUtilTest, bitIndices) {
   testIndices(1);
   testIndices(10);
@@ -376,4 +442,29 @@ TEST_F(SimdUtilTest, reinterpretBatch) {
   validateReinterpretBatch<int64_t>();
 }
 
+template <typename T>
+void validateIndexOf() {
+  std::vector<T> values(100);
+  for (auto i = 0; i < values.size(); ++i) {
+    values[i] = i % 50;
+  }
+  for (auto size : {0, 1, 7, 33, 100}) {
+    for (T value : {T(0), T(6), T(31), T(49), T(77)}) {
+      auto expected = std::find(values.begin(), values.begin() + size, value);
+      ASSERT_EQ(
+          simd::indexOf(values.data(), size, value),
+          expected == values.begin() + size ? -1 : expected - values.begin());
+    }
+  }
+}
+
+TEST_F(SimdUtilTest, indexOf) {
+  validateIndexOf<int8_t>();
+  validateIndexOf<int16_t>();
+  validateIndexOf<int32_t>();
+  validateIndexOf<int64_t>();
+  validateIndexOf<float>();
+  validateIndexOf<double>();
+}
+
 } // namespace
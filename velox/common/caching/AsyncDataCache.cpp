@@ -153,7 +153,8 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    CacheTag tag) {
   AsyncDataCacheEntry* entryToInit = nullptr;
   {
     std::lock_guard<std::mutex> l(mutex_);
@@ -171,6 +172,10 @@ CachePin CacheShard::findOrCreate(
       }
       if (found->size() >= size) {
         found->touch();
+        policy_->recordAccess(key, found);
+        if (tag.priority > found->tag_.priority) {
+          found->tag_.priority = tag.priority;
+        }
         // The entry is in a readable state. Add a pin.
         if (found->isPrefetch_) {
           found->isFirstUse_ = true;
@@ -191,8 +196,10 @@ CachePin CacheShard::findOrCreate(
                              << found->size() << " requested size " << size;
       // The old entry is superseded. Possible readers of the old
       // entry still retain a valid read pin.
+      policy_->remove(*found);
       found->key_.fileNum.clear();
     }
+    policy_->recordAccess(key, nullptr);
     auto newEntry = getFreeEntryWithSize(size);
     // Initialize the members that must be set inside 'mutex_'.
     newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
@@ -210,7 +217,10 @@ CachePin CacheShard::findOrCreate(
     // Inside the shard mutex.
     VELOX_CHECK_EQ(0, entryToInit->size_);
     entryToInit->size_ = size;
+    entryToInit->tag_ = tag;
+    cache_->incrementTenantBytes(tag.tenant, size);
     entryToInit->isFirstUse_ = true;
+    policy_->admit(key, *entryToInit);
   }
   return initEntry(key, entryToInit);
 }
@@ -220,6 +230,7 @@ bool CacheShard::exists(RawFileCacheKey key) const {
   auto it = entryMap_.find(key);
   if (it != entryMap_.end()) {
     it->second->touch();
+    policy_->recordAccess(key, it->second);
     return true;
   }
   return false;
@@ -308,6 +319,7 @@ std::unique_ptr<folly::SharedPromise<bool>> CacheShard::removeEntry(
 
 void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   if (entry->key_.fileNum.hasValue()) {
+    policy_->remove(*entry);
     auto removeIter = entryMap_.find(
         RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
     VELOX_CHECK(removeIter != entryMap_.end());
@@ -336,6 +348,10 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   auto ssdCache = cache_->ssdCache();
   bool skipSsdSaveable = ssdCache && ssdCache->writeInProgress();
   auto now = accessTime();
+  // If a tenant is over its quota, the first sweep evicts only entries of
+  // tenants over their quota and a second sweep evicts by score if the first
+  // did not free enough.
+  const bool quotaSweep = !evictAllUnpinned && cache_->hasTenantOverQuota();
   std::vector<memory::Allocation> toFree;
   {
     std::lock_guard<std::mutex> l(mutex_);
@@ -347,7 +363,8 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
     int32_t numChecked = 0;
     auto entryIndex = (clockHand_ % size);
     auto iter = entries_.begin() + entryIndex;
-    while (++counter <= size) {
+    const auto numSteps = quotaSweep ? 2 * size : size;
+    while (++counter <= numSteps) {
       if (++iter == entries_.end()) {
         iter = entries_.begin();
         entryIndex = 0;
@@ -370,13 +387,26 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         eventCounter_ = 0;
       }
       int32_t score = 0;
+      bool overQuota = false;
+      if (quotaSweep && candidate->numPins_ == 0 &&
+          candidate->key_.fileNum.hasValue()) {
+        overQuota = cache_->isOverQuota(candidate->tag_.tenant);
+        if (!overQuota && counter <= size) {
+          continue;
+        }
+      }
       if (candidate->numPins_ == 0 &&
           (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
-           (score = candidate->score(now)) >= evictionThreshold_)) {
+           overQuota ||
+           (score = this->score(*candidate, now)) >= evictionThreshold_)) {
         if (skipSsdSaveable && candidate->ssdSaveable_ && !evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
         }
+        if (!evictAllUnpinned && !overQuota &&
+            candidate->key_.fileNum.hasValue() && !policy_->evict(*candidate)) {
+          continue;
+        }
         largeFreed += candidate->data_.byteSize();
         toFree.push_back(std::move(candidate->data()));
         removeEntryLocked(candidate);
@@ -384,8 +414,13 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         emptySlots_.push_back(entryIndex);
         tinyFreed += candidate->tinyData_.size();
         candidate->tinyData_.clear();
+        cache_->incrementTenantBytes(
+            candidate->tag_.tenant, -candidate->size_);
         candidate->size_ = 0;
         ++numEvict_;
+        if (overQuota) {
+          ++numQuotaEvict_;
+        }
         if (score) {
           sumEvictScore_ += score;
         }
@@ -426,7 +461,7 @@ void CacheShard::calibrateThreshold() {
   evictionThreshold_ = percentile<int32_t>(
       [&]() -> int32_t {
         AsyncDataCacheEntry* element = iter->get();
-        int32_t score = element ? element->score(now) : 0;
+        int32_t score = element ? this->score(*element, now) : 0;
         if (entryIndex + step >= entries_.size()) {
           entryIndex = (entryIndex + step) % entries_.size();
           iter = entries_.begin() + entryIndex;
@@ -440,6 +475,35 @@ void CacheShard::calibrateThreshold() {
       80);
 }
 
+int32_t CacheShard::score(const AsyncDataCacheEntry& entry, AccessTime now)
+    const {
+  const auto score = policy_->score(entry, now);
+  switch (entry.tag_.priority) {
+    case CachePriority::kLow:
+      // Saturates so that a low priority entry is not retained for wrapping
+      // around.
+      return score > std::numeric_limits<int32_t>::max() / 4
+          ? std::numeric_limits<int32_t>::max()
+          : score * 4;
+    case CachePriority::kNormal:
+      return score;
+    case CachePriority::kHigh:
+      return score / 4;
+  }
+  VELOX_UNREACHABLE();
+}
+
+void CacheShard::appendAffinity(CacheAffinityCollector& collector) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& entry : entries_) {
+    if (!entry || !entry->key_.fileNum.hasValue() || entry->isExclusive()) {
+      continue;
+    }
+    collector.add(
+        entry->key_.fileNum.id(), entry->key_.offset, entry->size_, false);
+  }
+}
+
 void CacheShard::updateStats(CacheStats& stats) {
   std::lock_guard<std::mutex> l(mutex_);
   for (auto& entry : entries_) {
@@ -465,10 +529,13 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.hitBytes += hitBytes_;
   stats.numNew += numNew_;
   stats.numEvict += numEvict_;
+  stats.numQuotaEvict += numQuotaEvict_;
   stats.numEvictChecks += numEvictChecks_;
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
   stats.allocClocks += allocClocks_;
+  stats.policy = policy_->kind();
+  stats.policyStats.add(policy_->stats());
 }
 
 void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
@@ -497,22 +564,89 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
 AsyncDataCache::AsyncDataCache(
     const std::shared_ptr<MemoryAllocator>& allocator,
     uint64_t maxBytes,
-    std::unique_ptr<SsdCache> ssdCache)
+    std::unique_ptr<SsdCache> ssdCache,
+    CachePolicyKind policy)
     : allocator_(allocator),
       ssdCache_(std::move(ssdCache)),
+      policy_(policy),
       cachedPages_(0),
       maxBytes_(maxBytes) {
   for (auto i = 0; i < kNumShards; ++i) {
-    shards_.push_back(std::make_unique<CacheShard>(this));
+    shards_.push_back(std::make_unique<CacheShard>(this, policy_));
   }
 }
 
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    CacheTag tag) {
   int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  return shards_[shard]->findOrCreate(key, size, wait, tag);
+}
+
+CacheTag AsyncDataCache::makeTag(
+    const std::string& tenant,
+    CachePriority priority) {
+  CacheTag tag;
+  tag.priority = priority;
+  if (tenant.empty()) {
+    return tag;
+  }
+  {
+    auto ids = tenantIds_.rlock();
+    auto it = ids->find(tenant);
+    if (it != ids->end()) {
+      tag.tenant = it->second;
+      return tag;
+    }
+  }
+  auto ids = tenantIds_.wlock();
+  auto it = ids->find(tenant);
+  if (it != ids->end()) {
+    tag.tenant = it->second;
+  } else if (ids->size() + 1 < kMaxTenants) {
+    tag.tenant = ids->size() + 1;
+    (*ids)[tenant] = tag.tenant;
+  } else {
+    LOG_EVERY_N(WARNING, 1000)
+        << "Too many cache tenants, " << tenant << " uses the default tenant";
+  }
+  return tag;
+}
+
+void AsyncDataCache::setTenantQuota(
+    const std::string& tenant,
+    uint64_t maxBytes) {
+  const auto id = makeTag(tenant, CachePriority::kNormal).tenant;
+  VELOX_CHECK_NE(0, id, "Cannot set a quota for tenant '{}'", tenant);
+  const auto previous = tenants_[id].maxBytes.exchange(maxBytes);
+  numQuotas_ += (maxBytes > 0) - (previous > 0);
+}
+
+uint64_t AsyncDataCache::tenantBytes(const std::string& tenant) const {
+  int32_t id = 0;
+  if (!tenant.empty()) {
+    auto ids = tenantIds_.rlock();
+    auto it = ids->find(tenant);
+    if (it == ids->end()) {
+      return 0;
+    }
+    id = it->second;
+  }
+  return std::max<int64_t>(0, tenants_[id].bytes);
+}
+
+bool AsyncDataCache::hasTenantOverQuota() const {
+  if (numQuotas_ == 0) {
+    return false;
+  }
+  for (auto i = 1; i < kMaxTenants; ++i) {
+    if (isOverQuota(i)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
@@ -694,6 +828,19 @@ CacheStats AsyncDataCache::refreshStats() const {
   return stats;
 }
 
+CacheAffinitySummary AsyncDataCache::affinitySummary(
+    int32_t maxFiles,
+    uint64_t granularity) const {
+  CacheAffinityCollector collector(granularity);
+  for (auto& shard : shards_) {
+    shard->appendAffinity(collector);
+  }
+  if (ssdCache_) {
+    ssdCache_->appendAffinity(collector);
+  }
+  return collector.finish(maxFiles);
+}
+
 void AsyncDataCache::clear() {
   for (auto& shard : shards_) {
     shard->evict(std::numeric_limits<int32_t>::max(), true);
@@ -708,7 +855,8 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " policy " << cachePolicyKindName(stats.policy)
+      << " hit rate " << stats.hitRate() << "\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
@@ -19,12 +19,15 @@
 #include <deque>
 
 #include <fmt/format.h>
+#include <folly/Synchronized.h>
 #include <folly/chrono/Hardware.h>
 #include <folly/futures/SharedPromise.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CoalesceIo.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SelectivityInfo.h"
+#include "velox/common/caching/CacheAffinity.h"
+#include "velox/common/caching/CacheTag.h"
 #include "velox/common/caching/FileGroupStats.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
@@ -35,6 +38,7 @@ namespace facebook::velox::cache {
 
 class AsyncDataCache;
 class CacheShard;
+class PeerCache;
 class SsdCache;
 class SsdCacheStats;
 class SsdFile;
@@ -185,6 +189,26 @@ class AsyncDataCacheEntry {
     return accessStats_.score(now, size_);
   }
 
+  const AccessStats& accessStats() const {
+    return accessStats_;
+  }
+
+  // State kept by the CachePolicy of the shard, e.g. the segment of the
+  // entry. Accessed under the shard mutex.
+  uint8_t policyState() const {
+    return policyState_;
+  }
+
+  void setPolicyState(uint8_t state) {
+    policyState_ = state;
+  }
+
+  // Tenant and priority of 'this'. Set when the entry is created. A hit with
+  // a higher priority raises the priority. Accessed under the shard mutex.
+  const CacheTag& tag() const {
+    return tag_;
+  }
+
   bool isShared() const {
     return numPins_ > 0;
   }
@@ -283,6 +307,11 @@ class AsyncDataCacheEntry {
 
   AccessStats accessStats_;
 
+  uint8_t policyState_{0};
+
+  // The tenant is charged for 'size_' from creation until eviction.
+  CacheTag tag_;
+
   // True if 'this' is speculatively loaded. This is reset on first
   // hit. Allows catching a situation where prefetched entries get
   // evicted before they are hit.
@@ -459,6 +488,92 @@ class CoalescedLoad {
   std::vector<int32_t> sizes_;
 };
 
+// Admission and eviction policies for AsyncDataCache.
+enum class CachePolicyKind {
+  // Evicts entries by age divided by use count. Admits everything.
+  kDefault,
+  // Admits a new entry as fully retained only if its key is more frequent
+  // than the last evicted entry, counting frequencies in a sketch that
+  // remembers evicted keys. Other new entries are evicted first unless hit
+  // again.
+  kTinyLfu,
+  // Keeps new entries in a probation segment and moves them to a protected
+  // segment when hit. Probation entries are evicted first and protected
+  // entries are demoted to probation before they are evicted.
+  kSegmentedLru,
+};
+
+std::string cachePolicyKindName(CachePolicyKind kind);
+
+// Counters of a CachePolicy.
+struct CachePolicyStats {
+  // Number of new entries admitted as fully retained.
+  int64_t numAdmit{};
+  // Number of new entries not admitted, i.e. first in line for eviction.
+  int64_t numReject{};
+  // Number of entries promoted on hit, e.g. from probation to protected.
+  int64_t numPromote{};
+  // Number of entries demoted instead of evicted.
+  int64_t numDemote{};
+
+  void add(const CachePolicyStats& other) {
+    numAdmit += other.numAdmit;
+    numReject += other.numReject;
+    numPromote += other.numPromote;
+    numDemote += other.numDemote;
+  }
+};
+
+// Decides which entries of a CacheShard to retain. Each CacheShard has its
+// own instance. All methods are called under the shard mutex.
+class CachePolicy {
+ public:
+  static std::unique_ptr<CachePolicy> create(CachePolicyKind kind);
+
+  virtual ~CachePolicy() = default;
+
+  virtual CachePolicyKind kind() const {
+    return CachePolicyKind::kDefault;
+  }
+
+  // Records a lookup of 'key'. 'entry' is the entry found or nullptr on a
+  // miss.
+  virtual void recordAccess(
+      RawFileCacheKey /*key*/,
+      AsyncDataCacheEntry* FOLLY_NULLABLE /*entry*/) {}
+
+  // Called when 'entry' is created for 'key' after a miss.
+  virtual void admit(RawFileCacheKey /*key*/, AsyncDataCacheEntry& entry) {
+    entry.setPolicyState(0);
+  }
+
+  // Returns the retention score of 'entry'. A higher score means less worth
+  // retaining. 'now' is accessTime().
+  virtual int32_t score(const AsyncDataCacheEntry& entry, AccessTime now) {
+    return entry.score(now);
+  }
+
+  // Called when 'entry' is chosen for eviction. Returns false if 'entry' is
+  // to be retained instead, e.g. when demoted to a lower segment.
+  virtual bool evict(AsyncDataCacheEntry& /*entry*/) {
+    return true;
+  }
+
+  // Called when 'entry' is removed from the shard.
+  virtual void remove(const AsyncDataCacheEntry& /*entry*/) {}
+
+  const CachePolicyStats& stats() const {
+    return stats_;
+  }
+
+ protected:
+  static RawFileCacheKey rawKey(const AsyncDataCacheEntry& entry) {
+    return RawFileCacheKey{entry.key().fileNum.id(), entry.key().offset};
+  }
+
+  CachePolicyStats stats_;
+};
+
 // Struct for CacheShard stats. Stats from all shards are added into
 // this struct to provide a snapshot of state.
 struct CacheStats {
@@ -503,6 +618,19 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Number of entries evicted because their tenant was over its quota.
+  int64_t numQuotaEvict{};
+  // Admission and eviction policy of the cache.
+  CachePolicyKind policy{CachePolicyKind::kDefault};
+  // Counters of the policy.
+  CachePolicyStats policyStats;
+
+  // Hits divided by lookups, i.e. hits plus new entries.
+  double hitRate() const {
+    return numHit + numNew == 0
+        ? 0
+        : static_cast<double>(numHit) / (numHit + numNew);
+  }
 
   std::shared_ptr<SsdCacheStats> ssdStats = nullptr;
 };
@@ -512,13 +640,17 @@ struct CacheStats {
 // and other housekeeping.
 class CacheShard {
  public:
-  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache) : cache_(cache) {}
+  CacheShard(
+      AsyncDataCache* FOLLY_NONNULL cache,
+      CachePolicyKind policy = CachePolicyKind::kDefault)
+      : cache_(cache), policy_(CachePolicy::create(policy)) {}
 
   // See AsyncDataCache::findOrCreate.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* readyFuture);
+      folly::SemiFuture<bool>* readyFuture,
+      CacheTag tag = {});
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
@@ -553,6 +685,9 @@ class CacheShard {
   // calling this a second time.
   void appendSsdSaveable(std::vector<CachePin>& pins);
 
+  // Adds the shared entries of 'this' to 'collector'.
+  void appendAffinity(CacheAffinityCollector& collector);
+
   auto& allocClocks() {
     return allocClocks_;
   }
@@ -562,6 +697,10 @@ class CacheShard {
 
   void calibrateThreshold();
 
+  // Returns the retention score of 'entry' from 'policy_', scaled by the
+  // priority of the entry.
+  int32_t score(const AsyncDataCacheEntry& entry, AccessTime now) const;
+
   void removeEntryLocked(AsyncDataCacheEntry* entry);
 
   // Returns an unused entry if found. 'size' is a hint for selecting an entry
@@ -582,6 +721,8 @@ class CacheShard {
   // few around to avoid allocating one inside 'mutex_'.
   std::vector<std::unique_ptr<AsyncDataCacheEntry>> freeEntries_;
   AsyncDataCache* const cache_;
+  // Decides admission and the retention scores of the entries.
+  const std::unique_ptr<CachePolicy> policy_;
   // Index in 'entries_' for the next eviction candidate.
   uint32_t clockHand_{};
   // Number of gets  since last stats sampling.
@@ -598,6 +739,8 @@ class CacheShard {
   uint64_t numNew_{};
   // Count of entries evicted.
   uint64_t numEvict_{};
+  // Count of entries evicted for being over the quota of their tenant.
+  uint64_t numQuotaEvict_{};
   // Count of entries considered for eviction. This divided by
   // 'numEvict_' measured efficiency of eviction.
   uint64_t numEvictChecks_{};
@@ -614,7 +757,8 @@ class AsyncDataCache : public memory::MemoryAllocator {
   AsyncDataCache(
       const std::shared_ptr<memory::MemoryAllocator>& allocator,
       uint64_t maxBytes,
-      std::unique_ptr<SsdCache> ssdCache = nullptr);
+      std::unique_ptr<SsdCache> ssdCache = nullptr,
+      CachePolicyKind policy = CachePolicyKind::kDefault);
 
   // Finds or creates a cache entry corresponding to 'key'. The entry
   // is returned in 'pin'. If the entry is new, it is pinned in
@@ -626,11 +770,13 @@ class AsyncDataCache : public memory::MemoryAllocator {
   // future that is realized when the pin is no longer exclusive. When
   // the future is realized, the caller may retry findOrCreate().
   // runtime error with code kNoCacheSpace if there is no space to create the
-  // new entry after evicting any unpinned content.
+  // new entry after evicting any unpinned content. A new entry is charged to
+  // the tenant of 'tag'.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* waitFuture = nullptr);
+      folly::SemiFuture<bool>* waitFuture = nullptr,
+      CacheTag tag = {});
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
@@ -699,10 +845,61 @@ class AsyncDataCache : public memory::MemoryAllocator {
     return maxBytes_;
   }
 
+  CachePolicyKind policy() const {
+    return policy_;
+  }
+
   SsdCache* ssdCache() const {
     return ssdCache_.get();
   }
 
+  // Sets the tier after RAM and SSD that reads entries from the cache of
+  // other workers, see PeerCache. Must be set before the cache is used.
+  void setPeerCache(std::shared_ptr<PeerCache> peerCache) {
+    peerCache_ = std::move(peerCache);
+  }
+
+  PeerCache* peerCache() const {
+    return peerCache_.get();
+  }
+
+  // Returns a summary of the files cached in RAM and SSD for a scheduler
+  // that assigns splits to the workers that have their data cached. Lists
+  // the 'maxFiles' files with the most cached bytes with their cached ranges
+  // rounded to 'granularity'. Takes the shard mutexes one at a time, so the
+  // summary is not a consistent snapshot.
+  CacheAffinitySummary affinitySummary(
+      int32_t maxFiles = 100,
+      uint64_t granularity = 8 << 20) const;
+
+  // Returns the tag for entries of 'tenant' with 'priority'. Tenants are
+  // numbered on first use. The empty tenant and tenants after the first
+  // kMaxTenants share the default tenant, which has no quota.
+  CacheTag makeTag(const std::string& tenant, CachePriority priority);
+
+  // Limits the bytes of the entries of 'tenant'. While some tenant is over
+  // its quota, eviction takes the unpinned entries of the tenants over their
+  // quota first. 0 means no limit. The quota is enforced only when making
+  // space, so a tenant may exceed it while the cache has free space.
+  void setTenantQuota(const std::string& tenant, uint64_t maxBytes);
+
+  // Returns the bytes of the entries of 'tenant'.
+  uint64_t tenantBytes(const std::string& tenant) const;
+
+  // Adds 'bytes' to the size of the entries of tenant 'tenant'.
+  void incrementTenantBytes(int32_t tenant, int64_t bytes) {
+    tenants_[tenant].bytes += bytes;
+  }
+
+  // True if the entries of 'tenant' are over its quota.
+  bool isOverQuota(int32_t tenant) const {
+    const auto maxBytes = tenants_[tenant].maxBytes.load();
+    return maxBytes > 0 && tenants_[tenant].bytes > maxBytes;
+  }
+
+  // True if any tenant is over its quota.
+  bool hasTenantOverQuota() const;
+
   // Updates stats for creation of a new cache entry of 'size' bytes,
   // i.e. a cache miss. Periodically updates SSD admission criteria,
   // i.e. reconsider criteria every half cache capacity worth of misses.
@@ -733,9 +930,10 @@ class AsyncDataCache : public memory::MemoryAllocator {
   void makePins(
       const std::vector<RawFileCacheKey>& keys,
       SizeFunc sizeFunc,
-      ProcessPin processPin) {
+      ProcessPin processPin,
+      CacheTag tag = {}) {
     for (auto i = 0; i < keys.size(); ++i) {
-      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr);
+      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr, tag);
       if (pin.empty() || pin.checkedEntry()->isShared()) {
         continue;
       }
@@ -757,10 +955,20 @@ class AsyncDataCache : public memory::MemoryAllocator {
     return allocator_->stats();
   }
 
+  static constexpr int32_t kMaxTenants = 64;
+
  private:
   static constexpr int32_t kNumShards = 4; // Must be power of 2.
   static constexpr int32_t kShardMask = kNumShards - 1;
 
+  struct Tenant {
+    // Quota in bytes. 0 means unlimited.
+    std::atomic<uint64_t> maxBytes{0};
+    // Bytes of the entries of the tenant. Signed since the updates from
+    // different shards are not ordered.
+    std::atomic<int64_t> bytes{0};
+  };
+
   // Waits a pseudorandom delay times 'counter'.
   void backoff(int32_t counter);
 
@@ -777,8 +985,17 @@ class AsyncDataCache : public memory::MemoryAllocator {
 
   std::shared_ptr<memory::MemoryAllocator> allocator_;
   std::unique_ptr<SsdCache> ssdCache_;
+  std::shared_ptr<PeerCache> peerCache_;
+  const CachePolicyKind policy_;
   std::vector<std::unique_ptr<CacheShard>> shards_;
   std::atomic<int32_t> shardCounter_{0};
+
+  // Tenant number by name. The default tenant "" is 0.
+  folly::Synchronized<folly::F14FastMap<std::string, int32_t>> tenantIds_;
+  std::array<Tenant, kMaxTenants> tenants_;
+  // Number of tenants with a quota. Lets eviction skip checking the quotas
+  // if there are none.
+  std::atomic<int32_t> numQuotas_{0};
   std::atomic<memory::MachinePageCount> cachedPages_{0};
   // Number of pages that are allocated and not yet loaded or loaded
   // but not yet hit for the first time.
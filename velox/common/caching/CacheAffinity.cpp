@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheAffinity.h"
+#include "velox/common/base/IOUtils.h"
+#include "velox/common/caching/FileIds.h"
+
+#include <folly/hash/Hash.h>
+
+namespace facebook::velox::cache {
+
+namespace {
+constexpr int8_t kSummaryV1 = 1;
+} // namespace
+
+// static
+uint64_t CacheAffinitySummary::fileNameHash(std::string_view fileName) {
+  return folly::hash::fnv64_buf(fileName.data(), fileName.size());
+}
+
+bool CacheAffinitySummary::mayContain(std::string_view fileName) const {
+  return fileNames_.isSet() && fileNames_.mayContain(fileNameHash(fileName));
+}
+
+uint64_t CacheAffinitySummary::cachedBytes(
+    std::string_view fileName,
+    uint64_t offset,
+    uint64_t length) const {
+  const auto end = offset + length;
+  for (const auto& file : topFiles_) {
+    if (file.fileName != fileName) {
+      continue;
+    }
+    uint64_t bytes = 0;
+    for (const auto& [rangeBegin, rangeEnd] : file.ranges) {
+      if (rangeBegin >= end) {
+        break;
+      }
+      if (rangeEnd > offset) {
+        bytes += std::min(rangeEnd, end) - std::max(rangeBegin, offset);
+      }
+    }
+    return bytes;
+  }
+  return 0;
+}
+
+std::string CacheAffinitySummary::serialize() const {
+  // Version, number of files, for each file the name, RAM and SSD bytes and
+  // ranges, then the Bloom filter.
+  size_t size = sizeof(int8_t) + sizeof(int32_t);
+  for (const auto& file : topFiles_) {
+    size += sizeof(int32_t) + file.fileName.size() + 2 * sizeof(uint64_t) +
+        sizeof(int32_t) + file.ranges.size() * 2 * sizeof(uint64_t);
+  }
+  std::string result(size + fileNames_.serializedSize(), '\0');
+  common::OutputByteStream stream(result.data());
+  stream.appendOne(kSummaryV1);
+  stream.appendOne<int32_t>(topFiles_.size());
+  for (const auto& file : topFiles_) {
+    stream.appendOne<int32_t>(file.fileName.size());
+    stream.append(file.fileName.data(), file.fileName.size());
+    stream.appendOne(file.ramBytes);
+    stream.appendOne(file.ssdBytes);
+    stream.appendOne<int32_t>(file.ranges.size());
+    for (const auto& [begin, end] : file.ranges) {
+      stream.appendOne(begin);
+      stream.appendOne(end);
+    }
+  }
+  fileNames_.serialize(result.data() + stream.offset());
+  return result;
+}
+
+// static
+CacheAffinitySummary CacheAffinitySummary::deserialize(
+    std::string_view serialized) {
+  common::InputByteStream stream(serialized.data());
+  VELOX_USER_CHECK_EQ(kSummaryV1, stream.read<int8_t>());
+  std::vector<CachedFileSummary> topFiles(stream.read<int32_t>());
+  for (auto& file : topFiles) {
+    const auto nameSize = stream.read<int32_t>();
+    file.fileName.assign(stream.read<char>(nameSize), nameSize);
+    file.ramBytes = stream.read<uint64_t>();
+    file.ssdBytes = stream.read<uint64_t>();
+    file.ranges.resize(stream.read<int32_t>());
+    for (auto& range : file.ranges) {
+      range.first = stream.read<uint64_t>();
+      range.second = stream.read<uint64_t>();
+    }
+  }
+  VELOX_USER_CHECK_LE(
+      stream.offset(), static_cast<int64_t>(serialized.size()));
+  BloomFilter<> fileNames;
+  fileNames.merge(serialized.data() + stream.offset());
+  return CacheAffinitySummary(std::move(topFiles), std::move(fileNames));
+}
+
+void CacheAffinityCollector::add(
+    uint64_t fileId,
+    uint64_t offset,
+    uint64_t size,
+    bool isSsd) {
+  if (size == 0) {
+    return;
+  }
+  auto& file = files_[fileId];
+  if (isSsd) {
+    file.ssdBytes += size;
+  } else {
+    file.ramBytes += size;
+  }
+  const auto lastBlock = (offset + size - 1) / granularity_;
+  for (auto block = offset / granularity_; block <= lastBlock; ++block) {
+    file.blocks.insert(block);
+  }
+}
+
+CacheAffinitySummary CacheAffinityCollector::finish(int32_t maxFiles) {
+  BloomFilter<> fileNames;
+  fileNames.reset(files_.size());
+  std::vector<std::pair<uint64_t, FileData*>> files;
+  files.reserve(files_.size());
+  for (auto& [id, data] : files_) {
+    files.emplace_back(id, &data);
+    fileNames.insert(CacheAffinitySummary::fileNameHash(fileIds().string(id)));
+  }
+  const auto numTop = std::min<size_t>(maxFiles, files.size());
+  std::partial_sort(
+      files.begin(),
+      files.begin() + numTop,
+      files.end(),
+      [](const auto& left, const auto& right) {
+        return left.second->ramBytes + left.second->ssdBytes >
+            right.second->ramBytes + right.second->ssdBytes;
+      });
+  std::vector<CachedFileSummary> topFiles(numTop);
+  for (auto i = 0; i < numTop; ++i) {
+    auto& data = *files[i].second;
+    auto& summary = topFiles[i];
+    summary.fileName = fileIds().string(files[i].first);
+    summary.ramBytes = data.ramBytes;
+    summary.ssdBytes = data.ssdBytes;
+    std::vector<uint64_t> blocks(data.blocks.begin(), data.blocks.end());
+    std::sort(blocks.begin(), blocks.end());
+    for (auto block : blocks) {
+      if (!summary.ranges.empty() &&
+          summary.ranges.back().second == block * granularity_) {
+        summary.ranges.back().second += granularity_;
+      } else {
+        summary.ranges.emplace_back(
+            block * granularity_, (block + 1) * granularity_);
+      }
+    }
+  }
+  files_.clear();
+  return CacheAffinitySummary(std::move(topFiles), std::move(fileNames));
+}
+
+} // namespace facebook::velox::cache
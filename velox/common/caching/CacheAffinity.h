@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/BloomFilter.h"
+
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// Cached bytes of one file on a worker.
+struct CachedFileSummary {
+  std::string fileName;
+  uint64_t ramBytes{0};
+  uint64_t ssdBytes{0};
+  // Sorted disjoint [begin, end) byte ranges of the file that have cached
+  // entries in RAM or SSD, rounded out to the granularity of the summary.
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+
+  uint64_t totalBytes() const {
+    return ramBytes + ssdBytes;
+  }
+};
+
+// Compact description of what a worker has cached, for a coordinator that
+// assigns splits to the workers that have their data. Lists the files with
+// the most cached bytes and their cached ranges, and has a Bloom filter of
+// the names of all cached files. See AsyncDataCache::affinitySummary().
+class CacheAffinitySummary {
+ public:
+  CacheAffinitySummary() = default;
+
+  CacheAffinitySummary(
+      std::vector<CachedFileSummary> topFiles,
+      BloomFilter<> fileNames)
+      : topFiles_(std::move(topFiles)), fileNames_(std::move(fileNames)) {}
+
+  // Files with the most cached bytes, most first.
+  const std::vector<CachedFileSummary>& topFiles() const {
+    return topFiles_;
+  }
+
+  // False if nothing of 'fileName' is cached. True if something may be.
+  bool mayContain(std::string_view fileName) const;
+
+  // Returns the cached bytes in [offset, offset + length) of 'fileName'
+  // according to the ranges of 'topFiles()'. 0 if 'fileName' is not in
+  // 'topFiles()'.
+  uint64_t cachedBytes(
+      std::string_view fileName,
+      uint64_t offset,
+      uint64_t length) const;
+
+  // Returns a binary form for sending to the coordinator.
+  std::string serialize() const;
+
+  static CacheAffinitySummary deserialize(std::string_view serialized);
+
+  // Returns the hash of 'fileName' for the Bloom filter. The same on all
+  // workers.
+  static uint64_t fileNameHash(std::string_view fileName);
+
+ private:
+  std::vector<CachedFileSummary> topFiles_;
+  BloomFilter<> fileNames_;
+};
+
+// Accumulates cache entries for a CacheAffinitySummary. Not thread safe.
+class CacheAffinityCollector {
+ public:
+  // 'granularity' is the size of the blocks a file is divided into for
+  // describing the cached ranges.
+  explicit CacheAffinityCollector(uint64_t granularity)
+      : granularity_(granularity) {}
+
+  // Records 'size' cached bytes at 'offset' of file 'fileId'.
+  void add(uint64_t fileId, uint64_t offset, uint64_t size, bool isSsd);
+
+  // Returns the summary with the 'maxFiles' files with the most cached
+  // bytes.
+  CacheAffinitySummary finish(int32_t maxFiles);
+
+ private:
+  struct FileData {
+    uint64_t ramBytes{0};
+    uint64_t ssdBytes{0};
+    // Indices of the 'granularity_' sized blocks with cached data.
+    folly::F14FastSet<uint64_t> blocks;
+  };
+
+  const uint64_t granularity_;
+  folly::F14FastMap<uint64_t, FileData> files_;
+};
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CachePolicy.h"
+
+#include <limits>
+
+namespace facebook::velox::cache {
+
+std::string cachePolicyKindName(CachePolicyKind kind) {
+  switch (kind) {
+    case CachePolicyKind::kDefault:
+      return "DEFAULT";
+    case CachePolicyKind::kTinyLfu:
+      return "TINY_LFU";
+    case CachePolicyKind::kSegmentedLru:
+      return "SEGMENTED_LRU";
+  }
+  VELOX_UNREACHABLE();
+}
+
+std::unique_ptr<CachePolicy> CachePolicy::create(CachePolicyKind kind) {
+  switch (kind) {
+    case CachePolicyKind::kDefault:
+      return std::make_unique<CachePolicy>();
+    case CachePolicyKind::kTinyLfu:
+      return std::make_unique<TinyLfuPolicy>();
+    case CachePolicyKind::kSegmentedLru:
+      return std::make_unique<SegmentedLruPolicy>();
+  }
+  VELOX_UNREACHABLE();
+}
+
+FrequencySketch::FrequencySketch(int32_t width)
+    : mask_(bits::nextPowerOfTwo(std::max(width, 16)) - 1),
+      table_((mask_ + 1) * kNumRows / 16),
+      sampleSize_(10 * (mask_ + 1)) {}
+
+uint32_t FrequencySketch::index(uint64_t hash, int32_t row) const {
+  // Each row mixes the hash with a different seed.
+  static constexpr uint64_t kSeeds[kNumRows] = {
+      0xc3a5c85c97cb3127ULL,
+      0xb492b66fbe98f273ULL,
+      0x9ae16a3b2f90404fULL,
+      0xcbf29ce484222325ULL};
+  return bits::hashMix(hash, kSeeds[row]) & mask_;
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  for (auto row = 0; row < kNumRows; ++row) {
+    const auto i = row * (mask_ + 1) + index(hash, row);
+    if (counter(i) < kMaxFrequency) {
+      table_[i / 16] += 1ULL << ((i % 16) * 4);
+    }
+  }
+  if (++numIncrements_ >= sampleSize_) {
+    age();
+  }
+}
+
+int32_t FrequencySketch::estimate(uint64_t hash) const {
+  int32_t result = kMaxFrequency;
+  for (auto row = 0; row < kNumRows; ++row) {
+    result =
+        std::min(result, counter(row * (mask_ + 1) + index(hash, row)));
+  }
+  return result;
+}
+
+void FrequencySketch::age() {
+  // Shifts each 4 bit counter right by 1 and clears the bit that moved in
+  // from the next counter.
+  for (auto& word : table_) {
+    word = (word >> 1) & 0x7777777777777777ULL;
+  }
+  numIncrements_ /= 2;
+}
+
+void TinyLfuPolicy::recordAccess(
+    RawFileCacheKey key,
+    AsyncDataCacheEntry* entry) {
+  sketch_.increment(std::hash<RawFileCacheKey>()(key));
+  // The first use of a prefetched entry is not a hit.
+  if (entry != nullptr && !entry->isPrefetch() &&
+      entry->policyState() == kProbation) {
+    entry->setPolicyState(0);
+    ++stats_.numPromote;
+  }
+}
+
+void TinyLfuPolicy::admit(RawFileCacheKey key, AsyncDataCacheEntry& entry) {
+  // recordAccess() has counted this miss.
+  if (estimate(key) > victimFrequency_) {
+    entry.setPolicyState(0);
+    ++stats_.numAdmit;
+  } else {
+    entry.setPolicyState(kProbation);
+    ++stats_.numReject;
+  }
+}
+
+int32_t TinyLfuPolicy::score(
+    const AsyncDataCacheEntry& entry,
+    AccessTime now) {
+  const auto& accessStats = entry.accessStats();
+  // A prefetched entry is not evicted before its first use even if not
+  // admitted.
+  if (accessStats.lastUse == 0 ||
+      (entry.policyState() == kProbation && !entry.isPrefetch())) {
+    return std::numeric_limits<int32_t>::max();
+  }
+  return (now - accessStats.lastUse) / (1 + estimate(rawKey(entry)));
+}
+
+bool TinyLfuPolicy::evict(AsyncDataCacheEntry& entry) {
+  victimFrequency_ = estimate(rawKey(entry));
+  return true;
+}
+
+void SegmentedLruPolicy::recordAccess(
+    RawFileCacheKey /*key*/,
+    AsyncDataCacheEntry* entry) {
+  // The first use of a prefetched entry is not a hit.
+  if (entry != nullptr && !entry->isPrefetch() &&
+      entry->policyState() != kProtected) {
+    entry->setPolicyState(kProtected);
+    protectedBytes_ += entry->size();
+    ++stats_.numPromote;
+  }
+}
+
+void SegmentedLruPolicy::admit(
+    RawFileCacheKey /*key*/,
+    AsyncDataCacheEntry& entry) {
+  entry.setPolicyState(0);
+  ++stats_.numAdmit;
+}
+
+int32_t SegmentedLruPolicy::score(
+    const AsyncDataCacheEntry& entry,
+    AccessTime now) {
+  const auto& accessStats = entry.accessStats();
+  if (accessStats.lastUse == 0) {
+    return std::numeric_limits<int32_t>::max();
+  }
+  const auto age = std::max<int32_t>(0, now - accessStats.lastUse);
+  if (entry.policyState() == kProtected) {
+    return age;
+  }
+  return age > std::numeric_limits<int32_t>::max() - kProbationPenalty
+      ? std::numeric_limits<int32_t>::max()
+      : age + kProbationPenalty;
+}
+
+bool SegmentedLruPolicy::evict(AsyncDataCacheEntry& entry) {
+  if (entry.policyState() != kProtected) {
+    return true;
+  }
+  entry.setPolicyState(0);
+  protectedBytes_ -= entry.size();
+  ++stats_.numDemote;
+  return false;
+}
+
+void SegmentedLruPolicy::remove(const AsyncDataCacheEntry& entry) {
+  if (entry.policyState() == kProtected) {
+    protectedBytes_ -= entry.size();
+  }
+}
+
+} // namespace facebook::velox::cache
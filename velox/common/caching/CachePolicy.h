@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/caching/AsyncDataCache.h"
+
+namespace facebook::velox::cache {
+
+// Count-min sketch of access frequencies with 4 rows of 4 bit counters.
+// The counters are halved after every 10 x 'width' increments, so that the
+// frequencies reflect recent history. Not thread safe.
+class FrequencySketch {
+ public:
+  static constexpr int32_t kMaxFrequency = 15;
+
+  // 'width' is the number of counters per row, rounded up to a power of 2.
+  explicit FrequencySketch(int32_t width);
+
+  // Increments the frequency of 'hash'.
+  void increment(uint64_t hash);
+
+  // Returns the estimated frequency of 'hash', at most kMaxFrequency.
+  int32_t estimate(uint64_t hash) const;
+
+ private:
+  static constexpr int32_t kNumRows = 4;
+
+  // Returns the index of the counter for 'hash' in 'row'.
+  uint32_t index(uint64_t hash, int32_t row) const;
+
+  int32_t counter(uint32_t index) const {
+    return (table_[index / 16] >> ((index % 16) * 4)) & 0xf;
+  }
+
+  // Halves all counters.
+  void age();
+
+  const uint32_t mask_;
+  // kNumRows x width counters, 16 to a word.
+  std::vector<uint64_t> table_;
+  const int32_t sampleSize_;
+  int32_t numIncrements_{0};
+};
+
+// TinyLFU admission in front of the default retention score. A new entry is
+// admitted if its key is more frequent than the key of the last evicted
+// entry. Entries that are not admitted are on probation and are evicted at
+// first sight by the clock sweep unless hit again before that. The sketch
+// counts misses too, so a key that keeps coming back is admitted on a later
+// miss. A scan of cold data does not push out frequently used entries
+// because each of its keys is seen once.
+class TinyLfuPolicy : public CachePolicy {
+ public:
+  static constexpr uint8_t kProbation = 1;
+
+  explicit TinyLfuPolicy(int32_t sketchWidth = 1 << 16)
+      : sketch_(sketchWidth) {}
+
+  CachePolicyKind kind() const override {
+    return CachePolicyKind::kTinyLfu;
+  }
+
+  void recordAccess(RawFileCacheKey key, AsyncDataCacheEntry* entry) override;
+
+  void admit(RawFileCacheKey key, AsyncDataCacheEntry& entry) override;
+
+  int32_t score(const AsyncDataCacheEntry& entry, AccessTime now) override;
+
+  bool evict(AsyncDataCacheEntry& entry) override;
+
+  int32_t estimate(RawFileCacheKey key) const {
+    return sketch_.estimate(std::hash<RawFileCacheKey>()(key));
+  }
+
+ private:
+  FrequencySketch sketch_;
+  // Estimated frequency of the most recently evicted entry. 0 if nothing
+  // has been evicted, so that everything is admitted until the shard is
+  // full.
+  int32_t victimFrequency_{0};
+};
+
+// Segmented LRU: new entries go to a probation segment and move to a
+// protected segment when hit. The score of a probation entry is its age
+// plus kProbationPenalty, so that probation entries are evicted before
+// protected entries of similar age. A protected entry that is chosen for
+// eviction is demoted to probation instead, so it gets one more chance.
+class SegmentedLruPolicy : public CachePolicy {
+ public:
+  static constexpr uint8_t kProtected = 1;
+  // About 17 minutes in accessTime() units.
+  static constexpr int32_t kProbationPenalty = 1 << 20;
+
+  CachePolicyKind kind() const override {
+    return CachePolicyKind::kSegmentedLru;
+  }
+
+  void recordAccess(RawFileCacheKey key, AsyncDataCacheEntry* entry) override;
+
+  void admit(RawFileCacheKey key, AsyncDataCacheEntry& entry) override;
+
+  int32_t score(const AsyncDataCacheEntry& entry, AccessTime now) override;
+
+  bool evict(AsyncDataCacheEntry& entry) override;
+
+  void remove(const AsyncDataCacheEntry& entry) override;
+
+  // Bytes in the protected segment.
+  uint64_t protectedBytes() const {
+    return protectedBytes_;
+  }
+
+ private:
+  uint64_t protectedBytes_{0};
+};
+
+} // namespace facebook::velox::cache
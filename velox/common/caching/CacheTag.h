@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Exceptions.h"
+
+#include <string_view>
+
+namespace facebook::velox::cache {
+
+// Retention class of cache entries. Among entries of tenants within their
+// quota, a lower priority entry is evicted before a higher priority entry of
+// similar age and use count.
+enum class CachePriority : uint8_t { kLow = 0, kNormal = 1, kHigh = 2 };
+
+inline std::string_view cachePriorityName(CachePriority priority) {
+  switch (priority) {
+    case CachePriority::kLow:
+      return "low";
+    case CachePriority::kNormal:
+      return "normal";
+    case CachePriority::kHigh:
+      return "high";
+  }
+  VELOX_UNREACHABLE();
+}
+
+inline CachePriority cachePriorityFromName(std::string_view name) {
+  if (name == "low") {
+    return CachePriority::kLow;
+  }
+  if (name == "normal") {
+    return CachePriority::kNormal;
+  }
+  if (name == "high") {
+    return CachePriority::kHigh;
+  }
+  VELOX_USER_FAIL("Invalid cache priority: {}", name);
+}
+
+// Owner and priority of cache entries. Tenants are numbered by their cache,
+// see AsyncDataCache::makeTag(). Tenant 0 is the default tenant without a
+// quota.
+struct CacheTag {
+  int32_t tenant{0};
+  CachePriority priority{CachePriority::kNormal};
+};
+
+} // namespace facebook::velox::cache
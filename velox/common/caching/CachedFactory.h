@@ -25,15 +25,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <utility>
+#include <vector>
 
 #include "folly/container/F14Set.h"
+#include "folly/hash/Hash.h"
 #include "glog/logging.h"
 
+#include "velox/common/base/Exceptions.h"
 #include "velox/common/caching/SimpleLRUCache.h"
 
 namespace facebook::velox {
@@ -110,6 +114,73 @@ class CachedFactory {
   std::condition_variable pendingCv_;
 };
 
+// CachedFactory partitioned into shards by the hash of the key. Each shard
+// has its own LRU cache and its own set of keys being generated, so lookups
+// and generation of keys in different shards do not serialize on one mutex.
+// Concurrent generate() calls for the same key still run the generator once.
+// The generator is shared by all shards and must be thread-safe.
+template <typename Key, typename Value, typename Generator>
+class ShardedCachedFactory {
+ public:
+  static constexpr int32_t kDefaultNumShards = 16;
+
+  // 'maxSize' is divided evenly between 'numShards' shards.
+  ShardedCachedFactory(
+      int64_t maxSize,
+      std::unique_ptr<Generator> generator,
+      int32_t numShards = kDefaultNumShards);
+
+  // See CachedFactory::generate().
+  std::pair<bool, Value> generate(const Key& key) {
+    return shardOf(key).generate(key);
+  }
+
+  // See CachedFactory::retrieveCached(). The keys in 'cached' and 'missing'
+  // are grouped by shard.
+  void retrieveCached(
+      const std::vector<Key>& keys,
+      std::vector<std::pair<Key, Value>>* cached,
+      std::vector<Key>* missing);
+
+  int64_t currentSize() const;
+
+  int64_t maxSize() const;
+
+  // Sum of the stats of all shards.
+  SimpleLRUCacheStats cacheStats();
+
+  SimpleLRUCacheStats clearCache();
+
+ private:
+  // Forwards to the generator shared by all shards.
+  struct SharedGenerator {
+    Value operator()(const Key& key) {
+      return (*generator)(key);
+    }
+
+    Generator* generator;
+  };
+
+  using Shard = CachedFactory<Key, Value, SharedGenerator>;
+
+  size_t shardIndex(const Key& key) const {
+    // Mixes the hash so that the shard does not correlate with the bits the
+    // hash tables inside the shards use.
+    return folly::hash::twang_mix64(folly::hasher<Key>{}(key)) %
+        shards_.size();
+  }
+
+  Shard& shardOf(const Key& key) {
+    return *shards_[shardIndex(key)];
+  }
+
+  template <typename StatsFunc>
+  SimpleLRUCacheStats sumStats(StatsFunc statsFunc);
+
+  std::unique_ptr<Generator> generator_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
 //
 // End of public API. Implementation follows.
 //
@@ -185,4 +256,83 @@ void CachedFactory<Key, Value, Generator>::retrieveCached(
   }
 }
 
+template <typename Key, typename Value, typename Generator>
+ShardedCachedFactory<Key, Value, Generator>::ShardedCachedFactory(
+    int64_t maxSize,
+    std::unique_ptr<Generator> generator,
+    int32_t numShards)
+    : generator_(std::move(generator)) {
+  VELOX_CHECK_GT(numShards, 0);
+  const int64_t shardSize = std::max<int64_t>(
+      1, (maxSize + numShards - 1) / numShards);
+  shards_.reserve(numShards);
+  for (auto i = 0; i < numShards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(
+        std::make_unique<SimpleLRUCache<Key, Value>>(shardSize),
+        std::make_unique<SharedGenerator>(SharedGenerator{generator_.get()})));
+  }
+}
+
+template <typename Key, typename Value, typename Generator>
+void ShardedCachedFactory<Key, Value, Generator>::retrieveCached(
+    const std::vector<Key>& keys,
+    std::vector<std::pair<Key, Value>>* cached,
+    std::vector<Key>* missing) {
+  std::vector<std::vector<Key>> shardKeys(shards_.size());
+  for (const Key& key : keys) {
+    shardKeys[shardIndex(key)].push_back(key);
+  }
+  for (auto i = 0; i < shards_.size(); ++i) {
+    if (!shardKeys[i].empty()) {
+      shards_[i]->retrieveCached(shardKeys[i], cached, missing);
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Generator>
+int64_t ShardedCachedFactory<Key, Value, Generator>::currentSize() const {
+  int64_t size = 0;
+  for (const auto& shard : shards_) {
+    size += shard->currentSize();
+  }
+  return size;
+}
+
+template <typename Key, typename Value, typename Generator>
+int64_t ShardedCachedFactory<Key, Value, Generator>::maxSize() const {
+  int64_t size = 0;
+  for (const auto& shard : shards_) {
+    size += shard->maxSize();
+  }
+  return size;
+}
+
+template <typename Key, typename Value, typename Generator>
+SimpleLRUCacheStats ShardedCachedFactory<Key, Value, Generator>::cacheStats() {
+  return sumStats([](Shard& shard) { return shard.cacheStats(); });
+}
+
+template <typename Key, typename Value, typename Generator>
+SimpleLRUCacheStats ShardedCachedFactory<Key, Value, Generator>::clearCache() {
+  return sumStats([](Shard& shard) { return shard.clearCache(); });
+}
+
+template <typename Key, typename Value, typename Generator>
+template <typename StatsFunc>
+SimpleLRUCacheStats ShardedCachedFactory<Key, Value, Generator>::sumStats(
+    StatsFunc statsFunc) {
+  size_t maxSize = 0;
+  size_t curSize = 0;
+  size_t numHits = 0;
+  size_t numLookups = 0;
+  for (auto& shard : shards_) {
+    auto stats = statsFunc(*shard);
+    maxSize += stats.maxSize;
+    curSize += stats.curSize;
+    numHits += stats.numHits;
+    numLookups += stats.numLookups;
+  }
+  return SimpleLRUCacheStats(maxSize, curSize, numHits, numLookups);
+}
+
 } // namespace facebook::velox
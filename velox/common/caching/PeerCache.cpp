@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/PeerCache.h"
+#include "velox/common/caching/FileIds.h"
+
+#include <folly/hash/Hash.h>
+
+#include <limits>
+
+namespace facebook::velox::cache {
+
+namespace {
+// The hashes must be the same on all workers, so std::hash is not used.
+uint64_t nameHash(std::string_view name) {
+  return folly::hash::fnv64_buf(name.data(), name.size());
+}
+
+// Returns the memory of the data of 'entry'.
+std::vector<folly::Range<char*>> entryRanges(AsyncDataCacheEntry& entry) {
+  std::vector<folly::Range<char*>> ranges;
+  const uint64_t size = entry.size();
+  if (entry.tinyData()) {
+    ranges.emplace_back(entry.tinyData(), size);
+    return ranges;
+  }
+  auto& data = entry.data();
+  uint64_t offset = 0;
+  for (auto i = 0; i < data.numRuns() && offset < size; ++i) {
+    auto run = data.runAt(i);
+    const auto bytes = std::min<uint64_t>(run.numBytes(), size - offset);
+    ranges.emplace_back(run.data<char>(), bytes);
+    offset += bytes;
+  }
+  return ranges;
+}
+
+uint64_t totalBytes(const std::vector<folly::Range<char*>>& ranges) {
+  uint64_t bytes = 0;
+  for (const auto& range : ranges) {
+    bytes += range.size();
+  }
+  return bytes;
+}
+} // namespace
+
+PeerCache::PeerCache(
+    std::string self,
+    std::vector<std::string> peers,
+    std::shared_ptr<PeerCacheTransport> transport,
+    uint64_t affinityBytes,
+    int32_t numVirtualNodes)
+    : self_(std::move(self)),
+      transport_(std::move(transport)),
+      affinityBytes_(affinityBytes),
+      numVirtualNodes_(numVirtualNodes) {
+  VELOX_CHECK_NOT_NULL(transport_);
+  VELOX_CHECK_GT(affinityBytes_, 0);
+  VELOX_CHECK_GT(numVirtualNodes_, 0);
+  setPeers(std::move(peers));
+}
+
+void PeerCache::setPeers(std::vector<std::string> peers) {
+  Ring ring;
+  ring.points.reserve(peers.size() * numVirtualNodes_);
+  for (auto i = 0; i < peers.size(); ++i) {
+    const auto hash = nameHash(peers[i]);
+    for (auto node = 0; node < numVirtualNodes_; ++node) {
+      ring.points.emplace_back(bits::hashMix(hash, node), i);
+    }
+  }
+  std::sort(ring.points.begin(), ring.points.end());
+  ring.peers = std::move(peers);
+  *ring_.wlock() = std::move(ring);
+}
+
+std::string PeerCache::owner(std::string_view fileName, uint64_t offset)
+    const {
+  const auto hash = bits::hashMix(nameHash(fileName), offset / affinityBytes_);
+  auto ring = ring_.rlock();
+  if (ring->points.empty()) {
+    return self_;
+  }
+  auto it = std::lower_bound(
+      ring->points.begin(),
+      ring->points.end(),
+      std::make_pair(hash, std::numeric_limits<int32_t>::min()));
+  if (it == ring->points.end()) {
+    it = ring->points.begin();
+  }
+  return ring->peers[it->second];
+}
+
+std::vector<int32_t> PeerCache::read(
+    const std::string& fileName,
+    const std::vector<CachePin>& pins) {
+  std::vector<int32_t> misses;
+  // One transport read per entry. An entry is up to a load quantum, which
+  // amortizes the round trip.
+  for (auto i = 0; i < pins.size(); ++i) {
+    auto entry = pins[i].checkedEntry();
+    const auto peer = owner(fileName, entry->offset());
+    ++numReads_;
+    bool hit = false;
+    if (peer != self_) {
+      try {
+        hit = transport_->read(
+            peer, fileName, entry->offset(), entryRanges(*entry));
+      } catch (const std::exception& e) {
+        LOG_EVERY_N(WARNING, 1000)
+            << "Error reading " << fileName << " from peer " << peer << ": "
+            << e.what();
+      }
+    }
+    if (hit) {
+      ++numHits_;
+      bytesRead_ += entry->size();
+    } else {
+      ++numMisses_;
+      misses.push_back(i);
+    }
+  }
+  return misses;
+}
+
+// static
+bool PeerCache::readLocal(
+    AsyncDataCache& cache,
+    const std::string& fileName,
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) {
+  StringIdLease fileId(fileIds(), fileName);
+  RawFileCacheKey key{fileId.id(), offset};
+  if (!cache.exists(key)) {
+    return false;
+  }
+  // Asks for any size so that a smaller entry is not superseded.
+  auto pin = cache.findOrCreate(key, 1, nullptr);
+  if (pin.empty() || pin.checkedEntry()->isExclusive()) {
+    // Being loaded or evicted in the meantime. An exclusive entry is dropped
+    // with the pin.
+    return false;
+  }
+  auto entry = pin.checkedEntry();
+  if (entry->size() < totalBytes(buffers)) {
+    return false;
+  }
+  auto source = entryRanges(*entry);
+  auto sourceIt = source.begin();
+  uint64_t sourceOffset = 0;
+  for (const auto& buffer : buffers) {
+    uint64_t copied = 0;
+    while (copied < buffer.size()) {
+      VELOX_CHECK(sourceIt != source.end());
+      const auto bytes = std::min<uint64_t>(
+          buffer.size() - copied, sourceIt->size() - sourceOffset);
+      memcpy(buffer.data() + copied, sourceIt->data() + sourceOffset, bytes);
+      copied += bytes;
+      sourceOffset += bytes;
+      if (sourceOffset == sourceIt->size()) {
+        ++sourceIt;
+        sourceOffset = 0;
+      }
+    }
+  }
+  return true;
+}
+
+PeerCacheStats PeerCache::stats() const {
+  PeerCacheStats stats;
+  stats.numReads = numReads_;
+  stats.numHits = numHits_;
+  stats.bytesRead = bytesRead_;
+  stats.numMisses = numMisses_;
+  return stats;
+}
+
+} // namespace facebook::velox::cache
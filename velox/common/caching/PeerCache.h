@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/caching/AsyncDataCache.h"
+
+#include <folly/Synchronized.h>
+
+namespace facebook::velox::cache {
+
+// Moves cache entry data between workers. Implemented by the embedding
+// system on top of its RPC layer. The peer side answers with
+// PeerCache::readLocal(). Thread safe.
+class PeerCacheTransport {
+ public:
+  virtual ~PeerCacheTransport() = default;
+
+  // Reads the bytes at 'offset' of 'fileName' into 'buffers' from the cache
+  // of 'peer'. Returns false if 'peer' does not have all of the range
+  // cached or cannot be reached. Must not read from storage.
+  virtual bool read(
+      const std::string& peer,
+      const std::string& fileName,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) = 0;
+};
+
+struct PeerCacheStats {
+  // Entries asked from peers.
+  uint64_t numReads{0};
+  // Entries that peers had.
+  uint64_t numHits{0};
+  uint64_t bytesRead{0};
+  // Entries that were not loaded from a peer and go to storage.
+  uint64_t numMisses{0};
+};
+
+// Maps ranges of files to the workers of a cluster by consistent hashing,
+// so that each worker caches its share of the hot data and the others read
+// that share from it instead of from storage. A file is split into chunks
+// of 'affinityBytes' and each chunk has an owner. Adjacent entries of a
+// stripe thus usually have the same owner. A change of the membership moves
+// only the chunks of the joining or leaving worker. This is the tier after
+// RAM and SSD: CachedBufferedInput asks the owner of an entry that misses
+// RAM and SSD before reading storage and then caches the entry locally.
+class PeerCache {
+ public:
+  static constexpr uint64_t kDefaultAffinityBytes = 64 << 20;
+
+  // 'self' is the id of this worker in 'peers'. 'numVirtualNodes' is the
+  // number of points per worker on the hash ring.
+  PeerCache(
+      std::string self,
+      std::vector<std::string> peers,
+      std::shared_ptr<PeerCacheTransport> transport,
+      uint64_t affinityBytes = kDefaultAffinityBytes,
+      int32_t numVirtualNodes = 100);
+
+  // Replaces the workers of the cluster.
+  void setPeers(std::vector<std::string> peers);
+
+  // Returns the worker that owns the chunk at 'offset' of 'fileName'.
+  std::string owner(std::string_view fileName, uint64_t offset) const;
+
+  // True if the chunk at 'offset' of 'fileName' is owned by another worker.
+  bool isRemote(std::string_view fileName, uint64_t offset) const {
+    return owner(fileName, offset) != self_;
+  }
+
+  // Loads the entries of 'pins' of 'fileName' from their owners. Returns the
+  // indices of the entries that were not loaded. These are to be read from
+  // storage.
+  std::vector<int32_t> read(
+      const std::string& fileName,
+      const std::vector<CachePin>& pins);
+
+  // Copies the cached bytes at 'offset' of 'fileName' into 'buffers' if
+  // 'cache' has an entry at 'offset' that covers them. Serves a read from a
+  // peer. Returns false on a miss. Does not read SSD or storage.
+  static bool readLocal(
+      AsyncDataCache& cache,
+      const std::string& fileName,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers);
+
+  PeerCacheStats stats() const;
+
+  const std::string& self() const {
+    return self_;
+  }
+
+ private:
+  struct Ring {
+    // Sorted points on the ring and the index of their worker in 'peers'.
+    std::vector<std::pair<uint64_t, int32_t>> points;
+    std::vector<std::string> peers;
+  };
+
+  const std::string self_;
+  const std::shared_ptr<PeerCacheTransport> transport_;
+  const uint64_t affinityBytes_;
+  const int32_t numVirtualNodes_;
+  folly::Synchronized<Ring> ring_;
+
+  std::atomic<uint64_t> numReads_{0};
+  std::atomic<uint64_t> numHits_{0};
+  std::atomic<uint64_t> bytesRead_{0};
+  std::atomic<uint64_t> numMisses_{0};
+};
+
+} // namespace facebook::velox::cache
@@ -56,7 +56,8 @@ SsdCache::SsdCache(
         i,
         fileMaxRegions,
         checkpointIntervalBytes / numShards,
-        disableFileCow));
+        disableFileCow,
+        executor_));
   }
 }
 
@@ -133,6 +134,18 @@ SsdCacheStats SsdCache::stats() const {
   return stats;
 }
 
+void SsdCache::appendAffinity(CacheAffinityCollector& collector) const {
+  for (auto& file : files_) {
+    file->appendAffinity(collector);
+  }
+}
+
+void SsdCache::waitForRecovery() {
+  for (auto& file : files_) {
+    file->waitForRecovery();
+  }
+}
+
 void SsdCache::clear() {
   for (auto& file : files_) {
     file->clear();
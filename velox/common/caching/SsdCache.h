@@ -79,6 +79,13 @@ class SsdCache {
     return *groupStats_;
   }
 
+  // Adds the entries of all shards to 'collector'.
+  void appendAffinity(CacheAffinityCollector& collector) const;
+
+  // Waits for the shards to finish recovering from checkpoint. Until then
+  // the cache serves as empty, see SsdFile.
+  void waitForRecovery();
+
   // Drops all entries. Outstanding pins become invalid but reading
   // them will mostly succeed since the files will not be rewritten
   // until new content is stored.
@@ -16,9 +16,11 @@
 
 #include "velox/common/caching/SsdFile.h"
 #include <folly/Executor.h>
+#include <folly/hash/Checksum.h>
 #include <folly/portability/SysUio.h>
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/time/Timer.h"
 
 #include <fcntl.h>
 #ifdef linux
@@ -32,6 +34,23 @@
 
 DEFINE_bool(ssd_odirect, true, "Use O_DIRECT for SSD cache IO");
 DEFINE_bool(ssd_verify_write, false, "Read back data after writing to SSD");
+DEFINE_bool(
+    ssd_io_uring,
+    false,
+    "Use io_uring for SSD cache IO if Velox is built with io_uring support");
+DEFINE_int32(
+    ssd_io_uring_depth,
+    64,
+    "Maximum number of SSD cache IOs in flight per io_uring");
+DEFINE_bool(
+    ssd_checksum,
+    true,
+    "Keep a CRC32C of each SSD cache entry and verify it on read");
+DEFINE_bool(
+    ssd_lazy_recovery,
+    true,
+    "Recover the SSD cache from checkpoint on the cache executor after "
+    "startup instead of in the constructor");
 
 namespace facebook::velox::cache {
 
@@ -107,7 +126,8 @@ SsdFile::SsdFile(
       maxRegions_(maxRegions),
       filename_(filename),
       checkpointIntervalBytes_(checkpointIntervalBytes),
-      executor_(executor) {
+      executor_(executor),
+      checksumEntries_(FLAGS_ssd_checksum) {
   int32_t oDirect = 0;
 #ifdef linux
   oDirect = FLAGS_ssd_odirect ? O_DIRECT : 0;
@@ -128,7 +148,7 @@ SsdFile::SsdFile(
     disableCow(fd_);
   }
 
-  readFile_ = std::make_unique<LocalReadFile>(fd_);
+  io_ = SsdFileIo::create(fd_, FLAGS_ssd_io_uring, FLAGS_ssd_io_uring_depth);
   uint64_t size = lseek(fd_, 0, SEEK_END);
   numRegions_ = size / kRegionSize;
   if (numRegions_ > maxRegions_) {
@@ -149,6 +169,16 @@ SsdFile::SsdFile(
   }
 }
 
+SsdFile::~SsdFile() {
+  waitForRecovery();
+}
+
+void SsdFile::waitForRecovery() {
+  if (recoveryDone_.valid()) {
+    recoveryDone_.wait();
+  }
+}
+
 void SsdFile::pinRegion(uint64_t offset) {
   std::lock_guard<std::mutex> l(mutex_);
   pinRegionLocked(offset);
@@ -184,7 +214,22 @@ void addEntryToIovecs(AsyncDataCacheEntry& entry, std::vector<iovec>& iovecs) {
 }
 } // namespace
 
+// static
+uint32_t SsdFile::checksum(const AsyncDataCacheEntry& entry) {
+  std::vector<iovec> iovecs;
+  addEntryToIovecs(const_cast<AsyncDataCacheEntry&>(entry), iovecs);
+  uint32_t crc = 0;
+  for (const auto& iov : iovecs) {
+    crc = folly::crc32c(
+        reinterpret_cast<const uint8_t*>(iov.iov_base), iov.iov_len, crc);
+  }
+  return crc;
+}
+
 SsdPin SsdFile::find(RawFileCacheKey key) {
+  if (recovering_) {
+    return SsdPin();
+  }
   FileCacheKey ssdKey{StringIdLease(fileIds(), key.fileNum), key.offset};
   SsdRun run;
   {
@@ -204,6 +249,9 @@ SsdPin SsdFile::find(RawFileCacheKey key) {
 }
 
 bool SsdFile::erase(RawFileCacheKey key) {
+  if (recovering_) {
+    return false;
+  }
   FileCacheKey ssdKey{StringIdLease(fileIds(), key.fileNum), key.offset};
   std::lock_guard<std::mutex> l(mutex_);
   auto it = entries_.find(ssdKey);
@@ -241,7 +289,9 @@ CoalesceIoStats SsdFile::load(
   }
   // Do coalesced IO for the pins. For short payloads, the break-even
   // between discrete pread calls and a single preadv that discards
-  // gaps is ~25K per gap. For longer payloads this is ~50-100K.
+  // gaps is ~25K per gap. For longer payloads this is ~50-100K. The
+  // coalesced reads are collected and submitted together.
+  std::vector<SsdIoRequest> requests;
   auto stats = readPins(
       pins,
       payloadTotal / pins.size() < 10000 ? 25000 : 50000,
@@ -255,8 +305,40 @@ CoalesceIoStats SsdFile::load(
           int32_t /*end*/,
           uint64_t offset,
           const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
+        requests.emplace_back();
+        requests.back().offset = offset;
+        SsdFileIo::appendIovecs(buffers, requests.back());
       });
+  io_->read(requests);
+  for (const auto& request : requests) {
+    if (FOLLY_UNLIKELY(!request.ok)) {
+      ++stats_.readSsdErrors;
+      VELOX_FAIL(
+          "IOERR: Failed to read {} bytes at {} from SSD cache file {}",
+          request.bytes(),
+          request.offset,
+          filename_);
+    }
+  }
+  if (checksumEntries_) {
+    for (auto i = 0; i < ssdPins.size(); ++i) {
+      const auto run = ssdPins[i].run();
+      auto entry = pins[i].checkedEntry();
+      // A prefix of an entry cannot be checked.
+      if (run.checksum() == 0 || run.size() != entry->size() ||
+          checksum(*entry) == run.checksum()) {
+        continue;
+      }
+      ++stats_.readSsdChecksumErrors;
+      erase(RawFileCacheKey{
+          entry->key().fileNum.id(), static_cast<uint64_t>(entry->offset())});
+      VELOX_FAIL(
+          "IOERR: Checksum mismatch for {} bytes at {} in SSD cache file {}",
+          run.size(),
+          run.offset(),
+          filename_);
+    }
+  }
 
   for (auto i = 0; i < ssdPins.size(); ++i) {
     pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
@@ -264,12 +346,6 @@ CoalesceIoStats SsdFile::load(
   return stats;
 }
 
-void SsdFile::read(
-    uint64_t offset,
-    const std::vector<folly::Range<char*>>& buffers) {
-  readFile_->preadv(offset, buffers);
-}
-
 std::optional<std::pair<uint64_t, int32_t>> SsdFile::getSpace(
     const std::vector<CachePin>& pins,
     int32_t begin) {
@@ -359,6 +435,10 @@ void SsdFile::clearRegionEntriesLocked(
 }
 
 void SsdFile::write(std::vector<CachePin>& pins) {
+  if (recovering_) {
+    // The entries are not written. They may be written when evicted again.
+    return;
+  }
   // Sorts the pins by their file/offset. In this way what is ajacent
   // in storage is likely adjacent on SSD.
   std::sort(pins.begin(), pins.end());
@@ -368,56 +448,88 @@ void SsdFile::write(std::vector<CachePin>& pins) {
     VELOX_CHECK_NULL(entry->ssdFile());
     total += entry->size();
   }
+  // Reserves space for as many pins as fit and collects a write per
+  // contiguous range of space. The writes are submitted as one batch.
+  struct Segment {
+    int32_t begin;
+    int32_t numPins;
+  };
+  std::vector<Segment> segments;
+  std::vector<SsdIoRequest> requests;
+  // CRC32C of the data of each pin, if checksums are on.
+  std::vector<uint32_t> checksums(checksumEntries_ ? pins.size() : 0);
   int32_t storeIndex = 0;
   while (storeIndex < pins.size()) {
     auto space = getSpace(pins, storeIndex);
 
     if (!space.has_value()) {
-      // No space can be reclaimed. The pins are freed when the caller is freed.
-      return;
+      // No space can be reclaimed. The pins that did not get space are freed
+      // when the caller is freed.
+      break;
     }
     auto [offset, available] = space.value();
     int32_t numWritten = 0;
     int32_t bytes = 0;
-    std::vector<iovec> iovecs;
+    SsdIoRequest request;
+    request.offset = offset;
     for (auto i = storeIndex; i < pins.size(); ++i) {
       auto entry = pins[i].checkedEntry();
       auto entrySize = entry->size();
       if (bytes + entrySize > available) {
         break;
       }
-      addEntryToIovecs(*entry, iovecs);
+      addEntryToIovecs(*entry, request.iovecs);
+      if (checksumEntries_) {
+        checksums[i] = checksum(*entry);
+      }
       bytes += entrySize;
       ++numWritten;
     }
     VELOX_CHECK_GE(fileSize_, offset + bytes);
-    auto rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
-    if (rc != bytes) {
-      LOG(ERROR) << "Failed to write to SSD: " << folly::errnoStr(errno);
+    segments.push_back({storeIndex, numWritten});
+    requests.push_back(std::move(request));
+    storeIndex += numWritten;
+  }
+  io_->write(requests);
+
+  for (auto segmentIndex = 0; segmentIndex < segments.size(); ++segmentIndex) {
+    const auto& segment = segments[segmentIndex];
+    auto offset = requests[segmentIndex].offset;
+    if (!requests[segmentIndex].ok) {
+      LOG(ERROR) << "Failed to write to SSD at " << offset;
       ++stats_.writeSsdErrors;
-      // If the write fails we return without adding the pins to the cache. The
-      // entries are unchanged.
-      return;
+      // If the write fails the pins are not added to the cache. The entries
+      // are unchanged.
+      continue;
     }
-    {
-      std::lock_guard<std::mutex> l(mutex_);
-      for (auto i = storeIndex; i < storeIndex + numWritten; ++i) {
-        auto entry = pins[i].checkedEntry();
-        entry->setSsdFile(this, offset);
-        auto size = entry->size();
-        FileCacheKey key = {
-            entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
-        entries_[std::move(key)] = SsdRun(offset, size);
-        if (FLAGS_ssd_verify_write) {
-          verifyWrite(*entry, SsdRun(offset, size));
-        }
-        offset += size;
-        ++stats_.entriesWritten;
-        stats_.bytesWritten += size;
-        bytesAfterCheckpoint_ += size;
+    std::lock_guard<std::mutex> l(mutex_);
+    // New entries are logged if there is a checkpoint to recover from.
+    const bool logEntries = checkpointIntervalBytes_ && !checkpointDeleted_;
+    std::string log;
+    for (auto i = segment.begin; i < segment.begin + segment.numPins; ++i) {
+      auto entry = pins[i].checkedEntry();
+      entry->setSsdFile(this, offset);
+      auto size = entry->size();
+      FileCacheKey key = {
+          entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
+      SsdRun run(offset, size, checksumEntries_ ? checksums[i] : 0);
+      if (logEntries) {
+        logEntryLocked(key, run, log);
       }
+      entries_[std::move(key)] = run;
+      if (FLAGS_ssd_verify_write) {
+        verifyWrite(*entry, run);
+      }
+      offset += size;
+      ++stats_.entriesWritten;
+      stats_.bytesWritten += size;
+      bytesAfterCheckpoint_ += size;
+    }
+    // The entry records are not synced. An entry whose record is lost in a
+    // crash is not recovered.
+    if (!log.empty() && !writeLog(log, false)) {
+      checkpointError(-1, "Failed to log new entries");
     }
-    storeIndex += numWritten;
   }
 
   if (checkpointIntervalBytes_ &&
@@ -466,6 +578,16 @@ void SsdFile::verifyWrite(AsyncDataCacheEntry& entry, SsdRun ssdRun) {
   }
 }
 
+void SsdFile::appendAffinity(CacheAffinityCollector& collector) const {
+  if (recovering_) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& [key, run] : entries_) {
+    collector.add(key.fileNum.id(), key.offset, run.size(), true);
+  }
+}
+
 void SsdFile::updateStats(SsdCacheStats& stats) const {
   // Lock only in tsan build. Incrementing the counters has no synchronized
   // emantics.
@@ -491,9 +613,13 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   stats.writeCheckpointErrors += stats_.writeCheckpointErrors;
   stats.readSsdErrors += stats_.readSsdErrors;
   stats.readCheckpointErrors += stats_.readCheckpointErrors;
+  stats.readSsdChecksumErrors += stats_.readSsdChecksumErrors;
+  stats.numRecoveredEntries += stats_.numRecoveredEntries;
+  stats.recoveryMicros += stats_.recoveryMicros;
 }
 
 void SsdFile::clear() {
+  waitForRecovery();
   std::lock_guard<std::mutex> l(mutex_);
   entries_.clear();
   std::fill(regionSize_.begin(), regionSize_.end(), 0);
@@ -502,6 +628,7 @@ void SsdFile::clear() {
 }
 
 void SsdFile::deleteFile() {
+  waitForRecovery();
   if (fd_) {
     close(fd_);
     fd_ = 0;
@@ -514,14 +641,72 @@ void SsdFile::deleteFile() {
 
 void SsdFile::logEviction(const std::vector<int32_t>& regions) {
   if (checkpointIntervalBytes_) {
-    int32_t rc = ::write(
-        evictLogFd_, regions.data(), regions.size() * sizeof(regions[0]));
-    if (rc != regions.size() * sizeof(regions[0])) {
-      checkpointError(rc, "Failed to log eviction");
+    std::string log;
+    for (auto region : regions) {
+      LogRecord record{};
+      record.kind = LogRecord::kEvict;
+      record.offset = region;
+      appendLogRecord(record, {}, log);
+    }
+    // The eviction must be durable before the regions are overwritten.
+    // Otherwise a recovery could find entries of the checkpoint in them.
+    if (!writeLog(log, true)) {
+      checkpointError(-1, "Failed to log eviction");
     }
   }
 }
 
+void SsdFile::logEntryLocked(
+    const FileCacheKey& key,
+    SsdRun run,
+    std::string& out) {
+  const auto id = key.fileNum.id();
+  if (loggedFileIds_.find(id) == loggedFileIds_.end()) {
+    const auto name = fileIds().string(id);
+    LogRecord record{};
+    record.kind = LogRecord::kFileName;
+    record.fileNum = id;
+    record.offset = name.size();
+    appendLogRecord(record, name, out);
+    loggedFileIds_.emplace(id, key.fileNum);
+  }
+  LogRecord record{};
+  record.kind = LogRecord::kEntry;
+  record.entryChecksum = run.checksum();
+  record.fileNum = id;
+  record.offset = key.offset;
+  record.runBits = run.bits();
+  appendLogRecord(record, {}, out);
+}
+
+uint32_t SsdFile::LogRecord::computeChecksum(std::string_view name) const {
+  auto copy = *this;
+  copy.checksum = 0;
+  auto crc = folly::crc32c(
+      reinterpret_cast<const uint8_t*>(&copy), sizeof(copy), 0);
+  return folly::crc32c(
+      reinterpret_cast<const uint8_t*>(name.data()), name.size(), crc);
+}
+
+void SsdFile::appendLogRecord(
+    LogRecord record,
+    std::string_view name,
+    std::string& out) const {
+  record.generation = checkpointGeneration_;
+  record.checksum = record.computeChecksum(name);
+  out.append(reinterpret_cast<const char*>(&record), sizeof(record));
+  out.append(name.data(), name.size());
+}
+
+bool SsdFile::writeLog(const std::string& data, bool sync) {
+  // The log is opened with O_APPEND, so the write goes after the last record
+  // also after a truncation by checkpoint().
+  if (::write(evictLogFd_, data.data(), data.size()) != data.size()) {
+    return false;
+  }
+  return !sync || fdatasync(evictLogFd_) == 0;
+}
+
 void SsdFile::deleteCheckpoint(bool keepLog) {
   if (checkpointDeleted_) {
     return;
@@ -572,9 +757,14 @@ inline const char* asChar(const T* ptr) {
 
 void SsdFile::checkpoint(bool force) {
   std::lock_guard<std::mutex> l(mutex_);
-  if (!force && bytesAfterCheckpoint_ < checkpointIntervalBytes_) {
+  if (recovering_ ||
+      (!force && bytesAfterCheckpoint_ < checkpointIntervalBytes_)) {
     return;
   }
+  checkpointLocked();
+}
+
+void SsdFile::checkpointLocked() {
   checkpointDeleted_ = false;
   bytesAfterCheckpoint_ = 0;
   try {
@@ -590,26 +780,32 @@ void SsdFile::checkpoint(bool force) {
     auto checkpointPath = fileName_ + kCheckpointExtension;
     state.exceptions(std::ofstream::failbit);
     state.open(checkpointPath, std::ios_base::out | std::ios_base::trunc);
+    // The log records of the previous checkpoint are ignored from here on.
+    ++checkpointGeneration_;
     // The checkpoint state file contains:
     // int32_t The 4 bytes of kCheckpointMagic,
     // int32_t maxRegions,
     // int32_t numRegions,
+    // uint32_t generation,
     // regionScores from the 'tracker_',
     // {fileId, fileName} pairs,
     // kMapMarker,
-    // {fileId, offset, SSdRun} triples,
+    // {fileId, offset, SSdRun, checksum} quadruples,
     // kEndMarker.
     state.write(kCheckpointMagic, sizeof(int32_t));
     state.write(asChar(&maxRegions_), sizeof(maxRegions_));
     state.write(asChar(&numRegions_), sizeof(numRegions_));
+    state.write(
+        asChar(&checkpointGeneration_), sizeof(checkpointGeneration_));
 
     // Copy the region scores before writing out for tsan.
     auto scoresCopy = tracker_.copyScores();
     state.write(asChar(scoresCopy.data()), maxRegions_ * sizeof(uint64_t));
-    std::unordered_set<uint64_t> fileNums;
-    for (auto pair : entries_) {
+    // The log after this checkpoint does not repeat the names written here.
+    loggedFileIds_.clear();
+    for (auto& pair : entries_) {
       auto fileNum = pair.first.fileNum.id();
-      if (fileNums.insert(fileNum).second) {
+      if (loggedFileIds_.emplace(fileNum, pair.first.fileNum).second) {
         state.write(asChar(&fileNum), sizeof(fileNum));
         auto name = fileIds().string(fileNum);
         int32_t length = name.size();
@@ -625,6 +821,8 @@ void SsdFile::checkpoint(bool force) {
       state.write(asChar(&pair.first.offset), sizeof(pair.first.offset));
       auto offsetAndSize = pair.second.bits();
       state.write(asChar(&offsetAndSize), sizeof(offsetAndSize));
+      auto checksum = pair.second.checksum();
+      state.write(asChar(&checksum), sizeof(checksum));
     }
     const auto endMarker = kCheckpointEndMarker;
     state.write(asChar(&endMarker), sizeof(endMarker));
@@ -667,15 +865,9 @@ void SsdFile::initializeCheckpoint() {
   if (!checkpointIntervalBytes_) {
     return;
   }
-  bool hasCheckpoint = true;
-  std::ifstream state(fileName_ + kCheckpointExtension);
-  if (!state.is_open()) {
-    hasCheckpoint = false;
-    ++stats_.openCheckpointErrors;
-    LOG(INFO) << "Starting shard " << shardId_ << " without checkpoint";
-  }
   auto logPath = fileName_ + kLogExtension;
-  evictLogFd_ = open(logPath.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  evictLogFd_ =
+      open(logPath.c_str(), O_CREAT | O_RDWR | O_APPEND, S_IRUSR | S_IWUSR);
   if (evictLogFd_ < 0) {
     ++stats_.openLogErrors;
   }
@@ -687,21 +879,47 @@ void SsdFile::initializeCheckpoint() {
       logPath,
       evictLogFd_);
 
+  if (!executor_ || !FLAGS_ssd_lazy_recovery) {
+    recover();
+    return;
+  }
+  // Reading the checkpoint and log of a large file takes seconds. The file
+  // serves as empty until then.
+  recovering_ = true;
+  auto done = std::make_shared<std::promise<void>>();
+  recoveryDone_ = done->get_future().share();
+  executor_->add([this, done]() {
+    recover();
+    recovering_ = false;
+    done->set_value();
+  });
+}
+
+void SsdFile::recover() {
+  std::ifstream state(fileName_ + kCheckpointExtension);
+  if (!state.is_open()) {
+    ++stats_.openCheckpointErrors;
+    LOG(INFO) << "Starting shard " << shardId_ << " without checkpoint";
+    // A log without checkpoint is not usable.
+    ftruncate(evictLogFd_, 0);
+    return;
+  }
+  const auto startMicros = getCurrentTimeMicro();
   try {
-    if (hasCheckpoint) {
-      state.exceptions(std::ifstream::failbit);
-      readCheckpoint(state);
-    }
+    state.exceptions(std::ifstream::failbit);
+    readCheckpoint(state);
   } catch (const std::exception& e) {
     ++stats_.readCheckpointErrors;
     try {
       LOG(ERROR) << "Error recovering from checkpoint " << e.what()
                  << ": Starting without checkpoint";
+      std::lock_guard<std::mutex> l(mutex_);
       entries_.clear();
       deleteCheckpoint(true);
     } catch (const std::exception& e) {
     }
   }
+  stats_.recoveryMicros += getCurrentTimeMicro() - startMicros;
 }
 
 bool SsdFile::testingIsCowDisabled() const {
@@ -733,13 +951,19 @@ T readNumber(std::ifstream& stream) {
 void SsdFile::readCheckpoint(std::ifstream& state) {
   char magic[4];
   state.read(magic, sizeof(magic));
-  VELOX_CHECK(strncmp(magic, kCheckpointMagic, 4) == 0);
+  const bool hasLogRecords = strncmp(magic, kCheckpointMagic, 4) == 0;
+  VELOX_CHECK(hasLogRecords || strncmp(magic, kCheckpointMagicV1, 4) == 0);
   auto maxRegions = readNumber<int32_t>(state);
   VELOX_CHECK_EQ(
       maxRegions,
       maxRegions_,
       "Trying to start from checkpoint with a different capacity");
-  numRegions_ = readNumber<int32_t>(state);
+  // The file may have grown after the checkpoint. The regions past the
+  // checkpoint can only have entries from the log.
+  auto numRegions = readNumber<int32_t>(state);
+  VELOX_CHECK_LE(
+      numRegions, numRegions_, "Cache file is shorter than its checkpoint");
+  const auto generation = hasLogRecords ? readNumber<uint32_t>(state) : 0;
   std::vector<int64_t> scores(maxRegions);
   state.read(asChar(scores.data()), maxRegions_ * sizeof(uint64_t));
   std::unordered_map<uint64_t, StringIdLease> idMap;
@@ -755,44 +979,130 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     idMap[id] = std::move(lease);
   }
   auto logSize = lseek(evictLogFd_, 0, SEEK_END);
-  std::vector<uint32_t> evicted(logSize / sizeof(uint32_t));
-  auto rc = ::pread(evictLogFd_, evicted.data(), logSize, 0);
+  std::string log(logSize, '\0');
+  auto rc = ::pread(evictLogFd_, log.data(), logSize, 0);
   VELOX_CHECK_EQ(logSize, rc, "Failed to read eviction log");
   std::unordered_set<uint32_t> evictedMap;
-  for (auto region : evicted) {
-    evictedMap.insert(region);
+  if (!hasLogRecords) {
+    // A version 1 log has the indices of evicted regions.
+    for (auto i = 0; i + sizeof(uint32_t) <= log.size();
+         i += sizeof(uint32_t)) {
+      evictedMap.insert(*reinterpret_cast<const uint32_t*>(log.data() + i));
+    }
   }
+  folly::F14FastMap<FileCacheKey, SsdRun> entries;
   for (;;) {
     uint64_t fileNum = readNumber<uint64_t>(state);
     if (fileNum == kCheckpointEndMarker) {
       break;
     }
     uint64_t offset = readNumber<uint64_t>(state);
-    auto run = SsdRun(readNumber<uint64_t>(state));
+    auto bits = readNumber<uint64_t>(state);
+    auto run = SsdRun(bits, hasLogRecords ? readNumber<uint32_t>(state) : 0);
     // Check that the recovered entry does not fall in an evicted region.
     if (evictedMap.find(regionIndex(run.offset())) == evictedMap.end()) {
       // The file may have a different id on restore.
       auto it = idMap.find(fileNum);
       VELOX_CHECK(it != idMap.end());
       FileCacheKey key{it->second, offset};
-      entries_[std::move(key)] = run;
+      entries[std::move(key)] = run;
+    }
+  }
+
+  // Replays the evictions and new entries after the checkpoint.
+  uint64_t logOffset = 0;
+  while (hasLogRecords && logOffset + sizeof(LogRecord) <= log.size()) {
+    LogRecord record;
+    memcpy(&record, log.data() + logOffset, sizeof(record));
+    std::string_view name;
+    if (record.kind == LogRecord::kFileName) {
+      if (logOffset + sizeof(record) + record.offset > log.size()) {
+        break;
+      }
+      name = std::string_view(
+          log.data() + logOffset + sizeof(record), record.offset);
+    }
+    if (record.generation != generation ||
+        record.checksum != record.computeChecksum(name)) {
+      break;
+    }
+    logOffset += sizeof(record) + name.size();
+    switch (record.kind) {
+      case LogRecord::kEvict: {
+        const int32_t region = record.offset;
+        evictedMap.insert(region);
+        for (auto it = entries.begin(); it != entries.end();) {
+          if (regionIndex(it->second.offset()) == region) {
+            it = entries.erase(it);
+          } else {
+            ++it;
+          }
+        }
+        break;
+      }
+      case LogRecord::kEntry: {
+        auto it = idMap.find(record.fileNum);
+        VELOX_CHECK(it != idMap.end(), "Log entry for a file with no name");
+        FileCacheKey key{it->second, record.offset};
+        entries[std::move(key)] =
+            SsdRun(record.runBits, record.entryChecksum);
+        break;
+      }
+      case LogRecord::kFileName:
+        idMap[record.fileNum] = StringIdLease(fileIds(), name);
+        break;
+      default:
+        VELOX_FAIL("Bad SSD cache log record kind {}", record.kind);
+    }
+  }
+  if (hasLogRecords && logOffset < log.size()) {
+    // A crash while appending leaves an incomplete last record. New records
+    // go after the last good one.
+    LOG(WARNING) << "Ignoring " << log.size() - logOffset
+                 << " bytes at the end of SSD cache log of shard " << shardId_;
+    VELOX_CHECK_EQ(0, ftruncate(evictLogFd_, logOffset));
+  }
+
+  std::vector<uint32_t> regionSizes(maxRegions_);
+  for (auto it = entries.begin(); it != entries.end();) {
+    const auto region = regionIndex(it->second.offset());
+    if (region >= numRegions_) {
+      it = entries.erase(it);
+      continue;
     }
+    regionSizes[region] = std::max<uint32_t>(
+        regionSizes[region],
+        it->second.offset() + it->second.size() - region * kRegionSize);
+    ++it;
   }
-  // The state is successfully read. Install the access frequency scores and
-  // evicted regions.
+  // The state is successfully read. Install the entries, access frequency
+  // scores and evicted regions.
   VELOX_CHECK_EQ(scores.size(), tracker_.regionScores().size());
-  // Set the writable regions by deduplicated evicted regions.
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_ = std::move(entries);
+  regionSize_ = std::move(regionSizes);
+  // Evicted regions continue to be filled from their last entry. Regions
+  // with no entries are writable too.
   writableRegions_.clear();
-  for (auto region : evictedMap) {
-    writableRegions_.push_back(region);
+  for (auto region = 0; region < numRegions_; ++region) {
+    if (evictedMap.count(region) > 0 || regionSize_[region] == 0) {
+      writableRegions_.push_back(region);
+    }
   }
   tracker_.setRegionScores(scores);
+  checkpointGeneration_ = generation;
+  stats_.numRecoveredEntries += entries_.size();
   LOG(INFO) << fmt::format(
       "Starting shard {} from checkpoint with {} entries, {} regions with {} free.",
       shardId_,
       entries_.size(),
       numRegions_,
       writableRegions_.size());
+  if (!hasLogRecords) {
+    // Rewrites the checkpoint in the current format and clears the version 1
+    // log, so that new records can be appended.
+    checkpointLocked();
+  }
 }
 
 } // namespace facebook::velox::cache
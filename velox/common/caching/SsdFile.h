@@ -17,41 +17,52 @@
 #pragma once
 
 #include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/caching/SsdFileIo.h"
 #include "velox/common/caching/SsdFileTracker.h"
 #include "velox/common/file/File.h"
 
 #include <gflags/gflags.h>
 
+#include <future>
+
 DECLARE_bool(ssd_odirect);
 DECLARE_bool(ssd_verify_write);
+DECLARE_bool(ssd_io_uring);
+DECLARE_bool(ssd_checksum);
+DECLARE_bool(ssd_lazy_recovery);
+DECLARE_int32(ssd_io_uring_depth);
 
 namespace facebook::velox::cache {
 
 // A 64 bit word describing a SSD cache entry in an SsdFile. The low
 // 23 bits are the size, for a maximum entry size of 8MB. The high
-// bits are the offset.
+// bits are the offset. Comes with a CRC32C of the entry's data, 0 if not
+// known.
 class SsdRun {
  public:
   static constexpr int32_t kSizeBits = 23;
 
   SsdRun() : bits_(0) {}
 
-  SsdRun(uint64_t offset, uint32_t size)
-      : bits_((offset << kSizeBits) | ((size - 1))) {
+  SsdRun(uint64_t offset, uint32_t size, uint32_t checksum = 0)
+      : bits_((offset << kSizeBits) | ((size - 1))), checksum_(checksum) {
     VELOX_CHECK_LT(offset, 1L << (64 - kSizeBits));
     VELOX_CHECK_LT(size - 1, 1 << kSizeBits);
   }
 
-  SsdRun(uint64_t bits) : bits_(bits) {}
+  SsdRun(uint64_t bits, uint32_t checksum = 0)
+      : bits_(bits), checksum_(checksum) {}
 
   SsdRun(const SsdRun& other) = default;
   SsdRun(SsdRun&& other) = default;
 
   void operator=(const SsdRun& other) {
     bits_ = other.bits_;
+    checksum_ = other.checksum_;
   }
   void operator=(SsdRun&& other) {
     bits_ = other.bits_;
+    checksum_ = other.checksum_;
   }
 
   uint64_t offset() const {
@@ -67,8 +78,13 @@ class SsdRun {
     return bits_;
   }
 
+  uint32_t checksum() const {
+    return checksum_;
+  }
+
  private:
   uint64_t bits_;
+  uint32_t checksum_{0};
 };
 
 // Represents an SsdFile entry that is planned for load or being
@@ -144,6 +160,9 @@ struct SsdCacheStats {
     writeCheckpointErrors = tsanAtomicValue(other.writeCheckpointErrors);
     readSsdErrors = tsanAtomicValue(other.readSsdErrors);
     readCheckpointErrors = tsanAtomicValue(other.readCheckpointErrors);
+    readSsdChecksumErrors = tsanAtomicValue(other.readSsdChecksumErrors);
+    numRecoveredEntries = tsanAtomicValue(other.numRecoveredEntries);
+    recoveryMicros = tsanAtomicValue(other.recoveryMicros);
   }
 
   tsan_atomic<uint64_t> entriesWritten{0};
@@ -163,6 +182,12 @@ struct SsdCacheStats {
   tsan_atomic<uint32_t> writeCheckpointErrors{0};
   tsan_atomic<uint32_t> readSsdErrors{0};
   tsan_atomic<uint32_t> readCheckpointErrors{0};
+  // Number of entries dropped because their data did not match the checksum.
+  tsan_atomic<uint32_t> readSsdChecksumErrors{0};
+  // Number of entries recovered from checkpoint and log at startup.
+  tsan_atomic<uint64_t> numRecoveredEntries{0};
+  // Time spent in recovering from checkpoint and log.
+  tsan_atomic<uint64_t> recoveryMicros{0};
 };
 
 // A shard of SsdCache. Corresponds to one file on SSD.  The data
@@ -177,8 +202,11 @@ class SsdFile {
  public:
   static constexpr uint64_t kRegionSize = 1 << 26; // 64MB
 
-  // Constructs a cache backed by filename. Discards any previous
-  // contents of filename.
+  // Constructs a cache backed by filename. If 'checkpointIntervalBytes' is
+  // non-0, recovers the entries of a previous instance from its checkpoint
+  // and log. The recovery runs on 'executor' if given and
+  // FLAGS_ssd_lazy_recovery is set. The file then serves as empty until the
+  // recovery is done. Otherwise discards any previous contents of filename.
   SsdFile(
       const std::string& filename,
       int32_t shardId,
@@ -187,6 +215,9 @@ class SsdFile {
       bool disableFileCow = false,
       folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
+  // Waits for a background recovery to finish.
+  ~SsdFile();
+
   // Adds entries of  'pins'  to this file. 'pins' must be in read mode and
   // those pins that are successfully added to SSD are marked as being on SSD.
   // The file of the entries must be a file that is backed by 'this'.
@@ -199,7 +230,10 @@ class SsdFile {
   bool erase(RawFileCacheKey key);
 
   // Copies the data in 'ssdPins' into 'pins'. Coalesces IO for nearby
-  // entries if they are in ascending order and near enough.
+  // entries if they are in ascending order and near enough. The coalesced
+  // reads are issued as one batch, a single system call with io_uring.
+  // Throws if the data of an entry does not match its checksum. The entry is
+  // then erased.
   CoalesceIoStats load(
       const std::vector<SsdPin>& ssdPins,
       const std::vector<CachePin>& pins);
@@ -239,6 +273,10 @@ class SsdFile {
   // Adds 'stats_' to 'stats'.
   void updateStats(SsdCacheStats& stats) const;
 
+  // Adds the entries of 'this' to 'collector'. Adds nothing while
+  // recovering.
+  void appendAffinity(CacheAffinityCollector& collector) const;
+
   // Resets this' to a post-construction empty state. See SsdCache::clear().
   void clear();
 
@@ -248,22 +286,75 @@ class SsdFile {
   // Writes a checkpoint state that can be recovered from. The
   // checkpoint is serialized on 'mutex_'. If 'force' is false,
   // rechecks that at least 'checkpointIntervalBytes_' have been
-  // written since last checkpoint and silently returns if not.
+  // written since last checkpoint and silently returns if not. Between
+  // checkpoints, new entries and evictions are appended to the log, so that
+  // a restart recovers the state as of the last write.
   void checkpoint(bool force = false);
 
+  // True while the entries of a previous instance are being recovered.
+  bool recovering() const {
+    return recovering_;
+  }
+
+  // Waits for a background recovery to finish.
+  void waitForRecovery();
+
   /// Returns true if copy on write is disabled for this file. Used in testing.
   bool testingIsCowDisabled() const;
 
+  // Registers 'buffers' for fixed buffer IO, see SsdFileIo. Returns false if
+  // the IO backend does not support this.
+  bool registerBuffers(const std::vector<folly::Range<char*>>& buffers) {
+    return io_->registerBuffers(buffers);
+  }
+
+  // Returns the kind of the IO backend, "sync" or "io_uring".
+  std::string ioKind() const {
+    return io_->kind();
+  }
+
  private:
   // 4 first bytes of a checkpoint file. Allows distinguishing between format
-  // versions.
-  static constexpr const char* FOLLY_NONNULL kCheckpointMagic = "CPT1";
+  // versions. Version 1 has no checksums and a log of evicted region indices.
+  // Version 2 has checksums and a log of LogRecords.
+  static constexpr const char* FOLLY_NONNULL kCheckpointMagicV1 = "CPT1";
+  static constexpr const char* FOLLY_NONNULL kCheckpointMagic = "CPT2";
   // Magic number separating file names from cache entry data in checkpoint
   // file.
   static constexpr int64_t kCheckpointMapMarker = 0xfffffffffffffffe;
   // Magic number at end of completed checkpoint file.
   static constexpr int64_t kCheckpointEndMarker = 0xcbedf11e;
 
+  // A record in the log of a version 2 checkpoint. The log has the
+  // evictions and new entries since the checkpoint in the order they
+  // happened. A kFileName record is followed by 'offset' bytes of file name
+  // and gives the name of 'fileNum' for the records that follow it.
+  // 'checksum' is the CRC32C of the other fields and the file name. A
+  // recovery stops at the first incomplete or corrupt record, which can be
+  // left by a crash while appending.
+  struct LogRecord {
+    static constexpr uint32_t kEvict = 1;
+    static constexpr uint32_t kEntry = 2;
+    static constexpr uint32_t kFileName = 3;
+
+    uint32_t kind;
+    // CRC32C of the data of the entry for kEntry.
+    uint32_t entryChecksum;
+    uint32_t checksum;
+    // Low bits of the generation of the checkpoint the record belongs to. A
+    // crash between writing a checkpoint and truncating the log leaves
+    // records of the previous generation, which are ignored.
+    uint32_t generation;
+    uint64_t fileNum;
+    // Region index for kEvict, offset in 'fileNum' for kEntry.
+    uint64_t offset;
+    // SsdRun bits for kEntry.
+    uint64_t runBits;
+
+    // Returns the CRC32C of 'this' with 0 as 'checksum' and of 'name'.
+    uint32_t computeChecksum(std::string_view name) const;
+  };
+
   // Increments the pin count of the region of 'offset'. Caller must hold
   // 'mutex_'.
   void pinRegionLocked(uint64_t offset) {
@@ -287,8 +378,6 @@ class SsdFile {
   // added to 'writableRegions_'. Returns true if regions could be cleared.
   bool growOrEvictLocked();
 
-  // Reads the backing file with ReadFile::preadv().
-  void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
   // Verifies that 'entry' has the data at 'run'.
   void verifyWrite(AsyncDataCacheEntry& entry, SsdRun run);
@@ -297,11 +386,36 @@ class SsdFile {
   // eviction log and leaves this open.
   void deleteCheckpoint(bool keepLog = false);
 
-  // Reads a checkpoint state file and sets 'this' accordingly if read
-  // is successful. Return true for successful read. A failed read
-  // deletes the checkpoint and leaves the log truncated open.
+  // Reads a checkpoint state file and the log and sets 'this' accordingly if
+  // read is successful. Throws if the checkpoint is not readable.
   void readCheckpoint(std::ifstream& state);
 
+  // Recovers from the checkpoint, if any. A failed read deletes the
+  // checkpoint and leaves the log truncated open.
+  void recover();
+
+  // Appends a log record for 'key' at 'run' to 'out'. Adds a record for the
+  // file name if the log or checkpoint does not have one. Caller must hold
+  // 'mutex_'.
+  void logEntryLocked(const FileCacheKey& key, SsdRun run, std::string& out);
+
+  // Appends 'record' and 'name' to 'out' with the generation and checksum of
+  // 'record' set.
+  void appendLogRecord(
+      LogRecord record,
+      std::string_view name,
+      std::string& out) const;
+
+  // Writes 'data' at the end of the log. Syncs the log if 'sync' is true.
+  // Returns false on error.
+  bool writeLog(const std::string& data, bool sync);
+
+  // Makes a checkpoint. Caller must hold 'mutex_'.
+  void checkpointLocked();
+
+  // Returns the CRC32C of the data of 'entry'.
+  static uint32_t checksum(const AsyncDataCacheEntry& entry);
+
   // Logs an error message, deletes the checkpoint and stop making new
   // checkpoints.
   void checkpointError(int32_t rc, const std::string& error);
@@ -314,7 +428,7 @@ class SsdFile {
   void initializeCheckpoint();
 
   // Synchronously logs that 'regions' are no longer valid in a possibly xisting
-  // checkpoint.
+  // checkpoint. The log is synced before the regions are rewritten.
   void logEviction(const std::vector<int32_t>& regions);
 
   // Serializes access to all private data members.
@@ -365,8 +479,8 @@ class SsdFile {
   // Size of the backing file in bytes. Must be multiple of kRegionSize.
   uint64_t fileSize_{0};
 
-  // ReadFile made from 'fd_'.
-  std::unique_ptr<ReadFile> readFile_;
+  // Issues the reads and writes of cache entries on 'fd_'.
+  std::unique_ptr<SsdFileIo> io_;
 
   // Counters.
   SsdCacheStats stats_;
@@ -382,11 +496,25 @@ class SsdFile {
   // Count of bytes written after last checkpoint.
   std::atomic<uint64_t> bytesAfterCheckpoint_{0};
 
-  // fd for logging evictions.
+  // fd for logging evictions and new entries. Opened for append.
   int32_t evictLogFd_{0};
 
   // True if there was an error with checkpoint and the checkpoint was deleted.
   bool checkpointDeleted_{false};
+
+  // Incremented for each checkpoint. Tags the records of the log.
+  uint32_t checkpointGeneration_{0};
+
+  // File ids that have a name in the checkpoint or the log. Holds leases so
+  // that the ids are not reused for other files until the next checkpoint.
+  folly::F14FastMap<uint64_t, StringIdLease> loggedFileIds_;
+
+  // True if checksums of entries are kept.
+  const bool checksumEntries_;
+
+  std::atomic<bool> recovering_{false};
+  // Realized when a background recovery finishes.
+  std::shared_future<void> recoveryDone_;
 };
 
 } // namespace facebook::velox::cache
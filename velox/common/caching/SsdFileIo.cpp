@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/SsdFileIo.h"
+#include "velox/common/base/Exceptions.h"
+
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace facebook::velox::cache {
+
+uint64_t SsdIoRequest::bytes() const {
+  uint64_t total = 0;
+  for (const auto& iov : iovecs) {
+    total += iov.iov_len;
+  }
+  return total;
+}
+
+void SsdFileIo::read(std::vector<SsdIoRequest>& requests) {
+  for (auto& request : requests) {
+    request.ok = readSync(request);
+  }
+}
+
+void SsdFileIo::write(std::vector<SsdIoRequest>& requests) {
+  for (auto& request : requests) {
+    request.ok = writeSync(request);
+  }
+}
+
+void SsdFileIo::appendIovecs(
+    const std::vector<folly::Range<char*>>& buffers,
+    SsdIoRequest& request) {
+  // Dropped bytes sized so that a typical gap of 25-50K is not too many
+  // iovecs. The content is never looked at, so concurrent requests may share
+  // it.
+  static thread_local std::vector<char> droppedBytes(16 * 1024);
+  request.iovecs.reserve(request.iovecs.size() + buffers.size());
+  for (const auto& range : buffers) {
+    if (range.data() != nullptr) {
+      request.iovecs.push_back({range.data(), range.size()});
+      continue;
+    }
+    auto skipSize = range.size();
+    while (skipSize > 0) {
+      const auto bytes = std::min<size_t>(droppedBytes.size(), skipSize);
+      request.iovecs.push_back({droppedBytes.data(), bytes});
+      skipSize -= bytes;
+    }
+  }
+}
+
+namespace {
+// Calls preadv() or pwritev() until all of 'iovecs' are transferred.
+bool transferAll(
+    int32_t fd,
+    uint64_t offset,
+    std::vector<iovec> iovecs,
+    bool isWrite) {
+  auto* iov = iovecs.data();
+  auto numIovecs = static_cast<int32_t>(iovecs.size());
+  while (numIovecs > 0) {
+    const auto rc = isWrite ? folly::pwritev(fd, iov, numIovecs, offset)
+                            : folly::preadv(fd, iov, numIovecs, offset);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG(ERROR) << "IOERR: SSD " << (isWrite ? "write" : "read") << " of "
+                 << numIovecs << " ranges at " << offset
+                 << " failed: " << folly::errnoStr(errno);
+      return false;
+    }
+    offset += rc;
+    size_t done = rc;
+    while (numIovecs > 0 && done >= iov->iov_len) {
+      done -= iov->iov_len;
+      ++iov;
+      --numIovecs;
+    }
+    if (done > 0) {
+      iov->iov_base = reinterpret_cast<char*>(iov->iov_base) + done;
+      iov->iov_len -= done;
+    }
+  }
+  return true;
+}
+} // namespace
+
+bool SsdFileIo::readSync(const SsdIoRequest& request) const {
+  return transferAll(fd_, request.offset, request.iovecs, false);
+}
+
+bool SsdFileIo::writeSync(const SsdIoRequest& request) const {
+  return transferAll(fd_, request.offset, request.iovecs, true);
+}
+
+#ifdef VELOX_ENABLE_IO_URING
+namespace {
+
+class IoUringSsdFileIo : public SsdFileIo {
+ public:
+  IoUringSsdFileIo(int32_t fd, int32_t queueDepth)
+      : SsdFileIo(fd), queueDepth_(queueDepth) {}
+
+  // Sets up a first ring. Returns false if the kernel does not allow it.
+  bool init() {
+    auto ring = makeRing();
+    if (ring == nullptr) {
+      return false;
+    }
+    releaseRing(std::move(ring));
+    return true;
+  }
+
+  void read(std::vector<SsdIoRequest>& requests) override {
+    submit(requests, false);
+  }
+
+  void write(std::vector<SsdIoRequest>& requests) override {
+    submit(requests, true);
+  }
+
+  bool registerBuffers(
+      const std::vector<folly::Range<char*>>& buffers) override {
+    std::lock_guard<std::mutex> l(mutex_);
+    buffers_.clear();
+    for (const auto& buffer : buffers) {
+      buffers_.push_back({buffer.data(), buffer.size()});
+    }
+    std::sort(buffers_.begin(), buffers_.end(), [](auto& left, auto& right) {
+      return left.iov_base < right.iov_base;
+    });
+    ++buffersVersion_;
+    return true;
+  }
+
+  std::string kind() const override {
+    return "io_uring";
+  }
+
+ private:
+  // An io_uring with the fixed buffers registered with it. A ring is used
+  // by one thread at a time.
+  struct Ring {
+    ~Ring() {
+      if (initialized) {
+        io_uring_queue_exit(&ring);
+      }
+    }
+
+    io_uring ring;
+    bool initialized{false};
+    // Version of 'buffersVersion_' registered with 'ring'.
+    int64_t buffersVersion{0};
+    // The buffers registered with 'ring', sorted on address.
+    std::vector<iovec> buffers;
+  };
+
+  std::unique_ptr<Ring> makeRing() {
+    auto ring = std::make_unique<Ring>();
+    const auto rc = io_uring_queue_init(queueDepth_, &ring->ring, 0);
+    if (rc < 0) {
+      LOG(WARNING) << "Cannot set up io_uring for SSD cache: "
+                   << folly::errnoStr(-rc);
+      return nullptr;
+    }
+    ring->initialized = true;
+    return ring;
+  }
+
+  // Returns a free ring with the current buffers registered. Makes a new
+  // ring if none is free.
+  std::unique_ptr<Ring> acquireRing() {
+    std::unique_ptr<Ring> ring;
+    std::vector<iovec> buffers;
+    int64_t version;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!freeRings_.empty()) {
+        ring = std::move(freeRings_.back());
+        freeRings_.pop_back();
+      }
+      version = buffersVersion_;
+      if (ring == nullptr || ring->buffersVersion != version) {
+        buffers = buffers_;
+      }
+    }
+    if (ring == nullptr) {
+      ring = makeRing();
+      if (ring == nullptr) {
+        return nullptr;
+      }
+    }
+    if (ring->buffersVersion != version) {
+      if (!ring->buffers.empty()) {
+        io_uring_unregister_buffers(&ring->ring);
+        ring->buffers.clear();
+      }
+      if (!buffers.empty()) {
+        const auto rc = io_uring_register_buffers(
+            &ring->ring, buffers.data(), buffers.size());
+        if (rc == 0) {
+          ring->buffers = std::move(buffers);
+        } else {
+          LOG(WARNING) << "Cannot register SSD cache buffers with io_uring: "
+                       << folly::errnoStr(-rc);
+        }
+      }
+      ring->buffersVersion = version;
+    }
+    return ring;
+  }
+
+  void releaseRing(std::unique_ptr<Ring> ring) {
+    std::lock_guard<std::mutex> l(mutex_);
+    freeRings_.push_back(std::move(ring));
+  }
+
+  // Returns the index of the registered buffer of 'ring' that contains the
+  // single iovec of 'request', -1 if there is none.
+  static int32_t fixedBufferIndex(
+      const Ring& ring,
+      const SsdIoRequest& request) {
+    if (request.iovecs.size() != 1 || ring.buffers.empty()) {
+      return -1;
+    }
+    auto* begin = reinterpret_cast<char*>(request.iovecs[0].iov_base);
+    auto it = std::upper_bound(
+        ring.buffers.begin(),
+        ring.buffers.end(),
+        begin,
+        [](char* address, const iovec& buffer) {
+          return address < reinterpret_cast<char*>(buffer.iov_base);
+        });
+    if (it == ring.buffers.begin()) {
+      return -1;
+    }
+    --it;
+    auto* bufferBegin = reinterpret_cast<char*>(it->iov_base);
+    if (begin + request.iovecs[0].iov_len > bufferBegin + it->iov_len) {
+      return -1;
+    }
+    return it - ring.buffers.begin();
+  }
+
+  // Submits 'requests' in batches of up to 'queueDepth_' and waits for each
+  // batch. A request that fails or completes short is retried synchronously,
+  // so that the error, if any, is the one a synchronous call would see.
+  void submit(std::vector<SsdIoRequest>& requests, bool isWrite) {
+    auto ring = requests.empty() ? nullptr : acquireRing();
+    if (ring == nullptr) {
+      isWrite ? SsdFileIo::write(requests) : SsdFileIo::read(requests);
+      return;
+    }
+    constexpr int64_t kNotCompleted = std::numeric_limits<int64_t>::min();
+    std::vector<int64_t> results;
+    bool ringUsable = true;
+    for (auto begin = 0; begin < requests.size(); begin += queueDepth_) {
+      const int32_t end =
+          std::min<int32_t>(requests.size(), begin + queueDepth_);
+      results.assign(end - begin, kNotCompleted);
+      int32_t numSubmitted = 0;
+      if (ringUsable) {
+        for (auto i = begin; i < end; ++i) {
+          auto* sqe = io_uring_get_sqe(&ring->ring);
+          VELOX_CHECK_NOT_NULL(sqe);
+          prepare(*ring, sqe, requests[i], isWrite);
+          io_uring_sqe_set_data(
+              sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(i - begin)));
+        }
+        const auto rc = io_uring_submit_and_wait(&ring->ring, end - begin);
+        numSubmitted = std::max(rc, 0);
+        if (numSubmitted < end - begin) {
+          // Entries left in the submission queue can't be taken back. The
+          // ring is dropped after the submitted ones complete.
+          LOG(WARNING) << "io_uring_submit_and_wait submitted "
+                       << numSubmitted << " of " << end - begin << ": "
+                       << (rc < 0 ? folly::errnoStr(-rc) : "");
+          ringUsable = false;
+        }
+      }
+      for (auto i = 0; i < numSubmitted; ++i) {
+        io_uring_cqe* cqe;
+        const auto rc = io_uring_wait_cqe(&ring->ring, &cqe);
+        VELOX_CHECK_EQ(rc, 0, "io_uring_wait_cqe: {}", folly::errnoStr(-rc));
+        results[reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe))] =
+            cqe->res;
+        io_uring_cqe_seen(&ring->ring, cqe);
+      }
+      for (auto i = begin; i < end; ++i) {
+        auto& request = requests[i];
+        request.ok =
+            results[i - begin] == static_cast<int64_t>(request.bytes());
+        if (!request.ok) {
+          request.ok = isWrite ? writeSync(request) : readSync(request);
+        }
+      }
+    }
+    if (ringUsable) {
+      releaseRing(std::move(ring));
+    }
+  }
+
+  void prepare(
+      const Ring& ring,
+      io_uring_sqe* sqe,
+      const SsdIoRequest& request,
+      bool isWrite) const {
+    const auto index = fixedBufferIndex(ring, request);
+    if (index >= 0) {
+      const auto& iov = request.iovecs[0];
+      if (isWrite) {
+        io_uring_prep_write_fixed(
+            sqe, fd_, iov.iov_base, iov.iov_len, request.offset, index);
+      } else {
+        io_uring_prep_read_fixed(
+            sqe, fd_, iov.iov_base, iov.iov_len, request.offset, index);
+      }
+      return;
+    }
+    if (isWrite) {
+      io_uring_prep_writev(
+          sqe,
+          fd_,
+          request.iovecs.data(),
+          request.iovecs.size(),
+          request.offset);
+    } else {
+      io_uring_prep_readv(
+          sqe,
+          fd_,
+          request.iovecs.data(),
+          request.iovecs.size(),
+          request.offset);
+    }
+  }
+
+  const int32_t queueDepth_;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Ring>> freeRings_;
+  // Buffers to register, sorted on address.
+  std::vector<iovec> buffers_;
+  int64_t buffersVersion_{0};
+};
+
+} // namespace
+#endif
+
+std::unique_ptr<SsdFileIo>
+SsdFileIo::create(int32_t fd, bool useIoUring, int32_t queueDepth) {
+  VELOX_CHECK_GT(queueDepth, 0);
+#ifdef VELOX_ENABLE_IO_URING
+  if (useIoUring) {
+    auto io = std::make_unique<IoUringSsdFileIo>(fd, queueDepth);
+    if (io->init()) {
+      return io;
+    }
+  }
+#else
+  if (useIoUring) {
+    LOG(WARNING) << "Velox is built without io_uring, using synchronous "
+                 << "SSD cache IO";
+  }
+#endif
+  return std::make_unique<SsdFileIo>(fd);
+}
+
+} // namespace facebook::velox::cache
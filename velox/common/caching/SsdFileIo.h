@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/portability/SysUio.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// A vectored read or write of the bytes of 'iovecs' at 'offset' of an SSD
+// cache file.
+struct SsdIoRequest {
+  uint64_t offset{0};
+  std::vector<iovec> iovecs;
+
+  // Set by SsdFileIo::read() or write(). True if all bytes were transferred.
+  bool ok{false};
+
+  uint64_t bytes() const;
+};
+
+// Issues batches of SsdIoRequests against the file descriptor of an
+// SsdFile. The base implementation makes a preadv() or pwritev() call per
+// request. If Velox is built with VELOX_ENABLE_IO_URING, an io_uring backed
+// implementation submits a whole batch with a single system call and waits
+// for the completions, so that an SSD with a deep queue sees all the
+// requests at once. Thread safe.
+class SsdFileIo {
+ public:
+  // Returns an io_uring backed instance for 'fd' if 'useIoUring' is true, the
+  // build has io_uring support and the kernel allows setting up a ring.
+  // Returns the synchronous implementation otherwise. 'queueDepth' is the
+  // maximum number of requests in flight per ring.
+  static std::unique_ptr<SsdFileIo>
+  create(int32_t fd, bool useIoUring, int32_t queueDepth);
+
+  explicit SsdFileIo(int32_t fd) : fd_(fd) {}
+
+  virtual ~SsdFileIo() = default;
+
+  // Reads all of 'requests' and sets their 'ok'.
+  virtual void read(std::vector<SsdIoRequest>& requests);
+
+  // Writes all of 'requests' and sets their 'ok'.
+  virtual void write(std::vector<SsdIoRequest>& requests);
+
+  // Registers 'buffers', e.g. cache memory from the MemoryAllocator, for
+  // fixed buffer IO. Requests that consist of a single iovec inside a
+  // registered buffer then avoid mapping the pages of the buffer on each IO.
+  // Replaces previously registered buffers. Returns false if not supported.
+  virtual bool registerBuffers(
+      const std::vector<folly::Range<char*>>& /*buffers*/) {
+    return false;
+  }
+
+  virtual std::string kind() const {
+    return "sync";
+  }
+
+  // Appends iovecs for 'buffers' to 'request'. A range with a null data
+  // pointer is a gap between cache entries that is read into a scratch
+  // buffer and dropped.
+  static void appendIovecs(
+      const std::vector<folly::Range<char*>>& buffers,
+      SsdIoRequest& request);
+
+ protected:
+  // Makes a single preadv() or pwritev() call for 'request' and returns
+  // true if all its bytes were transferred.
+  bool readSync(const SsdIoRequest& request) const;
+  bool writeSync(const SsdIoRequest& request) const;
+
+  const int32_t fd_;
+};
+
+} // namespace facebook::velox::cache
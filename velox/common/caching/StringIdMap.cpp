@@ -16,72 +16,101 @@
 
 #include "velox/common/caching/StringIdMap.h"
 
+#include <mutex>
+#include <shared_mutex>
+
 namespace facebook::velox {
 
 uint64_t StringIdMap::id(std::string_view string) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = stringToId_.find(string);
-  if (it != stringToId_.end()) {
+  auto& shard = shards_[shardIndex(string)];
+  std::shared_lock<folly::SharedMutex> l(shard.mutex);
+  auto it = shard.stringToId.find(string);
+  if (it != shard.stringToId.end()) {
     return it->second;
   }
   return kNoId;
 }
 
+std::string StringIdMap::string(uint64_t id) {
+  auto& shard = shardOfId(id);
+  std::shared_lock<folly::SharedMutex> l(shard.mutex);
+  auto* entry = findLocked(shard, id);
+  return entry ? entry->string : "";
+}
+
 void StringIdMap::release(uint64_t id) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = idToString_.find(id);
-  if (it != idToString_.end()) {
-    VELOX_CHECK_LT(
-        0, it->second.numInUse, "Extra release of id in StringIdMap");
-    if (--it->second.numInUse == 0) {
-      pinnedSize_ -= it->second.string.size();
-      auto strIter = stringToId_.find(it->second.string);
-      assert(strIter != stringToId_.end());
-      stringToId_.erase(strIter);
-      idToString_.erase(it);
+  auto& shard = shardOfId(id);
+  {
+    std::shared_lock<folly::SharedMutex> l(shard.mutex);
+    auto* entry = findLocked(shard, id);
+    if (!entry) {
+      return;
     }
+    auto numInUse = entry->numInUse.load();
+    do {
+      VELOX_CHECK_LT(0, numInUse, "Extra release of id in StringIdMap");
+    } while (!entry->numInUse.compare_exchange_weak(numInUse, numInUse - 1));
+    if (numInUse > 1) {
+      return;
+    }
+    pinnedSize_ -= entry->string.size();
+  }
+  // The entry may have been taken into use again or dropped by another
+  // release before the exclusive lock is acquired.
+  std::unique_lock<folly::SharedMutex> l(shard.mutex);
+  auto* entry = findLocked(shard, id);
+  if (entry && entry->numInUse == 0) {
+    shard.stringToId.erase(entry->string);
+    shard.idToEntry.erase(id);
   }
 }
 
 void StringIdMap::addReference(uint64_t id) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = idToString_.find(id);
-  VELOX_CHECK(
-      it != idToString_.end(),
+  auto& shard = shardOfId(id);
+  std::shared_lock<folly::SharedMutex> l(shard.mutex);
+  auto* entry = findLocked(shard, id);
+  VELOX_CHECK_NOT_NULL(
+      entry,
       "Trying to add a reference to id {} that is not in StringIdMap",
       id);
-
-  ++it->second.numInUse;
+  addUse(*entry);
 }
 
 uint64_t StringIdMap::makeId(std::string_view string) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = stringToId_.find(string);
-  if (it != stringToId_.end()) {
-    auto entry = idToString_.find(it->second);
-    VELOX_CHECK(entry != idToString_.end());
-    if (++entry->second.numInUse == 1) {
-      pinnedSize_ += entry->second.string.size();
+  const auto index = shardIndex(string);
+  auto& shard = shards_[index];
+  {
+    std::shared_lock<folly::SharedMutex> l(shard.mutex);
+    auto it = shard.stringToId.find(string);
+    if (it != shard.stringToId.end()) {
+      auto* entry = findLocked(shard, it->second);
+      VELOX_CHECK_NOT_NULL(entry);
+      addUse(*entry);
+      return entry->id;
     }
-
-    return it->second;
   }
-  Entry entry;
-  entry.string = std::string(string);
+  std::unique_lock<folly::SharedMutex> l(shard.mutex);
+  auto it = shard.stringToId.find(string);
+  if (it != shard.stringToId.end()) {
+    auto* entry = findLocked(shard, it->second);
+    VELOX_CHECK_NOT_NULL(entry);
+    addUse(*entry);
+    return entry->id;
+  }
   // Check that we do not use an id twice. In practice this never
   // happens because the int64 counter would have to wrap around for
   // this. Even if this happened, the time spent in the loop would
   // have a low cap since the number of mappings would in practice
   // be in the 100K range.
+  uint64_t id;
   do {
-    entry.id = ++lastId_;
-  } while (idToString_.find(entry.id) != idToString_.end());
-  entry.numInUse = 1;
-  pinnedSize_ += entry.string.size();
-  auto id = entry.id;
-  auto& entryInTable = idToString_[id] = std::move(entry);
-  stringToId_[entryInTable.string] = entry.id;
-  return lastId_;
+    id = (++shard.lastId << kShardBits) | index;
+  } while (id == kNoId || shard.idToEntry.count(id));
+  auto entry = std::make_unique<Entry>(string, id);
+  addUse(*entry);
+  shard.stringToId[entry->string] = id;
+  shard.idToEntry[id] = std::move(entry);
+  return id;
 }
 
 } // namespace facebook::velox
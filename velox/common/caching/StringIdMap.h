@@ -16,14 +16,24 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <string_view>
 
+#include <folly/SharedMutex.h>
 #include <folly/container/F14Map.h>
+#include <folly/lang/Align.h>
 
 #include "velox/common/base/Exceptions.h"
 
 namespace facebook::velox {
 
+// Map of strings to ids with a use count per string. The mappings are
+// partitioned into shards by the hash of the string and the shard of an id is
+// encoded in its low bits. Lookups and use count changes take a shared lock
+// of one shard, so only assigning a new id or dropping an unused one takes an
+// exclusive lock.
 class StringIdMap {
  public:
   static constexpr uint64_t kNoId = ~0UL;
@@ -57,24 +67,54 @@ class StringIdMap {
 
   // Returns a copy of the string associated with id or empty string if id has
   // no string.
-  std::string string(uint64_t id) {
-    std::lock_guard<std::mutex> l(mutex_);
-    auto it = idToString_.find(id);
-    return it == idToString_.end() ? "" : it->second.string;
-  }
+  std::string string(uint64_t id);
 
  private:
+  static constexpr int32_t kShardBits = 4;
+  static constexpr int32_t kNumShards = 1 << kShardBits;
+
   struct Entry {
-    std::string string;
-    uint64_t id;
-    uint32_t numInUse{};
+    Entry(std::string_view _string, uint64_t _id) : string(_string), id(_id) {}
+
+    const std::string string;
+    const uint64_t id;
+    std::atomic<uint32_t> numInUse{0};
   };
 
-  std::mutex mutex_;
-  folly::F14FastMap<std::string, uint64_t> stringToId_;
-  folly::F14FastMap<uint64_t, Entry> idToString_;
-  uint64_t lastId_{};
-  uint64_t pinnedSize_{};
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    folly::SharedMutex mutex;
+    folly::F14FastMap<std::string, uint64_t> stringToId;
+    // The entries are allocated separately so that their use counts can be
+    // changed under a shared lock while other threads look up the map.
+    folly::F14FastMap<uint64_t, std::unique_ptr<Entry>> idToEntry;
+    uint64_t lastId{0};
+  };
+
+  int32_t shardIndex(std::string_view string) const {
+    return std::hash<std::string_view>{}(string) & (kNumShards - 1);
+  }
+
+  Shard& shardOfId(uint64_t id) {
+    return shards_[id & (kNumShards - 1)];
+  }
+
+  // Returns the entry for 'id' in 'shard' or nullptr. The caller holds a lock
+  // of 'shard'.
+  static Entry* findLocked(Shard& shard, uint64_t id) {
+    auto it = shard.idToEntry.find(id);
+    return it == shard.idToEntry.end() ? nullptr : it->second.get();
+  }
+
+  // Increments the use count of 'entry' and accounts for its string if it was
+  // not in use.
+  void addUse(Entry& entry) {
+    if (entry.numInUse.fetch_add(1) == 0) {
+      pinnedSize_ += entry.string.size();
+    }
+  }
+
+  std::array<Shard, kNumShards> shards_;
+  std::atomic<int64_t> pinnedSize_{0};
 };
 
 // Keeps a string-id association live for the duration of this.
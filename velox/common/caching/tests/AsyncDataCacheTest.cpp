@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/caching/CachePolicy.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 #include "velox/common/file/FileSystems.h"
@@ -29,6 +30,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 
 using namespace facebook::velox;
 using namespace facebook::velox::cache;
@@ -84,7 +86,10 @@ class AsyncDataCacheTest : public testing::Test {
     }
   }
 
-  void initializeCache(uint64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      uint64_t maxBytes,
+      int64_t ssdBytes = 0,
+      CachePolicyKind policy = CachePolicyKind::kDefault) {
     std::unique_ptr<SsdCache> ssdCache;
     if (ssdBytes) {
       // tmpfs does not support O_DIRECT, so turn this off for testing.
@@ -107,7 +112,8 @@ class AsyncDataCacheTest : public testing::Test {
     cache_ = std::make_shared<AsyncDataCache>(
         std::make_shared<memory::MmapAllocator>(options),
         maxBytes,
-        std::move(ssdCache));
+        std::move(ssdCache),
+        policy);
     if (filenames_.empty()) {
       for (auto i = 0; i < kNumFiles; ++i) {
         auto name = fmt::format("testing_file_{}", i);
@@ -683,6 +689,7 @@ TEST_F(AsyncDataCacheTest, ssd) {
   // We open the cache from checkpoint. Reading checks the data
   // integrity, here we check that more data was read than written.
   initializeCache(kRamBytes, kSsdBytes);
+  cache_->ssdCache()->waitForRecovery();
   runThreads(16, [&](int32_t /*i*/) {
     loadLoop(kSsdBytes / 2, kSsdBytes * 1.5, 113);
   });
@@ -705,3 +712,219 @@ TEST_F(AsyncDataCacheTest, invalidSsdPath) {
           "Ssd path '{}' does not start with '/' that points to local file system.",
           testPath));
 }
+
+TEST_F(AsyncDataCacheTest, frequencySketch) {
+  FrequencySketch sketch(1024);
+  EXPECT_EQ(0, sketch.estimate(1));
+  for (auto i = 0; i < 5; ++i) {
+    sketch.increment(1);
+  }
+  EXPECT_EQ(5, sketch.estimate(1));
+  for (auto i = 0; i < 20; ++i) {
+    sketch.increment(2);
+  }
+  EXPECT_EQ(FrequencySketch::kMaxFrequency, sketch.estimate(2));
+  EXPECT_EQ(0, sketch.estimate(3));
+
+  // 10 x width increments halve the counters.
+  for (auto i = 0; i < 10 * 1024 - 25; ++i) {
+    sketch.increment(1'000 + i % 7);
+  }
+  EXPECT_EQ(2, sketch.estimate(1));
+  EXPECT_EQ(FrequencySketch::kMaxFrequency / 2, sketch.estimate(2));
+}
+
+TEST_F(AsyncDataCacheTest, scanResistance) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumHot = 64;
+  constexpr int32_t kNumScan = 1024;
+  for (auto policy :
+       {CachePolicyKind::kDefault,
+        CachePolicyKind::kTinyLfu,
+        CachePolicyKind::kSegmentedLru}) {
+    SCOPED_TRACE(cachePolicyKindName(policy));
+    initializeCache(kMaxBytes, 0, policy);
+    ASSERT_EQ(policy, cache_->policy());
+    // Looks up 'offset' and fills the entry on a miss. Returns true on a hit.
+    auto access = [&](uint64_t offset) {
+      auto pin =
+          cache_->findOrCreate({filenames_[0].id(), offset}, kSize, nullptr);
+      VELOX_CHECK(!pin.empty());
+      if (pin.entry()->isExclusive()) {
+        pin.entry()->setExclusiveToShared();
+        return false;
+      }
+      return true;
+    };
+    auto accessHot = [&]() {
+      int32_t numHits = 0;
+      for (auto i = 0; i < kNumHot; ++i) {
+        numHits += access(i * kSize);
+      }
+      return numHits;
+    };
+    // Scans 'kNumScan' entries that are used once.
+    auto scan = [&](int32_t pass) {
+      for (auto i = 0; i < kNumScan; ++i) {
+        access((kNumHot + (pass * kNumScan) + i) * kSize);
+      }
+    };
+
+    for (auto i = 0; i < 4; ++i) {
+      accessHot();
+    }
+    // Lets the access times of the hot entries age a little so that the
+    // scores of the entries differ.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // NOLINT
+    scan(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // NOLINT
+    accessHot();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // NOLINT
+    scan(1);
+    const auto numHits = accessHot();
+
+    auto stats = cache_->refreshStats();
+    EXPECT_EQ(policy, stats.policy);
+    EXPECT_LT(0, stats.numEvict);
+    EXPECT_LT(0, stats.hitRate());
+    EXPECT_GT(1, stats.hitRate());
+    switch (policy) {
+      case CachePolicyKind::kDefault:
+        EXPECT_EQ(0, stats.policyStats.numReject);
+        break;
+      case CachePolicyKind::kTinyLfu:
+        // Most of the second scan is not admitted and the hot entries stay.
+        EXPECT_LT(kNumScan / 2, stats.policyStats.numReject);
+        EXPECT_LE(kNumHot * 3 / 4, numHits);
+        break;
+      case CachePolicyKind::kSegmentedLru:
+        // The hot entries are protected, the scan stays on probation.
+        EXPECT_LE(kNumHot, stats.policyStats.numPromote);
+        EXPECT_LE(kNumHot * 3 / 4, numHits);
+        break;
+    }
+    LOG(INFO) << cachePolicyKindName(policy) << ": " << numHits << " of "
+              << kNumHot << " hot entries hit after scan. "
+              << cache_->toString();
+    cache_->clear();
+    stats = cache_->refreshStats();
+    EXPECT_EQ(0, stats.numEntries);
+  }
+}
+
+TEST_F(AsyncDataCacheTest, tenantQuota) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumHot = 64;
+  constexpr int32_t kNumScan = 1024;
+  constexpr uint64_t kHotBytes = kNumHot * kSize;
+  constexpr uint64_t kQuota = 4 << 20;
+  initializeCache(kMaxBytes);
+  const auto dashboard = cache_->makeTag("dashboard", CachePriority::kHigh);
+  const auto adhoc = cache_->makeTag("adhoc", CachePriority::kLow);
+  EXPECT_NE(0, dashboard.tenant);
+  EXPECT_NE(dashboard.tenant, adhoc.tenant);
+  EXPECT_EQ(
+      adhoc.tenant, cache_->makeTag("adhoc", CachePriority::kNormal).tenant);
+  EXPECT_EQ(0, cache_->makeTag("", CachePriority::kHigh).tenant);
+  VELOX_ASSERT_THROW(
+      cache_->setTenantQuota("", kQuota), "Cannot set a quota for tenant");
+  cache_->setTenantQuota("adhoc", kQuota);
+
+  // Looks up 'offset' and fills the entry on a miss. Returns true on a hit.
+  auto access = [&](uint64_t offset, CacheTag tag) {
+    auto pin = cache_->findOrCreate(
+        {filenames_[0].id(), offset}, kSize, nullptr, tag);
+    VELOX_CHECK(!pin.empty());
+    if (pin.entry()->isExclusive()) {
+      pin.entry()->setExclusiveToShared();
+      return false;
+    }
+    return true;
+  };
+  for (auto i = 0; i < kNumHot; ++i) {
+    EXPECT_FALSE(access(i * kSize, dashboard));
+  }
+  EXPECT_EQ(kHotBytes, cache_->tenantBytes("dashboard"));
+  EXPECT_EQ(0, cache_->tenantBytes("adhoc"));
+
+  // A scan of 4x the cache size by the tenant with a quota evicts only its
+  // own entries.
+  for (auto i = 0; i < kNumScan; ++i) {
+    access((kNumHot + i) * kSize, adhoc);
+  }
+  int32_t numHits = 0;
+  for (auto i = 0; i < kNumHot; ++i) {
+    numHits += access(i * kSize, dashboard);
+  }
+  EXPECT_EQ(kNumHot, numHits);
+  EXPECT_EQ(kHotBytes, cache_->tenantBytes("dashboard"));
+  EXPECT_LT(kQuota, cache_->tenantBytes("adhoc"));
+  auto stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numQuotaEvict);
+  EXPECT_EQ(stats.numEvict, stats.numQuotaEvict);
+
+  cache_->clear();
+  EXPECT_EQ(0, cache_->tenantBytes("dashboard"));
+  EXPECT_EQ(0, cache_->tenantBytes("adhoc"));
+}
+
+TEST_F(AsyncDataCacheTest, affinitySummary) {
+  constexpr uint64_t kGranularity = 1 << 20;
+  initializeCache(64 << 20);
+  EXPECT_TRUE(cache_->affinitySummary().topFiles().empty());
+  auto name = [&](int32_t fileIndex) {
+    return fileIds().string(filenames_[fileIndex].id());
+  };
+  EXPECT_FALSE(cache_->affinitySummary().mayContain(name(0)));
+
+  auto addEntry = [&](int32_t fileIndex, uint64_t offset, int32_t size) {
+    auto pin = cache_->findOrCreate(
+        {filenames_[fileIndex].id(), offset}, size, nullptr);
+    ASSERT_TRUE(pin.entry()->isExclusive());
+    pin.entry()->setExclusiveToShared();
+  };
+  addEntry(0, 0, 100'000);
+  addEntry(0, kGranularity + 1'000, 100'000);
+  addEntry(0, 5 * kGranularity, 100'000);
+  addEntry(1, 20 * kGranularity, 10'000);
+  // An entry being loaded is not in the summary.
+  auto loading =
+      cache_->findOrCreate({filenames_[2].id(), 0}, 100'000, nullptr);
+  ASSERT_TRUE(loading.entry()->isExclusive());
+
+  auto summary = cache_->affinitySummary(10, kGranularity);
+  auto check = [&](const CacheAffinitySummary& result) {
+    ASSERT_EQ(2, result.topFiles().size());
+    const auto& first = result.topFiles()[0];
+    EXPECT_EQ(name(0), first.fileName);
+    EXPECT_EQ(300'000, first.ramBytes);
+    EXPECT_EQ(0, first.ssdBytes);
+    using Ranges = std::vector<std::pair<uint64_t, uint64_t>>;
+    EXPECT_EQ(
+        Ranges({{0, 2 * kGranularity}, {5 * kGranularity, 6 * kGranularity}}),
+        first.ranges);
+    const auto& second = result.topFiles()[1];
+    EXPECT_EQ(name(1), second.fileName);
+    EXPECT_EQ(10'000, second.totalBytes());
+    EXPECT_EQ(Ranges({{20 * kGranularity, 21 * kGranularity}}), second.ranges);
+
+    EXPECT_TRUE(result.mayContain(name(0)));
+    EXPECT_TRUE(result.mayContain(name(1)));
+    EXPECT_EQ(
+        2 * kGranularity,
+        result.cachedBytes(name(0), kGranularity / 2, 5 * kGranularity));
+    EXPECT_EQ(0, result.cachedBytes(name(0), 3 * kGranularity, kGranularity));
+    EXPECT_EQ(0, result.cachedBytes(name(2), 0, 100'000));
+  };
+  check(summary);
+  check(CacheAffinitySummary::deserialize(summary.serialize()));
+
+  // Only the file with the most cached bytes is listed but the Bloom filter
+  // covers both.
+  auto top = cache_->affinitySummary(1, kGranularity);
+  ASSERT_EQ(1, top.topFiles().size());
+  EXPECT_EQ(name(0), top.topFiles()[0].fileName);
+  EXPECT_TRUE(top.mayContain(name(1)));
+}
@@ -225,3 +225,50 @@ TEST(CachedFactoryTest, retrievedCached) {
   }
   EXPECT_EQ(*generated, 5);
 }
+
+TEST(CachedFactoryTest, sharded) {
+  auto generator = std::make_unique<DoublerGenerator>();
+  auto* generated = &generator->generated_;
+  ShardedCachedFactory<int, int, DoublerGenerator> factory(
+      1000, std::move(generator), 4);
+  EXPECT_EQ(factory.maxSize(), 1000);
+  folly::EDFThreadPoolExecutor pool(
+      100, std::make_shared<folly::NamedThreadFactory>("test_pool"));
+  const int numValues = 50;
+  const int requestsPerValue = 10;
+  folly::Latch latch(numValues * requestsPerValue);
+  for (int i = 0; i < requestsPerValue; i++) {
+    for (int j = 0; j < numValues; j++) {
+      pool.add([&, j]() {
+        auto value = factory.generate(j);
+        EXPECT_EQ(getCachedValue(value), 2 * j);
+        latch.count_down();
+      });
+    }
+  }
+  latch.wait();
+  EXPECT_EQ(*generated, numValues);
+  EXPECT_EQ(factory.currentSize(), numValues);
+
+  auto stats = factory.cacheStats();
+  EXPECT_EQ(stats.curSize, numValues);
+  EXPECT_EQ(stats.maxSize, 1000);
+
+  std::vector<int> keys{1, 100, 2, 200};
+  std::vector<std::pair<int, int>> cached;
+  std::vector<int> missing;
+  factory.retrieveCached(keys, &cached, &missing);
+  ASSERT_EQ(2, cached.size());
+  ASSERT_EQ(2, missing.size());
+  std::sort(cached.begin(), cached.end());
+  std::sort(missing.begin(), missing.end());
+  EXPECT_EQ(cached[0], std::make_pair(1, 2));
+  EXPECT_EQ(cached[1], std::make_pair(2, 4));
+  EXPECT_EQ(missing, std::vector<int>({100, 200}));
+
+  stats = factory.clearCache();
+  EXPECT_EQ(stats.curSize, 0);
+  EXPECT_EQ(factory.currentSize(), 0);
+  EXPECT_EQ(factory.generate(1), cacheMiss(2));
+  EXPECT_EQ(*generated, numValues + 1);
+}
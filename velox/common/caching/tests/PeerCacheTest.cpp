@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/PeerCache.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/memory/MmapAllocator.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+namespace {
+// Serves reads from the AsyncDataCaches of workers in the same process.
+class LocalTransport : public PeerCacheTransport {
+ public:
+  bool read(
+      const std::string& peer,
+      const std::string& fileName,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) override {
+    ++numReads;
+    auto it = caches.find(peer);
+    if (it == caches.end()) {
+      return false;
+    }
+    return PeerCache::readLocal(*it->second, fileName, offset, buffers);
+  }
+
+  std::unordered_map<std::string, AsyncDataCache*> caches;
+  int32_t numReads{0};
+};
+} // namespace
+
+class PeerCacheTest : public testing::Test {
+ protected:
+  static constexpr uint64_t kAffinityBytes = 1 << 20;
+
+  void SetUp() override {
+    transport_ = std::make_shared<LocalTransport>();
+    for (auto i = 0; i < 2; ++i) {
+      memory::MmapAllocator::Options options;
+      options.capacity = 64 << 20;
+      caches_.push_back(std::make_shared<AsyncDataCache>(
+          std::make_shared<memory::MmapAllocator>(options), 64 << 20));
+      transport_->caches[peers_[i]] = caches_.back().get();
+    }
+    fileName_ = "peerCacheTestFile";
+    fileId_ = StringIdLease(fileIds(), fileName_);
+  }
+
+  // Makes an entry of 'size' bytes at 'offset' in 'cache' with bytes that
+  // depend on the offset.
+  void addEntry(AsyncDataCache& cache, uint64_t offset, int32_t size) {
+    auto pin = cache.findOrCreate({fileId_.id(), offset}, size, nullptr);
+    ASSERT_FALSE(pin.empty());
+    auto entry = pin.checkedEntry();
+    ASSERT_TRUE(entry->isExclusive());
+    if (entry->tinyData()) {
+      fill(entry->tinyData(), size, offset);
+    } else {
+      uint64_t filled = 0;
+      for (auto i = 0; i < entry->data().numRuns(); ++i) {
+        auto run = entry->data().runAt(i);
+        const auto bytes = std::min<uint64_t>(run.numBytes(), size - filled);
+        fill(run.data<char>(), bytes, offset + filled);
+        filled += bytes;
+      }
+    }
+    entry->setExclusiveToShared();
+  }
+
+  static void fill(char* data, uint64_t size, uint64_t offset) {
+    for (auto i = 0; i < size; ++i) {
+      data[i] = (offset + i) % 251;
+    }
+  }
+
+  static void check(const std::string& data, uint64_t offset) {
+    for (auto i = 0; i < data.size(); ++i) {
+      ASSERT_EQ(static_cast<char>((offset + i) % 251), data[i]) << i;
+    }
+  }
+
+  std::vector<std::string> peers_{"worker1", "worker2"};
+  std::shared_ptr<LocalTransport> transport_;
+  std::vector<std::shared_ptr<AsyncDataCache>> caches_;
+  std::string fileName_;
+  StringIdLease fileId_;
+};
+
+TEST_F(PeerCacheTest, consistentHash) {
+  std::vector<std::string> peers;
+  for (auto i = 0; i < 10; ++i) {
+    peers.push_back(fmt::format("worker{}", i));
+  }
+  PeerCache peerCache("worker0", peers, transport_, kAffinityBytes);
+  constexpr int32_t kNumChunks = 10'000;
+  std::vector<std::string> owners;
+  std::unordered_map<std::string, int32_t> counts;
+  for (auto i = 0; i < kNumChunks; ++i) {
+    owners.push_back(peerCache.owner(fileName_, i * kAffinityBytes));
+    ++counts[owners.back()];
+    // The same chunk has the same owner.
+    EXPECT_EQ(
+        owners.back(),
+        peerCache.owner(fileName_, i * kAffinityBytes + kAffinityBytes - 1));
+  }
+  ASSERT_EQ(10, counts.size());
+  for (auto& [peer, count] : counts) {
+    EXPECT_LT(kNumChunks / 20, count) << peer;
+    EXPECT_GT(kNumChunks / 5, count) << peer;
+  }
+
+  // Removing a worker moves only its chunks.
+  peers.pop_back();
+  peerCache.setPeers(peers);
+  for (auto i = 0; i < kNumChunks; ++i) {
+    const auto owner = peerCache.owner(fileName_, i * kAffinityBytes);
+    if (owners[i] != "worker9") {
+      EXPECT_EQ(owners[i], owner);
+    } else {
+      EXPECT_NE("worker9", owner);
+    }
+  }
+}
+
+TEST_F(PeerCacheTest, readFromPeer) {
+  PeerCache peerCache(peers_[0], peers_, transport_, kAffinityBytes);
+  // Finds a chunk owned by the other worker and one owned by this.
+  uint64_t remoteOffset = 0;
+  while (!peerCache.isRemote(fileName_, remoteOffset)) {
+    remoteOffset += kAffinityBytes;
+  }
+  uint64_t localOffset = 0;
+  while (peerCache.isRemote(fileName_, localOffset)) {
+    localOffset += kAffinityBytes;
+  }
+  // The peer has a large and a tiny entry in its chunk.
+  addEntry(*caches_[1], remoteOffset, 100'000);
+  addEntry(*caches_[1], remoteOffset + 200'000, 1'000);
+
+  std::vector<CachePin> pins;
+  for (auto [offset, size] : std::vector<std::pair<uint64_t, int32_t>>{
+           {remoteOffset, 100'000},
+           {remoteOffset + 200'000, 1'000},
+           {remoteOffset + 300'000, 1'000},
+           {localOffset, 1'000}}) {
+    pins.push_back(
+        caches_[0]->findOrCreate({fileId_.id(), offset}, size, nullptr));
+    ASSERT_TRUE(pins.back().checkedEntry()->isExclusive());
+  }
+  auto misses = peerCache.read(fileName_, pins);
+  // The peer does not have the third entry and the last is owned by this.
+  EXPECT_EQ(std::vector<int32_t>({2, 3}), misses);
+  EXPECT_EQ(3, transport_->numReads);
+  for (auto i = 0; i < 2; ++i) {
+    auto entry = pins[i].checkedEntry();
+    std::string copy(entry->size(), 0);
+    if (entry->tinyData()) {
+      memcpy(copy.data(), entry->tinyData(), entry->size());
+    } else {
+      uint64_t copied = 0;
+      for (auto j = 0; j < entry->data().numRuns(); ++j) {
+        auto run = entry->data().runAt(j);
+        const auto bytes =
+            std::min<uint64_t>(run.numBytes(), entry->size() - copied);
+        memcpy(copy.data() + copied, run.data<char>(), bytes);
+        copied += bytes;
+      }
+    }
+    check(copy, entry->offset());
+  }
+  auto stats = peerCache.stats();
+  EXPECT_EQ(4, stats.numReads);
+  EXPECT_EQ(2, stats.numHits);
+  EXPECT_EQ(2, stats.numMisses);
+  EXPECT_EQ(101'000, stats.bytesRead);
+
+  // A request larger than the cached entry is a miss and does not drop the
+  // entry.
+  std::string data(200'000, 0);
+  EXPECT_FALSE(PeerCache::readLocal(
+      *caches_[1],
+      fileName_,
+      remoteOffset,
+      {folly::Range<char*>(data.data(), data.size())}));
+  EXPECT_TRUE(caches_[1]->exists({fileId_.id(), remoteOffset}));
+}
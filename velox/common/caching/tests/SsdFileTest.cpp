@@ -18,9 +18,13 @@
 #include "velox/common/caching/SsdCache.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
+#include <fcntl.h>
+#include <folly/ScopeGuard.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace facebook::velox;
 using namespace facebook::velox::cache;
@@ -50,7 +54,8 @@ class SsdFileTest : public testing::Test {
   void initializeCache(
       int64_t maxBytes,
       int64_t ssdBytes = 0,
-      bool setNoCowFlag = false) {
+      bool setNoCowFlag = false,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
     cache_ = std::make_shared<AsyncDataCache>(
@@ -59,12 +64,29 @@ class SsdFileTest : public testing::Test {
     fileName_ = StringIdLease(fileIds(), "fileInStorage");
 
     tempDirectory_ = exec::test::TempDirectoryPath::create();
+    openFile(ssdBytes, checkpointIntervalBytes, setNoCowFlag);
+  }
+
+  // Opens the SSD file in 'tempDirectory_'. Recovers a previous instance if
+  // 'checkpointIntervalBytes' is non-0.
+  void openFile(
+      int64_t ssdBytes,
+      int64_t checkpointIntervalBytes,
+      bool setNoCowFlag = false,
+      folly::Executor* executor = nullptr) {
+    // Destroys the previous instance before opening the same file.
+    ssdFile_.reset();
     ssdFile_ = std::make_unique<SsdFile>(
-        fmt::format("{}/ssdtest", tempDirectory_->path),
+        filePath(),
         0, // shardId
         bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize,
-        0, // checkpointInternalBytes
-        setNoCowFlag);
+        checkpointIntervalBytes,
+        setNoCowFlag,
+        executor);
+  }
+
+  std::string filePath() const {
+    return fmt::format("{}/ssdtest", tempDirectory_->path);
   }
 
   static void initializeContents(int64_t sequence, memory::Allocation& alloc) {
@@ -297,6 +319,163 @@ TEST_F(SsdFileTest, writeAndRead) {
   }
 }
 
+TEST_F(SsdFileTest, ioUring) {
+  // Falls back to synchronous IO if the build or the kernel has no io_uring.
+  FLAGS_ssd_io_uring = true;
+  SCOPE_EXIT {
+    FLAGS_ssd_io_uring = false;
+  };
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  initializeCache(128 * kMB, kSsdSize);
+  FLAGS_ssd_verify_write = true;
+  for (auto startOffset = 0; startOffset < kSsdSize;
+       startOffset += SsdFile::kRegionSize) {
+    auto pins =
+        makePins(fileName_.id(), startOffset, 4096, 2048 * 1025, 62 * kMB);
+    ssdFile_->write(pins);
+    for (auto& pin : pins) {
+      EXPECT_EQ(ssdFile_.get(), pin.entry()->ssdFile());
+    }
+  }
+  for (auto startOffset = 0; startOffset < kSsdSize;
+       startOffset += SsdFile::kRegionSize) {
+    auto pins =
+        makePins(fileName_.id(), startOffset, 4096, 2048 * 1025, 62 * kMB);
+    readAndCheckPins(pins);
+  }
+}
+
+TEST_F(SsdFileTest, ssdFileIo) {
+  FLAGS_ssd_odirect = false;
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  const auto path = fmt::format("{}/ssdFileIo", tempDirectory->path);
+  for (auto useIoUring : {false, true}) {
+    SCOPED_TRACE(fmt::format("useIoUring {}", useIoUring));
+    auto fd = open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    SCOPE_EXIT {
+      close(fd);
+    };
+    auto io = SsdFileIo::create(fd, useIoUring, 4);
+    if (!useIoUring) {
+      EXPECT_EQ(io->kind(), "sync");
+    }
+
+    // 10 writes of 2 ranges of 1000 bytes each, more than the queue depth.
+    std::vector<std::string> data;
+    std::vector<SsdIoRequest> writes(10);
+    for (auto i = 0; i < writes.size(); ++i) {
+      writes[i].offset = i * 2000;
+      for (auto j = 0; j < 2; ++j) {
+        data.push_back(std::string(1000, 'a' + (i * 2 + j) % 26));
+        writes[i].iovecs.push_back({data.back().data(), 1000});
+      }
+    }
+    io->write(writes);
+    for (const auto& write : writes) {
+      EXPECT_TRUE(write.ok);
+    }
+
+    // Reads every other range, skipping the ones in between.
+    std::vector<std::string> buffers(data.size() / 2, std::string(1000, 0));
+    std::vector<folly::Range<char*>> ranges;
+    for (auto& buffer : buffers) {
+      ranges.emplace_back(buffer.data(), buffer.size());
+      ranges.emplace_back(nullptr, 1000);
+    }
+    ranges.pop_back();
+    std::vector<SsdIoRequest> reads(1);
+    SsdFileIo::appendIovecs(ranges, reads[0]);
+    EXPECT_EQ(reads[0].bytes(), 19'000);
+    io->read(reads);
+    ASSERT_TRUE(reads[0].ok);
+    for (auto i = 0; i < buffers.size(); ++i) {
+      EXPECT_EQ(buffers[i], data[i * 2]);
+    }
+
+    // A single range inside a registered buffer.
+    std::string registered(4000, 0);
+    io->registerBuffers({folly::Range<char*>(registered.data(), 4000)});
+    reads[0].iovecs = {{registered.data() + 1000, 2000}};
+    reads[0].offset = 2000;
+    io->read(reads);
+    ASSERT_TRUE(reads[0].ok);
+    EXPECT_EQ(registered.substr(1000, 1000), data[2]);
+    EXPECT_EQ(registered.substr(2000, 1000), data[3]);
+
+    // Reading past the end of the file fails.
+    reads[0].offset = 20'000;
+    io->read(reads);
+    EXPECT_FALSE(reads[0].ok);
+  }
+}
+
+TEST_F(SsdFileTest, recoverFromCheckpointAndLog) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  // No checkpoints other than the forced one.
+  constexpr int64_t kCheckpointInterval = 1L << 40;
+  initializeCache(128 * kMB, kSsdSize, false, kCheckpointInterval);
+  auto pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 20 * kMB);
+  ssdFile_->write(pins);
+  const auto corruptOffset = pins[0].entry()->ssdOffset();
+  pins.clear();
+  ssdFile_->checkpoint(true);
+  // These entries are only in the log.
+  pins = makePins(fileName_.id(), 100 * kMB, 4096, 2048 * 1025, 20 * kMB);
+  ssdFile_->write(pins);
+  pins.clear();
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  const uint64_t numEntries = stats.entriesCached;
+
+  // Opens the file again with recovery on an executor. Reading checks the
+  // contents.
+  cache_->clear();
+  folly::QueuedImmediateExecutor executor;
+  openFile(kSsdSize, kCheckpointInterval, false, &executor);
+  ssdFile_->waitForRecovery();
+  EXPECT_FALSE(ssdFile_->recovering());
+  SsdCacheStats recoveredStats;
+  ssdFile_->updateStats(recoveredStats);
+  EXPECT_EQ(numEntries, recoveredStats.numRecoveredEntries);
+  EXPECT_EQ(numEntries, recoveredStats.entriesCached);
+  readAndCheckPins(makePins(fileName_.id(), 0, 4096, 2048 * 1025, 20 * kMB));
+  readAndCheckPins(
+      makePins(fileName_.id(), 100 * kMB, 4096, 2048 * 1025, 20 * kMB));
+
+  // Corrupts the data of the first entry and leaves a partial record at the
+  // end of the log.
+  auto fd = open(filePath().c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(8, pwrite(fd, "garbage!", 8, corruptOffset + 100));
+  close(fd);
+  fd = open((filePath() + ".log").c_str(), O_WRONLY | O_APPEND);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(8, write(fd, "garbage!", 8));
+  close(fd);
+
+  cache_->clear();
+  openFile(kSsdSize, kCheckpointInterval);
+  SsdCacheStats corruptStats;
+  ssdFile_->updateStats(corruptStats);
+  EXPECT_EQ(numEntries, corruptStats.numRecoveredEntries);
+  {
+    std::vector<CachePin> corruptPins;
+    corruptPins.push_back(cache_->findOrCreate(
+        RawFileCacheKey{fileName_.id(), 0}, 4096, nullptr));
+    std::vector<SsdPin> ssdPins;
+    ssdPins.push_back(ssdFile_->find(RawFileCacheKey{fileName_.id(), 0}));
+    ASSERT_FALSE(ssdPins.back().empty());
+    EXPECT_THROW(ssdFile_->load(ssdPins, corruptPins), VeloxException);
+  }
+  corruptStats = SsdCacheStats();
+  ssdFile_->updateStats(corruptStats);
+  EXPECT_EQ(1, corruptStats.readSsdChecksumErrors);
+  EXPECT_TRUE(ssdFile_->find(RawFileCacheKey{fileName_.id(), 0}).empty());
+  readAndCheckPins(
+      makePins(fileName_.id(), 100 * kMB, 4096, 2048 * 1025, 20 * kMB));
+}
+
 #ifdef VELOX_SSD_FILE_TEST_SET_NO_COW_FLAG
 TEST_F(SsdFileTest, disabledCow) {
   constexpr int64_t kSsdSize = 16 * SsdFile::kRegionSize;
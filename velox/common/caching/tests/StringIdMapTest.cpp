@@ -16,6 +16,8 @@
 
 #include "velox/common/caching/StringIdMap.h"
 
+#include <thread>
+
 #include "gtest/gtest.h"
 
 using namespace facebook::velox;
@@ -53,3 +55,30 @@ TEST(StringIdMapTest, rehash) {
     EXPECT_EQ(ids[i].id(), StringIdLease(map, name).id());
   }
 }
+
+TEST(StringIdMapTest, concurrentLeases) {
+  constexpr int32_t kNumThreads = 8;
+  constexpr int32_t kNumNames = 50;
+  constexpr int32_t kNumIterations = 2000;
+  StringIdMap map;
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (auto j = 0; j < kNumIterations; ++j) {
+        auto name = fmt::format("filename_{}", (i + j) % kNumNames);
+        StringIdLease lease(map, name);
+        EXPECT_EQ(name, map.string(lease.id()));
+        EXPECT_EQ(lease.id(), map.id(name));
+        StringIdLease copy(map, lease.id());
+        EXPECT_EQ(lease.id(), copy.id());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, map.pinnedSize());
+  for (auto i = 0; i < kNumNames; ++i) {
+    EXPECT_EQ(StringIdMap::kNoId, map.id(fmt::format("filename_{}", i)));
+  }
+}
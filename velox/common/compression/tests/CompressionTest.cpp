@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/compression/Compression.h"
+
+namespace facebook::velox::common {
+
+TEST(CompressionTest, compressionKindToString) {
+  EXPECT_EQ(compressionKindToString(CompressionKind_NONE), "none");
+  EXPECT_EQ(compressionKindToString(CompressionKind_ZLIB), "zlib");
+  EXPECT_EQ(compressionKindToString(CompressionKind_SNAPPY), "snappy");
+  EXPECT_EQ(compressionKindToString(CompressionKind_LZO), "lzo");
+  EXPECT_EQ(compressionKindToString(CompressionKind_ZSTD), "zstd");
+  EXPECT_EQ(compressionKindToString(CompressionKind_LZ4), "lz4");
+  EXPECT_EQ(compressionKindToString(CompressionKind_GZIP), "gzip");
+  EXPECT_EQ(
+      compressionKindToString(static_cast<CompressionKind>(99)),
+      "unknown - 99");
+}
+
+TEST(CompressionTest, stringToCompressionKind) {
+  EXPECT_EQ(stringToCompressionKind("none"), CompressionKind_NONE);
+  EXPECT_EQ(stringToCompressionKind("zstd"), CompressionKind_ZSTD);
+  EXPECT_EQ(stringToCompressionKind("LZ4"), CompressionKind_LZ4);
+  EXPECT_EQ(stringToCompressionKind("Snappy"), CompressionKind_SNAPPY);
+  VELOX_ASSERT_THROW(
+      stringToCompressionKind("bz2"), "Not supported compression kind bz2");
+}
+
+TEST(CompressionTest, roundTrip) {
+  std::string data;
+  for (int i = 0; i < 10'000; ++i) {
+    data += std::to_string(i % 100);
+  }
+  for (auto kind :
+       {CompressionKind_ZLIB,
+        CompressionKind_SNAPPY,
+        CompressionKind_ZSTD,
+        CompressionKind_LZ4,
+        CompressionKind_GZIP}) {
+    SCOPED_TRACE(compressionKindToString(kind));
+    auto codec = compressionKindToCodec(kind);
+    auto input = folly::IOBuf::copyBuffer(data);
+    auto compressed = codec->compress(input.get());
+    EXPECT_LT(compressed->computeChainDataLength(), data.size());
+    auto uncompressed = codec->uncompress(compressed.get(), data.size());
+    EXPECT_EQ(uncompressed->moveToFbString().toStdString(), data);
+  }
+  VELOX_ASSERT_THROW(
+      compressionKindToCodec(CompressionKind_NONE),
+      "Not supported compression kind: none");
+}
+
+} // namespace facebook::velox::common
@@ -22,8 +22,31 @@
 #include <stdexcept>
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <folly/ScopeGuard.h>
 #include <folly/portability/SysUio.h>
 
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/file/IoUringReader.h"
+
+DEFINE_bool(
+    local_file_io_uring,
+    false,
+    "Use io_uring for asynchronous local file reads if Velox is built with "
+    "io_uring support");
+
+DEFINE_bool(
+    local_file_direct_io,
+    false,
+    "Read local files with O_DIRECT, bypassing the page cache");
+
+DEFINE_bool(
+    local_file_mmap,
+    false,
+    "Open local files for read as memory mapped files that readers access in "
+    "place");
+
 namespace facebook::velox {
 
 std::string ReadFile::pread(uint64_t offset, uint64_t length) const {
@@ -79,6 +102,97 @@ uint64_t InMemoryWriteFile::size() const {
   return file_->size();
 }
 
+namespace {
+struct FreeDeleter {
+  void operator()(char* data) const {
+    free(data);
+  }
+};
+
+using AlignedBuffer = std::unique_ptr<char, FreeDeleter>;
+
+AlignedBuffer allocateAligned(uint64_t size) {
+  void* data;
+  const auto rc =
+      posix_memalign(&data, LocalReadFile::kDirectIoAlignment, size);
+  VELOX_CHECK_EQ(rc, 0, "Cannot allocate {} aligned bytes", size);
+  return AlignedBuffer(reinterpret_cast<char*>(data));
+}
+
+uint64_t totalSize(const std::vector<folly::Range<char*>>& buffers) {
+  uint64_t size = 0;
+  for (const auto& range : buffers) {
+    size += range.size();
+  }
+  return size;
+}
+
+// Returns iovecs for 'buffers'. Ranges with a null data pointer are read
+// into 'droppedBytes'.
+std::vector<iovec> toIovecs(
+    const std::vector<folly::Range<char*>>& buffers,
+    std::vector<char>& droppedBytes) {
+  std::vector<iovec> iovecs;
+  iovecs.reserve(buffers.size());
+  for (auto& range : buffers) {
+    if (!range.data()) {
+      auto skipSize = range.size();
+      while (skipSize) {
+        auto bytes = std::min<size_t>(droppedBytes.size(), skipSize);
+        iovecs.push_back({droppedBytes.data(), bytes});
+        skipSize -= bytes;
+      }
+    } else {
+      iovecs.push_back({range.data(), range.size()});
+    }
+  }
+  return iovecs;
+}
+
+// Copies consecutive bytes from 'data' to 'buffers', skipping the ranges
+// with a null data pointer.
+void copyToBuffers(
+    const char* data,
+    const std::vector<folly::Range<char*>>& buffers) {
+  for (const auto& range : buffers) {
+    if (range.data()) {
+      memcpy(range.data(), data, range.size());
+    }
+    data += range.size();
+  }
+}
+
+// True if 'buffers' is a single buffer that can be the destination of a
+// direct read at 'offset'.
+bool isAligned(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) {
+  constexpr auto kAlignment = LocalReadFile::kDirectIoAlignment;
+  return buffers.size() == 1 && buffers[0].data() &&
+      reinterpret_cast<uintptr_t>(buffers[0].data()) % kAlignment == 0 &&
+      offset % kAlignment == 0 && buffers[0].size() % kAlignment == 0;
+}
+
+// Reads up to 'length' bytes at 'offset' of 'fd'. Returns the number of
+// bytes read, which is less than 'length' only at the end of the file.
+uint64_t preadFully(int32_t fd, char* data, uint64_t length, uint64_t offset) {
+  uint64_t bytesRead = 0;
+  while (bytesRead < length) {
+    const auto rc =
+        ::pread(fd, data + bytesRead, length - bytesRead, offset + bytesRead);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    VELOX_CHECK_GE(rc, 0, "pread failure: {}", folly::errnoStr(errno));
+    if (rc == 0) {
+      break;
+    }
+    bytesRead += rc;
+  }
+  return bytesRead;
+}
+} // namespace
+
 LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
   fd_ = open(path_.c_str(), O_RDONLY);
   VELOX_CHECK_GE(
@@ -97,11 +211,30 @@ LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
       path,
       folly::errnoStr(errno));
   size_ = rc;
+  if (FLAGS_local_file_direct_io) {
+#ifdef O_DIRECT
+    directFd_ = open(path_.c_str(), O_RDONLY | O_DIRECT);
+    if (directFd_ < 0) {
+      LOG(WARNING) << "Cannot open " << path << " with O_DIRECT: "
+                   << folly::errnoStr(errno);
+    }
+#endif
+  }
+  if (FLAGS_local_file_io_uring) {
+    ioUring_ = IoUringReader::instance();
+  }
 }
 
-LocalReadFile::LocalReadFile(int32_t fd) : fd_(fd) {}
+LocalReadFile::LocalReadFile(int32_t fd) : fd_(fd) {
+  if (FLAGS_local_file_io_uring) {
+    ioUring_ = IoUringReader::instance();
+  }
+}
 
 LocalReadFile::~LocalReadFile() {
+  if (directFd_ >= 0) {
+    close(directFd_);
+  }
   const int ret = close(fd_);
   if (ret < 0) {
     LOG(WARNING) << "close failure in LocalReadFile destructor: " << ret << ", "
@@ -112,6 +245,10 @@ LocalReadFile::~LocalReadFile() {
 void LocalReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   bytesRead_ += length;
+  if (directFd_ >= 0) {
+    preadvDirect(offset, {{pos, length}});
+    return;
+  }
   auto bytesRead = ::pread(fd_, pos, length, offset);
   VELOX_CHECK_EQ(
       bytesRead,
@@ -130,30 +267,96 @@ LocalReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
 uint64_t LocalReadFile::preadv(
     uint64_t offset,
     const std::vector<folly::Range<char*>>& buffers) const {
+  if (directFd_ >= 0) {
+    return preadvDirect(offset, buffers);
+  }
   // Dropped bytes sized so that a typical dropped range of 50K is not
   // too many iovecs.
   static thread_local std::vector<char> droppedBytes(16 * 1024);
-  std::vector<struct iovec> iovecs;
-  iovecs.reserve(buffers.size());
-  for (auto& range : buffers) {
-    if (!range.data()) {
-      auto skipSize = range.size();
-      while (skipSize) {
-        auto bytes = std::min<size_t>(droppedBytes.size(), skipSize);
-        iovecs.push_back({droppedBytes.data(), bytes});
-        skipSize -= bytes;
-      }
-    } else {
-      iovecs.push_back({range.data(), range.size()});
-    }
-  }
+  auto iovecs = toIovecs(buffers, droppedBytes);
   return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
 }
 
+uint64_t LocalReadFile::preadvDirect(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  const auto size = totalSize(buffers);
+  if (isAligned(offset, buffers)) {
+    const auto bytesRead =
+        preadFully(directFd_, buffers[0].data(), size, offset);
+    VELOX_CHECK_EQ(bytesRead, size, "Direct read of {}", path_);
+    return size;
+  }
+  const auto begin = offset - offset % kDirectIoAlignment;
+  const auto end = bits::roundUp(offset + size, kDirectIoAlignment);
+  auto staging = allocateAligned(end - begin);
+  const auto bytesRead =
+      preadFully(directFd_, staging.get(), end - begin, begin);
+  VELOX_CHECK_GE(
+      bytesRead, offset + size - begin, "Direct read of {}", path_);
+  copyToBuffers(staging.get() + offset - begin, buffers);
+  return size;
+}
+
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (ioUring_ == nullptr) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  const auto size = totalSize(buffers);
+  if (directFd_ >= 0 && isAligned(offset, buffers)) {
+    return ioUring_->readv(directFd_, offset, {{buffers[0].data(), size}})
+        .deferValue([this, size](int64_t rc) -> uint64_t {
+          VELOX_CHECK_EQ(
+              rc, static_cast<int64_t>(size), "Direct read of {}", path_);
+          return size;
+        });
+  }
+  if (directFd_ >= 0) {
+    const auto begin = offset - offset % kDirectIoAlignment;
+    const auto end = bits::roundUp(offset + size, kDirectIoAlignment);
+    std::shared_ptr<char> staging = allocateAligned(end - begin);
+    return ioUring_->readv(directFd_, begin, {{staging.get(), end - begin}})
+        .deferValue([this, staging, buffers, skip = offset - begin, size](
+                        int64_t rc) -> uint64_t {
+          const auto expected = static_cast<int64_t>(skip + size);
+          VELOX_CHECK_GE(rc, expected, "Direct read of {}", path_);
+          copyToBuffers(staging.get() + skip, buffers);
+          return size;
+        });
+  }
+  // Shared by all reads in flight. The content is never looked at.
+  static std::vector<char> droppedBytes(16 * 1024);
+  return ioUring_->readv(fd_, offset, toIovecs(buffers, droppedBytes))
+      .deferValue([this, offset, buffers, size](int64_t rc) -> uint64_t {
+        if (rc == static_cast<int64_t>(size)) {
+          return size;
+        }
+        // A short read is at the end of the file or interrupted. The
+        // synchronous read returns the same as it would have without
+        // io_uring.
+        return preadv(offset, buffers);
+      });
+}
+
 uint64_t LocalReadFile::size() const {
   return size_;
 }
 
+std::optional<int64_t> LocalReadFile::modificationTime() const {
+  // Files opened from a descriptor have no name to tell them apart.
+  if (path_.empty()) {
+    return std::nullopt;
+  }
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    return std::nullopt;
+  }
+  return static_cast<int64_t>(st.st_mtim.tv_sec) * 1'000'000'000 +
+      st.st_mtim.tv_nsec;
+}
+
 uint64_t LocalReadFile::memoryUsage() const {
   // TODO: does FILE really not use any more memory? From the stdio.h
   // source code it looks like it has only a single integer? Probably
@@ -162,6 +365,86 @@ uint64_t LocalReadFile::memoryUsage() const {
   return sizeof(FILE);
 }
 
+MmapReadFile::MmapReadFile(std::string_view path) : path_(path) {
+  const auto fd = open(path_.c_str(), O_RDONLY);
+  VELOX_CHECK_GE(
+      fd,
+      0,
+      "open failure in MmapReadFile constructor, {} {}.",
+      path,
+      folly::errnoStr(errno));
+  SCOPE_EXIT {
+    close(fd);
+  };
+  struct stat st;
+  VELOX_CHECK_EQ(
+      fstat(fd, &st),
+      0,
+      "fstat failure in MmapReadFile constructor, {} {}.",
+      path,
+      folly::errnoStr(errno));
+  size_ = st.st_size;
+  modificationTime_ = static_cast<int64_t>(st.st_mtim.tv_sec) * 1'000'000'000 +
+      st.st_mtim.tv_nsec;
+  if (size_ == 0) {
+    return;
+  }
+  // The mapping stays valid after the descriptor is closed.
+  auto* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  VELOX_CHECK(
+      data != MAP_FAILED,
+      "mmap failure in MmapReadFile constructor, {} {}.",
+      path,
+      folly::errnoStr(errno));
+  data_ = reinterpret_cast<char*>(data);
+}
+
+MmapReadFile::~MmapReadFile() {
+  if (data_ != nullptr && munmap(data_, size_) != 0) {
+    LOG(WARNING) << "munmap failure in MmapReadFile destructor: "
+                 << folly::errnoStr(errno);
+  }
+}
+
+std::string_view MmapReadFile::view(uint64_t offset, uint64_t length) const {
+  VELOX_CHECK_LE(
+      offset + length,
+      size_,
+      "Read past the end of {}: {} + {}",
+      path_,
+      offset,
+      length);
+  bytesRead_ += length;
+  return {data_ + offset, length};
+}
+
+std::string_view
+MmapReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
+  memcpy(buf, view(offset, length).data(), length);
+  return {static_cast<char*>(buf), length};
+}
+
+uint64_t MmapReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  const auto size = totalSize(buffers);
+  copyToBuffers(view(offset, size).data(), buffers);
+  return size;
+}
+
+void MmapReadFile::prefetch(uint64_t offset, uint64_t length) const {
+  if (length == 0 || offset >= size_) {
+    return;
+  }
+  static const uint64_t kPageSize = sysconf(_SC_PAGESIZE);
+  const auto begin = offset - offset % kPageSize;
+  const auto end = std::min(offset + length, size_);
+  if (madvise(data_ + begin, end - begin, MADV_WILLNEED) != 0) {
+    VLOG(1) << "madvise failure for " << path_ << ": "
+            << folly::errnoStr(errno);
+  }
+}
+
 LocalWriteFile::LocalWriteFile(std::string_view path) {
   std::unique_ptr<char[]> buf(new char[path.size() + 1]);
   buf[path.size()] = 0;
@@ -30,16 +30,24 @@
 #include <cstdint>
 #include <cstdio>
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 
 #include <folly/Range.h>
 #include <folly/futures/Future.h>
+#include <gflags/gflags.h>
 
 #include "velox/common/base/Exceptions.h"
 
+DECLARE_bool(local_file_io_uring);
+DECLARE_bool(local_file_direct_io);
+DECLARE_bool(local_file_mmap);
+
 namespace facebook::velox {
 
+class IoUringReader;
+
 // A read-only file.  All methods in this object should be thread safe.
 class ReadFile {
  public:
@@ -118,6 +126,13 @@ class ReadFile {
   // Number of bytes in the file.
   virtual uint64_t size() const = 0;
 
+  // Last modification time of the file in nanoseconds since the epoch, or
+  // std::nullopt if not known. Used to tell apart versions of a file with the
+  // same name when caching metadata across readers.
+  virtual std::optional<int64_t> modificationTime() const {
+    return std::nullopt;
+  }
+
   // An estimate for the total amount of memory *this uses.
   virtual uint64_t memoryUsage() const = 0;
 
@@ -232,9 +247,20 @@ class InMemoryWriteFile final : public WriteFile {
 // Current implementation for the local version is quite simple (e.g. no
 // internal arenaing), as local disk writes are expected to be cheap. Local
 // files match against any filepath starting with '/'.
+//
+// With --local_file_io_uring, preadvAsync() is asynchronous on the io_uring
+// of IoUringReader if the build supports it. With --local_file_direct_io,
+// files opened by path are also opened with O_DIRECT and reads bypass the
+// page cache, which avoids caching the same data twice when the data is
+// kept in AsyncDataCache. Direct reads are widened to whole aligned blocks
+// and go through an aligned staging buffer unless the destination, the
+// offset and the size are all aligned.
 
 class LocalReadFile final : public ReadFile {
  public:
+  // Alignment of the file offset, size and memory of a direct read.
+  static constexpr uint64_t kDirectIoAlignment = 4096;
+
   explicit LocalReadFile(std::string_view path);
 
   explicit LocalReadFile(int32_t fd);
@@ -246,10 +272,25 @@ class LocalReadFile final : public ReadFile {
 
   uint64_t size() const final;
 
+  std::optional<int64_t> modificationTime() const final;
+
   uint64_t preadv(
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return ioUring_ != nullptr;
+  }
+
+  // True if reads bypass the page cache.
+  bool isDirectIo() const {
+    return directFd_ >= 0;
+  }
+
   uint64_t memoryUsage() const final;
 
   bool shouldCoalesce() const final {
@@ -271,9 +312,76 @@ class LocalReadFile final : public ReadFile {
   void preadInternal(uint64_t offset, uint64_t length, char* FOLLY_NONNULL pos)
       const;
 
+  // Reads 'buffers' from 'offset' of 'directFd_'.
+  uint64_t preadvDirect(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const;
+
   std::string path_;
   int32_t fd_;
+  // Descriptor of the file opened with O_DIRECT or -1 if not using direct
+  // IO.
+  int32_t directFd_{-1};
   long size_;
+  IoUringReader* FOLLY_NULLABLE ioUring_{nullptr};
+};
+
+// Local file read through a read-only shared mapping of the whole file. The
+// bytes can be accessed in place with view(), so that files that are mostly
+// in the page cache, e.g. dimension tables read by every query, are not
+// copied into another cache. LocalFileSystem opens files as MmapReadFile
+// with --local_file_mmap.
+class MmapReadFile final : public ReadFile {
+ public:
+  explicit MmapReadFile(std::string_view path);
+
+  ~MmapReadFile();
+
+  std::string_view
+  pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf) const final;
+
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  // Returns the bytes at [offset, offset + length) in the mapping. These
+  // stay valid for the lifetime of 'this'.
+  std::string_view view(uint64_t offset, uint64_t length) const;
+
+  // Advises the kernel that [offset, offset + length) will be accessed soon,
+  // so that it is read ahead of the page faults of view().
+  void prefetch(uint64_t offset, uint64_t length) const;
+
+  uint64_t size() const final {
+    return size_;
+  }
+
+  std::optional<int64_t> modificationTime() const final {
+    return modificationTime_;
+  }
+
+  uint64_t memoryUsage() const final {
+    return sizeof(*this);
+  }
+
+  bool shouldCoalesce() const final {
+    return false;
+  }
+
+  std::string getName() const override {
+    return path_;
+  }
+
+  uint64_t getNaturalReadSize() const override {
+    return 10 << 20;
+  }
+
+ private:
+  const std::string path_;
+  uint64_t size_{0};
+  int64_t modificationTime_{0};
+  // Start of the mapping, nullptr for an empty file.
+  char* FOLLY_NULLABLE data_{nullptr};
 };
 
 class LocalWriteFile final : public WriteFile {
@@ -87,6 +87,9 @@ class LocalFileSystem : public FileSystem {
   std::unique_ptr<ReadFile> openFileForRead(
       std::string_view path,
       const FileOptions& /*unused*/) override {
+    if (FLAGS_local_file_mmap) {
+      return std::make_unique<MmapReadFile>(extractPath(path));
+    }
     return std::make_unique<LocalReadFile>(extractPath(path));
   }
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/file/IoUringReader.h"
+
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "velox/common/base/Exceptions.h"
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#endif
+
+DEFINE_int32(
+    local_file_io_uring_depth,
+    256,
+    "Maximum number of local file reads in flight on the io_uring");
+
+namespace facebook::velox {
+
+#ifdef VELOX_ENABLE_IO_URING
+namespace {
+
+class IoUringReaderImpl : public IoUringReader {
+ public:
+  explicit IoUringReaderImpl(int32_t depth) : depth_(depth) {}
+
+  // Sets up the ring and starts the thread that reaps its completions.
+  // Returns false if the kernel does not allow setting up a ring.
+  bool init() {
+    const auto rc = io_uring_queue_init(depth_, &ring_, 0);
+    if (rc < 0) {
+      LOG(WARNING) << "Cannot set up io_uring for local file reads: "
+                   << folly::errnoStr(-rc);
+      return false;
+    }
+    reaper_ = std::thread([this]() { reap(); });
+    return true;
+  }
+
+  folly::SemiFuture<int64_t>
+  readv(int32_t fd, uint64_t offset, std::vector<iovec> iovecs) override {
+    auto request = std::make_unique<Request>();
+    request->iovecs = std::move(iovecs);
+    auto [promise, future] = folly::makePromiseContract<int64_t>();
+    request->promise = std::move(promise);
+
+    std::unique_lock<std::mutex> l(mutex_);
+    // Bounds the reads in flight so that the completion queue, which is
+    // twice the depth, cannot overflow.
+    notFull_.wait(l, [&]() { return numInFlight_ < depth_; });
+    auto* sqe = io_uring_get_sqe(&ring_);
+    VELOX_CHECK_NOT_NULL(sqe);
+    io_uring_prep_readv(
+        sqe, fd, request->iovecs.data(), request->iovecs.size(), offset);
+    io_uring_sqe_set_data(sqe, request.release());
+    ++numInFlight_;
+    const auto rc = io_uring_submit(&ring_);
+    if (rc < 0) {
+      // The entry stays in the submission queue and goes with the next
+      // submit.
+      LOG(WARNING) << "io_uring_submit failed: " << folly::errnoStr(-rc);
+    }
+    return std::move(future);
+  }
+
+ private:
+  struct Request {
+    std::vector<iovec> iovecs;
+    folly::Promise<int64_t> promise;
+  };
+
+  void reap() {
+    for (;;) {
+      io_uring_cqe* cqe;
+      const auto rc = io_uring_wait_cqe(&ring_, &cqe);
+      if (rc == -EINTR) {
+        continue;
+      }
+      VELOX_CHECK_EQ(rc, 0, "io_uring_wait_cqe: {}", folly::errnoStr(-rc));
+      std::unique_ptr<Request> request(
+          reinterpret_cast<Request*>(io_uring_cqe_get_data(cqe)));
+      const int64_t result = cqe->res;
+      io_uring_cqe_seen(&ring_, cqe);
+      {
+        std::lock_guard<std::mutex> l(mutex_);
+        --numInFlight_;
+      }
+      notFull_.notify_one();
+      request->promise.setValue(result);
+    }
+  }
+
+  const int32_t depth_;
+  io_uring ring_;
+  // Serializes the submissions. Completions are only touched by 'reaper_'.
+  std::mutex mutex_;
+  std::condition_variable notFull_;
+  int32_t numInFlight_{0};
+  std::thread reaper_;
+};
+
+} // namespace
+#endif
+
+// static
+IoUringReader* IoUringReader::instance() {
+#ifdef VELOX_ENABLE_IO_URING
+  // Never destroyed, so that the reaper thread outlives all reads.
+  static IoUringReader* reader = []() -> IoUringReader* {
+    VELOX_CHECK_GT(FLAGS_local_file_io_uring_depth, 0);
+    auto* impl = new IoUringReaderImpl(FLAGS_local_file_io_uring_depth);
+    if (!impl->init()) {
+      delete impl;
+      return nullptr;
+    }
+    return impl;
+  }();
+  return reader;
+#else
+  return nullptr;
+#endif
+}
+
+} // namespace facebook::velox
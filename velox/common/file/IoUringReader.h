@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <folly/futures/Future.h>
+#include <folly/portability/SysUio.h>
+#include <gflags/gflags.h>
+
+DECLARE_int32(local_file_io_uring_depth);
+
+namespace facebook::velox {
+
+/// Process wide io_uring for asynchronous reads of local files. Reads are
+/// submitted from any thread and a thread of the reader reaps the
+/// completions and fulfills the futures of the reads. Only available if
+/// Velox is built with VELOX_ENABLE_IO_URING.
+class IoUringReader {
+ public:
+  virtual ~IoUringReader() = default;
+
+  /// Returns the process wide instance or nullptr if the build has no
+  /// io_uring support or the kernel does not allow setting up a ring.
+  static IoUringReader* instance();
+
+  /// Reads into 'iovecs' from 'offset' of 'fd' with a single readv. The
+  /// result is the number of bytes read, which may be short, or a negated
+  /// errno. The memory of 'iovecs' must stay live until the result is set.
+  virtual folly::SemiFuture<int64_t>
+  readv(int32_t fd, uint64_t offset, std::vector<iovec> iovecs) = 0;
+};
+
+} // namespace facebook::velox
@@ -15,6 +15,7 @@
  */
 
 #include <fcntl.h>
+#include <folly/ScopeGuard.h>
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
@@ -119,6 +120,68 @@ TEST(LocalFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(LocalFile, directIoAndIoUring) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  std::string data(3 * LocalReadFile::kDirectIoAlignment + 100, '\0');
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = 'a' + i % 23;
+  }
+  {
+    LocalWriteFile writeFile(filename);
+    writeFile.append(data);
+  }
+  // Direct IO and io_uring fall back to buffered and synchronous reads if
+  // the file system or the build does not support them.
+  FLAGS_local_file_direct_io = true;
+  FLAGS_local_file_io_uring = true;
+  SCOPE_EXIT {
+    FLAGS_local_file_direct_io = false;
+    FLAGS_local_file_io_uring = false;
+  };
+  LocalReadFile readFile(filename);
+  EXPECT_EQ(readFile.pread(4000, 200), data.substr(4000, 200));
+
+  std::string head(10, '\0');
+  std::string tail(3000, '\0');
+  const std::vector<folly::Range<char*>> buffers = {
+      {head.data(), head.size()},
+      {nullptr, 5000},
+      {tail.data(), tail.size()}};
+  const uint64_t offset = 5;
+  const auto size = head.size() + 5000 + tail.size();
+  EXPECT_EQ(readFile.preadv(offset, buffers), size);
+  EXPECT_EQ(head, data.substr(offset, head.size()));
+  EXPECT_EQ(tail, data.substr(offset + head.size() + 5000, tail.size()));
+
+  head.assign(head.size(), '\0');
+  tail.assign(tail.size(), '\0');
+  EXPECT_EQ(readFile.preadvAsync(offset, buffers).get(), size);
+  EXPECT_EQ(head, data.substr(offset, head.size()));
+  EXPECT_EQ(tail, data.substr(offset + head.size() + 5000, tail.size()));
+
+  // An aligned destination is read without staging.
+  void* aligned;
+  ASSERT_EQ(
+      posix_memalign(
+          &aligned,
+          LocalReadFile::kDirectIoAlignment,
+          LocalReadFile::kDirectIoAlignment),
+      0);
+  SCOPE_EXIT {
+    free(aligned);
+  };
+  folly::Range<char*> block(
+      reinterpret_cast<char*>(aligned), LocalReadFile::kDirectIoAlignment);
+  EXPECT_EQ(
+      readFile.preadvAsync(LocalReadFile::kDirectIoAlignment, {block}).get(),
+      block.size());
+  EXPECT_EQ(
+      std::string_view(block.data(), block.size()),
+      data.substr(LocalReadFile::kDirectIoAlignment, block.size()));
+}
+
 TEST(LocalFile, viaRegistry) {
   filesystems::registerLocalFileSystem();
   auto tempFile = ::exec::test::TempFilePath::create();
@@ -18,6 +18,7 @@
 #include <exception>
 #include <sstream>
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/hyperloglog/BiasCorrection.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -568,59 +569,119 @@ void DenseHll::mergeWith(
     int16_t otherOverflows,
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
+  using Batch = xsimd::batch<int8_t>;
+
   int8_t newBaseline = std::max(baseline_, otherBaseline);
   int32_t baselineCount = 0;
 
-  int bucket = 0;
-  for (int i = 0; i < deltas_.size(); i++) {
-    int newSlot = 0;
-
-    int8_t slot1 = deltas_[i];
-    int8_t slot2 = otherDeltas[i];
-
-    for (int shift = 4; shift >= 0; shift -= 4) {
-      int8_t delta1 = (slot1 >> shift) & kBucketMask;
-      int8_t delta2 = (slot2 >> shift) & kBucketMask;
-
-      int8_t value1 = baseline_ + delta1;
-      int8_t value2 = otherBaseline + delta2;
-
-      int16_t overflowEntry = -1;
-      if (delta1 == kMaxDelta) {
-        overflowEntry = findOverflowEntry(bucket);
-        if (overflowEntry != -1) {
-          value1 += overflowValues_[overflowEntry];
-        }
+  // The values are baseline + delta, so rebasing them on the new baseline
+  // subtracts the difference of the baselines from the deltas. One of the
+  // differences is 0, so the larger of the rebased deltas is not negative.
+  // Batches with no delta of kMaxDelta on either side have no overflows to
+  // look up and the new deltas stay below kMaxDelta.
+  const Batch bucketMask(kBucketMask);
+  const Batch maxDelta(kMaxDelta);
+  const Batch zero(0);
+  const Batch rebase1(static_cast<int8_t>(newBaseline - baseline_));
+  const Batch rebase2(static_cast<int8_t>(newBaseline - otherBaseline));
+  const int32_t numSlots = deltas_.size();
+  int32_t i = 0;
+  for (; i + Batch::size <= numSlots; i += Batch::size) {
+    auto slots1 = Batch::load_unaligned(deltas_.data() + i);
+    auto slots2 = Batch::load_unaligned(otherDeltas + i);
+    auto low1 = slots1 & bucketMask;
+    auto high1 = (slots1 >> 4) & bucketMask;
+    auto low2 = slots2 & bucketMask;
+    auto high2 = (slots2 >> 4) & bucketMask;
+    if (simd::toBitMask(
+            (low1 == maxDelta) | (high1 == maxDelta) | (low2 == maxDelta) |
+            (high2 == maxDelta))) {
+      for (auto j = i; j < i + Batch::size; ++j) {
+        baselineCount += mergeSlot(
+            j,
+            otherDeltas[j],
+            otherBaseline,
+            newBaseline,
+            otherOverflows,
+            otherOverflowBuckets,
+            otherOverflowValues);
       }
+      continue;
+    }
+    auto low = xsimd::max(low1 - rebase1, low2 - rebase2);
+    auto high = xsimd::max(high1 - rebase1, high2 - rebase2);
+    baselineCount += __builtin_popcount(simd::toBitMask(low == zero)) +
+        __builtin_popcount(simd::toBitMask(high == zero));
+    ((high << 4) | low).store_unaligned(deltas_.data() + i);
+  }
+  for (; i < numSlots; ++i) {
+    baselineCount += mergeSlot(
+        i,
+        otherDeltas[i],
+        otherBaseline,
+        newBaseline,
+        otherOverflows,
+        otherOverflowBuckets,
+        otherOverflowValues);
+  }
 
-      if (delta2 == kMaxDelta) {
-        value2 += getOverflowImpl(
-            bucket, otherOverflows, otherOverflowBuckets, otherOverflowValues);
-      }
+  baseline_ = newBaseline;
+  baselineCount_ = baselineCount;
 
-      int8_t newValue = std::max(value1, value2);
-      int8_t newDelta = newValue - newBaseline;
+  // All baseline values in one of the HLLs lost to the values
+  // in the other HLL, so we need to adjust the final baseline.
+  adjustBaselineIfNeeded();
+}
 
-      if (newDelta == 0) {
-        baselineCount++;
+int32_t DenseHll::mergeSlot(
+    int32_t slot,
+    int8_t otherSlot,
+    int8_t otherBaseline,
+    int8_t newBaseline,
+    int16_t otherOverflows,
+    const uint16_t* otherOverflowBuckets,
+    const int8_t* otherOverflowValues) {
+  int32_t baselineCount = 0;
+  int newSlot = 0;
+  int bucket = slot * 2;
+  int8_t slot1 = deltas_[slot];
+
+  for (int shift = 4; shift >= 0; shift -= 4) {
+    int8_t delta1 = (slot1 >> shift) & kBucketMask;
+    int8_t delta2 = (otherSlot >> shift) & kBucketMask;
+
+    int8_t value1 = baseline_ + delta1;
+    int8_t value2 = otherBaseline + delta2;
+
+    int16_t overflowEntry = -1;
+    if (delta1 == kMaxDelta) {
+      overflowEntry = findOverflowEntry(bucket);
+      if (overflowEntry != -1) {
+        value1 += overflowValues_[overflowEntry];
       }
+    }
+
+    if (delta2 == kMaxDelta) {
+      value2 += getOverflowImpl(
+          bucket, otherOverflows, otherOverflowBuckets, otherOverflowValues);
+    }
 
-      newDelta = updateOverflow(bucket, overflowEntry, newDelta);
+    int8_t newValue = std::max(value1, value2);
+    int8_t newDelta = newValue - newBaseline;
 
-      newSlot <<= 4;
-      newSlot |= newDelta;
-      bucket++;
+    if (newDelta == 0) {
+      baselineCount++;
     }
 
-    deltas_[i] = newSlot;
-  }
+    newDelta = updateOverflow(bucket, overflowEntry, newDelta);
 
-  baseline_ = newBaseline;
-  baselineCount_ = baselineCount;
+    newSlot <<= 4;
+    newSlot |= newDelta;
+    bucket++;
+  }
 
-  // All baseline values in one of the HLLs lost to the values
-  // in the other HLL, so we need to adjust the final baseline.
-  adjustBaselineIfNeeded();
+  deltas_[slot] = newSlot;
+  return baselineCount;
 }
 
 int8_t
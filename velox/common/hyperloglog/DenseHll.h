@@ -116,6 +116,18 @@ class DenseHll {
       const uint16_t* otherOverflowBuckets,
       const int8_t* otherOverflowValues);
 
+  /// Merges the 2 buckets in 'slot' of 'deltas_' with the ones in 'otherSlot'
+  /// and returns the number of merged buckets at 'newBaseline'. Doesn't update
+  /// 'baseline_'.
+  int32_t mergeSlot(
+      int32_t slot,
+      int8_t otherSlot,
+      int8_t otherBaseline,
+      int8_t newBaseline,
+      int16_t otherOverflows,
+      const uint16_t* otherOverflowBuckets,
+      const int8_t* otherOverflowValues);
+
   /// Number of first bits of the hash to calculate buckets from.
   int8_t indexBitLength_;
 
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/common/hyperloglog/SparseHll.h"
+
+#include <cstring>
+
 #include "velox/common/base/IOUtils.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -115,9 +118,9 @@ void SparseHll::serialize(int8_t indexBitLength, char* output) const {
   stream.appendOne(kPrestoSparseV2);
   stream.appendOne(indexBitLength);
   stream.appendOne((int16_t)entries_.size());
-  for (auto entry : entries_) {
-    stream.appendOne(entry);
-  }
+  stream.append(
+      reinterpret_cast<const char*>(entries_.data()),
+      entries_.size() * sizeof(uint32_t));
 }
 
 // static
@@ -156,8 +159,9 @@ SparseHll::SparseHll(const char* serialized, HashStringAllocator* allocator)
 
   auto size = stream.read<int16_t>();
   entries_.resize(size);
-  for (auto i = 0; i < size; i++) {
-    entries_[i] = stream.read<uint32_t>();
+  if (size > 0) {
+    std::memcpy(
+        entries_.data(), serialized + stream.offset(), size * sizeof(uint32_t));
   }
 }
 
@@ -176,40 +180,46 @@ void SparseHll::mergeWith(const char* serialized) {
 void SparseHll::mergeWith(size_t otherSize, const uint32_t* otherEntries) {
   VELOX_CHECK_GT(otherSize, 0);
 
-  auto size = entries_.size();
-  std::vector<uint32_t> merged(size + otherSize);
+  // Merges from the back into the end of 'entries_' so that no temporary
+  // copy is needed. The write position never falls below the read position
+  // in 'entries_'. Buckets present on both sides leave a gap at the front,
+  // which is removed at the end.
+  const int64_t size = entries_.size();
+  entries_.resize(size + otherSize);
 
-  int pos = 0;
-  int leftPos = 0;
-  int rightPos = 0;
+  int64_t pos = size + otherSize - 1;
+  int64_t leftPos = size - 1;
+  int64_t rightPos = otherSize - 1;
 
-  while (leftPos < size && rightPos < otherSize) {
+  while (leftPos >= 0 && rightPos >= 0) {
     auto left = decodeIndex(entries_[leftPos]);
     auto right = decodeIndex(otherEntries[rightPos]);
-    if (left < right) {
-      merged[pos++] = entries_[leftPos++];
-    } else if (left > right) {
-      merged[pos++] = otherEntries[rightPos++];
+    if (left > right) {
+      entries_[pos--] = entries_[leftPos--];
+    } else if (left < right) {
+      entries_[pos--] = otherEntries[rightPos--];
     } else {
       auto value = std::max(
-          decodeValue(entries_[leftPos++]),
-          decodeValue(otherEntries[rightPos++]));
-      merged[pos++] = encode(left, value);
+          decodeValue(entries_[leftPos--]),
+          decodeValue(otherEntries[rightPos--]));
+      entries_[pos--] = encode(left, value);
     }
   }
 
-  while (leftPos < size) {
-    merged[pos++] = entries_[leftPos++];
+  while (rightPos >= 0) {
+    entries_[pos--] = otherEntries[rightPos--];
   }
 
-  while (rightPos < otherSize) {
-    merged[pos++] = otherEntries[rightPos++];
+  if (pos == leftPos) {
+    // No common buckets. The rest of 'entries_' is in place.
+    return;
   }
 
-  entries_.resize(pos);
-  for (auto i = 0; i < pos; i++) {
-    entries_[i] = merged[i];
+  while (leftPos >= 0) {
+    entries_[pos--] = entries_[leftPos--];
   }
+
+  entries_.erase(entries_.begin(), entries_.begin() + pos + 1);
 }
 
 void SparseHll::verify() const {
@@ -226,10 +236,29 @@ void SparseHll::verify() const {
 }
 
 void SparseHll::toDense(DenseHll& denseHll) const {
+  toDense(entries_.size(), entries_.data(), denseHll);
+}
+
+// static
+void SparseHll::toDense(const char* serialized, DenseHll& denseHll) {
+  auto stream = initializeInputStream(serialized);
+
+  auto size = stream.read<int16_t>();
+  toDense(
+      size,
+      reinterpret_cast<const uint32_t*>(serialized + stream.offset()),
+      denseHll);
+}
+
+// static
+void SparseHll::toDense(
+    size_t size,
+    const uint32_t* entries,
+    DenseHll& denseHll) {
   auto indexBitLength = denseHll.indexBitLength();
 
-  for (auto i = 0; i < entries_.size(); i++) {
-    auto entry = entries_[i];
+  for (auto i = 0; i < size; i++) {
+    auto entry = entries[i];
     auto index = entry >> (32 - indexBitLength);
 
     auto zeros = __builtin_clz(entry << indexBitLength);
@@ -218,6 +218,10 @@ TEST_P(DenseHllTest, mergeWith) {
 
   // large, same
   testMergeWith(indexBitLength, sequence(0, 2'000'000), sequence(0, 2'000'000));
+
+  // small and large, with different baselines
+  testMergeWith(indexBitLength, sequence(0, 100), sequence(0, 3'000'000));
+  testMergeWith(indexBitLength, sequence(0, 3'000'000), sequence(0, 100));
 }
 
 INSTANTIATE_TEST_SUITE_P(
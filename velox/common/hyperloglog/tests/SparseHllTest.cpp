@@ -162,6 +162,10 @@ TEST_F(SparseHllTest, mergeWith) {
 
   // idempotent
   testMergeWith(sequence(0, 100), sequence(0, 100));
+
+  // subset
+  testMergeWith(sequence(0, 100), sequence(20, 30));
+  testMergeWith(sequence(20, 30), sequence(0, 100));
 }
 
 class SparseHllToDenseTest : public ::testing::TestWithParam<int8_t> {
@@ -195,6 +199,26 @@ TEST_P(SparseHllToDenseTest, toDense) {
   ASSERT_EQ(serialize(denseHll), serialize(expectedHll));
 }
 
+TEST_P(SparseHllToDenseTest, serializedToDense) {
+  int8_t indexBitLength = GetParam();
+
+  SparseHll sparseHll{&allocator_};
+  DenseHll expectedHll{indexBitLength, &allocator_};
+  for (int i = 0; i < 1'000; i++) {
+    auto hash = hashOne(i);
+    sparseHll.insertHash(hash);
+    expectedHll.insertHash(hash);
+  }
+
+  std::string serialized;
+  serialized.resize(sparseHll.serializedSize());
+  sparseHll.serialize(indexBitLength, serialized.data());
+
+  DenseHll denseHll{indexBitLength, &allocator_};
+  SparseHll::toDense(serialized.data(), denseHll);
+  ASSERT_EQ(serialize(denseHll), serialize(expectedHll));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     SparseHllToDenseTest,
     SparseHllToDenseTest,
@@ -142,7 +142,7 @@ class HashStringAllocator : public StreamArena {
   };
 
   explicit HashStringAllocator(memory::MemoryPool* FOLLY_NONNULL pool)
-      : StreamArena(pool), pool_(pool) {}
+      : StreamArena(pool), pool_(pool), appendOnlyPool_(pool) {}
 
   // Copies a StringView at 'offset' in 'group' to storage owned by
   // the hash table. Updates the StringView.
@@ -156,6 +156,27 @@ class HashStringAllocator : public StreamArena {
     *string = StringView(data, string->size());
   }
 
+  // Copies a StringView at 'offset' in 'group' to an append-only arena owned
+  // by 'this'. Updates the StringView. The copy is contiguous and follows a
+  // Header, so it reads like a string written by copyMultipart(). Unlike
+  // copyMultipart() this does not search the free list and has no minimum
+  // size. The copy must not be passed to free(). Its memory is returned by
+  // clear().
+  void copyAppendOnly(char* FOLLY_NONNULL group, int32_t offset) {
+    auto string = reinterpret_cast<StringView*>(group + offset);
+    if (string->isInline()) {
+      return;
+    }
+    const auto numBytes = string->size();
+    // Keeps the Headers aligned.
+    auto* header = new (appendOnlyPool_.allocateFixed(
+        bits::roundUp(sizeof(Header) + numBytes, sizeof(Header))))
+        Header(numBytes);
+    memcpy(header->begin(), string->data(), numBytes);
+    cumulativeBytes_ += numBytes;
+    *string = StringView(header->begin(), numBytes);
+  }
+
   // Copies a StringView at 'offset' in 'group' to storage owned by
   // 'this'. Updates the StringView. A large string may be copied into
   // non-contiguous allocation pieces. The size in the StringView is
@@ -259,7 +280,7 @@ class HashStringAllocator : public StreamArena {
 
   // Returns the total memory footprint of 'this'.
   int64_t retainedSize() const {
-    return pool_.allocatedBytes();
+    return pool_.allocatedBytes() + appendOnlyPool_.allocatedBytes();
   }
 
   // Adds the allocation of 'header' and any extensions (if header has
@@ -283,6 +304,7 @@ class HashStringAllocator : public StreamArena {
     freeBytes_ = 0;
     new (&free_) CompactDoubleList();
     pool_.clear();
+    appendOnlyPool_.clear();
   }
 
   memory::MemoryPool* FOLLY_NONNULL pool() const {
@@ -359,6 +381,10 @@ class HashStringAllocator : public StreamArena {
 
   // Pool for getting new slabs.
   AllocationPool pool_;
+
+  // Arena for copyAppendOnly(). Kept apart from 'pool_' so that the slabs of
+  // 'pool_' consist of Headers linked by size, see checkConsistency().
+  AllocationPool appendOnlyPool_;
 };
 
 // Utility for keeping track of allocation between two points in
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/HugePages.h"
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+
+#include <string>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::memory::hugepages {
+
+namespace {
+void* mapAnonymous(uint64_t bytes, int32_t extraFlags) {
+  void* ptr = ::mmap(
+      nullptr,
+      bytes,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | extraFlags,
+      -1,
+      0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+// Maps 'bytes' aligned to kHugePageBytes by over-mapping and unmapping the
+// unaligned head and the tail. Transparent huge pages can only back aligned
+// 2MB ranges.
+void* mapAligned(uint64_t bytes) {
+  auto* ptr =
+      reinterpret_cast<uint8_t*>(mapAnonymous(bytes + kHugePageBytes, 0));
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+  auto* aligned = reinterpret_cast<uint8_t*>(
+      bits::roundUp(reinterpret_cast<uint64_t>(ptr), kHugePageBytes));
+  if (aligned > ptr) {
+    ::munmap(ptr, aligned - ptr);
+  }
+  const auto tailBytes = (ptr + bytes + kHugePageBytes) - (aligned + bytes);
+  if (tailBytes > 0) {
+    ::munmap(aligned + bytes, tailBytes);
+  }
+  return aligned;
+}
+} // namespace
+
+void Stats::record(Backing requested, Backing actual, uint64_t bytes) {
+  if (actual != requested) {
+    ++numFallbacks;
+  }
+  switch (actual) {
+    case Backing::kHugetlb:
+      ++numHugetlb;
+      break;
+    case Backing::kTransparent:
+      ++numTransparent;
+      break;
+    case Backing::kRegular:
+      return;
+  }
+  hugePageBytes += bytes;
+}
+
+Stats& Stats::operator+=(const Stats& other) {
+  numHugetlb += other.numHugetlb;
+  numTransparent += other.numTransparent;
+  numFallbacks += other.numFallbacks;
+  hugePageBytes += other.hugePageBytes;
+  return *this;
+}
+
+bool transparentHugePagesEnabled() {
+  static const bool kEnabled = []() {
+#ifdef MADV_HUGEPAGE
+    std::string text;
+    if (!folly::readFile("/sys/kernel/mm/transparent_hugepage/enabled", text)) {
+      return false;
+    }
+    // The selected mode is in brackets, e.g. "always [madvise] never".
+    return text.find("[never]") == std::string::npos;
+#else
+    return false;
+#endif
+  }();
+  return kEnabled;
+}
+
+void* map(uint64_t bytes, Backing backing, Backing* actual) {
+  *actual = Backing::kRegular;
+  if (backing == Backing::kRegular) {
+    return mapAnonymous(bytes, 0);
+  }
+  VELOX_CHECK_EQ(bytes % kHugePageBytes, 0);
+#ifdef MAP_HUGETLB
+  if (backing == Backing::kHugetlb) {
+    if (auto* ptr = mapAnonymous(bytes, MAP_HUGETLB)) {
+      *actual = Backing::kHugetlb;
+      return ptr;
+    }
+    VLOG(1) << "No hugetlbfs pages for " << bytes
+            << " bytes: " << folly::errnoStr(errno);
+  }
+#endif
+  auto* ptr = mapAligned(bytes);
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+#ifdef MADV_HUGEPAGE
+  if (transparentHugePagesEnabled() &&
+      ::madvise(ptr, bytes, MADV_HUGEPAGE) == 0) {
+    *actual = Backing::kTransparent;
+  }
+#endif
+  return ptr;
+}
+
+} // namespace facebook::velox::memory::hugepages
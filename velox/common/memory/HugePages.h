@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+
+/// Helpers for backing large mmaps with 2MB huge pages, which reduce the TLB
+/// misses of random access to large hash tables and row containers. Falls
+/// back to regular pages on systems without huge page support.
+namespace facebook::velox::memory::hugepages {
+
+constexpr uint64_t kHugePageBytes = 2 << 20;
+
+/// Backing of a mapping.
+enum class Backing {
+  /// Regular pages.
+  kRegular,
+  /// Transparent huge pages, requested with madvise(MADV_HUGEPAGE). The
+  /// kernel may still use regular pages for parts of the mapping.
+  kTransparent,
+  /// Pages reserved in the hugetlbfs pool, i.e. mapped with MAP_HUGETLB.
+  kHugetlb,
+};
+
+/// Counters of huge page backed mappings.
+struct Stats {
+  /// Number of mappings backed by hugetlbfs pages.
+  uint64_t numHugetlb{0};
+
+  /// Number of mappings with transparent huge pages.
+  uint64_t numTransparent{0};
+
+  /// Number of mappings that did not get the requested backing.
+  uint64_t numFallbacks{0};
+
+  /// Cumulative bytes mapped with huge page backing.
+  uint64_t hugePageBytes{0};
+
+  /// Records a mapping of 'bytes' that asked for 'requested' and got
+  /// 'actual'.
+  void record(Backing requested, Backing actual, uint64_t bytes);
+
+  Stats& operator+=(const Stats& other);
+};
+
+/// Returns true if the kernel supports transparent huge pages and they are
+/// not disabled in /sys/kernel/mm/transparent_hugepage/enabled.
+bool transparentHugePagesEnabled();
+
+/// Maps 'bytes' of private anonymous read-write memory. If 'backing' is not
+/// kRegular, the mapping is aligned to kHugePageBytes and 'bytes' must be a
+/// multiple of kHugePageBytes. kHugetlb falls back to kTransparent if the
+/// hugetlbfs pool does not have enough free pages and kTransparent falls
+/// back to kRegular if transparent huge pages are not enabled. Sets
+/// '*actual' to the backing of the result. Returns nullptr if no memory
+/// could be mapped.
+void* map(uint64_t bytes, Backing backing, Backing* actual);
+
+} // namespace facebook::velox::memory::hugepages
@@ -36,7 +36,9 @@ MemoryManager::MemoryManager(const Options& options)
           .minMemoryPoolCapacityTransferSize =
               options.arbitratorConfig.minMemoryPoolCapacityTransferSize,
           .retryArbitrationFailure =
-              options.arbitratorConfig.retryArbitrationFailure})),
+              options.arbitratorConfig.retryArbitrationFailure,
+          .memoryReleaseWaitTimeMs =
+              options.arbitratorConfig.memoryReleaseWaitTimeMs})),
       alignment_(std::max(MemoryAllocator::kMinAlignment, options.alignment)),
       checkUsageLeak_(options.checkUsageLeak),
       poolDestructionCb_([&](MemoryPool* pool) { dropPool(pool); }),
@@ -50,8 +50,8 @@ std::unique_ptr<MemoryArbitrator> MemoryArbitrator::create(
   }
 }
 
-std::unique_ptr<MemoryReclaimer> MemoryReclaimer::create() {
-  return std::unique_ptr<MemoryReclaimer>(new MemoryReclaimer());
+std::unique_ptr<MemoryReclaimer> MemoryReclaimer::create(int32_t priority) {
+  return std::unique_ptr<MemoryReclaimer>(new MemoryReclaimer(priority));
 }
 
 bool MemoryReclaimer::reclaimableBytes(
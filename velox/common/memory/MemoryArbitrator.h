@@ -79,12 +79,20 @@ class MemoryArbitrator {
     uint64_t minMemoryPoolCapacityTransferSize{32 << 20};
 
     /// If true, handle the memory arbitration failure by aborting the memory
-    /// pool with most capacity and retry the memory arbitration, otherwise we
-    /// simply fails the memory arbitration requestor itself. This helps the
+    /// pool with the lowest priority and most capacity and retry the memory
+    /// arbitration, otherwise we simply fails the memory arbitration requestor
+    /// itself. This helps the
     /// distributed query execution use case such as Prestissimo that fail the
     /// same query on all the workers instead of a random victim query which
     /// happens to trigger the failed memory arbitration.
     bool retryArbitrationFailure{true};
+
+    /// The max time in milliseconds to wait for the other memory pools to
+    /// release memory capacity, e.g. on query completion, if the memory
+    /// reclamation can't free up enough capacity for a request. The request
+    /// fails (or aborts a victim pool) after the wait times out. Zero means no
+    /// wait.
+    uint64_t memoryReleaseWaitTimeMs{0};
   };
   static std::unique_ptr<MemoryArbitrator> create(const Config& config);
 
@@ -163,13 +171,15 @@ class MemoryArbitrator {
         initMemoryPoolCapacity_(config.initMemoryPoolCapacity),
         minMemoryPoolCapacityTransferSize_(
             config.minMemoryPoolCapacityTransferSize),
-        retryArbitrationFailure_(config.retryArbitrationFailure) {}
+        retryArbitrationFailure_(config.retryArbitrationFailure),
+        memoryReleaseWaitTimeMs_(config.memoryReleaseWaitTimeMs) {}
 
   const Kind kind_;
   const uint64_t capacity_;
   const uint64_t initMemoryPoolCapacity_;
   const uint64_t minMemoryPoolCapacityTransferSize_;
   const bool retryArbitrationFailure_;
+  const uint64_t memoryReleaseWaitTimeMs_;
 };
 
 std::ostream& operator<<(std::ostream& out, const MemoryArbitrator::Kind& kind);
@@ -196,7 +206,17 @@ class MemoryReclaimer {
  public:
   virtual ~MemoryReclaimer() = default;
 
-  static std::unique_ptr<MemoryReclaimer> create();
+  /// 'priority' is the importance of the associated query object in memory
+  /// arbitration, see priority().
+  static std::unique_ptr<MemoryReclaimer> create(int32_t priority = 0);
+
+  /// Returns the priority of the associated query object in memory
+  /// arbitration. The shared memory arbitrator reclaims from the memory pools
+  /// with lower priority first, and aborts the memory pool with the lowest
+  /// priority on memory arbitration failure. The default priority is zero.
+  virtual int32_t priority() const {
+    return priority_;
+  }
 
   /// Invoked by the memory arbitrator before entering the memory arbitration
   /// processing. The default implementation does nothing but user can override
@@ -238,6 +258,9 @@ class MemoryReclaimer {
   virtual void abort(MemoryPool* pool);
 
  protected:
-  MemoryReclaimer() = default;
+  explicit MemoryReclaimer(int32_t priority = 0) : priority_(priority) {}
+
+ private:
+  const int32_t priority_;
 };
 } // namespace facebook::velox::memory
@@ -400,6 +400,31 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   /// Returns true if this memory pool has been aborted.
   virtual bool aborted() const = 0;
 
+  /// Invoked by the memory arbitrator to account the time in microseconds
+  /// that a memory arbitration request from this root memory pool has waited,
+  /// including the time queued behind the other requests.
+  void addArbitrationWaitTime(uint64_t waitTimeUs) {
+    arbitrationWaitTimeUs_ += waitTimeUs;
+  }
+
+  /// Invoked by the memory arbitrator to account the used memory bytes that
+  /// have been reclaimed from this root memory pool, e.g. by disk spilling.
+  void addReclaimedBytes(uint64_t bytes) {
+    reclaimedBytes_ += bytes;
+  }
+
+  /// Returns the accumulated memory arbitration wait time of this root memory
+  /// pool in microseconds.
+  uint64_t arbitrationWaitTimeUs() const {
+    return arbitrationWaitTimeUs_;
+  }
+
+  /// Returns the accumulated used memory bytes reclaimed from this root memory
+  /// pool by the memory arbitrator.
+  uint64_t reclaimedBytes() const {
+    return reclaimedBytes_;
+  }
+
   /// The memory pool's execution stats.
   struct Stats {
     /// The current memory usage.
@@ -503,6 +528,10 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   /// reclaimer. We process a query abort request from the root memory pool.
   std::atomic<bool> aborted_{false};
 
+  /// The memory arbitration stats of a root memory pool.
+  std::atomic<uint64_t> arbitrationWaitTimeUs_{0};
+  std::atomic<uint64_t> reclaimedBytes_{0};
+
   mutable folly::SharedMutex poolMutex_;
   /// Used by memory arbitration to reclaim memory from the associated query
   /// object if not null. For example, a memory pool can reclaim the used memory
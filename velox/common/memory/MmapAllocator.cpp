@@ -32,7 +32,11 @@ MmapAllocator::MmapAllocator(const Options& options)
               : options.capacity * options.smallAllocationReservePct / 100),
       capacity_(bits::roundUp(
           AllocationTraits::numPages(options.capacity - mallocReservedBytes_),
-          64 * sizeClassSizes_.back())) {
+          64 * sizeClassSizes_.back())),
+      hugePages_(options.hugePages),
+      threadCachePages_(options.threadCachePages),
+      threadCaches_([this]() { return new ThreadCache(this); }) {
+  VELOX_CHECK_GE(threadCachePages_, 0);
   for (const auto& size : sizeClassSizes_) {
     sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
   }
@@ -42,7 +46,9 @@ MmapAllocator::MmapAllocator(const Options& options)
         AllocationTraits::pageBytes(capacity_) / options.mmapArenaCapacityRatio,
         AllocationTraits::kPageSize);
     managedArenas_ = std::make_unique<ManagedMmapArenas>(
-        std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes));
+        std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes),
+        options.numaAwareMmapArena,
+        hugePages_ != hugepages::Backing::kRegular);
   }
 }
 
@@ -114,8 +120,15 @@ bool MmapAllocator::allocateNonContiguous(
         AllocationTraits::pageBytes(sizeClassSizes_[mix.sizeIndices[i]]),
         mix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[mix.sizeIndices[i]]->allocate(
-              mix.sizeCounts[i], newMapsNeeded, out);
+          // Pages from the thread cache are mapped and do not add to
+          // 'newMapsNeeded'.
+          const auto numCached = threadCachePages_ == 0
+              ? 0
+              : allocateFromThreadCache(
+                    mix.sizeIndices[i], mix.sizeCounts[i], out);
+          success = numCached == mix.sizeCounts[i] ||
+              sizeClasses_[mix.sizeIndices[i]]->allocate(
+                  mix.sizeCounts[i] - numCached, newMapsNeeded, out);
         });
     if (success && ((i > 0) || (mix.numSizes == 1)) &&
         testingHasInjectedFailure(InjectedFailure::kAllocate)) {
@@ -168,7 +181,13 @@ bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
   }
   // We need to advise away a number of pages or we fail the alloc.
   const auto target = totalMaps - capacity_;
-  const auto numAdvised = adviseAway(target);
+  auto numAdvised = adviseAway(target);
+  if (numAdvised < target && numThreadCachedPages_ > 0) {
+    // The pages in the thread caches are mapped but cannot be advised away
+    // before they are returned to their size classes.
+    flushThreadCaches();
+    numAdvised += adviseAway(target - numAdvised);
+  }
   numAdvisedPages_ += numAdvised;
   if (numAdvised >= target) {
     numMapped_.fetch_sub(numAdvised);
@@ -185,6 +204,24 @@ int64_t MmapAllocator::freeNonContiguous(Allocation& allocation) {
 }
 
 MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
+  if (allocation.empty()) {
+    return 0;
+  }
+  if (threadCachePages_ == 0) {
+    return freeToSizeClasses(allocation);
+  }
+  // All pages of 'allocation' are freed, whether to the thread cache or to the
+  // size classes. 'uncached' may also have pages the cache gives up, which
+  // were already counted as freed.
+  const MachinePageCount numFreed = allocation.numPages();
+  Allocation uncached;
+  freeToThreadCache(allocation, uncached);
+  allocation.clear();
+  freeToSizeClasses(uncached);
+  return numFreed;
+}
+
+MachinePageCount MmapAllocator::freeToSizeClasses(Allocation& allocation) {
   MachinePageCount numFreed = 0;
   if (allocation.empty()) {
     return numFreed;
@@ -212,6 +249,120 @@ MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
   return numFreed;
 }
 
+MmapAllocator::ThreadCache::ThreadCache(MmapAllocator* allocator)
+    : allocator(allocator),
+      pages(allocator->sizeClasses_.size()),
+      lowWater(allocator->sizeClasses_.size(), 0) {}
+
+MmapAllocator::ThreadCache::~ThreadCache() {
+  Allocation cached;
+  {
+    std::lock_guard<std::mutex> l(mutex);
+    for (auto i = 0; i < pages.size(); ++i) {
+      allocator->releaseCachedPagesLocked(*this, i, pages[i].size(), cached);
+    }
+  }
+  allocator->freeToSizeClasses(cached);
+}
+
+ClassPageCount MmapAllocator::allocateFromThreadCache(
+    int32_t sizeIndex,
+    ClassPageCount numPages,
+    Allocation& out) {
+  auto& cache = *threadCaches_;
+  const auto unitSize = sizeClasses_[sizeIndex]->unitSize();
+  std::lock_guard<std::mutex> l(cache.mutex);
+  ++cache.numOps;
+  auto& pages = cache.pages[sizeIndex];
+  const ClassPageCount numCached =
+      std::min<ClassPageCount>(numPages, pages.size());
+  for (auto i = 0; i < numCached; ++i) {
+    out.append(pages.back(), unitSize);
+    pages.pop_back();
+  }
+  cache.lowWater[sizeIndex] =
+      std::min<int32_t>(cache.lowWater[sizeIndex], pages.size());
+  numThreadCachedPages_ -= numCached * unitSize;
+  numThreadCacheHits_ += numCached;
+  return numCached;
+}
+
+void MmapAllocator::freeToThreadCache(
+    const Allocation& allocation,
+    Allocation& uncached) {
+  auto& cache = *threadCaches_;
+  std::lock_guard<std::mutex> l(cache.mutex);
+  ++cache.numOps;
+  for (auto i = 0; i < allocation.numRuns(); ++i) {
+    const auto run = allocation.runAt(i);
+    int32_t sizeIndex = 0;
+    while (!sizeClasses_[sizeIndex]->isInRange(run.data())) {
+      ++sizeIndex;
+      VELOX_CHECK_LT(sizeIndex, sizeClasses_.size());
+    }
+    const auto unitSize = sizeClasses_[sizeIndex]->unitSize();
+    const int32_t maxPages = threadCachePages_ / unitSize;
+    auto& pages = cache.pages[sizeIndex];
+    for (auto offset = 0; offset < run.numPages(); offset += unitSize) {
+      uint8_t* page = run.data() + AllocationTraits::pageBytes(offset);
+      if (maxPages == 0) {
+        uncached.append(page, unitSize);
+        continue;
+      }
+      if (pages.size() >= maxPages) {
+        // Gives up the older half of the cache to make room.
+        const int32_t numReleased = (maxPages + 1) / 2;
+        std::rotate(pages.begin(), pages.begin() + numReleased, pages.end());
+        releaseCachedPagesLocked(cache, sizeIndex, numReleased, uncached);
+      }
+      pages.push_back(page);
+      numThreadCachedPages_ += unitSize;
+    }
+  }
+  if (cache.numOps < kThreadCacheTrimOps) {
+    return;
+  }
+  // Returns half of the pages that have not been needed since the last trim.
+  cache.numOps = 0;
+  for (auto i = 0; i < cache.pages.size(); ++i) {
+    releaseCachedPagesLocked(cache, i, (cache.lowWater[i] + 1) / 2, uncached);
+    cache.lowWater[i] = cache.pages[i].size();
+  }
+}
+
+void MmapAllocator::releaseCachedPagesLocked(
+    ThreadCache& cache,
+    int32_t sizeIndex,
+    int32_t numPages,
+    Allocation& out) {
+  auto& pages = cache.pages[sizeIndex];
+  const auto unitSize = sizeClasses_[sizeIndex]->unitSize();
+  numPages = std::min<int32_t>(numPages, pages.size());
+  for (auto i = 0; i < numPages; ++i) {
+    out.append(pages.back(), unitSize);
+    pages.pop_back();
+  }
+  cache.lowWater[sizeIndex] =
+      std::min<int32_t>(cache.lowWater[sizeIndex], pages.size());
+  numThreadCachedPages_ -= numPages * unitSize;
+}
+
+void MmapAllocator::flushThreadCaches() {
+  if (threadCachePages_ == 0) {
+    return;
+  }
+  for (auto& cache : threadCaches_.accessAllThreads()) {
+    Allocation cached;
+    {
+      std::lock_guard<std::mutex> l(cache.mutex);
+      for (auto i = 0; i < cache.pages.size(); ++i) {
+        releaseCachedPagesLocked(cache, i, cache.pages[i].size(), cached);
+      }
+    }
+    freeToSizeClasses(cached);
+  }
+}
+
 bool MmapAllocator::allocateContiguousImpl(
     MachinePageCount numPages,
     Allocation* collateral,
@@ -241,10 +392,7 @@ bool MmapAllocator::allocateContiguousImpl(
       std::lock_guard<std::mutex> l(arenaMutex_);
       managedArenas_->free(allocation.data(), allocation.size());
     } else {
-      if (::munmap(allocation.data(), allocation.size()) < 0) {
-        VELOX_MEM_LOG(ERROR) << "munmap got " << folly::errnoStr(errno)
-                             << " for " << allocation.toString();
-      }
+      unmapContiguous(allocation);
     }
     allocation.clear();
   }
@@ -327,16 +475,16 @@ bool MmapAllocator::allocateContiguousImpl(
       std::lock_guard<std::mutex> l(arenaMutex_);
       data = managedArenas_->allocate(AllocationTraits::pageBytes(numPages));
     } else {
-      data = ::mmap(
-          nullptr,
-          AllocationTraits::pageBytes(numPages),
-          PROT_READ | PROT_WRITE,
-          MAP_PRIVATE | MAP_ANONYMOUS,
-          -1,
-          0);
+      const auto mapBytes =
+          contiguousMapBytes(AllocationTraits::pageBytes(numPages));
+      hugepages::Backing backing;
+      data = hugepages::map(mapBytes, hugePages_, &backing);
+      if (data != nullptr && hugePages_ != hugepages::Backing::kRegular) {
+        std::lock_guard<std::mutex> l(hugePageMutex_);
+        hugePageStats_.record(hugePages_, backing, mapBytes);
+      }
     }
   }
-  // TODO: add handling of MAP_FAILED.
   if (data == nullptr) {
     VELOX_MEM_LOG(ERROR) << "Mmap failed with " << numPages
                          << " pages, use MmapArena "
@@ -358,10 +506,7 @@ void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
     std::lock_guard<std::mutex> l(arenaMutex_);
     managedArenas_->free(allocation.data(), allocation.size());
   } else {
-    if (::munmap(allocation.data(), allocation.size()) < 0) {
-      VELOX_MEM_LOG(ERROR) << "munmap returned " << folly::errnoStr(errno)
-                           << " for " << allocation.toString();
-    }
+    unmapContiguous(allocation);
   }
   numMapped_ -= allocation.numPages();
   numExternalMapped_ -= allocation.numPages();
@@ -369,6 +514,14 @@ void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
   allocation.clear();
 }
 
+void MmapAllocator::unmapContiguous(const ContiguousAllocation& allocation) {
+  const auto bytes = contiguousMapBytes(allocation.size());
+  if (::munmap(allocation.data(), bytes) < 0) {
+    VELOX_MEM_LOG(ERROR) << "munmap returned " << folly::errnoStr(errno)
+                         << " for " << allocation.toString();
+  }
+}
+
 void* MmapAllocator::allocateBytes(uint64_t bytes, uint16_t alignment) {
   alignmentCheck(bytes, alignment);
 
@@ -868,11 +1021,15 @@ bool MmapAllocator::checkConsistency() const {
         sizeClass->checkConsistency(mapped, numErrors) * sizeClass->unitSize();
     mappedCount += mapped * sizeClass->unitSize();
   }
-  if (count != numAllocated_ - numExternalMapped_) {
+  // The pages in the thread caches are allocated in their size classes but
+  // not counted in 'numAllocated_'.
+  if (count !=
+      numAllocated_ - numExternalMapped_ + numThreadCachedPages_) {
     ++numErrors;
     VELOX_MEM_LOG(WARNING) << "Allocated count out of sync. Actual= " << count
                            << " recorded= "
-                           << numAllocated_ - numExternalMapped_;
+                           << numAllocated_ - numExternalMapped_
+                           << " thread cached= " << numThreadCachedPages_;
   }
   if (mappedCount != numMapped_ - numExternalMapped_) {
     ++numErrors;
@@ -895,7 +1052,7 @@ std::string MmapAllocator::toString() const {
   std::stringstream out;
   out << "[Memory capacity " << capacity_ << " allocated " << numAllocated_
       << " mapped " << numMapped_ << " external mapped " << numExternalMapped_
-      << std::endl;
+      << " thread cached " << numThreadCachedPages_ << std::endl;
   for (auto& sizeClass : sizeClasses_) {
     out << sizeClass->toString() << std::endl;
   }
@@ -24,7 +24,10 @@
 #include <mutex>
 #include <unordered_set>
 
+#include <folly/ThreadLocal.h>
+
 #include "velox/common/base/SimdUtil.h"
+#include "velox/common/memory/HugePages.h"
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/common/memory/MmapArena.h"
 
@@ -61,6 +64,11 @@ class MmapAllocator : public MemoryAllocator {
     /// capacity to single MmapArena capacity ratio.
     int32_t mmapArenaCapacityRatio = 10;
 
+    /// If set with 'useMmapArena', the arenas are bound to NUMA nodes and an
+    /// allocation is served from the arena of the node the calling thread
+    /// runs on.
+    bool numaAwareMmapArena = false;
+
     /// If not zero, reserve 'smallAllocationReservePct'% of space from
     /// 'capacity' for ad hoc small allocations. And those allocations are
     /// delegated to std::malloc.
@@ -75,6 +83,23 @@ class MmapAllocator : public MemoryAllocator {
     /// and 'smallAllocationReservePct' will be automatically set to 0
     /// disregarding any passed in value.
     int32_t maxMallocBytes = 3072;
+
+    /// If not zero, each thread keeps up to 'threadCachePages' machine pages
+    /// of each size class that it frees, and serves its next allocations of
+    /// the size class from these without taking the size class lock. The
+    /// cached pages count as free against 'capacity' but stay backed by
+    /// memory. They are returned to their size classes when the cache of the
+    /// thread overflows, when they stay unused for a while, when the thread
+    /// exits and when advising away memory needs them.
+    int32_t threadCachePages = 0;
+
+    /// Backing of the memory of contiguous allocations, which are used for
+    /// hash tables and other large randomly accessed structures. With huge
+    /// pages, a mmap per allocation is rounded up to a multiple of
+    /// hugepages::kHugePageBytes. The MmapArenas of 'useMmapArena' use
+    /// transparent huge pages if this is not kRegular. Falls back to regular
+    /// pages if huge pages are not available. See hugePageStats().
+    hugepages::Backing hugePages = hugepages::Backing::kRegular;
   };
 
   explicit MmapAllocator(const Options& options);
@@ -165,6 +190,44 @@ class MmapAllocator : public MemoryAllocator {
     return numMallocBytes_;
   }
 
+  /// Returns the number of machine pages in the thread caches. See
+  /// Options::threadCachePages.
+  MachinePageCount numThreadCachedPages() const {
+    return numThreadCachedPages_;
+  }
+
+  /// Returns the cumulative number of size class pages allocated from the
+  /// thread caches.
+  uint64_t numThreadCacheHits() const {
+    return numThreadCacheHits_;
+  }
+
+  /// Returns the pages in the caches of all threads to their size classes.
+  void flushThreadCaches();
+
+  /// Returns the per NUMA node usage of the MmapArenas. Empty if
+  /// 'useMmapArena' is not set.
+  ManagedMmapArenas::NumaStats arenaNumaStats() {
+    std::lock_guard<std::mutex> l(arenaMutex_);
+    return managedArenas_ == nullptr ? ManagedMmapArenas::NumaStats{}
+                                     : managedArenas_->numaStats();
+  }
+
+  /// Returns the huge page backing of the mmaps of contiguous allocations and
+  /// MmapArenas.
+  hugepages::Stats hugePageStats() {
+    hugepages::Stats stats;
+    {
+      std::lock_guard<std::mutex> l(hugePageMutex_);
+      stats = hugePageStats_;
+    }
+    std::lock_guard<std::mutex> l(arenaMutex_);
+    if (managedArenas_ != nullptr) {
+      stats += managedArenas_->hugePageStats();
+    }
+    return stats;
+  }
+
   Stats stats() const override {
     auto stats = stats_;
     stats.numAdvise = numAdvisedPages_;
@@ -330,6 +393,57 @@ class MmapAllocator : public MemoryAllocator {
     uint64_t numAdvisedAway_ = 0;
   };
 
+  struct ThreadCacheTag {};
+
+  // Free size class pages kept by one thread. The pages are marked allocated
+  // in their size classes. 'mutex' is uncontended except when another thread
+  // flushes the cache.
+  struct ThreadCache {
+    explicit ThreadCache(MmapAllocator* allocator);
+
+    // Returns the cached pages to the size classes of 'allocator'.
+    ~ThreadCache();
+
+    MmapAllocator* const allocator;
+    std::mutex mutex;
+    // Start addresses of the cached class pages for each size class.
+    std::vector<std::vector<uint8_t*>> pages;
+    // The least number of cached pages of each size class since the last
+    // trim. These many pages have not been needed in the meantime.
+    std::vector<int32_t> lowWater;
+    // Number of allocations and frees since the last trim.
+    int32_t numOps{0};
+  };
+
+  // Number of operations on a thread cache after which the pages that have
+  // not been used in the meantime are returned to their size classes.
+  static constexpr int32_t kThreadCacheTrimOps = 4096;
+
+  // Moves up to 'numPages' class pages of size class 'sizeIndex' from the
+  // cache of the calling thread to 'out'. Returns the number of class pages
+  // moved.
+  ClassPageCount allocateFromThreadCache(
+      int32_t sizeIndex,
+      ClassPageCount numPages,
+      Allocation& out);
+
+  // Moves the class pages of 'allocation' to the cache of the calling thread.
+  // Adds the pages that do not fit and any pages the cache gives up to
+  // 'uncached'.
+  void freeToThreadCache(const Allocation& allocation, Allocation& uncached);
+
+  // Moves the last 'numPages' cached pages of size class 'sizeIndex' in
+  // 'cache' to 'out'. Must be called with 'cache.mutex' held.
+  void releaseCachedPagesLocked(
+      ThreadCache& cache,
+      int32_t sizeIndex,
+      int32_t numPages,
+      Allocation& out);
+
+  // Frees the pages of 'allocation' in the size classes and clears
+  // 'allocation'. Returns the number of freed machine pages.
+  MachinePageCount freeToSizeClasses(Allocation& allocation);
+
   bool allocateContiguousImpl(
       MachinePageCount numPages,
       Allocation* collateral,
@@ -338,6 +452,16 @@ class MmapAllocator : public MemoryAllocator {
 
   void freeContiguousImpl(ContiguousAllocation& allocation);
 
+  // Returns the size of the mmap for a contiguous allocation of 'bytes'.
+  uint64_t contiguousMapBytes(uint64_t bytes) const {
+    return hugePages_ == hugepages::Backing::kRegular
+        ? bytes
+        : bits::roundUp(bytes, hugepages::kHugePageBytes);
+  }
+
+  // Unmaps the memory of a contiguous allocation that is not in an arena.
+  void unmapContiguous(const ContiguousAllocation& allocation);
+
   // Ensures that there are at least 'newMappedNeeded' pages that are
   // not backing any existing allocation. If capacity_ - numMapped_ <
   // newMappedNeeded, advises away enough pages backing freed slots in
@@ -409,6 +533,20 @@ class MmapAllocator : public MemoryAllocator {
   std::unique_ptr<ManagedMmapArenas> managedArenas_;
 
   Stats stats_;
+
+  // See Options::hugePages.
+  const hugepages::Backing hugePages_;
+  std::mutex hugePageMutex_;
+  hugepages::Stats hugePageStats_;
+
+  // See Options::threadCachePages.
+  const int32_t threadCachePages_;
+  std::atomic<MachinePageCount> numThreadCachedPages_{0};
+  std::atomic<uint64_t> numThreadCacheHits_{0};
+
+  // Declared after 'sizeClasses_' so that the caches are flushed before the
+  // size classes are destroyed.
+  folly::ThreadLocal<ThreadCache, ThreadCacheTag> threadCaches_;
 };
 
 } // namespace facebook::velox::memory
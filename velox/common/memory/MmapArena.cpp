@@ -19,39 +19,46 @@
 #include <sys/mman.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/memory/Memory.h"
+#include "velox/common/memory/Numa.h"
 
 namespace facebook::velox::memory {
 uint64_t MmapArena::roundBytes(uint64_t bytes) {
   return bits::nextPowerOfTwo(bytes);
 }
 
-MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
+MmapArena::MmapArena(size_t capacityBytes, int32_t numaNode, bool hugePages)
+    : byteSize_(capacityBytes),
+      numaNode_(numaNode),
+      mappedBytes_(
+          hugePages ? bits::roundUp(capacityBytes, hugepages::kHugePageBytes)
+                    : capacityBytes) {
   VELOX_CHECK_EQ(
       byteSize_ % kMinGrainSizeBytes,
       0,
       "Arena must have a multiple of {} bytes capacity.",
       kMinGrainSizeBytes);
-  void* ptr = mmap(
-      nullptr,
-      capacityBytes,
-      PROT_READ | PROT_WRITE,
-      MAP_PRIVATE | MAP_ANONYMOUS,
-      -1,
-      0);
-  if (ptr == MAP_FAILED || ptr == nullptr) {
+  void* ptr = hugepages::map(
+      mappedBytes_,
+      hugePages ? hugepages::Backing::kTransparent
+                : hugepages::Backing::kRegular,
+      &backing_);
+  if (ptr == nullptr) {
     VELOX_FAIL(
         "Could not allocate working memory"
         "mmap failed with errno {} with capacity bytes {}",
         folly::errnoStr(errno),
         capacityBytes);
   }
+  if (numaNode_ != kNoNode) {
+    numa::bindMemory(ptr, mappedBytes_, numaNode_);
+  }
   address_ = reinterpret_cast<uint8_t*>(ptr);
   addFreeBlock(reinterpret_cast<uint64_t>(address_), byteSize_);
   freeBytes_ = byteSize_;
 }
 
 MmapArena::~MmapArena() {
-  ::munmap(address_, byteSize_);
+  ::munmap(address_, mappedBytes_);
 }
 
 void* MmapArena::allocate(uint64_t bytes) {
@@ -276,26 +283,52 @@ std::string MmapArena::toString() const {
       freeList_.size());
 }
 
-ManagedMmapArenas::ManagedMmapArenas(uint64_t singleArenaCapacity)
-    : singleArenaCapacity_(singleArenaCapacity) {
-  auto arena = std::make_shared<MmapArena>(singleArenaCapacity);
+ManagedMmapArenas::ManagedMmapArenas(
+    uint64_t singleArenaCapacity,
+    bool numaAware,
+    bool hugePages)
+    : singleArenaCapacity_(singleArenaCapacity),
+      numaAware_(numaAware && numa::numNodes() > 1),
+      hugePages_(hugePages) {
+  const auto numNodes = numaAware_ ? numa::numNodes() : 1;
+  numaStats_.allocatedBytes.resize(numNodes);
+  for (auto node = 0; node < numNodes; ++node) {
+    currentArenas_.push_back(
+        addArena(numaAware_ ? node : MmapArena::kNoNode));
+  }
+}
+
+std::shared_ptr<MmapArena> ManagedMmapArenas::addArena(int32_t numaNode) {
+  auto arena = std::make_shared<MmapArena>(
+      singleArenaCapacity_, numaNode, hugePages_);
+  if (hugePages_) {
+    hugePageStats_.record(
+        hugepages::Backing::kTransparent,
+        arena->backing(),
+        singleArenaCapacity_);
+  }
   arenas_.emplace(reinterpret_cast<uint64_t>(arena->address()), arena);
-  currentArena_ = arena;
+  return arena;
 }
 
 void* ManagedMmapArenas::allocate(uint64_t bytes) {
-  auto* result = currentArena_->allocate(bytes);
+  auto node = numaAware_ ? numa::currentNode() : 0;
+  if (node >= currentArenas_.size()) {
+    node = 0;
+  }
+  auto& currentArena = currentArenas_[node];
+  auto* result = currentArena->allocate(bytes);
+  if (result == nullptr) {
+    // If first allocation fails we create a new MmapArena for another attempt.
+    // If it ever fails again then it means requested bytes is larger than a
+    // single MmapArena's capacity. No further attempts will happen.
+    currentArena = addArena(currentArena->numaNode());
+    result = currentArena->allocate(bytes);
+  }
   if (result != nullptr) {
-    return result;
+    numaStats_.allocatedBytes[node] += bytes;
   }
-
-  // If first allocation fails we create a new MmapArena for another attempt. If
-  // it ever fails again then it means requested bytes is larger than a single
-  // MmapArena's capacity. No further attempts will happen.
-  auto newArena = std::make_shared<MmapArena>(singleArenaCapacity_);
-  arenas_.emplace(reinterpret_cast<uint64_t>(newArena->address()), newArena);
-  currentArena_ = newArena;
-  return currentArena_->allocate(bytes);
+  return result;
 }
 
 void ManagedMmapArenas::free(void* address, uint64_t bytes) {
@@ -307,8 +340,14 @@ void ManagedMmapArenas::free(void* address, uint64_t bytes) {
     --iter;
     VELOX_CHECK_GE(iter->first + singleArenaCapacity_, addressU64 + bytes);
   }
-  iter->second->free(address, bytes);
-  if (iter->second->empty() && iter->second != currentArena_) {
+  auto& arena = iter->second;
+  const auto node = numaAware_ ? arena->numaNode() : 0;
+  if (numaAware_ && node != numa::currentNode()) {
+    ++numaStats_.numRemoteFrees;
+  }
+  numaStats_.allocatedBytes[node] -= bytes;
+  arena->free(address, bytes);
+  if (arena->empty() && arena != currentArenas_[node]) {
     arenas_.erase(iter);
   }
 }
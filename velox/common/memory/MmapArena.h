@@ -21,7 +21,9 @@
 #include <map>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
+#include "velox/common/memory/HugePages.h"
 #include "velox/common/memory/MemoryAllocator.h"
 
 namespace facebook::velox::memory {
@@ -36,9 +38,27 @@ class MmapArena {
   /// MmapArena capacity should be multiple of kMinGrainSizeBytes.
   static constexpr uint64_t kMinGrainSizeBytes = 1024 * 1024; // 1M
 
-  MmapArena(size_t capacityBytes);
+  /// If 'numaNode' is not kNoNode, binds the memory of the arena to that
+  /// NUMA node. If 'hugePages' is set, asks for transparent huge pages for the
+  /// memory of the arena and falls back to regular pages if these are not
+  /// enabled. hugetlbfs pages are not used since freed blocks need not be
+  /// aligned to huge pages.
+  explicit MmapArena(
+      size_t capacityBytes,
+      int32_t numaNode = kNoNode,
+      bool hugePages = false);
   ~MmapArena();
 
+  static constexpr int32_t kNoNode = -1;
+
+  int32_t numaNode() const {
+    return numaNode_;
+  }
+
+  hugepages::Backing backing() const {
+    return backing_;
+  }
+
   void* allocate(uint64_t bytes);
   void free(void* address, uint64_t bytes);
   void* address() const {
@@ -104,6 +124,15 @@ class MmapArena {
   // Total capacity size of this arena.
   const uint64_t byteSize_;
 
+  // NUMA node the memory is bound to or kNoNode.
+  const int32_t numaNode_;
+
+  // Size of the mapping at 'address_'. More than 'byteSize_' if rounded up to
+  // huge pages.
+  uint64_t mappedBytes_;
+
+  hugepages::Backing backing_{hugepages::Backing::kRegular};
+
   // Starting address of this arena.
   uint8_t* address_;
 
@@ -121,9 +150,19 @@ class MmapArena {
 /// A class that manages a set of MmapArenas. It is able to adapt itself by
 /// growing the number of its managed MmapArena's when extreme memory
 /// fragmentation happens.
+///
+/// If 'numaAware' is set, there is a current arena per NUMA node, bound to
+/// that node, and an allocation is served from the arena of the node the
+/// calling thread runs on. Drivers pinned to a node then get their large
+/// allocations, e.g. hash tables, from local memory.
+///
+/// If 'hugePages' is set, the arenas ask for transparent huge pages.
 class ManagedMmapArenas {
  public:
-  ManagedMmapArenas(uint64_t singleArenaCapacity);
+  explicit ManagedMmapArenas(
+      uint64_t singleArenaCapacity,
+      bool numaAware = false,
+      bool hugePages = false);
 
   void* allocate(uint64_t bytes);
 
@@ -133,16 +172,46 @@ class ManagedMmapArenas {
     return arenas_;
   }
 
+  struct NumaStats {
+    /// Bytes allocated from the arenas of each NUMA node. A single entry if
+    /// not NUMA aware.
+    std::vector<uint64_t> allocatedBytes;
+
+    /// Number of frees from a thread on a different node than the memory,
+    /// i.e. allocations that were likely used across nodes.
+    uint64_t numRemoteFrees{0};
+  };
+
+  const NumaStats& numaStats() const {
+    return numaStats_;
+  }
+
+  /// Returns the huge page backing of the arenas created so far.
+  const hugepages::Stats& hugePageStats() const {
+    return hugePageStats_;
+  }
+
  private:
+  std::shared_ptr<MmapArena> addArena(int32_t numaNode);
+
   // Capacity in bytes for a single MmapArena managed by this.
   const uint64_t singleArenaCapacity_;
 
+  const bool numaAware_;
+
+  const bool hugePages_;
+
   // A sorted list of MmapArena by its initial address
   std::map<uint64_t, std::shared_ptr<MmapArena>> arenas_;
 
-  // All allocations should come from this MmapArena. When it is no longer able
-  // to handle allocations it will be updated to a newly created MmapArena.
-  std::shared_ptr<MmapArena> currentArena_;
+  // All allocations should come from these MmapArenas, one per NUMA node if
+  // 'numaAware_', otherwise one. When an arena is no longer able to handle
+  // allocations it will be updated to a newly created MmapArena.
+  std::vector<std::shared_ptr<MmapArena>> currentArenas_;
+
+  NumaStats numaStats_;
+
+  hugepages::Stats hugePageStats_;
 };
 
 } // namespace facebook::velox::memory
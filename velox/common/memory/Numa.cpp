@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/Numa.h"
+
+#include <fmt/format.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace facebook::velox::memory::numa {
+
+namespace {
+// Parses a sysfs CPU or node list like "0-3,8,10-11".
+std::vector<int32_t> parseList(const std::string& text) {
+  std::vector<int32_t> result;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', folly::trimWhitespace(text), ranges, true);
+  for (const auto& range : ranges) {
+    folly::StringPiece first;
+    folly::StringPiece last;
+    if (folly::split('-', range, first, last)) {
+      for (auto i = folly::to<int32_t>(first); i <= folly::to<int32_t>(last);
+           ++i) {
+        result.push_back(i);
+      }
+    } else {
+      result.push_back(folly::to<int32_t>(range));
+    }
+  }
+  return result;
+}
+
+std::vector<int32_t> readList(const std::string& path) {
+  std::string text;
+  if (!folly::readFile(path.c_str(), text)) {
+    return {};
+  }
+  try {
+    return parseList(text);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Cannot parse " << path << ": " << e.what();
+    return {};
+  }
+}
+
+#ifdef __linux__
+// From linux/mempolicy.h.
+constexpr int kMpolBind = 2;
+#endif
+} // namespace
+
+int32_t numNodes() {
+  static const int32_t kNumNodes = []() {
+    const auto nodes = readList("/sys/devices/system/node/online");
+    return nodes.empty() ? 1 : nodes.back() + 1;
+  }();
+  return kNumNodes;
+}
+
+std::vector<int32_t> nodeCpus(int32_t node) {
+  return readList(fmt::format("/sys/devices/system/node/node{}/cpulist", node));
+}
+
+int32_t currentNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu;
+  unsigned node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+bool pinCurrentThread(int32_t node) {
+#ifdef __linux__
+  const auto cpus = nodeCpus(node);
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &cpuSet);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+  return false;
+#endif
+}
+
+bool bindMemory(void* address, uint64_t bytes, int32_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int32_t kBitsPerWord = 64;
+  // The kernel reads one bit less than 'maxnode', so leave a spare word.
+  std::vector<uint64_t> nodeMask(node / kBitsPerWord + 2);
+  nodeMask[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+  if (syscall(
+          SYS_mbind,
+          address,
+          bytes,
+          kMpolBind,
+          nodeMask.data(),
+          nodeMask.size() * kBitsPerWord,
+          0) == 0) {
+    return true;
+  }
+  LOG(WARNING) << "mbind to NUMA node " << node
+               << " failed: " << folly::errnoStr(errno);
+#endif
+  return false;
+}
+
+} // namespace facebook::velox::memory::numa
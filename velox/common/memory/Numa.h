@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// Minimal NUMA topology and memory policy helpers. These read the topology
+/// from sysfs and call the kernel directly, so that there is no dependency on
+/// libnuma. On systems without NUMA support there is a single node 0 with all
+/// CPUs and binding memory is a no-op.
+namespace facebook::velox::memory::numa {
+
+/// Returns the number of NUMA nodes of the machine, at least 1.
+int32_t numNodes();
+
+/// Returns the CPUs of 'node'. Empty if the topology cannot be read.
+std::vector<int32_t> nodeCpus(int32_t node);
+
+/// Returns the NUMA node of the CPU the calling thread runs on, 0 if unknown.
+int32_t currentNode();
+
+/// Restricts the calling thread to the CPUs of 'node'. Returns false if the
+/// affinity could not be set.
+bool pinCurrentThread(int32_t node);
+
+/// Binds the pages of ['address', 'address' + 'bytes') to 'node', so that
+/// they are allocated from the memory of 'node' when first touched. Must be
+/// called before the memory is touched. Returns false if the policy could
+/// not be set, e.g. when the kernel has no NUMA support.
+bool bindMemory(void* address, uint64_t bytes, int32_t node);
+
+} // namespace facebook::velox::memory::numa
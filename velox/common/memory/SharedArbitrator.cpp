@@ -49,6 +49,10 @@ void SharedArbitrator::sortCandidatesByReclaimableMemory(
         if (!rhs.reclaimable) {
           return true;
         }
+        // Reclaims from the lower priority candidates first.
+        if (lhs.priority != rhs.priority) {
+          return lhs.priority < rhs.priority;
+        }
         return lhs.reclaimableBytes > rhs.reclaimableBytes;
       });
 
@@ -57,13 +61,13 @@ void SharedArbitrator::sortCandidatesByReclaimableMemory(
       &candidates);
 }
 
-const SharedArbitrator::Candidate&
-SharedArbitrator::findCandidateWithLargestCapacity(
+const SharedArbitrator::Candidate& SharedArbitrator::findCandidateToAbort(
     MemoryPool* requestor,
     uint64_t targetBytes,
     const std::vector<Candidate>& candidates) const {
   VELOX_CHECK(!candidates.empty());
   int32_t candidateIdx{-1};
+  int32_t minPriority{0};
   int64_t maxCapacity{-1};
   for (int32_t i = 0; i < candidates.size(); ++i) {
     const bool isCandidate = candidates[i].pool == requestor;
@@ -71,23 +75,24 @@ SharedArbitrator::findCandidateWithLargestCapacity(
     // current capacity and the capacity growth.
     const int64_t capacity =
         candidates[i].pool->capacity() + (isCandidate ? targetBytes : 0);
-    if (i == 0) {
-      candidateIdx = 0;
-      maxCapacity = capacity;
-      continue;
-    }
-    if (maxCapacity > capacity) {
-      continue;
-    }
-    if (capacity < maxCapacity) {
-      candidateIdx = i;
-      continue;
-    }
-    // With the same amount of capacity, we prefer to kill the requestor itself
-    // without affecting the other query.
-    if (isCandidate) {
-      candidateIdx = i;
+    if (candidateIdx != -1) {
+      if (candidates[i].priority > minPriority) {
+        continue;
+      }
+      if (candidates[i].priority == minPriority) {
+        if (capacity < maxCapacity) {
+          continue;
+        }
+        // With the same amount of capacity, we prefer to kill the requestor
+        // itself without affecting the other query.
+        if (capacity == maxCapacity && !isCandidate) {
+          continue;
+        }
+      }
     }
+    candidateIdx = i;
+    minPriority = candidates[i].priority;
+    maxCapacity = capacity;
   }
   VELOX_CHECK_NE(candidateIdx, -1);
   return candidates[candidateIdx];
@@ -123,8 +128,14 @@ std::vector<SharedArbitrator::Candidate> SharedArbitrator::getCandidateStats(
   for (const auto& pool : pools) {
     uint64_t reclaimableBytes;
     const bool reclaimable = pool->reclaimableBytes(reclaimableBytes);
+    const int32_t priority =
+        pool->reclaimer() == nullptr ? 0 : pool->reclaimer()->priority();
     candidates.push_back(
-        {reclaimable, reclaimableBytes, pool->freeBytes(), pool.get()});
+        {reclaimable,
+         reclaimableBytes,
+         pool->freeBytes(),
+         priority,
+         pool.get()});
   }
   return candidates;
 }
@@ -169,7 +180,7 @@ void SharedArbitrator::handleOOM(
     uint64_t targetBytes,
     std::vector<Candidate>& candidates) {
   MemoryPool* victim =
-      findCandidateWithLargestCapacity(requestor, targetBytes, candidates).pool;
+      findCandidateToAbort(requestor, targetBytes, candidates).pool;
   if (requestor != victim) {
     VELOX_MEM_LOG(WARNING) << "Aborting victim memory pool " << victim->name()
                            << " to free up memory for requestor "
@@ -230,6 +241,11 @@ bool SharedArbitrator::arbitrateMemory(
     }
   });
 
+  if (freedBytes < targetBytes && memoryReleaseWaitTimeMs_ > 0) {
+    freedBytes += waitForMemoryRelease(
+        candidates, targetBytes - freedBytes, growTarget - freedBytes);
+  }
+
   if (freedBytes < targetBytes) {
     VELOX_MEM_LOG(WARNING)
         << "Failed to arbitrate sufficient memory for memory pool "
@@ -295,6 +311,37 @@ uint64_t SharedArbitrator::reclaimUsedMemoryFromCandidates(
   return freedBytes;
 }
 
+uint64_t SharedArbitrator::waitForMemoryRelease(
+    std::vector<Candidate>& candidates,
+    uint64_t minBytes,
+    uint64_t maxBytes) {
+  // The interval to check the candidates for the capacity they have freed in
+  // the meantime. The candidate pools are kept alive by the arbitration so
+  // their capacity is not returned to the arbitrator on destruction.
+  constexpr std::chrono::milliseconds kCheckInterval{10};
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(memoryReleaseWaitTimeMs_);
+  uint64_t freedBytes{0};
+  for (;;) {
+    for (auto& candidate : candidates) {
+      candidate.freeBytes = candidate.pool->freeBytes();
+    }
+    freedBytes +=
+        reclaimFreeMemoryFromCandidates(candidates, maxBytes - freedBytes);
+    if (freedBytes >= minBytes) {
+      break;
+    }
+    std::unique_lock<std::mutex> l(mutex_);
+    freedBytes += decrementFreeCapacityLocked(maxBytes - freedBytes);
+    const auto now = std::chrono::steady_clock::now();
+    if (freedBytes >= minBytes || now >= deadline) {
+      break;
+    }
+    freeCapacityCv_.wait_until(l, std::min(deadline, now + kCheckInterval));
+  }
+  return freedBytes;
+}
+
 uint64_t SharedArbitrator::reclaim(
     MemoryPool* pool,
     uint64_t targetBytes) noexcept {
@@ -318,6 +365,7 @@ uint64_t SharedArbitrator::reclaim(
   const uint64_t reclaimedbytes = oldCapacity - newCapacity;
   numShrunkBytes_ += freedBytes;
   numReclaimedBytes_ += reclaimedbytes - freedBytes;
+  pool->addReclaimedBytes(reclaimedbytes - freedBytes);
   return reclaimedbytes;
 }
 
@@ -354,6 +402,7 @@ void SharedArbitrator::incrementFreeCapacity(uint64_t bytes) {
 
 void SharedArbitrator::incrementFreeCapacityLocked(uint64_t bytes) {
   freeCapacity_ += bytes;
+  freeCapacityCv_.notify_all();
   if (FOLLY_UNLIKELY(freeCapacity_ > capacity_)) {
     VELOX_FAIL(
         "The free capacity {} is larger than the max capacity {}, {}",
@@ -412,6 +461,7 @@ SharedArbitrator::ScopedArbitration::~ScopedArbitration() {
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::steady_clock::now() - startTime_);
   arbitrator_->arbitrationTimeUs_ += arbitrationTime.count();
+  requestor_->root()->addArbitrationWaitTime(arbitrationTime.count());
   arbitrator_->finishArbitration();
 }
 
@@ -21,6 +21,8 @@
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/common/memory/Memory.h"
 
+#include <condition_variable>
+
 namespace facebook::velox::memory {
 class SharedArbitrator : public MemoryArbitrator {
  public:
@@ -49,6 +51,7 @@ class SharedArbitrator : public MemoryArbitrator {
     bool reclaimable{false};
     uint64_t reclaimableBytes{0};
     uint64_t freeBytes{0};
+    int32_t priority{0};
     MemoryPool* pool;
   };
 
@@ -74,10 +77,11 @@ class SharedArbitrator : public MemoryArbitrator {
 
   void sortCandidatesByFreeCapacity(std::vector<Candidate>& candidates) const;
 
-  // Finds the candidate with the largest capacity. For 'requestor', the
-  // capacity for comparison including its current capacity and the capacity to
-  // grow.
-  const Candidate& findCandidateWithLargestCapacity(
+  // Finds the candidate to abort on memory arbitration failure. This is the
+  // candidate with the lowest priority, and among those the one with the
+  // largest capacity. For 'requestor', the capacity for comparison including
+  // its current capacity and the capacity to grow.
+  const Candidate& findCandidateToAbort(
       MemoryPool* requestor,
       uint64_t targetBytes,
       const std::vector<Candidate>& candidates) const;
@@ -114,6 +118,15 @@ class SharedArbitrator : public MemoryArbitrator {
       std::vector<Candidate>& candidates,
       uint64_t targetBytes);
 
+  // Invoked after the memory reclamation falls short to wait up to
+  // 'memoryReleaseWaitTimeMs_' for 'candidates' or the arbitrator to have
+  // 'minBytes' free capacity. The function returns the freed capacity of up to
+  // 'maxBytes'.
+  uint64_t waitForMemoryRelease(
+      std::vector<Candidate>& candidates,
+      uint64_t minBytes,
+      uint64_t maxBytes);
+
   // Invoked to reclaim used memory from 'pool' with specified 'targetBytes'.
   // The function returns the actually freed capacity.
   uint64_t reclaim(MemoryPool* pool, uint64_t targetBytes) noexcept;
@@ -122,7 +135,7 @@ class SharedArbitrator : public MemoryArbitrator {
   void abort(MemoryPool* pool);
 
   // Invoked to handle the memory arbitration failure to abort the memory pool
-  // with the largest capacity to free up memory.
+  // with the lowest priority and largest capacity to free up memory.
   void handleOOM(
       MemoryPool* requestor,
       uint64_t targetBytes,
@@ -144,6 +157,9 @@ class SharedArbitrator : public MemoryArbitrator {
 
   mutable std::mutex mutex_;
   uint64_t freeCapacity_{0};
+  // Signaled on free capacity increment for the memory arbitration request
+  // waiting in waitForMemoryRelease().
+  std::condition_variable freeCapacityCv_;
   // Indicates if there is a running arbitration request or not.
   bool running_{false};
 
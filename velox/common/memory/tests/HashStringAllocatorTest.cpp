@@ -170,6 +170,35 @@ TEST_F(HashStringAllocatorTest, multipart) {
   instance_->checkConsistency();
 }
 
+TEST_F(HashStringAllocatorTest, appendOnly) {
+  std::vector<std::string> strings;
+  std::vector<StringView> views;
+  for (auto i = 0; i < 1'000; ++i) {
+    strings.push_back(std::string(i % 100, 'a' + i % 26));
+  }
+  for (auto& string : strings) {
+    views.push_back(StringView(string));
+    instance_->copyAppendOnly(reinterpret_cast<char*>(&views.back()), 0);
+  }
+  instance_->checkConsistency();
+  std::string storage;
+  for (auto i = 0; i < strings.size(); ++i) {
+    EXPECT_EQ(
+        strings[i],
+        HashStringAllocator::contiguousString(views[i], storage).str());
+    if (!views[i].isInline()) {
+      EXPECT_NE(strings[i].data(), views[i].data());
+      EXPECT_EQ(
+          strings[i].size(),
+          HashStringAllocator::headerOf(views[i].data())->size());
+    }
+  }
+  EXPECT_GT(instance_->retainedSize(), 0);
+  EXPECT_EQ(0, instance_->freeSpace());
+  instance_->clear();
+  EXPECT_EQ(0, instance_->retainedSize());
+}
+
 TEST_F(HashStringAllocatorTest, rewrite) {
   ByteStream stream(instance_.get());
   auto header = instance_->allocate(5);
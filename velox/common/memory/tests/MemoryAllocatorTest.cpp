@@ -19,6 +19,7 @@
 #include "velox/common/memory/MallocAllocator.h"
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/common/memory/MmapArena.h"
+#include "velox/common/memory/Numa.h"
 #include "velox/common/testutil/TestValue.h"
 
 #include <thread>
@@ -405,6 +406,114 @@ TEST_P(MemoryAllocatorTest, mmapAllocatorInit) {
   }
 }
 
+TEST_P(MemoryAllocatorTest, threadCache) {
+  if (!useMmap_) {
+    return;
+  }
+  MmapAllocator::Options options;
+  options.capacity = kCapacityBytes;
+  options.threadCachePages = 64;
+  auto allocator = std::make_shared<MmapAllocator>(options);
+  {
+    Allocation allocation;
+    ASSERT_TRUE(allocator->allocateNonContiguous(16, allocation));
+    const auto numPages = allocation.numPages();
+    allocator->freeNonContiguous(allocation);
+    EXPECT_EQ(0, allocator->numAllocated());
+    EXPECT_EQ(numPages, allocator->numThreadCachedPages());
+    EXPECT_TRUE(allocator->checkConsistency());
+
+    // The same size is allocated from the cache.
+    ASSERT_TRUE(allocator->allocateNonContiguous(16, allocation));
+    EXPECT_EQ(0, allocator->numThreadCachedPages());
+    EXPECT_LT(0, allocator->numThreadCacheHits());
+    EXPECT_TRUE(allocator->checkConsistency());
+    allocator->freeNonContiguous(allocation);
+
+    allocator->flushThreadCaches();
+    EXPECT_EQ(0, allocator->numThreadCachedPages());
+    EXPECT_TRUE(allocator->checkConsistency());
+  }
+  {
+    // A contiguous allocation of the whole capacity needs the cached pages to
+    // be advised away.
+    Allocation allocation;
+    ASSERT_TRUE(allocator->allocateNonContiguous(16, allocation));
+    allocator->freeNonContiguous(allocation);
+    EXPECT_LT(0, allocator->numThreadCachedPages());
+    ContiguousAllocation large;
+    ASSERT_TRUE(
+        allocator->allocateContiguous(allocator->capacity(), nullptr, large));
+    EXPECT_EQ(0, allocator->numThreadCachedPages());
+    allocator->freeContiguous(large);
+    EXPECT_TRUE(allocator->checkConsistency());
+  }
+  {
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < 8; ++i) {
+      threads.push_back(std::thread([&, i]() {
+        folly::Random::DefaultGenerator rng(i);
+        std::vector<Allocation> allocations(4);
+        for (auto counter = 0; counter < 10'000; ++counter) {
+          auto& allocation = allocations[folly::Random::rand32(4, rng)];
+          if (!allocation.empty()) {
+            allocator->freeNonContiguous(allocation);
+          } else {
+            ASSERT_TRUE(allocator->allocateNonContiguous(
+                1 + folly::Random::rand32(64, rng), allocation));
+          }
+        }
+        for (auto& allocation : allocations) {
+          allocator->freeNonContiguous(allocation);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    // The caches of the exited threads are returned to the size classes.
+    EXPECT_EQ(0, allocator->numThreadCachedPages());
+    EXPECT_EQ(0, allocator->numAllocated());
+    EXPECT_TRUE(allocator->checkConsistency());
+  }
+}
+
+TEST_P(MemoryAllocatorTest, hugePages) {
+  if (!useMmap_) {
+    return;
+  }
+  for (auto backing :
+       {hugepages::Backing::kTransparent, hugepages::Backing::kHugetlb}) {
+    MmapAllocator::Options options;
+    options.capacity = kCapacityBytes;
+    options.hugePages = backing;
+    auto allocator = std::make_shared<MmapAllocator>(options);
+    // Not a multiple of the huge page size.
+    const MachinePageCount numPages = allocator->largestSizeClass() * 3 + 1;
+    ContiguousAllocation allocation;
+    ASSERT_TRUE(allocator->allocateContiguous(numPages, nullptr, allocation));
+    EXPECT_EQ(
+        reinterpret_cast<uint64_t>(allocation.data()) %
+            hugepages::kHugePageBytes,
+        0);
+    memset(allocation.data(), 1, allocation.size());
+    // Either gets the requested backing or falls back.
+    const auto stats = allocator->hugePageStats();
+    EXPECT_EQ(
+        1,
+        (backing == hugepages::Backing::kHugetlb ? stats.numHugetlb
+                                                 : stats.numTransparent) +
+            stats.numFallbacks);
+    EXPECT_EQ(
+        stats.hugePageBytes,
+        (stats.numHugetlb + stats.numTransparent) *
+            bits::roundUp(allocation.size(), hugepages::kHugePageBytes));
+    allocator->freeContiguous(allocation);
+    EXPECT_EQ(0, allocator->numAllocated());
+    EXPECT_EQ(0, allocator->numMapped());
+  }
+}
+
 TEST_P(MemoryAllocatorTest, allocationPool) {
   const size_t kNumLargeAllocPages = instance_->largestSizeClass() * 2;
   AllocationPool pool(pool_.get());
@@ -1529,6 +1638,61 @@ TEST_F(MmapArenaTest, managedMmapArenas) {
   }
 }
 
+TEST_F(MmapArenaTest, numa) {
+  const auto numNodes = numa::numNodes();
+  ASSERT_GE(numNodes, 1);
+  ASSERT_LT(numa::currentNode(), numNodes);
+
+  // An arena bound to a node is usable whether or not the kernel supports
+  // NUMA policies.
+  auto arena = std::make_unique<MmapArena>(kArenaCapacityBytes, 0);
+  EXPECT_EQ(arena->numaNode(), 0);
+  auto* buffer = allocateAndPad(arena.get(), kArenaCapacityBytes / 2);
+  unpadAndFree(arena.get(), buffer, kArenaCapacityBytes / 2);
+  EXPECT_TRUE(arena->empty());
+
+  // A NUMA aware ManagedMmapArenas has an arena per node and accounts the
+  // allocations to the node of the calling thread.
+  auto managedArenas =
+      std::make_unique<ManagedMmapArenas>(kArenaCapacityBytes, true);
+  EXPECT_EQ(managedArenas->arenas().size(), numNodes);
+  ASSERT_EQ(managedArenas->numaStats().allocatedBytes.size(), numNodes);
+  auto* allocation = managedArenas->allocate(kArenaCapacityBytes / 4);
+  ASSERT_NE(allocation, nullptr);
+  const auto node = numNodes > 1 ? numa::currentNode() : 0;
+  EXPECT_EQ(
+      managedArenas->numaStats().allocatedBytes[node],
+      kArenaCapacityBytes / 4);
+  managedArenas->free(allocation, kArenaCapacityBytes / 4);
+  EXPECT_EQ(managedArenas->numaStats().allocatedBytes[node], 0);
+}
+
+TEST_F(MmapArenaTest, hugePages) {
+  // Huge pages are used if enabled, otherwise the arena falls back to regular
+  // pages.
+  auto arena = std::make_unique<MmapArena>(
+      kArenaCapacityBytes, MmapArena::kNoNode, true);
+  EXPECT_EQ(
+      reinterpret_cast<uint64_t>(arena->address()) %
+          hugepages::kHugePageBytes,
+      0);
+  EXPECT_EQ(
+      arena->backing(),
+      hugepages::transparentHugePagesEnabled()
+          ? hugepages::Backing::kTransparent
+          : hugepages::Backing::kRegular);
+  auto* buffer = allocateAndPad(arena.get(), kArenaCapacityBytes / 2);
+  unpadAndFree(arena.get(), buffer, kArenaCapacityBytes / 2);
+  EXPECT_TRUE(arena->empty());
+
+  auto managedArenas = std::make_unique<ManagedMmapArenas>(
+      kArenaCapacityBytes, false, true);
+  const auto& stats = managedArenas->hugePageStats();
+  EXPECT_EQ(stats.numTransparent + stats.numFallbacks, 1);
+  EXPECT_EQ(
+      stats.hugePageBytes, stats.numTransparent * kArenaCapacityBytes);
+}
+
 TEST_F(MmapArenaTest, managedMmapArenasFree) {
   struct {
     std::vector<uint64_t> allocSizes;
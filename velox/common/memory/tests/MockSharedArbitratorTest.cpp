@@ -61,11 +61,11 @@ struct Allocation {
 
 class MockQuery {
  public:
-  MockQuery(MemoryManager* manager, uint64_t capacity)
+  MockQuery(MemoryManager* manager, uint64_t capacity, int32_t priority = 0)
       : root_(manager->addRootPool(
             fmt::format("RootPool-{}", poolId_++),
             capacity,
-            MemoryReclaimer::create())) {}
+            MemoryReclaimer::create(priority))) {}
 
   ~MockQuery();
 
@@ -362,7 +362,8 @@ class MockSharedArbitrationTest : public testing::Test {
       int64_t memoryCapacity = 0,
       uint64_t initMemoryPoolCapacity = kMaxMemory,
       uint64_t minMemoryPoolCapacityTransferSize = 0,
-      bool retryArbitrationFailure = true) {
+      bool retryArbitrationFailure = true,
+      uint64_t memoryReleaseWaitTimeMs = 0) {
     if (initMemoryPoolCapacity == kMaxMemory) {
       initMemoryPoolCapacity = kInitMemoryPoolCapacity;
     }
@@ -376,15 +377,18 @@ class MockSharedArbitrationTest : public testing::Test {
         .capacity = options.capacity,
         .initMemoryPoolCapacity = initMemoryPoolCapacity,
         .minMemoryPoolCapacityTransferSize = minMemoryPoolCapacityTransferSize,
-        .retryArbitrationFailure = retryArbitrationFailure};
+        .retryArbitrationFailure = retryArbitrationFailure,
+        .memoryReleaseWaitTimeMs = memoryReleaseWaitTimeMs};
     options.checkUsageLeak = true;
     manager_ = std::make_unique<MemoryManager>(options);
     ASSERT_EQ(manager_->arbitrator()->kind(), MemoryArbitrator::Kind::kShared);
     arbitrator_ = static_cast<SharedArbitrator*>(manager_->arbitrator());
   }
 
-  std::shared_ptr<MockQuery> addQuery(int64_t capacity = 0) {
-    return std::make_shared<MockQuery>(manager_.get(), capacity);
+  std::shared_ptr<MockQuery> addQuery(
+      int64_t capacity = 0,
+      int32_t priority = 0) {
+    return std::make_shared<MockQuery>(manager_.get(), capacity, priority);
   }
 
   MockMemoryOperator* addMemoryOp(
@@ -1484,6 +1488,91 @@ TEST_F(MockSharedArbitrationTest, arbitrationFailureRetry) {
   }
 }
 
+TEST_F(MockSharedArbitrationTest, reclaimByPriority) {
+  const uint64_t memCapacity = 256 * MB;
+  setupMemory(memCapacity, 0, 8 * MB);
+  auto lowQuery = addQuery(0, -1);
+  auto* lowOp = addMemoryOp(lowQuery);
+  lowOp->allocate(64 * MB);
+  auto highQuery = addQuery(0, 1);
+  auto* highOp = addMemoryOp(highQuery);
+  highOp->allocate(128 * MB);
+  auto requestorQuery = addQuery();
+  auto* requestorOp = addMemoryOp(requestorQuery);
+  requestorOp->allocate(64 * MB);
+  ASSERT_EQ(arbitrator_->stats().freeCapacityBytes, 0);
+
+  // The low priority query is spilled first although the high priority query
+  // has more reclaimable memory.
+  requestorOp->allocate(16 * MB);
+  verifyReclaimerStats(lowOp->reclaimer()->stats(), 1, 1);
+  verifyReclaimerStats(highOp->reclaimer()->stats(), 0, 1);
+  ASSERT_GE(lowQuery->pool()->reclaimedBytes(), 16 * MB);
+  ASSERT_EQ(highQuery->pool()->reclaimedBytes(), 0);
+  ASSERT_EQ(requestorQuery->pool()->reclaimedBytes(), 0);
+  ASSERT_EQ(arbitrator_->stats().numAborted, 0);
+}
+
+TEST_F(MockSharedArbitrationTest, abortByPriority) {
+  const uint64_t memCapacity = 256 * MB;
+  setupMemory(memCapacity, 0, 8 * MB);
+  auto lowQuery = addQuery(0, -1);
+  auto* lowOp = addMemoryOp(lowQuery, false);
+  lowOp->allocate(32 * MB);
+  auto highQuery = addQuery(0, 1);
+  auto* highOp = addMemoryOp(highQuery, false);
+  highOp->allocate(160 * MB);
+  auto requestorQuery = addQuery();
+  auto* requestorOp = addMemoryOp(requestorQuery, false);
+  requestorOp->allocate(64 * MB);
+
+  // Aborts the query with the lowest priority instead of the one with the
+  // largest capacity.
+  requestorOp->allocate(32 * MB);
+  ASSERT_TRUE(lowOp->pool()->aborted());
+  ASSERT_FALSE(highOp->pool()->aborted());
+  ASSERT_FALSE(requestorOp->pool()->aborted());
+  ASSERT_EQ(arbitrator_->stats().numAborted, 1);
+  ASSERT_EQ(arbitrator_->stats().numFailures, 0);
+}
+
+TEST_F(MockSharedArbitrationTest, waitForMemoryRelease) {
+  const uint64_t memCapacity = 256 * MB;
+  const uint64_t waitTimeMs = 100;
+  for (const bool release : {false, true}) {
+    SCOPED_TRACE(fmt::format("release {}", release));
+    setupMemory(memCapacity, 0, 8 * MB, false, release ? 10'000 : waitTimeMs);
+    auto otherQuery = addQuery();
+    auto* otherOp = addMemoryOp(otherQuery, false);
+    otherOp->allocate(192 * MB);
+    auto requestorQuery = addQuery();
+    auto* requestorOp = addMemoryOp(requestorQuery, false);
+    requestorOp->allocate(64 * MB);
+    const auto prevWaitTimeUs = requestorQuery->pool()->arbitrationWaitTimeUs();
+
+    std::thread releaseThread([&]() {
+      if (release) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(waitTimeMs));
+        otherOp->freeAll();
+      }
+    });
+    if (release) {
+      requestorOp->allocate(32 * MB);
+    } else {
+      VELOX_ASSERT_THROW(requestorOp->allocate(32 * MB), "");
+    }
+    releaseThread.join();
+    ASSERT_FALSE(otherOp->pool()->aborted());
+    ASSERT_FALSE(requestorOp->pool()->aborted());
+    ASSERT_EQ(arbitrator_->stats().numFailures, release ? 0 : 1);
+    // The release thread starts the wait clock slightly earlier than the
+    // arbitration.
+    ASSERT_GE(
+        requestorQuery->pool()->arbitrationWaitTimeUs() - prevWaitTimeUs,
+        waitTimeMs * 1'000 / 2);
+  }
+}
+
 TEST_F(MockSharedArbitrationTest, concurrentArbitrations) {
   const int numQueries = 10;
   const int numOpsPerQuery = 5;
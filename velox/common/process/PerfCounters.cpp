@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/process/PerfCounters.h"
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <glog/logging.h>
+
+namespace facebook::velox::process {
+
+namespace {
+
+#ifdef __linux__
+constexpr std::array<uint64_t, 4> kEvents{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+// Set after the first thread fails to open its counters.
+std::atomic<bool> disabled{false};
+
+// Layout of a read of the group with PERF_FORMAT_GROUP and the enabled and
+// running times.
+struct GroupReadFormat {
+  uint64_t numEvents;
+  uint64_t timeEnabled;
+  uint64_t timeRunning;
+  uint64_t values[kEvents.size()];
+};
+
+int openEvent(uint64_t config, int groupFd) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+      PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // Counts the calling thread on any CPU.
+  return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+// The counters of a thread. The first event is the group leader.
+class ThreadCounters {
+ public:
+  ThreadCounters() {
+    fds_.fill(-1);
+    if (disabled) {
+      return;
+    }
+    for (auto i = 0; i < kEvents.size(); ++i) {
+      fds_[i] = openEvent(kEvents[i], i == 0 ? -1 : fds_[0]);
+      if (fds_[i] < 0) {
+        if (!disabled.exchange(true)) {
+          LOG(WARNING) << "Hardware counters are not available: "
+                       << std::strerror(errno);
+        }
+        closeAll();
+        return;
+      }
+    }
+  }
+
+  ~ThreadCounters() {
+    closeAll();
+  }
+
+  bool read(PerfCounterValues& values) const {
+    if (fds_[0] < 0) {
+      return false;
+    }
+    GroupReadFormat data;
+    if (::read(fds_[0], &data, sizeof(data)) != sizeof(data) ||
+        data.timeRunning == 0) {
+      return false;
+    }
+    // Scales the counts up if the PMU was shared with other groups.
+    const double scale = data.timeRunning < data.timeEnabled
+        ? static_cast<double>(data.timeEnabled) / data.timeRunning
+        : 1.0;
+    auto scaled = [&](int32_t i) {
+      return static_cast<uint64_t>(data.values[i] * scale);
+    };
+    values.cycles = scaled(0);
+    values.instructions = scaled(1);
+    values.cacheMisses = scaled(2);
+    values.branchMisses = scaled(3);
+    return true;
+  }
+
+ private:
+  void closeAll() {
+    for (auto& fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+  }
+
+  std::array<int, kEvents.size()> fds_;
+};
+
+ThreadCounters& threadCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+#endif
+
+} // namespace
+
+// static
+bool PerfCounters::read(PerfCounterValues& values) {
+#ifdef __linux__
+  return threadCounters().read(values);
+#else
+  return false;
+#endif
+}
+
+// static
+bool PerfCounters::isAvailable() {
+  PerfCounterValues values;
+  return read(values);
+}
+
+} // namespace facebook::velox::process
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace facebook::velox::process {
+
+// Hardware event counts of a thread, see PerfCounters.
+struct PerfCounterValues {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  // Last level cache misses.
+  uint64_t cacheMisses{0};
+  uint64_t branchMisses{0};
+
+  PerfCounterValues operator-(const PerfCounterValues& other) const {
+    return {
+        cycles - other.cycles,
+        instructions - other.instructions,
+        cacheMisses - other.cacheMisses,
+        branchMisses - other.branchMisses};
+  }
+};
+
+// Reads hardware event counters of the calling thread through
+// perf_event_open(2). The counters of a thread are opened as one group on
+// first use and read together with a single read(2). Only user space events
+// are counted, which kernel.perf_event_paranoid allows up to 2. Where the
+// counters cannot be opened, e.g. in a container without access to the PMU,
+// they are disabled for the process after the first failure.
+class PerfCounters {
+ public:
+  // Sets 'values' to the counts of the calling thread since the counters of
+  // the thread were opened. Returns false if the counters are not available.
+  static bool read(PerfCounterValues& values);
+
+  // Returns true if the counters can be opened in this process. Opens the
+  // counters of the calling thread.
+  static bool isAvailable();
+};
+
+} // namespace facebook::velox::process
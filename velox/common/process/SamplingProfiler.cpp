@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/process/SamplingProfiler.h"
+
+#include <signal.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/format.h>
+#include <folly/experimental/symbolizer/StackTrace.h>
+#include <glog/logging.h>
+
+#include "velox/common/process/StackTrace.h"
+
+namespace facebook::velox::process {
+
+namespace {
+
+constexpr int32_t kMaxFrames = 48;
+constexpr int32_t kNumSlots = 4'096;
+// Frames of the signal handler and the signal trampoline.
+constexpr int32_t kNumSkippedFrames = 2;
+constexpr auto kDrainInterval = std::chrono::milliseconds(50);
+
+enum SlotState : int32_t { kEmpty, kWriting, kFull };
+
+// A sample written by the signal handler and drained by the collector thread.
+struct Slot {
+  std::atomic<int32_t> state{kEmpty};
+  int32_t tag;
+  int32_t numFrames;
+  uintptr_t frames[kMaxFrames];
+};
+
+struct TagInfo {
+  std::string queryId;
+  std::string label;
+};
+
+// Aggregated stacks of one tag.
+using StackCounts = std::map<std::vector<uintptr_t>, uint64_t>;
+
+struct State {
+  std::array<Slot, kNumSlots> slots;
+  std::atomic<uint64_t> nextSlot{0};
+  std::atomic<uint64_t> numUntagged{0};
+  std::atomic<uint64_t> numDropped{0};
+  std::atomic<bool> running{false};
+
+  // Serializes start() and stop().
+  std::mutex runMutex;
+  std::thread collector;
+  std::condition_variable collectorWakeup;
+  bool stopCollector{false};
+
+  std::mutex mutex;
+  std::vector<TagInfo> tags;
+  // Index into 'tags' for a query id and label. Tags are not reused, so that
+  // samples of a taken query that are drained later are dropped rather than
+  // attributed to another query.
+  std::map<std::pair<std::string, std::string>, int32_t> tagIds;
+  std::unordered_map<int32_t, StackCounts> counts;
+};
+
+State& state() {
+  static auto* state = new State();
+  return *state;
+}
+
+thread_local int32_t threadTag{SamplingProfiler::kNoTag};
+
+void handleSignal(int /*signal*/, siginfo_t* /*info*/, void* /*context*/) {
+  const auto savedErrno = errno;
+  auto& profiler = state();
+  const auto tag = threadTag;
+  if (tag == SamplingProfiler::kNoTag) {
+    profiler.numUntagged.fetch_add(1, std::memory_order_relaxed);
+    errno = savedErrno;
+    return;
+  }
+  auto& slot = profiler.slots
+                   [profiler.nextSlot.fetch_add(1, std::memory_order_relaxed) %
+                    kNumSlots];
+  int32_t expected = kEmpty;
+  if (!slot.state.compare_exchange_strong(
+          expected, kWriting, std::memory_order_acquire)) {
+    profiler.numDropped.fetch_add(1, std::memory_order_relaxed);
+    errno = savedErrno;
+    return;
+  }
+  const auto numFrames =
+      folly::symbolizer::getStackTraceSafe(slot.frames, kMaxFrames);
+  slot.tag = tag;
+  slot.numFrames = numFrames < 0 ? 0 : numFrames;
+  slot.state.store(kFull, std::memory_order_release);
+  errno = savedErrno;
+}
+
+// Moves the full slots into 'counts'. Requires 'mutex'.
+void drainLocked(State& profiler) {
+  for (auto& slot : profiler.slots) {
+    if (slot.state.load(std::memory_order_acquire) != kFull) {
+      continue;
+    }
+    // Skips the frames of the signal handler. The root is last.
+    const auto begin =
+        slot.frames + std::min(slot.numFrames, kNumSkippedFrames);
+    std::vector<uintptr_t> stack(begin, slot.frames + slot.numFrames);
+    const auto tag = slot.tag;
+    slot.state.store(kEmpty, std::memory_order_release);
+    if (tag < static_cast<int32_t>(profiler.tags.size()) &&
+        !profiler.tags[tag].queryId.empty()) {
+      ++profiler.counts[tag][std::move(stack)];
+    }
+  }
+}
+
+void runCollector(State& profiler) {
+  std::unique_lock<std::mutex> l(profiler.mutex);
+  while (!profiler.stopCollector) {
+    profiler.collectorWakeup.wait_for(l, kDrainInterval);
+    drainLocked(profiler);
+  }
+}
+
+} // namespace
+
+// static
+void SamplingProfiler::start(int32_t intervalMicros) {
+  CHECK_GT(intervalMicros, 0);
+  auto& profiler = state();
+  std::lock_guard<std::mutex> l(profiler.runMutex);
+  CHECK(!profiler.running) << "SamplingProfiler is already running";
+
+  // The first stack trace may initialize the unwinder, which is not safe in
+  // a signal handler.
+  uintptr_t frames[kMaxFrames];
+  folly::symbolizer::getStackTraceSafe(frames, kMaxFrames);
+
+  profiler.stopCollector = false;
+  profiler.collector = std::thread([&profiler]() { runCollector(profiler); });
+
+  struct sigaction action {};
+  action.sa_sigaction = handleSignal;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  CHECK_EQ(sigaction(SIGPROF, &action, nullptr), 0);
+
+  itimerval timer{};
+  timer.it_interval.tv_sec = intervalMicros / 1'000'000;
+  timer.it_interval.tv_usec = intervalMicros % 1'000'000;
+  timer.it_value = timer.it_interval;
+  CHECK_EQ(setitimer(ITIMER_PROF, &timer, nullptr), 0);
+  profiler.running = true;
+}
+
+// static
+void SamplingProfiler::stop() {
+  auto& profiler = state();
+  std::lock_guard<std::mutex> l(profiler.runMutex);
+  if (!profiler.running) {
+    return;
+  }
+  itimerval timer{};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  // A signal may still be pending. Ignores it rather than terminating.
+  signal(SIGPROF, SIG_IGN);
+  profiler.running = false;
+  {
+    std::lock_guard<std::mutex> collectorLock(profiler.mutex);
+    profiler.stopCollector = true;
+  }
+  profiler.collectorWakeup.notify_one();
+  profiler.collector.join();
+}
+
+// static
+bool SamplingProfiler::isRunning() {
+  return state().running;
+}
+
+// static
+int32_t SamplingProfiler::registerTag(
+    const std::string& queryId,
+    const std::string& label) {
+  auto& profiler = state();
+  if (!profiler.running || queryId.empty()) {
+    return kNoTag;
+  }
+  std::lock_guard<std::mutex> l(profiler.mutex);
+  auto key = std::make_pair(queryId, label);
+  auto it = profiler.tagIds.find(key);
+  if (it != profiler.tagIds.end()) {
+    return it->second;
+  }
+  const int32_t tag = profiler.tags.size();
+  profiler.tags.push_back(TagInfo{queryId, label});
+  profiler.tagIds.emplace(std::move(key), tag);
+  return tag;
+}
+
+// static
+std::string SamplingProfiler::takeFlameData(const std::string& queryId) {
+  auto& profiler = state();
+  std::vector<std::pair<std::string, StackCounts>> queryCounts;
+  {
+    std::lock_guard<std::mutex> l(profiler.mutex);
+    drainLocked(profiler);
+    auto it =
+        profiler.tagIds.lower_bound(std::make_pair(queryId, std::string()));
+    while (it != profiler.tagIds.end() && it->first.first == queryId) {
+      const auto tag = it->second;
+      queryCounts.emplace_back(
+          profiler.tags[tag].label, std::move(profiler.counts[tag]));
+      profiler.counts.erase(tag);
+      profiler.tags[tag] = TagInfo{};
+      it = profiler.tagIds.erase(it);
+    }
+  }
+
+  // Symbolizes outside of the lock.
+  std::unordered_map<uintptr_t, std::string> names;
+  std::string result;
+  for (const auto& [label, counts] : queryCounts) {
+    for (const auto& [stack, count] : counts) {
+      result += label;
+      for (auto frame = stack.rbegin(); frame != stack.rend(); ++frame) {
+        auto& name = names[*frame];
+        if (name.empty()) {
+          name = StackTrace::translateFrame(reinterpret_cast<void*>(*frame));
+          // ';' separates the frames of a folded stack.
+          std::replace(name.begin(), name.end(), ';', ':');
+        }
+        result += ';';
+        result += name;
+      }
+      result += fmt::format(" {}\n", count);
+    }
+  }
+  return result;
+}
+
+// static
+uint64_t SamplingProfiler::numUntaggedSamples() {
+  return state().numUntagged;
+}
+
+// static
+uint64_t SamplingProfiler::numDroppedSamples() {
+  return state().numDropped;
+}
+
+SampleTagScope::SampleTagScope(int32_t tag) : prevTag_(threadTag) {
+  threadTag = tag;
+}
+
+SampleTagScope::~SampleTagScope() {
+  threadTag = prevTag_;
+}
+
+} // namespace facebook::velox::process
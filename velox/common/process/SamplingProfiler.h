@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace facebook::velox::process {
+
+// In process sampling CPU profiler. While running, SIGPROF interrupts the
+// threads of the process at an interval of their CPU time and records the
+// stack of the interrupted thread together with the tag the thread has set
+// with SampleTagScope. The Driver tags the calls to each Operator with the
+// query id and the operator, so the samples of a query can be exported per
+// operator as flame graph input.
+class SamplingProfiler {
+ public:
+  // Starts sampling every 'intervalMicros' of CPU time. Only one profiler
+  // runs per process. Replaces any other handler of SIGPROF.
+  static void start(int32_t intervalMicros = 10'000);
+
+  // Stops sampling. Aggregated samples are kept until taken.
+  static void stop();
+
+  static bool isRunning();
+
+  // Returns the tag for samples of 'label', e.g. an operator, in the query
+  // 'queryId'. Returns kNoTag if the profiler is not running, so that tags
+  // are only registered while profiling, or if 'queryId' is empty.
+  static int32_t registerTag(
+      const std::string& queryId,
+      const std::string& label);
+
+  // Returns the samples of 'queryId' in the folded stack format of
+  // flamegraph.pl, one line per distinct stack with the label of the tag as
+  // the root frame, followed by a space and the number of samples. Removes
+  // the samples and tags of 'queryId'.
+  static std::string takeFlameData(const std::string& queryId);
+
+  // Number of samples taken outside of a tag or lost because the buffer of
+  // unaggregated samples was full.
+  static uint64_t numUntaggedSamples();
+  static uint64_t numDroppedSamples();
+
+  static constexpr int32_t kNoTag = -1;
+};
+
+// Sets the tag of the samples of the calling thread for the lifetime of
+// 'this' and restores the previous tag after.
+class SampleTagScope {
+ public:
+  explicit SampleTagScope(int32_t tag);
+
+  ~SampleTagScope();
+
+ private:
+  const int32_t prevTag_;
+};
+
+} // namespace facebook::velox::process
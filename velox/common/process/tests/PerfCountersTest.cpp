@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/process/PerfCounters.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace facebook::velox::process;
+
+namespace {
+
+uint64_t work(int32_t numIterations) {
+  uint64_t value = 1;
+  for (auto i = 0; i < numIterations; ++i) {
+    value = value * 31 + (value >> 7) + i;
+  }
+  return value;
+}
+
+} // namespace
+
+TEST(PerfCountersTest, read) {
+  if (!PerfCounters::isAvailable()) {
+    GTEST_SKIP() << "Hardware counters are not available";
+  }
+  PerfCounterValues start;
+  ASSERT_TRUE(PerfCounters::read(start));
+  volatile uint64_t result = work(1'000'000);
+  (void)result;
+  PerfCounterValues end;
+  ASSERT_TRUE(PerfCounters::read(end));
+  const auto delta = end - start;
+  // The loop runs at least a few instructions per iteration.
+  EXPECT_GT(delta.instructions, 1'000'000);
+  EXPECT_GT(delta.cycles, 0);
+
+  // The counters are per thread.
+  std::thread thread([&]() {
+    PerfCounterValues values;
+    ASSERT_TRUE(PerfCounters::read(values));
+    EXPECT_LT(values.instructions, end.instructions);
+  });
+  thread.join();
+}
+
+TEST(PerfCountersTest, unavailable) {
+  if (PerfCounters::isAvailable()) {
+    GTEST_SKIP() << "Hardware counters are available";
+  }
+  PerfCounterValues values;
+  EXPECT_FALSE(PerfCounters::read(values));
+  EXPECT_EQ(values.instructions, 0);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/process/SamplingProfiler.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace facebook::velox::process;
+
+namespace {
+
+// Spins for 'millis' of wall time and returns a value that depends on the
+// work so that it is not optimized away.
+uint64_t spin(int32_t millis) {
+  const auto end =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(millis);
+  uint64_t value = 1;
+  while (std::chrono::steady_clock::now() < end) {
+    for (auto i = 0; i < 1'000; ++i) {
+      value = value * 31 + i;
+    }
+  }
+  return value;
+}
+
+} // namespace
+
+TEST(SamplingProfilerTest, tags) {
+  EXPECT_EQ(
+      SamplingProfiler::registerTag("q1", "op"), SamplingProfiler::kNoTag);
+
+  SamplingProfiler::start(1'000);
+  ASSERT_TRUE(SamplingProfiler::isRunning());
+  const auto tag = SamplingProfiler::registerTag("q1", "0:TableScan");
+  EXPECT_NE(tag, SamplingProfiler::kNoTag);
+  EXPECT_EQ(SamplingProfiler::registerTag("q1", "0:TableScan"), tag);
+  const auto otherTag = SamplingProfiler::registerTag("q2", "1:FilterProject");
+  EXPECT_NE(otherTag, tag);
+  EXPECT_EQ(SamplingProfiler::registerTag("", "op"), SamplingProfiler::kNoTag);
+
+  uint64_t value = 0;
+  {
+    SampleTagScope scope(tag);
+    value += spin(300);
+    {
+      SampleTagScope nested(otherTag);
+      value += spin(100);
+    }
+    value += spin(100);
+  }
+  const auto numUntagged = SamplingProfiler::numUntaggedSamples();
+  value += spin(100);
+  EXPECT_GT(SamplingProfiler::numUntaggedSamples(), numUntagged);
+  SamplingProfiler::stop();
+  EXPECT_FALSE(SamplingProfiler::isRunning());
+  EXPECT_NE(value, 0);
+
+  // Each line is a folded stack rooted at the label and a count.
+  const auto flameData = SamplingProfiler::takeFlameData("q1");
+  ASSERT_FALSE(flameData.empty());
+  EXPECT_EQ(flameData.find("1:FilterProject"), std::string::npos);
+  size_t begin = 0;
+  while (begin < flameData.size()) {
+    const auto end = flameData.find('\n', begin);
+    ASSERT_NE(end, std::string::npos);
+    const auto line = flameData.substr(begin, end - begin);
+    EXPECT_EQ(line.rfind("0:TableScan", 0), 0) << line;
+    EXPECT_GT(std::stoi(line.substr(line.rfind(' ') + 1)), 0) << line;
+    begin = end + 1;
+  }
+  EXPECT_TRUE(SamplingProfiler::takeFlameData("q1").empty());
+  EXPECT_FALSE(SamplingProfiler::takeFlameData("q2").empty());
+}
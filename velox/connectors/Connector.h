@@ -17,6 +17,7 @@
 
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/caching/CacheTag.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/core/ExpressionEvaluator.h"
@@ -32,6 +33,10 @@ namespace facebook::velox {
 class Config;
 }
 
+namespace facebook::velox::exec {
+struct SpillConfig;
+}
+
 namespace facebook::velox::connector {
 
 class DataSource;
@@ -43,6 +48,10 @@ struct ConnectorSplit {
 
   std::unique_ptr<AsyncSource<DataSource>> dataSource;
 
+  // True once the split has been passed to Connector::prefetchSplits(). Set
+  // by the Task while holding its lock.
+  bool filesPrefetched{false};
+
   explicit ConnectorSplit(const std::string& _connectorId)
       : connectorId(_connectorId) {}
 
@@ -51,6 +60,15 @@ struct ConnectorSplit {
   virtual std::string toString() const {
     return fmt::format("[split: {}]", connectorId);
   }
+
+  // Returns a string that identifies the data read by 'this', including its
+  // version, e.g. the modification time of a file. Splits with the same key
+  // produce the same data. Returns std::nullopt if the data can change
+  // without changing the split. The results of a plan fragment are cached only
+  // if all its splits have a key. See exec::FragmentResultCache.
+  virtual std::optional<std::string> cacheKey() const {
+    return std::nullopt;
+  }
 };
 
 class ColumnHandle : public ISerializable {
@@ -135,6 +153,20 @@ class DataSink {
   virtual std::vector<std::string> finish() const = 0;
 
   virtual void close() = 0;
+
+  /// Returns an estimate of the memory in bytes that reclaim() can release by
+  /// writing out buffered data.
+  virtual uint64_t reclaimableBytes() const {
+    return 0;
+  }
+
+  /// Writes out buffered data to release at least 'targetBytes' of memory, or
+  /// all reclaimable memory if 'targetBytes' is zero. Invoked by the memory
+  /// arbitrator through the table writer operator. Returns an estimate of the
+  /// released bytes.
+  virtual uint64_t reclaim(uint64_t /*targetBytes*/) {
+    return 0;
+  }
 };
 
 class DataSource {
@@ -189,6 +221,17 @@ class DataSource {
     VELOX_UNSUPPORTED("setFromDataSource");
   }
 
+  // Allows addSplit() to divide a split into up to 'maxSubSplits' parts so
+  // that idle drivers can read the parts of a large split in parallel. 0 or 1
+  // disables this.
+  virtual void setMaxSubSplits(int32_t /*maxSubSplits*/) {}
+
+  // Returns the splits that the last addSplit() divided off the added split.
+  // 'this' reads only the first part. The caller queues the returned splits.
+  virtual std::vector<std::shared_ptr<ConnectorSplit>> takeSubSplits() {
+    return {};
+  }
+
   // Returns a connector dependent row size if available. This can be
   // called after addSplit().  This estimates uncompressed data
   // sizes. This is better than getCompletedBytes()/getCompletedRows()
@@ -214,7 +257,10 @@ class ConnectorQueryCtx {
       memory::MemoryAllocator* FOLLY_NONNULL allocator,
       const std::string& taskId,
       const std::string& planNodeId,
-      int driverId)
+      int driverId,
+      const std::string& cacheTenant = "",
+      cache::CachePriority cachePriority = cache::CachePriority::kNormal,
+      const exec::SpillConfig* spillConfig = nullptr)
       : operatorPool_(operatorPool),
         connectorPool_(connectorPool),
         config_(connectorConfig),
@@ -222,7 +268,10 @@ class ConnectorQueryCtx {
         allocator_(allocator),
         scanId_(fmt::format("{}.{}", taskId, planNodeId)),
         taskId_(taskId),
-        driverId_(driverId) {}
+        driverId_(driverId),
+        cacheTenant_(cacheTenant),
+        cachePriority_(cachePriority),
+        spillConfig_(spillConfig) {}
 
   /// Returns the associated operator's memory pool which is a leaf kind of
   /// memory pool, used for direct memory allocation use.
@@ -267,6 +316,22 @@ class ConnectorQueryCtx {
     return driverId_;
   }
 
+  /// Tenant and priority of the cache entries that the DataSource creates. See
+  /// AsyncDataCache::makeTag().
+  const std::string& cacheTenant() const {
+    return cacheTenant_;
+  }
+
+  cache::CachePriority cachePriority() const {
+    return cachePriority_;
+  }
+
+  /// Returns the spill config for the data sink of a table write or nullptr
+  /// if spilling is disabled. Used by data sinks that buffer sorted data.
+  const exec::SpillConfig* spillConfig() const {
+    return spillConfig_;
+  }
+
  private:
   memory::MemoryPool* operatorPool_;
   memory::MemoryPool* connectorPool_;
@@ -276,6 +341,9 @@ class ConnectorQueryCtx {
   const std::string scanId_;
   const std::string taskId_;
   const int driverId_;
+  const std::string cacheTenant_;
+  const cache::CachePriority cachePriority_;
+  const exec::SpillConfig* const spillConfig_;
 };
 
 class Connector {
@@ -317,6 +385,31 @@ class Connector {
     return false;
   }
 
+  // Returns the max number of splits per Driver that TableScan preloads if
+  // this is configured for the connector. If not set, TableScan uses the
+  // --split_preload_per_driver flag.
+  virtual std::optional<int32_t> maxSplitPreloadPerDriver() const {
+    return std::nullopt;
+  }
+
+  // Returns true if prefetchSplits() opens files ahead of addSplit().
+  virtual bool supportsSplitPrefetch() const {
+    return false;
+  }
+
+  // Starts opening the files of 'splits' and reading their metadata, e.g.
+  // footers, in parallel in the background. This is lighter than a preload
+  // and is used by TableScan for the splits queued behind the preloaded
+  // ones, so that the DataSources that later get these splits find the
+  // files open. Errors are ignored and surface when the split is read. The
+  // returned future is realized when all of 'splits' are done. The caller
+  // keeps 'connectorQueryCtx' live until then.
+  virtual folly::SemiFuture<folly::Unit> prefetchSplits(
+      const std::vector<std::shared_ptr<ConnectorSplit>>& /*splits*/,
+      ConnectorQueryCtx* FOLLY_NONNULL /*connectorQueryCtx*/) {
+    return folly::makeSemiFuture();
+  }
+
   virtual std::unique_ptr<DataSink> createDataSink(
       RowTypePtr inputType,
       std::shared_ptr<ConnectorInsertTableHandle> connectorInsertTableHandle,
@@ -73,7 +73,7 @@ class FileHandleGenerator {
   const std::shared_ptr<const Config> properties_;
 };
 
-using FileHandleFactory = CachedFactory<
+using FileHandleFactory = ShardedCachedFactory<
     std::string,
     std::shared_ptr<FileHandle>,
     FileHandleGenerator>;
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/connectors/hive/HiveColumnStatistics.h"
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "velox/common/hyperloglog/HllUtils.h"
+#include "velox/dwio/dwrf/common/Config.h"
+
+namespace facebook::velox::connector::hive {
+namespace {
+
+// Hashes the values the same way as approx_distinct.
+template <typename T>
+uint64_t hashValue(const T& value) {
+  return XXH64(&value, sizeof(T), 0);
+}
+
+template <>
+uint64_t hashValue(const StringView& value) {
+  return XXH64(value.data(), value.size(), 0);
+}
+
+bool hasHll(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+    case TypeKind::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Sets 'min' and 'max' of 'stats' from 'builder' when known.
+void addBounds(const dwrf::StatisticsBuilder& builder, folly::dynamic& stats) {
+  if (auto* integers =
+          dynamic_cast<const dwio::common::IntegerColumnStatistics*>(
+              &builder)) {
+    if (integers->getMinimum().has_value()) {
+      stats["min"] = integers->getMinimum().value();
+      stats["max"] = integers->getMaximum().value();
+    }
+  } else if (
+      auto* doubles =
+          dynamic_cast<const dwio::common::DoubleColumnStatistics*>(
+              &builder)) {
+    // The bounds are dropped if there is a NaN.
+    if (doubles->getMinimum().has_value()) {
+      stats["min"] = doubles->getMinimum().value();
+      stats["max"] = doubles->getMaximum().value();
+    }
+  } else if (
+      auto* strings =
+          dynamic_cast<const dwio::common::StringColumnStatistics*>(
+              &builder)) {
+    // The bounds are dropped for strings longer than the limit.
+    if (strings->getMinimum().has_value() &&
+        strings->getMaximum().has_value()) {
+      stats["min"] = strings->getMinimum().value();
+      stats["max"] = strings->getMaximum().value();
+    }
+  }
+}
+
+} // namespace
+
+HiveColumnStatistics::HiveColumnStatistics(
+    const RowTypePtr& type,
+    const std::vector<column_index_t>& channels,
+    memory::MemoryPool* pool)
+    : allocator_(pool) {
+  const auto options =
+      dwrf::StatisticsBuilderOptions::fromConfig(dwrf::Config{});
+  columns_.reserve(channels.size());
+  for (const auto channel : channels) {
+    Column column;
+    column.channel = channel;
+    column.name = type->nameOf(channel);
+    column.type = type->childAt(channel);
+    column.builder = dwrf::StatisticsBuilder::create(*column.type, options);
+    if (hasHll(column.type->kind())) {
+      column.hll = std::make_unique<common::hll::DenseHll>(
+          common::hll::toIndexBitLength(common::hll::kDefaultStandardError),
+          &allocator_);
+    }
+    columns_.push_back(std::move(column));
+  }
+}
+
+template <typename T>
+void HiveColumnStatistics::addValues(Column& column, vector_size_t numRows) {
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (decoded_.isNullAt(row)) {
+      ++column.nullCount;
+      continue;
+    }
+    const auto value = decoded_.valueAt<T>(row);
+    column.hll->insertHash(hashValue(value));
+    if constexpr (std::is_same_v<T, bool>) {
+      static_cast<dwrf::BooleanStatisticsBuilder&>(*column.builder)
+          .addValues(value);
+    } else if constexpr (std::is_integral_v<T>) {
+      static_cast<dwrf::IntegerStatisticsBuilder&>(*column.builder)
+          .addValues(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      static_cast<dwrf::DoubleStatisticsBuilder&>(*column.builder)
+          .addValues(value);
+    } else if constexpr (std::is_same_v<T, StringView>) {
+      if (column.type->kind() == TypeKind::VARCHAR) {
+        static_cast<dwrf::StringStatisticsBuilder&>(*column.builder)
+            .addValues(folly::StringPiece(value.data(), value.size()));
+      } else {
+        static_cast<dwrf::BinaryStatisticsBuilder&>(*column.builder)
+            .addValues(value.size());
+      }
+    } else {
+      column.builder->increaseValueCount();
+    }
+  }
+}
+
+void HiveColumnStatistics::add(const RowVector& input) {
+  const auto numRows = input.size();
+  if (numRows == 0) {
+    return;
+  }
+  SelectivityVector rows(numRows);
+  for (auto& column : columns_) {
+    const auto vector =
+        BaseVector::loadedVectorShared(input.childAt(column.channel));
+    switch (column.type->kind()) {
+      case TypeKind::BOOLEAN:
+        decoded_.decode(*vector, rows);
+        addValues<bool>(column, numRows);
+        break;
+      case TypeKind::TINYINT:
+        decoded_.decode(*vector, rows);
+        addValues<int8_t>(column, numRows);
+        break;
+      case TypeKind::SMALLINT:
+        decoded_.decode(*vector, rows);
+        addValues<int16_t>(column, numRows);
+        break;
+      case TypeKind::INTEGER:
+        decoded_.decode(*vector, rows);
+        addValues<int32_t>(column, numRows);
+        break;
+      case TypeKind::BIGINT:
+        decoded_.decode(*vector, rows);
+        addValues<int64_t>(column, numRows);
+        break;
+      case TypeKind::REAL:
+        decoded_.decode(*vector, rows);
+        addValues<float>(column, numRows);
+        break;
+      case TypeKind::DOUBLE:
+        decoded_.decode(*vector, rows);
+        addValues<double>(column, numRows);
+        break;
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        decoded_.decode(*vector, rows);
+        addValues<StringView>(column, numRows);
+        break;
+      case TypeKind::DATE:
+        decoded_.decode(*vector, rows);
+        addValues<Date>(column, numRows);
+        break;
+      default:
+        // Only the nulls are counted for the other types.
+        for (vector_size_t row = 0; row < numRows; ++row) {
+          if (vector->isNullAt(row)) {
+            ++column.nullCount;
+          }
+        }
+        break;
+    }
+  }
+}
+
+folly::dynamic HiveColumnStatistics::toJson() const {
+  auto columns = folly::dynamic::array();
+  for (const auto& column : columns_) {
+    folly::dynamic stats = folly::dynamic::object;
+    stats["name"] = column.name;
+    stats["nullCount"] = column.nullCount;
+    // The bounds are only defined if there are non-null values.
+    if (column.builder->getNumberOfValues().value_or(0) > 0) {
+      addBounds(*column.builder, stats);
+    }
+    if (column.hll != nullptr) {
+      stats["distinctCount"] = column.hll->cardinality();
+    }
+    columns.push_back(std::move(stats));
+  }
+  return columns;
+}
+
+} // namespace facebook::velox::connector::hive
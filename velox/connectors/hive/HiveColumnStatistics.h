@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <folly/dynamic.h>
+
+#include "velox/common/hyperloglog/DenseHll.h"
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/dwio/dwrf/writer/StatisticsBuilder.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Collects the statistics of the columns written for a partition: the number
+/// of nulls, the minimum and maximum and an estimate of the number of distinct
+/// values. Minimum and maximum come from the statistics builders of the DWRF
+/// writer and are known for integer, floating point and string columns. The
+/// number of distinct values is estimated with a HyperLogLog of the same
+/// accuracy as approx_distinct.
+class HiveColumnStatistics {
+ public:
+  /// Collects the statistics of the columns of 'type' at 'channels'. The
+  /// HyperLogLogs are allocated from 'pool'.
+  HiveColumnStatistics(
+      const RowTypePtr& type,
+      const std::vector<column_index_t>& channels,
+      memory::MemoryPool* pool);
+
+  void add(const RowVector& input);
+
+  /// Returns an array with an object per column with the keys 'name' and
+  /// 'nullCount' and, when known, 'min', 'max' and 'distinctCount'.
+  folly::dynamic toJson() const;
+
+ private:
+  struct Column {
+    column_index_t channel;
+    std::string name;
+    TypePtr type;
+    std::unique_ptr<dwrf::StatisticsBuilder> builder;
+    std::unique_ptr<common::hll::DenseHll> hll;
+    uint64_t nullCount{0};
+  };
+
+  template <typename T>
+  void addValues(Column& column, vector_size_t numRows);
+
+  // Declared before 'columns_' so that the HyperLogLogs are freed first.
+  HashStringAllocator allocator_;
+  std::vector<Column> columns_;
+  DecodedVector decoded_;
+};
+
+} // namespace facebook::velox::connector::hive
@@ -66,11 +66,33 @@ uint32_t HiveConfig::maxPartitionsPerWriters(const Config* config) {
   return config->get<uint32_t>(kMaxPartitionsPerWriters, 100);
 }
 
+// static
+uint32_t HiveConfig::maxOpenWriters(const Config* config) {
+  return config->get<uint32_t>(kMaxOpenWriters, 0);
+}
+
 // static
 bool HiveConfig::immutablePartitions(const Config* config) {
   return config->get<bool>(kImmutablePartitions, false);
 }
 
+// static
+bool HiveConfig::collectColumnStatistics(const Config* config) {
+  return config->get<bool>(kCollectColumnStatistics, false);
+}
+
+// static
+std::optional<int32_t> HiveConfig::maxSplitPreloadPerDriver(
+    const Config* config) {
+  const auto value = config->get<int32_t>(kMaxSplitPreloadPerDriver);
+  if (!value.has_value()) {
+    return std::nullopt;
+  }
+  VELOX_USER_CHECK_GE(
+      value.value(), 0, "{} must not be negative", kMaxSplitPreloadPerDriver);
+  return value.value();
+}
+
 // static
 bool HiveConfig::s3UseVirtualAddressing(const Config* config) {
   return !config->get(kS3PathStyleAccess, false);
@@ -124,4 +146,29 @@ std::optional<std::string> HiveConfig::s3IAMRole(const Config* config) {
 std::string HiveConfig::s3IAMRoleSessionName(const Config* config) {
   return config->get(kS3IamRoleSessionName, std::string("velox-session"));
 }
+
+// static
+uint32_t HiveConfig::s3MaxConnections(const Config* config) {
+  return config->get<uint32_t>(kS3MaxConnections, 25);
+}
+
+// static
+uint64_t HiveConfig::s3UploadPartSize(const Config* config) {
+  return config->get<uint64_t>(kS3UploadPartSize, 16UL << 20);
+}
+
+// static
+uint32_t HiveConfig::s3MaxConcurrentUploads(const Config* config) {
+  return config->get<uint32_t>(kS3MaxConcurrentUploads, 4);
+}
+
+// static
+double HiveConfig::s3HedgedReadPercentile(const Config* config) {
+  return config->get<double>(kS3HedgedReadPercentile, 0);
+}
+
+// static
+uint32_t HiveConfig::s3HedgedReadMinDelayMs(const Config* config) {
+  return config->get<uint32_t>(kS3HedgedReadMinDelayMs, 20);
+}
 } // namespace facebook::velox::connector::hive
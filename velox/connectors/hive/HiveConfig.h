@@ -16,6 +16,7 @@
 #pragma once
 
 #include <folly/Optional.h>
+#include <optional>
 #include <string>
 
 namespace facebook::velox {
@@ -43,10 +44,29 @@ class HiveConfig {
   static constexpr const char* kMaxPartitionsPerWriters =
       "max_partitions_per_writers";
 
+  /// Maximum number of files a single table writer instance keeps open when
+  /// writing to a partitioned table that is not bucketed. The writer of the
+  /// least recently written partition is closed to open another one, and the
+  /// partition gets a new file if it receives more rows. 0 means no limit.
+  static constexpr const char* kMaxOpenWriters = "max_open_writers";
+
   /// Whether new data can be inserted into an unpartition table.
   /// Velox currently does not support appending data to existing partitions.
   static constexpr const char* kImmutablePartitions = "immutable_partitions";
 
+  /// Whether the writer collects the null count, minimum, maximum and
+  /// approximate number of distinct values of the written columns and returns
+  /// them with the partition updates.
+  static constexpr const char* kCollectColumnStatistics =
+      "collect_column_statistics";
+
+  /// Maximum number of splits per Driver for which TableScan opens the file
+  /// and loads the first stripe in the background while the current split is
+  /// read. 0 disables split preload. If not set, the value of the
+  /// --split_preload_per_driver flag is used.
+  static constexpr const char* kMaxSplitPreloadPerDriver =
+      "max_split_preload_per_driver";
+
   /// Virtual addressing is used for AWS S3 and is the default
   /// (path-style-access is false). Path access style is used for some on-prem
   /// systems like Minio.
@@ -79,13 +99,43 @@ class HiveConfig {
   static constexpr const char* kS3IamRoleSessionName =
       "hive.s3.iam-role-session-name";
 
+  /// Maximum number of concurrent HTTP connections to S3. This also sizes the
+  /// thread pool that runs asynchronous reads.
+  static constexpr const char* kS3MaxConnections = "hive.s3.max-connections";
+
+  /// Size of the parts of a multipart upload of a file written to S3. Files
+  /// smaller than this are uploaded with a single request.
+  static constexpr const char* kS3UploadPartSize = "hive.s3.upload-part-size";
+
+  /// Maximum number of parts of a file written to S3 that are uploaded at the
+  /// same time. Together with the part size this bounds the memory of a file
+  /// being written.
+  static constexpr const char* kS3MaxConcurrentUploads =
+      "hive.s3.max-concurrent-uploads";
+
+  /// Percentile of the observed latency of S3 reads of similar size after
+  /// which a duplicate read is issued. The first read to complete is used. 0
+  /// disables hedged reads.
+  static constexpr const char* kS3HedgedReadPercentile =
+      "hive.s3.hedged-read-percentile";
+
+  /// Minimum delay in milliseconds before a hedged read is issued.
+  static constexpr const char* kS3HedgedReadMinDelayMs =
+      "hive.s3.hedged-read-min-delay-ms";
+
   static InsertExistingPartitionsBehavior insertExistingPartitionsBehavior(
       const Config* config);
 
   static uint32_t maxPartitionsPerWriters(const Config* config);
 
+  static uint32_t maxOpenWriters(const Config* config);
+
   static bool immutablePartitions(const Config* config);
 
+  static bool collectColumnStatistics(const Config* config);
+
+  static std::optional<int32_t> maxSplitPreloadPerDriver(const Config* config);
+
   static bool s3UseVirtualAddressing(const Config* config);
 
   static std::string s3GetLogLevel(const Config* config);
@@ -103,6 +153,16 @@ class HiveConfig {
   static std::optional<std::string> s3IAMRole(const Config* config);
 
   static std::string s3IAMRoleSessionName(const Config* config);
+
+  static uint32_t s3MaxConnections(const Config* config);
+
+  static uint64_t s3UploadPartSize(const Config* config);
+
+  static uint32_t s3MaxConcurrentUploads(const Config* config);
+
+  static double s3HedgedReadPercentile(const Config* config);
+
+  static uint32_t s3HedgedReadMinDelayMs(const Config* config);
 };
 
 } // namespace facebook::velox::connector::hive
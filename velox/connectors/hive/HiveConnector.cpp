@@ -17,10 +17,14 @@
 #include "velox/connectors/hive/HiveConnector.h"
 
 #include "velox/common/base/Fs.h"
+#include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HivePartitionFunction.h"
+#include "velox/dwio/common/FileFooterCache.h"
+#include "velox/dwio/common/ReaderFactory.h"
 #include "velox/expression/FieldReference.h"
 
 #include <boost/lexical_cast.hpp>
+#include <folly/futures/Future.h>
 #include <memory>
 
 using namespace facebook::velox::exec;
@@ -39,11 +43,55 @@ HiveConnector::HiveConnector(
     folly::Executor* FOLLY_NULLABLE executor)
     : Connector(id, properties),
       fileHandleFactory_(
-          std::make_unique<
-              SimpleLRUCache<std::string, std::shared_ptr<FileHandle>>>(
-              FLAGS_num_file_handle_cache),
-          std::make_unique<FileHandleGenerator>(std::move(properties))),
-      executor_(executor) {}
+          FLAGS_num_file_handle_cache,
+          std::make_unique<FileHandleGenerator>(properties)),
+      executor_(executor),
+      maxSplitPreloadPerDriver_(
+          properties ? HiveConfig::maxSplitPreloadPerDriver(properties.get())
+                     : std::nullopt) {}
+
+folly::SemiFuture<folly::Unit> HiveConnector::prefetchSplits(
+    const std::vector<std::shared_ptr<ConnectorSplit>>& splits,
+    ConnectorQueryCtx* connectorQueryCtx) {
+  if (executor_ == nullptr) {
+    return folly::makeSemiFuture();
+  }
+  auto* pool = connectorQueryCtx->memoryPool();
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  futures.reserve(splits.size());
+  for (const auto& split : splits) {
+    auto hiveSplit = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
+    if (hiveSplit == nullptr) {
+      continue;
+    }
+    futures.push_back(
+        folly::via(executor_, [this, hiveSplit, pool]() {
+          prefetchSplit(*hiveSplit, *pool);
+        }).semi());
+  }
+  return folly::collectAll(std::move(futures)).deferValue([](auto&&) {});
+}
+
+void HiveConnector::prefetchSplit(
+    const HiveConnectorSplit& split,
+    memory::MemoryPool& pool) {
+  try {
+    auto fileHandle = fileHandleFactory_.generate(split.filePath).second;
+    if (dwio::common::FileFooterCache::instance() == nullptr) {
+      return;
+    }
+    // Creating a reader parses the footer into the FileFooterCache.
+    dwio::common::ReaderOptions readerOpts(&pool);
+    readerOpts.setFileFormat(split.fileFormat);
+    dwio::common::getReaderFactory(split.fileFormat)
+        ->createReader(
+            std::make_unique<dwio::common::BufferedInput>(
+                fileHandle->file, pool),
+            readerOpts);
+  } catch (const std::exception& e) {
+    VLOG(1) << "Prefetch of " << split.filePath << " failed: " << e.what();
+  }
+}
 
 std::unique_ptr<core::PartitionFunction> HivePartitionFunctionSpec::create(
     int numPartitions) const {
@@ -49,13 +49,30 @@ class HiveConnector : public Connector {
         connectorQueryCtx->expressionEvaluator(),
         connectorQueryCtx->allocator(),
         connectorQueryCtx->scanId(),
-        executor_);
+        executor_,
+        connectorQueryCtx->cacheTenant(),
+        connectorQueryCtx->cachePriority());
   }
 
   bool supportsSplitPreload() override {
     return true;
   }
 
+  std::optional<int32_t> maxSplitPreloadPerDriver() const override {
+    return maxSplitPreloadPerDriver_;
+  }
+
+  bool supportsSplitPrefetch() const override {
+    return executor_ != nullptr;
+  }
+
+  // Opens the files of 'splits' into the file handle cache and, if the
+  // process has a FileFooterCache, parses their footers, one split per task
+  // on 'executor_'.
+  folly::SemiFuture<folly::Unit> prefetchSplits(
+      const std::vector<std::shared_ptr<ConnectorSplit>>& splits,
+      ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx) override;
+
   std::unique_ptr<DataSink> createDataSink(
       RowTypePtr inputType,
       std::shared_ptr<ConnectorInsertTableHandle> connectorInsertTableHandle,
@@ -84,8 +101,13 @@ class HiveConnector : public Connector {
   }
 
  protected:
+  void prefetchSplit(
+      const HiveConnectorSplit& split,
+      memory::MemoryPool& pool);
+
   FileHandleFactory fileHandleFactory_;
   folly::Executor* FOLLY_NULLABLE executor_;
+  const std::optional<int32_t> maxSplitPreloadPerDriver_;
 };
 
 class HiveConnectorFactory : public ConnectorFactory {
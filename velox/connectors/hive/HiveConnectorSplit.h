@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <map>
 #include <optional>
 #include <unordered_map>
 #include "velox/connectors/Connector.h"
@@ -32,6 +33,12 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
   std::optional<int32_t> tableBucketNumber;
   std::unordered_map<std::string, std::string> customSplitInfo;
   std::shared_ptr<std::string> extraFileInfo;
+  // True if this covers a part of a split divided by the DataSource. These
+  // are not divided again.
+  bool isSubSplit{false};
+  // Modification time of the file. If set, the split has a cache key and the
+  // results of the fragments reading it may be cached.
+  std::optional<int64_t> fileModificationTime;
 
   HiveConnectorSplit(
       const std::string& connectorId,
@@ -66,6 +73,27 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
     return fmt::format("Hive: {} {} - {}", filePath, start, length);
   }
 
+  std::optional<std::string> cacheKey() const override {
+    if (!fileModificationTime.has_value()) {
+      return std::nullopt;
+    }
+    // Partition keys are sorted so that the key does not depend on the order
+    // of the map.
+    std::map<std::string, std::optional<std::string>> sortedPartitionKeys(
+        partitionKeys.begin(), partitionKeys.end());
+    auto key = fmt::format(
+        "Hive: {} {} {} - {} {}",
+        filePath,
+        fileModificationTime.value(),
+        start,
+        length,
+        tableBucketNumber.value_or(-1));
+    for (const auto& [name, value] : sortedPartitionKeys) {
+      key += fmt::format(" {}={}", name, value.value_or("NULL"));
+    }
+    return key;
+  }
+
   std::string getFileName() const {
     auto i = filePath.rfind('/');
     return i == std::string::npos ? filePath : filePath.substr(i + 1);
@@ -19,13 +19,17 @@
 #include "velox/common/base/Fs.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/core/ITypedExpr.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/exec/SortBuffer.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#include <numeric>
+
 namespace facebook::velox::connector::hive {
 
 namespace {
@@ -45,6 +49,42 @@ std::vector<column_index_t> getPartitionChannels(
   return channels;
 }
 
+// Returns the indices of the data columns if column statistics are collected.
+std::vector<column_index_t> getStatisticsChannels(
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle,
+    const Config* config) {
+  std::vector<column_index_t> channels;
+  if (!HiveConfig::collectColumnStatistics(config)) {
+    return channels;
+  }
+  for (column_index_t i = 0; i < insertTableHandle->inputColumns().size();
+       i++) {
+    if (!insertTableHandle->inputColumns()[i]->isPartitionKey()) {
+      channels.push_back(i);
+    }
+  }
+  return channels;
+}
+
+// Number of rows per batch written from a SortBuffer.
+constexpr vector_size_t kSortedWriteBatchRows = 1'024;
+
+std::unique_ptr<core::PartitionFunction> createBucketFunction(
+    const HiveBucketProperty& bucketProperty,
+    const RowTypePtr& inputType) {
+  std::vector<column_index_t> bucketChannels;
+  bucketChannels.reserve(bucketProperty.bucketedBy().size());
+  for (const auto& column : bucketProperty.bucketedBy()) {
+    bucketChannels.push_back(inputType->getChildIdx(column));
+  }
+  std::vector<int> bucketToPartition(bucketProperty.bucketCount());
+  std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+  return std::make_unique<HivePartitionFunction>(
+      bucketProperty.bucketCount(),
+      std::move(bucketToPartition),
+      std::move(bucketChannels));
+}
+
 std::string makePartitionDirectory(
     const std::string& tableDirectory,
     const std::optional<std::string>& partitionSubdirectory) {
@@ -58,6 +98,14 @@ std::string makeUuid() {
   return boost::lexical_cast<std::string>(boost::uuids::random_generator()());
 }
 
+// Hive finds the bucket of a file from the leading digits of its name.
+std::string makeBucketFileName(
+    uint32_t bucketId,
+    const std::string& taskId,
+    int driverId) {
+  return fmt::format("0{:0>5}_{}_{}", bucketId, driverId, taskId);
+}
+
 std::unordered_map<LocationHandle::TableType, std::string> tableTypeNames() {
   return {
       {LocationHandle::TableType::kNew, "kNew"},
@@ -225,6 +273,9 @@ HiveDataSink::HiveDataSink(
       connectorQueryCtx_(connectorQueryCtx),
       commitStrategy_(commitStrategy),
       partitionChannels_(getPartitionChannels(insertTableHandle_)),
+      statisticsChannels_(getStatisticsChannels(
+          insertTableHandle_,
+          connectorQueryCtx_->config())),
       partitionIdGenerator_(
           !partitionChannels_.empty() ? std::make_unique<PartitionIdGenerator>(
                                             inputType_,
@@ -232,63 +283,175 @@ HiveDataSink::HiveDataSink(
                                             HiveConfig::maxPartitionsPerWriters(
                                                 connectorQueryCtx_->config()),
                                             connectorQueryCtx_->memoryPool())
-                                      : nullptr) {
+                                      : nullptr),
+      bucketCount_(
+          insertTableHandle_->isBucketed()
+              ? insertTableHandle_->bucketProperty()->bucketCount()
+              : 0),
+      bucketFunction_(
+          insertTableHandle_->isBucketed()
+              ? createBucketFunction(
+                    *insertTableHandle_->bucketProperty(), inputType_)
+              : nullptr),
+      // The files of a bucket are named by the bucket, so a bucketed table
+      // gets one file per bucket.
+      maxOpenWriters_(
+          insertTableHandle_->isBucketed()
+              ? 0
+              : HiveConfig::maxOpenWriters(connectorQueryCtx_->config())) {
+  if (insertTableHandle_->isBucketed()) {
+    for (const auto& sortColumn :
+         insertTableHandle_->bucketProperty()->sortedBy()) {
+      sortColumns_.push_back(inputType_->getChildIdx(sortColumn->sortColumn()));
+      const auto sortOrder = sortColumn->sortOrder();
+      sortCompareFlags_.push_back(
+          {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+    }
+  }
   // TODO: remove this hack after Prestissimo adds to register dwrf writer.
   facebook::velox::dwrf::registerDwrfWriterFactory();
 }
 
+HiveDataSink::~HiveDataSink() = default;
+
 void HiveDataSink::appendData(RowVectorPtr input) {
-  // Write to unpartitioned table.
-  if (partitionChannels_.empty()) {
+  // Write to unpartitioned and unbucketed table.
+  if (partitionChannels_.empty() && bucketFunction_ == nullptr) {
     ensureSingleWriter();
-
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
+    write(0, input);
     return;
   }
 
-  // Write to partitioned table.
-  partitionIdGenerator_->run(input, partitionIds_);
-
-  ensurePartitionWriters();
-
   for (column_index_t i = 0; i < input->childrenSize(); ++i) {
     input->childAt(i)->loadedVector();
   }
 
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
+  if (bucketFunction_ == nullptr) {
+    // Write to partitioned table.
+    partitionIdGenerator_->run(input, partitionIds_);
+    ensurePartitionWriters();
+  } else {
+    computeBucketedWriterIds(input);
+  }
 
-  // All inputs belong to a single partition.
-  if (numPartitions == 1) {
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
+  // All inputs belong to a single writer.
+  if (writers_.size() == 1) {
+    write(0, input);
     return;
   }
 
   computePartitionRowCountsAndIndices();
 
-  for (auto id = 0; id < numPartitions; id++) {
+  auto writePartition = [&](size_t id) {
     const vector_size_t partitionSize = partitionSizes_[id];
     if (partitionSize == 0) {
-      continue;
+      return;
     }
-
     RowVectorPtr writerInput = partitionSize == input->size()
         ? input
         : exec::wrap(partitionSize, partitionRows_[id], input);
-    writers_[id]->write(writerInput);
-    writerInfo_[id]->numWrittenRows += partitionSize;
+    write(id, writerInput);
+  };
+
+  if (maxOpenWriters_ == 0) {
+    for (auto id = 0; id < writers_.size(); id++) {
+      writePartition(id);
+    }
+    return;
+  }
+  // Writes the partitions with open writers first so that they are not closed
+  // to open the writers of the other partitions of 'input' before their rows
+  // are written.
+  std::vector<uint32_t> openIds(openWriters_.begin(), openWriters_.end());
+  for (const auto id : openIds) {
+    writePartition(id);
+    partitionSizes_[id] = 0;
+  }
+  for (auto id = 0; id < writers_.size(); id++) {
+    writePartition(id);
   }
 }
 
+void HiveDataSink::computeBucketedWriterIds(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  if (partitionIdGenerator_ != nullptr) {
+    partitionIdGenerator_->run(input, partitionIds_);
+  } else {
+    partitionIds_.resize(numRows);
+    std::fill(partitionIds_.begin(), partitionIds_.end(), 0);
+  }
+  bucketFunction_->partition(*input, bucketIds_);
+
+  for (auto row = 0; row < numRows; ++row) {
+    const uint64_t partitionId = partitionIds_[row];
+    const uint64_t key = partitionId * bucketCount_ + bucketIds_[row];
+    auto it = writerIndexMap_.find(key);
+    if (it == writerIndexMap_.end()) {
+      it = writerIndexMap_.emplace(key, writers_.size()).first;
+      std::optional<std::string> partitionName;
+      if (partitionIdGenerator_ != nullptr) {
+        partitionName = partitionIdGenerator_->partitionName(partitionId);
+      }
+      appendWriter(partitionName, bucketIds_[row]);
+    }
+    partitionIds_[row] = it->second;
+  }
+}
+
+void HiveDataSink::write(size_t index, const RowVectorPtr& input) {
+  ensureWriterOpen(index);
+  if (!sortBuffers_.empty()) {
+    sortBuffers_[index]->addInput(input);
+  } else {
+    writers_[index]->write(input);
+  }
+  auto& info = *writerInfo_[index];
+  if (info.columnStatistics != nullptr) {
+    info.columnStatistics->add(*input);
+  }
+  info.numWrittenRows += input->size();
+}
+
+void HiveDataSink::ensureWriterOpen(size_t index) {
+  if (maxOpenWriters_ == 0) {
+    return;
+  }
+  if (writers_[index] != nullptr) {
+    openWriters_.splice(
+        openWriters_.end(), openWriters_, openWriterPositions_[index]);
+    return;
+  }
+  if (openWriters_.size() >= maxOpenWriters_) {
+    const auto lruIndex = openWriters_.front();
+    openWriters_.pop_front();
+    writers_[lruIndex]->close();
+    writers_[lruIndex].reset();
+  }
+  openWriter(index);
+  openWriterPositions_[index] = openWriters_.insert(openWriters_.end(), index);
+}
+
 std::vector<std::string> HiveDataSink::finish() const {
   std::vector<std::string> partitionUpdates;
   partitionUpdates.reserve(writerInfo_.size());
 
+  auto fileWriteInfo = [](const HiveWriterParameters& parameters) {
+    folly::dynamic info = folly::dynamic::object;
+    info["writeFileName"] = parameters.writeFileName();
+    info["targetFileName"] = parameters.targetFileName();
+    info["fileSize"] = 0;
+    return info;
+  };
+
   for (const auto& info : writerInfo_) {
     if (info != nullptr) {
+      auto fileWriteInfos =
+          folly::dynamic::array(fileWriteInfo(info->writerParameters));
+      for (const auto& parameters : info->nextFiles) {
+        fileWriteInfos.push_back(fileWriteInfo(parameters));
+      }
       // clang-format off
-      auto partitionUpdateJson = folly::toJson(
+      folly::dynamic partitionUpdate =
        folly::dynamic::object
           ("name", info->writerParameters.partitionName().value_or(""))
           ("updateMode",
@@ -296,28 +459,112 @@ std::vector<std::string> HiveDataSink::finish() const {
               info->writerParameters.updateMode()))
           ("writePath", info->writerParameters.writeDirectory())
           ("targetPath", info->writerParameters.targetDirectory())
-          ("fileWriteInfos", folly::dynamic::array(
-            folly::dynamic::object
-              ("writeFileName", info->writerParameters.writeFileName())
-              ("targetFileName", info->writerParameters.targetFileName())
-              ("fileSize", 0)))
+          ("fileWriteInfos", fileWriteInfos)
           ("rowCount", info->numWrittenRows)
          // TODO(gaoge): track and send the fields when inMemoryDataSizeInBytes, onDiskDataSizeInBytes
          // and containsNumberedFileNames are needed at coordinator when file_renaming_enabled are turned on.
           ("inMemoryDataSizeInBytes", 0)
           ("onDiskDataSizeInBytes", 0)
-          ("containsNumberedFileNames", true));
+          ("containsNumberedFileNames", true);
       // clang-format on
-      partitionUpdates.push_back(partitionUpdateJson);
+      if (info->columnStatistics != nullptr) {
+        partitionUpdate["columnStatistics"] = info->columnStatistics->toJson();
+      }
+      partitionUpdates.push_back(folly::toJson(partitionUpdate));
     }
   }
   return partitionUpdates;
 }
 
 void HiveDataSink::close() {
+  for (auto i = 0; i < writers_.size(); ++i) {
+    if (writers_[i] == nullptr) {
+      continue;
+    }
+    if (!sortBuffers_.empty()) {
+      auto& sortBuffer = sortBuffers_[i];
+      sortBuffer->noMoreInput();
+      while (auto output = sortBuffer->getOutput(kSortedWriteBatchRows)) {
+        writers_[i]->write(output);
+      }
+      sortBuffer.reset();
+    }
+    writers_[i]->close();
+  }
+}
+
+uint64_t HiveDataSink::reclaimableBytes() const {
+  uint64_t bytes = 0;
+  for (const auto& writer : writers_) {
+    if (writer != nullptr) {
+      bytes += writer->reclaimableBytes();
+    }
+  }
+  // The buffers are reset by close() once their rows are written.
+  for (const auto& sortBuffer : sortBuffers_) {
+    if (sortBuffer != nullptr && sortBuffer->canSpill()) {
+      bytes += sortBuffer->spillableBytes();
+    }
+  }
+  return bytes;
+}
+
+uint64_t HiveDataSink::reclaim(uint64_t targetBytes) {
+  // A sorted table buffers its rows in 'sortBuffers_' and only writes on
+  // close, so spilling is the only way to free memory.
+  if (!sortBuffers_.empty()) {
+    std::vector<std::pair<uint64_t, exec::SortBuffer*>> candidates;
+    for (const auto& sortBuffer : sortBuffers_) {
+      if (sortBuffer == nullptr || !sortBuffer->canSpill()) {
+        continue;
+      }
+      const auto bytes = sortBuffer->spillableBytes();
+      if (bytes > 0) {
+        candidates.emplace_back(bytes, sortBuffer.get());
+      }
+    }
+    std::sort(
+        candidates.begin(),
+        candidates.end(),
+        [](const auto& left, const auto& right) {
+          return left.first > right.first;
+        });
+    uint64_t reclaimedBytes = 0;
+    for (const auto& [bytes, sortBuffer] : candidates) {
+      if (targetBytes != 0 && reclaimedBytes >= targetBytes) {
+        break;
+      }
+      sortBuffer->spill();
+      reclaimedBytes += bytes;
+    }
+    return reclaimedBytes;
+  }
+
+  std::vector<std::pair<uint64_t, dwio::common::Writer*>> candidates;
   for (const auto& writer : writers_) {
-    writer->close();
+    if (writer == nullptr) {
+      continue;
+    }
+    const auto bytes = writer->reclaimableBytes();
+    if (bytes > 0) {
+      candidates.emplace_back(bytes, writer.get());
+    }
   }
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const auto& left, const auto& right) {
+        return left.first > right.first;
+      });
+  uint64_t reclaimedBytes = 0;
+  for (const auto& [bytes, writer] : candidates) {
+    if (targetBytes != 0 && reclaimedBytes >= targetBytes) {
+      break;
+    }
+    writer->reclaim();
+    reclaimedBytes += bytes;
+  }
+  return reclaimedBytes;
 }
 
 void HiveDataSink::ensureSingleWriter() {
@@ -342,26 +589,71 @@ void HiveDataSink::ensurePartitionWriters() {
 }
 
 void HiveDataSink::appendWriter(
-    const std::optional<std::string>& partitionName) {
+    const std::optional<std::string>& partitionName,
+    std::optional<uint32_t> bucketId) {
+  writerInfo_.push_back(std::make_shared<HiveWriterInfo>(
+      getWriterParameters(partitionName, bucketId)));
+  if (!statisticsChannels_.empty()) {
+    writerInfo_.back()->columnStatistics =
+        std::make_unique<HiveColumnStatistics>(
+            inputType_, statisticsChannels_, connectorQueryCtx_->memoryPool());
+  }
+  writers_.push_back(nullptr);
+  if (maxOpenWriters_ > 0) {
+    // Opened by the first write.
+    openWriterPositions_.emplace_back();
+  } else {
+    openWriter(writers_.size() - 1);
+  }
+
+  if (sortColumns_.empty()) {
+    return;
+  }
+  const auto index = sortBuffers_.size();
+  // Each buffer spills to its own files and tracks its own memory to decide
+  // when to spill.
+  std::optional<exec::SpillConfig> spillConfig;
+  if (connectorQueryCtx_->spillConfig() != nullptr) {
+    spillConfig = *connectorQueryCtx_->spillConfig();
+    spillConfig->filePath =
+        fmt::format("{}-sort-{}", spillConfig->filePath, index);
+  }
+  sortPools_.push_back(connectorQueryCtx_->connectorMemoryPool()->addLeafChild(
+      fmt::format("sort.{}", index)));
+  sortBuffers_.push_back(std::make_unique<exec::SortBuffer>(
+      inputType_,
+      sortColumns_,
+      sortCompareFlags_,
+      sortPools_.back().get(),
+      spillConfig));
+}
+
+void HiveDataSink::openWriter(size_t index) {
+  VELOX_CHECK_NULL(writers_[index]);
+  auto& info = *writerInfo_[index];
+  if (info.numFiles > 0) {
+    info.nextFiles.push_back(getWriterParameters(
+        info.writerParameters.partitionName(), std::nullopt, info.numFiles));
+  }
+  ++info.numFiles;
+  const auto& parameters =
+      info.nextFiles.empty() ? info.writerParameters : info.nextFiles.back();
+  const auto writePath =
+      fs::path(parameters.writeDirectory()) / parameters.writeFileName();
+
   // Without explicitly setting flush policy, the default memory based flush
   // policy is used.
-  auto writerParameters = getWriterParameters(partitionName);
-  const auto writePath = fs::path(writerParameters.writeDirectory()) /
-      writerParameters.writeFileName();
-  writerInfo_.push_back(
-      std::make_shared<HiveWriterInfo>(std::move(writerParameters)));
-
   auto writerFactory =
       dwio::common::getWriterFactory(insertTableHandle_->tableStorageFormat());
   dwio::common::WriterOptions options;
   options.schema = inputType_;
   options.memoryPool = connectorQueryCtx_->connectorMemoryPool();
-  writers_.push_back(writerFactory->createWriter(
-      dwio::common::DataSink::create(writePath), options));
+  writers_[index] = writerFactory->createWriter(
+      dwio::common::DataSink::create(writePath), options);
 }
 
 void HiveDataSink::computePartitionRowCountsAndIndices() {
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
+  const auto numPartitions = writers_.size();
   const auto numRows = partitionIds_.size();
 
   partitionSizes_.resize(numPartitions);
@@ -390,27 +682,39 @@ void HiveDataSink::computePartitionRowCountsAndIndices() {
 }
 
 HiveWriterParameters HiveDataSink::getWriterParameters(
-    const std::optional<std::string>& partition) const {
+    const std::optional<std::string>& partition,
+    std::optional<uint32_t> bucketId,
+    uint32_t fileSequence) const {
   auto updateMode = getUpdateMode();
 
   std::string targetFileName;
   std::string writeFileName;
   switch (commitStrategy_) {
     case CommitStrategy::kNoCommit: {
-      targetFileName = fmt::format(
-          "{}_{}_{}",
-          connectorQueryCtx_->taskId(),
-          connectorQueryCtx_->driverId(),
-          makeUuid());
+      targetFileName = bucketId.has_value()
+          ? makeBucketFileName(
+                bucketId.value(),
+                connectorQueryCtx_->taskId(),
+                connectorQueryCtx_->driverId())
+          : fmt::format(
+                "{}_{}_{}",
+                connectorQueryCtx_->taskId(),
+                connectorQueryCtx_->driverId(),
+                makeUuid());
       writeFileName = targetFileName;
       break;
     }
     case CommitStrategy::kTaskCommit: {
-      targetFileName = fmt::format(
-          "{}_{}_{}",
-          connectorQueryCtx_->taskId(),
-          connectorQueryCtx_->driverId(),
-          0);
+      targetFileName = bucketId.has_value()
+          ? makeBucketFileName(
+                bucketId.value(),
+                connectorQueryCtx_->taskId(),
+                connectorQueryCtx_->driverId())
+          : fmt::format(
+                "{}_{}_{}",
+                connectorQueryCtx_->taskId(),
+                connectorQueryCtx_->driverId(),
+                fileSequence);
       writeFileName =
           fmt::format(".tmp.velox.{}_{}", targetFileName, makeUuid());
       break;
@@ -478,6 +782,9 @@ folly::dynamic HiveInsertTableHandle::serialize() const {
 
   obj["inputColumns"] = arr;
   obj["locationHandle"] = locationHandle_->serialize();
+  if (bucketProperty_ != nullptr) {
+    obj["bucketProperty"] = bucketProperty_->serialize();
+  }
   return obj;
 }
 
@@ -487,7 +794,16 @@ HiveInsertTableHandlePtr HiveInsertTableHandle::create(
       obj["inputColumns"]);
   auto locationHandle =
       ISerializable::deserialize<LocationHandle>(obj["locationHandle"]);
-  return std::make_shared<HiveInsertTableHandle>(inputColumns, locationHandle);
+  std::shared_ptr<const HiveBucketProperty> bucketProperty;
+  if (obj.count("bucketProperty") != 0) {
+    bucketProperty =
+        ISerializable::deserialize<HiveBucketProperty>(obj["bucketProperty"]);
+  }
+  return std::make_shared<HiveInsertTableHandle>(
+      inputColumns,
+      locationHandle,
+      dwio::common::FileFormat::DWRF,
+      bucketProperty);
 }
 
 void HiveInsertTableHandle::registerSerDe() {
@@ -501,7 +817,11 @@ std::string HiveInsertTableHandle::toString() const {
   for (const auto& i : inputColumns_) {
     out << " " << i->toString();
   }
-  out << " ], locationHandle: " << locationHandle_->toString() << "]";
+  out << " ], locationHandle: " << locationHandle_->toString();
+  if (bucketProperty_ != nullptr) {
+    out << ", bucketProperty: " << bucketProperty_->toString();
+  }
+  out << "]";
   return out.str();
 }
 
@@ -15,7 +15,10 @@
  */
 #pragma once
 
+#include <list>
+
 #include "velox/connectors/Connector.h"
+#include "velox/connectors/hive/HiveColumnStatistics.h"
 #include "velox/connectors/hive/PartitionIdGenerator.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Writer.h"
@@ -24,6 +27,10 @@ namespace facebook::velox::dwrf {
 class Writer;
 }
 
+namespace facebook::velox::exec {
+class SortBuffer;
+}
+
 namespace facebook::velox::connector::hive {
 class HiveColumnHandle;
 
@@ -189,10 +196,12 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
       std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns,
       std::shared_ptr<const LocationHandle> locationHandle,
       const dwio::common::FileFormat tableStorageFormat =
-          dwio::common::FileFormat::DWRF)
+          dwio::common::FileFormat::DWRF,
+      std::shared_ptr<const HiveBucketProperty> bucketProperty = nullptr)
       : inputColumns_(std::move(inputColumns)),
         locationHandle_(std::move(locationHandle)),
-        tableStorageFormat_(tableStorageFormat) {}
+        tableStorageFormat_(tableStorageFormat),
+        bucketProperty_(std::move(bucketProperty)) {}
 
   virtual ~HiveInsertTableHandle() = default;
 
@@ -209,8 +218,17 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
     return tableStorageFormat_;
   }
 
+  /// Returns the bucketing of the table or nullptr if it is not bucketed.
+  const std::shared_ptr<const HiveBucketProperty>& bucketProperty() const {
+    return bucketProperty_;
+  }
+
   bool isPartitioned() const;
 
+  bool isBucketed() const {
+    return bucketProperty_ != nullptr;
+  }
+
   bool isInsertTable() const;
 
   folly::dynamic serialize() const override;
@@ -225,6 +243,7 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
   const std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns_;
   const std::shared_ptr<const LocationHandle> locationHandle_;
   const dwio::common::FileFormat tableStorageFormat_;
+  const std::shared_ptr<const HiveBucketProperty> bucketProperty_;
 };
 
 /// Parameters for Hive writers.
@@ -316,6 +335,15 @@ struct HiveWriterInfo {
 
   const HiveWriterParameters writerParameters;
   vector_size_t numWrittenRows = 0;
+  // Number of files opened for the partition.
+  uint32_t numFiles = 0;
+  // Parameters of the files opened after the first one, which is described by
+  // 'writerParameters'. A partition gets more files if its writer was closed
+  // to bound the number of open writers.
+  std::vector<HiveWriterParameters> nextFiles;
+  // Statistics of the written data columns, nullptr unless
+  // HiveConfig::kCollectColumnStatistics is set.
+  std::unique_ptr<HiveColumnStatistics> columnStatistics;
 };
 
 class HiveDataSink : public DataSink {
@@ -326,16 +354,26 @@ class HiveDataSink : public DataSink {
       const ConnectorQueryCtx* connectorQueryCtx,
       CommitStrategy commitStrategy);
 
+  ~HiveDataSink() override;
+
   void appendData(RowVectorPtr input) override;
 
   std::vector<std::string> finish() const override;
 
   void close() override;
 
+  uint64_t reclaimableBytes() const override;
+
+  /// Flushes the open stripes or row groups of the writers and spills the
+  /// rows buffered for sorted writes, holding the most memory first.
+  uint64_t reclaim(uint64_t targetBytes) override;
+
  private:
   // Pass 0 as partitionId when creating the single writer for an
-  // unpartitioned table.
-  void appendWriter(const std::optional<std::string>& partitionName);
+  // unpartitioned table. 'bucketId' is set for a bucketed table.
+  void appendWriter(
+      const std::optional<std::string>& partitionName,
+      std::optional<uint32_t> bucketId = std::nullopt);
 
   // Make sure to create the one writer for unpartitioned table.
   void ensureSingleWriter();
@@ -343,12 +381,32 @@ class HiveDataSink : public DataSink {
   // Make sure every partition has one writer created for it.
   void ensurePartitionWriters();
 
+  // Labels the rows of 'input' of a bucketed table with the index of the
+  // writer of their partition and bucket in 'partitionIds_'. Creates the
+  // writers that do not exist yet.
+  void computeBucketedWriterIds(const RowVectorPtr& input);
+
+  // Writes 'input' with the writer at 'index' or buffers it to be written
+  // sorted on close.
+  void write(size_t index, const RowVectorPtr& input);
+
+  // Creates the writer at 'index' for the next file of its partition.
+  void openWriter(size_t index);
+
+  // Makes sure that the writer at 'index' is open and marks it most recently
+  // used. Closes the least recently used writer if 'maxOpenWriters_' writers
+  // are open.
+  void ensureWriterOpen(size_t index);
+
   // Compute the number of rows as well as the actual row indices corresponding
-  // to every partition ID, based on the ID labeling of partitionIds_.
+  // to every writer, based on the writer index labeling of partitionIds_.
   void computePartitionRowCountsAndIndices();
 
+  // 'fileSequence' numbers the files of a partition.
   HiveWriterParameters getWriterParameters(
-      const std::optional<std::string>& partition) const;
+      const std::optional<std::string>& partition,
+      std::optional<uint32_t> bucketId,
+      uint32_t fileSequence = 0) const;
 
   HiveWriterParameters::UpdateMode getUpdateMode() const;
 
@@ -357,17 +415,43 @@ class HiveDataSink : public DataSink {
   const ConnectorQueryCtx* connectorQueryCtx_;
   const CommitStrategy commitStrategy_;
   const std::vector<column_index_t> partitionChannels_;
+  // The columns to collect statistics for. Empty if
+  // HiveConfig::kCollectColumnStatistics is not set.
+  const std::vector<column_index_t> statisticsChannels_;
   const std::unique_ptr<PartitionIdGenerator> partitionIdGenerator_;
+  const int32_t bucketCount_;
+  // Computes the bucket of each row of a bucketed table, nullptr otherwise.
+  const std::unique_ptr<core::PartitionFunction> bucketFunction_;
+  // The columns and sort orders of a sorted table.
+  std::vector<column_index_t> sortColumns_;
+  std::vector<CompareFlags> sortCompareFlags_;
+  // Max number of open writers of a partitioned table that is not bucketed,
+  // 0 if not limited.
+  const uint32_t maxOpenWriters_;
 
   // Below are structures for partitions from all inputs. writerInfo_ and
-  // writers_ are both indexed by partitionId.
+  // writers_ are both indexed by partitionId, or by the index in
+  // 'writerIndexMap_' for a bucketed table.
   std::vector<std::shared_ptr<HiveWriterInfo>> writerInfo_;
+  // The writers closed to bound the number of open writers are nullptr.
   std::vector<std::unique_ptr<dwio::common::Writer>> writers_;
+  // Indices of the open writers, least recently used first, and the position
+  // of each open writer in the list. Maintained if 'maxOpenWriters_' is set.
+  std::list<uint32_t> openWriters_;
+  std::vector<std::list<uint32_t>::iterator> openWriterPositions_;
+  // Maps partitionId * 'bucketCount_' + bucket to the index of the writer of
+  // a bucketed table.
+  std::unordered_map<uint64_t, uint32_t> writerIndexMap_;
+  // Per writer buffers of a sorted table that sort the rows on close, with
+  // their memory pools. Empty if the table is not sorted.
+  std::vector<std::shared_ptr<memory::MemoryPool>> sortPools_;
+  std::vector<std::unique_ptr<exec::SortBuffer>> sortBuffers_;
 
   // Below are structures updated when processing current input. partitionIds_
   // are indexed by the row of input_. partitionRows_, rawPartitionRows_ and
-  // partitionSizes_ are indexed by partitionId.
+  // partitionSizes_ are indexed by writer.
   raw_vector<uint64_t> partitionIds_;
+  std::vector<uint32_t> bucketIds_;
   std::vector<BufferPtr> partitionRows_;
   std::vector<vector_size_t*> rawPartitionRows_;
   std::vector<vector_size_t> partitionSizes_;
@@ -19,6 +19,7 @@
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
+#include "velox/dwio/common/MmapBufferedInput.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/expression/FieldReference.h"
 
@@ -175,14 +176,49 @@ void addSubfields(
   }
 }
 
+// Returns false if a filter on a partition key fails for the values of the
+// partition keys of a split. This is checked before opening the file.
+bool testPartitionFilters(
+    const common::ScanSpec& scanSpec,
+    const std::unordered_map<std::string, std::optional<std::string>>&
+        partitionKeys,
+    const std::unordered_map<std::string, std::shared_ptr<HiveColumnHandle>>&
+        partitionKeysHandle) {
+  for (const auto& child : scanSpec.children()) {
+    if (!child->filter()) {
+      continue;
+    }
+    auto iter = partitionKeys.find(child->fieldName());
+    if (iter == partitionKeys.end()) {
+      continue;
+    }
+    if (!iter->second.has_value()) {
+      if (!child->filter()->testNull()) {
+        return false;
+      }
+      continue;
+    }
+    auto handleIter = partitionKeysHandle.find(child->fieldName());
+    VELOX_CHECK(
+        handleIter != partitionKeysHandle.end(),
+        "ColumnHandle is missing for partition key {}",
+        child->fieldName());
+    if (!applyPartitionFilter(
+            handleIter->second->dataType()->kind(),
+            iter->second.value(),
+            child->filter())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool testFilters(
     common::ScanSpec* scanSpec,
     dwio::common::Reader* reader,
     const std::string& filePath,
     const std::unordered_map<std::string, std::optional<std::string>>&
-        partitionKey,
-    std::unordered_map<std::string, std::shared_ptr<HiveColumnHandle>>&
-        partitionKeysHandle) {
+        partitionKey) {
   auto totalRows = reader->numberOfRows();
   const auto& fileTypeWithId = reader->typeWithId();
   const auto& rowType = reader->rowType();
@@ -190,13 +226,9 @@ bool testFilters(
     if (child->filter()) {
       const auto& name = child->fieldName();
       if (!rowType->containsChild(name)) {
-        // If missing column is partition key.
-        auto iter = partitionKey.find(name);
-        if (iter != partitionKey.end() && iter->second.has_value()) {
-          return applyPartitionFilter(
-              partitionKeysHandle[name]->dataType()->kind(),
-              iter->second.value(),
-              child->filter());
+        // Filters on partition keys are tested by testPartitionFilters().
+        if (partitionKey.count(name)) {
+          continue;
         }
         // Column is missing. Most likely due to schema evolution.
         if (child->filter()->isDeterministic() &&
@@ -250,7 +282,9 @@ HiveDataSource::HiveDataSource(
     core::ExpressionEvaluator* expressionEvaluator,
     memory::MemoryAllocator* allocator,
     const std::string& scanId,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    const std::string& cacheTenant,
+    cache::CachePriority cachePriority)
     : fileHandleFactory_(fileHandleFactory),
       readerOpts_(pool),
       pool_(pool),
@@ -259,6 +293,10 @@ HiveDataSource::HiveDataSource(
       allocator_(allocator),
       scanId_(scanId),
       executor_(executor) {
+  if (auto* asyncCache = dynamic_cast<cache::AsyncDataCache*>(allocator_)) {
+    cacheTag_ = asyncCache->makeTag(cacheTenant, cachePriority);
+  }
+
   // Column handled keyed on the column alias, the name used in the query.
   for (const auto& [canonicalizedName, columnHandle] : columnHandles) {
     auto handle = std::dynamic_pointer_cast<HiveColumnHandle>(columnHandle);
@@ -355,6 +393,17 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   VELOX_CHECK(split_, "Wrong type of split");
 
   VLOG(1) << "Adding split " << split_->toString();
+  subSplits_.clear();
+
+  // Skips the split without opening the file if a filter on the partition
+  // keys fails.
+  if (!testPartitionFilters(
+          *scanSpec_, split_->partitionKeys, partitionKeys_)) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    return;
+  }
 
   fileHandle_ = fileHandleFactory_->generate(split_->filePath).second;
   auto input = createBufferedInput(*fileHandle_, readerOpts_);
@@ -383,14 +432,17 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
           scanSpec_.get(),
           reader_.get(),
           split_->filePath,
-          split_->partitionKeys,
-          partitionKeys_)) {
+          split_->partitionKeys)) {
     emptySplit_ = true;
     ++runtimeStats_.skippedSplits;
     runtimeStats_.skippedSplitBytes += split_->length;
     return;
   }
 
+  if (maxSubSplits_ > 1 && !split_->isSubSplit) {
+    divideSplit();
+  }
+
   auto& fileType = reader_->rowType();
 
   for (int i = 0; i < readerOutputType_->size(); i++) {
@@ -540,6 +592,10 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
        {"localReadBytes",
         RuntimeCounter(
             ioStats_->ssdRead().sum(), RuntimeCounter::Unit::kBytes)},
+       {"numPeerRead", RuntimeCounter(ioStats_->peerRead().count())},
+       {"peerReadBytes",
+        RuntimeCounter(
+            ioStats_->peerRead().sum(), RuntimeCounter::Unit::kBytes)},
        {"numRamRead", RuntimeCounter(ioStats_->ramHit().count())},
        {"ramReadBytes",
         RuntimeCounter(ioStats_->ramHit().sum(), RuntimeCounter::Unit::kBytes)},
@@ -554,7 +610,13 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
         RuntimeCounter(
             ioStats_->rawOverreadBytes(), RuntimeCounter::Unit::kBytes)},
        {"queryThreadIoLatency",
-        RuntimeCounter(ioStats_->queryThreadIoLatency().count())}});
+        RuntimeCounter(ioStats_->queryThreadIoLatency().count())},
+       {"coalesceDistance",
+        RuntimeCounter(
+            ioStats_->coalesceDistance(), RuntimeCounter::Unit::kBytes)},
+       {"maxCoalescedBytes",
+        RuntimeCounter(
+            ioStats_->maxCoalescedBytes(), RuntimeCounter::Unit::kBytes)}});
   return res;
 }
 
@@ -564,6 +626,7 @@ void HiveDataSource::setFromDataSource(
   VELOX_CHECK(source, "Bad DataSource type");
   emptySplit_ = source->emptySplit_;
   split_ = std::move(source->split_);
+  subSplits_ = std::move(source->subSplits_);
   if (emptySplit_) {
     return;
   }
@@ -650,8 +713,13 @@ std::unique_ptr<dwio::common::BufferedInput>
 HiveDataSource::createBufferedInput(
     const FileHandle& fileHandle,
     const dwio::common::ReaderOptions& readerOpts) {
+  // Mapped files are read in place and bypass the cache.
+  if (dynamic_cast<const MmapReadFile*>(fileHandle.file.get())) {
+    return std::make_unique<dwio::common::MmapBufferedInput>(
+        fileHandle.file, readerOpts.getMemoryPool(), ioStats_.get());
+  }
   if (auto* asyncCache = dynamic_cast<cache::AsyncDataCache*>(allocator_)) {
-    return std::make_unique<dwio::common::CachedBufferedInput>(
+    auto input = std::make_unique<dwio::common::CachedBufferedInput>(
         fileHandle.file,
         readerOpts.getMemoryPool(),
         dwio::common::MetricsLog::voidLog(),
@@ -663,6 +731,8 @@ HiveDataSource::createBufferedInput(
         executor_,
         readerOpts.loadQuantum(),
         readerOpts.maxCoalesceDistance());
+    input->setCacheTag(cacheTag_);
+    return input;
   }
   return std::make_unique<dwio::common::BufferedInput>(
       fileHandle.file,
@@ -712,6 +782,62 @@ void HiveDataSource::resetSplit() {
   // Keep readers around to hold adaptation.
 }
 
+void HiveDataSource::divideSplit() {
+  const uint64_t start = split_->start;
+  const uint64_t end =
+      split_->length > std::numeric_limits<uint64_t>::max() - start
+      ? std::numeric_limits<uint64_t>::max()
+      : start + split_->length;
+  // The row readers read the units that start inside the split.
+  std::vector<dwio::common::Region> units;
+  uint64_t totalBytes = 0;
+  for (const auto& unit : reader_->readUnits()) {
+    if (unit.offset >= start && unit.offset < end) {
+      units.push_back(unit);
+      totalBytes += unit.length;
+    }
+  }
+  const auto numParts = std::min<size_t>(maxSubSplits_, units.size());
+  if (numParts < 2) {
+    return;
+  }
+  // Offsets of the first unit of each part after the first. A part is closed
+  // when the bytes so far reach its share of the total, leaving at least one
+  // unit for each of the remaining parts.
+  std::vector<uint64_t> partStarts;
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < units.size() && partStarts.size() + 1 < numParts;
+       ++i) {
+    bytes += units[i].length;
+    const auto numRemainingUnits = units.size() - i - 1;
+    const auto numRemainingParts = numParts - partStarts.size() - 1;
+    if (numRemainingUnits == numRemainingParts ||
+        bytes * numParts >= totalBytes * (partStarts.size() + 1)) {
+      partStarts.push_back(units[i + 1].offset);
+    }
+  }
+  auto makeSplit = [&](uint64_t partStart, uint64_t partEnd) {
+    auto split = std::make_shared<HiveConnectorSplit>(
+        split_->connectorId,
+        split_->filePath,
+        split_->fileFormat,
+        partStart,
+        partEnd - partStart,
+        split_->partitionKeys,
+        split_->tableBucketNumber,
+        split_->customSplitInfo,
+        split_->extraFileInfo);
+    split->isSubSplit = true;
+    return split;
+  };
+  for (size_t i = 0; i < partStarts.size(); ++i) {
+    subSplits_.push_back(makeSplit(
+        partStarts[i],
+        i + 1 < partStarts.size() ? partStarts[i + 1] : end));
+  }
+  split_ = makeSplit(start, partStarts[0]);
+}
+
 void HiveDataSource::configureRowReaderOptions(
     dwio::common::RowReaderOptions& options) const {
   std::vector<std::string> columnNames;
@@ -40,7 +40,9 @@ class HiveDataSource : public DataSource {
       core::ExpressionEvaluator* expressionEvaluator,
       memory::MemoryAllocator* allocator,
       const std::string& scanId,
-      folly::Executor* executor);
+      folly::Executor* executor,
+      const std::string& cacheTenant,
+      cache::CachePriority cachePriority);
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -69,6 +71,14 @@ class HiveDataSource : public DataSource {
 
   int64_t estimatedRowSize() override;
 
+  void setMaxSubSplits(int32_t maxSubSplits) override {
+    maxSubSplits_ = maxSubSplits;
+  }
+
+  std::vector<std::shared_ptr<ConnectorSplit>> takeSubSplits() override {
+    return std::move(subSplits_);
+  }
+
   // Internal API, made public to be accessible in unit tests.  Do not use in
   // other places.
   static std::shared_ptr<common::ScanSpec> makeScanSpec(
@@ -127,6 +137,11 @@ class HiveDataSource : public DataSource {
 
   void configureRowReaderOptions(dwio::common::RowReaderOptions&) const;
 
+  // Divides 'split_' at the stripe or row group boundaries of 'reader_' into
+  // up to 'maxSubSplits_' parts of about equal size. Narrows 'split_' to the
+  // first part and adds the others to 'subSplits_'.
+  void divideSplit();
+
   const RowTypePtr outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
@@ -139,6 +154,8 @@ class HiveDataSource : public DataSource {
   std::unique_ptr<dwio::common::Reader> reader_;
   std::unique_ptr<exec::ExprSet> remainingFilterExprSet_;
   bool emptySplit_;
+  int32_t maxSubSplits_{0};
+  std::vector<std::shared_ptr<ConnectorSplit>> subSplits_;
 
   dwio::common::RuntimeStatistics runtimeStats_;
 
@@ -154,6 +171,8 @@ class HiveDataSource : public DataSource {
   memory::MemoryAllocator* const allocator_;
   const std::string& scanId_;
   folly::Executor* executor_;
+  // Tenant and priority of the cache entries created by the reads.
+  cache::CacheTag cacheTag_;
 };
 
 } // namespace facebook::velox::connector::hive
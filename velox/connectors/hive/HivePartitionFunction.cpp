@@ -29,6 +29,16 @@ void hashTyped(
       TypeTraits<kind>::name);
 }
 
+void hashPrecomputed(
+    uint32_t precomputedHash,
+    vector_size_t numRows,
+    bool mix,
+    std::vector<uint32_t>& hashes) {
+  for (auto i = 0; i < numRows; ++i) {
+    hashes[i] = mix ? hashes[i] * 31 + precomputedHash : precomputedHash;
+  }
+}
+
 template <typename T, typename Func>
 void abstractHashTyped(
     const DecodedVector& values,
@@ -36,6 +46,30 @@ void abstractHashTyped(
     bool mix,
     Func&& hashOne,
     std::vector<uint32_t>& hashes) {
+  if constexpr (!std::is_same_v<T, bool>) {
+    // Flat values without nulls are hashed in a branch free loop over the
+    // raw values, which the compiler vectorizes for fixed width types.
+    if (values.isIdentityMapping() && !values.mayHaveNulls()) {
+      const auto* rawValues = values.data<T>();
+      auto* rawHashes = hashes.data();
+      if (mix) {
+        for (auto i = 0; i < size; ++i) {
+          rawHashes[i] = rawHashes[i] * 31 + hashOne(rawValues[i]);
+        }
+      } else {
+        for (auto i = 0; i < size; ++i) {
+          rawHashes[i] = hashOne(rawValues[i]);
+        }
+      }
+      return;
+    }
+  }
+  if (values.isConstantMapping()) {
+    const uint32_t hash =
+        values.isNullAt(0) ? 0 : hashOne(values.valueAt<T>(0));
+    hashPrecomputed(hash, size, mix, hashes);
+    return;
+  }
   for (auto i = 0; i < size; ++i) {
     const uint32_t hash =
         (values.isNullAt(i)) ? 0 : hashOne(values.valueAt<T>(i));
@@ -200,15 +234,13 @@ void hash(
   VELOX_DYNAMIC_TYPE_DISPATCH(hashTyped, typeKind, values, size, mix, hashes);
 }
 
-void hashPrecomputed(
-    uint32_t precomputedHash,
-    vector_size_t numRows,
-    bool mix,
-    std::vector<uint32_t>& hashes) {
-  for (auto i = 0; i < numRows; ++i) {
-    hashes[i] = mix ? hashes[i] * 31 + precomputedHash : precomputedHash;
-  }
+// Returns true if 'values' is a dictionary over fewer distinct values than
+// 'size'. These are hashed once per base value.
+bool hashBaseValues(const DecodedVector& values, vector_size_t size) {
+  return !values.isIdentityMapping() && !values.isConstantMapping() &&
+      values.base()->size() < size;
 }
+
 } // namespace
 
 HivePartitionFunction::HivePartitionFunction(
@@ -243,12 +275,20 @@ void HivePartitionFunction::partition(
     if (keyChannels_[i] != kConstantChannel) {
       const auto& keyVector = input.childAt(keyChannels_[i]);
       decodedVectors_[i].decode(*keyVector, rows_);
-      hash(
-          decodedVectors_[i],
-          keyVector->typeKind(),
-          keyVector->size(),
-          i > 0,
-          hashes_);
+      if (hashBaseValues(decodedVectors_[i], keyVector->size())) {
+        hashDictionary(
+            decodedVectors_[i],
+            keyVector->typeKind(),
+            keyVector->size(),
+            i > 0);
+      } else {
+        hash(
+            decodedVectors_[i],
+            keyVector->typeKind(),
+            keyVector->size(),
+            i > 0,
+            hashes_);
+      }
     } else {
       hashPrecomputed(precomputedHashes_[i], numRows, i > 0, hashes_);
     }
@@ -262,6 +302,28 @@ void HivePartitionFunction::partition(
   }
 }
 
+void HivePartitionFunction::hashDictionary(
+    const DecodedVector& values,
+    TypeKind typeKind,
+    vector_size_t size,
+    bool mix) {
+  const auto* base = values.base();
+  const auto baseSize = base->size();
+  baseRows_.resizeFill(baseSize, true);
+  baseDecodedVector_.decode(*base, baseRows_);
+  if (baseSize > baseHashes_.size()) {
+    baseHashes_.resize(baseSize);
+  }
+  hash(baseDecodedVector_, typeKind, baseSize, false, baseHashes_);
+
+  // Nulls added by the dictionary hash to 0 like the nulls of the base.
+  for (auto i = 0; i < size; ++i) {
+    const uint32_t hash =
+        values.isNullAt(i) ? 0 : baseHashes_[values.index(i)];
+    hashes_[i] = mix ? hashes_[i] * 31 + hash : hash;
+  }
+}
+
 void HivePartitionFunction::precompute(
     const BaseVector& value,
     size_t channelIndex) {
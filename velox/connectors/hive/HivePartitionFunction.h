@@ -34,6 +34,14 @@ class HivePartitionFunction : public core::PartitionFunction {
       override;
 
  private:
+  // Hashes each value of the base of dictionary encoded 'values' once and
+  // combines the hashes of the rows into 'hashes_'.
+  void hashDictionary(
+      const DecodedVector& values,
+      TypeKind typeKind,
+      vector_size_t size,
+      bool mix);
+
   // Precompute single value hive hash for a constant partition key.
   void precompute(const BaseVector& value, size_t column_index_t);
 
@@ -45,6 +53,10 @@ class HivePartitionFunction : public core::PartitionFunction {
   std::vector<uint32_t> hashes_;
   SelectivityVector rows_;
   std::vector<DecodedVector> decodedVectors_;
+  // Base values and their hashes for dictionary encoded keys.
+  SelectivityVector baseRows_;
+  DecodedVector baseDecodedVector_;
+  std::vector<uint32_t> baseHashes_;
   // Precomputed hashes for constant partition keys (one per key).
   std::vector<uint32_t> precomputedHashes_;
 };
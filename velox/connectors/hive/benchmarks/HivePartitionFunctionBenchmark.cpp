@@ -57,6 +57,11 @@ class HivePartitionFunctionBenchmark
       auto flatVector = fuzzer.fuzzFlat(createScalarType(typeKind));
       rowVectors_[typeKind] = vm.rowVector({flatVector});
     }
+    // Strings repeated 10 times on average in a dictionary.
+    opts.vectorSize = std::max<size_t>(1, vectorSize / 10);
+    fuzzer.setOptions(opts);
+    varcharDictionary_ = vm.rowVector(
+        {fuzzer.fuzzDictionary(fuzzer.fuzzFlat(VARCHAR()), vectorSize)});
 
     // Prepare HivePartitionFunction
     fewBucketsFunction_ = createHivePartitionFunction(20);
@@ -75,6 +80,10 @@ class HivePartitionFunctionBenchmark
     run<KIND>(manyBucketsFunction_.get());
   }
 
+  void runVarcharDictionary() {
+    fewBucketsFunction_->partition(*varcharDictionary_, partitions_);
+  }
+
  private:
   std::unique_ptr<HivePartitionFunction> createHivePartitionFunction(
       size_t bucketCount) {
@@ -96,6 +105,7 @@ class HivePartitionFunctionBenchmark
   }
 
   std::unordered_map<TypeKind, RowVectorPtr> rowVectors_;
+  RowVectorPtr varcharDictionary_;
   std::unique_ptr<HivePartitionFunction> fewBucketsFunction_;
   std::unique_ptr<HivePartitionFunction> manyBucketsFunction_;
   std::vector<uint32_t> partitions_;
@@ -246,6 +256,14 @@ BENCHMARK_RELATIVE(varcharManyRowsManyBuckets) {
   benchmarkMany->runMany<TypeKind::VARCHAR>();
 }
 
+BENCHMARK(varcharDictionaryFewRows) {
+  benchmarkFew->runVarcharDictionary();
+}
+
+BENCHMARK(varcharDictionaryManyRows) {
+  benchmarkMany->runVarcharDictionary();
+}
+
 BENCHMARK_DRAW_LINE();
 
 BENCHMARK(timestampFewRowsFewBuckets) {
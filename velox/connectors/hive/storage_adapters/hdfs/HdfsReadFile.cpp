@@ -15,10 +15,27 @@
  */
 
 #include "HdfsReadFile.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 #include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
 
+DEFINE_int32(
+    hdfs_async_read_threads,
+    32,
+    "Number of threads for asynchronous HDFS reads. 0 makes preadvAsync "
+    "synchronous");
+
 namespace facebook::velox {
+namespace {
+folly::Executor* asyncReadExecutor() {
+  static auto* executor = new folly::CPUThreadPoolExecutor(
+      FLAGS_hdfs_async_read_threads,
+      std::make_shared<folly::NamedThreadFactory>("HdfsRead"));
+  return executor;
+}
+} // namespace
 
 HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
     : hdfsClient_(hdfs), filePath_(path) {
@@ -76,6 +93,42 @@ std::string HdfsReadFile::pread(uint64_t offset, uint64_t length) const {
   return result;
 }
 
+uint64_t HdfsReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  uint64_t length = 0;
+  for (const auto range : buffers) {
+    length += range.size();
+  }
+  if (buffers.size() == 1 && buffers[0].data()) {
+    preadInternal(offset, length, buffers[0].data());
+    return length;
+  }
+  // Gaps are read too, which is cheaper than a seek per range.
+  std::string result(length, 0);
+  preadInternal(offset, length, result.data());
+  uint64_t resultOffset = 0;
+  for (auto range : buffers) {
+    if (range.data()) {
+      memcpy(range.data(), result.data() + resultOffset, range.size());
+    }
+    resultOffset += range.size();
+  }
+  return length;
+}
+
+folly::SemiFuture<uint64_t> HdfsReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (!hasPreadvAsync()) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  return folly::via(
+             asyncReadExecutor(),
+             [this, offset, buffers]() { return preadv(offset, buffers); })
+      .semi();
+}
+
 uint64_t HdfsReadFile::size() const {
   return fileInfo_->mSize;
 }
@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
+#include <gflags/gflags.h>
 #include <hdfs/hdfs.h>
 #include "velox/common/file/File.h"
 
+DECLARE_int32(hdfs_async_read_threads);
+
 namespace facebook::velox {
 
 class HdfsReadFile final : public ReadFile {
@@ -28,6 +31,23 @@ class HdfsReadFile final : public ReadFile {
 
   std::string pread(uint64_t offset, uint64_t length) const final;
 
+  /// Reads the range spanning 'buffers' with a single open and seek.
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  /// libhdfs3 has no asynchronous API. Runs preadv on a process wide pool of
+  /// FLAGS_hdfs_async_read_threads threads so that the caller is not blocked
+  /// and many reads can be in flight. 'this' and 'buffers' must stay alive
+  /// until the returned future completes.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return FLAGS_hdfs_async_read_threads > 0;
+  }
+
   uint64_t size() const final;
 
   uint64_t memoryUsage() const final;
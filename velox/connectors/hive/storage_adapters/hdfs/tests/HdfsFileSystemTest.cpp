@@ -178,6 +178,38 @@ TEST_F(HdfsFileSystemTest, read) {
   readData(&readFile);
 }
 
+TEST_F(HdfsFileSystemTest, preadv) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  HdfsReadFile readFile(hdfs, destinationPath);
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+
+  char head[12];
+  char tail[7];
+  const uint64_t gap = 15 + kOneMB - sizeof(head) - sizeof(tail);
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(nullptr, (char*)gap),
+      folly::Range<char*>(tail, sizeof(tail))};
+  ASSERT_EQ(15 + kOneMB, readFile.preadv(0, buffers));
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+
+  std::memset(head, 0, sizeof(head));
+  std::memset(tail, 0, sizeof(tail));
+  ASSERT_EQ(15 + kOneMB, readFile.preadvAsync(0, buffers).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+
+  std::vector<folly::Range<char*>> beyondEnd = {
+      folly::Range<char*>(head, sizeof(head))};
+  VELOX_ASSERT_THROW(
+      readFile.preadvAsync(10 + kOneMB, beyondEnd).get(),
+      "Cannot read HDFS file beyond its size");
+}
+
 TEST_F(HdfsFileSystemTest, viaFileSystem) {
   filesystems::registerHdfsFileSystem();
   auto memConfig = std::make_shared<const core::MemConfig>(configurationValues);
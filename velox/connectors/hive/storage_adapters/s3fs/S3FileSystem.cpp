@@ -16,13 +16,18 @@
 
 #include "velox/connectors/hive/storage_adapters/s3fs/S3FileSystem.h"
 #include "velox/common/file/File.h"
+#include "velox/common/time/Timer.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/storage_adapters/s3fs/S3Util.h"
 #include "velox/core/Config.h"
 
 #include <fmt/format.h>
+#include <folly/futures/Future.h>
 #include <glog/logging.h>
+#include <algorithm>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 
 #include <aws/core/Aws.h>
@@ -30,10 +35,18 @@
 #include <aws/core/http/HttpResponse.h>
 #include <aws/core/utils/logging/ConsoleLogSystem.h>
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
+#include <aws/core/utils/threading/Executor.h>
 #include <aws/identity-management/auth/STSAssumeRoleCredentialsProvider.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 namespace facebook::velox {
 namespace {
@@ -60,10 +73,91 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
   return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
 }
 
+// Keeps the recent latencies of S3 reads by size class and derives from these
+// the delay after which a read is hedged, i.e. issued again.
+class ReadLatencyTracker {
+ public:
+  ReadLatencyTracker(double percentile, uint64_t minDelayUs)
+      : percentile_(percentile), minDelayUs_(minDelayUs) {
+    VELOX_USER_CHECK(
+        percentile_ > 0 && percentile_ < 100,
+        "Invalid hedged read percentile: {}",
+        percentile_);
+  }
+
+  void record(uint64_t length, uint64_t latencyUs) {
+    auto& sizeClass = sizeClasses_[sizeClassIndex(length)];
+    std::lock_guard<std::mutex> l(mutex_);
+    if (sizeClass.samples.size() < kMaxSamples) {
+      sizeClass.samples.push_back(latencyUs);
+    } else {
+      sizeClass.samples[sizeClass.next] = latencyUs;
+      sizeClass.next = (sizeClass.next + 1) % kMaxSamples;
+    }
+    if (++sizeClass.numNew >= kMinSamples) {
+      sizeClass.numNew = 0;
+      auto samples = sizeClass.samples;
+      const auto nth = std::min<size_t>(
+          samples.size() - 1, samples.size() * percentile_ / 100);
+      std::nth_element(samples.begin(), samples.begin() + nth, samples.end());
+      sizeClass.delayUs = std::max(minDelayUs_, samples[nth]);
+    }
+  }
+
+  // Returns the delay after which a read of 'length' bytes is hedged or 0 if
+  // there are not enough samples for reads of this size.
+  uint64_t hedgeDelayUs(uint64_t length) const {
+    const auto& sizeClass = sizeClasses_[sizeClassIndex(length)];
+    std::lock_guard<std::mutex> l(mutex_);
+    return sizeClass.delayUs;
+  }
+
+  void recordHedge() {
+    ++numHedgedReads_;
+  }
+
+  uint64_t numHedgedReads() const {
+    return numHedgedReads_;
+  }
+
+ private:
+  static constexpr int32_t kNumSizeClasses = 6;
+  static constexpr int32_t kMaxSamples = 1024;
+  // Number of new samples after which the delay of a size class is updated.
+  static constexpr int32_t kMinSamples = 32;
+
+  struct SizeClass {
+    std::vector<uint64_t> samples;
+    int32_t next{0};
+    int32_t numNew{0};
+    uint64_t delayUs{0};
+  };
+
+  // Size classes grow by 4x from 64KB, the last one has the larger reads.
+  static int32_t sizeClassIndex(uint64_t length) {
+    int32_t index = 0;
+    uint64_t limit = 64 << 10;
+    while (length > limit && index < kNumSizeClasses - 1) {
+      limit *= 4;
+      ++index;
+    }
+    return index;
+  }
+
+  const double percentile_;
+  const uint64_t minDelayUs_;
+  mutable std::mutex mutex_;
+  SizeClass sizeClasses_[kNumSizeClasses];
+  std::atomic<uint64_t> numHedgedReads_{0};
+};
+
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      ReadLatencyTracker* tracker = nullptr)
+      : client_(client), tracker_(tracker) {
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -108,23 +202,79 @@ class S3ReadFile final : public ReadFile {
     // multi-range. AWS S3 also charges by number of read requests and not size.
     // The idea here is to use a single read spanning all the ranges and then
     // populate individual ranges. We pre-allocate a buffer to support this.
-    size_t length = 0;
-    for (const auto range : buffers) {
-      length += range.size();
+    const auto length = totalLength(buffers);
+    if (buffers.size() == 1 && buffers[0].data()) {
+      preadInternal(offset, length, buffers[0].data());
+      return length;
     }
     // TODO: allocate from a memory pool
     std::string result(length, 0);
     preadInternal(offset, length, static_cast<char*>(result.data()));
-    size_t resultOffset = 0;
-    for (auto range : buffers) {
-      if (range.data()) {
-        memcpy(range.data(), &(result.data()[resultOffset]), range.size());
-      }
-      resultOffset += range.size();
-    }
+    copyToRanges(result.data(), buffers);
     return length;
   }
 
+  // Issues a single ranged GET on the executor of the S3 client. The calling
+  // thread does not wait for the response, so that many reads can be in
+  // flight at the same time.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    const auto length = totalLength(buffers);
+    if (length == 0) {
+      return folly::makeSemiFuture<uint64_t>(0);
+    }
+    if (tracker_) {
+      return hedgedGet(offset, length)
+          .deferValue([buffers, length](std::shared_ptr<std::string> data) {
+            copyToRanges(data->data(), buffers);
+            return length;
+          });
+    }
+    std::shared_ptr<std::string> staging;
+    char* position;
+    if (buffers.size() == 1 && buffers[0].data()) {
+      position = buffers[0].data();
+    } else {
+      staging = std::make_shared<std::string>(length, 0);
+      position = staging->data();
+    }
+
+    auto request = makeRequest(offset, length, position);
+    auto [promise, future] = folly::makePromiseContract<uint64_t>();
+    auto sharedPromise =
+        std::make_shared<folly::Promise<uint64_t>>(std::move(promise));
+    client_->GetObjectAsync(
+        request,
+        [bucket = bucket_,
+         key = key_,
+         buffers,
+         staging,
+         length,
+         sharedPromise](
+            const auto* /*client*/,
+            const auto& /*request*/,
+            auto outcome,
+            const auto& /*context*/) {
+          try {
+            VELOX_CHECK_AWS_OUTCOME(
+                outcome, "Failed to get S3 object", bucket, key);
+            if (staging) {
+              copyToRanges(staging->data(), buffers);
+            }
+            sharedPromise->setValue(length);
+          } catch (const std::exception& e) {
+            sharedPromise->setException(
+                folly::exception_wrapper(std::current_exception(), e));
+          }
+        });
+    return std::move(future);
+  }
+
+  bool hasPreadvAsync() const override {
+    return true;
+  }
+
   uint64_t size() const override {
     return length_;
   }
@@ -148,13 +298,32 @@ class S3ReadFile final : public ReadFile {
   }
 
  private:
-  // The assumption here is that "position" has space for at least "length"
-  // bytes.
-  void preadInternal(uint64_t offset, uint64_t length, char* position) const {
-    // Read the desired range of bytes.
-    Aws::S3::Model::GetObjectRequest request;
-    Aws::S3::Model::GetObjectResult result;
+  static uint64_t totalLength(const std::vector<folly::Range<char*>>& buffers) {
+    uint64_t length = 0;
+    for (const auto range : buffers) {
+      length += range.size();
+    }
+    return length;
+  }
 
+  // Copies consecutive bytes from 'data' to the non-gap ranges of 'buffers'.
+  static void copyToRanges(
+      const char* data,
+      const std::vector<folly::Range<char*>>& buffers) {
+    size_t offset = 0;
+    for (auto range : buffers) {
+      if (range.data()) {
+        memcpy(range.data(), data + offset, range.size());
+      }
+      offset += range.size();
+    }
+  }
+
+  // Returns a request for 'length' bytes at 'offset' that writes the object
+  // data to 'position'.
+  Aws::S3::Model::GetObjectRequest
+  makeRequest(uint64_t offset, uint64_t length, char* position) const {
+    Aws::S3::Model::GetObjectRequest request;
     request.SetBucket(awsString(bucket_));
     request.SetKey(awsString(key_));
     std::stringstream ss;
@@ -162,16 +331,322 @@ class S3ReadFile final : public ReadFile {
     request.SetRange(awsString(ss.str()));
     request.SetResponseStreamFactory(
         AwsWriteableStreamFactory(position, length));
-    auto outcome = client_->GetObject(request);
+    return request;
+  }
+
+  // The assumption here is that "position" has space for at least "length"
+  // bytes.
+  void preadInternal(uint64_t offset, uint64_t length, char* position) const {
+    if (tracker_) {
+      auto data = hedgedGet(offset, length).get();
+      memcpy(position, data->data(), length);
+      return;
+    }
+    // Read the desired range of bytes.
+    auto outcome = client_->GetObject(makeRequest(offset, length, position));
     VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
   }
 
+  // Reads 'length' bytes at 'offset' into a new buffer. If no response came
+  // within the hedge delay of 'tracker_', issues the same read again and
+  // returns the result of the first one to succeed. Each read has its own
+  // buffer since a slower read cannot be cancelled. Does not reference 'this'
+  // after returning.
+  folly::SemiFuture<std::shared_ptr<std::string>> hedgedGet(
+      uint64_t offset,
+      uint64_t length) const {
+    struct State {
+      folly::Promise<std::shared_ptr<std::string>> promise;
+      std::atomic<bool> done{false};
+      std::atomic<int32_t> numPending{1};
+    };
+    auto state = std::make_shared<State>();
+    auto future = state->promise.getSemiFuture();
+
+    auto issue = [client = client_,
+                  tracker = tracker_,
+                  bucket = bucket_,
+                  key = key_,
+                  offset,
+                  length,
+                  state]() {
+      auto data = std::make_shared<std::string>(length, 0);
+      Aws::S3::Model::GetObjectRequest request;
+      request.SetBucket(awsString(bucket));
+      request.SetKey(awsString(key));
+      request.SetRange(
+          awsString(fmt::format("bytes={}-{}", offset, offset + length - 1)));
+      request.SetResponseStreamFactory(
+          AwsWriteableStreamFactory(data->data(), length));
+      const auto startUs = getCurrentTimeMicro();
+      client->GetObjectAsync(
+          request,
+          [tracker, bucket, key, length, state, data, startUs](
+              const auto* /*client*/,
+              const auto& /*request*/,
+              auto outcome,
+              const auto& /*context*/) {
+            if (outcome.IsSuccess()) {
+              tracker->record(length, getCurrentTimeMicro() - startUs);
+              if (!state->done.exchange(true)) {
+                state->promise.setValue(data);
+              }
+              return;
+            }
+            if (--state->numPending > 0 || state->done.exchange(true)) {
+              return;
+            }
+            try {
+              VELOX_CHECK_AWS_OUTCOME(
+                  outcome, "Failed to get S3 object", bucket, key);
+            } catch (const std::exception& e) {
+              state->promise.setException(
+                  folly::exception_wrapper(std::current_exception(), e));
+            }
+          });
+    };
+
+    issue();
+    if (const auto delayUs = tracker_->hedgeDelayUs(length)) {
+      folly::futures::sleep(std::chrono::microseconds(delayUs))
+          .toUnsafeFuture()
+          .thenValue([state, issue, tracker = tracker_](auto&&) {
+            if (state->done) {
+              return;
+            }
+            ++state->numPending;
+            tracker->recordHedge();
+            issue();
+          });
+    }
+    return future;
+  }
+
   Aws::S3::S3Client* client_;
+  // Set if reads are hedged.
+  ReadLatencyTracker* const tracker_;
   std::string bucket_;
   std::string key_;
   int64_t length_ = -1;
 };
 
+// Minimum size of all but the last part of a multipart upload.
+constexpr uint64_t kS3MinUploadPartSize = 5 << 20;
+
+// Buffers appended data into parts and uploads full parts while more data is
+// appended. Up to 'maxConcurrentUploads' parts are uploaded at the same time
+// on the executor of the S3 client, so that a single file can use several
+// connections. append() waits for an upload to finish when this many are in
+// flight, which bounds the memory to that many parts plus the one being
+// filled. Files smaller than a part are written with a single PutObject.
+class S3WriteFile final : public WriteFile {
+ public:
+  S3WriteFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      uint64_t partSize,
+      uint32_t maxConcurrentUploads)
+      : client_(client),
+        partSize_(partSize),
+        maxConcurrentUploads_(maxConcurrentUploads) {
+    VELOX_USER_CHECK_GE(
+        partSize_,
+        kS3MinUploadPartSize,
+        "S3 upload part size must be at least 5MB");
+    VELOX_USER_CHECK_GT(maxConcurrentUploads_, 0);
+    bucketAndKeyFromS3Path(path, bucket_, key_);
+    currentPart_.reserve(partSize_);
+  }
+
+  ~S3WriteFile() override {
+    if (!closed_) {
+      try {
+        abort();
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Failed to abort upload of " << s3URI(bucket_, key_)
+                     << ": " << e.what();
+      }
+    }
+  }
+
+  void append(std::string_view data) override {
+    VELOX_CHECK(!closed_, "File is closed");
+    size_ += data.size();
+    while (!data.empty()) {
+      const auto bytes =
+          std::min<uint64_t>(data.size(), partSize_ - currentPart_.size());
+      currentPart_.append(data.data(), bytes);
+      data.remove_prefix(bytes);
+      if (currentPart_.size() == partSize_) {
+        uploadPart();
+      }
+    }
+  }
+
+  // S3 has no partial writes below the minimum part size, so data is
+  // uploaded when its part is full or at close().
+  void flush() override {
+    checkUploadError();
+  }
+
+  void close() override {
+    if (closed_) {
+      return;
+    }
+    if (uploadId_.empty()) {
+      putObject();
+      closed_ = true;
+      return;
+    }
+    if (!currentPart_.empty()) {
+      uploadPart();
+    }
+    waitForUploads(0);
+    checkUploadError();
+    completeUpload();
+    closed_ = true;
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  struct UploadState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t numInFlight{0};
+    std::vector<Aws::String> eTags;
+    std::optional<std::string> error;
+  };
+
+  void putObject() {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetContentLength(currentPart_.size());
+    request.SetBody(std::make_shared<StringViewStream>(
+        currentPart_.data(), currentPart_.size()));
+    auto outcome = client_->PutObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to put S3 object", bucket_, key_);
+    currentPart_.clear();
+  }
+
+  // Uploads 'currentPart_' asynchronously after waiting for an upload slot.
+  void uploadPart() {
+    if (uploadId_.empty()) {
+      Aws::S3::Model::CreateMultipartUploadRequest request;
+      request.SetBucket(awsString(bucket_));
+      request.SetKey(awsString(key_));
+      auto outcome = client_->CreateMultipartUpload(request);
+      VELOX_CHECK_AWS_OUTCOME(
+          outcome, "Failed to create S3 multipart upload", bucket_, key_);
+      uploadId_ = outcome.GetResult().GetUploadId();
+    }
+    waitForUploads(maxConcurrentUploads_ - 1);
+    checkUploadError();
+
+    auto part = std::make_shared<std::string>(std::move(currentPart_));
+    currentPart_ = std::string();
+    currentPart_.reserve(partSize_);
+    const int32_t partNumber = ++numParts_;
+    {
+      std::lock_guard<std::mutex> l(state_->mutex);
+      ++state_->numInFlight;
+      state_->eTags.resize(partNumber);
+    }
+
+    Aws::S3::Model::UploadPartRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetPartNumber(partNumber);
+    request.SetContentLength(part->size());
+    request.SetBody(
+        std::make_shared<StringViewStream>(part->data(), part->size()));
+    client_->UploadPartAsync(
+        request,
+        [state = state_, part, partNumber](
+            const auto* /*client*/,
+            const auto& /*request*/,
+            auto outcome,
+            const auto& /*context*/) {
+          std::lock_guard<std::mutex> l(state->mutex);
+          if (outcome.IsSuccess()) {
+            state->eTags[partNumber - 1] = outcome.GetResult().GetETag();
+          } else if (!state->error.has_value()) {
+            state->error = fmt::format(
+                "Failed to upload part {} of S3 object: {}",
+                partNumber,
+                outcome.GetError().GetMessage());
+          }
+          --state->numInFlight;
+          state->cv.notify_all();
+        });
+  }
+
+  // Waits until at most 'maxInFlight' uploads are in flight.
+  void waitForUploads(uint32_t maxInFlight) {
+    std::unique_lock<std::mutex> l(state_->mutex);
+    state_->cv.wait(
+        l, [&]() { return state_->numInFlight <= maxInFlight; });
+  }
+
+  void checkUploadError() {
+    std::lock_guard<std::mutex> l(state_->mutex);
+    if (state_->error.has_value()) {
+      VELOX_FAIL("{}. Path:'{}'", *state_->error, s3URI(bucket_, key_));
+    }
+  }
+
+  void completeUpload() {
+    Aws::S3::Model::CompletedMultipartUpload upload;
+    for (auto i = 0; i < state_->eTags.size(); ++i) {
+      Aws::S3::Model::CompletedPart part;
+      part.SetPartNumber(i + 1);
+      part.SetETag(state_->eTags[i]);
+      upload.AddParts(std::move(part));
+    }
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetMultipartUpload(std::move(upload));
+    auto outcome = client_->CompleteMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to complete S3 multipart upload", bucket_, key_);
+  }
+
+  // Drops the parts uploaded so far. Called if the file is not closed.
+  void abort() {
+    closed_ = true;
+    if (uploadId_.empty()) {
+      return;
+    }
+    waitForUploads(0);
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    auto outcome = client_->AbortMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to abort S3 multipart upload", bucket_, key_);
+  }
+
+  Aws::S3::S3Client* const client_;
+  const uint64_t partSize_;
+  const uint32_t maxConcurrentUploads_;
+  std::string bucket_;
+  std::string key_;
+  std::string currentPart_;
+  Aws::String uploadId_;
+  int32_t numParts_{0};
+  uint64_t size_{0};
+  bool closed_{false};
+  // Shared with the completion handlers of the uploads.
+  const std::shared_ptr<UploadState> state_{std::make_shared<UploadState>()};
+};
+
 Aws::Utils::Logging::LogLevel inferS3LogLevel(std::string level) {
   // Convert to upper case.
   std::transform(
@@ -304,6 +779,15 @@ class S3FileSystem::Impl {
       clientConfig.scheme = Aws::Http::Scheme::HTTP;
     }
 
+    // Bounds the connections and runs the asynchronous requests on a pool of
+    // as many threads, so that each connection can have a read in flight.
+    const auto maxConnections = HiveConfig::s3MaxConnections(config_);
+    VELOX_USER_CHECK_GT(maxConnections, 0);
+    clientConfig.maxConnections = maxConnections;
+    clientConfig.executor =
+        Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(
+            "velox-s3", maxConnections);
+
     auto credentialsProvider = getCredentialsProvider();
 
     client_ = std::make_shared<Aws::S3::S3Client>(
@@ -324,9 +808,32 @@ class S3FileSystem::Impl {
     return GetLogLevelName(inferS3LogLevel(HiveConfig::s3GetLogLevel(config_)));
   }
 
+  // Returns the latency tracker shared by the files of 'this' or nullptr if
+  // reads are not hedged.
+  ReadLatencyTracker* readLatencyTracker() {
+    std::call_once(trackerOnce_, [&]() {
+      const auto percentile = HiveConfig::s3HedgedReadPercentile(config_);
+      if (percentile > 0) {
+        tracker_ = std::make_unique<ReadLatencyTracker>(
+            percentile, HiveConfig::s3HedgedReadMinDelayMs(config_) * 1'000);
+      }
+    });
+    return tracker_.get();
+  }
+
+  uint64_t uploadPartSize() const {
+    return HiveConfig::s3UploadPartSize(config_);
+  }
+
+  uint32_t maxConcurrentUploads() const {
+    return HiveConfig::s3MaxConcurrentUploads(config_);
+  }
+
  private:
   const Config* config_;
   std::shared_ptr<Aws::S3::S3Client> client_;
+  std::once_flag trackerOnce_;
+  std::unique_ptr<ReadLatencyTracker> tracker_;
   static std::atomic<size_t> initCounter_;
 };
 
@@ -346,11 +853,17 @@ std::string S3FileSystem::getLogLevelName() const {
   return impl_->getLogLevelName();
 }
 
+uint64_t S3FileSystem::numHedgedReads() const {
+  auto* tracker = impl_->readLatencyTracker();
+  return tracker ? tracker->numHedgedReads() : 0;
+}
+
 std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(
     std::string_view path,
     const FileOptions& /*unused*/) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = std::make_unique<S3ReadFile>(
+      file, impl_->s3Client(), impl_->readLatencyTracker());
   s3file->initialize();
   return s3file;
 }
@@ -358,7 +871,11 @@ std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(
 std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
     std::string_view path,
     const FileOptions& /*unused*/) {
-  VELOX_NYI();
+  return std::make_unique<S3WriteFile>(
+      s3Path(path),
+      impl_->s3Client(),
+      impl_->uploadPartSize(),
+      impl_->maxConcurrentUploads());
 }
 
 std::string S3FileSystem::name() const {
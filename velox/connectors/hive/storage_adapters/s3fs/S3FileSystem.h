@@ -70,6 +70,10 @@ class S3FileSystem : public FileSystem {
 
   std::string getLogLevelName() const;
 
+  /// Returns the number of reads that were issued a second time because the
+  /// first took longer than hive.s3.hedged-read-percentile.
+  uint64_t numHedgedReads() const;
+
  protected:
   class Impl;
   std::shared_ptr<Impl> impl_;
@@ -17,6 +17,7 @@
 #include "connectors/hive/storage_adapters/s3fs/S3FileSystem.h"
 #include "connectors/hive/storage_adapters/s3fs/S3Util.h"
 #include "connectors/hive/storage_adapters/s3fs/tests/MinioServer.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/File.h"
 #include "velox/connectors/hive/FileHandle.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
@@ -118,6 +119,45 @@ TEST_F(S3FileSystemTest, writeAndRead) {
   readData(readFile.get());
 }
 
+TEST_F(S3FileSystemTest, writeFile) {
+  const char* bucketName = "data-write";
+  addBucket(bucketName);
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.upload-part-size", std::to_string(5 * kOneMB)},
+       {"hive.s3.max-concurrent-uploads", "2"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+
+  // Smaller than a part. Uploaded with a single request at close.
+  const std::string smallFile = s3URI(bucketName, "small.txt");
+  auto writeFile = s3fs.openFileForWrite(smallFile);
+  writeData(writeFile.get());
+  writeFile->close();
+  readData(s3fs.openFileForRead(smallFile).get());
+
+  // Several parts, some of which are uploaded at the same time.
+  const std::string largeFile = s3URI(bucketName, "large.txt");
+  writeFile = s3fs.openFileForWrite(largeFile);
+  std::string expected;
+  for (auto i = 0; i < 12; ++i) {
+    std::string data(kOneMB + i, 'a' + i);
+    writeFile->append(data);
+    expected += data;
+  }
+  writeFile->flush();
+  ASSERT_EQ(expected.size(), writeFile->size());
+  writeFile->close();
+  auto readFile = s3fs.openFileForRead(largeFile);
+  ASSERT_EQ(expected.size(), readFile->size());
+  ASSERT_EQ(expected, readFile->pread(0, expected.size()));
+
+  VELOX_ASSERT_THROW(
+      filesystems::S3FileSystem(
+          minioServer_->hiveConfig({{"hive.s3.upload-part-size", "1024"}}))
+          .openFileForWrite(largeFile),
+      "S3 upload part size must be at least 5MB");
+}
+
 TEST_F(S3FileSystemTest, viaRegistry) {
   const char* bucketName = "data2";
   const char* file = "test.txt";
@@ -134,6 +174,75 @@ TEST_F(S3FileSystemTest, viaRegistry) {
   readData(readFile.get());
 }
 
+TEST_F(S3FileSystemTest, preadvAsync) {
+  const char* bucketName = "data-async";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  auto hiveConfig = minioServer_->hiveConfig();
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  ASSERT_TRUE(readFile->hasPreadvAsync());
+
+  char head[10];
+  char tail[5];
+  std::vector<folly::Range<char*>> gapBuffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(nullptr, (char*)(uint64_t)kOneMB),
+      folly::Range<char*>(tail, sizeof(tail))};
+  std::string middle(kOneMB, 0);
+  std::vector<folly::Range<char*>> singleBuffer = {
+      folly::Range<char*>(middle.data(), middle.size())};
+
+  // Both reads are in flight at the same time.
+  auto gapRead = readFile->preadvAsync(0, gapBuffers);
+  auto singleRead = readFile->preadvAsync(10, singleBuffer);
+  ASSERT_EQ(15 + kOneMB, std::move(gapRead).get());
+  ASSERT_EQ(kOneMB, std::move(singleRead).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbb");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ddddd");
+  ASSERT_EQ(middle, std::string(kOneMB, 'c'));
+
+  // Errors are returned through the future.
+  char beyondEnd[10];
+  std::vector<folly::Range<char*>> beyondEndBuffer = {
+      folly::Range<char*>(beyondEnd, sizeof(beyondEnd))};
+  VELOX_ASSERT_THROW(
+      readFile->preadvAsync(20 + kOneMB, beyondEndBuffer).get(),
+      "Failed to get S3 object");
+}
+
+TEST_F(S3FileSystemTest, hedgedReads) {
+  const char* bucketName = "data-hedged";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  // Hedges nearly all reads once there are enough samples.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.hedged-read-percentile", "1"},
+       {"hive.s3.hedged-read-min-delay-ms", "0"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  for (auto i = 0; i < 200; ++i) {
+    char buffer[10];
+    ASSERT_EQ(readFile->pread(0, 10, buffer), "aaaaabbbbb");
+  }
+  readData(readFile.get());
+  ASSERT_GT(s3fs.numHedgedReads(), 0);
+}
+
 TEST_F(S3FileSystemTest, fileHandle) {
   const char* bucketName = "data3";
   const char* file = "test.txt";
@@ -146,9 +255,7 @@ TEST_F(S3FileSystemTest, fileHandle) {
   }
   auto hiveConfig = minioServer_->hiveConfig();
   FileHandleFactory factory(
-      std::make_unique<
-          SimpleLRUCache<std::string, std::shared_ptr<FileHandle>>>(1000),
-      std::make_unique<FileHandleGenerator>(hiveConfig));
+      1000, std::make_unique<FileHandleGenerator>(hiveConfig));
   auto fileHandle = factory.generate(s3File).second;
   readData(fileHandle->file.get());
 }
@@ -36,10 +36,7 @@ TEST(FileHandleTest, localFile) {
     writeFile.append("foo");
   }
 
-  FileHandleFactory factory(
-      std::make_unique<
-          SimpleLRUCache<std::string, std::shared_ptr<FileHandle>>>(1000),
-      std::make_unique<FileHandleGenerator>());
+  FileHandleFactory factory(1000, std::make_unique<FileHandleGenerator>());
   auto fileHandle = factory.generate(filename).second;
   ASSERT_EQ(fileHandle->file->size(), 3);
   char buffer[3];
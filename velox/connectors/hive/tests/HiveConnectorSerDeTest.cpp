@@ -34,6 +34,8 @@ class HiveConnectorSerDeTest : public exec::test::HiveConnectorTestBase {
     HiveColumnHandle::registerSerDe();
     LocationHandle::registerSerDe();
     HiveInsertTableHandle::registerSerDe();
+    HiveSortingColumn::registerSerDe();
+    HiveBucketProperty::registerSerDe();
   }
 
   template <typename T>
@@ -127,4 +129,22 @@ TEST_F(HiveConnectorSerDeTest, hiveInsertTableHandle) {
       exec::test::HiveConnectorTestBase::makeHiveInsertTableHandle(
           tableColumnNames, tableColumnTypes, {"loca"}, locationHandle);
   testSerde(*hiveInsertTableHandle);
+
+  auto bucketProperty = std::make_shared<HiveBucketProperty>(
+      HiveBucketProperty::Kind::kHiveCompatible,
+      8,
+      std::vector<std::string>{"id"},
+      std::vector<TypePtr>{bigintType},
+      std::vector<std::shared_ptr<const HiveSortingColumn>>{
+          std::make_shared<HiveSortingColumn>(
+              "loc", core::SortOrder{true, true})});
+  auto bucketedInsertTableHandle =
+      exec::test::HiveConnectorTestBase::makeHiveInsertTableHandle(
+          tableColumnNames,
+          tableColumnTypes,
+          {"loca"},
+          locationHandle,
+          dwio::common::FileFormat::DWRF,
+          bucketProperty);
+  testSerde(*bucketedInsertTableHandle);
 }
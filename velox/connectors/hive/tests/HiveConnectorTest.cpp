@@ -15,6 +15,7 @@
  */
 
 #include <gtest/gtest.h>
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 
 #include "velox/connectors/hive/HiveConfig.h"
@@ -55,6 +56,24 @@ TEST_F(HiveConnectorTest, hiveConfig) {
       "UNKNOWN BEHAVIOR 100");
 }
 
+TEST_F(HiveConnectorTest, maxSplitPreloadPerDriver) {
+  HiveConnector defaultConnector("test-hive", nullptr, nullptr);
+  ASSERT_FALSE(defaultConnector.maxSplitPreloadPerDriver().has_value());
+
+  HiveConnector connector(
+      "test-hive",
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {HiveConfig::kMaxSplitPreloadPerDriver, "4"}}),
+      nullptr);
+  ASSERT_EQ(connector.maxSplitPreloadPerDriver(), 4);
+
+  core::MemConfig negative({{HiveConfig::kMaxSplitPreloadPerDriver, "-1"}});
+  VELOX_ASSERT_THROW(
+      HiveConfig::maxSplitPreloadPerDriver(&negative),
+      "max_split_preload_per_driver must not be negative");
+}
+
 TEST_F(HiveConnectorTest, makeScanSpec_requiredSubfields_multilevel) {
   auto columnType = ROW(
       {{"c0c0", BIGINT()},
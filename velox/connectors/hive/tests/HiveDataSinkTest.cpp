@@ -18,6 +18,8 @@
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/connectors/hive/HiveColumnStatistics.h"
+#include "velox/exec/OperatorUtils.h"
 
 namespace facebook::velox::connector::hive {
 namespace {
@@ -305,5 +307,48 @@ TEST_F(HiveDataSinkTest, hiveBucketProperty) {
     ASSERT_EQ(obj, deserializedProperty->serialize());
   }
 }
+
+TEST_F(HiveDataSinkTest, columnStatistics) {
+  auto input = makeRowVector(
+      {"c0", "p0", "c1", "c2", "c3"},
+      {makeNullableFlatVector<int64_t>({10, std::nullopt, -5, 10, 7}),
+       makeFlatVector<int32_t>({1, 1, 1, 1, 1}),
+       makeNullableFlatVector<double>(
+           {1.5, 2.5, std::nullopt, std::nullopt, 0}),
+       makeNullableFlatVector<StringView>({"b", "a", "c", "a", std::nullopt}),
+       makeArrayVector<int32_t>({{1}, {}, {2, 3}, {}, {}})});
+  HiveColumnStatistics statistics(
+      asRowType(input->type()), {0, 2, 3, 4}, pool_.get());
+  statistics.add(*input);
+  // Wrapped in a dictionary like the rows of a partition.
+  statistics.add(*exec::wrap(2, makeIndices({1, 2}), input));
+
+  const auto json = statistics.toJson();
+  ASSERT_EQ(json.size(), 4);
+
+  ASSERT_EQ(json[0]["name"], "c0");
+  ASSERT_EQ(json[0]["nullCount"], 2);
+  ASSERT_EQ(json[0]["min"], -5);
+  ASSERT_EQ(json[0]["max"], 10);
+  ASSERT_EQ(json[0]["distinctCount"], 3);
+
+  ASSERT_EQ(json[1]["name"], "c1");
+  ASSERT_EQ(json[1]["nullCount"], 3);
+  ASSERT_EQ(json[1]["min"], 0.0);
+  ASSERT_EQ(json[1]["max"], 2.5);
+  ASSERT_EQ(json[1]["distinctCount"], 3);
+
+  ASSERT_EQ(json[2]["name"], "c2");
+  ASSERT_EQ(json[2]["nullCount"], 1);
+  ASSERT_EQ(json[2]["min"], "a");
+  ASSERT_EQ(json[2]["max"], "c");
+  ASSERT_EQ(json[2]["distinctCount"], 3);
+
+  // Only the nulls are counted for complex types.
+  ASSERT_EQ(json[3]["name"], "c3");
+  ASSERT_EQ(json[3]["nullCount"], 0);
+  ASSERT_EQ(json[3].count("min"), 0);
+  ASSERT_EQ(json[3].count("distinctCount"), 0);
+}
 } // namespace
 } // namespace facebook::velox::connector::hive
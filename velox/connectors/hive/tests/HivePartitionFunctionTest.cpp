@@ -279,6 +279,49 @@ TEST_F(HivePartitionFunctionTest, date) {
   assertPartitionsWithConstChannel(values, 997);
 }
 
+TEST_F(HivePartitionFunctionTest, dictionaryKeys) {
+  // Dictionaries over fewer values than rows hash each base value once. The
+  // partitions must match the flat keys.
+  const vector_size_t size = 1'000;
+  auto isNullAt = [](auto row) { return row % 11 == 3 || row % 97 == 0; };
+  auto flatStrings = makeFlatVector<std::string>(
+      size,
+      [](auto row) { return fmt::format("key {}", row % 11); },
+      isNullAt);
+  auto flatInts = makeFlatVector<int64_t>(
+      size, [](auto row) { return (row % 7) * 300'000'000'000; });
+
+  auto baseStrings = makeFlatVector<std::string>(
+      11,
+      [](auto row) { return fmt::format("key {}", row); },
+      [](auto row) { return row == 3; });
+  auto dictionaryStrings = BaseVector::wrapInDictionary(
+      makeNulls(size, [](auto row) { return row % 97 == 0; }),
+      makeIndices(size, [](auto row) { return row % 11; }),
+      size,
+      baseStrings);
+  auto dictionaryInts = wrapInDictionary(
+      makeIndices(size, [](auto row) { return row % 7; }),
+      size,
+      makeFlatVector<int64_t>(
+          7, [](auto row) { return row * 300'000'000'000; }));
+
+  for (auto bucketCount : {1, 2, 500, 997}) {
+    std::vector<int> bucketToPartition(bucketCount);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    connector::hive::HivePartitionFunction partitionFunction(
+        bucketCount, bucketToPartition, {0, 1});
+
+    std::vector<uint32_t> expected(size);
+    partitionFunction.partition(
+        *makeRowVector({flatStrings, flatInts}), expected);
+    std::vector<uint32_t> partitions(size);
+    partitionFunction.partition(
+        *makeRowVector({dictionaryStrings, dictionaryInts}), partitions);
+    EXPECT_EQ(expected, partitions) << bucketCount;
+  }
+}
+
 TEST_F(HivePartitionFunctionTest, spec) {
   Type::registerSerDe();
   core::ITypedExpr::registerSerDe();
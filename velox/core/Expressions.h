@@ -160,6 +160,8 @@ class ConstantTypedExpr : public ITypedExpr {
   const VectorPtr valueVector_;
 };
 
+using ConstantTypedExprPtr = std::shared_ptr<const ConstantTypedExpr>;
+
 class CallTypedExpr : public ITypedExpr {
  public:
   CallTypedExpr(
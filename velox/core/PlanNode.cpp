@@ -195,6 +195,9 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
     }
     const auto& aggregate = aggregates_[i];
     stream << aggregateNames_[i] << " := " << aggregate.call->toString();
+    if (aggregate.distinct) {
+      stream << " DISTINCT";
+    }
     if (aggregate.mask) {
       stream << " mask: " << aggregate.mask->name();
     }
@@ -297,6 +300,7 @@ folly::dynamic AggregationNode::Aggregate::serialize() const {
   }
   obj["sortingKeys"] = ISerializable::serialize(sortingKeys);
   obj["sortingOrders"] = serializeSortingOrders(sortingOrders);
+  obj["distinct"] = distinct;
   return obj;
 }
 
@@ -311,7 +315,9 @@ AggregationNode::Aggregate AggregationNode::Aggregate::deserialize(
   }
   auto sortingKeys = deserializeFields(obj["sortingKeys"], context);
   auto sortingOrders = deserializeSortingOrders(obj["sortingOrders"]);
-  return {call, mask, std::move(sortingKeys), std::move(sortingOrders)};
+  const bool distinct = obj.count("distinct") && obj["distinct"].asBool();
+  return {
+      call, mask, std::move(sortingKeys), std::move(sortingOrders), distinct};
 }
 
 // static
@@ -888,8 +894,54 @@ PlanNodePtr HashJoinNode::create(const folly::dynamic& obj, void* context) {
       outputType);
 }
 
+MergeJoinNode::MergeJoinNode(
+    const PlanNodeId& id,
+    JoinType joinType,
+    const std::vector<FieldAccessTypedExprPtr>& leftKeys,
+    const std::vector<FieldAccessTypedExprPtr>& rightKeys,
+    TypedExprPtr filter,
+    PlanNodePtr left,
+    PlanNodePtr right,
+    RowTypePtr outputType,
+    std::vector<ConstantTypedExprPtr> keyRangeBoundaries)
+    : AbstractJoinNode(
+          id,
+          joinType,
+          leftKeys,
+          rightKeys,
+          std::move(filter),
+          std::move(left),
+          std::move(right),
+          std::move(outputType)),
+      keyRangeBoundaries_(std::move(keyRangeBoundaries)) {
+  for (const auto& boundary : keyRangeBoundaries_) {
+    VELOX_USER_CHECK(
+        boundary->type()->equivalent(*leftKeys_[0]->type()) &&
+            boundary->type()->equivalent(*rightKeys_[0]->type()),
+        "Merge join key range boundary must have the type of the first "
+        "join key: {} vs. {}",
+        boundary->type()->toString(),
+        leftKeys_[0]->type()->toString());
+    VELOX_USER_CHECK(
+        boundary->hasValueVector() ? !boundary->valueVector()->isNullAt(0)
+                                   : !boundary->value().isNull(),
+        "Merge join key range boundary must not be null");
+  }
+}
+
+void MergeJoinNode::addDetails(std::stringstream& stream) const {
+  AbstractJoinNode::addDetails(stream);
+  if (!keyRangeBoundaries_.empty()) {
+    stream << ", key ranges: " << keyRangeBoundaries_.size() + 1;
+  }
+}
+
 folly::dynamic MergeJoinNode::serialize() const {
-  return serializeBase();
+  auto obj = serializeBase();
+  if (!keyRangeBoundaries_.empty()) {
+    obj["keyRangeBoundaries"] = ISerializable::serialize(keyRangeBoundaries_);
+  }
+  return obj;
 }
 
 // static
@@ -907,6 +959,13 @@ PlanNodePtr MergeJoinNode::create(const folly::dynamic& obj, void* context) {
 
   auto outputType = deserializeRowType(obj["outputType"]);
 
+  std::vector<ConstantTypedExprPtr> keyRangeBoundaries;
+  if (obj.count("keyRangeBoundaries")) {
+    keyRangeBoundaries =
+        ISerializable::deserialize<std::vector<ConstantTypedExpr>>(
+            obj["keyRangeBoundaries"], context);
+  }
+
   return std::make_shared<MergeJoinNode>(
       deserializePlanNodeId(obj),
       joinTypeFromName(obj["joinType"].asString()),
@@ -915,7 +974,8 @@ PlanNodePtr MergeJoinNode::create(const folly::dynamic& obj, void* context) {
       filter,
       sources[0],
       sources[1],
-      outputType);
+      outputType,
+      std::move(keyRangeBoundaries));
 }
 
 NestedLoopJoinNode::NestedLoopJoinNode(
@@ -1098,12 +1158,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
+    bool inputsSorted,
     PlanNodePtr source)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -1120,6 +1182,9 @@ WindowNode::WindowNode(
 }
 
 void WindowNode::addDetails(std::stringstream& stream) const {
+  if (inputsSorted_) {
+    stream << "STREAMING ";
+  }
   stream << "partition by [";
   if (!partitionKeys_.empty()) {
     addFields(stream, partitionKeys_);
@@ -1255,6 +1320,7 @@ folly::dynamic WindowNode::serialize() const {
     windowNames.push_back(outputType_->nameOf(i));
   }
   obj["names"] = ISerializable::serialize(windowNames);
+  obj["inputsSorted"] = inputsSorted_;
 
   return obj;
 }
@@ -1281,6 +1347,7 @@ PlanNodePtr WindowNode::create(const folly::dynamic& obj, void* context) {
       sortingOrders,
       windowNames,
       functions,
+      obj.getDefault("inputsSorted", false).asBool(),
       source);
 }
 
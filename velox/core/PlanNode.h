@@ -526,6 +526,10 @@ class TableWriteNode : public PlanNode {
     return commitStrategy_;
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.writerSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "TableWrite";
   }
@@ -578,6 +582,10 @@ class AggregationNode : public PlanNode {
     /// A list of sorting orders that goes together with 'sortingKeys'.
     std::vector<SortOrder> sortingOrders;
 
+    /// Boolean indicating whether inputs must be de-duplicated within each
+    /// group before aggregating, e.g. count(DISTINCT x).
+    bool distinct{false};
+
     folly::dynamic serialize() const;
 
     static Aggregate deserialize(const folly::dynamic& obj, void* context);
@@ -680,9 +688,20 @@ class AggregationNode : public PlanNode {
     // NOTE: as for now, we don't allow spilling for distinct aggregation
     // (https://github.com/facebookincubator/velox/issues/3263) and pre-grouped
     // aggregation (https://github.com/facebookincubator/velox/issues/3264). We
-    // will add support later to re-enable.
+    // will add support later to re-enable. Aggregates over distinct inputs
+    // cannot spill either, since their accumulators don't carry the values
+    // already seen.
     return (isFinal() || isSingle()) && !(aggregates().empty()) &&
-        preGroupedKeys().empty() && queryConfig.aggregationSpillEnabled();
+        preGroupedKeys().empty() && !hasDistinctAggregates() &&
+        queryConfig.aggregationSpillEnabled();
+  }
+
+  /// Returns true if any of the aggregates de-duplicates its inputs.
+  bool hasDistinctAggregates() const {
+    return std::any_of(
+        aggregates_.begin(), aggregates_.end(), [](const auto& aggregate) {
+          return aggregate.distinct;
+        });
   }
 
   bool isFinal() const {
@@ -931,9 +950,14 @@ class PartitionFunction {
  public:
   virtual ~PartitionFunction() = default;
 
+  /// Partition number assigned by partition() to rows that must be sent to
+  /// all partitions.
+  static constexpr uint32_t kAllPartitions =
+      std::numeric_limits<uint32_t>::max();
+
   /// @param input RowVector to split into partitions.
   /// @param [out] partitions Computed partition numbers for each row in
-  /// 'input'.
+  /// 'input'. A row may be assigned kAllPartitions.
   virtual void partition(
       const RowVector& input,
       std::vector<uint32_t>& partitions) = 0;
@@ -1459,6 +1483,17 @@ class HashJoinNode : public AbstractJoinNode {
 /// sorted on the join keys. A separate pipeline that puts its output into
 /// exec::MergeJoinSource is produced for the right side when generating
 /// exec::Operators.
+///
+/// The join runs single-threaded per split group. Co-sorted inputs can be
+/// joined in parallel by splitting the key space into disjoint ranges, e.g.
+/// based on file statistics or a sample of the keys. 'keyRangeBoundaries'
+/// are then the ascending values of the first join key that separate the
+/// ranges and the task runs in grouped execution mode with one split group
+/// per range: split group 'i' joins the rows with the first key in
+/// [keyRangeBoundaries[i - 1], keyRangeBoundaries[i]). The first and last
+/// ranges are unbounded below and above. Rows with a null first key belong
+/// to the last range, i.e. the inputs are sorted with nulls last. Splits may
+/// be added to all split groups whose range they overlap.
 class MergeJoinNode : public AbstractJoinNode {
  public:
   MergeJoinNode(
@@ -1469,24 +1504,25 @@ class MergeJoinNode : public AbstractJoinNode {
       TypedExprPtr filter,
       PlanNodePtr left,
       PlanNodePtr right,
-      RowTypePtr outputType)
-      : AbstractJoinNode(
-            id,
-            joinType,
-            leftKeys,
-            rightKeys,
-            std::move(filter),
-            std::move(left),
-            std::move(right),
-            std::move(outputType)) {}
+      RowTypePtr outputType,
+      std::vector<ConstantTypedExprPtr> keyRangeBoundaries = {});
 
   std::string_view name() const override {
     return "MergeJoin";
   }
 
+  const std::vector<ConstantTypedExprPtr>& keyRangeBoundaries() const {
+    return keyRangeBoundaries_;
+  }
+
   folly::dynamic serialize() const override;
 
   static PlanNodePtr create(const folly::dynamic& obj, void* context);
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<ConstantTypedExprPtr> keyRangeBoundaries_;
 };
 
 /// Represents inner/outer nested loop joins. Translates to an
@@ -1945,6 +1981,10 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted true if the input is already sorted by the
+  /// partition keys and the sorting keys. The operator then processes
+  /// each partition as soon as it is complete instead of buffering all
+  /// input.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1952,6 +1992,7 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
+      bool inputsSorted,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -1980,6 +2021,18 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // NOTE: streaming window only holds about one partition in memory and
+    // doesn't need to spill. Without partition keys, all the rows make up a
+    // single partition which has to be held in memory at once anyway.
+    return !inputsSorted_ && !partitionKeys_.empty() &&
+        queryConfig.windowSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -1998,6 +2051,8 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
@@ -2037,6 +2092,11 @@ class RowNumberNode : public PlanNode {
     return limit_;
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // NOTE: without partition keys, there is no per-partition state to spill.
+    return !partitionKeys_.empty() && queryConfig.rowNumberSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "RowNumber";
   }
@@ -2157,6 +2217,11 @@ class TopNRowNumberNode : public PlanNode {
     return outputType_->size() > sources_[0]->outputType()->size();
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // NOTE: without partition keys, at most 'limit' rows are held in memory.
+    return !partitionKeys_.empty() && queryConfig.topNRowNumberSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "TopNRowNumber";
   }
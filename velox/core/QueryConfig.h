@@ -64,11 +64,52 @@ class QueryConfig {
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  /// Memory limit for the results an expression memoizes for the base
+  /// vectors of dictionary encoded inputs. These are kept across batches so
+  /// that a function runs once per distinct dictionary value. 16MB by
+  /// default.
+  static constexpr const char* kExprMaxMemoBytes = "expression.max_memo_bytes";
+
+  /// Whether to evaluate arithmetic, comparison and logical sub-expressions
+  /// over flat numeric columns without nulls with fused loops instead of one
+  /// function call per node. Batches that don't qualify or overflow use the
+  /// regular evaluation. False by default.
+  static constexpr const char* kExprFusedEvalEnabled =
+      "expression.fused_eval_enabled";
+
   // Whether to track CPU usage for stages of individual operators. True by
   // default. Can be expensive when processing small batches, e.g. < 10K rows.
   static constexpr const char* kOperatorTrackCpuUsage =
       "track_operator_cpu_usage";
 
+  /// Whether to count CPU cycles, instructions, last level cache misses and
+  /// branch misses for the stages of individual operators. These are reported
+  /// in the runtime stats 'cpuCycles', 'instructions', 'cacheMisses' and
+  /// 'branchMisses' of the operators. Needs access to the hardware counters
+  /// through perf_event_open. False by default as it adds a few syscalls per
+  /// operator call.
+  static constexpr const char* kOperatorTrackHardwareCounters =
+      "track_operator_hardware_counters";
+
+  /// Fair share weight of the query's Drivers when they run on an
+  /// exec::DriverScheduler. A query with twice the weight of another gets
+  /// about twice the CPU time when both have runnable Drivers.
+  static constexpr const char* kDriverSchedulerWeight =
+      "driver_scheduler_weight";
+
+  /// Wall time in milliseconds a Driver runs on a thread before it yields the
+  /// thread to other Drivers. Long-running operator phases, e.g. the sort of
+  /// an OrderBy, are broken into chunks that end when the time slice is used
+  /// up. 0 means no limit.
+  static constexpr const char* kDriverTimeSliceMs = "driver_time_slice_ms";
+
+  /// Interval in milliseconds at which a running Driver samples the memory
+  /// usage of its operators into OperatorStats::memoryTimeline and checks
+  /// whether the query is at a new peak, see TaskStats::memoryPeak. 0
+  /// disables the sampling.
+  static constexpr const char* kOperatorMemorySampleIntervalMs =
+      "operator_memory_sample_interval_ms";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied in a way that the casting
@@ -97,9 +138,40 @@ class QueryConfig {
   static constexpr const char* kAbandonPartialAggregationMinPct =
       "abandon_partial_aggregation_min_pct";
 
+  /// Number of input rows after which an abandoned partial aggregation is
+  /// tried again. Doubles each time the retry does not reduce enough. 0 keeps
+  /// it abandoned.
+  static constexpr const char* kAbandonPartialAggregationResampleRows =
+      "abandon_partial_aggregation_resample_rows";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "max_page_partitioning_buffer_size";
 
+  /// If true, PartitionedOutput splits max_page_partitioning_buffer_size
+  /// between its destinations by how fast each consumer fetches data,
+  /// instead of evenly. Faster consumers then get larger pages.
+  static constexpr const char* kPartitionedOutputAdaptivePageSizeEnabled =
+      "partitioned_output_adaptive_page_size_enabled";
+
+  /// The compression codec for the pages that PartitionedOutput sends to
+  /// Exchange and MergeExchange, e.g. "none", "lz4" or "zstd". The producer
+  /// and consumer tasks of an exchange must use the same codec.
+  static constexpr const char* kExchangeCompressionKind =
+      "exchange_compression_codec";
+
+  /// A compressed page is sent only if its size is below this fraction of
+  /// the uncompressed size. Otherwise the page is sent uncompressed and
+  /// compression is skipped for a growing number of the following pages to
+  /// the same destination.
+  static constexpr const char* kExchangeMinCompressionRatio =
+      "exchange_min_compression_ratio";
+
+  /// If true, PartitionedOutput sends dictionary encoded and constant
+  /// top-level columns as DICTIONARY and RLE blocks instead of flattening
+  /// them.
+  static constexpr const char* kExchangePreserveEncodings =
+      "exchange_preserve_encodings";
+
   /// Preferred size of batches in bytes to be returned by operators from
   /// Operator::getOutput. It is used when an estimate of average row size is
   /// known. Otherwise kPreferredOutputBatchRows is used.
@@ -119,6 +191,13 @@ class QueryConfig {
   /// output rows.
   static constexpr const char* kMaxOutputBatchRows = "max_output_batch_rows";
 
+  /// If true, TableScan adapts the number of rows it reads per batch to the
+  /// selectivity of the filters and to the output row size observed in the
+  /// current split so that output batches get close to
+  /// kPreferredOutputBatchBytes.
+  static constexpr const char* kTableScanAdaptiveBatchSizeEnabled =
+      "table_scan_adaptive_batch_size_enabled";
+
   /// If false, the 'group by' code is forced to use generic hash mode
   /// hashtable.
   static constexpr const char* kHashAdaptivityEnabled =
@@ -129,6 +208,13 @@ class QueryConfig {
   static constexpr const char* kAdaptiveFilterReorderingEnabled =
       "adaptive_filter_reordering_enabled";
 
+  /// If true and adaptive filter reordering is enabled, the conjunction
+  /// expression starts with the order of inputs learned by earlier
+  /// expressions in the process with the same inputs, so that short queries
+  /// benefit from the first batch.
+  static constexpr const char* kAdaptiveFilterReorderingUseHistory =
+      "adaptive_filter_reordering_use_history";
+
   /// Global enable spilling flag.
   static constexpr const char* kSpillEnabled = "spill_enabled";
 
@@ -139,9 +225,76 @@ class QueryConfig {
   /// Join spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kJoinSpillEnabled = "join_spill_enabled";
 
+  /// If true, a hash build asked by the memory arbitrator to free memory
+  /// spills only the largest partitions needed to free the requested bytes
+  /// and keeps the other partitions in memory. Only applies if
+  /// "join_spill_enabled" is set.
+  static constexpr const char* kJoinSpillHybridReclaimEnabled =
+      "join_spill_hybrid_reclaim_enabled";
+
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
+  /// RowNumber spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kRowNumberSpillEnabled =
+      "row_number_spill_enabled";
+
+  /// TopNRowNumber spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNRowNumberSpillEnabled =
+      "topn_row_number_spill_enabled";
+
+  /// TableWrite spilling flag, only applies if "spill_enabled" flag is set.
+  /// Spills the rows buffered for sorted writes.
+  static constexpr const char* kWriterSpillEnabled = "writer_spill_enabled";
+
+  /// If true, a final OrderBy runs on multiple drivers. Each driver sorts its
+  /// own input and the last driver to finish merges the sorted runs of all
+  /// drivers and produces the output. Spilling is disabled for such an
+  /// OrderBy.
+  static constexpr const char* kOrderByParallelSortEnabled =
+      "order_by_parallel_sort_enabled";
+
+  /// If true, a final or single grouped aggregation runs on multiple drivers
+  /// without a local exchange on the grouping keys in front of it. The groups
+  /// of all drivers are partitioned by the hash of the grouping keys at the end
+  /// of input and each driver merges and produces one share of the partitions.
+  /// Spilling is disabled for such an aggregation.
+  static constexpr const char* kAggregationParallelMergeEnabled =
+      "aggregation_parallel_merge_enabled";
+
+  /// If true, a final or single grouped aggregation followed by a filter which
+  /// bounds count(), max() or min() from the side to which the aggregate moves
+  /// with more input, e.g. HAVING count(*) <= 10, stops adding input to the
+  /// groups which fail the bound.
+  static constexpr const char* kAggregationHavingPruningEnabled =
+      "aggregation_having_pruning_enabled";
+
+  /// The max size in bytes of a Bloom filter that a hash join build makes over
+  /// an integer join key to push down into the probe side scan. Bloom filters
+  /// are made only for keys with too many distinct values for an exact IN-list
+  /// filter. Bloom filters take 2 bytes per distinct key, rounded up to a power
+  /// of two. 0 disables Bloom filters.
+  static constexpr const char* kHashProbeBloomFilterPushdownMaxSize =
+      "hash_probe_bloom_filter_pushdown_max_size";
+
+  /// Opaque identifier of the versions of the data read by the build sides of
+  /// the hash joins of the query, e.g. the snapshot ids of the tables. If set
+  /// and --hash_table_cache_bytes is not 0, the built hash tables are cached
+  /// and reused by the queries with the same build side plan and version.
+  static constexpr const char* kHashTableCacheInputVersion =
+      "hash_table_cache_input_version";
+
+  /// The max bytes of probe input that each HashProbe operator of an inner
+  /// join buffers while the hash table is being built. If the whole probe
+  /// side fits and the build side turns out to be much larger, the join swaps
+  /// the sides at runtime: the probe input is put in the hash table and the
+  /// rest of the build input is streamed through it. 0 disables the swap.
+  static constexpr const char* kHashJoinSwapProbeBufferBytes =
+      "hash_join_swap_probe_buffer_bytes";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
@@ -157,6 +310,11 @@ class QueryConfig {
   static constexpr const char* kOrderBySpillMemoryThreshold =
       "order_by_spill_memory_threshold";
 
+  /// The max memory that a window can use before spilling. If it 0, then there
+  /// is no limit.
+  static constexpr const char* kWindowSpillMemoryThreshold =
+      "window_spill_memory_threshold";
+
   static constexpr const char* kTestingSpillPct = "testing.spill_pct";
 
   /// The max allowed spilling level with zero being the initial spilling level.
@@ -188,6 +346,42 @@ class QueryConfig {
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable_reservation_growth_pct";
 
+  /// The compression codec used for spill files, e.g. "none", "lz4" or
+  /// "zstd". The same codec is used to read the spilled data back.
+  static constexpr const char* kSpillCompressionKind =
+      "spill_compression_codec";
+
+  /// The number of buffers read ahead asynchronously on the spill executor
+  /// for each spill file being read back. 0 disables read-ahead.
+  static constexpr const char* kSpillReadAheadDepth = "spill_read_ahead_depth";
+
+  /// The tenant that the cache entries created by the query are charged to.
+  /// See AsyncDataCache::setTenantQuota(). Empty means the default tenant.
+  static constexpr const char* kCacheTenant = "cache_tenant";
+
+  /// The retention priority of the cache entries created or hit by the query:
+  /// "low", "normal" or "high".
+  static constexpr const char* kCachePriority = "cache_priority";
+
+  /// If true, Task::next() returns the results of a plan fragment from the
+  /// process wide FragmentResultCache if the same fragment ran with the same
+  /// splits before.
+  static constexpr const char* kFragmentResultCacheEnabled =
+      "fragment_result_cache_enabled";
+
+  /// The max memory in bytes of a task in grouped execution above which no
+  /// more split groups start until a running group finishes. A new group is
+  /// expected to use as much memory as the largest group so far. 0 means no
+  /// limit other than the number of concurrent split groups.
+  static constexpr const char* kGroupedExecutionMemoryBudget =
+      "grouped_execution_memory_budget";
+
+  /// The max number of Arrow arrays an ArrowStream operator fetches ahead of
+  /// its consumer on the executor of the query. 0 fetches the arrays on the
+  /// driver thread.
+  static constexpr const char* kArrowStreamPrefetchBatches =
+      "arrow_stream_prefetch_batches";
+
   /// If false, size function returns null for null input.
   static constexpr const char* kSparkLegacySizeOfNull =
       "spark.legacy_size_of_null";
@@ -210,6 +404,10 @@ class QueryConfig {
     return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
   }
 
+  int64_t abandonPartialAggregationResampleRows() const {
+    return get<int64_t>(kAbandonPartialAggregationResampleRows, 0);
+  }
+
   uint64_t aggregationSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kAggregationSpillMemoryThreshold, kDefault);
@@ -225,6 +423,11 @@ class QueryConfig {
     return get<uint64_t>(kOrderBySpillMemoryThreshold, kDefault);
   }
 
+  uint64_t windowSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kWindowSpillMemoryThreshold, kDefault);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -234,6 +437,24 @@ class QueryConfig {
     return get<uint64_t>(kMaxPartitionedOutputBufferSize, kDefault);
   }
 
+  bool partitionedOutputAdaptivePageSizeEnabled() const {
+    return get<bool>(kPartitionedOutputAdaptivePageSizeEnabled, false);
+  }
+
+  /// Returns the name of the exchange compression codec. Parsed with
+  /// common::stringToCompressionKind().
+  std::string exchangeCompressionKind() const {
+    return get<std::string>(kExchangeCompressionKind, "none");
+  }
+
+  double exchangeMinCompressionRatio() const {
+    return get<double>(kExchangeMinCompressionRatio, 0.8);
+  }
+
+  bool exchangePreserveEncodings() const {
+    return get<bool>(kExchangePreserveEncodings, false);
+  }
+
   uint64_t maxLocalExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
@@ -252,6 +473,10 @@ class QueryConfig {
     return get<uint32_t>(kMaxOutputBatchRows, 10'000);
   }
 
+  bool tableScanAdaptiveBatchSizeEnabled() const {
+    return get<bool>(kTableScanAdaptiveBatchSizeEnabled, true);
+  }
+
   bool hashAdaptivityEnabled() const {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
@@ -270,6 +495,10 @@ class QueryConfig {
     return get<bool>(kAdaptiveFilterReorderingEnabled, true);
   }
 
+  bool adaptiveFilterReorderingUseHistory() const {
+    return get<bool>(kAdaptiveFilterReorderingUseHistory, false);
+  }
+
   bool isMatchStructByName() const {
     return get<bool>(kCastMatchStructByName, false);
   }
@@ -319,12 +548,64 @@ class QueryConfig {
     return get<bool>(kJoinSpillEnabled, true);
   }
 
+  bool joinSpillHybridReclaimEnabled() const {
+    return get<bool>(kJoinSpillHybridReclaimEnabled, false);
+  }
+
   /// Returns 'is orderby spilling enabled' flag. Must also check the
   /// spillEnabled()!
   bool orderBySpillEnabled() const {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, true);
+  }
+
+  /// Returns 'is row number spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool rowNumberSpillEnabled() const {
+    return get<bool>(kRowNumberSpillEnabled, true);
+  }
+
+  /// Returns 'is topn row number spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNRowNumberSpillEnabled() const {
+    return get<bool>(kTopNRowNumberSpillEnabled, true);
+  }
+
+  /// Returns 'is writer spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool writerSpillEnabled() const {
+    return get<bool>(kWriterSpillEnabled, true);
+  }
+
+  bool orderByParallelSortEnabled() const {
+    return get<bool>(kOrderByParallelSortEnabled, false);
+  }
+
+  bool aggregationParallelMergeEnabled() const {
+    return get<bool>(kAggregationParallelMergeEnabled, false);
+  }
+
+  bool aggregationHavingPruningEnabled() const {
+    return get<bool>(kAggregationHavingPruningEnabled, true);
+  }
+
+  uint64_t hashProbeBloomFilterPushdownMaxSize() const {
+    return get<uint64_t>(kHashProbeBloomFilterPushdownMaxSize, 0);
+  }
+
+  std::string hashTableCacheInputVersion() const {
+    return get<std::string>(kHashTableCacheInputVersion, "");
+  }
+
+  uint64_t hashJoinSwapProbeBufferBytes() const {
+    return get<uint64_t>(kHashJoinSwapProbeBufferBytes, 0);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -371,11 +652,50 @@ class QueryConfig {
     return get<double>(kSpillableReservationGrowthPct, kDefaultPct);
   }
 
+  /// Returns the name of the spill compression codec. Parsed with
+  /// common::stringToCompressionKind().
+  std::string spillCompressionKind() const {
+    return get<std::string>(kSpillCompressionKind, "none");
+  }
+
+  int32_t spillReadAheadDepth() const {
+    return get<int32_t>(kSpillReadAheadDepth, 0);
+  }
+
+  std::string cacheTenant() const {
+    return get<std::string>(kCacheTenant, "");
+  }
+
+  std::string cachePriority() const {
+    return get<std::string>(kCachePriority, "normal");
+  }
+
+  bool fragmentResultCacheEnabled() const {
+    return get<bool>(kFragmentResultCacheEnabled, false);
+  }
+
+  int64_t groupedExecutionMemoryBudget() const {
+    return get<int64_t>(kGroupedExecutionMemoryBudget, 0);
+  }
+
+  int32_t arrowStreamPrefetchBatches() const {
+    return get<int32_t>(kArrowStreamPrefetchBatches, 2);
+  }
+
   bool sparkLegacySizeOfNull() const {
     constexpr bool kDefault{true};
     return get<bool>(kSparkLegacySizeOfNull, kDefault);
   }
 
+  uint64_t exprMaxMemoBytes() const {
+    static constexpr uint64_t kDefault = 16UL << 20;
+    return get<uint64_t>(kExprMaxMemoBytes, kDefault);
+  }
+
+  bool exprFusedEvalEnabled() const {
+    return get<bool>(kExprFusedEvalEnabled, false);
+  }
+
   bool exprTrackCpuUsage() const {
     return get<bool>(kExprTrackCpuUsage, false);
   }
@@ -384,6 +704,22 @@ class QueryConfig {
     return get<bool>(kOperatorTrackCpuUsage, true);
   }
 
+  bool operatorTrackHardwareCounters() const {
+    return get<bool>(kOperatorTrackHardwareCounters, false);
+  }
+
+  double driverSchedulerWeight() const {
+    return get<double>(kDriverSchedulerWeight, 1.0);
+  }
+
+  uint64_t driverTimeSliceMs() const {
+    return get<uint64_t>(kDriverTimeSliceMs, 0);
+  }
+
+  uint64_t operatorMemorySampleIntervalMs() const {
+    return get<uint64_t>(kOperatorMemorySampleIntervalMs, 0);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return config_->get<T>(key, defaultValue);
@@ -146,10 +146,18 @@ class QueryCtx {
 // Represents the state of one thread of query execution.
 class ExecCtx {
  public:
+  /// Recycles vectors in 'sharedVectorPool' if not null, else in a pool
+  /// owned by 'this'. 'sharedVectorPool' must outlive 'this'.
   ExecCtx(
       memory::MemoryPool* FOLLY_NONNULL pool,
-      QueryCtx* FOLLY_NULLABLE queryCtx)
-      : pool_(pool), queryCtx_(queryCtx), vectorPool_{pool} {}
+      QueryCtx* FOLLY_NULLABLE queryCtx,
+      VectorPool* FOLLY_NULLABLE sharedVectorPool = nullptr)
+      : pool_(pool),
+        queryCtx_(queryCtx),
+        ownedVectorPool_{
+            sharedVectorPool ? nullptr : std::make_unique<VectorPool>(pool)},
+        vectorPool_{
+            sharedVectorPool ? sharedVectorPool : ownedVectorPool_.get()} {}
 
   velox::memory::MemoryPool* FOLLY_NONNULL pool() const {
     return pool_;
@@ -205,25 +213,25 @@ class ExecCtx {
   }
 
   VectorPool& vectorPool() {
-    return vectorPool_;
+    return *vectorPool_;
   }
 
   /// Gets a possibly recycled vector of 'type and 'size'. Allocates from
   /// 'pool_' if no pre-allocated vector.
   VectorPtr getVector(const TypePtr& type, vector_size_t size) {
-    return vectorPool_.get(type, size);
+    return vectorPool_->get(type, size, pool_);
   }
 
   /// Moves 'vector' to the pool if it is reusable, else leaves it in
   /// place. Returns true if the vector was moved into the pool.
   bool releaseVector(VectorPtr& vector) {
-    return vectorPool_.release(vector);
+    return vectorPool_->release(vector);
   }
 
   /// Moves elements of 'vectors' to the pool if reusable, else leaves them
   /// in place. Returns number of vectors that were moved into the pool.
   size_t releaseVectors(std::vector<VectorPtr>& vectors) {
-    return vectorPool_.release(vectors);
+    return vectorPool_->release(vectors);
   }
 
  private:
@@ -235,7 +243,8 @@ class ExecCtx {
   // A pool of preallocated SelectivityVectors for use by expressions
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
-  VectorPool vectorPool_;
+  std::unique_ptr<VectorPool> ownedVectorPool_;
+  VectorPool* const FOLLY_NONNULL vectorPool_;
 };
 
 } // namespace facebook::velox::core
@@ -51,13 +51,16 @@ struct AggregateExpr {
   std::shared_ptr<const core::IExpr> expr;
   std::vector<std::pair<std::shared_ptr<const core::IExpr>, core::SortOrder>>
       orderBy;
+  bool distinct{false};
 };
 
-/// Parses aggregate function call expression with optional ORDER by clause.
+/// Parses aggregate function call expression with optional ORDER by clause
+/// and DISTINCT keyword.
 /// Examples:
 ///     sum(a)
 ///     sum(a) as s
 ///     array_agg(x ORDER BY y DESC)
+///     count(DISTINCT a)
 AggregateExpr parseAggregateExpr(
     const std::string& exprString,
     const ParseOptions& options);
@@ -125,6 +125,9 @@ TEST(DuckParserTest, aggregates) {
     auto aggregateExpr = parseAggregateExpr(expr, options);
     std::stringstream out;
     out << aggregateExpr.expr->toString();
+    if (aggregateExpr.distinct) {
+      out << " DISTINCT";
+    }
     if (!aggregateExpr.orderBy.empty()) {
       out << " " << toString(aggregateExpr.orderBy);
     }
@@ -145,6 +148,7 @@ TEST(DuckParserTest, aggregates) {
   EXPECT_EQ(
       "array_agg(\"x\") ORDER BY \"y\" ASC NULLS LAST, \"z\" ASC NULLS LAST",
       parse("array_agg(x ORDER BY y, z)"));
+  EXPECT_EQ("count(\"x\") DISTINCT", parse("count(DISTINCT x)"));
 }
 
 TEST(DuckParserTest, subscript) {
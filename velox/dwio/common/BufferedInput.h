@@ -139,6 +139,12 @@ class BufferedInput {
     return 0;
   }
 
+  // The process wide number of the file, e.g. for keys of caches, or
+  // std::nullopt if the input has no file number.
+  virtual std::optional<uint64_t> fileNum() const {
+    return std::nullopt;
+  }
+
  protected:
   std::shared_ptr<ReadFileInputStream> input_;
   memory::MemoryPool& pool_;
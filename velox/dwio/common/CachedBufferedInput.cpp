@@ -15,9 +15,16 @@
  */
 
 #include "velox/dwio/common/CachedBufferedInput.h"
+
+#include <folly/futures/Future.h>
+
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/caching/PeerCache.h"
 #include "velox/common/memory/Allocation.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
+#include "velox/dwio/common/StorageLatencyModel.h"
 
 DEFINE_int32(
     cache_prefetch_min_pct,
@@ -29,6 +36,13 @@ DEFINE_int64(
     128 << 20,
     "Maximum size of single coalesced IO");
 
+DEFINE_bool(
+    cache_adaptive_coalesce,
+    false,
+    "Derive the coalescing distance and maximum coalesced IO size from the "
+    "observed latency and throughput of the storage instead of the "
+    "configured values");
+
 namespace facebook::velox::dwio::common {
 
 using cache::CachePin;
@@ -164,6 +178,11 @@ void CachedBufferedInput::load(const LogType) {
   if (ssdCache) {
     ssdFile = &ssdCache->file(fileNum_);
   }
+  auto peerCache = cache_->peerCache();
+  std::string fileName;
+  if (peerCache) {
+    fileName = cache::fileIds().string(fileNum_);
+  }
   // Extra requests made for preloadable regions that are larger then
   // 'loadQuantum'.
   std::vector<std::unique_ptr<CacheRequest>> extraRequests;
@@ -173,6 +192,7 @@ void CachedBufferedInput::load(const LogType) {
   for (auto readPct : std::vector<int32_t>{80, 50, 20, 0}) {
     std::vector<CacheRequest*> storageLoad;
     std::vector<CacheRequest*> ssdLoad;
+    std::vector<CacheRequest*> peerLoad;
     for (auto& request : requests) {
       if (request.processed) {
         continue;
@@ -204,12 +224,18 @@ void CachedBufferedInput::load(const LogType) {
               continue;
             }
           }
+          if (peerCache && peerCache->isRemote(fileName, part->key.offset)) {
+            part->fromPeer = true;
+            peerLoad.push_back(part);
+            continue;
+          }
           storageLoad.push_back(part);
         }
       }
     }
     makeLoads(std::move(storageLoad), isPrefetchPct(readPct));
     makeLoads(std::move(ssdLoad), isPrefetchPct(readPct));
+    makeLoads(std::move(peerLoad), isPrefetchPct(readPct));
   }
 }
 
@@ -220,7 +246,12 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  int32_t maxDistance = isSsd ? 20000 : coalesceDistance();
+  const int64_t maxCoalescedBytes =
+      isSsd ? FLAGS_max_coalesced_bytes : this->maxCoalescedBytes();
+  if (!isSsd && ioStats_) {
+    ioStats_->setCoalesceLimits(maxDistance, maxCoalescedBytes);
+  }
   std::sort(
       requests.begin(),
       requests.end(),
@@ -250,7 +281,7 @@ void CachedBufferedInput::makeLoads(
         return size;
       },
       [&](int32_t index) {
-        if (coalescedBytes > FLAGS_max_coalesced_bytes) {
+        if (coalescedBytes > maxCoalescedBytes) {
           coalescedBytes = 0;
           return kNoCoalesce;
         }
@@ -299,11 +330,13 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      cache::CacheTag tag,
       std::vector<CacheRequest*> requests)
       : CoalescedLoad(makeKeys(requests), makeSizes(requests)),
         cache_(cache),
         ioStats_(std::move(ioStats)),
-        groupId_(groupId) {
+        groupId_(groupId),
+        tag_(tag) {
     for (auto& request : requests) {
       size_ += request->size;
       requests_.push_back(std::move(*request));
@@ -334,10 +367,16 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   }
 
  protected:
-  void updateStats(const CoalesceIoStats& stats, bool isPrefetch, bool isSsd) {
+  void updateStats(
+      const CoalesceIoStats& stats,
+      bool isPrefetch,
+      bool isSsd,
+      bool isPeer = false) {
     if (ioStats_) {
       ioStats_->incRawOverreadBytes(stats.extraBytes);
-      if (isSsd) {
+      if (isPeer) {
+        ioStats_->peerRead().increment(stats.payloadBytes);
+      } else if (isSsd) {
         ioStats_->ssdRead().increment(stats.payloadBytes);
       } else {
         ioStats_->read().increment(stats.payloadBytes);
@@ -371,6 +410,7 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   std::vector<CacheRequest> requests_;
   std::shared_ptr<IoStatistics> ioStats_;
   const uint64_t groupId_;
+  const cache::CacheTag tag_;
   int64_t size_{0};
 };
 
@@ -382,11 +422,19 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<ReadFileInputStream> input,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      cache::CacheTag tag,
       std::vector<CacheRequest*> requests,
-      int32_t maxCoalesceDistance)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
+      int32_t maxCoalesceDistance,
+      StorageLatencyModel* latencyModel)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            tag,
+            std::move(requests)),
         input_(std::move(input)),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        latencyModel_(latencyModel) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<CachePin> pins;
@@ -399,10 +447,15 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             pin.checkedEntry()->setPrefetch(true);
           }
           pins.push_back(std::move(pin));
-        });
+        },
+        tag_);
     if (pins.empty()) {
       return pins;
     }
+    // With native async reads, all the coalesced reads are issued before
+    // waiting for any, so that they are in flight at the same time.
+    const bool async = input_->hasReadAsync();
+    std::vector<folly::SemiFuture<uint64_t>> reads;
     auto stats = cache::readPins(
         pins,
         maxCoalesceDistance_,
@@ -413,14 +466,45 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          input_->read(buffers, offset, LogType::FILE);
+          uint64_t bytes = 0;
+          for (const auto& buffer : buffers) {
+            bytes += buffer.size();
+          }
+          const auto startUs = getCurrentTimeMicro();
+          if (async) {
+            reads.push_back(
+                input_->readAsync(buffers, offset, LogType::FILE)
+                    .toUnsafeFuture()
+                    .thenValue([model = latencyModel_, bytes, startUs](
+                                   uint64_t size) {
+                      if (model) {
+                        model->recordRead(
+                            bytes, getCurrentTimeMicro() - startUs);
+                      }
+                      return size;
+                    })
+                    .semi());
+          } else {
+            input_->read(buffers, offset, LogType::FILE);
+            if (latencyModel_) {
+              latencyModel_->recordRead(
+                  bytes, getCurrentTimeMicro() - startUs);
+            }
+          }
         });
+    if (!reads.empty()) {
+      for (auto& result : folly::collectAll(std::move(reads)).get()) {
+        result.value();
+      }
+    }
     updateStats(stats, isPrefetch, false);
     return pins;
   }
 
   std::shared_ptr<ReadFileInputStream> input_;
   const int32_t maxCoalesceDistance_;
+  // Receives the latency of the reads if coalescing is adaptive.
+  StorageLatencyModel* const latencyModel_;
 };
 
 // Represents a CoalescedLoad from local SSD cache.
@@ -430,8 +514,14 @@ class SsdLoad : public DwioCoalescedLoadBase {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      cache::CacheTag tag,
       std::vector<CacheRequest*> requests)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)) {}
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            tag,
+            std::move(requests)) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<SsdPin> ssdPins;
@@ -445,7 +535,8 @@ class SsdLoad : public DwioCoalescedLoadBase {
           }
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
-        });
+        },
+        tag_);
     if (pins.empty()) {
       return pins;
     }
@@ -456,6 +547,83 @@ class SsdLoad : public DwioCoalescedLoadBase {
   }
 };
 
+// Represents a CoalescedLoad from the cache of other workers. Entries that
+// the owning worker does not have are read from storage.
+class PeerLoad : public DwioCoalescedLoadBase {
+ public:
+  PeerLoad(
+      cache::AsyncDataCache& cache,
+      std::shared_ptr<ReadFileInputStream> input,
+      std::shared_ptr<IoStatistics> ioStats,
+      uint64_t groupId,
+      cache::CacheTag tag,
+      std::vector<CacheRequest*> requests,
+      int32_t maxCoalesceDistance,
+      std::string fileName)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            tag,
+            std::move(requests)),
+        input_(std::move(input)),
+        maxCoalesceDistance_(maxCoalesceDistance),
+        fileName_(std::move(fileName)) {}
+
+  std::vector<CachePin> loadData(bool isPrefetch) override {
+    std::vector<CachePin> pins;
+    pins.reserve(keys_.size());
+    cache_.makePins(
+        keys_,
+        [&](int32_t index) { return sizes_[index]; },
+        [&](int32_t /*index*/, CachePin pin) {
+          if (isPrefetch) {
+            pin.checkedEntry()->setPrefetch(true);
+          }
+          pins.push_back(std::move(pin));
+        },
+        tag_);
+    if (pins.empty()) {
+      return pins;
+    }
+    auto misses = cache_.peerCache()->read(fileName_, pins);
+    CoalesceIoStats peerStats;
+    for (auto& pin : pins) {
+      peerStats.payloadBytes += pin.checkedEntry()->size();
+    }
+    if (!misses.empty()) {
+      std::vector<CachePin> storagePins;
+      storagePins.reserve(misses.size());
+      for (auto index : misses) {
+        peerStats.payloadBytes -= pins[index].checkedEntry()->size();
+        storagePins.push_back(std::move(pins[index]));
+      }
+      auto stats = cache::readPins(
+          storagePins,
+          maxCoalesceDistance_,
+          1000,
+          [&](int32_t i) { return storagePins[i].entry()->offset(); },
+          [&](const std::vector<CachePin>& /*pins*/,
+              int32_t /*begin*/,
+              int32_t /*end*/,
+              uint64_t offset,
+              const std::vector<folly::Range<char*>>& buffers) {
+            input_->read(buffers, offset, LogType::FILE);
+          });
+      updateStats(stats, isPrefetch, false);
+      for (auto i = 0; i < misses.size(); ++i) {
+        pins[misses[i]] = std::move(storagePins[i]);
+      }
+    }
+    updateStats(peerStats, isPrefetch, false, true);
+    return pins;
+  }
+
+  std::shared_ptr<ReadFileInputStream> input_;
+  const int32_t maxCoalesceDistance_;
+  const std::string fileName_;
+};
+
 } // namespace
 
 void CachedBufferedInput::readRegion(
@@ -466,10 +634,28 @@ void CachedBufferedInput::readRegion(
   }
   std::shared_ptr<cache::CoalescedLoad> load;
   if (!requests[0]->ssdPin.empty()) {
-    load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
+    load = std::make_shared<SsdLoad>(
+        *cache_, ioStats_, groupId_, cacheTag_, requests);
+  } else if (requests[0]->fromPeer) {
+    load = std::make_shared<PeerLoad>(
+        *cache_,
+        input_,
+        ioStats_,
+        groupId_,
+        cacheTag_,
+        requests,
+        maxCoalesceDistance_,
+        cache::fileIds().string(fileNum_));
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
-        *cache_, input_, ioStats_, groupId_, requests, maxCoalesceDistance_);
+        *cache_,
+        input_,
+        ioStats_,
+        groupId_,
+        cacheTag_,
+        requests,
+        coalesceDistance(),
+        latencyModel_);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
@@ -528,4 +714,31 @@ bool CachedBufferedInput::prefetch(Region region) {
   return true;
 }
 
+// static
+StorageLatencyModel* CachedBufferedInput::latencyModelFor(
+    const ReadFileInputStream& input) {
+  return FLAGS_cache_adaptive_coalesce
+      ? &StorageLatencyModel::forFile(input.getName())
+      : nullptr;
+}
+
+int32_t CachedBufferedInput::coalesceDistance() const {
+  if (latencyModel_) {
+    if (auto distance = latencyModel_->coalesceDistance()) {
+      return distance.value();
+    }
+  }
+  return maxCoalesceDistance_;
+}
+
+int64_t CachedBufferedInput::maxCoalescedBytes() const {
+  if (latencyModel_) {
+    if (auto bytes = latencyModel_->coalescedBytes()) {
+      return std::clamp<int64_t>(
+          bytes.value(), loadQuantum_, FLAGS_max_coalesced_bytes);
+    }
+  }
+  return FLAGS_max_coalesced_bytes;
+}
+
 } // namespace facebook::velox::dwio::common
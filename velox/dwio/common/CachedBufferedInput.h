@@ -25,6 +25,7 @@
 #include "velox/dwio/common/CacheInputStream.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/IoStatistics.h"
+#include "velox/dwio/common/StorageLatencyModel.h"
 #include "velox/dwio/common/Options.h"
 
 DECLARE_int32(cache_load_quantum);
@@ -44,6 +45,9 @@ struct CacheRequest {
   cache::CachePin pin;
   cache::SsdPin ssdPin;
 
+  // True if this is to be read from the PeerCache of the AsyncDataCache.
+  bool fromPeer{false};
+
   bool processed{false};
 
   // True if this should be coalesced into a CoalescedLoad with other
@@ -77,7 +81,8 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input_->getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        latencyModel_(latencyModelFor(*input_)) {}
 
   CachedBufferedInput(
       std::shared_ptr<ReadFileInputStream> input,
@@ -99,7 +104,8 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input_->getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        latencyModel_(latencyModelFor(*input_)) {}
 
   ~CachedBufferedInput() override {
     for (auto& load : allCoalescedLoads_) {
@@ -136,7 +142,7 @@ class CachedBufferedInput : public BufferedInput {
   }
 
   virtual std::unique_ptr<BufferedInput> clone() const override {
-    return std::make_unique<CachedBufferedInput>(
+    auto input = std::make_unique<CachedBufferedInput>(
         input_,
         pool_,
         fileNum_,
@@ -147,12 +153,23 @@ class CachedBufferedInput : public BufferedInput {
         executor_,
         loadQuantum_,
         maxCoalesceDistance_);
+    input->setCacheTag(cacheTag_);
+    return input;
   }
 
   cache::AsyncDataCache* FOLLY_NONNULL cache() const {
     return cache_;
   }
 
+  // Sets the tenant and priority of the cache entries created by 'this'.
+  void setCacheTag(cache::CacheTag tag) {
+    cacheTag_ = tag;
+  }
+
+  cache::CacheTag cacheTag() const {
+    return cacheTag_;
+  }
+
   // Returns the CoalescedLoad that contains the correlated loads for
   // 'stream' or nullptr if none. Returns nullptr on all but first
   // call for 'stream' since the load is to be triggered by the first
@@ -168,6 +185,10 @@ class CachedBufferedInput : public BufferedInput {
     return prefetchSize_;
   }
 
+  std::optional<uint64_t> fileNum() const override {
+    return fileNum_;
+  }
+
  private:
   // Sorts requests and makes CoalescedLoads for nearby requests. If 'prefetch'
   // is true, starts background loading.
@@ -180,12 +201,25 @@ class CachedBufferedInput : public BufferedInput {
 
   void readRegion(std::vector<CacheRequest*> requests, bool prefetch);
 
+  // Returns the model of the storage of 'input' if coalescing adapts to the
+  // storage latency, otherwise nullptr.
+  static StorageLatencyModel* FOLLY_NULLABLE
+  latencyModelFor(const ReadFileInputStream& input);
+
+  // Returns the gap up to which storage reads are coalesced. This is
+  // 'maxCoalesceDistance_' unless derived from 'latencyModel_'.
+  int32_t coalesceDistance() const;
+
+  // Returns the maximum size of a coalesced storage read.
+  int64_t maxCoalescedBytes() const;
+
   cache::AsyncDataCache* FOLLY_NONNULL cache_;
   const uint64_t fileNum_;
   std::shared_ptr<cache::ScanTracker> tracker_;
   const uint64_t groupId_;
   std::shared_ptr<IoStatistics> ioStats_;
   folly::Executor* const FOLLY_NULLABLE executor_;
+  cache::CacheTag cacheTag_;
 
   // Regions that are candidates for loading.
   std::vector<CacheRequest> requests_;
@@ -202,6 +236,7 @@ class CachedBufferedInput : public BufferedInput {
   const uint64_t fileSize_;
   const int32_t loadQuantum_;
   const int32_t maxCoalesceDistance_;
+  StorageLatencyModel* const FOLLY_NULLABLE latencyModel_;
   int64_t prefetchSize_{0};
 };
 
@@ -16,26 +16,20 @@
 
 #pragma once
 
-#include <string>
-#include <cstdint>
+#include "velox/common/compression/Compression.h"
 
 namespace facebook::velox::dwio::common {
 
-enum CompressionKind {
-  CompressionKind_NONE = 0,
-  CompressionKind_ZLIB = 1,
-  CompressionKind_SNAPPY = 2,
-  CompressionKind_LZO = 3,
-  CompressionKind_ZSTD = 4,
-  CompressionKind_LZ4 = 5,
-  CompressionKind_GZIP = 6,
-  CompressionKind_MAX = INT64_MAX
-};
-
-/**
- * Get the name of the CompressionKind.
- */
-std::string compressionKindToString(CompressionKind kind);
+using velox::common::CompressionKind;
+using velox::common::CompressionKind_GZIP;
+using velox::common::CompressionKind_LZ4;
+using velox::common::CompressionKind_LZO;
+using velox::common::CompressionKind_MAX;
+using velox::common::CompressionKind_NONE;
+using velox::common::CompressionKind_SNAPPY;
+using velox::common::CompressionKind_ZLIB;
+using velox::common::CompressionKind_ZSTD;
+using velox::common::compressionKindToString;
 
 constexpr uint64_t DEFAULT_COMPRESSION_BLOCK_SIZE = 256 * 1024;
 
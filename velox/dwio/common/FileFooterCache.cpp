@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileFooterCache.h"
+
+#include <fmt/format.h>
+
+DEFINE_int32(
+    velox_file_footer_cache_entries,
+    0,
+    "Number of parsed file footers kept by the process wide footer cache. 0 "
+    "disables the cache");
+
+namespace facebook::velox::dwio::common {
+
+// static
+FileFooterCache* FileFooterCache::instance() {
+  static auto* cache = FLAGS_velox_file_footer_cache_entries > 0
+      ? new FileFooterCache(FLAGS_velox_file_footer_cache_entries)
+      : nullptr;
+  return cache;
+}
+
+// static
+std::optional<std::string> FileFooterCache::makeKey(
+    std::string_view kind,
+    const ReadFile& file) {
+  const auto modificationTime = file.modificationTime();
+  if (!modificationTime.has_value()) {
+    return std::nullopt;
+  }
+  return fmt::format(
+      "{}:{}:{}:{}",
+      kind,
+      file.getName(),
+      modificationTime.value(),
+      file.size());
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <gflags/gflags.h>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/common/file/File.h"
+
+DECLARE_int32(velox_file_footer_cache_entries);
+
+namespace facebook::velox::dwio::common {
+
+/// Process wide LRU of parsed file footers, e.g. the DWRF Footer proto or
+/// the Parquet FileMetaData. Each split of a file is read by a new reader,
+/// which would otherwise parse the same footer again. Entries are keyed by
+/// the kind of footer, the name, modification time and size of the file.
+/// Files whose modification time is not known are not cached.
+class FileFooterCache {
+ public:
+  explicit FileFooterCache(size_t maxEntries) : cache_(maxEntries) {}
+
+  /// Returns the process wide instance or nullptr if
+  /// FLAGS_velox_file_footer_cache_entries is 0.
+  static FileFooterCache* instance();
+
+  /// Returns the key of the footer of 'kind' for 'file' or std::nullopt if
+  /// 'file' may not be cached.
+  static std::optional<std::string> makeKey(
+      std::string_view kind,
+      const ReadFile& file);
+
+  /// Returns the footer at 'key' and makes it with 'load' if not cached.
+  /// 'load' runs without holding the lock of 'this'.
+  template <typename T>
+  std::shared_ptr<const T> get(
+      const std::string& key,
+      const std::function<std::unique_ptr<T>()>& load) {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (auto footer = cache_.get(key)) {
+        return std::static_pointer_cast<const T>(footer.value());
+      }
+    }
+    std::shared_ptr<const T> footer = load();
+    std::lock_guard<std::mutex> l(mutex_);
+    // Another reader may have added the footer while 'this' was loading.
+    if (!cache_.add(key, footer)) {
+      if (auto existing = cache_.get(key)) {
+        return std::static_pointer_cast<const T>(existing.value());
+      }
+    }
+    return footer;
+  }
+
+  SimpleLRUCacheStats stats() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return cache_.getStats();
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> l(mutex_);
+    cache_.clear();
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  SimpleLRUCache<std::string, std::shared_ptr<const void>> cache_;
+};
+
+} // namespace facebook::velox::dwio::common
@@ -100,10 +100,15 @@ void IoStatistics::merge(const IoStatistics& other) {
   totalScanTime_ += other.totalScanTime_;
 
   rawOverreadBytes_ += other.rawOverreadBytes_;
+  coalesceDistance_ =
+      std::max<uint64_t>(coalesceDistance_, other.coalesceDistance_);
+  maxCoalescedBytes_ =
+      std::max<uint64_t>(maxCoalescedBytes_, other.maxCoalescedBytes_);
   prefetch_.merge(other.prefetch_);
   read_.merge(other.read_);
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
+  peerRead_.merge(other.peerRead_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
   std::lock_guard<std::mutex> l(operationStatsMutex_);
   for (auto& item : other.operationStats_) {
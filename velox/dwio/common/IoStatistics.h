@@ -91,6 +91,10 @@ class IoStatistics {
     return ssdRead_;
   }
 
+  IoCounter& peerRead() {
+    return peerRead_;
+  }
+
   IoCounter& ramHit() {
     return ramHit_;
   }
@@ -99,6 +103,21 @@ class IoStatistics {
     return queryThreadIoLatency_;
   }
 
+  /// Gap and size limits used for the last coalesced storage reads. These are
+  /// adapted to the latency of the storage if 'cache_adaptive_coalesce' is set.
+  uint64_t coalesceDistance() const {
+    return coalesceDistance_;
+  }
+
+  uint64_t maxCoalescedBytes() const {
+    return maxCoalescedBytes_;
+  }
+
+  void setCoalesceLimits(uint64_t distance, uint64_t maxBytes) {
+    coalesceDistance_ = distance;
+    maxCoalescedBytes_ = maxBytes;
+  }
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -121,6 +140,8 @@ class IoStatistics {
   std::atomic<uint64_t> outputBatchSize_{0};
   std::atomic<uint64_t> rawOverreadBytes_{0};
   std::atomic<uint64_t> totalScanTime_{0};
+  std::atomic<uint64_t> coalesceDistance_{0};
+  std::atomic<uint64_t> maxCoalescedBytes_{0};
 
   // Planned read from storage or SSD.
   IoCounter prefetch_;
@@ -135,6 +156,9 @@ class IoStatistics {
   // reads.
   IoCounter ssdRead_;
 
+  // Read from the cache of another worker instead of storage.
+  IoCounter peerRead_;
+
   // Time spent by a query processing thread waiting for synchronously
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
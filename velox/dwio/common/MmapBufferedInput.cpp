@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/common/MmapBufferedInput.h"
+
+namespace facebook::velox::dwio::common {
+
+MmapBufferedInput::MmapBufferedInput(
+    std::shared_ptr<ReadFile> readFile,
+    memory::MemoryPool& pool,
+    IoStatistics* stats)
+    : MmapBufferedInput(
+          std::make_shared<ReadFileInputStream>(
+              std::move(readFile),
+              MetricsLog::voidLog(),
+              stats),
+          pool,
+          stats) {}
+
+MmapBufferedInput::MmapBufferedInput(
+    std::shared_ptr<ReadFileInputStream> input,
+    memory::MemoryPool& pool,
+    IoStatistics* stats)
+    : BufferedInput(std::move(input), pool),
+      file_(dynamic_cast<const MmapReadFile*>(input_->getReadFile().get())),
+      stats_(stats) {
+  VELOX_CHECK_NOT_NULL(
+      file_, "MmapBufferedInput needs an MmapReadFile: {}", getName());
+}
+
+std::unique_ptr<SeekableInputStream> MmapBufferedInput::enqueue(
+    Region region,
+    const StreamIdentifier* /*si*/) {
+  if (region.length == 0) {
+    return std::make_unique<SeekableArrayInputStream>(
+        static_cast<const char*>(nullptr), 0);
+  }
+  enqueued_.push_back(region);
+  return makeStream(region.offset, region.length);
+}
+
+void MmapBufferedInput::load(const LogType /*logType*/) {
+  for (const auto& region : enqueued_) {
+    file_->prefetch(region.offset, region.length);
+    if (stats_) {
+      stats_->prefetch().increment(region.length);
+    }
+  }
+  enqueued_.clear();
+}
+
+std::unique_ptr<SeekableInputStream> MmapBufferedInput::read(
+    uint64_t offset,
+    uint64_t length,
+    LogType /*logType*/) const {
+  return makeStream(offset, length);
+}
+
+std::unique_ptr<BufferedInput> MmapBufferedInput::clone() const {
+  return std::unique_ptr<MmapBufferedInput>(
+      new MmapBufferedInput(input_, pool_, stats_));
+}
+
+std::unique_ptr<SeekableInputStream> MmapBufferedInput::makeStream(
+    uint64_t offset,
+    uint64_t length) const {
+  const auto data = file_->view(offset, length);
+  if (stats_) {
+    stats_->incRawBytesRead(length);
+  }
+  return std::make_unique<SeekableArrayInputStream>(data.data(), data.size());
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "velox/common/file/File.h"
+#include "velox/dwio/common/BufferedInput.h"
+
+namespace facebook::velox::dwio::common {
+
+/// BufferedInput over an MmapReadFile. The streams read the mapped file in
+/// place instead of copying it to buffers, so that data that is in the page
+/// cache is not also held in AsyncDataCache. load() advises the kernel to
+/// read ahead the enqueued regions.
+class MmapBufferedInput : public BufferedInput {
+ public:
+  MmapBufferedInput(
+      std::shared_ptr<ReadFile> readFile,
+      memory::MemoryPool& pool,
+      IoStatistics* FOLLY_NULLABLE stats = nullptr);
+
+  std::unique_ptr<SeekableInputStream> enqueue(
+      Region region,
+      const StreamIdentifier* FOLLY_NULLABLE si = nullptr) override;
+
+  void load(const LogType) override;
+
+  bool isBuffered(uint64_t /*offset*/, uint64_t /*length*/) const override {
+    return true;
+  }
+
+  std::unique_ptr<SeekableInputStream>
+  read(uint64_t offset, uint64_t length, LogType logType) const override;
+
+  std::unique_ptr<BufferedInput> clone() const override;
+
+ private:
+  MmapBufferedInput(
+      std::shared_ptr<ReadFileInputStream> input,
+      memory::MemoryPool& pool,
+      IoStatistics* FOLLY_NULLABLE stats);
+
+  std::unique_ptr<SeekableInputStream> makeStream(
+      uint64_t offset,
+      uint64_t length) const;
+
+  const MmapReadFile* const file_;
+  IoStatistics* const FOLLY_NULLABLE stats_;
+  // Regions enqueued since the last load().
+  std::vector<Region> enqueued_;
+};
+
+} // namespace facebook::velox::dwio::common
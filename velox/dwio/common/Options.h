@@ -103,6 +103,9 @@ class RowReaderOptions {
   // operations.
   std::shared_ptr<folly::Executor> decodingExecutor_;
   std::shared_ptr<folly::Executor> ioExecutor_;
+  // Minimum number of rows in a batch for reading the columns without filter
+  // in parallel on 'decodingExecutor_'.
+  int32_t minRowsForParallelDecoding_ = 4'096;
   bool appendRowNumberColumn_ = false;
   // Function to populate metrics related to feature projection stats
   // in Koski. This gets fired in FlatMapColumnReader.
@@ -268,6 +271,10 @@ class RowReaderOptions {
     decodingExecutor_ = executor;
   }
 
+  void setMinRowsForParallelDecoding(int32_t minRows) {
+    minRowsForParallelDecoding_ = minRows;
+  }
+
   void setIOExecutor(std::shared_ptr<folly::Executor> executor) {
     ioExecutor_ = executor;
   }
@@ -303,6 +310,10 @@ class RowReaderOptions {
     return decodingExecutor_;
   }
 
+  int32_t getMinRowsForParallelDecoding() const {
+    return minRowsForParallelDecoding_;
+  }
+
   const std::shared_ptr<folly::Executor>& getIOExecutor() const {
     return ioExecutor_;
   }
@@ -155,6 +155,16 @@ class Reader {
    */
   virtual std::unique_ptr<RowReader> createRowReader(
       const RowReaderOptions& options = {}) const = 0;
+
+  /**
+   * Get the byte ranges of the units of the file that a row reader reads
+   * whole, i.e. the stripes or row groups, in file order. A row reader for a
+   * range of the file reads the units whose offset is in the range.
+   * @return the ranges or an empty vector if the format does not tell
+   */
+  virtual std::vector<Region> readUnits() const {
+    return {};
+  }
 };
 
 } // namespace facebook::velox::dwio::common
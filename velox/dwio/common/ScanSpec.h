@@ -45,12 +45,24 @@ class ScanSpec {
   static constexpr const char* kArrayElementsFieldName = "elements";
 
   explicit ScanSpec(const Subfield::PathElement& element) {
-    if (element.kind() == kNestedField) {
-      auto field = reinterpret_cast<const Subfield::NestedField*>(&element);
-      fieldName_ = field->name();
-
-    } else {
-      VELOX_CHECK(false, "Only nested fields are supported");
+    switch (element.kind()) {
+      case kNestedField:
+        fieldName_ =
+            reinterpret_cast<const Subfield::NestedField*>(&element)->name();
+        break;
+      // A map subscript, e.g. for a filter on m['k'], is named by its key.
+      case kStringSubscript:
+        fieldName_ =
+            reinterpret_cast<const Subfield::StringSubscript*>(&element)
+                ->index();
+        break;
+      case kLongSubscript:
+        fieldName_ = std::to_string(
+            reinterpret_cast<const Subfield::LongSubscript*>(&element)
+                ->index());
+        break;
+      default:
+        VELOX_CHECK(false, "Only nested fields and subscripts are supported");
     }
   }
 
@@ -215,8 +227,10 @@ class ScanSpec {
         return fieldName_ ==
             reinterpret_cast<const Subfield::NestedField*>(&element)->name();
       case kLongSubscript:
-        return subscript_ ==
-            reinterpret_cast<const Subfield::LongSubscript*>(&element)->index();
+        return fieldName_ ==
+            std::to_string(
+                   reinterpret_cast<const Subfield::LongSubscript*>(&element)
+                       ->index());
       case kStringSubscript:
         return fieldName_ ==
             reinterpret_cast<const Subfield::StringSubscript*>(&element)
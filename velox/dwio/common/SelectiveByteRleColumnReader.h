@@ -140,6 +140,12 @@ void SelectiveByteRleColumnReader::processValueHook(
           rows,
           dwio::common::ExtractToHook<SumHook<int64_t, int64_t>>(hook));
       break;
+    case aggregate::AggregationHook::kCount:
+      readHelper<Reader, velox::common::AlwaysTrue, isDense>(
+          &dwio::common::alwaysTrue(),
+          rows,
+          dwio::common::ExtractToHook<CountHook>(hook));
+      break;
     default:
       readHelper<Reader, velox::common::AlwaysTrue, isDense>(
           &dwio::common::alwaysTrue(),
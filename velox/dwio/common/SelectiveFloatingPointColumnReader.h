@@ -111,6 +111,10 @@ void SelectiveFloatingPointColumnReader<TData, TRequested>::processFilter(
       readHelper<Reader, velox::common::FloatingPointRange<TData>, isDense>(
           filter, rows, extractValues);
       break;
+    case velox::common::FilterKind::kMultiRange:
+      readHelper<Reader, velox::common::MultiRange, isDense>(
+          filter, rows, extractValues);
+      break;
     default:
       readHelper<Reader, velox::common::Filter, isDense>(
           filter, rows, extractValues);
@@ -150,6 +154,10 @@ void SelectiveFloatingPointColumnReader<TData, TRequested>::processValueHook(
           rows,
           ExtractToHook<aggregate::MinMaxHook<TRequested, true>>(hook));
       break;
+    case aggregate::AggregationHook::kCount:
+      readHelper<Reader, velox::common::AlwaysTrue, isDense>(
+          &alwaysTrue(), rows, ExtractToHook<aggregate::CountHook>(hook));
+      break;
     default:
       readHelper<Reader, velox::common::AlwaysTrue, isDense>(
           &alwaysTrue(), rows, ExtractToGenericHook(hook));
@@ -206,7 +206,19 @@ SelectiveMapColumnReader::SelectiveMapColumnReader(
     FormatParams& params,
     velox::common::ScanSpec& scanSpec)
     : SelectiveRepeatedColumnReader(dataType, params, scanSpec, dataType->type),
-      requestedType_{requestedType} {}
+      requestedType_{requestedType} {
+  // Filters on the values of given keys are only evaluated by readers that
+  // store each key separately, i.e. DWRF flat maps.
+  for (auto& child : scanSpec.children()) {
+    VELOX_CHECK(
+        child->fieldName() == velox::common::ScanSpec::kMapKeysFieldName ||
+            child->fieldName() ==
+                velox::common::ScanSpec::kMapValuesFieldName ||
+            !child->hasFilter(),
+        "Filter on map subscript {} is only supported for flat maps",
+        child->fieldName());
+  }
+}
 
 uint64_t SelectiveMapColumnReader::skip(uint64_t numValues) {
   numValues = formatData_->skipNulls(numValues);
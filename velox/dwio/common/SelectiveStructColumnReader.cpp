@@ -16,6 +16,7 @@
 
 #include "velox/dwio/common/SelectiveStructColumnReader.h"
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/ColumnLoader.h"
 
 namespace facebook::velox::dwio::common {
@@ -129,6 +130,10 @@ void SelectiveStructColumnReaderBase::read(
   }
 
   VELOX_CHECK(!children_.empty());
+  // Children without filter that are read in parallel after the filters.
+  std::vector<SelectiveColumnReader*> parallelReaders;
+  const bool parallel = decodingExecutor_ &&
+      activeRows.size() >= minRowsForParallelDecoding_;
   auto& childSpecs = scanSpec_->children();
   for (size_t i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
@@ -159,10 +164,15 @@ void SelectiveStructColumnReaderBase::read(
       if (activeRows.empty()) {
         break;
       }
+    } else if (parallel) {
+      parallelReaders.push_back(reader);
     } else {
       reader->read(offset, activeRows, structNulls);
     }
   }
+  if (!activeRows.empty() && !parallelReaders.empty()) {
+    readInParallel(parallelReaders, offset, activeRows, structNulls);
+  }
   // If this adds nulls, the field readers will miss a value for each null added
   // here.
   recordParentNullsInChildren(offset, rows);
@@ -174,6 +184,42 @@ void SelectiveStructColumnReaderBase::read(
   readOffset_ = offset + rows.back() + 1;
 }
 
+void SelectiveStructColumnReaderBase::readInParallel(
+    const std::vector<SelectiveColumnReader*>& readers,
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* structNulls) {
+  std::vector<std::shared_ptr<AsyncSource<bool>>> reads;
+  reads.reserve(readers.size());
+  for (auto* reader : readers) {
+    reads.push_back(std::make_shared<AsyncSource<bool>>(
+        [reader, offset, rows, structNulls]() {
+          reader->read(offset, rows, structNulls);
+          return std::make_unique<bool>(true);
+        }));
+  }
+  // The last read is left for this thread, which also picks up the reads the
+  // executor has not started when it gets to them.
+  for (auto i = 0; i + 1 < reads.size(); ++i) {
+    decodingExecutor_->add([read = reads[i]]() { read->prepare(); });
+  }
+  // All reads must finish before returning, also on error, since they
+  // reference the rows and nulls of 'this'.
+  std::exception_ptr error;
+  for (auto& read : reads) {
+    try {
+      read->move();
+    } catch (const std::exception&) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 void SelectiveStructColumnReaderBase::recordParentNullsInChildren(
     vector_size_t offset,
     RowSet rows) {
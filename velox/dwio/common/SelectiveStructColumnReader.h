@@ -18,6 +18,8 @@
 
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
 
+#include <folly/Executor.h>
+
 namespace facebook::velox::dwio::common {
 
 class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
@@ -95,6 +97,20 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
     return debugString_;
   }
 
+  /// Reads the children without filter in parallel on 'executor' once the
+  /// filters of a batch of at least 'minRows' rows are evaluated. Applies
+  /// also to the struct children of 'this'.
+  void setDecodingExecutor(folly::Executor* executor, int32_t minRows) {
+    decodingExecutor_ = executor;
+    minRowsForParallelDecoding_ = minRows;
+    for (auto* child : children_) {
+      if (auto* structChild =
+              dynamic_cast<SelectiveStructColumnReaderBase*>(child)) {
+        structChild->setDecodingExecutor(executor, minRows);
+      }
+    }
+  }
+
  protected:
   SelectiveStructColumnReaderBase(
       const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
@@ -112,6 +128,13 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // know how much to skip when seeking forward within the row group.
   void recordParentNullsInChildren(vector_size_t offset, RowSet rows);
 
+  // Reads 'readers' at 'rows' on 'decodingExecutor_' and the calling thread.
+  void readInParallel(
+      const std::vector<SelectiveColumnReader*>& readers,
+      vector_size_t offset,
+      RowSet rows,
+      const uint64_t* structNulls);
+
   bool hasMutation() const override {
     return hasMutation_;
   }
@@ -141,6 +164,9 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // and query. Set at construction, which takes place on first
   // use. If no ExceptionContext is in effect, this is "".
   const std::string debugString_;
+
+  folly::Executor* decodingExecutor_{nullptr};
+  int32_t minRowsForParallelDecoding_{0};
 };
 
 struct SelectiveStructColumnReader : SelectiveStructColumnReaderBase {
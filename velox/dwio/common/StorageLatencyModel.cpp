@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/StorageLatencyModel.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::velox::dwio::common {
+
+// static
+StorageLatencyModel& StorageLatencyModel::forFile(std::string_view fileName) {
+  static folly::Synchronized<folly::F14FastMap<
+      std::string,
+      std::unique_ptr<StorageLatencyModel>>>
+      models;
+  const auto schemeEnd = fileName.find("://");
+  const std::string scheme(
+      schemeEnd == std::string_view::npos ? "" : fileName.substr(0, schemeEnd));
+  {
+    auto rlock = models.rlock();
+    auto it = rlock->find(scheme);
+    if (it != rlock->end()) {
+      return *it->second;
+    }
+  }
+  auto wlock = models.wlock();
+  auto& model = (*wlock)[scheme];
+  if (!model) {
+    model = std::make_unique<StorageLatencyModel>();
+  }
+  return *model;
+}
+
+void StorageLatencyModel::recordRead(uint64_t bytes, uint64_t micros) {
+  const double x = bytes;
+  const double y = micros;
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numReads_;
+  n_ = n_ * kDecay + 1;
+  sumBytes_ = sumBytes_ * kDecay + x;
+  sumMicros_ = sumMicros_ * kDecay + y;
+  sumBytesMicros_ = sumBytesMicros_ * kDecay + x * y;
+  sumBytesSquared_ = sumBytesSquared_ * kDecay + x * x;
+}
+
+std::optional<std::pair<double, double>> StorageLatencyModel::fit() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (numReads_ < kMinSamples) {
+    return std::nullopt;
+  }
+  const double denominator = n_ * sumBytesSquared_ - sumBytes_ * sumBytes_;
+  if (denominator <= 0) {
+    // All reads of the same size.
+    return std::nullopt;
+  }
+  const double slope =
+      (n_ * sumBytesMicros_ - sumBytes_ * sumMicros_) / denominator;
+  if (slope <= 0) {
+    return std::nullopt;
+  }
+  const double latency = std::max(0.0, (sumMicros_ - slope * sumBytes_) / n_);
+  return std::make_pair(latency, 1 / slope);
+}
+
+std::optional<int32_t> StorageLatencyModel::coalesceDistance() const {
+  const auto model = fit();
+  if (!model.has_value()) {
+    return std::nullopt;
+  }
+  const auto [latency, throughput] = *model;
+  return std::min<double>(kMaxDistance, latency * throughput);
+}
+
+std::optional<int64_t> StorageLatencyModel::coalescedBytes() const {
+  const auto distance = coalesceDistance();
+  if (!distance.has_value()) {
+    return std::nullopt;
+  }
+  return kOverheadRatio * distance.value();
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+namespace facebook::velox::dwio::common {
+
+/// Linear model of the time of a read from a storage system as a fixed
+/// latency plus the bytes over a throughput, fitted to observed reads. From
+/// this follows the gap below which reading the gap is cheaper than a separate
+/// read and the read size above which the fixed latency is a small part of
+/// the time of a read. Older samples decay so that the model follows changes
+/// in load.
+class StorageLatencyModel {
+ public:
+  /// Number of reads before the model gives estimates.
+  static constexpr int32_t kMinSamples = 20;
+
+  /// Returns the process wide model for the storage of 'fileName', i.e. one
+  /// per scheme like 's3://' or 'hdfs://'. Names without a scheme share the
+  /// model of local files.
+  static StorageLatencyModel& forFile(std::string_view fileName);
+
+  void recordRead(uint64_t bytes, uint64_t micros);
+
+  /// Returns the largest gap between two ranges that should be read in one
+  /// request or std::nullopt if there are not enough samples.
+  std::optional<int32_t> coalesceDistance() const;
+
+  /// Returns the size of a read at which the fixed latency is 1/8 of its
+  /// time or std::nullopt if there are not enough samples.
+  std::optional<int64_t> coalescedBytes() const;
+
+ private:
+  static constexpr double kDecay = 0.99;
+  static constexpr int32_t kMaxDistance = 16 << 20;
+  static constexpr int64_t kOverheadRatio = 8;
+
+  // Returns the latency in us and the throughput in bytes per us, if known.
+  std::optional<std::pair<double, double>> fit() const;
+
+  mutable std::mutex mutex_;
+  int64_t numReads_{0};
+  // Decayed sums for a least squares fit of micros over bytes.
+  double n_{0};
+  double sumBytes_{0};
+  double sumMicros_{0};
+  double sumBytesMicros_{0};
+  double sumBytesSquared_{0};
+};
+
+} // namespace facebook::velox::dwio::common
@@ -49,6 +49,21 @@ class Writer {
    */
   virtual void flush() = 0;
 
+  /**
+   * Returns an estimate of the memory in bytes that reclaim() releases.
+   * Returns 0 if there is nothing to reclaim or the writer is not
+   * reclaimable.
+   */
+  virtual uint64_t reclaimableBytes() const {
+    return 0;
+  }
+
+  /**
+   * Writes out the buffered data, e.g. the open stripe or row group, to
+   * release its memory under memory pressure. Does not close the writer.
+   */
+  virtual void reclaim() {}
+
   /**
    *  Invokes flush and closes the writer.
    *  Data can no longer be written.
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileFooterCache.h"
+#include "velox/exec/tests/utils/TempFilePath.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::dwio::common {
+
+TEST(FileFooterCacheTest, makeKey) {
+  InMemoryReadFile inMemory(std::string("footer"));
+  EXPECT_FALSE(FileFooterCache::makeKey("dwrf", inMemory).has_value());
+
+  auto tempFile = TempFilePath::create();
+  tempFile->append("footer");
+  LocalReadFile file(tempFile->path);
+  ASSERT_TRUE(file.modificationTime().has_value());
+  auto key = FileFooterCache::makeKey("dwrf", file);
+  ASSERT_TRUE(key.has_value());
+  EXPECT_EQ(key, FileFooterCache::makeKey("dwrf", file));
+  EXPECT_NE(key, FileFooterCache::makeKey("parquet", file));
+
+  // A file rewritten at the same path gets a different key.
+  tempFile->append("more");
+  LocalReadFile rewritten(tempFile->path);
+  EXPECT_NE(key, FileFooterCache::makeKey("dwrf", rewritten));
+}
+
+TEST(FileFooterCacheTest, get) {
+  FileFooterCache cache(2);
+  int32_t numLoads = 0;
+  auto load = [&](int32_t value) {
+    return [&numLoads, value]() {
+      ++numLoads;
+      return std::make_unique<int32_t>(value);
+    };
+  };
+  auto first = cache.get<int32_t>("a", load(1));
+  auto second = cache.get<int32_t>("a", load(2));
+  EXPECT_EQ(1, numLoads);
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(1, *second);
+
+  cache.get<int32_t>("b", load(3));
+  cache.get<int32_t>("c", load(4));
+  EXPECT_EQ(3, numLoads);
+  EXPECT_EQ(2, cache.stats().curSize);
+  // "a" is the least recently used and was evicted.
+  EXPECT_EQ(5, *cache.get<int32_t>("a", load(5)));
+  EXPECT_EQ(4, numLoads);
+  // The evicted footer is still live for its readers.
+  EXPECT_EQ(1, *first);
+
+  cache.clear();
+  EXPECT_EQ(0, cache.stats().curSize);
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/common/StorageLatencyModel.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::dwio::common;
+
+TEST(StorageLatencyModelTest, noEstimateBeforeMinSamples) {
+  StorageLatencyModel model;
+  for (auto i = 0; i < StorageLatencyModel::kMinSamples - 1; ++i) {
+    model.recordRead(1 << 20, 1'000 + i);
+  }
+  EXPECT_FALSE(model.coalesceDistance().has_value());
+  EXPECT_FALSE(model.coalescedBytes().has_value());
+}
+
+TEST(StorageLatencyModelTest, fit) {
+  // 10ms of latency and 100 bytes per us.
+  StorageLatencyModel model;
+  for (auto i = 0; i < 100; ++i) {
+    const uint64_t bytes = (i % 10 + 1) * 100'000;
+    model.recordRead(bytes, 10'000 + bytes / 100);
+  }
+  EXPECT_NEAR(model.coalesceDistance().value(), 1'000'000, 1'000);
+  EXPECT_NEAR(model.coalescedBytes().value(), 8'000'000, 8'000);
+}
+
+TEST(StorageLatencyModelTest, forFile) {
+  auto& s3 = StorageLatencyModel::forFile("s3://bucket/a");
+  EXPECT_EQ(&s3, &StorageLatencyModel::forFile("s3://other/b"));
+  EXPECT_NE(&s3, &StorageLatencyModel::forFile("hdfs://host/a"));
+  EXPECT_EQ(
+      &StorageLatencyModel::forFile("/tmp/a"),
+      &StorageLatencyModel::forFile("file:/tmp/b"));
+}
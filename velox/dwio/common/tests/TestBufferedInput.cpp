@@ -17,6 +17,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/MmapBufferedInput.h"
+#include "velox/exec/tests/utils/TempFilePath.h"
 
 using namespace facebook::velox::dwio::common;
 using namespace ::testing;
@@ -345,3 +347,34 @@ TEST(TestBufferedInput, VReadSortingWithLabels) {
     EXPECT_EQ(next.value(), r.second);
   }
 }
+
+TEST(TestBufferedInput, mmap) {
+  std::string content = "aaabbbcccdddeeefffggghhhiiijjjkkklllmmmnnnooopppqqq";
+  auto tempFile = facebook::velox::exec::test::TempFilePath::create();
+  tempFile->append(content);
+  auto file = std::make_shared<facebook::velox::MmapReadFile>(tempFile->path);
+  auto pool = facebook::velox::memory::addDefaultLeafMemoryPool();
+  IoStatistics stats;
+  MmapBufferedInput input(file, *pool, &stats);
+
+  auto first = input.enqueue({3, 6});
+  auto second = input.enqueue({30, 9});
+  input.load(LogType::TEST);
+  EXPECT_EQ(stats.prefetch().sum(), 15);
+
+  // The streams point into the mapping.
+  const void* buf = nullptr;
+  int32_t size;
+  ASSERT_TRUE(first->Next(&buf, &size));
+  EXPECT_EQ(buf, file->view(3, 6).data());
+  EXPECT_EQ(std::string(static_cast<const char*>(buf), size), "bbbccc");
+  EXPECT_EQ(getNext(*second).value(), content.substr(30, 9));
+
+  EXPECT_TRUE(input.isBuffered(40, 5));
+  auto unplanned = input.read(40, 5, LogType::TEST);
+  EXPECT_EQ(getNext(*unplanned).value(), content.substr(40, 5));
+  EXPECT_EQ(getNext(*input.clone()->read(0, 3, LogType::TEST)).value(), "aaa");
+
+  EXPECT_THROW(
+      input.read(50, 10, LogType::TEST), facebook::velox::VeloxException);
+}
@@ -438,7 +438,8 @@ std::unique_ptr<BufferedOutputStream> createCompressor(
     CompressionBufferPool& bufferPool,
     DataBufferHolder& bufferHolder,
     const Config& config,
-    const Encrypter* encrypter) {
+    const Encrypter* encrypter,
+    folly::Executor* executor) {
   std::unique_ptr<Compressor> compressor;
   switch (static_cast<int64_t>(kind)) {
     case dwio::common::CompressionKind_NONE:
@@ -470,7 +471,12 @@ std::unique_ptr<BufferedOutputStream> createCompressor(
       DWIO_RAISE("compression codec");
   }
   return std::make_unique<PagedOutputStream>(
-      bufferPool, bufferHolder, config, std::move(compressor), encrypter);
+      bufferPool,
+      bufferHolder,
+      config,
+      std::move(compressor),
+      encrypter,
+      executor);
 }
 
 std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
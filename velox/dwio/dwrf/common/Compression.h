@@ -25,6 +25,8 @@
 #include "velox/dwio/dwrf/common/Encryption.h"
 #include "velox/dwio/dwrf/common/OutputStream.h"
 
+#include <folly/Executor.h>
+
 namespace facebook::velox::dwrf {
 
 constexpr uint8_t PAGE_HEADER_SIZE = 3;
@@ -87,12 +89,14 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
  * @param bufferHolder buffer holder that handles buffer allocation and
  * collection
  * @param level compression level
+ * @param executor if set, full pages are compressed on this executor
  */
 std::unique_ptr<BufferedOutputStream> createCompressor(
     dwio::common::CompressionKind kind,
     CompressionBufferPool& bufferPool,
     DataBufferHolder& bufferHolder,
     const Config& config,
-    const dwio::common::encryption::Encrypter* encrypter = nullptr);
+    const dwio::common::encryption::Encrypter* encrypter = nullptr,
+    folly::Executor* executor = nullptr);
 
 } // namespace facebook::velox::dwrf
@@ -184,6 +184,27 @@ Config::Entry<uint32_t> Config::MAP_FLAT_MAX_KEYS(
     "orc.map.flat.max.keys",
     20000);
 
+Config::Entry<const std::vector<uint32_t>> Config::BLOOM_FILTER_COLUMNS(
+    "orc.bloom.filter.columns",
+    {},
+    [](const std::vector<uint32_t>& val) { return folly::join(",", val); },
+    [](const std::string& /* key */, const std::string& val) {
+      std::vector<uint32_t> result;
+      if (!val.empty()) {
+        std::vector<folly::StringPiece> pieces;
+        folly::split(',', val, pieces, true);
+        for (auto& p : pieces) {
+          const auto& trimmedCol = folly::trimWhitespace(p);
+          if (!trimmedCol.empty()) {
+            result.push_back(folly::to<uint32_t>(trimmedCol));
+          }
+        }
+      }
+      return result;
+    });
+
+Config::Entry<float> Config::BLOOM_FILTER_FPP("orc.bloom.filter.fpp", 0.05f);
+
 Config::Entry<uint64_t> Config::MAX_DICTIONARY_SIZE(
     "hive.exec.orc.max.dictionary.size",
     80L * 1024L * 1024L);
@@ -60,6 +60,9 @@ class Config : public common::ConfigBase<Config> {
   static Entry<const std::vector<std::vector<std::string>>>
       MAP_FLAT_COLS_STRUCT_KEYS;
   static Entry<uint32_t> MAP_FLAT_MAX_KEYS;
+  // Top level columns to write bloom filters for, per row index stride.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLUMNS;
+  static Entry<float> BLOOM_FILTER_FPP;
   static Entry<uint64_t> MAX_DICTIONARY_SIZE;
   static Entry<uint64_t> STRIPE_SIZE;
   // With this config, we don't even try the more memory intensive encodings
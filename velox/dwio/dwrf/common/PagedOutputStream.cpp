@@ -24,29 +24,14 @@ std::vector<folly::StringPiece> PagedOutputStream::createPage() {
   DWIO_ENSURE_GT(origSize, PAGE_HEADER_SIZE);
   origSize -= PAGE_HEADER_SIZE;
 
-  auto compressedSize = origSize;
   // apply compressoin if there is compressor and original data size exceeds
   // threshold
+  char* output = nullptr;
   if (compressor_ && origSize >= threshold_) {
     compressionBuffer_ = pool_.getBuffer(buffer_.size());
-    compressedSize = compressor_->compress(
-        buffer_.data() + PAGE_HEADER_SIZE,
-        compressionBuffer_->data() + PAGE_HEADER_SIZE,
-        origSize);
-  }
-
-  folly::StringPiece compressed;
-  if (compressedSize >= origSize) {
-    // write orig
-    writeHeader(buffer_.data(), origSize, true);
-    compressed =
-        folly::StringPiece(buffer_.data(), origSize + PAGE_HEADER_SIZE);
-  } else {
-    // write compressed
-    writeHeader(compressionBuffer_->data(), compressedSize, false);
-    compressed = folly::StringPiece(
-        compressionBuffer_->data(), compressedSize + PAGE_HEADER_SIZE);
+    output = compressionBuffer_->data();
   }
+  auto compressed = writePage(buffer_.data(), origSize, output);
 
   if (!encrypter_) {
     return {compressed};
@@ -63,6 +48,69 @@ std::vector<folly::StringPiece> PagedOutputStream::createPage() {
           encryptionBuffer_->length())};
 }
 
+folly::StringPiece
+PagedOutputStream::writePage(char* input, uint64_t size, char* output) {
+  auto compressedSize = size;
+  if (output) {
+    compressedSize = compressor_->compress(
+        input + PAGE_HEADER_SIZE, output + PAGE_HEADER_SIZE, size);
+  }
+  if (compressedSize >= size) {
+    // write orig
+    writeHeader(input, size, true);
+    return folly::StringPiece(input, size + PAGE_HEADER_SIZE);
+  }
+  // write compressed
+  writeHeader(output, compressedSize, false);
+  return folly::StringPiece(output, compressedSize + PAGE_HEADER_SIZE);
+}
+
+void PagedOutputStream::compressAsync() {
+  finishPendingPage();
+  auto& memoryPool = bufferHolder_.getMemoryPool();
+  const auto size = buffer_.size();
+  DWIO_ENSURE_GT(size, PAGE_HEADER_SIZE);
+  pendingInput_ =
+      std::make_unique<dwio::common::DataBuffer<char>>(memoryPool, size);
+  std::memcpy(pendingInput_->data(), buffer_.data(), size);
+  pendingSize_ = size - PAGE_HEADER_SIZE;
+  if (pendingSize_ >= threshold_) {
+    pendingOutput_ =
+        std::make_unique<dwio::common::DataBuffer<char>>(memoryPool, size);
+  }
+  pendingPage_ = std::make_shared<AsyncSource<folly::StringPiece>>([this]() {
+    return std::make_unique<folly::StringPiece>(writePage(
+        pendingInput_->data(),
+        pendingSize_,
+        pendingOutput_ ? pendingOutput_->data() : nullptr));
+  });
+  executor_->add([page = pendingPage_]() { page->prepare(); });
+}
+
+void PagedOutputStream::finishPendingPage() const {
+  if (!pendingPage_) {
+    return;
+  }
+  auto page = std::move(pendingPage_);
+  auto compressed = page->move();
+  DWIO_ENSURE_NOT_NULL(compressed);
+  bufferHolder_.take(*compressed);
+  pendingInput_.reset();
+  pendingOutput_.reset();
+  pendingSize_ = 0;
+}
+
+PagedOutputStream::~PagedOutputStream() {
+  // The compression on 'executor_' references 'this'.
+  if (pendingPage_) {
+    try {
+      pendingPage_->move();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Error compressing page: " << e.what();
+    }
+  }
+}
+
 void PagedOutputStream::writeHeader(
     char* buffer,
     size_t compressedSize,
@@ -89,8 +137,9 @@ void PagedOutputStream::resetBuffers() {
 }
 
 uint64_t PagedOutputStream::flush() {
-  auto size = buffer_.size();
   auto originalSize = bufferHolder_.size();
+  finishPendingPage();
+  auto size = buffer_.size();
   if (size > PAGE_HEADER_SIZE) {
     bufferHolder_.take(createPage());
     resetBuffers();
@@ -109,8 +158,13 @@ void PagedOutputStream::BackUp(int32_t count) {
 
 bool PagedOutputStream::Next(void** data, int32_t* size, uint64_t increment) {
   if (!tryResize(data, size, PAGE_HEADER_SIZE, increment)) {
-    flushAndReset(data, size, PAGE_HEADER_SIZE, createPage());
-    resetBuffers();
+    if (executor_) {
+      compressAsync();
+      flushAndReset(data, size, PAGE_HEADER_SIZE, {});
+    } else {
+      flushAndReset(data, size, PAGE_HEADER_SIZE, createPage());
+      resetBuffers();
+    }
   }
   return true;
 }
@@ -120,6 +174,8 @@ void PagedOutputStream::recordPosition(
     int32_t bufferLength,
     int32_t bufferOffset,
     int32_t strideOffset) const {
+  // The position is in terms of compressed pages.
+  finishPendingPage();
   // add compressed size, then uncompressed
   recorder.add(bufferHolder_.size(), strideOffset);
   auto size = buffer_.size();
@@ -16,33 +16,45 @@
 
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 
+#include <folly/Executor.h>
+
 namespace facebook::velox::dwrf {
 
 class PagedOutputStream : public BufferedOutputStream {
  public:
+  // If 'executor' is set, full pages of a compressed, unencrypted stream are
+  // compressed on 'executor' while the next page is filled. At most one page
+  // per stream is in flight, so pages are added to 'bufferHolder' in order
+  // and 'compressor' is not used concurrently.
   PagedOutputStream(
       CompressionBufferPool& pool,
       DataBufferHolder& bufferHolder,
       const Config& config,
       std::unique_ptr<Compressor> compressor,
-      const dwio::common::encryption::Encrypter* encrypter)
+      const dwio::common::encryption::Encrypter* encrypter,
+      folly::Executor* executor = nullptr)
       : BufferedOutputStream(bufferHolder),
         pool_{pool},
         compressor_{std::move(compressor)},
         encrypter_{encrypter},
-        threshold_{config.get(Config::COMPRESSION_THRESHOLD)} {
+        threshold_{config.get(Config::COMPRESSION_THRESHOLD)},
+        executor_{compressor_ && !encrypter_ ? executor : nullptr} {
     DWIO_ENSURE(compressor_ || encrypter_, "invalid paged output stream");
   }
 
+  ~PagedOutputStream() override;
+
   bool Next(void** data, int32_t* size, uint64_t increment) override;
 
   uint64_t flush() override;
 
   uint64_t size() const override {
-    // only care about compressed size
-    return bufferHolder_.size();
+    // only care about compressed size. A page being compressed counts with
+    // its original size.
+    return bufferHolder_.size() + pendingSize_;
   }
 
   void BackUp(int32_t count) override;
@@ -61,6 +73,17 @@ class PagedOutputStream : public BufferedOutputStream {
   // create page using compressor and encrypter
   std::vector<folly::StringPiece> createPage();
 
+  // Writes the header of the page of 'size' bytes after the header at
+  // 'input'. Compresses the page into 'output' first if 'output' is set.
+  // Returns the page to write with its header.
+  folly::StringPiece writePage(char* input, uint64_t size, char* output);
+
+  // Starts compressing a copy of 'buffer_' on 'executor_'.
+  void compressAsync();
+
+  // Waits for the page being compressed and adds it to 'bufferHolder_'.
+  void finishPendingPage() const;
+
   void writeHeader(char* buffer, size_t compressedSize, bool original);
 
   void updateSize(char* buffer, size_t compressedSize);
@@ -82,6 +105,15 @@ class PagedOutputStream : public BufferedOutputStream {
 
   // threshold below which, we skip compression
   uint32_t threshold_;
+
+  folly::Executor* const executor_;
+
+  // Page being compressed on 'executor_', its input and output buffers and
+  // its original size.
+  mutable std::shared_ptr<AsyncSource<folly::StringPiece>> pendingPage_;
+  mutable std::unique_ptr<dwio::common::DataBuffer<char>> pendingInput_;
+  mutable std::unique_ptr<dwio::common::DataBuffer<char>> pendingOutput_;
+  mutable uint64_t pendingSize_{0};
 };
 
 } // namespace facebook::velox::dwrf
@@ -174,15 +174,65 @@ template void RleDecoderV2<false>::seekToRowGroup(
 
 template <bool isSigned>
 void RleDecoderV2<isSigned>::skip(uint64_t numValues) {
-  // simple for now, until perf tests indicate something encoding specific is
-  // needed
-  const uint64_t N = 64;
-  int64_t dummy[N];
-
-  while (numValues) {
-    uint64_t nRead = std::min(N, numValues);
-    next(dummy, nRead, nullptr);
-    numValues -= nRead;
+  constexpr uint64_t kBatchSize = 64;
+  int64_t dummy[kBatchSize];
+
+  while (numValues > 0) {
+    const bool newRun = runRead == runLength;
+    if (newRun) {
+      resetRun();
+      firstByte = readByte();
+    }
+    const auto enc = static_cast<EncodingType>((firstByte >> 6) & 0x03);
+    switch (enc) {
+      case SHORT_REPEAT:
+        if (newRun) {
+          // Reads the header without decoding any values.
+          nextShortRepeats(dummy, 0, 0, nullptr);
+        }
+        break;
+      case DIRECT:
+        if (newRun) {
+          nextDirect(dummy, 0, 0, nullptr);
+        }
+        break;
+      case PATCHED_BASE:
+        if (newRun) {
+          nextPatched(dummy, 0, 0, nullptr);
+        }
+        break;
+      case DELTA:
+        if (newRun) {
+          nextDelta(dummy, 0, 0, nullptr);
+        }
+        break;
+      default:
+        DWIO_RAISE("unknown encoding");
+    }
+
+    const uint64_t numSkipped = std::min(runLength - runRead, numValues);
+    if (enc == SHORT_REPEAT) {
+      runRead += numSkipped;
+    } else if (enc == DIRECT) {
+      // The values are not needed, so the bits are skipped without unpacking.
+      skipBits(numSkipped * bitSize);
+      runRead += numSkipped;
+    } else if (enc == DELTA && bitSize == 0) {
+      // The value at 'i' in the run is firstValue + i * deltaBase.
+      runRead += numSkipped;
+      prevValue = firstValue + static_cast<int64_t>(runRead - 1) * deltaBase;
+    } else {
+      // Patched and varying delta values depend on earlier ones.
+      for (uint64_t i = 0; i < numSkipped; i += kBatchSize) {
+        const auto batch = std::min(kBatchSize, numSkipped - i);
+        if (enc == PATCHED_BASE) {
+          nextPatched(dummy, 0, batch, nullptr);
+        } else {
+          nextDelta(dummy, 0, batch, nullptr);
+        }
+      }
+    }
+    numValues -= numSkipped;
   }
 }
 
@@ -550,10 +600,26 @@ uint64_t RleDecoderV2<isSigned>::nextDelta(
     uint64_t remaining = (offset + nRead) - pos;
     runRead += readLongs(data, pos, remaining, bitSize, nulls);
 
-    if (deltaBase < 0) {
+    if (!nulls) {
+      // The deltas are unpacked in bulk above, only the running sum remains.
+      const uint64_t end = offset + nRead;
+      int64_t value = prevValue;
+      if (deltaBase < 0) {
+        for (; pos < end; ++pos) {
+          value -= data[pos];
+          data[pos] = value;
+        }
+      } else {
+        for (; pos < end; ++pos) {
+          value += data[pos];
+          data[pos] = value;
+        }
+      }
+      prevValue = value;
+    } else if (deltaBase < 0) {
       for (; pos < offset + nRead; ++pos) {
         // skip null positions
-        if (nulls && bits::isBitNull(nulls, pos)) {
+        if (bits::isBitNull(nulls, pos)) {
           continue;
         }
         prevValue = data[pos] = prevValue - data[pos];
@@ -561,7 +627,7 @@ uint64_t RleDecoderV2<isSigned>::nextDelta(
     } else {
       for (; pos < offset + nRead; ++pos) {
         // skip null positions
-        if (nulls && bits::isBitNull(nulls, pos)) {
+        if (bits::isBitNull(nulls, pos)) {
           continue;
         }
         prevValue = data[pos] = prevValue + data[pos];
@@ -23,6 +23,8 @@
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/exception/Exception.h"
 
+#include <folly/Bits.h>
+
 #include <vector>
 
 namespace facebook::velox::dwrf {
@@ -107,41 +109,124 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
   }
 
   int64_t readLongBE(uint64_t bsz);
+
+  // Reads one value of 'fb' bits.
+  uint64_t readLong(uint64_t fb) {
+    uint64_t result = 0;
+    uint64_t bitsLeftToRead = fb;
+    while (bitsLeftToRead > bitsLeft) {
+      result <<= bitsLeft;
+      result |= curByte & ((1 << bitsLeft) - 1);
+      bitsLeftToRead -= bitsLeft;
+      curByte = readByte();
+      bitsLeft = 8;
+    }
+
+    // handle the left over bits
+    if (bitsLeftToRead > 0) {
+      result <<= bitsLeftToRead;
+      bitsLeft -= static_cast<uint32_t>(bitsLeftToRead);
+      result |= (curByte >> bitsLeft) & ((1 << bitsLeftToRead) - 1);
+    }
+    return result;
+  }
+
+  // Decodes up to 'numValues' values of 'fb' <= 56 bits a 64 bit word at a
+  // time, for as long as the current buffer has 8 bytes from the first byte
+  // of the next value. Leaves the bit state as readLong() would. Returns the
+  // number of values decoded.
+  uint64_t unpackFast(int64_t* data, uint64_t numValues, uint32_t fb) {
+    auto& bufferStart = dwio::common::IntDecoder<isSigned>::bufferStart;
+    // The unread bits of 'curByte' are in the byte before 'bufferStart'.
+    const char* start = bitsLeft ? bufferStart - 1 : bufferStart;
+    if (!start || dwio::common::IntDecoder<isSigned>::bufferEnd - start < 8) {
+      return 0;
+    }
+    uint64_t bitPos = bitsLeft ? 8 - bitsLeft : 0;
+    const uint64_t endBit =
+        (dwio::common::IntDecoder<isSigned>::bufferEnd - start - 7) * 8;
+    if (bitPos >= endBit) {
+      return 0;
+    }
+    const uint64_t count =
+        std::min<uint64_t>(numValues, (endBit - bitPos - 1) / fb + 1);
+    const int32_t rightShift = 64 - fb;
+    for (uint64_t i = 0; i < count; ++i) {
+      const auto word = folly::Endian::big(
+          folly::loadUnaligned<uint64_t>(start + (bitPos >> 3)));
+      data[i] = static_cast<int64_t>((word << (bitPos & 7)) >> rightShift);
+      bitPos += fb;
+    }
+    bufferStart = start + (bitPos >> 3);
+    if (bitPos & 7) {
+      curByte = static_cast<unsigned char>(*bufferStart++);
+      bitsLeft = 8 - (bitPos & 7);
+    } else {
+      bitsLeft = 0;
+    }
+    return count;
+  }
+
+  // Reads 'numValues' consecutive values of 'fb' bits into 'data'.
+  void readDenseLongs(int64_t* data, uint64_t numValues, uint64_t fb) {
+    uint64_t i = 0;
+    if (fb <= 56) {
+      i = unpackFast(data, numValues, fb);
+    }
+    for (; i < numValues; ++i) {
+      data[i] = static_cast<int64_t>(readLong(fb));
+    }
+  }
+
   uint64_t readLongs(
       int64_t* data,
       uint64_t offset,
       uint64_t len,
       uint64_t fb,
       const uint64_t* nulls = nullptr) {
-    uint64_t ret = 0;
-
-    // TODO: unroll to improve performance
-    for (uint64_t i = offset; i < (offset + len); i++) {
-      // skip null positions
-      if (nulls && bits::isBitNull(nulls, i)) {
-        continue;
-      }
-      uint64_t result = 0;
-      uint64_t bitsLeftToRead = fb;
-      while (bitsLeftToRead > bitsLeft) {
-        result <<= bitsLeft;
-        result |= curByte & ((1 << bitsLeft) - 1);
-        bitsLeftToRead -= bitsLeft;
-        curByte = readByte();
-        bitsLeft = 8;
+    if (!nulls) {
+      readDenseLongs(data + offset, len, fb);
+      return len;
+    }
+    // Reads the non-null values to the start of the range and moves them to
+    // their rows from the back.
+    const uint64_t numValues = bits::countNonNulls(nulls, offset, offset + len);
+    readDenseLongs(data + offset, numValues, fb);
+    auto dense = numValues;
+    for (auto i = offset + len; dense > 0 && i-- > offset;) {
+      if (!bits::isBitNull(nulls, i)) {
+        data[i] = data[offset + --dense];
       }
+    }
+    return numValues;
+  }
 
-      // handle the left over bits
-      if (bitsLeftToRead > 0) {
-        result <<= bitsLeftToRead;
-        bitsLeft -= static_cast<uint32_t>(bitsLeftToRead);
-        result |= (curByte >> bitsLeft) & ((1 << bitsLeftToRead) - 1);
+  // Skips 'numBits' bits of bit packed values.
+  void skipBits(uint64_t numBits) {
+    if (numBits <= bitsLeft) {
+      bitsLeft -= numBits;
+      return;
+    }
+    numBits -= bitsLeft;
+    bitsLeft = 0;
+    auto& bufferStart = dwio::common::IntDecoder<isSigned>::bufferStart;
+    auto& bufferEnd = dwio::common::IntDecoder<isSigned>::bufferEnd;
+    uint64_t numBytes = numBits / 8;
+    while (numBytes > 0) {
+      if (bufferStart == bufferEnd) {
+        // Loads the next buffer.
+        readByte();
+        --numBytes;
+        continue;
       }
-      data[i] = static_cast<int64_t>(result);
-      ++ret;
+      const auto step = std::min<uint64_t>(numBytes, bufferEnd - bufferStart);
+      bufferStart += step;
+      numBytes -= step;
+    }
+    if (numBits % 8) {
+      curByte = readByte();
+      bitsLeft = 8 - numBits % 8;
     }
-
-    return ret;
   }
 
   uint64_t nextShortRepeats(
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/StrideBloomFilter.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+// Seed of the Murmur3 hash used by ORC bloom filters.
+constexpr uint32_t kMurmur3Seed = 104729;
+
+inline uint64_t rotl64(uint64_t x, int8_t r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t fmix64(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+} // namespace
+
+StrideBloomFilter::StrideBloomFilter(uint64_t expectedEntries, double fpp) {
+  DWIO_ENSURE_GT(expectedEntries, 0);
+  DWIO_ENSURE(fpp > 0.0 && fpp < 1.0, "Invalid bloom filter fpp ", fpp);
+  const auto n = static_cast<double>(expectedEntries);
+  const auto optimalBits =
+      static_cast<uint64_t>(-n * std::log(fpp) / (std::log(2) * std::log(2)));
+  // Rounds up to whole words the same way as ORC.
+  const uint64_t numBits = optimalBits + (64 - optimalBits % 64);
+  numHashFunctions_ = std::max<uint32_t>(
+      1, static_cast<uint32_t>(std::round(numBits / n * std::log(2))));
+  bits_.resize(numBits / 64);
+}
+
+StrideBloomFilter::StrideBloomFilter(const proto::BloomFilter& bloomFilter)
+    : numHashFunctions_{bloomFilter.numhashfunctions()} {
+  DWIO_ENSURE_GT(numHashFunctions_, 0);
+  if (bloomFilter.has_utf8bitset()) {
+    const auto& bytes = bloomFilter.utf8bitset();
+    DWIO_ENSURE_EQ(bytes.size() % sizeof(uint64_t), 0);
+    bits_.resize(bytes.size() / sizeof(uint64_t));
+    std::memcpy(bits_.data(), bytes.data(), bytes.size());
+  } else {
+    bits_.assign(bloomFilter.bitset().begin(), bloomFilter.bitset().end());
+  }
+  DWIO_ENSURE_GT(bits_.size(), 0);
+}
+
+void StrideBloomFilter::toProto(proto::BloomFilter& bloomFilter) const {
+  bloomFilter.set_numhashfunctions(numHashFunctions_);
+  // The words are stored little endian, which is also the layout in memory.
+  bloomFilter.set_utf8bitset(
+      reinterpret_cast<const char*>(bits_.data()),
+      bits_.size() * sizeof(uint64_t));
+}
+
+void StrideBloomFilter::addHash(uint64_t hash) {
+  const auto hash1 = static_cast<uint32_t>(hash);
+  const auto hash2 = static_cast<uint32_t>(hash >> 32);
+  const auto numBits = this->numBits();
+  for (uint32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto combinedHash = static_cast<int32_t>(hash1 + i * hash2);
+    if (combinedHash < 0) {
+      combinedHash = ~combinedHash;
+    }
+    const uint64_t pos = combinedHash % numBits;
+    bits_[pos >> 6] |= 1ULL << (pos & 63);
+  }
+}
+
+bool StrideBloomFilter::testHash(uint64_t hash) const {
+  const auto hash1 = static_cast<uint32_t>(hash);
+  const auto hash2 = static_cast<uint32_t>(hash >> 32);
+  const auto numBits = this->numBits();
+  for (uint32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto combinedHash = static_cast<int32_t>(hash1 + i * hash2);
+    if (combinedHash < 0) {
+      combinedHash = ~combinedHash;
+    }
+    const uint64_t pos = combinedHash % numBits;
+    if ((bits_[pos >> 6] & (1ULL << (pos & 63))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// static
+uint64_t StrideBloomFilter::hashLong(int64_t value) {
+  // Thomas Wang's integer hash with logical shifts.
+  auto key = static_cast<uint64_t>(value);
+  key = (~key) + (key << 21);
+  key = key ^ (key >> 24);
+  key = (key + (key << 3)) + (key << 8);
+  key = key ^ (key >> 14);
+  key = (key + (key << 2)) + (key << 4);
+  key = key ^ (key >> 28);
+  key = key + (key << 31);
+  return key;
+}
+
+// static
+uint64_t StrideBloomFilter::hashBytes(const char* data, size_t size) {
+  constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+  constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+  uint64_t h = kMurmur3Seed;
+  const size_t numBlocks = size / 8;
+  for (size_t i = 0; i < numBlocks; ++i) {
+    uint64_t k;
+    std::memcpy(&k, bytes + i * 8, sizeof(k));
+    k *= c1;
+    k = rotl64(k, 31);
+    k *= c2;
+    h ^= k;
+    h = rotl64(h, 27);
+    h = h * 5 + 0x52dce729;
+  }
+
+  const auto* tail = bytes + numBlocks * 8;
+  const size_t tailSize = size - numBlocks * 8;
+  if (tailSize > 0) {
+    uint64_t k = 0;
+    for (size_t i = 0; i < tailSize; ++i) {
+      k ^= static_cast<uint64_t>(tail[i]) << (8 * i);
+    }
+    k *= c1;
+    k = rotl64(k, 31);
+    k *= c2;
+    h ^= k;
+  }
+  h ^= size;
+  return fmix64(h);
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+/**
+ * Bloom filter of the values of a column in one row index stride. These are
+ * stored in the BLOOM_FILTER_UTF8 stream, one per row index entry. The bit
+ * layout and hashing follow ORC, i.e. Murmur3 for strings, Thomas Wang's
+ * hash for integers and double hashing for the bit positions.
+ */
+class StrideBloomFilter {
+ public:
+  StrideBloomFilter(uint64_t expectedEntries, double fpp);
+
+  explicit StrideBloomFilter(const proto::BloomFilter& bloomFilter);
+
+  void addLong(int64_t value) {
+    addHash(hashLong(value));
+  }
+
+  void addBytes(const char* data, size_t size) {
+    addHash(hashBytes(data, size));
+  }
+
+  bool testLong(int64_t value) const {
+    return testHash(hashLong(value));
+  }
+
+  bool testBytes(const char* data, size_t size) const {
+    return testHash(hashBytes(data, size));
+  }
+
+  void reset() {
+    std::fill(bits_.begin(), bits_.end(), 0);
+  }
+
+  uint64_t numBits() const {
+    return bits_.size() * 64;
+  }
+
+  uint32_t numHashFunctions() const {
+    return numHashFunctions_;
+  }
+
+  void toProto(proto::BloomFilter& bloomFilter) const;
+
+  static uint64_t hashLong(int64_t value);
+
+  static uint64_t hashBytes(const char* data, size_t size);
+
+ private:
+  void addHash(uint64_t hash);
+
+  bool testHash(uint64_t hash) const;
+
+  uint32_t numHashFunctions_;
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace facebook::velox::dwrf
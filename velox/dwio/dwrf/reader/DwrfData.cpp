@@ -17,6 +17,8 @@
 #include "velox/dwio/dwrf/reader/DwrfData.h"
 
 #include "velox/dwio/common/BufferUtil.h"
+#include "velox/dwio/dwrf/common/StrideBloomFilter.h"
+#include "velox/dwio/dwrf/reader/SharedStripeMetadataCache.h"
 
 namespace facebook::velox::dwrf {
 
@@ -43,8 +45,19 @@ DwrfData::DwrfData(
   // anywhere in the reader tree. This is not known at construct time
   // because the first filter can come from a hash join or other run
   // time pushdown.
-  indexStream_ = stripe.getStream(
-      encodingKey.forKind(proto::Stream_Kind_ROW_INDEX),
+  const auto indexId = encodingKey.forKind(proto::Stream_Kind_ROW_INDEX);
+  auto* sharedCache = SharedStripeMetadataCache::instance();
+  if (sharedCache) {
+    indexCacheKey_ = stripe.getStreamCacheKey(indexId);
+    if (indexCacheKey_.has_value()) {
+      index_ = sharedCache->find<proto::RowIndex>(indexCacheKey_.value());
+    }
+  }
+  if (!index_) {
+    indexStream_ = stripe.getStream(indexId, streamLabels.label(), false);
+  }
+  bloomFilterStream_ = stripe.getStream(
+      encodingKey.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8),
       streamLabels.label(),
       false);
 }
@@ -85,10 +98,25 @@ uint64_t DwrfData::skipNulls(uint64_t numValues, bool /*nullsOnly*/) {
 void DwrfData::ensureRowGroupIndex() {
   VELOX_CHECK(index_ || indexStream_, "Reader needs to have an index stream");
   if (indexStream_) {
-    index_ = ProtoUtils::readProto<proto::RowIndex>(std::move(indexStream_));
+    std::shared_ptr<const proto::RowIndex> index =
+        ProtoUtils::readProto<proto::RowIndex>(std::move(indexStream_));
+    if (indexCacheKey_.has_value()) {
+      index = SharedStripeMetadataCache::instance()->insert(
+          indexCacheKey_.value(), std::move(index));
+    }
+    index_ = std::move(index);
   }
 }
 
+const proto::BloomFilterIndex* FOLLY_NULLABLE
+DwrfData::ensureBloomFilterIndex() {
+  if (bloomFilterStream_) {
+    bloomFilterIndex_ = ProtoUtils::readProto<proto::BloomFilterIndex>(
+        std::move(bloomFilterStream_));
+  }
+  return bloomFilterIndex_.get();
+}
+
 dwio::common::PositionProvider DwrfData::seekToRowGroup(uint32_t index) {
   ensureRowGroupIndex();
   tempPositions_ = toPositionsInner(index_->entry(index));
@@ -136,6 +164,89 @@ void DwrfData::readNulls(
   }
 }
 
+namespace {
+
+// Returns true if 'filter' on a column of 'type' can be tested with the bloom
+// filters of the column. The integer types are hashed as int64_t and strings
+// as their bytes.
+bool isBloomFilterTestable(const common::Filter& filter, const Type& type) {
+  if (filter.testNull()) {
+    // Nulls are not in the bloom filter.
+    return false;
+  }
+  switch (type.kind()) {
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::VARCHAR:
+      break;
+    default:
+      return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns false if no value that passes 'filter' can be in 'bloomFilter'.
+// 'filter' must be testable with isBloomFilterTestable().
+bool testBloomFilter(
+    const common::Filter& filter,
+    const StrideBloomFilter& bloomFilter) {
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto& range = static_cast<const common::BigintRange&>(filter);
+      return bloomFilter.testLong(range.lower());
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      auto& values =
+          static_cast<const common::BigintValuesUsingHashTable&>(filter);
+      for (auto value : values.values()) {
+        if (bloomFilter.testLong(value)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      auto& values =
+          static_cast<const common::BigintValuesUsingBitmask&>(filter);
+      for (auto value : values.values()) {
+        if (bloomFilter.testLong(value)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBytesRange: {
+      auto& range = static_cast<const common::BytesRange&>(filter);
+      return bloomFilter.testBytes(range.lower().data(), range.lower().size());
+    }
+    case common::FilterKind::kBytesValues: {
+      auto& values = static_cast<const common::BytesValues&>(filter);
+      for (const auto& value : values.values()) {
+        if (bloomFilter.testBytes(value.data(), value.size())) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace
+
 void DwrfData::filterRowGroups(
     const common::ScanSpec& scanSpec,
     uint64_t rowGroupSize,
@@ -157,6 +268,10 @@ void DwrfData::filterRowGroups(
     result.metadataFilterResults.emplace_back(
         scanSpec.metadataFilterNodeAt(i), std::vector<uint64_t>(nwords));
   }
+  const auto* bloomFilters =
+      filter && isBloomFilterTestable(*filter, *nodeType_->type)
+      ? ensureBloomFilterIndex()
+      : nullptr;
   for (auto i = 0; i < index_->entry_size(); i++) {
     const auto& entry = index_->entry(i);
     auto columnStats =
@@ -167,6 +282,14 @@ void DwrfData::filterRowGroups(
       bits::setBit(result.filterResult.data(), i);
       continue;
     }
+    if (bloomFilters && i < bloomFilters->bloomfilter_size() &&
+        !testBloomFilter(
+            *filter, StrideBloomFilter(bloomFilters->bloomfilter(i)))) {
+      VLOG(1) << "Drop stride " << i << " on bloom filter of "
+              << scanSpec.toString();
+      bits::setBit(result.filterResult.data(), i);
+      continue;
+    }
     for (int j = 0; j < scanSpec.numMetadataFilters(); ++j) {
       auto* metadataFilter = scanSpec.metadataFilterAt(j);
       if (!testFilter(
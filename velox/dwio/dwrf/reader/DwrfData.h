@@ -89,6 +89,10 @@ class DwrfData : public dwio::common::FormatData {
     return *index_;
   }
 
+  // Decodes the bloom filters for 'this' in the stripe if there are any and
+  // not already decoded. Returns nullptr if there are none.
+  const proto::BloomFilterIndex* FOLLY_NULLABLE ensureBloomFilterIndex();
+
  private:
   static std::vector<uint64_t> toPositionsInner(
       const proto::RowIndexEntry& entry) {
@@ -101,7 +105,14 @@ class DwrfData : public dwio::common::FormatData {
   FlatMapContext flatMapContext_;
   std::unique_ptr<ByteRleDecoder> notNullDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> indexStream_;
-  std::unique_ptr<proto::RowIndex> index_;
+  // Shared with the other readers of the file if it is in
+  // SharedStripeMetadataCache.
+  std::shared_ptr<const proto::RowIndex> index_;
+  // Key of the row index in SharedStripeMetadataCache if it may be shared.
+  std::optional<cache::RawFileCacheKey> indexCacheKey_;
+  // Bloom filters of the row groups, if the writer made them.
+  std::unique_ptr<dwio::common::SeekableInputStream> bloomFilterStream_;
+  std::unique_ptr<proto::BloomFilterIndex> bloomFilterIndex_;
   // Number of rows in a row group. Last row group may have fewer rows.
   uint32_t rowsPerRowGroup_;
 
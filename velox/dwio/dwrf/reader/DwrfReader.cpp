@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/common/SelectiveStructColumnReader.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/common/exception/Exception.h"
 #include "velox/dwio/dwrf/reader/ColumnReader.h"
@@ -419,6 +420,14 @@ void DwrfRowReader::startNextStripe() {
         scanSpec,
         flatMapContext);
     selectiveColumnReader_->setIsTopLevel();
+    if (auto& executor = options_.getDecodingExecutor()) {
+      if (auto* structReader =
+              dynamic_cast<dwio::common::SelectiveStructColumnReaderBase*>(
+                  selectiveColumnReader_.get())) {
+        structReader->setDecodingExecutor(
+            executor.get(), options_.getMinRowsForParallelDecoding());
+      }
+    }
   } else {
     columnReader_ = ColumnReader::build(
         requestedType, dataType, stripeStreams, streamLabels, flatMapContext);
@@ -584,6 +593,20 @@ std::unique_ptr<StripeInformation> DwrfReader::getStripe(
       stripeInfo.numberOfRows());
 }
 
+std::vector<dwio::common::Region> DwrfReader::readUnits() const {
+  auto& footer = readerBase_->getFooter();
+  std::vector<dwio::common::Region> stripes;
+  stripes.reserve(footer.stripesSize());
+  for (auto i = 0; i < footer.stripesSize(); ++i) {
+    auto stripeInfo = footer.stripes(i);
+    stripes.emplace_back(
+        stripeInfo.offset(),
+        stripeInfo.indexLength() + stripeInfo.dataLength() +
+            stripeInfo.footerLength());
+  }
+  return stripes;
+}
+
 std::vector<std::string> DwrfReader::getMetadataKeys() const {
   std::vector<std::string> result;
   auto& footer = readerBase_->getFooter();
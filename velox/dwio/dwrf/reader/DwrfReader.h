@@ -237,6 +237,8 @@ class DwrfReader : public dwio::common::Reader {
     return readerBase_->getColumnStatistics(nodeId);
   }
 
+  std::vector<dwio::common::Region> readUnits() const override;
+
   const std::shared_ptr<const RowType>& rowType() const override {
     return readerBase_->getSchema();
   }
@@ -18,6 +18,7 @@
 
 #include <fmt/format.h>
 
+#include "velox/dwio/common/FileFooterCache.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 namespace facebook::velox::dwrf {
@@ -163,21 +164,45 @@ ReaderBase::ReaderBase(
     input_->load(LogType::FOOTER);
   }
 
-  auto footerStream = input_->read(
-      fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
-  if (fileFormat == FileFormat::DWRF) {
+  auto readFooterStream = [&]() {
+    return createDecompressedStream(
+        input_->read(
+            fileLength_ - psLength_ - footerSize - 1,
+            footerSize,
+            LogType::FOOTER),
+        "File Footer");
+  };
+  auto* footerCache = dwio::common::FileFooterCache::instance();
+  const auto footerKey = footerCache
+      ? dwio::common::FileFooterCache::makeKey(
+            toString(fileFormat), *input_->getReadFile())
+      : std::nullopt;
+  if (footerKey.has_value()) {
+    // The parsed footer is shared with the other readers of the file.
+    if (fileFormat == FileFormat::DWRF) {
+      auto footer = footerCache->get<proto::Footer>(footerKey.value(), [&]() {
+        return ProtoUtils::readProto<proto::Footer>(readFooterStream());
+      });
+      footer_ = std::make_unique<FooterWrapper>(footer.get());
+      sharedFooter_ = std::move(footer);
+    } else {
+      auto footer =
+          footerCache->get<proto::orc::Footer>(footerKey.value(), [&]() {
+            return ProtoUtils::readProto<proto::orc::Footer>(
+                readFooterStream());
+          });
+      footer_ = std::make_unique<FooterWrapper>(footer.get());
+      sharedFooter_ = std::move(footer);
+    }
+  } else if (fileFormat == FileFormat::DWRF) {
     auto footer =
         google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
-    ProtoUtils::readProtoInto<proto::Footer>(
-        createDecompressedStream(std::move(footerStream), "File Footer"),
-        footer);
+    ProtoUtils::readProtoInto<proto::Footer>(readFooterStream(), footer);
     footer_ = std::make_unique<FooterWrapper>(footer);
   } else {
     auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
         arena_.get());
-    ProtoUtils::readProtoInto<proto::orc::Footer>(
-        createDecompressedStream(std::move(footerStream), "File Footer"),
-        footer);
+    ProtoUtils::readProtoInto<proto::orc::Footer>(readFooterStream(), footer);
     footer_ = std::make_unique<FooterWrapper>(footer);
   }
 
@@ -234,6 +234,8 @@ class ReaderBase {
   std::unique_ptr<google::protobuf::Arena> arena_;
   std::unique_ptr<PostScript> postScript_;
   std::unique_ptr<FooterWrapper> footer_ = nullptr;
+  // Owns the proto behind 'footer_' if it is from FileFooterCache.
+  std::shared_ptr<const google::protobuf::Message> sharedFooter_;
   std::unique_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
   std::shared_ptr<dwio::common::encryption::DecrypterFactory> decryptorFactory_;
@@ -16,6 +16,8 @@
 
 #include "velox/dwio/dwrf/reader/SelectiveFlatMapColumnReader.h"
 
+#include <folly/Conv.h>
+
 #include "velox/dwio/common/FlatMapHelper.h"
 #include "velox/dwio/dwrf/reader/SelectiveDwrfReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveStructColumnReader.h"
@@ -74,13 +76,31 @@ struct KeyNode {
         inMap(std::move(inMap)) {}
 };
 
+template <typename T>
+std::optional<dwio::common::flatmap::KeyValue<T>> parseKey(
+    const std::string& name) {
+  if constexpr (std::is_same_v<T, StringView>) {
+    return dwio::common::flatmap::KeyValue<T>(StringView(name));
+  } else {
+    auto value = folly::tryTo<T>(name);
+    if (value.hasError()) {
+      return std::nullopt;
+    }
+    return dwio::common::flatmap::KeyValue<T>(value.value());
+  }
+}
+
+// Returns the readers of the keys to read. If 'allRowsFiltered' is given, it
+// is set to true when a filter on the value of a key that is not in the
+// stripe rejects nulls, in which case no rows of the stripe pass.
 template <typename T>
 std::vector<KeyNode<T>> getKeyNodes(
     const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
     const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
     DwrfParams& params,
     common::ScanSpec& scanSpec,
-    bool asStruct) {
+    bool asStruct,
+    bool* allRowsFiltered = nullptr) {
   using namespace dwio::common::flatmap;
 
   std::vector<KeyNode<T>> keyNodes;
@@ -104,6 +124,31 @@ std::vector<KeyNode<T>> getKeyNodes(
     }
   }
 
+  // Filters on the values of given keys, e.g. m['k'] > 5, are the remaining
+  // children. These are evaluated by the readers of the keys.
+  std::unordered_map<
+      KeyValue<T>,
+      std::shared_ptr<common::ScanSpec>,
+      KeyValueHash<T>>
+      keyFilterSpecs;
+  if (!asStruct) {
+    std::vector<std::shared_ptr<common::ScanSpec>> filterSpecs;
+    for (auto& c : scanSpec.children()) {
+      if (c->hasFilter()) {
+        filterSpecs.push_back(c);
+      }
+    }
+    for (auto& c : filterSpecs) {
+      scanSpec.removeChild(c.get());
+      auto key = parseKey<T>(c->fieldName());
+      VELOX_CHECK(
+          key.has_value(),
+          "Invalid flat map key in filter: {}",
+          c->fieldName());
+      keyFilterSpecs[*key] = c;
+    }
+  }
+
   std::unordered_map<KeyValue<T>, common::ScanSpec*, KeyValueHash<T>>
       childSpecs;
   if (asStruct) {
@@ -141,7 +186,9 @@ std::vector<KeyNode<T>> getKeyNodes(
           // Column not selected in 'scanSpec', skipping it.
           return;
         } else {
-          if (keysSpec && keysSpec->filter() &&
+          auto filterIt = keyFilterSpecs.find(key);
+          const bool hasKeyFilter = filterIt != keyFilterSpecs.end();
+          if (!hasKeyFilter && keysSpec && keysSpec->filter() &&
               !common::applyFilter(*keysSpec->filter(), key.get())) {
             return; // Subfield pruning
           }
@@ -152,6 +199,11 @@ std::vector<KeyNode<T>> getKeyNodes(
           if (valuesSpec) {
             *childSpec = *valuesSpec;
           }
+          if (hasKeyFilter) {
+            childSpec->setFilter(filterIt->second->filter()->clone());
+            childSpec->resetCachedValues(false);
+            keyFilterSpecs.erase(filterIt);
+          }
           childSpecs[key] = childSpec;
         }
         auto labels = params.streamLabels().append(toString(key.get()));
@@ -172,6 +224,16 @@ std::vector<KeyNode<T>> getKeyNodes(
             key, sequence, std::move(reader), std::move(inMapDecoder));
       });
 
+  if (allRowsFiltered) {
+    // A key not in the stripe reads as null for all rows.
+    *allRowsFiltered = false;
+    for (auto& [_, spec] : keyFilterSpecs) {
+      if (!spec->filter()->testNull()) {
+        *allRowsFiltered = true;
+      }
+    }
+  }
+
   VLOG(1) << "[Flat-Map] Initialized a flat-map column reader for node "
           << dataType->id << ", keys=" << keyNodes.size()
           << ", streams=" << streams;
@@ -225,11 +287,29 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
         // Copy the scan spec because we need to remove the children.
         structScanSpec_(scanSpec) {
     scanSpec_ = &structScanSpec_;
-    keyNodes_ =
-        getKeyNodes<T>(requestedType, dataType, params, structScanSpec_, false);
+    keyNodes_ = getKeyNodes<T>(
+        requestedType,
+        dataType,
+        params,
+        structScanSpec_,
+        false,
+        &allRowsFiltered_);
+    // The readers of keys with filters go first so that the other keys are
+    // only read for the rows that pass.
     std::sort(keyNodes_.begin(), keyNodes_.end(), [](auto& x, auto& y) {
+      const bool xFilter = x.reader->scanSpec()->hasFilter();
+      const bool yFilter = y.reader->scanSpec()->hasFilter();
+      if (xFilter != yFilter) {
+        return xFilter;
+      }
       return x.sequence < y.sequence;
     });
+    for (auto& child : scanSpec.children()) {
+      if (child->fieldName() != common::ScanSpec::kMapKeysFieldName &&
+          child->hasFilter()) {
+        hasKeyFilters_ = true;
+      }
+    }
     childValues_.resize(keyNodes_.size());
     copyRanges_.resize(keyNodes_.size());
     children_.resize(keyNodes_.size());
@@ -255,6 +335,16 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
     auto activeRows = rows;
     auto* mapNulls =
         nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+    if (allRowsFiltered_) {
+      for (auto* reader : children_) {
+        advanceFieldReader(reader, offset);
+        reader->addParentNulls(offset, mapNulls, rows);
+      }
+      setOutputRows({});
+      lazyVectorReadOffset_ = offset;
+      readOffset_ = offset + rows.back() + 1;
+      return;
+    }
     if (scanSpec_->filter()) {
       auto kind = scanSpec_->filter()->kind();
       VELOX_CHECK(
@@ -271,9 +361,17 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
     }
     for (auto* reader : children_) {
       advanceFieldReader(reader, offset);
-      reader->read(offset, activeRows, mapNulls);
+      if (!activeRows.empty()) {
+        reader->read(offset, activeRows, mapNulls);
+        if (reader->scanSpec()->hasFilter()) {
+          activeRows = reader->outputRows();
+        }
+      }
       reader->addParentNulls(offset, mapNulls, rows);
     }
+    if (hasKeyFilters_ && activeRows.data() != outputRows_.data()) {
+      setOutputRows(activeRows);
+    }
     lazyVectorReadOffset_ = offset;
     readOffset_ = offset + rows.back() + 1;
   }
@@ -385,6 +483,12 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
  private:
   common::ScanSpec structScanSpec_;
   std::vector<KeyNode<T>> keyNodes_;
+  // True if a filter on the value of a key that is not in the stripe rejects
+  // nulls, so that no row passes.
+  bool allRowsFiltered_{false};
+  // True if there are filters on the values of given keys. The parent then
+  // takes the rows that pass from 'outputRows_'.
+  bool hasKeyFilters_{false};
   std::vector<VectorPtr> childValues_;
   std::vector<std::vector<BaseVector::CopyRange>> copyRanges_;
 };
@@ -139,6 +139,7 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
   // get stride dictionary size and load it if needed
   auto& positions =
       formatData_->as<DwrfData>().index().entry(nextStride).positions();
+  const auto previousStrideDictSize = scanState_.dictionary2.numValues;
   scanState_.dictionary2.numValues = positions.Get(strideDictSizeOffset_);
   if (scanState_.dictionary2.numValues > 0) {
     // seek stride dictionary related streams
@@ -152,7 +153,11 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
         *strideDictStream_, *strideDictLengthDecoder_, scanState_.dictionary2);
   }
   lastStrideIndex_ = nextStride;
-  dictionaryValues_ = nullptr;
+  // The values only change if there is a stride dictionary. Keeping the same
+  // vector lets expressions reuse the results they memoized for it.
+  if (previousStrideDictSize > 0 || scanState_.dictionary2.numValues > 0) {
+    dictionaryValues_ = nullptr;
+  }
 
   if (scanSpec_->hasFilter()) {
     scanState_.filterCache.resize(
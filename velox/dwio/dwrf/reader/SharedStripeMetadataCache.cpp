@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/reader/SharedStripeMetadataCache.h"
+
+#include "velox/common/caching/FileIds.h"
+
+DEFINE_int64(
+    dwrf_shared_stripe_metadata_cache_bytes,
+    64 << 20,
+    "Memory limit of the process wide cache of parsed DWRF stripe footers and "
+    "row indexes. 0 disables the cache");
+
+namespace facebook::velox::dwrf {
+
+// static
+SharedStripeMetadataCache* SharedStripeMetadataCache::instance() {
+  static auto* cache = FLAGS_dwrf_shared_stripe_metadata_cache_bytes > 0
+      ? new SharedStripeMetadataCache(
+            FLAGS_dwrf_shared_stripe_metadata_cache_bytes)
+      : nullptr;
+  return cache;
+}
+
+std::shared_ptr<const google::protobuf::Message>
+SharedStripeMetadataCache::findMessage(const cache::RawFileCacheKey& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->message;
+}
+
+std::shared_ptr<const google::protobuf::Message>
+SharedStripeMetadataCache::insertMessage(
+    const cache::RawFileCacheKey& key,
+    std::shared_ptr<const google::protobuf::Message> message) {
+  // Sized outside of the lock. This walks the message.
+  const uint64_t bytes = message->SpaceUsedLong();
+  if (bytes > maxBytes_) {
+    return message;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->message;
+  }
+  lru_.push_front(Entry{
+      cache::FileCacheKey{StringIdLease(fileIds(), key.fileNum), key.offset},
+      message,
+      bytes});
+  entries_[key] = lru_.begin();
+  bytes_ += bytes;
+  evictLocked();
+  return message;
+}
+
+void SharedStripeMetadataCache::evictLocked() {
+  while (bytes_ > maxBytes_) {
+    VELOX_CHECK(!lru_.empty());
+    auto& entry = lru_.back();
+    bytes_ -= entry.bytes;
+    entries_.erase(
+        cache::RawFileCacheKey{entry.key.fileNum.id(), entry.key.offset});
+    lru_.pop_back();
+    ++numEvicts_;
+  }
+}
+
+void SharedStripeMetadataCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+SharedStripeMetadataCache::Stats SharedStripeMetadataCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numHits = numHits_;
+  stats.numMisses = numMisses_;
+  stats.numEvicts = numEvicts_;
+  stats.numEntries = entries_.size();
+  stats.bytes = bytes_;
+  return stats;
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+
+#include <folly/container/F14Map.h>
+#include <gflags/gflags.h>
+#include <google/protobuf/message.h>
+
+#include "velox/common/caching/AsyncDataCache.h"
+
+DECLARE_int64(dwrf_shared_stripe_metadata_cache_bytes);
+
+namespace facebook::velox::dwrf {
+
+/// Process wide cache of parsed stripe footers and row indexes. The splits of
+/// a file are read by different readers, each of which would otherwise parse
+/// the same metadata again. Entries are keyed by the file number of the
+/// CachedBufferedInput of the reader and the offset of the metadata in the
+/// file, so readers without a file number don't use the cache. The cache is
+/// bounded by the memory of the parsed messages and evicts the least recently
+/// used entries first.
+class SharedStripeMetadataCache {
+ public:
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEvicts{0};
+    uint64_t numEntries{0};
+    uint64_t bytes{0};
+  };
+
+  explicit SharedStripeMetadataCache(uint64_t maxBytes) : maxBytes_(maxBytes) {}
+
+  /// Returns the process wide instance or nullptr if
+  /// FLAGS_dwrf_shared_stripe_metadata_cache_bytes is 0.
+  static SharedStripeMetadataCache* instance();
+
+  /// Returns the message at 'key' or nullptr if not cached.
+  template <typename T>
+  std::shared_ptr<const T> find(const cache::RawFileCacheKey& key) {
+    return std::static_pointer_cast<const T>(findMessage(key));
+  }
+
+  /// Adds 'message' at 'key' and returns the cached message, which is the
+  /// earlier one if another reader added it first.
+  template <typename T>
+  std::shared_ptr<const T> insert(
+      const cache::RawFileCacheKey& key,
+      std::shared_ptr<const T> message) {
+    return std::static_pointer_cast<const T>(
+        insertMessage(key, std::move(message)));
+  }
+
+  /// Returns the message at 'key' and makes it with 'load' if not cached.
+  /// 'load' runs without holding the lock of 'this'.
+  template <typename T>
+  std::shared_ptr<const T> get(
+      const cache::RawFileCacheKey& key,
+      const std::function<std::unique_ptr<T>()>& load) {
+    if (auto message = find<T>(key)) {
+      return message;
+    }
+    return insert<T>(key, std::shared_ptr<const T>(load()));
+  }
+
+  void clear();
+
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    // Holds a reference to the file number so that it is not reused while
+    // cached.
+    cache::FileCacheKey key;
+    std::shared_ptr<const google::protobuf::Message> message;
+    uint64_t bytes;
+  };
+
+  std::shared_ptr<const google::protobuf::Message> findMessage(
+      const cache::RawFileCacheKey& key);
+
+  std::shared_ptr<const google::protobuf::Message> insertMessage(
+      const cache::RawFileCacheKey& key,
+      std::shared_ptr<const google::protobuf::Message> message);
+
+  // Evicts the least recently used entries until 'bytes_' is within
+  // 'maxBytes_'.
+  void evictLocked();
+
+  const uint64_t maxBytes_;
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> lru_;
+  folly::F14FastMap<cache::RawFileCacheKey, std::list<Entry>::iterator>
+      entries_;
+  uint64_t bytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+  uint64_t numEvicts_{0};
+};
+
+} // namespace facebook::velox::dwrf
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/reader/StripeReaderBase.h"
+#include "velox/dwio/dwrf/reader/SharedStripeMetadataCache.h"
 
 namespace facebook::velox::dwrf {
 
@@ -58,8 +59,47 @@ StripeInformationWrapper StripeReaderBase::loadStripe(
   }
 
   // load stripe footer
+  auto* sharedCache = SharedStripeMetadataCache::instance();
+  const auto fileNum = reader_->getBufferedInput().fileNum();
+  if (sharedCache && fileNum.has_value()) {
+    // The footers of the stripes of a file are shared by the readers of all
+    // its splits.
+    sharedFooter_ = sharedCache->get<proto::StripeFooter>(
+        {fileNum.value(),
+         stripe.offset() + stripe.indexLength() + stripe.dataLength()},
+        [&]() {
+          auto footer = std::make_unique<proto::StripeFooter>();
+          ProtoUtils::readProtoInto<proto::StripeFooter>(
+              readFooter(index, stripe), footer.get());
+          return footer;
+        });
+    footer_ = sharedFooter_.get();
+  } else {
+    // Reuse arenaFooter_'s memory to avoid expensive destruction
+    if (!arenaFooter_) {
+      arenaFooter_ =
+          google::protobuf::Arena::CreateMessage<proto::StripeFooter>(
+              reader_->arena());
+    }
+    ProtoUtils::readProtoInto<proto::StripeFooter>(
+        readFooter(index, stripe), arenaFooter_);
+    sharedFooter_.reset();
+    footer_ = arenaFooter_;
+  }
+
+  // refresh stripe encryption key if necessary
+  loadEncryptionKeys(index);
+  lastStripeIndex_ = index;
+
+  return stripe;
+}
+
+std::unique_ptr<dwio::common::SeekableInputStream>
+StripeReaderBase::readFooter(
+    uint32_t index,
+    const StripeInformationWrapper& stripe) {
   std::unique_ptr<dwio::common::SeekableInputStream> stream;
-  if (cache) {
+  if (auto& cache = reader_->getMetadataCache()) {
     stream = cache->get(StripeCacheMode::FOOTER, index);
   }
 
@@ -70,22 +110,8 @@ StripeInformationWrapper StripeReaderBase::loadStripe(
         LogType::STRIPE_FOOTER);
   }
 
-  // Reuse footer_'s memory to avoid expensive destruction
-  if (!footer_) {
-    footer_ = google::protobuf::Arena::CreateMessage<proto::StripeFooter>(
-        reader_->arena());
-  }
-
   auto streamDebugInfo = fmt::format("Stripe {} Footer ", index);
-  ProtoUtils::readProtoInto<proto::StripeFooter>(
-      reader_->createDecompressedStream(std::move(stream), streamDebugInfo),
-      footer_);
-
-  // refresh stripe encryption key if necessary
-  loadEncryptionKeys(index);
-  lastStripeIndex_ = index;
-
-  return stripe;
+  return reader_->createDecompressedStream(std::move(stream), streamDebugInfo);
 }
 
 void StripeReaderBase::loadEncryptionKeys(uint32_t index) {
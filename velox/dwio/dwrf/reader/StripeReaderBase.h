@@ -34,7 +34,7 @@ class StripeReaderBase {
       const std::shared_ptr<ReaderBase>& reader,
       const proto::StripeFooter* footer)
       : reader_{reader},
-        footer_{const_cast<proto::StripeFooter*>(footer)},
+        footer_{footer},
         handler_{std::make_unique<encryption::DecryptionHandler>(
             reader_->getDecryptionHandler())},
         canLoad_{false} {
@@ -71,13 +71,22 @@ class StripeReaderBase {
  private:
   std::shared_ptr<ReaderBase> reader_;
   std::unique_ptr<dwio::common::BufferedInput> stripeInput_;
-  proto::StripeFooter* footer_ = nullptr;
+  const proto::StripeFooter* footer_ = nullptr;
+  // Reused for the footers parsed by 'this'.
+  proto::StripeFooter* arenaFooter_ = nullptr;
+  // Keeps 'footer_' live if it is from SharedStripeMetadataCache.
+  std::shared_ptr<const proto::StripeFooter> sharedFooter_;
   std::unique_ptr<encryption::DecryptionHandler> handler_;
   std::optional<uint32_t> lastStripeIndex_;
   bool canLoad_{true};
 
   void loadEncryptionKeys(uint32_t index);
 
+  // Reads and decompresses the footer of the stripe at 'index'.
+  std::unique_ptr<dwio::common::SeekableInputStream> readFooter(
+      uint32_t index,
+      const StripeInformationWrapper& stripe);
+
   friend class StripeLoadKeysTest;
 };
 
@@ -302,6 +302,21 @@ std::unique_ptr<dwio::common::SeekableInputStream> StripeStreamsImpl::getStream(
       getDecrypter(si.encodingKey().node));
 }
 
+std::optional<cache::RawFileCacheKey> StripeStreamsImpl::getStreamCacheKey(
+    const DwrfStreamIdentifier& si) const {
+  const auto fileNum = reader_.getReader().getBufferedInput().fileNum();
+  if (!fileNum.has_value() ||
+      reader_.getDecryptionHandler().isEncrypted(si.encodingKey().node)) {
+    return std::nullopt;
+  }
+  const auto& info = getStreamInfo(si, false /* throwIfNotFound */);
+  if (!info.valid()) {
+    return std::nullopt;
+  }
+  return cache::RawFileCacheKey{
+      fileNum.value(), info.getOffset() + stripeStart_};
+}
+
 uint32_t StripeStreamsImpl::visitStreamsOfNode(
     uint32_t node,
     std::function<void(const StreamInformation&)> visitor) const {
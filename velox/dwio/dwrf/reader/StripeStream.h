@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "velox/common/caching/AsyncDataCache.h"
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/SeekableInputStream.h"
@@ -166,6 +167,13 @@ class StripeStreams {
 
   // Number of rows per row group. Last row group may have fewer rows.
   virtual uint32_t rowsPerRowGroup() const = 0;
+
+  // Key of the given stream in SharedStripeMetadataCache or std::nullopt if
+  // the parsed stream may not be shared with other readers of the file.
+  virtual std::optional<cache::RawFileCacheKey> getStreamCacheKey(
+      const DwrfStreamIdentifier& /*si*/) const {
+    return std::nullopt;
+  }
 };
 
 class StripeStreamsBase : public StripeStreams {
@@ -307,6 +315,9 @@ class StripeStreamsImpl : public StripeStreamsBase {
     return reader_.getReader().getFooter().rowIndexStride();
   }
 
+  std::optional<cache::RawFileCacheKey> getStreamCacheKey(
+      const DwrfStreamIdentifier& si) const override;
+
  private:
   const StreamInformation& getStreamInfo(
       const DwrfStreamIdentifier& si,
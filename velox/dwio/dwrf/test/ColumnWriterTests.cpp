@@ -599,6 +599,78 @@ TEST(ColumnWriterTests, TestBinaryWriterAllNulls) {
   testDataTypeWriter(VARBINARY(), data);
 }
 
+TEST(ColumnWriterTests, TestStringWriterDictionaryInput) {
+  auto pool = addDefaultLeafMemoryPool();
+  // The base has a null and a duplicate value, which must map to a single
+  // dictionary entry.
+  std::vector<std::optional<StringView>> baseData{
+      StringView("apple"),
+      std::nullopt,
+      StringView("banana"),
+      StringView("apple"),
+      StringView("a much longer string than the others")};
+  auto base = populateBatch(baseData, pool.get());
+  const vector_size_t size = 1'000;
+  auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  auto nulls = allocateNulls(size, pool.get());
+  auto* rawNulls = nulls->asMutable<uint64_t>();
+  std::vector<std::optional<StringView>> data;
+  for (auto i = 0; i < size; ++i) {
+    rawIndices[i] = (i * 7) % baseData.size();
+    bits::setNull(rawNulls, i, i % 11 == 0);
+    data.push_back(i % 11 == 0 ? std::nullopt : baseData[rawIndices[i]]);
+  }
+  auto batch = BaseVector::wrapInDictionary(nulls, indices, size, base);
+
+  auto config = std::make_shared<Config>();
+  WriterContext context{config, defaultMemoryManager().addRootPool()};
+  auto rowType = ROW({VARCHAR()});
+  auto dataTypeWithId = TypeWithId::create(VARCHAR(), 1);
+  auto writer = BaseColumnWriter::create(context, *dataTypeWithId);
+  ASSERT_TRUE(writer->useDictionaryEncoding());
+
+  proto::StripeFooter sf;
+  const size_t strideCount = 2;
+  for (auto strideI = 0; strideI < strideCount; ++strideI) {
+    writer->write(batch, common::Ranges::of(0, size));
+    writer->createIndexEntry();
+  }
+  writer->flush([&sf](uint32_t /* unused */) -> proto::ColumnEncoding& {
+    return *sf.add_encoding();
+  });
+  ASSERT_EQ(sf.encoding(0).dictionarysize(), 3);
+
+  TestStripeStreams streams(context, sf, rowType, pool.get());
+  auto typeWithId = TypeWithId::create(rowType);
+  auto reqType = typeWithId->childAt(0);
+  AllocationPool allocPool(pool.get());
+  StreamLabels labels(allocPool);
+  auto reader = ColumnReader::build(
+      reqType,
+      reqType,
+      streams,
+      labels,
+      FlatMapContext{
+          .sequence = 0,
+          .inMapDecoder = nullptr,
+          .keySelectionCallback = nullptr});
+  VectorPtr out;
+  for (auto strideI = 0; strideI < strideCount; ++strideI) {
+    reader->next(size, out);
+    ASSERT_EQ(out->size(), size);
+    auto* values = out->as<SimpleVector<StringView>>();
+    for (auto i = 0; i < size; ++i) {
+      if (data[i].has_value()) {
+        ASSERT_FALSE(out->isNullAt(i)) << i;
+        ASSERT_EQ(values->valueAt(i), data[i].value()) << i;
+      } else {
+        ASSERT_TRUE(out->isNullAt(i)) << i;
+      }
+    }
+  }
+}
+
 template <typename T>
 struct ValueOf {
   static std::string get(const VectorPtr& batch, const uint32_t offset) {
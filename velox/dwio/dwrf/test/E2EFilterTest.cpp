@@ -19,7 +19,9 @@
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/dwrf/writer/FlushPolicy.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 
 using namespace facebook::velox::dwio::common;
@@ -90,6 +92,10 @@ class E2EFilterTest : public E2EFilterTestBase {
     if (!flatmapNodeIdsAsStruct_.empty()) {
       opts.setFlatmapNodeIdsAsStruct(flatmapNodeIdsAsStruct_);
     }
+    if (decodingExecutor_) {
+      opts.setDecodingExecutor(decodingExecutor_);
+      opts.setMinRowsForParallelDecoding(1);
+    }
   }
 
   std::unique_ptr<dwio::common::Reader> makeReader(
@@ -99,12 +105,18 @@ class E2EFilterTest : public E2EFilterTestBase {
   }
 
   std::unordered_set<std::string> flatMapColumns_;
+  std::vector<uint32_t> bloomFilterColumns_;
+  std::shared_ptr<folly::Executor> decodingExecutor_;
 
  private:
   dwrf::WriterOptions createWriterOptions(const TypePtr& type) {
     auto config = std::make_shared<dwrf::Config>();
     config->set(dwrf::Config::COMPRESSION, CompressionKind_NONE);
     config->set(dwrf::Config::USE_VINTS, useVInts_);
+    if (!bloomFilterColumns_.empty()) {
+      config->set<const std::vector<uint32_t>>(
+          dwrf::Config::BLOOM_FILTER_COLUMNS, bloomFilterColumns_);
+    }
     auto writerSchema = type;
     if (!flatMapColumns_.empty()) {
       auto& rowType = type->asRow();
@@ -360,6 +372,24 @@ TEST_F(E2EFilterTest, filterStruct) {
       false);
 }
 
+TEST_F(E2EFilterTest, parallelDecode) {
+  decodingExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  testWithTypes(
+      "long_val:bigint,"
+      "outer_struct: struct<nested1:bigint, "
+      "  data1: string, "
+      "  data2: double, "
+      "  inner_struct: struct<nested2: bigint, data3: smallint, data4: int>>",
+      [&]() {},
+      true,
+      {"long_val",
+       "outer_struct.nested1",
+       "outer_struct.inner_struct.nested2"},
+      20,
+      true,
+      false);
+}
+
 TEST_F(E2EFilterTest, flatMapAsStruct) {
   constexpr auto kColumns =
       "long_val:bigint,"
@@ -395,6 +425,146 @@ TEST_F(E2EFilterTest, flatMap) {
       true);
 }
 
+TEST_F(E2EFilterTest, flatMapKeyFilter) {
+  // Key 1 is in all rows, key 2 in even rows and key 3 in no row.
+  constexpr int32_t kNumRows = 10'000;
+  test::VectorMaker vectorMaker(leafPool_.get());
+  rowType_ = ROW({"id", "m"}, {BIGINT(), MAP(BIGINT(), BIGINT())});
+  std::vector<RowVectorPtr> batches;
+  for (auto batch = 0; batch < 2; ++batch) {
+    const auto firstRow = batch * kNumRows;
+    batches.push_back(vectorMaker.rowVector(
+        {"id", "m"},
+        {vectorMaker.flatVector<int64_t>(
+             kNumRows, [&](auto row) { return firstRow + row; }),
+         vectorMaker.mapVector<int64_t, int64_t>(
+             kNumRows,
+             [](auto row) { return row % 2 == 0 ? 2 : 1; },
+             [](auto /*row*/, auto index) { return index + 1; },
+             [&](auto row, auto index) {
+               return index == 0 ? (firstRow + row) % 100 : firstRow + row;
+             })}));
+  }
+  flatMapColumns_ = {"m"};
+  writeToMemory(rowType_, batches, false);
+
+  auto countRows = [&](const std::string& subfield,
+                       std::unique_ptr<Filter> filter,
+                       std::function<bool(int64_t)> expectedPass) {
+    SCOPED_TRACE(subfield);
+    auto spec = std::make_shared<ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->getOrCreateChild(Subfield(subfield))->setFilter(std::move(filter));
+    ReaderOptions readerOpts{leafPool_.get()};
+    RowReaderOptions rowReaderOpts;
+    std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+    auto input = std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+    auto reader = makeReader(readerOpts, std::move(input));
+    setUpRowReaderOptions(rowReaderOpts, spec);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto result = BaseVector::create(rowType_, 1, leafPool_.get());
+    int64_t numRows = 0;
+    while (rowReader->next(1'000, result)) {
+      auto* rowVector = result->as<RowVector>();
+      auto* ids = rowVector->childAt(0)->loadedVector();
+      auto* maps = rowVector->childAt(1)->loadedVector()->as<MapVector>();
+      for (auto i = 0; i < result->size(); ++i) {
+        auto id = ids->as<SimpleVector<int64_t>>()->valueAt(i);
+        ASSERT_TRUE(expectedPass(id)) << id;
+        // The keys without filters are read for the rows that pass.
+        ASSERT_EQ(maps->sizeAt(i), id % 2 == 0 ? 2 : 1);
+      }
+      numRows += result->size();
+    }
+    int64_t expectedRows = 0;
+    for (auto id = 0; id < 2 * kNumRows; ++id) {
+      expectedRows += expectedPass(id);
+    }
+    ASSERT_EQ(numRows, expectedRows);
+  };
+
+  countRows(
+      "m[1]", std::make_unique<BigintRange>(10, 19, false), [](auto id) {
+        return id % 100 >= 10 && id % 100 < 20;
+      });
+  countRows("m[2]", std::make_unique<IsNull>(), [](auto id) {
+    return id % 2 == 1;
+  });
+  countRows(
+      "m[2]", std::make_unique<BigintRange>(0, 4'999, false), [](auto id) {
+        return id % 2 == 0 && id < 5'000;
+      });
+  countRows(
+      "m[3]", std::make_unique<BigintRange>(0, 100, false), [](auto /*id*/) {
+        return false;
+      });
+}
+
+TEST_F(E2EFilterTest, bloomFilter) {
+  // Each stride has values from the whole range of the column, so that the
+  // stride stats can't skip any. An equality filter matches a row in one
+  // stride and the bloom filters skip the others.
+  constexpr int32_t kNumStrides = 5;
+  constexpr int32_t kStrideSize = 10'000;
+  test::VectorMaker vectorMaker(leafPool_.get());
+  rowType_ = ROW({"long_val", "string_val"}, {BIGINT(), VARCHAR()});
+  std::vector<RowVectorPtr> batches;
+  for (auto stride = 0; stride < kNumStrides; ++stride) {
+    batches.push_back(vectorMaker.rowVector(
+        {"long_val", "string_val"},
+        {vectorMaker.flatVector<int64_t>(
+             kStrideSize,
+             [&](auto row) { return row * kNumStrides + stride; }),
+         vectorMaker.flatVector<StringView>(kStrideSize, [&](auto row) {
+           return StringView::makeInline(
+               fmt::format("s{}", row * kNumStrides + stride));
+         })}));
+  }
+  bloomFilterColumns_ = {0, 1};
+  writeToMemory(rowType_, batches, true);
+
+  auto testFilter = [&](const std::string& column,
+                        std::unique_ptr<Filter> filter,
+                        int64_t expectedValue) {
+    SCOPED_TRACE(column);
+    auto spec = std::make_shared<ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->childByName(column)->setFilter(std::move(filter));
+    ReaderOptions readerOpts{leafPool_.get()};
+    RowReaderOptions rowReaderOpts;
+    std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+    auto input = std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+    auto reader = makeReader(readerOpts, std::move(input));
+    setUpRowReaderOptions(rowReaderOpts, spec);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto result = BaseVector::create(rowType_, 1, leafPool_.get());
+    int64_t numRows = 0;
+    while (rowReader->next(1000, result)) {
+      auto* values = result->as<RowVector>()
+                         ->childAt(0)
+                         ->loadedVector()
+                         ->as<SimpleVector<int64_t>>();
+      for (auto i = 0; i < result->size(); ++i) {
+        ASSERT_EQ(values->valueAt(i), expectedValue);
+      }
+      numRows += result->size();
+    }
+    ASSERT_EQ(numRows, 1);
+    RuntimeStatistics stats;
+    rowReader->updateRuntimeStats(stats);
+    ASSERT_GT(stats.skippedStrides, 0);
+  };
+
+  testFilter(
+      "long_val", std::make_unique<BigintRange>(1'234, 1'234, false), 1'234);
+  testFilter(
+      "string_val",
+      std::make_unique<BytesValues>(std::vector<std::string>{"s4321"}, false),
+      4'321);
+}
+
 TEST_F(E2EFilterTest, metadataFilter) {
   testMetadataFilter();
 }
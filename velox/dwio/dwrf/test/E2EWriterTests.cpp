@@ -801,6 +801,37 @@ TEST_F(E2EWriterTests, PartialStride) {
   ASSERT_EQ(true, reader->columnStatistics(1)->hasNull().value());
 }
 
+TEST_F(E2EWriterTests, reclaim) {
+  auto type = ROW({"c0"}, {BIGINT()});
+  auto sink = std::make_unique<MemorySink>(*leafPool_, 2 * 1024 * 1024);
+  auto sinkPtr = sink.get();
+
+  dwrf::WriterOptions options;
+  options.config = std::make_shared<Config>();
+  options.schema = type;
+  options.memoryPool = rootPool_.get();
+  dwrf::Writer writer{std::move(sink), options};
+  ASSERT_EQ(writer.reclaimableBytes(), 0);
+
+  VectorMaker maker{leafPool_.get()};
+  auto batch = maker.rowVector(
+      {maker.flatVector<int64_t>(1'000, [](auto row) { return row; })});
+  // Each reclaim() writes the open stripe.
+  for (auto i = 0; i < 2; ++i) {
+    writer.write(batch);
+    ASSERT_GT(writer.reclaimableBytes(), 0);
+    writer.reclaim();
+    ASSERT_EQ(writer.reclaimableBytes(), 0);
+  }
+  writer.reclaim();
+  writer.close();
+
+  ReaderOptions readerOpts{defaultPool.get()};
+  auto reader = createReader(*sinkPtr, readerOpts);
+  ASSERT_EQ(reader->getFooter().stripesSize(), 2);
+  ASSERT_EQ(reader->numberOfRows(), 2'000);
+}
+
 TEST_F(E2EWriterTests, OversizeRows) {
   auto pool = facebook::velox::memory::addDefaultLeafMemoryPool();
 
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <random>
+
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/dwrf/common/DecoderUtil.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+namespace {
+
+constexpr int32_t kNumValues = 1'000'000;
+constexpr int32_t kRunSize = 512;
+constexpr int32_t kBatchSize = 1'000;
+
+// Encoded width codes of the fixed bit sizes used below.
+uint32_t encodeWidth(uint32_t width) {
+  return width <= 24 ? width - 1 : width == 32 ? 27 : 29;
+}
+
+void pack(
+    const std::vector<uint64_t>& values,
+    uint32_t width,
+    std::vector<unsigned char>& out) {
+  uint32_t numBits = 0;
+  uint32_t current = 0;
+  for (auto value : values) {
+    for (int32_t bit = width - 1; bit >= 0; --bit) {
+      current = (current << 1) | ((value >> bit) & 1);
+      if (++numBits == 8) {
+        out.push_back(current);
+        numBits = 0;
+        current = 0;
+      }
+    }
+  }
+  if (numBits > 0) {
+    out.push_back(current << (8 - numBits));
+  }
+}
+
+// RLEv2 DIRECT or DELTA runs of random values of 'width' bits.
+std::vector<unsigned char> makeRuns(uint32_t width, bool delta) {
+  std::mt19937 rng(width);
+  const uint64_t mask = (1ULL << width) - 1;
+  std::vector<unsigned char> bytes;
+  for (auto i = 0; i < kNumValues; i += kRunSize) {
+    const uint32_t length = kRunSize - 1;
+    bytes.push_back(
+        ((delta ? 3 : 1) << 6) | (encodeWidth(width) << 1) | (length >> 8));
+    bytes.push_back(length & 0xff);
+    std::vector<uint64_t> values(delta ? kRunSize - 2 : kRunSize);
+    for (auto& value : values) {
+      value = rng() & mask;
+    }
+    if (delta) {
+      // First value 0 and delta base 1 as varints.
+      bytes.push_back(0);
+      bytes.push_back(2);
+    }
+    pack(values, width, bytes);
+  }
+  return bytes;
+}
+
+// Reference bit at a time unpacking of one DIRECT run.
+void unpackScalar(
+    const unsigned char* data,
+    uint32_t width,
+    int32_t numValues,
+    int64_t* result) {
+  uint64_t bitPos = 0;
+  for (auto i = 0; i < numValues; ++i) {
+    uint64_t value = 0;
+    for (uint32_t bit = 0; bit < width; ++bit, ++bitPos) {
+      value = (value << 1) | ((data[bitPos >> 3] >> (7 - (bitPos & 7))) & 1);
+    }
+    result[i] = value;
+  }
+}
+
+std::shared_ptr<memory::MemoryPool> pool;
+
+std::unordered_map<uint64_t, std::vector<unsigned char>> encoded;
+
+const std::vector<unsigned char>& runs(uint32_t width, bool delta) {
+  auto& bytes = encoded[width * 2 + delta];
+  if (bytes.empty()) {
+    bytes = makeRuns(width, delta);
+  }
+  return bytes;
+}
+
+std::unique_ptr<dwio::common::IntDecoder<false>> makeDecoder(
+    const std::vector<unsigned char>& bytes) {
+  return createRleDecoder<false>(
+      std::make_unique<dwio::common::SeekableArrayInputStream>(
+          bytes.data(), bytes.size()),
+      RleVersion_2,
+      *pool,
+      true,
+      dwio::common::INT_BYTE_SIZE);
+}
+
+void decode(uint32_t width, bool delta) {
+  folly::BenchmarkSuspender suspender;
+  auto& bytes = runs(width, delta);
+  auto decoder = makeDecoder(bytes);
+  std::vector<int64_t> data(kBatchSize);
+  suspender.dismiss();
+  for (auto i = 0; i < kNumValues; i += kBatchSize) {
+    decoder->next(data.data(), kBatchSize, nullptr);
+  }
+  folly::doNotOptimizeAway(data);
+}
+
+void decodeScalar(uint32_t width) {
+  folly::BenchmarkSuspender suspender;
+  auto& bytes = runs(width, false);
+  const auto runBytes = 2 + (kRunSize * width + 7) / 8;
+  std::vector<int64_t> data(kRunSize);
+  suspender.dismiss();
+  for (auto i = 0; i < kNumValues / kRunSize; ++i) {
+    unpackScalar(bytes.data() + i * runBytes + 2, width, kRunSize, data.data());
+  }
+  folly::doNotOptimizeAway(data);
+}
+
+void skip(uint32_t width) {
+  folly::BenchmarkSuspender suspender;
+  auto decoder = makeDecoder(runs(width, false));
+  suspender.dismiss();
+  decoder->skip(kNumValues);
+}
+
+} // namespace
+
+BENCHMARK(directScalar7) {
+  decodeScalar(7);
+}
+
+BENCHMARK_RELATIVE(direct7) {
+  decode(7, false);
+}
+
+BENCHMARK(directScalar13) {
+  decodeScalar(13);
+}
+
+BENCHMARK_RELATIVE(direct13) {
+  decode(13, false);
+}
+
+BENCHMARK(directScalar32) {
+  decodeScalar(32);
+}
+
+BENCHMARK_RELATIVE(direct32) {
+  decode(32, false);
+}
+
+BENCHMARK(directScalar48) {
+  decodeScalar(48);
+}
+
+BENCHMARK_RELATIVE(direct48) {
+  decode(48, false);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(delta7) {
+  decode(7, true);
+}
+
+BENCHMARK(delta20) {
+  decode(20, true);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(skipDirect13) {
+  skip(13);
+}
+
+BENCHMARK(skipDirect32) {
+  skip(32);
+}
+
+int32_t main(int32_t argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  pool = memory::addDefaultLeafMemoryPool();
+  folly::runBenchmarks();
+  return 0;
+}
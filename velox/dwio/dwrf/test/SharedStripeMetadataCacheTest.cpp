@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/caching/FileIds.h"
+#include "velox/dwio/dwrf/reader/SharedStripeMetadataCache.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+namespace {
+
+std::unique_ptr<proto::RowIndex> makeRowIndex(int32_t numEntries) {
+  auto index = std::make_unique<proto::RowIndex>();
+  for (auto i = 0; i < numEntries; ++i) {
+    auto* entry = index->add_entry();
+    for (auto j = 0; j < 4; ++j) {
+      entry->add_positions(i * 100 + j);
+    }
+  }
+  return index;
+}
+
+class SharedStripeMetadataCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    lease_ = StringIdLease(fileIds(), "SharedStripeMetadataCacheTest.dwrf");
+    indexBytes_ = makeRowIndex(10)->SpaceUsedLong();
+  }
+
+  cache::RawFileCacheKey key(uint64_t offset) const {
+    return {lease_.id(), offset};
+  }
+
+  StringIdLease lease_;
+  uint64_t indexBytes_;
+};
+
+TEST_F(SharedStripeMetadataCacheTest, hitAndMiss) {
+  SharedStripeMetadataCache cache(indexBytes_ * 10);
+  int32_t numLoads = 0;
+  auto load = [&]() {
+    ++numLoads;
+    return makeRowIndex(10);
+  };
+  auto first = cache.get<proto::RowIndex>(key(100), load);
+  auto second = cache.get<proto::RowIndex>(key(100), load);
+  EXPECT_EQ(1, numLoads);
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(10, second->entry_size());
+  EXPECT_EQ(nullptr, cache.find<proto::RowIndex>(key(200)));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(1, stats.numHits);
+  EXPECT_EQ(2, stats.numMisses);
+  EXPECT_EQ(1, stats.numEntries);
+  EXPECT_EQ(indexBytes_, stats.bytes);
+
+  // Inserting at an existing key keeps the first message.
+  std::shared_ptr<const proto::RowIndex> other = makeRowIndex(10);
+  EXPECT_EQ(first.get(), cache.insert(key(100), other).get());
+
+  cache.clear();
+  stats = cache.stats();
+  EXPECT_EQ(0, stats.numEntries);
+  EXPECT_EQ(0, stats.bytes);
+  // The message outlives its entry.
+  EXPECT_EQ(10, first->entry_size());
+}
+
+TEST_F(SharedStripeMetadataCacheTest, evict) {
+  SharedStripeMetadataCache cache(indexBytes_ * 2 + indexBytes_ / 2);
+  std::shared_ptr<const proto::RowIndex> index = makeRowIndex(10);
+  cache.insert(key(0), index);
+  cache.insert(key(1), index);
+  // Makes 0 the most recently used.
+  EXPECT_NE(nullptr, cache.find<proto::RowIndex>(key(0)));
+  cache.insert(key(2), index);
+
+  auto stats = cache.stats();
+  EXPECT_EQ(1, stats.numEvicts);
+  EXPECT_EQ(2, stats.numEntries);
+  EXPECT_LE(stats.bytes, indexBytes_ * 2 + indexBytes_ / 2);
+  EXPECT_NE(nullptr, cache.find<proto::RowIndex>(key(0)));
+  EXPECT_EQ(nullptr, cache.find<proto::RowIndex>(key(1)));
+  EXPECT_NE(nullptr, cache.find<proto::RowIndex>(key(2)));
+}
+
+TEST_F(SharedStripeMetadataCacheTest, oversized) {
+  SharedStripeMetadataCache cache(indexBytes_);
+  auto index = cache.get<proto::RowIndex>(
+      key(0), []() { return makeRowIndex(1'000); });
+  EXPECT_EQ(1'000, index->entry_size());
+  auto stats = cache.stats();
+  EXPECT_EQ(0, stats.numEntries);
+  EXPECT_EQ(0, stats.bytes);
+  EXPECT_EQ(nullptr, cache.find<proto::RowIndex>(key(0)));
+}
+
+} // namespace
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/StrideBloomFilter.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::dwrf;
+
+TEST(StrideBloomFilterTest, size) {
+  StrideBloomFilter bloomFilter(10'000, 0.05);
+  EXPECT_EQ(bloomFilter.numBits(), 62'400);
+  EXPECT_EQ(bloomFilter.numHashFunctions(), 4);
+}
+
+TEST(StrideBloomFilterTest, hash) {
+  // Murmur3 with the ORC seed. Only the final mix applies to no input.
+  EXPECT_EQ(StrideBloomFilter::hashBytes("", 0), 0x74a18dc8f20adb48ULL);
+}
+
+TEST(StrideBloomFilterTest, addAndTest) {
+  StrideBloomFilter bloomFilter(1'000, 0.05);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    bloomFilter.addLong(i * 7);
+    auto value = fmt::format("value{}", i);
+    bloomFilter.addBytes(value.data(), value.size());
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 10'000; ++i) {
+    if (i % 7 == 0 && i < 7'000) {
+      EXPECT_TRUE(bloomFilter.testLong(i)) << i;
+    } else if (bloomFilter.testLong(i)) {
+      ++numFalsePositives;
+    }
+  }
+  EXPECT_LT(numFalsePositives, 1'000);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    auto value = fmt::format("value{}", i);
+    EXPECT_TRUE(bloomFilter.testBytes(value.data(), value.size())) << value;
+  }
+
+  bloomFilter.reset();
+  EXPECT_FALSE(bloomFilter.testLong(0));
+}
+
+TEST(StrideBloomFilterTest, proto) {
+  StrideBloomFilter bloomFilter(100, 0.01);
+  for (int64_t i = 0; i < 100; ++i) {
+    bloomFilter.addLong(i);
+  }
+  proto::BloomFilter bloomFilterProto;
+  bloomFilter.toProto(bloomFilterProto);
+  EXPECT_EQ(bloomFilterProto.utf8bitset().size() * 8, bloomFilter.numBits());
+
+  StrideBloomFilter copy(bloomFilterProto);
+  EXPECT_EQ(copy.numBits(), bloomFilter.numBits());
+  EXPECT_EQ(copy.numHashFunctions(), bloomFilter.numHashFunctions());
+  for (int64_t i = 0; i < 1'000; ++i) {
+    EXPECT_EQ(copy.testLong(i), bloomFilter.testLong(i)) << i;
+  }
+}
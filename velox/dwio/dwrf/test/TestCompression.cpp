@@ -21,6 +21,7 @@
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 #include <algorithm>
@@ -107,14 +108,15 @@ void compressAndVerify(
     MemoryPool& pool,
     const char* data,
     size_t dataSize,
-    const Encrypter* encrypter) {
+    const Encrypter* encrypter,
+    folly::Executor* executor = nullptr) {
   TestBufferPool bufferPool(pool, block);
   DataBufferHolder holder{
       pool, block, 0, DEFAULT_PAGE_GROW_RATIO, std::addressof(sink)};
   Config config;
   config.set<uint32_t>(Config::COMPRESSION_THRESHOLD, 128);
   std::unique_ptr<BufferedOutputStream> compressStream =
-      createCompressor(kind, bufferPool, holder, config, encrypter);
+      createCompressor(kind, bufferPool, holder, config, encrypter, executor);
 
   size_t pos = 0;
   char* compressBuffer;
@@ -233,6 +235,37 @@ TEST_P(CompressionTest, compressRandomBytes) {
       memSink, kind_, block, testData, dataSize, *pool, decrypter_);
 }
 
+TEST_P(CompressionTest, compressOnExecutor) {
+  auto pool = addDefaultLeafMemoryPool();
+  MemorySink memSink(*pool, DEFAULT_MEM_STREAM_SIZE);
+  MemorySink asyncMemSink(*pool, DEFAULT_MEM_STREAM_SIZE);
+  folly::CPUThreadPoolExecutor executor(4);
+
+  uint64_t block = 1024;
+  constexpr size_t dataSize = 1024 * 1024; // 1M
+
+  char testData[dataSize];
+  generateRandomData(testData, dataSize, true);
+  compressAndVerify(
+      kind_, memSink, block, *pool, testData, dataSize, encrypter_);
+  compressAndVerify(
+      kind_,
+      asyncMemSink,
+      block,
+      *pool,
+      testData,
+      dataSize,
+      encrypter_,
+      &executor);
+  // Pages compressed on 'executor' are written in the same order.
+  ASSERT_EQ(memSink.size(), asyncMemSink.size());
+  EXPECT_EQ(
+      0,
+      std::memcmp(memSink.getData(), asyncMemSink.getData(), memSink.size()));
+  decompressAndVerify(
+      asyncMemSink, kind_, block, testData, dataSize, *pool, decrypter_);
+}
+
 void verifyProto(
     const MemorySink& memSink,
     CompressionKind kind,
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include "velox/common/base/Nulls.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/SeekableInputStream.h"
@@ -666,6 +668,256 @@ TEST(RLEv2, bitsLeftByPreviousStream) {
   }
 };
 
+namespace {
+
+// Writes RLEv2 runs for testing the bulk decoding paths. Values are bit
+// packed most significant bit first.
+class RLEv2Writer {
+ public:
+  void direct(const std::vector<uint64_t>& values, uint32_t width) {
+    header(1, width, values.size());
+    pack(values, width);
+  }
+
+  // Writes a DELTA run of 'firstValue', 'firstValue' + 'deltaBase' and then
+  // the 'deltas' in the direction of 'deltaBase'. 'firstValue' is not zig
+  // zag encoded, as for the unsigned decoder.
+  void delta(
+      int64_t firstValue,
+      int64_t deltaBase,
+      const std::vector<uint64_t>& deltas,
+      uint32_t width) {
+    header(3, width, deltas.size() + 2);
+    varint(static_cast<uint64_t>(firstValue));
+    varint(zigZagEncode(deltaBase));
+    pack(deltas, width);
+  }
+
+  // Writes a DELTA run of 'numValues' values 'deltaBase' apart.
+  void fixedDelta(int64_t firstValue, int64_t deltaBase, uint64_t numValues) {
+    // Width 1 is encoded as 0, which means no packed deltas.
+    header(3, 1, numValues);
+    varint(static_cast<uint64_t>(firstValue));
+    varint(zigZagEncode(deltaBase));
+  }
+
+  const std::vector<unsigned char>& bytes() const {
+    return bytes_;
+  }
+
+ private:
+  static uint32_t encodeWidth(uint32_t width) {
+    if (width <= 24) {
+      return width - 1;
+    }
+    switch (width) {
+      case 26:
+        return 24;
+      case 28:
+        return 25;
+      case 30:
+        return 26;
+      case 32:
+        return 27;
+      case 40:
+        return 28;
+      case 48:
+        return 29;
+      case 56:
+        return 30;
+      default:
+        EXPECT_EQ(64, width);
+        return 31;
+    }
+  }
+
+  void header(uint32_t encoding, uint32_t width, uint64_t numValues) {
+    const auto length = numValues - 1;
+    bytes_.push_back(
+        (encoding << 6) | (encodeWidth(width) << 1) | ((length >> 8) & 1));
+    bytes_.push_back(length & 0xff);
+  }
+
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      bytes_.push_back((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    bytes_.push_back(value);
+  }
+
+  void pack(const std::vector<uint64_t>& values, uint32_t width) {
+    uint32_t numBits = 0;
+    uint32_t current = 0;
+    for (auto value : values) {
+      for (int32_t bit = width - 1; bit >= 0; --bit) {
+        current = (current << 1) | ((value >> bit) & 1);
+        if (++numBits == 8) {
+          bytes_.push_back(current);
+          numBits = 0;
+          current = 0;
+        }
+      }
+    }
+    if (numBits > 0) {
+      bytes_.push_back(current << (8 - numBits));
+    }
+  }
+
+  std::vector<unsigned char> bytes_;
+};
+
+std::unique_ptr<dwio::common::IntDecoder<false>> makeUnsignedRLEv2Decoder(
+    const std::vector<unsigned char>& bytes,
+    uint64_t blockSize,
+    memory::MemoryPool& pool) {
+  return createRleDecoder<false>(
+      std::make_unique<dwio::common::SeekableArrayInputStream>(
+          bytes.data(), bytes.size(), blockSize),
+      RleVersion_2,
+      pool,
+      true /* doesn't matter */,
+      dwio::common::INT_BYTE_SIZE /* doesn't matter */);
+}
+
+} // namespace
+
+TEST(RLEv2, bulkDirectAllWidths) {
+  auto pool = memory::addDefaultLeafMemoryPool();
+  std::mt19937 rng(1);
+  for (uint32_t width :
+       {1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17,
+        18, 19, 20, 21, 22, 23, 24, 26, 28, 30, 32, 40, 48, 56, 64}) {
+    SCOPED_TRACE(fmt::format("width {}", width));
+    const uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+    RLEv2Writer writer;
+    std::vector<uint64_t> expected;
+    for (auto runSize : {512, 100, 3}) {
+      std::vector<uint64_t> run;
+      for (auto i = 0; i < runSize; ++i) {
+        run.push_back(((static_cast<uint64_t>(rng()) << 32) | rng()) & mask);
+      }
+      writer.direct(run, width);
+      expected.insert(expected.end(), run.begin(), run.end());
+    }
+
+    // Small blocks make values span buffers.
+    for (uint64_t blockSize : {0, 13}) {
+      for (uint64_t batchSize : {1, 7, 1000}) {
+        auto decoder =
+            makeUnsignedRLEv2Decoder(writer.bytes(), blockSize, *pool);
+        std::vector<int64_t> data(expected.size());
+        for (uint64_t i = 0; i < expected.size(); i += batchSize) {
+          decoder->next(
+              data.data() + i,
+              std::min(batchSize, expected.size() - i),
+              nullptr);
+        }
+        for (size_t i = 0; i < expected.size(); ++i) {
+          ASSERT_EQ(expected[i], static_cast<uint64_t>(data[i]))
+              << "at " << i << " blockSize " << blockSize << " batchSize "
+              << batchSize;
+        }
+      }
+    }
+  }
+}
+
+TEST(RLEv2, bulkDirectWithNullsAndSkip) {
+  auto pool = memory::addDefaultLeafMemoryPool();
+  constexpr uint32_t kWidth = 11;
+  RLEv2Writer writer;
+  std::vector<uint64_t> expected;
+  for (auto run = 0; run < 4; ++run) {
+    std::vector<uint64_t> values;
+    for (auto i = 0; i < 300; ++i) {
+      values.push_back((run * 300 + i) * 7 % 2048);
+    }
+    writer.direct(values, kWidth);
+    expected.insert(expected.end(), values.begin(), values.end());
+  }
+
+  // Every third row is null and does not consume a value.
+  constexpr int32_t kNumRows = 1'500;
+  std::vector<uint64_t> nulls(bits::nwords(kNumRows), bits::kNotNull64);
+  for (auto i = 0; i < kNumRows; i += 3) {
+    bits::setNull(nulls.data(), i);
+  }
+  auto decoder = makeUnsignedRLEv2Decoder(writer.bytes(), 0, *pool);
+  std::vector<int64_t> data(kNumRows);
+  decoder->next(data.data(), kNumRows, nulls.data());
+  int32_t numValues = 0;
+  for (auto i = 0; i < kNumRows; ++i) {
+    if (!bits::isBitNull(nulls.data(), i)) {
+      ASSERT_EQ(expected[numValues++], data[i]) << "at " << i;
+    }
+  }
+  EXPECT_EQ(1'000, numValues);
+
+  // Skips within and across runs without unpacking.
+  decoder = makeUnsignedRLEv2Decoder(writer.bytes(), 0, *pool);
+  uint64_t row = 0;
+  for (auto skip : {5, 290, 1, 600, 3}) {
+    decoder->skip(skip);
+    row += skip;
+    decoder->next(data.data(), 2, nullptr);
+    EXPECT_EQ(expected[row], data[0]) << "after skipping to " << row;
+    EXPECT_EQ(expected[row + 1], data[1]) << "after skipping to " << row;
+    row += 2;
+  }
+}
+
+TEST(RLEv2, bulkDeltaAndSkip) {
+  auto pool = memory::addDefaultLeafMemoryPool();
+  RLEv2Writer writer;
+  std::vector<int64_t> expected;
+  std::vector<uint64_t> deltas;
+  int64_t value = 1'000;
+  expected.push_back(value);
+  // The second value is first value + delta base.
+  value += 3;
+  expected.push_back(value);
+  for (auto i = 0; i < 398; ++i) {
+    deltas.push_back(i % 13);
+    value += i % 13;
+    expected.push_back(value);
+  }
+  writer.delta(1'000, 3, deltas, 4);
+  deltas.clear();
+  value = 50'000;
+  expected.push_back(value);
+  value -= 2;
+  expected.push_back(value);
+  for (auto i = 0; i < 198; ++i) {
+    deltas.push_back(i % 100);
+    value -= i % 100;
+    expected.push_back(value);
+  }
+  writer.delta(50'000, -2, deltas, 7);
+  writer.fixedDelta(-5, 10, 20);
+  for (auto i = 0; i < 20; ++i) {
+    expected.push_back(-5 + i * 10);
+  }
+
+  auto decoder = makeUnsignedRLEv2Decoder(writer.bytes(), 0, *pool);
+  std::vector<int64_t> data(expected.size());
+  decoder->next(data.data(), expected.size(), nullptr);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], data[i]) << "at " << i;
+  }
+
+  decoder = makeUnsignedRLEv2Decoder(writer.bytes(), 0, *pool);
+  uint64_t row = 0;
+  for (auto skip : {450, 148, 5}) {
+    decoder->skip(skip);
+    row += skip;
+    decoder->next(data.data(), 2, nullptr);
+    EXPECT_EQ(expected[row], data[0]) << "after skipping to " << row;
+    EXPECT_EQ(expected[row + 1], data[1]) << "after skipping to " << row;
+    row += 2;
+  }
+}
+
 TEST(RLEv1, simpleTest) {
   auto pool = memory::addDefaultLeafMemoryPool();
   const unsigned char buffer[] = {
@@ -17,6 +17,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "folly/Random.h"
+#include "folly/executors/CPUThreadPoolExecutor.h"
 #include "velox/dwio/dwrf/writer/WriterSink.h"
 
 using namespace ::testing;
@@ -492,3 +493,50 @@ TEST_F(WriterSinkTests, SetModeOutOfOrder) {
   sink.addBuffer(*pool, data.data(), 10);
   ASSERT_EQ(sink.getChecksum()->getDigest(false), 977966233);
 }
+
+TEST_F(WriterSinkTests, asyncFlush) {
+  auto pool = addDefaultLeafMemoryPool();
+  MemorySink out{*pool, 1024 + 3};
+  Config config;
+  config.set(Config::CHECKSUM_ALGORITHM, proto::ChecksumAlgorithm::NULL_);
+  config.set(Config::STRIPE_CACHE_MODE, StripeCacheMode::NA);
+  folly::CPUThreadPoolExecutor executor(1);
+  WriterSink sink{out, *pool, config};
+  sink.setFlushExecutor(&executor);
+  auto offset = out.size();
+
+  // Buffered until flush() even though 'out' is a buffered sink.
+  sink.addBuffer(*pool, data.data(), data.size());
+  ASSERT_EQ(out.size(), offset);
+  ASSERT_EQ(sink.size(), offset + data.size());
+
+  sink.flush();
+  ASSERT_EQ(sink.size(), offset + data.size());
+  sink.finishFlush();
+  checkOutput(out, offset);
+  ASSERT_EQ(sink.size(), out.size());
+}
+
+TEST_F(WriterSinkTests, asyncFlushOverMemoryBudget) {
+  // Half the capacity of 'pool' is less than the data.
+  auto rootPool = defaultMemoryManager().addRootPool(
+      "asyncFlushOverMemoryBudget", 1'024 * 1'024);
+  auto pool = rootPool->addLeafChild("asyncFlushOverMemoryBudget");
+  auto sinkPool = addDefaultLeafMemoryPool();
+  MemorySink out{*sinkPool, 2 * 1'024 * 1'024};
+  Config config;
+  config.set(Config::CHECKSUM_ALGORITHM, proto::ChecksumAlgorithm::NULL_);
+  config.set(Config::STRIPE_CACHE_MODE, StripeCacheMode::NA);
+  folly::CPUThreadPoolExecutor executor(1);
+  WriterSink sink{out, *pool, config};
+  sink.setFlushExecutor(&executor);
+  auto offset = out.size();
+
+  for (auto i = 0; i < 600; ++i) {
+    sink.addBuffer(*pool, data.data(), data.size());
+  }
+  // Written synchronously.
+  sink.flush();
+  ASSERT_EQ(out.size() - offset, 600 * data.size());
+  ASSERT_EQ(sink.size(), out.size());
+}
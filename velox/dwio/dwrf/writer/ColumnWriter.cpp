@@ -299,6 +299,9 @@ class IntegerColumnWriter : public BaseColumnWriter {
     fileStatsBuilder_->merge(*indexStatsBuilder_, /*ignoreSize=*/true);
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
+    if (bloomFilterBuilder_) {
+      bloomFilterBuilder_->addEntry();
+    }
     indexStatsBuilder_->reset();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
@@ -506,10 +509,14 @@ uint64_t IntegerColumnWriter<T>::writeDict(
   writeNulls(decodedVector, ranges);
   // make sure we have enough space
   rows_.reserve(rows_.size() + ranges.size());
+  auto* bloomFilter = strideBloomFilter();
   auto processRow = [&](vector_size_t pos) {
     T value = decodedVector.valueAt<T>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(value));
     statsBuilder.addValues(value);
+    if (bloomFilter) {
+      bloomFilter->addLong(value);
+    }
   };
 
   uint64_t nullCount = 0;
@@ -552,6 +559,13 @@ uint64_t IntegerColumnWriter<T>::writeDirect(
       dynamic_cast<IntegerStatisticsBuilder&>(*indexStatsBuilder_),
       slice,
       ranges);
+  if (auto* bloomFilter = strideBloomFilter()) {
+    for (auto& pos : ranges) {
+      if (!nulls || !bits::isBitNull(nulls, pos)) {
+        bloomFilter->addLong(vals[pos]);
+      }
+    }
+  }
   auto rawSize = count * sizeof(T) + (ranges.size() - count) * NULL_SIZE;
   indexStatsBuilder_->increaseRawSize(rawSize);
   return rawSize;
@@ -893,6 +907,9 @@ class StringColumnWriter : public BaseColumnWriter {
     fileStatsBuilder_->merge(*indexStatsBuilder_, /*ignoreSize=*/true);
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
+    if (bloomFilterBuilder_) {
+      bloomFilterBuilder_->addEntry();
+    }
     indexStatsBuilder_->reset();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
@@ -1109,15 +1126,53 @@ uint64_t StringColumnWriter::writeDict(
   rows_.reserve(rows_.size() + ranges.size());
   size_t strideIndex = strideOffsets_.size() - 1;
   uint64_t rawSize = 0;
+  auto* bloomFilter = strideBloomFilter();
   auto processRow = [&](size_t pos) {
     auto sp = decodedVector.valueAt<StringView>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(sp, strideIndex));
     statsBuilder.addValues(sp);
+    if (bloomFilter) {
+      bloomFilter->addBytes(sp.data(), sp.size());
+    }
     rawSize += sp.size();
   };
 
   uint64_t nullCount = 0;
-  if (decodedVector.mayHaveNulls()) {
+  const auto baseSize = decodedVector.base()->size();
+  if (!decodedVector.isIdentityMapping() && baseSize <= ranges.size()) {
+    // Dictionary encoded input, e.g. from a scan, is added to 'dictEncoder_'
+    // once per distinct base value with the count of its rows instead of
+    // hashing every row. 'baseKeys' holds the dictionary index + 1 of each
+    // base value, 0 until it is added.
+    auto& pool = getMemoryPool(MemoryUsageCategory::GENERAL);
+    DataBuffer<uint32_t> baseCounts{pool, baseSize};
+    DataBuffer<uint32_t> baseKeys{pool, baseSize};
+    for (auto& pos : ranges) {
+      if (decodedVector.isNullAt(pos)) {
+        ++nullCount;
+      } else {
+        ++baseCounts[decodedVector.index(pos)];
+      }
+    }
+    for (auto& pos : ranges) {
+      if (decodedVector.isNullAt(pos)) {
+        continue;
+      }
+      const auto baseIndex = decodedVector.index(pos);
+      auto& key = baseKeys[baseIndex];
+      if (key == 0) {
+        const auto count = baseCounts[baseIndex];
+        auto sp = decodedVector.valueAt<StringView>(pos);
+        key = dictEncoder_.addKey(sp, strideIndex, count) + 1;
+        statsBuilder.addValues(sp, count);
+        if (bloomFilter) {
+          bloomFilter->addBytes(sp.data(), sp.size());
+        }
+        rawSize += sp.size() * count;
+      }
+      rows_.unsafeAppend(key - 1);
+    }
+  } else if (decodedVector.mayHaveNulls()) {
     for (auto& pos : ranges) {
       if (decodedVector.isNullAt(pos)) {
         ++nullCount;
@@ -1153,11 +1208,15 @@ uint64_t StringColumnWriter::writeDirect(
   lengths.reserve(ranges.size());
 
   uint64_t rawSize = 0;
+  auto* bloomFilter = strideBloomFilter();
   auto processRow = [&](size_t pos) {
     auto sp = decodedVector.valueAt<StringView>(pos);
     auto size = sp.size();
     dataDirect_->write(sp.data(), size);
     statsBuilder.addValues(sp);
+    if (bloomFilter) {
+      bloomFilter->addBytes(sp.data(), size);
+    }
     rawSize += size;
     lengths.unsafeAppend(size);
   };
@@ -1952,6 +2011,31 @@ uint64_t MapColumnWriter::write(
 
 } // namespace
 
+bool BaseColumnWriter::shouldWriteBloomFilter() const {
+  // Bloom filters are written for top level columns only, not for the values
+  // of flat maps.
+  if (sequence_ != 0 || type_.parent == nullptr || type_.parent->id != 0) {
+    return false;
+  }
+  const auto& bloomFilterCols = getConfig(Config::BLOOM_FILTER_COLUMNS);
+  if (std::find(bloomFilterCols.begin(), bloomFilterCols.end(), type_.column) ==
+      bloomFilterCols.end()) {
+    return false;
+  }
+  switch (type_.type->kind()) {
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::VARCHAR:
+      return true;
+    default:
+      DWIO_RAISE(fmt::format(
+          "BLOOM_FILTER_COLUMNS contains column {} of unsupported type {}",
+          type_.column,
+          mapTypeKindToName(type_.type->kind())));
+  }
+}
+
 std::unique_ptr<BaseColumnWriter> BaseColumnWriter::create(
     WriterContext& context,
     const TypeWithId& type,
@@ -83,6 +83,9 @@ class BaseColumnWriter : public ColumnWriter {
     // time, yet we need to maintain and aggregate logical stats.
     fileStatsBuilder_->merge(*indexStatsBuilder_, /*ignoreSize=*/true);
     indexBuilder_->addEntry(*indexStatsBuilder_);
+    if (bloomFilterBuilder_) {
+      bloomFilterBuilder_->addEntry();
+    }
     indexStatsBuilder_->reset();
     recordPosition();
     for (auto& child : children_) {
@@ -117,6 +120,9 @@ class BaseColumnWriter : public ColumnWriter {
     setEncoding(encoding);
     encodingOverride(encoding);
     indexBuilder_->flush();
+    if (bloomFilterBuilder_) {
+      bloomFilterBuilder_->flush();
+    }
   }
 
   uint64_t writeFileStats(std::function<proto::ColumnStatistics&(uint32_t)>
@@ -171,6 +177,12 @@ class BaseColumnWriter : public ColumnWriter {
     auto options = StatisticsBuilderOptions::fromConfig(context.getConfigs());
     indexStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
     fileStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
+    if (shouldWriteBloomFilter()) {
+      bloomFilterBuilder_ = std::make_unique<BloomFilterIndexBuilder>(
+          newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8),
+          context_.indexStride,
+          getConfig(Config::BLOOM_FILTER_FPP));
+    }
   }
 
   uint64_t writeNulls(const VectorPtr& slice, const common::Ranges& ranges) {
@@ -256,9 +268,19 @@ class BaseColumnWriter : public ColumnWriter {
       const VectorPtr& slice,
       const common::Ranges& ranges);
 
+  // Returns true if the column is in Config::BLOOM_FILTER_COLUMNS. Throws if
+  // its type has no bloom filter support.
+  bool shouldWriteBloomFilter() const;
+
+  // The bloom filter of the current stride or nullptr if the column has none.
+  StrideBloomFilter* strideBloomFilter() {
+    return bloomFilterBuilder_ ? &bloomFilterBuilder_->bloomFilter() : nullptr;
+  }
+
   const dwio::common::TypeWithId& type_;
   std::vector<std::unique_ptr<BaseColumnWriter>> children_;
   std::unique_ptr<IndexBuilder> indexBuilder_;
+  std::unique_ptr<BloomFilterIndexBuilder> bloomFilterBuilder_;
   std::unique_ptr<StatisticsBuilder> indexStatsBuilder_;
   std::unique_ptr<StatisticsBuilder> fileStatsBuilder_;
 
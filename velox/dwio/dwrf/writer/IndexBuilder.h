@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/dwio/dwrf/common/OutputStream.h"
+#include "velox/dwio/dwrf/common/StrideBloomFilter.h"
 #include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
 #include "velox/dwio/dwrf/writer/StatisticsBuilder.h"
 
@@ -101,4 +102,37 @@ class IndexBuilder : public PositionRecorder {
   }
 };
 
+// Builds the BLOOM_FILTER_UTF8 stream of a column with one bloom filter per
+// row index entry.
+class BloomFilterIndexBuilder {
+ public:
+  BloomFilterIndexBuilder(
+      std::unique_ptr<BufferedOutputStream> out,
+      uint64_t expectedEntries,
+      double fpp)
+      : out_{std::move(out)}, bloomFilter_{expectedEntries, fpp} {}
+
+  // The bloom filter of the current stride.
+  StrideBloomFilter& bloomFilter() {
+    return bloomFilter_;
+  }
+
+  void addEntry() {
+    bloomFilter_.toProto(*index_.add_bloomfilter());
+    bloomFilter_.reset();
+  }
+
+  void flush() {
+    index_.SerializeToZeroCopyStream(out_.get());
+    out_->flush();
+    index_.Clear();
+    bloomFilter_.reset();
+  }
+
+ private:
+  std::unique_ptr<BufferedOutputStream> out_;
+  proto::BloomFilterIndex index_;
+  StrideBloomFilter bloomFilter_;
+};
+
 } // namespace facebook::velox::dwrf
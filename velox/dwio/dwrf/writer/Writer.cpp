@@ -488,6 +488,19 @@ void Writer::flush() {
   flushInternal(false);
 }
 
+uint64_t Writer::reclaimableBytes() const {
+  const auto& context = writerBase_->getContext();
+  return context.stripeRowCount > 0 ? context.getTotalMemoryUsage() : 0;
+}
+
+void Writer::reclaim() {
+  if (writerBase_->getContext().stripeRowCount == 0) {
+    return;
+  }
+  flushInternal(false);
+  writerBase_->getSink().finishFlush();
+}
+
 void Writer::close() {
   auto exitGuard = folly::makeGuard([this]() { flushPolicy_->onClose(); });
   flushInternal(true);
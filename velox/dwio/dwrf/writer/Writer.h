@@ -42,6 +42,12 @@ struct WriterOptions {
   std::shared_ptr<encryption::EncryptionSpecification> encryptionSpec;
   std::shared_ptr<dwio::common::encryption::EncrypterFactory> encrypterFactory;
   int64_t memoryBudget = std::numeric_limits<int64_t>::max();
+  // If set, full compression blocks are compressed in parallel on this
+  // executor while the writer keeps encoding.
+  std::shared_ptr<folly::Executor> compressionExecutor;
+  // If set, finished stripes are written to the sink on this executor while
+  // the writer encodes the next stripe.
+  std::shared_ptr<folly::Executor> flushExecutor;
   std::function<std::unique_ptr<ColumnWriter>(
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
@@ -76,6 +82,10 @@ class Writer : public dwio::common::Writer {
     writerBase_->initContext(
         options.config, std::move(pool), std::move(handler));
     auto& context = writerBase_->getContext();
+    compressionExecutor_ = options.compressionExecutor;
+    context.setCompressionExecutor(compressionExecutor_.get());
+    flushExecutor_ = options.flushExecutor;
+    writerBase_->getSink().setFlushExecutor(flushExecutor_.get());
     context.buildPhysicalSizeAggregators(*schema_);
     if (!options.flushPolicyFactory) {
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
@@ -116,6 +126,13 @@ class Writer : public dwio::common::Writer {
   // Forces the writer to flush, does not close the writer.
   virtual void flush() override;
 
+  // Returns the memory of the writer if there is an open stripe.
+  uint64_t reclaimableBytes() const override;
+
+  // Flushes the open stripe and waits for its buffers to be written to the
+  // sink.
+  void reclaim() override;
+
   virtual void close() override;
 
   void setLowMemoryMode();
@@ -161,6 +178,9 @@ class Writer : public dwio::common::Writer {
     writerBase_->getContext().indexRowCount = 0;
   }
 
+  // Kept live for the streams of 'writer_'.
+  std::shared_ptr<folly::Executor> compressionExecutor_;
+  std::shared_ptr<folly::Executor> flushExecutor_;
   const std::shared_ptr<const dwio::common::TypeWithId> schema_;
   std::unique_ptr<DWRFFlushPolicy> flushPolicy_;
   std::unique_ptr<LayoutPlanner> layoutPlanner_;
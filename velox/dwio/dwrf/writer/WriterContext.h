@@ -132,7 +132,14 @@ class WriterContext : public CompressionBufferPool {
       dwio::common::CompressionKind kind,
       DataBufferHolder& holder,
       const dwio::common::encryption::Encrypter* encrypter = nullptr) {
-    return createCompressor(kind, *this, holder, *config_, encrypter);
+    return createCompressor(
+        kind, *this, holder, *config_, encrypter, compressionExecutor_);
+  }
+
+  // Sets the executor for compressing full pages of the streams made after
+  // this call. nullptr compresses on the writer thread.
+  void setCompressionExecutor(folly::Executor* executor) {
+    compressionExecutor_ = executor;
   }
 
   template <typename T>
@@ -531,6 +538,7 @@ class WriterContext : public CompressionBufferPool {
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
   std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  folly::Executor* compressionExecutor_{nullptr};
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
   // Reusable SelectivityVector
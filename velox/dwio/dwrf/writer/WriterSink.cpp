@@ -16,8 +16,53 @@
 
 #include "velox/dwio/dwrf/writer/WriterSink.h"
 
+#include <folly/ScopeGuard.h>
+
 namespace facebook::velox::dwrf {
 
+WriterSink::~WriterSink() {
+  // The flush in flight references 'this'.
+  try {
+    finishFlush();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Error flushing writer sink: " << e.what();
+  }
+  if (!buffers_.empty() || size_ != 0) {
+    LOG(WARNING) << "Unflushed data in writer sink!";
+  }
+}
+
+void WriterSink::flush() {
+  finishFlush();
+  if (!flushExecutor_ || size_ == 0 ||
+      size_ > static_cast<uint64_t>(pool_.maxCapacity()) / 2) {
+    sink_.write(buffers_);
+    buffers_.clear();
+    size_ = 0;
+    return;
+  }
+  flushedSize_ = sink_.size() + size_;
+  flushingBuffers_ = std::move(buffers_);
+  buffers_.clear();
+  size_ = 0;
+  pendingFlush_ = std::make_shared<AsyncSource<bool>>([this]() {
+    sink_.write(flushingBuffers_);
+    return std::make_unique<bool>(true);
+  });
+  flushExecutor_->add([flush = pendingFlush_]() { flush->prepare(); });
+}
+
+void WriterSink::finishFlush() {
+  if (!pendingFlush_) {
+    return;
+  }
+  auto flush = std::move(pendingFlush_);
+  SCOPE_EXIT {
+    flushingBuffers_.clear();
+  };
+  flush->move();
+}
+
 void WriterSink::addBuffer(dwio::common::DataBuffer<char> buffer) {
   auto length = buffer.size();
   if (length > 0) {
@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <folly/container/Array.h>
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/dwrf/common/Checksum.h"
 #include "velox/dwio/dwrf/common/Config.h"
 #include "velox/dwio/dwrf/common/DataBufferHolder.h"
@@ -41,6 +43,7 @@ class WriterSink {
       memory::MemoryPool& pool,
       const Config& configs)
       : sink_{sink},
+        pool_{pool},
         checksum_{
             ChecksumFactory::create(configs.get(Config::CHECKSUM_ALGORITHM))},
         cacheMode_{configs.get(Config::STRIPE_CACHE_MODE)},
@@ -60,14 +63,23 @@ class WriterSink {
     addBuffer(pool, ORC_MAGIC.data(), ORC_MAGIC_LEN);
   }
 
-  ~WriterSink() {
-    if (!buffers_.empty() || size_ != 0) {
-      LOG(WARNING) << "Unflushed data in writer sink!";
-    }
-  }
+  ~WriterSink();
 
   uint64_t size() const {
-    return sink_.size() + size_;
+    // 'sink_' is being written by a background flush.
+    return (pendingFlush_ ? flushedSize_ : sink_.size()) + size_;
+  }
+
+  // Makes flush() write the buffered data to the sink on 'executor' while the
+  // writer encodes the next stripe. The data is buffered even if the sink is
+  // buffered. At most one flush is in flight. A flush larger than half the
+  // capacity of the writer's memory pool is written synchronously, so that
+  // the stripe in flight and the stripe being encoded stay within the pool.
+  void setFlushExecutor(folly::Executor* executor) {
+    flushExecutor_ = executor;
+    if (flushExecutor_) {
+      shouldBuffer_ = true;
+    }
   }
 
   void addBuffer(memory::MemoryPool& pool, const char* data, size_t size) {
@@ -86,11 +98,10 @@ class WriterSink {
     other.clear();
   }
 
-  void flush() {
-    sink_.write(buffers_);
-    buffers_.clear();
-    size_ = 0;
-  }
+  void flush();
+
+  // Waits for the flush in flight, if any, and rethrows its error.
+  void finishFlush();
 
   Checksum* getChecksum() {
     return checksum_.get();
@@ -131,6 +142,7 @@ class WriterSink {
 
  private:
   dwio::common::DataSink& sink_;
+  memory::MemoryPool& pool_;
   std::unique_ptr<Checksum> checksum_;
   StripeCacheMode cacheMode_;
   Mode mode_;
@@ -146,6 +158,13 @@ class WriterSink {
 
   std::vector<dwio::common::DataBuffer<char>> buffers_;
 
+  folly::Executor* flushExecutor_{nullptr};
+  // Flush in flight on 'flushExecutor_' and its buffers.
+  std::shared_ptr<AsyncSource<bool>> pendingFlush_;
+  std::vector<dwio::common::DataBuffer<char>> flushingBuffers_;
+  // Size of 'sink_' after the flush in flight.
+  uint64_t flushedSize_{0};
+
   bool shouldChecksum() {
     // checksum is captured in all modes except None and if checksum algorithm
     // is available
@@ -17,14 +17,27 @@
 #include "velox/dwio/parquet/RegisterParquetWriter.h"
 
 #ifdef VELOX_ENABLE_PARQUET
+#include "velox/dwio/parquet/writer/NativeWriter.h"
 #include "velox/dwio/parquet/writer/Writer.h"
 #endif
 
 namespace facebook::velox::parquet {
 
-void registerParquetWriterFactory() {
+void registerParquetWriterFactory(ParquetWriterType parquetWriterType) {
 #ifdef VELOX_ENABLE_PARQUET
-  dwio::common::registerWriterFactory(std::make_shared<ParquetWriterFactory>());
+  switch (parquetWriterType) {
+    case ParquetWriterType::ARROW:
+      dwio::common::registerWriterFactory(
+          std::make_shared<ParquetWriterFactory>());
+      break;
+    case ParquetWriterType::NATIVE:
+      dwio::common::registerWriterFactory(
+          std::make_shared<NativeParquetWriterFactory>());
+      break;
+    default:
+      VELOX_UNSUPPORTED(
+          "Velox does not support ParquetWriterType ", parquetWriterType);
+  }
 #endif
 }
 
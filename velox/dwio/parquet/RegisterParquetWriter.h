@@ -18,7 +18,10 @@
 
 namespace facebook::velox::parquet {
 
-void registerParquetWriterFactory();
+enum class ParquetWriterType { ARROW, NATIVE };
+
+void registerParquetWriterFactory(
+    ParquetWriterType parquetWriterType = ParquetWriterType::ARROW);
 
 void unregisterParquetWriterFactory();
 
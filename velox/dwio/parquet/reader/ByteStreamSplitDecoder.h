@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Nulls.h"
+#include "velox/common/base/RawVector.h"
+#include "velox/dwio/common/DecoderUtil.h"
+
+namespace facebook::velox::parquet {
+
+// Decodes BYTE_STREAM_SPLIT data of FLOAT or DOUBLE values. The data of n
+// values of k bytes is k streams of n bytes, where stream i has byte i of
+// each value. Values are decoded in batches by transposing the streams, which
+// the compiler vectorizes for the fixed value sizes.
+class ByteStreamSplitDecoder {
+ public:
+  ByteStreamSplitDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end,
+      int32_t valueSize)
+      : data_(reinterpret_cast<const uint8_t*>(start)),
+        valueSize_(valueSize),
+        numValues_((end - start) / valueSize) {
+    VELOX_CHECK(valueSize_ == sizeof(float) || valueSize_ == sizeof(double));
+    VELOX_CHECK_EQ(
+        (end - start) % valueSize_, 0, "Invalid BYTE_STREAM_SPLIT data size");
+    buffer_.resize(kBatchSize * valueSize_);
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    // Skips the buffered values first, then whole values in the streams.
+    const auto numBuffered = numBuffered_ - bufferIndex_;
+    if (numValues <= numBuffered) {
+      bufferIndex_ += numValues;
+      return;
+    }
+    bufferIndex_ = numBuffered_;
+    nextValue_ += numValues - numBuffered;
+    VELOX_CHECK_LE(nextValue_, numValues_);
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    using T = typename Visitor::DataType;
+    if constexpr (std::is_floating_point_v<T>) {
+      VELOX_CHECK_EQ(sizeof(T), valueSize_);
+      int32_t current = visitor.start();
+      skip<hasNulls>(current, 0, nulls);
+      int32_t toSkip;
+      bool atEnd = false;
+      const bool allowNulls = hasNulls && visitor.allowNulls();
+      for (;;) {
+        if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+          toSkip = visitor.processNull(atEnd);
+        } else {
+          if (hasNulls && !allowNulls) {
+            toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+            if (!Visitor::dense) {
+              skip<false>(toSkip, current, nullptr);
+            }
+            if (atEnd) {
+              return;
+            }
+          }
+
+          // We are at a non-null value on a row to visit.
+          toSkip = visitor.process(read<T>(), atEnd);
+        }
+        ++current;
+        if (toSkip) {
+          skip<hasNulls>(toSkip, current, nulls);
+          current += toSkip;
+        }
+        if (atEnd) {
+          return;
+        }
+      }
+    } else {
+      VELOX_FAIL("BYTE_STREAM_SPLIT is only supported for FLOAT and DOUBLE");
+    }
+  }
+
+  template <typename T>
+  T read() {
+    if (bufferIndex_ == numBuffered_) {
+      if (valueSize_ == sizeof(float)) {
+        decodeBatch<sizeof(float)>();
+      } else {
+        decodeBatch<sizeof(double)>();
+      }
+    }
+    T value;
+    memcpy(&value, buffer_.data() + bufferIndex_++ * sizeof(T), sizeof(T));
+    return value;
+  }
+
+ private:
+  static constexpr int32_t kBatchSize = 256;
+
+  // Transposes the next batch of values from the streams into 'buffer_'.
+  template <int32_t kValueSize>
+  void decodeBatch() {
+    VELOX_CHECK_LT(nextValue_, numValues_, "Reading past end of page");
+    numBuffered_ = std::min<int64_t>(kBatchSize, numValues_ - nextValue_);
+    auto* output = buffer_.data();
+    for (auto byte = 0; byte < kValueSize; ++byte) {
+      const auto* stream = data_ + byte * numValues_ + nextValue_;
+      for (auto i = 0; i < numBuffered_; ++i) {
+        output[i * kValueSize + byte] = stream[i];
+      }
+    }
+    nextValue_ += numBuffered_;
+    bufferIndex_ = 0;
+  }
+
+  const uint8_t* FOLLY_NONNULL const data_;
+  const int32_t valueSize_;
+  const int64_t numValues_;
+
+  // Index of the first value that is not in 'buffer_'.
+  int64_t nextValue_{0};
+
+  // Decoded values.
+  raw_vector<uint8_t> buffer_;
+  int32_t numBuffered_{0};
+  int32_t bufferIndex_{0};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Nulls.h"
+#include "velox/common/base/RawVector.h"
+#include "velox/common/base/SimdUtil.h"
+#include "velox/dwio/common/BitPackDecoder.h"
+#include "velox/dwio/common/DecoderUtil.h"
+
+namespace facebook::velox::parquet {
+
+// Decodes DELTA_BINARY_PACKED data. The data is a header with the block size,
+// the number of miniblocks per block, the number of values and the first
+// value, followed by blocks of bit packed deltas. Each block has a min delta
+// and a bit width for each of its miniblocks. Deltas are added in unsigned 64
+// bit arithmetic so that the low 32 bits are right for INT32 data, see
+// 'int32'.
+class DeltaBpDecoder {
+ public:
+  // If 'int32' is set, values are truncated to 32 bits.
+  DeltaBpDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end,
+      bool int32 = false)
+      : bufferStart_(start), bufferEnd_(end), int32_(int32) {
+    blockSize_ = readVarint();
+    miniblocksPerBlock_ = readVarint();
+    numValues_ = readVarint();
+    last_ = readZigzag();
+    VELOX_CHECK_GT(miniblocksPerBlock_, 0);
+    VELOX_CHECK(
+        blockSize_ > 0 && blockSize_ % 128 == 0,
+        "Invalid DELTA_BINARY_PACKED block size {}",
+        blockSize_);
+    valuesPerMiniblock_ = blockSize_ / miniblocksPerBlock_;
+    VELOX_CHECK_EQ(
+        valuesPerMiniblock_ % 32, 0, "Invalid DELTA_BINARY_PACKED miniblock");
+    bitWidths_.resize(miniblocksPerBlock_);
+    miniblockIndex_ = miniblocksPerBlock_;
+    // The first value is in the header.
+    values_.resize(valuesPerMiniblock_);
+    values_[0] = last_;
+    numBuffered_ = numValues_ > 0 ? 1 : 0;
+    numUnread_ = numValues_ - numBuffered_;
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    while (numValues > 0) {
+      if (bufferIndex_ == numBuffered_) {
+        readMiniblock();
+      }
+      const auto numSkipped =
+          std::min<int32_t>(numValues, numBuffered_ - bufferIndex_);
+      bufferIndex_ += numSkipped;
+      numValues -= numSkipped;
+    }
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        toSkip = visitor.process(readLong(), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+  int64_t readLong() {
+    if (bufferIndex_ == numBuffered_) {
+      readMiniblock();
+    }
+    const auto value = values_[bufferIndex_++];
+    return int32_ ? static_cast<int32_t>(value) : static_cast<int64_t>(value);
+  }
+
+  // Returns the total number of values in the encoded data.
+  int64_t numValues() const {
+    return numValues_;
+  }
+
+  // Decodes all remaining values and returns the first byte after the
+  // encoded data. Used for the lengths in front of DELTA_LENGTH_BYTE_ARRAY
+  // data.
+  const char* FOLLY_NONNULL skipToEnd() {
+    while (numUnread_ > 0) {
+      readMiniblock();
+    }
+    bufferIndex_ = numBuffered_;
+    return bufferStart_;
+  }
+
+ private:
+  uint64_t readVarint() {
+    uint64_t result = 0;
+    for (auto shift = 0; shift < 64; shift += 7) {
+      VELOX_CHECK_LT(bufferStart_, bufferEnd_, "Truncated varint");
+      const uint8_t byte = *bufferStart_++;
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return result;
+      }
+    }
+    VELOX_FAIL("Invalid varint");
+  }
+
+  uint64_t readZigzag() {
+    const auto value = readVarint();
+    return (value >> 1) ^ -(value & 1);
+  }
+
+  void readBlockHeader() {
+    minDelta_ = readZigzag();
+    VELOX_CHECK_LE(
+        bufferStart_ + miniblocksPerBlock_, bufferEnd_, "Truncated block");
+    for (auto i = 0; i < miniblocksPerBlock_; ++i) {
+      // Unused trailing miniblocks may have any bit width, so these are
+      // checked only when decoded.
+      bitWidths_[i] = *bufferStart_++;
+    }
+    miniblockIndex_ = 0;
+  }
+
+  // Decodes the next miniblock into 'values_'.
+  void readMiniblock() {
+    VELOX_CHECK_GT(numUnread_, 0, "Reading past end of DELTA_BINARY_PACKED");
+    if (miniblockIndex_ == miniblocksPerBlock_) {
+      readBlockHeader();
+    }
+    const auto bitWidth = bitWidths_[miniblockIndex_++];
+    VELOX_CHECK_LE(bitWidth, 64, "Invalid miniblock bit width");
+    // A miniblock is padded to full size even if it has fewer values.
+    const uint64_t numBytes = valuesPerMiniblock_ * bitWidth / 8;
+    VELOX_CHECK_LE(bufferStart_ + numBytes, bufferEnd_, "Truncated miniblock");
+    unpackDeltas(bitWidth, numBytes);
+    bufferStart_ += numBytes;
+    numBuffered_ = std::min<int64_t>(valuesPerMiniblock_, numUnread_);
+    numUnread_ -= numBuffered_;
+    bufferIndex_ = 0;
+    for (auto i = 0; i < numBuffered_; ++i) {
+      last_ += minDelta_ + values_[i];
+      values_[i] = last_;
+    }
+  }
+
+  // Unpacks the 'bitWidth' bit deltas of a miniblock of 'numBytes' bytes at
+  // 'bufferStart_' into 'values_'.
+  void unpackDeltas(uint8_t bitWidth, uint64_t numBytes) {
+    if (bitWidth == 0) {
+      std::fill(values_.begin(), values_.end(), 0);
+      return;
+    }
+    const auto* input = reinterpret_cast<const uint8_t*>(bufferStart_);
+    if (static_cast<uint64_t>(bufferEnd_ - bufferStart_) <
+        numBytes + simd::kPadding) {
+      // The SIMD unpack may read past the end of the miniblock.
+      padded_.resize(numBytes + simd::kPadding);
+      memcpy(padded_.data(), bufferStart_, numBytes);
+      input = padded_.data();
+    }
+    if (bitWidth <= 32) {
+      packed_.resize(valuesPerMiniblock_);
+      auto* output = packed_.data();
+      dwio::common::unpack<uint32_t>(
+          input, numBytes, valuesPerMiniblock_, bitWidth, output);
+      for (auto i = 0; i < valuesPerMiniblock_; ++i) {
+        values_[i] = packed_[i];
+      }
+      return;
+    }
+    const uint64_t mask = bitWidth == 64 ? ~0UL : (1UL << bitWidth) - 1;
+    for (auto i = 0; i < valuesPerMiniblock_; ++i) {
+      const uint64_t bit = static_cast<uint64_t>(i) * bitWidth;
+      const auto* word = input + bit / 8;
+      const auto shift = bit % 8;
+      uint64_t value;
+      memcpy(&value, word, sizeof(value));
+      value >>= shift;
+      if (shift + bitWidth > 64) {
+        value |= static_cast<uint64_t>(word[8]) << (64 - shift);
+      }
+      values_[i] = value & mask;
+    }
+  }
+
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL bufferEnd_;
+  const bool int32_;
+
+  uint64_t blockSize_;
+  uint64_t miniblocksPerBlock_;
+  uint64_t valuesPerMiniblock_;
+  int64_t numValues_;
+
+  // Number of values not yet decoded into 'values_'.
+  int64_t numUnread_;
+
+  uint64_t minDelta_{0};
+  std::vector<uint8_t> bitWidths_;
+  uint64_t miniblockIndex_;
+
+  // The last decoded value.
+  uint64_t last_;
+
+  // Decoded values of the current miniblock.
+  raw_vector<uint64_t> values_;
+  int32_t numBuffered_{0};
+  int32_t bufferIndex_{0};
+
+  raw_vector<uint32_t> packed_;
+  raw_vector<uint8_t> padded_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+
+#include <string>
+
+namespace facebook::velox::parquet {
+
+// Decodes DELTA_LENGTH_BYTE_ARRAY and DELTA_BYTE_ARRAY data.
+// DELTA_LENGTH_BYTE_ARRAY is the DELTA_BINARY_PACKED lengths of all values
+// followed by the concatenated values. DELTA_BYTE_ARRAY is the
+// DELTA_BINARY_PACKED lengths of the prefixes each value shares with the
+// previous value followed by the suffixes as DELTA_LENGTH_BYTE_ARRAY.
+class DeltaByteArrayDecoder {
+ public:
+  // If 'prefixed' is set, the data is DELTA_BYTE_ARRAY, otherwise
+  // DELTA_LENGTH_BYTE_ARRAY.
+  DeltaByteArrayDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end,
+      bool prefixed)
+      : bufferEnd_(end) {
+    if (prefixed) {
+      start = readLengths(start, prefixLengths_);
+    }
+    bufferStart_ = readLengths(start, lengths_);
+    VELOX_CHECK(
+        !prefixed || prefixLengths_.size() == lengths_.size(),
+        "Mismatched number of prefixes and suffixes in DELTA_BYTE_ARRAY");
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    if (!prefixLengths_.empty()) {
+      // A value depends on the previous one.
+      for (auto i = 0; i < numValues; ++i) {
+        readString();
+      }
+      return;
+    }
+    VELOX_CHECK_LE(valueIndex_ + numValues, lengths_.size());
+    for (auto i = 0; i < numValues; ++i) {
+      bufferStart_ += lengths_[valueIndex_++];
+    }
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        toSkip = visitor.process(readString(), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+  // The returned value is valid until the next call.
+  folly::StringPiece readString() {
+    VELOX_CHECK_LT(valueIndex_, lengths_.size());
+    const auto length = lengths_[valueIndex_];
+    VELOX_CHECK_LE(bufferStart_ + length, bufferEnd_, "Truncated value");
+    folly::StringPiece suffix(bufferStart_, length);
+    bufferStart_ += length;
+    if (prefixLengths_.empty()) {
+      ++valueIndex_;
+      return suffix;
+    }
+    const auto prefixLength = prefixLengths_[valueIndex_++];
+    VELOX_CHECK_LE(
+        prefixLength, lastValue_.size(), "Invalid DELTA_BYTE_ARRAY prefix");
+    lastValue_.resize(prefixLength);
+    lastValue_.append(suffix.data(), suffix.size());
+    return folly::StringPiece(lastValue_);
+  }
+
+ private:
+  // Decodes the DELTA_BINARY_PACKED lengths at 'start' into 'lengths' and
+  // returns the first byte after them.
+  const char* FOLLY_NONNULL readLengths(
+      const char* FOLLY_NONNULL start,
+      raw_vector<int32_t>& lengths) {
+    DeltaBpDecoder decoder(start, bufferEnd_, true);
+    lengths.resize(decoder.numValues());
+    for (auto i = 0; i < lengths.size(); ++i) {
+      lengths[i] = decoder.readLong();
+      VELOX_CHECK_GE(lengths[i], 0, "Negative length in delta encoding");
+    }
+    return decoder.skipToEnd();
+  }
+
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL const bufferEnd_;
+
+  // Lengths of the values for DELTA_LENGTH_BYTE_ARRAY or of the suffixes for
+  // DELTA_BYTE_ARRAY.
+  raw_vector<int32_t> lengths_;
+
+  // Lengths of the prefixes shared with the previous value. Empty for
+  // DELTA_LENGTH_BYTE_ARRAY.
+  raw_vector<int32_t> prefixLengths_;
+
+  // Index of the next value in 'lengths_'.
+  int32_t valueIndex_{0};
+
+  // The last value of DELTA_BYTE_ARRAY.
+  std::string lastValue_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
+
+namespace facebook::velox::parquet {
+
+std::vector<RowRange> filterPages(
+    common::Filter& filter,
+    const TypePtr& type,
+    const thrift::ColumnIndex& columnIndex,
+    const thrift::OffsetIndex& offsetIndex,
+    int64_t numRows) {
+  const auto& locations = offsetIndex.page_locations;
+  const auto numPages = locations.size();
+  VELOX_CHECK_EQ(numPages, columnIndex.null_pages.size());
+  VELOX_CHECK_EQ(numPages, columnIndex.min_values.size());
+  VELOX_CHECK_EQ(numPages, columnIndex.max_values.size());
+  const bool hasNullCounts = columnIndex.__isset.null_counts &&
+      columnIndex.null_counts.size() == numPages;
+  std::vector<RowRange> ranges;
+  for (auto i = 0; i < numPages; ++i) {
+    const auto begin = locations[i].first_row_index;
+    const auto end =
+        i + 1 < numPages ? locations[i + 1].first_row_index : numRows;
+    VELOX_CHECK_LE(begin, end);
+    thrift::Statistics stats;
+    if (columnIndex.null_pages[i]) {
+      stats.__set_null_count(end - begin);
+    } else {
+      if (hasNullCounts) {
+        stats.__set_null_count(columnIndex.null_counts[i]);
+      }
+      stats.__set_min_value(columnIndex.min_values[i]);
+      stats.__set_max_value(columnIndex.max_values[i]);
+    }
+    auto columnStats =
+        buildColumnStatisticsFromThrift(stats, *type, end - begin);
+    if (!testFilter(&filter, columnStats.get(), end - begin, type)) {
+      continue;
+    }
+    if (!ranges.empty() && ranges.back().end == begin) {
+      ranges.back().end = end;
+    } else {
+      ranges.push_back({begin, end});
+    }
+  }
+  return ranges;
+}
+
+std::vector<RowRange> intersectRowRanges(
+    const std::vector<RowRange>& left,
+    const std::vector<RowRange>& right) {
+  std::vector<RowRange> result;
+  auto leftIt = left.begin();
+  auto rightIt = right.begin();
+  while (leftIt != left.end() && rightIt != right.end()) {
+    const auto begin = std::max(leftIt->begin, rightIt->begin);
+    const auto end = std::min(leftIt->end, rightIt->end);
+    if (begin < end) {
+      result.push_back({begin, end});
+    }
+    if (leftIt->end < rightIt->end) {
+      ++leftIt;
+    } else {
+      ++rightIt;
+    }
+  }
+  return result;
+}
+
+} // namespace facebook::velox::parquet
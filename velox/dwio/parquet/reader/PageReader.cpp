@@ -649,6 +649,14 @@ int32_t PageReader::getLengthsAndNulls(
 
 void PageReader::makeDecoder() {
   auto parquetType = type_->parquetType_.value();
+  // Pages of a column chunk may have different encodings. Other than the
+  // dictionary, only the decoder of the current page is set.
+  directDecoder_.reset();
+  stringDecoder_.reset();
+  booleanDecoder_.reset();
+  deltaBpDecoder_.reset();
+  deltaByteArrayDecoder_.reset();
+  byteStreamSplitDecoder_.reset();
   switch (encoding_) {
     case Encoding::RLE_DICTIONARY:
     case Encoding::PLAIN_DICTIONARY:
@@ -683,6 +691,38 @@ void PageReader::makeDecoder() {
       }
       break;
     case Encoding::DELTA_BINARY_PACKED:
+      if (parquetType != thrift::Type::INT32 &&
+          parquetType != thrift::Type::INT64) {
+        VELOX_UNSUPPORTED(
+            "DELTA_BINARY_PACKED is only supported for INT32 and INT64");
+      }
+      deltaBpDecoder_ = std::make_unique<DeltaBpDecoder>(
+          pageData_,
+          pageData_ + encodedDataSize_,
+          parquetType == thrift::Type::INT32);
+      break;
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY:
+    case Encoding::DELTA_BYTE_ARRAY:
+      if (parquetType != thrift::Type::BYTE_ARRAY) {
+        VELOX_UNSUPPORTED(
+            "Delta byte array encodings are only supported for BYTE_ARRAY");
+      }
+      deltaByteArrayDecoder_ = std::make_unique<DeltaByteArrayDecoder>(
+          pageData_,
+          pageData_ + encodedDataSize_,
+          encoding_ == Encoding::DELTA_BYTE_ARRAY);
+      break;
+    case Encoding::BYTE_STREAM_SPLIT:
+      if (parquetType != thrift::Type::FLOAT &&
+          parquetType != thrift::Type::DOUBLE) {
+        VELOX_UNSUPPORTED(
+            "BYTE_STREAM_SPLIT is only supported for FLOAT and DOUBLE");
+      }
+      byteStreamSplitDecoder_ = std::make_unique<ByteStreamSplitDecoder>(
+          pageData_,
+          pageData_ + encodedDataSize_,
+          parquetTypeBytes(parquetType));
+      break;
     default:
       VELOX_UNSUPPORTED("Encoding not supported yet");
   }
@@ -715,6 +755,12 @@ void PageReader::skip(int64_t numRows) {
     stringDecoder_->skip(toSkip);
   } else if (booleanDecoder_) {
     booleanDecoder_->skip(toSkip);
+  } else if (deltaBpDecoder_) {
+    deltaBpDecoder_->skip(toSkip);
+  } else if (deltaByteArrayDecoder_) {
+    deltaByteArrayDecoder_->skip(toSkip);
+  } else if (byteStreamSplitDecoder_) {
+    byteStreamSplitDecoder_->skip(toSkip);
   } else {
     VELOX_FAIL("No decoder to skip");
   }
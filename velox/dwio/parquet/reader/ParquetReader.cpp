@@ -16,6 +16,7 @@
 
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/FileFooterCache.h"
 #include "velox/dwio/common/MetricsLog.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
@@ -42,11 +43,22 @@ ReaderBase::ReaderBase(
   VELOX_CHECK_GT(fileLength_, 0, "Parquet file is empty");
   VELOX_CHECK_GE(fileLength_, 12, "Parquet file is too small");
 
-  loadFileMetaData();
+  auto* footerCache = dwio::common::FileFooterCache::instance();
+  const auto footerKey = footerCache
+      ? dwio::common::FileFooterCache::makeKey(
+            "parquet", *input_->getReadFile())
+      : std::nullopt;
+  if (footerKey.has_value()) {
+    // The parsed footer is shared with the other readers of the file.
+    fileMetaData_ = footerCache->get<thrift::FileMetaData>(
+        footerKey.value(), [&]() { return loadFileMetaData(); });
+  } else {
+    fileMetaData_ = loadFileMetaData();
+  }
   initializeSchema();
 }
 
-void ReaderBase::loadFileMetaData() {
+std::unique_ptr<thrift::FileMetaData> ReaderBase::loadFileMetaData() {
   bool preloadFile_ = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile_ ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -88,8 +100,9 @@ void ReaderBase::loadFileMetaData() {
   auto thriftProtocol = std::make_unique<
       apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>>(
       thriftTransport);
-  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
-  fileMetaData_->read(thriftProtocol.get());
+  auto fileMetaData = std::make_unique<thrift::FileMetaData>();
+  fileMetaData->read(thriftProtocol.get());
+  return fileMetaData;
 }
 
 void ReaderBase::initializeSchema() {
@@ -455,31 +468,35 @@ void ReaderBase::scheduleRowGroups(
     int32_t currentGroup,
     StructColumnReader& reader) {
   auto thisGroup = rowGroupIds[currentGroup];
-  auto nextGroup =
-      currentGroup + 1 < rowGroupIds.size() ? rowGroupIds[currentGroup + 1] : 0;
-  auto input = inputs_[thisGroup].get();
-  if (!input) {
+  if (inputs_.count(thisGroup) == 0) {
     auto newInput = input_->clone();
     reader.enqueueRowGroup(thisGroup, *newInput);
     newInput->load(dwio::common::LogType::STRIPE);
     inputs_[thisGroup] = std::move(newInput);
   }
-  for (auto counter = 0; counter < FLAGS_parquet_prefetch_rowgroups;
-       ++counter) {
-    if (nextGroup) {
+  // Reads ahead the column chunks of the next row groups while this one is
+  // decoded. This is done only if 'input_' loads in the background. The loads
+  // of a row group are coalesced by the input.
+  if (input_->shouldPrefetchStripes()) {
+    const int32_t lastGroup = std::min<int64_t>(
+        rowGroupIds.size(),
+        currentGroup + 1 + FLAGS_parquet_prefetch_rowgroups);
+    for (auto i = currentGroup + 1; i < lastGroup; ++i) {
+      auto nextGroup = rowGroupIds[i];
       if (inputs_.count(nextGroup) != 0) {
-        auto newInput = input_->clone();
-        reader.enqueueRowGroup(nextGroup, *newInput);
-        newInput->load(dwio::common::LogType::STRIPE);
-        inputs_[nextGroup] = std::move(newInput);
+        continue;
       }
-    } else {
-      break;
+      auto newInput = input_->clone();
+      reader.enqueueRowGroup(nextGroup, *newInput);
+      if (!newInput->shouldPreload()) {
+        // No memory for prefetching. The row group is loaded when reached.
+        break;
+      }
+      newInput->load(dwio::common::LogType::STRIPE);
+      inputs_[nextGroup] = std::move(newInput);
     }
-    nextGroup =
-        nextGroup + 1 < rowGroupIds.size() ? rowGroupIds[nextGroup + 1] : 0;
   }
-  if (currentGroup > 1) {
+  if (currentGroup > 0) {
     inputs_.erase(rowGroupIds[currentGroup - 1]);
   }
 }
@@ -499,6 +516,95 @@ int64_t ReaderBase::rowGroupUncompressedSize(
   return sum;
 }
 
+namespace {
+// Bytes to read for a BloomFilterHeader of unknown size.
+constexpr uint64_t kBloomFilterHeaderSizeGuess = 256;
+
+void readIndexBytes(
+    const dwio::common::BufferedInput& input,
+    uint64_t offset,
+    uint64_t length,
+    char* data) {
+  auto stream =
+      input.read(offset, length, dwio::common::LogType::STRIPE_INDEX);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(length, stream.get(), data, bufferStart, bufferEnd);
+}
+
+// Deserializes 'result' from 'data' and returns its serialized size.
+template <typename T>
+uint32_t deserializeThrift(const char* data, uint64_t length, T& result) {
+  std::shared_ptr<thrift::ThriftTransport> thriftTransport =
+      std::make_shared<thrift::ThriftBufferedTransport>(data, length);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>
+      thriftProtocol(thriftTransport);
+  return result.read(&thriftProtocol);
+}
+
+template <typename T>
+void readThrift(
+    const dwio::common::BufferedInput& input,
+    uint64_t offset,
+    uint64_t length,
+    T& result) {
+  std::vector<char> copy(length);
+  readIndexBytes(input, offset, length, copy.data());
+  deserializeThrift(copy.data(), length, result);
+}
+} // namespace
+
+bool ReaderBase::readPageIndex(
+    int32_t rowGroupIndex,
+    int32_t column,
+    thrift::ColumnIndex& columnIndex,
+    thrift::OffsetIndex& offsetIndex) const {
+  auto& chunk = fileMetaData_->row_groups[rowGroupIndex].columns[column];
+  if (!chunk.__isset.column_index_offset ||
+      !chunk.__isset.offset_index_offset || chunk.column_index_length <= 0 ||
+      chunk.offset_index_length <= 0) {
+    return false;
+  }
+  readThrift(
+      *input_,
+      chunk.column_index_offset,
+      chunk.column_index_length,
+      columnIndex);
+  readThrift(
+      *input_,
+      chunk.offset_index_offset,
+      chunk.offset_index_length,
+      offsetIndex);
+  return true;
+}
+
+std::unique_ptr<SplitBlockBloomFilter> ReaderBase::readBloomFilter(
+    int32_t rowGroupIndex,
+    int32_t column) const {
+  auto& metaData =
+      fileMetaData_->row_groups[rowGroupIndex].columns[column].meta_data;
+  if (!metaData.__isset.bloom_filter_offset) {
+    return nullptr;
+  }
+  const uint64_t offset = metaData.bloom_filter_offset;
+  VELOX_CHECK_LT(offset, fileLength_);
+  const auto headerReadSize =
+      std::min(kBloomFilterHeaderSizeGuess, fileLength_ - offset);
+  std::vector<char> headerData(headerReadSize);
+  readIndexBytes(*input_, offset, headerReadSize, headerData.data());
+  thrift::BloomFilterHeader header;
+  const auto headerSize =
+      deserializeThrift(headerData.data(), headerReadSize, header);
+  if (!header.algorithm.__isset.BLOCK || !header.hash.__isset.XXHASH ||
+      !header.compression.__isset.UNCOMPRESSED || header.numBytes <= 0) {
+    return nullptr;
+  }
+  VELOX_CHECK_LE(offset + headerSize + header.numBytes, fileLength_);
+  std::string bitset(header.numBytes, '\0');
+  readIndexBytes(*input_, offset + headerSize, header.numBytes, bitset.data());
+  return std::make_unique<SplitBlockBloomFilter>(std::move(bitset));
+}
+
 ParquetRowReader::ParquetRowReader(
     const std::shared_ptr<ReaderBase>& readerBase,
     const dwio::common::RowReaderOptions& options)
@@ -532,6 +638,14 @@ ParquetRowReader::ParquetRowReader(
       readerBase_->schemaWithId(), // Id is schema id
       params,
       *options_.getScanSpec());
+  if (auto& executor = options_.getDecodingExecutor()) {
+    if (auto* structReader =
+            dynamic_cast<dwio::common::SelectiveStructColumnReaderBase*>(
+                columnReader_.get())) {
+      structReader->setDecodingExecutor(
+          executor.get(), options_.getMinRowsForParallelDecoding());
+    }
+  }
 
   filterRowGroups();
   if (!rowGroupIds_.empty()) {
@@ -568,7 +682,8 @@ void ParquetRowReader::filterRowGroups() {
          fileOffset < options_.getLimit());
     // A skipped row group is one that is in range and is in the excluded list.
     if (rowGroupInRange) {
-      if (i < res.totalCount && bits::isBitSet(res.filterResult.data(), i)) {
+      if ((i < res.totalCount && bits::isBitSet(res.filterResult.data(), i)) ||
+          !bloomFiltersMatch(i)) {
         ++skippedRowGroups_;
       } else {
         rowGroupIds_.push_back(i);
@@ -579,10 +694,125 @@ void ParquetRowReader::filterRowGroups() {
   }
 }
 
+bool ParquetRowReader::filterPages(uint32_t rowGroupIndex) {
+  rowRanges_.clear();
+  nextRowRange_ = 0;
+  const auto numRows = rowGroups_[rowGroupIndex].num_rows;
+  bool filtered = false;
+  std::vector<RowRange> ranges;
+  const auto& fileType = *readerBase_->schemaWithId();
+  const auto& rowType = fileType.type->asRow();
+  for (auto& childSpec : options_.getScanSpec()->children()) {
+    if (!childSpec->filter() || childSpec->isConstant()) {
+      continue;
+    }
+    auto index = rowType.getChildIdxIfExists(childSpec->fieldName());
+    if (!index.has_value()) {
+      continue;
+    }
+    auto type = std::static_pointer_cast<const ParquetTypeWithId>(
+        fileType.childAt(index.value()));
+    // Pages of repeated columns do not map to top level rows one to one.
+    if (type->column == ParquetTypeWithId::kNonLeaf || type->maxRepeat_ > 0) {
+      continue;
+    }
+    thrift::ColumnIndex columnIndex;
+    thrift::OffsetIndex offsetIndex;
+    if (!readerBase_->readPageIndex(
+            rowGroupIndex, type->column, columnIndex, offsetIndex)) {
+      continue;
+    }
+    auto columnRanges = parquet::filterPages(
+        *childSpec->filter(), type->type, columnIndex, offsetIndex, numRows);
+    ranges = filtered ? intersectRowRanges(ranges, columnRanges)
+                      : std::move(columnRanges);
+    filtered = true;
+    if (ranges.empty()) {
+      return false;
+    }
+  }
+  if (filtered &&
+      !(ranges.size() == 1 && ranges[0].begin == 0 &&
+        ranges[0].end == numRows)) {
+    rowRanges_ = std::move(ranges);
+  }
+  return true;
+}
+
+void ParquetRowReader::skipFilteredPages() {
+  if (rowRanges_.empty()) {
+    return;
+  }
+  while (nextRowRange_ < rowRanges_.size() &&
+         rowRanges_[nextRowRange_].end <= currentRowInGroup_) {
+    ++nextRowRange_;
+  }
+  const uint64_t nextRow = nextRowRange_ < rowRanges_.size()
+      ? std::max<uint64_t>(
+            currentRowInGroup_, rowRanges_[nextRowRange_].begin)
+      : rowsInCurrentRowGroup_;
+  if (nextRow == currentRowInGroup_) {
+    return;
+  }
+  skippedPageRows_ += nextRow - currentRowInGroup_;
+  currentRowInGroup_ = nextRow;
+  // The column readers skip to the new position on their next read, which
+  // skips the pruned pages without decompressing or decoding them.
+  columnReader_->setReadOffset(currentRowInGroup_);
+}
+
+bool ParquetRowReader::bloomFiltersMatch(uint32_t rowGroupIndex) {
+  const auto& fileType = *readerBase_->schemaWithId();
+  const auto& rowType = fileType.type->asRow();
+  for (auto& childSpec : options_.getScanSpec()->children()) {
+    auto* filter = childSpec->filter();
+    if (!filter || childSpec->isConstant() ||
+        !isBloomFilterTestable(*filter)) {
+      continue;
+    }
+    auto index = rowType.getChildIdxIfExists(childSpec->fieldName());
+    if (!index.has_value()) {
+      continue;
+    }
+    auto type = std::static_pointer_cast<const ParquetTypeWithId>(
+        fileType.childAt(index.value()));
+    if (type->column == ParquetTypeWithId::kNonLeaf ||
+        !type->parquetType_.has_value()) {
+      continue;
+    }
+    // The Bloom filter hashes the physical values, which must be the ones
+    // the filter compares.
+    const auto physicalType = type->parquetType_.value();
+    const bool isBytes = physicalType == thrift::Type::BYTE_ARRAY;
+    const bool isInt = physicalType == thrift::Type::INT32 ||
+        physicalType == thrift::Type::INT64;
+    const bool bytesFilter =
+        filter->kind() == common::FilterKind::kBytesRange ||
+        filter->kind() == common::FilterKind::kBytesValues;
+    if ((bytesFilter && !isBytes) || (!bytesFilter && !isInt) ||
+        type->type->isDecimal()) {
+      continue;
+    }
+    auto bloomFilter =
+        readerBase_->readBloomFilter(rowGroupIndex, type->column);
+    if (bloomFilter &&
+        !testBloomFilter(*filter, physicalType, *bloomFilter)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 int64_t ParquetRowReader::nextRowNumber() {
-  if (currentRowInGroup_ >= rowsInCurrentRowGroup_ &&
-      !advanceToNextRowGroup()) {
-    return kAtEnd;
+  for (;;) {
+    if (currentRowInGroup_ >= rowsInCurrentRowGroup_ &&
+        !advanceToNextRowGroup()) {
+      return kAtEnd;
+    }
+    skipFilteredPages();
+    if (currentRowInGroup_ < rowsInCurrentRowGroup_) {
+      break;
+    }
   }
   return firstRowOfRowGroup_[nextRowGroupIdsIdx_ - 1] + currentRowInGroup_;
 }
@@ -592,7 +822,13 @@ int64_t ParquetRowReader::nextReadSize(uint64_t size) {
   if (nextRowNumber() == kAtEnd) {
     return kAtEnd;
   }
-  return std::min(size, rowsInCurrentRowGroup_ - currentRowInGroup_);
+  auto rowsToRead = std::min(size, rowsInCurrentRowGroup_ - currentRowInGroup_);
+  if (nextRowRange_ < rowRanges_.size()) {
+    // Don't allow read to cross into pruned pages.
+    rowsToRead = std::min<uint64_t>(
+        rowsToRead, rowRanges_[nextRowRange_].end - currentRowInGroup_);
+  }
+  return rowsToRead;
 }
 
 uint64_t ParquetRowReader::next(
@@ -614,6 +850,13 @@ bool ParquetRowReader::advanceToNextRowGroup() {
   if (nextRowGroupIdsIdx_ == rowGroupIds_.size()) {
     return false;
   }
+  while (!filterPages(rowGroupIds_[nextRowGroupIdsIdx_])) {
+    // No page of the row group may pass the filters.
+    ++skippedRowGroups_;
+    if (++nextRowGroupIdsIdx_ == rowGroupIds_.size()) {
+      return false;
+    }
+  }
 
   auto nextRowGroupIndex = rowGroupIds_[nextRowGroupIdsIdx_];
   readerBase_->scheduleRowGroups(
@@ -631,6 +874,7 @@ bool ParquetRowReader::advanceToNextRowGroup() {
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& stats) const {
   stats.skippedStrides += skippedRowGroups_;
+  stats.skippedPageRows += skippedPageRows_;
 }
 
 void ParquetRowReader::resetFilterCaches() {
@@ -654,4 +898,24 @@ std::unique_ptr<dwio::common::RowReader> ParquetReader::createRowReader(
     const dwio::common::RowReaderOptions& options) const {
   return std::make_unique<ParquetRowReader>(readerBase_, options);
 }
+
+std::vector<dwio::common::Region> ParquetReader::readUnits() const {
+  const auto& rowGroups = readerBase_->fileMetaData().row_groups;
+  std::vector<dwio::common::Region> units;
+  units.reserve(rowGroups.size());
+  for (const auto& rowGroup : rowGroups) {
+    if (rowGroup.columns.empty()) {
+      return {};
+    }
+    // The same offset as the row reader uses to select row groups.
+    const auto offset = rowGroup.__isset.file_offset
+        ? rowGroup.file_offset
+        : rowGroup.columns[0].file_offset;
+    const auto size = rowGroup.__isset.total_compressed_size
+        ? rowGroup.total_compressed_size
+        : rowGroup.total_byte_size;
+    units.emplace_back(offset, size);
+  }
+  return units;
+}
 } // namespace facebook::velox::parquet
@@ -20,7 +20,9 @@
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 
 namespace facebook::velox::parquet {
@@ -80,9 +82,25 @@ class ReaderBase {
       int32_t rowGroupIndex,
       const dwio::common::TypeWithId& type) const;
 
+  /// Reads the ColumnIndex and OffsetIndex of leaf column 'column' in row
+  /// group 'rowGroupIndex'. Returns false if the file has no page index for
+  /// the column.
+  bool readPageIndex(
+      int32_t rowGroupIndex,
+      int32_t column,
+      thrift::ColumnIndex& columnIndex,
+      thrift::OffsetIndex& offsetIndex) const;
+
+  /// Reads the Bloom filter of leaf column 'column' in row group
+  /// 'rowGroupIndex'. Returns nullptr if the column chunk has no Bloom filter
+  /// or has one of an unsupported kind.
+  std::unique_ptr<SplitBlockBloomFilter> readBloomFilter(
+      int32_t rowGroupIndex,
+      int32_t column) const;
+
  private:
   // Reads and parses file footer.
-  void loadFileMetaData();
+  std::unique_ptr<thrift::FileMetaData> loadFileMetaData();
 
   void initializeSchema();
 
@@ -106,7 +124,9 @@ class ReaderBase {
   const dwio::common::ReaderOptions options_;
   std::unique_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
-  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  // Shared with the other readers of the file if it is from
+  // FileFooterCache.
+  std::shared_ptr<const thrift::FileMetaData> fileMetaData_;
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -155,10 +175,23 @@ class ParquetRowReader : public dwio::common::RowReader {
   // ReaderBase and determines the set of row groups to scan.
   void filterRowGroups();
 
+  // Returns false if a Bloom filter shows that row group 'rowGroupIndex' has
+  // no value passing an equality or IN filter in ScanSpec. The Bloom filters
+  // are read only for columns with such filters.
+  bool bloomFiltersMatch(uint32_t rowGroupIndex);
+
   // Positions the reader tre at the start of the next row group, as determined
   // by filterRowGroups().
   bool advanceToNextRowGroup();
 
+  // Sets 'rowRanges_' to the rows of row group 'rowGroupIndex' that are in
+  // pages that may pass the filters in ScanSpec according to the page index of
+  // the filtered columns. Returns false if no row may pass.
+  bool filterPages(uint32_t rowGroupIndex);
+
+  // Moves 'currentRowInGroup_' past rows that are not in 'rowRanges_'.
+  void skipFilteredPages();
+
   memory::MemoryPool& pool_;
   const std::shared_ptr<ReaderBase> readerBase_;
   const dwio::common::RowReaderOptions options_;
@@ -177,6 +210,14 @@ class ParquetRowReader : public dwio::common::RowReader {
   // Number of row groups skipped based on stats.
   int32_t skippedRowGroups_{0};
 
+  // Ranges of rows of the current row group to read. Rows outside of these
+  // are in pages pruned by the page index. Empty if all rows are read.
+  std::vector<RowRange> rowRanges_;
+  size_t nextRowRange_{0};
+
+  // Number of rows skipped based on page stats.
+  int64_t skippedPageRows_{0};
+
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
   RowTypePtr requestedType_;
@@ -212,6 +253,8 @@ class ParquetReader : public dwio::common::Reader {
   std::unique_ptr<dwio::common::RowReader> createRowReader(
       const dwio::common::RowReaderOptions& options = {}) const override;
 
+  std::vector<dwio::common::Region> readUnits() const override;
+
  private:
   std::shared_ptr<ReaderBase> readerBase_;
 };
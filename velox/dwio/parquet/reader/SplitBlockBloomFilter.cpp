@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+namespace facebook::velox::parquet {
+
+namespace {
+constexpr int32_t kWordsPerBlock = 8;
+
+constexpr uint32_t kSalt[kWordsPerBlock] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+
+// Returns the bit to set in word 'i' of a block for 'key'.
+inline uint32_t maskBit(uint32_t key, int32_t i) {
+  return 1U << ((key * kSalt[i]) >> 27);
+}
+
+// Returns true if 'bloomFilter' may contain 'value' stored as 'physicalType'.
+bool mayContainInt(
+    int64_t value,
+    thrift::Type::type physicalType,
+    const SplitBlockBloomFilter& bloomFilter) {
+  if (physicalType == thrift::Type::INT32) {
+    if (value < std::numeric_limits<int32_t>::min() ||
+        value > std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+    return bloomFilter.mayContain(static_cast<int32_t>(value));
+  }
+  return bloomFilter.mayContain(value);
+}
+} // namespace
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(std::string bitset)
+    : bitset_(std::move(bitset)), numBlocks_(bitset_.size() / kBytesPerBlock) {
+  VELOX_CHECK_GT(numBlocks_, 0);
+  VELOX_CHECK_EQ(
+      bitset_.size() % kBytesPerBlock, 0, "Invalid Bloom filter size");
+}
+
+// static
+SplitBlockBloomFilter SplitBlockBloomFilter::empty(int32_t numBytes) {
+  return SplitBlockBloomFilter(std::string(numBytes, '\0'));
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hash(const void* data, int32_t size) {
+  return XXH64(data, size, 0);
+}
+
+uint32_t* SplitBlockBloomFilter::blockAt(uint64_t hash) const {
+  const auto index = ((hash >> 32) * numBlocks_) >> 32;
+  return reinterpret_cast<uint32_t*>(
+      const_cast<char*>(bitset_.data()) + index * kBytesPerBlock);
+}
+
+void SplitBlockBloomFilter::insertHash(uint64_t hash) {
+  auto* block = blockAt(hash);
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < kWordsPerBlock; ++i) {
+    block[i] |= maskBit(key, i);
+  }
+}
+
+bool SplitBlockBloomFilter::mayContainHash(uint64_t hash) const {
+  const auto* block = blockAt(hash);
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < kWordsPerBlock; ++i) {
+    if ((block[i] & maskBit(key, i)) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool isBloomFilterTestable(const common::Filter& filter) {
+  if (filter.testNull()) {
+    // Nulls are not in the Bloom filter.
+    return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool testBloomFilter(
+    const common::Filter& filter,
+    thrift::Type::type physicalType,
+    const SplitBlockBloomFilter& bloomFilter) {
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto& range = static_cast<const common::BigintRange&>(filter);
+      return mayContainInt(range.lower(), physicalType, bloomFilter);
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      auto& values =
+          static_cast<const common::BigintValuesUsingHashTable&>(filter);
+      for (auto value : values.values()) {
+        if (mayContainInt(value, physicalType, bloomFilter)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      auto& values =
+          static_cast<const common::BigintValuesUsingBitmask&>(filter);
+      for (auto value : values.values()) {
+        if (mayContainInt(value, physicalType, bloomFilter)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBytesRange: {
+      auto& range = static_cast<const common::BytesRange&>(filter);
+      return bloomFilter.mayContain(std::string_view(range.lower()));
+    }
+    case common::FilterKind::kBytesValues: {
+      auto& values = static_cast<const common::BytesValues&>(filter);
+      for (const auto& value : values.values()) {
+        if (bloomFilter.mayContain(std::string_view(value))) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace facebook::velox::parquet
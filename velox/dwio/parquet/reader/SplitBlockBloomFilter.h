@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+
+#include <string>
+
+namespace facebook::velox::parquet {
+
+// Split block Bloom filter of a Parquet column chunk. The bitset consists of
+// 32 byte blocks of 8 words. A value sets one bit in each word of one block.
+// The hash is XXH64 of the plain encoding of the value.
+class SplitBlockBloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  // 'bitset' is the data following the BloomFilterHeader.
+  explicit SplitBlockBloomFilter(std::string bitset);
+
+  // Makes an empty filter of 'numBytes' bytes.
+  static SplitBlockBloomFilter empty(int32_t numBytes);
+
+  // Returns the hash of the plain encoded value in 'data'.
+  static uint64_t hash(const void* data, int32_t size);
+
+  void insertHash(uint64_t hash);
+
+  bool mayContainHash(uint64_t hash) const;
+
+  template <typename T>
+  bool mayContain(T value) const {
+    return mayContainHash(hash(&value, sizeof(T)));
+  }
+
+  bool mayContain(std::string_view value) const {
+    return mayContainHash(hash(value.data(), value.size()));
+  }
+
+  const std::string& bitset() const {
+    return bitset_;
+  }
+
+ private:
+  uint32_t* blockAt(uint64_t hash) const;
+
+  std::string bitset_;
+  const int64_t numBlocks_;
+};
+
+// Returns true if 'filter' is an equality or IN filter that a Bloom filter
+// can test. The values must be non-null.
+bool isBloomFilterTestable(const common::Filter& filter);
+
+// Returns false if no value passing 'filter' can be in a column chunk of
+// 'physicalType' with 'bloomFilter'. 'filter' must be testable.
+bool testBloomFilter(
+    const common::Filter& filter,
+    thrift::Type::type physicalType,
+    const SplitBlockBloomFilter& bloomFilter);
+
+} // namespace facebook::velox::parquet
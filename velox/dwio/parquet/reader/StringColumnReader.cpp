@@ -139,6 +139,12 @@ void StringColumnReader::getValues(RowSet rows, VectorPtr* result) {
         numValues_,
         dictionaryValues,
         values_);
+    // Filters and hooks have run on dictionary ids. Strings are only copied
+    // out for the surviving rows if the consumer asks for a flat vector.
+    if (scanSpec_->makeFlat()) {
+      BaseVector::ensureWritable(
+          SelectivityVector::empty(), (*result)->type(), &memoryPool_, *result);
+    }
     return;
   }
   rawStringBuffer_ = nullptr;
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ByteStreamSplitDecoder.h"
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+// Returns 'values' encoded as BYTE_STREAM_SPLIT.
+template <typename T>
+std::string encodeByteStreamSplit(const std::vector<T>& values) {
+  std::string out(values.size() * sizeof(T), '\0');
+  for (auto i = 0; i < values.size(); ++i) {
+    const auto* bytes = reinterpret_cast<const char*>(&values[i]);
+    for (auto byte = 0; byte < sizeof(T); ++byte) {
+      out[byte * values.size() + i] = bytes[byte];
+    }
+  }
+  return out;
+}
+
+template <typename T>
+void testReadAndSkip(int32_t numValues) {
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<T> values(numValues);
+  for (auto& value : values) {
+    value = static_cast<T>(folly::Random::randDouble(-1e6, 1e6, rng));
+  }
+  auto encoded = encodeByteStreamSplit(values);
+  ByteStreamSplitDecoder decoder(
+      encoded.data(), encoded.data() + encoded.size(), sizeof(T));
+  // Alternates reads and skips of varying lengths across batch boundaries.
+  int32_t row = 0;
+  int32_t step = 1;
+  while (row < numValues) {
+    const auto numRead = std::min(step, numValues - row);
+    for (auto i = 0; i < numRead; ++i, ++row) {
+      ASSERT_EQ(values[row], decoder.read<T>()) << row;
+    }
+    const auto numSkipped = std::min(step * 3, numValues - row);
+    decoder.skip(numSkipped);
+    row += numSkipped;
+    step = step * 2 % 1000 + 1;
+  }
+}
+} // namespace
+
+TEST(ByteStreamSplitDecoderTest, readFloat) {
+  testReadAndSkip<float>(1);
+  testReadAndSkip<float>(255);
+  testReadAndSkip<float>(10'000);
+}
+
+TEST(ByteStreamSplitDecoderTest, readDouble) {
+  testReadAndSkip<double>(1);
+  testReadAndSkip<double>(257);
+  testReadAndSkip<double>(10'000);
+}
+
+TEST(ByteStreamSplitDecoderTest, invalidSize) {
+  std::string data(7, '\0');
+  EXPECT_THROW(
+      ByteStreamSplitDecoder(data.data(), data.data() + data.size(), 4),
+      VeloxRuntimeError);
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaByteArrayDecoder.h"
+
+#include <fmt/format.h>
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+void writeVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void writeZigzag(std::string& out, int64_t value) {
+  writeVarint(
+      out,
+      (static_cast<uint64_t>(value) << 1) ^
+          static_cast<uint64_t>(value >> 63));
+}
+
+// Encodes 'values' as DELTA_BINARY_PACKED with 4 miniblocks of 32 values per
+// block. If 'int32' is set, the deltas are computed in 32 bit arithmetic like
+// writers do for INT32 columns. The unused miniblocks of the last block get
+// 'unusedBitWidth', which the spec allows to be any value.
+std::string encodeDeltaBinaryPacked(
+    const std::vector<int64_t>& values,
+    bool int32 = false,
+    uint8_t unusedBitWidth = 0) {
+  constexpr int32_t kBlockSize = 128;
+  constexpr int32_t kMiniblocks = 4;
+  constexpr int32_t kMiniblockSize = kBlockSize / kMiniblocks;
+  std::string out;
+  writeVarint(out, kBlockSize);
+  writeVarint(out, kMiniblocks);
+  writeVarint(out, values.size());
+  writeZigzag(out, values.empty() ? 0 : values[0]);
+  for (size_t start = 1; start < values.size(); start += kBlockSize) {
+    const auto end = std::min<size_t>(start + kBlockSize, values.size());
+    std::vector<int64_t> deltas;
+    for (auto i = start; i < end; ++i) {
+      if (int32) {
+        deltas.push_back(static_cast<int32_t>(
+            static_cast<uint32_t>(values[i]) -
+            static_cast<uint32_t>(values[i - 1])));
+      } else {
+        deltas.push_back(
+            static_cast<uint64_t>(values[i]) -
+            static_cast<uint64_t>(values[i - 1]));
+      }
+    }
+    const auto minDelta = *std::min_element(deltas.begin(), deltas.end());
+    writeZigzag(out, minDelta);
+    std::vector<uint64_t> packed(kBlockSize, 0);
+    for (auto i = 0; i < deltas.size(); ++i) {
+      packed[i] = static_cast<uint64_t>(deltas[i]) - minDelta;
+      if (int32) {
+        packed[i] = static_cast<uint32_t>(packed[i]);
+      }
+    }
+    const int32_t numMiniblocks =
+        bits::roundUp(deltas.size(), kMiniblockSize) / kMiniblockSize;
+    std::vector<uint8_t> bitWidths(kMiniblocks, 0);
+    for (auto miniblock = 0; miniblock < numMiniblocks; ++miniblock) {
+      uint64_t maxValue = 0;
+      for (auto i = 0; i < kMiniblockSize; ++i) {
+        maxValue |= packed[miniblock * kMiniblockSize + i];
+      }
+      bitWidths[miniblock] =
+          maxValue == 0 ? 0 : 64 - __builtin_clzll(maxValue);
+      out.push_back(static_cast<char>(bitWidths[miniblock]));
+    }
+    // The bit widths of unused miniblocks are present.
+    for (auto miniblock = numMiniblocks; miniblock < kMiniblocks; ++miniblock) {
+      out.push_back(static_cast<char>(unusedBitWidth));
+    }
+    for (auto miniblock = 0; miniblock < numMiniblocks; ++miniblock) {
+      const auto bitWidth = bitWidths[miniblock];
+      std::string bytes(kMiniblockSize * bitWidth / 8, 0);
+      for (auto i = 0; i < kMiniblockSize; ++i) {
+        const auto value = packed[miniblock * kMiniblockSize + i];
+        for (auto bit = 0; bit < bitWidth; ++bit) {
+          if (value & (1UL << bit)) {
+            const auto position = i * bitWidth + bit;
+            bytes[position / 8] |= 1 << (position % 8);
+          }
+        }
+      }
+      out += bytes;
+    }
+  }
+  return out;
+}
+
+std::string encodeLengths(const std::vector<std::string>& values) {
+  std::vector<int64_t> lengths;
+  for (const auto& value : values) {
+    lengths.push_back(value.size());
+  }
+  return encodeDeltaBinaryPacked(lengths, true);
+}
+
+std::string encodeDeltaLengthByteArray(const std::vector<std::string>& values) {
+  auto out = encodeLengths(values);
+  for (const auto& value : values) {
+    out += value;
+  }
+  return out;
+}
+
+std::string encodeDeltaByteArray(const std::vector<std::string>& values) {
+  std::vector<int64_t> prefixLengths;
+  std::vector<std::string> suffixes;
+  std::string previous;
+  for (const auto& value : values) {
+    size_t prefix = 0;
+    while (prefix < previous.size() && prefix < value.size() &&
+           previous[prefix] == value[prefix]) {
+      ++prefix;
+    }
+    prefixLengths.push_back(prefix);
+    suffixes.push_back(value.substr(prefix));
+    previous = value;
+  }
+  return encodeDeltaBinaryPacked(prefixLengths, true) +
+      encodeDeltaLengthByteArray(suffixes);
+}
+} // namespace
+
+class DeltaDecoderTest : public testing::Test {
+ protected:
+  void checkInts(
+      const std::vector<int64_t>& values,
+      const std::string& encoded,
+      bool int32) {
+    {
+      DeltaBpDecoder decoder(
+          encoded.data(), encoded.data() + encoded.size(), int32);
+      ASSERT_EQ(values.size(), decoder.numValues());
+      for (auto i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], decoder.readLong()) << i;
+      }
+      EXPECT_EQ(encoded.data() + encoded.size(), decoder.skipToEnd());
+    }
+    // Alternates skips and reads of different lengths.
+    DeltaBpDecoder decoder(
+        encoded.data(), encoded.data() + encoded.size(), int32);
+    int32_t index = 0;
+    for (auto step = 1; index < values.size(); step = step * 3 % 301) {
+      const auto numSkipped =
+          std::min<int32_t>(step, values.size() - index - 1);
+      decoder.skip(numSkipped);
+      index += numSkipped;
+      ASSERT_EQ(values[index], decoder.readLong()) << index;
+      ++index;
+    }
+  }
+
+  folly::Random::DefaultGenerator rng_{1};
+};
+
+TEST_F(DeltaDecoderTest, deltaBinaryPacked) {
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 1'000; ++i) {
+    // Runs of ascending values with small deltas, each starting at a random
+    // value.
+    if (i % 100 == 0) {
+      values.push_back(folly::Random::rand64(rng_));
+    } else {
+      values.push_back(values.back() + folly::Random::rand32(1'000, rng_));
+    }
+  }
+  values.push_back(std::numeric_limits<int64_t>::min());
+  values.push_back(std::numeric_limits<int64_t>::max());
+  checkInts(values, encodeDeltaBinaryPacked(values), false);
+
+  // A single value and no values.
+  checkInts({-5}, encodeDeltaBinaryPacked({-5}), false);
+  auto empty = encodeDeltaBinaryPacked({});
+  DeltaBpDecoder decoder(empty.data(), empty.data() + empty.size());
+  EXPECT_EQ(0, decoder.numValues());
+  EXPECT_EQ(empty.data() + empty.size(), decoder.skipToEnd());
+}
+
+TEST_F(DeltaDecoderTest, unusedMiniblockBitWidth) {
+  // The last block has 40 deltas, so 2 of its 4 miniblocks are unused.
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 1 + 128 + 40; ++i) {
+    values.push_back(i * 3 - 100);
+  }
+  checkInts(values, encodeDeltaBinaryPacked(values, false, 200), false);
+}
+
+TEST_F(DeltaDecoderTest, deltaBinaryPackedInt32) {
+  // Deltas between these overflow 32 bits and wrap around.
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 300; ++i) {
+    values.push_back(static_cast<int32_t>(folly::Random::rand32(rng_)));
+  }
+  values.push_back(std::numeric_limits<int32_t>::max());
+  values.push_back(std::numeric_limits<int32_t>::min());
+  checkInts(values, encodeDeltaBinaryPacked(values, true), true);
+}
+
+TEST_F(DeltaDecoderTest, deltaByteArray) {
+  std::vector<std::string> values;
+  for (auto i = 0; i < 500; ++i) {
+    // Values with common prefixes and some empty values.
+    values.push_back(
+        i % 7 == 0
+            ? ""
+            : fmt::format("prefix{}_{}", i / 10, std::string(i % 13, 'x')));
+  }
+  for (const auto prefixed : {false, true}) {
+    SCOPED_TRACE(prefixed);
+    const auto encoded = prefixed ? encodeDeltaByteArray(values)
+                                  : encodeDeltaLengthByteArray(values);
+    DeltaByteArrayDecoder decoder(
+        encoded.data(), encoded.data() + encoded.size(), prefixed);
+    for (auto i = 0; i < values.size(); ++i) {
+      if (i % 5 == 1) {
+        decoder.skip(1);
+        continue;
+      }
+      ASSERT_EQ(values[i], decoder.readString().str()) << i;
+    }
+  }
+}
@@ -16,6 +16,7 @@
 
 #include "velox/dwio/common/tests/E2EFilterTestBase.h"
 #include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/writer/NativeWriter.h"
 #include "velox/dwio/parquet/writer/Writer.h"
 
 #include <folly/init/Init.h>
@@ -61,8 +62,12 @@ class E2EFilterTest : public E2EFilterTestBase {
     options_.memoryPool = rootPool_.get();
 
     options_.bufferGrowRatio = 2;
-    writer_ = std::make_unique<facebook::velox::parquet::Writer>(
-        std::move(sink), options_);
+    if (useNativeWriter_) {
+      writer_ = std::make_unique<NativeWriter>(std::move(sink), options_);
+    } else {
+      writer_ = std::make_unique<facebook::velox::parquet::Writer>(
+          std::move(sink), options_);
+    }
     for (auto& batch : batches) {
       writer_->write(batch);
     }
@@ -75,8 +80,9 @@ class E2EFilterTest : public E2EFilterTestBase {
     return std::make_unique<ParquetReader>(std::move(input), opts);
   }
 
-  std::unique_ptr<facebook::velox::parquet::Writer> writer_;
+  std::unique_ptr<dwio::common::Writer> writer_;
   facebook::velox::parquet::WriterOptions options_;
+  bool useNativeWriter_{false};
 };
 
 TEST_F(E2EFilterTest, writerMagic) {
@@ -115,6 +121,23 @@ TEST_F(E2EFilterTest, integerDirect) {
       {"short_val", "int_val", "long_val"},
       20);
 }
+
+TEST_F(E2EFilterTest, integerDeltaBinaryPacked) {
+  options_.enableDictionary = false;
+  options_.enableDeltaBinaryPacked = true;
+  options_.dataPageSize = 4 * 1024;
+
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "long_null:bigint",
+      [&]() { makeAllNulls("long_null"); },
+      true,
+      {"short_val", "int_val", "long_val"},
+      20);
+}
+
 TEST_F(E2EFilterTest, compression) {
   for (const auto compression :
        {dwio::common::CompressionKind_SNAPPY,
@@ -233,6 +256,27 @@ TEST_F(E2EFilterTest, floatAndDoubleDirect) {
       20);
 }
 
+TEST_F(E2EFilterTest, floatAndDoubleByteStreamSplit) {
+  options_.enableDictionary = false;
+  options_.enableByteStreamSplit = true;
+  options_.dataPageSize = 4 * 1024;
+
+  testWithTypes(
+      "float_val:float,"
+      "double_val:double,"
+      "float_val2:float,"
+      "double_val2:double,"
+      "float_null:float",
+      [&]() {
+        makeAllNulls("float_null");
+        makeQuantizedFloat<float>("float_val2", 200, true);
+        makeQuantizedFloat<double>("double_val2", 522, true);
+      },
+      true,
+      {"float_val", "double_val", "float_val2", "double_val2", "float_null"},
+      20);
+}
+
 TEST_F(E2EFilterTest, floatAndDouble) {
   // float_val and double_val may be direct since the
   // values are random.float_val2 and double_val2 are expected to be
@@ -470,6 +514,277 @@ TEST_F(E2EFilterTest, list) {
       10);
 }
 
+TEST_F(E2EFilterTest, nativeWriterMagic) {
+  useNativeWriter_ = true;
+  rowType_ = ROW({INTEGER()});
+  std::vector<RowVectorPtr> batches;
+  batches.push_back(std::static_pointer_cast<RowVector>(
+      test::BatchMaker::createBatch(rowType_, 20000, *leafPool_, nullptr, 0)));
+  writeToMemory(rowType_, batches, false);
+  auto data = sinkPtr_->getData();
+  auto size = sinkPtr_->size();
+  EXPECT_EQ("PAR1", std::string(data, 4));
+  EXPECT_EQ("PAR1", std::string(data + size - 4, 4));
+}
+
+TEST_F(E2EFilterTest, nativeWriterBoolean) {
+  useNativeWriter_ = true;
+  testWithTypes(
+      "boolean_val:boolean,"
+      "boolean_null:boolean",
+      [&]() { makeAllNulls("boolean_null"); },
+      true,
+      {"boolean_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterIntegerDirect) {
+  useNativeWriter_ = true;
+  options_.enableDictionary = false;
+  options_.dataPageSize = 4 * 1024;
+
+  testWithTypes(
+      "tiny_val:tinyint,"
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "long_null:bigint",
+      [&]() { makeAllNulls("long_null"); },
+      true,
+      {"tiny_val", "short_val", "int_val", "long_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterIntegerDictionary) {
+  useNativeWriter_ = true;
+  options_.dataPageSize = 4 * 1024;
+
+  testWithTypes(
+      "int_val:int,"
+      "long_val:bigint",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+
+        makeIntDistribution<int32_t>(
+            "int_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            100000000, // rareMax
+            false); // keepNulls
+      },
+      true,
+      {"int_val", "long_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterFloatAndDouble) {
+  useNativeWriter_ = true;
+  testWithTypes(
+      "float_val:float,"
+      "double_val:double,"
+      "float_val2:float,"
+      "double_val2:double,"
+      "float_null:float",
+      [&]() {
+        makeAllNulls("float_null");
+        makeQuantizedFloat<float>("float_val2", 200, true);
+        makeQuantizedFloat<double>("double_val2", 522, true);
+        makeReapeatingValues<float>("float_val2", 0, 100, 200, 10.1);
+        makeReapeatingValues<double>("double_val2", 0, 100, 200, 100.8);
+      },
+      true,
+      {"float_val", "double_val", "float_val2", "double_val2", "float_null"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterString) {
+  useNativeWriter_ = true;
+  options_.dataPageSize = 4 * 1024;
+
+  testWithTypes(
+      "string_val:string,"
+      "string_val_2:string,"
+      "string_const: string",
+      [&]() {
+        makeStringDistribution("string_val", 100, true, false);
+        makeStringUnique("string_val_2");
+        makeStringDistribution("string_const", 1, true, false);
+      },
+      true,
+      {"string_val", "string_val_2"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterDedictionarize) {
+  useNativeWriter_ = true;
+  options_.maxRowGroupLength = 10'000'000;
+  options_.dictionaryPageSizeLimit = 20'000;
+
+  testWithTypes(
+      "long_val: bigint,"
+      "string_val:string,"
+      "string_val_2:string",
+      [&]() {
+        makeStringDistribution("string_val", 10000000, true, false);
+        makeStringDistribution("string_val_2", 1700000, false, true);
+      },
+      true,
+      {"long_val", "string_val", "string_val_2"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterStruct) {
+  useNativeWriter_ = true;
+  testWithTypes(
+      "long_val:bigint,"
+      "outer_struct: struct<nested1:bigint, "
+      "  data1: string, "
+      "  inner_struct: struct<nested2: bigint, data2: smallint>>",
+      [&]() {},
+      false,
+      {"long_val",
+       "outer_struct.inner_struct",
+       "outer_struct.nested1",
+       "outer_struct.inner_struct.nested2"},
+      40);
+}
+
+TEST_F(E2EFilterTest, nativeWriterCompression) {
+  useNativeWriter_ = true;
+  options_.dataPageSize = 4 * 1024;
+  for (const auto compression :
+       {dwio::common::CompressionKind_SNAPPY,
+        dwio::common::CompressionKind_ZSTD,
+        dwio::common::CompressionKind_GZIP}) {
+    options_.compression = compression;
+
+    testWithTypes(
+        "int_val:int,"
+        "string_val:string",
+        [&]() { makeStringDistribution("string_val", 100, true, false); },
+        true,
+        {"int_val", "string_val"},
+        3);
+  }
+}
+
+TEST_F(E2EFilterTest, nativeWriterBloomFilter) {
+  useNativeWriter_ = true;
+  options_.enableBloomFilter = true;
+
+  testWithTypes(
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+        makeStringDistribution("string_val", 100, true, false);
+      },
+      true,
+      {"long_val", "string_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterDictionaryVector) {
+  useNativeWriter_ = true;
+  rowType_ = ROW({"int_val", "string_val"}, {INTEGER(), VARCHAR()});
+  constexpr vector_size_t kNumDistinct = 100;
+  constexpr vector_size_t kSize = 25'000;
+  auto base = std::static_pointer_cast<RowVector>(test::BatchMaker::createBatch(
+      rowType_, kNumDistinct, *leafPool_, nullptr, 0));
+  auto indices = allocateIndices(kSize, leafPool_.get());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < kSize; ++i) {
+    rawIndices[i] = (i * 7) % kNumDistinct;
+  }
+  std::vector<VectorPtr> children;
+  for (const auto& child : base->children()) {
+    children.push_back(
+        BaseVector::wrapInDictionary(nullptr, indices, kSize, child));
+  }
+  std::vector<RowVectorPtr> batches;
+  batches.push_back(std::make_shared<RowVector>(
+      leafPool_.get(), rowType_, nullptr, kSize, std::move(children)));
+  writeToMemory(rowType_, batches, false);
+
+  auto spec = std::make_shared<common::ScanSpec>("<root>");
+  spec->addAllChildFields(*rowType_);
+  uint64_t time = 0;
+  readWithoutFilter(spec, batches, time);
+}
+
+TEST_F(E2EFilterTest, dictionaryEncodedStringIds) {
+  useNativeWriter_ = true;
+  rowType_ = ROW({"string_val"}, {VARCHAR()});
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 4; ++i) {
+    batches.push_back(
+        std::static_pointer_cast<RowVector>(test::BatchMaker::createBatch(
+            rowType_, 5'000, *leafPool_, nullptr, i)));
+    auto strings = batches.back()->childAt(0)->asFlatVector<StringView>();
+    for (auto row = 0; row < strings->size(); ++row) {
+      if (!strings->isNullAt(row)) {
+        strings->set(row, StringView(fmt::format("value-{}", row % 50)));
+      }
+    }
+  }
+  writeToMemory(rowType_, batches, false);
+
+  for (auto makeFlat : {false, true}) {
+    auto spec = std::make_shared<common::ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->childByName("string_val")->setMakeFlat(makeFlat);
+    dwio::common::ReaderOptions readerOpts{leafPool_.get()};
+    dwio::common::RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setScanSpec(spec);
+    std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+    auto input = std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+    auto reader = makeReader(readerOpts, std::move(input));
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+
+    auto batchIndex = 0;
+    auto rowIndex = 0;
+    auto result = BaseVector::create(rowType_, 1, leafPool_.get());
+    while (rowReader->next(1'000, result)) {
+      auto strings = result->as<RowVector>()->childAt(0)->loadedVector();
+      // All pages are dictionary encoded, so the values are ids into the
+      // page dictionary unless a flat vector is requested.
+      EXPECT_EQ(
+          makeFlat ? VectorEncoding::Simple::FLAT
+                   : VectorEncoding::Simple::DICTIONARY,
+          strings->encoding());
+      for (auto i = 0; i < strings->size(); ++i) {
+        ASSERT_TRUE(strings->equalValueAt(
+            batches[batchIndex]->childAt(0).get(), i, rowIndex));
+        if (++rowIndex == batches[batchIndex]->size()) {
+          rowIndex = 0;
+          ++batchIndex;
+        }
+      }
+    }
+    EXPECT_EQ(batches.size(), batchIndex);
+  }
+}
+
 TEST_F(E2EFilterTest, metadataFilter) {
   testMetadataFilter();
 }
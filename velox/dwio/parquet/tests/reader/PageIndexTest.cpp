@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+std::string plain(int64_t value) {
+  return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Makes the page index of a BIGINT column with pages of 'pageSize' rows,
+// where page i has values in [i * 100, i * 100 + 99]. Pages in 'nullPages'
+// have only nulls.
+void makePageIndex(
+    int32_t numPages,
+    int64_t pageSize,
+    const std::vector<int32_t>& nullPages,
+    thrift::ColumnIndex& columnIndex,
+    thrift::OffsetIndex& offsetIndex) {
+  for (auto i = 0; i < numPages; ++i) {
+    const bool isNull = std::find(nullPages.begin(), nullPages.end(), i) !=
+        nullPages.end();
+    columnIndex.null_pages.push_back(isNull);
+    columnIndex.min_values.push_back(isNull ? "" : plain(i * 100));
+    columnIndex.max_values.push_back(isNull ? "" : plain(i * 100 + 99));
+    columnIndex.null_counts.push_back(isNull ? pageSize : 0);
+    thrift::PageLocation location;
+    location.offset = 4 + i * 1000;
+    location.compressed_page_size = 1000;
+    location.first_row_index = i * pageSize;
+    offsetIndex.page_locations.push_back(location);
+  }
+  columnIndex.__isset.null_counts = true;
+}
+} // namespace
+
+TEST(PageIndexTest, filterPages) {
+  thrift::ColumnIndex columnIndex;
+  thrift::OffsetIndex offsetIndex;
+  makePageIndex(10, 1000, {7}, columnIndex, offsetIndex);
+
+  // A point lookup hits one page.
+  common::BigintRange point(250, 250, false);
+  EXPECT_EQ(
+      std::vector<RowRange>({{2000, 3000}}),
+      filterPages(point, BIGINT(), columnIndex, offsetIndex, 9500));
+
+  // Adjacent pages are merged. The last page ends at the end of the row
+  // group.
+  common::BigintRange range(150, 10'000, false);
+  EXPECT_EQ(
+      std::vector<RowRange>({{1000, 7000}, {8000, 9500}}),
+      filterPages(range, BIGINT(), columnIndex, offsetIndex, 9500));
+
+  // Only the all null page passes IS NULL.
+  common::IsNull isNull;
+  EXPECT_EQ(
+      std::vector<RowRange>({{7000, 8000}}),
+      filterPages(isNull, BIGINT(), columnIndex, offsetIndex, 9500));
+
+  common::BigintRange none(2000, 3000, false);
+  EXPECT_TRUE(
+      filterPages(none, BIGINT(), columnIndex, offsetIndex, 9500).empty());
+}
+
+TEST(PageIndexTest, intersectRowRanges) {
+  std::vector<RowRange> left = {{0, 100}, {200, 300}, {400, 500}};
+  std::vector<RowRange> right = {{50, 250}, {300, 450}};
+  EXPECT_EQ(
+      std::vector<RowRange>({{50, 100}, {200, 250}, {400, 450}}),
+      intersectRowRanges(left, right));
+  EXPECT_EQ(
+      std::vector<RowRange>({{50, 100}, {200, 250}, {400, 450}}),
+      intersectRowRanges(right, left));
+  EXPECT_TRUE(intersectRowRanges(left, {}).empty());
+  EXPECT_TRUE(intersectRowRanges({{0, 10}}, {{10, 20}}).empty());
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+TEST(SplitBlockBloomFilterTest, hash) {
+  // XXH64 with seed 0, as in the Parquet spec.
+  EXPECT_EQ(0xef46db3751d8e999ULL, SplitBlockBloomFilter::hash("", 0));
+}
+
+TEST(SplitBlockBloomFilterTest, insertAndTest) {
+  auto bloomFilter = SplitBlockBloomFilter::empty(1024);
+  for (int64_t i = 0; i < 100; ++i) {
+    bloomFilter.insertHash(SplitBlockBloomFilter::hash(&i, sizeof(i)));
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 10'000; ++i) {
+    if (i < 100) {
+      EXPECT_TRUE(bloomFilter.mayContain(i)) << i;
+    } else if (bloomFilter.mayContain(i)) {
+      ++numFalsePositives;
+    }
+  }
+  EXPECT_LT(numFalsePositives, 100);
+}
+
+TEST(SplitBlockBloomFilterTest, testFilters) {
+  auto ints = SplitBlockBloomFilter::empty(256);
+  auto bytes = SplitBlockBloomFilter::empty(256);
+  for (int32_t value : {10, 20, 30}) {
+    ints.insertHash(SplitBlockBloomFilter::hash(&value, sizeof(value)));
+  }
+  for (std::string_view value : {"apple", "pear"}) {
+    bytes.insertHash(SplitBlockBloomFilter::hash(value.data(), value.size()));
+  }
+
+  common::BigintRange equal20(20, 20, false);
+  common::BigintRange equal21(21, 21, false);
+  common::BigintRange range(10, 30, false);
+  common::BigintRange equal20OrNull(20, 20, true);
+  EXPECT_TRUE(isBloomFilterTestable(equal20));
+  EXPECT_FALSE(isBloomFilterTestable(range));
+  EXPECT_FALSE(isBloomFilterTestable(equal20OrNull));
+  EXPECT_TRUE(testBloomFilter(equal20, thrift::Type::INT32, ints));
+  EXPECT_FALSE(testBloomFilter(equal21, thrift::Type::INT32, ints));
+  // An INT64 column hashes 8 byte values.
+  EXPECT_FALSE(testBloomFilter(equal20, thrift::Type::INT64, ints));
+
+  auto in = common::createBigintValues({5, 30, 1LL << 40}, false);
+  EXPECT_TRUE(isBloomFilterTestable(*in));
+  EXPECT_TRUE(testBloomFilter(*in, thrift::Type::INT32, ints));
+  auto notIn = common::createBigintValues({5, 1LL << 40}, false);
+  EXPECT_FALSE(testBloomFilter(*notIn, thrift::Type::INT32, ints));
+
+  common::BytesValues fruits({"pear", "plum"}, false);
+  common::BytesValues otherFruits({"fig", "plum"}, false);
+  EXPECT_TRUE(isBloomFilterTestable(fruits));
+  EXPECT_TRUE(testBloomFilter(fruits, thrift::Type::BYTE_ARRAY, bytes));
+  EXPECT_FALSE(testBloomFilter(otherFruits, thrift::Type::BYTE_ARRAY, bytes));
+  common::BytesRange apple("apple", false, false, "apple", false, false, false);
+  EXPECT_TRUE(isBloomFilterTestable(apple));
+  EXPECT_TRUE(testBloomFilter(apple, thrift::Type::BYTE_ARRAY, bytes));
+}
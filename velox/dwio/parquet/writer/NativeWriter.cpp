@@ -0,0 +1,1142 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
+#include "velox/vector/DecodedVector.h"
+
+#include <folly/Random.h>
+#include <folly/ScopeGuard.h>
+#include <folly/Varint.h>
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+#include <snappy.h>
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
+#include <zlib.h>
+#include <zstd.h>
+
+#include <cmath>
+#include <deque>
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+constexpr std::string_view kMagic = "PAR1";
+constexpr std::string_view kCreatedBy = "velox";
+constexpr int32_t kZstdLevel = 1;
+constexpr double kBloomFilterFpp = 0.01;
+constexpr uint64_t kMaxBloomFilterBytes = 1 << 20;
+
+template <typename T>
+std::string serializeThrift(const T& object) {
+  auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocolT<
+      apache::thrift::transport::TMemoryBuffer>
+      protocol(buffer);
+  object.write(&protocol);
+  return buffer->getBufferAsString();
+}
+
+// Returns the number of bits needed for values up to 'maxValue'.
+int32_t bitWidth(uint64_t maxValue) {
+  return maxValue == 0 ? 0 : 64 - __builtin_clzll(maxValue);
+}
+
+void appendVarint(uint64_t value, std::string& out) {
+  uint8_t buffer[folly::kMaxVarintLength64];
+  const auto size = folly::encodeVarint(value, buffer);
+  out.append(reinterpret_cast<const char*>(buffer), size);
+}
+
+// Appends a bit-packed run of 'values'. The last group of 8 is padded with
+// zeros.
+template <typename T>
+void appendBitPackedRun(
+    const T* values,
+    int32_t numValues,
+    int32_t bitWidth,
+    std::string& out) {
+  const auto numGroups = bits::roundUp(numValues, 8) / 8;
+  appendVarint((numGroups << 1) | 1, out);
+  const auto offset = out.size();
+  out.resize(offset + numGroups * bitWidth, '\0');
+  auto* data = reinterpret_cast<uint8_t*>(out.data() + offset);
+  uint64_t buffer = 0;
+  int32_t numBits = 0;
+  for (auto i = 0; i < numValues; ++i) {
+    buffer |= static_cast<uint64_t>(values[i]) << numBits;
+    numBits += bitWidth;
+    while (numBits >= 8) {
+      *data++ = buffer;
+      buffer >>= 8;
+      numBits -= 8;
+    }
+  }
+  if (numBits > 0) {
+    *data = buffer;
+  }
+}
+
+template <typename T>
+void appendRleRun(T value, int32_t count, int32_t bitWidth, std::string& out) {
+  appendVarint(static_cast<uint64_t>(count) << 1, out);
+  const uint64_t wide = value;
+  out.append(reinterpret_cast<const char*>(&wide), bits::nbytes(bitWidth));
+}
+
+// Appends 'values' in the RLE/bit-packed hybrid encoding with 'bitWidth' bits
+// per value. Repeats of at least 8 values become RLE runs, the rest is bit
+// packed in groups of 8.
+template <typename T>
+void encodeRleBp(
+    const T* values,
+    int32_t numValues,
+    int32_t bitWidth,
+    std::string& out) {
+  constexpr int32_t kMinRepeat = 8;
+  int32_t literalStart = 0;
+  int32_t i = 0;
+  while (i < numValues) {
+    auto runEnd = i + 1;
+    while (runEnd < numValues && values[runEnd] == values[i]) {
+      ++runEnd;
+    }
+    // A bit-packed run before a repeat must be a multiple of 8 values, so the
+    // first values of the repeat may go into it.
+    const auto numToAlign = (8 - (i - literalStart) % 8) % 8;
+    if (runEnd - i - numToAlign >= kMinRepeat) {
+      i += numToAlign;
+      if (i > literalStart) {
+        appendBitPackedRun(
+            values + literalStart, i - literalStart, bitWidth, out);
+      }
+      appendRleRun(values[i], runEnd - i, bitWidth, out);
+      literalStart = runEnd;
+    }
+    i = runEnd;
+  }
+  if (literalStart < numValues) {
+    appendBitPackedRun(
+        values + literalStart, numValues - literalStart, bitWidth, out);
+  }
+}
+
+// Appends 'levels' with their 4 byte length as in a DATA_PAGE.
+void appendLevels(
+    const std::vector<uint8_t>& levels,
+    int32_t maxLevel,
+    std::string& out) {
+  const auto lengthOffset = out.size();
+  out.append(sizeof(uint32_t), '\0');
+  encodeRleBp(levels.data(), levels.size(), bitWidth(maxLevel), out);
+  const uint32_t length = out.size() - lengthOffset - sizeof(uint32_t);
+  memcpy(out.data() + lengthOffset, &length, sizeof(length));
+}
+
+// Appends 'values', one byte per value, as PLAIN encoded booleans.
+void appendBooleans(const std::string& values, std::string& out) {
+  const auto offset = out.size();
+  out.resize(offset + bits::nbytes(values.size()), '\0');
+  for (auto i = 0; i < values.size(); ++i) {
+    if (values[i]) {
+      out[offset + i / 8] |= 1 << (i % 8);
+    }
+  }
+}
+
+thrift::CompressionCodec::type toThriftCodec(
+    dwio::common::CompressionKind compression) {
+  switch (compression) {
+    case dwio::common::CompressionKind_NONE:
+      return thrift::CompressionCodec::UNCOMPRESSED;
+    case dwio::common::CompressionKind_SNAPPY:
+      return thrift::CompressionCodec::SNAPPY;
+    case dwio::common::CompressionKind_ZSTD:
+      return thrift::CompressionCodec::ZSTD;
+    case dwio::common::CompressionKind_GZIP:
+      return thrift::CompressionCodec::GZIP;
+    default:
+      VELOX_UNSUPPORTED("Unsupported Parquet compression {}", compression);
+  }
+}
+
+std::string compress(thrift::CompressionCodec::type codec, std::string data) {
+  std::string result;
+  switch (codec) {
+    case thrift::CompressionCodec::UNCOMPRESSED:
+      return data;
+    case thrift::CompressionCodec::SNAPPY:
+      snappy::Compress(data.data(), data.size(), &result);
+      return result;
+    case thrift::CompressionCodec::ZSTD: {
+      result.resize(ZSTD_compressBound(data.size()));
+      const auto size = ZSTD_compress(
+          result.data(), result.size(), data.data(), data.size(), kZstdLevel);
+      VELOX_CHECK(
+          !ZSTD_isError(size),
+          "ZSTD returned an error: {}",
+          ZSTD_getErrorName(size));
+      result.resize(size);
+      return result;
+    }
+    case thrift::CompressionCodec::GZIP: {
+      z_stream stream;
+      memset(&stream, 0, sizeof(stream));
+      constexpr int kWindowBits = 15;
+      // Writes a gzip header and trailer.
+      constexpr int kGzipCodec = 16;
+      constexpr int kMemLevel = 8;
+      auto ret = deflateInit2(
+          &stream,
+          Z_DEFAULT_COMPRESSION,
+          Z_DEFLATED,
+          kWindowBits | kGzipCodec,
+          kMemLevel,
+          Z_DEFAULT_STRATEGY);
+      VELOX_CHECK(
+          ret == Z_OK,
+          "zlib deflateInit failed: {}",
+          stream.msg ? stream.msg : "");
+      auto deflateEndGuard = folly::makeGuard([&] { deflateEnd(&stream); });
+      result.resize(deflateBound(&stream, data.size()));
+      stream.next_in = reinterpret_cast<Bytef*>(data.data());
+      stream.avail_in = static_cast<uInt>(data.size());
+      stream.next_out = reinterpret_cast<Bytef*>(result.data());
+      stream.avail_out = static_cast<uInt>(result.size());
+      ret = deflate(&stream, Z_FINISH);
+      VELOX_CHECK(
+          ret == Z_STREAM_END,
+          "GZipCodec failed: {}",
+          stream.msg ? stream.msg : "");
+      result.resize(stream.total_out);
+      return result;
+    }
+    default:
+      VELOX_UNSUPPORTED("Unsupported Parquet compression type '{}'", codec);
+  }
+}
+
+// Appends 'header' and 'body' to 'out'. Returns the number of bytes appended.
+int64_t appendPage(
+    const thrift::PageHeader& header,
+    const std::string& body,
+    std::string& out) {
+  const auto serializedHeader = serializeThrift(header);
+  out.append(serializedHeader);
+  out.append(body);
+  return serializedHeader.size() + body.size();
+}
+
+thrift::Type::type physicalType(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return thrift::Type::BOOLEAN;
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return thrift::Type::INT32;
+    case TypeKind::BIGINT:
+      return thrift::Type::INT64;
+    case TypeKind::REAL:
+      return thrift::Type::FLOAT;
+    case TypeKind::DOUBLE:
+      return thrift::Type::DOUBLE;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return thrift::Type::BYTE_ARRAY;
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+std::optional<thrift::ConvertedType::type> convertedType(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return thrift::ConvertedType::INT_8;
+    case TypeKind::SMALLINT:
+      return thrift::ConvertedType::INT_16;
+    case TypeKind::DATE:
+      return thrift::ConvertedType::DATE;
+    case TypeKind::VARCHAR:
+      return thrift::ConvertedType::UTF8;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Returns the size of a Bloom filter for 'numDistinct' values with a false
+// positive rate of about kBloomFilterFpp.
+int32_t bloomFilterBytes(int64_t numDistinct) {
+  const double numBits =
+      -8.0 * numDistinct / std::log(1 - std::pow(kBloomFilterFpp, 1.0 / 8));
+  return std::clamp<uint64_t>(
+      bits::nextPowerOfTwo(static_cast<uint64_t>(numBits / 8)),
+      SplitBlockBloomFilter::kBytesPerBlock,
+      kMaxBloomFilterBytes);
+}
+
+// Parquet representation of a Velox value. Small integers and dates are
+// INT32 and strings are their bytes.
+template <typename T>
+struct ParquetValue {
+  using type = T;
+  static T from(T value) {
+    return value;
+  }
+};
+
+template <>
+struct ParquetValue<int8_t> {
+  using type = int32_t;
+  static int32_t from(int8_t value) {
+    return value;
+  }
+};
+
+template <>
+struct ParquetValue<int16_t> {
+  using type = int32_t;
+  static int32_t from(int16_t value) {
+    return value;
+  }
+};
+
+template <>
+struct ParquetValue<Date> {
+  using type = int32_t;
+  static int32_t from(Date value) {
+    return value.days();
+  }
+};
+
+template <>
+struct ParquetValue<StringView> {
+  using type = std::string_view;
+  static std::string_view from(StringView value) {
+    return std::string_view(value.data(), value.size());
+  }
+};
+
+// Key of a value in a dictionary. Floating point values are keyed by their
+// bits so that NaNs are found and 0.0 and -0.0 stay distinct.
+template <typename T>
+struct DictionaryKey {
+  using type = T;
+  static T of(T value) {
+    return value;
+  }
+};
+
+template <>
+struct DictionaryKey<float> {
+  using type = uint32_t;
+  static uint32_t of(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+template <>
+struct DictionaryKey<double> {
+  using type = uint64_t;
+  static uint64_t of(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+template <typename T>
+void appendPlain(T value, std::string& out) {
+  if constexpr (std::is_same_v<T, std::string_view>) {
+    const uint32_t length = value.size();
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.append(value.data(), value.size());
+  } else {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+}
+
+template <typename T>
+std::string encodeStatistic(const T& value) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    return value;
+  } else {
+    return std::string(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+}
+
+// Zeros compare equal, so the minimum is written as -0.0 and the maximum as
+// 0.0 for readers that compare bits.
+template <typename T>
+std::string encodeMin(T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    if (value == 0) {
+      value = -0.0;
+    }
+  }
+  return encodeStatistic(value);
+}
+
+template <typename T>
+std::string encodeMax(T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    if (value == 0) {
+      value = 0.0;
+    }
+  }
+  return encodeStatistic(value);
+}
+
+} // namespace
+
+// Buffers the pages of a leaf column for the current row group. Keeps the
+// page indexes and Bloom filters of the finished column chunks until the
+// writer closes.
+class ColumnChunkWriter {
+ public:
+  virtual ~ColumnChunkWriter() = default;
+
+  // Appends a value or a null for each of 'rows'. See
+  // NativeWriter::writeColumn().
+  virtual void append(
+      const BaseVector& vector,
+      const std::vector<vector_size_t>& rows,
+      const std::vector<uint8_t>& levels) = 0;
+
+  // Returns the estimated size of the buffered column chunk.
+  virtual int64_t bufferedBytes() const = 0;
+
+  // Appends the buffered column chunk to 'out', which starts at file offset
+  // 'offset', and returns its metadata.
+  virtual thrift::ColumnChunk finishChunk(int64_t offset, std::string& out) = 0;
+
+  // Appends the Bloom filters, column indexes and offset indexes of the
+  // finished chunks to 'out', which starts at file offset 'offset'. Sets
+  // their locations in the chunks at 'column' in 'rowGroups'.
+  void writeIndexes(
+      int32_t column,
+      int64_t offset,
+      std::string& out,
+      std::vector<thrift::RowGroup>& rowGroups);
+
+ protected:
+  struct ChunkIndexes {
+    std::optional<thrift::ColumnIndex> columnIndex;
+    thrift::OffsetIndex offsetIndex;
+    std::optional<SplitBlockBloomFilter> bloomFilter;
+  };
+
+  // One per finished column chunk.
+  std::vector<ChunkIndexes> chunkIndexes_;
+};
+
+void ColumnChunkWriter::writeIndexes(
+    int32_t column,
+    int64_t offset,
+    std::string& out,
+    std::vector<thrift::RowGroup>& rowGroups) {
+  VELOX_CHECK_EQ(chunkIndexes_.size(), rowGroups.size());
+  for (auto i = 0; i < rowGroups.size(); ++i) {
+    auto& chunk = rowGroups[i].columns[column];
+    const auto& indexes = chunkIndexes_[i];
+    if (indexes.bloomFilter.has_value()) {
+      const auto& bitset = indexes.bloomFilter->bitset();
+      thrift::BloomFilterAlgorithm algorithm;
+      algorithm.__set_BLOCK(thrift::SplitBlockAlgorithm());
+      thrift::BloomFilterHash hash;
+      hash.__set_XXHASH(thrift::XxHash());
+      thrift::BloomFilterCompression compression;
+      compression.__set_UNCOMPRESSED(thrift::Uncompressed());
+      thrift::BloomFilterHeader header;
+      header.__set_numBytes(bitset.size());
+      header.__set_algorithm(algorithm);
+      header.__set_hash(hash);
+      header.__set_compression(compression);
+      chunk.meta_data.__set_bloom_filter_offset(offset + out.size());
+      out.append(serializeThrift(header));
+      out.append(bitset);
+    }
+    if (indexes.columnIndex.has_value()) {
+      const auto serialized = serializeThrift(*indexes.columnIndex);
+      chunk.__set_column_index_offset(offset + out.size());
+      chunk.__set_column_index_length(serialized.size());
+      out.append(serialized);
+    }
+    const auto serialized = serializeThrift(indexes.offsetIndex);
+    chunk.__set_offset_index_offset(offset + out.size());
+    chunk.__set_offset_index_length(serialized.size());
+    out.append(serialized);
+  }
+  chunkIndexes_.clear();
+}
+
+namespace {
+
+template <TypeKind kKind>
+class TypedColumnChunkWriter : public ColumnChunkWriter {
+  using T = typename TypeTraits<kKind>::NativeType;
+  using P = typename ParquetValue<T>::type;
+  // Owns the bytes of string minimums and maximums.
+  using Stat =
+      std::conditional_t<std::is_same_v<P, std::string_view>, std::string, P>;
+
+  static constexpr bool kIsString = std::is_same_v<P, std::string_view>;
+  static constexpr int32_t kNoId = -1;
+
+ public:
+  TypedColumnChunkWriter(
+      const WriterOptions& options,
+      const std::vector<std::string>& path)
+      : physicalType_(physicalType(kKind)),
+        codec_(toThriftCodec(options.compression)),
+        path_(path),
+        maxDefinitionLevel_(path.size()),
+        dataPageSize_(options.dataPageSize),
+        dictionaryPageSizeLimit_(options.dictionaryPageSizeLimit),
+        enableDictionary_(
+            options.enableDictionary && kKind != TypeKind::BOOLEAN),
+        enableBloomFilter_(
+            options.enableBloomFilter &&
+            (physicalType_ == thrift::Type::INT32 ||
+             physicalType_ == thrift::Type::INT64 ||
+             physicalType_ == thrift::Type::BYTE_ARRAY)),
+        useDictionary_(enableDictionary_) {}
+
+  void append(
+      const BaseVector& vector,
+      const std::vector<vector_size_t>& rows,
+      const std::vector<uint8_t>& levels) override {
+    decoded_.decode(vector);
+    // The dictionary ids of the base values of a DictionaryVector are looked
+    // up once per batch.
+    const bool cacheIds = useDictionary_ && !decoded_.isIdentityMapping() &&
+        decoded_.base()->size() <= rows.size();
+    if (cacheIds) {
+      baseIds_.assign(decoded_.base()->size(), kNoId);
+    }
+    for (auto i = 0; i < rows.size(); ++i) {
+      const auto row = rows[i];
+      if (row < 0 || decoded_.isNullAt(row)) {
+        pageLevels_.push_back(levels[i]);
+        ++pageNulls_;
+      } else {
+        pageLevels_.push_back(levels[i] + 1);
+        const auto value = ParquetValue<T>::from(decoded_.valueAt<T>(row));
+        updateStatistics(value);
+        if (useDictionary_) {
+          if (cacheIds) {
+            auto& id = baseIds_[decoded_.index(row)];
+            if (id == kNoId) {
+              id = dictionaryId(value);
+            }
+            pageIds_.push_back(id);
+          } else {
+            pageIds_.push_back(dictionaryId(value));
+          }
+        } else {
+          appendPlain(value, pageValues_);
+          if (enableBloomFilter_) {
+            bloomHashes_.insert(hash(value));
+          }
+        }
+      }
+      if (pageBytes() >= dataPageSize_) {
+        finishPage();
+      }
+      if (useDictionary_ && dictionaryBytes_ > dictionaryPageSizeLimit_) {
+        // The pages so far stay dictionary encoded and the rest of the chunk
+        // is PLAIN.
+        finishPage();
+        useDictionary_ = false;
+      }
+    }
+  }
+
+  int64_t bufferedBytes() const override {
+    return pages_.size() + pageBytes() + dictionaryBytes_;
+  }
+
+  thrift::ColumnChunk finishChunk(int64_t offset, std::string& out) override {
+    finishPage();
+    const auto start = out.size();
+    thrift::ColumnMetaData metadata;
+    if (!dictionary_.empty()) {
+      std::string plain;
+      for (auto value : dictionary_) {
+        appendPlain(value, plain);
+      }
+      thrift::DictionaryPageHeader dictionaryHeader;
+      dictionaryHeader.__set_num_values(dictionary_.size());
+      dictionaryHeader.__set_encoding(thrift::Encoding::PLAIN);
+      const auto uncompressedSize = plain.size();
+      const auto compressed = compress(codec_, std::move(plain));
+      thrift::PageHeader header;
+      header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+      header.__set_uncompressed_page_size(uncompressedSize);
+      header.__set_compressed_page_size(compressed.size());
+      header.__set_dictionary_page_header(dictionaryHeader);
+      metadata.__set_dictionary_page_offset(offset + out.size());
+      const auto bytes = appendPage(header, compressed, out);
+      uncompressedBytes_ += bytes - compressed.size() + uncompressedSize;
+      addEncoding(thrift::Encoding::PLAIN);
+    }
+    const int64_t dataPageOffset = offset + out.size();
+    metadata.__set_data_page_offset(dataPageOffset);
+    out.append(pages_);
+    addEncoding(thrift::Encoding::RLE);
+
+    thrift::Statistics statistics;
+    statistics.__set_null_count(chunkNulls_);
+    if (chunkMin_.has_value()) {
+      statistics.__set_min_value(encodeMin(*chunkMin_));
+      statistics.__set_max_value(encodeMax(*chunkMax_));
+    }
+    metadata.__set_type(physicalType_);
+    metadata.__set_encodings(encodings_);
+    metadata.__set_path_in_schema(path_);
+    metadata.__set_codec(codec_);
+    metadata.__set_num_values(chunkRows_);
+    metadata.__set_total_uncompressed_size(uncompressedBytes_);
+    metadata.__set_total_compressed_size(out.size() - start);
+    metadata.__set_statistics(statistics);
+    thrift::ColumnChunk chunk;
+    chunk.__set_file_offset(offset + start);
+    chunk.__set_meta_data(metadata);
+
+    ChunkIndexes indexes;
+    for (auto& location : pageLocations_) {
+      location.offset += dataPageOffset;
+    }
+    indexes.offsetIndex.__set_page_locations(pageLocations_);
+    if (hasColumnIndex_) {
+      thrift::ColumnIndex columnIndex;
+      columnIndex.__set_null_pages(nullPages_);
+      columnIndex.__set_min_values(minValues_);
+      columnIndex.__set_max_values(maxValues_);
+      columnIndex.__set_boundary_order(thrift::BoundaryOrder::UNORDERED);
+      columnIndex.__set_null_counts(nullCounts_);
+      indexes.columnIndex = std::move(columnIndex);
+    }
+    if (enableBloomFilter_) {
+      indexes.bloomFilter = makeBloomFilter();
+    }
+    chunkIndexes_.push_back(std::move(indexes));
+    resetChunk();
+    return chunk;
+  }
+
+ private:
+  int64_t pageBytes() const {
+    const int64_t valueBytes = kKind == TypeKind::BOOLEAN
+        ? pageValues_.size() / 8
+        : pageValues_.size();
+    return pageLevels_.size() / 8 + valueBytes +
+        pageIds_.size() * bitWidth(dictionary_.size()) / 8;
+  }
+
+  void updateStatistics(P value) {
+    if constexpr (std::is_floating_point_v<P>) {
+      if (std::isnan(value)) {
+        return;
+      }
+    }
+    if (!pageMin_.has_value() || value < *pageMin_) {
+      pageMin_ = Stat(value);
+    }
+    if (!pageMax_.has_value() || value > *pageMax_) {
+      pageMax_ = Stat(value);
+    }
+  }
+
+  int32_t dictionaryId(P value) {
+    auto it = dictionaryIds_.find(DictionaryKey<P>::of(value));
+    if (it != dictionaryIds_.end()) {
+      return it->second;
+    }
+    if constexpr (kIsString) {
+      dictionaryBytes_ += sizeof(uint32_t) + value.size();
+      value = dictionaryStrings_.emplace_back(value);
+    } else {
+      dictionaryBytes_ += sizeof(P);
+    }
+    const int32_t id = dictionary_.size();
+    dictionary_.push_back(value);
+    dictionaryIds_.emplace(DictionaryKey<P>::of(value), id);
+    return id;
+  }
+
+  static uint64_t hash(P value) {
+    if constexpr (kIsString) {
+      return SplitBlockBloomFilter::hash(value.data(), value.size());
+    } else {
+      return SplitBlockBloomFilter::hash(&value, sizeof(P));
+    }
+  }
+
+  void addEncoding(thrift::Encoding::type encoding) {
+    if (std::find(encodings_.begin(), encodings_.end(), encoding) ==
+        encodings_.end()) {
+      encodings_.push_back(encoding);
+    }
+  }
+
+  void finishPage() {
+    if (pageLevels_.empty()) {
+      return;
+    }
+    const int32_t numRows = pageLevels_.size();
+    std::string body;
+    appendLevels(pageLevels_, maxDefinitionLevel_, body);
+    auto encoding = thrift::Encoding::PLAIN;
+    if (!pageIds_.empty()) {
+      encoding = thrift::Encoding::RLE_DICTIONARY;
+      const auto idBitWidth = std::max(1, bitWidth(dictionary_.size() - 1));
+      body.push_back(idBitWidth);
+      encodeRleBp(pageIds_.data(), pageIds_.size(), idBitWidth, body);
+    } else if constexpr (kKind == TypeKind::BOOLEAN) {
+      appendBooleans(pageValues_, body);
+    } else {
+      body.append(pageValues_);
+    }
+    addEncoding(encoding);
+
+    thrift::DataPageHeader dataPageHeader;
+    dataPageHeader.__set_num_values(numRows);
+    dataPageHeader.__set_encoding(encoding);
+    dataPageHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+    dataPageHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+    const auto uncompressedSize = body.size();
+    const auto compressed = compress(codec_, std::move(body));
+    thrift::PageHeader header;
+    header.__set_type(thrift::PageType::DATA_PAGE);
+    header.__set_uncompressed_page_size(uncompressedSize);
+    header.__set_compressed_page_size(compressed.size());
+    header.__set_data_page_header(dataPageHeader);
+    thrift::PageLocation location;
+    location.__set_offset(pages_.size());
+    const auto bytes = appendPage(header, compressed, pages_);
+    location.__set_compressed_page_size(bytes);
+    location.__set_first_row_index(chunkRows_);
+    pageLocations_.push_back(location);
+    uncompressedBytes_ += bytes - compressed.size() + uncompressedSize;
+
+    const bool nullPage = pageNulls_ == numRows;
+    if (!nullPage && !pageMin_.has_value()) {
+      // Only NaNs. The page has no bounds, so the chunk gets no column index.
+      hasColumnIndex_ = false;
+    }
+    nullPages_.push_back(nullPage);
+    nullCounts_.push_back(pageNulls_);
+    minValues_.push_back(pageMin_.has_value() ? encodeMin(*pageMin_) : "");
+    maxValues_.push_back(pageMax_.has_value() ? encodeMax(*pageMax_) : "");
+    if (pageMin_.has_value()) {
+      if (!chunkMin_.has_value() || *pageMin_ < *chunkMin_) {
+        chunkMin_ = std::move(pageMin_);
+      }
+      if (!chunkMax_.has_value() || *pageMax_ > *chunkMax_) {
+        chunkMax_ = std::move(pageMax_);
+      }
+    }
+    chunkNulls_ += pageNulls_;
+    chunkRows_ += numRows;
+
+    pageLevels_.clear();
+    pageIds_.clear();
+    pageValues_.clear();
+    pageNulls_ = 0;
+    pageMin_.reset();
+    pageMax_.reset();
+  }
+
+  std::optional<SplitBlockBloomFilter> makeBloomFilter() {
+    for (auto value : dictionary_) {
+      bloomHashes_.insert(hash(value));
+    }
+    if (bloomHashes_.empty()) {
+      return std::nullopt;
+    }
+    auto bloomFilter =
+        SplitBlockBloomFilter::empty(bloomFilterBytes(bloomHashes_.size()));
+    for (auto bloomHash : bloomHashes_) {
+      bloomFilter.insertHash(bloomHash);
+    }
+    return bloomFilter;
+  }
+
+  void resetChunk() {
+    pages_.clear();
+    pageLocations_.clear();
+    nullPages_.clear();
+    nullCounts_.clear();
+    minValues_.clear();
+    maxValues_.clear();
+    hasColumnIndex_ = true;
+    encodings_.clear();
+    chunkRows_ = 0;
+    chunkNulls_ = 0;
+    chunkMin_.reset();
+    chunkMax_.reset();
+    uncompressedBytes_ = 0;
+    dictionaryIds_.clear();
+    dictionary_.clear();
+    dictionaryStrings_.clear();
+    dictionaryBytes_ = 0;
+    useDictionary_ = enableDictionary_;
+    bloomHashes_.clear();
+  }
+
+  const thrift::Type::type physicalType_;
+  const thrift::CompressionCodec::type codec_;
+  const std::vector<std::string> path_;
+  const int32_t maxDefinitionLevel_;
+  const int64_t dataPageSize_;
+  const int64_t dictionaryPageSizeLimit_;
+  const bool enableDictionary_;
+  const bool enableBloomFilter_;
+
+  DecodedVector decoded_;
+  // Dictionary ids of the base values of 'decoded_'.
+  std::vector<int32_t> baseIds_;
+
+  // The page being filled. Values go to 'pageIds_' in dictionary mode and
+  // PLAIN encoded to 'pageValues_' otherwise, booleans one byte each.
+  std::vector<uint8_t> pageLevels_;
+  std::vector<uint32_t> pageIds_;
+  std::string pageValues_;
+  int32_t pageNulls_{0};
+  std::optional<Stat> pageMin_;
+  std::optional<Stat> pageMax_;
+
+  // The finished data pages of the chunk with their headers.
+  std::string pages_;
+  // Offsets are relative to 'pages_' until the chunk is finished.
+  std::vector<thrift::PageLocation> pageLocations_;
+  std::vector<bool> nullPages_;
+  std::vector<int64_t> nullCounts_;
+  std::vector<std::string> minValues_;
+  std::vector<std::string> maxValues_;
+  bool hasColumnIndex_{true};
+  std::vector<thrift::Encoding::type> encodings_;
+  int64_t chunkRows_{0};
+  int64_t chunkNulls_{0};
+  std::optional<Stat> chunkMin_;
+  std::optional<Stat> chunkMax_;
+  int64_t uncompressedBytes_{0};
+
+  // False after the dictionary of the chunk exceeded
+  // 'dictionaryPageSizeLimit_'.
+  bool useDictionary_;
+  folly::F14FastMap<typename DictionaryKey<P>::type, int32_t> dictionaryIds_;
+  std::vector<P> dictionary_;
+  // Owns the bytes of string dictionary values.
+  std::deque<std::string> dictionaryStrings_;
+  int64_t dictionaryBytes_{0};
+
+  // Hashes of the PLAIN encoded values of the chunk.
+  folly::F14FastSet<uint64_t> bloomHashes_;
+};
+
+std::unique_ptr<ColumnChunkWriter> makeColumnChunkWriter(
+    TypeKind kind,
+    const WriterOptions& options,
+    const std::vector<std::string>& path) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::BOOLEAN>>(
+          options, path);
+    case TypeKind::TINYINT:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::TINYINT>>(
+          options, path);
+    case TypeKind::SMALLINT:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::SMALLINT>>(
+          options, path);
+    case TypeKind::INTEGER:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::INTEGER>>(
+          options, path);
+    case TypeKind::BIGINT:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::BIGINT>>(
+          options, path);
+    case TypeKind::REAL:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::REAL>>(
+          options, path);
+    case TypeKind::DOUBLE:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::DOUBLE>>(
+          options, path);
+    case TypeKind::VARCHAR:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::VARCHAR>>(
+          options, path);
+    case TypeKind::VARBINARY:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::VARBINARY>>(
+          options, path);
+    case TypeKind::DATE:
+      return std::make_unique<TypedColumnChunkWriter<TypeKind::DATE>>(
+          options, path);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace
+
+NativeWriter::NativeWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    const WriterOptions& options)
+    : options_(options),
+      pool_(options.memoryPool->addAggregateChild(fmt::format(
+          "native_parquet_writer_node_{}",
+          folly::to<std::string>(folly::Random::rand64())))),
+      generalPool_(pool_->addLeafChild(".general")),
+      sink_(std::move(sink)) {
+  VELOX_CHECK_NOT_NULL(sink_);
+  VELOX_CHECK_GT(options_.rowsInRowGroup, 0);
+}
+
+NativeWriter::~NativeWriter() = default;
+
+// static
+bool NativeWriter::isSupported(const TypePtr& type) {
+  if (type->isDecimal()) {
+    return false;
+  }
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+    case TypeKind::DATE:
+      return true;
+    case TypeKind::ROW:
+      if (type->size() == 0) {
+        return false;
+      }
+      for (const auto& child : asRowType(type)->children()) {
+        if (!isSupported(child)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+void NativeWriter::initialize(const RowTypePtr& type) {
+  VELOX_USER_CHECK(
+      isSupported(type),
+      "Type not supported by the native Parquet writer: {}",
+      type->toString());
+  type_ = type;
+  thrift::SchemaElement root;
+  root.__set_name("schema");
+  root.__set_num_children(type->size());
+  schema_.push_back(root);
+  std::vector<std::string> path;
+  for (auto i = 0; i < type->size(); ++i) {
+    addSchemaElement(type->nameOf(i), type->childAt(i), path);
+  }
+}
+
+void NativeWriter::addSchemaElement(
+    const std::string& name,
+    const TypePtr& type,
+    std::vector<std::string>& path) {
+  path.push_back(name);
+  thrift::SchemaElement element;
+  element.__set_name(name);
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  if (type->kind() == TypeKind::ROW) {
+    element.__set_num_children(type->size());
+    schema_.push_back(element);
+    const auto& rowType = asRowType(type);
+    for (auto i = 0; i < rowType->size(); ++i) {
+      addSchemaElement(rowType->nameOf(i), rowType->childAt(i), path);
+    }
+  } else {
+    element.__set_type(physicalType(type->kind()));
+    if (auto converted = convertedType(type->kind())) {
+      element.__set_converted_type(*converted);
+    }
+    schema_.push_back(element);
+    columns_.push_back(makeColumnChunkWriter(type->kind(), options_, path));
+  }
+  path.pop_back();
+}
+
+void NativeWriter::write(const VectorPtr& data) {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  VELOX_CHECK_EQ(data->typeKind(), TypeKind::ROW);
+  if (!type_) {
+    initialize(asRowType(data->type()));
+  }
+  DecodedVector decoded(*data);
+  const auto* rowVector = decoded.base()->as<RowVector>();
+  VELOX_CHECK_EQ(rowVector->childrenSize(), type_->size());
+  vector_size_t offset = 0;
+  while (offset < data->size()) {
+    const auto numRows = std::min<vector_size_t>(
+        data->size() - offset, options_.rowsInRowGroup - bufferedRows_);
+    std::vector<vector_size_t> rows(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      rows[i] = decoded.index(offset + i);
+    }
+    const std::vector<uint8_t> levels(numRows, 0);
+    int32_t leaf = 0;
+    for (auto i = 0; i < type_->size(); ++i) {
+      writeColumn(
+          type_->childAt(i), rowVector->childAt(i), rows, levels, leaf);
+    }
+    offset += numRows;
+    bufferedRows_ += numRows;
+    if (bufferedRows_ >= options_.rowsInRowGroup ||
+        bufferedBytes() >= options_.maxRowGroupLength) {
+      flush();
+    }
+  }
+}
+
+void NativeWriter::writeColumn(
+    const TypePtr& type,
+    const VectorPtr& vector,
+    const std::vector<vector_size_t>& rows,
+    const std::vector<uint8_t>& levels,
+    int32_t& leaf) {
+  if (type->kind() != TypeKind::ROW) {
+    columns_[leaf++]->append(*vector, rows, levels);
+    return;
+  }
+  DecodedVector decoded(*vector);
+  const auto* rowVector = decoded.base()->as<RowVector>();
+  std::vector<vector_size_t> childRows(rows.size());
+  std::vector<uint8_t> childLevels(rows.size());
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (rows[i] < 0 || decoded.isNullAt(rows[i])) {
+      childRows[i] = -1;
+      childLevels[i] = levels[i];
+    } else {
+      childRows[i] = decoded.index(rows[i]);
+      childLevels[i] = levels[i] + 1;
+    }
+  }
+  for (auto i = 0; i < type->size(); ++i) {
+    writeColumn(
+        type->childAt(i), rowVector->childAt(i), childRows, childLevels, leaf);
+  }
+}
+
+int64_t NativeWriter::bufferedBytes() const {
+  int64_t bytes = 0;
+  for (const auto& column : columns_) {
+    bytes += column->bufferedBytes();
+  }
+  return bytes;
+}
+
+uint64_t NativeWriter::reclaimableBytes() const {
+  return bufferedRows_ > 0 ? bufferedBytes() : 0;
+}
+
+void NativeWriter::flush() {
+  if (bufferedRows_ == 0) {
+    return;
+  }
+  std::string out;
+  if (offset_ == 0) {
+    out.append(kMagic);
+  }
+  const int64_t start = offset_ + out.size();
+  std::vector<thrift::ColumnChunk> chunks;
+  chunks.reserve(columns_.size());
+  int64_t totalBytes = 0;
+  for (auto& column : columns_) {
+    chunks.push_back(column->finishChunk(offset_, out));
+    totalBytes += chunks.back().meta_data.total_uncompressed_size;
+  }
+  thrift::RowGroup rowGroup;
+  rowGroup.__set_columns(chunks);
+  rowGroup.__set_num_rows(bufferedRows_);
+  rowGroup.__set_total_byte_size(totalBytes);
+  rowGroup.__set_file_offset(start);
+  rowGroup.__set_total_compressed_size(offset_ + out.size() - start);
+  rowGroup.__set_ordinal(rowGroups_.size());
+  rowGroups_.push_back(std::move(rowGroup));
+  numRows_ += bufferedRows_;
+  bufferedRows_ = 0;
+  writeToSink(out);
+}
+
+void NativeWriter::close() {
+  if (closed_) {
+    return;
+  }
+  flush();
+  if (type_) {
+    std::string out;
+    if (offset_ == 0) {
+      out.append(kMagic);
+    }
+    for (auto i = 0; i < columns_.size(); ++i) {
+      columns_[i]->writeIndexes(i, offset_, out, rowGroups_);
+    }
+    thrift::FileMetaData metadata;
+    metadata.__set_version(1);
+    metadata.__set_schema(schema_);
+    metadata.__set_num_rows(numRows_);
+    metadata.__set_row_groups(rowGroups_);
+    metadata.__set_created_by(std::string(kCreatedBy));
+    const auto footer = serializeThrift(metadata);
+    out.append(footer);
+    const uint32_t footerLength = footer.size();
+    out.append(
+        reinterpret_cast<const char*>(&footerLength), sizeof(footerLength));
+    out.append(kMagic);
+    writeToSink(out);
+  }
+  sink_->close();
+  closed_ = true;
+}
+
+void NativeWriter::writeToSink(const std::string& data) {
+  if (data.empty()) {
+    return;
+  }
+  dwio::common::DataBuffer<char> buffer(*generalPool_, data.size());
+  memcpy(buffer.data(), data.data(), data.size());
+  sink_->write(std::move(buffer));
+  offset_ += data.size();
+}
+
+std::unique_ptr<dwio::common::Writer> NativeParquetWriterFactory::createWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    const dwio::common::WriterOptions& options) {
+  if (!options.schema || !NativeWriter::isSupported(options.schema)) {
+    return ParquetWriterFactory().createWriter(std::move(sink), options);
+  }
+  WriterOptions parquetOptions;
+  parquetOptions.memoryPool = options.memoryPool;
+  return std::make_unique<NativeWriter>(std::move(sink), parquetOptions);
+}
+
+} // namespace facebook::velox::parquet
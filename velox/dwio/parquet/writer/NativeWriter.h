@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/Writer.h"
+#include "velox/dwio/common/WriterFactory.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+class ColumnChunkWriter;
+
+// Writes Velox vectors into a DataSink as Parquet without going through
+// Arrow. Supports BOOLEAN, TINYINT, SMALLINT, INTEGER, BIGINT, REAL, DOUBLE,
+// VARCHAR, VARBINARY and DATE columns, also inside ROW columns. All columns
+// are optional. Values are dictionary encoded until the dictionary of a
+// column chunk exceeds 'dictionaryPageSizeLimit' and PLAIN encoded after
+// that. DictionaryVector inputs are hashed once per distinct base value. Each
+// column chunk gets a column and offset index and, if 'enableBloomFilter' is
+// set, integer and string chunks get a Bloom filter. These are written after
+// the row groups. 'enableDeltaBinaryPacked' and 'enableByteStreamSplit' are
+// ignored.
+class NativeWriter : public dwio::common::Writer {
+ public:
+  NativeWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      const WriterOptions& options);
+
+  ~NativeWriter() override;
+
+  // Returns true if all columns of 'type' can be written by NativeWriter.
+  static bool isSupported(const TypePtr& type);
+
+  // Appends 'data' into the writer. A row group is written every
+  // 'rowsInRowGroup' rows or when the buffered data exceeds
+  // 'maxRowGroupLength' bytes.
+  void write(const VectorPtr& data) override;
+
+  // Writes the buffered rows as a row group.
+  void flush() override;
+
+  // Returns the buffered bytes of the open row group.
+  uint64_t reclaimableBytes() const override;
+
+  // Writes the open row group.
+  void reclaim() override {
+    flush();
+  }
+
+  // Writes the last row group, the page indexes, the Bloom filters and the
+  // footer and closes the sink. Data can no longer be added after close.
+  void close() override;
+
+ private:
+  // Makes the schema and the column writers for 'type'.
+  void initialize(const RowTypePtr& type);
+
+  void addSchemaElement(
+      const std::string& name,
+      const TypePtr& type,
+      std::vector<std::string>& path);
+
+  // Appends the values of 'vector' at 'rows' to the writers of the columns
+  // under 'type'. 'rows[i]' is -1 if row i is null at a parent level.
+  // 'levels[i]' is the definition level reached by row i above 'type'.
+  // 'leaf' is the index of the first column writer of 'type' and is advanced
+  // past its last.
+  void writeColumn(
+      const TypePtr& type,
+      const VectorPtr& vector,
+      const std::vector<vector_size_t>& rows,
+      const std::vector<uint8_t>& levels,
+      int32_t& leaf);
+
+  int64_t bufferedBytes() const;
+
+  // Appends 'data' to 'sink_'.
+  void writeToSink(const std::string& data);
+
+  const WriterOptions options_;
+  std::shared_ptr<memory::MemoryPool> pool_;
+  std::shared_ptr<memory::MemoryPool> generalPool_;
+  std::unique_ptr<dwio::common::DataSink> sink_;
+
+  RowTypePtr type_;
+  std::vector<thrift::SchemaElement> schema_;
+  // One per leaf column in schema order.
+  std::vector<std::unique_ptr<ColumnChunkWriter>> columns_;
+  std::vector<thrift::RowGroup> rowGroups_;
+
+  // Rows in the row group being buffered.
+  int32_t bufferedRows_{0};
+  int64_t numRows_{0};
+  // Bytes written to 'sink_'.
+  int64_t offset_{0};
+  bool closed_{false};
+};
+
+class NativeParquetWriterFactory : public dwio::common::WriterFactory {
+ public:
+  NativeParquetWriterFactory()
+      : WriterFactory(dwio::common::FileFormat::PARQUET) {}
+
+  // Makes a NativeWriter if it supports 'options.schema' and an Arrow based
+  // Writer otherwise.
+  std::unique_ptr<dwio::common::Writer> createWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      const dwio::common::WriterOptions& options) override;
+};
+
+} // namespace facebook::velox::parquet
@@ -102,6 +102,13 @@ std::shared_ptr<::parquet::WriterProperties> getArrowParquetWriterOptions(
   if (!options.enableDictionary) {
     properties = properties->disable_dictionary();
   }
+  if (options.enableDeltaBinaryPacked) {
+    properties =
+        properties->encoding(::parquet::Encoding::DELTA_BINARY_PACKED);
+  }
+  if (options.enableByteStreamSplit) {
+    properties = properties->encoding(::parquet::Encoding::BYTE_STREAM_SPLIT);
+  }
   properties =
       properties->compression(getArrowParquetCompression(options.compression));
   properties = properties->data_pagesize(options.dataPageSize);
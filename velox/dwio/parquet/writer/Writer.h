@@ -32,6 +32,17 @@ struct ArrowContext;
 
 struct WriterOptions {
   bool enableDictionary = true;
+  // If set, columns are written with DELTA_BINARY_PACKED encoding instead of
+  // PLAIN. Only valid if all columns are INT32 or INT64 and dictionary
+  // encoding is disabled.
+  bool enableDeltaBinaryPacked = false;
+  // If set, columns are written with BYTE_STREAM_SPLIT encoding instead of
+  // PLAIN. Only valid if all columns are FLOAT or DOUBLE and dictionary
+  // encoding is disabled.
+  bool enableByteStreamSplit = false;
+  // If set, integer and string column chunks get a Bloom filter. Only used by
+  // NativeWriter.
+  bool enableBloomFilter = false;
   int64_t dataPageSize = 1'024 * 1'024;
   int32_t rowsInRowGroup = 10'000;
   int64_t maxRowGroupLength = 1'024 * 1'024;
@@ -27,8 +27,13 @@ namespace {
 
 // A generic way to compute any aggregation used as a window function.
 // Creates an Aggregate function object for the window function invocation.
-// At each row, computes the aggregation across all rows from the frameStart
-// to frameEnd boundaries at that row using singleGroup.
+// Frames with a fixed frameStart and non-decreasing frameEnd values are
+// aggregated incrementally using singleGroup. Other frames, e.g. sliding
+// ROWS/RANGE k PRECEDING frames, are aggregated using a segment tree over the
+// partition rows: each level of the tree stores the intermediate results of
+// the aggregation over runs of kFanout nodes of the level below, so the
+// aggregation of any frame combines O(kFanout * log(partition size)) values
+// instead of all the frame rows.
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -58,6 +63,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
     aggregate_ = exec::Aggregate::create(
         name, core::AggregationNode::Step::kSingle, argTypes_, resultType);
     aggregate_->setAllocator(stringAllocator_);
+    intermediateType_ = exec::Aggregate::intermediateType(name, argTypes_);
 
     // Aggregate initialization.
     // Row layout is:
@@ -80,6 +86,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
         exec::RowContainer::nullMask(kNullOffset),
         /* needed for out of line allocations */ kRowSizeOffset);
     singleGroupRowSize_ += aggregate_->accumulatorFixedWidthSize();
+    // The group rows of the segment tree are laid out back to back.
+    groupRowStride_ = bits::roundUp(
+        singleGroupRowSize_, aggregate_->accumulatorAlignmentSize());
 
     // Construct the single row in the MemoryPool.
     singleGroupRowBufferPtr_ =
@@ -89,6 +98,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
     // Constructing a vector of a single result value used for copying from
     // the aggregate to the final result.
     aggregateResultVector_ = BaseVector::create(resultType, 1, pool_);
+    frameResultsVector_ = BaseVector::create(resultType, 0, pool_);
   }
 
   ~AggregateWindowFunction() {
@@ -104,6 +114,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    segmentTreeBuilt_ = false;
+    partitionArgVectors_.clear();
+    segmentTree_.clear();
   }
 
   void apply(
@@ -152,20 +165,34 @@ class AggregateWindowFunction : public exec::WindowFunction {
           resultOffset,
           result);
     } else {
-      fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
-      simpleAggregation(
-          validRows,
-          frameMetadata.firstRow,
-          frameMetadata.lastRow,
-          rawFrameStarts,
-          rawFrameEnds,
-          resultOffset,
-          result);
+      segmentTreeAggregation(
+          validRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
     }
     previousFrameMetadata_ = frameMetadata;
   }
 
  private:
+  // Number of child nodes of each segment tree node.
+  static constexpr vector_size_t kFanout = 16;
+
+  // The nodes of a segment tree level to add to the groups of the frames.
+  struct LevelNodes {
+    std::vector<vector_size_t> indices;
+    std::vector<char*> groups;
+
+    void add(vector_size_t begin, vector_size_t end, char* group) {
+      for (auto i = begin; i < end; ++i) {
+        indices.push_back(i);
+        groups.push_back(group);
+      }
+    }
+
+    void clear() {
+      indices.clear();
+      groups.clear();
+    }
+  };
+
   struct FrameMetadata {
     // Min frame start row required for aggregation.
     vector_size_t firstRow;
@@ -303,33 +330,177 @@ class AggregateWindowFunction : public exec::WindowFunction {
     setNullEmptyFramesResults(validRows, resultOffset, result);
   }
 
-  void simpleAggregation(
+  // Allocates 'numGroups' group rows in 'groupsBuffer_', points 'groups_' at
+  // them and initializes their accumulators.
+  void initializeGroups(vector_size_t numGroups) {
+    const auto numBytes = numGroups * groupRowStride_;
+    if (groupsBuffer_ == nullptr || groupsBuffer_->capacity() < numBytes) {
+      groupsBuffer_ = AlignedBuffer::allocate<char>(numBytes, pool_);
+    }
+    auto* rawGroups = groupsBuffer_->asMutable<char>();
+    std::memset(rawGroups, 0, numBytes);
+
+    groups_.resize(numGroups);
+    groupIndices_.resize(numGroups);
+    for (auto i = 0; i < numGroups; ++i) {
+      groups_[i] = rawGroups + i * groupRowStride_;
+      groupIndices_[i] = i;
+    }
+    aggregate_->initializeNewGroups(groups_.data(), groupIndices_);
+  }
+
+  // Builds the levels of the segment tree above the partition rows. The level
+  // 0 nodes are the partition rows and each node of level l + 1 holds the
+  // intermediate result of the aggregation over kFanout consecutive nodes of
+  // level l. The last node of a level may cover fewer nodes.
+  void buildSegmentTree() {
+    const auto numRows = partition_->numRows();
+    partitionArgVectors_.resize(argIndices_.size());
+    for (auto i = 0; i < argIndices_.size(); ++i) {
+      if (argIndices_[i] == kConstantChannel) {
+        partitionArgVectors_[i] =
+            BaseVector::wrapInConstant(numRows, 0, argVectors_[i]);
+      } else {
+        partitionArgVectors_[i] = BaseVector::create(argTypes_[i], 0, pool_);
+        partition_->extractColumn(
+            argIndices_[i], 0, numRows, 0, partitionArgVectors_[i]);
+      }
+    }
+
+    segmentTree_.clear();
+    vector_size_t levelSize = numRows;
+    std::vector<char*> nodeGroups;
+    while (levelSize > kFanout) {
+      const auto numNodes = bits::roundUp(levelSize, kFanout) / kFanout;
+      initializeGroups(numNodes);
+      nodeGroups.resize(levelSize);
+      for (auto i = 0; i < levelSize; ++i) {
+        nodeGroups[i] = groups_[i / kFanout];
+      }
+
+      SelectivityVector rows(levelSize);
+      if (segmentTree_.empty()) {
+        aggregate_->addRawInput(
+            nodeGroups.data(), rows, partitionArgVectors_, false);
+      } else {
+        aggregate_->addIntermediateResults(
+            nodeGroups.data(), rows, {segmentTree_.back()}, false);
+      }
+
+      auto nodes = BaseVector::create(intermediateType_, numNodes, pool_);
+      aggregate_->extractAccumulators(groups_.data(), numNodes, &nodes);
+      aggregate_->destroy(folly::Range(groups_.data(), numNodes));
+      segmentTree_.push_back(std::move(nodes));
+      levelSize = numNodes;
+    }
+    segmentTreeBuilt_ = true;
+  }
+
+  vector_size_t numLevelNodes(size_t level) const {
+    return level == 0 ? partition_->numRows() : segmentTree_[level - 1]->size();
+  }
+
+  // Decomposes the frame rows [frameBegin, frameEnd) into the nodes of the
+  // segment tree and adds them to the inputs for 'group'. At each level, the
+  // nodes not covered by a full parent node at either end of the range are
+  // added, and the remaining range continues on the parent level. The nodes
+  // left of the topmost range and the topmost range itself are added to
+  // 'leftNodes_', the ones right of it to 'rightNodes_'.
+  void addFrameNodes(
+      vector_size_t frameBegin,
+      vector_size_t frameEnd,
+      char* group) {
+    vector_size_t begin = frameBegin;
+    vector_size_t end = frameEnd;
+    for (size_t level = 0;; ++level) {
+      const auto size = numLevelNodes(level);
+      const auto parentBegin = bits::roundUp(begin, kFanout) / kFanout;
+      // The last parent node covers the end of the level even if it's partial.
+      const auto parentEnd = end == size ? bits::roundUp(end, kFanout) / kFanout
+                                         : end / kFanout;
+      if (level == segmentTree_.size() || parentBegin >= parentEnd) {
+        leftNodes_[level].add(begin, end, group);
+        return;
+      }
+      leftNodes_[level].add(begin, parentBegin * kFanout, group);
+      rightNodes_[level].add(
+          std::min(parentEnd * kFanout, size), end, group);
+      begin = parentBegin;
+      end = parentEnd;
+    }
+  }
+
+  // Adds the nodes of 'level' in 'nodes' to their groups.
+  void aggregateNodes(size_t level, LevelNodes& nodes) {
+    const auto numNodes = nodes.groups.size();
+    if (numNodes == 0) {
+      return;
+    }
+
+    auto indices = AlignedBuffer::allocate<vector_size_t>(numNodes, pool_);
+    std::memcpy(
+        indices->asMutable<vector_size_t>(),
+        nodes.indices.data(),
+        numNodes * sizeof(vector_size_t));
+    SelectivityVector rows(numNodes);
+    if (level == 0) {
+      std::vector<VectorPtr> args;
+      args.reserve(partitionArgVectors_.size());
+      for (const auto& arg : partitionArgVectors_) {
+        args.push_back(
+            BaseVector::wrapInDictionary(nullptr, indices, numNodes, arg));
+      }
+      aggregate_->addRawInput(nodes.groups.data(), rows, args, false);
+    } else {
+      aggregate_->addIntermediateResults(
+          nodes.groups.data(),
+          rows,
+          {BaseVector::wrapInDictionary(
+              nullptr, indices, numNodes, segmentTree_[level - 1])},
+          false);
+    }
+    nodes.clear();
+  }
+
+  void segmentTreeAggregation(
       const SelectivityVector& validRows,
-      vector_size_t minFrame,
-      vector_size_t maxFrame,
       const vector_size_t* frameStartsVector,
       const vector_size_t* frameEndsVector,
       vector_size_t resultOffset,
       const VectorPtr& result) {
-    SelectivityVector rows;
-    rows.resize(maxFrame + 1 - minFrame);
-    static auto kSingleGroup = std::vector<vector_size_t>{0};
+    if (!segmentTreeBuilt_) {
+      buildSegmentTree();
+    }
 
+    // Each valid row of the output block gets its own group.
+    initializeGroups(validRows.countSelected());
+    const auto numLevels = segmentTree_.size() + 1;
+    leftNodes_.resize(numLevels);
+    rightNodes_.resize(numLevels);
+    vector_size_t groupIndex = 0;
     validRows.applyToSelected([&](auto i) {
-      // This is a very naive algorithm.
-      // It evaluates the entire aggregation for each row by iterating over
-      // input rows from frameStart to frameEnd in the SelectivityVector.
-      // TODO : Try to re-use previous computations by advancing and retracting
-      // the aggregation based on the frame changes with each row. This would
-      // require adding new APIs to the Aggregate framework.
-      aggregate_->clear();
-      aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
-      aggregateInitialized_ = true;
-
-      auto frameStartIndex = frameStartsVector[i] - minFrame;
-      auto frameEndIndex = frameEndsVector[i] - minFrame + 1;
-      computeAggregate(rows, frameStartIndex, frameEndIndex);
-      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+      addFrameNodes(
+          frameStartsVector[i], frameEndsVector[i] + 1, groups_[groupIndex++]);
+    });
+
+    // Add the nodes of each frame in the order of the rows they cover, so
+    // that order sensitive aggregates see the frame rows in order.
+    for (size_t level = 0; level < numLevels; ++level) {
+      aggregateNodes(level, leftNodes_[level]);
+    }
+    for (auto level = numLevels; level-- > 0;) {
+      aggregateNodes(level, rightNodes_[level]);
+    }
+
+    BaseVector::prepareForReuse(frameResultsVector_, groups_.size());
+    aggregate_->extractValues(
+        groups_.data(), groups_.size(), &frameResultsVector_);
+    aggregate_->destroy(folly::Range(groups_.data(), groups_.size()));
+
+    groupIndex = 0;
+    validRows.applyToSelected([&](auto i) {
+      result->copy(
+          frameResultsVector_.get(), resultOffset + i, groupIndex++, 1);
     });
 
     // Set null values for empty (non valid) frames in the output block.
@@ -363,6 +534,32 @@ class AggregateWindowFunction : public exec::WindowFunction {
   // This vector is used to copy from the aggregate to the result.
   VectorPtr aggregateResultVector_;
 
+  // Type of the intermediate results stored in the segment tree.
+  TypePtr intermediateType_;
+
+  // Segment tree of the current partition. It is built the first time a frame
+  // can't be aggregated incrementally. 'partitionArgVectors_' are the
+  // argument vectors over all the partition rows, i.e. the level 0 nodes, and
+  // 'segmentTree_[l - 1]' hold the intermediate results of the level l nodes.
+  bool segmentTreeBuilt_{false};
+  std::vector<VectorPtr> partitionArgVectors_;
+  std::vector<VectorPtr> segmentTree_;
+
+  // Group rows used to build the segment tree and to aggregate the frames of
+  // an output block. The rows are 'groupRowStride_' bytes apart.
+  vector_size_t groupRowStride_;
+  BufferPtr groupsBuffer_;
+  std::vector<char*> groups_;
+  std::vector<vector_size_t> groupIndices_;
+
+  // The segment tree nodes to add to the groups of the frames of an output
+  // block, per level.
+  std::vector<LevelNodes> leftNodes_;
+  std::vector<LevelNodes> rightNodes_;
+
+  // Results of the frames of an output block.
+  VectorPtr frameResultsVector_;
+
   // Stores metadata about the previous output block of the partition
   // to optimize aggregate computation and reading argument vectors.
   std::optional<FrameMetadata> previousFrameMetadata_;
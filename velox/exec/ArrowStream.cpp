@@ -15,44 +15,56 @@
  */
 #include "velox/exec/ArrowStream.h"
 
+#include <deque>
+#include <mutex>
+
+#include "velox/exec/Task.h"
+
 namespace facebook::velox::exec {
 
-ArrowStream::ArrowStream(
-    int32_t operatorId,
-    DriverCtx* driverCtx,
-    const std::shared_ptr<const core::ArrowStreamNode>& arrowStreamNode)
-    : SourceOperator(
-          driverCtx,
-          arrowStreamNode->outputType(),
-          operatorId,
-          arrowStreamNode->id(),
-          "ArrowStream") {
-  arrowStream_ = arrowStreamNode->arrowStream();
-}
+namespace {
 
-ArrowStream::~ArrowStream() {
-  close();
+struct ArrowBatch {
+  ArrowArray array;
+  ArrowSchema schema;
+
+  void release() {
+    if (schema.release) {
+      schema.release(&schema);
+    }
+    if (array.release) {
+      array.release(&array);
+    }
+  }
+};
+
+/// Return last error in Arrow array stream.
+std::string getError(ArrowArrayStream* arrowStream) {
+  const char* lastError = arrowStream->get_last_error(arrowStream);
+  VELOX_CHECK_NOT_NULL(lastError);
+  return lastError;
 }
 
-RowVectorPtr ArrowStream::getOutput() {
+// Reads the next Arrow array and its schema from 'arrowStream' into 'batch'.
+// Returns false at the end of the stream.
+bool nextBatch(ArrowArrayStream* arrowStream, ArrowBatch& batch) {
   // Get Arrow array.
-  struct ArrowArray arrowArray;
-  if (arrowStream_->get_next(arrowStream_.get(), &arrowArray)) {
+  struct ArrowArray& arrowArray = batch.array;
+  if (arrowStream->get_next(arrowStream, &arrowArray)) {
     if (arrowArray.release) {
       arrowArray.release(&arrowArray);
     }
     VELOX_FAIL(
-        "Failed to call get_next on ArrowStream: {}", std::string(getError()));
+        "Failed to call get_next on ArrowStream: {}", getError(arrowStream));
   }
   if (arrowArray.release == nullptr) {
     // End of Stream.
-    finished_ = true;
-    return nullptr;
+    return false;
   }
 
   // Get Arrow schema.
-  struct ArrowSchema arrowSchema;
-  if (arrowStream_->get_schema(arrowStream_.get(), &arrowSchema)) {
+  struct ArrowSchema& arrowSchema = batch.schema;
+  if (arrowStream->get_schema(arrowStream, &arrowSchema)) {
     if (arrowSchema.release) {
       arrowSchema.release(&arrowSchema);
     }
@@ -60,28 +72,228 @@ RowVectorPtr ArrowStream::getOutput() {
       arrowArray.release(&arrowArray);
     }
     VELOX_FAIL(
-        "Failed to call get_schema on ArrowStream: {}",
-        std::string(getError()));
+        "Failed to call get_schema on ArrowStream: {}", getError(arrowStream));
+  }
+  return true;
+}
+
+void releaseStream(ArrowArrayStream& arrowStream) {
+  if (arrowStream.release) {
+    arrowStream.release(&arrowStream);
+  }
+}
+
+} // namespace
+
+// At most one fetch runs at a time, so the calls to the stream are serial
+// even though they are made on different threads. This owns the stream once
+// created and releases it after the last fetch, which may still be running
+// when the operator closes.
+class ArrowStream::Prefetcher
+    : public std::enable_shared_from_this<ArrowStream::Prefetcher> {
+ public:
+  Prefetcher(
+      std::shared_ptr<ArrowArrayStream> arrowStream,
+      folly::Executor* executor,
+      int32_t maxBatches)
+      : arrowStream_(std::move(arrowStream)),
+        executor_(folly::getKeepAliveToken(executor)),
+        maxBatches_(maxBatches) {}
+
+  // Sets 'future' and returns false if no batch is ready and the stream is
+  // not at its end.
+  bool isReady(ContinueFuture* future) {
+    bool shouldFetch;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!batches_.empty() || atEnd_ || error_) {
+        return true;
+      }
+      shouldFetch = startFetchLocked();
+      promise_ = ContinuePromise("ArrowStream::isBlocked");
+      *future = promise_->getSemiFuture();
+    }
+    if (shouldFetch) {
+      scheduleFetch();
+    }
+    return false;
+  }
+
+  // Moves the next batch into 'batch' and returns true. Returns false if
+  // there is none, which is at the end of the stream if 'atEnd' is set.
+  // Rethrows the error of a failed fetch.
+  bool next(ArrowBatch& batch, bool& atEnd) {
+    bool shouldFetch;
+    bool hasBatch = false;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+      if (!batches_.empty()) {
+        batch = batches_.front();
+        batches_.pop_front();
+        hasBatch = true;
+      }
+      atEnd = batches_.empty() && atEnd_;
+      shouldFetch = startFetchLocked();
+    }
+    if (shouldFetch) {
+      scheduleFetch();
+    }
+    return hasBatch;
+  }
+
+  void close() {
+    std::optional<ContinuePromise> promise;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      closed_ = true;
+      for (auto& batch : batches_) {
+        batch.release();
+      }
+      batches_.clear();
+      promise.swap(promise_);
+      if (!fetching_) {
+        releaseStream(*arrowStream_);
+      }
+    }
+    if (promise) {
+      promise->setValue();
+    }
+  }
+
+ private:
+  // Returns true if the caller is to schedule a fetch.
+  bool startFetchLocked() {
+    if (fetching_ || closed_ || atEnd_ || error_ ||
+        batches_.size() >= maxBatches_) {
+      return false;
+    }
+    fetching_ = true;
+    return true;
+  }
+
+  void scheduleFetch() {
+    executor_->add([self = shared_from_this()]() { self->fetch(); });
+  }
+
+  // Fetches batches until 'maxBatches_' are ready or the stream ends.
+  void fetch() {
+    for (;;) {
+      ArrowBatch batch;
+      bool hasBatch = false;
+      std::exception_ptr error;
+      try {
+        hasBatch = nextBatch(arrowStream_.get(), batch);
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      std::optional<ContinuePromise> promise;
+      bool fetchMore;
+      {
+        std::lock_guard<std::mutex> l(mutex_);
+        if (closed_) {
+          if (hasBatch) {
+            batch.release();
+          }
+          fetching_ = false;
+          releaseStream(*arrowStream_);
+          return;
+        }
+        if (error) {
+          error_ = error;
+        } else if (hasBatch) {
+          batches_.push_back(batch);
+        } else {
+          atEnd_ = true;
+        }
+        fetching_ = false;
+        fetchMore = startFetchLocked();
+        promise.swap(promise_);
+      }
+      if (promise) {
+        promise->setValue();
+      }
+      if (!fetchMore) {
+        return;
+      }
+    }
+  }
+
+  const std::shared_ptr<ArrowArrayStream> arrowStream_;
+  const folly::Executor::KeepAlive<> executor_;
+  const size_t maxBatches_;
+
+  std::mutex mutex_;
+  std::deque<ArrowBatch> batches_;
+  // Set while a fetch is scheduled or running.
+  bool fetching_{false};
+  bool atEnd_{false};
+  bool closed_{false};
+  std::exception_ptr error_;
+  // Fulfilled when a batch is ready, the stream ends or a fetch fails.
+  std::optional<ContinuePromise> promise_;
+};
+
+ArrowStream::ArrowStream(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::ArrowStreamNode>& arrowStreamNode)
+    : SourceOperator(
+          driverCtx,
+          arrowStreamNode->outputType(),
+          operatorId,
+          arrowStreamNode->id(),
+          "ArrowStream") {
+  arrowStream_ = arrowStreamNode->arrowStream();
+  const auto maxBatches = driverCtx->queryConfig().arrowStreamPrefetchBatches();
+  auto* executor = driverCtx->task->queryCtx()->executor();
+  if (maxBatches > 0 && executor != nullptr) {
+    prefetcher_ =
+        std::make_shared<Prefetcher>(arrowStream_, executor, maxBatches);
+  }
+}
+
+ArrowStream::~ArrowStream() {
+  close();
+}
+
+BlockingReason ArrowStream::isBlocked(ContinueFuture* future) {
+  if (prefetcher_ == nullptr || finished_ || prefetcher_->isReady(future)) {
+    return BlockingReason::kNotBlocked;
+  }
+  return BlockingReason::kWaitForProducer;
+}
+
+RowVectorPtr ArrowStream::getOutput() {
+  ArrowBatch batch;
+  if (prefetcher_ != nullptr) {
+    bool atEnd;
+    if (!prefetcher_->next(batch, atEnd)) {
+      finished_ = atEnd;
+      return nullptr;
+    }
+  } else if (!nextBatch(arrowStream_.get(), batch)) {
+    finished_ = true;
+    return nullptr;
   }
 
   // Convert Arrow Array into RowVector and return.
   return std::dynamic_pointer_cast<RowVector>(
-      importFromArrowAsOwner(arrowSchema, arrowArray, pool()));
+      importFromArrowAsOwner(batch.schema, batch.array, pool()));
 }
 
 bool ArrowStream::isFinished() {
   return finished_;
 }
 
-const char* ArrowStream::getError() const {
-  const char* lastError = arrowStream_->get_last_error(arrowStream_.get());
-  VELOX_CHECK_NOT_NULL(lastError);
-  return lastError;
-}
-
 void ArrowStream::close() {
-  if (arrowStream_->release) {
-    arrowStream_->release(arrowStream_.get());
+  if (prefetcher_ != nullptr) {
+    prefetcher_->close();
+  } else {
+    releaseStream(*arrowStream_);
   }
   SourceOperator::close();
 }
@@ -31,20 +31,22 @@ class ArrowStream : public SourceOperator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  /// Blocks while no prefetched Arrow array is ready.
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
   void close() override;
 
  private:
-  /// Return last error in Arrow array stream.
-  const char* getError() const;
+  /// Fetches Arrow arrays of 'arrowStream_' on an executor, up to a max
+  /// number ahead of the operator.
+  class Prefetcher;
 
   bool finished_ = false;
   std::shared_ptr<ArrowArrayStream> arrowStream_;
+  /// Set if the query has an executor and prefetching is enabled.
+  std::shared_ptr<Prefetcher> prefetcher_;
 };
 
 } // namespace facebook::velox::exec
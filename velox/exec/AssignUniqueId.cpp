@@ -16,6 +16,7 @@
 #include "velox/exec/AssignUniqueId.h"
 
 #include <algorithm>
+#include <numeric>
 #include <utility>
 
 namespace facebook::velox::exec {
@@ -76,25 +77,30 @@ void AssignUniqueId::generateIdColumn(vector_size_t size) {
   if (result && result.unique()) {
     BaseVector::prepareForReuse(result, size);
   } else {
-    result = BaseVector::create(BIGINT(), size, pool());
+    // The previous ids are still referenced downstream. Takes a vector
+    // recycled by the operators of the Driver.
+    result = operatorCtx_->execCtx()->getVector(BIGINT(), size);
+    result->clearNulls(0, size);
   }
 
   auto rawResults =
       result->asUnchecked<FlatVector<int64_t>>()->mutableRawValues();
 
+  // Fills the ids a range of consecutive ids at a time. A batch spans more
+  // than one range only if it crosses the end of the ids requested so far.
   vector_size_t start = 0;
   while (start < size) {
     if (rowIdCounter_ >= maxRowIdCounterValue_) {
       requestRowIds();
     }
 
-    auto batchSize =
-        std::min(maxRowIdCounterValue_ - rowIdCounter_ + 1, kRowIdsPerRequest);
-    auto end = (int32_t)std::min((int64_t)size, start + batchSize);
-    VELOX_CHECK_EQ((rowIdCounter_ + end - 1) & uniqueValueMask_, 0);
+    const auto numIds = maxRowIdCounterValue_ - rowIdCounter_;
+    const auto end =
+        static_cast<vector_size_t>(std::min<int64_t>(size, start + numIds));
+    VELOX_CHECK_EQ((rowIdCounter_ + end - start - 1) & uniqueValueMask_, 0);
     std::iota(
         rawResults + start, rawResults + end, uniqueValueMask_ | rowIdCounter_);
-    rowIdCounter_ += end;
+    rowIdCounter_ += end - start;
     start = end;
   }
 }
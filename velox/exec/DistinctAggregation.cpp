@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/DistinctAggregation.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+RowTypePtr makeKeyType(const std::vector<TypePtr>& inputTypes) {
+  std::vector<std::string> names{"group"};
+  std::vector<TypePtr> types{BIGINT()};
+  for (auto i = 0; i < inputTypes.size(); ++i) {
+    names.push_back(fmt::format("i{}", i));
+    types.push_back(inputTypes[i]);
+  }
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
+DistinctAggregation::DistinctAggregation(
+    const std::vector<TypePtr>& inputTypes,
+    memory::MemoryPool* pool)
+    : pool_(pool), keyType_(makeKeyType(inputTypes)) {
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  hashers.reserve(keyType_->size());
+  for (auto i = 0; i < keyType_->size(); ++i) {
+    hashers.push_back(VectorHasher::create(keyType_->childAt(i), i));
+  }
+  table_ = HashTable<false>::createForAggregation(
+      std::move(hashers), std::vector<Accumulator>{}, pool_);
+  lookup_ = std::make_unique<HashLookup>(table_->hashers());
+}
+
+int64_t* DistinctAggregation::prepareGroups(vector_size_t size) {
+  if (groups_) {
+    BaseVector::prepareForReuse(groups_, size);
+  } else {
+    groups_ = BaseVector::create(BIGINT(), size, pool_);
+  }
+  return groups_->asFlatVector<int64_t>()->mutableRawValues();
+}
+
+const SelectivityVector& DistinctAggregation::newInputs(
+    char** groups,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& inputs) {
+  auto* rawGroups = prepareGroups(rows.end());
+  rows.applyToSelected([&](auto row) {
+    rawGroups[row] = reinterpret_cast<int64_t>(groups[row]);
+  });
+  return probe(rows, inputs);
+}
+
+const SelectivityVector& DistinctAggregation::newInputs(
+    char* group,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& inputs) {
+  auto* rawGroups = prepareGroups(rows.end());
+  std::fill(
+      rawGroups, rawGroups + rows.end(), reinterpret_cast<int64_t>(group));
+  return probe(rows, inputs);
+}
+
+const SelectivityVector& DistinctAggregation::probe(
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& inputs) {
+  std::vector<VectorPtr> children;
+  children.reserve(inputs.size() + 1);
+  children.push_back(groups_);
+  children.insert(children.end(), inputs.begin(), inputs.end());
+  auto keys = std::make_shared<RowVector>(
+      pool_, keyType_, nullptr, rows.end(), std::move(children));
+
+  activeRows_ = rows;
+  table_->prepareForProbe(*lookup_, keys, activeRows_, false);
+  table_->groupProbe(*lookup_);
+
+  newRows_.resizeFill(rows.end(), false);
+  for (auto row : lookup_->newGroups) {
+    newRows_.setValid(row, true);
+  }
+  newRows_.updateBounds();
+  return newRows_;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/HashTable.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+/// Tracks the distinct inputs of an aggregate within each group, e.g. for
+/// count(DISTINCT x). The values are kept in a hash table keyed on the group
+/// and the inputs of the aggregate, so that only the first occurrence of a
+/// value in a group is passed on to the aggregate function. Nulls are treated
+/// as values and left to the function to ignore.
+class DistinctAggregation {
+ public:
+  /// @param inputTypes Types of the inputs of the aggregate.
+  /// @param pool Memory pool for the hash table.
+  DistinctAggregation(
+      const std::vector<TypePtr>& inputTypes,
+      memory::MemoryPool* pool);
+
+  /// Returns the subset of 'rows' with inputs not seen before in their group
+  /// and remembers these. 'groups' and 'inputs' are indexed by row number.
+  const SelectivityVector& newInputs(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& inputs);
+
+  /// Same as above for a global aggregation where all rows go to 'group'.
+  const SelectivityVector& newInputs(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& inputs);
+
+  /// Forgets the inputs seen so far. Must be called when the groups are
+  /// freed since their addresses may be reused.
+  void clear() {
+    table_->clear();
+  }
+
+ private:
+  // Makes 'groups_' a flat vector of 'size' rows and returns its values.
+  int64_t* prepareGroups(vector_size_t size);
+
+  // Probes 'groups_' and 'inputs' and sets 'newRows_' to the rows that
+  // created new entries.
+  const SelectivityVector& probe(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& inputs);
+
+  memory::MemoryPool* const pool_;
+  // BIGINT group address followed by the inputs of the aggregate.
+  const RowTypePtr keyType_;
+  std::unique_ptr<BaseHashTable> table_;
+  std::unique_ptr<HashLookup> lookup_;
+  VectorPtr groups_;
+  SelectivityVector activeRows_;
+  SelectivityVector newRows_;
+};
+
+} // namespace facebook::velox::exec
@@ -18,8 +18,12 @@
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/executors/thread_factory/InitThreadFactory.h>
 #include <gflags/gflags.h>
+#include "velox/common/process/PerfCounters.h"
+#include "velox/common/process/SamplingProfiler.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/DriverScheduler.h"
+#include "velox/exec/DriverTrace.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
@@ -47,7 +51,15 @@ const core::QueryConfig& DriverCtx::queryConfig() const {
 velox::memory::MemoryPool* DriverCtx::addOperatorPool(
     const core::PlanNodeId& planNodeId,
     const std::string& operatorType) {
-  return task->addOperatorPool(planNodeId, pipelineId, driverId, operatorType);
+  return task->addOperatorPool(
+      planNodeId, pipelineId, driverId, operatorType, splitGroupId);
+}
+
+VectorPool& DriverCtx::vectorPool(velox::memory::MemoryPool* pool) {
+  if (sharedVectorPool == nullptr) {
+    sharedVectorPool = std::make_unique<VectorPool>(pool);
+  }
+  return *sharedVectorPool;
 }
 
 std::optional<Spiller::Config> DriverCtx::makeSpillConfig(
@@ -71,7 +83,9 @@ std::optional<Spiller::Config> DriverCtx::makeSpillConfig(
           queryConfig.spillStartPartitionBit() +
               queryConfig.spillPartitionBits()),
       queryConfig.maxSpillLevel(),
-      queryConfig.testingSpillPct());
+      queryConfig.testingSpillPct(),
+      common::stringToCompressionKind(queryConfig.spillCompressionKind()),
+      queryConfig.spillReadAheadDepth());
 }
 
 std::atomic_uint64_t BlockingState::numBlockedDrivers_{0};
@@ -112,6 +126,7 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
         VELOX_CHECK(!driver->state().isSuspended);
         VELOX_CHECK(driver->state().hasBlockingFuture);
         driver->state().hasBlockingFuture = false;
+        DriverTrace::record(*driver, DriverTrace::EventType::kResume);
         if (task->pauseRequested()) {
           // The thread will be enqueued at resume.
           return;
@@ -163,6 +178,35 @@ class CancelGuard {
   std::function<void(StopReason reason)> onTerminate_;
   bool isThrow_ = true;
 };
+
+// Adds the hardware event counts of the calling thread over the lifetime of
+// 'this' to the runtime stats of 'op'. A noop if 'op' is nullptr.
+class HardwareCounterScope {
+ public:
+  explicit HardwareCounterScope(Operator* op)
+      : op_(op != nullptr && process::PerfCounters::read(start_) ? op
+                                                                  : nullptr) {}
+
+  ~HardwareCounterScope() {
+    process::PerfCounterValues end;
+    if (op_ == nullptr || !process::PerfCounters::read(end)) {
+      return;
+    }
+    const auto delta = end - start_;
+    auto lockedStats = op_->stats().wlock();
+    lockedStats->addRuntimeStat("cpuCycles", RuntimeCounter(delta.cycles));
+    lockedStats->addRuntimeStat(
+        "instructions", RuntimeCounter(delta.instructions));
+    lockedStats->addRuntimeStat(
+        "cacheMisses", RuntimeCounter(delta.cacheMisses));
+    lockedStats->addRuntimeStat(
+        "branchMisses", RuntimeCounter(delta.branchMisses));
+  }
+
+ private:
+  process::PerfCounterValues start_;
+  Operator* const op_;
+};
 } // namespace
 
 std::string stopReasonString(StopReason reason) {
@@ -199,8 +243,17 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  driver->yieldOnTimeSlice_ = true;
+  auto* queryCtx = driver->task()->queryCtx().get();
+  if (auto* scheduler =
+          dynamic_cast<DriverScheduler*>(queryCtx->executor())) {
+    scheduler->add(
+        queryCtx->queryId(),
+        queryCtx->queryConfig().driverSchedulerWeight(),
+        [driver]() { Driver::run(driver); });
+    return;
+  }
+  queryCtx->executor()->add([driver]() { Driver::run(driver); });
 }
 
 void Driver::init(
@@ -212,6 +265,21 @@ void Driver::init(
   operators_ = std::move(operators);
   curOpIndex_ = operators_.size() - 1;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  trackHardwareCounters_ =
+      ctx_->queryConfig().operatorTrackHardwareCounters() &&
+      process::PerfCounters::isAvailable();
+  timeSliceMicros_ = ctx_->queryConfig().driverTimeSliceMs() * 1'000;
+  memorySampleIntervalMicros_ =
+      ctx_->queryConfig().operatorMemorySampleIntervalMs() * 1'000;
+  if (process::SamplingProfiler::isRunning()) {
+    sampleTags_.resize(operators_.size(), process::SamplingProfiler::kNoTag);
+    const auto& queryId = ctx_->task->queryCtx()->queryId();
+    for (auto& op : operators_) {
+      sampleTags_[op->operatorId()] = process::SamplingProfiler::registerTag(
+          queryId,
+          fmt::format("{}:{}", op->planNodeId(), op->operatorType()));
+    }
+  }
 }
 
 namespace {
@@ -229,6 +297,19 @@ std::optional<column_index_t> getIdentityProjection(
 }
 } // namespace
 
+void Driver::checkNoMoreOutputNeeded(int operatorIndex) {
+  if (operatorIndex <= numOutputNotNeeded_ ||
+      !operators_[operatorIndex]->isFinished()) {
+    return;
+  }
+  for (auto i = numOutputNotNeeded_; i < operatorIndex; ++i) {
+    auto* op = operators_[i].get();
+    RuntimeStatWriterScopeGuard statsWriterGuard(op);
+    op->noMoreOutputNeeded();
+  }
+  numOutputNotNeeded_ = operatorIndex;
+}
+
 void Driver::pushdownFilters(int operatorIndex) {
   auto op = operators_[operatorIndex].get();
   const auto& filters = op->getDynamicFilters();
@@ -282,6 +363,8 @@ RowVectorPtr Driver::next(std::shared_ptr<BlockingState>& blockingState) {
   auto self = shared_from_this();
   RowVectorPtr result;
   auto stop = runInternal(self, blockingState, result);
+  DriverTrace::record(
+      *this, DriverTrace::EventType::kStop, stop, blockingReason_);
 
   // We get kBlock if 'result' was produced; kAtEnd if pipeline has finished
   // processing and no more results will be produced; kAlreadyTerminated on
@@ -298,10 +381,14 @@ void Driver::enqueueInternal() {
   state_.isEnqueued = true;
   // When enqueuing, starting timing the queue time.
   queueTimeStartMicros_ = getCurrentTimeMicro();
+  DriverTrace::record(*this, DriverTrace::EventType::kEnqueue);
 }
 
 #define CALL_OPERATOR(call, operator, methodName)                       \
   try {                                                                 \
+    process::SampleTagScope sampleTagScope(                             \
+        sampleTags_.empty() ? process::SamplingProfiler::kNoTag         \
+                            : sampleTags_[operator->operatorId()]);     \
     call;                                                               \
   } catch (const VeloxException& e) {                                   \
     throw;                                                              \
@@ -340,6 +427,9 @@ StopReason Driver::runInternal(
     }
     return stop;
   }
+  sliceStartMicros_ = now;
+  stats_.wlock()->queuedWallNanos.addValue(queuedTime);
+  DriverTrace::record(*this, DriverTrace::EventType::kRun);
 
   // Update the queued time after entering the Task to ensure the stats have not
   // been deleted.
@@ -365,17 +455,40 @@ StopReason Driver::runInternal(
     close();
   });
 
+  // Destroyed before 'guard', which may close 'this'. A quantum that ends
+  // after close() adds its times to the Task directly.
+  DeltaCpuWallTimer onThreadTimer([this](const CpuWallTiming& timing) {
+    DriverStats quantum;
+    quantum.onThreadWallNanos.addValue(timing.wallNanos);
+    quantum.onThreadCpuNanos.addValue(timing.cpuNanos);
+    if (closed_) {
+      task()->addDriverStats(ctx_->pipelineId, quantum);
+    } else {
+      stats_.wlock()->add(quantum);
+    }
+  });
+
   try {
     int32_t numOperators = operators_.size();
     ContinueFuture future;
 
     for (;;) {
       for (int32_t i = numOperators - 1; i >= 0; --i) {
+        if (i < numOutputNotNeeded_) {
+          // The operators from here on have been told that their output is
+          // not needed. Start over from the end of the pipeline.
+          break;
+        }
         stop = task()->shouldStop();
         if (stop != StopReason::kNone) {
           guard.notThrown();
           return stop;
         }
+        if (shouldYield()) {
+          guard.notThrown();
+          return StopReason::kYield;
+        }
+        maybeSampleMemoryUsage();
 
         auto op = operators_[i].get();
         // In case we are blocked, this index will point to the operator, whose
@@ -417,6 +530,7 @@ StopReason Driver::runInternal(
                   [op](const CpuWallTiming& deltaTiming) {
                     op->stats().wlock()->getOutputTiming.add(deltaTiming);
                   });
+              HardwareCounterScope counters(hardwareCounterOp(op));
               RuntimeStatWriterScopeGuard statsWriterGuard(op);
               CALL_OPERATOR(result = op->getOutput(), op, "getOutput");
               if (result) {
@@ -438,6 +552,7 @@ StopReason Driver::runInternal(
                   [nextOp](const CpuWallTiming& timing) {
                     nextOp->stats().wlock()->addInputTiming.add(timing);
                   });
+              HardwareCounterScope counters(hardwareCounterOp(nextOp));
               {
                 auto lockedStats = nextOp->stats().wlock();
                 lockedStats->addInputVector(resultBytes, result->size());
@@ -479,6 +594,7 @@ StopReason Driver::runInternal(
                     createDeltaCpuWallTimer([op](const CpuWallTiming& timing) {
                       op->stats().wlock()->finishTiming.add(timing);
                     });
+                HardwareCounterScope counters(hardwareCounterOp(op));
                 RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
                 TestValue::adjust(
                     "facebook::velox::exec::Driver::runInternal::noMoreInput",
@@ -487,6 +603,12 @@ StopReason Driver::runInternal(
                 break;
               }
             }
+          } else {
+            // 'nextOp' may have finished before its input, e.g. a Limit.
+            CALL_OPERATOR(
+                checkNoMoreOutputNeeded(i + 1),
+                nextOp,
+                "noMoreOutputNeeded");
           }
         } else {
           // A sink (last) operator, after getting unblocked, gets
@@ -498,6 +620,7 @@ StopReason Driver::runInternal(
                 createDeltaCpuWallTimer([op](const CpuWallTiming& timing) {
                   op->stats().wlock()->getOutputTiming.add(timing);
                 });
+            HardwareCounterScope counters(hardwareCounterOp(op));
             CALL_OPERATOR(result = op->getOutput(), op, "getOutput");
             if (result) {
               VELOX_CHECK(
@@ -545,6 +668,8 @@ void Driver::run(std::shared_ptr<Driver> self) {
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
   auto reason = self->runInternal(self, blockingState, nullResult);
+  DriverTrace::record(
+      *self, DriverTrace::EventType::kStop, reason, self->blockingReason_);
 
   // When Driver runs on an executor, the last operator (sink) must not produce
   // any results.
@@ -599,6 +724,15 @@ void Driver::initializeOperatorStats(std::vector<OperatorStats>& stats) {
   }
 }
 
+void Driver::sampleMemoryUsage(uint64_t nowMicros) {
+  nextMemorySampleMicros_ = nowMicros + memorySampleIntervalMicros_;
+  const auto timeMs = task()->timeSinceStartMs();
+  for (auto& op : operators_) {
+    op->sampleMemoryUsage(timeMs, memorySampleIntervalMicros_ / 1'000);
+  }
+  task()->updateMemoryPeak();
+}
+
 void Driver::addStatsToTask() {
   for (auto& op : operators_) {
     auto stats = op->stats(true);
@@ -606,6 +740,11 @@ void Driver::addStatsToTask() {
     stats.numDrivers = 1;
     task()->addOperatorStats(stats);
   }
+  // Task::taskStats() reads 'stats_' under the Task's mutex, so this does not
+  // hold the lock of 'stats_' while taking that mutex.
+  DriverStats driverStats;
+  std::swap(driverStats, *stats_.wlock());
+  task()->addDriverStats(ctx_->pipelineId, driverStats);
 }
 
 void Driver::close() {
@@ -620,6 +759,9 @@ void Driver::close() {
   for (auto& op : operators_) {
     op->close();
   }
+  if (ctx_->sharedVectorPool != nullptr) {
+    ctx_->sharedVectorPool->clear();
+  }
   closed_ = true;
   Task::removeDriver(ctx_->task, this);
 }
@@ -630,6 +772,9 @@ void Driver::closeByTask() {
   for (auto& op : operators_) {
     op->close();
   }
+  if (ctx_->sharedVectorPool != nullptr) {
+    ctx_->sharedVectorPool->clear();
+  }
   closed_ = true;
 }
 
@@ -14,13 +14,16 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/Synchronized.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/portability/SysSyscall.h>
 #include <memory>
 
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/common/time/CpuWallTimer.h"
+#include "velox/common/time/Timer.h"
 #include "velox/connectors/Connector.h"
 #include "velox/core/PlanNode.h"
 #include "velox/core/QueryCtx.h"
@@ -197,6 +200,23 @@ class BlockingState {
   static std::atomic_uint64_t numBlockedDrivers_;
 };
 
+/// Scheduling times of a Driver, one value per quantum, i.e. per time the
+/// Driver gets on thread. Tells the time runnable Drivers wait for a thread
+/// of the executor, e.g. on an overloaded worker, from the time they run.
+struct DriverStats {
+  /// Time from being enqueued to the executor to getting on thread.
+  RuntimeMetric queuedWallNanos{RuntimeCounter::Unit::kNanos};
+  /// Wall and CPU time on thread.
+  RuntimeMetric onThreadWallNanos{RuntimeCounter::Unit::kNanos};
+  RuntimeMetric onThreadCpuNanos{RuntimeCounter::Unit::kNanos};
+
+  void add(const DriverStats& other) {
+    queuedWallNanos.merge(other.queuedWallNanos);
+    onThreadWallNanos.merge(other.onThreadWallNanos);
+    onThreadCpuNanos.merge(other.onThreadCpuNanos);
+  }
+};
+
 /// Special group id to reflect the ungrouped execution.
 constexpr uint32_t kUngroupedGroupId{std::numeric_limits<uint32_t>::max()};
 
@@ -213,6 +233,10 @@ struct DriverCtx {
   std::shared_ptr<Task> task;
   Driver* driver;
 
+  /// Vectors recycled by the operators of the Driver, see
+  /// OperatorCtx::execCtx(). Made on first use by vectorPool().
+  std::unique_ptr<VectorPool> sharedVectorPool;
+
   explicit DriverCtx(
       std::shared_ptr<Task> _task,
       int _driverId,
@@ -226,6 +250,14 @@ struct DriverCtx {
       const core::PlanNodeId& planNodeId,
       const std::string& operatorType);
 
+  /// Returns the pool of vectors shared by the operators of the Driver, so
+  /// that a vector released by one operator is reused by another. Makes the
+  /// pool on first use with 'pool', the memory pool of the calling operator.
+  /// The ExecCtx of each operator allocates the vectors that are not
+  /// recycled from its own memory pool. Operator memory pools live as long as
+  /// the Task, i.e. longer than the recycled vectors.
+  VectorPool& vectorPool(velox::memory::MemoryPool* pool);
+
   /// Builds the spill config for the operator with specified 'operatorId'.
   std::optional<Spiller::Config> makeSpillConfig(int32_t operatorId) const;
 };
@@ -250,12 +282,36 @@ class Driver : public std::enable_shared_from_this<Driver> {
     return state_.isOnThread();
   }
 
+  /// Returns true if 'this' runs on an executor and has been on thread for
+  /// longer than the 'driver_time_slice_ms' of its query. The Driver then
+  /// yields its thread before running the next operator. Operators with
+  /// long-running phases check this between chunks of work, see
+  /// Operator::shouldYield().
+  bool shouldYield() const {
+    return yieldOnTimeSlice_ && timeSliceMicros_ > 0 &&
+        getCurrentTimeMicro() - sliceStartMicros_ >= timeSliceMicros_;
+  }
+
   bool isTerminated() const {
     return state_.isTerminated;
   }
 
   std::string label() const;
 
+  // Samples the memory usage of the operators if the sampling interval has
+  // passed since the last sample.
+  void maybeSampleMemoryUsage() {
+    if (memorySampleIntervalMicros_ == 0) {
+      return;
+    }
+    const auto now = getCurrentTimeMicro();
+    if (now >= nextMemorySampleMicros_) {
+      sampleMemoryUsage(now);
+    }
+  }
+
+  void sampleMemoryUsage(uint64_t nowMicros);
+
   ThreadState& state() {
     return state_;
   }
@@ -302,6 +358,12 @@ class Driver : public std::enable_shared_from_this<Driver> {
     return blockingReason_;
   }
 
+  /// Returns the scheduling times of the quanta of 'this' that are not yet
+  /// added to the Task.
+  DriverStats stats() const {
+    return *stats_.rlock();
+  }
+
  private:
   Driver() = default;
 
@@ -324,6 +386,11 @@ class Driver : public std::enable_shared_from_this<Driver> {
   // position in the pipeline.
   void pushdownFilters(int operatorIndex);
 
+  // Calls noMoreOutputNeeded() on the operators before the operator at
+  // 'operatorIndex' once this has finished, e.g. a Limit that has passed
+  // enough rows.
+  void checkNoMoreOutputNeeded(int operatorIndex);
+
   /// If 'trackOperatorCpuUsage_' is true, returns initialized timer object to
   /// track cpu and wall time of an operation. Returns null otherwise.
   /// The delta CpuWallTiming object would be passes to 'func' upon destruction
@@ -335,6 +402,11 @@ class Driver : public std::enable_shared_from_this<Driver> {
         : nullptr;
   }
 
+  /// Returns 'op' if 'trackHardwareCounters_' is true, nullptr otherwise.
+  Operator* hardwareCounterOp(Operator* op) const {
+    return trackHardwareCounters_ ? op : nullptr;
+  }
+
   std::unique_ptr<DriverCtx> ctx_;
   std::atomic_bool closed_{false};
 
@@ -349,10 +421,39 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   std::vector<std::unique_ptr<Operator>> operators_;
 
+  // Number of leading operators whose output is no longer needed.
+  int32_t numOutputNotNeeded_{0};
+
+  // SamplingProfiler tags of the operators by operator id. Empty if the
+  // profiler was not running when 'this' was initialized.
+  std::vector<int32_t> sampleTags_;
+
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 
+  folly::Synchronized<DriverStats> stats_;
+
   bool trackOperatorCpuUsage_;
 
+  // True if 'track_operator_hardware_counters' is set and the counters are
+  // available.
+  bool trackHardwareCounters_{false};
+
+  // Time slice from 'driver_time_slice_ms', 0 if there is none.
+  uint64_t timeSliceMicros_{0};
+
+  // Set when 'this' is run by an executor through enqueue(). A Driver pulled
+  // with next() never yields.
+  bool yieldOnTimeSlice_{false};
+
+  // Time 'this' last went on thread.
+  uint64_t sliceStartMicros_{0};
+
+  // Interval from 'operator_memory_sample_interval_ms', 0 if not sampling.
+  uint64_t memorySampleIntervalMicros_{0};
+
+  // Time of the next sample of the memory usage of the operators.
+  uint64_t nextMemorySampleMicros_{0};
+
   friend struct DriverFactory;
 };
 
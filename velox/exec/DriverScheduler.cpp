@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverScheduler.h"
+#include <folly/system/ThreadName.h>
+#include <chrono>
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/memory/Numa.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+// The scheduler and index of the worker running on this thread, if any.
+thread_local DriverScheduler* currentScheduler{nullptr};
+thread_local int32_t currentWorker{-1};
+} // namespace
+
+DriverScheduler::DriverScheduler(int32_t numThreads, bool numaAware) {
+  VELOX_CHECK_GT(numThreads, 0);
+  // Every node must have at least one thread.
+  const int32_t numNodes =
+      numaAware ? std::min(memory::numa::numNodes(), numThreads) : 1;
+  nodeWorkers_.resize(numNodes);
+  workers_.reserve(numThreads);
+  for (auto i = 0; i < numThreads; ++i) {
+    const int32_t node = i % numNodes;
+    workers_.push_back(std::make_unique<Worker>(node));
+    nodeWorkers_[node].push_back(i);
+  }
+  for (auto i = 0; i < numThreads; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { run(i); });
+  }
+}
+
+DriverScheduler::~DriverScheduler() {
+  {
+    std::lock_guard<std::mutex> l(idleMutex_);
+    stopped_ = true;
+  }
+  idleCv_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void DriverScheduler::add(folly::Func func) {
+  add("", 1.0, std::move(func));
+}
+
+void DriverScheduler::add(
+    const std::string& queryId,
+    double weight,
+    folly::Func func) {
+  VELOX_CHECK_GT(weight, 0, "Fair share weight of {}", queryId);
+  enqueue(Work{addQuery(queryId, weight), std::move(func)});
+}
+
+DriverScheduler::Stats DriverScheduler::stats() const {
+  Stats stats;
+  stats.numRun = numRun_;
+  stats.numStolen = numStolen_;
+  stats.numCrossNodeSteals = numCrossNodeSteals_;
+  return stats;
+}
+
+std::shared_ptr<DriverScheduler::Query> DriverScheduler::addQuery(
+    const std::string& queryId,
+    double weight) {
+  std::lock_guard<std::mutex> l(queriesMutex_);
+  auto& query = queries_[queryId];
+  if (query == nullptr) {
+    query = std::make_shared<Query>(
+        queryId, weight, virtualTime_.load(), nextNode_++ % numNodes());
+  } else {
+    query->weight = weight;
+  }
+  ++query->numPending;
+  return query;
+}
+
+void DriverScheduler::finishQuery(const std::shared_ptr<Query>& query) {
+  std::lock_guard<std::mutex> l(queriesMutex_);
+  if (--query->numPending == 0) {
+    queries_.erase(query->id);
+  }
+}
+
+void DriverScheduler::enqueue(Work work) {
+  int32_t index;
+  if (currentScheduler == this &&
+      workers_[currentWorker]->node == work.query->node) {
+    index = currentWorker;
+  } else {
+    const auto& candidates = nodeWorkers_[work.query->node];
+    index = candidates[nextWorker_++ % candidates.size()];
+  }
+  auto& worker = *workers_[index];
+  {
+    std::lock_guard<std::mutex> l(worker.mutex);
+    auto it = std::find_if(
+        worker.queues.begin(), worker.queues.end(), [&](const auto& queue) {
+          return queue.query == work.query;
+        });
+    if (it == worker.queues.end()) {
+      worker.queues.push_back(QueryQueue{std::move(work.query), {}});
+      it = worker.queues.end() - 1;
+    }
+    it->funcs.push_back(std::move(work.func));
+  }
+  {
+    std::lock_guard<std::mutex> l(idleMutex_);
+    ++numQueued_;
+  }
+  idleCv_.notify_one();
+}
+
+bool DriverScheduler::take(Worker& worker, Work& work) {
+  std::lock_guard<std::mutex> l(worker.mutex);
+  if (worker.queues.empty()) {
+    return false;
+  }
+  auto best = worker.queues.begin();
+  for (auto it = best + 1; it != worker.queues.end(); ++it) {
+    if (it->query->virtualTime < best->query->virtualTime) {
+      best = it;
+    }
+  }
+  work.query = best->query;
+  work.func = std::move(best->funcs.front());
+  best->funcs.pop_front();
+  if (best->funcs.empty()) {
+    worker.queues.erase(best);
+  }
+  --numQueued_;
+  return true;
+}
+
+bool DriverScheduler::steal(int32_t index, Work& work) {
+  const auto node = workers_[index]->node;
+  for (auto crossNode : {false, true}) {
+    for (auto i = 1; i < workers_.size(); ++i) {
+      auto& victim = *workers_[(index + i) % workers_.size()];
+      if ((victim.node != node) != crossNode) {
+        continue;
+      }
+      if (take(victim, work)) {
+        ++numStolen_;
+        if (crossNode) {
+          ++numCrossNodeSteals_;
+        }
+        return true;
+      }
+    }
+    if (numNodes() == 1) {
+      break;
+    }
+  }
+  return false;
+}
+
+void DriverScheduler::run(int32_t index) {
+  folly::setThreadName(fmt::format("DriverSched{}", index));
+  currentScheduler = this;
+  currentWorker = index;
+  auto& worker = *workers_[index];
+  if (numNodes() > 1 && !memory::numa::pinCurrentThread(worker.node)) {
+    LOG(WARNING) << "DriverScheduler: cannot pin thread " << index
+                 << " to NUMA node " << worker.node;
+  }
+  for (;;) {
+    Work work;
+    if (!take(worker, work) && !steal(index, work)) {
+      std::unique_lock<std::mutex> l(idleMutex_);
+      if (numQueued_ <= 0) {
+        if (stopped_) {
+          return;
+        }
+        idleCv_.wait(l, [&]() { return numQueued_ > 0 || stopped_; });
+      }
+      continue;
+    }
+
+    virtualTime_ = work.query->virtualTime.load();
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      work.func();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "DriverScheduler: function threw: " << e.what();
+    }
+    const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    work.query->virtualTime += static_cast<int64_t>(nanos / work.query->weight);
+    ++numRun_;
+    finishQuery(work.query);
+  }
+}
+
+} // namespace facebook::velox::exec
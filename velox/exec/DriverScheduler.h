@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// Executor for Drivers with a run queue per thread, work stealing and fair
+/// sharing of CPU time between queries. It can be used as the executor of a
+/// QueryCtx in place of a folly::CPUThreadPoolExecutor.
+///
+/// Driver::enqueue() tags each Driver with its query id and the query's
+/// 'driver_scheduler_weight'. Each query accumulates a virtual run time,
+/// which is the run time of its slices divided by its weight. A thread runs
+/// the oldest work of the query with the least virtual run time in its own
+/// queue, so a query with many runnable Drivers cannot starve a query with
+/// few. A query that becomes runnable starts at the virtual time of the
+/// most recently scheduled query, so it cannot monopolize the threads
+/// either.
+///
+/// Work submitted from a scheduler thread, e.g. a Driver continuing after a
+/// yield, goes to that thread's queue. Other work is spread round robin. A
+/// thread with an empty queue steals from the other threads before it
+/// sleeps.
+///
+/// If 'numaAware' is set on a machine with more than one NUMA node, the
+/// threads are spread over the nodes and pinned to the CPUs of their node.
+/// Each query gets a home node, round robin, and its work is queued on
+/// threads of that node, so that its Drivers keep using memory that is local
+/// to them. Idle threads steal from threads of their own node before they
+/// steal across nodes.
+class DriverScheduler : public folly::Executor {
+ public:
+  explicit DriverScheduler(int32_t numThreads, bool numaAware = false);
+
+  /// Waits for the queued work to finish and joins the threads.
+  ~DriverScheduler() override;
+
+  /// Adds 'func' on behalf of an anonymous query with weight 1.
+  void add(folly::Func func) override;
+
+  /// Adds 'func' on behalf of 'queryId' with fair share 'weight'. A query
+  /// has the weight given with its latest work.
+  void add(const std::string& queryId, double weight, folly::Func func);
+
+  int32_t numThreads() const {
+    return workers_.size();
+  }
+
+  /// Number of NUMA nodes the threads are spread over, 1 if not NUMA aware.
+  int32_t numNodes() const {
+    return nodeWorkers_.size();
+  }
+
+  struct Stats {
+    /// Number of functions run.
+    int64_t numRun{0};
+
+    /// Number of functions run by a thread other than the one they were
+    /// queued on.
+    int64_t numStolen{0};
+
+    /// Number of stolen functions that were queued on a thread of another
+    /// NUMA node.
+    int64_t numCrossNodeSteals{0};
+  };
+
+  Stats stats() const;
+
+ private:
+  struct Query {
+    Query(
+        std::string _id,
+        double _weight,
+        int64_t _virtualTime,
+        int32_t _node)
+        : id(std::move(_id)),
+          weight(_weight),
+          virtualTime(_virtualTime),
+          node(_node) {}
+
+    const std::string id;
+    std::atomic<double> weight;
+
+    // Wall nanos of the query's slices divided by its weight.
+    std::atomic<int64_t> virtualTime;
+
+    // NUMA node whose threads the work of the query is queued on.
+    const int32_t node;
+
+    // Number of queued and running functions. The query is forgotten when
+    // this drops to 0. Guarded by 'queriesMutex_'.
+    int32_t numPending{0};
+  };
+
+  struct QueryQueue {
+    std::shared_ptr<Query> query;
+    std::deque<folly::Func> funcs;
+  };
+
+  struct Worker {
+    explicit Worker(int32_t _node) : node(_node) {}
+
+    // NUMA node the thread is pinned to.
+    const int32_t node;
+    std::mutex mutex;
+    // One queue per query with work on this thread.
+    std::vector<QueryQueue> queues;
+    std::thread thread;
+  };
+
+  struct Work {
+    std::shared_ptr<Query> query;
+    folly::Func func;
+  };
+
+  std::shared_ptr<Query> addQuery(const std::string& queryId, double weight);
+
+  void finishQuery(const std::shared_ptr<Query>& query);
+
+  void enqueue(Work work);
+
+  // Takes the oldest work of the query with the least virtual time from the
+  // queue of 'worker'. Returns false if the queue is empty.
+  bool take(Worker& worker, Work& work);
+
+  // Takes work from the queue of a thread other than 'index'. Prefers
+  // threads on the same NUMA node.
+  bool steal(int32_t index, Work& work);
+
+  void run(int32_t index);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Indices of the workers of each NUMA node.
+  std::vector<std::vector<int32_t>> nodeWorkers_;
+
+  std::mutex queriesMutex_;
+  std::unordered_map<std::string, std::shared_ptr<Query>> queries_;
+
+  // Virtual time of the most recently scheduled query.
+  std::atomic<int64_t> virtualTime_{0};
+
+  std::atomic<uint32_t> nextWorker_{0};
+  // Guarded by 'queriesMutex_'.
+  uint32_t nextNode_{0};
+
+  // Guards the sleeping of idle threads.
+  std::mutex idleMutex_;
+  std::condition_variable idleCv_;
+  // Number of queued functions. May go transiently below zero.
+  std::atomic<int64_t> numQueued_{0};
+  bool stopped_{false};
+
+  std::atomic<int64_t> numRun_{0};
+  std::atomic<int64_t> numStolen_{0};
+  std::atomic<int64_t> numCrossNodeSteals_{0};
+};
+
+} // namespace facebook::velox::exec
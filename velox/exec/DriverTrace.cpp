@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/DriverTrace.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+
+#include <fmt/format.h>
+#include <folly/String.h>
+
+#include "velox/exec/Task.h"
+
+DEFINE_bool(
+    velox_trace_driver_events,
+    false,
+    "Record Driver state transitions for exporting as a Chrome trace with "
+    "DriverTrace::toChromeTraceJson()");
+
+namespace facebook::velox::exec {
+
+namespace {
+
+struct Ring {
+  std::mutex mutex;
+  std::vector<DriverTrace::Event> events;
+  uint64_t numEvents{0};
+  int32_t index;
+  // True while a thread records into 'this'. Guarded by the mutex of the
+  // registry.
+  bool inUse{false};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Ring>> rings;
+};
+
+Registry& registry() {
+  static auto* registry = new Registry();
+  return *registry;
+}
+
+// Returns the ring of a thread to the registry when the thread exits. The
+// events stay until the next thread which takes the ring overwrites them.
+struct RingLease {
+  ~RingLease() {
+    if (ring != nullptr) {
+      std::lock_guard<std::mutex> l(registry().mutex);
+      ring->inUse = false;
+    }
+  }
+
+  Ring* ring{nullptr};
+};
+
+thread_local RingLease threadRing;
+
+Ring& ringForThread() {
+  if (threadRing.ring == nullptr) {
+    auto& rings = registry();
+    std::lock_guard<std::mutex> l(rings.mutex);
+    for (auto& ring : rings.rings) {
+      if (!ring->inUse) {
+        threadRing.ring = ring.get();
+        break;
+      }
+    }
+    if (threadRing.ring == nullptr) {
+      auto ring = std::make_unique<Ring>();
+      ring->index = rings.rings.size();
+      ring->events.resize(DriverTrace::kEventsPerThread);
+      threadRing.ring = ring.get();
+      rings.rings.push_back(std::move(ring));
+    }
+    threadRing.ring->inUse = true;
+  }
+  return *threadRing.ring;
+}
+
+uint64_t traceTaskId(const Task& task) {
+  return std::hash<std::string>()(task.uuid());
+}
+
+uint64_t steadyNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+// static
+void DriverTrace::recordEvent(
+    const Driver& driver,
+    EventType type,
+    StopReason stopReason,
+    BlockingReason blockingReason) {
+  auto* driverCtx = driver.driverCtx();
+  if (driverCtx == nullptr || driverCtx->task == nullptr) {
+    return;
+  }
+  auto& ring = ringForThread();
+  const Event event{
+      steadyNanos(),
+      traceTaskId(*driverCtx->task),
+      driverCtx->pipelineId,
+      driverCtx->driverId,
+      ring.index,
+      type,
+      stopReason,
+      blockingReason};
+  std::lock_guard<std::mutex> l(ring.mutex);
+  ring.events[ring.numEvents++ % kEventsPerThread] = event;
+}
+
+// static
+std::vector<DriverTrace::Event> DriverTrace::events(const Task& task) {
+  const auto taskId = traceTaskId(task);
+  std::vector<Event> events;
+  auto& rings = registry();
+  std::lock_guard<std::mutex> l(rings.mutex);
+  for (auto& ring : rings.rings) {
+    std::lock_guard<std::mutex> ringLock(ring->mutex);
+    const auto numEvents =
+        std::min<uint64_t>(ring->numEvents, kEventsPerThread);
+    for (uint64_t i = 0; i < numEvents; ++i) {
+      const auto& event = ring->events[i];
+      if (event.taskId == taskId) {
+        events.push_back(event);
+      }
+    }
+  }
+  std::stable_sort(
+      events.begin(), events.end(), [](const auto& left, const auto& right) {
+        return left.timeNanos < right.timeNanos;
+      });
+  return events;
+}
+
+// static
+std::string DriverTrace::toChromeTraceJson(const Task& task) {
+  const auto events = DriverTrace::events(task);
+  const auto baseNanos = events.empty() ? 0 : events.front().timeNanos;
+
+  // The start of the slice a Driver is in.
+  struct DriverState {
+    std::optional<uint64_t> enqueueNanos;
+    std::optional<uint64_t> runNanos;
+    std::optional<uint64_t> blockNanos;
+    BlockingReason blockingReason{BlockingReason::kNotBlocked};
+  };
+  std::map<std::pair<int32_t, int32_t>, DriverState> drivers;
+
+  std::vector<std::string> traceEvents;
+  auto addSlice = [&](const Event& event,
+                      const std::string& name,
+                      uint64_t beginNanos,
+                      const std::string& args) {
+    traceEvents.push_back(fmt::format(
+        "{{\"name\":\"{}\",\"cat\":\"driver\",\"ph\":\"X\",\"ts\":{:.3f},"
+        "\"dur\":{:.3f},\"pid\":{},\"tid\":{},\"args\":{{{}}}}}",
+        name,
+        (beginNanos - baseNanos) / 1'000.0,
+        (event.timeNanos - beginNanos) / 1'000.0,
+        event.pipelineId,
+        event.driverId,
+        args));
+  };
+
+  std::set<int32_t> pipelineIds;
+  for (const auto& event : events) {
+    pipelineIds.insert(event.pipelineId);
+    auto& state = drivers[{event.pipelineId, event.driverId}];
+    switch (event.type) {
+      case EventType::kEnqueue:
+        state.enqueueNanos = event.timeNanos;
+        break;
+      case EventType::kRun:
+        if (state.enqueueNanos.has_value()) {
+          addSlice(event, "queued", state.enqueueNanos.value(), "");
+          state.enqueueNanos.reset();
+        }
+        state.runNanos = event.timeNanos;
+        break;
+      case EventType::kStop:
+        if (state.runNanos.has_value()) {
+          addSlice(
+              event,
+              "running",
+              state.runNanos.value(),
+              fmt::format(
+                  "\"stopReason\":\"{}\",\"thread\":{}",
+                  stopReasonString(event.stopReason),
+                  event.threadIndex));
+          state.runNanos.reset();
+        }
+        if (event.stopReason == StopReason::kBlock) {
+          state.blockNanos = event.timeNanos;
+          state.blockingReason = event.blockingReason;
+        }
+        break;
+      case EventType::kResume:
+        if (state.blockNanos.has_value()) {
+          addSlice(
+              event,
+              blockingReasonToString(state.blockingReason),
+              state.blockNanos.value(),
+              "");
+          state.blockNanos.reset();
+        }
+        break;
+    }
+  }
+  for (auto pipelineId : pipelineIds) {
+    traceEvents.push_back(fmt::format(
+        "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},"
+        "\"args\":{{\"name\":\"pipeline {}\"}}}}",
+        pipelineId,
+        pipelineId));
+  }
+  return fmt::format(
+      "{{\"traceEvents\":[{}],\"displayTimeUnit\":\"ns\"}}",
+      folly::join(",", traceEvents));
+}
+
+} // namespace facebook::velox::exec
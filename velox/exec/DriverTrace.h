@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <gflags/gflags.h>
+
+#include "velox/exec/Driver.h"
+
+DECLARE_bool(velox_trace_driver_events);
+
+namespace facebook::velox::exec {
+
+/// Trace of Driver state transitions for debugging latency. When
+/// FLAGS_velox_trace_driver_events is set, each thread records the
+/// transitions of the Drivers it runs or enqueues in a ring of the last
+/// kEventsPerThread events. The events of a Task can then be exported as
+/// Chrome trace event JSON, which chrome://tracing and Perfetto load. When
+/// the flag is not set, recording is a check of the flag.
+class DriverTrace {
+ public:
+  enum class EventType : uint8_t {
+    // Added to the queue of the executor.
+    kEnqueue,
+    // Started running on a thread.
+    kRun,
+    // Went off thread. 'stopReason' tells why.
+    kStop,
+    // The future a blocked Driver waited for was realized.
+    kResume,
+  };
+
+  struct Event {
+    // Steady clock time.
+    uint64_t timeNanos;
+    // Hash of the uuid of the Task.
+    uint64_t taskId;
+    int32_t pipelineId;
+    int32_t driverId;
+    // Index of the ring, one per live thread, which recorded the event.
+    int32_t threadIndex;
+    EventType type;
+    StopReason stopReason;
+    // Set if 'stopReason' is kBlock.
+    BlockingReason blockingReason;
+  };
+
+  static constexpr int32_t kEventsPerThread = 4'096;
+
+  static bool enabled() {
+    return FLAGS_velox_trace_driver_events;
+  }
+
+  /// Records an event of 'driver' if enabled().
+  static void record(
+      const Driver& driver,
+      EventType type,
+      StopReason stopReason = StopReason::kNone,
+      BlockingReason blockingReason = BlockingReason::kNotBlocked) {
+    if (FOLLY_UNLIKELY(enabled())) {
+      recordEvent(driver, type, stopReason, blockingReason);
+    }
+  }
+
+  /// Returns the recorded events of 'task' in time order. Events which were
+  /// overwritten in the ring of their thread are lost.
+  static std::vector<Event> events(const Task& task);
+
+  /// Returns the events of 'task' as a Chrome trace JSON object. Each Driver
+  /// is a track with the pipeline as process and the driver as thread. The
+  /// time between kEnqueue and kRun is a 'queued' slice, kRun to kStop is a
+  /// 'running' slice with the stop reason, and a blocked Driver has a slice
+  /// named by the blocking reason until kResume.
+  static std::string toChromeTraceJson(const Task& task);
+
+ private:
+  static void recordEvent(
+      const Driver& driver,
+      EventType type,
+      StopReason stopReason,
+      BlockingReason blockingReason);
+};
+
+} // namespace facebook::velox::exec
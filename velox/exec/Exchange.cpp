@@ -17,6 +17,7 @@
 #include <velox/common/base/Exceptions.h>
 #include <velox/common/memory/Memory.h>
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
@@ -47,6 +48,114 @@ void SerializedPage::prepareStreamForDeserialize(ByteStream* input) {
   input->resetInput(std::move(ranges_));
 }
 
+ExchangeMemoryRegion::ExchangeMemoryRegion(
+    memory::MemoryPool* pool,
+    uint64_t capacity)
+    : pool_(pool),
+      capacity_(capacity),
+      data_(reinterpret_cast<uint8_t*>(pool_->allocate(capacity_))) {}
+
+ExchangeMemoryRegion::~ExchangeMemoryRegion() {
+  pool_->free(data_, capacity_);
+}
+
+// static
+std::shared_ptr<ExchangeMemoryRegionPool> ExchangeMemoryRegionPool::create(
+    memory::MemoryPool* pool,
+    uint64_t regionBytes,
+    int32_t maxRegions,
+    RegionCallback onRegister,
+    RegionCallback onUnregister) {
+  return std::shared_ptr<ExchangeMemoryRegionPool>(new ExchangeMemoryRegionPool(
+      pool,
+      regionBytes,
+      maxRegions,
+      std::move(onRegister),
+      std::move(onUnregister)));
+}
+
+ExchangeMemoryRegionPool::ExchangeMemoryRegionPool(
+    memory::MemoryPool* pool,
+    uint64_t regionBytes,
+    int32_t maxRegions,
+    RegionCallback onRegister,
+    RegionCallback onUnregister)
+    : pool_(pool->shared_from_this()),
+      regionBytes_(regionBytes),
+      maxRegions_(maxRegions),
+      onRegister_(std::move(onRegister)),
+      onUnregister_(std::move(onUnregister)) {
+  VELOX_CHECK_GT(regionBytes_, 0);
+  VELOX_CHECK_GT(maxRegions_, 0);
+}
+
+ExchangeMemoryRegionPool::~ExchangeMemoryRegionPool() {
+  // Pages hold a reference on 'this', so all regions are free here unless a
+  // source still holds one it acquired and never released.
+  VELOX_DCHECK_EQ(static_cast<int32_t>(freeRegions_.size()), numRegions_);
+  if (onUnregister_) {
+    for (auto& region : freeRegions_) {
+      onUnregister_(*region);
+    }
+  }
+}
+
+std::unique_ptr<ExchangeMemoryRegion> ExchangeMemoryRegionPool::acquire() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!freeRegions_.empty()) {
+      auto region = std::move(freeRegions_.back());
+      freeRegions_.pop_back();
+      return region;
+    }
+    if (numRegions_ >= maxRegions_) {
+      return nullptr;
+    }
+    ++numRegions_;
+  }
+  auto region =
+      std::make_unique<ExchangeMemoryRegion>(pool_.get(), regionBytes_);
+  if (onRegister_) {
+    onRegister_(*region);
+  }
+  return region;
+}
+
+void ExchangeMemoryRegionPool::release(
+    std::unique_ptr<ExchangeMemoryRegion> region) {
+  VELOX_CHECK_NOT_NULL(region);
+  std::lock_guard<std::mutex> l(mutex_);
+  freeRegions_.push_back(std::move(region));
+}
+
+namespace {
+struct RegionPageBuffer {
+  std::shared_ptr<ExchangeMemoryRegionPool> regions;
+  std::unique_ptr<ExchangeMemoryRegion> region;
+};
+} // namespace
+
+std::unique_ptr<SerializedPage> ExchangeMemoryRegionPool::makePage(
+    std::unique_ptr<ExchangeMemoryRegion> region,
+    uint64_t size) {
+  VELOX_CHECK_NOT_NULL(region);
+  VELOX_CHECK_LE(size, region->capacity());
+  auto* data = region->data();
+  const auto capacity = region->capacity();
+  auto* buffer = new RegionPageBuffer{shared_from_this(), std::move(region)};
+  auto iobuf = folly::IOBuf::takeOwnership(
+      data,
+      capacity,
+      size,
+      [](void* /*buf*/, void* userData) {
+        std::unique_ptr<RegionPageBuffer> buffer(
+            reinterpret_cast<RegionPageBuffer*>(userData));
+        buffer->regions->release(std::move(buffer->region));
+      },
+      buffer);
+  return std::make_unique<SerializedPage>(std::move(iobuf));
+}
+
 std::shared_ptr<ExchangeSource> ExchangeSource::create(
     const std::string& taskId,
     int destination,
@@ -84,16 +193,17 @@ class LocalExchangeSource : public ExchangeSource {
     return !requestPending_.exchange(true);
   }
 
-  void request() override {
+  void request(uint64_t maxBytes) override {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     VELOX_CHECK_NOT_NULL(buffers, "invalid PartitionedOutputBufferManager");
     VELOX_CHECK(requestPending_);
     auto requestedSequence = sequence_;
     auto self = shared_from_this();
+    requestedBytes_ += maxBytes;
     buffers->getData(
         taskId_,
         destination_,
-        kMaxBytes,
+        maxBytes,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
@@ -117,7 +227,12 @@ class LocalExchangeSource : public ExchangeSource {
               // Keep looping, there could be extra end markers.
               continue;
             }
-            inputPage->unshare();
+            // The page shares the buffers of the producer's page instead of
+            // copying them. The buffers keep the producer task and its
+            // memory alive until the last reference goes away, see
+            // PartitionedOutput::bufferReleaseFn_. Deserialization only
+            // reads the buffers, so the consumers of a broadcast page can
+            // safely share them.
             pages.push_back(
                 std::make_unique<SerializedPage>(std::move(inputPage)));
             inputPage = nullptr;
@@ -157,14 +272,17 @@ class LocalExchangeSource : public ExchangeSource {
   }
 
   folly::F14FastMap<std::string, int64_t> stats() const override {
-    return {{"localExchangeSource.numPages", numPages_}};
+    return {
+        {"localExchangeSource.numPages", numPages_},
+        {"localExchangeSource.requestedBytes", requestedBytes_}};
   }
 
  private:
-  static constexpr uint64_t kMaxBytes = 32 * 1024 * 1024; // 32 MB
-
   // Records the total number of pages fetched from sources.
   int64_t numPages_{0};
+
+  // Records the total credit given to this source in requests.
+  int64_t requestedBytes_{0};
 };
 
 std::unique_ptr<ExchangeSource> createLocalExchangeSource(
@@ -184,6 +302,7 @@ std::unique_ptr<ExchangeSource> createLocalExchangeSource(
 void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
   std::shared_ptr<ExchangeSource> toRequest;
   std::shared_ptr<ExchangeSource> toClose;
+  int64_t credit = 0;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
 
@@ -214,6 +333,7 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
       queue_->addSourceLocked();
       if (source->shouldRequestLocked()) {
         toRequest = source;
+        credit = creditLocked();
       }
     }
   }
@@ -222,7 +342,7 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
   if (toClose) {
     toClose->close();
   } else if (toRequest) {
-    toRequest->request();
+    toRequest->request(credit);
   }
 }
 
@@ -264,6 +384,7 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
     ContinueFuture* future) {
   std::vector<std::shared_ptr<ExchangeSource>> toRequest;
   std::unique_ptr<SerializedPage> page;
+  int64_t credit = 0;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
     *atEnd = false;
@@ -281,15 +402,33 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
         toRequest.push_back(source);
       }
     }
+    if (!toRequest.empty()) {
+      credit = creditLocked();
+    }
   }
 
   // Outside of lock
   for (auto& source : toRequest) {
-    source->request();
+    source->request(credit);
   }
   return page;
 }
 
+int64_t ExchangeClient::creditLocked() const {
+  int64_t numActiveSources = 0;
+  for (const auto& source : sources_) {
+    if (!source->atEnd_) {
+      ++numActiveSources;
+    }
+  }
+  const int64_t freeBytes = std::max<int64_t>(
+      0,
+      static_cast<int64_t>(queue_->minBytes()) -
+          static_cast<int64_t>(queue_->totalBytes()));
+  return std::max(
+      kMinCredit, freeBytes / std::max<int64_t>(1, numActiveSources));
+}
+
 ExchangeClient::~ExchangeClient() {
   close();
 }
@@ -377,6 +516,15 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
   return BlockingReason::kWaitForProducer;
 }
 
+void Exchange::noMoreOutputNeeded() {
+  currentPage_ = nullptr;
+  inputStream_ = nullptr;
+  if (!atEnd_) {
+    atEnd_ = true;
+    exchangeClient_->close();
+  }
+}
+
 bool Exchange::isFinished() {
   return atEnd_;
 }
@@ -393,8 +541,18 @@ RowVectorPtr Exchange::getOutput() {
     currentPage_->prepareStreamForDeserialize(inputStream_.get());
   }
 
+  if (!result_ || !result_.unique()) {
+    // The previous result is still referenced downstream. Deserializes into a
+    // vector recycled by the operators of the Driver.
+    result_ = std::static_pointer_cast<RowVector>(
+        operatorCtx_->execCtx()->getVector(outputType_, 0));
+  }
   getSerde()->deserialize(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result_,
+      serdeOptions_.get());
 
   {
     auto lockedStats = stats_.wlock();
@@ -417,6 +575,23 @@ void Exchange::recordStats() {
   }
 }
 
+std::unique_ptr<VectorSerde::Options> makeExchangeSerdeOptions(
+    const core::QueryConfig& queryConfig,
+    bool compressed) {
+  const auto compressionKind = compressed
+      ? common::stringToCompressionKind(queryConfig.exchangeCompressionKind())
+      : common::CompressionKind_NONE;
+  const bool preserveEncodings = queryConfig.exchangePreserveEncodings();
+  if (compressionKind == common::CompressionKind_NONE && !preserveEncodings) {
+    return nullptr;
+  }
+  return std::make_unique<serializer::presto::PrestoVectorSerde::PrestoOptions>(
+      /*useLosslessTimestamp*/ false,
+      compressionKind,
+      queryConfig.exchangeMinCompressionRatio(),
+      preserveEncodings);
+}
+
 VectorSerde* Exchange::getSerde() {
   return getVectorSerde();
 }
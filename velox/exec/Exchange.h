@@ -74,6 +74,112 @@ class SerializedPage {
   std::function<void(folly::IOBuf&)> onDestructionCb_;
 };
 
+/// A block of memory allocated from a MemoryPool into which a transport
+/// writes serialized pages directly, e.g. a buffer registered with an RDMA
+/// NIC or mapped into a shared memory segment. 'handle' is transport specific
+/// state of the region, such as its registration key.
+class ExchangeMemoryRegion {
+ public:
+  ExchangeMemoryRegion(memory::MemoryPool* pool, uint64_t capacity);
+
+  ~ExchangeMemoryRegion();
+
+  uint8_t* data() const {
+    return data_;
+  }
+
+  uint64_t capacity() const {
+    return capacity_;
+  }
+
+  void* handle() const {
+    return handle_;
+  }
+
+  void setHandle(void* handle) {
+    handle_ = handle;
+  }
+
+ private:
+  memory::MemoryPool* const pool_;
+  const uint64_t capacity_;
+  uint8_t* const data_;
+  void* handle_{nullptr};
+};
+
+/// A set of equally sized ExchangeMemoryRegions that an ExchangeSource posts
+/// to its transport. Regions are allocated and registered with the transport
+/// on first use and are recycled once the page delivered into them has been
+/// consumed, so a region is registered only once. The number of regions
+/// bounds the memory the transport can fill ahead of the consumer.
+class ExchangeMemoryRegionPool
+    : public std::enable_shared_from_this<ExchangeMemoryRegionPool> {
+ public:
+  /// Called for each region after it is allocated and before it is freed.
+  using RegionCallback = std::function<void(ExchangeMemoryRegion&)>;
+
+  static std::shared_ptr<ExchangeMemoryRegionPool> create(
+      memory::MemoryPool* pool,
+      uint64_t regionBytes,
+      int32_t maxRegions,
+      RegionCallback onRegister = nullptr,
+      RegionCallback onUnregister = nullptr);
+
+  ~ExchangeMemoryRegionPool();
+
+  /// Returns a free region, allocating and registering a new one if there
+  /// are fewer than 'maxRegions'. Returns nullptr if all regions hold pages
+  /// that have not been consumed yet.
+  std::unique_ptr<ExchangeMemoryRegion> acquire();
+
+  /// Returns a region that does not hold a page, e.g. after a failed
+  /// transfer.
+  void release(std::unique_ptr<ExchangeMemoryRegion> region);
+
+  /// Makes a page over the first 'size' bytes of 'region' without copying
+  /// them. The region is released to 'this' when the page and all clones of
+  /// its IOBuf are destroyed.
+  std::unique_ptr<SerializedPage> makePage(
+      std::unique_ptr<ExchangeMemoryRegion> region,
+      uint64_t size);
+
+  uint64_t regionBytes() const {
+    return regionBytes_;
+  }
+
+  /// Returns the number of regions allocated so far.
+  int32_t numRegions() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return numRegions_;
+  }
+
+  /// Returns the number of allocated regions that do not hold a page.
+  int32_t numFreeRegions() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return freeRegions_.size();
+  }
+
+ private:
+  ExchangeMemoryRegionPool(
+      memory::MemoryPool* pool,
+      uint64_t regionBytes,
+      int32_t maxRegions,
+      RegionCallback onRegister,
+      RegionCallback onUnregister);
+
+  // Shared so that the regions of pages that outlive the query can still be
+  // freed.
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  const uint64_t regionBytes_;
+  const int32_t maxRegions_;
+  const RegionCallback onRegister_;
+  const RegionCallback onUnregister_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<ExchangeMemoryRegion>> freeRegions_;
+  int32_t numRegions_{0};
+};
+
 // Queue of results retrieved from source. Owned by shared_ptr by
 // Exchange and client threads and registered callbacks waiting
 // for input.
@@ -283,8 +389,10 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
 
   // Requests the producer to generate more data. Call only if shouldRequest()
   // was true. The object handles its own lifetime by acquiring a
-  // shared_from_this() pointer if needed.
-  virtual void request() = 0;
+  // shared_from_this() pointer if needed. 'maxBytes' is the credit of this
+  // source, i.e. the amount of data the consumer has room for. The response
+  // should not exceed it by more than one page.
+  virtual void request(uint64_t maxBytes) = 0;
 
   // Close the exchange source. May be called before all data
   // has been received and proessed. This can happen in case
@@ -295,6 +403,17 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   // Returns runtime statistics.
   virtual folly::F14FastMap<std::string, int64_t> stats() const = 0;
 
+  // Returns the memory regions the transport of 'this' delivers pages into,
+  // or nullptr if the pages come in IOBufs allocated by the transport. A
+  // source for a transport that writes into pre-registered memory, e.g. RDMA
+  // or shared memory, creates an ExchangeMemoryRegionPool from 'pool_',
+  // posts regions from it in request() and enqueues the filled regions with
+  // ExchangeMemoryRegionPool::makePage(), so that pages are not copied after
+  // they arrive.
+  virtual std::shared_ptr<ExchangeMemoryRegionPool> memoryRegions() const {
+    return nullptr;
+  }
+
   virtual std::string toString() {
     std::stringstream out;
     out << "[ExchangeSource " << taskId_ << ":" << destination_
@@ -348,6 +467,10 @@ class ExchangeClient {
  public:
   static constexpr int32_t kDefaultMinSize = 32 << 20; // 32 MB.
 
+  // Smallest credit given to a source in a request, so that sources make
+  // progress with many sources or a full queue.
+  static constexpr int64_t kMinCredit = 64 << 10; // 64 KB.
+
   ExchangeClient(
       int destination,
       memory::MemoryPool* pool,
@@ -391,6 +514,12 @@ class ExchangeClient {
   std::string toString();
 
  private:
+  // Returns the credit for the next request to a source. The free space in
+  // the queue is split evenly between the sources that are not at end, so
+  // that the data requested from all sources together stays close to the
+  // queue's target size and no single source can fill the queue.
+  int64_t creditLocked() const;
+
   const int destination_;
   memory::MemoryPool* const pool_;
   std::shared_ptr<ExchangeQueue> queue_;
@@ -399,6 +528,16 @@ class ExchangeClient {
   bool closed_{false};
 };
 
+/// Returns the serde options for the pages sent between the tasks of a query
+/// according to the exchange compression and encoding settings in
+/// 'queryConfig'. Returns nullptr if the defaults of the serde apply. If
+/// 'compressed' is false, the options are for pages written without
+/// compression. Used by PartitionedOutput to write
+/// and by Exchange and MergeExchange to read the pages.
+std::unique_ptr<VectorSerde::Options> makeExchangeSerdeOptions(
+    const core::QueryConfig& queryConfig,
+    bool compressed = true);
+
 class Exchange : public SourceOperator {
  public:
   Exchange(
@@ -414,6 +553,7 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             operatorType),
         planNodeId_(exchangeNode->id()),
+        serdeOptions_(makeExchangeSerdeOptions(ctx->queryConfig())),
         exchangeClient_(std::move(exchangeClient)) {}
 
   ~Exchange() override {
@@ -432,6 +572,10 @@ class Exchange : public SourceOperator {
     exchangeClient_ = nullptr;
   }
 
+  /// Closes the exchange sources so that the upstream tasks stop producing
+  /// data for 'this'.
+  void noMoreOutputNeeded() override;
+
   BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
@@ -452,6 +596,7 @@ class Exchange : public SourceOperator {
   void recordStats();
 
   const core::PlanNodeId planNodeId_;
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
   bool noMoreSplits_ = false;
 
   /// A future received from Task::getSplitOrFuture(). It will be complete when
@@ -94,6 +94,28 @@ FilterProject::FilterProject(
   }
 }
 
+void FilterProject::close() {
+  recordConjunctStats();
+  Operator::close();
+  exprs_->clear();
+}
+
+void FilterProject::recordConjunctStats() {
+  for (const auto& [name, exprStats] : exprs_->stats()) {
+    for (const auto& [input, stats] : exprStats.conjuncts) {
+      addRuntimeStat(
+          fmt::format("conjunctInputRows[{}]", input),
+          RuntimeCounter(stats.numInputRows));
+      addRuntimeStat(
+          fmt::format("conjunctPassedRows[{}]", input),
+          RuntimeCounter(stats.numPassedRows));
+      addRuntimeStat(
+          fmt::format("conjunctClocks[{}]", input),
+          RuntimeCounter(stats.timeClocks));
+    }
+  }
+}
+
 void FilterProject::addInput(RowVectorPtr input) {
   input_ = std::move(input);
   numProcessedInputRows_ = 0;
@@ -103,6 +125,8 @@ void FilterProject::addInput(RowVectorPtr input) {
       if (result && result.unique() && result->isFlatEncoding()) {
         BaseVector::prepareForReuse(result, 0);
       } else {
+        // Recycles complex results in the vector pool of the Driver.
+        operatorCtx_->execCtx()->releaseVector(result);
         result.reset();
       }
     }
@@ -114,7 +138,7 @@ bool FilterProject::allInputProcessed() {
     return true;
   }
   if (numProcessedInputRows_ == input_->size()) {
-    input_ = nullptr;
+    releaseInput();
     return true;
   }
   return false;
@@ -165,7 +189,7 @@ RowVectorPtr FilterProject::getOutput() {
   auto numOut = filter(evalCtx, *rows);
   numProcessedInputRows_ = size;
   if (numOut == 0) { // no rows passed the filer
-    input_ = nullptr;
+    releaseInput();
     return nullptr;
   }
 
@@ -183,6 +207,13 @@ RowVectorPtr FilterProject::getOutput() {
       numOut, allRowsSelected ? nullptr : filterEvalCtx_.selectedIndices);
 }
 
+void FilterProject::releaseInput() {
+  // The input goes to the vector pool of the Driver for reuse by an upstream
+  // operator, e.g. an Exchange, unless it is referenced by the output.
+  VectorPtr input = std::move(input_);
+  operatorCtx_->execCtx()->releaseVector(input);
+}
+
 void FilterProject::project(const SelectivityVector& rows, EvalCtx& evalCtx) {
   exprs_->eval(
       hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results_);
@@ -51,10 +51,7 @@ class FilterProject : public Operator {
 
   bool isFinished() override;
 
-  void close() override {
-    Operator::close();
-    exprs_->clear();
-  }
+  void close() override;
 
  private:
   // Tests if 'numProcessedRows_' equals to the length of input_ and clears
@@ -73,6 +70,12 @@ class FilterProject : public Operator {
   // pre-condition: !isIdentityProjection_
   void project(const SelectivityVector& rows, EvalCtx& evalCtx);
 
+  // Clears 'input_' and recycles it if not referenced elsewhere.
+  void releaseInput();
+
+  // Adds the statistics of the inputs of AND and OR to the runtime stats.
+  void recordConjunctStats();
+
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
   std::unique_ptr<ExprSet> exprs_;
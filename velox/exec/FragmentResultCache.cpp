@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/FragmentResultCache.h"
+
+#include "velox/common/memory/Memory.h"
+
+DEFINE_int64(
+    velox_fragment_result_cache_bytes,
+    256 << 20,
+    "Memory limit of the process wide cache of plan fragment results. 0 "
+    "disables the cache");
+
+namespace facebook::velox::exec {
+
+FragmentResultCache::FragmentResultCache(uint64_t maxBytes)
+    : maxBytes_(maxBytes),
+      pool_(memory::addDefaultLeafMemoryPool("FragmentResultCache")) {}
+
+// static
+FragmentResultCache* FragmentResultCache::instance() {
+  static auto* cache = FLAGS_velox_fragment_result_cache_bytes > 0
+      ? new FragmentResultCache(FLAGS_velox_fragment_result_cache_bytes)
+      : nullptr;
+  return cache;
+}
+
+std::shared_ptr<const std::vector<RowVectorPtr>> FragmentResultCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->results;
+}
+
+RowVectorPtr FragmentResultCache::copy(const RowVectorPtr& result) const {
+  auto copy = std::static_pointer_cast<RowVector>(
+      BaseVector::create(result->type(), result->size(), pool_.get()));
+  copy->copy(result.get(), 0, 0, result->size());
+  return copy;
+}
+
+void FragmentResultCache::insert(
+    const std::string& key,
+    std::vector<RowVectorPtr> results) {
+  uint64_t bytes = 0;
+  for (const auto& result : results) {
+    bytes += result->retainedSize();
+  }
+  if (bytes > maxBytes_) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> l(mutex_);
+  if (entries_.count(key)) {
+    return;
+  }
+  lru_.push_front(Entry{
+      key,
+      std::make_shared<const std::vector<RowVectorPtr>>(std::move(results)),
+      bytes});
+  entries_[key] = lru_.begin();
+  bytes_ += bytes;
+  evictLocked();
+}
+
+void FragmentResultCache::evictLocked() {
+  while (bytes_ > maxBytes_) {
+    VELOX_CHECK(!lru_.empty());
+    auto& entry = lru_.back();
+    bytes_ -= entry.bytes;
+    entries_.erase(entry.key);
+    lru_.pop_back();
+    ++numEvicts_;
+  }
+}
+
+void FragmentResultCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+FragmentResultCache::Stats FragmentResultCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numHits = numHits_;
+  stats.numMisses = numMisses_;
+  stats.numEvicts = numEvicts_;
+  stats.numEntries = entries_.size();
+  stats.bytes = bytes_;
+  return stats;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <list>
+#include <mutex>
+
+#include <folly/container/F14Map.h>
+#include <gflags/gflags.h>
+
+#include "velox/vector/ComplexVector.h"
+
+DECLARE_int64(velox_fragment_result_cache_bytes);
+
+namespace facebook::velox::exec {
+
+/// Process wide cache of the results of plan fragments run with
+/// Task::next(). Repeated queries over unchanged data run the same fragment
+/// with the same splits and can return the cached results without running the
+/// plan. An entry is keyed by the serialized plan fragment and the cache keys
+/// of its splits, which identify the version of the data read by the split,
+/// see ConnectorSplit::cacheKey(). The results are copied into a memory pool
+/// owned by the cache. The cache is bounded by the retained size of the
+/// results and evicts the least recently used entries first.
+class FragmentResultCache {
+ public:
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEvicts{0};
+    uint64_t numEntries{0};
+    uint64_t bytes{0};
+  };
+
+  explicit FragmentResultCache(uint64_t maxBytes);
+
+  /// Returns the process wide instance or nullptr if
+  /// FLAGS_velox_fragment_result_cache_bytes is 0.
+  static FragmentResultCache* instance();
+
+  uint64_t maxBytes() const {
+    return maxBytes_;
+  }
+
+  /// Returns the results cached at 'key' or nullptr if not cached.
+  std::shared_ptr<const std::vector<RowVectorPtr>> find(const std::string& key);
+
+  /// Returns a copy of 'result' in the memory of 'this'. The results of a
+  /// fragment reference the memory of the query that produces them and are
+  /// copied as they are produced.
+  RowVectorPtr copy(const RowVectorPtr& result) const;
+
+  /// Caches 'results' made by copy() at 'key'. Does nothing if 'key' is cached
+  /// or 'results' are larger than the cache.
+  void insert(const std::string& key, std::vector<RowVectorPtr> results);
+
+  void clear();
+
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const std::vector<RowVectorPtr>> results;
+    uint64_t bytes;
+  };
+
+  // Evicts the least recently used entries until 'bytes_' is within
+  // 'maxBytes_'.
+  void evictLocked();
+
+  const uint64_t maxBytes_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> lru_;
+  folly::F14FastMap<std::string, std::list<Entry>::iterator> entries_;
+  uint64_t bytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+  uint64_t numEvicts_{0};
+};
+
+} // namespace facebook::velox::exec
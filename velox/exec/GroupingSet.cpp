@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/exec/GroupingSet.h"
+
+#include <numeric>
+
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/Task.h"
 
@@ -58,7 +61,8 @@ GroupingSet::GroupingSet(
     const Spiller::Config* spillConfig,
     tsan_atomic<bool>* nonReclaimableSection,
     OperatorCtx* operatorCtx)
-    : preGroupedKeyChannels_(std::move(preGroupedKeys)),
+    : inputType_(inputType),
+      preGroupedKeyChannels_(std::move(preGroupedKeys)),
       hashers_(std::move(hashers)),
       isGlobal_(hashers_.empty()),
       isPartial_(isPartial),
@@ -107,6 +111,24 @@ GroupingSet::GroupingSet(
     sortedAggregations_ =
         std::make_unique<SortedAggregations>(sortedAggs, inputType, &pool_);
   }
+
+  distinctAggregations_.resize(aggregates_.size());
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    const auto& aggregate = aggregates_[i];
+    if (!aggregate.distinct) {
+      continue;
+    }
+    VELOX_CHECK(isRawInput_);
+    std::vector<TypePtr> inputTypes;
+    for (auto j = 0; j < aggregate.inputs.size(); ++j) {
+      const auto channel = aggregate.inputs[j];
+      inputTypes.push_back(
+          channel == kConstantChannel ? aggregate.constantInputs[j]->type()
+                                      : inputType->childAt(channel));
+    }
+    distinctAggregations_[i] =
+        std::make_unique<DistinctAggregation>(inputTypes, &pool_);
+  }
 }
 
 GroupingSet::~GroupingSet() {
@@ -157,23 +179,40 @@ void GroupingSet::addInput(const RowVectorPtr& input, bool mayPushdown) {
   }
 
   auto numRows = input->size();
-  if (!preGroupedKeyChannels_.empty()) {
+  if (!preGroupedKeyChannels_.empty() && numRows > 0) {
     if (remainingInput_) {
       addRemainingInput();
     }
     // Look for the last group of pre-grouped keys.
+    bool foundBoundary = false;
     for (auto i = input->size() - 2; i >= 0; --i) {
       if (!equalKeys(preGroupedKeyChannels_, input, i, i + 1)) {
         // Process that many rows, flush the accumulators and the hash
         // table, then add remaining rows.
         numRows = i + 1;
-
-        remainingInput_ = input;
-        firstRemainingRow_ = numRows;
-        remainingMayPushdown_ = mayPushdown;
+        foundBoundary = true;
         break;
       }
     }
+    // The groups in the table are also complete if the pre-grouped keys
+    // changed between the previous input and this one. Then flush before
+    // adding any row of 'input'. Distinct aggregation produces its new
+    // groups from each input instead.
+    if (!foundBoundary && !aggregates_.empty() && table_ &&
+        table_->numDistinct() > 0 &&
+        !equalLastPreGroupedKeys(input, 0)) {
+      numRows = 0;
+      foundBoundary = true;
+    }
+    if (foundBoundary) {
+      remainingInput_ = input;
+      firstRemainingRow_ = numRows;
+      remainingMayPushdown_ = mayPushdown;
+    }
+    saveLastPreGroupedKeys(input);
+    if (numRows == 0) {
+      return;
+    }
   }
 
   activeRows_.resize(numRows);
@@ -182,6 +221,33 @@ void GroupingSet::addInput(const RowVectorPtr& input, bool mayPushdown) {
   addInputForActiveRows(input, mayPushdown);
 }
 
+bool GroupingSet::equalLastPreGroupedKeys(
+    const RowVectorPtr& input,
+    vector_size_t index) const {
+  for (auto i = 0; i < preGroupedKeyChannels_.size(); ++i) {
+    const auto& child = input->childAt(preGroupedKeyChannels_[i]);
+    if (!child->equalValueAt(lastPreGroupedKeys_[i].get(), index, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GroupingSet::saveLastPreGroupedKeys(const RowVectorPtr& input) {
+  if (lastPreGroupedKeys_.empty()) {
+    lastPreGroupedKeys_.resize(preGroupedKeyChannels_.size());
+  }
+  const auto lastRow = input->size() - 1;
+  for (auto i = 0; i < preGroupedKeyChannels_.size(); ++i) {
+    const auto& child = input->childAt(preGroupedKeyChannels_[i]);
+    auto& lastKey = lastPreGroupedKeys_[i];
+    if (!lastKey) {
+      lastKey = BaseVector::create(child->type(), 1, &pool_);
+    }
+    lastKey->copy(child.get(), 0, lastRow, 1);
+  }
+}
+
 void GroupingSet::noMoreInput() {
   noMoreInput_ = true;
 
@@ -217,6 +283,9 @@ void GroupingSet::addInputForActiveRows(
 
   table_->prepareForProbe(*lookup_, input, activeRows_, ignoreNullKeys_);
   table_->groupProbe(*lookup_);
+  if (pruneCondition_.has_value()) {
+    skipPrunedGroups();
+  }
   masks_.addInput(input, activeRows_);
 
   auto* groups = lookup_->hits.data();
@@ -239,6 +308,13 @@ void GroupingSet::addInputForActiveRows(
     }
 
     populateTempVectors(i, input);
+    if (const auto& distinct = distinctAggregations_[i]) {
+      const auto& newRows = distinct->newInputs(groups, rows, tempVectors_);
+      if (newRows.hasSelections()) {
+        function->addRawInput(groups, newRows, tempVectors_, false);
+      }
+      continue;
+    }
     // TODO(spershin): We disable the pushdown at the moment if selectivity
     // vector has changed after groups generation, we might want to revisit
     // this.
@@ -258,6 +334,57 @@ void GroupingSet::addInputForActiveRows(
     }
     sortedAggregations_->addInput(groups, input);
   }
+
+  if (pruneCondition_.has_value()) {
+    updatePrunedGroups();
+  }
+}
+
+void GroupingSet::skipPrunedGroups() {
+  if (prunedGroups_.empty()) {
+    return;
+  }
+  auto* groups = lookup_->hits.data();
+  for (auto row = activeRows_.begin(); row < activeRows_.end(); ++row) {
+    if (activeRows_.isValid(row) && prunedGroups_.count(groups[row])) {
+      activeRows_.setValid(row, false);
+      ++numPrunedRows_;
+    }
+  }
+  activeRows_.updateBounds();
+}
+
+void GroupingSet::updatePrunedGroups() {
+  auto* groups = lookup_->hits.data();
+  pruneCandidates_.clear();
+  activeRows_.applyToSelected(
+      [&](vector_size_t row) { pruneCandidates_.push_back(groups[row]); });
+  if (pruneCandidates_.empty()) {
+    return;
+  }
+  std::sort(pruneCandidates_.begin(), pruneCandidates_.end());
+  pruneCandidates_.erase(
+      std::unique(pruneCandidates_.begin(), pruneCandidates_.end()),
+      pruneCandidates_.end());
+
+  const auto& condition = pruneCondition_.value();
+  const auto numCandidates = pruneCandidates_.size();
+  if (pruneValues_ == nullptr) {
+    pruneValues_ =
+        BaseVector::create(condition.bound->type(), numCandidates, &pool_);
+  }
+  aggregates_[condition.aggregate].function->extractValues(
+      pruneCandidates_.data(), numCandidates, &pruneValues_);
+  for (auto i = 0; i < numCandidates; ++i) {
+    if (pruneValues_->isNullAt(i)) {
+      continue;
+    }
+    const auto result = pruneValues_->compare(condition.bound.get(), i, 0);
+    const bool fails = condition.upper ? result > 0 : result < 0;
+    if (fails || (result == 0 && !condition.inclusive)) {
+      prunedGroups_.insert(pruneCandidates_[i]);
+    }
+  }
 }
 
 void GroupingSet::addRemainingInput() {
@@ -433,6 +560,13 @@ void GroupingSet::addGlobalAggregationInput(
     auto& function = aggregates_[i].function;
 
     populateTempVectors(i, input);
+    if (const auto& distinct = distinctAggregations_[i]) {
+      const auto& newRows = distinct->newInputs(group, rows, tempVectors_);
+      if (newRows.hasSelections()) {
+        function->addSingleGroupRawInput(group, newRows, tempVectors_, false);
+      }
+      continue;
+    }
     const bool canPushdown =
         mayPushdown && mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
     if (isRawInput_) {
@@ -543,6 +677,8 @@ bool GroupingSet::getOutput(
   if (!numGroups) {
     if (table_) {
       table_->clear();
+      clearDistinctAggregations();
+      prunedGroups_.clear();
     }
     if (remainingInput_) {
       addRemainingInput();
@@ -562,10 +698,13 @@ void GroupingSet::extractGroups(
   }
   RowContainer& rows = table_ ? *table_->rows() : *rowsWhileReadingSpill_;
   auto totalKeys = rows.keyTypes().size();
-  for (int32_t i = 0; i < totalKeys; ++i) {
-    auto keyVector = result->childAt(i);
-    rows.extractColumn(groups.data(), groups.size(), i, keyVector);
-  }
+  std::vector<column_index_t> keyColumns(totalKeys);
+  std::iota(keyColumns.begin(), keyColumns.end(), 0);
+  rows.extractColumns(
+      groups.data(),
+      groups.size(),
+      keyColumns,
+      folly::Range<const VectorPtr*>(result->children().data(), totalKeys));
   for (int32_t i = 0; i < aggregates_.size(); ++i) {
     if (!aggregates_[i].sortingKeys.empty()) {
       continue;
@@ -589,6 +728,22 @@ void GroupingSet::extractGroups(
 void GroupingSet::resetPartial() {
   if (table_ != nullptr) {
     table_->clear();
+    clearDistinctAggregations();
+  }
+}
+
+bool GroupingSet::hasDistinctAggregations() const {
+  return std::any_of(
+      distinctAggregations_.begin(),
+      distinctAggregations_.end(),
+      [](const auto& distinct) { return distinct != nullptr; });
+}
+
+void GroupingSet::clearDistinctAggregations() {
+  for (auto& distinct : distinctAggregations_) {
+    if (distinct) {
+      distinct->clear();
+    }
   }
 }
 
@@ -717,20 +872,12 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
   }
   if (spiller_ == nullptr) {
     auto rows = table_->rows();
-    auto types = rows->keyTypes();
-    for (const auto& aggregate : aggregates_) {
-      types.push_back(aggregate.intermediateType);
-    }
-    std::vector<std::string> names;
-    for (auto i = 0; i < types.size(); ++i) {
-      names.push_back(fmt::format("s{}", i));
-    }
     VELOX_DCHECK(pool_.trackUsage());
     spiller_ = std::make_unique<Spiller>(
         Spiller::Type::kAggregate,
         rows,
         [&](folly::Range<char**> rows) { table_->erase(rows); },
-        ROW(std::move(names), std::move(types)),
+        intermediateRowType(),
         // Spill up to 8 partitions based on bits starting from 29th of the hash
         // number. Any from one to three bits would do.
         spillConfig_->hashBitRange,
@@ -740,14 +887,29 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->maxFileSize,
         spillConfig_->minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->compressionKind,
+        spillConfig_->readAheadDepth);
   }
   spiller_->spill(targetRows, targetBytes);
+  prunedGroups_.clear();
   if (table_->rows()->numRows() == 0) {
     table_->clear();
   }
 }
 
+RowTypePtr GroupingSet::intermediateRowType() const {
+  auto types = table_->rows()->keyTypes();
+  for (const auto& aggregate : aggregates_) {
+    types.push_back(aggregate.intermediateType);
+  }
+  std::vector<std::string> names;
+  for (auto i = 0; i < types.size(); ++i) {
+    names.push_back(fmt::format("s{}", i));
+  }
+  return ROW(std::move(names), std::move(types));
+}
+
 bool GroupingSet::getOutputWithSpill(
     int32_t batchSize,
     const RowVectorPtr& result) {
@@ -881,6 +1043,21 @@ void GroupingSet::abandonPartialAggregation() {
   table_ = nullptr;
 }
 
+void GroupingSet::resumePartialAggregation() {
+  VELOX_CHECK(abandonedPartialAggregation_);
+  VELOX_CHECK_NULL(table_);
+  abandonedPartialAggregation_ = false;
+  intermediateRows_.reset();
+  intermediateGroups_.clear();
+  // The hashers were moved into the abandoned table. The next input creates a
+  // new table with these.
+  hashers_.clear();
+  for (auto channel : keyChannels_) {
+    hashers_.push_back(
+        VectorHasher::create(inputType_->childAt(channel), channel));
+  }
+}
+
 void GroupingSet::toIntermediate(
     const RowVectorPtr& input,
     RowVectorPtr& result) {
@@ -960,6 +1137,112 @@ void GroupingSet::toIntermediate(
   tempVectors_.clear();
 }
 
+std::vector<std::vector<RowVectorPtr>> GroupingSet::takePeerGroups(
+    const HashBitRange& hashBits,
+    int32_t numDrivers,
+    int32_t driverId,
+    vector_size_t batchSize) {
+  VELOX_CHECK(noMoreInput_);
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK_NULL(sortedAggregations_);
+  VELOX_CHECK(!hasDistinctAggregations());
+  VELOX_CHECK_NULL(spiller_);
+  VELOX_CHECK_GT(batchSize, 0);
+
+  std::vector<std::vector<RowVectorPtr>> peerGroups(numDrivers);
+  if (table_ == nullptr || table_->rows()->numRows() == 0) {
+    return peerGroups;
+  }
+
+  // Hash the grouping keys of the groups the same way as the Spiller does to
+  // partition them.
+  auto* rows = table_->rows();
+  const auto numKeys = rows->keyTypes().size();
+  std::vector<std::vector<char*>> driverGroups(numDrivers);
+  constexpr int32_t kHashBatchSize = 4096;
+  std::vector<char*> groups(kHashBatchSize);
+  std::vector<uint64_t> hashes(kHashBatchSize);
+  RowContainerIterator iterator;
+  for (;;) {
+    const auto numGroups = rows->listRows(
+        &iterator, kHashBatchSize, RowContainer::kUnlimited, groups.data());
+    if (numGroups == 0) {
+      break;
+    }
+    folly::Range<char**> groupSet(groups.data(), numGroups);
+    for (auto i = 0; i < numKeys; ++i) {
+      rows->hash(i, groupSet, i > 0, hashes.data());
+    }
+    for (auto i = 0; i < numGroups; ++i) {
+      const auto driver = hashBits.partition(hashes[i]) % numDrivers;
+      if (driver != driverId) {
+        driverGroups[driver].push_back(groups[i]);
+      }
+    }
+  }
+
+  const auto rowType = intermediateRowType();
+  for (auto driver = 0; driver < numDrivers; ++driver) {
+    auto& groupsOfDriver = driverGroups[driver];
+    for (vector_size_t offset = 0; offset < groupsOfDriver.size();
+         offset += batchSize) {
+      const auto numGroups = std::min<vector_size_t>(
+          batchSize, groupsOfDriver.size() - offset);
+      auto* const groupsBatch = groupsOfDriver.data() + offset;
+      auto batch = BaseVector::create<RowVector>(rowType, numGroups, &pool_);
+      for (auto i = 0; i < numKeys; ++i) {
+        rows->extractColumn(groupsBatch, numGroups, i, batch->childAt(i));
+      }
+      for (auto i = 0; i < aggregates_.size(); ++i) {
+        aggregates_[i].function->extractAccumulators(
+            groupsBatch, numGroups, &batch->childAt(numKeys + i));
+      }
+      peerGroups[driver].push_back(std::move(batch));
+    }
+    table_->erase(folly::Range<char**>(
+        groupsOfDriver.data(), groupsOfDriver.size()));
+  }
+  prunedGroups_.clear();
+  return peerGroups;
+}
+
+void GroupingSet::addPeerGroups(const RowVectorPtr& groups) {
+  VELOX_CHECK(!isGlobal_);
+  if (!table_) {
+    createHashTable();
+  }
+
+  // Place the grouping keys at their input channels to probe the hash table.
+  const auto numGroups = groups->size();
+  std::vector<VectorPtr> children(inputType_->size());
+  for (auto i = 0; i < inputType_->size(); ++i) {
+    children[i] = BaseVector::createNullConstant(
+        inputType_->childAt(i), numGroups, &pool_);
+  }
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    children[keyChannels_[i]] = groups->childAt(i);
+  }
+  auto input = std::make_shared<RowVector>(
+      &pool_, inputType_, nullptr, numGroups, std::move(children));
+
+  activeRows_.resize(numGroups);
+  activeRows_.setAll();
+  table_->prepareForProbe(*lookup_, input, activeRows_, ignoreNullKeys_);
+  table_->groupProbe(*lookup_);
+
+  auto* hits = lookup_->hits.data();
+  const auto& newGroups = lookup_->newGroups;
+  std::vector<VectorPtr> args(1);
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    auto& function = aggregates_[i].function;
+    if (!newGroups.empty()) {
+      function->initializeNewGroups(hits, newGroups);
+    }
+    args[0] = groups->childAt(keyChannels_.size() + i);
+    function->addIntermediateResults(hits, activeRows_, args, false);
+  }
+}
+
 std::optional<int64_t> GroupingSet::estimateRowSize() const {
   const RowContainer* rows =
       table_ ? table_->rows() : rowsWhileReadingSpill_.get();
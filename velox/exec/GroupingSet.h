@@ -15,8 +15,11 @@
  */
 #pragma once
 
+#include <folly/container/F14Set.h>
+
 #include "velox/exec/AggregateInfo.h"
 #include "velox/exec/AggregationMasks.h"
+#include "velox/exec/DistinctAggregation.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/SortedAggregations.h"
 #include "velox/exec/Spiller.h"
@@ -114,6 +117,10 @@ class GroupingSet {
   // non-productive. Must be called before toIntermediate() is used.
   void abandonPartialAggregation();
 
+  /// Returns to partial aggregation after abandonPartialAggregation(). The
+  /// hash table is recreated on the next input.
+  void resumePartialAggregation();
+
   /// Translates the raw input in input to accumulators initialized from a
   /// single input row. Passes grouping keys through.
   void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
@@ -121,6 +128,56 @@ class GroupingSet {
   /// Returns an estimate of the average row size.
   std::optional<int64_t> estimateRowSize() const;
 
+  /// Used by a grouped aggregation merging the groups of its drivers in
+  /// parallel. Partitions the groups by 'hashBits' of the hash of their
+  /// grouping keys and assigns partition 'p' to driver 'p % numDrivers'.
+  /// Takes the groups of the drivers other than 'driverId' out of the hash
+  /// table and returns their grouping keys and intermediate results in batches
+  /// of up to 'batchSize' rows for each driver. Must be called after
+  /// noMoreInput().
+  std::vector<std::vector<RowVectorPtr>> takePeerGroups(
+      const HashBitRange& hashBits,
+      int32_t numDrivers,
+      int32_t driverId,
+      vector_size_t batchSize);
+
+  /// Adds the grouping keys and intermediate results of a batch of groups
+  /// returned by takePeerGroups() of a peer driver.
+  void addPeerGroups(const RowVectorPtr& groups);
+
+  /// A bound on an aggregate which the output groups must satisfy, e.g. a
+  /// HAVING max(x) < 10 filter over a final aggregation. The aggregate must
+  /// only grow with more input if 'upper' and only shrink otherwise, so that a
+  /// group failing the bound fails it for the rest of the input.
+  struct PruneCondition {
+    /// Index of the aggregate in 'aggregates'.
+    column_index_t aggregate;
+
+    /// Single row vector with the bound.
+    VectorPtr bound;
+
+    /// True if the groups with the aggregate above 'bound' fail, false if the
+    /// groups below fail.
+    bool upper;
+
+    /// True if the groups with the aggregate equal to 'bound' pass.
+    bool inclusive;
+  };
+
+  /// Stops adding input to the groups that fail 'condition'. These groups are
+  /// still produced with the aggregates of their input so far and must be
+  /// filtered out by the consumer of the output.
+  void setPruneCondition(PruneCondition condition) {
+    VELOX_CHECK(!isPartial_ && !isGlobal_);
+    pruneCondition_ = std::move(condition);
+  }
+
+  /// Returns the number of input rows skipped because their group failed the
+  /// prune condition.
+  int64_t numPrunedRows() const {
+    return numPrunedRows_;
+  }
+
  private:
   void addInputForActiveRows(const RowVectorPtr& input, bool mayPushdown);
 
@@ -190,10 +247,30 @@ class GroupingSet {
   // groups.
   void extractSpillResult(const RowVectorPtr& result);
 
+  bool hasDistinctAggregations() const;
+
+  // Forgets the inputs seen by 'distinctAggregations_'. Called whenever the
+  // groups in 'table_' are freed.
+  void clearDistinctAggregations();
+
+  // Deselects the rows of the groups in 'prunedGroups_' from 'activeRows_'.
+  // 'lookup_' must have the groups of the rows.
+  void skipPrunedGroups();
+
+  // Adds the groups of 'activeRows_' which fail 'pruneCondition_' to
+  // 'prunedGroups_'.
+  void updatePrunedGroups();
+
   // Return a list of accumulators for 'aggregates_' plus one more accumulator
   // for 'sortedAggregations_'.
   std::vector<Accumulator> accumulators();
 
+  // Returns the type of the grouping keys followed by the intermediate results
+  // of the aggregates. Spilled and peer groups are of this type.
+  RowTypePtr intermediateRowType() const;
+
+  const RowTypePtr inputType_;
+
   std::vector<column_index_t> keyChannels_;
 
   /// A subset of grouping keys on which the input is clustered.
@@ -207,6 +284,9 @@ class GroupingSet {
   std::vector<AggregateInfo> aggregates_;
   AggregationMasks masks_;
   std::unique_ptr<SortedAggregations> sortedAggregations_;
+  // One entry per aggregate in 'aggregates_'. Null unless the aggregate is
+  // over distinct inputs.
+  std::vector<std::unique_ptr<DistinctAggregation>> distinctAggregations_;
 
   const bool ignoreNullKeys_;
 
@@ -252,6 +332,12 @@ class GroupingSet {
   // 'remainingInput_'.
   bool remainingMayPushdown_;
 
+  // In case of partial streaming aggregation, the values of the pre-grouped
+  // keys in the last row of the previous input, one single row vector per
+  // key. Used to detect a change of the pre-grouped keys at the start of the
+  // next input.
+  std::vector<VectorPtr> lastPreGroupedKeys_;
+
   std::unique_ptr<Spiller> spiller_;
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> merge_;
 
@@ -282,6 +368,21 @@ class GroupingSet {
   // Index of first in 'nonSpilledRows_' that has not been added to output.
   size_t nonSpilledIndex_ = 0;
 
+  std::optional<PruneCondition> pruneCondition_;
+
+  // The groups which failed 'pruneCondition_'. Cleared whenever rows are
+  // erased from 'table_' so that a new group at the same address is not
+  // skipped.
+  folly::F14FastSet<char*> prunedGroups_;
+
+  // The distinct groups of the last input to check against 'pruneCondition_'.
+  std::vector<char*> pruneCandidates_;
+
+  // The aggregate of 'pruneCandidates_'.
+  VectorPtr pruneValues_;
+
+  int64_t numPrunedRows_{0};
+
   // Pool of the OperatorCtx. Used for spilling.
   memory::MemoryPool& pool_;
 
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/HashAggregation.h"
+#include <folly/ScopeGuard.h>
 #include <optional>
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/OperatorUtils.h"
@@ -22,10 +23,122 @@
 
 namespace facebook::velox::exec {
 
+namespace {
+bool isParallelMerge(
+    const core::AggregationNode& aggregationNode,
+    const DriverCtx& driverCtx) {
+  if (!driverCtx.queryConfig().aggregationParallelMergeEnabled() ||
+      isPartialOutput(aggregationNode.step()) ||
+      aggregationNode.groupingKeys().empty() ||
+      aggregationNode.aggregates().empty() ||
+      !aggregationNode.preGroupedKeys().empty()) {
+    return false;
+  }
+  // Aggregations over sorted or distinct inputs have no intermediate results
+  // to merge.
+  for (const auto& aggregate : aggregationNode.aggregates()) {
+    if (!aggregate.sortingKeys.empty() || aggregate.distinct) {
+      return false;
+    }
+  }
+  return driverCtx.task->numDrivers(driverCtx.pipelineId) > 1;
+}
+
+// Returns 1 if 'aggregate' only grows with more input, -1 if it only shrinks
+// and 0 otherwise.
+int32_t monotonicDirection(const core::AggregationNode::Aggregate& aggregate) {
+  if (!aggregate.sortingKeys.empty()) {
+    return 0;
+  }
+  const auto& name = aggregate.call->name();
+  const auto numArgs = aggregate.call->inputs().size();
+  if (name == "count" || name == "count_if") {
+    return 1;
+  }
+  if (name == "max" && numArgs == 1) {
+    return 1;
+  }
+  if (name == "min" && numArgs == 1) {
+    return -1;
+  }
+  return 0;
+}
+
+// Returns a condition on the groups of 'aggregationNode' which 'filterNode'
+// on top of it drops, if the filter has a conjunct 'aggregate <op> constant'
+// bounding an aggregate from the side it moves to with more input.
+std::optional<GroupingSet::PruneCondition> toPruneCondition(
+    const core::AggregationNode& aggregationNode,
+    const core::FilterNode& filterNode,
+    memory::MemoryPool* pool) {
+  const auto& outputType = aggregationNode.outputType();
+  const auto numKeys = aggregationNode.groupingKeys().size();
+  std::vector<core::TypedExprPtr> conjuncts;
+  auto* call =
+      dynamic_cast<const core::CallTypedExpr*>(filterNode.filter().get());
+  if (call != nullptr && call->name() == "and") {
+    conjuncts = call->inputs();
+  } else {
+    conjuncts.push_back(filterNode.filter());
+  }
+  for (const auto& conjunct : conjuncts) {
+    auto* comparison = dynamic_cast<const core::CallTypedExpr*>(conjunct.get());
+    if (comparison == nullptr || comparison->inputs().size() != 2) {
+      continue;
+    }
+    const auto& name = comparison->name();
+    bool less = name == "lt" || name == "lte";
+    if (!less && name != "gt" && name != "gte") {
+      continue;
+    }
+    // Normalizes to 'aggregate <op> constant'.
+    auto* field = dynamic_cast<const core::FieldAccessTypedExpr*>(
+        comparison->inputs()[0].get());
+    auto* constant = dynamic_cast<const core::ConstantTypedExpr*>(
+        comparison->inputs()[1].get());
+    if (field == nullptr || constant == nullptr) {
+      field = dynamic_cast<const core::FieldAccessTypedExpr*>(
+          comparison->inputs()[1].get());
+      constant = dynamic_cast<const core::ConstantTypedExpr*>(
+          comparison->inputs()[0].get());
+      less = !less;
+    }
+    if (field == nullptr || constant == nullptr || !field->isInputColumn()) {
+      continue;
+    }
+    const auto channel = outputType->getChildIdxIfExists(field->name());
+    if (!channel.has_value() || channel.value() < numKeys) {
+      continue;
+    }
+    const auto aggregateIndex = channel.value() - numKeys;
+    const auto direction =
+        monotonicDirection(aggregationNode.aggregates()[aggregateIndex]);
+    if (direction == 0 || less != (direction > 0)) {
+      continue;
+    }
+    const auto& type = outputType->childAt(channel.value());
+    if (!type->isPrimitiveType() || !constant->type()->equivalent(*type)) {
+      continue;
+    }
+    auto bound = constant->toConstantVector(pool);
+    if (bound->isNullAt(0)) {
+      continue;
+    }
+    return GroupingSet::PruneCondition{
+        static_cast<column_index_t>(aggregateIndex),
+        std::move(bound),
+        less,
+        name == "lte" || name == "gte"};
+  }
+  return std::nullopt;
+}
+} // namespace
+
 HashAggregation::HashAggregation(
     int32_t operatorId,
     DriverCtx* driverCtx,
-    const std::shared_ptr<const core::AggregationNode>& aggregationNode)
+    const std::shared_ptr<const core::AggregationNode>& aggregationNode,
+    const std::shared_ptr<const core::FilterNode>& filterNode)
     : Operator(
           driverCtx,
           aggregationNode->outputType(),
@@ -34,12 +147,14 @@ HashAggregation::HashAggregation(
           aggregationNode->step() == core::AggregationNode::Step::kPartial
               ? "PartialAggregation"
               : "Aggregation",
-          aggregationNode->canSpill(driverCtx->queryConfig())
+          aggregationNode->canSpill(driverCtx->queryConfig()) &&
+                  !isParallelMerge(*aggregationNode, *driverCtx)
               ? driverCtx->makeSpillConfig(operatorId)
               : std::nullopt),
       isPartialOutput_(isPartialOutput(aggregationNode->step())),
       isDistinct_(aggregationNode->aggregates().empty()),
       isGlobal_(aggregationNode->groupingKeys().empty()),
+      parallelMerge_(isParallelMerge(*aggregationNode, *driverCtx)),
       maxExtendedPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxExtendedPartialAggregationMemoryUsage()),
       maxPartialAggregationMemoryUsage_(
@@ -47,7 +162,10 @@ HashAggregation::HashAggregation(
       abandonPartialAggregationMinRows_(
           driverCtx->queryConfig().abandonPartialAggregationMinRows()),
       abandonPartialAggregationMinPct_(
-          driverCtx->queryConfig().abandonPartialAggregationMinPct()) {
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
+      abandonPartialAggregationResampleRows_(
+          driverCtx->queryConfig().abandonPartialAggregationResampleRows()),
+      resampleRows_(abandonPartialAggregationResampleRows_) {
   VELOX_CHECK(pool()->trackUsage());
 
   auto inputType = aggregationNode->sources()[0]->outputType();
@@ -126,6 +244,17 @@ HashAggregation::HashAggregation(
           "Aggregations over sorted inputs with masks are not supported yet");
     }
 
+    info.distinct = aggregate.distinct;
+    if (info.distinct) {
+      VELOX_USER_CHECK(
+          aggregationNode->step() == core::AggregationNode::Step::kSingle,
+          "Aggregations over distinct inputs cannot be split into partial and final");
+      VELOX_USER_CHECK_EQ(
+          numSortingKeys,
+          0,
+          "Aggregations over distinct and sorted inputs are not supported yet");
+    }
+
     aggregateInfos.emplace_back(std::move(info));
   }
 
@@ -158,6 +287,14 @@ HashAggregation::HashAggregation(
       spillConfig_.has_value() ? &spillConfig_.value() : nullptr,
       &nonReclaimableSection_,
       operatorCtx_.get());
+
+  if (filterNode != nullptr && !isPartialOutput_ && !isGlobal_ &&
+      driverCtx->queryConfig().aggregationHavingPruningEnabled()) {
+    if (auto condition =
+            toPruneCondition(*aggregationNode, *filterNode, pool())) {
+      groupingSet_->setPruneCondition(std::move(condition.value()));
+    }
+  }
 }
 
 bool HashAggregation::abandonPartialAggregationEarly(int64_t numOutput) const {
@@ -189,6 +326,10 @@ void HashAggregation::addInput(RowVectorPtr input) {
         RuntimeMetric(hashTableStats.numDistinct);
     lockedStats->runtimeStats["hashtable.numTombstones"] =
         RuntimeMetric(hashTableStats.numTombstones);
+    if (const auto numPrunedRows = groupingSet_->numPrunedRows()) {
+      lockedStats->runtimeStats["prunedInputRows"] =
+          RuntimeMetric(numPrunedRows);
+    }
   }
 
   // NOTE: we should not trigger partial output flush in case of global
@@ -221,6 +362,7 @@ void HashAggregation::recordSpillStats() {
   const auto spillStats = groupingSet_->spilledStats();
   auto lockedStats = stats_.wlock();
   lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledInputBytes = spillStats.spilledInputBytes;
   lockedStats->spilledRows = spillStats.spilledRows;
   lockedStats->spilledPartitions = spillStats.spilledPartitions;
   lockedStats->spilledFiles = spillStats.spilledFiles;
@@ -276,8 +418,20 @@ void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
     pool()->release();
     addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
     abandonedPartialAggregation_ = true;
+    if (resumedPartialAggregation_) {
+      // The sample after the last resume did not reduce either. Wait longer
+      // before the next one so that non-reducing input does not keep paying
+      // for building hash tables.
+      resampleRows_ *= 2;
+      resumedPartialAggregation_ = false;
+    }
+    numAbandonedInputRows_ = 0;
     return;
   }
+  if (resumedPartialAggregation_) {
+    resampleRows_ = abandonPartialAggregationResampleRows_;
+    resumedPartialAggregation_ = false;
+  }
   const int64_t extendedPartialAggregationMemoryUsage = std::min(
       maxPartialAggregationMemoryUsage_ * 2,
       maxExtendedPartialAggregationMemoryUsage_);
@@ -299,11 +453,36 @@ void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
           maxPartialAggregationMemoryUsage_, RuntimeCounter::Unit::kBytes));
 }
 
+void HashAggregation::maybeResumePartialAggregation() {
+  VELOX_DCHECK(abandonedPartialAggregation_);
+  if (resampleRows_ == 0 || noMoreInput_ ||
+      numAbandonedInputRows_ < resampleRows_) {
+    return;
+  }
+  groupingSet_->resumePartialAggregation();
+  addRuntimeStat("resumedPartialAggregation", RuntimeCounter(1));
+  addRuntimeStat(
+      "abandonedPartialAggregationInputRows",
+      RuntimeCounter(numAbandonedInputRows_));
+  abandonedPartialAggregation_ = false;
+  resumedPartialAggregation_ = true;
+  numAbandonedInputRows_ = 0;
+  numInputRows_ = 0;
+  numOutputRows_ = 0;
+}
+
 RowVectorPtr HashAggregation::getOutput() {
   if (finished_) {
     input_ = nullptr;
     return nullptr;
   }
+
+  if (!mergeInputs_.empty()) {
+    for (const auto& groups : mergeInputs_) {
+      groupingSet_->addPeerGroups(groups);
+    }
+    mergeInputs_.clear();
+  }
   if (abandonedPartialAggregation_) {
     if (noMoreInput_) {
       finished_ = true;
@@ -314,7 +493,9 @@ RowVectorPtr HashAggregation::getOutput() {
     prepareOutput(input_->size());
     groupingSet_->toIntermediate(input_, output_);
     numOutputRows_ += input_->size();
+    numAbandonedInputRows_ += input_->size();
     input_ = nullptr;
+    maybeResumePartialAggregation();
     return output_;
   }
 
@@ -377,6 +558,75 @@ void HashAggregation::noMoreInput() {
   groupingSet_->noMoreInput();
   recordSpillStats();
   Operator::noMoreInput();
+  // Every driver of a parallel merge must reach the barrier, including the
+  // ones without input.
+  if (parallelMerge_) {
+    finishParallelMerge();
+  }
+}
+
+void HashAggregation::finishParallelMerge() {
+  const auto* driverCtx = operatorCtx_->driverCtx();
+  const auto numDrivers =
+      operatorCtx_->task()->numDrivers(driverCtx->pipelineId);
+  // Use a few more hash bits than needed to number the drivers so that the
+  // partitions spread evenly over the drivers.
+  const auto startBit = driverCtx->queryConfig().spillStartPartitionBit();
+  uint8_t numBits = 3;
+  while ((1u << (numBits - 3)) < numDrivers) {
+    ++numBits;
+  }
+  const HashBitRange hashBits(
+      startBit, std::min<uint8_t>(64, startBit + numBits));
+  peerGroups_ = groupingSet_->takePeerGroups(
+      hashBits,
+      numDrivers,
+      driverCtx->driverId,
+      outputBatchRows(groupingSet_->estimateRowSize()));
+
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    VELOX_CHECK(future_.valid());
+    return;
+  }
+
+  auto promisesGuard = folly::makeGuard([&]() {
+    peers.clear();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  });
+
+  std::vector<HashAggregation*> aggregations{this};
+  for (auto& peer : peers) {
+    auto* peerAggregation =
+        dynamic_cast<HashAggregation*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(peerAggregation);
+    aggregations.push_back(peerAggregation);
+  }
+  VELOX_CHECK_EQ(aggregations.size(), numDrivers);
+
+  // The peers are waiting, so their groups can be handed out from here.
+  for (auto* source : aggregations) {
+    VELOX_CHECK_EQ(source->peerGroups_.size(), numDrivers);
+    for (auto* target : aggregations) {
+      const auto targetId = target->operatorCtx_->driverCtx()->driverId;
+      for (auto& groups : source->peerGroups_[targetId]) {
+        target->mergeInputs_.push_back(std::move(groups));
+      }
+    }
+    source->peerGroups_.clear();
+  }
+}
+
+BlockingReason HashAggregation::isBlocked(ContinueFuture* future) {
+  if (future_.valid()) {
+    *future = std::move(future_);
+    return BlockingReason::kWaitForProducer;
+  }
+  return BlockingReason::kNotBlocked;
 }
 
 bool HashAggregation::isFinished() {
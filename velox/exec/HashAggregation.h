@@ -20,12 +20,28 @@
 
 namespace facebook::velox::exec {
 
+/// Aggregates the input by the grouping keys in a hash table.
+///
+/// A final or single grouped aggregation normally relies on a local exchange
+/// on the grouping keys to run on multiple drivers. If
+/// QueryConfig::aggregationParallelMergeEnabled() is set, it runs on multiple
+/// drivers without one: at the end of input, each driver partitions its groups
+/// by the hash of the grouping keys, the drivers meet at a barrier and each
+/// driver merges the groups of its share of the partitions from all its peers
+/// into its own hash table before producing output.
+///
+/// A final or single grouped aggregation followed by 'filterNode' stops
+/// adding input to the groups which can no longer pass the filter, i.e. the
+/// groups failing a conjunct that bounds count(), max() or min() from the side
+/// to which the aggregate moves with more input, e.g. HAVING max(x) < 10. See
+/// QueryConfig::aggregationHavingPruningEnabled().
 class HashAggregation : public Operator {
  public:
   HashAggregation(
       int32_t operatorId,
       DriverCtx* driverCtx,
-      const std::shared_ptr<const core::AggregationNode>& aggregationNode);
+      const std::shared_ptr<const core::AggregationNode>& aggregationNode,
+      const std::shared_ptr<const core::FilterNode>& filterNode = nullptr);
 
   void addInput(RowVectorPtr input) override;
 
@@ -37,9 +53,7 @@ class HashAggregation : public Operator {
 
   void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
@@ -65,13 +79,27 @@ class HashAggregation : public Operator {
   // 'abandonPartialAggregationMinPct_' % of rows are unique.
   bool abandonPartialAggregationEarly(int64_t numOutput) const;
 
+  // Goes back to partial aggregation after 'resampleRows_' input rows have
+  // been passed through since it was abandoned. The partial aggregation is
+  // then checked again at the next flush.
+  void maybeResumePartialAggregation();
+
   // Invoked to record the spilling stats in operator stats after processing all
   // the inputs.
   void recordSpillStats();
 
+  // Invoked by every driver of a parallel merge after processing all the
+  // inputs. Takes the groups merged by the peers out of 'groupingSet_' and
+  // waits for the peers. The last driver to get here hands the taken groups
+  // to the drivers merging them and continues the other drivers.
+  void finishParallelMerge();
+
   const bool isPartialOutput_;
   const bool isDistinct_;
   const bool isGlobal_;
+  // True if this is a final or single aggregation merging the groups of its
+  // drivers in parallel.
+  const bool parallelMerge_;
   const int64_t maxExtendedPartialAggregationMemoryUsage_;
 
   int64_t maxPartialAggregationMemoryUsage_;
@@ -91,6 +119,21 @@ class HashAggregation : public Operator {
   // are unique, the partial aggregation is not worthwhile.
   const int32_t abandonPartialAggregationMinPct_;
 
+  // Number of input rows to pass through after abandoning partial aggregation
+  // before trying it again. 0 means partial aggregation stays abandoned.
+  const int64_t abandonPartialAggregationResampleRows_;
+
+  // Current number of rows to pass through before resuming. Doubles each time
+  // partial aggregation is abandoned again right after being resumed.
+  int64_t resampleRows_;
+
+  // Number of input rows passed through since partial aggregation was
+  // abandoned.
+  int64_t numAbandonedInputRows_{0};
+
+  // True if partial aggregation was resumed and has not been flushed since.
+  bool resumedPartialAggregation_{false};
+
   RowContainerIterator resultIterator_;
   bool pushdownChecked_ = false;
   bool mayPushdown_ = false;
@@ -104,6 +147,18 @@ class HashAggregation : public Operator {
 
   // Possibly reusable output vector.
   RowVectorPtr output_;
+
+  // The groups taken out of 'groupingSet_' for each peer driver of a parallel
+  // merge, indexed by driver id.
+  std::vector<std::vector<RowVectorPtr>> peerGroups_;
+
+  // The groups taken out by the peer drivers of a parallel merge for this
+  // driver to merge into 'groupingSet_' before producing output.
+  std::vector<RowVectorPtr> mergeInputs_;
+
+  // Set by a driver of a parallel merge that waits for the last peer to hand
+  // out the groups.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
 };
 
 } // namespace facebook::velox::exec
@@ -15,6 +15,9 @@
  */
 
 #include "velox/exec/HashBuild.h"
+
+#include <folly/json.h>
+
 #include "velox/common/testutil/TestValue.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
@@ -41,6 +44,125 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
       VELOX_UNREACHABLE(HashBuild::stateName(state));
   }
 }
+
+template <typename T>
+std::unique_ptr<common::Filter> makeBloomFilter(
+    BaseHashTable& table,
+    int32_t keyIndex) {
+  const auto column = table.rows()->columnAt(keyIndex);
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(table.numDistinct());
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  bool hasValues = false;
+  constexpr int32_t kBatchSize = 1'024;
+  std::vector<char*> rows(kBatchSize);
+  BaseHashTable::RowsIterator iter;
+  while (auto numRows = table.listAllRows(
+             &iter, kBatchSize, RowContainer::kUnlimited, rows.data())) {
+    for (auto i = 0; i < numRows; ++i) {
+      if (RowContainer::isNullAt(
+              rows[i], column.nullByte(), column.nullMask())) {
+        continue;
+      }
+      const int64_t value = RowContainer::valueAt<T>(rows[i], column.offset());
+      bloomFilter->insert(folly::hasher<int64_t>()(value));
+      min = std::min(min, value);
+      max = std::max(max, value);
+      hasValues = true;
+    }
+  }
+  if (!hasValues) {
+    return nullptr;
+  }
+  return std::make_unique<common::BigintValuesUsingBloomFilter>(
+      min, max, std::move(bloomFilter), false);
+}
+// Returns the partitions with the most data in 'spillableStats' which hold at
+// least 'targetRows' rows and 'targetBytes' bytes together.
+SpillPartitionNumSet selectPartitionsToSpill(
+    const std::vector<Spiller::SpillableStats>& spillableStats,
+    uint64_t targetRows,
+    uint64_t targetBytes) {
+  // Sort the partitions based on the amount of spillable data.
+  std::vector<int32_t> partitionIndices(spillableStats.size());
+  std::iota(partitionIndices.begin(), partitionIndices.end(), 0);
+  std::sort(
+      partitionIndices.begin(),
+      partitionIndices.end(),
+      [&](int32_t lhs, int32_t rhs) {
+        return spillableStats[lhs].numBytes > spillableStats[rhs].numBytes;
+      });
+  SpillPartitionNumSet partitionsToSpill;
+  uint64_t numRows = 0;
+  uint64_t numBytes = 0;
+  for (auto partitionNum : partitionIndices) {
+    if (spillableStats[partitionNum].numBytes == 0) {
+      break;
+    }
+    partitionsToSpill.insert(partitionNum);
+    numRows += spillableStats[partitionNum].numRows;
+    numBytes += spillableStats[partitionNum].numBytes;
+    if (numRows >= targetRows && numBytes >= targetBytes) {
+      break;
+    }
+  }
+  return partitionsToSpill;
+}
+
+// Removes the plan node ids of 'node' and its sources, which differ between
+// queries with the same plan.
+void removePlanNodeIds(folly::dynamic& node) {
+  node.erase("id");
+  if (auto* sources = node.get_ptr("sources")) {
+    for (auto& source : *sources) {
+      removePlanNodeIds(source);
+    }
+  }
+}
+
+// Returns the key of the hash table of 'joinNode' in HashTableCache. The key
+// is made of the build side plan, the join keys and filter and the
+// 'inputVersion' of the build side data. Returns an empty string if the build
+// side plan cannot be serialized.
+std::string makeHashTableCacheKey(
+    const core::HashJoinNode& joinNode,
+    const std::string& inputVersion,
+    uint64_t bloomFilterMaxSize) {
+  folly::dynamic obj;
+  try {
+    obj = joinNode.serialize();
+  } catch (const VeloxException&) {
+    return "";
+  }
+  // The probe side and the output do not change the table.
+  auto build = obj["sources"][1];
+  removePlanNodeIds(build);
+  obj.erase("id");
+  obj.erase("sources");
+  obj.erase("leftKeys");
+  obj.erase("outputType");
+  obj["build"] = std::move(build);
+  obj["inputVersion"] = inputVersion;
+  obj["bloomFilterMaxSize"] = bloomFilterMaxSize;
+  folly::json::serialization_opts opts;
+  opts.sort_keys = true;
+  return folly::json::serialize(obj, opts);
+}
+
+// Moves the partitions of 'from' into 'to'. The files of a partition in both
+// are merged.
+void addSpillPartitions(SpillPartitionSet& from, SpillPartitionSet& to) {
+  for (auto& [id, partition] : from) {
+    auto it = to.find(id);
+    if (it == to.end()) {
+      to.emplace(id, std::move(partition));
+    } else {
+      it->second->addFiles(std::move(*partition));
+    }
+  }
+  from.clear();
+}
 } // namespace
 
 HashBuild::HashBuild(
@@ -71,6 +193,8 @@ HashBuild::HashBuild(
       : nullptr;
 
   joinBridge_->addBuilder();
+  swapSides_ =
+      canSwapJoinSides(joinNode_, operatorCtx_->driverCtx()->queryConfig());
 
   auto outputType = joinNode_->sources()[1]->outputType();
 
@@ -91,11 +215,16 @@ HashBuild::HashBuild(
     types.emplace_back(outputType->childAt(channel));
   }
 
-  // Identify the non-key build side columns and make a decoder for each.
-  const auto numDependents = outputType->size() - numKeys;
+  // Identify the non-key build side columns and make a decoder for each. Left
+  // semi and anti joins without a filter only check whether a key is in the
+  // table, so that their table has just the distinct keys.
+  const bool keysOnly = !joinNode_->filter() &&
+      (joinNode_->isLeftSemiFilterJoin() ||
+       joinNode_->isLeftSemiProjectJoin() || isAntiJoin(joinType_));
+  const auto numDependents = keysOnly ? 0 : outputType->size() - numKeys;
   dependentChannels_.reserve(numDependents);
   decoders_.reserve(numDependents);
-  for (auto i = 0; i < outputType->size(); ++i) {
+  for (auto i = 0; i < outputType->size() && !keysOnly; ++i) {
     if (keyChannelMap.find(i) == keyChannelMap.end()) {
       dependentChannels_.emplace_back(i);
       decoders_.emplace_back(std::make_unique<DecodedVector>());
@@ -105,6 +234,7 @@ HashBuild::HashBuild(
   }
 
   tableType_ = ROW(std::move(names), std::move(types));
+  setupCachedTable();
   setupTable();
   setupSpiller();
 
@@ -113,9 +243,40 @@ HashBuild::HashBuild(
   }
 }
 
+void HashBuild::setupCachedTable() {
+  if (HashTableCache::instance() == nullptr || spillEnabled()) {
+    return;
+  }
+  // The tables of right and full joins and right semi joins are updated by
+  // the probe to flag the probed rows.
+  if (joinNode_->isRightJoin() || joinNode_->isFullJoin() ||
+      joinNode_->isRightSemiFilterJoin() ||
+      joinNode_->isRightSemiProjectJoin()) {
+    return;
+  }
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  const auto inputVersion = queryConfig.hashTableCacheInputVersion();
+  if (inputVersion.empty()) {
+    return;
+  }
+  cacheKey_ = makeHashTableCacheKey(
+      *joinNode_,
+      inputVersion,
+      queryConfig.hashProbeBloomFilterPushdownMaxSize());
+  if (cacheKey_.empty()) {
+    return;
+  }
+  cachedTable_ = joinBridge_->cachedTable(cacheKey_);
+}
+
 void HashBuild::setupTable() {
   VELOX_CHECK_NULL(table_);
 
+  // The table goes to the pool of the cache entry if it is to be cached.
+  auto* tablePool = cachedTable_ != nullptr && !hasCachedTable()
+      ? cachedTable_->pool.get()
+      : pool();
+
   const auto numKeys = keyChannels_.size();
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
   keyHashers.reserve(numKeys);
@@ -138,7 +299,7 @@ void HashBuild::setupTable() {
         dependentTypes,
         true, // allowDuplicates
         true, // hasProbedFlag
-        pool());
+        tablePool);
   } else {
     // (Left) semi and anti join with no extra filter only needs to know whether
     // there is a match. Hence, no need to store entries with duplicate keys.
@@ -155,7 +316,7 @@ void HashBuild::setupTable() {
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          tablePool);
     } else {
       // Ignore null keys
       table_ = HashTable<true>::createForJoin(
@@ -163,9 +324,13 @@ void HashBuild::setupTable() {
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          tablePool);
     }
   }
+  if (!spillEnabled()) {
+    // Rows are only erased when spilling.
+    table_->rows()->setAppendOnlyStrings();
+  }
   analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
 }
 
@@ -197,6 +362,18 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
         HashBitRange(startBit, startBit + spillConfig.hashBitRange.numBits());
   }
 
+  makeSpiller(std::move(hashBits));
+
+  const int32_t numPartitions = spiller_->hashBits().numPartitions();
+  spillInputIndicesBuffers_.resize(numPartitions);
+  rawSpillInputIndicesBuffers_.resize(numPartitions);
+  numSpillInputs_.resize(numPartitions, 0);
+  spillChildVectors_.resize(tableType_->size());
+}
+
+void HashBuild::makeSpiller(HashBitRange hashBits) {
+  VELOX_CHECK_NULL(spiller_);
+  const auto& spillConfig = spillConfig_.value();
   spiller_ = std::make_unique<Spiller>(
       Spiller::Type::kHashJoinBuild,
       table_->rows(),
@@ -209,13 +386,9 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
-
-  const int32_t numPartitions = spiller_->hashBits().numPartitions();
-  spillInputIndicesBuffers_.resize(numPartitions);
-  rawSpillInputIndicesBuffers_.resize(numPartitions);
-  numSpillInputs_.resize(numPartitions, 0);
-  spillChildVectors_.resize(tableType_->size());
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.readAheadDepth);
 }
 
 bool HashBuild::isInputFromSpill() const {
@@ -284,6 +457,16 @@ void HashBuild::removeInputRowsForAntiJoinFilter() {
 void HashBuild::addInput(RowVectorPtr input) {
   checkRunning();
 
+  restoreResidentPartitions();
+
+  if (swapSides_ && !swapped_) {
+    swapped_ = joinBridge_->addBuildInputBytes(input->estimateFlatSize());
+  }
+  if (swapped_) {
+    addSwappedInput(input);
+    return;
+  }
+
   if (!ensureInputFits(input)) {
     VELOX_CHECK_NOT_NULL(input_);
     VELOX_CHECK(future_.valid());
@@ -346,6 +529,30 @@ void HashBuild::addInput(RowVectorPtr input) {
     return;
   }
 
+  storeActiveRows();
+}
+
+void HashBuild::addSwappedInput(const RowVectorPtr& input) {
+  // The input is probed on the threads of the probe side. Loads it here and
+  // puts the columns in the order of 'tableType_'.
+  std::vector<VectorPtr> children;
+  children.reserve(tableType_->size());
+  for (auto channel : keyChannels_) {
+    children.push_back(BaseVector::loadedVectorShared(input->childAt(channel)));
+  }
+  for (auto channel : dependentChannels_) {
+    children.push_back(BaseVector::loadedVectorShared(input->childAt(channel)));
+  }
+  auto swappedInput = std::make_shared<RowVector>(
+      pool(), tableType_, nullptr, input->size(), std::move(children));
+  if (joinBridge_->addSwappedBuildInput(std::move(swappedInput), &future_)) {
+    VELOX_CHECK(future_.valid());
+    setState(State::kWaitForProbe);
+  }
+}
+
+void HashBuild::storeActiveRows() {
+  auto& hashers = table_->hashers();
   if (analyzeKeys_ && hashes_.size() < activeRows_.end()) {
     hashes_.resize(activeRows_.end());
   }
@@ -628,29 +835,8 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
     spiller->fillSpillRuns(spillableStats);
   }
 
-  // Sort the partitions based on the amount of spillable data.
-  SpillPartitionNumSet partitionsToSpill;
-  std::vector<int32_t> partitionIndices(spillableStats.size());
-  std::iota(partitionIndices.begin(), partitionIndices.end(), 0);
-  std::sort(
-      partitionIndices.begin(),
-      partitionIndices.end(),
-      [&](int32_t lhs, int32_t rhs) {
-        return spillableStats[lhs].numBytes > spillableStats[rhs].numBytes;
-      });
-  int64_t numRows = 0;
-  int64_t numBytes = 0;
-  for (auto partitionNum : partitionIndices) {
-    if (spillableStats[partitionNum].numBytes == 0) {
-      break;
-    }
-    partitionsToSpill.insert(partitionNum);
-    numRows += spillableStats[partitionNum].numRows;
-    numBytes += spillableStats[partitionNum].numBytes;
-    if (numRows >= targetRows && numBytes >= targetBytes) {
-      break;
-    }
-  }
+  const auto partitionsToSpill =
+      selectPartitionsToSpill(spillableStats, targetRows, targetBytes);
   VELOX_CHECK(!partitionsToSpill.empty());
 
   // TODO: consider to offload the partition spill processing to an executor to
@@ -673,6 +859,7 @@ void HashBuild::noMoreInput() {
   if (noMoreInput_) {
     return;
   }
+  restoreResidentPartitions();
   Operator::noMoreInput();
 
   noMoreInputInternal();
@@ -715,6 +902,18 @@ bool HashBuild::finishHashBuild() {
     }
   });
 
+  if (hasCachedTable()) {
+    addRuntimeStat("hashTableCacheHits", RuntimeCounter(1));
+    joinBridge_->setHashTable(
+        cachedTable_->table, {}, cachedTable_->hasNullKeys);
+    return true;
+  }
+
+  if (swapSides_ && joinBridge_->finishBuildInput()) {
+    finishSwappedBuild(peers);
+    return true;
+  }
+
   std::vector<std::unique_ptr<BaseHashTable>> otherTables;
   otherTables.reserve(peers.size());
   SpillPartitionSet spillPartitions;
@@ -738,6 +937,8 @@ bool HashBuild::finishHashBuild() {
         spillStats += build->spiller_->stats();
         build->spiller_->finishSpill(spillPartitions);
       }
+      spillStats += build->reclaimedSpillStats_;
+      addSpillPartitions(build->reclaimedSpillPartitions_, spillPartitions);
     }
 
     if (joinHasNullKeys_ && isAntiJoin(joinType_) && nullAware_ &&
@@ -746,16 +947,19 @@ bool HashBuild::finishHashBuild() {
     } else {
       if (spiller_ != nullptr) {
         spillStats += spiller_->stats();
+        spillStats += reclaimedSpillStats_;
 
         {
           auto lockedStats = stats_.wlock();
           lockedStats->spilledBytes += spillStats.spilledBytes;
+          lockedStats->spilledInputBytes += spillStats.spilledInputBytes;
           lockedStats->spilledRows += spillStats.spilledRows;
           lockedStats->spilledPartitions += spillStats.spilledPartitions;
           lockedStats->spilledFiles += spillStats.spilledFiles;
         }
 
         spiller_->finishSpill(spillPartitions);
+        addSpillPartitions(reclaimedSpillPartitions_, spillPartitions);
 
         // Verify all the spilled partitions are not empty as we won't spill on
         // an empty one.
@@ -773,11 +977,23 @@ bool HashBuild::finishHashBuild() {
           allowPrallelJoinBuild ? operatorCtx_->task()->queryCtx()->executor()
                                 : nullptr);
 
+      if (spillPartitions.empty()) {
+        makeBloomFilters();
+      }
+
       addRuntimeStats();
-      if (joinBridge_->setHashTable(
-              std::move(table_),
-              std::move(spillPartitions),
-              joinHasNullKeys_)) {
+      if (cachedTable_ != nullptr) {
+        VELOX_CHECK(spillPartitions.empty());
+        cachedTable_->table = std::move(table_);
+        cachedTable_->hasNullKeys = joinHasNullKeys_;
+        if (auto* cache = HashTableCache::instance()) {
+          cache->insert(cacheKey_, cachedTable_);
+        }
+        joinBridge_->setHashTable(cachedTable_->table, {}, joinHasNullKeys_);
+      } else if (joinBridge_->setHashTable(
+                     std::move(table_),
+                     std::move(spillPartitions),
+                     joinHasNullKeys_)) {
         spillGroup_->restart();
       }
     }
@@ -786,6 +1002,44 @@ bool HashBuild::finishHashBuild() {
   return true;
 }
 
+void HashBuild::finishSwappedBuild(
+    const std::vector<std::shared_ptr<Driver>>& peers) {
+  std::vector<std::unique_ptr<BaseHashTable>> tables;
+  tables.reserve(peers.size() + 1);
+  tables.push_back(std::move(table_));
+  for (auto& peer : peers) {
+    auto op = peer->findOperator(planNodeId());
+    HashBuild* build = dynamic_cast<HashBuild*>(op);
+    VELOX_CHECK(build);
+    tables.push_back(std::move(build->table_));
+  }
+
+  // The rows were stored before the swap, so that their size is bounded by the
+  // size of the probe side.
+  constexpr int32_t kBatchSize = 1'024;
+  std::vector<char*> rows(kBatchSize);
+  std::vector<RowVectorPtr> input;
+  for (auto& table : tables) {
+    BaseHashTable::RowsIterator iter;
+    for (;;) {
+      const auto numRows = table->listAllRows(
+          &iter, kBatchSize, RowContainer::kUnlimited, rows.data());
+      if (numRows == 0) {
+        break;
+      }
+      auto vector = BaseVector::create<RowVector>(tableType_, numRows, pool());
+      for (auto i = 0; i < tableType_->size(); ++i) {
+        table->rows()->extractColumn(
+            rows.data(), numRows, i, vector->childAt(i));
+      }
+      input.push_back(std::move(vector));
+    }
+    table.reset();
+  }
+  addRuntimeStat("swappedJoinSides", RuntimeCounter(1));
+  joinBridge_->finishSwappedBuildInput(std::move(input));
+}
+
 void HashBuild::postHashBuildProcess() {
   checkRunning();
 
@@ -846,6 +1100,106 @@ void HashBuild::processSpillInput() {
   noMoreInputInternal();
 }
 
+void HashBuild::restoreResidentPartitions() {
+  if (residentPartitions_.empty()) {
+    return;
+  }
+  VELOX_CHECK_NOT_NULL(spiller_);
+
+  // Prevents the memory arbitrator to reclaim memory from this operator while
+  // the spiller is being replaced.
+  NonReclaimableSection guard(this);
+
+  auto hashBits = spiller_->hashBits();
+  auto spilledPartitions = spiller_->spilledPartitionSet();
+  reclaimedSpillStats_ += spiller_->stats();
+  spiller_->finishSpill(reclaimedSpillPartitions_);
+  spiller_.reset();
+
+  for (auto partition : residentPartitions_) {
+    spilledPartitions.erase(partition);
+  }
+  makeSpiller(std::move(hashBits));
+  spiller_->setPartitionsSpilled(spilledPartitions);
+
+  int64_t numRestoredRows{0};
+  for (auto partition : residentPartitions_) {
+    auto it = reclaimedSpillPartitions_.find(
+        SpillPartitionId(spiller_->hashBits().begin(), partition));
+    if (it == reclaimedSpillPartitions_.end()) {
+      continue;
+    }
+    auto reader = it->second->createReader();
+    reclaimedSpillPartitions_.erase(it);
+    RowVectorPtr restored;
+    while (reader->nextBatch(restored)) {
+      addRestoredRows(restored);
+      numRestoredRows += restored->size();
+    }
+  }
+  residentPartitions_.clear();
+  addRuntimeStat("restoredResidentRows", RuntimeCounter(numRestoredRows));
+}
+
+void HashBuild::addRestoredRows(const RowVectorPtr& input) {
+  activeRows_.resize(input->size());
+  activeRows_.setAll();
+
+  auto& hashers = table_->hashers();
+  for (auto i = 0; i < hashers.size(); ++i) {
+    hashers[i]->decode(*input->childAt(i), activeRows_);
+  }
+  for (auto i = 0; i < decoders_.size(); ++i) {
+    decoders_[i]->decode(*input->childAt(i + hashers.size()), activeRows_);
+  }
+  storeActiveRows();
+}
+
+void HashBuild::makeBloomFilters() {
+  // Only the joins that HashProbe pushes dynamic filters for.
+  if (!isInnerJoin(joinType_) && !isLeftSemiFilterJoin(joinType_) &&
+      !isRightSemiFilterJoin(joinType_) && !isRightSemiProjectJoin(joinType_)) {
+    return;
+  }
+  const auto maxSize = operatorCtx_->driverCtx()
+                           ->queryConfig()
+                           .hashProbeBloomFilterPushdownMaxSize();
+  const auto numDistinct = table_->numDistinct();
+  // BloomFilter takes 2 bytes per entry, rounded up to a power of two.
+  if (numDistinct == 0 || 2 * bits::nextPowerOfTwo(numDistinct) > maxSize) {
+    return;
+  }
+  const auto& hashers = table_->hashers();
+  const bool isHashMode =
+      table_->hashMode() == BaseHashTable::HashMode::kHash;
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto& hasher = hashers[i];
+    // VectorHasher::getFilter() gives an exact filter unless the table is in
+    // hash mode or the key has too many distinct values.
+    if (!isHashMode && !hasher->distinctOverflow()) {
+      continue;
+    }
+    std::unique_ptr<common::Filter> filter;
+    switch (hasher->typeKind()) {
+      case TypeKind::TINYINT:
+        filter = makeBloomFilter<int8_t>(*table_, i);
+        break;
+      case TypeKind::SMALLINT:
+        filter = makeBloomFilter<int16_t>(*table_, i);
+        break;
+      case TypeKind::INTEGER:
+        filter = makeBloomFilter<int32_t>(*table_, i);
+        break;
+      case TypeKind::BIGINT:
+        filter = makeBloomFilter<int64_t>(*table_, i);
+        break;
+      default:
+        break;
+    }
+    hasher->setBloomFilter(std::move(filter));
+  }
+}
+
 void HashBuild::addRuntimeStats() {
   // Report range sizes and number of distinct values for the join keys.
   const auto& hashers = table_->hashers();
@@ -866,6 +1220,24 @@ void HashBuild::addRuntimeStats() {
     }
   }
 
+  // Report the hash mode chosen for the table and the number of distinct
+  // keys. The latter together with hashtable.numDistinct, which is the number
+  // of rows, shows how many rows the probe side gets per key match.
+  switch (table_->hashMode()) {
+    case BaseHashTable::HashMode::kArray:
+      lockedStats->addRuntimeStat("hashtable.arrayMode", RuntimeCounter(1));
+      break;
+    case BaseHashTable::HashMode::kNormalizedKey:
+      lockedStats->addRuntimeStat(
+          "hashtable.normalizedKeyMode", RuntimeCounter(1));
+      break;
+    case BaseHashTable::HashMode::kHash:
+      lockedStats->addRuntimeStat("hashtable.hashMode", RuntimeCounter(1));
+      break;
+  }
+  lockedStats->runtimeStats["hashtable.numDistinctKeys"] =
+      RuntimeMetric(table_->numDistinctJoinKeys());
+
   lockedStats->runtimeStats["hashtable.capacity"] =
       RuntimeMetric(hashTableStats.capacity);
   lockedStats->runtimeStats["hashtable.numRehashes"] =
@@ -891,6 +1263,9 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
     case State::kRunning:
       if (isInputFromSpill()) {
         processSpillInput();
+      } else if (hasCachedTable() && !noMoreInput_) {
+        // The build input is not needed.
+        noMoreInput();
       }
       break;
     case State::kFinish:
@@ -903,13 +1278,21 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
       }
       break;
     case State::kWaitForBuild:
-      FOLLY_FALLTHROUGH;
-    case State::kWaitForProbe:
       if (!future_.valid()) {
         setRunning();
         postHashBuildProcess();
       }
       break;
+    case State::kWaitForProbe:
+      if (!future_.valid()) {
+        setRunning();
+        // The sides are swapped and the probe side has consumed the input
+        // queued by addSwappedInput().
+        if (!swapped_) {
+          postHashBuildProcess();
+        }
+      }
+      break;
     default:
       VELOX_UNREACHABLE("Unexpected state: {}", stateName(state_));
       break;
@@ -946,7 +1329,7 @@ void HashBuild::checkStateTransition(State state) {
   VELOX_CHECK_NE(state_, state);
   switch (state) {
     case State::kRunning:
-      if (!spillEnabled()) {
+      if (!spillEnabled() && !swapped_) {
         VELOX_CHECK_EQ(state_, State::kWaitForBuild);
       } else {
         VELOX_CHECK_NE(state_, State::kFinish);
@@ -993,7 +1376,7 @@ bool HashBuild::testingTriggerSpill() {
       spillConfig()->testSpillPct;
 }
 
-void HashBuild::reclaim(uint64_t /*unused*/) {
+void HashBuild::reclaim(uint64_t targetBytes) {
   VELOX_CHECK(canReclaim());
   auto* driver = operatorCtx_->driver();
 
@@ -1032,15 +1415,39 @@ void HashBuild::reclaim(uint64_t /*unused*/) {
 
   std::vector<Spiller::SpillableStats> spillableStats;
   spillableStats.reserve(spiller_->hashBits().numPartitions());
-  // TODO: consider to parallelize this disk spilling processing.
   for (auto* op : operators) {
     HashBuild* buildOp = static_cast<HashBuild*>(op);
     buildOp->spiller_->fillSpillRuns(spillableStats);
-    // TODO: support fine-grain disk spilling based on 'targetBytes' after
-    // having row container memory compaction support later.
+  }
+
+  // All the rows are spilled to release the memory of the row containers as
+  // there is no row container memory compaction. In hybrid mode, the
+  // partitions which are not needed to free 'targetBytes' are read back into
+  // memory on the next input so that the probe side doesn't have to spill
+  // their rows.
+  SpillPartitionNumSet residentPartitions;
+  if (targetBytes > 0 &&
+      operatorCtx_->driverCtx()
+          ->queryConfig()
+          .joinSpillHybridReclaimEnabled()) {
+    const auto partitionsToSpill =
+        selectPartitionsToSpill(spillableStats, 0, targetBytes);
+    for (auto partition = 0; partition < spillableStats.size(); ++partition) {
+      if (!spiller_->isSpilled(partition) &&
+          partitionsToSpill.count(partition) == 0) {
+        residentPartitions.insert(partition);
+      }
+    }
+  }
+
+  // TODO: consider to parallelize this disk spilling processing.
+  for (auto* op : operators) {
+    HashBuild* buildOp = static_cast<HashBuild*>(op);
     buildOp->spiller_->spill();
     VELOX_CHECK_EQ(buildOp->table_->numDistinct(), 0);
     buildOp->table_->clear();
+    buildOp->residentPartitions_.insert(
+        residentPartitions.begin(), residentPartitions.end());
     // Release the minimum reserved memory.
     op->pool()->release();
   }
@@ -1052,6 +1459,7 @@ void HashBuild::close() {
   // Free up major memory usage.
   joinBridge_.reset();
   spiller_.reset();
+  reclaimedSpillPartitions_.clear();
   table_.reset();
 }
 } // namespace facebook::velox::exec
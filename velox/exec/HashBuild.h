@@ -77,6 +77,11 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
+  /// Spills all the build side rows of this and the peer operators. If
+  /// 'join_spill_hybrid_reclaim_enabled' is set, only the largest partitions
+  /// needed to free 'targetBytes' stay spilled and the rest are read back into
+  /// memory on the next input. This way the probe side spills only the rows
+  /// for the partitions which did not fit.
   void reclaim(uint64_t targetBytes) override;
 
   void close() override;
@@ -92,6 +97,25 @@ class HashBuild final : public Operator {
   // Invoked to set up hash table to build.
   void setupTable();
 
+  // Looks up the hash table of the join in HashTableCache if the query sets
+  // an input version and the table can be shared by queries.
+  void setupCachedTable();
+
+  // Returns true if the table of the join was found in HashTableCache.
+  bool hasCachedTable() const {
+    return cachedTable_ != nullptr && cachedTable_->table != nullptr;
+  }
+
+  // Forwards 'input' to the HashProbe operators after the join swapped the
+  // build and probe sides. Waits in 'kWaitForProbe' state if the HashProbe
+  // operators are behind.
+  void addSwappedInput(const RowVectorPtr& input);
+
+  // Invoked by the last driver instead of building the table if the join
+  // swapped sides. Forwards the rows stored by this and the peer operators
+  // before the swap.
+  void finishSwappedBuild(const std::vector<std::shared_ptr<Driver>>& peers);
+
   // Invoked when operator has finished processing the build input and wait for
   // all the other drivers to finish the processing. The last driver that
   // reaches to the hash build barrier, is responsible to build the hash table
@@ -116,6 +140,10 @@ class HashBuild final : public Operator {
     return spillConfig_.has_value() ? &spillConfig_.value() : nullptr;
   }
 
+  // Creates 'spiller_' to spill the rows of 'table_' partitioned by
+  // 'hashBits'.
+  void makeSpiller(HashBitRange hashBits);
+
   // Indicates if the input is read from spill data or not.
   bool isInputFromSpill() const;
 
@@ -212,6 +240,20 @@ class HashBuild final : public Operator {
   // Invoked to process data from spill input reader on restoring.
   void processSpillInput();
 
+  // Invoked on the first addInput() or noMoreInput() after a hybrid memory
+  // reclaim, see reclaim(). Reads the rows of 'residentPartitions_' back from
+  // disk into 'table_' and replaces 'spiller_' with one which has only the
+  // other partitions spilled. The files spilled so far for those partitions
+  // are kept in 'reclaimedSpillPartitions_'.
+  void restoreResidentPartitions();
+
+  // Adds the rows of 'input', which has 'tableType_', to 'table_'.
+  void addRestoredRows(const RowVectorPtr& input);
+
+  // Adds the selected rows in 'activeRows_' to 'table_'. The key and dependent
+  // columns are decoded by the hashers of 'table_' and 'decoders_'.
+  void storeActiveRows();
+
   // Set up for null-aware and regular anti-join with filter processing.
   void setupFilterForAntiJoins(
       const folly::F14FastMap<column_index_t, column_index_t>& keyChannelMap);
@@ -224,6 +266,12 @@ class HashBuild final : public Operator {
   // will be added to the joined output.
   void removeInputRowsForAntiJoinFilter();
 
+  // Makes Bloom filters over the integer join keys that have too many distinct
+  // values for an exact dynamic filter and sets them on the hashers of
+  // 'table_' for the probe side to push down. Invoked by the last build
+  // driver after the table is built.
+  void makeBloomFilters();
+
   void addRuntimeStats();
 
   // Invoked to check if it needs to trigger spilling for test purpose only.
@@ -237,8 +285,21 @@ class HashBuild final : public Operator {
 
   std::shared_ptr<HashJoinBridge> joinBridge_;
 
+  // The entry of the join in HashTableCache, nullptr if the table is not
+  // cached. If the table is not yet built, 'table_' is allocated from its
+  // pool so that the table can be added to the cache.
+  std::shared_ptr<CachedHashTable> cachedTable_;
+  std::string cacheKey_;
+
   std::shared_ptr<SpillOperatorGroup> spillGroup_;
 
+  // True if the join may swap the build and probe sides, see
+  // canSwapJoinSides().
+  bool swapSides_{false};
+
+  // True after the join swapped sides.
+  bool swapped_{false};
+
   State state_{State::kRunning};
 
   // The row type used for hash table build and disk spilling.
@@ -284,6 +345,15 @@ class HashBuild final : public Operator {
 
   std::unique_ptr<Spiller> spiller_;
 
+  // The partitions spilled by a hybrid memory reclaim only to free up memory
+  // right away. They are read back to stay in memory on the next input.
+  SpillPartitionNumSet residentPartitions_;
+
+  // The spill files and stats of the spillers replaced by
+  // restoreResidentPartitions().
+  SpillPartitionSet reclaimedSpillPartitions_;
+  Spiller::Stats reclaimedSpillStats_;
+
   // Used to read input from previously spilled data for restoring.
   std::unique_ptr<UnorderedStreamReader<BatchStream>> spillInputReader_;
 
@@ -18,14 +18,92 @@
 
 #include "velox/exec/HashJoinBridge.h"
 
+DEFINE_int64(
+    hash_table_cache_bytes,
+    0,
+    "Memory limit of the process wide cache of join hash tables used by the "
+    "queries which set hash_table_cache_input_version. 0 disables the cache");
+
 namespace facebook::velox::exec {
 namespace {
 bool isHashBuildMemoryPool(const memory::MemoryPool& pool) {
   static const std::string re(".*HashBuild");
   return RE2::FullMatch(pool.name(), re);
 }
+
+// The build side must be this many times larger than the probe side to swap
+// them.
+constexpr uint64_t kSwapSizeRatio = 2;
 } // namespace
 
+// static
+HashTableCache* HashTableCache::instance() {
+  if (FLAGS_hash_table_cache_bytes <= 0) {
+    return nullptr;
+  }
+  static auto* cache = new HashTableCache(FLAGS_hash_table_cache_bytes);
+  return cache;
+}
+
+std::shared_ptr<CachedHashTable> HashTableCache::find(const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->table;
+}
+
+void HashTableCache::insert(
+    const std::string& key,
+    std::shared_ptr<CachedHashTable> table) {
+  VELOX_CHECK_NOT_NULL(table->table);
+  const uint64_t bytes = table->pool->currentBytes();
+  if (bytes > maxBytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (entries_.count(key) != 0) {
+    return;
+  }
+  lru_.push_front(Entry{key, std::move(table), bytes});
+  entries_[key] = lru_.begin();
+  bytes_ += bytes;
+  evictLocked();
+}
+
+void HashTableCache::evictLocked() {
+  while (bytes_ > maxBytes_) {
+    VELOX_CHECK(!lru_.empty());
+    auto& entry = lru_.back();
+    bytes_ -= entry.bytes;
+    entries_.erase(entry.key);
+    lru_.pop_back();
+    ++numEvicts_;
+  }
+}
+
+void HashTableCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+HashTableCache::Stats HashTableCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numHits = numHits_;
+  stats.numMisses = numMisses_;
+  stats.numEvicts = numEvicts_;
+  stats.numEntries = entries_.size();
+  stats.bytes = bytes_;
+  return stats;
+}
+
 void HashJoinBridge::start() {
   std::lock_guard<std::mutex> l(mutex_);
   started_ = true;
@@ -38,8 +116,23 @@ void HashJoinBridge::addBuilder() {
   ++numBuilders_;
 }
 
+std::shared_ptr<CachedHashTable> HashJoinBridge::cachedTable(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cachedTable_ == nullptr) {
+    auto* cache = HashTableCache::instance();
+    VELOX_CHECK_NOT_NULL(cache);
+    cachedTable_ = cache->find(key);
+    if (cachedTable_ == nullptr) {
+      cachedTable_ = std::make_shared<CachedHashTable>();
+      cachedTable_->pool = memory::defaultMemoryManager().addLeafPool();
+    }
+  }
+  return cachedTable_;
+}
+
 bool HashJoinBridge::setHashTable(
-    std::unique_ptr<BaseHashTable> table,
+    std::shared_ptr<BaseHashTable> table,
     SpillPartitionSet spillPartitionSet,
     bool hasNullKeys) {
   VELOX_CHECK_NOT_NULL(table, "setHashTable called with null table");
@@ -73,6 +166,8 @@ bool HashJoinBridge::setHashTable(
         std::move(spillPartitionIdSet),
         hasNullKeys);
     restoringSpillPartitionId_.reset();
+    buildResult_->swapped = swapped_;
+    probeInput_.clear();
 
     hasSpillData = !spillPartitionSets_.empty();
     promises = std::move(promises_);
@@ -111,11 +206,176 @@ std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
   if (buildResult_.has_value()) {
     return buildResult_.value();
   }
+  if (swapped_ && !swappedTableClaimed_) {
+    swappedTableClaimed_ = true;
+    HashBuildResult result(nullptr, std::nullopt, {}, false);
+    result.swapped = true;
+    result.probeInput = std::move(probeInput_);
+    return result;
+  }
   promises_.emplace_back("HashJoinBridge::tableOrFuture");
   *future = promises_.back().getSemiFuture();
   return std::nullopt;
 }
 
+void HashJoinBridge::addProber() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!started_);
+  ++numProbers_;
+}
+
+void HashJoinBridge::setProbeInput(
+    std::vector<RowVectorPtr> input,
+    uint64_t bytes) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(started_);
+    VELOX_CHECK_LT(numFinishedProbers_, numProbers_);
+    ++numFinishedProbers_;
+    if (swapDisabled_ || buildInputFinished_) {
+      return;
+    }
+    probeInput_.reserve(probeInput_.size() + input.size());
+    for (auto& vector : input) {
+      probeInput_.push_back(std::move(vector));
+    }
+    probeBytes_ += bytes;
+    if (maybeSwapLocked()) {
+      promises = std::move(promises_);
+    }
+  }
+  notify(std::move(promises));
+}
+
+void HashJoinBridge::disableSwap() {
+  std::lock_guard<std::mutex> l(mutex_);
+  swapDisabled_ = true;
+  probeInput_.clear();
+}
+
+bool HashJoinBridge::addBuildInputBytes(uint64_t bytes) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (swapped_) {
+      return true;
+    }
+    buildBytes_ += bytes;
+    if (!maybeSwapLocked()) {
+      return false;
+    }
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+  return true;
+}
+
+bool HashJoinBridge::maybeSwapLocked() {
+  if (swapped_ || swapDisabled_ || buildInputFinished_ ||
+      numFinishedProbers_ < numProbers_) {
+    return false;
+  }
+  if (buildBytes_ <= kSwapSizeRatio * probeBytes_) {
+    return false;
+  }
+  swapped_ = true;
+  return true;
+}
+
+bool HashJoinBridge::finishBuildInput() {
+  std::lock_guard<std::mutex> l(mutex_);
+  buildInputFinished_ = true;
+  if (!swapped_) {
+    probeInput_.clear();
+  }
+  return swapped_;
+}
+
+bool HashJoinBridge::addSwappedBuildInput(
+    RowVectorPtr input,
+    ContinueFuture* future) {
+  std::vector<ContinuePromise> promises;
+  bool wait = false;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(swapped_);
+    VELOX_CHECK(!noMoreSwappedBuildInput_);
+    VELOX_CHECK(!cancelled_, "Adding build input after join is aborted");
+    if (numClosedProbers_ == numProbers_) {
+      return false;
+    }
+    swappedBuildInput_.push_back(std::move(input));
+    // Wakes up the waiting HashProbe operators to consume the input.
+    promises = std::move(promises_);
+    if (swappedBuildInput_.size() >= 2 * numProbers_) {
+      promises_.emplace_back("HashJoinBridge::addSwappedBuildInput");
+      *future = promises_.back().getSemiFuture();
+      wait = true;
+    }
+  }
+  notify(std::move(promises));
+  return wait;
+}
+
+void HashJoinBridge::finishSwappedBuildInput(std::vector<RowVectorPtr> input) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(swapped_);
+    VELOX_CHECK(!noMoreSwappedBuildInput_);
+    noMoreSwappedBuildInput_ = true;
+    if (numClosedProbers_ == numProbers_) {
+      return;
+    }
+    for (auto& vector : input) {
+      swappedBuildInput_.push_back(std::move(vector));
+    }
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+}
+
+std::optional<RowVectorPtr> HashJoinBridge::swappedBuildInputOrFuture(
+    ContinueFuture* future) {
+  std::vector<ContinuePromise> promises;
+  RowVectorPtr input;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(swapped_);
+    VELOX_CHECK(!cancelled_, "Getting build input after join is aborted");
+    if (swappedBuildInput_.empty()) {
+      if (noMoreSwappedBuildInput_) {
+        return nullptr;
+      }
+      promises_.emplace_back("HashJoinBridge::swappedBuildInputOrFuture");
+      *future = promises_.back().getSemiFuture();
+      return std::nullopt;
+    }
+    input = std::move(swappedBuildInput_.front());
+    swappedBuildInput_.pop_front();
+    // Wakes up the HashBuild operators waiting for the queue to drain.
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+  return input;
+}
+
+void HashJoinBridge::proberClosed() {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK_LT(numClosedProbers_, numProbers_);
+    if (++numClosedProbers_ < numProbers_) {
+      return;
+    }
+    swappedBuildInput_.clear();
+    // Wakes up the HashBuild operators waiting for the queue to drain.
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+}
+
 bool HashJoinBridge::probeFinished() {
   std::vector<ContinuePromise> promises;
   bool hasSpillInput = false;
@@ -179,20 +439,47 @@ bool isLeftNullAwareJoinWithFilter(
       joinNode->isNullAware() && (joinNode->filter() != nullptr);
 }
 
+bool canSwapJoinSides(
+    const std::shared_ptr<const core::HashJoinNode>& joinNode,
+    const core::QueryConfig& queryConfig) {
+  if (queryConfig.hashJoinSwapProbeBufferBytes() == 0 ||
+      !joinNode->isInnerJoin() || joinNode->filter() != nullptr ||
+      joinNode->canSpill(queryConfig)) {
+    return false;
+  }
+  // A cached table is cheaper than both sides.
+  return HashTableCache::instance() == nullptr ||
+      queryConfig.hashTableCacheInputVersion().empty();
+}
+
 uint64_t HashJoinMemoryReclaimer::reclaim(
     memory::MemoryPool* pool,
     uint64_t targetBytes) {
   uint64_t reclaimedBytes{0};
+  // Frees the output buffers of the blocked hash probe operators first as this
+  // is cheaper than spilling the hash build operators.
   pool->visitChildren(
       [&targetBytes, &reclaimedBytes](memory::MemoryPool* child) {
         VELOX_CHECK_EQ(child->kind(), memory::MemoryPool::Kind::kLeaf);
-        // The hash probe operator do not support memory reclaim.
+        if (isHashBuildMemoryPool(*child)) {
+          return true;
+        }
+        reclaimedBytes += child->reclaim(
+            targetBytes == 0 ? 0 : targetBytes - reclaimedBytes);
+        return targetBytes == 0 || reclaimedBytes < targetBytes;
+      });
+  if (targetBytes != 0 && reclaimedBytes >= targetBytes) {
+    return reclaimedBytes;
+  }
+  pool->visitChildren(
+      [&targetBytes, &reclaimedBytes](memory::MemoryPool* child) {
         if (!isHashBuildMemoryPool(*child)) {
           return true;
         }
         // We only need to reclaim from any one of the hash build operators
         // which will reclaim from all the peer hash build operators.
-        reclaimedBytes = child->reclaim(targetBytes);
+        reclaimedBytes += child->reclaim(
+            targetBytes == 0 ? 0 : targetBytes - reclaimedBytes);
         return false;
       });
   return reclaimedBytes;
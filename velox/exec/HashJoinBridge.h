@@ -15,12 +15,85 @@
  */
 #pragma once
 
+#include <deque>
+#include <list>
+
+#include <folly/container/F14Map.h>
+#include <gflags/gflags.h>
+
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Spill.h"
 
+DECLARE_int64(hash_table_cache_bytes);
+
 namespace facebook::velox::exec {
 
+/// A join hash table that can be reused by the queries with the same build
+/// side. The table is allocated from 'pool', which does not belong to any
+/// query, so that the table can outlive the query that built it.
+struct CachedHashTable {
+  std::shared_ptr<memory::MemoryPool> pool;
+  // Null until built.
+  std::shared_ptr<BaseHashTable> table;
+  bool hasNullKeys{false};
+};
+
+/// Process wide cache of join hash tables keyed by the build side plan and
+/// the version of its input data. The hash tables of the dimension tables of
+/// repeated star schema queries are this way built once per worker. The cache
+/// is bounded by the memory of the tables and evicts the least recently used
+/// entries first. An evicted table stays alive until the last query probing it
+/// finishes.
+class HashTableCache {
+ public:
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEvicts{0};
+    uint64_t numEntries{0};
+    uint64_t bytes{0};
+  };
+
+  explicit HashTableCache(uint64_t maxBytes) : maxBytes_(maxBytes) {}
+
+  /// Returns the process wide instance or nullptr if
+  /// FLAGS_hash_table_cache_bytes is 0.
+  static HashTableCache* instance();
+
+  /// Returns the table at 'key' or nullptr if not cached.
+  std::shared_ptr<CachedHashTable> find(const std::string& key);
+
+  /// Adds the built 'table' at 'key'. Keeps the earlier table if another query
+  /// added one first.
+  void insert(const std::string& key, std::shared_ptr<CachedHashTable> table);
+
+  void clear();
+
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<CachedHashTable> table;
+    uint64_t bytes;
+  };
+
+  // Evicts the least recently used entries until 'bytes_' is within
+  // 'maxBytes_'.
+  void evictLocked();
+
+  const uint64_t maxBytes_;
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> lru_;
+  folly::F14FastMap<std::string, std::list<Entry>::iterator> entries_;
+  uint64_t bytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+  uint64_t numEvicts_{0};
+};
+
 /// Hands over a hash table from a multi-threaded build pipeline to a
 /// multi-threaded probe pipeline. This is owned by shared_ptr by all the build
 /// and probe Operator instances concerned. Corresponds to the Presto concept of
@@ -34,17 +107,74 @@ class HashJoinBridge : public JoinBridge {
   /// HashBuild operators to parallelize the restoring operation.
   void addBuilder();
 
+  /// Invoked by the HashBuild operator ctors if the table can be cached at
+  /// 'key' in HashTableCache. The first call looks up the cache, so that all
+  /// the builders see the same result. The returned entry has the cached table
+  /// on a hit. On a miss, the builders allocate the table from its pool and
+  /// the last builder adds it to the cache.
+  std::shared_ptr<CachedHashTable> cachedTable(const std::string& key);
+
   /// 'spillPartitionSet' contains the spilled partitions while building
   /// 'table'. The function returns true if there is spill data to restore
   /// after HashProbe operators process 'table', otherwise false. This only
   /// applies if the disk spilling is enabled.
   bool setHashTable(
-      std::unique_ptr<BaseHashTable> table,
+      std::shared_ptr<BaseHashTable> table,
       SpillPartitionSet spillPartitionSet,
       bool hasNullKeys);
 
   void setAntiJoinHasNullKeys();
 
+  /// Invoked by the HashProbe operator ctors of a join which may swap the
+  /// build and probe sides, see canSwapJoinSides().
+  void addProber();
+
+  /// Invoked by a HashProbe operator at the end of its input if all of it was
+  /// buffered while the table was being built. 'input' is handed over as the
+  /// rows of the hash table if the sides are swapped.
+  void setProbeInput(std::vector<RowVectorPtr> input, uint64_t bytes);
+
+  /// Invoked by a HashProbe operator whose input does not fit in its buffer.
+  /// The sides are not swapped after this.
+  void disableSwap();
+
+  /// Invoked by the HashBuild operators with the size of each input of a join
+  /// which may swap sides. Returns true if the sides are swapped. The swap
+  /// happens once all the probe input is buffered and the build input is more
+  /// than twice as large. The HashBuild operators then forward the input with
+  /// addSwappedBuildInput() instead of adding it to their tables.
+  bool addBuildInputBytes(uint64_t bytes);
+
+  /// Invoked by the last HashBuild operator before it builds the table.
+  /// Returns true if the sides are swapped, otherwise the sides are not
+  /// swapped after this.
+  bool finishBuildInput();
+
+  /// Adds 'input' to the build input to stream through the table of the
+  /// swapped sides. 'input' has the columns of the build side table type, i.e.
+  /// the keys first. Returns true and sets 'future' if the caller must wait for
+  /// the HashProbe operators to consume the queued input.
+  bool addSwappedBuildInput(
+      RowVectorPtr input,
+      ContinueFuture* FOLLY_NONNULL future);
+
+  /// Invoked by the last HashBuild operator after the swap with the rows
+  /// stored in the tables of all HashBuild operators before the swap. These
+  /// are bounded by the size of the probe side. Marks the end of the build
+  /// input.
+  void finishSwappedBuildInput(std::vector<RowVectorPtr> input);
+
+  /// Invoked by the HashProbe operators of swapped sides to get the next build
+  /// input to probe the table with. Returns nullptr at the end of the build
+  /// input. If there is no input yet, 'future' is set to wait.
+  std::optional<RowVectorPtr> swappedBuildInputOrFuture(
+      ContinueFuture* FOLLY_NONNULL future);
+
+  /// Invoked by the HashProbe operators of a join which may swap sides when
+  /// they close. The build input of the swapped sides is dropped once all of
+  /// them are closed, e.g. if a limit downstream needs no more output.
+  void proberClosed();
+
   /// Represents the result of HashBuild operators: a hash table, an optional
   /// restored spill partition id associated with the table, and the spilled
   /// partitions while building the table if not empty. In case of an anti join,
@@ -68,12 +198,20 @@ class HashJoinBridge : public JoinBridge {
     std::shared_ptr<BaseHashTable> table;
     std::optional<SpillPartitionId> restoredPartitionId;
     SpillPartitionIdSet spillPartitionIds;
+    // True if the build and probe sides are swapped. 'table' is then made by
+    // the HashProbe operators from the probe input.
+    bool swapped{false};
+    // Set for the one HashProbe operator which makes the table of the swapped
+    // sides from this input and then sets it with setHashTable().
+    std::vector<RowVectorPtr> probeInput;
   };
 
   /// Invoked by HashProbe operator to get the table to probe which is built by
   /// HashBuild operators. If HashProbe operator calls this early, 'future' will
   /// be set to wait asynchronously, otherwise the built table along with
   /// optional spilling related information will be returned in HashBuildResult.
+  /// If the sides are swapped, the first caller gets the probe input to make
+  /// the table from and the others wait for the table.
   std::optional<HashBuildResult> tableOrFuture(
       ContinueFuture* FOLLY_NONNULL future);
 
@@ -107,6 +245,31 @@ class HashJoinBridge : public JoinBridge {
  private:
   uint32_t numBuilders_{0};
 
+  // Set by the first cachedTable() call.
+  std::shared_ptr<CachedHashTable> cachedTable_;
+
+  // Sets 'swapped_' if all the probe input is buffered and the build input is
+  // large enough to swap the sides. Returns true if the sides were swapped.
+  bool maybeSwapLocked();
+
+  // The state of swapping the build and probe sides. 'numProbers_' is 0 if the
+  // join can't swap the sides.
+  uint32_t numProbers_{0};
+  uint32_t numFinishedProbers_{0};
+  uint32_t numClosedProbers_{0};
+  bool swapDisabled_{false};
+  bool buildInputFinished_{false};
+  bool swapped_{false};
+  // True after the probe input is handed to the HashProbe operator which makes
+  // the table of the swapped sides.
+  bool swappedTableClaimed_{false};
+  uint64_t probeBytes_{0};
+  uint64_t buildBytes_{0};
+  std::vector<RowVectorPtr> probeInput_;
+  // The build input to stream through the table of the swapped sides.
+  std::deque<RowVectorPtr> swappedBuildInput_;
+  bool noMoreSwappedBuildInput_{false};
+
   std::optional<HashBuildResult> buildResult_;
 
   // restoringSpillPartitionXxx member variables are populated by the
@@ -135,6 +298,16 @@ class HashJoinBridge : public JoinBridge {
 bool isLeftNullAwareJoinWithFilter(
     const std::shared_ptr<const core::HashJoinNode>& joinNode);
 
+/// Returns true if the HashBuild and HashProbe operators of 'joinNode' may swap
+/// sides at runtime, see QueryConfig::kHashJoinSwapProbeBufferBytes. This only
+/// applies to inner joins without a filter which neither spill nor cache the
+/// hash table.
+bool canSwapJoinSides(
+    const std::shared_ptr<const core::HashJoinNode>& joinNode,
+    const core::QueryConfig& queryConfig);
+
+/// The memory reclaimer of a hash join node. It frees the output buffers of the
+/// blocked hash probe operators before spilling the hash build operators.
 class HashJoinMemoryReclaimer final : public memory::MemoryReclaimer {
  public:
   static std::unique_ptr<memory::MemoryReclaimer> create() {
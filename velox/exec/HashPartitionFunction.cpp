@@ -17,13 +17,45 @@
 #include <velox/exec/VectorHasher.h>
 
 namespace facebook::velox::exec {
+// static
+std::string HashPartitionFunction::skewModeName(SkewMode mode) {
+  switch (mode) {
+    case SkewMode::kNone:
+      return "NONE";
+    case SkewMode::kSpread:
+      return "SPREAD";
+    case SkewMode::kReplicate:
+      return "REPLICATE";
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+// static
+HashPartitionFunction::SkewMode HashPartitionFunction::skewModeFromName(
+    const std::string& name) {
+  if (name == "NONE") {
+    return SkewMode::kNone;
+  }
+  if (name == "SPREAD") {
+    return SkewMode::kSpread;
+  }
+  if (name == "REPLICATE") {
+    return SkewMode::kReplicate;
+  }
+  VELOX_FAIL("Unknown skew mode: {}", name);
+}
+
 HashPartitionFunction::HashPartitionFunction(
     int numPartitions,
     const RowTypePtr& inputType,
     const std::vector<column_index_t>& keyChannels,
-    const std::vector<VectorPtr>& constValues)
-    : numPartitions_{numPartitions} {
+    const std::vector<VectorPtr>& constValues,
+    SkewMode skewMode,
+    const std::vector<VectorPtr>& skewedKeys)
+    : numPartitions_{numPartitions}, skewMode_{skewMode} {
   init(inputType, keyChannels, constValues);
+  initSkewedKeys(skewedKeys);
 }
 
 HashPartitionFunction::HashPartitionFunction(
@@ -54,6 +86,46 @@ void HashPartitionFunction::init(
   }
 }
 
+void HashPartitionFunction::initSkewedKeys(
+    const std::vector<VectorPtr>& skewedKeys) {
+  if (skewMode_ == SkewMode::kNone || skewedKeys.empty()) {
+    return;
+  }
+  VELOX_USER_CHECK_EQ(
+      skewedKeys.size(),
+      hashers_.size(),
+      "Skewed keys must have one vector per partition key");
+  const auto numKeys = skewedKeys[0]->size();
+  SelectivityVector rows(numKeys);
+  raw_vector<uint64_t> hashes(numKeys);
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    VELOX_USER_CHECK_NE(
+        hashers_[i]->channel(),
+        kConstantChannel,
+        "Skewed keys are not supported with constant partition keys");
+    VELOX_USER_CHECK_EQ(skewedKeys[i]->size(), numKeys);
+    hashers_[i]->decode(*skewedKeys[i], rows);
+    hashers_[i]->hash(rows, i > 0, hashes);
+  }
+  skewedHashes_.insert(hashes.begin(), hashes.end());
+}
+
+void HashPartitionFunction::partitionSkewedRows(
+    vector_size_t size,
+    std::vector<uint32_t>& partitions) {
+  for (auto i = 0; i < size; ++i) {
+    if (skewedHashes_.count(hashes_[i]) == 0) {
+      continue;
+    }
+    if (skewMode_ == SkewMode::kSpread) {
+      partitions[i] = spreadCounter_ % numPartitions_;
+      ++spreadCounter_;
+    } else {
+      partitions[i] = kAllPartitions;
+    }
+  }
+}
+
 void HashPartitionFunction::partition(
     const RowVector& input,
     std::vector<uint32_t>& partitions) {
@@ -83,12 +155,21 @@ void HashPartitionFunction::partition(
       partitions[i] = hashes_[i] % numPartitions_;
     }
   }
+
+  if (!skewedHashes_.empty()) {
+    partitionSkewedRows(size, partitions);
+  }
 }
 
 std::unique_ptr<core::PartitionFunction> HashPartitionFunctionSpec::create(
     int numPartitions) const {
   return std::make_unique<exec::HashPartitionFunction>(
-      numPartitions, inputType_, keyChannels_, constValues_);
+      numPartitions,
+      inputType_,
+      keyChannels_,
+      constValues_,
+      skewMode_,
+      skewedKeys_);
 }
 
 std::string HashPartitionFunctionSpec::toString() const {
@@ -106,7 +187,14 @@ std::string HashPartitionFunctionSpec::toString() const {
     }
   }
 
-  return fmt::format("HASH({})", keys.str());
+  if (skewMode_ == HashPartitionFunction::SkewMode::kNone) {
+    return fmt::format("HASH({})", keys.str());
+  }
+  return fmt::format(
+      "HASH({}) {}({} skewed keys)",
+      keys.str(),
+      HashPartitionFunction::skewModeName(skewMode_),
+      skewedKeys_.empty() ? 0 : skewedKeys_[0]->size());
 }
 
 folly::dynamic HashPartitionFunctionSpec::serialize() const {
@@ -121,6 +209,18 @@ folly::dynamic HashPartitionFunctionSpec::serialize() const {
     constValues.emplace_back(value);
   }
   obj["constants"] = ISerializable::serialize(constValues);
+  obj["skewMode"] = HashPartitionFunction::skewModeName(skewMode_);
+  // Each skewed key vector is serialized as a list of single value constants.
+  folly::dynamic skewedKeys = folly::dynamic::array;
+  for (const auto& skewedKey : skewedKeys_) {
+    std::vector<velox::core::ConstantTypedExpr> values;
+    values.reserve(skewedKey->size());
+    for (auto i = 0; i < skewedKey->size(); ++i) {
+      values.emplace_back(BaseVector::wrapInConstant(1, i, skewedKey));
+    }
+    skewedKeys.push_back(ISerializable::serialize(values));
+  }
+  obj["skewedKeys"] = std::move(skewedKeys);
   return obj;
 }
 
@@ -140,7 +240,29 @@ core::PartitionFunctionSpecPtr HashPartitionFunctionSpec::deserialize(
   for (const auto& value : constTypeExprs) {
     constValues.emplace_back(value->toConstantVector(pool));
   }
+
+  auto skewMode = HashPartitionFunction::SkewMode::kNone;
+  std::vector<VectorPtr> skewedKeys;
+  if (obj.count("skewMode")) {
+    skewMode =
+        HashPartitionFunction::skewModeFromName(obj["skewMode"].asString());
+    for (const auto& keysObj : obj["skewedKeys"]) {
+      const auto values = ISerializable::deserialize<
+          std::vector<velox::core::ConstantTypedExpr>>(keysObj, context);
+      VELOX_CHECK(!values.empty());
+      auto skewedKey =
+          BaseVector::create(values[0]->type(), values.size(), pool);
+      for (auto i = 0; i < values.size(); ++i) {
+        skewedKey->copy(values[i]->toConstantVector(pool).get(), i, 0, 1);
+      }
+      skewedKeys.emplace_back(std::move(skewedKey));
+    }
+  }
   return std::make_shared<HashPartitionFunctionSpec>(
-      ISerializable::deserialize<RowType>(obj["inputType"]), keys, constValues);
+      ISerializable::deserialize<RowType>(obj["inputType"]),
+      keys,
+      constValues,
+      skewMode,
+      std::move(skewedKeys));
 }
 } // namespace facebook::velox::exec
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/container/F14Set.h>
+
 #include <velox/exec/HashBitRange.h>
 #include <velox/exec/VectorHasher.h>
 #include "velox/core/PlanNode.h"
@@ -23,11 +25,37 @@ namespace facebook::velox::exec {
 
 class HashPartitionFunction : public core::PartitionFunction {
  public:
+  /// Specifies how the rows with a skewed key are partitioned. Hash
+  /// partitioning sends all rows of a key to one partition, so a few hot keys
+  /// can overload a single consumer. For a join, the probe side can spread the
+  /// rows of the hot keys over all partitions if the build side replicates
+  /// the rows of the same keys to every partition. This is correct only for
+  /// joins that do not produce unmatched build side rows, i.e. inner, left,
+  /// semi and anti joins.
+  enum class SkewMode {
+    /// Rows with a skewed key are hash partitioned like all other rows.
+    kNone,
+    /// Rows with a skewed key are assigned to partitions round-robin.
+    kSpread,
+    /// Rows with a skewed key are assigned to kAllPartitions.
+    kReplicate,
+  };
+
+  static std::string skewModeName(SkewMode mode);
+
+  static SkewMode skewModeFromName(const std::string& name);
+
+  /// 'skewedKeys' has one vector per key channel. The values at the same row
+  /// of these vectors form one skewed key. Rows are matched against the
+  /// skewed keys by hash, which is consistent between the two sides of a join
+  /// because both use the same hash function.
   HashPartitionFunction(
       int numPartitions,
       const RowTypePtr& inputType,
       const std::vector<column_index_t>& keyChannels,
-      const std::vector<VectorPtr>& constValues = {});
+      const std::vector<VectorPtr>& constValues = {},
+      SkewMode skewMode = SkewMode::kNone,
+      const std::vector<VectorPtr>& skewedKeys = {});
 
   HashPartitionFunction(
       const HashBitRange& hashBitRange,
@@ -50,10 +78,26 @@ class HashPartitionFunction : public core::PartitionFunction {
       const std::vector<column_index_t>& keyChannels,
       const std::vector<VectorPtr>& constValues);
 
+  // Computes 'skewedHashes_' from 'skewedKeys'.
+  void initSkewedKeys(const std::vector<VectorPtr>& skewedKeys);
+
+  // Reassigns the rows whose hash is in 'skewedHashes_' according to
+  // 'skewMode_'.
+  void partitionSkewedRows(
+      vector_size_t size,
+      std::vector<uint32_t>& partitions);
+
   const int numPartitions_;
   const std::optional<HashBitRange> hashBitRange_ = std::nullopt;
+  const SkewMode skewMode_{SkewMode::kNone};
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
 
+  // Hashes of the skewed keys.
+  folly::F14FastSet<uint64_t> skewedHashes_;
+
+  // Next partition for a row with a skewed key in kSpread mode.
+  uint32_t spreadCounter_{0};
+
   // Reusable memory.
   SelectivityVector rows_;
   raw_vector<uint64_t> hashes_;
@@ -64,15 +108,22 @@ class HashPartitionFunction : public core::PartitionFunction {
 /// constant, use index 'kConstantChannel' to indicate so and store the constant
 /// value as a base vector in 'constValues'
 /// The 'constValues' size is less than or equal to 'keyChannels' size
+/// 'skewMode' and 'skewedKeys' specify the handling of hot keys, see
+/// HashPartitionFunction::SkewMode.
 class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
  public:
   HashPartitionFunctionSpec(
       RowTypePtr inputType,
       std::vector<column_index_t> keyChannels,
-      std::vector<VectorPtr> constValues = {})
+      std::vector<VectorPtr> constValues = {},
+      HashPartitionFunction::SkewMode skewMode =
+          HashPartitionFunction::SkewMode::kNone,
+      std::vector<VectorPtr> skewedKeys = {})
       : inputType_{std::move(inputType)},
         keyChannels_{std::move(keyChannels)},
-        constValues_{std::move(constValues)} {}
+        constValues_{std::move(constValues)},
+        skewMode_{skewMode},
+        skewedKeys_{std::move(skewedKeys)} {}
 
   std::unique_ptr<core::PartitionFunction> create(
       int numPartitions) const override;
@@ -89,5 +140,7 @@ class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
   const RowTypePtr inputType_;
   const std::vector<column_index_t> keyChannels_;
   const std::vector<VectorPtr> constValues_;
+  const HashPartitionFunction::SkewMode skewMode_;
+  const std::vector<VectorPtr> skewedKeys_;
 };
 } // namespace facebook::velox::exec
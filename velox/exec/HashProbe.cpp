@@ -15,10 +15,13 @@
  */
 
 #include "velox/exec/HashProbe.h"
+#include "velox/common/testutil/TestValue.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/FieldReference.h"
 
+using facebook::velox::common::testutil::TestValue;
+
 namespace facebook::velox::exec {
 
 namespace {
@@ -168,6 +171,26 @@ HashProbe::HashProbe(
   if (nullAware_) {
     filterTableResult_.resize(1);
   }
+
+  swapSides_ = canSwapJoinSides(joinNode_, driverCtx->queryConfig());
+  if (swapSides_) {
+    joinBridge_->addProber();
+    probeBufferMaxBytes_ =
+        driverCtx->queryConfig().hashJoinSwapProbeBufferBytes();
+    bufferProbeInput_ = true;
+    for (auto i = 0; i < numKeys; ++i) {
+      swappedHashers_.emplace_back(
+          VectorHasher::create(tableType->childAt(i), i));
+    }
+    auto swappedTableType =
+        makeTableType(probeType_.get(), joinNode_->leftKeys());
+    for (const auto& projection : identityProjections_) {
+      swappedTableProjections_.emplace_back(
+          swappedTableType->getChildIdx(
+              probeType_->nameOf(projection.inputChannel)),
+          projection.outputChannel);
+    }
+  }
 }
 
 void HashProbe::initializeFilter(
@@ -247,7 +270,9 @@ void HashProbe::maybeSetupSpillInput(
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.readAheadDepth);
   // Set the spill partitions to the corresponding ones at the build side. The
   // hash probe operator itself won't trigger any spilling.
   spiller_->setPartitionsSpilled(toPartitionNumSet(spillInputPartitionIds_));
@@ -270,6 +295,12 @@ void HashProbe::asyncWaitForHashTable() {
     return;
   }
 
+  bufferProbeInput_ = false;
+  if (hashBuildResult->swapped) {
+    setupSwappedTable(std::move(hashBuildResult.value()));
+    return;
+  }
+
   if (hashBuildResult->hasNullKeys) {
     VELOX_CHECK(nullAware_);
     if (isAntiJoin(joinType_) && !joinNode_->filter()) {
@@ -292,14 +323,14 @@ void HashProbe::asyncWaitForHashTable() {
   if (table_->numDistinct() == 0) {
     if (skipProbeOnEmptyBuild()) {
       if (!needSpillInput()) {
+        probeBuffer_.clear();
         noMoreInput();
       }
     }
   } else if (
       (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
        isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
-      !hasMoreSpillData()) {
+      !isSpillInput() && !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept
     // dynamic filters on all or a subset of the join keys. Create dynamic
     // filters to push down.
@@ -308,12 +339,25 @@ void HashProbe::asyncWaitForHashTable() {
     // probe input is read from spilled data and there is no upstream operators
     // involved; (2) if there is spill data to restore, then we can't filter
     // probe inputs solely based on the current table's join keys.
+    //
+    // The exact filters from the hashers are not available in hash mode. A
+    // Bloom filter made by the build side is pushed down instead if there is
+    // one.
     const auto& buildHashers = table_->hashers();
+    const bool isHashMode =
+        table_->hashMode() == BaseHashTable::HashMode::kHash;
     auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
         this, keyChannels_);
     for (auto i = 0; i < keyChannels_.size(); i++) {
       if (channels.find(keyChannels_[i]) != channels.end()) {
-        if (auto filter = buildHashers[i]->getFilter(false)) {
+        std::unique_ptr<common::Filter> filter;
+        if (!isHashMode) {
+          filter = buildHashers[i]->getFilter(false);
+        }
+        if (!filter && buildHashers[i]->bloomFilter()) {
+          filter = buildHashers[i]->bloomFilter()->clone();
+        }
+        if (filter) {
           dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
         }
       }
@@ -321,6 +365,211 @@ void HashProbe::asyncWaitForHashTable() {
   }
 }
 
+void HashProbe::bufferInput(RowVectorPtr input) {
+  // The buffered input may be read on the thread of another operator which
+  // makes the table of the swapped sides.
+  std::vector<VectorPtr> children;
+  children.reserve(input->childrenSize());
+  for (auto& child : input->children()) {
+    children.push_back(BaseVector::loadedVectorShared(child));
+  }
+  auto loaded = std::make_shared<RowVector>(
+      pool(),
+      input->type(),
+      input->nulls(),
+      input->size(),
+      std::move(children));
+  probeBufferBytes_ += loaded->estimateFlatSize();
+  probeBuffer_.push_back(std::move(loaded));
+  if (probeBufferBytes_ > probeBufferMaxBytes_) {
+    // The probe side is too large to swap with the build side.
+    bufferProbeInput_ = false;
+    joinBridge_->disableSwap();
+  }
+}
+
+void HashProbe::setupSwappedTable(HashJoinBridge::HashBuildResult result) {
+  swapped_ = true;
+  probeBuffer_.clear();
+  probeBufferBytes_ = 0;
+  if (result.table == nullptr) {
+    result.table = makeSwappedTable(result.probeInput);
+    result.probeInput.clear();
+    addRuntimeStat("swappedJoinSides", RuntimeCounter(1));
+    joinBridge_->setHashTable(result.table, {}, false);
+  }
+  table_ = std::move(result.table);
+  lookup_ = std::make_unique<HashLookup>(swappedHashers_);
+  nextSwappedInput();
+}
+
+std::shared_ptr<BaseHashTable> HashProbe::makeSwappedTable(
+    const std::vector<RowVectorPtr>& input) {
+  auto tableType = makeTableType(probeType_.get(), joinNode_->leftKeys());
+  const auto numKeys = keyChannels_.size();
+  std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+  keyHashers.reserve(numKeys);
+  for (auto i = 0; i < numKeys; ++i) {
+    keyHashers.emplace_back(
+        VectorHasher::create(tableType->childAt(i), keyChannels_[i]));
+  }
+  std::vector<TypePtr> dependentTypes;
+  std::vector<column_index_t> dependentChannels;
+  for (auto i = numKeys; i < tableType->size(); ++i) {
+    dependentTypes.emplace_back(tableType->childAt(i));
+    dependentChannels.emplace_back(
+        probeType_->getChildIdx(tableType->nameOf(i)));
+  }
+  std::shared_ptr<BaseHashTable> table = HashTable<true>::createForJoin(
+      std::move(keyHashers),
+      dependentTypes,
+      true, // allowDuplicates
+      false, // hasProbedFlag
+      pool());
+
+  // Stores the rows the same way as HashBuild.
+  auto& hashers = table->hashers();
+  auto* rows = table->rows();
+  const auto nextOffset = rows->nextOffset();
+  bool analyzeKeys = table->hashMode() != BaseHashTable::HashMode::kHash;
+  std::vector<DecodedVector> decoders(dependentChannels.size());
+  SelectivityVector activeRows;
+  raw_vector<uint64_t> hashes;
+  for (const auto& vector : input) {
+    activeRows.resize(vector->size());
+    activeRows.setAll();
+    for (auto& hasher : hashers) {
+      hasher->decode(*vector->childAt(hasher->channel()), activeRows);
+    }
+    deselectRowsWithNulls(hashers, activeRows);
+    if (!activeRows.hasSelections()) {
+      continue;
+    }
+    for (auto i = 0; i < dependentChannels.size(); ++i) {
+      decoders[i].decode(*vector->childAt(dependentChannels[i]), activeRows);
+    }
+    if (analyzeKeys) {
+      hashes.resize(activeRows.end());
+      for (auto& hasher : hashers) {
+        if (analyzeKeys) {
+          hasher->computeValueIds(activeRows, hashes);
+          analyzeKeys = hasher->mayUseValueIds();
+        }
+      }
+    }
+    activeRows.applyToSelected([&](auto row) {
+      char* newRow = rows->newRow();
+      if (nextOffset) {
+        *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+      }
+      for (auto i = 0; i < numKeys; ++i) {
+        rows->store(hashers[i]->decodedVector(), row, newRow, i);
+      }
+      for (auto i = 0; i < decoders.size(); ++i) {
+        rows->store(decoders[i], row, newRow, i + numKeys);
+      }
+    });
+  }
+  table->prepareJoinTable({});
+  return table;
+}
+
+void HashProbe::nextSwappedInput() {
+  checkRunning();
+  if (input_ != nullptr || noMoreSwappedInput_) {
+    return;
+  }
+  if (table_->numDistinct() == 0) {
+    // An inner join with an empty probe side returns nothing.
+    noMoreSwappedInput_ = true;
+    return;
+  }
+  auto input = joinBridge_->swappedBuildInputOrFuture(&future_);
+  if (!input.has_value()) {
+    VELOX_CHECK(future_.valid());
+    setState(ProbeOperatorState::kWaitForBuild);
+    return;
+  }
+  if (input.value() == nullptr) {
+    noMoreSwappedInput_ = true;
+    return;
+  }
+  addSwappedInput(std::move(input.value()));
+}
+
+void HashProbe::addSwappedInput(RowVectorPtr input) {
+  input_ = std::move(input);
+  activeRows_.resize(input_->size());
+  activeRows_.setAll();
+  for (auto& hasher : swappedHashers_) {
+    hasher->decode(*input_->childAt(hasher->channel()), activeRows_);
+  }
+  deselectRowsWithNulls(swappedHashers_, activeRows_);
+
+  lookup_->hashes.resize(input_->size());
+  const auto mode = table_->hashMode();
+  auto& tableHashers = table_->hashers();
+  for (auto i = 0; i < swappedHashers_.size(); ++i) {
+    if (mode != BaseHashTable::HashMode::kHash) {
+      tableHashers[i]->lookupValueIds(
+          *input_->childAt(i), activeRows_, scratchMemory_, lookup_->hashes);
+    } else {
+      swappedHashers_[i]->hash(activeRows_, i > 0, lookup_->hashes);
+    }
+  }
+  lookup_->rows.clear();
+  activeRows_.applyToSelected([&](auto row) { lookup_->rows.push_back(row); });
+  if (lookup_->rows.empty()) {
+    input_ = nullptr;
+    return;
+  }
+  lookup_->hits.resize(lookup_->rows.back() + 1);
+  table_->joinProbe(*lookup_);
+  results_.reset(*lookup_);
+}
+
+RowVectorPtr HashProbe::getSwappedOutput() {
+  if (input_ == nullptr) {
+    if (noMoreSwappedInput_) {
+      setState(ProbeOperatorState::kFinish);
+    }
+    return nullptr;
+  }
+
+  auto mapping =
+      initializeRowNumberMapping(outputRowMapping_, outputBatchSize_, pool());
+  outputTableRows_.resize(outputBatchSize_);
+  const auto numOut = table_->listJoinResults(
+      results_,
+      false,
+      mapping,
+      folly::Range(outputTableRows_.data(), outputTableRows_.size()));
+  if (numOut == 0) {
+    input_ = nullptr;
+    return nullptr;
+  }
+
+  // The build side columns wrap 'input_'. Drops them first so that
+  // prepareOutput() only keeps the probe side columns for reuse.
+  if (output_ != nullptr && output_.unique()) {
+    for (const auto& projection : tableOutputProjections_) {
+      output_->childAt(projection.outputChannel) = nullptr;
+    }
+  }
+  prepareOutput(numOut);
+  for (const auto& projection : tableOutputProjections_) {
+    output_->childAt(projection.outputChannel) = wrapChild(
+        numOut, outputRowMapping_, input_->childAt(projection.inputChannel));
+  }
+  extractColumns(
+      table_.get(),
+      folly::Range<char**>(outputTableRows_.data(), numOut),
+      swappedTableProjections_,
+      pool(),
+      output_);
+  return output_;
+}
+
 bool HashProbe::isSpillInput() const {
   return spillInputReader_ != nullptr;
 }
@@ -436,16 +685,36 @@ void HashProbe::prepareInputIndicesBuffers(
 BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
   switch (state_) {
     case ProbeOperatorState::kWaitForBuild:
-      VELOX_CHECK_NULL(table_);
+      VELOX_CHECK(table_ == nullptr || swapped_);
+      if (future_.valid() && future_.isReady()) {
+        // The future is kept while buffering the input, see below.
+        future_ = ContinueFuture::makeEmpty();
+      }
       if (!future_.valid()) {
         setRunning();
-        asyncWaitForHashTable();
+        if (swapped_) {
+          nextSwappedInput();
+        } else {
+          asyncWaitForHashTable();
+          if (swapSides_ && !swapped_ && isRunning() && noMoreInput_ &&
+              !noMoreSpillInput_) {
+            // The input ended while it was buffered.
+            noMoreInputInternal();
+          }
+        }
       }
       break;
     case ProbeOperatorState::kRunning:
       VELOX_CHECK_NOT_NULL(table_);
-      if (spillInputReader_ != nullptr) {
+      if (swapped_) {
+        nextSwappedInput();
+      } else if (spillInputReader_ != nullptr) {
         addSpillInput();
+      } else if (input_ == nullptr && !probeBuffer_.empty()) {
+        // Probes the input buffered while the table was being built.
+        auto input = std::move(probeBuffer_.back());
+        probeBuffer_.pop_back();
+        addInput(std::move(input));
       }
       break;
     case ProbeOperatorState::kWaitForPeers:
@@ -463,6 +732,10 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
 
   if (future_.valid()) {
     VELOX_CHECK(!isRunning());
+    if (bufferProbeInput_) {
+      // Takes more input while the table is being built.
+      return BlockingReason::kNotBlocked;
+    }
     *future = std::move(future_);
   }
   return fromStateToBlockingReason(state_);
@@ -476,8 +749,11 @@ void HashProbe::clearDynamicFilters() {
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
   //  * build side has no dependent columns.
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      dynamicFilters_.begin()->second->kind() !=
+          common::FilterKind::kBigintValuesUsingBloomFilter) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -501,6 +777,11 @@ void HashProbe::decodeAndDetectNonNullKeys() {
 }
 
 void HashProbe::addInput(RowVectorPtr input) {
+  if (bufferProbeInput_) {
+    bufferInput(std::move(input));
+    return;
+  }
+
   input_ = std::move(input);
 
   if (input_->size() > 0) {
@@ -611,12 +892,15 @@ void HashProbe::prepareOutput(vector_size_t size) {
   // We expect output vectors containing probe-side data to be null (reset in
   // clearIdentityProjectedOutput). BaseVector::prepareForReuse keeps null
   // children unmodified and makes non-null (build side) children reusable.
-  if (output_) {
+  if (output_ && output_.unique()) {
     VectorPtr output = std::move(output_);
     BaseVector::prepareForReuse(output, size);
     output_ = std::static_pointer_cast<RowVector>(output);
   } else {
-    output_ = BaseVector::create<RowVector>(outputType_, size, pool());
+    // The previous output is still referenced downstream. Takes a vector
+    // recycled by the operators of the Driver.
+    output_ = std::static_pointer_cast<RowVector>(
+        operatorCtx_->execCtx()->getVector(outputType_, size));
   }
 }
 
@@ -825,11 +1109,15 @@ void HashProbe::checkStateTransition(ProbeOperatorState state) {
 }
 
 RowVectorPtr HashProbe::getOutput() {
-  if (isFinished()) {
+  if (isFinished() || (bufferProbeInput_ && !isRunning())) {
     return nullptr;
   }
   checkRunning();
 
+  if (swapped_) {
+    return getSwappedOutput();
+  }
+
   clearIdentityProjectedOutput();
   if (!input_) {
     if (!hasMoreInput()) {
@@ -884,6 +1172,16 @@ RowVectorPtr HashProbe::getOutput() {
       std::iota(mapping.begin(), mapping.end(), 0);
       std::fill(outputTableRows_.begin(), outputTableRows_.end(), nullptr);
       numOut = inputSize;
+    } else if (isLeftSemiFilterJoin(joinType_) && !filter_) {
+      // The table has no duplicate keys. Selects the probe rows with a hit
+      // without iterating the join results.
+      for (auto row : lookup_->rows) {
+        if (lookup_->hits[row]) {
+          mapping[numOut] = row;
+          outputTableRows_[numOut] = lookup_->hits[row];
+          ++numOut;
+        }
+      }
     } else if (isAntiJoin(joinType_) && !filter_) {
       if (nullAware_) {
         // When build side is not empty, anti join without a filter returns
@@ -1330,11 +1628,20 @@ void HashProbe::ensureLoadedIfNotAtEnd(column_index_t channel) {
 
 void HashProbe::noMoreInput() {
   Operator::noMoreInput();
+  if (bufferProbeInput_) {
+    // All the input is buffered before the table is built. The join can swap
+    // sides now.
+    bufferProbeInput_ = false;
+    joinBridge_->setProbeInput(probeBuffer_, probeBufferBytes_);
+    TestValue::adjust("facebook::velox::exec::HashProbe::setProbeInput", this);
+    return;
+  }
   noMoreInputInternal();
 }
 
 bool HashProbe::hasMoreInput() const {
-  return !noMoreInput_ || (spillInputReader_ != nullptr && !noMoreSpillInput_);
+  return !noMoreInput_ || !probeBuffer_.empty() ||
+      (spillInputReader_ != nullptr && !noMoreSpillInput_);
 }
 
 void HashProbe::noMoreInputInternal() {
@@ -1395,9 +1702,42 @@ void HashProbe::setRunning() {
   setState(ProbeOperatorState::kRunning);
 }
 
+bool HashProbe::canReclaim() const {
+  if (state_ != ProbeOperatorState::kWaitForBuild &&
+      state_ != ProbeOperatorState::kWaitForPeers) {
+    return false;
+  }
+  // The operator must not be in the middle of processing on its driver thread,
+  // e.g. buffering the probe input before the hash table is built.
+  auto* driver = operatorCtx_->driver();
+  return driver != nullptr && !driver->isOnThread();
+}
+
+void HashProbe::reclaim(uint64_t /*unused*/) {
+  VELOX_CHECK(canReclaim());
+  VELOX_CHECK(operatorCtx_->task()->pauseRequested());
+
+  // The output and filter buffers are allocated again on demand after the
+  // hash table is built.
+  output_ = nullptr;
+  outputRowMapping_ = nullptr;
+  filterInput_ = nullptr;
+  filterTableInput_ = nullptr;
+  for (auto& result : filterResult_) {
+    result = nullptr;
+  }
+  for (auto& result : filterTableResult_) {
+    result = nullptr;
+  }
+  operatorCtx_->clearCachedVectors();
+}
+
 void HashProbe::close() {
   Operator::close();
 
+  if (swapSides_ && joinBridge_ != nullptr) {
+    joinBridge_->proberClosed();
+  }
   // Free up major memory usage.
   joinBridge_.reset();
   spiller_.reset();
@@ -37,7 +37,7 @@ class HashProbe : public Operator {
         noMoreSpillInput_ || input_ != nullptr) {
       return false;
     }
-    if (table_) {
+    if (table_ || bufferProbeInput_) {
       return true;
     }
     // NOTE: if we can't apply dynamic filtering, then we can start early to
@@ -57,12 +57,13 @@ class HashProbe : public Operator {
 
   bool isFinished() override;
 
-  /// NOTE: we can't reclaim memory from a hash probe operator. The disk
-  /// spilling in hash probe is used to coordinate with the disk spilling
-  /// triggered by the hash build operator.
-  bool canReclaim() const override {
-    return false;
-  }
+  /// NOTE: we can't spill a hash probe operator. The disk spilling in hash
+  /// probe is used to coordinate with the disk spilling triggered by the hash
+  /// build operator. But a hash probe operator which is blocked waiting for
+  /// the hash table or for its peers can free its output buffers.
+  bool canReclaim() const override;
+
+  void reclaim(uint64_t targetBytes) override;
 
   void close() override;
 
@@ -80,6 +81,30 @@ class HashProbe : public Operator {
   // asynchronously.
   void asyncWaitForHashTable();
 
+  // Adds 'input' to 'probeBuffer_' while the table is being built. Stops the
+  // buffering once 'probeBuffer_' exceeds 'probeBufferMaxBytes_'.
+  void bufferInput(RowVectorPtr input);
+
+  // Invoked when the join swapped the build and probe sides. The first
+  // operator makes the table from the probe input in 'result', the other ones
+  // get the table it made.
+  void setupSwappedTable(HashJoinBridge::HashBuildResult result);
+
+  // Makes a table of the probe side columns with the rows of 'input'.
+  std::shared_ptr<BaseHashTable> makeSwappedTable(
+      const std::vector<RowVectorPtr>& input);
+
+  // Gets the next build input to probe the table of the swapped sides with.
+  // Waits in 'kWaitForBuild' state if there is no input yet.
+  void nextSwappedInput();
+
+  // Probes the table of the swapped sides with the build side 'input'.
+  void addSwappedInput(RowVectorPtr input);
+
+  // Returns the next batch of output of the swapped sides. The probe side
+  // columns come from the table and the build side columns from 'input_'.
+  RowVectorPtr getSwappedOutput();
+
   // Invoked to set up spilling related input processing. The function sets up a
   // reader to read probe inputs from spilled data on disk if
   // 'restoredSpillPartitionId' is not null. If 'spillPartitionIds' is not
@@ -357,6 +382,37 @@ class HashProbe : public Operator {
   // Rows of table found by join probe, later filtered by 'filter_'.
   std::vector<char*> outputTableRows_;
 
+  // True if the join may swap the build and probe sides, see
+  // canSwapJoinSides().
+  bool swapSides_{false};
+
+  // The max bytes of 'probeBuffer_'.
+  uint64_t probeBufferMaxBytes_{0};
+
+  // True while the input is added to 'probeBuffer_' instead of being probed
+  // because the table is not built yet.
+  bool bufferProbeInput_{false};
+
+  // The input received before the table was built. If the join does not swap
+  // sides, this is probed after the table is built.
+  std::vector<RowVectorPtr> probeBuffer_;
+  uint64_t probeBufferBytes_{0};
+
+  // True if the join swapped sides. 'table_' then has the probe side rows and
+  // 'input_' is the build side input.
+  bool swapped_{false};
+
+  // True after the last build side input of the swapped sides.
+  bool noMoreSwappedInput_{false};
+
+  // Hashers of the keys of the build side input of the swapped sides. The keys
+  // are the first columns of the input.
+  std::vector<std::unique_ptr<VectorHasher>> swappedHashers_;
+
+  // Maps from column index in the table of the swapped sides to channel in
+  // 'output_'.
+  std::vector<IdentityProjection> swappedTableProjections_;
+
   // Indicates probe-side rows which should produce a NULL in left semi project
   // with filter.
   SelectivityVector leftSemiProjectIsNull_;
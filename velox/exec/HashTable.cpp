@@ -517,10 +517,34 @@ void HashTable<ignoreNullKeys>::arrayGroupProbe(HashLookup& lookup) {
   }
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::prefetchProbes(
+    const vector_size_t* rows,
+    const uint64_t* hashes,
+    int32_t begin,
+    int32_t end) {
+  for (auto i = begin; i < end; ++i) {
+    const auto tagIndex =
+        ProbeState::tagsByteOffset(hashes[rows[i]], sizeMask_);
+    // The tags of a TagVector fit in one cache line, their row pointers take
+    // two.
+    __builtin_prefetch(tags_ + tagIndex);
+    __builtin_prefetch(table_ + tagIndex);
+    __builtin_prefetch(table_ + tagIndex + sizeof(TagVector) / 2);
+  }
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   if (hashMode_ == HashMode::kArray) {
-    for (auto row : lookup.rows) {
+    const bool prefetch = capacity_ >= kPrefetchMinCapacity;
+    const int32_t numProbes = lookup.rows.size();
+    for (auto i = 0; i < numProbes; ++i) {
+      if (prefetch && i + kPrefetchDistance < numProbes) {
+        __builtin_prefetch(
+            table_ + lookup.hashes[lookup.rows[i + kPrefetchDistance]]);
+      }
+      const auto row = lookup.rows[i];
       auto index = lookup.hashes[row];
       DCHECK_LT(index, capacity_);
       lookup.hits[row] = table_[index]; // NOLINT
@@ -535,11 +559,24 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
   const vector_size_t* rows = lookup.rows.data();
+  const uint64_t* hashes = lookup.hashes.data();
+  const bool prefetch = capacity_ >= kPrefetchMinCapacity;
+  if (prefetch) {
+    prefetchProbes(rows, hashes, 0, std::min(kPrefetchDistance, numProbes));
+  }
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
   ProbeState state4;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      const auto prefetchBegin = probeIndex + kPrefetchDistance;
+      prefetchProbes(
+          rows,
+          hashes,
+          std::min(prefetchBegin, numProbes),
+          std::min(prefetchBegin + 4, numProbes));
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -577,7 +614,19 @@ void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   const uint64_t* keys = lookup.normalizedKeys.data();
   const uint64_t* hashes = lookup.hashes.data();
   char** hits = lookup.hits.data();
+  const bool prefetch = capacity_ >= kPrefetchMinCapacity;
+  if (prefetch) {
+    prefetchProbes(rows, hashes, 0, std::min(kPrefetchDistance, numProbes));
+  }
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      const auto prefetchBegin = probeIndex + kPrefetchDistance;
+      prefetchProbes(
+          rows,
+          hashes,
+          std::min(prefetchBegin, numProbes),
+          std::min(prefetchBegin + 4, numProbes));
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, hashes[row], row);
     row = rows[probeIndex + 1];
@@ -754,9 +803,6 @@ bool HashTable<ignoreNullKeys>::canApplyParallelJoinBuild() const {
   if (!isJoinBuild_ || buildExecutor_ == nullptr) {
     return false;
   }
-  if (hashMode_ == HashMode::kArray) {
-    return false;
-  }
   if (otherTables_.empty()) {
     return false;
   }
@@ -881,7 +927,13 @@ void HashTable<ignoreNullKeys>::partitionRows(
         buildPartitionBounds_.capacity() % xsimd::batch<int32_t>::size,
         "partition bounds must be padded to SIMD width");
     for (auto i = 0; i < numRows; ++i) {
-      auto index = ProbeState::tagsByteOffset(hashes[i], sizeMask_);
+      int32_t index;
+      if (hashMode_ == HashMode::kArray) {
+        VELOX_CHECK_LT(hashes[i], capacity_);
+        index = hashes[i];
+      } else {
+        index = ProbeState::tagsByteOffset(hashes[i], sizeMask_);
+      }
       partitions[i] = findPartition(
           index, buildPartitionBounds_.data(), buildPartitionBounds_.size());
     }
@@ -1391,6 +1443,19 @@ bool mayUseValueIds(const BaseHashTable& table) {
 }
 } // namespace
 
+template <bool ignoreNullKeys>
+int64_t HashTable<ignoreNullKeys>::numDistinctJoinKeys() const {
+  VELOX_CHECK(isJoinBuild_);
+  if (!hasDuplicates_) {
+    return numDistinct_;
+  }
+  int64_t numKeys = 0;
+  for (int64_t i = 0; i < capacity_; ++i) {
+    numKeys += table_[i] != nullptr;
+  }
+  return numKeys;
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::prepareJoinTable(
     std::vector<std::unique_ptr<BaseHashTable>> tables,
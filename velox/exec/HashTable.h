@@ -69,6 +69,14 @@ class BaseHashTable {
   // 2M entries, i.e. 16MB is the largest array based hash table.
   static constexpr uint64_t kArrayHashMaxSize = 2L << 20;
 
+  // Number of probes ahead of the current one for which joinProbe
+  // prefetches tags and row pointers.
+  static constexpr int32_t kPrefetchDistance = 16;
+
+  // Tables with fewer slots are assumed to stay in cache and are probed
+  // without prefetching. 64K slots take 576KB of tags and pointers.
+  static constexpr uint64_t kPrefetchMinCapacity = 64 << 10;
+
   /// Specifies the hash mode of a table.
   enum class HashMode { kHash, kArray, kNormalizedKey };
 
@@ -209,6 +217,11 @@ class BaseHashTable {
   /// Returns true if the hash table contains rows with duplicate keys.
   virtual bool hasDuplicateKeys() const = 0;
 
+  /// Returns the number of distinct keys in a hash join build side. The rows
+  /// with the same key hang off a single table entry, so this is the number
+  /// of non-empty entries. Must be called after prepareJoinTable().
+  virtual int64_t numDistinctJoinKeys() const = 0;
+
   /// Returns the hash mode. This is needed for the caller to calculate
   /// the hash numbers using the appropriate method of the
   /// VectorHashers of 'this'.
@@ -427,6 +440,8 @@ class HashTable : public BaseHashTable {
     return hasDuplicates_;
   }
 
+  int64_t numDistinctJoinKeys() const override;
+
   HashMode hashMode() const override {
     return hashMode_;
   }
@@ -574,8 +589,7 @@ class HashTable : public BaseHashTable {
   /// 1. the hash table is built for parallel join;
   /// 2. there is more than one sub-tables;
   /// 3. the build executor has been set;
-  /// 4. the table is not in kArray mode;
-  /// 5. the number of table entries per each parallel build shard is no less
+  /// 4. the number of table entries per each parallel build shard is no less
   ///    than a pre-defined threshold: 1000 for now.
   bool canApplyParallelJoinBuild() const;
 
@@ -585,7 +599,8 @@ class HashTable : public BaseHashTable {
   // assigned to their thread-specific partition and insert these. If
   // a row would overflow past the end of its partition it is added to
   // a set of overflow rows that are sequentially inserted after all
-  // else.
+  // else. In kArray mode the partitions are ranges of the array and
+  // there is no overflow.
   void parallelJoinBuild();
 
   // Inserts the rows in 'partition' from this and 'otherTables' into 'this'.
@@ -628,6 +643,16 @@ class HashTable : public BaseHashTable {
   // Shortcut for probe with normalized keys.
   void joinNormalizedKeyProbe(HashLookup& lookup);
 
+  // Issues prefetches for the tags and row pointers that the probes of
+  // 'rows[begin]' ... 'rows[end - 1]' will load first. Called
+  // kPrefetchDistance probes ahead of the probe loop in joinProbe so that
+  // the cache misses of several probes overlap.
+  void prefetchProbes(
+      const vector_size_t* rows,
+      const uint64_t* hashes,
+      int32_t begin,
+      int32_t end);
+
   // Adds a row to a hash join table in kArray hash mode. Returns true
   // if a new entry was made and false if the row was added to an
   // existing set of rows with the same key.
@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/LocalPartition.h"
+#include "velox/exec/RoundRobinPartitionFunction.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -29,27 +30,36 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if (bufferedBytes_.fetch_add(added) + added < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  // Announces the wait before re-checking the usage. A consumer decreases the
+  // usage before checking 'numPromises_', so either the consumer sees the
+  // promise or this sees the decreased usage.
+  ++numPromises_;
+  if (bufferedBytes_ < maxBufferSize_) {
+    --numPromises_;
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
     int64_t removed) {
   std::vector<ContinuePromise> promises;
+  if (bufferedBytes_.fetch_sub(removed) - removed >= maxBufferSize_ ||
+      numPromises_ == 0) {
+    return promises;
+  }
   {
     std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
-
     if (bufferedBytes_ < maxBufferSize_) {
       promises = std::move(promises_);
+      numPromises_ = 0;
     }
   }
   return promises;
@@ -87,13 +97,18 @@ BlockingReason LocalExchangeQueue::enqueue(
     ContinueFuture* future) {
   auto inputBytes = input->estimateFlatSize();
 
-  std::vector<ContinuePromise> consumerPromises;
+  // Wakes up a single consumer. Only one consumer can fetch 'input', the others
+  // would find the queue empty and wait again.
+  std::optional<ContinuePromise> consumerPromise;
   bool isClosed = queue_.withWLock([&](auto& queue) {
     if (closed_) {
       return true;
     }
     queue.push(std::move(input));
-    consumerPromises = std::move(consumerPromises_);
+    if (!consumerPromises_.empty()) {
+      consumerPromise = std::move(consumerPromises_.back());
+      consumerPromises_.pop_back();
+    }
     return false;
   });
 
@@ -101,7 +116,9 @@ BlockingReason LocalExchangeQueue::enqueue(
     return BlockingReason::kNotBlocked;
   }
 
-  notify(consumerPromises);
+  if (consumerPromise.has_value()) {
+    consumerPromise->setValue();
+  }
 
   if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
     return BlockingReason::kWaitForConsumer;
@@ -132,7 +149,6 @@ BlockingReason LocalExchangeQueue::next(
     memory::MemoryPool* pool,
     RowVectorPtr* data) {
   std::vector<ContinuePromise> producerPromises;
-  std::vector<ContinuePromise> memoryPromises;
   auto blockingReason = queue_.withWLock([&](auto& queue) {
     *data = nullptr;
     if (queue.empty()) {
@@ -149,16 +165,18 @@ BlockingReason LocalExchangeQueue::next(
     *data = queue.front();
     queue.pop();
 
-    memoryPromises =
-        memoryManager_->decreaseMemoryUsage((*data)->estimateFlatSize());
-
     if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
       producerPromises = std::move(producerPromises_);
     }
 
     return BlockingReason::kNotBlocked;
   });
-  notify(memoryPromises);
+  if (*data != nullptr) {
+    // Sized and released outside of the queue lock.
+    auto memoryPromises =
+        memoryManager_->decreaseMemoryUsage((*data)->estimateFlatSize());
+    notify(memoryPromises);
+  }
   notify(producerPromises);
   return blockingReason;
 }
@@ -190,7 +208,7 @@ BlockingReason LocalExchangeQueue::isFinished(ContinueFuture* future) {
 }
 
 bool LocalExchangeQueue::isFinished() {
-  return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
+  return queue_.withRLock([&](auto& queue) { return isFinishedLocked(queue); });
 }
 
 void LocalExchangeQueue::close() {
@@ -276,11 +294,17 @@ LocalPartition::LocalPartition(
       queues_{
           ctx->task->getLocalExchangeQueues(ctx->splitGroupId, planNode->id())},
       numPartitions_{queues_.size()},
+      roundRobin_{
+          numPartitions_ > 1 &&
+          dynamic_cast<const RoundRobinPartitionFunctionSpec*>(
+              &planNode->partitionFunctionSpec()) != nullptr},
       partitionFunction_(
-          numPartitions_ == 1
+          numPartitions_ == 1 || roundRobin_
               ? nullptr
-              : planNode->partitionFunctionSpec().create(numPartitions_)) {
-  VELOX_CHECK(numPartitions_ == 1 || partitionFunction_ != nullptr);
+              : planNode->partitionFunctionSpec().create(numPartitions_)),
+      nextPartition_(ctx->driverId % numPartitions_) {
+  VELOX_CHECK(
+      numPartitions_ == 1 || roundRobin_ || partitionFunction_ != nullptr);
 
   for (auto& queue : queues_) {
     queue->addProducer();
@@ -288,28 +312,6 @@ LocalPartition::LocalPartition(
 }
 
 namespace {
-std::vector<BufferPtr> allocateIndexBuffers(
-    int numBuffers,
-    vector_size_t size,
-    memory::MemoryPool* pool) {
-  std::vector<BufferPtr> indexBuffers;
-  indexBuffers.reserve(numBuffers);
-  for (auto i = 0; i < numBuffers; i++) {
-    indexBuffers.emplace_back(allocateIndices(size, pool));
-  }
-  return indexBuffers;
-}
-
-std::vector<vector_size_t*> getRawIndices(
-    const std::vector<BufferPtr>& indexBuffers) {
-  std::vector<vector_size_t*> rawIndices;
-  rawIndices.reserve(indexBuffers.size());
-  for (auto& buffer : indexBuffers) {
-    rawIndices.emplace_back(buffer->asMutable<vector_size_t>());
-  }
-  return rawIndices;
-}
-
 RowVectorPtr
 wrapChildren(const RowVectorPtr& input, vector_size_t size, BufferPtr indices) {
   std::vector<VectorPtr> wrappedChildren;
@@ -338,44 +340,84 @@ void LocalPartition::addInput(RowVectorPtr input) {
   input_ = std::move(input);
 
   if (numPartitions_ == 1) {
-    ContinueFuture future;
-    auto blockingReason = queues_[0]->enqueue(input_, &future);
-    if (blockingReason != BlockingReason::kNotBlocked) {
-      blockingReasons_.push_back(blockingReason);
-      futures_.push_back(std::move(future));
-    }
+    enqueue(0, input_);
+  } else if (roundRobin_) {
+    // Whole vectors go to the partitions in turn instead of wrapping every
+    // n-th row of each vector.
+    enqueue(nextPartition_, input_);
+    nextPartition_ = (nextPartition_ + 1) % numPartitions_;
   } else {
-    partitionFunction_->partition(*input_, partitions_);
+    partitionInput();
+  }
+}
+
+void LocalPartition::enqueue(uint32_t partition, RowVectorPtr data) {
+  ContinueFuture future;
+  auto reason = queues_[partition]->enqueue(std::move(data), &future);
+  if (reason != BlockingReason::kNotBlocked) {
+    blockingReasons_.push_back(reason);
+    futures_.push_back(std::move(future));
+  }
+}
 
-    auto numInput = input_->size();
-    auto indexBuffers = allocateIndexBuffers(numPartitions_, numInput, pool());
-    auto rawIndices = getRawIndices(indexBuffers);
+void LocalPartition::partitionInput() {
+  partitionFunction_->partition(*input_, partitions_);
+
+  const auto numInput = input_->size();
+  partitionSizes_.assign(numPartitions_, 0);
+  vector_size_t numToAll = 0;
+  for (auto i = 0; i < numInput; ++i) {
+    const auto partition = partitions_[i];
+    if (FOLLY_UNLIKELY(partition == core::PartitionFunction::kAllPartitions)) {
+      ++numToAll;
+    } else {
+      ++partitionSizes_[partition];
+    }
+  }
 
-    std::vector<vector_size_t> maxIndex(numPartitions_, 0);
-    for (auto i = 0; i < numInput; ++i) {
-      auto partition = partitions_[i];
-      rawIndices[partition][maxIndex[partition]] = i;
-      ++maxIndex[partition];
+  // Index buffers are allocated only for partitions that get some but not
+  // all rows.
+  std::vector<BufferPtr> indexBuffers(numPartitions_);
+  std::vector<vector_size_t*> rawIndices(numPartitions_, nullptr);
+  bool needsIndices = false;
+  for (auto i = 0; i < numPartitions_; ++i) {
+    partitionSizes_[i] += numToAll;
+    if (partitionSizes_[i] > 0 && partitionSizes_[i] < numInput) {
+      indexBuffers[i] = allocateIndices(partitionSizes_[i], pool());
+      rawIndices[i] = indexBuffers[i]->asMutable<vector_size_t>();
+      needsIndices = true;
     }
+  }
 
-    for (auto i = 0; i < numPartitions_; i++) {
-      auto partitionSize = maxIndex[i];
-      if (partitionSize == 0) {
-        // Do not enqueue empty partitions.
-        continue;
-      }
-      indexBuffers[i]->setSize(partitionSize * sizeof(vector_size_t));
-      auto partitionData =
-          wrapChildren(input_, partitionSize, std::move(indexBuffers[i]));
-
-      ContinueFuture future;
-      auto reason = queues_[i]->enqueue(partitionData, &future);
-      if (reason != BlockingReason::kNotBlocked) {
-        blockingReasons_.push_back(reason);
-        futures_.push_back(std::move(future));
+  if (needsIndices) {
+    std::vector<vector_size_t> numIndices(numPartitions_, 0);
+    for (auto i = 0; i < numInput; ++i) {
+      const auto partition = partitions_[i];
+      if (FOLLY_UNLIKELY(
+              partition == core::PartitionFunction::kAllPartitions)) {
+        for (auto j = 0; j < numPartitions_; ++j) {
+          if (rawIndices[j]) {
+            rawIndices[j][numIndices[j]++] = i;
+          }
+        }
+      } else if (rawIndices[partition]) {
+        rawIndices[partition][numIndices[partition]++] = i;
       }
     }
   }
+
+  for (auto i = 0; i < numPartitions_; ++i) {
+    const auto partitionSize = partitionSizes_[i];
+    if (partitionSize == 0) {
+      // Do not enqueue empty partitions.
+      continue;
+    }
+    if (partitionSize == numInput) {
+      enqueue(i, input_);
+      continue;
+    }
+    enqueue(i, wrapChildren(input_, partitionSize, std::move(indexBuffers[i])));
+  }
 }
 
 BlockingReason LocalPartition::isBlocked(ContinueFuture* future) {
@@ -21,7 +21,8 @@
 namespace facebook::velox::exec {
 
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. The usage is updated without locking while below the
+/// limit. The mutex is only taken to block a producer or to unblock producers.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -39,7 +40,9 @@ class LocalExchangeMemoryManager {
  private:
   const int64_t maxBufferSize_;
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
+  std::atomic<int64_t> bufferedBytes_{0};
+  // Number of producers waiting in 'promises_' or about to wait.
+  std::atomic<int32_t> numPromises_{0};
   std::vector<ContinuePromise> promises_;
 };
 
@@ -104,7 +107,8 @@ class LocalExchangeQueue {
   folly::Synchronized<std::queue<RowVectorPtr>> queue_;
   // Satisfied when data becomes available or all producers report that they
   // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
-  // and pendingProducers_ is zero.
+  // and pendingProducers_ is zero. Each enqueue satisfies one promise, the
+  // completion of the producers satisfies all.
   std::vector<ContinuePromise> consumerPromises_;
   // Satisfied when all data has been fetched and no more data will be produced,
   // e.g. queue_ is empty, noMoreProducers_ is true and pendingProducers_ is
@@ -136,6 +140,13 @@ class LocalExchange : public SourceOperator {
 
   bool isFinished() override;
 
+  /// Closes the exchange queue so that the producers stop.
+  void noMoreOutputNeeded() override {
+    if (queue_) {
+      queue_->close();
+    }
+  }
+
   /// Close exchange queue. If called before all data has been processed,
   /// notifies the producer that no more data is needed.
   void close() override {
@@ -184,15 +195,33 @@ class LocalPartition : public Operator {
   bool isFinished() override;
 
  private:
+  // Adds 'data' to the queue of 'partition' and records the future to wait
+  // for if the queue is full.
+  void enqueue(uint32_t partition, RowVectorPtr data);
+
+  // Adds the rows of 'input_' to the queues of their partitions. Passes
+  // 'input_' as is to partitions that get all rows and wraps the rows of
+  // other partitions in dictionaries over 'input_'.
+  void partitionInput();
+
   const std::vector<std::shared_ptr<LocalExchangeQueue>> queues_;
   const size_t numPartitions_;
+  // True if the input is distributed round-robin. Whole input vectors then go
+  // to the partitions in turn.
+  const bool roundRobin_;
   std::unique_ptr<core::PartitionFunction> partitionFunction_;
 
+  // Partition of the next input vector if 'roundRobin_'.
+  uint32_t nextPartition_{0};
+
   std::vector<BlockingReason> blockingReasons_;
   std::vector<ContinueFuture> futures_;
 
   /// Reusable memory for hash calculation.
   std::vector<uint32_t> partitions_;
+
+  /// Reusable memory for the number of rows of each partition.
+  std::vector<vector_size_t> partitionSizes_;
 };
 
 } // namespace facebook::velox::exec
@@ -43,6 +43,15 @@
 #include "velox/exec/Values.h"
 #include "velox/exec/Window.h"
 
+#include <list>
+#include <mutex>
+
+DEFINE_int32(
+    local_planner_cache_entries,
+    256,
+    "Max number of planned fragments cached by LocalPlanner. 0 disables the "
+    "cache");
+
 namespace facebook::velox::exec {
 
 namespace detail {
@@ -169,7 +178,11 @@ uint32_t maxDriversForConsumer(
   return std::numeric_limits<uint32_t>::max();
 }
 
-uint32_t maxDrivers(const DriverFactory& driverFactory) {
+// NOTE: The query config settings used here must be in the key of the plan
+// cache, see makePlanCacheKey().
+uint32_t maxDrivers(
+    const DriverFactory& driverFactory,
+    const core::QueryConfig& queryConfig) {
   uint32_t count = maxDriversForConsumer(driverFactory.consumerNode);
   if (count == 1) {
     return count;
@@ -198,8 +211,8 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
     } else if (
         auto orderBy =
             std::dynamic_pointer_cast<const core::OrderByNode>(node)) {
-      // final orderby must run single-threaded
-      if (!orderBy->isPartial()) {
+      // final orderby must run single-threaded unless it sorts in parallel
+      if (!orderBy->isPartial() && !queryConfig.orderByParallelSortEnabled()) {
         return 1;
       }
     } else if (
@@ -243,6 +256,175 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
   }
   return count;
 }
+
+// A pipeline of a planned fragment. Refers to the plan nodes by raw pointer
+// so that the cache does not keep the plan alive.
+struct CachedPipeline {
+  std::vector<const core::PlanNode*> planNodes;
+  const core::PlanNode* consumerNode;
+  uint32_t maxDrivers;
+  uint32_t numDrivers;
+  uint32_t numTotalDrivers;
+  bool groupedExecution;
+  bool inputDriver;
+  bool outputDriver;
+  folly::F14FastSet<core::PlanNodeId> mixedExecutionModeHashJoinNodeIds;
+  folly::F14FastSet<core::PlanNodeId> mixedExecutionModeNestedLoopJoinNodeIds;
+};
+
+struct CachedPlan {
+  // The raw pointers in 'pipelines' are valid while this is not expired.
+  std::weak_ptr<const core::PlanNode> root;
+  std::vector<CachedPipeline> pipelines;
+};
+
+std::string makePlanCacheKey(
+    const core::PlanFragment& planFragment,
+    const core::QueryConfig& queryConfig,
+    uint32_t maxDrivers) {
+  std::vector<core::PlanNodeId> leafNodeIds(
+      planFragment.groupedExecutionLeafNodeIds.begin(),
+      planFragment.groupedExecutionLeafNodeIds.end());
+  std::sort(leafNodeIds.begin(), leafNodeIds.end());
+  auto key = fmt::format(
+      "{} {} {} {} {}",
+      static_cast<const void*>(planFragment.planNode.get()),
+      maxDrivers,
+      queryConfig.orderByParallelSortEnabled(),
+      static_cast<int>(planFragment.executionStrategy),
+      planFragment.numSplitGroups);
+  for (const auto& id : leafNodeIds) {
+    key += fmt::format(" {}", id);
+  }
+  return key;
+}
+
+// Process wide LRU cache of planned fragments.
+class PlanCache {
+ public:
+  static PlanCache& instance() {
+    static PlanCache cache;
+    return cache;
+  }
+
+  // Fills 'driverFactories' from the plan cached at 'key' for 'root'. Returns
+  // false if not cached.
+  bool find(
+      const std::string& key,
+      const std::shared_ptr<const core::PlanNode>& root,
+      const ConsumerSupplier& consumerSupplier,
+      std::vector<std::unique_ptr<DriverFactory>>* driverFactories) {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second->second.root.lock() != root) {
+      ++numMisses_;
+      return false;
+    }
+    ++numHits_;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    const auto& pipelines = it->second->second.pipelines;
+    // Aliases 'root' so that the nodes stay alive as long as the plan.
+    auto toShared = [&](const core::PlanNode* node) {
+      return std::shared_ptr<const core::PlanNode>(root, node);
+    };
+    for (auto i = 0; i < pipelines.size(); ++i) {
+      const auto& pipeline = pipelines[i];
+      auto factory = std::make_unique<DriverFactory>();
+      factory->planNodes.reserve(pipeline.planNodes.size());
+      for (const auto* node : pipeline.planNodes) {
+        factory->planNodes.push_back(toShared(node));
+      }
+      if (pipeline.consumerNode != nullptr) {
+        factory->consumerNode = toShared(pipeline.consumerNode);
+        factory->consumerSupplier = makeConsumerSupplier(factory->consumerNode);
+      } else {
+        VELOX_CHECK_EQ(i, 0);
+        factory->consumerSupplier = makeConsumerSupplier(consumerSupplier);
+      }
+      factory->maxDrivers = pipeline.maxDrivers;
+      factory->numDrivers = pipeline.numDrivers;
+      factory->numTotalDrivers = pipeline.numTotalDrivers;
+      factory->groupedExecution = pipeline.groupedExecution;
+      factory->inputDriver = pipeline.inputDriver;
+      factory->outputDriver = pipeline.outputDriver;
+      factory->mixedExecutionModeHashJoinNodeIds =
+          pipeline.mixedExecutionModeHashJoinNodeIds;
+      factory->mixedExecutionModeNestedLoopJoinNodeIds =
+          pipeline.mixedExecutionModeNestedLoopJoinNodeIds;
+      driverFactories->push_back(std::move(factory));
+    }
+    return true;
+  }
+
+  void insert(
+      const std::string& key,
+      const std::shared_ptr<const core::PlanNode>& root,
+      const std::vector<std::unique_ptr<DriverFactory>>& driverFactories) {
+    CachedPlan plan;
+    plan.root = root;
+    plan.pipelines.reserve(driverFactories.size());
+    for (const auto& factory : driverFactories) {
+      CachedPipeline pipeline;
+      pipeline.planNodes.reserve(factory->planNodes.size());
+      for (const auto& node : factory->planNodes) {
+        pipeline.planNodes.push_back(node.get());
+      }
+      pipeline.consumerNode = factory->consumerNode.get();
+      pipeline.maxDrivers = factory->maxDrivers;
+      pipeline.numDrivers = factory->numDrivers;
+      pipeline.numTotalDrivers = factory->numTotalDrivers;
+      pipeline.groupedExecution = factory->groupedExecution;
+      pipeline.inputDriver = factory->inputDriver;
+      pipeline.outputDriver = factory->outputDriver;
+      pipeline.mixedExecutionModeHashJoinNodeIds =
+          factory->mixedExecutionModeHashJoinNodeIds;
+      pipeline.mixedExecutionModeNestedLoopJoinNodeIds =
+          factory->mixedExecutionModeNestedLoopJoinNodeIds;
+      plan.pipelines.push_back(std::move(pipeline));
+    }
+
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      // Replaces a plan that is no longer alive.
+      it->second->second = std::move(plan);
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return;
+    }
+    lru_.emplace_front(key, std::move(plan));
+    entries_[key] = lru_.begin();
+    while (lru_.size() >
+           static_cast<size_t>(FLAGS_local_planner_cache_entries)) {
+      entries_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+
+  LocalPlanner::CacheStats stats() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    LocalPlanner::CacheStats stats;
+    stats.numHits = numHits_;
+    stats.numMisses = numMisses_;
+    stats.numEntries = entries_.size();
+    return stats;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> l(mutex_);
+    entries_.clear();
+    lru_.clear();
+  }
+
+ private:
+  using Entry = std::pair<std::string, CachedPlan>;
+
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> lru_;
+  folly::F14FastMap<std::string, std::list<Entry>::iterator> entries_;
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+};
 } // namespace detail
 
 // static
@@ -250,7 +432,20 @@ void LocalPlanner::plan(
     const core::PlanFragment& planFragment,
     ConsumerSupplier consumerSupplier,
     std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    const core::QueryConfig& queryConfig,
     uint32_t maxDrivers) {
+  std::string cacheKey;
+  if (FLAGS_local_planner_cache_entries > 0) {
+    cacheKey = detail::makePlanCacheKey(planFragment, queryConfig, maxDrivers);
+    if (detail::PlanCache::instance().find(
+            cacheKey,
+            planFragment.planNode,
+            consumerSupplier,
+            driverFactories)) {
+      return;
+    }
+  }
+
   detail::plan(
       planFragment.planNode,
       nullptr,
@@ -267,7 +462,7 @@ void LocalPlanner::plan(
 
   // Determine number of drivers for each pipeline.
   for (auto& factory : *driverFactories) {
-    factory->maxDrivers = detail::maxDrivers(*factory);
+    factory->maxDrivers = detail::maxDrivers(*factory, queryConfig);
     factory->numDrivers = std::min(factory->maxDrivers, maxDrivers);
 
     // Pipelines running grouped/bucketed execution would have separate groups
@@ -281,6 +476,21 @@ void LocalPlanner::plan(
       factory->numTotalDrivers = factory->numDrivers;
     }
   }
+
+  if (FLAGS_local_planner_cache_entries > 0) {
+    detail::PlanCache::instance().insert(
+        cacheKey, planFragment.planNode, *driverFactories);
+  }
+}
+
+// static
+LocalPlanner::CacheStats LocalPlanner::cacheStats() {
+  return detail::PlanCache::instance().stats();
+}
+
+// static
+void LocalPlanner::clearCache() {
+  detail::PlanCache::instance().clear();
 }
 
 // static
@@ -455,8 +665,15 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         operators.push_back(std::make_unique<StreamingAggregation>(
             id, ctx.get(), aggregationNode));
       } else {
-        operators.push_back(
-            std::make_unique<HashAggregation>(id, ctx.get(), aggregationNode));
+        // A filter over the aggregation in the same pipeline may let the
+        // aggregation skip the input of the groups the filter drops.
+        std::shared_ptr<const core::FilterNode> filterNode;
+        if (i < planNodes.size() - 1) {
+          filterNode = std::dynamic_pointer_cast<const core::FilterNode>(
+              planNodes[i + 1]);
+        }
+        operators.push_back(std::make_unique<HashAggregation>(
+            id, ctx.get(), aggregationNode, filterNode));
       }
     } else if (
         auto groupIdNode =
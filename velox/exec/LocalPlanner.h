@@ -15,8 +15,12 @@
  */
 #pragma once
 
+#include <gflags/gflags.h>
+
 #include "velox/exec/Operator.h"
 
+DECLARE_int32(local_planner_cache_entries);
+
 namespace facebook::velox::core {
 struct PlanFragment;
 } // namespace facebook::velox::core
@@ -25,10 +29,21 @@ namespace facebook::velox::exec {
 
 class LocalPlanner {
  public:
+  struct CacheStats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEntries{0};
+  };
+
+  /// Splits 'planFragment' into pipelines and makes a DriverFactory for each.
+  /// The pipelines of a fragment are cached by the identity of its root plan
+  /// node and the planning options, so that the tasks of a repeated fragment
+  /// don't plan it again. A cached plan does not keep the plan nodes alive.
   static void plan(
       const core::PlanFragment& planFragment,
       ConsumerSupplier consumerSupplier,
       std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+      const core::QueryConfig& queryConfig,
       uint32_t maxDrivers);
 
   // Determine which pipelines should run Grouped Execution.
@@ -42,5 +57,10 @@ class LocalPlanner {
   // detected by both pipelines.
   static void markMixedJoinBridges(
       std::vector<std::unique_ptr<DriverFactory>>& driverFactories);
+
+  /// Returns the stats of the process wide cache of planned fragments.
+  static CacheStats cacheStats();
+
+  static void clearCache();
 };
 } // namespace facebook::velox::exec
@@ -78,9 +78,15 @@ RowVectorPtr MarkDistinct::getOutput() {
   auto resultBits =
       results_[0]->as<FlatVector<bool>>()->mutableRawValues<uint64_t>();
 
-  bits::fillBits(resultBits, 0, outputSize, false);
-  for (const auto i : groupingSet_->hashLookup().newGroups) {
-    bits::setBit(resultBits, i, true);
+  const auto& newGroups = groupingSet_->hashLookup().newGroups;
+  if (newGroups.size() == outputSize) {
+    // All rows are distinct, e.g. the first batch with unique keys.
+    bits::fillBits(resultBits, 0, outputSize, true);
+  } else {
+    bits::fillBits(resultBits, 0, outputSize, false);
+    for (const auto i : newGroups) {
+      bits::setBit(resultBits, i, true);
+    }
   }
   auto output = fillOutput(outputSize, nullptr);
 
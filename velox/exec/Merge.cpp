@@ -16,6 +16,7 @@
 
 #include "velox/exec/Merge.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 using facebook::velox::common::testutil::TestValue;
@@ -154,13 +155,26 @@ RowVectorPtr Merge::getOutput() {
       return std::move(output_);
     }
 
-    if (stream->setOutputRow(outputSize_)) {
+    vector_size_t numRows;
+    if (stream == lastStream_) {
+      // Take the rows that are not greater than the first row of any other
+      // stream.
+      numRows = stream->setOutputRows(
+          outputSize_,
+          outputBatchSize_ - outputSize_,
+          treeOfLosers_->runnerUp());
+    } else {
+      numRows = stream->setOutputRows(outputSize_, 1, nullptr);
+      lastStream_ = stream;
+    }
+
+    if (stream->atLastRow()) {
       // The stream is at end of input batch. Need to copy out the rows before
       // fetching next batch in 'pop'.
       stream->copyToOutput(output_);
     }
 
-    ++outputSize_;
+    outputSize_ += numRows;
 
     // Advance the stream.
     stream->pop(sourceBlockingFutures_);
@@ -207,11 +221,45 @@ bool SourceStream::operator<(const MergeStream& other) const {
   return false;
 }
 
+bool SourceStream::hasKeyPrefix() const {
+  return hasIntegerKeyPrefix(keyColumns_[0]->typeKind());
+}
+
+uint64_t SourceStream::keyPrefix() const {
+  return integerKeyPrefix(
+      *keyColumns_[0], currentSourceRow_, sortingKeys_[0].second);
+}
+
+vector_size_t SourceStream::setOutputRows(
+    vector_size_t outputRow,
+    vector_size_t maxRows,
+    const SourceStream* other) {
+  const auto firstRow = currentSourceRow_;
+  vector_size_t numRows = 1;
+  while (numRows < maxRows && currentSourceRow_ + 1 < data_->size()) {
+    ++currentSourceRow_;
+    if (other && *other < *this) {
+      --currentSourceRow_;
+      break;
+    }
+    ++numRows;
+  }
+
+  if (!ranges_.empty() &&
+      ranges_.back().sourceIndex + ranges_.back().count == firstRow &&
+      ranges_.back().targetIndex + ranges_.back().count == outputRow) {
+    ranges_.back().count += numRows;
+  } else {
+    ranges_.push_back({firstRow, outputRow, numRows});
+  }
+  return numRows;
+}
+
 bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
   ++currentSourceRow_;
   if (currentSourceRow_ == data_->size()) {
     // Make sure all current data has been copied out.
-    VELOX_CHECK(!outputRows_.hasSelections());
+    VELOX_CHECK(ranges_.empty());
     return fetchMoreData(futures);
   }
 
@@ -219,28 +267,17 @@ bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
 }
 
 void SourceStream::copyToOutput(RowVectorPtr& output) {
-  outputRows_.updateBounds();
-
-  if (!outputRows_.hasSelections()) {
+  if (ranges_.empty()) {
     return;
   }
 
-  vector_size_t sourceRow = firstSourceRow_;
-  outputRows_.applyToSelected(
-      [&](auto row) { sourceRows_[row] = sourceRow++; });
-
+  const folly::Range<const BaseVector::CopyRange*> ranges(
+      ranges_.data(), ranges_.size());
   for (auto i = 0; i < output->type()->size(); ++i) {
-    output->childAt(i)->copy(
-        data_->childAt(i).get(), outputRows_, sourceRows_.data());
+    output->childAt(i)->copyRanges(data_->childAt(i).get(), ranges);
   }
 
-  outputRows_.clearAll();
-
-  if (sourceRow == data_->size()) {
-    firstSourceRow_ = 0;
-  } else {
-    firstSourceRow_ = sourceRow;
-  }
+  ranges_.clear();
 }
 
 bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
@@ -305,7 +342,8 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(makeExchangeSerdeOptions(driverCtx->queryConfig())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
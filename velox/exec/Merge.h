@@ -72,6 +72,11 @@ class Merge : public SourceOperator {
 
   RowVectorPtr output_;
 
+  /// The stream that produced the last output row. If the same stream wins
+  /// again, the input is likely clustered and a run of rows is taken from the
+  /// stream at once.
+  SourceStream* lastStream_{nullptr};
+
   /// Number of rows accumulated in 'output_' so far.
   vector_size_t outputSize_{0};
 
@@ -88,11 +93,9 @@ class SourceStream final : public MergeStream {
       MergeSource* source,
       const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys,
       uint32_t outputBatchSize)
-      : source_{source},
-        sortingKeys_{sortingKeys},
-        outputRows_(outputBatchSize, false),
-        sourceRows_(outputBatchSize) {
+      : source_{source}, sortingKeys_{sortingKeys} {
     keyColumns_.reserve(sortingKeys.size());
+    ranges_.reserve(outputBatchSize);
   }
 
   /// Returns true and appends a future to 'futures' if needs to wait for the
@@ -112,19 +115,32 @@ class SourceStream final : public MergeStream {
   /// 'other'.
   bool operator<(const MergeStream& other) const override;
 
+  bool hasKeyPrefix() const override;
+
+  uint64_t keyPrefix() const override;
+
   /// Advances to the next row. Returns true and appends a future to 'futures'
   /// if runs out of rows in the current batch and needs to wait for the
   /// source to produce the next batch. The return flag has the meaning of
   /// 'is-blocked'.
   bool pop(std::vector<ContinueFuture>& futures);
 
-  /// Records the output row number for the current row. Returns true if
-  /// current row is the last row in the current batch, in which case the
-  /// caller must call 'copyToOutput' before calling pop(). The caller must
-  /// call 'setOutputRow' before calling 'pop'. The output rows must
-  /// monotonically increase in between calls to 'copyToOutput'.
-  bool setOutputRow(vector_size_t row) {
-    outputRows_.setValid(row, true);
+  /// Records that up to 'maxRows' consecutive rows starting at the current
+  /// row go to consecutive output rows starting at 'outputRow'. Stops at the
+  /// end of the current batch and before the first row that is greater than
+  /// the current row of 'other' if 'other' is not null. The current row
+  /// becomes the last recorded row. Returns the number of recorded rows,
+  /// which is at least 1. The caller must call 'setOutputRows' before calling
+  /// 'pop'. The output rows must monotonically increase in between calls to
+  /// 'copyToOutput'.
+  vector_size_t setOutputRows(
+      vector_size_t outputRow,
+      vector_size_t maxRows,
+      const SourceStream* other);
+
+  /// Returns true if the current row is the last row in the current batch, in
+  /// which case the caller must call 'copyToOutput' before calling pop().
+  bool atLastRow() const {
     return currentSourceRow_ == data_->size() - 1;
   }
 
@@ -157,14 +173,9 @@ class SourceStream final : public MergeStream {
   /// returned by 'source_->next()'.
   bool needData_{true};
 
-  /// First source row that hasn't been copied out yet.
-  vector_size_t firstSourceRow_{0};
-
-  /// Output row numbers for source rows that haven't been copied out yet.
-  SelectivityVector outputRows_;
-
-  /// Reusable memory.
-  std::vector<vector_size_t> sourceRows_;
+  /// Ranges of source rows that haven't been copied out yet and their
+  /// positions in the output.
+  std::vector<BaseVector::CopyRange> ranges_;
 };
 
 // LocalMerge merges its source's output into a single stream of
@@ -191,10 +202,17 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  /// Returns the serde options to read the pages from the sources with, see
+  /// makeExchangeSerdeOptions().
+  const VectorSerde::Options* serdeOptions() const {
+    return serdeOptions_.get();
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
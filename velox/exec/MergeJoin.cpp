@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/exec/MergeJoin.h"
+
+#include <numeric>
+
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/FieldReference.h"
@@ -66,6 +69,28 @@ MergeJoin::MergeJoin(
     }
   }
 
+  const auto& keyRangeBoundaries = joinNode->keyRangeBoundaries();
+  if (!keyRangeBoundaries.empty()) {
+    const auto splitGroupId = driverCtx->splitGroupId;
+    VELOX_USER_CHECK_NE(
+        splitGroupId,
+        kUngroupedGroupId,
+        "Merge join with key ranges requires grouped execution");
+    VELOX_USER_CHECK_LE(
+        splitGroupId,
+        keyRangeBoundaries.size(),
+        "Split group of merge join is out of the key ranges");
+    hasKeyRange_ = true;
+    if (splitGroupId > 0) {
+      keyRangeLowerBound_ =
+          keyRangeBoundaries[splitGroupId - 1]->toConstantVector(pool());
+    }
+    if (splitGroupId < keyRangeBoundaries.size()) {
+      keyRangeUpperBound_ =
+          keyRangeBoundaries[splitGroupId]->toConstantVector(pool());
+    }
+  }
+
   if (joinNode->filter()) {
     initializeFilter(joinNode->filter(), leftType, rightType);
 
@@ -128,9 +153,125 @@ bool MergeJoin::needsInput() const {
   return input_ == nullptr;
 }
 
+namespace {
+// Returns the raw values of the join key of 'input' if there is a single
+// BIGINT key that is flat and has no nulls. Returns nullptr otherwise.
+const int64_t* rawBigintKeys(
+    const RowVectorPtr& input,
+    const std::vector<column_index_t>& keys) {
+  if (keys.size() != 1) {
+    return nullptr;
+  }
+  const auto& key = input->childAt(keys[0]);
+  if (key->typeKind() != TypeKind::BIGINT ||
+      key->encoding() != VectorEncoding::Simple::FLAT || key->mayHaveNulls()) {
+    return nullptr;
+  }
+  return key->asUnchecked<FlatVector<int64_t>>()->rawValues();
+}
+
+// Returns true if the rows of 'input' are known to be in ascending order of
+// compare() on 'keys'. This is the case if the keys are of primitive types and
+// have no nulls, which may be either first or last in the input.
+bool hasOrderedKeys(
+    const RowVectorPtr& input,
+    const std::vector<column_index_t>& keys) {
+  for (auto key : keys) {
+    const auto& vector = input->childAt(key);
+    if (!vector->type()->isPrimitiveType() || isLazyNotLoaded(*vector) ||
+        vector->loadedVector()->mayHaveNulls()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the first index in [begin, end) for which 'isBefore' is false.
+// 'isBefore' must be true for a prefix of the range and false for the rest.
+// Probes at exponentially growing distances from 'begin' and binary searches
+// the last step. Skipping n rows takes O(log n) comparisons while not
+// skipping any takes one comparison, like a linear scan.
+template <typename IsBefore>
+vector_size_t
+gallop(vector_size_t begin, vector_size_t end, const IsBefore& isBefore) {
+  int64_t low = begin;
+  int64_t high = begin;
+  int64_t step = 1;
+  while (high < end && isBefore(high)) {
+    low = high + 1;
+    high = low + step;
+    step *= 2;
+  }
+  high = std::min<int64_t>(high, end);
+  while (low < high) {
+    const auto mid = low + (high - low) / 2;
+    if (isBefore(mid)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+} // namespace
+
+RowVectorPtr MergeJoin::trimToKeyRange(
+    RowVectorPtr input,
+    column_index_t key) const {
+  if (!hasKeyRange_) {
+    return input;
+  }
+  // Null keys sort after the upper bound of all but the last key range.
+  static constexpr CompareFlags kCompareFlags{false, true, false, false};
+  const auto& keys = input->childAt(key);
+  const auto numRows = input->size();
+  auto isBefore = [&](const VectorPtr& bound, vector_size_t row) {
+    return keys->compare(bound.get(), row, 0, kCompareFlags).value() < 0;
+  };
+
+  vector_size_t begin = 0;
+  if (keyRangeLowerBound_) {
+    begin = gallop(0, numRows, [&](auto row) {
+      return isBefore(keyRangeLowerBound_, row);
+    });
+  }
+  vector_size_t end = numRows;
+  if (keyRangeUpperBound_ && begin < numRows &&
+      !isBefore(keyRangeUpperBound_, numRows - 1)) {
+    end = gallop(begin, numRows - 1, [&](auto row) {
+      return isBefore(keyRangeUpperBound_, row);
+    });
+  }
+
+  if (begin == 0 && end == numRows) {
+    return input;
+  }
+  if (begin == end) {
+    return nullptr;
+  }
+  const auto numInRange = end - begin;
+  auto indices = allocateIndices(numInRange, pool());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  std::iota(rawIndices, rawIndices + numInRange, begin);
+  std::vector<VectorPtr> children;
+  children.reserve(input->childrenSize());
+  for (const auto& child : input->children()) {
+    children.push_back(
+        BaseVector::wrapInDictionary(nullptr, indices, numInRange, child));
+  }
+  return std::make_shared<RowVector>(
+      pool(), input->type(), nullptr, numInRange, std::move(children));
+}
+
 void MergeJoin::addInput(RowVectorPtr input) {
-  input_ = std::move(input);
+  input_ = trimToKeyRange(std::move(input), leftKeys_[0]);
+  if (!input_) {
+    // No rows in the key range of this split group.
+    return;
+  }
   index_ = 0;
+  leftKeyValues_ = rawBigintKeys(input_, leftKeys_);
+  leftKeysOrdered_ = hasOrderedKeys(input_, leftKeys_);
 
   if (leftJoinTracker_) {
     leftJoinTracker_->resetLastVector();
@@ -170,9 +311,23 @@ bool MergeJoin::findEndOfMatch(
   auto numInput = input->size();
 
   vector_size_t endIndex = 0;
-  while (endIndex < numInput &&
-         compare(keys, input, endIndex, keys, prevInput, prevIndex) == 0) {
-    ++endIndex;
+  if (hasOrderedKeys(input, keys)) {
+    const auto* values = rawBigintKeys(input, keys);
+    const auto* prevValues = rawBigintKeys(prevInput, keys);
+    if (values && prevValues) {
+      const auto prevValue = prevValues[prevIndex];
+      endIndex = gallop(
+          0, numInput, [&](auto row) { return values[row] == prevValue; });
+    } else {
+      endIndex = gallop(0, numInput, [&](auto row) {
+        return compare(keys, input, row, keys, prevInput, prevIndex) == 0;
+      });
+    }
+  } else {
+    while (endIndex < numInput &&
+           compare(keys, input, endIndex, keys, prevInput, prevIndex) == 0) {
+      ++endIndex;
+    }
   }
 
   if (endIndex == numInput) {
@@ -376,6 +531,83 @@ vector_size_t firstNonNull(
 }
 } // namespace
 
+vector_size_t MergeJoin::skipLeft(vector_size_t begin) const {
+  const auto numRows = input_->size();
+  if (!leftKeysOrdered_) {
+    auto row = begin;
+    while (row < numRows &&
+           compare(
+               leftKeys_, input_, row, rightKeys_, rightInput_, rightIndex_) <
+               0) {
+      ++row;
+    }
+    return row;
+  }
+  if (leftKeyValues_ && rightKeyValues_) {
+    const auto rightValue = rightKeyValues_[rightIndex_];
+    return gallop(begin, numRows, [&](auto row) {
+      return leftKeyValues_[row] < rightValue;
+    });
+  }
+  return gallop(begin, numRows, [&](auto row) {
+    return compare(
+               leftKeys_, input_, row, rightKeys_, rightInput_, rightIndex_) <
+        0;
+  });
+}
+
+vector_size_t MergeJoin::skipRight(vector_size_t begin) const {
+  const auto numRows = rightInput_->size();
+  if (!rightKeysOrdered_) {
+    auto row = begin;
+    for (;;) {
+      row = firstNonNull(rightInput_, rightKeys_, row);
+      if (row == numRows ||
+          compare(leftKeys_, input_, index_, rightKeys_, rightInput_, row) <=
+              0) {
+        return row;
+      }
+      ++row;
+    }
+  }
+  if (leftKeyValues_ && rightKeyValues_) {
+    const auto leftValue = leftKeyValues_[index_];
+    return gallop(begin, numRows, [&](auto row) {
+      return rightKeyValues_[row] < leftValue;
+    });
+  }
+  return gallop(begin, numRows, [&](auto row) {
+    return compare(leftKeys_, input_, index_, rightKeys_, rightInput_, row) > 0;
+  });
+}
+
+vector_size_t MergeJoin::endOfLeftRun() const {
+  const auto numRows = input_->size();
+  if (!leftKeysOrdered_) {
+    auto row = index_ + 1;
+    while (row < numRows && compareLeft(row) == 0) {
+      ++row;
+    }
+    return row;
+  }
+  return gallop(
+      index_ + 1, numRows, [&](auto row) { return compareLeft(row) == 0; });
+}
+
+vector_size_t MergeJoin::endOfRightRun() const {
+  const auto numRows = rightInput_->size();
+  if (!rightKeysOrdered_) {
+    auto row = rightIndex_ + 1;
+    while (row < numRows && compareRight(row) == 0) {
+      ++row;
+    }
+    return row;
+  }
+  return gallop(rightIndex_ + 1, numRows, [&](auto row) {
+    return compareRight(row) == 0;
+  });
+}
+
 RowVectorPtr MergeJoin::getOutput() {
   // Make sure to have is-blocked or needs-input as true if returning null
   // output. Otherwise, Driver assumes the operator is finished.
@@ -416,6 +648,11 @@ RowVectorPtr MergeJoin::getOutput() {
         }
 
         if (rightInput_) {
+          rightInput_ = trimToKeyRange(std::move(rightInput_), rightKeys_[0]);
+        }
+        if (rightInput_) {
+          rightKeyValues_ = rawBigintKeys(rightInput_, rightKeys_);
+          rightKeysOrdered_ = hasOrderedKeys(rightInput_, rightKeys_);
           rightIndex_ = firstNonNull(rightInput_, rightKeys_);
           if (rightIndex_ == rightInput_->size()) {
             // Ran out of rows on the right side.
@@ -552,9 +789,12 @@ RowVectorPtr MergeJoin::doGetOutput() {
         }
 
         addOutputRowForLeftJoin(input_, index_);
+        ++index_;
+      } else {
+        // Rows without a match are not in the output of an inner join.
+        index_ = skipLeft(index_ + 1);
       }
 
-      ++index_;
       if (index_ == input_->size()) {
         // Ran out of rows on the left side.
         input_ = nullptr;
@@ -565,7 +805,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
 
     // Catch up rightInput_ with input_.
     while (compareResult > 0) {
-      rightIndex_ = firstNonNull(rightInput_, rightKeys_, rightIndex_ + 1);
+      rightIndex_ = skipRight(rightIndex_ + 1);
       if (rightIndex_ == rightInput_->size()) {
         // Ran out of rows on the right side.
         rightInput_ = nullptr;
@@ -577,10 +817,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
     if (compareResult == 0) {
       // Found a match. Identify all rows on the left and right that have the
       // matching keys.
-      vector_size_t endIndex = index_ + 1;
-      while (endIndex < input_->size() && compareLeft(endIndex) == 0) {
-        ++endIndex;
-      }
+      const auto endIndex = endOfLeftRun();
 
       if (endIndex == input_->size()) {
         // Matches continue in subsequent input. Load all lazies.
@@ -589,11 +826,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
       leftMatch_ = Match{
           {input_}, index_, endIndex, endIndex < input_->size(), std::nullopt};
 
-      vector_size_t endRightIndex = rightIndex_ + 1;
-      while (endRightIndex < rightInput_->size() &&
-             compareRight(endRightIndex) == 0) {
-        ++endRightIndex;
-      }
+      const auto endRightIndex = endOfRightRun();
 
       rightMatch_ = Match{
           {rightInput_},
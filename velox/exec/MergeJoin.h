@@ -51,6 +51,11 @@ class MergeJoin : public Operator {
 
   RowVectorPtr doGetOutput();
 
+  // Returns the rows of 'input' with the first join key at 'key' in the key
+  // range of the split group of this operator. Returns nullptr if there are
+  // no such rows.
+  RowVectorPtr trimToKeyRange(RowVectorPtr input, column_index_t key) const;
+
   static int32_t compare(
       const std::vector<column_index_t>& keys,
       const RowVectorPtr& batch,
@@ -59,23 +64,54 @@ class MergeJoin : public Operator {
       const RowVectorPtr& otherBatch,
       vector_size_t otherIndex);
 
+  static int32_t compare(int64_t value, int64_t otherValue) {
+    return value < otherValue ? -1 : (value == otherValue ? 0 : 1);
+  }
+
   // Compare rows on the left and right at index_ and rightIndex_ respectively.
   int32_t compare() const {
+    if (leftKeyValues_ && rightKeyValues_) {
+      return compare(leftKeyValues_[index_], rightKeyValues_[rightIndex_]);
+    }
     return compare(
         leftKeys_, input_, index_, rightKeys_, rightInput_, rightIndex_);
   }
 
   // Compare two rows on the left: index_ and index.
   int32_t compareLeft(vector_size_t index) const {
+    if (leftKeyValues_) {
+      return compare(leftKeyValues_[index_], leftKeyValues_[index]);
+    }
     return compare(leftKeys_, input_, index_, leftKeys_, input_, index);
   }
 
   // Compare two rows on the right: rightIndex_ and index.
   int32_t compareRight(vector_size_t index) const {
+    if (rightKeyValues_) {
+      return compare(rightKeyValues_[rightIndex_], rightKeyValues_[index]);
+    }
     return compare(
         rightKeys_, rightInput_, rightIndex_, rightKeys_, rightInput_, index);
   }
 
+  // Returns the first row at or after 'begin' of 'input_' with a key that is
+  // not less than the key at rightIndex_ of 'rightInput_'. Uses galloping
+  // search if 'leftKeysOrdered_'.
+  vector_size_t skipLeft(vector_size_t begin) const;
+
+  // Returns the first row at or after 'begin' of 'rightInput_' with non-null
+  // keys that are not less than the key at index_ of 'input_'. Uses galloping
+  // search if 'rightKeysOrdered_'.
+  vector_size_t skipRight(vector_size_t begin) const;
+
+  // Returns the end of the run of rows of 'input_' that starts at index_ and
+  // have the key of index_.
+  vector_size_t endOfLeftRun() const;
+
+  // Returns the end of the run of rows of 'rightInput_' that starts at
+  // rightIndex_ and have the key of rightIndex_.
+  vector_size_t endOfRightRun() const;
+
   // Compare two rows from the left side.
   int32_t compareLeft(
       const RowVectorPtr& batch,
@@ -379,6 +415,24 @@ class MergeJoin : public Operator {
   /// Row number on the right side (rightInput_) to process next.
   vector_size_t rightIndex_{0};
 
+  /// True if the join node has key range boundaries. Only rows with the first
+  /// key in [keyRangeLowerBound_, keyRangeUpperBound_) are joined then. The
+  /// bounds are null for the first and last key range.
+  bool hasKeyRange_{false};
+  VectorPtr keyRangeLowerBound_;
+  VectorPtr keyRangeUpperBound_;
+
+  /// Raw values of the single BIGINT key of 'input_' and 'rightInput_' if
+  /// flat without nulls, nullptr otherwise. The keys are then compared
+  /// without virtual calls.
+  const int64_t* leftKeyValues_{nullptr};
+  const int64_t* rightKeyValues_{nullptr};
+
+  /// True if the keys of 'input_' and 'rightInput_' are in ascending order of
+  /// compare(), so that runs of keys can be skipped with galloping search.
+  bool leftKeysOrdered_{false};
+  bool rightKeysOrdered_{false};
+
   /// A set of rows with matching keys on the left side.
   std::optional<Match> leftMatch_;
 
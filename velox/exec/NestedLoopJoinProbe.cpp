@@ -42,6 +42,64 @@ std::vector<IdentityProjection> extractProjections(
   }
   return projections;
 }
+
+bool isIntegerType(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the channel of 'expr' in 'type' if 'expr' is a column of 'type'.
+std::optional<column_index_t> toChannel(
+    const core::TypedExprPtr& expr,
+    const RowTypePtr& type) {
+  auto* field = dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get());
+  if (field == nullptr || !field->isInputColumn()) {
+    return std::nullopt;
+  }
+  return type->getChildIdxIfExists(field->name());
+}
+
+template <typename T>
+void readIntegers(
+    const BaseVector& vector,
+    std::vector<int64_t>& values,
+    std::vector<bool>& nulls) {
+  DecodedVector decoded(vector);
+  const auto size = vector.size();
+  values.resize(size);
+  nulls.resize(size);
+  for (vector_size_t i = 0; i < size; ++i) {
+    nulls[i] = decoded.isNullAt(i);
+    values[i] = nulls[i] ? 0 : decoded.valueAt<T>(i);
+  }
+}
+
+// Reads the values of an integer 'vector' as int64_t. 'nulls' is true for
+// the null rows, for which 'values' is 0.
+void readIntegers(
+    const BaseVector& vector,
+    std::vector<int64_t>& values,
+    std::vector<bool>& nulls) {
+  switch (vector.typeKind()) {
+    case TypeKind::TINYINT:
+      return readIntegers<int8_t>(vector, values, nulls);
+    case TypeKind::SMALLINT:
+      return readIntegers<int16_t>(vector, values, nulls);
+    case TypeKind::INTEGER:
+      return readIntegers<int32_t>(vector, values, nulls);
+    case TypeKind::BIGINT:
+      return readIntegers<int64_t>(vector, values, nulls);
+    default:
+      VELOX_UNREACHABLE(vector.type()->toString());
+  }
+}
 } // namespace
 
 NestedLoopJoinProbe::NestedLoopJoinProbe(
@@ -66,9 +124,89 @@ NestedLoopJoinProbe::NestedLoopJoinProbe(
         joinNode->joinCondition(),
         joinNode->sources()[0]->outputType(),
         joinNode->sources()[1]->outputType());
+    rangeCondition_ =
+        toRangeCondition(joinNode->joinCondition(), probeType, buildType);
   }
 }
 
+// static
+std::optional<NestedLoopJoinProbe::RangeCondition>
+NestedLoopJoinProbe::toRangeCondition(
+    const core::TypedExprPtr& filter,
+    const RowTypePtr& probeType,
+    const RowTypePtr& buildType) {
+  auto* call = dynamic_cast<const core::CallTypedExpr*>(filter.get());
+  if (call == nullptr) {
+    return std::nullopt;
+  }
+  std::optional<column_index_t> probeChannel;
+  std::optional<column_index_t> lowerChannel;
+  std::optional<column_index_t> upperChannel;
+  bool lowerInclusive{true};
+  bool upperInclusive{true};
+  if (call->name() == "between" && call->inputs().size() == 3) {
+    probeChannel = toChannel(call->inputs()[0], probeType);
+    lowerChannel = toChannel(call->inputs()[1], buildType);
+    upperChannel = toChannel(call->inputs()[2], buildType);
+  } else if (call->name() == "and" && call->inputs().size() == 2) {
+    for (const auto& input : call->inputs()) {
+      auto* comparison = dynamic_cast<const core::CallTypedExpr*>(input.get());
+      if (comparison == nullptr || comparison->inputs().size() != 2) {
+        return std::nullopt;
+      }
+      const auto& name = comparison->name();
+      const bool less = name == "lt" || name == "lte";
+      if (!less && name != "gt" && name != "gte") {
+        return std::nullopt;
+      }
+      const bool inclusive = name == "lte" || name == "gte";
+      // Normalizes to 'probe key <op> build column'.
+      auto probe = toChannel(comparison->inputs()[0], probeType);
+      auto build = toChannel(comparison->inputs()[1], buildType);
+      bool upper = less;
+      if (!probe.has_value() || !build.has_value()) {
+        probe = toChannel(comparison->inputs()[1], probeType);
+        build = toChannel(comparison->inputs()[0], buildType);
+        upper = !less;
+      }
+      if (!probe.has_value() || !build.has_value() ||
+          (probeChannel.has_value() && probeChannel != probe)) {
+        return std::nullopt;
+      }
+      probeChannel = probe;
+      if (upper) {
+        if (upperChannel.has_value()) {
+          return std::nullopt;
+        }
+        upperChannel = build;
+        upperInclusive = inclusive;
+      } else {
+        if (lowerChannel.has_value()) {
+          return std::nullopt;
+        }
+        lowerChannel = build;
+        lowerInclusive = inclusive;
+      }
+    }
+  }
+  if (!probeChannel.has_value() || !lowerChannel.has_value() ||
+      !upperChannel.has_value()) {
+    return std::nullopt;
+  }
+  const auto& keyType = probeType->childAt(probeChannel.value());
+  if (!isIntegerType(keyType) ||
+      !keyType->equivalent(*buildType->childAt(lowerChannel.value())) ||
+      !keyType->equivalent(*buildType->childAt(upperChannel.value()))) {
+    return std::nullopt;
+  }
+  return RangeCondition{
+      probeChannel.value(),
+      lowerChannel.value(),
+      upperChannel.value(),
+      lowerInclusive,
+      upperInclusive};
+}
+
 BlockingReason NestedLoopJoinProbe::isBlocked(ContinueFuture* future) {
   switch (state_) {
     case ProbeOperatorState::kRunning:
@@ -82,6 +220,10 @@ BlockingReason NestedLoopJoinProbe::isBlocked(ContinueFuture* future) {
       }
       VELOX_CHECK(buildVectors_.has_value());
 
+      if (rangeCondition_.has_value()) {
+        buildRangeIndexes();
+      }
+
       if (needsBuildMismatch(joinType_)) {
         buildMatched_.resize(buildVectors_->size());
         for (auto i = 0; i < buildVectors_->size(); ++i) {
@@ -105,6 +247,25 @@ void NestedLoopJoinProbe::close() {
   Operator::close();
 }
 
+bool NestedLoopJoinProbe::canReclaim() const {
+  if (state_ == ProbeOperatorState::kFinish) {
+    return false;
+  }
+  auto* driver = operatorCtx_->driver();
+  return driver != nullptr && !driver->isOnThread();
+}
+
+void NestedLoopJoinProbe::reclaim(uint64_t /*unused*/) {
+  VELOX_CHECK(canReclaim());
+  VELOX_CHECK(operatorCtx_->task()->pauseRequested());
+
+  probeOutMapping_ = nullptr;
+  probeIndices_ = nullptr;
+  buildIndices_ = nullptr;
+  buildOutMapping_ = nullptr;
+  operatorCtx_->clearCachedVectors();
+}
+
 void NestedLoopJoinProbe::addInput(RowVectorPtr input) {
   // In getOutput(), we are going to wrap input in dictionaries a few rows at a
   // time. Since lazy vectors cannot be wrapped in different dictionaries, we
@@ -117,6 +278,12 @@ void NestedLoopJoinProbe::addInput(RowVectorPtr input) {
   if (needsProbeMismatch(joinType_)) {
     probeMatched_.resizeFill(input_->size(), false);
   }
+  if (rangeCondition_.has_value()) {
+    readIntegers(
+        *input_->childAt(rangeCondition_->probeChannel),
+        probeKeys_,
+        probeKeyNulls_);
+  }
 }
 
 RowVectorPtr NestedLoopJoinProbe::getOutput() {
@@ -162,8 +329,13 @@ RowVectorPtr NestedLoopJoinProbe::getOutput() {
       break;
     }
 
-    const vector_size_t probeCnt = getNumProbeRows();
-    output = doMatch(probeCnt);
+    vector_size_t probeCnt;
+    if (rangeCondition_.has_value()) {
+      output = doRangeMatch(probeCnt);
+    } else {
+      probeCnt = getNumProbeRows();
+      output = doMatch(probeCnt);
+    }
     if (advanceProbeRows(probeCnt)) {
       if (!needsProbeMismatch(joinType_)) {
         finishProbeInput();
@@ -320,6 +492,48 @@ bool NestedLoopJoinProbe::getBuildData(ContinueFuture* future) {
   return true;
 }
 
+void NestedLoopJoinProbe::buildRangeIndexes() {
+  VELOX_CHECK(rangeCondition_.has_value());
+  rangeIndexes_.resize(buildVectors_->size());
+  std::vector<int64_t> lowers;
+  std::vector<int64_t> uppers;
+  std::vector<bool> lowerNulls;
+  std::vector<bool> upperNulls;
+  std::vector<vector_size_t> order;
+  for (auto i = 0; i < buildVectors_->size(); ++i) {
+    const auto& vector = buildVectors_.value()[i];
+    readIntegers(
+        *vector->childAt(rangeCondition_->lowerChannel), lowers, lowerNulls);
+    readIntegers(
+        *vector->childAt(rangeCondition_->upperChannel), uppers, upperNulls);
+    order.clear();
+    for (vector_size_t row = 0; row < vector->size(); ++row) {
+      // A null bound never satisfies the condition.
+      if (!lowerNulls[row] && !upperNulls[row]) {
+        order.push_back(row);
+      }
+    }
+    std::sort(order.begin(), order.end(), [&](auto left, auto right) {
+      return lowers[left] < lowers[right];
+    });
+
+    auto& index = rangeIndexes_[i];
+    index.lowers.resize(order.size());
+    index.uppers.resize(order.size());
+    index.blockMaxUppers.assign(
+        bits::roundUp(order.size(), kRangeIndexBlockSize) /
+            kRangeIndexBlockSize,
+        std::numeric_limits<int64_t>::min());
+    for (auto j = 0; j < order.size(); ++j) {
+      index.lowers[j] = lowers[order[j]];
+      index.uppers[j] = uppers[order[j]];
+      auto& blockMax = index.blockMaxUppers[j / kRangeIndexBlockSize];
+      blockMax = std::max(blockMax, index.uppers[j]);
+    }
+    index.rows = order;
+  }
+}
+
 vector_size_t NestedLoopJoinProbe::getNumProbeRows() const {
   VELOX_CHECK_NOT_NULL(input_);
   VELOX_CHECK(!hasProbedAllBuildData());
@@ -439,6 +653,61 @@ RowVectorPtr NestedLoopJoinProbe::doMatch(vector_size_t probeCnt) {
       ++numOutputRows;
     }
   }
+  return getMatchedOutput(numOutputRows);
+}
+
+RowVectorPtr NestedLoopJoinProbe::doRangeMatch(vector_size_t& probeCnt) {
+  VELOX_CHECK_NOT_NULL(input_);
+  VELOX_CHECK(!hasProbedAllBuildData());
+
+  const auto& index = rangeIndexes_[buildIndex_];
+  const auto numRanges = index.rows.size();
+  // The last probe row may add up to all the ranges beyond the batch size.
+  const vector_size_t maxOutputRows = outputBatchSize_ + numRanges;
+  auto rawProbeOutMapping =
+      initializeRowNumberMapping(probeOutMapping_, maxOutputRows, pool());
+  auto rawBuildOutMapping =
+      initializeRowNumberMapping(buildOutMapping_, maxOutputRows, pool());
+  const bool lowerInclusive = rangeCondition_->lowerInclusive;
+  const bool upperInclusive = rangeCondition_->upperInclusive;
+  vector_size_t numOutputRows{0};
+  auto row = probeRow_;
+  for (; row < input_->size() && numOutputRows < outputBatchSize_; ++row) {
+    if (probeKeyNulls_[row]) {
+      continue;
+    }
+    const auto key = probeKeys_[row];
+    // The ranges that start at or before 'key' are a prefix of the index.
+    const auto end = lowerInclusive
+        ? std::upper_bound(index.lowers.begin(), index.lowers.end(), key)
+        : std::lower_bound(index.lowers.begin(), index.lowers.end(), key);
+    const auto numCandidates = end - index.lowers.begin();
+    for (auto begin = 0; begin < numCandidates;
+         begin += kRangeIndexBlockSize) {
+      const auto blockMax = index.blockMaxUppers[begin / kRangeIndexBlockSize];
+      if (upperInclusive ? blockMax < key : blockMax <= key) {
+        continue;
+      }
+      const auto blockEnd =
+          std::min<int64_t>(begin + kRangeIndexBlockSize, numCandidates);
+      for (auto i = begin; i < blockEnd; ++i) {
+        const auto upper = index.uppers[i];
+        if (upperInclusive ? key <= upper : key < upper) {
+          rawProbeOutMapping[numOutputRows] = row;
+          rawBuildOutMapping[numOutputRows] = index.rows[i];
+          ++numOutputRows;
+        }
+      }
+    }
+  }
+  probeCnt = row - probeRow_;
+  return getMatchedOutput(numOutputRows);
+}
+
+RowVectorPtr NestedLoopJoinProbe::getMatchedOutput(
+    vector_size_t numOutputRows) {
+  auto* rawProbeOutMapping = probeOutMapping_->as<vector_size_t>();
+  auto* rawBuildOutMapping = buildOutMapping_->as<vector_size_t>();
   if (needsProbeMismatch(joinType_)) {
     for (auto i = 0; i < numOutputRows; ++i) {
       probeMatched_.setValid(rawProbeOutMapping[i], true);
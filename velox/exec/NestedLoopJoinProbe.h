@@ -46,6 +46,13 @@ class NestedLoopJoinProbe : public Operator {
 
   void close() override;
 
+  /// A nested loop join probe operator which is blocked, e.g. waiting for the
+  /// build side, can free its row mapping buffers and cached vectors. These
+  /// are allocated again on demand in the next getOutput() call.
+  bool canReclaim() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   // TODO: maybe consolidate initializeFilter routine across operators like
   // HashProbe and MergeJoin.
@@ -54,8 +61,41 @@ class NestedLoopJoinProbe : public Operator {
       const RowTypePtr& leftType,
       const RowTypePtr& rightType);
 
+  // A join condition 'lower <= probe key <= upper', e.g. 'a BETWEEN b AND c',
+  // where the probe key is a probe side column and the bounds are build side
+  // columns of the same integer type. The comparisons may also be strict.
+  struct RangeCondition {
+    column_index_t probeChannel;
+    column_index_t lowerChannel;
+    column_index_t upperChannel;
+    bool lowerInclusive;
+    bool upperInclusive;
+  };
+
+  // The build rows of one build vector with non-null bounds, sorted by the
+  // lower bound.
+  struct RangeIndex {
+    std::vector<int64_t> lowers;
+    std::vector<int64_t> uppers;
+    std::vector<vector_size_t> rows;
+    // Max of 'uppers' in each block of kRangeIndexBlockSize entries, so that
+    // blocks of ranges which end before a probe key are skipped.
+    std::vector<int64_t> blockMaxUppers;
+  };
+
+  static constexpr int32_t kRangeIndexBlockSize = 64;
+
+  // Returns the range condition 'filter' is equivalent to, if any.
+  static std::optional<RangeCondition> toRangeCondition(
+      const core::TypedExprPtr& filter,
+      const RowTypePtr& probeType,
+      const RowTypePtr& buildType);
+
   bool getBuildData(ContinueFuture* future);
 
+  // Makes 'rangeIndexes_' from 'buildVectors_'.
+  void buildRangeIndexes();
+
   // Calculates the number of probe rows to match with the build side vectors
   // given the output batch size limit.
   vector_size_t getNumProbeRows() const;
@@ -80,6 +120,16 @@ class NestedLoopJoinProbe : public Operator {
   // buildMatched_ accordingly.
   RowVectorPtr doMatch(vector_size_t probeCnt);
 
+  // Matches the probe rows from 'probeRow_' on with the build vector at
+  // 'buildIndex_' using 'rangeCondition_'. Adds probe rows until the output
+  // has at least 'outputBatchSize_' rows or reaches the end of input_. Sets
+  // 'probeCnt' to the number of probe rows processed.
+  RowVectorPtr doRangeMatch(vector_size_t& probeCnt);
+
+  // Makes the output for the first 'numOutputRows' rows of 'probeOutMapping_'
+  // and 'buildOutMapping_' and updates probeMatched_ and buildMatched_.
+  RowVectorPtr getMatchedOutput(vector_size_t numOutputRows);
+
   // Updates 'probeRow_' and 'buildIndex_' by advancing 'probeRow_' by probeCnt.
   // Returns true if 'buildIndex_' points to the end of 'buildData_'.
   bool advanceProbeRows(vector_size_t probeCnt);
@@ -130,6 +180,14 @@ class NestedLoopJoinProbe : public Operator {
   std::unique_ptr<ExprSet> joinCondition_;
   RowTypePtr filterInputType_;
   SelectivityVector filterInputRows_;
+  // Set if the join condition is a range condition, which is then evaluated
+  // by binary search in 'rangeIndexes_' rather than on the cross product.
+  std::optional<RangeCondition> rangeCondition_;
+  // One for each element of 'buildVectors_'.
+  std::vector<RangeIndex> rangeIndexes_;
+  // Probe keys of the range condition for input_.
+  std::vector<int64_t> probeKeys_;
+  std::vector<bool> probeKeyNulls_;
 
   // Probe side state
   // Input row to process on next call to getOutput().
@@ -38,16 +38,25 @@ OperatorCtx::OperatorCtx(
 core::ExecCtx* OperatorCtx::execCtx() const {
   if (!execCtx_) {
     execCtx_ = std::make_unique<core::ExecCtx>(
-        pool_, driverCtx_->task->queryCtx().get());
+        pool_,
+        driverCtx_->task->queryCtx().get(),
+        &driverCtx_->vectorPool(pool_));
   }
   return execCtx_.get();
 }
 
+void OperatorCtx::clearCachedVectors() {
+  if (execCtx_ != nullptr) {
+    execCtx_->vectorPool().clear();
+  }
+}
+
 std::shared_ptr<connector::ConnectorQueryCtx>
 OperatorCtx::createConnectorQueryCtx(
     const std::string& connectorId,
     const std::string& planNodeId,
-    memory::MemoryPool* connectorPool) const {
+    memory::MemoryPool* connectorPool,
+    const SpillConfig* spillConfig) const {
   return std::make_shared<connector::ConnectorQueryCtx>(
       pool_,
       connectorPool,
@@ -57,7 +66,10 @@ OperatorCtx::createConnectorQueryCtx(
       driverCtx_->task->queryCtx()->allocator(),
       taskId(),
       planNodeId,
-      driverCtx_->driverId);
+      driverCtx_->driverId,
+      driverCtx_->queryConfig().cacheTenant(),
+      cache::cachePriorityFromName(driverCtx_->queryConfig().cachePriority()),
+      spillConfig);
 }
 
 Operator::Operator(
@@ -268,6 +280,11 @@ void Operator::recordBlockingTime(uint64_t start, BlockingReason reason) {
       fmt::format("blocked{}Times", blockReason), RuntimeCounter(1));
 }
 
+void Operator::sampleMemoryUsage(uint64_t timeMs, uint64_t minBucketMs) {
+  const uint64_t bytes = pool()->currentBytes();
+  stats_.wlock()->memoryTimeline.addSample(timeMs, bytes, minBucketMs);
+}
+
 std::string Operator::toString() const {
   std::stringstream out;
   if (auto task = operatorCtx_->task()) {
@@ -362,6 +379,7 @@ void OperatorStats::add(const OperatorStats& other) {
   finishTiming.add(other.finishTiming);
 
   memoryStats.add(other.memoryStats);
+  memoryTimeline.add(other.memoryTimeline);
 
   for (const auto& [name, stats] : other.runtimeStats) {
     if (UNLIKELY(runtimeStats.count(name) == 0)) {
@@ -373,6 +391,7 @@ void OperatorStats::add(const OperatorStats& other) {
 
   numDrivers += other.numDrivers;
   spilledBytes += other.spilledBytes;
+  spilledInputBytes += other.spilledInputBytes;
   spilledRows += other.spilledRows;
   spilledPartitions += other.spilledPartitions;
   spilledFiles += other.spilledFiles;
@@ -398,10 +417,71 @@ void OperatorStats::clear() {
   finishTiming.clear();
 
   memoryStats.clear();
+  memoryTimeline.clear();
 
   runtimeStats.clear();
 }
 
+void MemoryTimeline::addSample(
+    uint64_t timeMs,
+    uint64_t bytes,
+    uint64_t minBucketMs) {
+  if (bucketMs == 0) {
+    bucketMs = std::max<uint64_t>(minBucketMs, 1);
+  }
+  while (timeMs / bucketMs >= kMaxBuckets) {
+    coarsen();
+  }
+  const auto bucket = timeMs / bucketMs;
+  if (bucket >= maxBytes.size()) {
+    maxBytes.resize(bucket + 1, 0);
+  }
+  maxBytes[bucket] = std::max(maxBytes[bucket], bytes);
+  ++numSamples;
+}
+
+void MemoryTimeline::add(const MemoryTimeline& other) {
+  if (other.maxBytes.empty()) {
+    return;
+  }
+  if (bucketMs == 0) {
+    *this = other;
+    return;
+  }
+  while (bucketMs < other.bucketMs ||
+         (other.maxBytes.size() - 1) * other.bucketMs / bucketMs >=
+             kMaxBuckets) {
+    coarsen();
+  }
+  // Several buckets of 'other' may fall in one of 'this'. These hold the usage
+  // of the same Driver, so their maximum is added.
+  std::vector<uint64_t> otherBytes;
+  for (auto i = 0; i < other.maxBytes.size(); ++i) {
+    const auto bucket = i * other.bucketMs / bucketMs;
+    if (bucket >= otherBytes.size()) {
+      otherBytes.resize(bucket + 1, 0);
+    }
+    otherBytes[bucket] = std::max(otherBytes[bucket], other.maxBytes[i]);
+  }
+  if (otherBytes.size() > maxBytes.size()) {
+    maxBytes.resize(otherBytes.size(), 0);
+  }
+  for (auto i = 0; i < otherBytes.size(); ++i) {
+    maxBytes[i] += otherBytes[i];
+  }
+  numSamples += other.numSamples;
+}
+
+void MemoryTimeline::coarsen() {
+  for (auto i = 0; i < maxBytes.size(); i += 2) {
+    maxBytes[i / 2] = i + 1 < maxBytes.size()
+        ? std::max(maxBytes[i], maxBytes[i + 1])
+        : maxBytes[i];
+  }
+  maxBytes.resize((maxBytes.size() + 1) / 2);
+  bucketMs *= 2;
+}
+
 std::unique_ptr<memory::MemoryReclaimer> Operator::MemoryReclaimer::create(
     DriverCtx* driverCtx,
     Operator* op) {
@@ -80,6 +80,37 @@ struct MemoryStats {
   }
 };
 
+/// Usage of the memory pool of an operator sampled while its Drivers run, see
+/// 'operator_memory_sample_interval_ms'. Bucket i holds the highest sampled
+/// usage between i and i + 1 times 'bucketMs' after the start of the Task.
+/// When the timeline runs out of buckets, adjacent buckets are merged and
+/// 'bucketMs' doubles, so the size stays bounded however long the Task runs.
+struct MemoryTimeline {
+  static constexpr int32_t kMaxBuckets = 64;
+
+  uint64_t bucketMs{0};
+  std::vector<uint64_t> maxBytes;
+  uint64_t numSamples{0};
+
+  /// Adds a sample of a single Driver. 'minBucketMs' is the bucket width of
+  /// an empty timeline.
+  void addSample(uint64_t timeMs, uint64_t bytes, uint64_t minBucketMs);
+
+  /// Adds the usage of the operator in other Drivers. The usages of the same
+  /// bucket are summed.
+  void add(const MemoryTimeline& other);
+
+  void clear() {
+    bucketMs = 0;
+    maxBytes.clear();
+    numSamples = 0;
+  }
+
+ private:
+  // Merges pairs of adjacent buckets and doubles 'bucketMs'.
+  void coarsen();
+};
+
 struct OperatorStats {
   /// Initial ordinal position in the operator's pipeline.
   int32_t operatorId = 0;
@@ -126,9 +157,15 @@ struct OperatorStats {
 
   MemoryStats memoryStats;
 
+  MemoryTimeline memoryTimeline;
+
   // Total bytes written for spilling.
   uint64_t spilledBytes{0};
 
+  // Total in-memory bytes of the spilled rows before serialization and
+  // compression.
+  uint64_t spilledInputBytes{0};
+
   // Total rows written for spilling.
   uint64_t spilledRows{0};
 
@@ -207,16 +244,25 @@ class OperatorCtx {
     return operatorType_;
   }
 
+  /// Returns the context for expression evaluation. Its vector pool is the
+  /// one shared by the operators of the Driver, see DriverCtx::vectorPool().
   core::ExecCtx* execCtx() const;
 
+  /// Frees the vectors cached for reuse by the expression evaluation and the
+  /// operators of the Driver in 'execCtx()'. A noop if 'execCtx()' has not
+  /// been created.
+  void clearCachedVectors();
+
   /// Makes an extract of QueryCtx for use in a connector. 'planNodeId'
   /// is the id of the calling TableScan. This and the task id identify the scan
   /// for column access tracking. 'connectorPool' is an aggregate memory pool
-  /// for connector use.
+  /// for connector use. 'spillConfig' is set for a table write that may
+  /// spill and must outlive the returned context.
   std::shared_ptr<connector::ConnectorQueryCtx> createConnectorQueryCtx(
       const std::string& connectorId,
       const std::string& planNodeId,
-      memory::MemoryPool* connectorPool) const;
+      memory::MemoryPool* connectorPool,
+      const SpillConfig* spillConfig = nullptr) const;
 
  private:
   DriverCtx* const driverCtx_;
@@ -363,6 +409,12 @@ class Operator : public BaseRuntimeStatWriter {
         toString());
   }
 
+  // Called by the Driver when the operators downstream of 'this' need no more
+  // output, e.g. after a Limit has passed enough rows. The Driver does not ask
+  // 'this' for output after this call. Sources use this to stop fetching data
+  // that would be dropped.
+  virtual void noMoreOutputNeeded() {}
+
   // Returns a list of identify projections, e.g. columns that are projected
   // as-is possibly after applying a filter.
   const std::vector<IdentityProjection>& identityProjections() const {
@@ -406,6 +458,10 @@ class Operator : public BaseRuntimeStatWriter {
 
   void recordBlockingTime(uint64_t start, BlockingReason reason);
 
+  /// Adds the current usage of 'pool()' to the memory timeline of the stats.
+  /// 'timeMs' is the time since the start of the Task.
+  void sampleMemoryUsage(uint64_t timeMs, uint64_t minBucketMs);
+
   virtual std::string toString() const;
 
   velox::memory::MemoryPool* pool() const {
@@ -492,6 +548,16 @@ class Operator : public BaseRuntimeStatWriter {
   static std::vector<std::unique_ptr<PlanNodeTranslator>>& translators();
   friend class NonReclaimableSection;
 
+  /// Returns true if the Driver of 'this' has used up its time slice. An
+  /// operator with a long-running phase, e.g. a sort, checks this between
+  /// chunks of the work and returns from getOutput() without output if true.
+  /// The Driver then yields its thread and the work continues in the next
+  /// getOutput() call.
+  bool shouldYield() const {
+    auto* driver = operatorCtx_->driver();
+    return driver != nullptr && driver->shouldYield();
+  }
+
   class MemoryReclaimer : public memory::MemoryReclaimer {
    public:
     static std::unique_ptr<memory::MemoryReclaimer> create(
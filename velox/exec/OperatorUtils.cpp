@@ -416,4 +416,44 @@ void projectChildren(
         wrapChild(size, mapping, src[projection.inputChannel]);
   }
 }
+bool hasIntegerKeyPrefix(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint64_t integerKeyPrefix(
+    const BaseVector& vector,
+    vector_size_t index,
+    const CompareFlags& flags) {
+  if (vector.isNullAt(index)) {
+    return integerKeyPrefix(0, true, flags.ascending, flags.nullsFirst);
+  }
+  int64_t value;
+  switch (vector.typeKind()) {
+    case TypeKind::TINYINT:
+      value = vector.asUnchecked<SimpleVector<int8_t>>()->valueAt(index);
+      break;
+    case TypeKind::SMALLINT:
+      value = vector.asUnchecked<SimpleVector<int16_t>>()->valueAt(index);
+      break;
+    case TypeKind::INTEGER:
+      value = vector.asUnchecked<SimpleVector<int32_t>>()->valueAt(index);
+      break;
+    case TypeKind::BIGINT:
+      value = vector.asUnchecked<SimpleVector<int64_t>>()->valueAt(index);
+      break;
+    default:
+      VELOX_UNREACHABLE(
+          "No integer key prefix for {}", mapTypeKindToName(vector.typeKind()));
+  }
+  return integerKeyPrefix(value, false, flags.ascending, flags.nullsFirst);
+}
+
 } // namespace facebook::velox::exec
@@ -155,4 +155,16 @@ void projectChildren(
     int32_t size,
     const BufferPtr& mapping);
 
+/// Returns true if the keys of 'kind' have a key prefix made by
+/// integerKeyPrefix() for merging sorted streams, see MergeStream::keyPrefix().
+bool hasIntegerKeyPrefix(TypeKind kind);
+
+/// Returns the key prefix of the integer key in 'vector' at 'index' in the
+/// order given by 'flags'. hasIntegerKeyPrefix() must be true for the type of
+/// 'vector'.
+uint64_t integerKeyPrefix(
+    const BaseVector& vector,
+    vector_size_t index,
+    const CompareFlags& flags);
+
 } // namespace facebook::velox::exec
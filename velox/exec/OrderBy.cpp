@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 #include "velox/exec/OrderBy.h"
+#include <folly/ScopeGuard.h>
 #include "velox/common/testutil/TestValue.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
+#include "velox/exec/TreeOfLosers.h"
 #include "velox/vector/FlatVector.h"
 
 using facebook::velox::common::testutil::TestValue;
@@ -27,8 +30,60 @@ namespace {
 CompareFlags fromSortOrderToCompareFlags(const core::SortOrder& sortOrder) {
   return {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false};
 }
+
+bool isParallelSort(
+    const core::OrderByNode& orderByNode,
+    const core::QueryConfig& queryConfig) {
+  return !orderByNode.isPartial() && queryConfig.orderByParallelSortEnabled();
+}
+
 } // namespace
 
+// Sorted rows of one driver of a parallel sort or one run of a sort broken
+// into time slices. The RowContainers of all drivers are created with the
+// same types and have the same row layout, so the rows of any driver can be
+// compared and extracted with any container.
+class SortedRowsStream : public MergeStream {
+ public:
+  SortedRowsStream(
+      std::vector<char*> rows,
+      RowContainer* container,
+      const std::vector<CompareFlags>& compareFlags)
+      : rows_(std::move(rows)),
+        container_(container),
+        compareFlags_(compareFlags) {}
+
+  bool hasData() const override {
+    return index_ < rows_.size();
+  }
+
+  int32_t compare(const MergeStream& other) const override {
+    const auto* otherRow =
+        static_cast<const SortedRowsStream&>(other).current();
+    for (auto i = 0; i < compareFlags_.size(); ++i) {
+      if (auto result =
+              container_->compare(current(), otherRow, i, compareFlags_[i])) {
+        return result;
+      }
+    }
+    return 0;
+  }
+
+  char* current() const {
+    return rows_[index_];
+  }
+
+  void pop() {
+    ++index_;
+  }
+
+ private:
+  const std::vector<char*> rows_;
+  RowContainer* const container_;
+  const std::vector<CompareFlags>& compareFlags_;
+  size_t index_{0};
+};
+
 OrderBy::OrderBy(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -39,10 +94,12 @@ OrderBy::OrderBy(
           operatorId,
           orderByNode->id(),
           "OrderBy",
-          orderByNode->canSpill(driverCtx->queryConfig())
+          orderByNode->canSpill(driverCtx->queryConfig()) &&
+                  !isParallelSort(*orderByNode, driverCtx->queryConfig())
               ? driverCtx->makeSpillConfig(operatorId)
               : std::nullopt),
       numSortKeys_(orderByNode->sortingKeys().size()),
+      parallelSort_(isParallelSort(*orderByNode, driverCtx->queryConfig())),
       spillMemoryThreshold_(operatorCtx_->driverCtx()
                                 ->queryConfig()
                                 .orderBySpillMemoryThreshold()) {
@@ -88,6 +145,10 @@ OrderBy::OrderBy(
 
   // Create row container.
   data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  if (!spillConfig_.has_value()) {
+    // Rows are only erased when spilling.
+    data_->setAppendOnlyStrings();
+  }
   internalStoreType_ = ROW(std::move(names), std::move(types));
 #ifndef NDEBUG
   for (int i = 0; i < internalStoreType_->children().size(); ++i) {
@@ -244,7 +305,9 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig.maxFileSize,
         spillConfig.minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig.executor);
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.readAheadDepth);
     VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
   }
   spiller_->spill(targetRows, targetBytes);
@@ -253,6 +316,13 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
 void OrderBy::noMoreInput() {
   Operator::noMoreInput();
 
+  // Every driver of a parallel sort must reach the barrier, including the
+  // ones without data.
+  if (parallelSort_) {
+    finishParallelSort();
+    return;
+  }
+
   // No data.
   if (numRows_ == 0) {
     finished_ = true;
@@ -260,25 +330,15 @@ void OrderBy::noMoreInput() {
   }
 
   if (spiller_ == nullptr) {
-    VELOX_CHECK_EQ(numRows_, data_->numRows());
-    // Sort the pointers to the rows in RowContainer (data_) instead of sorting
-    // the rows.
-    returningRows_.resize(numRows_);
-    RowContainerIterator iter;
-    data_->listRows(&iter, numRows_, returningRows_.data());
-    std::sort(
-        returningRows_.begin(),
-        returningRows_.end(),
-        [this](const char* leftRow, const char* rightRow) {
-          for (vector_size_t index = 0; index < numSortKeys_; ++index) {
-            if (auto result = data_->compare(
-                    leftRow, rightRow, index, keyCompareFlags_[index])) {
-              return result < 0;
-            }
-          }
-          return false;
-        });
-
+    listRows();
+    // With a time slice the rows are sorted in runs that are merged, so that
+    // the sort can be interrupted between runs.
+    sortRunRows_ =
+        operatorCtx_->driverCtx()->queryConfig().driverTimeSliceMs() > 0
+        ? kSortRunRows
+        : numRows_;
+    sorting_ = true;
+    continueSort();
   } else {
     // Finish spill, and we shouldn't get any rows from non-spilled partition as
     // there is only one hash partition for orderBy operator.
@@ -293,6 +353,134 @@ void OrderBy::noMoreInput() {
   }
 }
 
+OrderBy::~OrderBy() = default;
+
+void OrderBy::listRows() {
+  VELOX_CHECK_EQ(numRows_, data_->numRows());
+  // Sort the pointers to the rows in RowContainer (data_) instead of sorting
+  // the rows.
+  returningRows_.resize(numRows_);
+  RowContainerIterator iter;
+  data_->listRows(&iter, numRows_, returningRows_.data());
+}
+
+void OrderBy::sortRows(size_t begin, size_t numRows) {
+  std::vector<std::pair<column_index_t, CompareFlags>> sortKeys;
+  sortKeys.reserve(numSortKeys_);
+  for (column_index_t index = 0; index < numSortKeys_; ++index) {
+    sortKeys.emplace_back(index, keyCompareFlags_[index]);
+  }
+  PrefixSort::sort(
+      *data_,
+      sortKeys,
+      folly::Range<char**>(returningRows_.data() + begin, numRows));
+}
+
+bool OrderBy::continueSort() {
+  VELOX_CHECK(sorting_);
+  while (numSortedRows_ < numRows_) {
+    const auto numRunRows = std::min(sortRunRows_, numRows_ - numSortedRows_);
+    sortRows(numSortedRows_, numRunRows);
+    numSortedRows_ += numRunRows;
+    if (numSortedRows_ < numRows_ && shouldYield()) {
+      return false;
+    }
+  }
+
+  if (numRows_ > sortRunRows_) {
+    if (sortMerge_ == nullptr) {
+      std::vector<std::unique_ptr<SortedRowsStream>> streams;
+      for (size_t begin = 0; begin < numRows_; begin += sortRunRows_) {
+        const auto end = std::min(begin + sortRunRows_, numRows_);
+        streams.push_back(std::make_unique<SortedRowsStream>(
+            std::vector<char*>(
+                returningRows_.begin() + begin, returningRows_.begin() + end),
+            data_.get(),
+            keyCompareFlags_));
+      }
+      sortMerge_ =
+          std::make_unique<TreeOfLosers<SortedRowsStream>>(std::move(streams));
+      mergedRows_.reserve(numRows_);
+    }
+    while (auto* stream = sortMerge_->next()) {
+      mergedRows_.push_back(stream->current());
+      stream->pop();
+      if (mergedRows_.size() % kMergeBatchRows == 0 && shouldYield()) {
+        return false;
+      }
+    }
+    VELOX_CHECK_EQ(mergedRows_.size(), numRows_);
+    sortMerge_.reset();
+    returningRows_ = std::move(mergedRows_);
+  }
+  sorting_ = false;
+  return true;
+}
+
+void OrderBy::finishParallelSort() {
+  VELOX_CHECK_NULL(spiller_);
+  listRows();
+  sortRows(0, numRows_);
+
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last driver to finish merges the sorted rows of all drivers. The
+  // other drivers are continued once it has taken over their rows and finish
+  // without output.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    VELOX_CHECK(future_.valid());
+    finished_ = true;
+    return;
+  }
+
+  auto promisesGuard = folly::makeGuard([&]() {
+    peers.clear();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  });
+
+  std::vector<std::unique_ptr<SortedRowsStream>> streams;
+  if (!returningRows_.empty()) {
+    streams.push_back(std::make_unique<SortedRowsStream>(
+        std::move(returningRows_), data_.get(), keyCompareFlags_));
+  }
+  for (auto& peer : peers) {
+    auto* peerOrderBy =
+        dynamic_cast<OrderBy*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(peerOrderBy);
+    if (peerOrderBy->numRows_ == 0) {
+      continue;
+    }
+    numRows_ += peerOrderBy->numRows_;
+    streams.push_back(std::make_unique<SortedRowsStream>(
+        std::move(peerOrderBy->returningRows_), data_.get(), keyCompareFlags_));
+    peerData_.push_back(std::move(peerOrderBy->data_));
+  }
+
+  returningRows_.clear();
+  if (streams.empty()) {
+    finished_ = true;
+    return;
+  }
+  returningRows_.reserve(numRows_);
+  TreeOfLosers<SortedRowsStream> merge(std::move(streams));
+  while (auto* stream = merge.next()) {
+    returningRows_.push_back(stream->current());
+    stream->pop();
+  }
+  VELOX_CHECK_EQ(numRows_, returningRows_.size());
+}
+
+BlockingReason OrderBy::isBlocked(ContinueFuture* future) {
+  if (future_.valid()) {
+    *future = std::move(future_);
+    return BlockingReason::kWaitForProducer;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
 void OrderBy::recordSpillStats() {
   VELOX_CHECK_NOT_NULL(spiller_);
   VELOX_CHECK(noMoreInput_);
@@ -300,6 +488,7 @@ void OrderBy::recordSpillStats() {
   const auto spillStats = spiller_->stats();
   auto lockedStats = stats_.wlock();
   lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledInputBytes = spillStats.spilledInputBytes;
   lockedStats->spilledRows = spillStats.spilledRows;
   lockedStats->spilledPartitions = spillStats.spilledPartitions;
   lockedStats->spilledFiles = spillStats.spilledFiles;
@@ -310,6 +499,9 @@ RowVectorPtr OrderBy::getOutput() {
   if (finished_ || !noMoreInput_ || numRows_ == numRowsReturned_) {
     return nullptr;
   }
+  if (sorting_ && !continueSort()) {
+    return nullptr;
+  }
   prepareOutput();
 
   if (spiller_ != nullptr) {
@@ -328,13 +520,19 @@ void OrderBy::getOutputWithoutSpill() {
   VELOX_DCHECK_EQ(numRows_, returningRows_.size());
   VELOX_DCHECK(!finished_);
 
+  std::vector<column_index_t> columns;
+  std::vector<VectorPtr> results;
+  columns.reserve(columnMap_.size());
+  results.reserve(columnMap_.size());
   for (const auto& columnProjection : columnMap_) {
-    data_->extractColumn(
-        returningRows_.data() + numRowsReturned_,
-        output_->size(),
-        columnProjection.inputChannel,
-        output_->childAt(columnProjection.outputChannel));
+    columns.push_back(columnProjection.inputChannel);
+    results.push_back(output_->childAt(columnProjection.outputChannel));
   }
+  data_->extractColumns(
+      returningRows_.data() + numRowsReturned_,
+      output_->size(),
+      columns,
+      results);
   numRowsReturned_ += output_->size();
 }
 
@@ -414,6 +612,8 @@ void OrderBy::close() {
 
   output_ = nullptr;
   spiller_.reset();
+  sortMerge_.reset();
   data_.reset();
+  peerData_.clear();
 }
 } // namespace facebook::velox::exec
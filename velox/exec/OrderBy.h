@@ -22,12 +22,25 @@
 
 namespace facebook::velox::exec {
 
+class SortedRowsStream;
+
 /// OrderBy operator implementation: OrderBy stores all its inputs in a
 /// RowContainer as the inputs are added. Until all inputs are available,
 /// it blocks the pipeline. Once all inputs are available, it sorts pointers
 /// to the rows using the RowContainer's compare() function. And finally it
 /// constructs and returns the sorted output RowVector using the data in the
 /// RowContainer.
+///
+/// A final OrderBy runs on multiple drivers if
+/// QueryConfig::orderByParallelSortEnabled() is set. Each driver sorts the rows
+/// of its own RowContainer. The last driver to finish takes over the sorted
+/// rows of its peers, merges them with a TreeOfLosers and produces all of the
+/// output. The other drivers finish without producing output.
+///
+/// If the query sets a 'driver_time_slice_ms', a serial OrderBy sorts its rows
+/// in runs of kSortRunRows and merges the runs, and getOutput() returns
+/// without output when the time slice of the Driver is used up between runs
+/// or merged batches. The sort continues in the next getOutput() call.
 /// Limitations:
 /// * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 /// output.
@@ -38,6 +51,14 @@ class OrderBy : public Operator {
       DriverCtx* FOLLY_NONNULL driverCtx,
       const std::shared_ptr<const core::OrderByNode>& orderByNode);
 
+  ~OrderBy() override;
+
+  /// Number of rows per sorted run of a sort broken into time slices.
+  static constexpr size_t kSortRunRows = 64 << 10;
+
+  /// Number of rows merged between checks for the end of the time slice.
+  static constexpr size_t kMergeBatchRows = 16 << 10;
+
   bool needsInput() const override {
     return !finished_;
   }
@@ -48,9 +69,7 @@ class OrderBy : public Operator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE /*future*/) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE future) override;
 
   bool isFinished() override {
     return finished_;
@@ -70,6 +89,23 @@ class OrderBy : public Operator {
   // remaining rows to return.
   void prepareOutput();
 
+  // Lists the pointers to the rows in 'data_' into 'returningRows_'.
+  void listRows();
+
+  // Sorts 'numRows' pointers of 'returningRows_' starting at 'begin'.
+  void sortRows(size_t begin, size_t numRows);
+
+  // Sorts the runs of 'returningRows_' that are not sorted yet and merges
+  // them. Returns false if the Driver should yield before the sort is
+  // complete. Can then be called again to continue.
+  bool continueSort();
+
+  // Sorts the rows of this driver and synchronizes with the peer drivers of a
+  // parallel sort. The last driver to get here merges the sorted rows of all
+  // peers into its 'returningRows_'. The other drivers wait on 'future_' and
+  // then finish.
+  void finishParallelSort();
+
   void getOutputWithoutSpill();
   void getOutputWithSpill();
 
@@ -86,6 +122,9 @@ class OrderBy : public Operator {
 
   const int32_t numSortKeys_;
 
+  // True if this is a final OrderBy sorting in parallel on multiple drivers.
+  const bool parallelSort_;
+
   // The maximum memory usage that an order by can hold before spilling.
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
@@ -118,6 +157,29 @@ class OrderBy : public Operator {
   // Used to collect sorted rows from 'data_' on non-spilling output path.
   std::vector<char*> returningRows_;
 
+  // True from noMoreInput() until 'returningRows_' are sorted on the
+  // non-spilling serial path.
+  bool sorting_{false};
+
+  // Number of rows per sorted run. All rows form a single run unless the
+  // query has a time slice.
+  size_t sortRunRows_{0};
+
+  // Number of leading rows of 'returningRows_' that are sorted in runs.
+  size_t numSortedRows_{0};
+
+  // Merges the sorted runs into 'mergedRows_' if there is more than one.
+  std::unique_ptr<TreeOfLosers<SortedRowsStream>> sortMerge_;
+  std::vector<char*> mergedRows_;
+
+  // RowContainers taken over from the peer drivers of a parallel sort. These
+  // keep the rows in 'returningRows_' that do not come from 'data_' alive.
+  std::vector<std::unique_ptr<RowContainer>> peerData_;
+
+  // Set by a driver of a parallel sort that waits for the last peer to take
+  // over its rows.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+
   std::unique_ptr<Spiller> spiller_;
 
   // Counts input batches and triggers spilling if folly hash of this % 100 <=
@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/Exchange.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 
 namespace facebook::velox::exec {
@@ -70,7 +71,14 @@ void Destination::serialize(
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    skipCompression_ = numCompressionSkips_ > 0;
+    if (skipCompression_) {
+      --numCompressionSkips_;
+    }
+    current_->createStreamTree(
+        rowType,
+        numRows,
+        skipCompression_ ? uncompressedSerdeOptions_ : serdeOptions_);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
@@ -90,6 +98,7 @@ BlockingReason Destination::flush(
       listener.get(),
       std::max<int64_t>(kMinMessageSize, current_->size()));
   current_->flush(&stream);
+  updateCompressionStats();
   current_.reset();
   bytesInCurrent_ = 0;
   setTargetSizePct();
@@ -101,6 +110,36 @@ BlockingReason Destination::flush(
       future);
 }
 
+void Destination::updateCompressionStats() {
+  if (serdeOptions_ == nullptr) {
+    return;
+  }
+  if (skipCompression_) {
+    runtimeStats_["compressionSkippedPages"].addValue(1);
+    return;
+  }
+  int64_t skippedBytes = 0;
+  for (const auto& [name, counter] : current_->runtimeStats()) {
+    auto it = runtimeStats_.find(name);
+    if (it == runtimeStats_.end()) {
+      it = runtimeStats_.emplace(name, RuntimeMetric(counter.unit)).first;
+    }
+    it->second.addValue(counter.value);
+    if (name == "compressionSkippedBytes") {
+      skippedBytes = counter.value;
+    }
+  }
+  if (skippedBytes > 0) {
+    // The page did not compress well. Do not spend time compressing the next
+    // pages.
+    numCompressionSkips_ = nextCompressionSkips_;
+    nextCompressionSkips_ =
+        std::min(2 * nextCompressionSkips_, kMaxCompressionSkips);
+  } else {
+    nextCompressionSkips_ = 1;
+  }
+}
+
 PartitionedOutput::PartitionedOutput(
     int32_t operatorId,
     DriverCtx* FOLLY_NONNULL ctx,
@@ -130,7 +169,13 @@ PartitionedOutput::PartitionedOutput(
       bufferReleaseFn_([task = operatorCtx_->task()]() {}),
       maxBufferedBytes_(ctx->task->queryCtx()
                             ->queryConfig()
-                            .maxPartitionedOutputBufferSize()) {
+                            .maxPartitionedOutputBufferSize()),
+      adaptivePageSize_(
+          ctx->queryConfig().partitionedOutputAdaptivePageSizeEnabled()),
+      serdeOptions_(makeExchangeSerdeOptions(ctx->queryConfig())),
+      uncompressedSerdeOptions_(makeExchangeSerdeOptions(
+          ctx->queryConfig(),
+          /*compressed=*/false)) {
   if (numDestinations_ == 1 || planNode->isBroadcast()) {
     VELOX_CHECK(keyChannels_.empty());
     VELOX_CHECK_NULL(partitionFunction_);
@@ -162,7 +207,12 @@ void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(std::make_unique<Destination>(taskId, i, pool()));
+      destinations_.push_back(std::make_unique<Destination>(
+          taskId,
+          i,
+          pool(),
+          serdeOptions_.get(),
+          uncompressedSerdeOptions_.get()));
     }
   }
 }
@@ -237,17 +287,27 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
             destination->addRow(i);
           }
         } else {
-          destinations_[partitions_[i]]->addRow(i);
+          addRow(i, partitions_[i]);
         }
       }
     } else {
       for (vector_size_t i = 0; i < numInput; ++i) {
-        destinations_[partitions_[i]]->addRow(i);
+        addRow(i, partitions_[i]);
       }
     }
   }
 }
 
+void PartitionedOutput::addRow(vector_size_t row, uint32_t partition) {
+  if (FOLLY_UNLIKELY(partition == core::PartitionFunction::kAllPartitions)) {
+    for (auto& destination : destinations_) {
+      destination->addRow(row);
+    }
+  } else {
+    destinations_[partition]->addRow(row);
+  }
+}
+
 void PartitionedOutput::collectNullRows() {
   auto size = input_->size();
   rows_.resize(size);
@@ -282,13 +342,27 @@ RowVectorPtr PartitionedOutput::getOutput() {
   VELOX_CHECK_NOT_NULL(
       bufferManager, "PartitionedOutputBufferManager was already destructed");
 
+  const bool useTargetPageSizes =
+      adaptivePageSize_ && destinations_.size() > 1;
+  if (useTargetPageSizes) {
+    bufferManager->getTargetPageSizes(
+        operatorCtx_->taskId(),
+        destinations_.size(),
+        maxBufferedBytes_,
+        kMinDestinationSize,
+        targetPageSizes_);
+    VELOX_CHECK_EQ(targetPageSizes_.size(), destinations_.size());
+  }
+
   bool workLeft;
   do {
     workLeft = false;
-    for (auto& destination : destinations_) {
+    for (auto i = 0; i < destinations_.size(); ++i) {
+      auto& destination = destinations_[i];
       bool atEnd = false;
       blockingReason_ = destination->advance(
-          maxBufferedBytes_ / destinations_.size(),
+          useTargetPageSizes ? targetPageSizes_[i]
+                             : maxBufferedBytes_ / destinations_.size(),
           rowSize_,
           output_,
           *bufferManager,
@@ -333,6 +407,7 @@ RowVectorPtr PartitionedOutput::getOutput() {
       destination->flush(*bufferManager, bufferReleaseFn_, nullptr);
       destination->setFinished();
     }
+    recordSerdeStats();
 
     bufferManager->noMoreData(operatorCtx_->task()->taskId());
     finished_ = true;
@@ -343,6 +418,20 @@ RowVectorPtr PartitionedOutput::getOutput() {
   return nullptr;
 }
 
+void PartitionedOutput::recordSerdeStats() {
+  auto lockedStats = stats_.wlock();
+  for (const auto& destination : destinations_) {
+    for (const auto& [name, metric] : destination->runtimeStats()) {
+      auto it = lockedStats->runtimeStats.find(name);
+      if (it == lockedStats->runtimeStats.end()) {
+        lockedStats->runtimeStats.emplace(name, metric);
+      } else {
+        it->second.merge(metric);
+      }
+    }
+  }
+}
+
 bool PartitionedOutput::isFinished() {
   return finished_;
 }
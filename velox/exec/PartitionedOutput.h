@@ -24,11 +24,21 @@ namespace facebook::velox::exec {
 
 class Destination {
  public:
+  // 'serdeOptions' are used to serialize the pages. nullptr means default
+  // options. 'uncompressedSerdeOptions' are used for the pages that skip
+  // compression.
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MemoryPool* FOLLY_NONNULL pool)
-      : taskId_(taskId), destination_(destination), pool_(pool) {
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      const VectorSerde::Options* FOLLY_NULLABLE serdeOptions = nullptr,
+      const VectorSerde::Options* FOLLY_NULLABLE uncompressedSerdeOptions =
+          nullptr)
+      : taskId_(taskId),
+        destination_(destination),
+        pool_(pool),
+        serdeOptions_(serdeOptions),
+        uncompressedSerdeOptions_(uncompressedSerdeOptions) {
     setTargetSizePct();
   }
 
@@ -72,7 +82,21 @@ class Destination {
     return bytesInCurrent_;
   }
 
+  // Returns the serializer stats, e.g. about compression, of the pages
+  // flushed so far.
+  const folly::F14FastMap<std::string, RuntimeMetric>& runtimeStats() const {
+    return runtimeStats_;
+  }
+
  private:
+  // Maximum number of consecutive pages that are sent without trying to
+  // compress them after a page did not compress well.
+  static constexpr int32_t kMaxCompressionSkips = 64;
+
+  // Adds the serializer stats of 'current_' to 'runtimeStats_' and decides
+  // whether to compress the next pages.
+  void updateCompressionStats();
+
   void
   serialize(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
 
@@ -92,6 +116,8 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MemoryPool* FOLLY_NONNULL const pool_;
+  const VectorSerde::Options* FOLLY_NULLABLE const serdeOptions_;
+  const VectorSerde::Options* FOLLY_NULLABLE const uncompressedSerdeOptions_;
   uint64_t bytesInCurrent_{0};
   std::vector<IndexRange> rows_;
 
@@ -111,6 +137,20 @@ class Destination {
 
   // Generator for varying target batch size. Randomly seeded at construction.
   folly::Random::DefaultGenerator rng_;
+
+  // True if 'current_' is serialized without compression because the
+  // previous pages did not compress well.
+  bool skipCompression_{false};
+
+  // Number of the next pages to send without trying to compress them.
+  int32_t numCompressionSkips_{0};
+
+  // Number of pages to skip compressing the next time a page does not
+  // compress well. Doubles up to kMaxCompressionSkips each time compression
+  // does not pay off and is reset when it does.
+  int32_t nextCompressionSkips_{1};
+
+  folly::F14FastMap<std::string, RuntimeMetric> runtimeStats_;
 };
 
 // In a distributed query engine data needs to be shuffled between workers so
@@ -170,6 +210,13 @@ class PartitionedOutput : public Operator {
 
   void estimateRowSizes();
 
+  // Adds 'row' to the destination for 'partition' or to all destinations if
+  // 'partition' is kAllPartitions.
+  void addRow(vector_size_t row, uint32_t partition);
+
+  // Adds the serializer stats of all destinations to the operator stats.
+  void recordSerdeStats();
+
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
@@ -182,6 +229,11 @@ class PartitionedOutput : public Operator {
   const std::weak_ptr<exec::PartitionedOutputBufferManager> bufferManager_;
   const std::function<void()> bufferReleaseFn_;
   const int64_t maxBufferedBytes_;
+  const bool adaptivePageSize_;
+  // Options for serializing the pages. nullptr if the serde defaults apply.
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
+  // Options for the pages that skip compression.
+  const std::unique_ptr<VectorSerde::Options> uncompressedSerdeOptions_;
 
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
   ContinueFuture future_;
@@ -193,6 +245,9 @@ class PartitionedOutput : public Operator {
   std::vector<vector_size_t*> sizePointers_;
   std::vector<vector_size_t> rowSize_;
   std::vector<std::unique_ptr<Destination>> destinations_;
+  // Target page size for each destination if 'adaptivePageSize_' is set. See
+  // PartitionedOutputBuffer::getTargetPageSizes().
+  std::vector<uint64_t> targetPageSizes_;
   bool replicatedAny_{false};
   RowVectorPtr output_;
 
@@ -174,6 +174,7 @@ std::vector<std::shared_ptr<SerializedPage>> DestinationBuffer::acknowledge(
       VELOX_CHECK_EQ(i, data_.size() - 1, "null marker found in the middle");
       break;
     }
+    consumedBytes_ += data_[i]->size();
     freed.push_back(std::move(data_[i]));
   }
   data_.erase(data_.begin(), data_.begin() + numDeleted);
@@ -609,6 +610,35 @@ void PartitionedOutputBuffer::getData(
   }
 }
 
+void PartitionedOutputBuffer::getTargetPageSizes(
+    uint64_t totalBytes,
+    uint64_t minBytes,
+    std::vector<uint64_t>& sizes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  const auto numBuffers = buffers_.size();
+  sizes.resize(numBuffers);
+  if (numBuffers == 0) {
+    return;
+  }
+  uint64_t totalConsumed = 0;
+  for (const auto& buffer : buffers_) {
+    if (buffer != nullptr) {
+      totalConsumed += buffer->consumedBytes();
+    }
+  }
+  const uint64_t evenShare = totalBytes / numBuffers;
+  for (auto i = 0; i < numBuffers; ++i) {
+    uint64_t size = evenShare;
+    if (totalConsumed > 0) {
+      const uint64_t consumed =
+          buffers_[i] == nullptr ? 0 : buffers_[i]->consumedBytes();
+      const double share = static_cast<double>(consumed) / totalConsumed;
+      size = evenShare / 2 + static_cast<uint64_t>(share * (totalBytes / 2));
+    }
+    sizes[i] = std::max(size, minBytes);
+  }
+}
+
 void PartitionedOutputBuffer::terminate() {
   VELOX_CHECK(!task_->isRunning());
 
@@ -729,6 +759,21 @@ bool PartitionedOutputBufferManager::getData(
   return false;
 }
 
+void PartitionedOutputBufferManager::getTargetPageSizes(
+    const std::string& taskId,
+    int numDestinations,
+    uint64_t totalBytes,
+    uint64_t minBytes,
+    std::vector<uint64_t>& sizes) {
+  if (auto buffer = getBufferIfExists(taskId)) {
+    buffer->getTargetPageSizes(totalBytes, minBytes, sizes);
+    return;
+  }
+  sizes.assign(
+      numDestinations,
+      std::max<uint64_t>(totalBytes / numDestinations, minBytes));
+}
+
 void PartitionedOutputBufferManager::initializeTask(
     std::shared_ptr<Task> task,
     PartitionedOutputBuffer::Kind kind,
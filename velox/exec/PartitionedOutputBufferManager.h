@@ -111,6 +111,11 @@ class DestinationBuffer {
   // Removes all remaining data from the queue and returns the removed data.
   std::vector<std::shared_ptr<SerializedPage>> deleteResults();
 
+  // Returns the bytes of data acknowledged by the consumer so far.
+  uint64_t consumedBytes() const {
+    return consumedBytes_;
+  }
+
   // Returns and clears the notify callback, if any, along with arguments for
   // the callback.
   DataAvailable getAndClearNotify();
@@ -125,6 +130,7 @@ class DestinationBuffer {
   // The sequence number of the first item to pass to 'notify'.
   int64_t notifySequence_{0};
   uint64_t notifyMaxBytes_{0};
+  uint64_t consumedBytes_{0};
 };
 
 class PartitionedOutputBuffer {
@@ -184,6 +190,16 @@ class PartitionedOutputBuffer {
       int64_t sequence,
       DataAvailableCallback notify);
 
+  /// Splits 'totalBytes' into a target page size per destination and
+  /// returns these in 'sizes'. Half of 'totalBytes' is split evenly and the
+  /// other half in proportion to the bytes each destination has consumed so
+  /// far, so that faster consumers get larger pages. No size is below
+  /// 'minBytes'.
+  void getTargetPageSizes(
+      uint64_t totalBytes,
+      uint64_t minBytes,
+      std::vector<uint64_t>& sizes);
+
   // Continues any possibly waiting producers. Called when the
   // producer task has an error or cancellation.
   void terminate();
@@ -330,6 +346,17 @@ class PartitionedOutputBufferManager {
 
   void deleteResults(const std::string& taskId, int destination);
 
+  /// Returns in 'sizes' the target page size for each destination of
+  /// 'taskId', see PartitionedOutputBuffer::getTargetPageSizes(). Splits
+  /// 'totalBytes' evenly over 'numDestinations' if there is no buffer for
+  /// 'taskId'.
+  void getTargetPageSizes(
+      const std::string& taskId,
+      int numDestinations,
+      uint64_t totalBytes,
+      uint64_t minBytes,
+      std::vector<uint64_t>& sizes);
+
   // Adds up to 'maxBytes' bytes worth of data for 'destination' from
   // 'taskId'. The sequence number of the data must be >= 'sequence'.
   // If there is no buffer associated with the given taskId, returns false.
@@ -72,6 +72,7 @@ void PlanNodeStats::addTotals(const OperatorStats& stats) {
   numSplits += stats.numSplits;
 
   spilledBytes += stats.spilledBytes;
+  spilledInputBytes += stats.spilledInputBytes;
   spilledRows += stats.spilledRows;
   spilledPartitions += stats.spilledPartitions;
   spilledFiles += stats.spilledFiles;
@@ -102,6 +102,10 @@ struct PlanNodeStats {
   /// Total bytes written for spilling.
   uint64_t spilledBytes{0};
 
+  /// Total in-memory bytes of the spilled rows before serialization and
+  /// compression.
+  uint64_t spilledInputBytes{0};
+
   /// Total rows written for spilling.
   uint64_t spilledRows{0};
 
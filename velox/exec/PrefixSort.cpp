@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+
+#include <folly/lang/Bits.h>
+
+namespace facebook::velox::exec {
+
+namespace {
+
+using SortKeys = std::vector<std::pair<column_index_t, CompareFlags>>;
+
+// Encoding of one sort key in the prefix. The key takes a null indicator
+// byte at 'offset' followed by 'size' bytes of value.
+struct KeyEncoding {
+  RowColumn column;
+  TypeKind kind;
+  CompareFlags flags;
+  int32_t offset;
+  int32_t size;
+};
+
+// Returns the encoded size of a fixed width key of 'kind' or std::nullopt if
+// 'kind' has no fixed width encoding.
+std::optional<int32_t> fixedEncodedSize(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+    case TypeKind::DATE:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return 8;
+    case TypeKind::TIMESTAMP:
+      // Seconds followed by nanos, which are below 10^9 and fit 4 bytes.
+      return 12;
+    default:
+      return std::nullopt;
+  }
+}
+
+PrefixSort::Layout makeEncodings(
+    const RowContainer& container,
+    const SortKeys& keys,
+    std::vector<KeyEncoding>* encodings) {
+  PrefixSort::Layout layout;
+  int32_t offset = 0;
+  for (const auto& [channel, flags] : keys) {
+    const auto kind = container.columnTypes()[channel]->kind();
+    if (auto size = fixedEncodedSize(kind)) {
+      if (offset + 1 + *size > PrefixSort::kMaxPrefixBytes) {
+        break;
+      }
+      if (encodings) {
+        encodings->push_back(
+            {container.columnAt(channel), kind, flags, offset, *size});
+      }
+      offset += 1 + *size;
+      ++layout.numEncodedKeys;
+      ++layout.numCompleteKeys;
+      continue;
+    }
+    if (kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY) {
+      // A string takes the rest of the prefix. Strings with equal prefixes
+      // may still differ, so the string and all keys after it are left to
+      // the full comparison.
+      const int32_t size = PrefixSort::kMaxPrefixBytes - offset - 1;
+      if (size > 0) {
+        if (encodings) {
+          encodings->push_back(
+              {container.columnAt(channel), kind, flags, offset, size});
+        }
+        offset += 1 + size;
+        ++layout.numEncodedKeys;
+      }
+    }
+    break;
+  }
+  layout.numPrefixBytes = offset;
+  return layout;
+}
+
+template <typename T>
+inline T loadValue(const char* row, int32_t offset) {
+  T value;
+  memcpy(&value, row + offset, sizeof(T));
+  return value;
+}
+
+template <typename U>
+inline void storeBigEndian(U value, uint8_t* out) {
+  value = folly::Endian::big(value);
+  memcpy(out, &value, sizeof(U));
+}
+
+// Flips the sign bit so that signed values order as unsigned.
+template <typename T>
+inline void encodeSigned(T value, uint8_t* out) {
+  using U = std::make_unsigned_t<T>;
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  storeBigEndian<U>(static_cast<U>(value) ^ kSignBit, out);
+}
+
+// Maps IEEE floating point values to unsigned integers of the same order.
+// NaNs are canonicalized to sort above infinity and -0.0 is folded into 0.0,
+// consistent with RowContainer::comparePrimitiveAsc().
+template <typename T, typename U>
+inline void encodeFloat(T value, uint8_t* out) {
+  if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  } else if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(T));
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  storeBigEndian<U>((bits & kSignBit) ? ~bits : bits | kSignBit, out);
+}
+
+void encodeString(StringView value, int32_t size, uint8_t* out) {
+  std::string storage;
+  auto contiguous = HashStringAllocator::contiguousString(value, storage);
+  // Bytes past the end of a short string stay zero, which orders a string
+  // before any longer string it is a prefix of.
+  memcpy(out, contiguous.data(), std::min<int32_t>(size, contiguous.size()));
+}
+
+// Encodes the keys of 'row' into 'out', which is expected to be zeroed.
+void encodeRow(
+    const std::vector<KeyEncoding>& encodings,
+    const char* row,
+    uint8_t* out) {
+  for (const auto& key : encodings) {
+    auto* indicator = out + key.offset;
+    const bool isNull = RowContainer::isNullAt(
+        row, key.column.nullByte(), key.column.nullMask());
+    *indicator = isNull == key.flags.nullsFirst ? 0 : 1;
+    if (isNull) {
+      continue;
+    }
+    auto* value = indicator + 1;
+    const auto offset = key.column.offset();
+    switch (key.kind) {
+      case TypeKind::BOOLEAN:
+        *value = loadValue<bool>(row, offset) ? 1 : 0;
+        break;
+      case TypeKind::TINYINT:
+        encodeSigned(loadValue<int8_t>(row, offset), value);
+        break;
+      case TypeKind::SMALLINT:
+        encodeSigned(loadValue<int16_t>(row, offset), value);
+        break;
+      case TypeKind::INTEGER:
+        encodeSigned(loadValue<int32_t>(row, offset), value);
+        break;
+      case TypeKind::BIGINT:
+        encodeSigned(loadValue<int64_t>(row, offset), value);
+        break;
+      case TypeKind::DATE:
+        encodeSigned(loadValue<Date>(row, offset).days(), value);
+        break;
+      case TypeKind::REAL:
+        encodeFloat<float, uint32_t>(loadValue<float>(row, offset), value);
+        break;
+      case TypeKind::DOUBLE:
+        encodeFloat<double, uint64_t>(loadValue<double>(row, offset), value);
+        break;
+      case TypeKind::TIMESTAMP: {
+        const auto timestamp = loadValue<Timestamp>(row, offset);
+        encodeSigned(timestamp.getSeconds(), value);
+        storeBigEndian<uint32_t>(timestamp.getNanos(), value + 8);
+        break;
+      }
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        encodeString(loadValue<StringView>(row, offset), key.size, value);
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    if (!key.flags.ascending) {
+      for (auto i = 0; i < key.size; ++i) {
+        value[i] = ~value[i];
+      }
+    }
+  }
+}
+
+// The comparisons of the sort keys, with the type dispatch resolved once
+// per sort.
+using KeyCompares = std::vector<RowContainer::ColumnCompare>;
+
+KeyCompares makeKeyCompares(RowContainer& container, const SortKeys& keys) {
+  KeyCompares compares;
+  compares.reserve(keys.size());
+  for (const auto& key : keys) {
+    compares.push_back(container.columnCompare(key.first));
+  }
+  return compares;
+}
+
+int32_t compareKeys(
+    RowContainer& container,
+    const SortKeys& keys,
+    const KeyCompares& compares,
+    int32_t firstKey,
+    const char* left,
+    const char* right) {
+  for (auto i = firstKey; i < keys.size(); ++i) {
+    if (auto result = compares[i](
+            container, left, right, keys[i].first, keys[i].second)) {
+      return result;
+    }
+  }
+  return 0;
+}
+
+// A row pointer with its normalized key prefix held as big endian words, so
+// that comparing the words in order compares the prefix bytes.
+template <int32_t kNumWords>
+struct Entry {
+  uint64_t prefix[kNumWords];
+  char* row;
+};
+
+template <int32_t kNumWords>
+void sortWithPrefix(
+    RowContainer& container,
+    const SortKeys& keys,
+    const KeyCompares& compares,
+    const std::vector<KeyEncoding>& encodings,
+    int32_t numCompleteKeys,
+    folly::Range<char**> rows) {
+  std::vector<Entry<kNumWords>> entries(rows.size());
+  uint8_t buffer[kNumWords * sizeof(uint64_t)];
+  for (auto i = 0; i < rows.size(); ++i) {
+    memset(buffer, 0, sizeof(buffer));
+    encodeRow(encodings, rows[i], buffer);
+    auto& entry = entries[i];
+    for (auto word = 0; word < kNumWords; ++word) {
+      entry.prefix[word] = folly::Endian::big(
+          loadValue<uint64_t>(reinterpret_cast<char*>(buffer), word * 8));
+    }
+    entry.row = rows[i];
+  }
+
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [&](const Entry<kNumWords>& left, const Entry<kNumWords>& right) {
+        for (auto word = 0; word < kNumWords; ++word) {
+          if (left.prefix[word] != right.prefix[word]) {
+            return left.prefix[word] < right.prefix[word];
+          }
+        }
+        return compareKeys(
+                   container,
+                   keys,
+                   compares,
+                   numCompleteKeys,
+                   left.row,
+                   right.row) < 0;
+      });
+
+  for (auto i = 0; i < rows.size(); ++i) {
+    rows[i] = entries[i].row;
+  }
+}
+} // namespace
+
+// static
+PrefixSort::Layout PrefixSort::layout(
+    const RowContainer& container,
+    const SortKeys& keys) {
+  return makeEncodings(container, keys, nullptr);
+}
+
+// static
+void PrefixSort::sort(
+    RowContainer& container,
+    const SortKeys& keys,
+    folly::Range<char**> rows) {
+  if (rows.size() < 2) {
+    return;
+  }
+  std::vector<KeyEncoding> encodings;
+  const auto layout = makeEncodings(container, keys, &encodings);
+  const auto compares = makeKeyCompares(container, keys);
+  switch (bits::roundUp(layout.numPrefixBytes, 8) / 8) {
+    case 0:
+      std::sort(rows.begin(), rows.end(), [&](const char* l, const char* r) {
+        return compareKeys(container, keys, compares, 0, l, r) < 0;
+      });
+      break;
+    case 1:
+      sortWithPrefix<1>(
+          container, keys, compares, encodings, layout.numCompleteKeys, rows);
+      break;
+    case 2:
+      sortWithPrefix<2>(
+          container, keys, compares, encodings, layout.numCompleteKeys, rows);
+      break;
+    case 3:
+      sortWithPrefix<3>(
+          container, keys, compares, encodings, layout.numCompleteKeys, rows);
+      break;
+    case 4:
+      sortWithPrefix<4>(
+          container, keys, compares, encodings, layout.numCompleteKeys, rows);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Sorts pointers to rows of a RowContainer using normalized key prefixes. A
+/// prefix of the sort keys is encoded into a fixed width, binary comparable
+/// key stored next to each row pointer. Most comparisons are then a few word
+/// compares on contiguous memory instead of type dispatched reads from the
+/// rows. Rows with equal prefixes are ordered by the RowContainer comparison
+/// of the keys the prefix does not fully cover.
+///
+/// Fixed width scalar keys are encoded in full. A string key is truncated to
+/// the remaining prefix space and ends the prefix. A key of any other type
+/// ends the prefix. If the first key cannot be encoded, the rows are sorted by
+/// the RowContainer comparison alone.
+class PrefixSort {
+ public:
+  /// Maximum number of bytes of normalized key stored per row.
+  static constexpr int32_t kMaxPrefixBytes = 32;
+
+  /// Describes which sort keys are encoded in the prefix.
+  struct Layout {
+    /// Number of leading keys encoded in the prefix, in part or in full.
+    int32_t numEncodedKeys{0};
+    /// Number of leading keys whose order is fully determined by the prefix.
+    /// Rows with equal prefixes are compared starting at this key.
+    int32_t numCompleteKeys{0};
+    /// Size of the encoded prefix in bytes, including null indicators.
+    int32_t numPrefixBytes{0};
+  };
+
+  /// Sorts 'rows' of 'container' by 'keys'. Each key is a column index into
+  /// 'container' and the flags to compare that column with.
+  static void sort(
+      RowContainer& container,
+      const std::vector<std::pair<column_index_t, CompareFlags>>& keys,
+      folly::Range<char**> rows);
+
+  /// Returns how 'keys' of 'container' are encoded. Public for testing.
+  static Layout layout(
+      const RowContainer& container,
+      const std::vector<std::pair<column_index_t, CompareFlags>>& keys);
+};
+
+} // namespace facebook::velox::exec
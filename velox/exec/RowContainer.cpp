@@ -129,11 +129,12 @@ RowContainer::RowContainer(
   // is followed by a free bit which is set if the row is in a free
   // list. The accumulators come next, with size given by
   // Aggregate::accumulatorFixedWidthSize(). Dependent fields follow.
-  // These are non-key columns for hash join or order by. If there are variable
-  // length columns or accumulators, i.e. ones that allocate extra space, this
-  // space is tracked by a uint32_t after the dependent columns. If this is a
-  // hash join build side, the pointer to the next row with the same key is
-  // after the optional row size.
+  // These are non-key columns for hash join or order by. Boolean dependent
+  // fields take no space there but a bit after the free bit. If there are
+  // variable length columns or accumulators, i.e. ones that allocate extra
+  // space, this space is tracked by a uint32_t after the dependent columns.
+  // If this is a hash join build side, the pointer to the next row with the
+  // same key is after the optional row size.
   //
   // In most cases, rows are prefixed with a normalized_key_t at index
   // -1, 8 bytes below the pointer. This space is reserved for a 64
@@ -188,7 +189,15 @@ RowContainer::RowContainer(
   for (int32_t i = 0; i < nullOffsets_.size(); ++i) {
     nullOffsets_[i] += firstAggregateOffset * 8;
   }
-  int32_t nullBytes = bits::nbytes(nullOffsets_.size());
+  // The values of boolean dependents are bits after the free flag.
+  int32_t numFlags = nullOffsets_.size();
+  for (auto& type : dependentTypes) {
+    if (type->kind() == TypeKind::BOOLEAN) {
+      ++numFlags;
+    }
+  }
+  int32_t nullBytes = bits::nbytes(numFlags);
+  int32_t valueBit = nullOffset + firstAggregateOffset * 8;
   offset += nullBytes;
   for (const auto& accumulator : accumulators) {
     // Accumulator offset must be aligned by their alignment size.
@@ -197,6 +206,10 @@ RowContainer::RowContainer(
     offset += accumulator.fixedWidthSize();
   }
   for (auto& type : dependentTypes) {
+    if (type->kind() == TypeKind::BOOLEAN) {
+      offsets_.push_back(bitColumnOffset(valueBit++));
+      continue;
+    }
     offsets_.push_back(offset);
     offset += typeKindSize(type->kind());
   }
@@ -294,6 +307,11 @@ void RowContainer::freeVariableWidthFields(folly::Range<char**> rows) {
     switch (typeKinds_[i]) {
       case TypeKind::VARCHAR:
       case TypeKind::VARBINARY:
+        if (appendOnlyStrings_) {
+          // Freed with all other append-only strings in clear().
+          break;
+        }
+        [[fallthrough]];
       case TypeKind::ROW:
       case TypeKind::ARRAY:
       case TypeKind::MAP: {
@@ -437,9 +455,13 @@ int32_t RowContainer::compareStringAsc(
     StringView left,
     const DecodedVector& decoded,
     vector_size_t index) {
+  const auto right = decoded.valueAt<StringView>(index);
+  // Most comparisons are decided by the size and prefix kept in the row.
+  if (auto result = left.compareInlined(right)) {
+    return result.value();
+  }
   std::string storage;
-  return HashStringAllocator::contiguousString(left, storage)
-      .compare(decoded.valueAt<StringView>(index));
+  return HashStringAllocator::contiguousString(left, storage).compare(right);
 }
 
 // static
@@ -457,6 +479,9 @@ int RowContainer::compareComplexType(
 }
 
 int32_t RowContainer::compareStringAsc(StringView left, StringView right) {
+  if (auto result = left.compareInlined(right)) {
+    return result.value();
+  }
   std::string leftStorage;
   std::string rightStorage;
   return HashStringAllocator::contiguousString(left, leftStorage)
@@ -503,7 +528,7 @@ void RowContainer::hashTyped(
   std::string storage;
   auto numRows = rows.size();
   for (int32_t i = 0; i < numRows; ++i) {
-    char* row = rows[i];
+    const char* row = rows[i];
     if (nullable && isNullAt(row, nullByte, nullMask)) {
       result[i] = mix ? bits::hashMix(result[i], BaseVector::kNullHash)
                       : BaseVector::kNullHash;
@@ -577,6 +602,35 @@ void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
   }
 }
 
+void RowContainer::extractColumns(
+    const char* const* rows,
+    int32_t numRows,
+    folly::Range<const column_index_t*> columnIndices,
+    folly::Range<const VectorPtr*> results) {
+  VELOX_CHECK_EQ(columnIndices.size(), results.size());
+  if (columnIndices.size() <= 1 || numRows <= kExtractColumnsBatchSize) {
+    for (auto i = 0; i < columnIndices.size(); ++i) {
+      extractColumn(rows, numRows, columnIndices[i], results[i]);
+    }
+    return;
+  }
+  for (const auto& result : results) {
+    result->resize(numRows);
+  }
+  for (auto offset = 0; offset < numRows; offset += kExtractColumnsBatchSize) {
+    const auto numBatchRows =
+        std::min<int32_t>(kExtractColumnsBatchSize, numRows - offset);
+    for (auto i = 0; i < columnIndices.size(); ++i) {
+      extractColumnNoResize(
+          rows + offset,
+          numBatchRows,
+          columnAt(columnIndices[i]),
+          offset,
+          results[i]);
+    }
+  }
+}
+
 void RowContainer::extractProbedFlags(
     const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
     int32_t numRows,
@@ -822,7 +876,13 @@ RowComparator::RowComparator(
         channel,
         kConstantChannel,
         "RowComparator doesn't allow constant comparison keys");
-    keyInfo_.push_back(std::make_pair(channel, sortingOrders[i]));
+    keys_.push_back(
+        {channel,
+         {sortingOrders[i].isNullsFirst(),
+          sortingOrders[i].isAscending(),
+          false},
+         rowContainer_->columnCompare(channel),
+         rowContainer_->decodedCompare(channel)});
   }
 }
 
@@ -830,12 +890,9 @@ bool RowComparator::operator()(const char* lhs, const char* rhs) {
   if (lhs == rhs) {
     return false;
   }
-  for (auto& key : keyInfo_) {
-    if (auto result = rowContainer_->compare(
-            lhs,
-            rhs,
-            key.first,
-            {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+  for (auto& key : keys_) {
+    if (auto result = key.compareRows(
+            *rowContainer_, lhs, rhs, key.channel, key.flags)) {
       return result < 0;
     }
   }
@@ -846,13 +903,14 @@ bool RowComparator::operator()(
     const std::vector<DecodedVector>& decodedVectors,
     vector_size_t index,
     const char* rhs) {
-  for (auto& key : keyInfo_) {
-    if (auto result = rowContainer_->compare(
+  for (auto& key : keys_) {
+    if (auto result = key.compareDecoded(
+            *rowContainer_,
             rhs,
-            rowContainer_->columnAt(key.first),
-            decodedVectors[key.first],
+            key.channel,
+            decodedVectors[key.channel],
             index,
-            {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+            key.flags)) {
       return result > 0;
     }
   }
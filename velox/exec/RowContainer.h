@@ -270,6 +270,16 @@ class RowContainer {
     return stringAllocator_;
   }
 
+  /// Copies the non-inline strings of keys and dependents of VARCHAR and
+  /// VARBINARY type into an append-only arena of the string allocator instead
+  /// of allocating them with free list headers. For containers whose rows are
+  /// not erased individually. The strings of erased or reused rows stay
+  /// allocated until clear(). Must be called before rows are stored.
+  void setAppendOnlyStrings() {
+    VELOX_CHECK_EQ(numRows_, 0);
+    appendOnlyStrings_ = true;
+  }
+
   // Returns the number of used rows in 'this'. This is the number of
   // rows a RowContainerIterator would access.
   int64_t numRows() const {
@@ -350,6 +360,17 @@ class RowContainer {
         rows, rowNumbers, columnAt(columnIndex), resultOffset, result);
   }
 
+  /// Copies the values at 'columnIndices' into the vectors at the same
+  /// positions in 'results' for the 'numRows' rows pointed to by 'rows'. Same
+  /// as calling extractColumn() for each column, but copies all columns for a
+  /// batch of rows before moving to the next batch, so that a row with many
+  /// columns is brought into the cache once instead of once per column.
+  void extractColumns(
+      const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
+      int32_t numRows,
+      folly::Range<const column_index_t*> columnIndices,
+      folly::Range<const VectorPtr*> results);
+
   /// Copies the 'probed' flags for the specified rows into 'result'.
   /// The 'result' is expected to be flat vector of type boolean.
   /// For rows with null keys, sets null in 'result' if 'setNullForNullKeysRow'
@@ -531,6 +552,40 @@ class RowContainer {
       int rightColumnIndex,
       CompareFlags flags = CompareFlags());
 
+  /// Compares the values at 'columnIndex' of 'left' and 'right' like
+  /// compare(left, right, columnIndex, flags).
+  using ColumnCompare = int32_t (*)(
+      RowContainer& container,
+      const char* FOLLY_NONNULL left,
+      const char* FOLLY_NONNULL right,
+      int32_t columnIndex,
+      CompareFlags flags);
+
+  /// Compares the value at 'columnIndex' of 'row' with the value at 'index'
+  /// in 'decoded' like compare(row, columnAt(columnIndex), decoded, index,
+  /// flags).
+  using DecodedCompare = int32_t (*)(
+      RowContainer& container,
+      const char* FOLLY_NONNULL row,
+      int32_t columnIndex,
+      const DecodedVector& decoded,
+      vector_size_t index,
+      CompareFlags flags);
+
+  /// Returns the comparison of the column at 'columnIndex' for its type.
+  /// Callers that compare many rows on the same columns, e.g. sort and top
+  /// N, resolve the type once per column instead of on every comparison.
+  ColumnCompare columnCompare(int32_t columnIndex) const {
+    return VELOX_DYNAMIC_TYPE_DISPATCH(
+        columnCompareTyped, types_[columnIndex]->kind());
+  }
+
+  /// Same as columnCompare() for comparing with decoded vectors.
+  DecodedCompare decodedCompare(int32_t columnIndex) const {
+    return VELOX_DYNAMIC_TYPE_DISPATCH(
+        decodedCompareTyped, types_[columnIndex]->kind());
+  }
+
   // Allows get/set of the normalized key. If normalized keys are
   // used, they are stored in the word immediately below the hash
   // table row.
@@ -666,6 +721,22 @@ class RowContainer {
   // Offset of the pointer to the next free row on a free row.
   static constexpr int32_t kNextFreeOffset = 0;
 
+  // Returns the offset of a boolean column stored as bit 'bit' of the row. The
+  // offset is negative to tell it from the byte offset of a boolean key.
+  static int32_t bitColumnOffset(int32_t bit) {
+    return -1 - bit;
+  }
+
+  // Stores 'value' in the byte or bit of a boolean column at 'offset'.
+  static inline void
+  storeBool(char* FOLLY_NONNULL row, int32_t offset, bool value) {
+    if (offset >= 0) {
+      *reinterpret_cast<bool*>(row + offset) = value;
+    } else {
+      bits::setBit(row, -1 - offset, value);
+    }
+  }
+
   template <typename T>
   static inline T valueAt(const char* FOLLY_NONNULL group, int32_t offset) {
     return *reinterpret_cast<const T*>(group + offset);
@@ -676,6 +747,48 @@ class RowContainer {
     return *reinterpret_cast<T*>(group + offset);
   }
 
+  // Number of rows extractColumns() copies for all columns before moving to
+  // the next rows. Small enough for the rows to stay in the L1 or L2 cache.
+  static constexpr int32_t kExtractColumnsBatchSize = 256;
+
+  // Same as the public extractColumn() but expects 'result' to already have
+  // at least 'resultOffset' + 'numRows' rows and does not resize it.
+  static void extractColumnNoResize(
+      const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
+      int32_t numRows,
+      RowColumn column,
+      int32_t resultOffset,
+      const VectorPtr& result);
+
+  template <TypeKind Kind>
+  static ColumnCompare columnCompareTyped() {
+    return [](RowContainer& container,
+              const char* left,
+              const char* right,
+              int32_t columnIndex,
+              CompareFlags flags) {
+      return container.compare<Kind>(
+          left,
+          right,
+          container.types_[columnIndex].get(),
+          container.columnAt(columnIndex),
+          flags);
+    };
+  }
+
+  template <TypeKind Kind>
+  static DecodedCompare decodedCompareTyped() {
+    return [](RowContainer& container,
+              const char* row,
+              int32_t columnIndex,
+              const DecodedVector& decoded,
+              vector_size_t index,
+              CompareFlags flags) {
+      return container.compare<Kind>(
+          row, container.columnAt(columnIndex), decoded, index, flags);
+    };
+  }
+
   template <TypeKind Kind>
   static void extractColumnTyped(
       const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
@@ -683,13 +796,26 @@ class RowContainer {
       int32_t numRows,
       RowColumn column,
       int32_t resultOffset,
-      const VectorPtr& result) {
+      const VectorPtr& result,
+      bool resizeResult = true) {
     if (rowNumbers.size() > 0) {
       extractColumnTypedInternal<true, Kind>(
-          rows, rowNumbers, rowNumbers.size(), column, resultOffset, result);
+          rows,
+          rowNumbers,
+          rowNumbers.size(),
+          column,
+          resultOffset,
+          result,
+          resizeResult);
     } else {
       extractColumnTypedInternal<false, Kind>(
-          rows, rowNumbers, numRows, column, resultOffset, result);
+          rows,
+          rowNumbers,
+          numRows,
+          column,
+          resultOffset,
+          result,
+          resizeResult);
     }
   }
 
@@ -700,9 +826,14 @@ class RowContainer {
       int32_t numRows,
       RowColumn column,
       int32_t resultOffset,
-      const VectorPtr& result) {
-    // Resize the result vector before all copies.
-    result->resize(numRows + resultOffset);
+      const VectorPtr& result,
+      bool resizeResult) {
+    if (resizeResult) {
+      // Resize the result vector before all copies.
+      result->resize(numRows + resultOffset);
+    } else {
+      VELOX_DCHECK_LE(numRows + resultOffset, result->size());
+    }
 
     if (Kind == TypeKind::ROW || Kind == TypeKind::ARRAY ||
         Kind == TypeKind::MAP) {
@@ -748,6 +879,14 @@ class RowContainer {
       int32_t nullByte,
       uint8_t nullMask) {
     using T = typename TypeTraits<Kind>::NativeType;
+    if constexpr (std::is_same_v<T, bool>) {
+      const bool isNull = decoded.isNullAt(index);
+      if (isNull) {
+        row[nullByte] |= nullMask;
+      }
+      storeBool(row, offset, !isNull && decoded.valueAt<bool>(index));
+      return;
+    }
     if (decoded.isNullAt(index)) {
       row[nullByte] |= nullMask;
       // Do not leave an uninitialized value in the case of a
@@ -758,7 +897,11 @@ class RowContainer {
     *reinterpret_cast<T*>(row + offset) = decoded.valueAt<T>(index);
     if constexpr (std::is_same_v<T, StringView>) {
       RowSizeTracker tracker(row[rowSizeOffset_], stringAllocator_);
-      stringAllocator_.copyMultipart(row, offset);
+      if (appendOnlyStrings_) {
+        stringAllocator_.copyAppendOnly(row, offset);
+      } else {
+        stringAllocator_.copyMultipart(row, offset);
+      }
     }
   }
 
@@ -769,10 +912,18 @@ class RowContainer {
       char* FOLLY_NONNULL group,
       int32_t offset) {
     using T = typename TypeTraits<Kind>::NativeType;
+    if constexpr (std::is_same_v<T, bool>) {
+      storeBool(group, offset, decoded.valueAt<bool>(index));
+      return;
+    }
     *reinterpret_cast<T*>(group + offset) = decoded.valueAt<T>(index);
     if constexpr (std::is_same_v<T, StringView>) {
       RowSizeTracker tracker(group[rowSizeOffset_], stringAllocator_);
-      stringAllocator_.copyMultipart(group, offset);
+      if (appendOnlyStrings_) {
+        stringAllocator_.copyAppendOnly(group, offset);
+      } else {
+        stringAllocator_.copyMultipart(group, offset);
+      }
     }
   }
 
@@ -882,8 +1033,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(valueAt<StringView>(row, offset), decoded, index);
     }
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
   }
@@ -901,8 +1051,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(valueAt<StringView>(row, offset), decoded, index);
     }
 
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
@@ -1057,6 +1206,19 @@ class RowContainer {
 
   static int32_t compareStringAsc(StringView left, StringView right);
 
+  // Returns true if 'left', a string stored in a row, equals the value at
+  // 'index' in 'decoded'. Strings of different sizes are unequal without
+  // reading the out of line part of 'left'.
+  static bool equalsString(
+      StringView left,
+      const DecodedVector& decoded,
+      vector_size_t index) {
+    if (left.size() != decoded.valueAt<StringView>(index).size()) {
+      return false;
+    }
+    return compareStringAsc(left, decoded, index) == 0;
+  }
+
   int32_t compareComplexType(
       const char* FOLLY_NONNULL row,
       int32_t offset,
@@ -1135,6 +1297,8 @@ class RowContainer {
 
   AllocationPool rows_;
   HashStringAllocator stringAllocator_;
+  // True if strings are stored with HashStringAllocator::copyAppendOnly().
+  bool appendOnlyStrings_{false};
 
   // Partition number for each row. Used only in parallel hash join build.
   std::unique_ptr<RowPartitions> partitions_;
@@ -1144,6 +1308,15 @@ class RowContainer {
   int alignment_ = 1;
 };
 
+template <>
+inline bool RowContainer::valueAt<bool>(
+    const char* FOLLY_NONNULL group,
+    int32_t offset) {
+  // A negative offset is a boolean stored as a bit, see bitColumnOffset().
+  return offset >= 0 ? *reinterpret_cast<const bool*>(group + offset)
+                     : bits::isBitSet(group, -1 - offset);
+}
+
 template <>
 inline int128_t RowContainer::valueAt<int128_t>(
     const char* FOLLY_NONNULL group,
@@ -1241,7 +1414,8 @@ inline void RowContainer::extractColumnTyped<TypeKind::OPAQUE>(
     int32_t /*numRows*/,
     RowColumn /*column*/,
     int32_t /*resultOffset*/,
-    const VectorPtr& /*result*/) {
+    const VectorPtr& /*result*/,
+    bool /*resizeResult*/) {
   VELOX_UNSUPPORTED("RowContainer doesn't support values of type OPAQUE");
 }
 
@@ -1262,6 +1436,24 @@ inline void RowContainer::extractColumn(
       result);
 }
 
+inline void RowContainer::extractColumnNoResize(
+    const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
+    int32_t numRows,
+    RowColumn column,
+    int32_t resultOffset,
+    const VectorPtr& result) {
+  VELOX_DYNAMIC_TYPE_DISPATCH_ALL(
+      extractColumnTyped,
+      result->typeKind(),
+      rows,
+      {},
+      numRows,
+      column,
+      resultOffset,
+      result,
+      false);
+}
+
 inline void RowContainer::extractColumn(
     const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
     folly::Range<const vector_size_t*> rowNumbers,
@@ -1367,7 +1559,15 @@ class RowComparator {
       const char* rhs);
 
  private:
-  std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+  // A sort key with the comparisons for its type resolved at construction.
+  struct Key {
+    column_index_t channel;
+    CompareFlags flags;
+    RowContainer::ColumnCompare compareRows;
+    RowContainer::DecodedCompare compareDecoded;
+  };
+
+  std::vector<Key> keys_;
   RowContainer* rowContainer_;
 };
 
@@ -15,6 +15,10 @@
  */
 #include "velox/exec/RowNumber.h"
 
+#include <numeric>
+
+#include "velox/exec/OperatorUtils.h"
+
 namespace facebook::velox::exec {
 
 RowNumber::RowNumber(
@@ -26,11 +30,19 @@ RowNumber::RowNumber(
           rowNumberNode->outputType(),
           operatorId,
           rowNumberNode->id(),
-          "RowNumber"),
-      limit_{rowNumberNode->limit()} {
-  const auto& inputType = rowNumberNode->sources()[0]->outputType();
+          "RowNumber",
+          rowNumberNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
+      limit_{rowNumberNode->limit()},
+      inputType_{rowNumberNode->sources()[0]->outputType()} {
+  const auto& inputType = inputType_;
   const auto& keys = rowNumberNode->partitionKeys();
   const auto numKeys = keys.size();
+  keyChannels_.reserve(numKeys);
+  for (const auto& key : keys) {
+    keyChannels_.push_back(exprToChannel(key.get(), inputType));
+  }
 
   if (numKeys > 0) {
     table_ = std::make_unique<HashTable<false>>(
@@ -57,33 +69,250 @@ RowNumber::RowNumber(
 }
 
 void RowNumber::addInput(RowVectorPtr input) {
-  const auto numInput = input->size();
-
   if (table_) {
-    SelectivityVector rows(numInput);
-    table_->prepareForProbe(*lookup_, input, rows, false);
-    table_->groupProbe(*lookup_);
+    // Test-only spill path.
+    if (spillConfig_.has_value() && spiller_ == nullptr &&
+        spillConfig_->testSpillPct &&
+        (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+            spillConfig_->testSpillPct) {
+      spill();
+    }
 
-    // Initialize new partitions with zeros.
-    for (auto i : lookup_->newGroups) {
-      setNumRows(lookup_->hits[i], 0);
+    if (inputSpiller_ != nullptr) {
+      spillInput(input);
+      return;
     }
+
+    // Prevents the memory arbitrator to reclaim memory from this operator
+    // while 'lookup_' refers to the rows of the hash table.
+    NonReclaimableSection guard(this);
+    addInputToTable(input);
   }
 
   input_ = std::move(input);
 }
 
+void RowNumber::addInputToTable(const RowVectorPtr& input) {
+  SelectivityVector rows(input->size());
+  table_->prepareForProbe(*lookup_, input, rows, false);
+  table_->groupProbe(*lookup_);
+
+  // Initialize new partitions with zeros.
+  for (auto i : lookup_->newGroups) {
+    setNumRows(lookup_->hits[i], 0);
+  }
+}
+
+void RowNumber::noMoreInput() {
+  Operator::noMoreInput();
+  if (spiller_ == nullptr) {
+    return;
+  }
+
+  spiller_->finishSpill(spillPartitionSet_);
+  inputSpiller_->finishSpill(spillInputPartitionSet_);
+  recordSpillStats();
+  restoreNextSpillPartition();
+}
+
+void RowNumber::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+
+  // NOTE: a row number operator is reclaimable if it hasn't finished input
+  // processing and is not under non-reclaimable execution section. Once the
+  // hash table is spilled, there is nothing left to reclaim as the following
+  // inputs are spilled as they come in.
+  if (noMoreInput_ || nonReclaimableSection_ || spiller_ != nullptr) {
+    LOG(WARNING) << "Can't reclaim from row number operator, noMoreInput_["
+                 << noMoreInput_ << "], nonReclaimableSection_["
+                 << nonReclaimableSection_ << "], spilled["
+                 << (spiller_ != nullptr) << "], " << toString();
+    return;
+  }
+
+  spill();
+  // The rows of the input not yet numbered are no longer in the hash table.
+  if (input_ != nullptr) {
+    spillInput(input_);
+    input_ = nullptr;
+  }
+  // Release the minimum reserved memory.
+  pool()->release();
+}
+
+void RowNumber::spill() {
+  VELOX_CHECK_NULL(spiller_);
+  VELOX_CHECK_NOT_NULL(table_);
+
+  const auto& spillConfig = spillConfig_.value();
+  auto* rows = table_->rows();
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    names.push_back(inputType_->nameOf(keyChannels_[i]));
+    types.push_back(rows->columnTypes()[i]);
+  }
+  names.push_back("numRows");
+  types.push_back(BIGINT());
+
+  spiller_ = std::make_unique<Spiller>(
+      Spiller::Type::kRowNumber,
+      rows,
+      [&](folly::Range<char**> rows) { table_->erase(rows); },
+      ROW(std::move(names), std::move(types)),
+      spillConfig.hashBitRange,
+      0,
+      std::vector<CompareFlags>{},
+      spillConfig.filePath,
+      spillConfig.maxFileSize,
+      spillConfig.minSpillRunSize,
+      Spiller::spillPool(),
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.readAheadDepth);
+  // Spill all the partitions of the hash table.
+  std::vector<Spiller::SpillableStats> spillableStats;
+  spiller_->fillSpillRuns(spillableStats);
+  spiller_->spill();
+  table_->clear();
+
+  inputSpiller_ = std::make_unique<Spiller>(
+      Spiller::Type::kRowNumber,
+      inputType_,
+      spiller_->hashBits(),
+      spillConfig.filePath,
+      spillConfig.maxFileSize,
+      spillConfig.minSpillRunSize,
+      Spiller::spillPool(),
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.readAheadDepth);
+  inputSpiller_->setPartitionsSpilled(spiller_->state().spilledPartitionSet());
+  spillHashFunction_ = std::make_unique<HashPartitionFunction>(
+      inputSpiller_->hashBits(), inputType_, keyChannels_);
+}
+
+void RowNumber::spillInput(const RowVectorPtr& input) {
+  const auto numInput = input->size();
+  spillHashFunction_->partition(*input, spillPartitions_);
+
+  // Ensure vector are lazy loaded before spilling.
+  for (auto i = 0; i < input->childrenSize(); ++i) {
+    input->childAt(i)->loadedVector();
+  }
+
+  const auto numPartitions = spillHashFunction_->numPartitions();
+  std::vector<BufferPtr> indices(numPartitions);
+  std::vector<vector_size_t*> rawIndices(numPartitions);
+  std::vector<vector_size_t> numSpillInputs(numPartitions, 0);
+  for (auto row = 0; row < numInput; ++row) {
+    const auto partition = spillPartitions_[row];
+    if (indices[partition] == nullptr) {
+      indices[partition] = allocateIndices(numInput, pool());
+      rawIndices[partition] = indices[partition]->asMutable<vector_size_t>();
+    }
+    rawIndices[partition][numSpillInputs[partition]++] = row;
+  }
+
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    if (numSpillInputs[partition] == 0) {
+      continue;
+    }
+    inputSpiller_->spill(
+        partition,
+        wrap(numSpillInputs[partition], indices[partition], input));
+  }
+}
+
+void RowNumber::restoreNextSpillPartition() {
+  VELOX_CHECK_NULL(spillInputReader_);
+
+  table_->clear();
+  // NOTE: the spill partitions without spilled inputs have no rows to number
+  // and are skipped.
+  if (spillInputPartitionSet_.empty()) {
+    spillPartitionSet_.clear();
+    return;
+  }
+
+  auto inputIt = spillInputPartitionSet_.begin();
+  const auto partitionId = inputIt->first;
+  spillInputReader_ = inputIt->second->createReader();
+  spillInputPartitionSet_.erase(inputIt);
+
+  auto stateIt = spillPartitionSet_.find(partitionId);
+  if (stateIt == spillPartitionSet_.end()) {
+    return;
+  }
+  auto stateReader = stateIt->second->createReader();
+  spillPartitionSet_.erase(stateIt);
+
+  // Restore the number of rows of each partition. The partition keys of the
+  // spilled states are placed at their input channels to probe the hash table.
+  const auto numKeys = keyChannels_.size();
+  RowVectorPtr states;
+  while (stateReader->nextBatch(states)) {
+    const auto numStates = states->size();
+    std::vector<VectorPtr> children(inputType_->size());
+    for (auto i = 0; i < inputType_->size(); ++i) {
+      children[i] = BaseVector::createNullConstant(
+          inputType_->childAt(i), numStates, pool());
+    }
+    for (auto i = 0; i < numKeys; ++i) {
+      children[keyChannels_[i]] = states->childAt(i);
+    }
+    auto input = std::make_shared<RowVector>(
+        pool(), inputType_, nullptr, numStates, std::move(children));
+    addInputToTable(input);
+
+    DecodedVector numRowsVector(*states->childAt(numKeys));
+    for (auto i = 0; i < numStates; ++i) {
+      setNumRows(lookup_->hits[i], numRowsVector.valueAt<int64_t>(i));
+    }
+  }
+}
+
+void RowNumber::recordSpillStats() {
+  VELOX_CHECK_NOT_NULL(spiller_);
+  VELOX_CHECK(noMoreInput_);
+
+  auto spillStats = spiller_->stats();
+  spillStats += inputSpiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledInputBytes = spillStats.spilledInputBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  // The hash table and the inputs are spilled to the same partitions.
+  lockedStats->spilledPartitions = spiller_->stats().spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+}
+
 FlatVector<int64_t>& RowNumber::getOrCreateRowNumberVector(vector_size_t size) {
   VectorPtr& result = results_[0];
   if (result && result.unique()) {
     BaseVector::prepareForReuse(result, size);
   } else {
-    result = BaseVector::create(BIGINT(), size, pool());
+    // The previous row numbers are still referenced downstream. Takes a vector
+    // recycled by the operators of the Driver.
+    result = operatorCtx_->execCtx()->getVector(BIGINT(), size);
+    result->clearNulls(0, size);
   }
   return *result->as<FlatVector<int64_t>>();
 }
 
 RowVectorPtr RowNumber::getOutput() {
+  // Read the inputs of the restored spill partitions.
+  while (input_ == nullptr && spillInputReader_ != nullptr) {
+    RowVectorPtr input;
+    if (spillInputReader_->nextBatch(input)) {
+      addInputToTable(input);
+      input_ = std::move(input);
+    } else {
+      spillInputReader_.reset();
+      restoreNextSpillPartition();
+    }
+  }
+
   if (input_ == nullptr) {
     return nullptr;
   }
@@ -93,6 +322,10 @@ RowVectorPtr RowNumber::getOutput() {
     return getOutputForSinglePartition();
   }
 
+  // Prevents the memory arbitrator to reclaim memory from this operator while
+  // 'lookup_' refers to the rows of the hash table.
+  NonReclaimableSection guard(this);
+
   const auto numInput = input_->size();
 
   BufferPtr mapping;
@@ -104,22 +337,28 @@ RowVectorPtr RowNumber::getOutput() {
   }
 
   // Compute row numbers.
-  auto& rowNumbers = getOrCreateRowNumberVector(numInput);
-
-  for (auto i = 0; i < numInput; ++i) {
-    auto* partition = lookup_->hits[i];
-    const auto rowNumber = numRows(partition) + 1;
+  auto* rawRowNumbers =
+      getOrCreateRowNumberVector(numInput).mutableRawValues();
+  auto* partitions = lookup_->hits.data();
 
-    if (limit_) {
-      if (rowNumber > limit_) {
-        // Exceeded the limit for this partition. Drop rows.
-        continue;
+  if (limit_) {
+    const auto limit = limit_.value();
+    for (auto i = 0; i < numInput; ++i) {
+      auto* partition = partitions[i];
+      const auto rowNumber = numRows(partition) + 1;
+      // Drops the rows past the limit for their partition.
+      if (rowNumber <= limit) {
+        rawMapping[index++] = i;
+        rawRowNumbers[i] = rowNumber;
+        setNumRows(partition, rowNumber);
       }
-      rawMapping[index++] = i;
     }
-
-    rowNumbers.set(i, rowNumber);
-    setNumRows(partition, rowNumber);
+  } else {
+    for (auto i = 0; i < numInput; ++i) {
+      auto* partition = partitions[i];
+      rawRowNumbers[i] = numRows(partition) + 1;
+      setNumRows(partition, rawRowNumbers[i]);
+    }
   }
 
   RowVectorPtr output;
@@ -154,11 +393,10 @@ RowVectorPtr RowNumber::getOutputForSinglePartition() {
     numOutput = numInput;
   }
 
-  auto& rowNumbers = getOrCreateRowNumberVector(numOutput);
-
-  for (auto i = 0; i < numOutput; ++i) {
-    rowNumbers.set(i, ++numTotalInput_);
-  }
+  auto* rawRowNumbers =
+      getOrCreateRowNumberVector(numOutput).mutableRawValues();
+  std::iota(rawRowNumbers, rawRowNumbers + numOutput, numTotalInput_ + 1);
+  numTotalInput_ += numOutput;
 
   auto output = fillOutput(numOutput, nullptr);
   input_ = nullptr;
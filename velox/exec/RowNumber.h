@@ -15,11 +15,22 @@
  */
 #pragma once
 
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// Assigns row numbers to the input rows of each partition as they come in.
+/// The number of rows seen so far for each partition is kept in a hash table.
+///
+/// If spilling is enabled, the hash table is spilled to disk partitioned by
+/// the hash of the partition keys once memory needs to be reclaimed. From then
+/// on, the inputs are spilled to the same spill partitions instead of being
+/// processed. After all the inputs are received, the spill partitions are
+/// processed one at a time: the hash table is restored from the spilled
+/// partition states and the spilled inputs are numbered on top of them.
 class RowNumber : public Operator {
  public:
   RowNumber(
@@ -39,11 +50,35 @@ class RowNumber : public Operator {
     return BlockingReason::kNotBlocked;
   }
 
+  void noMoreInput() override;
+
   bool isFinished() override {
-    return (noMoreInput_ && input_ == nullptr) || finishedEarly_;
+    return (noMoreInput_ && input_ == nullptr &&
+            spillInputReader_ == nullptr) ||
+        finishedEarly_;
   }
 
+  void reclaim(uint64_t targetBytes) override;
+
  private:
+  // Adds 'input' to the hash table and initializes its new partitions.
+  void addInputToTable(const RowVectorPtr& input);
+
+  // Spills the hash table and sets up the spilling of the following inputs.
+  void spill();
+
+  // Spills 'input' to the spill partitions of its rows.
+  void spillInput(const RowVectorPtr& input);
+
+  // Restores the hash table from the next spill partition with spilled
+  // inputs and sets 'spillInputReader_' to read them. Resets
+  // 'spillInputReader_' if there are no more spill partitions.
+  void restoreNextSpillPartition();
+
+  // Invoked to record the spilling stats in operator stats after processing all
+  // the inputs.
+  void recordSpillStats();
+
   int64_t numRows(char* partition);
 
   void setNumRows(char* partition, int64_t numRows);
@@ -68,5 +103,34 @@ class RowNumber : public Operator {
   /// the input. This happens when there are no partitioning keys and the
   /// operator already received 'limit_' rows.
   bool finishedEarly_{false};
+
+  const RowTypePtr inputType_;
+
+  /// The input channels of the partition keys.
+  std::vector<column_index_t> keyChannels_;
+
+  /// Spills the partition keys and the number of rows of each partition in
+  /// the hash table.
+  std::unique_ptr<Spiller> spiller_;
+
+  /// Spills the inputs received after the hash table is spilled. Set together
+  /// with 'spiller_'.
+  std::unique_ptr<Spiller> inputSpiller_;
+
+  /// Computes the spill partitions of the inputs.
+  std::unique_ptr<HashPartitionFunction> spillHashFunction_;
+  std::vector<uint32_t> spillPartitions_;
+
+  /// Counts input batches and triggers spilling if folly hash of this % 100 <=
+  /// 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  /// The spilled hash table and inputs by spill partition.
+  SpillPartitionSet spillPartitionSet_;
+  SpillPartitionSet spillInputPartitionSet_;
+
+  /// Reads the spilled inputs of the spill partition restored into the hash
+  /// table.
+  std::unique_ptr<UnorderedStreamReader<BatchStream>> spillInputReader_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortBuffer.h"
+#include "velox/exec/PrefixSort.h"
+
+namespace facebook::velox::exec {
+
+SortBuffer::SortBuffer(
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& sortColumnIndices,
+    const std::vector<CompareFlags>& sortCompareFlags,
+    memory::MemoryPool* pool,
+    const std::optional<SpillConfig>& spillConfig)
+    : inputType_(inputType),
+      sortCompareFlags_(sortCompareFlags),
+      pool_(pool),
+      spillConfig_(spillConfig) {
+  VELOX_CHECK_GE(inputType_->size(), sortCompareFlags_.size());
+  VELOX_CHECK_GT(sortCompareFlags_.size(), 0);
+  VELOX_CHECK_EQ(sortColumnIndices.size(), sortCompareFlags_.size());
+
+  std::vector<TypePtr> sortedColumnTypes;
+  std::vector<TypePtr> nonSortedColumnTypes;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  std::unordered_set<column_index_t> sortedChannelSet;
+  // Stores the sort columns first in 'data_' so that the spilled runs can be
+  // merged on the leading key columns.
+  for (column_index_t i = 0; i < sortColumnIndices.size(); ++i) {
+    const auto channel = sortColumnIndices[i];
+    VELOX_CHECK_LT(channel, inputType_->size());
+    VELOX_CHECK(
+        sortedChannelSet.emplace(channel).second,
+        "Duplicate sort column {}",
+        inputType_->nameOf(channel));
+    columnMap_.emplace_back(i, channel);
+    sortedColumnTypes.push_back(inputType_->childAt(channel));
+    types.push_back(sortedColumnTypes.back());
+    names.push_back(inputType_->nameOf(channel));
+  }
+  for (column_index_t channel = 0, nextChannel = sortColumnIndices.size();
+       channel < inputType_->size();
+       ++channel) {
+    if (sortedChannelSet.count(channel) != 0) {
+      continue;
+    }
+    columnMap_.emplace_back(nextChannel++, channel);
+    nonSortedColumnTypes.push_back(inputType_->childAt(channel));
+    types.push_back(nonSortedColumnTypes.back());
+    names.push_back(inputType_->nameOf(channel));
+  }
+
+  data_ = std::make_unique<RowContainer>(
+      sortedColumnTypes, nonSortedColumnTypes, pool_);
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+}
+
+void SortBuffer::addInput(const RowVectorPtr& input) {
+  VELOX_CHECK(!noMoreInput_);
+  ensureInputFits(input);
+
+  SelectivityVector allRows(input->size());
+  std::vector<char*> rows(input->size());
+  for (auto row = 0; row < input->size(); ++row) {
+    rows[row] = data_->newRow();
+  }
+  for (const auto& columnProjection : columnMap_) {
+    DecodedVector decoded(
+        *input->childAt(columnProjection.outputChannel), allRows);
+    for (auto row = 0; row < input->size(); ++row) {
+      data_->store(decoded, row, rows[row], columnProjection.inputChannel);
+    }
+  }
+  numInputRows_ += allRows.size();
+}
+
+void SortBuffer::noMoreInput() {
+  VELOX_CHECK(!noMoreInput_);
+  noMoreInput_ = true;
+
+  if (numInputRows_ == 0) {
+    return;
+  }
+
+  if (spiller_ == nullptr) {
+    VELOX_CHECK_EQ(numInputRows_, data_->numRows());
+    sortedRows_.resize(numInputRows_);
+    RowContainerIterator iter;
+    data_->listRows(&iter, numInputRows_, sortedRows_.data());
+    std::vector<std::pair<column_index_t, CompareFlags>> sortKeys;
+    sortKeys.reserve(sortCompareFlags_.size());
+    for (column_index_t i = 0; i < sortCompareFlags_.size(); ++i) {
+      sortKeys.emplace_back(i, sortCompareFlags_[i]);
+    }
+    PrefixSort::sort(
+        *data_,
+        sortKeys,
+        folly::Range<char**>(sortedRows_.data(), sortedRows_.size()));
+    return;
+  }
+
+  // The rows added after the last spill are merged from 'data_' with the
+  // spilled runs. There is a single partition, so there are no rows from
+  // non-spilled partitions.
+  VELOX_CHECK(spiller_->finishSpill().empty());
+  spillMerge_ = spiller_->startMerge(0);
+}
+
+RowVectorPtr SortBuffer::getOutput(vector_size_t maxOutputRows) {
+  VELOX_CHECK(noMoreInput_);
+  VELOX_CHECK_GT(maxOutputRows, 0);
+  if (numOutputRows_ == numInputRows_) {
+    return nullptr;
+  }
+
+  const vector_size_t numRows = std::min<uint64_t>(
+      numInputRows_ - numOutputRows_, maxOutputRows);
+  auto output = std::static_pointer_cast<RowVector>(
+      BaseVector::create(inputType_, numRows, pool_));
+  for (auto& child : output->children()) {
+    child->resize(numRows);
+  }
+  if (spiller_ == nullptr) {
+    getOutputWithoutSpill(output);
+  } else {
+    getOutputWithSpill(output);
+  }
+  numOutputRows_ += numRows;
+  return output;
+}
+
+void SortBuffer::getOutputWithoutSpill(const RowVectorPtr& output) {
+  VELOX_DCHECK_EQ(sortedRows_.size(), numInputRows_);
+  std::vector<column_index_t> columns;
+  std::vector<VectorPtr> results;
+  columns.reserve(columnMap_.size());
+  results.reserve(columnMap_.size());
+  for (const auto& columnProjection : columnMap_) {
+    columns.push_back(columnProjection.inputChannel);
+    results.push_back(output->childAt(columnProjection.outputChannel));
+  }
+  data_->extractColumns(
+      sortedRows_.data() + numOutputRows_, output->size(), columns, results);
+}
+
+void SortBuffer::getOutputWithSpill(const RowVectorPtr& output) {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  spillSources_.resize(output->size());
+  spillSourceRows_.resize(output->size());
+
+  int32_t outputRow = 0;
+  int32_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < output->size()) {
+    SpillMergeStream* stream = spillMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // Copies out the rows before 'pop' fetches the next batch of the stream.
+      gatherCopy(
+          output.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+    stream->pop();
+  }
+
+  if (FOLLY_LIKELY(outputSize != 0)) {
+    gatherCopy(
+        output.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+  }
+}
+
+void SortBuffer::ensureInputFits(const VectorPtr& input) {
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    return;
+  }
+
+  // Test-only spill path.
+  if (spillConfig_->testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig_->testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    return;
+  }
+
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+  if (pool_->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      pool_->currentBytes() * spillConfig_->spillableReservationGrowthPct /
+          100);
+  if (pool_->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  spill();
+}
+
+void SortBuffer::spill() {
+  VELOX_CHECK(canSpill());
+  VELOX_CHECK(!noMoreInput_);
+  if (data_->numRows() == 0) {
+    return;
+  }
+
+  if (spiller_ == nullptr) {
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        sortCompareFlags_,
+        spillConfig_->filePath,
+        spillConfig_->maxFileSize,
+        spillConfig_->minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig_->executor,
+        spillConfig_->compressionKind,
+        spillConfig_->readAheadDepth);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(0, 0);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  data_->clear();
+  pool_->release();
+}
+
+uint64_t SortBuffer::spillableBytes() const {
+  if (noMoreInput_ || data_->numRows() == 0) {
+    return 0;
+  }
+  return pool_->currentBytes();
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/SpillConfig.h"
+#include "velox/exec/Spiller.h"
+
+namespace facebook::velox::exec {
+
+/// Buffers rows and returns them sorted by a set of columns. Used outside of
+/// an operator, e.g. by a DataSink that writes sorted files. The rows are kept
+/// in a RowContainer with the sort columns first. If 'spillConfig' is set, the
+/// buffered rows are spilled as a sorted run when the memory of 'pool' can't
+/// grow or on spill(), and the runs are merged on output. Spill files are
+/// named after 'spillConfig->filePath', which must differ between the
+/// SortBuffers of a query.
+class SortBuffer {
+ public:
+  SortBuffer(
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& sortColumnIndices,
+      const std::vector<CompareFlags>& sortCompareFlags,
+      memory::MemoryPool* pool,
+      const std::optional<SpillConfig>& spillConfig = std::nullopt);
+
+  void addInput(const RowVectorPtr& input);
+
+  /// Sorts the buffered rows or starts the merge of the spilled runs. No more
+  /// input can be added after this.
+  void noMoreInput();
+
+  /// Returns up to 'maxOutputRows' of the sorted rows or nullptr if all rows
+  /// have been returned. Must be called after noMoreInput().
+  RowVectorPtr getOutput(vector_size_t maxOutputRows);
+
+  bool canSpill() const {
+    return spillConfig_.has_value();
+  }
+
+  /// Spills all buffered rows as a sorted run and frees their memory. Must
+  /// not be called after noMoreInput().
+  void spill();
+
+  /// Returns the bytes of the rows that spill() can free.
+  uint64_t spillableBytes() const;
+
+  uint64_t numInputRows() const {
+    return numInputRows_;
+  }
+
+  std::optional<Spiller::Stats> spilledStats() const {
+    if (spiller_ == nullptr) {
+      return std::nullopt;
+    }
+    return spiller_->stats();
+  }
+
+ private:
+  // Grows the reservation of 'pool_' for 'input' and spills all buffered rows
+  // if it can't grow.
+  void ensureInputFits(const VectorPtr& input);
+
+  void getOutputWithoutSpill(const RowVectorPtr& output);
+  void getOutputWithSpill(const RowVectorPtr& output);
+
+  const RowTypePtr inputType_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  memory::MemoryPool* const pool_;
+  const std::optional<SpillConfig> spillConfig_;
+
+  // The map from column channel in the input to the one stored in 'data_',
+  // where the sort columns come first.
+  std::vector<IdentityProjection> columnMap_;
+
+  // The row type of 'data_' and of the spilled rows.
+  RowTypePtr internalStoreType_;
+
+  std::unique_ptr<RowContainer> data_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'spillConfig_->testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  bool noMoreInput_{false};
+
+  uint64_t numInputRows_{0};
+  uint64_t numOutputRows_{0};
+
+  // Sorted rows of 'data_' on the non-spilling path.
+  std::vector<char*> sortedRows_;
+
+  // Merges the spilled runs on the spilling path.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+};
+
+} // namespace facebook::velox::exec
@@ -21,22 +21,87 @@
 
 namespace facebook::velox::exec {
 
+namespace {
 // Spilling currently uses the default PrestoSerializer which by default
 // serializes timestamp with millisecond precision to maintain compatibility
 // with presto. Since velox's native timestamp implementation supports
 // nanosecond precision, we use this serde option to ensure the serializer
 // preserves precision.
-static const serializer::presto::PrestoVectorSerde::PrestoOptions
-    kDefaultSerdeOptions(/*useLosslessTimestamp*/ true);
+serializer::presto::PrestoVectorSerde::PrestoOptions makeSerdeOptions(
+    common::CompressionKind compressionKind) {
+  return serializer::presto::PrestoVectorSerde::PrestoOptions(
+      /*useLosslessTimestamp*/ true, compressionKind);
+}
+} // namespace
 
 std::atomic<int32_t> SpillFile::ordinalCounter_;
 
+SpillInput::~SpillInput() {
+  // The pending reads reference 'input_' and must complete before it goes
+  // away.
+  for (auto& readAhead : readAheads_) {
+    try {
+      readAhead->move();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
-  VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
-  setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
-  offset_ += readBytes;
+  if (readAheads_.empty()) {
+    int32_t readBytes = std::min(size_ - readOffset_, buffer_->capacity());
+    VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+    setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
+    input_->pread(readOffset_, readBytes, buffer_->asMutable<char>());
+    readOffset_ += readBytes;
+    offset_ += readBytes;
+    startReadAhead(nullptr);
+    return;
+  }
+
+  auto readAhead = std::move(readAheads_.front());
+  readAheads_.pop_front();
+  auto chunk = readAhead->move();
+  VELOX_CHECK_NOT_NULL(chunk);
+  // The consumer is done with the current buffer, so reuse it for the next
+  // read-ahead.
+  auto spare = std::move(buffer_);
+  buffer_ = std::move(chunk->buffer);
+  setRange({buffer_->asMutable<uint8_t>(), chunk->size, 0});
+  offset_ += chunk->size;
+  startReadAhead(std::move(spare));
+}
+
+void SpillInput::startReadAhead(BufferPtr spare) {
+  if (executor_ == nullptr) {
+    return;
+  }
+  while (readAheads_.size() < readAheadDepth_ && readOffset_ < size_) {
+    BufferPtr buffer = spare != nullptr
+        ? std::move(spare)
+        : AlignedBuffer::allocate<char>(buffer_->capacity(), &pool_);
+    const int32_t readBytes = std::min(size_ - readOffset_, buffer->capacity());
+    const uint64_t offset = readOffset_;
+    readOffset_ += readBytes;
+    readAheads_.push_back(std::make_shared<AsyncSource<ReadChunk>>(
+        [input = input_.get(), buffer, offset, readBytes]() {
+          input->pread(offset, readBytes, buffer->asMutable<char>());
+          return std::make_unique<ReadChunk>(ReadChunk{buffer, readBytes});
+        }));
+    executor_->add([source = readAheads_.back()]() { source->prepare(); });
+  }
+}
+
+bool SpillMergeStream::hasKeyPrefix() const {
+  return numSortingKeys() > 0 &&
+      hasIntegerKeyPrefix(rowVector_->childAt(0)->typeKind());
+}
+
+uint64_t SpillMergeStream::keyPrefix() const {
+  return integerKeyPrefix(
+      *rowVector_->childAt(0),
+      index_,
+      sortCompareFlags().empty() ? CompareFlags() : sortCompareFlags()[0]);
 }
 
 void SpillMergeStream::pop() {
@@ -62,15 +127,17 @@ void SpillFile::startRead() {
   auto file = fs->openFileForRead(path_);
   auto buffer = AlignedBuffer::allocate<char>(
       std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  input_ = std::make_unique<SpillInput>(
+      std::move(file), std::move(buffer), pool_, executor_, readAheadDepth_);
 }
 
 bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
   if (input_->atEnd()) {
     return false;
   }
+  const auto serdeOptions = makeSerdeOptions(compressionKind_);
   VectorStreamGroup::read(
-      input_.get(), &pool_, type_, &rowVector, &kDefaultSerdeOptions);
+      input_.get(), &pool_, type_, &rowVector, &serdeOptions);
   return true;
 }
 
@@ -85,23 +152,65 @@ WriteFile& SpillFileList::currentOutput() {
         numSortingKeys_,
         sortCompareFlags_,
         fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        pool_,
+        compressionKind_,
+        executor_,
+        readAheadDepth_));
   }
   return files_.back()->output();
 }
 
+namespace {
+uint64_t writeIOBuf(const folly::IOBuf& iobuf, WriteFile& file) {
+  uint64_t bytes = 0;
+  for (auto& range : iobuf) {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+    bytes += range.size();
+  }
+  return bytes;
+}
+} // namespace
+
+SpillFileList::~SpillFileList() {
+  // The pending write references the current output file so it must complete
+  // before the files are destroyed. The error, if any, has been or will never
+  // be reported so it is ignored here.
+  try {
+    waitForPendingWrite();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to write spill file: " << e.what();
+  }
+}
+
+void SpillFileList::waitForPendingWrite() const {
+  if (pendingWrite_ == nullptr) {
+    return;
+  }
+  auto pendingWrite = std::move(pendingWrite_);
+  pendingWrite->move();
+}
+
 void SpillFileList::flush() {
   if (batch_) {
     IOBufOutputStream out(
         pool_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
     batch_->flush(&out);
     batch_.reset();
-    auto iobuf = out.getIOBuf();
+    std::shared_ptr<folly::IOBuf> iobuf = out.getIOBuf();
+    // Only one write is in flight so the file size is up to date after this
+    // when choosing the output file below.
+    waitForPendingWrite();
     auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+    if (executor_ == nullptr) {
+      writeIOBuf(*iobuf, file);
+      return;
     }
+    pendingWrite_ = std::make_shared<AsyncSource<uint64_t>>(
+        [iobuf = std::move(iobuf), &file]() {
+          return std::make_unique<uint64_t>(writeIOBuf(*iobuf, file));
+        });
+    executor_->add([source = pendingWrite_]() { source->prepare(); });
   }
 }
 
@@ -109,11 +218,12 @@ void SpillFileList::write(
     const RowVectorPtr& rows,
     const folly::Range<IndexRange*>& indices) {
   if (!batch_) {
+    const auto serdeOptions = makeSerdeOptions(compressionKind_);
     batch_ = std::make_unique<VectorStreamGroup>(&pool_);
     batch_->createStreamTree(
         std::static_pointer_cast<const RowType>(rows->type()),
         1000,
-        &kDefaultSerdeOptions);
+        &serdeOptions);
   }
   batch_->append(rows, indices);
 
@@ -122,6 +232,7 @@ void SpillFileList::write(
 
 void SpillFileList::finishFile() {
   flush();
+  waitForPendingWrite();
   if (files_.empty()) {
     return;
   }
@@ -131,6 +242,7 @@ void SpillFileList::finishFile() {
 }
 
 uint64_t SpillFileList::spilledBytes() const {
+  waitForPendingWrite();
   uint64_t bytes = 0;
   for (auto& file : files_) {
     bytes += file->size();
@@ -173,7 +285,10 @@ void SpillState::appendToPartition(
         sortCompareFlags_,
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
-        pool_);
+        pool_,
+        compressionKind_,
+        executor_,
+        readAheadDepth_);
   }
 
   IndexRange range{0, rows->size()};
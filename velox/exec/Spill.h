@@ -16,8 +16,13 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <folly/container/F14Set.h>
 
+#include <deque>
+
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/compression/Compression.h"
 #include "velox/common/file/File.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/UnorderedStreamReader.h"
@@ -30,14 +35,27 @@ namespace facebook::velox::exec {
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If 'executor' is
+  // not null and 'readAheadDepth' is positive, up to 'readAheadDepth' reads
+  // of the buffer size are issued ahead of the consumer on 'executor'. The
+  // extra buffers are allocated from 'pool'.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      memory::MemoryPool& pool,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      int32_t readAheadDepth = 0)
       : input_(std::move(input)),
         buffer_(std::move(buffer)),
-        size_(input_->size()) {
+        size_(input_->size()),
+        pool_(pool),
+        executor_(readAheadDepth > 0 ? executor : nullptr),
+        readAheadDepth_(readAheadDepth) {
     next(true);
   }
 
+  ~SpillInput() override;
+
   void next(bool throwIfPastEnd) override;
 
   // True if all of the file has been read into vectors.
@@ -46,11 +64,29 @@ class SpillInput : public ByteStream {
   }
 
  private:
+  // A buffer filled by a read-ahead.
+  struct ReadChunk {
+    BufferPtr buffer;
+    int32_t size;
+  };
+
+  // Issues reads on 'executor_' until there are 'readAheadDepth_' of them in
+  // flight or the file has been read to the end. 'spare' is reused for the
+  // first read if not null.
+  void startReadAhead(BufferPtr spare);
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
   const uint64_t size_;
+  memory::MemoryPool& pool_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  const int32_t readAheadDepth_;
   // Offset of first byte not in 'buffer_'
   uint64_t offset_ = 0;
+  // Offset of the first byte not read or being read ahead.
+  uint64_t readOffset_ = 0;
+  // Reads ahead of 'buffer_' in file order.
+  std::deque<std::shared_ptr<AsyncSource<ReadChunk>>> readAheads_;
 };
 
 /// Represents a spill file that is first in write mode and then
@@ -68,10 +104,16 @@ class SpillFile {
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      int32_t readAheadDepth = 0)
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
+        compressionKind_(compressionKind),
+        executor_(executor),
+        readAheadDepth_(readAheadDepth),
         pool_(pool),
         ordinal_(ordinalCounter_++),
         path_(fmt::format("{}-{}", path, ordinal_)) {
@@ -90,6 +132,10 @@ class SpillFile {
     return sortCompareFlags_;
   }
 
+  common::CompressionKind compressionKind() const {
+    return compressionKind_;
+  }
+
   /// Returns a file for writing spilled data. The caller constructs
   /// this, then calls output() and writes serialized data to the file
   /// and calls finishWrite when the file has reached its final
@@ -110,6 +156,8 @@ class SpillFile {
 
   /// Prepares 'this' for reading. Positions the read at the first row of
   /// content. The caller must call output() and finishWrite() before this.
+  /// Reads ahead on the executor given at construction if the read-ahead
+  /// depth is positive.
   void startRead();
 
   bool nextBatch(RowVectorPtr& rowVector);
@@ -139,6 +187,12 @@ class SpillFile {
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
+  // Codec used for the serialized pages in the file.
+  const common::CompressionKind compressionKind_;
+  // Executor and number of buffers for reading ahead. No read-ahead if
+  // 'executor_' is null or 'readAheadDepth_' is 0.
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  const int32_t readAheadDepth_;
   memory::MemoryPool& pool_;
 
   // Ordinal number used for making a label for debugging.
@@ -163,6 +217,11 @@ class SpillFileList {
   /// data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
   /// target byte size of a single file in the file set. 'pool' is used for
   /// buffering and constructing the result data read from 'this'.
+  /// 'compressionKind' is the codec used to compress the serialized pages.
+  /// If 'executor' is not null, the serialized data is written to the file on
+  /// 'executor' while the caller serializes the next batch. At most one write
+  /// is in flight at a time, i.e. the output is double-buffered. The files
+  /// read ahead 'readAheadDepth' buffers on 'executor' when read back.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -172,12 +231,18 @@ class SpillFileList {
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      int32_t readAheadDepth = 0)
       : type_(type),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
+        compressionKind_(compressionKind),
+        executor_(executor),
+        readAheadDepth_(readAheadDepth),
         pool_(pool) {
     // NOTE: if the associated spilling operator has specified the sort
     // comparison flags, then it must match the number of sorting keys.
@@ -194,6 +259,8 @@ class SpillFileList {
       const RowVectorPtr& rows,
       const folly::Range<IndexRange*>& indices);
 
+  ~SpillFileList();
+
   /// Closes the current output file if any. Subsequent calls to write will
   /// start a new one.
   void finishFile();
@@ -217,9 +284,14 @@ class SpillFileList {
   // Returns the current file to write to and creates one if needed.
   WriteFile& currentOutput();
 
-  // Writes data from 'batch_' to the current output file.
+  // Serializes the data from 'batch_' and writes it to the current output
+  // file. The write runs on 'executor_' if set.
   void flush();
 
+  // Waits for the write started by the previous flush() if any and rethrows
+  // its error.
+  void waitForPendingWrite() const;
+
   // Invoked by 'files()' to record stats when finish writing all the spill
   // files.
   void recordRuntimeStats();
@@ -229,8 +301,14 @@ class SpillFileList {
   const std::vector<CompareFlags> sortCompareFlags_;
   const std::string path_;
   const uint64_t targetFileSize_;
+  const common::CompressionKind compressionKind_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  const int32_t readAheadDepth_;
   memory::MemoryPool& pool_;
   std::unique_ptr<VectorStreamGroup> batch_;
+  // The in-flight write of the previously serialized batch if any. The item
+  // is the number of bytes written.
+  mutable std::shared_ptr<AsyncSource<uint64_t>> pendingWrite_;
   SpillFiles files_;
 };
 
@@ -248,6 +326,10 @@ class SpillMergeStream : public MergeStream {
     return compare(other) < 0;
   }
 
+  bool hasKeyPrefix() const final;
+
+  uint64_t keyPrefix() const final;
+
   int32_t compare(const MergeStream& other) const override {
     auto& otherStream = static_cast<const SpillMergeStream&>(other);
     auto& children = rowVector_->children();
@@ -513,6 +595,12 @@ class SpillPartition {
     }
   }
 
+  /// Moves the spill files of 'other' which has the same id into this.
+  void addFiles(SpillPartition&& other) {
+    VELOX_CHECK(id_ == other.id_);
+    addFiles(std::move(other.files_));
+  }
+
   const SpillPartitionId& id() const {
     return id_;
   }
@@ -548,20 +636,29 @@ class SpillState {
   /// between files. This also gives the maximum number of partitions.
   /// 'numSortingKeys' is the number of leading columns on which the data is
   /// sorted, 0 if only hash partitioning is used. 'targetFileSize' is the
-  /// target size of a single file.  'pool' owns the memory for state and
-  /// results.
+  /// target size of a single file. 'pool' owns the memory for state and
+  /// results. 'compressionKind' is the codec for the spilled pages. If
+  /// 'executor' is not null, the spill file writes are done on it
+  /// asynchronously and the reads are done ahead by 'readAheadDepth'
+  /// buffers, see SpillFileList.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      int32_t readAheadDepth = 0)
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
+        compressionKind_(compressionKind),
+        executor_(executor),
+        readAheadDepth_(readAheadDepth),
         pool_(pool),
         files_(maxPartitions_) {}
 
@@ -583,6 +680,10 @@ class SpillState {
     return targetFileSize_;
   }
 
+  common::CompressionKind compressionKind() const {
+    return compressionKind_;
+  }
+
   memory::MemoryPool& pool() const {
     return pool_;
   }
@@ -646,6 +747,9 @@ class SpillState {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   const uint64_t targetFileSize_;
+  const common::CompressionKind compressionKind_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  const int32_t readAheadDepth_;
 
   memory::MemoryPool& pool_;
 
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <limits>
+#include <string>
+
+#include "velox/common/compression/Compression.h"
+#include "velox/exec/HashBitRange.h"
+
+namespace facebook::velox::exec {
+
+/// Specifies the config for spilling.
+struct SpillConfig {
+  SpillConfig(
+      const std::string& _filePath,
+      uint64_t _maxFileSize,
+      uint64_t _minSpillRunSize,
+      folly::Executor* FOLLY_NULLABLE _executor,
+      int32_t _spillableReservationGrowthPct,
+      const HashBitRange& _hashBitRange,
+      int32_t _maxSpillLevel,
+      int32_t _testSpillPct,
+      common::CompressionKind _compressionKind = common::CompressionKind_NONE,
+      int32_t _readAheadDepth = 0)
+      : filePath(_filePath),
+        maxFileSize(
+            _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
+                              : _maxFileSize),
+        minSpillRunSize(_minSpillRunSize),
+        executor(_executor),
+        spillableReservationGrowthPct(_spillableReservationGrowthPct),
+        hashBitRange(_hashBitRange),
+        maxSpillLevel(_maxSpillLevel),
+        testSpillPct(_testSpillPct),
+        compressionKind(_compressionKind),
+        readAheadDepth(_readAheadDepth) {}
+
+  /// Returns the spilling level with given 'startBitOffset'.
+  ///
+  /// NOTE: we advance (or right shift) the partition bit offset when goes to
+  /// the next level of recursive spilling.
+  int32_t spillLevel(uint8_t startBitOffset) const;
+
+  /// Checks if the given 'startBitOffset' has exceeded the max spill limit.
+  bool exceedSpillLevelLimit(uint8_t startBitOffset) const;
+
+  /// Filesystem path for spill files.
+  std::string filePath;
+
+  /// The max spill file size. If it is zero, there is no limit on the spill
+  /// file size.
+  uint64_t maxFileSize;
+
+  /// The min spill run size (bytes) limit used to select partitions for
+  /// spilling. The spiller tries to spill a previously spilled partitions if
+  /// its data size exceeds this limit, otherwise it spills the partition with
+  /// most data. If the limit is zero, then the spiller always spill a
+  /// previously spilled partition if it has any data. This is to avoid spill
+  /// from a partition wigth a small amount of data which might result in
+  /// generating too many small spilled files.
+  uint64_t minSpillRunSize;
+
+  // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+  folly::Executor* FOLLY_NULLABLE executor; // Not owned.
+
+  // The spillable memory reservation growth percentage of the current
+  // reservation size.
+  int32_t spillableReservationGrowthPct;
+
+  // Used to calculate the spill hash partition number.
+  HashBitRange hashBitRange;
+
+  // The max allowed spilling level with zero being the initial spilling
+  // level. This only applies for hash build spilling which needs recursive
+  // spilling when the build table is too big. If it is set to -1, then there
+  // is no limit and then some extreme large query might run out of spilling
+  // partition bits at the end.
+  int32_t maxSpillLevel;
+
+  // Percentage of input batches to be spilled for testing. 0 means no
+  // spilling for test.
+  int32_t testSpillPct;
+
+  // The codec used to compress the spilled pages.
+  common::CompressionKind compressionKind;
+
+  // The number of buffers read ahead on 'executor' for each spill file
+  // being read back. 0 means reads are done synchronously on demand.
+  int32_t readAheadDepth;
+};
+
+} // namespace facebook::velox::exec
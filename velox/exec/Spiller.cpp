@@ -19,6 +19,7 @@
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/PrefixSort.h"
 
 using facebook::velox::common::testutil::TestValue;
 
@@ -38,7 +39,9 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    common::CompressionKind compressionKind,
+    int32_t readAheadDepth)
     : Spiller(
           type,
           container,
@@ -51,8 +54,14 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
-  VELOX_CHECK_EQ(type_, Type::kOrderBy);
+          executor,
+          compressionKind,
+          readAheadDepth) {
+  VELOX_CHECK(
+      type_ == Type::kOrderBy || type_ == Type::kWindow ||
+          type_ == Type::kTopNRowNumber,
+      "Unexpected spiller type: {}",
+      typeName(type_));
 }
 
 Spiller::Spiller(
@@ -63,7 +72,9 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* FOLLY_NULLABLE executor)
+    folly::Executor* FOLLY_NULLABLE executor,
+    common::CompressionKind compressionKind,
+    int32_t readAheadDepth)
     : Spiller(
           type,
           nullptr,
@@ -76,8 +87,13 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
-  VELOX_CHECK_EQ(type_, Type::kHashJoinProbe);
+          executor,
+          compressionKind,
+          readAheadDepth) {
+  VELOX_CHECK(
+      type_ == Type::kHashJoinProbe || type_ == Type::kRowNumber,
+      "Unexpected spiller type: {}",
+      typeName(type_));
 }
 
 Spiller::Spiller(
@@ -92,7 +108,9 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    common::CompressionKind compressionKind,
+    int32_t readAheadDepth)
     : type_(type),
       container_(container),
       eraser_(eraser),
@@ -105,15 +123,23 @@ Spiller::Spiller(
           numSortingKeys,
           sortCompareFlags,
           targetFileSize,
-          pool),
+          pool,
+          compressionKind,
+          executor,
+          readAheadDepth),
       pool_(pool),
       executor_(executor) {
   TestValue::adjust(
       "facebook::velox::exec::Spiller", const_cast<HashBitRange*>(&bits_));
 
-  VELOX_CHECK_EQ(container_ == nullptr, type_ == Type::kHashJoinProbe);
-  // kOrderBy spiller type must only have one partition.
-  VELOX_CHECK((type_ != Type::kOrderBy) || (state_.maxPartitions() == 1));
+  // kRowNumber spiller type is used with a row container to spill the
+  // partition states and without one to spill the inputs.
+  VELOX_CHECK(
+      type_ == Type::kRowNumber ||
+      (container_ == nullptr) == (type_ == Type::kHashJoinProbe));
+  // kOrderBy, kWindow and kTopNRowNumber spiller types must only have one
+  // partition.
+  VELOX_CHECK(!isSinglePartition() || (state_.maxPartitions() == 1));
   spillRuns_.reserve(state_.maxPartitions());
   for (int i = 0; i < state_.maxPartitions(); ++i) {
     spillRuns_.emplace_back(pool_);
@@ -149,7 +175,7 @@ int64_t Spiller::extractSpillVector(
     int64_t maxBytes,
     RowVectorPtr& spillVector,
     size_t& nextBatchIndex) {
-  VELOX_CHECK_NE(type_, Type::kHashJoinProbe);
+  VELOX_CHECK_NOT_NULL(container_);
 
   auto limit = std::min<size_t>(rows.size() - nextBatchIndex, maxRows);
   assert(!rows.empty());
@@ -245,19 +271,24 @@ std::unique_ptr<SpillMergeStream> Spiller::spillMergeStreamOverRows(
 void Spiller::ensureSorted(SpillRun& run) {
   // The spill data of a hash join doesn't need to be sorted.
   if (!run.sorted && needSort()) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_->compareRows(
-                     left, right, state_.sortCompareFlags()) < 0;
-        });
+    const auto& compareFlags = state_.sortCompareFlags();
+    const auto numKeys = container_->keyTypes().size();
+    std::vector<std::pair<column_index_t, CompareFlags>> sortKeys;
+    sortKeys.reserve(numKeys);
+    for (column_index_t i = 0; i < numKeys; ++i) {
+      sortKeys.emplace_back(
+          i, compareFlags.empty() ? CompareFlags() : compareFlags[i]);
+    }
+    PrefixSort::sort(
+        *container_,
+        sortKeys,
+        folly::Range<char**>(run.rows.data(), run.rows.size()));
     run.sorted = true;
   }
 }
 
 std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
-  VELOX_CHECK_NE(type_, Type::kHashJoinProbe);
+  VELOX_CHECK_NOT_NULL(container_);
   VELOX_CHECK_EQ(pendingSpillPartitions_.count(partition), 1);
   // Target size of a single vector of spilled content. One of
   // these will be materialized at a time for each stream of the
@@ -279,12 +310,13 @@ std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
         break;
       }
     }
-    return std::make_unique<SpillStatus>(partition, written, nullptr);
+    return std::make_unique<SpillStatus>(
+        partition, written, totalBytes, nullptr);
   } catch (const std::exception& e) {
     // The exception is passed to the caller thread which checks this in
     // advanceSpill().
     return std::make_unique<SpillStatus>(
-        partition, 0, std::current_exception());
+        partition, 0, 0, std::current_exception());
   }
 }
 
@@ -323,6 +355,7 @@ void Spiller::advanceSpill() {
     }
     auto numWritten = result->rowsWritten;
     spilledRows_ += numWritten;
+    spilledInputBytes_ += result->bytesWritten;
     auto partition = result->partition;
     auto& run = spillRuns_[partition];
     auto spilled = folly::Range<char**>(run.rows.data(), numWritten);
@@ -343,14 +376,20 @@ void Spiller::advanceSpill() {
   }
 }
 
+bool Spiller::isSinglePartition() const {
+  return type_ == Type::kOrderBy || type_ == Type::kWindow ||
+      type_ == Type::kTopNRowNumber;
+}
+
 bool Spiller::needSort() const {
-  return type_ != Type::kHashJoinProbe && type_ != Type::kHashJoinBuild;
+  return type_ != Type::kHashJoinProbe && type_ != Type::kHashJoinBuild &&
+      type_ != Type::kRowNumber;
 }
 
 void Spiller::spill(uint64_t targetRows, uint64_t targetBytes) {
   VELOX_CHECK(!spillFinalized_);
 
-  if (type_ == Type::kHashJoinBuild || type_ == Type::kHashJoinProbe) {
+  if (!needSort()) {
     VELOX_FAIL("Don't support incremental spill on type: {}", typeName(type_));
   }
 
@@ -413,7 +452,7 @@ void Spiller::spill(uint64_t targetRows, uint64_t targetBytes) {
 
 void Spiller::spill(const SpillPartitionNumSet& partitions) {
   VELOX_CHECK(!spillFinalized_);
-  if (type_ == Type::kHashJoinProbe) {
+  if (container_ == nullptr) {
     VELOX_FAIL("There is no row container for {}", typeName(type_));
   }
   if (!pendingSpillPartitions_.empty()) {
@@ -461,6 +500,7 @@ void Spiller::spill(uint32_t partition, const RowVectorPtr& spillVector) {
     return;
   }
 
+  spilledInputBytes_ += spillVector->estimateFlatSize();
   state_.appendToPartition(partition, spillVector);
 }
 
@@ -506,7 +546,7 @@ Spiller::SpillRows Spiller::finishSpill() {
 
   SpillRows rowsFromNonSpillingPartitions(
       0, memory::StlAllocator<char*>(pool_));
-  if (type_ != Spiller::Type::kHashJoinProbe) {
+  if (container_ != nullptr) {
     fillSpillRuns(&rowsFromNonSpillingPartitions);
   }
   return rowsFromNonSpillingPartitions;
@@ -556,7 +596,7 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
     for (auto i = 0; i < numRows; ++i) {
       // TODO: consider to cache the hash bits in row container so we only need
       // to calculate them once.
-      const auto partition = (type_ == Type::kOrderBy)
+      const auto partition = isSinglePartition()
           ? 0
           : bits_.partition(hashes[i], state_.maxPartitions());
       VELOX_DCHECK_GE(partition, 0);
@@ -594,7 +634,7 @@ std::string Spiller::toString() const {
       spillFinalized_);
 }
 
-int32_t Spiller::Config::spillLevel(uint8_t startBitOffset) const {
+int32_t SpillConfig::spillLevel(uint8_t startBitOffset) const {
   const auto numPartitionBits = hashBitRange.numBits();
   VELOX_CHECK_LE(
       startBitOffset + numPartitionBits,
@@ -613,7 +653,7 @@ int32_t Spiller::Config::spillLevel(uint8_t startBitOffset) const {
   return deltaBits / numPartitionBits;
 }
 
-bool Spiller::Config::exceedSpillLevelLimit(uint8_t startBitOffset) const {
+bool SpillConfig::exceedSpillLevelLimit(uint8_t startBitOffset) const {
   if (startBitOffset + hashBitRange.numBits() > 64) {
     return true;
   }
@@ -634,6 +674,12 @@ std::string Spiller::typeName(Type type) {
       return "HASH_JOIN_PROBE";
     case Type::kAggregate:
       return "AGGREGATE";
+    case Type::kWindow:
+      return "WINDOW";
+    case Type::kRowNumber:
+      return "ROW_NUMBER";
+    case Type::kTopNRowNumber:
+      return "TOPN_ROW_NUMBER";
     default:
       VELOX_UNREACHABLE("Unknown type: {}", static_cast<int>(type));
       return fmt::format("UNKNOWN TYPE: {}", static_cast<int>(type));
@@ -641,7 +687,7 @@ std::string Spiller::typeName(Type type) {
 }
 
 void Spiller::fillSpillRuns(std::vector<SpillableStats>& statsList) {
-  if (FOLLY_UNLIKELY(type_ == Type::kHashJoinProbe)) {
+  if (FOLLY_UNLIKELY(container_ == nullptr)) {
     VELOX_FAIL("There is no row container for {}", typeName(type_));
   }
   statsList.resize(state_.maxPartitions());
@@ -17,6 +17,7 @@
 
 #include "velox/exec/HashBitRange.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/SpillConfig.h"
 
 namespace facebook::velox::exec {
 
@@ -33,83 +34,25 @@ class Spiller {
     kHashJoinProbe = 2,
     // Used for order by.
     kOrderBy = 3,
+    // Used for window.
+    kWindow = 4,
+    // Used for row number, both for the partition states in the hash table
+    // and for the inputs received after spilling.
+    kRowNumber = 5,
+    // Used for top n row number.
+    kTopNRowNumber = 6,
   };
-  static constexpr int kNumTypes = 4;
+  static constexpr int kNumTypes = 7;
   static std::string typeName(Type);
 
   // Specifies the config for spilling.
-  struct Config {
-    Config(
-        const std::string& _filePath,
-        uint64_t _maxFileSize,
-        uint64_t _minSpillRunSize,
-        folly::Executor* FOLLY_NULLABLE _executor,
-        int32_t _spillableReservationGrowthPct,
-        const HashBitRange& _hashBitRange,
-        int32_t _maxSpillLevel,
-        int32_t _testSpillPct)
-        : filePath(_filePath),
-          maxFileSize(
-              _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
-                                : _maxFileSize),
-          minSpillRunSize(_minSpillRunSize),
-          executor(_executor),
-          spillableReservationGrowthPct(_spillableReservationGrowthPct),
-          hashBitRange(_hashBitRange),
-          maxSpillLevel(_maxSpillLevel),
-          testSpillPct(_testSpillPct) {}
-
-    /// Returns the spilling level with given 'startBitOffset'.
-    ///
-    /// NOTE: we advance (or right shift) the partition bit offset when goes to
-    /// the next level of recursive spilling.
-    int32_t spillLevel(uint8_t startBitOffset) const;
-
-    /// Checks if the given 'startBitOffset' has exceeded the max spill limit.
-    bool exceedSpillLevelLimit(uint8_t startBitOffset) const;
-
-    /// Filesystem path for spill files.
-    std::string filePath;
-
-    /// The max spill file size. If it is zero, there is no limit on the spill
-    /// file size.
-    uint64_t maxFileSize;
-
-    /// The min spill run size (bytes) limit used to select partitions for
-    /// spilling. The spiller tries to spill a previously spilled partitions if
-    /// its data size exceeds this limit, otherwise it spills the partition with
-    /// most data. If the limit is zero, then the spiller always spill a
-    /// previously spilled partition if it has any data. This is to avoid spill
-    /// from a partition wigth a small amount of data which might result in
-    /// generating too many small spilled files.
-    uint64_t minSpillRunSize;
-
-    // Executor for spilling. If nullptr spilling writes on the Driver's thread.
-    folly::Executor* FOLLY_NULLABLE executor; // Not owned.
-
-    // The spillable memory reservation growth percentage of the current
-    // reservation size.
-    int32_t spillableReservationGrowthPct;
-
-    // Used to calculate the spill hash partition number.
-    HashBitRange hashBitRange;
-
-    // The max allowed spilling level with zero being the initial spilling
-    // level. This only applies for hash build spilling which needs recursive
-    // spilling when the build table is too big. If it is set to -1, then there
-    // is no limit and then some extreme large query might run out of spilling
-    // partition bits at the end.
-    int32_t maxSpillLevel;
-
-    // Percentage of input batches to be spilled for testing. 0 means no
-    // spilling for test.
-    int32_t testSpillPct;
-  };
+  using Config = SpillConfig;
 
   using SpillRows = std::vector<char*, memory::StlAllocator<char*>>;
 
   // The constructor without specifying hash bits which will only use one
-  // partition by default. It is only used by kOrderBy spiller type as for now.
+  // partition by default. It is only used by kOrderBy, kWindow and
+  // kTopNRowNumber spiller types as for now.
   Spiller(
       Type type,
       RowContainer* FOLLY_NONNULL container,
@@ -121,7 +64,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      int32_t readAheadDepth = 0);
 
   Spiller(
       Type type,
@@ -131,7 +76,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      int32_t readAheadDepth = 0);
 
   Spiller(
       Type type,
@@ -145,7 +92,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      int32_t readAheadDepth = 0);
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -257,22 +206,30 @@ class Spiller {
 
   /// Define the spiller stats.
   struct Stats {
+    /// The number of bytes written to the spill files. This is the compressed
+    /// size if spill compression is enabled.
     uint64_t spilledBytes{0};
     uint64_t spilledRows{0};
     /// NOTE: when we sum up the stats from a group of spill operators, it is
     /// the total number of spilled partitions X number of operators.
     uint32_t spilledPartitions{0};
     uint64_t spilledFiles{0};
+    /// The in-memory size of the spilled rows before serialization and
+    /// compression. Compared with 'spilledBytes' this gives the effective
+    /// spill compression ratio.
+    uint64_t spilledInputBytes{0};
 
     Stats(
         uint64_t _spilledBytes,
         uint64_t _spilledRows,
         uint32_t _spilledPartitions,
-        uint64_t _spilledFiles)
+        uint64_t _spilledFiles,
+        uint64_t _spilledInputBytes = 0)
         : spilledBytes(_spilledBytes),
           spilledRows(_spilledRows),
           spilledPartitions(_spilledPartitions),
-          spilledFiles(_spilledFiles) {}
+          spilledFiles(_spilledFiles),
+          spilledInputBytes(_spilledInputBytes) {}
 
     Stats() = default;
 
@@ -281,6 +238,7 @@ class Spiller {
       spilledRows += other.spilledRows;
       spilledPartitions += other.spilledPartitions;
       spilledFiles += other.spilledFiles;
+      spilledInputBytes += other.spilledInputBytes;
       return *this;
     }
   };
@@ -290,7 +248,8 @@ class Spiller {
         state_.spilledBytes(),
         spilledRows_,
         state_.spilledPartitions(),
-        spilledFiles()};
+        spilledFiles(),
+        spilledInputBytes_};
   }
 
   /// Return the number of spilled files we have.
@@ -355,13 +314,19 @@ class Spiller {
   struct SpillStatus {
     const int32_t partition;
     const int32_t rowsWritten;
+    // The in-memory byte size of the rows written.
+    const uint64_t bytesWritten;
     const std::exception_ptr error;
 
     SpillStatus(
         int32_t _partition,
         int32_t _numWritten,
+        uint64_t _bytesWritten,
         std::exception_ptr _error)
-        : partition(_partition), rowsWritten(_numWritten), error(_error) {}
+        : partition(_partition),
+          rowsWritten(_numWritten),
+          bytesWritten(_bytesWritten),
+          error(_error) {}
   };
 
   // Prepares spill runs for the spillable data from all the hash partitions.
@@ -400,9 +365,14 @@ class Spiller {
 
   // Indicates if the spill data needs to be sorted before write to file. It is
   // based on the spiller type. As for now, we need to sort spill data for any
-  // non hash join types of spilling.
+  // non hash join and non row number types of spilling.
   bool needSort() const;
 
+  // Indicates if all the rows are spilled into a single partition, which is
+  // the case for the kOrderBy, kWindow and kTopNRowNumber spiller types that
+  // need a total order over the spilled rows.
+  bool isSinglePartition() const;
+
   const Type type_;
   // NOTE: for hash join probe type, there is no associated row container for
   // the spiller.
@@ -431,6 +401,8 @@ class Spiller {
   folly::Executor* FOLLY_NULLABLE const executor_;
 
   uint64_t spilledRows_{0};
+
+  uint64_t spilledInputBytes_{0};
 };
 
 } // namespace facebook::velox::exec
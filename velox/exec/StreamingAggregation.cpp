@@ -54,6 +54,9 @@ StreamingAggregation::StreamingAggregation(
   maskChannels.reserve(numAggregates);
   for (auto i = 0; i < numAggregates; i++) {
     const auto& aggregate = aggregationNode->aggregates()[i];
+    VELOX_USER_CHECK(
+        !aggregate.distinct,
+        "Streaming aggregation over distinct inputs is not supported yet");
 
     std::vector<column_index_t> channels;
     std::vector<VectorPtr> constants;
@@ -19,6 +19,17 @@
 #include "velox/expression/Expr.h"
 
 DEFINE_int32(split_preload_per_driver, 2, "Prefetch split metadata");
+DEFINE_int32(
+    split_file_prefetch_per_driver,
+    0,
+    "Number of splits per driver after the preloaded ones whose files are "
+    "opened ahead of reading");
+DEFINE_int32(
+    max_sub_splits_per_split,
+    0,
+    "Max number of parts at stripe or row group boundaries that a split is "
+    "divided into for reading by different drivers. Also limited by the "
+    "number of drivers. 0 or 1 disables dividing splits");
 
 namespace facebook::velox::exec {
 
@@ -42,10 +53,14 @@ TableScan::TableScan(
           driverCtx_->pipelineId,
           driverCtx_->driverId,
           operatorType(),
-          tableHandle_->connectorId())),
+          tableHandle_->connectorId(),
+          driverCtx_->splitGroupId)),
       readBatchSize_(driverCtx_->task->queryCtx()
                          ->queryConfig()
-                         .preferredOutputBatchRows()) {
+                         .preferredOutputBatchRows()),
+      adaptiveBatchSize_(driverCtx_->task->queryCtx()
+                             ->queryConfig()
+                             .tableScanAdaptiveBatchSizeEnabled()) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
 }
 
@@ -53,6 +68,7 @@ RowVectorPtr TableScan::getOutput() {
   if (noMoreSplits_) {
     return nullptr;
   }
+  addExternalDynamicFilters();
 
   for (;;) {
     if (needNewSplit_) {
@@ -63,31 +79,16 @@ RowVectorPtr TableScan::getOutput() {
           split,
           blockingFuture_,
           maxPreloadedSplits_,
-          splitPreloader_);
+          splitPreloader_,
+          maxPrefetchedSplits_,
+          splitPrefetcher_);
       if (blockingReason_ != BlockingReason::kNotBlocked) {
         return nullptr;
       }
 
       if (!split.hasConnectorSplit()) {
         noMoreSplits_ = true;
-        if (dataSource_) {
-          auto connectorStats = dataSource_->runtimeStats();
-          auto lockedStats = stats_.wlock();
-          for (const auto& [name, counter] : connectorStats) {
-            if (name == "ioWaitNanos") {
-              ioWaitNanos_ += counter.value - lastIoWaitNanos_;
-              lastIoWaitNanos_ = counter.value;
-            }
-            if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
-              lockedStats->runtimeStats.insert(
-                  std::make_pair(name, RuntimeMetric(counter.unit)));
-            } else {
-              VELOX_CHECK_EQ(
-                  lockedStats->runtimeStats.at(name).unit, counter.unit);
-            }
-            lockedStats->runtimeStats.at(name).addValue(counter.value);
-          }
-        }
+        recordConnectorStats();
         return nullptr;
       }
 
@@ -107,6 +108,10 @@ RowVectorPtr TableScan::getOutput() {
             tableHandle_,
             columnHandles_,
             connectorQueryCtx_.get());
+        const auto numDrivers =
+            driverCtx_->task->numDrivers(driverCtx_->driver);
+        maxSubSplits_ = std::min(FLAGS_max_sub_splits_per_split, numDrivers);
+        dataSource_->setMaxSubSplits(maxSubSplits_);
         for (const auto& entry : pendingDynamicFilters_) {
           dataSource_->addDynamicFilter(entry.first, entry.second);
         }
@@ -141,11 +146,21 @@ RowVectorPtr TableScan::getOutput() {
       }
       ++stats_.wlock()->numSplits;
 
-      auto estimatedRowSize = dataSource_->estimatedRowSize();
+      auto subSplits = dataSource_->takeSubSplits();
+      if (!subSplits.empty()) {
+        numSubSplits_ += subSplits.size();
+        driverCtx_->task->addSubSplits(
+            planNodeId(), driverCtx_->splitGroupId, std::move(subSplits));
+      }
+
+      estimatedRowSize_ = dataSource_->estimatedRowSize();
       readBatchSize_ =
-          estimatedRowSize == connector::DataSource::kUnknownRowSize
+          estimatedRowSize_ == connector::DataSource::kUnknownRowSize
           ? outputBatchRows()
-          : outputBatchRows(estimatedRowSize);
+          : outputBatchRows(estimatedRowSize_);
+      splitStartRows_ = dataSource_->getCompletedRows();
+      splitOutputRows_ = 0;
+      splitOutputBytes_ = 0;
     }
 
     const auto ioTimeStartMicros = getCurrentTimeMicro();
@@ -181,9 +196,12 @@ RowVectorPtr TableScan::getOutput() {
       auto data = dataOptional.value();
       if (data) {
         if (data->size() > 0) {
-          lockedStats->addInputVector(data->estimateFlatSize(), data->size());
+          const auto numBytes = data->estimateFlatSize();
+          lockedStats->addInputVector(numBytes, data->size());
+          adaptReadBatchSize(data->size(), numBytes);
           return data;
         }
+        adaptReadBatchSize(0, 0);
         continue;
       }
     }
@@ -200,6 +218,15 @@ RowVectorPtr TableScan::getOutput() {
             "readyPreloadedSplits", RuntimeCounter(numReadyPreloadedSplits_));
         numReadyPreloadedSplits_ = 0;
       }
+      if (numPrefetchedSplits_ > 0) {
+        lockedStats->addRuntimeStat(
+            "prefetchedSplits", RuntimeCounter(numPrefetchedSplits_));
+        numPrefetchedSplits_ = 0;
+      }
+      if (numSubSplits_ > 0) {
+        lockedStats->addRuntimeStat("subSplits", RuntimeCounter(numSubSplits_));
+        numSubSplits_ = 0;
+      }
     }
 
     driverCtx_->task->splitFinished();
@@ -207,6 +234,35 @@ RowVectorPtr TableScan::getOutput() {
   }
 }
 
+void TableScan::adaptReadBatchSize(vector_size_t numRows, uint64_t numBytes) {
+  if (!adaptiveBatchSize_) {
+    return;
+  }
+  splitOutputRows_ += numRows;
+  splitOutputBytes_ += numBytes;
+  const auto scannedRows = dataSource_->getCompletedRows() - splitStartRows_;
+  if (scannedRows == 0) {
+    return;
+  }
+  // The row size estimate of the DataSource is kept if there is one. Without
+  // it the size of the output rows so far is used.
+  uint32_t outputRows;
+  if (estimatedRowSize_ != connector::DataSource::kUnknownRowSize) {
+    outputRows = outputBatchRows(estimatedRowSize_);
+  } else if (splitOutputRows_ > 0) {
+    outputRows = outputBatchRows(splitOutputBytes_ / splitOutputRows_);
+  } else {
+    outputRows = outputBatchRows();
+  }
+  // Reads more rows if filters drop rows, up to kMaxSelectivityScale times
+  // the output batch size, so that the output batches are not tiny.
+  const uint64_t maxRows = outputRows * kMaxSelectivityScale;
+  const auto rows = splitOutputRows_ == 0
+      ? maxRows
+      : outputRows * scannedRows / splitOutputRows_;
+  readBatchSize_ = std::max<uint64_t>(std::min(rows, maxRows), 1);
+}
+
 void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
   // The AsyncSource returns a unique_ptr to the shared_ptr of the
   // DataSource. The callback may outlive the Task, hence it captures
@@ -221,6 +277,7 @@ void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
        ctx = operatorCtx_->createConnectorQueryCtx(
            split->connectorId, planNodeId(), connectorPool_),
        task = operatorCtx_->task(),
+       maxSubSplits = maxSubSplits_,
        split]() -> std::unique_ptr<connector::DataSource> {
         if (task->isCancelled()) {
           return nullptr;
@@ -237,20 +294,37 @@ void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
         if (task->isCancelled()) {
           return nullptr;
         }
+        ptr->setMaxSubSplits(maxSubSplits);
         ptr->addSplit(split);
         return ptr;
       });
 }
 
+void TableScan::prefetch(
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> splits) {
+  numPrefetchedSplits_ += splits.size();
+  auto ctx = operatorCtx_->createConnectorQueryCtx(
+      splits[0]->connectorId, planNodeId(), connectorPool_);
+  // The callback keeps the Task, and so the memory pool of 'ctx', and the
+  // connector live until the prefetches are done.
+  connector_->prefetchSplits(splits, ctx.get())
+      .toUnsafeFuture()
+      .thenTry([task = operatorCtx_->task(),
+                connector = connector_,
+                ctx](folly::Try<folly::Unit>&&) {});
+}
+
 void TableScan::checkPreload() {
   auto executor = connector_->executor();
-  if (FLAGS_split_preload_per_driver == 0 || !executor ||
-      !connector_->supportsSplitPreload()) {
+  if (!executor || !dataSource_->allPrefetchIssued()) {
     return;
   }
-  if (dataSource_->allPrefetchIssued()) {
-    maxPreloadedSplits_ = driverCtx_->task->numDrivers(driverCtx_->driver) *
-        FLAGS_split_preload_per_driver;
+  const auto numDrivers = driverCtx_->task->numDrivers(driverCtx_->driver);
+  const auto splitPreloadPerDriver =
+      connector_->maxSplitPreloadPerDriver().value_or(
+          FLAGS_split_preload_per_driver);
+  if (splitPreloadPerDriver > 0 && connector_->supportsSplitPreload()) {
+    maxPreloadedSplits_ = numDrivers * splitPreloadPerDriver;
     if (!splitPreloader_) {
       splitPreloader_ =
           [executor, this](std::shared_ptr<connector::ConnectorSplit> split) {
@@ -263,6 +337,49 @@ void TableScan::checkPreload() {
           };
     }
   }
+  if (FLAGS_split_file_prefetch_per_driver > 0 &&
+      connector_->supportsSplitPrefetch()) {
+    maxPrefetchedSplits_ = numDrivers * FLAGS_split_file_prefetch_per_driver;
+    if (!splitPrefetcher_) {
+      splitPrefetcher_ =
+          [this](std::vector<std::shared_ptr<connector::ConnectorSplit>>
+                     splits) { prefetch(std::move(splits)); };
+    }
+  }
+}
+
+void TableScan::recordConnectorStats() {
+  if (!dataSource_) {
+    return;
+  }
+  auto connectorStats = dataSource_->runtimeStats();
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, counter] : connectorStats) {
+    if (name == "ioWaitNanos") {
+      ioWaitNanos_ += counter.value - lastIoWaitNanos_;
+      lastIoWaitNanos_ = counter.value;
+    }
+    if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
+      lockedStats->runtimeStats.insert(
+          std::make_pair(name, RuntimeMetric(counter.unit)));
+    } else {
+      VELOX_CHECK_EQ(lockedStats->runtimeStats.at(name).unit, counter.unit);
+    }
+    lockedStats->runtimeStats.at(name).addValue(counter.value);
+  }
+}
+
+void TableScan::noMoreOutputNeeded() {
+  // Destroying the DataSource cancels its in-flight loads of the current
+  // split.
+  recordConnectorStats();
+  dataSource_.reset();
+  // No more splits are read, so that getOutput() returns nullptr and
+  // isFinished() is true from here on.
+  noMoreSplits_ = true;
+  needNewSplit_ = true;
+  blockingReason_ = BlockingReason::kNotBlocked;
+  blockingFuture_ = ContinueFuture::makeEmpty();
 }
 
 bool TableScan::isFinished() {
@@ -274,8 +391,32 @@ void TableScan::addDynamicFilter(
     const std::shared_ptr<common::Filter>& filter) {
   if (dataSource_) {
     dataSource_->addDynamicFilter(outputChannel, filter);
-  } else {
+    return;
+  }
+  auto it = pendingDynamicFilters_.find(outputChannel);
+  if (it == pendingDynamicFilters_.end()) {
     pendingDynamicFilters_.emplace(outputChannel, filter);
+  } else {
+    it->second = it->second->mergeWith(filter.get());
+  }
+}
+
+void TableScan::addExternalDynamicFilters() {
+  const auto& task = operatorCtx_->task();
+  const auto numFilters = task->numExternalDynamicFilters();
+  if (numFilters == numExternalDynamicFiltersSeen_ ||
+      !canAddDynamicFilter()) {
+    return;
+  }
+  numExternalDynamicFiltersSeen_ = numFilters;
+  const auto filters =
+      task->externalDynamicFilters(planNodeId(), numExternalDynamicFilters_);
+  numExternalDynamicFilters_ += filters.size();
+  for (const auto& [channel, filter] : filters) {
+    addDynamicFilter(channel, filter);
+  }
+  if (!filters.empty()) {
+    addRuntimeStat("dynamicFiltersAccepted", RuntimeCounter(filters.size()));
   }
 }
 
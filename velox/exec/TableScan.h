@@ -19,6 +19,8 @@
 #include "velox/exec/Operator.h"
 
 DECLARE_int32(split_preload_per_driver);
+DECLARE_int32(split_file_prefetch_per_driver);
+DECLARE_int32(max_sub_splits_per_split);
 
 namespace facebook::velox::exec {
 
@@ -41,6 +43,10 @@ class TableScan : public SourceOperator {
 
   bool isFinished() override;
 
+  /// Stops reading the current split and drops its pending reads. No more
+  /// splits are read.
+  void noMoreOutputNeeded() override;
+
   bool canAddDynamicFilter() const override {
     return connector_->canAddDynamicFilter();
   }
@@ -69,9 +75,28 @@ class TableScan : public SourceOperator {
   // needed before prepare is done, it will be made when needed.
   void preload(std::shared_ptr<connector::ConnectorSplit> split);
 
+  // Starts prefetching the files of 'splits' through the connector.
+  void prefetch(std::vector<std::shared_ptr<connector::ConnectorSplit>> splits);
+
+  // Adds the filters that were added to the Task with
+  // Task::addDynamicFilter() since the last call.
+  void addExternalDynamicFilters();
+
+  // Adds the runtime stats of 'dataSource_' to the stats of 'this'.
+  void recordConnectorStats();
+
+  // Records a batch of 'numRows' rows and 'numBytes' bytes read from the
+  // current split and sets 'readBatchSize_' so that the next batch has about
+  // kPreferredOutputBatchBytes after filtering.
+  void adaptReadBatchSize(vector_size_t numRows, uint64_t numBytes);
+
   // Process-wide IO wait time.
   static std::atomic<uint64_t> ioWaitNanos_;
 
+  // Max ratio of the read batch size to the output batch size when filters
+  // drop rows.
+  static constexpr uint64_t kMaxSelectivityScale = 10;
+
   const std::shared_ptr<connector::ConnectorTableHandle> tableHandle_;
   const std::
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
@@ -89,6 +114,12 @@ class TableScan : public SourceOperator {
   std::unordered_map<column_index_t, std::shared_ptr<common::Filter>>
       pendingDynamicFilters_;
 
+  // Value of Task::numExternalDynamicFilters() at the last check for filters
+  // added to the Task.
+  uint64_t numExternalDynamicFiltersSeen_{0};
+  // Number of filters for this plan node taken from the Task so far.
+  size_t numExternalDynamicFilters_{0};
+
   int32_t maxPreloadedSplits_{0};
 
   // Callback passed to getSplitOrFuture() for triggering async
@@ -99,14 +130,46 @@ class TableScan : public SourceOperator {
   std::function<void(std::shared_ptr<connector::ConnectorSplit>)>
       splitPreloader_{nullptr};
 
+  int32_t maxPrefetchedSplits_{0};
+
+  // Callback passed to getSplitOrFuture() for prefetching the files of the
+  // splits queued behind the preloaded ones. Like 'splitPreloader_', the
+  // prefetches may outlive the Task.
+  std::function<void(std::vector<std::shared_ptr<connector::ConnectorSplit>>)>
+      splitPrefetcher_{nullptr};
+
   // Count of splits that started background preload.
   int32_t numPreloadedSplits_{0};
 
+  // Count of splits whose files were prefetched.
+  int32_t numPrefetchedSplits_{0};
+
   // Count of splits that finished preloading before being read.
   int32_t numReadyPreloadedSplits_{0};
 
+  // Max number of parts the DataSource may divide a split into. Queued parts
+  // are read by the other drivers of the pipeline.
+  int32_t maxSubSplits_{0};
+
+  // Count of splits queued by dividing the splits read by 'this'.
+  int32_t numSubSplits_{0};
+
   int32_t readBatchSize_;
 
+  // True if 'readBatchSize_' is adapted to the selectivity and the output row
+  // size observed in the current split.
+  const bool adaptiveBatchSize_;
+
+  // Row size estimate of the DataSource for the current split or
+  // kUnknownRowSize.
+  int64_t estimatedRowSize_{connector::DataSource::kUnknownRowSize};
+
+  // Completed rows of 'dataSource_' when the current split started and the
+  // rows and bytes it produced so far.
+  uint64_t splitStartRows_{0};
+  uint64_t splitOutputRows_{0};
+  uint64_t splitOutputBytes_{0};
+
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
   std::string debugString_;
 
@@ -29,21 +29,28 @@ TableWriter::TableWriter(
           tableWriteNode->outputType(),
           operatorId,
           tableWriteNode->id(),
-          "TableWrite"),
+          "TableWrite",
+          tableWriteNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
       driverCtx_(driverCtx),
       connectorPool_(driverCtx_->task->addConnectorPoolLocked(
           planNodeId(),
           driverCtx_->pipelineId,
           driverCtx_->driverId,
           operatorType(),
-          tableWriteNode->insertTableHandle()->connectorId())),
+          tableWriteNode->insertTableHandle()->connectorId(),
+          driverCtx_->splitGroupId)),
       insertTableHandle_(
           tableWriteNode->insertTableHandle()->connectorInsertTableHandle()),
       commitStrategy_(tableWriteNode->commitStrategy()) {
   const auto& connectorId = tableWriteNode->insertTableHandle()->connectorId();
   connector_ = connector::getConnector(connectorId);
   connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
-      connectorId, planNodeId(), connectorPool_);
+      connectorId,
+      planNodeId(),
+      connectorPool_,
+      spillConfig_.has_value() ? &spillConfig_.value() : nullptr);
 
   auto names = tableWriteNode->columnNames();
   auto types = tableWriteNode->columns()->children();
@@ -86,6 +93,7 @@ void TableWriter::addInput(RowVectorPtr input) {
       mappedChildren,
       input->getNullCount());
 
+  NonReclaimableSection guard(this);
   if (!dataSink_) {
     createDataSink();
   }
@@ -93,6 +101,30 @@ void TableWriter::addInput(RowVectorPtr input) {
   numWrittenRows_ += input->size();
 }
 
+bool TableWriter::reclaimableBytes(uint64_t& reclaimableBytes) const {
+  reclaimableBytes = 0;
+  if (closed_ || dataSink_ == nullptr) {
+    return false;
+  }
+  reclaimableBytes = dataSink_->reclaimableBytes();
+  return true;
+}
+
+void TableWriter::reclaim(uint64_t targetBytes) {
+  VELOX_CHECK(canReclaim());
+  // NOTE: a table writer is not reclaimable while it is writing or after it
+  // is closed.
+  if (closed_ || nonReclaimableSection_) {
+    LOG(WARNING) << "Can't reclaim from table writer, closed_[" << closed_
+                 << "], nonReclaimableSection_[" << nonReclaimableSection_
+                 << "], " << toString();
+    return;
+  }
+  if (dataSink_ != nullptr) {
+    dataSink_->reclaim(targetBytes);
+  }
+}
+
 RowVectorPtr TableWriter::getOutput() {
   // Making sure the output is read only once after the write is fully done.
   if (!noMoreInput_ || finished_) {
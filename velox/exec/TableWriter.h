@@ -49,6 +49,7 @@ class TableWriter : public Operator {
   void close() override {
     if (!closed_) {
       if (dataSink_) {
+        NonReclaimableSection guard(this);
         dataSink_->close();
       }
       closed_ = true;
@@ -57,6 +58,16 @@ class TableWriter : public Operator {
 
   RowVectorPtr getOutput() override;
 
+  /// A table writer is reclaimable by flushing the buffered data of its
+  /// file writers.
+  bool canReclaim() const override {
+    return true;
+  }
+
+  bool reclaimableBytes(uint64_t& reclaimableBytes) const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
   bool isFinished() override {
     return finished_;
   }
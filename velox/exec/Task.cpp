@@ -16,12 +16,14 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/json.h>
 #include <string>
 
 #include "velox/codegen/Codegen.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/common/time/Timer.h"
 #include "velox/exec/Exchange.h"
+#include "velox/exec/FragmentResultCache.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/LocalPlanner.h"
 #include "velox/exec/Merge.h"
@@ -89,6 +91,19 @@ folly::Synchronized<std::vector<std::shared_ptr<TaskListener>>>& listeners() {
   return kListeners;
 }
 
+// Query config properties that change the results of a plan. These are part
+// of the fragment result cache key.
+const std::vector<const char*>& resultAffectingConfigs() {
+  static const std::vector<const char*> kConfigs{
+      core::QueryConfig::kSessionTimezone,
+      core::QueryConfig::kAdjustTimestampToTimezone,
+      core::QueryConfig::kCastMatchStructByName,
+      core::QueryConfig::kCastToIntByTruncate,
+      core::QueryConfig::kSparkLegacySizeOfNull,
+  };
+  return kConfigs;
+}
+
 std::string errorMessageImpl(const std::exception_ptr& exception) {
   if (!exception) {
     return "";
@@ -156,6 +171,21 @@ std::string makeUuid() {
   return boost::lexical_cast<std::string>(boost::uuids::random_generator()());
 }
 
+// Returns the node with 'id' in the plan tree rooted at 'planNode' or nullptr.
+const core::PlanNode* findPlanNode(
+    const core::PlanNode* planNode,
+    const core::PlanNodeId& id) {
+  if (planNode->id() == id) {
+    return planNode;
+  }
+  for (const auto& child : planNode->sources()) {
+    if (auto node = findPlanNode(child.get(), id)) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
 // Returns true if an operator is a hash join operator given 'operatorType'.
 bool isHashJoinOperator(const std::string& operatorType) {
   return (operatorType == "HashBuild") || (operatorType == "HashProbe");
@@ -326,17 +356,62 @@ void Task::initTaskPool() {
 
 velox::memory::MemoryPool* Task::getOrAddNodePool(
     const core::PlanNodeId& planNodeId,
+    uint32_t splitGroupId,
     bool isHashJoinNode) {
-  if (nodePools_.count(planNodeId) == 1) {
-    return nodePools_[planNodeId];
+  const auto key = std::make_pair(splitGroupId, planNodeId);
+  auto it = nodePools_.find(key);
+  if (it != nodePools_.end()) {
+    return it->second;
   }
-  childPools_.push_back(pool_->addAggregateChild(
+  auto* parentPool = splitGroupId == kUngroupedGroupId
+      ? pool_.get()
+      : getOrAddSplitGroupPool(splitGroupId);
+  childPools_.push_back(parentPool->addAggregateChild(
       fmt::format("node.{}", planNodeId), createNodeReclaimer(isHashJoinNode)));
   auto* nodePool = childPools_.back().get();
-  nodePools_[planNodeId] = nodePool;
+  nodePools_[key] = nodePool;
   return nodePool;
 }
 
+velox::memory::MemoryPool* Task::getOrAddSplitGroupPool(uint32_t splitGroupId) {
+  auto it = splitGroupPools_.find(splitGroupId);
+  if (it != splitGroupPools_.end()) {
+    return it->second;
+  }
+  childPools_.push_back(pool_->addAggregateChild(
+      fmt::format("group.{}", splitGroupId),
+      pool_->reclaimer() != nullptr ? memory::MemoryReclaimer::create()
+                                    : nullptr));
+  auto* groupPool = childPools_.back().get();
+  splitGroupPools_[splitGroupId] = groupPool;
+  return groupPool;
+}
+
+bool Task::hasMemoryForSplitGroupLocked() const {
+  const auto budget = queryCtx_->queryConfig().groupedExecutionMemoryBudget();
+  if (budget == 0) {
+    return true;
+  }
+  auto groupBytes = maxSplitGroupPeakBytes_;
+  for (const auto& [splitGroupId, groupPool] : splitGroupPools_) {
+    groupBytes = std::max(groupBytes, groupPool->peakBytes());
+  }
+  return pool_->currentBytes() + groupBytes <= budget;
+}
+
+void Task::splitGroupPoolsFinishedLocked(uint32_t splitGroupId) {
+  auto it = splitGroupPools_.find(splitGroupId);
+  if (it == splitGroupPools_.end()) {
+    return;
+  }
+  maxSplitGroupPeakBytes_ =
+      std::max(maxSplitGroupPeakBytes_, it->second->peakBytes());
+  splitGroupPools_.erase(it);
+  nodePools_.erase(
+      nodePools_.lower_bound(std::make_pair(splitGroupId, "")),
+      nodePools_.lower_bound(std::make_pair(splitGroupId + 1, "")));
+}
+
 std::unique_ptr<memory::MemoryReclaimer> Task::createNodeReclaimer(
     bool isHashJoinNode) const {
   if (pool()->reclaimer() == nullptr) {
@@ -362,9 +437,10 @@ velox::memory::MemoryPool* Task::addOperatorPool(
     const core::PlanNodeId& planNodeId,
     int pipelineId,
     uint32_t driverId,
-    const std::string& operatorType) {
-  auto* nodePool =
-      getOrAddNodePool(planNodeId, isHashJoinOperator(operatorType));
+    const std::string& operatorType,
+    uint32_t splitGroupId) {
+  auto* nodePool = getOrAddNodePool(
+      planNodeId, splitGroupId, isHashJoinOperator(operatorType));
   childPools_.push_back(nodePool->addLeafChild(fmt::format(
       "op.{}.{}.{}.{}", planNodeId, pipelineId, driverId, operatorType)));
   return childPools_.back().get();
@@ -375,8 +451,9 @@ velox::memory::MemoryPool* Task::addConnectorPoolLocked(
     int pipelineId,
     uint32_t driverId,
     const std::string& operatorType,
-    const std::string& connectorId) {
-  auto* nodePool = getOrAddNodePool(planNodeId);
+    const std::string& connectorId,
+    uint32_t splitGroupId) {
+  auto* nodePool = getOrAddNodePool(planNodeId, splitGroupId);
   childPools_.push_back(nodePool->addAggregateChild(fmt::format(
       "op.{}.{}.{}.{}.{}",
       planNodeId,
@@ -413,7 +490,8 @@ bool Task::supportsSingleThreadedExecution() const {
   }
 
   std::vector<std::unique_ptr<DriverFactory>> driverFactories;
-  LocalPlanner::plan(planFragment_, nullptr, &driverFactories, 1);
+  LocalPlanner::plan(
+      planFragment_, nullptr, &driverFactories, queryCtx_->queryConfig(), 1);
 
   for (const auto& factory : driverFactories) {
     if (!factory->supportsSingleThreadedExecution()) {
@@ -443,6 +521,28 @@ RowVectorPtr Task::next(ContinueFuture* future) {
 
   VELOX_CHECK_EQ(state_, kRunning, "Task has already finished processing.");
 
+  // On first call, look up the results in the cache.
+  if (driverFactories_.empty() && cachedResults_ == nullptr &&
+      queryCtx_->queryConfig().fragmentResultCacheEnabled()) {
+    if (auto* cache = FragmentResultCache::instance()) {
+      resultCacheKey_ = fragmentResultCacheKey();
+      if (resultCacheKey_.has_value()) {
+        cachedResults_ = cache->find(resultCacheKey_.value());
+      }
+      if (cachedResults_ != nullptr) {
+        resultCacheKey_.reset();
+      }
+    }
+  }
+
+  if (cachedResults_ != nullptr) {
+    if (nextCachedResult_ < cachedResults_->size()) {
+      return (*cachedResults_)[nextCachedResult_++];
+    }
+    terminate(kFinished);
+    return nullptr;
+  }
+
   // On first call, create the drivers.
   if (driverFactories_.empty()) {
     VELOX_CHECK_NULL(
@@ -450,7 +550,8 @@ RowVectorPtr Task::next(ContinueFuture* future) {
         "Single-threaded execution doesn't support delivering results to a "
         "callback");
 
-    LocalPlanner::plan(planFragment_, nullptr, &driverFactories_, 1);
+    LocalPlanner::plan(
+        planFragment_, nullptr, &driverFactories_, queryCtx_->queryConfig(), 1);
     exchangeClients_.resize(driverFactories_.size());
 
     // In Task::next() we always assume ungrouped execution.
@@ -500,6 +601,9 @@ RowVectorPtr Task::next(ContinueFuture* future) {
       std::shared_ptr<BlockingState> blockingState;
       auto result = drivers_[i]->next(blockingState);
       if (result) {
+        if (resultCacheKey_.has_value()) {
+          addResultToCache(result);
+        }
         return result;
       }
 
@@ -526,12 +630,71 @@ RowVectorPtr Task::next(ContinueFuture* future) {
           }
           *future = folly::collectAll(std::move(notReadyFutures)).unit();
         }
+      } else if (resultCacheKey_.has_value()) {
+        // All drivers have finished.
+        FragmentResultCache::instance()->insert(
+            resultCacheKey_.value(), std::move(resultsToCache_));
+        resultCacheKey_.reset();
       }
       return nullptr;
     }
   }
 }
 
+std::optional<std::string> Task::fragmentResultCacheKey() const {
+  std::string key;
+  try {
+    key = folly::toJson(planFragment_.planNode->serialize());
+  } catch (const VeloxException&) {
+    // The plan has nodes that can't be serialized.
+    return std::nullopt;
+  }
+
+  // Plans that differ only in these configs may produce different results.
+  const auto& queryConfig = queryCtx_->queryConfig();
+  for (const auto* name : resultAffectingConfigs()) {
+    key += fmt::format(
+        "\n{}={}", name, queryConfig.get<std::string>(name, std::string()));
+  }
+
+  // Leaf nodes in the order of their ids so that the key doesn't depend on
+  // the order of the map.
+  std::map<core::PlanNodeId, const SplitsState*> splitsStates;
+  for (const auto& [planNodeId, splitsState] : splitsStates_) {
+    splitsStates.emplace(planNodeId, &splitsState);
+  }
+  for (const auto& [planNodeId, splitsState] : splitsStates) {
+    key += fmt::format("\n{}:", planNodeId);
+    auto it = splitsState->groupSplitsStores.find(kUngroupedGroupId);
+    if (it == splitsState->groupSplitsStores.end()) {
+      continue;
+    }
+    for (const auto& split : it->second.splits) {
+      if (!split.hasConnectorSplit()) {
+        return std::nullopt;
+      }
+      auto splitKey = split.connectorSplit->cacheKey();
+      if (!splitKey.has_value()) {
+        return std::nullopt;
+      }
+      key += fmt::format("\n{}", splitKey.value());
+    }
+  }
+  return key;
+}
+
+void Task::addResultToCache(const RowVectorPtr& result) {
+  auto* cache = FragmentResultCache::instance();
+  auto copy = cache->copy(result);
+  resultsToCacheBytes_ += copy->retainedSize();
+  if (resultsToCacheBytes_ > cache->maxBytes()) {
+    resultCacheKey_.reset();
+    resultsToCache_.clear();
+    return;
+  }
+  resultsToCache_.push_back(std::move(copy));
+}
+
 // static
 void Task::start(
     std::shared_ptr<Task> self,
@@ -572,6 +735,7 @@ void Task::start(
         self->planFragment_,
         self->consumerSupplier(),
         &self->driverFactories_,
+        self->queryCtx_->queryConfig(),
         maxDrivers);
 
     // Keep one exchange client per pipeline (NULL if not used).
@@ -906,6 +1070,7 @@ void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
         if (splitGroupId != kUngroupedGroupId) {
           --self->numRunningSplitGroups_;
           self->taskStats_.completedSplitGroups.emplace(splitGroupId);
+          self->splitGroupPoolsFinishedLocked(splitGroupId);
           stateChangeNotifier.activate(std::move(self->stateChangePromises_));
           splitGroupState.clear();
           self->ensureSplitGroupsAreBeingProcessedLocked(self);
@@ -944,6 +1109,11 @@ void Task::ensureSplitGroupsAreBeingProcessedLocked(
 
   while (numRunningSplitGroups_ < concurrentSplitGroups_ and
          not queuedSplitGroups_.empty()) {
+    // A group always runs so that the task makes progress. The next group
+    // starts when a running group finishes.
+    if (numRunningSplitGroups_ > 0 && !hasMemoryForSplitGroupLocked()) {
+      break;
+    }
     const uint32_t splitGroupId = queuedSplitGroups_.front();
     queuedSplitGroups_.pop();
 
@@ -1038,6 +1208,78 @@ void Task::addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split) {
   }
 }
 
+void Task::addSubSplits(
+    const core::PlanNodeId& planNodeId,
+    uint32_t splitGroupId,
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> splits) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!isRunningLocked()) {
+      return;
+    }
+    auto& splitsStore = getPlanNodeSplitsStateLocked(planNodeId)
+                            .groupSplitsStores[splitGroupId];
+    const int32_t groupId =
+        splitGroupId == kUngroupedGroupId ? -1 : splitGroupId;
+    // Added in reverse so that the sub-splits are taken in file order.
+    for (auto it = splits.rbegin(); it != splits.rend(); ++it) {
+      VELOX_CHECK_NULL((*it)->dataSource);
+      splitsStore.splits.emplace_front(std::move(*it), groupId);
+    }
+    taskStats_.numTotalSplits += splits.size();
+    taskStats_.numQueuedSplits += splits.size();
+    while (!splitsStore.splitPromises.empty() &&
+           promises.size() < splits.size()) {
+      promises.push_back(std::move(splitsStore.splitPromises.back()));
+      splitsStore.splitPromises.pop_back();
+    }
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void Task::addDynamicFilter(
+    const core::PlanNodeId& planNodeId,
+    column_index_t outputChannel,
+    std::shared_ptr<common::Filter> filter) {
+  VELOX_CHECK_NOT_NULL(filter);
+  auto* scanNode = dynamic_cast<const core::TableScanNode*>(
+      findPlanNode(planFragment_.planNode.get(), planNodeId));
+  VELOX_USER_CHECK_NOT_NULL(
+      scanNode,
+      "Dynamic filters can be added only to table scan plan nodes. Plan node "
+      "ID {} doesn't refer to such plan node.",
+      planNodeId);
+  VELOX_USER_CHECK_LT(
+      outputChannel,
+      scanNode->outputType()->size(),
+      "Dynamic filter channel is out of range for plan node {}",
+      planNodeId);
+
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!isRunningLocked()) {
+    return;
+  }
+  externalDynamicFilters_[planNodeId].emplace_back(
+      outputChannel, std::move(filter));
+  ++numExternalDynamicFilters_;
+}
+
+std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+Task::externalDynamicFilters(
+    const core::PlanNodeId& planNodeId,
+    size_t startIndex) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = externalDynamicFilters_.find(planNodeId);
+  if (it == externalDynamicFilters_.end() ||
+      startIndex >= it->second.size()) {
+    return {};
+  }
+  return {it->second.begin() + startIndex, it->second.end()};
+}
+
 void Task::addRemoteSplit(
     const core::PlanNodeId& planNodeId,
     const exec::Split& split) {
@@ -1200,14 +1442,18 @@ BlockingReason Task::getSplitOrFuture(
     exec::Split& split,
     ContinueFuture& future,
     int32_t maxPreloadSplits,
-    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    int32_t maxPrefetchSplits,
+    SplitPrefetcher prefetch) {
   std::lock_guard<std::mutex> l(mutex_);
   return getSplitOrFutureLocked(
       getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId],
       split,
       future,
       maxPreloadSplits,
-      preload);
+      preload,
+      maxPrefetchSplits,
+      prefetch);
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
@@ -1215,7 +1461,9 @@ BlockingReason Task::getSplitOrFutureLocked(
     exec::Split& split,
     ContinueFuture& future,
     int32_t maxPreloadSplits,
-    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    int32_t maxPrefetchSplits,
+    const SplitPrefetcher& prefetch) {
   if (splitsStore.splits.empty()) {
     if (splitsStore.noMoreSplits) {
       return BlockingReason::kNotBlocked;
@@ -1227,14 +1475,17 @@ BlockingReason Task::getSplitOrFutureLocked(
     return BlockingReason::kWaitForSplit;
   }
 
-  split = getSplitLocked(splitsStore, maxPreloadSplits, preload);
+  split = getSplitLocked(
+      splitsStore, maxPreloadSplits, preload, maxPrefetchSplits, prefetch);
   return BlockingReason::kNotBlocked;
 }
 
 exec::Split Task::getSplitLocked(
     SplitsStore& splitsStore,
     int32_t maxPreloadSplits,
-    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    int32_t maxPrefetchSplits,
+    const SplitPrefetcher& prefetch) {
   int32_t readySplitIndex = -1;
   if (maxPreloadSplits) {
     for (auto i = 0; i < splitsStore.splits.size() && i < maxPreloadSplits;
@@ -1248,6 +1499,21 @@ exec::Split Task::getSplitLocked(
       }
     }
   }
+  if (maxPrefetchSplits) {
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> prefetchSplits;
+    const auto end = std::min<size_t>(
+        splitsStore.splits.size(), maxPreloadSplits + maxPrefetchSplits);
+    for (auto i = maxPreloadSplits; i < end; ++i) {
+      auto& split = splitsStore.splits[i].connectorSplit;
+      if (!split->filesPrefetched) {
+        split->filesPrefetched = true;
+        prefetchSplits.push_back(split);
+      }
+    }
+    if (!prefetchSplits.empty()) {
+      prefetch(std::move(prefetchSplits));
+    }
+  }
   if (readySplitIndex == -1) {
     readySplitIndex = 0;
   }
@@ -1757,6 +2023,37 @@ void Task::addOperatorStats(OperatorStats& stats) {
       .add(stats);
 }
 
+void Task::addDriverStats(int pipelineId, const DriverStats& stats) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(
+      pipelineId >= 0 && pipelineId < taskStats_.pipelineStats.size());
+  taskStats_.pipelineStats[pipelineId].driverStats.add(stats);
+}
+
+void Task::updateMemoryPeak() {
+  const auto queryBytes = pool_->root()->currentBytes();
+  if (queryBytes <= memoryPeakBytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& peak = taskStats_.memoryPeak;
+  if (queryBytes <= peak.queryBytes) {
+    return;
+  }
+  peak.queryBytes = queryBytes;
+  peak.taskBytes = pool_->currentBytes();
+  peak.timeMs = timeSinceStartMsLocked();
+  peak.nodeBytes.clear();
+  for (const auto& [key, nodePool] : nodePools_) {
+    const auto bytes = nodePool->currentBytes();
+    if (bytes > 0) {
+      // Sums the pools of the node in all split groups.
+      peak.nodeBytes[key.second] += bytes;
+    }
+  }
+  memoryPeakBytes_ = queryBytes;
+}
+
 TaskStats Task::taskStats() const {
   std::lock_guard<std::mutex> l(mutex_);
 
@@ -1782,6 +2079,8 @@ TaskStats Task::taskStats() const {
           .operatorStats[statsCopy.operatorId]
           .add(statsCopy);
     }
+    taskStats.pipelineStats[driver->driverCtx()->pipelineId].driverStats.add(
+        driver->stats());
     if (driver->isOnThread()) {
       ++taskStats.numRunningDrivers;
     } else if (driver->isTerminated()) {
@@ -1791,6 +2090,10 @@ TaskStats Task::taskStats() const {
     }
   }
 
+  // The memory arbitration is accounted per query on its root memory pool.
+  auto* queryPool = queryCtx_->pool()->root();
+  taskStats.memoryArbitrationWaitTimeUs = queryPool->arbitrationWaitTimeUs();
+  taskStats.memoryReclaimedBytes = queryPool->reclaimedBytes();
   return taskStats;
 }
 
@@ -32,6 +32,11 @@ class HashJoinBridge;
 class NestedLoopJoinBridge;
 class Task : public std::enable_shared_from_this<Task> {
  public:
+  /// Callback of getSplitOrFuture() that starts prefetching the files of a
+  /// batch of queued splits.
+  using SplitPrefetcher = std::function<void(
+      std::vector<std::shared_ptr<connector::ConnectorSplit>>)>;
+
   /// Creates a task to execute a plan fragment, but doesn't start execution
   /// until Task::start() method is called.
   /// @param taskId Unique task identifier.
@@ -152,6 +157,11 @@ class Task : public std::enable_shared_from_this<Task> {
   /// updates `future`. `future` is realized when the operators are no longer
   /// blocked. Caller thread is responsible to wait for future before calling
   /// `next` again.
+  ///
+  /// If QueryConfig::fragmentResultCacheEnabled() is true, the results of the
+  /// plan fragment with its splits may be returned from FragmentResultCache
+  /// without running the plan. Cached results are shared between the queries
+  /// and must not be modified.
   RowVectorPtr next(ContinueFuture* future = nullptr);
 
   /// Resumes execution of 'self' after a successful pause. All 'drivers_' must
@@ -184,6 +194,15 @@ class Task : public std::enable_shared_from_this<Task> {
   /// Note that, the operation is silently ignored if Task is not running.
   void addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split);
 
+  /// Adds 'splits' produced by dividing a split of the source operator of
+  /// 'planNodeId' in 'splitGroupId' at the head of the split queue so that
+  /// idle drivers pick them up before the remaining splits. The splits count
+  /// as new splits of the Task.
+  void addSubSplits(
+      const core::PlanNodeId& planNodeId,
+      uint32_t splitGroupId,
+      std::vector<std::shared_ptr<connector::ConnectorSplit>> splits);
+
   /// We mark that for the given group there would be no more splits coming.
   void noMoreSplitsForGroup(
       const core::PlanNodeId& planNodeId,
@@ -193,6 +212,32 @@ class Task : public std::enable_shared_from_this<Task> {
   /// corresponding to plan node with specified ID.
   void noMoreSplits(const core::PlanNodeId& planNodeId);
 
+  /// Adds a dynamic filter supplied from outside of the task, e.g. by a
+  /// coordinator that broadcasts the filters made by the build side of a join
+  /// running in another stage. 'planNodeId' must refer to a TableScanNode and
+  /// 'outputChannel' to one of its output columns. The running TableScan
+  /// operators of the node apply the filter before producing their next batch.
+  /// TableScan operators created later apply it on start. Filters for the same
+  /// column are merged. Note that, the operation is silently ignored if Task is
+  /// not running.
+  void addDynamicFilter(
+      const core::PlanNodeId& planNodeId,
+      column_index_t outputChannel,
+      std::shared_ptr<common::Filter> filter);
+
+  /// Returns the filters added with addDynamicFilter() for 'planNodeId' in the
+  /// order they were added, skipping the first 'startIndex' ones.
+  std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+  externalDynamicFilters(const core::PlanNodeId& planNodeId, size_t startIndex)
+      const;
+
+  /// Returns the number of filters added with addDynamicFilter() to all plan
+  /// nodes. Does not take the task lock. Used by TableScan to cheaply check
+  /// for new filters.
+  uint64_t numExternalDynamicFilters() const {
+    return numExternalDynamicFilters_;
+  }
+
   /// Updates the total number of output buffers to broadcast or arbitrarily
   /// distribute the results of the execution to. Used when plan tree ends with
   /// a PartitionedOutputNode with broadcast of arbitrary output type.
@@ -289,12 +334,15 @@ class Task : public std::enable_shared_from_this<Task> {
 
   /// Creates new instance of MemoryPool for an operator, stores it in the task
   /// to ensure lifetime and returns a raw pointer. Not thread safe, e.g. must
-  /// be called from the Operator's constructor.
+  /// be called from the Operator's constructor. The pools of the operators of
+  /// a split group in grouped execution are under the pool of the split
+  /// group.
   velox::memory::MemoryPool* addOperatorPool(
       const core::PlanNodeId& planNodeId,
       int pipelineId,
       uint32_t driverId,
-      const std::string& operatorType);
+      const std::string& operatorType,
+      uint32_t splitGroupId = kUngroupedGroupId);
 
   /// Creates new instance of MemoryPool with aggregate kind for the connector
   /// use, stores it in the task to ensure lifetime and returns a raw pointer.
@@ -304,7 +352,8 @@ class Task : public std::enable_shared_from_this<Task> {
       int pipelineId,
       uint32_t driverId,
       const std::string& operatorType,
-      const std::string& connectorId);
+      const std::string& connectorId,
+      uint32_t splitGroupId = kUngroupedGroupId);
 
   /// Creates new instance of MemoryPool for a merge source in a
   /// MergeExchangeNode, stores it in the task to ensure lifetime and returns a
@@ -327,7 +376,10 @@ class Task : public std::enable_shared_from_this<Task> {
   /// that will complete when split becomes available or no-more-splits
   /// signal is received. If 'maxPreloadSplits' is given, ensures that
   /// so many of splits at the head of the queue are preloading. If
-  /// they are not, calls preload on them to start preload.
+  /// they are not, calls preload on them to start preload. If
+  /// 'maxPrefetchSplits' is given, calls 'prefetch' with the splits among
+  /// the next 'maxPrefetchSplits' after the preloaded ones that have not
+  /// been prefetched yet.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
@@ -335,7 +387,9 @@ class Task : public std::enable_shared_from_this<Task> {
       ContinueFuture& future,
       int32_t maxPreloadSplits = 0,
       std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
-          nullptr);
+          nullptr,
+      int32_t maxPrefetchSplits = 0,
+      SplitPrefetcher prefetch = nullptr);
 
   void splitFinished();
 
@@ -463,6 +517,14 @@ class Task : public std::enable_shared_from_this<Task> {
   /// stats. Called from Drivers upon their closure.
   void addOperatorStats(OperatorStats& stats);
 
+  /// Adds 'stats' to the scheduling times of the pipeline 'pipelineId' in
+  /// the Task stats.
+  void addDriverStats(int pipelineId, const DriverStats& stats);
+
+  /// Records the usage of the plan nodes of 'this' in TaskStats::memoryPeak
+  /// if the memory usage of the query is higher than at the last call.
+  void updateMemoryPeak();
+
   /// Returns kNone if no pause or terminate is requested. The thread count is
   /// incremented if kNone is returned. If something else is returned the
   /// calling thread should unwind and return itself to its pool. If 'this' goes
@@ -617,12 +679,28 @@ class Task : public std::enable_shared_from_this<Task> {
   // Invoked to initialize the memory pool for this task on creation.
   void initTaskPool();
 
-  // Creates new instance of MemoryPool for a plan node, stores it in the task
-  // to ensure lifetime and returns a raw pointer.
+  // Creates new instance of MemoryPool for a plan node in a split group,
+  // stores it in the task to ensure lifetime and returns a raw pointer. The
+  // node pools of a split group in grouped execution are under the pool of the
+  // split group, the others are under 'pool_'.
   memory::MemoryPool* getOrAddNodePool(
       const core::PlanNodeId& planNodeId,
+      uint32_t splitGroupId = kUngroupedGroupId,
       bool isHashJoinNode = false);
 
+  // Returns the pool of the memory of a split group in grouped execution.
+  // Created on first use.
+  memory::MemoryPool* getOrAddSplitGroupPool(uint32_t splitGroupId);
+
+  // Returns true if another split group may start without going over
+  // QueryConfig::groupedExecutionMemoryBudget(). A group is expected to use
+  // as much memory as the largest running or finished group.
+  bool hasMemoryForSplitGroupLocked() const;
+
+  // Called when split group 'splitGroupId' finishes. Records the peak memory
+  // of the group and drops the pools of the group from the maps.
+  void splitGroupPoolsFinishedLocked(uint32_t splitGroupId);
+
   // Creates a memory reclaimer instance for a plan node if the task memory
   // pool has set memory reclaimer. If 'isHashJoinNode' is true, it creates a
   // customized instance for hash join plan node, otherwise creates a default
@@ -716,19 +794,33 @@ class Task : public std::enable_shared_from_this<Task> {
       ContinueFuture& future,
       int32_t maxPreloadSplits = 0,
       std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
-          nullptr);
+          nullptr,
+      int32_t maxPrefetchSplits = 0,
+      const SplitPrefetcher& prefetch = nullptr);
 
   /// Returns next split from the store. The caller must ensure the store is not
   /// empty.
   exec::Split getSplitLocked(
       SplitsStore& splitsStore,
       int32_t maxPreloadSplits,
-      std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload);
+      std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+      int32_t maxPrefetchSplits = 0,
+      const SplitPrefetcher& prefetch = nullptr);
 
   /// Creates for the given split group and fills up the 'SplitGroupState'
   /// structure, which stores inter-operator state (local exchange, bridges).
   void createSplitGroupStateLocked(uint32_t splitGroupId);
 
+  /// Returns the key of the results of 'planFragment_' and the splits added
+  /// to 'this' in FragmentResultCache. Returns std::nullopt if the results
+  /// can't be cached, e.g. a split without a cache key. Called by next()
+  /// before running the plan.
+  std::optional<std::string> fragmentResultCacheKey() const;
+
+  /// Adds a copy of 'result' returned by next() to 'resultsToCache_'. Stops
+  /// caching the results if these get larger than the cache.
+  void addResultToCache(const RowVectorPtr& result);
+
   /// Creates a bunch of drivers for the given split group.
   void createDriversLocked(
       std::shared_ptr<Task>& self,
@@ -871,11 +963,21 @@ class Task : public std::enable_shared_from_this<Task> {
   // to allow for sharing vectors across drivers without copy.
   std::vector<std::shared_ptr<memory::MemoryPool>> childPools_;
 
-  // The map from plan node id to the corresponding memory pool object's raw
-  // pointer.
+  // The map from split group id and plan node id to the corresponding memory
+  // pool object's raw pointer. The split group id is kUngroupedGroupId for
+  // the nodes not in grouped execution.
   //
   // NOTE: 'childPools_' holds the ownerships of node memory pools.
-  std::unordered_map<core::PlanNodeId, memory::MemoryPool*> nodePools_;
+  std::map<std::pair<uint32_t, core::PlanNodeId>, memory::MemoryPool*>
+      nodePools_;
+
+  // The pools of the running split groups in grouped execution.
+  //
+  // NOTE: 'childPools_' holds the ownerships of split group memory pools.
+  std::unordered_map<uint32_t, memory::MemoryPool*> splitGroupPools_;
+
+  // The largest peak memory of a finished split group.
+  int64_t maxSplitGroupPeakBytes_{0};
 
   // Set to true by PartitionedOutputBufferManager when all output is
   // acknowledged. If this happens before Drivers are at end, the last
@@ -911,6 +1013,17 @@ class Task : public std::enable_shared_from_this<Task> {
 
   std::vector<std::unique_ptr<DriverFactory>> driverFactories_;
   std::vector<std::shared_ptr<Driver>> drivers_;
+
+  /// Key of the results in FragmentResultCache if the results returned by
+  /// next() are cached when done.
+  std::optional<std::string> resultCacheKey_;
+  /// Copies of the results returned by next() so far.
+  std::vector<RowVectorPtr> resultsToCache_;
+  uint64_t resultsToCacheBytes_{0};
+  /// Results returned by next() from FragmentResultCache instead of running
+  /// the plan and the index of the next one to return.
+  std::shared_ptr<const std::vector<RowVectorPtr>> cachedResults_;
+  size_t nextCachedResult_{0};
   /// The total number of running drivers in all pipelines.
   /// This number changes over time as drivers finish their work and maybe new
   /// get created.
@@ -972,6 +1085,21 @@ class Task : public std::enable_shared_from_this<Task> {
   /// manage splits of the plan nodes that expect splits.
   std::unordered_map<core::PlanNodeId, SplitsState> splitsStates_;
 
+  /// Dynamic filters added with addDynamicFilter() per table scan plan node id
+  /// in the order they were added.
+  std::unordered_map<
+      core::PlanNodeId,
+      std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>>
+      externalDynamicFilters_;
+
+  /// Total number of filters in 'externalDynamicFilters_'. Updated under
+  /// 'mutex_' and read without it.
+  std::atomic<uint64_t> numExternalDynamicFilters_{0};
+
+  /// 'taskStats_.memoryPeak.queryBytes'. Updated under 'mutex_' and read
+  /// without it.
+  std::atomic<uint64_t> memoryPeakBytes_{0};
+
   // Promises that are fulfilled when the task is completed (terminated).
   std::vector<ContinuePromise> taskCompletionPromises_;
 
@@ -39,10 +39,25 @@ struct PipelineStats {
   // True if contains the sync node for the task.
   bool outputPipeline;
 
+  // Executor queue and on thread times of the quanta of the Drivers.
+  DriverStats driverStats;
+
   PipelineStats(bool _inputPipeline, bool _outputPipeline)
       : inputPipeline{_inputPipeline}, outputPipeline{_outputPipeline} {}
 };
 
+/// Memory usage at the highest usage of the query seen by the Drivers of a
+/// Task when they sample, see 'operator_memory_sample_interval_ms'. Tells
+/// which plan nodes of the Task held the memory at the peak.
+struct MemoryPeakStats {
+  uint64_t queryBytes{0};
+  uint64_t taskBytes{0};
+  /// Time of the peak since the start of the Task.
+  uint64_t timeMs{0};
+  /// Usage of the plan nodes that held memory at the peak.
+  std::unordered_map<core::PlanNodeId, uint64_t> nodeBytes;
+};
+
 /// Stores execution stats per task.
 struct TaskStats {
   int32_t numTotalSplits{0};
@@ -85,6 +100,15 @@ struct TaskStats {
   uint64_t numRunningDrivers{0};
   /// Drivers blocked for various reasons. Based on enum BlockingReason.
   std::unordered_map<BlockingReason, uint64_t> numBlockedDrivers;
+
+  /// The time in microseconds the query of the task has waited for memory
+  /// arbitration, including the queue time.
+  uint64_t memoryArbitrationWaitTimeUs{0};
+  /// The used memory bytes reclaimed from the query of the task by memory
+  /// arbitration, e.g. by disk spilling.
+  uint64_t memoryReclaimedBytes{0};
+
+  MemoryPeakStats memoryPeak;
 };
 
 } // namespace facebook::velox::exec
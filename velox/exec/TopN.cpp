@@ -14,10 +14,62 @@
  * limitations under the License.
  */
 #include "velox/exec/TopN.h"
+
+#include <numeric>
+
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+bool isPreFilterKind(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Appends to 'candidates' the rows in [begin, end) of 'decoded' that are null
+// or not after 'threshold' in the sort order.
+template <typename T>
+void addCandidatesTyped(
+    const DecodedVector& decoded,
+    int64_t threshold,
+    bool ascending,
+    vector_size_t begin,
+    vector_size_t end,
+    std::vector<vector_size_t>& candidates) {
+  auto numCandidates = candidates.size();
+  candidates.resize(numCandidates + end - begin);
+  auto* rawCandidates = candidates.data();
+  if (decoded.isIdentityMapping() && !decoded.mayHaveNulls()) {
+    // Branch free loop over the values.
+    const auto* values = decoded.data<T>();
+    for (auto row = begin; row < end; ++row) {
+      const int64_t value = values[row];
+      rawCandidates[numCandidates] = row;
+      numCandidates += ascending ? value <= threshold : value >= threshold;
+    }
+  } else {
+    for (auto row = begin; row < end; ++row) {
+      rawCandidates[numCandidates] = row;
+      if (decoded.isNullAt(row)) {
+        ++numCandidates;
+        continue;
+      }
+      const int64_t value = decoded.valueAt<T>(row);
+      numCandidates += ascending ? value <= threshold : value >= threshold;
+    }
+  }
+  candidates.resize(numCandidates);
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,6 +81,11 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
+      firstKeyChannel_(
+          exprToChannel(topNNode->sortingKeys()[0].get(), outputType_)),
+      firstKeyAscending_(topNNode->sortingOrders()[0].isAscending()),
+      canPreFilter_(
+          isPreFilterKind(outputType_->childAt(firstKeyChannel_)->kind())),
       data_(std::make_unique<RowContainer>(outputType_->children(), pool())),
       comparator_(
           outputType_,
@@ -44,27 +101,109 @@ void TopN::addInput(RowVectorPtr input) {
     decodedVectors_[col].decode(*input->childAt(col));
   }
 
-  for (auto row = 0; row < input->size(); ++row) {
-    char* newRow = nullptr;
-    if (topRows_.size() < count_) {
-      newRow = data_->newRow();
-    } else {
-      char* topRow = topRows_.top();
+  const auto numColumns = input->childrenSize();
+  vector_size_t row = 0;
+  for (; row < input->size() && topRows_.size() < count_; ++row) {
+    processRow(row, numColumns);
+  }
+  if (row == input->size()) {
+    return;
+  }
 
-      if (!comparator_(decodedVectors_, row, topRow)) {
-        continue;
-      }
-      topRows_.pop();
-      // Reuse the topRow's memory.
-      newRow = data_->initializeRow(topRow, true /* reuse */);
+  if (!updateThreshold()) {
+    for (; row < input->size(); ++row) {
+      processRow(row, numColumns);
     }
+    return;
+  }
 
-    for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedVectors_[col], row, newRow, col);
+  // 'topRows_' is full. Rows after the top row on the first key can't enter
+  // it, so only the rest go to the comparator. The threshold only tightens as
+  // rows are added, so the candidates are a superset of the rows to add.
+  candidates_.clear();
+  addCandidates(row, input->size());
+  numPreFilteredRows_ += input->size() - row - candidates_.size();
+  for (auto candidate : candidates_) {
+    processRow(candidate, numColumns);
+  }
+}
+
+bool TopN::updateThreshold() {
+  if (!canPreFilter_ || count_ == 0) {
+    return false;
+  }
+  char* topRow = topRows_.top();
+  if (!thresholdVector_) {
+    thresholdVector_ =
+        BaseVector::create(outputType_->childAt(firstKeyChannel_), 1, pool());
+  }
+  data_->extractColumn(&topRow, 1, firstKeyChannel_, thresholdVector_);
+  if (thresholdVector_->isNullAt(0)) {
+    return false;
+  }
+  switch (thresholdVector_->typeKind()) {
+    case TypeKind::TINYINT:
+      threshold_ = thresholdVector_->asFlatVector<int8_t>()->valueAt(0);
+      break;
+    case TypeKind::SMALLINT:
+      threshold_ = thresholdVector_->asFlatVector<int16_t>()->valueAt(0);
+      break;
+    case TypeKind::INTEGER:
+      threshold_ = thresholdVector_->asFlatVector<int32_t>()->valueAt(0);
+      break;
+    case TypeKind::BIGINT:
+      threshold_ = thresholdVector_->asFlatVector<int64_t>()->valueAt(0);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  return true;
+}
+
+void TopN::addCandidates(vector_size_t begin, vector_size_t end) {
+  const auto& decoded = decodedVectors_[firstKeyChannel_];
+  switch (thresholdVector_->typeKind()) {
+    case TypeKind::TINYINT:
+      addCandidatesTyped<int8_t>(
+          decoded, threshold_, firstKeyAscending_, begin, end, candidates_);
+      break;
+    case TypeKind::SMALLINT:
+      addCandidatesTyped<int16_t>(
+          decoded, threshold_, firstKeyAscending_, begin, end, candidates_);
+      break;
+    case TypeKind::INTEGER:
+      addCandidatesTyped<int32_t>(
+          decoded, threshold_, firstKeyAscending_, begin, end, candidates_);
+      break;
+    case TypeKind::BIGINT:
+      addCandidatesTyped<int64_t>(
+          decoded, threshold_, firstKeyAscending_, begin, end, candidates_);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+void TopN::processRow(vector_size_t row, vector_size_t numColumns) {
+  char* newRow = nullptr;
+  if (topRows_.size() < count_) {
+    newRow = data_->newRow();
+  } else {
+    char* topRow = topRows_.top();
+
+    if (!comparator_(decodedVectors_, row, topRow)) {
+      return;
     }
+    topRows_.pop();
+    // Reuse the topRow's memory.
+    newRow = data_->initializeRow(topRow, true /* reuse */);
+  }
 
-    topRows_.push(newRow);
+  for (auto col = 0; col < numColumns; ++col) {
+    data_->store(decodedVectors_[col], row, newRow, col);
   }
+
+  topRows_.push(newRow);
 }
 
 RowVectorPtr TopN::getOutput() {
@@ -79,13 +218,13 @@ RowVectorPtr TopN::getOutput() {
   auto result = BaseVector::create<RowVector>(
       outputType_, numRowsToReturn, operatorCtx_->pool());
 
-  for (auto i = 0; i < outputType_->size(); ++i) {
-    data_->extractColumn(
-        rows_.data() + numRowsReturned_,
-        numRowsToReturn,
-        i,
-        result->childAt(i));
-  }
+  std::vector<column_index_t> columns(outputType_->size());
+  std::iota(columns.begin(), columns.end(), 0);
+  data_->extractColumns(
+      rows_.data() + numRowsReturned_,
+      numRowsToReturn,
+      columns,
+      result->children());
   numRowsReturned_ += numRowsToReturn;
   finished_ = (numRowsReturned_ == rows_.size());
   return result;
@@ -93,6 +232,9 @@ RowVectorPtr TopN::getOutput() {
 
 void TopN::noMoreInput() {
   Operator::noMoreInput();
+  if (numPreFilteredRows_ > 0) {
+    addRuntimeStat("preFilteredRows", RuntimeCounter(numPreFilteredRows_));
+  }
   if (topRows_.empty()) {
     finished_ = true;
     return;
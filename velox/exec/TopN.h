@@ -44,8 +44,35 @@ class TopN : public Operator {
   bool isFinished() override;
 
  private:
+  // Returns true if rows can be pre-filtered on the first sort key, i.e. it
+  // is an integer with a non-null value in the top of 'topRows_'. Sets the
+  // value of the top row to 'threshold_' if so.
+  bool updateThreshold();
+
+  // Adds to 'candidates_' the rows in [begin, end) of the input that may sort
+  // before 'threshold_' on the first sort key. The other rows can't enter the
+  // top N since 'topRows_' is full.
+  void addCandidates(vector_size_t begin, vector_size_t end);
+
+  // Adds 'row' of the input to 'topRows_' if it sorts before the top row.
+  void processRow(vector_size_t row, vector_size_t numColumns);
+
   const int32_t count_;
 
+  // Channel and order of the first sort key.
+  const column_index_t firstKeyChannel_;
+  const bool firstKeyAscending_;
+  // True if the first sort key is of a type supported by addCandidates().
+  const bool canPreFilter_;
+  // The first sort key of the top row of 'topRows_' when the input was
+  // pre-filtered.
+  int64_t threshold_;
+  // Holds the first sort key of the top row while reading 'threshold_'.
+  VectorPtr thresholdVector_;
+  // Number of input rows skipped by the pre-filter.
+  uint64_t numPreFilteredRows_{0};
+  std::vector<vector_size_t> candidates_;
+
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
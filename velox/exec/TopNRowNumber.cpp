@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/TopNRowNumber.h"
+#include "velox/exec/OperatorUtils.h"
 
 namespace facebook::velox::exec {
 
@@ -26,20 +27,63 @@ TopNRowNumber::TopNRowNumber(
           node->outputType(),
           operatorId,
           node->id(),
-          "TopNRowNumber"),
+          "TopNRowNumber",
+          node->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
       limit_{node->limit()},
       generateRowNumber_{node->generateRowNumber()},
       inputType_{node->sources()[0]->outputType()},
-      data_(std::make_unique<RowContainer>(inputType_->children(), pool())),
-      comparator_(
-          inputType_,
-          node->sortingKeys(),
-          node->sortingOrders(),
-          data_.get()),
       decodedVectors_(inputType_->children().size()) {
   const auto& keys = node->partitionKeys();
   const auto numKeys = keys.size();
 
+  // Store the partitioning keys followed by the sorting keys as the key
+  // columns of 'data_' so that the Spiller sorts the spilled rows by them.
+  // A key that appears more than once is stored once.
+  std::vector<column_index_t> channelColumns(
+      inputType_->size(), kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  auto addColumn = [&](column_index_t channel) {
+    channelColumns[channel] = columnMap_.size();
+    columnMap_.emplace_back(columnMap_.size(), channel);
+    types.push_back(inputType_->childAt(channel));
+    names.push_back(inputType_->nameOf(channel));
+  };
+  auto addKey = [&](const core::FieldAccessTypedExprPtr& key,
+                    const core::SortOrder& sortOrder) {
+    const auto channel = exprToChannel(key.get(), inputType_);
+    if (channelColumns[channel] == kConstantChannel) {
+      addColumn(channel);
+      keyTypes.push_back(types.back());
+      keyCompareFlags_.push_back(
+          {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+    }
+  };
+  for (const auto& key : keys) {
+    addKey(key, core::kAscNullsFirst);
+  }
+  numPartitionKeyColumns_ = columnMap_.size();
+  for (auto i = 0; i < node->sortingKeys().size(); ++i) {
+    addKey(node->sortingKeys()[i], node->sortingOrders()[i]);
+  }
+  for (column_index_t channel = 0; channel < inputType_->size(); ++channel) {
+    if (channelColumns[channel] == kConstantChannel) {
+      addColumn(channel);
+      dependentTypes.push_back(types.back());
+    }
+  }
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+  comparator_ = std::make_unique<RowComparator>(
+      internalStoreType_,
+      node->sortingKeys(),
+      node->sortingOrders(),
+      data_.get());
+
   if (numKeys > 0) {
     Accumulator accumulator{true, sizeof(TopRows), false, 1, [](auto) {}};
 
@@ -55,7 +99,8 @@ TopNRowNumber::TopNRowNumber(
     lookup_ = std::make_unique<HashLookup>(table_->hashers());
   } else {
     allocator_ = std::make_unique<HashStringAllocator>(pool());
-    singlePartition_ = std::make_unique<TopRows>(allocator_.get(), comparator_);
+    singlePartition_ =
+        std::make_unique<TopRows>(allocator_.get(), *comparator_);
   }
 
   identityProjections_.reserve(inputType_->size());
@@ -70,10 +115,23 @@ TopNRowNumber::TopNRowNumber(
 }
 
 void TopNRowNumber::addInput(RowVectorPtr input) {
+  // Test-only spill path.
+  if (spillConfig_.has_value() && spillConfig_->testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig_->testSpillPct) {
+    spill();
+  }
+
+  // Prevents the memory arbitrator to reclaim memory from this operator
+  // while 'lookup_' refers to the rows of the hash table.
+  NonReclaimableSection guard(this);
+
   const auto numInput = input->size();
 
-  for (auto i = 0; i < inputType_->size(); ++i) {
-    decodedVectors_[i].decode(*input->childAt(i));
+  // 'decodedVectors_' are indexed by the columns of 'data_'.
+  for (const auto& columnProjection : columnMap_) {
+    decodedVectors_[columnProjection.inputChannel].decode(
+        *input->childAt(columnProjection.outputChannel));
   }
 
   if (table_) {
@@ -101,7 +159,7 @@ void TopNRowNumber::addInput(RowVectorPtr input) {
 void TopNRowNumber::initializeNewPartitions() {
   for (auto index : lookup_->newGroups) {
     new (lookup_->hits[index] + partitionOffset_)
-        TopRows(table_->stringAllocator(), comparator_);
+        TopRows(table_->stringAllocator(), *comparator_);
   }
 }
 
@@ -117,7 +175,7 @@ void TopNRowNumber::processInputRow(
   } else {
     char* topRow = topRows.top();
 
-    if (!comparator_(decodedVectors_, index, topRow)) {
+    if (!(*comparator_)(decodedVectors_, index, topRow)) {
       // Drop this input row.
       return;
     }
@@ -146,6 +204,80 @@ void TopNRowNumber::noMoreInput() {
 
   outputBatchSize_ = outputBatchRows(rowSize);
   outputRows_.resize(outputBatchSize_);
+
+  if (spiller_ != nullptr) {
+    // Spill the remaining rows to merge them with the spilled runs.
+    spill();
+    SpillPartitionSet spillPartitionSet;
+    spiller_->finishSpill(spillPartitionSet);
+    VELOX_CHECK(spillPartitionSet.empty());
+    recordSpillStats();
+
+    spillMerge_ = spiller_->startMerge(0);
+    spillSources_.resize(outputBatchSize_);
+    spillSourceRows_.resize(outputBatchSize_);
+  }
+}
+
+void TopNRowNumber::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+
+  // NOTE: a topn row number operator is reclaimable if it hasn't started
+  // output processing and is not under non-reclaimable execution section.
+  if (noMoreInput_ || nonReclaimableSection_) {
+    LOG(WARNING) << "Can't reclaim from topn row number operator, noMoreInput_["
+                 << noMoreInput_ << "], nonReclaimableSection_["
+                 << nonReclaimableSection_ << "], " << toString();
+    return;
+  }
+
+  spill();
+  // Release the minimum reserved memory.
+  pool()->release();
+}
+
+void TopNRowNumber::spill() {
+  VELOX_CHECK_NOT_NULL(table_);
+
+  if (spiller_ == nullptr) {
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kTopNRowNumber,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        keyCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.readAheadDepth);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+
+  spiller_->spill(0, 0);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  data_->clear();
+  // The partitions refer to the spilled rows. The following inputs start new
+  // partitions whose rows are merged with the spilled ones at the end.
+  table_->clear();
+}
+
+void TopNRowNumber::recordSpillStats() {
+  VELOX_CHECK_NOT_NULL(spiller_);
+  VELOX_CHECK(noMoreInput_);
+
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledInputBytes = spillStats.spilledInputBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
 }
 
 TopNRowNumber::TopRows* TopNRowNumber::nextPartition() {
@@ -213,6 +345,10 @@ RowVectorPtr TopNRowNumber::getOutput() {
     return nullptr;
   }
 
+  if (spillMerge_ != nullptr) {
+    return getOutputFromSpill();
+  }
+
   // Loop over partitions and emit sorted rows along with row numbers.
   auto output =
       BaseVector::create<RowVector>(outputType_, outputBatchSize_, pool());
@@ -266,15 +402,130 @@ RowVectorPtr TopNRowNumber::getOutput() {
   }
   output->resize(offset);
 
-  for (int i = 0; i < inputType_->size(); ++i) {
-    data_->extractColumn(outputRows_.data(), offset, i, output->childAt(i));
+  for (const auto& columnProjection : columnMap_) {
+    data_->extractColumn(
+        outputRows_.data(),
+        offset,
+        columnProjection.inputChannel,
+        output->childAt(columnProjection.outputChannel));
+  }
+
+  return output;
+}
+
+RowVectorPtr TopNRowNumber::getOutputFromSpill() {
+  auto output =
+      BaseVector::create<RowVector>(outputType_, outputBatchSize_, pool());
+  FlatVector<int64_t>* rowNumbers = nullptr;
+  if (generateRowNumber_) {
+    rowNumbers = output->children().back()->as<FlatVector<int64_t>>();
+    rowNumbers->resize(outputBatchSize_);
+  }
+
+  // The merged rows are sorted by the partitioning keys followed by the
+  // sorting keys. Only the first 'limit_' rows of each partition are returned.
+  vector_size_t outputRow = 0;
+  vector_size_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < outputBatchSize_) {
+    auto* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      break;
+    }
+
+    const auto& source = stream->current();
+    const auto index = stream->currentIndex(&isEndOfBatch);
+    if (isNewSpillPartition(source, index)) {
+      numSpillRowsInPartition_ = 0;
+    }
+    if (numSpillRowsInPartition_ < limit_) {
+      ++numSpillRowsInPartition_;
+      if (rowNumbers) {
+        rowNumbers->set(outputRow + outputSize, numSpillRowsInPartition_);
+      }
+      spillSources_[outputSize] = &source;
+      spillSourceRows_[outputSize] = index;
+      ++outputSize;
+    }
+
+    // Copy the pending rows before the stream moves to its next batch.
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      gatherCopy(
+          output.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+    stream->pop();
+  }
+
+  if (outputSize != 0) {
+    gatherCopy(
+        output.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+    outputRow += outputSize;
+  }
+
+  if (outputRow == 0) {
+    finished_ = true;
+    spillMerge_.reset();
+    return nullptr;
   }
 
+  if (rowNumbers) {
+    rowNumbers->resize(outputRow);
+  }
+  output->resize(outputRow);
   return output;
 }
 
+bool TopNRowNumber::isNewSpillPartition(
+    const RowVector& source,
+    vector_size_t index) {
+  if (spillPreviousRow_ == nullptr) {
+    spillPreviousRow_ =
+        BaseVector::create<RowVector>(internalStoreType_, 1, pool());
+  } else {
+    bool samePartition = true;
+    for (auto i = 0; i < numPartitionKeyColumns_; ++i) {
+      if (!source.childAt(i)->equalValueAt(
+              spillPreviousRow_->childAt(i).get(), index, 0)) {
+        samePartition = false;
+        break;
+      }
+    }
+    if (samePartition) {
+      return false;
+    }
+  }
+
+  for (auto i = 0; i < numPartitionKeyColumns_; ++i) {
+    spillPreviousRow_->childAt(i)->copy(source.childAt(i).get(), 0, index, 1);
+  }
+  return true;
+}
+
 bool TopNRowNumber::isFinished() {
   return finished_;
 }
 
+void TopNRowNumber::close() {
+  Operator::close();
+
+  spillMerge_.reset();
+  spiller_.reset();
+  table_.reset();
+  singlePartition_.reset();
+  data_.reset();
+  allocator_.reset();
+}
+
 } // namespace facebook::velox::exec
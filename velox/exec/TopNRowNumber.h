@@ -17,6 +17,7 @@
 
 #include "velox/exec/HashTable.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
@@ -34,6 +35,12 @@ namespace facebook::velox::exec {
 ///
 /// This is an optimized version of a Window operator with a single row_number
 /// window function followed by a row_number <= N filter.
+///
+/// If spilling is enabled, the rows kept so far are spilled to disk sorted by
+/// the partitioning and sorting keys once memory needs to be reclaimed, and
+/// the following inputs start new partitions. After all the inputs are
+/// received, the spilled runs are merged and up to 'limit' rows are returned
+/// for each partition.
 class TopNRowNumber : public Operator {
  public:
   TopNRowNumber(
@@ -57,6 +64,10 @@ class TopNRowNumber : public Operator {
 
   bool isFinished() override;
 
+  void reclaim(uint64_t targetBytes) override;
+
+  void close() override;
+
  private:
   /// A priority queue to keep track of top 'limit' rows for a given partition.
   struct TopRows {
@@ -103,6 +114,21 @@ class TopNRowNumber : public Operator {
       vector_size_t outputOffset,
       FlatVector<int64_t>* rowNumbers);
 
+  /// Spills all the rows kept so far and clears the partitions.
+  void spill();
+
+  /// Invoked to record the spilling stats in operator stats after processing
+  /// all the inputs.
+  void recordSpillStats();
+
+  /// Returns the next output batch from the merged spilled runs or nullptr if
+  /// there are no rows left.
+  RowVectorPtr getOutputFromSpill();
+
+  /// Returns true if the row at 'index' in 'source' read from the merged
+  /// spilled runs starts a new partition.
+  bool isNewSpillPartition(const RowVector& source, vector_size_t index);
+
   const int32_t limit_;
   const bool generateRowNumber_;
   const RowTypePtr inputType_;
@@ -119,10 +145,25 @@ class TopNRowNumber : public Operator {
   std::unique_ptr<HashStringAllocator> allocator_;
   std::unique_ptr<TopRows> singlePartition_;
 
+  /// Maps input channels to the columns of 'data_'. The partitioning keys are
+  /// stored first followed by the sorting keys so that the spilled rows are
+  /// sorted by them.
+  std::vector<IdentityProjection> columnMap_;
+
+  /// The row type of 'data_'.
+  RowTypePtr internalStoreType_;
+
+  /// The number of columns of 'data_' storing the partitioning keys.
+  column_index_t numPartitionKeyColumns_{0};
+
+  /// The compare flags of the key columns of 'data_' used to sort the spilled
+  /// rows.
+  std::vector<CompareFlags> keyCompareFlags_;
+
   /// Stores row data. For each partition, only up to 'limit' rows are stored.
   std::unique_ptr<RowContainer> data_;
 
-  RowComparator comparator_;
+  std::unique_ptr<RowComparator> comparator_;
 
   std::vector<DecodedVector> decodedVectors_;
 
@@ -141,5 +182,23 @@ class TopNRowNumber : public Operator {
   size_t numPartitions_{0};
   std::optional<int32_t> currentPartition_;
   vector_size_t remainingRowsInPartition_{0};
+
+  std::unique_ptr<Spiller> spiller_;
+
+  /// Counts input batches and triggers spilling if folly hash of this % 100 <=
+  /// 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  /// Merges the spilled runs after all the inputs are received.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  /// The sources of the rows of the output batch read from 'spillMerge_'.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+
+  /// The partitioning keys of the last row read from 'spillMerge_' and the
+  /// number of rows of its partition read so far.
+  RowVectorPtr spillPreviousRow_;
+  int64_t numSpillRowsInPartition_{0};
 };
 } // namespace facebook::velox::exec
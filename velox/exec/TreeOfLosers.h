@@ -16,6 +16,7 @@
 #pragma once
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -53,14 +54,46 @@ class MergeStream {
   virtual int32_t compare(const MergeStream& /*other*/) const {
     VELOX_UNSUPPORTED();
   }
+
+  // True if keyPrefix() is supported. Called only when hasData() is true.
+  virtual bool hasKeyPrefix() const {
+    return false;
+  }
+
+  // Returns a fixed width prefix of the first element of 'this'. If the
+  // prefixes of two streams differ, their first elements are in the order of
+  // the prefixes. If the prefixes are equal, the order is decided by
+  // compare() or <. hasData() must be true.
+  virtual uint64_t keyPrefix() const {
+    return 0;
+  }
 };
 
+// Returns the key prefix, see MergeStream::keyPrefix(), of an integer key
+// 'value', which is null if 'isNull'. The prefix is 0 for a null first, the
+// max for a null last and the order preserving bits of 'value' shifted right
+// by one plus one otherwise, so that adjacent values may share a prefix.
+inline uint64_t
+integerKeyPrefix(int64_t value, bool isNull, bool ascending, bool nullsFirst) {
+  if (isNull) {
+    return nullsFirst ? 0 : std::numeric_limits<uint64_t>::max();
+  }
+  auto bits = static_cast<uint64_t>(value) ^ (1ULL << 63);
+  if (!ascending) {
+    bits = ~bits;
+  }
+  return (bits >> 1) + 1;
+}
+
 // Implements a tree of losers algorithm for merging ordered
 // streams. The TreeOfLosers owns one or more instances of
 // Stream. At each call of next(), it returns the Stream that has
 // the lowest value as first value from the set of Streams. It
 // returns nullptr when all Streams are at end. The order is
-// determined by Stream::operator<.
+// determined by Stream::operator<. If all the streams support key prefixes,
+// the prefix of the first element of each stream is kept in the tree and the
+// streams are compared by prefix, falling back to Stream::operator< or
+// Stream::compare() only on equal prefixes.
 template <typename Stream, typename TIndex = uint16_t>
 class TreeOfLosers {
  public:
@@ -111,15 +144,39 @@ class TreeOfLosers {
         // Only one stream. We handle this off the common path.
         return streams_[0]->hasData() ? streams_[0].get() : nullptr;
       }
+      initializePrefixes();
       lastIndex_ = first(0);
     } else {
       lastIndex_ = propagate(
-          parent(firstStream_ + lastIndex_),
-          streams_[lastIndex_]->hasData() ? lastIndex_ : kEmpty);
+          parent(firstStream_ + lastIndex_), updatePrefix(lastIndex_));
     }
     return lastIndex_ == kEmpty ? nullptr : streams_[lastIndex_].get();
   }
 
+  // Returns the stream with the lowest first element other than the
+  // stream returned by the last call to next() or nullptr if no other
+  // stream has data. These are the losers stored on the path from the
+  // last returned stream to the root. The caller may take consecutive
+  // elements from the last returned stream while these are not greater
+  // than the first element of the returned stream.
+  Stream* runnerUp() const {
+    if (lastIndex_ == kEmpty || values_.empty()) {
+      return nullptr;
+    }
+    TIndex best = kEmpty;
+    for (TIndex node = parent(firstStream_ + lastIndex_);;
+         node = parent(node)) {
+      const auto value = values_[node];
+      if (value != kEmpty && (best == kEmpty || less(value, best))) {
+        best = value;
+      }
+      if (node == 0) {
+        break;
+      }
+    }
+    return best == kEmpty ? nullptr : streams_[best].get();
+  }
+
   // Returns the stream with the lowest first element and a flag that
   // is true if there is another equal value to come from some other
   // stream. The streams should have ordered unique values when using
@@ -135,11 +192,11 @@ class TreeOfLosers {
         return streams_[0]->hasData() ? std::make_pair(streams_[0].get(), false)
                                       : std::make_pair(nullptr, false);
       }
+      initializePrefixes();
       result = firstWithEquals(0);
     } else {
       result = propagateWithEquals(
-          parent(firstStream_ + lastIndex_),
-          streams_[lastIndex_]->hasData() ? lastIndex_ : kEmpty);
+          parent(firstStream_ + lastIndex_), updatePrefix(lastIndex_));
     }
     lastIndex_ = result.first;
 
@@ -155,6 +212,48 @@ class TreeOfLosers {
     return std::pair<TIndex, bool>{index, flag};
   }
 
+  // Keeps the key prefixes of the streams if all the streams with data
+  // support these.
+  void initializePrefixes() {
+    for (const auto& stream : streams_) {
+      if (stream->hasData() && !stream->hasKeyPrefix()) {
+        return;
+      }
+    }
+    prefixes_.resize(streams_.size());
+    for (auto i = 0; i < streams_.size(); ++i) {
+      if (streams_[i]->hasData()) {
+        prefixes_[i] = streams_[i]->keyPrefix();
+      }
+    }
+  }
+
+  // Updates the prefix of the stream at 'index' after its first element was
+  // popped off. Returns 'index' or kEmpty if the stream is at end.
+  FOLLY_ALWAYS_INLINE TIndex updatePrefix(TIndex index) {
+    if (!streams_[index]->hasData()) {
+      return kEmpty;
+    }
+    if (!prefixes_.empty()) {
+      prefixes_[index] = streams_[index]->keyPrefix();
+    }
+    return index;
+  }
+
+  FOLLY_ALWAYS_INLINE bool less(TIndex left, TIndex right) const {
+    if (!prefixes_.empty() && prefixes_[left] != prefixes_[right]) {
+      return prefixes_[left] < prefixes_[right];
+    }
+    return *streams_[left] < *streams_[right];
+  }
+
+  FOLLY_ALWAYS_INLINE int32_t compare(TIndex left, TIndex right) const {
+    if (!prefixes_.empty() && prefixes_[left] != prefixes_[right]) {
+      return prefixes_[left] < prefixes_[right] ? -1 : 1;
+    }
+    return streams_[left]->compare(*streams_[right]);
+  }
+
   TIndex first(TIndex node) {
     if (node >= firstStream_) {
       return streams_[node - firstStream_]->hasData() ? node - firstStream_
@@ -166,7 +265,7 @@ class TreeOfLosers {
       return right;
     } else if (right == kEmpty) {
       return left;
-    } else if (*streams_[left] < *streams_[right]) {
+    } else if (less(left, right)) {
       values_[node] = right;
       return left;
     } else {
@@ -188,7 +287,7 @@ class TreeOfLosers {
       } else if (UNLIKELY(value == kEmpty)) {
         value = values_[node];
         values_[node] = kEmpty;
-      } else if (*streams_[values_[node]] < *streams_[value]) {
+      } else if (less(values_[node], value)) {
         // The node had the lower value, the value stays here and the previous
         // value goes up.
         std::swap(value, values_[node]);
@@ -219,7 +318,7 @@ class TreeOfLosers {
     } else if (right.first == kEmpty) {
       return left;
     } else {
-      auto comparison = streams_[left.first]->compare(*streams_[right.first]);
+      auto comparison = compare(left.first, right.first);
       if (comparison == 0) {
         values_[node] = right.first;
         equals_[node] = right.second;
@@ -253,8 +352,7 @@ class TreeOfLosers {
         values_[node] = kEmpty;
         equals_[node] = false;
       } else {
-        auto comparison =
-            streams_[values_[node]]->compare(*streams_[value.first]);
+        auto comparison = compare(values_[node], value.first);
         if (comparison == 0) {
           // the value goes up with equals set.
           value.second = true;
@@ -296,6 +394,9 @@ class TreeOfLosers {
   // A byte vector is in this case faster than one of bool.
   std::vector<uint8_t> equals_;
   std::vector<std::unique_ptr<Stream>> streams_;
+  // The key prefixes of the first elements of 'streams_'. Empty unless all
+  // the streams support key prefixes.
+  std::vector<uint64_t> prefixes_;
   TIndex lastIndex_ = kEmpty;
   int32_t firstStream_;
 };
@@ -131,9 +131,211 @@ RowVectorPtr Unnest::getOutput() {
   auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
   vector_size_t index = 0;
   for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
-      rawRepeatedIndices[index++] = row;
+    std::fill_n(rawRepeatedIndices + index, rawMaxSizes[row], row);
+    index += rawMaxSizes[row];
+  }
+
+  // Wrap "replicated" columns in a dictionary using 'repeatedIndices'.
+  std::vector<VectorPtr> outputs(outputType_->size());
+  for (const auto& projection : identityProjections_) {
+    outputs[projection.outputChannel] = wrapChild(
+        numElements, repeatedIndices, input_->childAt(projection.inputChannel));
+  }
+
+  // Create unnest columns.
+  vector_size_t outputsIndex = identityProjections_.size();
+  for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
+    auto& currentDecoded = unnestDecoded_[channel];
+    auto currentSizes = rawSizes[channel];
+    auto currentOffsets = rawOffsets[channel];
+    auto currentIndices = rawIndices[channel];
+
+    // The elements of consecutive rows are usually adjacent in the base
+    // vector. The unnest column is then a range of the elements and needs no
+    // indices.
+    vector_size_t firstOffset = -1;
+    vector_size_t nextOffset = 0;
+    bool contiguous = true;
+    for (auto row = 0; row < size && contiguous; ++row) {
+      auto maxSize = rawMaxSizes[row];
+      if (maxSize == 0) {
+        continue;
+      }
+      if (currentDecoded.isNullAt(row)) {
+        contiguous = false;
+        break;
+      }
+      auto offset = currentOffsets[currentIndices[row]];
+      if (firstOffset < 0) {
+        firstOffset = offset;
+        nextOffset = offset;
+      }
+      contiguous = offset == nextOffset &&
+          currentSizes[currentIndices[row]] == maxSize;
+      nextOffset += maxSize;
+    }
+
+    BufferPtr elementIndices;
+    BufferPtr nulls;
+    if (!contiguous) {
+      elementIndices = allocateIndices(numElements, pool());
+      auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
+      uint64_t* rawNulls = nullptr;
+      auto setNulls = [&](vector_size_t begin, vector_size_t end) {
+        if (!rawNulls) {
+          nulls = AlignedBuffer::allocate<bool>(
+              numElements, pool(), bits::kNotNull);
+          rawNulls = nulls->asMutable<uint64_t>();
+        }
+        bits::fillBits(rawNulls, begin, end, bits::kNull);
+      };
+
+      // Make dictionary index for elements column since they may be out of
+      // order.
+      index = 0;
+      for (auto row = 0; row < size; ++row) {
+        auto maxSize = rawMaxSizes[row];
+        if (maxSize == 0) {
+          continue;
+        }
+
+        vector_size_t unnestSize = 0;
+        if (!currentDecoded.isNullAt(row)) {
+          auto offset = currentOffsets[currentIndices[row]];
+          unnestSize = currentSizes[currentIndices[row]];
+          std::iota(
+              rawElementIndices + index,
+              rawElementIndices + index + unnestSize,
+              offset);
+        }
+        if (unnestSize < maxSize) {
+          setNulls(index + unnestSize, index + maxSize);
+        }
+        index += maxSize;
+      }
+    }
+
+    // Returns the unnest column for 'elements', the elements, keys or values
+    // of the base vector.
+    auto unnestElements = [&](const VectorPtr& elements) -> VectorPtr {
+      if (!contiguous) {
+        return wrapChild(numElements, elementIndices, elements, nulls);
+      }
+      if (firstOffset == 0) {
+        return elements;
+      }
+      if (elements->encoding() == VectorEncoding::Simple::FLAT) {
+        return elements->slice(firstOffset, numElements);
+      }
+      auto indices = allocateIndices(numElements, pool());
+      auto* rawIndices = indices->asMutable<vector_size_t>();
+      std::iota(rawIndices, rawIndices + numElements, firstOffset);
+      return wrapChild(numElements, indices, elements);
+    };
+
+    if (currentDecoded.base()->typeKind() == TypeKind::ARRAY) {
+      // Construct unnest column using Array elements.
+      auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
+      outputs[outputsIndex++] = unnestElements(unnestBaseArray->elements());
+    } else {
+      // Construct two unnest columns for Map keys and values vectors.
+      auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
+      outputs[outputsIndex++] = unnestElements(unnestBaseMap->mapKeys());
+      outputs[outputsIndex++] = unnestElements(unnestBaseMap->mapValues());
+    }
+  }
+
+  if (withOrdinality_) {
+    VELOX_CHECK_EQ(
+        outputType_->children().back(),
+        BIGINT(),
+        "Ordinality column should be BIGINT type.")
+  }
+
+  column_index_t outputChannel = 0;
+  for (const auto& variable : unnestNode->replicateVariables()) {
+    identityProjections_.emplace_back(
+        inputType->getChildIdx(variable->name()), outputChannel++);
+  }
+}
+
+void Unnest::addInput(RowVectorPtr input) {
+  input_ = std::move(input);
+}
+
+RowVectorPtr Unnest::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  auto size = input_->size();
+  inputRows_.resize(size);
+
+  // The max number of elements at each row across all unnested columns.
+  auto maxSizes = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
+  auto rawMaxSizes = maxSizes->asMutable<int64_t>();
+
+  std::vector<const vector_size_t*> rawSizes;
+  std::vector<const vector_size_t*> rawOffsets;
+  std::vector<const vector_size_t*> rawIndices;
+
+  rawSizes.resize(unnestChannels_.size());
+  rawOffsets.resize(unnestChannels_.size());
+  rawIndices.resize(unnestChannels_.size());
+
+  for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
+    const auto& unnestVector = input_->childAt(unnestChannels_[channel]);
+    unnestDecoded_[channel].decode(*unnestVector, inputRows_);
+
+    auto& currentDecoded = unnestDecoded_[channel];
+    rawIndices[channel] = currentDecoded.indices();
+
+    const ArrayVector* unnestBaseArray;
+    const MapVector* unnestBaseMap;
+    if (unnestVector->typeKind() == TypeKind::ARRAY) {
+      unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
+      rawSizes[channel] = unnestBaseArray->rawSizes();
+      rawOffsets[channel] = unnestBaseArray->rawOffsets();
+    } else {
+      VELOX_CHECK(unnestVector->typeKind() == TypeKind::MAP);
+      unnestBaseMap = currentDecoded.base()->as<MapVector>();
+      rawSizes[channel] = unnestBaseMap->rawSizes();
+      rawOffsets[channel] = unnestBaseMap->rawOffsets();
     }
+
+    // Count max number of elements per row.
+    auto currentSizes = rawSizes[channel];
+    auto currentIndices = rawIndices[channel];
+    for (auto row = 0; row < size; ++row) {
+      if (!currentDecoded.isNullAt(row)) {
+        auto unnestSize = currentSizes[currentIndices[row]];
+        if (rawMaxSizes[row] < unnestSize) {
+          rawMaxSizes[row] = unnestSize;
+        }
+      }
+    }
+  }
+
+  // Calculate the number of rows in the unnest result.
+  int numElements = 0;
+  for (auto row = 0; row < size; ++row) {
+    numElements += rawMaxSizes[row];
+  }
+
+  if (numElements == 0) {
+    // All arrays/maps are null or empty.
+    input_ = nullptr;
+    return nullptr;
+  }
+
+  // Create "indices" buffer to repeat rows as many times as there are elements
+  // in the array (or map) in unnestDecoded.
+  auto repeatedIndices = allocateIndices(numElements, pool());
+  auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
+  vector_size_t index = 0;
+  for (auto row = 0; row < size; ++row) {
+    std::fill_n(rawRepeatedIndices + index, rawMaxSizes[row], row);
+    index += rawMaxSizes[row];
   }
 
   // Wrap "replicated" columns in a dictionary using 'repeatedIndices'.
@@ -19,6 +19,7 @@
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/memory/HashStringAllocator.h"
+#include "velox/vector/LazyVector.h"
 
 namespace facebook::velox::exec {
 
@@ -90,8 +91,12 @@ void VectorHasher::hashValues(
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
   } else {
-    cachedHashes_.resize(decoded_.base()->size());
-    std::fill(cachedHashes_.begin(), cachedHashes_.end(), kNullHash);
+    const auto* base = decoded_.base();
+    if (cachedHashesBase_ != base || dictionaryBase_.get() != base) {
+      cachedHashes_.resize(base->size());
+      std::fill(cachedHashes_.begin(), cachedHashes_.end(), kNullHash);
+      cachedHashesBase_ = base;
+    }
     rows.applyToSelected([&](vector_size_t row) {
       if (decoded_.isNullAt(row)) {
         result[row] = mix ? bits::hashMix(result[row], kNullHash) : kNullHash;
@@ -243,8 +248,12 @@ template <typename T, bool mayHaveNulls>
 bool VectorHasher::makeValueIdsDecoded(
     const SelectivityVector& rows,
     uint64_t* result) {
-  cachedHashes_.resize(decoded_.base()->size());
-  std::fill(cachedHashes_.begin(), cachedHashes_.end(), 0);
+  const auto* base = decoded_.base();
+  if (cachedValueIdsBase_ != base || dictionaryBase_.get() != base) {
+    cachedValueIds_.resize(base->size());
+    std::fill(cachedValueIds_.begin(), cachedValueIds_.end(), 0);
+    cachedValueIdsBase_ = base;
+  }
 
   auto indices = decoded_.indices();
   auto values = decoded_.data<T>();
@@ -260,7 +269,7 @@ bool VectorHasher::makeValueIdsDecoded(
       }
     }
     auto baseIndex = indices[row];
-    uint64_t id = cachedHashes_[baseIndex];
+    uint64_t id = cachedValueIds_[baseIndex];
     if (id == 0) {
       T value = values[baseIndex];
 
@@ -276,7 +285,7 @@ bool VectorHasher::makeValueIdsDecoded(
         success = false;
         return;
       }
-      cachedHashes_[baseIndex] = id;
+      cachedValueIds_[baseIndex] = id;
     }
     result[row] = multiplier_ == 1 ? id : result[row] + multiplier_ * id;
   });
@@ -320,6 +329,30 @@ bool VectorHasher::makeValueIdsDecoded<bool, false>(
   return true;
 }
 
+void VectorHasher::retainDictionaryBase(
+    const BaseVector& vector,
+    const SelectivityVector& rows) {
+  if (dictionaryBase_.get() == decoded_.base()) {
+    return;
+  }
+  dictionaryBase_ = nullptr;
+  if (decoded_.base()->size() > rows.end()) {
+    return;
+  }
+  VectorPtr base;
+  const BaseVector* wrapped = &vector;
+  while (wrapped->encoding() == VectorEncoding::Simple::DICTIONARY ||
+         wrapped->isLazy()) {
+    base = wrapped->isLazy()
+        ? wrapped->asUnchecked<LazyVector>()->loadedVectorShared()
+        : wrapped->valueVector();
+    wrapped = base.get();
+  }
+  if (wrapped == decoded_.base()) {
+    dictionaryBase_ = std::move(base);
+  }
+}
+
 bool VectorHasher::computeValueIds(
     const SelectivityVector& rows,
     raw_vector<uint64_t>& result) {
@@ -749,6 +782,7 @@ void VectorHasher::cardinality(
 }
 
 uint64_t VectorHasher::enableValueIds(uint64_t multiplier, int32_t reservePct) {
+  cachedValueIdsBase_ = nullptr;
   VELOX_CHECK_NE(
       typeKind_,
       TypeKind::BOOLEAN,
@@ -767,6 +801,7 @@ uint64_t VectorHasher::enableValueRange(
     uint64_t multiplier,
     int32_t reservePct) {
   multiplier_ = multiplier;
+  cachedValueIdsBase_ = nullptr;
   VELOX_CHECK_LE(0, reservePct);
   VELOX_CHECK(hasRange_);
   extendRange(type_->kind(), reservePct, min_, max_);
@@ -785,6 +820,7 @@ uint64_t VectorHasher::enableValueRange(
 }
 
 void VectorHasher::copyStatsFrom(const VectorHasher& other) {
+  cachedValueIdsBase_ = nullptr;
   hasRange_ = other.hasRange_;
   rangeOverflow_ = other.rangeOverflow_;
   distinctOverflow_ = other.distinctOverflow_;
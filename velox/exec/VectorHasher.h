@@ -178,6 +178,9 @@ class VectorHasher {
         type_->toString(),
         vector.type()->toString());
     decoded_.decode(vector, rows);
+    if (!decoded_.isIdentityMapping() && !decoded_.isConstantMapping()) {
+      retainDictionaryBase(vector, rows);
+    }
   }
 
   DecodedVector& decodedVector() {
@@ -252,9 +255,25 @@ class VectorHasher {
   // Returns null if distinctOverflow_ is true.
   std::unique_ptr<common::Filter> getFilter(bool nullAllowed) const;
 
+  // Sets an approximate filter over the values of this key. Used by hash join
+  // builds whose keys are not covered by getFilter().
+  void setBloomFilter(std::unique_ptr<common::Filter> bloomFilter) {
+    bloomFilter_ = std::move(bloomFilter);
+  }
+
+  // Returns the filter set by setBloomFilter() or nullptr.
+  const common::Filter* bloomFilter() const {
+    return bloomFilter_.get();
+  }
+
+  bool distinctOverflow() const {
+    return distinctOverflow_;
+  }
+
   void resetStats() {
     uniqueValues_.clear();
     uniqueValuesStorage_.clear();
+    cachedValueIdsBase_ = nullptr;
   }
 
   // Sets 'this' to range mode and adds 'reservePct' values to the
@@ -337,6 +356,13 @@ class VectorHasher {
     return value;
   }
 
+  // Keeps a reference to the base of dictionary encoded 'vector' so that the
+  // hashes and value ids of its values are kept for the following batches
+  // over the same base. Only bases with no more values than 'rows' are kept.
+  void retainDictionaryBase(
+      const BaseVector& vector,
+      const SelectivityVector& rows);
+
   // Sets the data statistics from 'other'. Does not set the mapping mode.
   void copyStatsFrom(const VectorHasher& other);
 
@@ -541,7 +567,21 @@ class VectorHasher {
   const TypeKind typeKind_;
 
   DecodedVector decoded_;
+
+  // Base of the last dictionary encoded input. Holding a reference keeps the
+  // base from being reused for different values while its hashes and value
+  // ids are cached below, e.g. for a stripe dictionary shared by the batches
+  // of a table scan.
+  VectorPtr dictionaryBase_;
+
+  // Hashes and value ids of the values of the base vector at
+  // 'cachedHashesBase_' and 'cachedValueIdsBase_'. kNullHash and 0 for
+  // values not computed yet. The caches are kept across batches only when
+  // the base is 'dictionaryBase_'.
   raw_vector<uint64_t> cachedHashes_;
+  const BaseVector* cachedHashesBase_{nullptr};
+  raw_vector<uint64_t> cachedValueIds_;
+  const BaseVector* cachedValueIdsBase_{nullptr};
 
   // Single precomputed hash for constant partition keys.
   uint64_t precomputedHash_{0};
@@ -575,6 +615,10 @@ class VectorHasher {
   // Memory for unique string values.
   std::vector<std::string> uniqueValuesStorage_;
   uint64_t distinctStringsBytes_ = 0;
+
+  // Approximate filter over the values of a join build key. See
+  // setBloomFilter().
+  std::unique_ptr<common::Filter> bloomFilter_;
 };
 
 template <>
@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 #include "velox/exec/Window.h"
+#include <folly/container/F14Map.h>
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -51,13 +53,16 @@ Window::Window(
           windowNode->outputType(),
           operatorId,
           windowNode->id(),
-          "Window"),
+          "Window",
+          windowNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      data_(std::make_unique<RowContainer>(
-          windowNode->sources()[0]->outputType()->children(),
-          pool())),
       decodedInputVectors_(numInputColumns_),
-      stringAllocator_(pool()) {
+      stringAllocator_(pool()),
+      spillMemoryThreshold_(
+          driverCtx->queryConfig().windowSpillMemoryThreshold()),
+      inputsSorted_(windowNode->inputsSorted()) {
   auto inputType = windowNode->sources()[0]->outputType();
   initKeyInfo(inputType, windowNode->partitionKeys(), {}, partitionKeyInfo_);
   initKeyInfo(
@@ -65,15 +70,45 @@ Window::Window(
       windowNode->sortingKeys(),
       windowNode->sortingOrders(),
       sortKeyInfo_);
-  allKeyInfo_.reserve(partitionKeyInfo_.size() + sortKeyInfo_.size());
-  allKeyInfo_.insert(
-      allKeyInfo_.cend(), partitionKeyInfo_.begin(), partitionKeyInfo_.end());
-  allKeyInfo_.insert(
-      allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
+
+  // Store the partition keys followed by the order by keys as the key
+  // columns of 'data_' so that the Spiller sorts the spilled rows by them.
+  // A key that appears more than once is stored once.
+  std::vector<column_index_t> channelColumns(
+      numInputColumns_, kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  auto addColumn = [&](column_index_t channel) {
+    channelColumns[channel] = columnMap_.size();
+    columnMap_.emplace_back(columnMap_.size(), channel);
+    types.push_back(inputType->childAt(channel));
+    names.push_back(inputType->nameOf(channel));
+  };
+  for (auto* keyInfo : {&partitionKeyInfo_, &sortKeyInfo_}) {
+    for (auto& [channel, sortOrder] : *keyInfo) {
+      if (channelColumns[channel] == kConstantChannel) {
+        addColumn(channel);
+        keyTypes.push_back(types.back());
+        keyCompareFlags_.push_back(
+            {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+      }
+      channel = channelColumns[channel];
+    }
+  }
+  for (column_index_t channel = 0; channel < numInputColumns_; ++channel) {
+    if (channelColumns[channel] == kConstantChannel) {
+      addColumn(channel);
+      dependentTypes.push_back(types.back());
+    }
+  }
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  internalStoreType_ = ROW(std::move(names), std::move(types));
 
   std::vector<exec::RowColumn> inputColumns;
   for (int i = 0; i < inputType->children().size(); i++) {
-    inputColumns.push_back(data_->columnAt(i));
+    inputColumns.push_back(data_->columnAt(channelColumns[i]));
   }
   // The WindowPartition is structured over all the input columns data.
   // Individual functions access its input argument column values from it.
@@ -152,6 +187,12 @@ void Window::createWindowFunctions(
 }
 
 void Window::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
+  // Prevents the memory arbitrator to reclaim memory from this operator during
+  // the execution below.
+  NonReclaimableSection guard(this);
+
   for (auto col = 0; col < input->childrenSize(); ++col) {
     decodedInputVectors_[col].decode(*input->childAt(col));
   }
@@ -160,11 +201,214 @@ void Window::addInput(RowVectorPtr input) {
   for (auto row = 0; row < input->size(); ++row) {
     char* newRow = data_->newRow();
 
-    for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedInputVectors_[col], row, newRow, col);
+    for (const auto& columnProjection : columnMap_) {
+      data_->store(
+          decodedInputVectors_[columnProjection.outputChannel],
+          row,
+          newRow,
+          columnProjection.inputChannel);
+    }
+    if (inputsSorted_) {
+      inputRows_.push_back(newRow);
+    }
+  }
+
+  if (!inputsSorted_) {
+    numRows_ += input->size();
+    return;
+  }
+
+  // The rows before the start of the last partition make up complete
+  // partitions that can be output right away.
+  const vector_size_t firstNewRow = inputRows_.size() - input->size();
+  for (auto i = std::max<vector_size_t>(firstNewRow, 1); i < inputRows_.size();
+       ++i) {
+    if (!samePartition(inputRows_[i - 1], inputRows_[i])) {
+      lastPartitionStart_ = i;
+    }
+  }
+  startStreamingOutput(lastPartitionStart_);
+}
+
+void Window::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  const auto currentUsage = pool()->currentBytes();
+  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (pool()->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (pool()->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void Window::reclaim(uint64_t targetBytes) {
+  VELOX_CHECK(canReclaim());
+
+  // NOTE: a window operator is reclaimable if it hasn't started output
+  // processing and is not under non-reclaimable execution section.
+  if (noMoreInput_ || nonReclaimableSection_) {
+    LOG(WARNING) << "Can't reclaim from window operator, noMoreInput_["
+                 << noMoreInput_ << "], nonReclaimableSection_["
+                 << nonReclaimableSection_ << "], " << toString();
+    return;
+  }
+
+  spill(0, targetBytes);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  data_->clear();
+  // Release the minimum reserved memory.
+  pool()->release();
+}
+
+void Window::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kWindow,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        keyCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.readAheadDepth);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void Window::recordSpillStats() {
+  VELOX_CHECK_NOT_NULL(spiller_);
+  VELOX_CHECK(noMoreInput_);
+
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledInputBytes = spillStats.spilledInputBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
+}
+
+void Window::readSpilledPartitions() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  VELOX_CHECK(sortedRows_.empty());
+  VELOX_CHECK_EQ(lastPartitionStart_, 0);
+
+  const auto numColumns = internalStoreType_->size();
+  for (;;) {
+    auto* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      // The partition of the last row is complete now.
+      lastPartitionStart_ = inputRows_.size();
+      spillMerge_.reset();
+      break;
+    }
+
+    char* newRow = data_->newRow();
+    const auto index = stream->currentIndex();
+    for (auto column = 0; column < numColumns; ++column) {
+      data_->store(stream->decoded(column), index, newRow, column);
+    }
+    stream->pop();
+    inputRows_.push_back(newRow);
+
+    const vector_size_t numInputRows = inputRows_.size();
+    if (numInputRows > 1 &&
+        !samePartition(inputRows_[numInputRows - 2], newRow)) {
+      lastPartitionStart_ = numInputRows - 1;
+      if (lastPartitionStart_ >= numRowsPerOutput_) {
+        break;
+      }
+    }
+  }
+  startStreamingOutput(lastPartitionStart_);
+  finished_ = sortedRows_.empty();
+}
+
+bool Window::samePartition(const char* lhs, const char* rhs) {
+  for (const auto& key : partitionKeyInfo_) {
+    if (data_->compare(lhs, rhs, key.first)) {
+      return false;
     }
   }
-  numRows_ += input->size();
+  return true;
 }
 
 inline bool Window::compareRowsWithKeys(
@@ -213,54 +457,168 @@ void Window::createPeerAndFrameBuffers() {
 }
 
 void Window::computePartitionStartRows() {
-  // Randomly assuming that max 10000 partitions are in the data.
-  partitionStartRows_.reserve(numRows_);
-  auto partitionCompare = [&](const char* lhs, const char* rhs) -> bool {
-    return compareRowsWithKeys(lhs, rhs, partitionKeyInfo_);
-  };
-
-  // Using a sequential traversal to find changing partitions.
-  // This algorithm is inefficient and can be changed
-  // i) Use a binary search kind of strategy.
-  // ii) If we use a Hashtable instead of a full sort then the count
-  // of rows in the partition can be directly used.
+  partitionStartRows_.clear();
   partitionStartRows_.push_back(0);
-
-  VELOX_CHECK_GT(sortedRows_.size(), 0);
-  for (auto i = 1; i < sortedRows_.size(); i++) {
-    if (partitionCompare(sortedRows_[i - 1], sortedRows_[i])) {
+  for (auto i = 1; i < sortedRows_.size(); ++i) {
+    if (!samePartition(sortedRows_[i - 1], sortedRows_[i])) {
       partitionStartRows_.push_back(i);
     }
   }
-
-  // Setting the startRow of the (last + 1) partition to be returningRows.size()
+  // Setting the startRow of the (last + 1) partition to be sortedRows_.size()
   // to help for last partition related calculations.
   partitionStartRows_.push_back(sortedRows_.size());
 }
 
+void Window::startStreamingOutput(vector_size_t numRows) {
+  VELOX_CHECK(sortedRows_.empty());
+  if (numRows == 0) {
+    return;
+  }
+  sortedRows_.assign(inputRows_.begin(), inputRows_.begin() + numRows);
+  inputRows_.erase(inputRows_.begin(), inputRows_.begin() + numRows);
+  lastPartitionStart_ = 0;
+  numRows_ = numRows;
+  numProcessedRows_ = 0;
+  computePartitionStartRows();
+  currentPartition_ = 0;
+  if (peerStartBuffer_ == nullptr) {
+    createPeerAndFrameBuffers();
+  }
+}
+
+void Window::finishStreamingOutput() {
+  VELOX_CHECK_EQ(numProcessedRows_, numRows_);
+  data_->eraseRows(
+      folly::Range<char**>(sortedRows_.data(), sortedRows_.size()));
+  sortedRows_.clear();
+  numRows_ = 0;
+  numProcessedRows_ = 0;
+  if (noMoreInput_) {
+    if (spillMerge_ != nullptr) {
+      readSpilledPartitions();
+      return;
+    }
+    startStreamingOutput(inputRows_.size());
+    finished_ = sortedRows_.empty();
+  }
+}
+
+void Window::groupPartitions() {
+  partitionStartRows_.clear();
+  if (partitionKeyInfo_.empty()) {
+    partitionStartRows_.push_back(0);
+    partitionStartRows_.push_back(numRows_);
+    return;
+  }
+
+  // Hash the partition keys of all rows and number the partitions in the
+  // order of their first row.
+  std::vector<uint64_t> hashes(numRows_);
+  folly::Range<char**> rows(sortedRows_.data(), numRows_);
+  for (auto i = 0; i < partitionKeyInfo_.size(); ++i) {
+    data_->hash(partitionKeyInfo_[i].first, rows, i > 0, hashes.data());
+  }
+  auto hasher = [&](vector_size_t row) { return hashes[row]; };
+  auto equal = [&](vector_size_t left, vector_size_t right) {
+    return samePartition(sortedRows_[left], sortedRows_[right]);
+  };
+  folly::F14FastMap<
+      vector_size_t,
+      vector_size_t,
+      decltype(hasher),
+      decltype(equal)>
+      partitions(0, hasher, equal);
+  std::vector<vector_size_t> rowPartitions(numRows_);
+  std::vector<vector_size_t> partitionSizes;
+  for (vector_size_t row = 0; row < numRows_; ++row) {
+    auto [it, inserted] = partitions.try_emplace(row, partitionSizes.size());
+    if (inserted) {
+      partitionSizes.push_back(0);
+    }
+    rowPartitions[row] = it->second;
+    ++partitionSizes[it->second];
+  }
+
+  // partitionStartRows_ has the start of each partition followed by
+  // numRows_ to help for last partition related calculations.
+  partitionStartRows_.resize(partitionSizes.size() + 1);
+  partitionStartRows_[0] = 0;
+  for (auto i = 0; i < partitionSizes.size(); ++i) {
+    partitionStartRows_[i + 1] = partitionStartRows_[i] + partitionSizes[i];
+  }
+
+  // Place the rows of each partition next to each other, keeping their input
+  // order.
+  std::vector<vector_size_t> nextRows(
+      partitionStartRows_.begin(), partitionStartRows_.end() - 1);
+  std::vector<char*> groupedRows(numRows_);
+  for (vector_size_t row = 0; row < numRows_; ++row) {
+    groupedRows[nextRows[rowPartitions[row]]++] = sortedRows_[row];
+  }
+  sortedRows_ = std::move(groupedRows);
+}
+
 void Window::sortPartitions() {
-  // This is a very inefficient but easy implementation to order the input rows
-  // by partition keys + sort keys.
   // Sort the pointers to the rows in RowContainer (data_) instead of sorting
   // the rows.
   sortedRows_.resize(numRows_);
   RowContainerIterator iter;
   data_->listRows(&iter, numRows_, sortedRows_.data());
 
-  std::sort(
-      sortedRows_.begin(),
-      sortedRows_.end(),
-      [this](const char* leftRow, const char* rightRow) {
-        return compareRowsWithKeys(leftRow, rightRow, allKeyInfo_);
-      });
+  groupPartitions();
 
-  computePartitionStartRows();
+  if (!sortKeyInfo_.empty()) {
+    std::vector<std::pair<column_index_t, CompareFlags>> sortKeys;
+    sortKeys.reserve(sortKeyInfo_.size());
+    for (const auto& [channel, sortOrder] : sortKeyInfo_) {
+      sortKeys.emplace_back(
+          channel,
+          CompareFlags{
+              sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+    }
+    for (auto i = 0; i < partitionStartRows_.size() - 1; ++i) {
+      const auto start = partitionStartRows_[i];
+      const auto end = partitionStartRows_[i + 1];
+      if (end - start > 1) {
+        PrefixSort::sort(
+            *data_,
+            sortKeys,
+            folly::Range<char**>(
+                sortedRows_.data() + start, sortedRows_.data() + end));
+      }
+    }
+  }
 
   currentPartition_ = 0;
 }
 
 void Window::noMoreInput() {
   Operator::noMoreInput();
+  if (inputsSorted_) {
+    // The last partition is complete now. If partitions are still being
+    // output, finishStreamingOutput() starts output of the remaining rows.
+    if (sortedRows_.empty()) {
+      startStreamingOutput(inputRows_.size());
+      finished_ = sortedRows_.empty();
+    }
+    return;
+  }
+
+  if (spiller_ != nullptr) {
+    // Finish spill, and we shouldn't get any rows from non-spilled partition
+    // as there is only one partition for the window operator.
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    recordSpillStats();
+    spillMerge_ = spiller_->startMerge(0);
+    VELOX_CHECK_NOT_NULL(spillMerge_);
+    // The sort merge produces the rows grouped by partition and sorted by the
+    // order by keys within each partition.
+    createPeerAndFrameBuffers();
+    readSpilledPartitions();
+    return;
+  }
+
   // No data.
   if (numRows_ == 0) {
     finished_ = true;
@@ -579,7 +937,8 @@ void Window::callApplyLoop(
 }
 
 RowVectorPtr Window::getOutput() {
-  if (finished_ || !noMoreInput_) {
+  if (finished_ || (!inputsSorted_ && !noMoreInput_) ||
+      numProcessedRows_ == numRows_) {
     return nullptr;
   }
 
@@ -589,12 +948,12 @@ RowVectorPtr Window::getOutput() {
       BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
 
   // Set all passthrough input columns.
-  for (int i = 0; i < numInputColumns_; ++i) {
+  for (const auto& columnProjection : columnMap_) {
     data_->extractColumn(
         sortedRows_.data() + numProcessedRows_,
         numOutputRows,
-        i,
-        result->childAt(i));
+        columnProjection.inputChannel,
+        result->childAt(columnProjection.outputChannel));
   }
 
   // Construct vectors for the window function output columns.
@@ -613,8 +972,20 @@ RowVectorPtr Window::getOutput() {
     result->childAt(j) = windowOutputs[j - numInputColumns_];
   }
 
-  finished_ = (numProcessedRows_ == sortedRows_.size());
+  if (!isStreaming()) {
+    finished_ = (numProcessedRows_ == sortedRows_.size());
+  } else if (numProcessedRows_ == numRows_) {
+    finishStreamingOutput();
+  }
   return result;
 }
 
+void Window::close() {
+  Operator::close();
+
+  spillMerge_.reset();
+  spiller_.reset();
+  data_.reset();
+}
+
 } // namespace facebook::velox::exec
@@ -17,6 +17,7 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/exec/WindowPartition.h"
 
@@ -25,15 +26,21 @@ namespace facebook::velox::exec {
 /// This is a very simple in-Memory implementation of a Window Operator
 /// to compute window functions.
 ///
-/// This operator uses a very naive algorithm that sorts all the input
-/// data with a combination of the (partition_by keys + order_by keys)
-/// to obtain a full ordering of the input. We can easily identify
-/// partitions while traversing this sorted data in order.
-/// It is also sorted in the order required for the WindowFunction
-/// to process it.
+/// This operator groups the input rows into partitions by hashing the
+/// partition_by keys and then sorts the rows of each partition by the
+/// order_by keys, which is the order required for the WindowFunction to
+/// process it. Partitions are output in the order of their first input row.
 ///
-/// We will revise this algorithm in the future using a HashTable based
-/// approach pending some profiling results.
+/// If the input is already sorted by partition_by keys and order_by keys
+/// (WindowNode::inputsSorted()), the operator streams instead: it outputs the
+/// partitions seen so far as soon as a row of a new partition arrives and
+/// frees their rows afterwards, so only about one partition is held in memory.
+///
+/// If spilling is enabled, the operator spills its rows as sorted runs ordered
+/// by the partition keys followed by the order_by keys. After all the input is
+/// received, the sort merge of the spilled runs produces the partitions one
+/// after the other, each of them sorted. The operator then reads back and
+/// outputs a few complete partitions at a time like in streaming mode.
 class Window : public Operator {
  public:
   Window(
@@ -46,7 +53,9 @@ class Window : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    // In streaming mode, the complete partitions are output before more
+    // input is accepted.
+    return !noMoreInput_ && (!inputsSorted_ || sortedRows_.empty());
   }
 
   void noMoreInput() override;
@@ -59,6 +68,10 @@ class Window : public Operator {
     return finished_;
   }
 
+  void reclaim(uint64_t targetBytes) override;
+
+  void close() override;
+
  private:
   // Used for k preceding/following frames. Index is the column index if k is a
   // column. value is used to read column values from the column index when k
@@ -90,20 +103,62 @@ class Window : public Operator {
   // row indices to send in window function apply invocations.
   void createPeerAndFrameBuffers();
 
-  // Function to compute the partitionStartRows_ structure.
-  // partitionStartRows_ is vector of the starting rows index
-  // of each partition in the data. This is an auxiliary
-  // structure that helps simplify the window function computations.
+  // Checks if input will fit in the existing memory and increases
+  // reservation if not. If reservation cannot be increased, spills enough to
+  // make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left. If 'targetRows' is 0, spills everything. This is
+  // called by ensureInputFits or by external memory management.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Invoked to record the spilling stats in operator stats after processing all
+  // the inputs.
+  void recordSpillStats();
+
+  // Reads rows from 'spillMerge_' into 'data_' until they make up complete
+  // partitions of at least 'numRowsPerOutput_' rows or the spilled rows are
+  // exhausted, and starts output of the complete partitions.
+  void readSpilledPartitions();
+
+  // Returns true if the rows are output one batch of complete partitions at
+  // a time, which is the case for sorted inputs and spilled inputs.
+  bool isStreaming() const {
+    return inputsSorted_ || spiller_ != nullptr;
+  }
+
+  // Returns true if 'lhs' and 'rhs' have equal partition keys.
+  bool samePartition(const char* lhs, const char* rhs);
+
+  // Computes the partitionStartRows_ structure for sortedRows_ whose
+  // rows of each partition are already adjacent.
   void computePartitionStartRows();
 
+  // Streaming mode only. Moves the first 'numRows' rows of inputRows_,
+  // which make up complete partitions, to sortedRows_ for output.
+  void startStreamingOutput(vector_size_t numRows);
+
+  // Streaming mode only. Frees the rows of sortedRows_ after they have
+  // all been output and, at the end of input, starts output of the
+  // remaining rows or of the next spilled partitions.
+  void finishStreamingOutput();
+
+  // Groups the rows in sortedRows_ by their partition keys so that
+  // the rows of each partition are adjacent, and computes the
+  // partitionStartRows_ structure. partitionStartRows_ is vector of
+  // the starting rows index of each partition in the data. This is
+  // an auxiliary structure that helps simplify the window function
+  // computations.
+  void groupPartitions();
+
   // This function is invoked after receiving all the input data.
   // The input data needs to be separated into partitions and
   // ordered within it (as that is the order in which the rows
   // will be output for the partition).
-  // This function achieves this by ordering the input rows by
-  // (partition keys + order by keys). Doing so orders all rows
-  // of a partition adjacent to each other and sorted by the
-  // ORDER BY clause.
+  // This function achieves this by grouping the input rows by
+  // partition keys with a hash table and then sorting the rows of
+  // each partition by the ORDER BY clause.
   void sortPartitions();
 
   // Helper function to call WindowFunction::resetPartition() for
@@ -174,18 +229,39 @@ class Window : public Operator {
   // buffers.
   HashStringAllocator stringAllocator_;
 
-  // The below 3 vectors represent the ChannelIndex of the partition keys,
-  // the order by keys and the concatenation of the 2. These keyInfo are
-  // used for sorting by those key combinations during the processing.
+  // The map from the input channels to the columns of 'data_'. The partition
+  // keys are stored first followed by the order by keys, which makes them the
+  // sorting keys of the spilled rows. The other input columns follow.
+  std::vector<IdentityProjection> columnMap_;
+
+  // The row type of 'data_' and of the spilled rows.
+  RowTypePtr internalStoreType_;
+
+  // The compare flags of the key columns of 'data_' to sort spilled rows.
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // The maximum memory usage that a window can hold before spilling. If it
+  // is zero, then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back spilled rows if disk spilling has been triggered. Reset
+  // once all the spilled rows are read.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // The below 2 vectors represent the columns in 'data_' of the partition
+  // keys and the order by keys. These keyInfo are used for grouping and
+  // sorting by those keys during the processing.
   // partitionKeyInfo_ is used to separate partitions in the rows.
-  // sortKeyInfo_ is used to identify peer rows in a partition.
-  // allKeyInfo_ is a combination of (partitionKeyInfo_ and sortKeyInfo_).
-  // It is used to perform a full sorting of the input rows to be able to
-  // separate partitions and sort the rows in it. The rows are output in
-  // this order by the operator.
+  // sortKeyInfo_ is used to sort the rows of a partition and to identify
+  // peer rows in a partition.
   std::vector<std::pair<column_index_t, core::SortOrder>> partitionKeyInfo_;
   std::vector<std::pair<column_index_t, core::SortOrder>> sortKeyInfo_;
-  std::vector<std::pair<column_index_t, core::SortOrder>> allKeyInfo_;
 
   // Vector of WindowFunction objects required by this operator.
   // WindowFunction is the base API implemented by all the window functions.
@@ -195,12 +271,26 @@ class Window : public Operator {
   // It represents the frame spec for the function computation.
   std::vector<WindowFrame> windowFrames_;
 
-  // Number of input rows.
+  // True if the input is sorted by partition keys and sort keys and is
+  // processed one batch of complete partitions at a time.
+  const bool inputsSorted_;
+
+  // Number of input rows. In streaming mode, the number of rows in
+  // sortedRows_ being output. Streaming mode includes the output of spilled
+  // input (see isStreaming()).
   vector_size_t numRows_ = 0;
 
+  // Streaming mode only. Rows received but not yet moved to sortedRows_
+  // for output, in input order.
+  std::vector<char*> inputRows_;
+
+  // Streaming mode only. Index in inputRows_ of the first row of the
+  // last partition, which may continue in the next input.
+  vector_size_t lastPartitionStart_ = 0;
+
   // Vector of pointers to each input row in the data_ RowContainer.
-  // The rows are sorted by partitionKeys + sortKeys. This total
-  // ordering can be used to split partitions (with the correct
+  // The rows of each partition are adjacent and sorted by sortKeys.
+  // This ordering can be used to split partitions (with the correct
   // order by) for the processing.
   std::vector<char*> sortedRows_;
 
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <deque>
+#include <functional>
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/hash/Hash.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/VectorHasher.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+// Measures the build and probe of join HashTables in each of the hash modes
+// for tables that fit in L2, L3 and DRAM and for different probe hit rates.
+// The time per row is reported. The benchmark names start with the hash mode,
+// which the key values decide:
+//
+//  denseBigint: Consecutive integers, a range that fits kArrayHashMaxSize.
+//  sparseBigint: Integers 1000 apart, a range too large for an array.
+//  randomBigint, randomVarchar: Random 64 bit integers and their hex strings.
+//  twoRandomBigints: A random integer and a consecutive integer.
+//
+// Keys with few enough distinct values are mapped to value ids, which makes
+// the L2 sized tables arrays or normalized keys regardless of the values.
+
+namespace {
+
+constexpr int32_t kBatchSize = 1'024;
+constexpr int32_t kNumProbeRows = 1 << 20;
+
+enum class KeyKind {
+  kDenseBigint,
+  kSparseBigint,
+  kRandomBigint,
+  kRandomVarchar,
+  kTwoRandomBigints,
+};
+
+const char* keyKindName(KeyKind kind) {
+  switch (kind) {
+    case KeyKind::kDenseBigint:
+      return "denseBigint";
+    case KeyKind::kSparseBigint:
+      return "sparseBigint";
+    case KeyKind::kRandomBigint:
+      return "randomBigint";
+    case KeyKind::kRandomVarchar:
+      return "randomVarchar";
+    case KeyKind::kTwoRandomBigints:
+      return "twoRandomBigints";
+  }
+  VELOX_UNREACHABLE();
+}
+
+// Returns the mode prepareJoinTable picks for 'size' distinct keys of 'kind'.
+// Up to VectorHasher::kMaxDistinct distinct values of a key are mapped to
+// value ids, so that small tables of sparse or random keys become arrays and
+// small tables of two keys use normalized keys.
+BaseHashTable::HashMode expectedMode(KeyKind kind, int64_t size) {
+  const bool hasValueIds = size <= VectorHasher::kMaxDistinct;
+  switch (kind) {
+    case KeyKind::kDenseBigint:
+      return BaseHashTable::HashMode::kArray;
+    case KeyKind::kSparseBigint:
+      return hasValueIds ? BaseHashTable::HashMode::kArray
+                         : BaseHashTable::HashMode::kNormalizedKey;
+    case KeyKind::kRandomBigint:
+    case KeyKind::kRandomVarchar:
+      return hasValueIds ? BaseHashTable::HashMode::kArray
+                         : BaseHashTable::HashMode::kHash;
+    case KeyKind::kTwoRandomBigints:
+      return hasValueIds ? BaseHashTable::HashMode::kNormalizedKey
+                         : BaseHashTable::HashMode::kHash;
+  }
+  VELOX_UNREACHABLE();
+}
+
+// A build side of 'size' rows with keys of 'kind' and one dependent BIGINT
+// column, and probe batches with the keys of a 'hitPct' percent of rows in
+// the build side.
+class HashTableBenchmark {
+ public:
+  HashTableBenchmark(KeyKind kind, int64_t size)
+      : kind_(kind),
+        size_(size),
+        numKeys_(kind == KeyKind::kTwoRandomBigints ? 2 : 1) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < numKeys_; ++i) {
+      names.push_back(fmt::format("k{}", i));
+      types.push_back(kind == KeyKind::kRandomVarchar ? VARCHAR() : BIGINT());
+    }
+    names.push_back("payload");
+    types.push_back(BIGINT());
+    buildType_ = ROW(std::move(names), std::move(types));
+    for (int64_t start = 0; start < size_; start += kBatchSize) {
+      buildBatches_.push_back(makeBatch(
+          std::min<int64_t>(kBatchSize, size_ - start),
+          [start](auto row) { return start + row; }));
+    }
+  }
+
+  KeyKind kind() const {
+    return kind_;
+  }
+
+  int64_t size() const {
+    return size_;
+  }
+
+  // Builds 'table_' from the build batches.
+  void build() {
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+    for (auto channel = 0; channel < numKeys_; ++channel) {
+      keyHashers.push_back(std::make_unique<VectorHasher>(
+          buildType_->childAt(channel), channel));
+    }
+    table_ = HashTable<true>::createForJoin(
+        std::move(keyHashers), {BIGINT()}, true, false, pool_.get());
+    auto* rowContainer = table_->rows();
+    auto& hashers = table_->hashers();
+    SelectivityVector rows;
+    raw_vector<uint64_t> valueIds;
+    std::vector<DecodedVector> decoded(buildType_->size());
+    const auto nextOffset = rowContainer->nextOffset();
+    for (const auto& batch : buildBatches_) {
+      rows.resize(batch->size());
+      rows.setAll();
+      valueIds.resize(batch->size());
+      for (auto i = 0; i < buildType_->size(); ++i) {
+        decoded[i].decode(*batch->childAt(i), rows);
+        if (i < numKeys_) {
+          // Collects the value ranges and distinct values that decide the
+          // hash mode.
+          hashers[i]->decode(*batch->childAt(i), rows);
+          if (table_->hashMode() != BaseHashTable::HashMode::kHash &&
+              hashers[i]->mayUseValueIds()) {
+            hashers[i]->computeValueIds(rows, valueIds);
+          }
+        }
+      }
+      for (auto row = 0; row < batch->size(); ++row) {
+        auto* newRow = rowContainer->newRow();
+        if (nextOffset) {
+          *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+        }
+        for (auto i = 0; i < buildType_->size(); ++i) {
+          rowContainer->store(decoded[i], row, newRow, i);
+        }
+      }
+    }
+    table_->prepareJoinTable({});
+    VELOX_CHECK(
+        table_->hashMode() == expectedMode(kind_, size_),
+        "Unexpected hash mode {}",
+        BaseHashTable::modeString(table_->hashMode()));
+  }
+
+  // Makes the probe batches with 'hitPct' percent of the keys in the table.
+  void makeProbeBatches(int32_t hitPct) {
+    probeBatches_.clear();
+    folly::Random::DefaultGenerator rng(hitPct);
+    const auto size = size_;
+    for (auto start = 0; start < kNumProbeRows; start += kBatchSize) {
+      probeBatches_.push_back(makeBatch(kBatchSize, [&](auto /*row*/) {
+        const auto index = folly::Random::rand64(size, rng);
+        return folly::Random::rand32(100, rng) < hitPct ? index : size + index;
+      }));
+    }
+  }
+
+  // Probes the table with the probe batches. Returns the number of hits.
+  int64_t probe() {
+    HashLookup lookup(table_->hashers());
+    auto& hashers = table_->hashers();
+    const auto mode = table_->hashMode();
+    SelectivityVector rows;
+    VectorHasher::ScratchMemory scratchMemory;
+    int64_t numHits = 0;
+    for (const auto& batch : probeBatches_) {
+      lookup.reset(batch->size());
+      rows.resize(batch->size());
+      rows.setAll();
+      for (auto i = 0; i < hashers.size(); ++i) {
+        auto key = batch->childAt(i);
+        if (mode != BaseHashTable::HashMode::kHash) {
+          hashers[i]->lookupValueIds(*key, rows, scratchMemory, lookup.hashes);
+        } else {
+          hashers[i]->decode(*key, rows);
+          hashers[i]->hash(rows, i > 0, lookup.hashes);
+        }
+      }
+      // Keys outside of the value ranges of an array or normalized key table
+      // are deselected and not probed, like in HashProbe.
+      lookup.rows.clear();
+      rows.applyToSelected([&](auto row) { lookup.rows.push_back(row); });
+      if (lookup.rows.empty()) {
+        continue;
+      }
+      table_->joinProbe(lookup);
+      for (auto row : lookup.rows) {
+        numHits += lookup.hits[row] != nullptr;
+      }
+    }
+    return numHits;
+  }
+
+ private:
+  // Returns the value of the first key of the build row 'index'. Values of
+  // indices past the end of the build side are not in the table.
+  int64_t keyValue(int64_t index) const {
+    switch (kind_) {
+      case KeyKind::kDenseBigint:
+        return index;
+      case KeyKind::kSparseBigint:
+        return index * 1'000;
+      default:
+        return folly::hash::twang_mix64(index);
+    }
+  }
+
+  RowVectorPtr makeBatch(
+      vector_size_t size,
+      const std::function<int64_t(vector_size_t)>& indexAt) {
+    std::vector<int64_t> indices(size);
+    for (auto i = 0; i < size; ++i) {
+      indices[i] = indexAt(i);
+    }
+    std::vector<VectorPtr> children;
+    if (kind_ == KeyKind::kRandomVarchar) {
+      children.push_back(vectorMaker_.flatVector<StringView>(
+          size,
+          [&](auto row) {
+            strings_.push_back(
+                fmt::format("{:016x}", keyValue(indices[row])));
+            return StringView(strings_.back());
+          }));
+    } else {
+      children.push_back(vectorMaker_.flatVector<int64_t>(
+          size, [&](auto row) { return keyValue(indices[row]); }));
+    }
+    if (numKeys_ == 2) {
+      children.push_back(vectorMaker_.flatVector<int64_t>(
+          size, [&](auto row) { return indices[row]; }));
+    }
+    children.push_back(vectorMaker_.flatVector<int64_t>(
+        size, [&](auto row) { return indices[row]; }));
+    return vectorMaker_.rowVector(buildType_->names(), children);
+  }
+
+  const KeyKind kind_;
+  const int64_t size_;
+  const int32_t numKeys_;
+  std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  // Backing strings of the flat VARCHAR vectors.
+  std::deque<std::string> strings_;
+  RowTypePtr buildType_;
+  std::vector<RowVectorPtr> buildBatches_;
+  std::vector<RowVectorPtr> probeBatches_;
+  std::unique_ptr<BaseHashTable> table_;
+};
+
+// The data of the last benchmark. The probe benchmarks of a table run after
+// its build benchmark and reuse the data and the table.
+std::unique_ptr<HashTableBenchmark> current;
+
+HashTableBenchmark& getBenchmark(KeyKind kind, int64_t size) {
+  if (current == nullptr || current->kind() != kind ||
+      current->size() != size) {
+    current.reset();
+    current = std::make_unique<HashTableBenchmark>(kind, size);
+    current->build();
+  }
+  return *current;
+}
+
+void registerBenchmarks() {
+  // Tables that fit in L2, in L3 and only in DRAM.
+  const std::vector<std::pair<std::string, int64_t>> sizes = {
+      {"L2", 16 << 10}, {"L3", 512 << 10}, {"DRAM", 8 << 20}};
+  const std::vector<int32_t> hitPcts = {5, 50, 100};
+  for (auto kind :
+       {KeyKind::kDenseBigint,
+        KeyKind::kSparseBigint,
+        KeyKind::kRandomBigint,
+        KeyKind::kRandomVarchar,
+        KeyKind::kTwoRandomBigints}) {
+    for (const auto& [sizeName, size] : sizes) {
+      if (kind == KeyKind::kDenseBigint &&
+          size >= BaseHashTable::kArrayHashMaxSize) {
+        // Too many distinct keys for kArray.
+        continue;
+      }
+      const auto name = fmt::format(
+          "{}_{}_{}",
+          BaseHashTable::modeString(expectedMode(kind, size)),
+          keyKindName(kind),
+          sizeName);
+      folly::addBenchmark(
+          __FILE__, "build_" + name, [kind, size = size](unsigned iters) {
+            folly::BenchmarkSuspender suspender;
+            auto& benchmark = getBenchmark(kind, size);
+            suspender.dismiss();
+            for (auto i = 0; i < iters; ++i) {
+              benchmark.build();
+            }
+            return iters * size;
+          });
+      for (auto hitPct : hitPcts) {
+        folly::addBenchmark(
+            __FILE__,
+            fmt::format("probe_{}_{}pct", name, hitPct),
+            [kind, size = size, hitPct](unsigned iters) {
+              folly::BenchmarkSuspender suspender;
+              auto& benchmark = getBenchmark(kind, size);
+              benchmark.makeProbeBatches(hitPct);
+              suspender.dismiss();
+              for (auto i = 0; i < iters; ++i) {
+                folly::doNotOptimizeAway(benchmark.probe());
+              }
+              return iters * kNumProbeRows;
+            });
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  registerBenchmarks();
+  folly::runBenchmarks();
+  current.reset();
+  return 0;
+}
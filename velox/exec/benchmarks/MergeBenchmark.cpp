@@ -28,6 +28,7 @@ using namespace facebook::velox::exec::test;
 TestData narrow;
 TestData medium;
 TestData wide;
+TestData clustered;
 
 BENCHMARK(narrowTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(narrow, false);
@@ -45,6 +46,10 @@ BENCHMARK_RELATIVE(mediumArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(medium, false);
 }
 
+BENCHMARK_RELATIVE(mediumTreeRuns) {
+  MergeTestBase::testRuns<TreeOfLosers<TestingStream>>(medium, false);
+}
+
 BENCHMARK(wideTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(wide, false);
 }
@@ -53,6 +58,14 @@ BENCHMARK_RELATIVE(wideArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(wide, false);
 }
 
+BENCHMARK(clusteredTree) {
+  MergeTestBase::test<TreeOfLosers<TestingStream>>(clustered, false);
+}
+
+BENCHMARK_RELATIVE(clusteredTreeRuns) {
+  MergeTestBase::testRuns<TreeOfLosers<TestingStream>>(clustered, false);
+}
+
 int main(int argc, char* argv[]) {
   folly::init(&argc, &argv);
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -61,6 +74,7 @@ int main(int argc, char* argv[]) {
   narrow = test.makeTestData(100'000'000, 7);
   medium = test.makeTestData(10'000'0000, 37);
   wide = test.makeTestData(10'000'0000, 1029);
+  clustered = test.makeClusteredTestData(10'000'0000, 37, 10'000);
   folly::runBenchmarks();
   return 0;
 }
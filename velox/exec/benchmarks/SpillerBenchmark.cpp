@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <iostream>
+
+#include <folly/Random.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/Spiller.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+DEFINE_string(
+    spiller_type,
+    "aggregate",
+    "Type of the spilled data, one of aggregate, orderby or join");
+DEFINE_int64(num_rows, 1'000'000, "Number of rows to spill");
+DEFINE_int32(row_bytes, 64, "Approximate size of a row in bytes");
+DEFINE_int32(
+    num_partitions,
+    8,
+    "Number of spill partitions, a power of two. The orderby type always "
+    "spills into one partition");
+DEFINE_int64(target_file_size_mb, 64, "Target size of a spill file in MB");
+DEFINE_string(
+    spill_compression,
+    "none",
+    "Compression of the spill files, e.g. none, zstd or lz4");
+DEFINE_int32(
+    spill_executor_threads,
+    0,
+    "Number of threads writing the spill partitions. 0 writes inline");
+DEFINE_string(
+    spill_path,
+    "",
+    "Directory of the spill files. A temporary directory if empty");
+DEFINE_int32(num_repeats, 3, "Number of times to spill and restore the data");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+// Spills synthetic RowContainer data with the Spiller and reads it back. The
+// rows have a BIGINT key, a BIGINT dependent and a VARCHAR dependent whose
+// size makes up the rest of 'row_bytes'. This reports the throughput of the
+// spill write, which includes the sort of the sorted spill types, and of the
+// restore, which merges the sorted runs or reads back the unsorted
+// partitions like HashBuild.
+
+namespace {
+
+constexpr int32_t kBatchSize = 10'000;
+
+struct SpillResult {
+  uint64_t spillMicros{0};
+  uint64_t restoreMicros{0};
+  uint64_t restoredRows{0};
+  Spiller::Stats stats;
+};
+
+class SpillerBenchmark {
+ public:
+  explicit SpillerBenchmark(const std::string& type)
+      : type_(toSpillerType(type)) {
+    rowType_ =
+        ROW({"key", "ordinal", "payload"}, {BIGINT(), BIGINT(), VARCHAR()});
+    if (FLAGS_spill_executor_threads > 0) {
+      executor_ = std::make_unique<folly::IOThreadPoolExecutor>(
+          FLAGS_spill_executor_threads);
+    }
+    if (FLAGS_spill_path.empty()) {
+      tempDir_ = exec::test::TempDirectoryPath::create();
+    }
+    makeInput();
+  }
+
+  SpillResult run() {
+    fillContainer();
+    auto spiller = makeSpiller();
+    SpillResult result;
+    {
+      MicrosecondTimer timer(&result.spillMicros);
+      spiller->spill(0, 0);
+    }
+    result.stats = spiller->stats();
+    VELOX_CHECK_EQ(result.stats.spilledRows, FLAGS_num_rows);
+    {
+      MicrosecondTimer timer(&result.restoreMicros);
+      result.restoredRows = restore(*spiller);
+    }
+    VELOX_CHECK_EQ(result.restoredRows, FLAGS_num_rows);
+    return result;
+  }
+
+ private:
+  static Spiller::Type toSpillerType(const std::string& type) {
+    if (type == "aggregate") {
+      return Spiller::Type::kAggregate;
+    }
+    if (type == "orderby") {
+      return Spiller::Type::kOrderBy;
+    }
+    if (type == "join") {
+      return Spiller::Type::kHashJoinBuild;
+    }
+    VELOX_USER_FAIL("Unknown spiller type: {}", type);
+  }
+
+  // Makes the input batches. The keys are random so that the rows spread
+  // evenly over the partitions and need sorting.
+  void makeInput() {
+    folly::Random::DefaultGenerator rng(1);
+    const auto payloadSize = std::max<int32_t>(0, FLAGS_row_bytes - 16);
+    std::string payload(payloadSize, 'x');
+    for (int64_t start = 0; start < FLAGS_num_rows; start += kBatchSize) {
+      const auto size = static_cast<vector_size_t>(
+          std::min<int64_t>(kBatchSize, FLAGS_num_rows - start));
+      auto keys = BaseVector::create<FlatVector<int64_t>>(
+          BIGINT(), size, pool_.get());
+      auto ordinals = BaseVector::create<FlatVector<int64_t>>(
+          BIGINT(), size, pool_.get());
+      auto payloads = BaseVector::create<FlatVector<StringView>>(
+          VARCHAR(), size, pool_.get());
+      for (auto i = 0; i < size; ++i) {
+        keys->set(i, folly::Random::rand64(rng));
+        ordinals->set(i, start + i);
+        // Varies the first bytes so that the payloads don't compress away.
+        if (payloadSize >= static_cast<int32_t>(sizeof(int64_t))) {
+          const auto value = folly::Random::rand64(rng);
+          memcpy(payload.data(), &value, sizeof(value));
+        }
+        payloads->set(i, StringView(payload));
+      }
+      input_.push_back(std::make_shared<RowVector>(
+          pool_.get(),
+          rowType_,
+          nullptr,
+          size,
+          std::vector<VectorPtr>{keys, ordinals, payloads}));
+    }
+  }
+
+  // Copies the input into a new 'container_'. Spilling erases the rows.
+  void fillContainer() {
+    const bool isJoinBuild = type_ == Spiller::Type::kHashJoinBuild;
+    container_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>{BIGINT()},
+        !isJoinBuild, // nullableKeys
+        std::vector<Accumulator>{},
+        std::vector<TypePtr>{BIGINT(), VARCHAR()},
+        isJoinBuild, // hasNext
+        isJoinBuild,
+        false, // hasProbedFlag
+        false, // hasNormalizedKey
+        pool_.get(),
+        ContainerRowSerde::instance());
+    std::vector<DecodedVector> decoded(rowType_->size());
+    for (const auto& batch : input_) {
+      SelectivityVector rows(batch->size());
+      for (auto i = 0; i < rowType_->size(); ++i) {
+        decoded[i].decode(*batch->childAt(i), rows);
+      }
+      for (auto row = 0; row < batch->size(); ++row) {
+        auto* newRow = container_->newRow();
+        for (auto i = 0; i < rowType_->size(); ++i) {
+          container_->store(decoded[i], row, newRow, i);
+        }
+      }
+    }
+  }
+
+  std::unique_ptr<Spiller> makeSpiller() {
+    const auto path = fmt::format(
+        "{}/spill",
+        FLAGS_spill_path.empty() ? tempDir_->path : FLAGS_spill_path);
+    const auto targetFileSize = FLAGS_target_file_size_mb << 20;
+    const auto compression =
+        common::stringToCompressionKind(FLAGS_spill_compression);
+    auto eraser = [this](folly::Range<char**> rows) {
+      container_->eraseRows(rows);
+    };
+    if (type_ == Spiller::Type::kOrderBy) {
+      return std::make_unique<Spiller>(
+          type_,
+          container_.get(),
+          eraser,
+          rowType_,
+          1,
+          std::vector<CompareFlags>{},
+          path,
+          targetFileSize,
+          0,
+          *pool_,
+          executor_.get(),
+          compression);
+    }
+    VELOX_USER_CHECK_GT(FLAGS_num_partitions, 0);
+    VELOX_USER_CHECK(
+        bits::isPowerOfTwo(FLAGS_num_partitions),
+        "num_partitions must be a power of two: {}",
+        FLAGS_num_partitions);
+    return std::make_unique<Spiller>(
+        type_,
+        container_.get(),
+        eraser,
+        rowType_,
+        HashBitRange(0, __builtin_ctz(FLAGS_num_partitions)),
+        1,
+        std::vector<CompareFlags>{},
+        path,
+        targetFileSize,
+        0,
+        *pool_,
+        executor_.get(),
+        compression);
+  }
+
+  // Reads back the spilled rows the way the spilling operators do and
+  // returns the number of rows read.
+  uint64_t restore(Spiller& spiller) {
+    uint64_t numRows = 0;
+    if (type_ == Spiller::Type::kHashJoinBuild) {
+      SpillPartitionSet partitionSet;
+      spiller.finishSpill(partitionSet);
+      for (auto& [id, partition] : partitionSet) {
+        auto reader = partition->createReader();
+        RowVectorPtr batch;
+        while (reader->nextBatch(batch)) {
+          numRows += batch->size();
+        }
+      }
+      return numRows;
+    }
+    VELOX_CHECK(spiller.finishSpill().empty());
+    for (auto partition = 0;
+         partition < spiller.hashBits().numPartitions();
+         ++partition) {
+      if (!spiller.isSpilled(partition)) {
+        continue;
+      }
+      auto merge = spiller.startMerge(partition);
+      while (auto* stream = merge->next()) {
+        stream->pop();
+        ++numRows;
+      }
+    }
+    return numRows;
+  }
+
+  const Spiller::Type type_;
+  std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
+  RowTypePtr rowType_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
+  std::shared_ptr<exec::test::TempDirectoryPath> tempDir_;
+  std::vector<RowVectorPtr> input_;
+  std::unique_ptr<RowContainer> container_;
+};
+
+double toMBPerSecond(uint64_t bytes, uint64_t micros) {
+  if (micros == 0) {
+    return 0;
+  }
+  return (bytes / static_cast<double>(1 << 20)) / (micros / 1'000'000.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  filesystems::registerLocalFileSystem();
+  SpillerBenchmark benchmark(FLAGS_spiller_type);
+  for (auto i = 0; i < FLAGS_num_repeats; ++i) {
+    const auto result = benchmark.run();
+    std::cout << fmt::format(
+                     "{} rows:{} input:{} spilled:{} files:{} "
+                     "partitions:{} spill:{} ({:.1f} MB/s) restore:{} "
+                     "({:.1f} MB/s)",
+                     FLAGS_spiller_type,
+                     result.stats.spilledRows,
+                     succinctBytes(result.stats.spilledInputBytes),
+                     succinctBytes(result.stats.spilledBytes),
+                     result.stats.spilledFiles,
+                     result.stats.spilledPartitions,
+                     succinctMicros(result.spillMicros),
+                     toMBPerSecond(
+                         result.stats.spilledInputBytes, result.spillMicros),
+                     succinctMicros(result.restoreMicros),
+                     toMBPerSecond(
+                         result.stats.spilledInputBytes, result.restoreMicros))
+              << std::endl;
+  }
+  return 0;
+}
@@ -793,6 +793,56 @@ TEST_F(AggregationTest, partialDistinctWithAbandon) {
              .assertResults("SELECT distinct c0, sum(c0) FROM tmp group by c0");
 }
 
+TEST_F(AggregationTest, partialAggregationResumeAfterAbandon) {
+  std::vector<RowVectorPtr> vectors;
+  // The first 5 batches have unique keys. Partial aggregation is abandoned
+  // after the 2nd one.
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int32_t>(
+        100, [i](auto row) { return i * 100 + row; })}));
+  }
+  // The rest reduce well enough to keep partial aggregation once resumed.
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(100, [](auto row) { return row % 5; })}));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .partialAggregation({"c0"}, {"sum(c0)"})
+                  .capturePlanNodeId(aggNodeId)
+                  .finalAggregation()
+                  .planNode();
+  const auto runQuery = [&](const std::string& resampleRows) {
+    return AssertQueryBuilder(duckDbQueryRunner_)
+        .config(QueryConfig::kAbandonPartialAggregationMinRows, "100")
+        .config(QueryConfig::kAbandonPartialAggregationMinPct, "50")
+        .config(
+            QueryConfig::kAbandonPartialAggregationResampleRows, resampleRows)
+        .config("max_drivers_per_task", "1")
+        .plan(plan)
+        .assertResults("SELECT c0, sum(c0) FROM tmp GROUP BY c0");
+  };
+
+  auto task = runQuery("250");
+  auto stats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  EXPECT_EQ(stats.at("abandonedPartialAggregation").sum, 1);
+  EXPECT_EQ(stats.at("resumedPartialAggregation").sum, 1);
+  EXPECT_EQ(stats.at("abandonedPartialAggregationInputRows").sum, 300);
+  // The resumed partial aggregation reduces the last 1000 rows to 5 groups.
+  EXPECT_EQ(
+      toPlanStats(task->taskStats()).at(aggNodeId).outputRows, 200 + 300 + 5);
+
+  // Stays abandoned by default.
+  task = runQuery("0");
+  stats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  EXPECT_EQ(stats.at("abandonedPartialAggregation").sum, 1);
+  EXPECT_EQ(stats.count("resumedPartialAggregation"), 0);
+  EXPECT_EQ(toPlanStats(task->taskStats()).at(aggNodeId).outputRows, 1'500);
+}
+
 TEST_F(AggregationTest, largeValueRangeArray) {
   // We have keys that map to integer range. The keys are
   // a little under max array hash table size apart. This wastes 16MB of
@@ -1543,6 +1593,52 @@ TEST_F(AggregationTest, distinctWithSpilling) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+TEST_F(AggregationTest, distinctInputs) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7; }),
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return (row + i) % 13; }, nullEvery(11)),
+        makeFlatVector<StringView>(
+            1'000,
+            [](auto row) {
+              return StringView(std::string(20, 'a' + row % 5));
+            }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation(
+                      {"c0"},
+                      {"count(DISTINCT c1)",
+                       "sum(DISTINCT c1)",
+                       "count(DISTINCT c2)",
+                       "count(c1)"})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, count(DISTINCT c1), sum(DISTINCT c1), count(DISTINCT c2), "
+      "count(c1) FROM tmp GROUP BY 1");
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation(
+                 {}, {"count(DISTINCT c1)", "max(DISTINCT c2)", "count(c1)"})
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT count(DISTINCT c1), max(DISTINCT c2), count(c1) FROM tmp");
+
+  VELOX_ASSERT_THROW(
+      PlanBuilder()
+          .values(vectors)
+          .partialAggregation({"c0"}, {"count(DISTINCT c1)"}),
+      "Aggregations over distinct inputs cannot be split into partial and final");
+}
+
 TEST_F(AggregationTest, preGroupedAggregationWithSpilling) {
   std::vector<RowVectorPtr> vectors;
   int64_t val = 0;
@@ -1629,6 +1725,124 @@ TEST_F(AggregationTest, adaptiveOutputBatchRows) {
   }
 }
 
+TEST_F(AggregationTest, parallelMerge) {
+  constexpr int32_t kNumDrivers = 4;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 5; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000,
+             [i](auto row) { return (row * 7 + i * 13) % 997; },
+             nullEvery(17)),
+         makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+         makeFlatVector<StringView>(1'000, [](auto row) {
+           return StringView(std::string(20, 'a' + row % 26));
+         })}));
+  }
+  // Each driver of a parallelizable Values node produces all of 'batches'.
+  std::vector<RowVectorPtr> expected;
+  for (int i = 0; i < kNumDrivers; ++i) {
+    expected.insert(expected.end(), batches.begin(), batches.end());
+  }
+  createDuckDbTable(expected);
+
+  const std::vector<std::string> aggregates = {
+      "sum(c1)", "count(c1)", "avg(c1)", "max(c2)"};
+  const std::string sql =
+      "SELECT c0, sum(c1), count(c1), avg(c1), max(c2) FROM tmp GROUP BY c0";
+
+  // The final and single aggregations run on all the drivers without a local
+  // exchange on the grouping keys.
+  core::PlanNodeId aggregationId;
+  std::vector<core::PlanNodePtr> plans;
+  plans.push_back(PlanBuilder()
+                      .values(batches, true)
+                      .partialAggregation({"c0"}, aggregates)
+                      .finalAggregation()
+                      .capturePlanNodeId(aggregationId)
+                      .planNode());
+  plans.push_back(PlanBuilder()
+                      .values(batches, true)
+                      .singleAggregation({"c0"}, aggregates)
+                      .capturePlanNodeId(aggregationId)
+                      .planNode());
+  for (const auto& plan : plans) {
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(QueryConfig::kAggregationParallelMergeEnabled, "true")
+            .maxDrivers(kNumDrivers)
+            .assertResults(sql);
+    EXPECT_EQ(
+        kNumDrivers,
+        toPlanStats(task->taskStats()).at(aggregationId).numDrivers);
+  }
+}
+
+TEST_F(AggregationTest, havingPruning) {
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(1'000, [](auto row) { return row % 100; }),
+         makeFlatVector<int64_t>(
+             1'000, [i](auto row) { return (row * 17 + i * 31) % 1'000; }),
+         makeFlatVector<int64_t>(
+             1'000, [i](auto row) { return row + i; }, nullEvery(7))}));
+  }
+  createDuckDbTable(batches);
+
+  struct {
+    std::string filter;
+    std::string sql;
+    bool expectPruning;
+  } testSettings[] = {
+      {"a0 < 100",
+       "SELECT * FROM (SELECT c0, max(c1) a0, min(c1), count(c2) "
+       "FROM tmp GROUP BY c0) WHERE a0 < 100",
+       true},
+      {"a1 >= 10",
+       "SELECT * FROM (SELECT c0, max(c1), min(c1) a1, count(c2) "
+       "FROM tmp GROUP BY c0) WHERE a1 >= 10",
+       true},
+      {"a2 <= 30 AND c0 > 10",
+       "SELECT * FROM (SELECT c0, max(c1), min(c1), count(c2) a2 "
+       "FROM tmp GROUP BY c0) WHERE a2 <= 30 AND c0 > 10",
+       true},
+      {"50 > a2",
+       "SELECT * FROM (SELECT c0, max(c1), min(c1), count(c2) a2 "
+       "FROM tmp GROUP BY c0) WHERE a2 < 50",
+       true},
+      // A lower bound on max() cannot prune.
+      {"a0 > 100",
+       "SELECT * FROM (SELECT c0, max(c1) a0, min(c1), count(c2) "
+       "FROM tmp GROUP BY c0) WHERE a0 > 100",
+       false},
+  };
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.filter);
+    for (const bool enabled : {false, true}) {
+      core::PlanNodeId aggregationId;
+      auto plan = PlanBuilder()
+                      .values(batches)
+                      .singleAggregation(
+                          {"c0"}, {"max(c1)", "min(c1)", "count(c2)"})
+                      .capturePlanNodeId(aggregationId)
+                      .filter(testData.filter)
+                      .planNode();
+      auto task =
+          AssertQueryBuilder(plan, duckDbQueryRunner_)
+              .config(
+                  QueryConfig::kAggregationHavingPruningEnabled,
+                  enabled ? "true" : "false")
+              .assertResults(testData.sql);
+      const auto& runtimeStats =
+          toPlanStats(task->taskStats()).at(aggregationId).customStats;
+      ASSERT_EQ(
+          runtimeStats.count("prunedInputRows") > 0,
+          enabled && testData.expectPruning);
+    }
+  }
+}
+
 DEBUG_ONLY_TEST_F(AggregationTest, reclaimDuringInputProcessing) {
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
   auto rowType = ROW({"c0", "c1", "c2"}, {INTEGER(), INTEGER(), VARCHAR()});
@@ -226,3 +226,30 @@ TEST_F(ArrowStreamTest, error) {
       AssertQueryBuilder(plan).copyResults(pool_.get()),
       "Failed to call get_schema on ArrowStream: get_schema failed.");
 }
+
+TEST_F(ArrowStreamTest, prefetch) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             100, [&](auto row) { return i * 100 + row; }, nullEvery(7)),
+         makeFlatVector<StringView>(100, [](auto row) {
+           return StringView(std::string(20, 'a' + row % 26));
+         })}));
+  }
+  createDuckDbTable(vectors);
+  auto type = asRowType(vectors[0]->type());
+
+  // 0 reads the stream on the driver thread.
+  for (const auto* prefetchBatches : {"0", "1", "4", "100"}) {
+    SCOPED_TRACE(prefetchBatches);
+    struct ArrowArrayStream arrowStream;
+    exportArrowStream(
+        std::make_shared<ArrowReader>(pool_, vectors, type), &arrowStream);
+    auto plan = std::make_shared<core::ArrowStreamNode>(
+        "0", type, std::make_shared<ArrowArrayStream>(arrowStream));
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kArrowStreamPrefetchBatches, prefetchBatches)
+        .assertResults("SELECT * FROM tmp");
+  }
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/QueryAssertions.h"
@@ -103,6 +104,32 @@ TEST_F(AssignUniqueIdTest, exceedRequestLimit) {
   verifyUniqueId(plan, input);
 }
 
+TEST_F(AssignUniqueIdTest, batchAcrossRequests) {
+  // The second batch starts 10 rows before the end of the first request of
+  // ids and takes the rest of its ids from the next request.
+  vector_size_t requestLimit = 1 << 20L;
+  std::vector<RowVectorPtr> input;
+  for (auto size : {requestLimit - 10, 20}) {
+    input.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(size, [](auto row) { return row; })}));
+  }
+
+  auto plan = PlanBuilder()
+                  .values(input)
+                  .assignUniqueId()
+                  .capturePlanNodeId(uniqueNodeId_)
+                  .planNode();
+
+  auto result = AssertQueryBuilder(plan).copyResults(pool());
+  auto ids = result->childAt(1)->asFlatVector<int64_t>();
+  ASSERT_EQ(requestLimit + 10, ids->size());
+  // Task unique id 1 is in the bits above the 40 bits of the row id.
+  const int64_t taskBits = 1L << 40;
+  for (auto i = 0; i < ids->size(); ++i) {
+    ASSERT_EQ(taskBits | i, ids->valueAt(i));
+  }
+}
+
 TEST_F(AssignUniqueIdTest, multiThread) {
   for (int i = 0; i < 3; i++) {
     vector_size_t batchSize = 1000;
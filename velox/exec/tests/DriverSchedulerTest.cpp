@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverScheduler.h"
+#include <folly/synchronization/Baton.h>
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class DriverSchedulerTest : public OperatorTestBase {
+ protected:
+  // Busy waits for 'micros' so that the function takes scheduler time.
+  static void spin(int32_t micros) {
+    auto end = std::chrono::steady_clock::now() +
+        std::chrono::microseconds(micros);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+};
+
+TEST_F(DriverSchedulerTest, basic) {
+  std::atomic<int32_t> numRun{0};
+  {
+    DriverScheduler scheduler(4);
+    ASSERT_EQ(scheduler.numThreads(), 4);
+    for (auto i = 0; i < 1'000; ++i) {
+      scheduler.add(fmt::format("query{}", i % 3), 1.0, [&]() { ++numRun; });
+    }
+    // Plain folly::Executor interface.
+    scheduler.add([&]() { ++numRun; });
+  }
+  ASSERT_EQ(numRun, 1'001);
+}
+
+TEST_F(DriverSchedulerTest, workStealing) {
+  std::atomic<int32_t> numRun{0};
+  DriverScheduler scheduler(4);
+  folly::Baton<> done;
+  // Work added from a scheduler thread goes to that thread's queue. The idle
+  // threads steal it.
+  scheduler.add([&]() {
+    for (auto i = 0; i < 100; ++i) {
+      scheduler.add("query", 1.0, [&]() {
+        spin(1'000);
+        if (++numRun == 100) {
+          done.post();
+        }
+      });
+    }
+  });
+  done.wait();
+  ASSERT_EQ(scheduler.stats().numRun, 101);
+  ASSERT_GT(scheduler.stats().numStolen, 0);
+}
+
+TEST_F(DriverSchedulerTest, fairShare) {
+  std::mutex mutex;
+  std::vector<std::string> order;
+  {
+    DriverScheduler scheduler(1);
+    folly::Baton<> start;
+    scheduler.add([&]() { start.wait(); });
+
+    // 'heavy' has 3 times the weight of 'light' and gets about 3 of every 4
+    // slices although 'light' queued all its work first.
+    for (const auto& [queryId, weight] :
+         std::vector<std::pair<std::string, double>>{
+             {"light", 1.0}, {"heavy", 3.0}}) {
+      for (auto i = 0; i < 40; ++i) {
+        scheduler.add(queryId, weight, [&, queryId = queryId]() {
+          spin(200);
+          std::lock_guard<std::mutex> l(mutex);
+          order.push_back(queryId);
+        });
+      }
+    }
+    start.post();
+  }
+  ASSERT_EQ(order.size(), 80);
+  const auto numHeavy =
+      std::count(order.begin(), order.begin() + 40, std::string("heavy"));
+  ASSERT_GE(numHeavy, 25);
+  ASSERT_LT(numHeavy, 40);
+}
+
+TEST_F(DriverSchedulerTest, numaAware) {
+  std::atomic<int32_t> numRun{0};
+  {
+    DriverScheduler scheduler(4, true);
+    ASSERT_GE(scheduler.numNodes(), 1);
+    ASSERT_LE(scheduler.numNodes(), 4);
+    for (auto i = 0; i < 1'000; ++i) {
+      scheduler.add(fmt::format("query{}", i % 7), 1.0, [&]() {
+        spin(10);
+        ++numRun;
+      });
+    }
+  }
+  ASSERT_EQ(numRun, 1'000);
+
+  // Without NUMA awareness there is a single node and no steal crosses
+  // nodes.
+  DriverScheduler scheduler(4);
+  ASSERT_EQ(scheduler.numNodes(), 1);
+  folly::Baton<> done;
+  scheduler.add([&]() {
+    for (auto i = 0; i < 100; ++i) {
+      scheduler.add("query", 1.0, [&]() {
+        spin(100);
+        if (++numRun == 1'100) {
+          done.post();
+        }
+      });
+    }
+  });
+  done.wait();
+  ASSERT_EQ(scheduler.stats().numCrossNodeSteals, 0);
+}
+
+TEST_F(DriverSchedulerTest, query) {
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  auto plan = PlanBuilder()
+                  .values({data}, true)
+                  .partialAggregation({}, {"sum(c0)"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .planNode();
+  auto expected = makeRowVector({makeFlatVector<int64_t>(
+      std::vector<int64_t>{4 * 1'000 * 999 / 2})});
+
+  DriverScheduler scheduler(4);
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      &scheduler,
+      std::unordered_map<std::string, std::string>{
+          {core::QueryConfig::kDriverSchedulerWeight, "2"}});
+  AssertQueryBuilder(plan)
+      .queryCtx(queryCtx)
+      .maxDrivers(4)
+      .assertResults(expected);
+  ASSERT_GT(scheduler.stats().numRun, 0);
+}
@@ -13,13 +13,16 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/ScopeGuard.h>
 #include <folly/Unit.h>
 #include <folly/init/Init.h>
 #include <velox/exec/Driver.h>
 #include "folly/experimental/EventCount.h"
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/process/PerfCounters.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/exec/DriverTrace.h"
 #include "velox/exec/Values.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
@@ -572,6 +575,15 @@ TEST_F(DriverTest, pause) {
   EXPECT_EQ(operators[0].outputPositions, 10000000);
   EXPECT_EQ(operators[1].inputPositions, 10000000);
   EXPECT_EQ(operators[1].outputPositions, 10 * hits);
+  // The Drivers are paused and resumed, so each gets on thread several times.
+  // Each quantum on thread follows a wait in the executor queue.
+  const auto& driverStats = taskStats.pipelineStats[0].driverStats;
+  EXPECT_GT(driverStats.queuedWallNanos.count, 10);
+  EXPECT_EQ(
+      driverStats.onThreadWallNanos.count, driverStats.queuedWallNanos.count);
+  EXPECT_EQ(
+      driverStats.onThreadCpuNanos.count, driverStats.onThreadWallNanos.count);
+  EXPECT_GT(driverStats.onThreadCpuNanos.sum, 0);
 }
 
 TEST_F(DriverTest, yield) {
@@ -961,6 +973,74 @@ class ThrowNodeFactory : public Operator::PlanNodeTranslator {
 
 } // namespace
 
+TEST_F(DriverTest, driverTrace) {
+  FLAGS_velox_trace_driver_events = true;
+  SCOPE_EXIT {
+    FLAGS_velox_trace_driver_events = false;
+  };
+  const int32_t numDrivers = 3;
+  auto task = createAndStartTaskToReadValues(numDrivers);
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 1'000'000));
+
+  const auto events = DriverTrace::events(*task);
+  std::vector<std::vector<DriverTrace::EventType>> driverEvents(numDrivers);
+  for (auto i = 0; i < events.size(); ++i) {
+    if (i > 0) {
+      ASSERT_LE(events[i - 1].timeNanos, events[i].timeNanos);
+    }
+    ASSERT_EQ(events[i].pipelineId, 0);
+    ASSERT_LT(events[i].driverId, numDrivers);
+    driverEvents[events[i].driverId].push_back(events[i].type);
+  }
+  for (const auto& types : driverEvents) {
+    ASSERT_GE(types.size(), 3);
+    EXPECT_EQ(types[0], DriverTrace::EventType::kEnqueue);
+    EXPECT_EQ(types[1], DriverTrace::EventType::kRun);
+    EXPECT_EQ(types.back(), DriverTrace::EventType::kStop);
+  }
+
+  const auto json = DriverTrace::toChromeTraceJson(*task);
+  EXPECT_NE(json.find("\"name\":\"queued\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"running\""), std::string::npos);
+  EXPECT_NE(json.find("\"stopReason\":\"AT_END\""), std::string::npos);
+  EXPECT_NE(json.find("pipeline 0"), std::string::npos);
+
+  // Other tasks have no events.
+  auto otherTask = createAndStartTaskToReadValues(1);
+  ASSERT_TRUE(waitForTaskCompletion(otherTask.get(), 1'000'000));
+  EXPECT_EQ(DriverTrace::events(*task).size(), events.size());
+}
+
+TEST_F(DriverTest, hardwareCounters) {
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(10'000, [](auto row) { return row; })});
+  auto plan =
+      PlanBuilder().values({data, data}).project({"c0 * 2 as c0"}).planNode();
+  auto expected = makeRowVector(
+      {makeFlatVector<int64_t>(10'000, [](auto row) { return row * 2; })});
+  auto task =
+      AssertQueryBuilder(plan)
+          .config(core::QueryConfig::kOperatorTrackHardwareCounters, "true")
+          .assertResults({expected, expected});
+  const auto& projectStats =
+      task->taskStats().pipelineStats[0].operatorStats[1];
+  const auto& runtimeStats = projectStats.runtimeStats;
+  if (!process::PerfCounters::isAvailable()) {
+    EXPECT_EQ(runtimeStats.count("instructions"), 0);
+    return;
+  }
+  // Counted at the same operator calls as the CPU and wall times.
+  ASSERT_EQ(runtimeStats.count("instructions"), 1);
+  EXPECT_EQ(
+      runtimeStats.at("instructions").count,
+      projectStats.getOutputTiming.count + projectStats.addInputTiming.count +
+          projectStats.finishTiming.count);
+  EXPECT_GT(runtimeStats.at("instructions").sum, 0);
+  EXPECT_GT(runtimeStats.at("cpuCycles").sum, 0);
+  EXPECT_EQ(runtimeStats.count("cacheMisses"), 1);
+  EXPECT_EQ(runtimeStats.count("branchMisses"), 1);
+}
+
 // Use a node for which driver factory would throw on any driver beyond id 0.
 // This is to test that we do not crash due to early driver destruction and we
 // have a proper error being propagated out.
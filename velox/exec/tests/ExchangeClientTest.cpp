@@ -21,6 +21,202 @@ namespace facebook::velox::exec {
 
 namespace {
 
+// Keeps its first request pending and records the credit it was given.
+class CreditRecordingSource : public ExchangeSource {
+ public:
+  CreditRecordingSource(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* pool,
+      std::vector<uint64_t>& credits)
+      : ExchangeSource(taskId, destination, std::move(queue), pool),
+        credits_(credits) {}
+
+  bool shouldRequestLocked() override {
+    if (requestPending_) {
+      return false;
+    }
+    requestPending_ = true;
+    return true;
+  }
+
+  void request(uint64_t maxBytes) override {
+    credits_.push_back(maxBytes);
+  }
+
+  void close() override {}
+
+  folly::F14FastMap<std::string, int64_t> stats() const override {
+    return {};
+  }
+
+ private:
+  std::vector<uint64_t>& credits_;
+};
+
+TEST(ExchangeClientTest, credit) {
+  std::shared_ptr<memory::MemoryPool> rootPool{
+      memory::defaultMemoryManager().addRootPool()};
+  std::shared_ptr<memory::MemoryPool> pool{rootPool->addLeafChild("leaf")};
+
+  static std::vector<uint64_t> credits;
+  ExchangeSource::registerFactory(
+      [](const auto& taskId, auto destination, auto queue, auto pool)
+          -> std::shared_ptr<ExchangeSource> {
+        if (taskId.find("credit://") != 0) {
+          return nullptr;
+        }
+        return std::make_shared<CreditRecordingSource>(
+            taskId, destination, std::move(queue), pool, credits);
+      });
+
+  // The free space of the queue is divided between the sources.
+  {
+    const uint64_t minSize = 1 << 20;
+    ExchangeClient client(0, pool.get(), minSize);
+    client.addRemoteTaskId("credit://1");
+    client.addRemoteTaskId("credit://2");
+    ASSERT_EQ(credits, std::vector<uint64_t>({minSize, minSize / 2}));
+  }
+
+  // Each source gets at least the minimum credit.
+  credits.clear();
+  {
+    ExchangeClient client(0, pool.get(), ExchangeClient::kMinCredit);
+    for (int i = 0; i < 4; ++i) {
+      client.addRemoteTaskId(fmt::format("credit://{}", i));
+    }
+    ASSERT_EQ(credits, std::vector<uint64_t>(4, ExchangeClient::kMinCredit));
+  }
+}
+
+// Delivers each page into a registered memory region, as an RDMA or shared
+// memory transport would, and reports the end of data once it has no
+// regions left.
+class RegionSource : public ExchangeSource {
+ public:
+  RegionSource(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* pool,
+      std::vector<void*>& registered)
+      : ExchangeSource(taskId, destination, std::move(queue), pool),
+        regions_(ExchangeMemoryRegionPool::create(
+            pool,
+            16,
+            2,
+            [&](auto& region) {
+              region.setHandle(region.data());
+              registered.push_back(region.handle());
+            },
+            [&](auto& region) {
+              registered.erase(std::find(
+                  registered.begin(), registered.end(), region.handle()));
+            })) {}
+
+  bool shouldRequestLocked() override {
+    if (atEnd_) {
+      return false;
+    }
+    return !requestPending_.exchange(true);
+  }
+
+  void request(uint64_t /*maxBytes*/) override {
+    auto region = regions_->acquire();
+    std::unique_ptr<SerializedPage> page;
+    if (region != nullptr) {
+      auto size = snprintf(
+          reinterpret_cast<char*>(region->data()),
+          region->capacity(),
+          "page %d",
+          numPages_++);
+      page = regions_->makePage(std::move(region), size);
+    }
+    std::vector<ContinuePromise> promises;
+    {
+      std::lock_guard<std::mutex> l(queue_->mutex());
+      requestPending_ = false;
+      atEnd_ = page == nullptr;
+      queue_->enqueueLocked(std::move(page), promises);
+    }
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  }
+
+  void close() override {}
+
+  folly::F14FastMap<std::string, int64_t> stats() const override {
+    return {};
+  }
+
+  std::shared_ptr<ExchangeMemoryRegionPool> memoryRegions() const override {
+    return regions_;
+  }
+
+ private:
+  const std::shared_ptr<ExchangeMemoryRegionPool> regions_;
+  int32_t numPages_{0};
+};
+
+TEST(ExchangeClientTest, memoryRegions) {
+  std::shared_ptr<memory::MemoryPool> rootPool{
+      memory::defaultMemoryManager().addRootPool()};
+  std::shared_ptr<memory::MemoryPool> pool{rootPool->addLeafChild("leaf")};
+
+  static std::vector<void*> registered;
+  ExchangeSource::registerFactory(
+      [](const auto& taskId, auto destination, auto queue, auto pool)
+          -> std::shared_ptr<ExchangeSource> {
+        if (taskId.find("region://") != 0) {
+          return nullptr;
+        }
+        return std::make_shared<RegionSource>(
+            taskId, destination, std::move(queue), pool, registered);
+      });
+
+  auto readPage = [](const std::unique_ptr<SerializedPage>& page) {
+    auto iobuf = page->getIOBuf();
+    return std::string(
+        reinterpret_cast<const char*>(iobuf->data()), iobuf->length());
+  };
+
+  std::vector<std::unique_ptr<SerializedPage>> pages;
+  {
+    auto client = std::make_shared<ExchangeClient>(0, pool.get());
+    client->addRemoteTaskId("region://1");
+    client->noMoreRemoteTasks();
+
+    bool atEnd;
+    ContinueFuture future;
+    // The source has two regions. The third request finds both holding
+    // unconsumed pages, upon which the source reports the end of data.
+    for (;;) {
+      auto page = client->next(&atEnd, &future);
+      if (atEnd) {
+        break;
+      }
+      if (page != nullptr) {
+        pages.push_back(std::move(page));
+      }
+    }
+    ASSERT_EQ(pages.size(), 2);
+    EXPECT_EQ(readPage(pages[0]), "page 0");
+    EXPECT_EQ(readPage(pages[1]), "page 1");
+    ASSERT_EQ(registered.size(), 2);
+    client->close();
+  }
+
+  // The pages keep their regions registered after the source is gone.
+  pages.resize(1);
+  ASSERT_EQ(registered.size(), 2);
+  EXPECT_EQ(readPage(pages[0]), "page 0");
+  pages.clear();
+  ASSERT_TRUE(registered.empty());
+}
+
 TEST(ExchangeClientTest, nonVeloxCreateExchangeSourceException) {
   std::shared_ptr<memory::MemoryPool> rootPool{
       memory::defaultMemoryManager().addRootPool()};
@@ -287,6 +287,73 @@ TEST_F(GroupedExecutionTest, groupedExecutionWithOutputBuffer) {
   EXPECT_EQ(18, taskStats.pipelineStats[1].operatorStats[1].inputVectors);
 }
 
+// Checks that each split group has its own memory pool and that the memory
+// budget limits the number of concurrent split groups.
+TEST_F(GroupedExecutionTest, splitGroupMemoryBudget) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId tableScanNodeId;
+  auto pipe0Node = PlanBuilder(planNodeIdGenerator)
+                       .tableScan(rowType_)
+                       .capturePlanNodeId(tableScanNodeId)
+                       .project({"c0", "c1"})
+                       .planNode();
+  auto planFragment = PlanBuilder(planNodeIdGenerator)
+                          .localPartitionRoundRobin({pipe0Node})
+                          .partitionedOutput({}, 1, {"c0", "c1"})
+                          .planFragment();
+  planFragment.executionStrategy = core::ExecutionStrategy::kGrouped;
+  planFragment.groupedExecutionLeafNodeIds.emplace(tableScanNodeId);
+  planFragment.numSplitGroups = 10;
+  // Any group is over a budget of 1 byte.
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      executor_.get(),
+      std::unordered_map<std::string, std::string>{
+          {core::QueryConfig::kGroupedExecutionMemoryBudget, "1"}});
+  auto task =
+      exec::Task::create("0", std::move(planFragment), 0, std::move(queryCtx));
+  // 3 drivers max and 2 concurrent split groups.
+  task->start(task, 3, 2);
+
+  task->addSplit("0", makeHiveSplitWithGroup(filePath->path, 8));
+  EXPECT_EQ(6, task->numRunningDrivers());
+  std::vector<std::string> childPools;
+  task->pool()->visitChildren([&](memory::MemoryPool* pool) {
+    childPools.push_back(pool->name());
+    return true;
+  });
+  EXPECT_NE(
+      std::find(childPools.begin(), childPools.end(), "group.8"),
+      childPools.end());
+
+  task->noMoreSplitsForGroup("0", 8);
+  waitForFinishedDrivers(task, 6);
+  EXPECT_EQ(std::unordered_set<int32_t>({8}), getCompletedSplitGroups(task));
+
+  // Group 8 went over the budget. Only one of the next two groups runs.
+  task->addSplit("0", makeHiveSplitWithGroup(filePath->path, 1));
+  task->addSplit("0", makeHiveSplitWithGroup(filePath->path, 5));
+  EXPECT_EQ(6, task->numRunningDrivers());
+
+  task->noMoreSplitsForGroup("0", 1);
+  waitForFinishedDrivers(task, 12);
+  EXPECT_EQ(6, task->numRunningDrivers());
+  EXPECT_EQ(std::unordered_set<int32_t>({1, 8}), getCompletedSplitGroups(task));
+
+  task->noMoreSplitsForGroup("0", 5);
+  waitForFinishedDrivers(task, 18);
+  EXPECT_EQ(0, task->numRunningDrivers());
+
+  task->noMoreSplits("0");
+  auto outputBufferManager =
+      exec::PartitionedOutputBufferManager::getInstance().lock();
+  outputBufferManager->deleteResults(task->taskId(), 0);
+  EXPECT_EQ(exec::TaskState::kFinished, task->state());
+}
+
 // Here we test various aspects of grouped/bucketed execution involving
 // output buffer and 3 pipelines.
 TEST_F(GroupedExecutionTest, groupedExecutionWithHashAndNestedLoopJoin) {
@@ -840,6 +840,41 @@ DEBUG_ONLY_TEST_P(MultiThreadedHashJoinTest, parallelJoinBuildCheck) {
   ASSERT_EQ(numDrivers_ == 1, !isParallelBuild);
 }
 
+DEBUG_ONLY_TEST_P(MultiThreadedHashJoinTest, arrayParallelJoinBuildCheck) {
+  // Build-side keys come from a small range so that the table is in kArray
+  // mode. Each key appears in every build batch.
+  std::vector<RowVectorPtr> probeVectors =
+      makeBatches(4, [&](uint32_t /*unused*/) {
+        return makeRowVector(
+            {"t0", "t1"},
+            {makeFlatVector<int32_t>(8'192, [](auto row) { return row * 2; }),
+             makeFlatVector<int64_t>(8'192, [](auto row) { return row; })});
+      });
+  std::vector<RowVectorPtr> buildVectors =
+      makeBatches(4, [&](uint32_t /*unused*/) {
+        return makeRowVector(
+            {"u0", "u1"},
+            {makeFlatVector<int32_t>(8'192, [](auto row) { return row; }),
+             makeFlatVector<int64_t>(8'192, [](auto row) { return row; })});
+      });
+
+  std::atomic<bool> isParallelBuild{false};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::HashTable::parallelJoinBuild",
+      std::function<void(void*)>([&](void*) { isParallelBuild = true; }));
+  HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+      .numDrivers(numDrivers_)
+      .probeKeys({"t0"})
+      .probeVectors(std::move(probeVectors))
+      .buildKeys({"u0"})
+      .buildVectors(std::move(buildVectors))
+      .joinOutputLayout({"t1", "u1"})
+      .referenceQuery("SELECT t.t1, u.u1 FROM t, u WHERE t.t0 = u.u0")
+      .injectSpill(false)
+      .run();
+  ASSERT_EQ(numDrivers_ == 1, !isParallelBuild);
+}
+
 TEST_P(MultiThreadedHashJoinTest, allTypes) {
   HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
       .keyTypes(
@@ -1002,6 +1037,8 @@ TEST_P(MultiThreadedHashJoinTest, arrayBasedLookup) {
                              .runtimeStats;
         ASSERT_EQ(151, joinStats["distinctKey0"].sum);
         ASSERT_EQ(200, joinStats["rangeKey0"].sum);
+        ASSERT_EQ(1, joinStats["hashtable.arrayMode"].sum);
+        ASSERT_EQ(150, joinStats["hashtable.numDistinctKeys"].sum);
       })
       .run();
 }
@@ -2733,6 +2770,48 @@ TEST_P(MultiThreadedHashJoinTest, noSpillLevelLimit) {
       .run();
 }
 
+TEST_F(HashJoinTest, semiFilterTableHasOnlyKeys) {
+  std::vector<RowVectorPtr> probeVectors =
+      makeBatches(3, [&](int32_t /*unused*/) {
+        return makeRowVector(
+            {makeFlatVector<int32_t>(1'000, [](auto row) { return row * 7; }),
+             makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+      });
+  // 10MB of build side payload which the semi join does not use.
+  static const std::string kPayload(1'000, 'x');
+  std::vector<RowVectorPtr> buildVectors =
+      makeBatches(10, [&](int32_t batch) {
+        return makeRowVector(
+            {"u_c0", "u_c1"},
+            {makeFlatVector<int32_t>(
+                 1'000, [batch](auto row) { return batch * 1'000 + row; }),
+             makeFlatVector<StringView>(
+                 1'000, [](auto /*row*/) { return StringView(kPayload); })});
+      });
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  core::PlanNodeId joinNodeId;
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values(probeVectors)
+          .hashJoin(
+              {"c0"},
+              {"u_c0"},
+              PlanBuilder(planNodeIdGenerator).values(buildVectors).planNode(),
+              "",
+              {"c1"},
+              core::JoinType::kLeftSemiFilter)
+          .capturePlanNodeId(joinNodeId)
+          .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .assertResults(
+                      "SELECT t.c1 FROM t WHERE t.c0 IN (SELECT u_c0 FROM u)");
+  const auto stats = toPlanStats(task->taskStats()).at(joinNodeId);
+  ASSERT_LT(stats.peakMemoryBytes, 2 << 20);
+}
+
 TEST_F(HashJoinTest, semiProject) {
   // Some keys have multiple rows: 2, 3, 5.
   auto probeVectors = makeBatches(3, [&](int32_t /*unused*/) {
@@ -4184,6 +4263,242 @@ TEST_F(HashJoinTest, dynamicFiltersWithSkippedSplits) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 5;
+  const int32_t numRowsProbe = 10'000;
+  // More distinct keys than VectorHasher tracks, so that no exact IN-list
+  // filter can be made.
+  const int32_t numRowsBuild = 120'000;
+  constexpr int64_t kSpacing = 1'000'003;
+
+  // Every 10th probe row has a match.
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  for (int32_t i = 0; i < numSplits; ++i) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsProbe,
+            [&](auto row) {
+              return (i * numRowsProbe + row) * kSpacing + (row % 10 != 0);
+            }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    probeVectors.push_back(rowVector);
+    tempFiles.push_back(TempFilePath::create());
+    writeToFile(tempFiles.back()->path, rowVector);
+  }
+  auto makeInputSplits = [&](const core::PlanNodeId& nodeId) {
+    return [&] {
+      std::vector<exec::Split> probeSplits;
+      for (auto& file : tempFiles) {
+        probeSplits.push_back(exec::Split(makeHiveConnectorSplit(file->path)));
+      }
+      SplitInput splits;
+      splits.emplace(nodeId, probeSplits);
+      return splits;
+    };
+  };
+
+  std::vector<RowVectorPtr> buildVectors;
+  for (int32_t i = 0; i < 6; ++i) {
+    buildVectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsBuild / 6,
+            [&](auto row) { return (i * numRowsBuild / 6 + row) * kSpacing; }),
+        makeFlatVector<int64_t>(numRowsBuild / 6, [](auto row) { return row; }),
+    }));
+  }
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator, pool_.get())
+                       .values(buildVectors)
+                       .project({"c0 AS u_c0", "c1 AS u_c1"})
+                       .planNode();
+
+  for (const bool enabled : {false, true}) {
+    SCOPED_TRACE(fmt::format("enabled:{}", enabled));
+    core::PlanNodeId probeScanId;
+    auto op = PlanBuilder(planNodeIdGenerator, pool_.get())
+                  .tableScan(probeType)
+                  .capturePlanNodeId(probeScanId)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      buildSide,
+                      "",
+                      {"c0", "c1", "u_c1"},
+                      core::JoinType::kInner)
+                  .project({"c0", "c1 + u_c1"})
+                  .planNode();
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .planNode(std::move(op))
+        .makeInputSplits(makeInputSplits(probeScanId))
+        .config(
+            core::QueryConfig::kHashProbeBloomFilterPushdownMaxSize,
+            enabled ? "1000000" : "0")
+        .referenceQuery("SELECT t.c0, t.c1 + u.c1 FROM t, u WHERE t.c0 = u.c0")
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+          if (hasSpill || !enabled) {
+            ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(getInputPositions(task, 1), numRowsProbe * numSplits);
+          } else {
+            ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+            // A Bloom filter is not exact and cannot replace the join.
+            ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+            ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+          }
+        })
+        .run();
+  }
+}
+
+TEST_F(HashJoinTest, hashTableCache) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_hash_table_cache_bytes = 64 << 20;
+  auto* cache = HashTableCache::instance();
+  ASSERT_NE(cache, nullptr);
+  cache->clear();
+  const auto initialStats = cache->stats();
+
+  std::vector<RowVectorPtr> probeVectors =
+      makeBatches(5, [&](int32_t /*unused*/) {
+        return makeRowVector(
+            {makeFlatVector<int32_t>(1'000, [](auto row) { return row % 23; }),
+             makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+      });
+  std::vector<RowVectorPtr> buildVectors =
+      makeBatches(3, [&](int32_t batch) {
+        return makeRowVector(
+            {"u_c0", "u_c1"},
+            {makeFlatVector<int32_t>(100, [](auto row) { return row % 31; }),
+             makeFlatVector<int64_t>(
+                 100, [batch](auto row) { return batch * 100 + row; })});
+      });
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  // The plans of the queries get different plan node ids.
+  auto makePlan = [&](int32_t numSkippedIds, core::PlanNodeId& joinNodeId) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    for (auto i = 0; i < numSkippedIds; ++i) {
+      planNodeIdGenerator->next();
+    }
+    return PlanBuilder(planNodeIdGenerator)
+        .values(probeVectors)
+        .hashJoin(
+            {"c0"},
+            {"u_c0"},
+            PlanBuilder(planNodeIdGenerator).values(buildVectors).planNode(),
+            "",
+            {"c1", "u_c1"})
+        .capturePlanNodeId(joinNodeId)
+        .planNode();
+  };
+
+  struct {
+    std::string inputVersion;
+    bool expectHit;
+  } testSettings[] = {{"1", false}, {"1", true}, {"2", false}, {"", false}};
+  for (auto i = 0; i < std::size(testSettings); ++i) {
+    const auto& testData = testSettings[i];
+    SCOPED_TRACE(fmt::format("query {}", i));
+    core::PlanNodeId joinNodeId;
+    auto task =
+        AssertQueryBuilder(makePlan(i, joinNodeId), duckDbQueryRunner_)
+            .maxDrivers(2)
+            .config(
+                core::QueryConfig::kHashTableCacheInputVersion,
+                testData.inputVersion)
+            .assertResults("SELECT t.c1, u.u_c1 FROM t, u WHERE t.c0 = u.u_c0");
+    const auto stats = toPlanStats(task->taskStats()).at(joinNodeId);
+    ASSERT_EQ(
+        stats.customStats.count("hashTableCacheHits"),
+        testData.expectHit ? 1 : 0);
+  }
+
+  const auto stats = cache->stats();
+  ASSERT_EQ(stats.numEntries, 2);
+  ASSERT_EQ(stats.numHits - initialStats.numHits, 1);
+  ASSERT_GT(stats.bytes, 0);
+  cache->clear();
+}
+
+TEST_F(HashJoinTest, swapSides) {
+  std::vector<RowVectorPtr> probeVectors = {makeRowVector(
+      {makeFlatVector<int32_t>(100, [](auto row) { return row % 7; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return row; })})};
+  std::vector<RowVectorPtr> buildVectors =
+      makeBatches(10, [&](int32_t batch) {
+        return makeRowVector(
+            {"u_c0", "u_c1"},
+            {makeFlatVector<int32_t>(1'000, [](auto row) { return row % 31; }),
+             makeFlatVector<int64_t>(
+                 1'000, [batch](auto row) { return batch * 1'000 + row; })});
+      });
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  core::PlanNodeId joinNodeId;
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values(probeVectors)
+          .hashJoin(
+              {"c0"},
+              {"u_c0"},
+              PlanBuilder(planNodeIdGenerator).values(buildVectors).planNode(),
+              "",
+              {"c1", "u_c0", "u_c1"})
+          .capturePlanNodeId(joinNodeId)
+          .planNode();
+
+  // The build side waits for all the probe input to be buffered.
+  folly::EventCount probeWait;
+  std::atomic<bool> probeBuffered{false};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::HashProbe::setProbeInput",
+      std::function<void(Operator*)>([&](Operator* /*unused*/) {
+        probeBuffered = true;
+        probeWait.notifyAll();
+      }));
+  std::atomic<int> numBuildInputs{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::addInput",
+      std::function<void(Operator*)>([&](Operator* op) {
+        if (op->operatorType() != "HashBuild" || ++numBuildInputs != 2) {
+          return;
+        }
+        probeWait.await([&]() { return probeBuffered.load(); });
+      }));
+
+  struct {
+    uint64_t probeBufferBytes;
+    bool expectSwap;
+  } testSettings[] = {{1 << 20, true}, {1, false}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(fmt::format("probeBufferBytes {}", testData.probeBufferBytes));
+    numBuildInputs = 0;
+    probeBuffered = !testData.expectSwap;
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(
+                core::QueryConfig::kHashJoinSwapProbeBufferBytes,
+                std::to_string(testData.probeBufferBytes))
+            .assertResults(
+                "SELECT t.c1, u.u_c0, u.u_c1 FROM t, u WHERE t.c0 = u.u_c0");
+    const auto stats = toPlanStats(task->taskStats()).at(joinNodeId);
+    ASSERT_EQ(
+        stats.customStats.count("swappedJoinSides"),
+        testData.expectSwap ? 1 : 0);
+  }
+}
+
 // Verify the size of the join output vectors when projecting build-side
 // variable-width column.
 TEST_F(HashJoinTest, memoryUsage) {
@@ -4569,6 +4884,107 @@ DEBUG_ONLY_TEST_F(HashJoinTest, reclaimDuringInputProcessing) {
   }
 }
 
+DEBUG_ONLY_TEST_F(HashJoinTest, hybridReclaimDuringInputProcessing) {
+  constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
+  VectorFuzzer fuzzer({.vectorSize = 1000}, pool());
+  const int32_t numBuildVectors = 10;
+  std::vector<RowVectorPtr> buildVectors;
+  for (int32_t i = 0; i < numBuildVectors; ++i) {
+    buildVectors.push_back(fuzzer.fuzzRow(buildType_));
+  }
+  const int32_t numProbeVectors = 5;
+  std::vector<RowVectorPtr> probeVectors;
+  for (int32_t i = 0; i < numProbeVectors; ++i) {
+    probeVectors.push_back(fuzzer.fuzzRow(probeType_));
+  }
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto queryPool = memory::defaultMemoryManager().addRootPool("", kMaxBytes);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors, false)
+                  .hashJoin(
+                      {"t_k1"},
+                      {"u_k1"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors, false)
+                          .planNode(),
+                      "",
+                      concat(probeType_->names(), buildType_->names()))
+                  .planNode();
+
+  folly::EventCount driverWait;
+  auto driverWaitKey = driverWait.prepareWait();
+  folly::EventCount testWait;
+  auto testWaitKey = testWait.prepareWait();
+
+  std::atomic<int> numInputs{0};
+  Operator* op;
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::addInput",
+      std::function<void(Operator*)>(([&](Operator* testOp) {
+        if (testOp->operatorType() != "HashBuild") {
+          return;
+        }
+        op = testOp;
+        if (++numInputs != 2) {
+          return;
+        }
+        testWait.notify();
+        driverWait.wait(driverWaitKey);
+      })));
+
+  std::thread taskThread([&]() {
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(numDrivers_)
+        .planNode(plan)
+        .queryPool(std::move(queryPool))
+        .injectSpill(false)
+        .spillDirectory(tempDirectory->path)
+        .config(core::QueryConfig::kJoinSpillHybridReclaimEnabled, "true")
+        .referenceQuery(
+            "SELECT t_k1, t_k2, t_v1, u_k1, u_k2, u_v1 FROM t, u WHERE t.t_k1 = u.u_k1")
+        .verifier([&](const std::shared_ptr<Task>& task, bool /*unused*/) {
+          // Only the largest partition stays spilled. The rows of the other
+          // partitions are read back into memory.
+          int64_t restoredRows{0};
+          for (const auto& pipeline : task->taskStats().pipelineStats) {
+            for (const auto& opStats : pipeline.operatorStats) {
+              if (opStats.operatorType == "HashBuild" &&
+                  opStats.runtimeStats.count("restoredResidentRows") != 0) {
+                restoredRows +=
+                    opStats.runtimeStats.at("restoredResidentRows").sum;
+              }
+            }
+          }
+          ASSERT_GT(restoredRows, 0);
+          ASSERT_LT(restoredRows, numBuildVectors * 1000);
+        })
+        .run();
+  });
+
+  testWait.wait(testWaitKey);
+  ASSERT_TRUE(op != nullptr);
+  auto task = op->testingOperatorCtx()->task();
+  auto taskPauseWait = task->requestPause();
+  driverWait.notify();
+  taskPauseWait.wait();
+
+  // Asks to free a single byte which is covered by the largest partition. All
+  // the rows are spilled to free the memory right away.
+  op->reclaim(1);
+  ASSERT_EQ(op->pool()->currentBytes(), 0);
+
+  Task::resume(task);
+  task.reset();
+
+  taskThread.join();
+}
+
 DEBUG_ONLY_TEST_F(HashJoinTest, reclaimDuringReserve) {
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
   const int32_t numBuildVectors = 3;
@@ -4685,6 +5101,103 @@ DEBUG_ONLY_TEST_F(HashJoinTest, reclaimDuringReserve) {
   taskThread.join();
 }
 
+DEBUG_ONLY_TEST_F(HashJoinTest, reclaimFromBlockedProbe) {
+  constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
+  VectorFuzzer fuzzer({.vectorSize = 1000}, pool());
+  std::vector<RowVectorPtr> buildVectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    buildVectors.push_back(fuzzer.fuzzRow(buildType_));
+  }
+  std::vector<RowVectorPtr> probeVectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    probeVectors.push_back(fuzzer.fuzzRow(probeType_));
+  }
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto queryPool = memory::defaultMemoryManager().addRootPool("", kMaxBytes);
+  core::PlanNodeId joinNodeId;
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors, false)
+                  .hashJoin(
+                      {"t_k1"},
+                      {"u_k1"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors, false)
+                          .planNode(),
+                      "",
+                      concat(probeType_->names(), buildType_->names()))
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+
+  folly::EventCount driverWait;
+  auto driverWaitKey = driverWait.prepareWait();
+  folly::EventCount testWait;
+  auto testWaitKey = testWait.prepareWait();
+
+  // Blocks the hash build on its first input so that the hash probe operators
+  // wait for the hash table.
+  std::atomic<Operator*> probeOp{nullptr};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal",
+      std::function<void(Driver*)>(([&](Driver* driver) {
+        auto* op = driver->findOperator(joinNodeId);
+        if (op != nullptr && op->operatorType() == "HashProbe") {
+          // Not reclaimable while running on its driver thread.
+          ASSERT_FALSE(op->canReclaim());
+          probeOp = op;
+        }
+      })));
+  std::atomic<bool> blockOnce{true};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::addInput",
+      std::function<void(Operator*)>(([&](Operator* testOp) {
+        if (testOp->operatorType() != "HashBuild" ||
+            !blockOnce.exchange(false)) {
+          return;
+        }
+        auto* driver = testOp->testingOperatorCtx()->driver();
+        SuspendedSection suspendedSection(driver);
+        testWait.notify();
+        driverWait.wait(driverWaitKey);
+      })));
+
+  std::thread taskThread([&]() {
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(numDrivers_)
+        .planNode(plan)
+        .queryPool(std::move(queryPool))
+        .injectSpill(false)
+        .referenceQuery(
+            "SELECT t_k1, t_k2, t_v1, u_k1, u_k2, u_v1 FROM t, u WHERE t.t_k1 = u.u_k1")
+        .run();
+  });
+
+  testWait.wait(testWaitKey);
+  while (probeOp == nullptr) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+  }
+  auto task = probeOp.load()->testingOperatorCtx()->task();
+  auto taskPauseWait = task->requestPause();
+  taskPauseWait.wait();
+
+  // The hash probe is blocked waiting for the hash table after the pause.
+  Operator* op = probeOp;
+  ASSERT_TRUE(op->canReclaim());
+  uint64_t reclaimableBytes{0};
+  ASSERT_TRUE(op->reclaimableBytes(reclaimableBytes));
+  op->reclaim(0);
+  ASSERT_EQ(op->pool()->currentBytes(), 0);
+
+  driverWait.notify();
+  Task::resume(task);
+  task.reset();
+
+  taskThread.join();
+}
+
 DEBUG_ONLY_TEST_F(HashJoinTest, reclaimDuringAllocation) {
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
   VectorFuzzer fuzzer({.vectorSize = 1000}, pool());
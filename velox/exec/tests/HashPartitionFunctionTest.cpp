@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/HashPartitionFunction.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/core/ITypedExpr.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
@@ -154,3 +155,133 @@ TEST_F(HashPartitionFunctionTest, spec) {
     ASSERT_EQ(hashSpec->toString(), copy->toString());
   }
 }
+
+TEST_F(HashPartitionFunctionTest, skewedKeys) {
+  const int numRows = 1'000;
+  const int numPartitions = 8;
+  // Every other row has key 7 or key 11. The other rows have distinct keys.
+  RowVectorPtr vector = makeRowVector(
+      {makeFlatVector<int64_t>(
+           numRows,
+           [](auto row) {
+             if (row % 2 == 1) {
+               return static_cast<int64_t>(row) + 1'000;
+             }
+             return static_cast<int64_t>(row % 4 == 0 ? 7 : 11);
+           }),
+       makeFlatVector<int32_t>(numRows, [](auto row) { return row; })});
+  RowTypePtr rowType = asRowType(vector->type());
+  const std::vector<VectorPtr> skewedKeys{makeFlatVector<int64_t>({7, 11})};
+
+  std::vector<uint32_t> expected;
+  HashPartitionFunction function(numPartitions, rowType, {0});
+  function.partition(*vector, expected);
+
+  {
+    std::vector<uint32_t> partitions;
+    HashPartitionFunction spread(
+        numPartitions,
+        rowType,
+        {0},
+        {},
+        HashPartitionFunction::SkewMode::kSpread,
+        skewedKeys);
+    spread.partition(*vector, partitions);
+    std::vector<int32_t> skewedRowCounts(numPartitions, 0);
+    for (auto i = 0; i < numRows; ++i) {
+      if (i % 2 == 0) {
+        ASSERT_LT(partitions[i], numPartitions);
+        ++skewedRowCounts[partitions[i]];
+      } else {
+        ASSERT_EQ(expected[i], partitions[i]);
+      }
+    }
+    // The skewed rows are spread evenly over all partitions.
+    for (auto count : skewedRowCounts) {
+      ASSERT_GE(count, numRows / 2 / numPartitions);
+      ASSERT_LE(count, numRows / 2 / numPartitions + 1);
+    }
+  }
+
+  {
+    std::vector<uint32_t> partitions;
+    HashPartitionFunction replicate(
+        numPartitions,
+        rowType,
+        {0},
+        {},
+        HashPartitionFunction::SkewMode::kReplicate,
+        skewedKeys);
+    replicate.partition(*vector, partitions);
+    for (auto i = 0; i < numRows; ++i) {
+      if (i % 2 == 0) {
+        ASSERT_EQ(core::PartitionFunction::kAllPartitions, partitions[i]);
+      } else {
+        ASSERT_EQ(expected[i], partitions[i]);
+      }
+    }
+  }
+
+  // Skewed keys on multiple columns match only on all columns.
+  {
+    std::vector<uint32_t> partitions;
+    HashPartitionFunction replicate(
+        numPartitions,
+        rowType,
+        {0, 1},
+        {},
+        HashPartitionFunction::SkewMode::kReplicate,
+        {makeFlatVector<int64_t>({7, 7}), makeFlatVector<int32_t>({4, 5})});
+    replicate.partition(*vector, partitions);
+    for (auto i = 0; i < numRows; ++i) {
+      ASSERT_EQ(
+          i == 4, partitions[i] == core::PartitionFunction::kAllPartitions);
+    }
+  }
+
+  VELOX_ASSERT_THROW(
+      HashPartitionFunction(
+          numPartitions,
+          rowType,
+          {0, 1},
+          {},
+          HashPartitionFunction::SkewMode::kSpread,
+          skewedKeys),
+      "Skewed keys must have one vector per partition key");
+}
+
+TEST_F(HashPartitionFunctionTest, skewedKeysSpec) {
+  Type::registerSerDe();
+  core::ITypedExpr::registerSerDe();
+
+  RowTypePtr inputType(ROW({"c0", "c1"}, {BIGINT(), VARCHAR()}));
+  auto hashSpec = std::make_unique<exec::HashPartitionFunctionSpec>(
+      inputType,
+      std::vector<column_index_t>{0, 1},
+      std::vector<VectorPtr>{},
+      HashPartitionFunction::SkewMode::kReplicate,
+      std::vector<VectorPtr>{
+          makeFlatVector<int64_t>({1, 2, 3}),
+          makeFlatVector<std::string>({"a", "b", "c"})});
+  ASSERT_EQ("HASH(c0, c1) REPLICATE(3 skewed keys)", hashSpec->toString());
+
+  auto serialized = hashSpec->serialize();
+  ASSERT_EQ(serialized["skewedKeys"].size(), 2);
+
+  auto copy = HashPartitionFunctionSpec::deserialize(serialized, pool());
+  ASSERT_EQ(hashSpec->toString(), copy->toString());
+
+  // The deserialized spec partitions the same as the original.
+  auto input = makeRowVector(
+      {makeFlatVector<int64_t>({1, 2, 3, 4}),
+       makeFlatVector<std::string>({"a", "b", "x", "d"})});
+  std::vector<uint32_t> partitions;
+  std::vector<uint32_t> copyPartitions;
+  hashSpec->create(4)->partition(*input, partitions);
+  copy->create(4)->partition(*input, copyPartitions);
+  ASSERT_EQ(partitions, copyPartitions);
+  ASSERT_EQ(core::PartitionFunction::kAllPartitions, partitions[0]);
+  ASSERT_EQ(core::PartitionFunction::kAllPartitions, partitions[1]);
+  ASSERT_NE(core::PartitionFunction::kAllPartitions, partitions[2]);
+  ASSERT_NE(core::PartitionFunction::kAllPartitions, partitions[3]);
+}
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -97,3 +98,46 @@ TEST_F(LimitTest, limitOverLocalExchange) {
   ASSERT_EQ(20, numRead);
   ASSERT_TRUE(waitForTaskCompletion(cursor.task().get()));
 }
+
+TEST_F(LimitTest, limitOverTableScan) {
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(1'000, [](auto row) { return row; })});
+
+  constexpr int32_t kNumFiles = 10;
+  std::vector<std::shared_ptr<TempFilePath>> files;
+  for (auto i = 0; i < kNumFiles; ++i) {
+    files.push_back(TempFilePath::create());
+    writeToFile(files.back()->path, {data});
+  }
+
+  core::PlanNodeId scanNodeId;
+
+  // The FilterProject between the scan and the Limit still needs input when
+  // the Limit finishes.
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .tableScan(asRowType(data->type()))
+                        .capturePlanNodeId(scanNodeId)
+                        .filter("c0 >= 0")
+                        .limit(0, 20, false)
+                        .planNode();
+  params.queryConfigs[core::QueryConfig::kPreferredOutputBatchRows] = "100";
+
+  TaskCursor cursor(params);
+  for (const auto& file : files) {
+    cursor.task()->addSplit(
+        scanNodeId, exec::Split(makeHiveConnectorSplit(file->path)));
+  }
+
+  int32_t numRead = 0;
+  while (cursor.moveNext()) {
+    numRead += cursor.current()->size();
+  }
+
+  // Do not send no-more-splits message. The scan stops after the Limit has
+  // finished, in the middle of the first split.
+  ASSERT_EQ(20, numRead);
+  ASSERT_TRUE(waitForTaskCompletion(cursor.task().get()));
+  auto scanStats = toPlanStats(cursor.task()->taskStats()).at(scanNodeId);
+  ASSERT_LT(scanStats.outputRows, data->size());
+}
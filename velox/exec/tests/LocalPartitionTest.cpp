@@ -575,3 +575,56 @@ TEST_F(LocalPartitionTest, unionAllLocalExchange) {
       "   SELECT * FROM (VALUES ('y')) as t2(c0)"
       ")");
 }
+
+TEST_F(LocalPartitionTest, roundRobinWholeVectors) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 6; ++i) {
+    vectors.push_back(
+        makeRowVector({makeFlatSequence<int32_t>(i * 100, 100)}));
+  }
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localPartitionRoundRobin(
+                      {PlanBuilder(planNodeIdGenerator)
+                           .values(vectors)
+                           .planNode()})
+                  .project({"c0 + 1"})
+                  .planNode();
+
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .maxDrivers(3)
+                  .assertResults("SELECT c0 + 1 FROM tmp");
+
+  // Input vectors are passed to the consumers whole.
+  verifyExchangeSourceOperatorStats(task, 600, 6);
+}
+
+TEST_F(LocalPartitionTest, hashSinglePartitionVectors) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(100, [i](auto /*row*/) { return i; }),
+         makeFlatSequence<int32_t>(i * 100, 100)}));
+  }
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localPartition(
+                      {"c0"},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .values(vectors)
+                           .planNode()})
+                  .partialAggregation({"c0"}, {"count(1)", "sum(c1)"})
+                  .planNode();
+
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .maxDrivers(2)
+          .assertResults("SELECT c0, count(1), sum(c1) FROM tmp GROUP BY 1");
+
+  // All rows of a vector have the same key and go to one partition as is.
+  verifyExchangeSourceOperatorStats(task, 300, 3);
+}
@@ -201,6 +201,18 @@ TEST_F(MergeJoinTest, duplicateMatch) {
       [](auto row) { return row / 2; }, [](auto row) { return row / 3; });
 }
 
+TEST_F(MergeJoinTest, longRuns) {
+  // Long runs of rows without a match and of duplicate keys on both sides.
+  testJoin<int64_t>(
+      [](auto row) { return row < 600 ? row : 10'000 + row / 100; },
+      [](auto row) { return row < 300 ? -1 : 10'000 + row / 50; });
+
+  // Same with a key that is not BIGINT.
+  testJoin<int32_t>(
+      [](auto row) { return row / 200 * 3; },
+      [](auto row) { return row / 100 * 5; });
+}
+
 TEST_F(MergeJoinTest, allRowsMatch) {
   std::vector<VectorPtr> leftKeys = {
       makeFlatVector<int32_t>(2, [](auto /* row */) { return 5; }),
@@ -443,6 +455,120 @@ TEST_F(MergeJoinTest, numDrivers) {
   EXPECT_EQ(2, task->numFinishedDrivers());
 }
 
+// Verify that key ranges joined by different split groups produce the same
+// results as a single-threaded join.
+TEST_F(MergeJoinTest, keyRanges) {
+  // Sorted files on each side. The last left file ends with null keys.
+  std::vector<RowVectorPtr> leftVectors;
+  for (auto i = 0; i < 3; ++i) {
+    leftVectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             400,
+             [i](auto row) { return (i * 400 + row) / 2; },
+             [i](auto row) { return i == 2 && row >= 390; }),
+         makeFlatVector<int32_t>(
+             400, [i](auto row) { return i * 400 + row; })}));
+  }
+  std::vector<RowVectorPtr> rightVectors;
+  for (auto i = 0; i < 2; ++i) {
+    rightVectors.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {makeFlatVector<int64_t>(
+             500, [i](auto row) { return 100 + (i * 500 + row) / 3; }),
+         makeFlatVector<int32_t>(
+             500, [i](auto row) { return i * 500 + row; })}));
+  }
+  createDuckDbTable("t", leftVectors);
+  createDuckDbTable("u", rightVectors);
+
+  // Split groups 0 to 3 join keys in (-inf, 150), [150, 300), [300, 450) and
+  // [450, +inf) plus null keys. A file is added to all split groups its keys
+  // overlap.
+  const std::vector<int64_t> boundaries = {150, 300, 450};
+  std::vector<std::shared_ptr<TempFilePath>> files;
+  auto makeSplits = [&](const std::vector<RowVectorPtr>& vectors) {
+    std::vector<exec::Split> splits;
+    for (const auto& vector : vectors) {
+      auto file = TempFilePath::create();
+      writeToFile(file->path, vector);
+      auto keys = vector->childAt(0)->asFlatVector<int64_t>();
+      const auto min = keys->valueAt(0);
+      const auto max = keys->isNullAt(keys->size() - 1)
+          ? std::numeric_limits<int64_t>::max()
+          : keys->valueAt(keys->size() - 1);
+      for (auto group = 0; group <= boundaries.size(); ++group) {
+        if ((group == 0 || max >= boundaries[group - 1]) &&
+            (group == boundaries.size() || min < boundaries[group])) {
+          splits.emplace_back(makeHiveConnectorSplit(file->path), group);
+        }
+      }
+      files.push_back(std::move(file));
+    }
+    return splits;
+  };
+  auto leftSplits = makeSplits(leftVectors);
+  auto rightSplits = makeSplits(rightVectors);
+
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeft}) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId leftScanId;
+    core::PlanNodeId rightScanId;
+    auto plan =
+        PlanBuilder(planNodeIdGenerator)
+            .tableScan(asRowType(leftVectors[0]->type()))
+            .capturePlanNodeId(leftScanId)
+            .mergeJoin(
+                {"c0"},
+                {"u_c0"},
+                PlanBuilder(planNodeIdGenerator)
+                    .tableScan(asRowType(rightVectors[0]->type()))
+                    .capturePlanNodeId(rightScanId)
+                    .planNode(),
+                "",
+                {"c0", "c1", "u_c1"},
+                joinType,
+                {variant(boundaries[0]),
+                 variant(boundaries[1]),
+                 variant(boundaries[2])})
+            .planNode();
+
+    CursorParameters params;
+    params.planNode = plan;
+    params.executionStrategy = core::ExecutionStrategy::kGrouped;
+    params.groupedExecutionLeafNodeIds = {leftScanId, rightScanId};
+    params.numSplitGroups = boundaries.size() + 1;
+    params.numConcurrentSplitGroups = 2;
+
+    bool splitsAdded = false;
+    auto addSplits = [&](exec::Task* task) {
+      if (splitsAdded) {
+        return;
+      }
+      for (const auto& split : leftSplits) {
+        task->addSplit(leftScanId, exec::Split(split));
+      }
+      for (const auto& split : rightSplits) {
+        task->addSplit(rightScanId, exec::Split(split));
+      }
+      for (auto group = 0; group <= boundaries.size(); ++group) {
+        task->noMoreSplitsForGroup(leftScanId, group);
+        task->noMoreSplitsForGroup(rightScanId, group);
+      }
+      task->noMoreSplits(leftScanId);
+      task->noMoreSplits(rightScanId);
+      splitsAdded = true;
+    };
+
+    test::assertQuery(
+        params,
+        addSplits,
+        joinType == core::JoinType::kInner
+            ? "SELECT t.c0, t.c1, u.u_c1 FROM t, u WHERE t.c0 = u.u_c0"
+            : "SELECT t.c0, t.c1, u.u_c1 FROM t LEFT JOIN u ON t.c0 = u.u_c0",
+        duckDbQueryRunner_);
+  }
+}
+
 TEST_F(MergeJoinTest, lazyVectors) {
   // a dataset of multiple row groups with multiple columns. We create
   // different dictionary wrappings for different columns and load the
@@ -182,3 +182,47 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchRows, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+/// Verifies merging of runs of rows from the same source that span input and
+/// output batches.
+TEST_F(MergeTest, clusteredRuns) {
+  // Each source has multiple batches with clusters of consecutive values.
+  std::vector<std::vector<RowVectorPtr>> inputs(3);
+  for (auto i = 0; i < inputs.size(); ++i) {
+    for (auto batch = 0; batch < 4; ++batch) {
+      inputs[i].push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              100,
+              [&](auto row) {
+                const auto n = batch * 100 + row;
+                return (n / 30 * inputs.size() + i) * 30 + n % 30;
+              }),
+          makeFlatVector<int32_t>(100, [&](auto row) { return i; }),
+      }));
+    }
+  }
+
+  std::vector<RowVectorPtr> allInputs;
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  std::vector<core::PlanNodePtr> sources;
+  for (const auto& input : inputs) {
+    allInputs.insert(allInputs.end(), input.begin(), input.end());
+    sources.push_back(
+        PlanBuilder(planNodeIdGenerator).values(input).planNode());
+  }
+  createDuckDbTable(allInputs);
+
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localMerge({"c0"}, std::move(sources))
+                  .planNode();
+
+  for (auto batchSize : {7, 64, 1'000}) {
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    params.queryCtx->testingOverrideConfigUnsafe(
+        {{core::QueryConfig::kPreferredOutputBatchRows,
+          std::to_string(batchSize)}});
+    assertQueryOrdered(params, "SELECT * FROM tmp ORDER BY c0", {0});
+  }
+}
@@ -23,6 +23,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -626,6 +627,46 @@ TEST_F(MultiFragmentTest, limit) {
   ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
 }
 
+// Test that a finished Limit over an Exchange stops the remote source.
+TEST_F(MultiFragmentTest, limitStopsExchange) {
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(1'000, [](auto row) { return row; })});
+  constexpr int32_t kRepeatTimes = 10'000;
+
+  // Make leaf task: Values -> Repartitioning(0). The leaf produces far more
+  // rows than are needed.
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan = PlanBuilder()
+                      .values({data}, false, kRepeatTimes)
+                      .partitionedOutput({}, 1)
+                      .planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  Task::start(leafTask, 1);
+
+  // Make final task: Exchange -> Filter -> FinalLimit(10). The Filter still
+  // needs input when the Limit finishes.
+  core::PlanNodeId exchangeNodeId;
+  auto plan = PlanBuilder()
+                  .exchange(leafPlan->outputType())
+                  .capturePlanNodeId(exchangeNodeId)
+                  .filter("c0 >= 0")
+                  .limit(0, 10, false)
+                  .planNode();
+
+  auto task = assertQuery(
+      plan,
+      {leafTaskId},
+      "VALUES (0), (1), (2), (3), (4), (5), (6), (7), (8), (9)");
+  ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+
+  auto exchangeStats = toPlanStats(task->taskStats()).at(exchangeNodeId);
+  ASSERT_LT(exchangeStats.outputRows, data->size() * kRepeatTimes);
+
+  // The leaf does not need to run to completion.
+  leafTask->requestCancel().wait();
+  ASSERT_FALSE(leafTask->isRunning()) << leafTask->taskId();
+}
+
 TEST_F(MultiFragmentTest, mergeExchangeOverEmptySources) {
   std::vector<std::shared_ptr<Task>> tasks;
   std::vector<std::string> leafTaskIds;
@@ -1345,3 +1386,58 @@ DEBUG_ONLY_TEST_F(MultiFragmentTest, mergeWithEarlyTermination) {
   ASSERT_TRUE(waitForTaskCompletion(partialSortTask.get(), 1'000'000'000));
   ASSERT_TRUE(waitForTaskAborted(finalSortTask.get(), 1'000'000'000));
 }
+
+TEST_F(MultiFragmentTest, compression) {
+  std::vector<RowVectorPtr> vectors;
+  for (int i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000, [i](auto row) { return i * 1'000 + row; }),
+         makeFlatVector<std::string>(1'000, [](auto row) {
+           return fmt::format("value {}", row % 100);
+         })}));
+  }
+  createDuckDbTable(vectors);
+
+  // Make PartitionedOutput flush several pages.
+  configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] = "100";
+  configSettings_[core::QueryConfig::kExchangeCompressionKind] = "lz4";
+  int32_t taskCounter = 0;
+  for (const auto* minCompressionRatio : {"0.8", "0"}) {
+    SCOPED_TRACE(minCompressionRatio);
+    configSettings_[core::QueryConfig::kExchangeMinCompressionRatio] =
+        minCompressionRatio;
+    auto producerPlan =
+        PlanBuilder().values(vectors).partitionedOutput({}, 1).planNode();
+    auto producerTaskId = makeTaskId("producer", taskCounter++);
+    auto producerTask = makeTask(producerTaskId, producerPlan, 0);
+    Task::start(producerTask, 1);
+
+    auto plan = PlanBuilder().exchange(producerPlan->outputType()).planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kExchangeCompressionKind, "lz4")
+        .split(std::make_shared<RemoteConnectorSplit>(producerTaskId))
+        .assertResults("SELECT * FROM tmp");
+    ASSERT_TRUE(waitForTaskCompletion(producerTask.get()));
+
+    const auto stats = producerTask->taskStats()
+                           .pipelineStats[0]
+                           .operatorStats.back()
+                           .runtimeStats;
+    const auto compressedBytes = stats.at("compressedBytes").sum;
+    const auto inputBytes = stats.at("compressionInputBytes").sum;
+    const auto skippedBytes = stats.at("compressionSkippedBytes").sum;
+    if (minCompressionRatio == std::string("0.8")) {
+      ASSERT_GT(compressedBytes, 0);
+      ASSERT_LT(compressedBytes, inputBytes);
+      ASSERT_EQ(0, skippedBytes);
+      ASSERT_EQ(0, stats.count("compressionSkippedPages"));
+    } else {
+      // No page compresses well enough, so compression is skipped for some
+      // of the pages after the first one.
+      ASSERT_EQ(0, compressedBytes);
+      ASSERT_EQ(inputBytes, skippedBytes);
+      ASSERT_GT(stats.at("compressionSkippedPages").sum, 0);
+    }
+  }
+}
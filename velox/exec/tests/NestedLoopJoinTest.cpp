@@ -394,3 +394,47 @@ TEST_F(NestedLoopJoinTest, allTypes) {
       "SELECT t0, u0 FROM t {0} JOIN u ON t.t0 {1} u0 AND t1 {1} u1 AND t2 {1} u2 AND t3 {1} u3 AND t4 {1} u4 AND t5 {1} u5 AND t6 {1} u6");
   runTest(probeVectors, buildVectors);
 }
+
+TEST_F(NestedLoopJoinTest, rangeCondition) {
+  // Ranges of varying width in build vectors larger than a block of the range
+  // index, with null bounds and null probe keys.
+  std::vector<RowVectorPtr> probeVectors;
+  for (auto i = 0; i < 3; ++i) {
+    probeVectors.push_back(makeRowVector(
+        {"t0"},
+        {makeFlatVector<int64_t>(
+            150,
+            [i](auto row) { return (row * 37 + i * 11) % 1'000; },
+            nullEvery(13))}));
+  }
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < 2; ++i) {
+    buildVectors.push_back(makeRowVector(
+        {"u0", "u1"},
+        {makeFlatVector<int64_t>(
+             200,
+             [i](auto row) { return (row * 53 + i * 7) % 1'000; },
+             nullEvery(17)),
+         makeFlatVector<int64_t>(
+             200,
+             [i](auto row) { return (row * 53 + i * 7) % 1'000 + row % 30; },
+             nullEvery(19))}));
+  }
+
+  setProbeType(ROW({"t0"}, {BIGINT()}));
+  setBuildType(ROW({"u0", "u1"}, {BIGINT(), BIGINT()}));
+  setComparisons({"BETWEEN"});
+  setJoinConditionStr("t0 {} u0 AND u1");
+  setQueryStr("SELECT t0, u0 FROM t {} JOIN u ON t0 {} u0 AND u1");
+  runTest(probeVectors, buildVectors);
+
+  setComparisons({"<=", "<"});
+  setJoinConditionStr("u0 {0} t0 AND t0 {0} u1");
+  setQueryStr("SELECT t0, u0 FROM t {0} JOIN u ON u0 {1} t0 AND t0 {1} u1");
+  runTest(probeVectors, buildVectors);
+
+  setComparisons({">=", ">"});
+  setJoinConditionStr("u1 {0} t0 AND t0 {0} u0");
+  setQueryStr("SELECT t0, u0 FROM t {0} JOIN u ON u1 {1} t0 AND t0 {1} u0");
+  runTest(probeVectors, buildVectors, 3);
+}
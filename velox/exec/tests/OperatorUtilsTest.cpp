@@ -278,6 +278,47 @@ TEST_F(OperatorUtilsTest, addOperatorRuntimeStats) {
   ASSERT_EQ(stats[statsName].min, 100);
 }
 
+TEST_F(OperatorUtilsTest, memoryTimeline) {
+  MemoryTimeline timeline;
+  timeline.addSample(0, 100, 10);
+  timeline.addSample(5, 300, 10);
+  timeline.addSample(25, 200, 10);
+  ASSERT_EQ(timeline.bucketMs, 10);
+  ASSERT_EQ(timeline.maxBytes, std::vector<uint64_t>({300, 0, 200}));
+  ASSERT_EQ(timeline.numSamples, 3);
+
+  // A sample past the last bucket merges adjacent buckets until it fits.
+  timeline.addSample(MemoryTimeline::kMaxBuckets * 10, 50, 10);
+  ASSERT_EQ(timeline.bucketMs, 20);
+  ASSERT_EQ(timeline.maxBytes.size(), MemoryTimeline::kMaxBuckets / 2 + 1);
+  ASSERT_EQ(timeline.maxBytes[0], 300);
+  ASSERT_EQ(timeline.maxBytes[1], 200);
+  ASSERT_EQ(timeline.maxBytes.back(), 50);
+
+  // The usages of other Drivers are summed per bucket after bringing both
+  // timelines to the same bucket width.
+  MemoryTimeline other;
+  other.addSample(0, 1'000, 10);
+  other.addSample(15, 2'000, 10);
+  other.addSample(30, 4'000, 10);
+  timeline.add(other);
+  ASSERT_EQ(timeline.bucketMs, 20);
+  ASSERT_EQ(timeline.maxBytes[0], 2'300);
+  ASSERT_EQ(timeline.maxBytes[1], 4'200);
+  ASSERT_EQ(timeline.maxBytes.back(), 50);
+  ASSERT_EQ(timeline.numSamples, 7);
+
+  MemoryTimeline empty;
+  empty.add(timeline);
+  ASSERT_EQ(empty.maxBytes, timeline.maxBytes);
+  timeline.add(MemoryTimeline());
+  ASSERT_EQ(timeline.numSamples, 7);
+
+  timeline.clear();
+  ASSERT_EQ(timeline.bucketMs, 0);
+  ASSERT_TRUE(timeline.maxBytes.empty());
+}
+
 TEST_F(OperatorUtilsTest, initializeRowNumberMapping) {
   BufferPtr mapping;
   auto rawMapping = initializeRowNumberMapping(mapping, 10, pool());
@@ -20,6 +20,7 @@
 #include "velox/common/file/FileSystems.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/core/QueryConfig.h"
+#include "velox/exec/OrderBy.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Spiller.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -466,6 +467,83 @@ TEST_F(OrderByTest, spill) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+TEST_F(OrderByTest, parallelSort) {
+  constexpr int32_t kNumDrivers = 4;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 5; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000,
+             [i](auto row) { return (row * 7 + i * 13) % 997; },
+             nullEvery(17)),
+         makeFlatVector<StringView>(1'000, [](auto row) {
+           return StringView::makeInline(std::to_string(row % 31));
+         })}));
+  }
+  // Each driver of a parallelizable Values node produces all of 'batches'.
+  std::vector<RowVectorPtr> expected;
+  for (int i = 0; i < kNumDrivers; ++i) {
+    expected.insert(expected.end(), batches.begin(), batches.end());
+  }
+  createDuckDbTable(expected);
+
+  core::PlanNodeId orderById;
+  auto plan = PlanBuilder()
+                  .values(batches, true)
+                  .orderBy({"c0 DESC NULLS FIRST", "c1"}, false)
+                  .capturePlanNodeId(orderById)
+                  .planNode();
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  queryCtx->testingOverrideConfigUnsafe({
+      {core::QueryConfig::kOrderByParallelSortEnabled, "true"},
+  });
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = queryCtx;
+  params.maxDrivers = kNumDrivers;
+  auto task = assertQueryOrdered(
+      params, "SELECT * FROM tmp ORDER BY c0 DESC NULLS FIRST, c1", {0, 1});
+  auto orderByStats = toPlanStats(task->taskStats()).at(orderById);
+  EXPECT_EQ(kNumDrivers, orderByStats.numDrivers);
+  EXPECT_EQ(kNumDrivers * 5'000, orderByStats.outputRows);
+}
+
+TEST_F(OrderByTest, timeSlice) {
+  // More rows than fit in one sorted run.
+  const vector_size_t kNumRows = 3 * OrderBy::kSortRunRows + 123;
+  std::vector<RowVectorPtr> batches;
+  for (vector_size_t offset = 0; offset < kNumRows; offset += 10'000) {
+    const auto size = std::min<vector_size_t>(10'000, kNumRows - offset);
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             size,
+             [offset](auto row) { return ((offset + row) * 7919) % 100'003; },
+             nullEvery(23)),
+         makeFlatVector<int32_t>(
+             size, [offset](auto row) { return offset + row; })}));
+  }
+  createDuckDbTable(batches);
+
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .orderBy({"c0 NULLS FIRST", "c1"}, false)
+                  .planNode();
+  // The sort yields between runs and merged batches each time the 1ms time
+  // slice is used up and produces the same result as without a time slice.
+  for (const auto* timeSlice : {"0", "1"}) {
+    SCOPED_TRACE(fmt::format("timeSlice: {}", timeSlice));
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->testingOverrideConfigUnsafe({
+        {core::QueryConfig::kDriverTimeSliceMs, timeSlice},
+    });
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = queryCtx;
+    assertQueryOrdered(
+        params, "SELECT * FROM tmp ORDER BY c0 NULLS FIRST, c1", {0, 1});
+  }
+}
+
 TEST_F(OrderByTest, spillWithMemoryLimit) {
   constexpr int32_t kNumRows = 2000;
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
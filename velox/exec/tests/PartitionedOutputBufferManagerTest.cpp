@@ -593,6 +593,54 @@ TEST_F(PartitionedOutputBufferManagerTest, basicPartitioned) {
   EXPECT_TRUE(task->isFinished());
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, targetPageSizes) {
+  const uint64_t totalBytes = 1 << 20;
+  std::vector<uint64_t> sizes;
+
+  // Without a buffer, the bytes are split evenly.
+  bufferManager_->getTargetPageSizes("unknown", 4, totalBytes, 0, sizes);
+  ASSERT_EQ(sizes, std::vector<uint64_t>(4, totalBytes / 4));
+
+  std::string taskId = "t0";
+  auto task = initializeTask(
+      taskId, rowType_, PartitionedOutputBuffer::Kind::kPartitioned, 4, 1);
+
+  // Nothing is consumed yet.
+  bufferManager_->getTargetPageSizes(taskId, 4, totalBytes, 0, sizes);
+  ASSERT_EQ(sizes, std::vector<uint64_t>(4, totalBytes / 4));
+
+  // Destination 0 consumes three pages and destination 1 one page.
+  for (int i = 0; i < 3; ++i) {
+    enqueue(taskId, 0, rowType_, 100);
+    fetchOneAndAck(taskId, 0, i);
+  }
+  enqueue(taskId, 1, rowType_, 100);
+  fetchOneAndAck(taskId, 1, 0);
+
+  bufferManager_->getTargetPageSizes(taskId, 4, totalBytes, 0, sizes);
+  ASSERT_EQ(sizes.size(), 4);
+  ASSERT_GT(sizes[0], sizes[1]);
+  ASSERT_GT(sizes[1], sizes[2]);
+  ASSERT_EQ(sizes[2], totalBytes / 8);
+  ASSERT_EQ(sizes[3], totalBytes / 8);
+  ASSERT_LE(sizes[0] + sizes[1] + sizes[2] + sizes[3], totalBytes);
+  ASSERT_GE(sizes[0] + sizes[1] + sizes[2] + sizes[3], totalBytes - 4);
+
+  // No size is below the minimum.
+  bufferManager_->getTargetPageSizes(
+      taskId, 4, totalBytes, totalBytes / 2, sizes);
+  ASSERT_EQ(sizes[2], totalBytes / 2);
+  ASSERT_EQ(sizes[3], totalBytes / 2);
+
+  noMoreData(taskId);
+  fetchEndMarker(taskId, 0, 3);
+  fetchEndMarker(taskId, 1, 1);
+  fetchEndMarker(taskId, 2, 0);
+  fetchEndMarker(taskId, 3, 0);
+  bufferManager_->removeTask(taskId);
+  EXPECT_TRUE(task->isFinished());
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, basicBroadcast) {
   vector_size_t size = 100;
 
@@ -248,6 +248,20 @@ TEST_F(PlanNodeSerdeTest, mergeJoin) {
              .planNode();
 
   testSerde(plan);
+
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({probe})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({build}).planNode(),
+                 "",
+                 {"t0", "t1", "u2", "t2"},
+                 core::JoinType::kInner,
+                 {variant(2), variant(3)})
+             .planNode();
+
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, orderBy) {
@@ -399,6 +413,21 @@ TEST_F(PlanNodeSerdeTest, window) {
              .planNode();
 
   testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .streamingWindow({"sum(c0) over (partition by c1 order by c2)"})
+             .planNode();
+
+  testSerde(plan);
+
+  // Plans serialized before 'inputsSorted' was added don't have it.
+  auto serialized = plan->serialize();
+  serialized.erase("inputsSorted");
+  auto copy = std::dynamic_pointer_cast<const core::WindowNode>(
+      velox::ISerializable::deserialize<core::PlanNode>(serialized, pool()));
+  ASSERT_NE(copy, nullptr);
+  ASSERT_FALSE(copy->inputsSorted());
 }
 
 TEST_F(PlanNodeSerdeTest, rowNumber) {
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/RowContainerTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class PrefixSortTest : public exec::test::RowContainerTestBase {
+ protected:
+  using SortKeys = std::vector<std::pair<column_index_t, CompareFlags>>;
+
+  // Stores 'data' in a new container with all columns as keys.
+  std::vector<char*> store(const RowVectorPtr& data) {
+    container_ = makeRowContainer(data->type()->asRow().children(), {});
+    SelectivityVector allRows(data->size());
+    std::vector<char*> rows(data->size());
+    for (auto row = 0; row < data->size(); ++row) {
+      rows[row] = container_->newRow();
+    }
+    for (auto column = 0; column < data->childrenSize(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto row = 0; row < data->size(); ++row) {
+        container_->store(decoded, row, rows[row], column);
+      }
+    }
+    return rows;
+  }
+
+  // Sorts 'data' by 'keys' and checks that every row sorts no lower than the
+  // row before it.
+  void testSort(const RowVectorPtr& data, const SortKeys& keys) {
+    auto rows = store(data);
+    PrefixSort::sort(
+        *container_, keys, folly::Range<char**>(rows.data(), rows.size()));
+    for (auto i = 1; i < rows.size(); ++i) {
+      for (const auto& [column, flags] : keys) {
+        auto result = container_->compare(rows[i - 1], rows[i], column, flags);
+        ASSERT_LE(result, 0) << "at row " << i << ", column " << column;
+        if (result < 0) {
+          break;
+        }
+      }
+    }
+  }
+
+  // Returns 'keys' with every combination of ascending and nulls first.
+  static std::vector<SortKeys> allOrders(
+      const std::vector<column_index_t>& columns) {
+    std::vector<SortKeys> orders;
+    for (auto order = 0; order < 4; ++order) {
+      SortKeys keys;
+      for (auto column : columns) {
+        keys.push_back({column, {(order & 1) != 0, (order & 2) != 0}});
+      }
+      orders.push_back(keys);
+    }
+    return orders;
+  }
+
+  std::unique_ptr<RowContainer> container_;
+};
+
+TEST_F(PrefixSortTest, layout) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>({1}),
+      makeFlatVector<StringView>({"a"}),
+      makeFlatVector<int32_t>({1}),
+      makeArrayVector<int32_t>({{1}}),
+      makeFlatVector<Timestamp>({Timestamp(1, 1)}),
+  });
+  store(data);
+
+  auto layout = PrefixSort::layout(*container_, {{0, {}}, {2, {}}});
+  EXPECT_EQ(2, layout.numEncodedKeys);
+  EXPECT_EQ(2, layout.numCompleteKeys);
+  EXPECT_EQ(14, layout.numPrefixBytes);
+
+  // A string takes the rest of the prefix.
+  layout = PrefixSort::layout(*container_, {{0, {}}, {1, {}}, {2, {}}});
+  EXPECT_EQ(2, layout.numEncodedKeys);
+  EXPECT_EQ(1, layout.numCompleteKeys);
+  EXPECT_EQ(PrefixSort::kMaxPrefixBytes, layout.numPrefixBytes);
+
+  // A complex type ends the prefix.
+  layout = PrefixSort::layout(*container_, {{2, {}}, {3, {}}, {0, {}}});
+  EXPECT_EQ(1, layout.numEncodedKeys);
+  EXPECT_EQ(1, layout.numCompleteKeys);
+  EXPECT_EQ(5, layout.numPrefixBytes);
+
+  layout = PrefixSort::layout(*container_, {{3, {}}, {0, {}}});
+  EXPECT_EQ(0, layout.numEncodedKeys);
+  EXPECT_EQ(0, layout.numPrefixBytes);
+
+  // Keys that do not fit are left to the full comparison.
+  layout = PrefixSort::layout(
+      *container_, {{4, {}}, {0, {}}, {2, {}}, {0, {}}});
+  EXPECT_EQ(3, layout.numEncodedKeys);
+  EXPECT_EQ(3, layout.numCompleteKeys);
+  EXPECT_EQ(27, layout.numPrefixBytes);
+}
+
+TEST_F(PrefixSortTest, integers) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          1'000,
+          [](auto row) { return (row * 7919) % 101 - 50; },
+          nullEvery(7)),
+      makeFlatVector<int32_t>(
+          1'000,
+          [](auto row) {
+            switch (row % 3) {
+              case 0:
+                return std::numeric_limits<int32_t>::min();
+              case 1:
+                return std::numeric_limits<int32_t>::max();
+              default:
+                return row % 11;
+            }
+          },
+          nullEvery(5)),
+      makeFlatVector<int8_t>(1'000, [](auto row) { return row % 256 - 128; }),
+      makeFlatVector<bool>(1'000, [](auto row) { return row % 3 == 0; }),
+  });
+  for (const auto& keys : allOrders({0, 1, 2})) {
+    testSort(data, keys);
+  }
+  for (const auto& keys : allOrders({3, 1, 0})) {
+    testSort(data, keys);
+  }
+}
+
+TEST_F(PrefixSortTest, floatingPoint) {
+  auto nan = std::numeric_limits<double>::quiet_NaN();
+  auto inf = std::numeric_limits<double>::infinity();
+  std::vector<double> values = {
+      nan, -inf, inf, -0.0, 0.0, 1.5, -1.5, -nan, 1e300, -1e-300};
+  auto data = makeRowVector({
+      makeFlatVector<double>(
+          1'000,
+          [&](auto row) { return values[row % values.size()]; },
+          nullEvery(13)),
+      makeFlatVector<float>(
+          1'000, [&](auto row) { return values[(row / 7) % values.size()]; }),
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 17; }),
+  });
+  for (const auto& keys : allOrders({0, 1, 2})) {
+    testSort(data, keys);
+  }
+}
+
+TEST_F(PrefixSortTest, strings) {
+  std::vector<std::string> strings = {
+      "",
+      "a",
+      std::string("a\0", 2),
+      "ab",
+      "\xff",
+      "abcdefghijklmnopqrstuvwxyz0123456789",
+      "abcdefghijklmnopqrstuvwxyz0123456788",
+      "abcdefghijklmnopqrstuvwxyz"};
+  auto data = makeRowVector({
+      makeFlatVector<int16_t>(1'000, [](auto row) { return row % 3; }),
+      makeFlatVector<StringView>(
+          1'000,
+          [&](auto row) { return StringView(strings[row % strings.size()]); },
+          nullEvery(11)),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row % 29; }),
+  });
+  for (const auto& keys : allOrders({0, 1, 2})) {
+    testSort(data, keys);
+  }
+  for (const auto& keys : allOrders({1, 2})) {
+    testSort(data, keys);
+  }
+}
+
+TEST_F(PrefixSortTest, timestampAndDate) {
+  auto data = makeRowVector({
+      makeFlatVector<Timestamp>(
+          1'000,
+          [](auto row) { return Timestamp(row % 5 - 2, (row * 37) % 1'000); },
+          nullEvery(9)),
+      makeFlatVector<Date>(
+          1'000, [](auto row) { return Date(row % 13 - 6); }, nullEvery(4)),
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row; }),
+  });
+  for (const auto& keys : allOrders({0, 1, 2})) {
+    testSort(data, keys);
+  }
+}
+
+TEST_F(PrefixSortTest, complexTypeFallback) {
+  auto data = makeRowVector({
+      makeArrayVector<int32_t>(
+          1'000,
+          [](auto row) { return row % 3; },
+          [](auto row) { return row % 5; }),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7; }),
+  });
+  for (const auto& keys : allOrders({0, 1})) {
+    testSort(data, keys);
+  }
+  for (const auto& keys : allOrders({1, 0})) {
+    testSort(data, keys);
+  }
+}
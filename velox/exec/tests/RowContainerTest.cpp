@@ -677,6 +677,57 @@ TEST_F(RowContainerTest, erase) {
   data->checkConsistency();
 }
 
+TEST_F(RowContainerTest, appendOnlyStrings) {
+  constexpr int32_t kNumRows = 1'000;
+  auto data = makeRowContainer({VARCHAR()}, {VARBINARY()});
+  data->setAppendOnlyStrings();
+  std::string storage;
+  auto keys = makeFlatVector<StringView>(kNumRows, [&](auto row) {
+    storage = std::string(row % 50, 'a' + row % 26);
+    return StringView(storage);
+  });
+  auto dependents = makeFlatVector<StringView>(
+      kNumRows,
+      [&](auto row) {
+        storage = std::string(100 + row % 1'000, 'x');
+        return StringView(storage);
+      },
+      nullEvery(7),
+      VARBINARY());
+  SelectivityVector allRows(kNumRows);
+  DecodedVector decodedKeys(*keys, allRows);
+  DecodedVector decodedDependents(*dependents, allRows);
+  std::vector<char*> rows(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows[i] = data->newRow();
+    data->store(decodedKeys, i, rows[i], 0);
+    data->store(decodedDependents, i, rows[i], 1);
+  }
+  for (auto i = 0; i < kNumRows; ++i) {
+    EXPECT_EQ(0, data->compare(rows[i], data->columnAt(0), decodedKeys, i));
+  }
+  auto result = BaseVector::create(VARCHAR(), kNumRows, pool_.get());
+  data->extractColumn(rows.data(), kNumRows, 0, result);
+  assertEqualVectors(keys, result);
+  result = BaseVector::create(VARBINARY(), kNumRows, pool_.get());
+  data->extractColumn(rows.data(), kNumRows, 1, result);
+  assertEqualVectors(dependents, result);
+
+  // Erased rows keep their strings until clear().
+  std::vector<char*> erased;
+  for (auto i = 0; i < kNumRows; i += 2) {
+    erased.push_back(rows[i]);
+  }
+  const auto retainedSize = data->stringAllocator().retainedSize();
+  data->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  data->checkConsistency();
+  EXPECT_EQ(retainedSize, data->stringAllocator().retainedSize());
+  EXPECT_EQ(0, data->stringAllocator().freeSpace());
+
+  data->clear();
+  EXPECT_EQ(0, data->stringAllocator().retainedSize());
+}
+
 TEST_F(RowContainerTest, initialNulls) {
   std::vector<TypePtr> keys{INTEGER()};
   std::vector<TypePtr> dependent{INTEGER()};
@@ -747,6 +798,61 @@ TEST_F(RowContainerTest, rowSizeWithNormalizedKey) {
   ASSERT_EQ(numRows, 1);
 }
 
+TEST_F(RowContainerTest, booleanDependentsAsBits) {
+  constexpr int32_t kNumBooleans = 12;
+  constexpr int32_t kNumRows = 100;
+  std::vector<TypePtr> dependents(kNumBooleans, BOOLEAN());
+  dependents.push_back(BIGINT());
+  auto data = makeRowContainer({SMALLINT()}, dependents);
+
+  // The layout is expected to be smallint - 6 bytes of padding - 4 bytes of
+  // bits - bigint - next pointer. The bits are 13 null flags, a probed flag, a
+  // free flag and the values of the 12 booleans.
+  EXPECT_EQ(28, data->fixedRowSize());
+  EXPECT_EQ(20, data->nextOffset());
+
+  std::vector<VectorPtr> vectors;
+  vectors.push_back(
+      makeFlatVector<int16_t>(kNumRows, [](auto row) { return row; }));
+  for (auto i = 0; i < kNumBooleans; ++i) {
+    vectors.push_back(makeFlatVector<bool>(
+        kNumRows,
+        [i](auto row) { return (row + i) % 3 == 0; },
+        nullEvery(i + 2)));
+  }
+  vectors.push_back(makeFlatVector<int64_t>(
+      kNumRows, [](auto row) { return row * 11; }, nullEvery(5)));
+
+  SelectivityVector allRows(kNumRows);
+  std::vector<DecodedVector> decoded(vectors.size());
+  std::vector<char*> rows(kNumRows);
+  for (auto row = 0; row < kNumRows; ++row) {
+    rows[row] = data->newRow();
+  }
+  for (auto column = 0; column < vectors.size(); ++column) {
+    decoded[column].decode(*vectors[column], allRows);
+    for (auto row = 0; row < kNumRows; ++row) {
+      data->store(decoded[column], row, rows[row], column);
+    }
+  }
+
+  for (auto column = 0; column < vectors.size(); ++column) {
+    testExtractColumn(*data, rows, column, vectors[column]);
+    for (auto row = 0; row < kNumRows; ++row) {
+      EXPECT_TRUE(data->equals<true>(
+          rows[row], data->columnAt(column), decoded[column], row));
+      EXPECT_EQ(
+          0,
+          data->compare(
+              rows[row],
+              data->columnAt(column),
+              decoded[column],
+              row,
+              CompareFlags()));
+    }
+  }
+}
+
 TEST_F(RowContainerTest, estimateRowSize) {
   auto numRows = 1000;
 
@@ -1053,3 +1159,105 @@ TEST_F(RowContainerTest, probedFlag) {
           {true, true, true, true, std::nullopt, true}),
       result);
 }
+
+TEST_F(RowContainerTest, extractColumns) {
+  const auto rowType = ROW(
+      {"k", "s", "a", "d"}, {BIGINT(), VARCHAR(), ARRAY(INTEGER()), DOUBLE()});
+  auto rowContainer = makeRowContainer(
+      {BIGINT()}, {VARCHAR(), ARRAY(INTEGER()), DOUBLE()});
+  constexpr int32_t kNumRows = 1'000;
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(kNumRows, [](auto row) { return row; }),
+      makeFlatVector<std::string>(
+          kNumRows,
+          [](auto row) { return fmt::format("not an inline string {}", row); },
+          nullEvery(5)),
+      makeArrayVector<int32_t>(
+          kNumRows,
+          [](vector_size_t row) { return row % 3; },
+          [](vector_size_t row, vector_size_t index) { return row + index; }),
+      makeFlatVector<double>(kNumRows, [](auto row) { return row * 0.5; }),
+  });
+
+  std::vector<char*> rows(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows[i] = rowContainer->newRow();
+  }
+  for (auto column = 0; column < input->childrenSize(); ++column) {
+    DecodedVector decoded(*input->childAt(column));
+    for (auto i = 0; i < kNumRows; ++i) {
+      rowContainer->store(decoded, i, rows[i], column);
+    }
+  }
+  std::reverse(rows.begin(), rows.end());
+
+  // Extracts the columns in another order than stored and over more rows than
+  // fit in one batch.
+  std::vector<column_index_t> columns = {3, 1, 0, 2};
+  std::vector<VectorPtr> results;
+  for (auto column : columns) {
+    results.push_back(BaseVector::create(rowType->childAt(column), 1, pool()));
+  }
+  rowContainer->extractColumns(rows.data(), kNumRows, columns, results);
+
+  for (auto i = 0; i < columns.size(); ++i) {
+    auto expected = BaseVector::create(rowType->childAt(columns[i]), 0, pool());
+    rowContainer->extractColumn(rows.data(), kNumRows, columns[i], expected);
+    ASSERT_EQ(kNumRows, results[i]->size());
+    assertEqualVectors(expected, results[i]);
+  }
+}
+
+TEST_F(RowContainerTest, columnCompare) {
+  auto rowContainer =
+      makeRowContainer({BIGINT(), VARCHAR()}, {ARRAY(INTEGER())});
+  auto input = makeRowVector({
+      makeNullableFlatVector<int64_t>({1, 1, std::nullopt, 2, 1}),
+      makeNullableFlatVector<std::string>(
+          {"b", "a long string that is not inlined", "a", std::nullopt, "b"}),
+      makeArrayVector<int32_t>({{1, 2}, {1}, {}, {3}, {1, 2}}),
+  });
+  const auto numRows = input->size();
+  std::vector<char*> rows(numRows);
+  std::vector<DecodedVector> decoded(input->childrenSize());
+  for (auto column = 0; column < input->childrenSize(); ++column) {
+    decoded[column].decode(*input->childAt(column));
+  }
+  for (auto i = 0; i < numRows; ++i) {
+    rows[i] = rowContainer->newRow();
+    for (auto column = 0; column < input->childrenSize(); ++column) {
+      rowContainer->store(decoded[column], i, rows[i], column);
+    }
+  }
+
+  const std::vector<CompareFlags> allFlags = {
+      {true, true}, {true, false}, {false, true}, {false, false}};
+  for (auto column = 0; column < input->childrenSize(); ++column) {
+    auto columnCompare = rowContainer->columnCompare(column);
+    auto decodedCompare = rowContainer->decodedCompare(column);
+    for (const auto& flags : allFlags) {
+      for (auto left = 0; left < numRows; ++left) {
+        for (auto right = 0; right < numRows; ++right) {
+          ASSERT_EQ(
+              rowContainer->compare(rows[left], rows[right], column, flags),
+              columnCompare(
+                  *rowContainer, rows[left], rows[right], column, flags));
+          ASSERT_EQ(
+              rowContainer->compare(
+                  rows[left],
+                  rowContainer->columnAt(column),
+                  decoded[column],
+                  right,
+                  flags),
+              decodedCompare(
+                  *rowContainer,
+                  rows[left],
+                  column,
+                  decoded[column],
+                  right,
+                  flags));
+        }
+      }
+    }
+  }
+}
@@ -13,8 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 namespace facebook::velox::exec::test {
 
@@ -103,4 +106,45 @@ TEST_F(RowNumberTest, largeInput) {
   testLimit(5'000);
 }
 
+TEST_F(RowNumberTest, spill) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row % 17; }, nullEvery(13)),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+    }));
+  }
+  createDuckDbTable(input);
+
+  auto testLimit = [&](std::optional<int32_t> limit) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit.value_or(-1)));
+    core::PlanNodeId rowNumberId;
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .rowNumber({"c0"}, limit)
+                    .capturePlanNodeId(rowNumberId)
+                    .planNode();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kRowNumberSpillEnabled, "true")
+            .spillDirectory(spillDirectory->path)
+            .assertResults(fmt::format(
+                "SELECT * FROM (SELECT *, row_number() over (partition by c0 "
+                "order by c1) as rn FROM tmp) WHERE rn <= {}",
+                limit.value_or(std::numeric_limits<int32_t>::max())));
+    const auto stats = toPlanStats(task->taskStats()).at(rowNumberId);
+    EXPECT_LT(0, stats.spilledBytes);
+    EXPECT_LT(0, stats.spilledPartitions);
+  };
+
+  testLimit(std::nullopt);
+  testLimit(1);
+  testLimit(100);
+}
+
 } // namespace facebook::velox::exec::test
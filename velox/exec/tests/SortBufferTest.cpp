@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortBuffer.h"
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/RowContainerTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class SortBufferTest : public exec::test::RowContainerTestBase {
+ protected:
+  void SetUp() override {
+    RowContainerTestBase::SetUp();
+    tempDirPath_ = exec::test::TempDirectoryPath::create();
+  }
+
+  std::optional<SpillConfig> makeSpillConfig(int32_t testSpillPct) {
+    return SpillConfig(
+        tempDirPath_->path + "/sort",
+        0,
+        0,
+        nullptr,
+        25,
+        HashBitRange(0, 0),
+        0,
+        testSpillPct);
+  }
+
+  // Makes 'numBatches' of 'batchSize' rows with a descending key 'k', a
+  // repeating key 'g' and a string payload.
+  std::vector<RowVectorPtr> makeData(int32_t numBatches, int32_t batchSize) {
+    std::vector<RowVectorPtr> batches;
+    for (auto batch = 0; batch < numBatches; ++batch) {
+      const auto offset = batch * batchSize;
+      batches.push_back(makeRowVector(
+          {"s", "g", "k"},
+          {makeFlatVector<StringView>(
+               batchSize,
+               [&](auto row) {
+                 return StringView::makeInline(
+                     fmt::format("s{}", offset + row));
+               }),
+           makeFlatVector<int32_t>(
+               batchSize, [&](auto row) { return (offset + row) % 7; }),
+           makeFlatVector<int64_t>(batchSize, [&](auto row) {
+             return -(offset + row);
+           })}));
+    }
+    return batches;
+  }
+
+  // Drains 'buffer' and checks that the rows are ordered by 'g' ascending
+  // then 'k' descending and that all 'numRows' come back.
+  void verifyOutput(SortBuffer& buffer, int64_t numRows) {
+    int64_t numOutputRows = 0;
+    std::optional<std::pair<int32_t, int64_t>> previous;
+    while (auto output = buffer.getOutput(333)) {
+      ASSERT_LE(output->size(), 333);
+      auto* g = output->childAt(1)->asFlatVector<int32_t>();
+      auto* k = output->childAt(2)->asFlatVector<int64_t>();
+      auto* s = output->childAt(0)->asFlatVector<StringView>();
+      for (auto row = 0; row < output->size(); ++row) {
+        const std::pair<int32_t, int64_t> current{
+            g->valueAt(row), -k->valueAt(row)};
+        if (previous.has_value()) {
+          ASSERT_LT(previous.value(), current);
+        }
+        ASSERT_EQ(s->valueAt(row).str(), fmt::format("s{}", current.second));
+        previous = current;
+      }
+      numOutputRows += output->size();
+    }
+    ASSERT_EQ(numOutputRows, numRows);
+  }
+
+  const std::vector<column_index_t> sortColumns_{1, 2};
+  const std::vector<CompareFlags> compareFlags_{
+      {true, true, false, false},
+      {true, false, false, false}};
+  std::shared_ptr<exec::test::TempDirectoryPath> tempDirPath_;
+};
+
+TEST_F(SortBufferTest, sort) {
+  auto data = makeData(5, 1'000);
+  auto rowType = asRowType(data[0]->type());
+  SortBuffer buffer(rowType, sortColumns_, compareFlags_, pool_.get());
+  ASSERT_FALSE(buffer.canSpill());
+  for (const auto& batch : data) {
+    buffer.addInput(batch);
+  }
+  ASSERT_EQ(buffer.numInputRows(), 5'000);
+  buffer.noMoreInput();
+  verifyOutput(buffer, 5'000);
+  ASSERT_FALSE(buffer.spilledStats().has_value());
+}
+
+TEST_F(SortBufferTest, empty) {
+  auto rowType = asRowType(makeData(1, 1)[0]->type());
+  SortBuffer buffer(rowType, sortColumns_, compareFlags_, pool_.get());
+  buffer.noMoreInput();
+  ASSERT_EQ(buffer.getOutput(100), nullptr);
+}
+
+TEST_F(SortBufferTest, spill) {
+  auto data = makeData(10, 1'000);
+  auto rowType = asRowType(data[0]->type());
+  SortBuffer buffer(
+      rowType, sortColumns_, compareFlags_, pool_.get(), makeSpillConfig(0));
+  ASSERT_TRUE(buffer.canSpill());
+  for (auto i = 0; i < data.size(); ++i) {
+    buffer.addInput(data[i]);
+    if (i % 3 == 0) {
+      ASSERT_GT(buffer.spillableBytes(), 0);
+      buffer.spill();
+      ASSERT_EQ(buffer.spillableBytes(), 0);
+    }
+  }
+  buffer.noMoreInput();
+  ASSERT_EQ(buffer.spillableBytes(), 0);
+  ASSERT_TRUE(buffer.spilledStats().has_value());
+  ASSERT_EQ(buffer.spilledStats()->spilledRows, 10'000);
+  verifyOutput(buffer, 10'000);
+}
+
+TEST_F(SortBufferTest, testSpill) {
+  auto data = makeData(10, 500);
+  auto rowType = asRowType(data[0]->type());
+  SortBuffer buffer(
+      rowType, sortColumns_, compareFlags_, pool_.get(), makeSpillConfig(100));
+  for (const auto& batch : data) {
+    buffer.addInput(batch);
+  }
+  buffer.noMoreInput();
+  ASSERT_TRUE(buffer.spilledStats().has_value());
+  ASSERT_GT(buffer.spilledStats()->spilledRows, 0);
+  verifyOutput(buffer, 5'000);
+}
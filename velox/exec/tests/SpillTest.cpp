@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
@@ -372,6 +373,145 @@ TEST_F(SpillTest, spillTimestamp) {
   ASSERT_EQ(nullptr, merge->next());
 }
 
+TEST_F(SpillTest, spillCompression) {
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  std::vector<CompareFlags> emptyCompareFlags;
+  const auto input = makeRowVector({
+      makeFlatVector<int64_t>(10'000, [](auto row) { return row / 10; }),
+      makeFlatVector<StringView>(
+          10'000, [](auto /*row*/) { return StringView("spill compression"); }),
+  });
+
+  uint64_t uncompressedBytes{0};
+  for (auto kind :
+       {common::CompressionKind_NONE,
+        common::CompressionKind_LZ4,
+        common::CompressionKind_ZSTD}) {
+    SCOPED_TRACE(common::compressionKindToString(kind));
+    const std::string spillPath = fmt::format(
+        "{}/{}", tempDirectory->path, common::compressionKindToString(kind));
+    SpillState state(spillPath, 1, 1, emptyCompareFlags, kGB, *pool(), kind);
+    ASSERT_EQ(state.compressionKind(), kind);
+    state.setPartitionSpilled(0);
+    state.appendToPartition(0, input);
+    state.finishWrite(0);
+    if (kind == common::CompressionKind_NONE) {
+      uncompressedBytes = state.spilledBytes();
+    } else {
+      ASSERT_LT(state.spilledBytes(), uncompressedBytes);
+    }
+
+    auto merge = state.startMerge(0, nullptr);
+    for (auto i = 0; i < input->size(); ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_TRUE(input->equalValueAt(
+          &stream->current(), i, stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+}
+
+TEST_F(SpillTest, spillAsyncWrite) {
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(2);
+  std::vector<CompareFlags> emptyCompareFlags;
+  constexpr int kNumBatches = 20;
+  constexpr int kNumRowsPerBatch = 1'000;
+
+  // A small target file size makes the file rotation interleave with the
+  // pending writes.
+  for (const int64_t targetFileSize : {kGB, 1'024L}) {
+    SCOPED_TRACE(fmt::format("targetFileSize: {}", targetFileSize));
+    const std::string spillPath =
+        fmt::format("{}/{}", tempDirectory->path, targetFileSize);
+    SpillState state(
+        spillPath,
+        1,
+        1,
+        emptyCompareFlags,
+        targetFileSize,
+        *pool(),
+        common::CompressionKind_NONE,
+        executor.get());
+    state.setPartitionSpilled(0);
+    for (int i = 0; i < kNumBatches; ++i) {
+      state.appendToPartition(
+          0,
+          makeRowVector({makeFlatVector<int64_t>(
+              kNumRowsPerBatch,
+              [&](auto row) { return i * kNumRowsPerBatch + row; })}));
+    }
+    state.finishWrite(0);
+    ASSERT_GT(state.spilledBytes(), kNumBatches * kNumRowsPerBatch * 8);
+    if (targetFileSize == kGB) {
+      ASSERT_EQ(state.spilledFiles(), 1);
+    } else {
+      ASSERT_EQ(state.spilledFiles(), kNumBatches);
+    }
+
+    auto merge = state.startMerge(0, nullptr);
+    for (int64_t i = 0; i < kNumBatches * kNumRowsPerBatch; ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+}
+
+TEST_F(SpillTest, spillReadAhead) {
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(2);
+  std::vector<CompareFlags> emptyCompareFlags;
+  constexpr int kNumFiles = 4;
+  constexpr int kNumBatches = 10;
+  constexpr int kNumRowsPerBatch = 50'000;
+
+  for (int readAheadDepth : {0, 1, 3}) {
+    SCOPED_TRACE(fmt::format("readAheadDepth: {}", readAheadDepth));
+    const std::string spillPath =
+        fmt::format("{}/{}", tempDirectory->path, readAheadDepth);
+    SpillState state(
+        spillPath,
+        1,
+        1,
+        emptyCompareFlags,
+        kGB,
+        *pool(),
+        common::CompressionKind_NONE,
+        executor.get(),
+        readAheadDepth);
+    state.setPartitionSpilled(0);
+    // Each file is a sorted run holding every 'kNumFiles'th value. Each file
+    // is a few MB so that the reads span multiple read buffers.
+    for (int file = 0; file < kNumFiles; ++file) {
+      for (int i = 0; i < kNumBatches; ++i) {
+        state.appendToPartition(
+            0,
+            makeRowVector({makeFlatVector<int64_t>(
+                kNumRowsPerBatch,
+                [&](auto row) {
+                  return (i * kNumRowsPerBatch + row) * kNumFiles + file;
+                })}));
+      }
+      state.finishWrite(0);
+    }
+    ASSERT_EQ(state.spilledFiles(), kNumFiles);
+
+    auto merge = state.startMerge(0, nullptr);
+    for (int64_t i = 0; i < kNumFiles * kNumBatches * kNumRowsPerBatch; ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+}
+
 TEST_F(SpillTest, spillStateWithSmallTargetFileSize) {
   // Set the target file size to a small value to open a new file on each batch
   // write.
@@ -76,7 +76,9 @@ struct TestParamsBuilder {
     return params;
   }
 
-  std::unordered_set<Spiller::Type> typesToExclude{};
+  // NOTE: kRowNumber is tested by the row number operator tests as it spills
+  // both with and without a row container.
+  std::unordered_set<Spiller::Type> typesToExclude{Spiller::Type::kRowNumber};
 };
 
 // Set sequential value in a given child vector. 'value' is the starting value.
@@ -109,7 +111,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
       : param_(param),
         type_(param.type),
         executorPoolSize_(param.poolSize),
-        hashBits_(0, type_ == Spiller::Type::kOrderBy ? 0 : 2),
+        hashBits_(0, isSinglePartition() ? 0 : 2),
         numPartitions_(hashBits_.numPartitions()),
         statWriter_(std::make_unique<TestRuntimeStatWriter>(stats_)) {
     setThreadLocalRunTimeStatWriter(statWriter_.get());
@@ -153,6 +155,12 @@ class SpillerTest : public exec::test::RowContainerTestBase {
   }
 
  protected:
+  bool isSinglePartition() const {
+    return type_ == Spiller::Type::kOrderBy ||
+        type_ == Spiller::Type::kWindow ||
+        type_ == Spiller::Type::kTopNRowNumber;
+  }
+
   void testSortedSpill(
       int32_t spillPct,
       int numDuplicates,
@@ -406,9 +414,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           minSpillRunSize,
           *pool_,
           executor());
-    } else if (type_ == Spiller::Type::kOrderBy) {
-      // We spill 'data' in one partition in type of kOrderBy, otherwise in 4
-      // partitions.
+    } else if (isSinglePartition()) {
+      // We spill 'data' in one partition in type of kOrderBy and kWindow,
+      // otherwise in 4 partitions.
       spiller_ = std::make_unique<Spiller>(
           type_,
           rowContainer_.get(),
@@ -436,7 +444,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           *pool_,
           executor());
     }
-    if (type_ == Spiller::Type::kOrderBy) {
+    if (isSinglePartition()) {
       ASSERT_EQ(spiller_->state().maxPartitions(), 1);
     } else {
       ASSERT_EQ(spiller_->state().maxPartitions(), numPartitions_);
@@ -885,7 +893,9 @@ class NoHashJoin : public SpillerTest,
   static std::vector<TestParam> getTestParams() {
     return TestParamsBuilder{
         .typesToExclude =
-            {Spiller::Type::kHashJoinProbe, Spiller::Type::kHashJoinBuild}}
+            {Spiller::Type::kHashJoinProbe,
+             Spiller::Type::kHashJoinBuild,
+             Spiller::Type::kRowNumber}}
         .getTestParams();
   }
 };
@@ -900,7 +910,10 @@ class NoHashJoinNoOrderBy : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kHashJoinProbe,
              Spiller::Type::kHashJoinBuild,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kWindow,
+             Spiller::Type::kRowNumber,
+             Spiller::Type::kTopNRowNumber}}
         .getTestParams();
   }
 };
@@ -1139,7 +1152,7 @@ TEST_P(NoHashJoin, spillPartition) {
 }
 
 TEST_P(AllTypes, nonSortedSpillFunctions) {
-  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate) {
+  if (isSinglePartition() || type_ == Spiller::Type::kAggregate) {
     setupSpillData(rowType_, numKeys_, 1'000, 1, nullptr, {});
     sortSpillData();
     setupSpiller(100'000, 0, false);
@@ -1221,7 +1234,10 @@ class HashJoinBuildOnly : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kAggregate,
              Spiller::Type::kHashJoinProbe,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kWindow,
+             Spiller::Type::kRowNumber,
+             Spiller::Type::kTopNRowNumber}}
         .getTestParams();
   }
 };
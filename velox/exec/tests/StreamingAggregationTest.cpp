@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/SumNonPODAggregate.h"
@@ -290,3 +292,37 @@ TEST_F(StreamingAggregationTest, partialStreaming) {
 
   testMultiKeyAggregation(keys, {"c0"});
 }
+
+TEST_F(StreamingAggregationTest, partialStreamingFlushBetweenBatches) {
+  // The clustered key changes only between batches. The partial aggregation
+  // flushes its groups before each new value.
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 3; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int32_t>(100, [&](auto /*row*/) { return i; }),
+        makeFlatVector<int32_t>(100, [](auto row) { return row % 7; }),
+    }));
+  }
+  createDuckDbTable(data);
+
+  core::PlanNodeId partialAggId;
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .aggregation(
+                      {"c0", "c1"},
+                      {"c0"},
+                      {"count(1)"},
+                      {},
+                      core::AggregationNode::Step::kPartial,
+                      false)
+                  .capturePlanNodeId(partialAggId)
+                  .finalAggregation()
+                  .planNode();
+
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .assertResults("SELECT c0, c1, count(1) FROM tmp GROUP BY 1, 2");
+  auto stats = toPlanStats(task->taskStats());
+  ASSERT_EQ(3, stats.at(partialAggId).outputVectors);
+  ASSERT_EQ(21, stats.at(partialAggId).outputRows);
+}
@@ -14,12 +14,14 @@
  * limitations under the License.
  */
 #include "velox/exec/TableScan.h"
+#include <folly/ScopeGuard.h>
 #include <velox/type/Timestamp.h>
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/common/tests/utils/DataFiles.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -289,6 +291,38 @@ TEST_F(TableScanTest, partitionKeyAlias) {
   assertQuery(op, split, "SELECT c0, '2021-12-02' FROM tmp");
 }
 
+TEST_F(TableScanTest, partitionKeyFilterSkipsFile) {
+  auto vectors = makeVectors(1, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  ColumnHandleMap assignments = {
+      {"c0", regularColumn("c0", BIGINT())},
+      {"pkey", partitionKey("pkey", VARCHAR())}};
+  auto op = PlanBuilder()
+                .tableScan(
+                    ROW({"c0", "pkey"}, {BIGINT(), VARCHAR()}),
+                    makeTableHandle(singleSubfieldFilter("pkey", equal("b"))),
+                    assignments)
+                .planNode();
+
+  // The files of the splits that fail the filter are not opened, so these
+  // don't need to exist.
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits = {
+      HiveConnectorSplitBuilder("/nonexistent/a")
+          .partitionKey("pkey", "a")
+          .build(),
+      HiveConnectorSplitBuilder("/nonexistent/null")
+          .partitionKey("pkey", std::nullopt)
+          .build(),
+      HiveConnectorSplitBuilder(filePath->path)
+          .partitionKey("pkey", "b")
+          .build()};
+  auto task = assertQuery(op, splits, "SELECT c0, 'b' FROM tmp");
+  EXPECT_EQ(2, getSkippedSplitsStat(task));
+}
+
 TEST_F(TableScanTest, columnPruning) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -769,6 +803,36 @@ TEST_F(TableScanTest, batchSize) {
   }
 }
 
+TEST_F(TableScanTest, adaptiveBatchSize) {
+  // 1% of the rows pass the filter.
+  auto vector = makeRowVector(
+      {makeFlatVector<int64_t>(20'000, [](auto row) { return row % 100; }),
+       makeFlatVector<int64_t>(20'000, [](auto row) { return row; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {vector});
+  createDuckDbTable({vector});
+
+  auto rowType = asRowType(vector->type());
+  auto plan = PlanBuilder().tableScan(rowType, {"c0 = 0"}, {}).planNode();
+  auto outputVectors = [&](bool adaptive) {
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .plan(plan)
+                    .splits(makeHiveConnectorSplits({filePath}))
+                    .config(QueryConfig::kPreferredOutputBatchRows, "1000")
+                    .config(QueryConfig::kMaxOutputBatchRows, "1000")
+                    .config(
+                        QueryConfig::kTableScanAdaptiveBatchSizeEnabled,
+                        adaptive ? "true" : "false")
+                    .assertResults("SELECT * FROM tmp WHERE c0 = 0");
+    return task->taskStats().pipelineStats[0].operatorStats[0].outputVectors;
+  };
+  // Without adaptation each batch of 1000 rows makes an output vector of 10
+  // rows. With adaptation the batches after the first read up to 10 times as
+  // many rows.
+  EXPECT_EQ(20, outputVectors(false));
+  EXPECT_GE(4, outputVectors(true));
+}
+
 // Test that adding the same split with the same sequence id does not cause
 // double read and the 2nd split is ignored.
 TEST_F(TableScanTest, sequentialSplitNoDoubleRead) {
@@ -880,6 +944,23 @@ TEST_F(TableScanTest, multipleSplits) {
   }
 }
 
+TEST_F(TableScanTest, prefetchSplitFiles) {
+  FLAGS_split_file_prefetch_per_driver = 4;
+  SCOPE_EXIT {
+    FLAGS_split_file_prefetch_per_driver = 0;
+  };
+  auto filePaths = makeFilePaths(100);
+  auto vectors = makeVectors(100, 100);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto task = assertQuery(tableScanNode(), filePaths, "SELECT * FROM tmp");
+  auto stats = getTableScanRuntimeStats(task);
+  ASSERT_GT(stats.at("prefetchedSplits").sum, 10);
+}
+
 TEST_F(TableScanTest, waitForSplit) {
   auto filePaths = makeFilePaths(10);
   auto vectors = makeVectors(10, 1'000);
@@ -921,6 +1002,39 @@ TEST_F(TableScanTest, splitOffsetAndLength) {
       "SELECT * FROM tmp LIMIT 0");
 }
 
+TEST_F(TableScanTest, divideSplitAtStripes) {
+  FLAGS_max_sub_splits_per_split = 4;
+  SCOPE_EXIT {
+    FLAGS_max_sub_splits_per_split = 0;
+  };
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  {
+    // Flushes after each vector to write one stripe per vector.
+    dwrf::WriterOptions options;
+    options.schema = vectors[0]->type();
+    auto writerPool = rootPool_->addAggregateChild("divideSplitAtStripes");
+    options.memoryPool = writerPool.get();
+    dwrf::Writer writer{
+        std::make_unique<dwio::common::LocalFileSink>(filePath->path),
+        options};
+    for (const auto& vector : vectors) {
+      writer.write(vector);
+      writer.flush();
+    }
+    writer.close();
+  }
+  createDuckDbTable(vectors);
+
+  auto task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+                  .maxDrivers(4)
+                  .split(makeHiveConnectorSplit(filePath->path))
+                  .assertResults("SELECT * FROM tmp");
+  auto stats = getTableScanRuntimeStats(task);
+  // The sub-splits are not divided again.
+  ASSERT_EQ(stats.at("subSplits").sum, 3);
+}
+
 TEST_F(TableScanTest, fileNotFound) {
   CursorParameters params;
   params.planNode = tableScanNode();
@@ -2213,6 +2327,25 @@ TEST_F(TableScanTest, aggregationPushdown) {
   // 5 aggregates processing 10K rows each via pushdown.
   EXPECT_EQ(5 * 10'000, loadedToValueHook(task, 1));
 
+  op = PlanBuilder()
+           .tableScan(rowType_)
+           .partialAggregation(
+               {"c5"},
+               {"count(c0)",
+                "count(c1)",
+                "count(c2)",
+                "count(c3)",
+                "count(c4)"})
+           .planNode();
+
+  task = assertQuery(
+      op,
+      {filePath},
+      "SELECT c5, count(c0), count(c1), count(c2), count(c3), count(c4) "
+      "FROM tmp group by c5");
+  // 5 aggregates processing 10K rows each via pushdown.
+  EXPECT_EQ(5 * 10'000, loadedToValueHook(task, 1));
+
   // Pushdown should also happen if there is a FilterProject node that doesn't
   // touch columns being aggregated
   op = PlanBuilder()
@@ -2532,3 +2665,62 @@ TEST_F(TableScanTest, parallelPrepare) {
   }
   AssertQueryBuilder(plan).splits(splits).copyResults(pool_.get());
 }
+
+TEST_F(TableScanTest, externalDynamicFilters) {
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+       makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {data});
+
+  core::PlanNodeId scanNodeId;
+  core::PlanNodeId projectNodeId;
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .tableScan(asRowType(data->type()))
+                        .capturePlanNodeId(scanNodeId)
+                        .project({"c0", "c1"})
+                        .capturePlanNodeId(projectNodeId)
+                        .planNode();
+  auto cursor = std::make_unique<TaskCursor>(params);
+  auto task = cursor->task();
+
+  // Filters can only be added to table scans and must refer to a valid
+  // output column.
+  VELOX_ASSERT_THROW(
+      task->addDynamicFilter(
+          projectNodeId,
+          0,
+          std::make_shared<common::BigintRange>(0, 99, false)),
+      "Dynamic filters can be added only to table scan plan nodes");
+  VELOX_ASSERT_THROW(
+      task->addDynamicFilter(
+          scanNodeId, 2, std::make_shared<common::BigintRange>(0, 99, false)),
+      "Dynamic filter channel is out of range");
+
+  // Filters on the same column are combined.
+  task->addDynamicFilter(
+      scanNodeId, 0, std::make_shared<common::BigintRange>(0, 99, false));
+  task->addDynamicFilter(
+      scanNodeId, 0, std::make_shared<common::BigintRange>(50, 1'000, false));
+  EXPECT_EQ(task->numExternalDynamicFilters(), 2);
+
+  task->addSplit(scanNodeId, makeHiveSplit(filePath->path));
+  task->noMoreSplits(scanNodeId);
+
+  int64_t numRows = 0;
+  while (cursor->moveNext()) {
+    auto result = cursor->current()->as<RowVector>();
+    auto c0 = result->childAt(0)->asFlatVector<int64_t>();
+    for (auto i = 0; i < result->size(); ++i) {
+      EXPECT_GE(c0->valueAt(i), 50);
+      EXPECT_LE(c0->valueAt(i), 99);
+    }
+    numRows += result->size();
+  }
+  EXPECT_EQ(numRows, 50);
+
+  auto planStats = toPlanStats(task->taskStats());
+  EXPECT_EQ(
+      planStats.at(scanNodeId).customStats.at("dynamicFiltersAccepted").sum, 2);
+}
@@ -17,6 +17,7 @@
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/dwio/common/WriterFactory.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
@@ -579,6 +580,46 @@ TEST_F(TableWriteTest, maxPartitions) {
       fmt::format("Exceeded limit of {} distinct partitions.", maxPartitions));
 }
 
+TEST_F(TableWriteTest, maxOpenWriters) {
+  const int32_t numPartitions = 20;
+  const int32_t numBatches = 4;
+  const int32_t maxOpenWriters = 5;
+
+  auto rowType = ROW({"c0", "p0"}, {BIGINT(), INTEGER()});
+  std::vector<RowVectorPtr> vectors = makeBatches(numBatches, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             numPartitions * 10,
+             [&](auto row) { return batch * 1'000 + row; }),
+         makeFlatVector<int32_t>(
+             numPartitions * 10,
+             [&](auto row) { return row % numPartitions; })});
+  });
+  createDuckDbTable(vectors);
+
+  auto outputDirectory = TempDirectoryPath::create();
+  auto plan = createInsertPlan(
+      PlanBuilder().values(vectors), rowType, outputDirectory->path, {"p0"});
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .connectorConfig(
+          kHiveConnectorId,
+          HiveConfig::kMaxOpenWriters,
+          folly::to<std::string>(maxOpenWriters))
+      .assertResults("SELECT count(*) FROM tmp");
+
+  // The partitions whose writers were closed get a new file for each batch.
+  const auto numFiles = countRecursiveFiles(outputDirectory->path);
+  EXPECT_GT(numFiles, numPartitions);
+  EXPECT_LE(numFiles, numPartitions * numBatches);
+  EXPECT_EQ(getLeafSubdirectories(outputDirectory->path).size(), numPartitions);
+
+  assertQuery(
+      PlanBuilder().tableScan(ROW({"c0"}, {BIGINT()})).planNode(),
+      makeHiveConnectorSplits(outputDirectory),
+      "SELECT c0 FROM tmp");
+}
+
 // Test TableWriter does not create a file if input is empty.
 TEST_F(TableWriteTest, writeNoFile) {
   auto outputDirectory = TempDirectoryPath::create();
@@ -689,3 +730,86 @@ TEST_F(TableWriteTest, appendToAnExistingUnpartitionedTable) {
         "SELECT * FROM tmp");
   }
 }
+
+TEST_F(TableWriteTest, bucketedSortedWrite) {
+  const int32_t numBuckets = 4;
+  auto rowType = ROW({"c0", "c1", "c2"}, {INTEGER(), BIGINT(), VARCHAR()});
+  std::vector<RowVectorPtr> vectors = makeBatches(5, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int32_t>(
+             1'000, [&](auto row) { return (batch * 1'000 + row) % 97; }),
+         makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return -(batch * 1'000 + row); }),
+         makeFlatVector<StringView>(1'000, [&](auto row) {
+           return StringView::makeInline(fmt::format("str_{}", row));
+         })});
+  });
+  createDuckDbTable(vectors);
+
+  auto bucketProperty = std::make_shared<HiveBucketProperty>(
+      HiveBucketProperty::Kind::kHiveCompatible,
+      numBuckets,
+      std::vector<std::string>{"c0"},
+      std::vector<TypePtr>{INTEGER()},
+      std::vector<std::shared_ptr<const HiveSortingColumn>>{
+          std::make_shared<HiveSortingColumn>(
+              "c1", core::SortOrder{true, true})});
+
+  for (bool spill : {false, true}) {
+    SCOPED_TRACE(fmt::format("spill {}", spill));
+    auto outputDirectory = TempDirectoryPath::create();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .tableWrite(
+                        rowType->names(),
+                        std::make_shared<core::InsertTableHandle>(
+                            kHiveConnectorId,
+                            makeHiveInsertTableHandle(
+                                rowType->names(),
+                                rowType->children(),
+                                {},
+                                makeLocationHandle(outputDirectory->path),
+                                dwio::common::FileFormat::DWRF,
+                                bucketProperty)),
+                        CommitStrategy::kNoCommit,
+                        "rows")
+                    .project({"rows"})
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .spillDirectory(spillDirectory->path)
+        .config(core::QueryConfig::kSpillEnabled, spill ? "true" : "false")
+        .config(core::QueryConfig::kTestingSpillPct, spill ? "100" : "0")
+        .assertResults("SELECT count(*) FROM tmp");
+
+    // One file per bucket named after the bucket, with the rows of the
+    // bucket sorted on 'c1'.
+    const auto files = getRecursiveFiles(outputDirectory->path);
+    ASSERT_EQ(files.size(), numBuckets);
+    connector::hive::HivePartitionFunction bucketFunction(
+        numBuckets, {0, 1, 2, 3}, {0});
+    for (const auto& file : files) {
+      const auto fileName = fs::path(file).filename().string();
+      const auto bucket = folly::to<uint32_t>(fileName.substr(0, 6));
+      auto result = AssertQueryBuilder(
+                        PlanBuilder().tableScan(rowType).planNode())
+                        .split(makeHiveConnectorSplit(file))
+                        .copyResults(pool());
+      ASSERT_GT(result->size(), 0);
+      std::vector<uint32_t> buckets;
+      bucketFunction.partition(*result, buckets);
+      auto* c1 = result->childAt(1)->asFlatVector<int64_t>();
+      for (auto row = 0; row < result->size(); ++row) {
+        ASSERT_EQ(buckets[row], bucket);
+        if (row > 0) {
+          ASSERT_LE(c1->valueAt(row - 1), c1->valueAt(row));
+        }
+      }
+    }
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+  }
+}
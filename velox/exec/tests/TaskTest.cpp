@@ -20,6 +20,8 @@
 #include "velox/common/testutil/TestValue.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/exec/FragmentResultCache.h"
+#include "velox/exec/LocalPlanner.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Values.h"
@@ -536,6 +538,156 @@ TEST_F(TaskTest, singleThreadedExecution) {
   VELOX_ASSERT_THROW(executeSingleThreaded(plan), "division by zero");
 }
 
+TEST_F(TaskTest, fragmentResultCache) {
+  auto* cache = FragmentResultCache::instance();
+  ASSERT_NE(cache, nullptr);
+  cache->clear();
+
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {data});
+
+  core::PlanNodeId scanId;
+  auto plan = PlanBuilder()
+                  .tableScan(asRowType(data->type()))
+                  .capturePlanNodeId(scanId)
+                  .filter("c0 % 10 = 0")
+                  .planFragment();
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row * 10; }),
+  });
+
+  auto run = [&](std::optional<int64_t> modificationTime,
+                 const std::string& timezone = "") {
+    std::unordered_map<std::string, std::string> config{
+        {core::QueryConfig::kFragmentResultCacheEnabled, "true"}};
+    if (!timezone.empty()) {
+      config[core::QueryConfig::kSessionTimezone] = timezone;
+    }
+    auto queryCtx =
+        std::make_shared<core::QueryCtx>(driverExecutor_.get(), config);
+    auto task = Task::create("t0", plan, 0, queryCtx);
+    auto split = std::dynamic_pointer_cast<connector::hive::HiveConnectorSplit>(
+        makeHiveConnectorSplit(filePath->path));
+    split->fileModificationTime = modificationTime;
+    task->addSplit(scanId, exec::Split(std::move(split)));
+    task->noMoreSplits(scanId);
+
+    std::vector<RowVectorPtr> results;
+    while (auto result = task->next()) {
+      results.push_back(result);
+    }
+    ASSERT_TRUE(waitForTaskCompletion(task.get()));
+    assertEqualResults({expected}, results);
+  };
+
+  // The split has no version. The results are not cached.
+  run(std::nullopt);
+  run(std::nullopt);
+  ASSERT_EQ(cache->stats().numEntries, 0);
+  ASSERT_EQ(cache->stats().numHits, 0);
+
+  run(1);
+  ASSERT_EQ(cache->stats().numEntries, 1);
+  ASSERT_EQ(cache->stats().numMisses, 1);
+  run(1);
+  ASSERT_EQ(cache->stats().numHits, 1);
+
+  // The file was modified.
+  run(2);
+  ASSERT_EQ(cache->stats().numEntries, 2);
+  ASSERT_EQ(cache->stats().numMisses, 2);
+  ASSERT_EQ(cache->stats().numHits, 1);
+
+  // A config that may change the results is part of the key.
+  run(2, "America/Los_Angeles");
+  ASSERT_EQ(cache->stats().numEntries, 3);
+  ASSERT_EQ(cache->stats().numMisses, 3);
+  run(2, "America/Los_Angeles");
+  ASSERT_EQ(cache->stats().numHits, 2);
+
+  cache->clear();
+}
+
+TEST_F(TaskTest, localPlannerCache) {
+  LocalPlanner::clearCache();
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto expectedResult = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row + 5; }),
+  });
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .filter("c0 < 100")
+                  .project({"c0 + 5"})
+                  .planFragment();
+
+  const auto stats = LocalPlanner::cacheStats();
+  for (auto i = 0; i < 3; ++i) {
+    auto [task, results] = executeSingleThreaded(plan);
+    assertEqualResults({expectedResult}, results);
+  }
+  // The first task plans the fragment, the others find it in the cache.
+  ASSERT_EQ(LocalPlanner::cacheStats().numMisses, stats.numMisses + 1);
+  ASSERT_EQ(LocalPlanner::cacheStats().numHits, stats.numHits + 2);
+
+  // A different plan with the same shape is planned again.
+  auto otherPlan = PlanBuilder()
+                       .values({data})
+                       .filter("c0 < 100")
+                       .project({"c0 + 5"})
+                       .planFragment();
+  {
+    auto [task, results] = executeSingleThreaded(otherPlan);
+    assertEqualResults({expectedResult}, results);
+  }
+  ASSERT_EQ(LocalPlanner::cacheStats().numMisses, stats.numMisses + 2);
+  LocalPlanner::clearCache();
+}
+
+TEST_F(TaskTest, memoryTimeline) {
+  std::vector<RowVectorPtr> data;
+  for (int32_t i = 0; i < 100; ++i) {
+    data.push_back(makeRowVector({makeFlatVector<int64_t>(
+        10'000, [i](auto row) { return i * 10'000 + row; })}));
+  }
+  core::PlanNodeId aggregationId;
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .singleAggregation({"c0"}, {"count(1)"})
+                  .capturePlanNodeId(aggregationId)
+                  .planFragment();
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      driverExecutor_.get(),
+      std::unordered_map<std::string, std::string>{
+          {core::QueryConfig::kOperatorMemorySampleIntervalMs, "1"}});
+  auto task = Task::create("t0", plan, 0, queryCtx);
+  vector_size_t numRows = 0;
+  while (auto result = task->next()) {
+    numRows += result->size();
+  }
+  ASSERT_EQ(numRows, 1'000'000);
+
+  const auto taskStats = task->taskStats();
+  const auto& operatorStats = taskStats.pipelineStats[0].operatorStats;
+  ASSERT_EQ(operatorStats[1].planNodeId, aggregationId);
+  const auto& timeline = operatorStats[1].memoryTimeline;
+  ASSERT_GT(timeline.numSamples, 1);
+  ASSERT_GT(
+      *std::max_element(timeline.maxBytes.begin(), timeline.maxBytes.end()),
+      0);
+
+  // The aggregation holds the hash table of the 1M groups at the peak.
+  const auto& peak = taskStats.memoryPeak;
+  ASSERT_GT(peak.queryBytes, 0);
+  ASSERT_GE(peak.queryBytes, peak.taskBytes);
+  ASSERT_EQ(peak.nodeBytes.count(aggregationId), 1);
+  ASSERT_LE(peak.nodeBytes.at(aggregationId), peak.taskBytes);
+}
+
 TEST_F(TaskTest, singleThreadedHashJoin) {
   auto left = makeRowVector(
       {"t_c0", "t_c1"},
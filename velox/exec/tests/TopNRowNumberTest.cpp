@@ -13,9 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox::exec::test;
 
@@ -166,5 +168,54 @@ TEST_F(TopNRowNumberTest, manyPartitions) {
   testLimit(100);
 }
 
+TEST_F(TopNRowNumberTest, spill) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeRowVector({
+        // Partitioning key.
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row % 17; }, nullEvery(13)),
+        // Sorting key.
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (5 - i) * 1'000 - row; }),
+        // Data.
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row; }, nullEvery(11)),
+    }));
+  }
+  createDuckDbTable(input);
+
+  auto testLimit = [&](auto limit, bool generateRowNumber) {
+    SCOPED_TRACE(fmt::format(
+        "limit: {}, generateRowNumber: {}", limit, generateRowNumber));
+    core::PlanNodeId topNRowNumberId;
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .topNRowNumber({"c0"}, {"c1"}, limit, generateRowNumber)
+                    .capturePlanNodeId(topNRowNumberId)
+                    .planNode();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kPreferredOutputBatchBytes, "1024")
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kTopNRowNumberSpillEnabled, "true")
+            .spillDirectory(spillDirectory->path)
+            .assertResults(fmt::format(
+                "SELECT {} FROM (SELECT *, row_number() over (partition by c0 "
+                "order by c1) as rn FROM tmp) WHERE rn <= {}",
+                generateRowNumber ? "*" : "c0, c1, c2",
+                limit));
+    const auto stats = toPlanStats(task->taskStats()).at(topNRowNumberId);
+    EXPECT_LT(0, stats.spilledBytes);
+    EXPECT_EQ(1, stats.spilledPartitions);
+  };
+
+  testLimit(1, true);
+  testLimit(5, false);
+  testLimit(100, true);
+}
+
 } // namespace
 } // namespace facebook::velox::exec
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -261,3 +263,38 @@ TEST_F(TopNTest, lowCardinality) {
 
   testTwoKeys(vectors, "c0", "c1", 200);
 }
+
+TEST_F(TopNTest, preFilter) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    // A permutation of 0..9999 spread over the batches.
+    auto c0 = makeFlatVector<int32_t>(batchSize, [&](vector_size_t row) {
+      return (int64_t(batchSize) * i + row) * 7'919 % 10'000;
+    });
+    auto c1 = makeFlatVector<int64_t>(
+        batchSize, [](vector_size_t row) { return row; }, nullEvery(7));
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto& order : {"", " DESC"}) {
+    core::PlanNodeId topNNodeId;
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .plan(PlanBuilder()
+                      .values(vectors)
+                      .topN({fmt::format("c0{}", order)}, 10, false)
+                      .capturePlanNodeId(topNNodeId)
+                      .planNode())
+            .assertResults(
+                fmt::format("SELECT * FROM tmp ORDER BY c0{} LIMIT 10", order));
+    // Most input rows are dropped before the comparator.
+    EXPECT_GT(
+        toPlanStats(task->taskStats())
+            .at(topNNodeId)
+            .customStats.at("preFilteredRows")
+            .sum,
+        5'000);
+  }
+}
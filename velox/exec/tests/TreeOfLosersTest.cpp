@@ -40,6 +40,18 @@ TEST_F(TreeOfLosersTest, merge) {
   testBoth(500, 1);
 }
 
+TEST_F(TreeOfLosersTest, runs) {
+  for (auto numStreams : {1, 2, 17, 32}) {
+    SCOPED_TRACE(fmt::format("numStreams: {}", numStreams));
+    testRuns<TreeOfLosers<TestingStream>>(
+        makeTestData(100'000, numStreams), true);
+    for (auto clusterSize : {1, 7, 1000}) {
+      testRuns<TreeOfLosers<TestingStream>>(
+          makeClusteredTestData(100'000, numStreams, clusterSize), true);
+    }
+  }
+}
+
 TEST_F(TreeOfLosersTest, nextWithEquals) {
   constexpr int32_t kNumStreams = 17;
   std::vector<std::vector<uint32_t>> streams(kNumStreams);
@@ -241,3 +253,94 @@ TEST_F(TreeOfLosersTest, randomWithDuplicates) {
     }
   }
 }
+
+namespace {
+// Stream of descending numbers with a key prefix that is shared by runs of
+// 16 consecutive numbers, so that the merge also falls back to the full
+// comparison on equal prefixes.
+class PrefixStream final : public MergeStream {
+ public:
+  explicit PrefixStream(std::vector<uint32_t>&& numbers)
+      : numbers_(std::move(numbers)) {}
+
+  bool hasData() const final {
+    return !numbers_.empty();
+  }
+
+  uint32_t value() const {
+    return numbers_.back();
+  }
+
+  void pop() {
+    numbers_.pop_back();
+  }
+
+  bool hasKeyPrefix() const final {
+    return true;
+  }
+
+  uint64_t keyPrefix() const final {
+    return integerKeyPrefix(value() >> 4, false, true, true);
+  }
+
+  bool operator<(const MergeStream& other) const final {
+    return value() < static_cast<const PrefixStream&>(other).value();
+  }
+
+  int32_t compare(const MergeStream& other) const final {
+    auto otherValue = static_cast<const PrefixStream&>(other).value();
+    return value() < otherValue ? -1 : value() == otherValue ? 0 : 1;
+  }
+
+ private:
+  std::vector<uint32_t> numbers_;
+};
+} // namespace
+
+TEST_F(TreeOfLosersTest, keyPrefix) {
+  EXPECT_EQ(0, integerKeyPrefix(0, true, true, true));
+  EXPECT_EQ(
+      std::numeric_limits<uint64_t>::max(),
+      integerKeyPrefix(0, true, true, false));
+  EXPECT_LT(
+      integerKeyPrefix(-5, false, true, true),
+      integerKeyPrefix(3, false, true, true));
+  EXPECT_GT(
+      integerKeyPrefix(-5, false, false, true),
+      integerKeyPrefix(3, false, false, true));
+  EXPECT_LT(
+      integerKeyPrefix(std::numeric_limits<int64_t>::max(), false, true, true),
+      integerKeyPrefix(0, true, true, false));
+  EXPECT_GT(
+      integerKeyPrefix(std::numeric_limits<int64_t>::min(), false, true, true),
+      integerKeyPrefix(0, true, true, true));
+
+  constexpr int32_t kNumStreams = 23;
+  constexpr int32_t kNumValues = 100'000;
+  for (bool testNextEqual : {false, true}) {
+    SCOPED_TRACE(fmt::format("testNextEqual: {}", testNextEqual));
+    std::vector<std::vector<uint32_t>> numbers(kNumStreams);
+    for (auto i = kNumValues - 1; i >= 0; --i) {
+      numbers[folly::Random::rand32(kNumStreams, rng_)].push_back(i);
+    }
+    std::vector<std::unique_ptr<PrefixStream>> streams;
+    for (auto& streamNumbers : numbers) {
+      streams.push_back(
+          std::make_unique<PrefixStream>(std::move(streamNumbers)));
+    }
+    TreeOfLosers<PrefixStream> merge(std::move(streams));
+    for (uint32_t i = 0; i < kNumValues; ++i) {
+      PrefixStream* stream;
+      if (testNextEqual) {
+        auto result = merge.nextWithEquals();
+        stream = result.first;
+        ASSERT_FALSE(result.second) << i;
+      } else {
+        stream = merge.next();
+      }
+      ASSERT_TRUE(stream != nullptr) << i;
+      ASSERT_EQ(stream->value(), i);
+      stream->pop();
+    }
+  }
+}
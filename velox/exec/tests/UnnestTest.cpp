@@ -39,6 +39,24 @@ TEST_F(UnnestTest, basicArray) {
   assertQuery(op, "SELECT c0, UNNEST(c1) FROM tmp WHERE c0 % 7 > 0");
 }
 
+TEST_F(UnnestTest, slicedArray) {
+  // The arrays of a slice start at a non-zero offset into the elements. The
+  // elements of the slice are adjacent and are output as a slice as well.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          100,
+          [](auto row) { return row % 5 + 1; },
+          [](auto row, auto index) { return row * 10 + index; }),
+  });
+  auto slice = std::dynamic_pointer_cast<RowVector>(vector->slice(10, 50));
+
+  createDuckDbTable({slice});
+
+  auto op = PlanBuilder().values({slice}).unnest({"c0"}, {"c1"}).planNode();
+  assertQuery(op, "SELECT c0, UNNEST(c1) FROM tmp");
+}
+
 TEST_F(UnnestTest, arrayWithOrdinality) {
   auto array = vectorMaker_.arrayVectorNullable<int32_t>(
       {{{1, 2, std::nullopt, 4}},
@@ -303,6 +303,62 @@ TEST_F(VectorHasherTest, dictionary) {
   }
 }
 
+TEST_F(VectorHasherTest, dictionaryAcrossBatches) {
+  // Batches of dictionaries over the same base reuse the hashes and value
+  // ids of the base values. A batch over another base in between must not
+  // mix up the cached values.
+  const vector_size_t size = 100;
+  auto base = vectorMaker_->flatVector<std::string>(
+      10, [](auto row) { return fmt::format("value number {}", row); });
+  auto otherBase = vectorMaker_->flatVector<std::string>(
+      10, [](auto row) { return fmt::format("other value {}", row); });
+  auto makeBatch = [&](const VectorPtr& values, int32_t step) {
+    return BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        makeIndices(size, [step](auto row) { return (row * step) % 10; }),
+        size,
+        values);
+  };
+  std::vector<VectorPtr> batches = {
+      makeBatch(base, 1),
+      makeBatch(otherBase, 3),
+      makeBatch(base, 3),
+      makeBatch(base, 7)};
+
+  auto hasher = exec::VectorHasher::create(VARCHAR(), 0);
+  raw_vector<uint64_t> hashes(size);
+  for (const auto& batch : batches) {
+    hasher->decode(*batch, allRows_);
+    hasher->hash(allRows_, false, hashes);
+    auto* simple = batch->as<SimpleVector<StringView>>();
+    for (auto i = 0; i < size; ++i) {
+      EXPECT_EQ(hashes[i], folly::hasher<StringView>()(simple->valueAt(i)))
+          << "at " << i;
+    }
+  }
+
+  // The first pass assigns the value ids and fails because the hasher has
+  // no id range yet.
+  raw_vector<uint64_t> ids(size);
+  for (const auto& batch : batches) {
+    hasher->decode(*batch, allRows_);
+    hasher->computeValueIds(allRows_, ids);
+  }
+  hasher->enableValueIds(1, 0);
+
+  std::unordered_map<std::string, uint64_t> valueIds;
+  for (const auto& batch : batches) {
+    hasher->decode(*batch, allRows_);
+    ASSERT_TRUE(hasher->computeValueIds(allRows_, ids));
+    auto* simple = batch->as<SimpleVector<StringView>>();
+    for (auto i = 0; i < size; ++i) {
+      auto it = valueIds.emplace(std::string(simple->valueAt(i)), ids[i]);
+      EXPECT_EQ(it.first->second, ids[i]) << "at " << i;
+    }
+  }
+  EXPECT_EQ(20, valueIds.size());
+}
+
 // Tests how strings are mapped to uint64_t (if they fit) and to
 // consecutive ids of distinct values for the general case.
 TEST_F(VectorHasherTest, stringIds) {
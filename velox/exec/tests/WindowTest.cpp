@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+namespace facebook::velox::exec::test {
+
+class WindowTest : public OperatorTestBase {};
+
+// Many small partitions whose rows are spread over the input batches in no
+// particular order, so that the grouping of rows by partition is exercised.
+TEST_F(WindowTest, manySmallPartitions) {
+  constexpr int32_t kNumBatches = 5;
+  constexpr int32_t kBatchSize = 1'000;
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < kNumBatches; ++i) {
+    input.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            kBatchSize, [&](auto row) { return (row * 7919 + i * 13) % 577; }),
+        makeFlatVector<int64_t>(
+            kBatchSize, [](auto row) { return row % 3; }, nullEvery(11)),
+        makeFlatVector<int64_t>(
+            kBatchSize, [&](auto row) { return row + i * kBatchSize; }),
+        // Unique values in descending order across the batches.
+        makeFlatVector<int64_t>(kBatchSize, [&](auto row) {
+          return kNumBatches * kBatchSize - (row + i * kBatchSize);
+        }),
+    }));
+  }
+  createDuckDbTable(input);
+
+  for (const auto& function :
+       {"sum(c2) over (partition by c0 order by c3)",
+        "count(c2) over (partition by c0, c1 order by c3 rows between "
+        "unbounded preceding and current row)",
+        "min(c3) over (partition by c1, c0)",
+        // A single row per partition.
+        "count(c2) over (partition by c2)"}) {
+    SCOPED_TRACE(function);
+    auto plan = PlanBuilder().values(input).window({function}).planNode();
+    assertQuery(
+        plan, fmt::format("SELECT c0, c1, c2, c3, {} FROM tmp", function));
+  }
+}
+
+} // namespace facebook::velox::exec::test
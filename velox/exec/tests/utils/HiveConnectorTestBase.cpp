@@ -174,7 +174,9 @@ HiveConnectorTestBase::makeHiveInsertTableHandle(
     const std::vector<TypePtr>& tableColumnTypes,
     const std::vector<std::string>& partitionedBy,
     std::shared_ptr<connector::hive::LocationHandle> locationHandle,
-    const dwio::common::FileFormat tableStorageFormat) {
+    const dwio::common::FileFormat tableStorageFormat,
+    std::shared_ptr<const connector::hive::HiveBucketProperty>
+        bucketProperty) {
   std::vector<std::shared_ptr<const connector::hive::HiveColumnHandle>>
       columnHandles;
   for (int i = 0; i < tableColumnNames.size(); ++i) {
@@ -197,7 +199,7 @@ HiveConnectorTestBase::makeHiveInsertTableHandle(
   }
 
   return std::make_shared<connector::hive::HiveInsertTableHandle>(
-      columnHandles, locationHandle, tableStorageFormat);
+      columnHandles, locationHandle, tableStorageFormat, bucketProperty);
 }
 
 std::shared_ptr<connector::hive::HiveColumnHandle>
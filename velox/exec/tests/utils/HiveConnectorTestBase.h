@@ -124,7 +124,9 @@ class HiveConnectorTestBase : public OperatorTestBase {
       const std::vector<std::string>& partitionedBy,
       std::shared_ptr<connector::hive::LocationHandle> locationHandle,
       const dwio::common::FileFormat tableStorageFormat =
-          dwio::common::FileFormat::DWRF);
+          dwio::common::FileFormat::DWRF,
+      std::shared_ptr<const connector::hive::HiveBucketProperty>
+          bucketProperty = nullptr);
 
   static std::shared_ptr<connector::hive::HiveColumnHandle> regularColumn(
       const std::string& name,
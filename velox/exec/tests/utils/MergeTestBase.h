@@ -146,6 +146,31 @@ class MergeTestBase {
     return data;
   }
 
+  // Makes 'numRuns' sorted streams totalling 'numValues' entries. The globally
+  // sorted values are dealt to the streams in turn in clusters of
+  // 'clusterSize' consecutive values, as in pre-clustered inputs.
+  TestData makeClusteredTestData(
+      int32_t numValues,
+      int32_t numRuns,
+      int32_t clusterSize) {
+    TestData data;
+    data.data.reserve(numValues);
+    for (auto i = 0; i < numValues; ++i) {
+      data.data.push_back(folly::Random::rand32(rng_));
+    }
+    std::sort(data.data.begin(), data.data.end());
+
+    std::vector<std::vector<uint32_t>> runs(numRuns);
+    for (auto i = 0; i < numValues; ++i) {
+      runs[(i / clusterSize) % numRuns].push_back(data.data[i]);
+    }
+    for (auto& run : runs) {
+      std::reverse(run.begin(), run.end());
+      data.sources.push_back(std::make_unique<TestingStream>(std::move(run)));
+    }
+    return data;
+  }
+
   // Reads the data in 'testData.runs' using the merging class MergeType. Checks
   // that the results match the globally sorted data in 'testData' if check is
   // true.
@@ -175,6 +200,36 @@ class MergeTestBase {
     }
   }
 
+  // Same as test() but takes a run of values from a stream that is returned
+  // twice in a row, up to the first value of MergeType::runnerUp().
+  template <typename MergeType>
+  static void testRuns(const TestData& testData, bool check) {
+    std::vector<std::unique_ptr<TestingStream>> sources;
+    for (auto& source : testData.sources) {
+      sources.push_back(std::make_unique<TestingStream>(*source));
+    }
+    MergeType merge(std::move(sources));
+    auto expected = testData.data.begin();
+    TestingStream* previous = nullptr;
+    while (auto* source = merge.next()) {
+      const bool takeRun = source == previous;
+      const auto* runnerUp = takeRun ? merge.runnerUp() : nullptr;
+      previous = source;
+      do {
+        if (check) {
+          ASSERT_TRUE(expected != testData.data.end())
+              << "Premature end in merged stream";
+          ASSERT_EQ(source->current()->value(), *expected++);
+        }
+        source->pop();
+      } while (takeRun && source->hasData() &&
+               (!runnerUp || !(*runnerUp < *source)));
+    }
+    if (check) {
+      ASSERT_TRUE(expected == testData.data.end());
+    }
+  }
+
  protected:
   folly::Random::DefaultGenerator rng_;
 };
@@ -551,6 +551,14 @@ PlanBuilder::AggregatesAndNames PlanBuilder::createAggregateExpressionsAndNames(
           aggregate)
     }
 
+    if (untypedExpr.distinct) {
+      VELOX_CHECK(
+          step == core::AggregationNode::Step::kSingle,
+          "Aggregations over distinct inputs cannot be split into partial and final: {}.",
+          aggregate)
+      agg.distinct = true;
+    }
+
     for (const auto& [keyExpr, order] : untypedExpr.orderBy) {
       auto sortingKey =
           std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(
@@ -932,7 +940,8 @@ PlanBuilder& PlanBuilder::mergeJoin(
     const core::PlanNodePtr& build,
     const std::string& filter,
     const std::vector<std::string>& outputLayout,
-    core::JoinType joinType) {
+    core::JoinType joinType,
+    const std::vector<variant>& keyRangeBoundaries) {
   VELOX_CHECK_EQ(leftKeys.size(), rightKeys.size());
 
   auto leftType = planNode_->outputType();
@@ -946,6 +955,13 @@ PlanBuilder& PlanBuilder::mergeJoin(
   auto leftKeyFields = fields(leftType, leftKeys);
   auto rightKeyFields = fields(rightType, rightKeys);
 
+  std::vector<core::ConstantTypedExprPtr> boundaries;
+  boundaries.reserve(keyRangeBoundaries.size());
+  for (const auto& boundary : keyRangeBoundaries) {
+    boundaries.push_back(std::make_shared<core::ConstantTypedExpr>(
+        leftKeyFields[0]->type(), boundary));
+  }
+
   planNode_ = std::make_shared<core::MergeJoinNode>(
       nextPlanNodeId(),
       joinType,
@@ -954,7 +970,8 @@ PlanBuilder& PlanBuilder::mergeJoin(
       std::move(filterExpr),
       std::move(planNode_),
       build,
-      outputType);
+      outputType,
+      std::move(boundaries));
   return *this;
 }
 
@@ -1229,6 +1246,17 @@ bool equalSortOrderList(
 
 PlanBuilder& PlanBuilder::window(
     const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, false);
+}
+
+PlanBuilder& PlanBuilder::streamingWindow(
+    const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, true);
+}
+
+PlanBuilder& PlanBuilder::window(
+    const std::vector<std::string>& windowFunctions,
+    bool inputsSorted) {
   VELOX_CHECK_GT(
       windowFunctions.size(),
       0,
@@ -1309,6 +1337,7 @@ PlanBuilder& PlanBuilder::window(
       sortingOrders,
       windowNames,
       windowNodeFunctions,
+      inputsSorted,
       planNode_);
   return *this;
 }
@@ -611,13 +611,17 @@ class PlanBuilder {
   /// query may produce incorrect results.
   ///
   /// See hashJoin method for the description of the parameters.
+  /// @param keyRangeBoundaries Optional values of the first join key that
+  /// split the key space into ranges joined by different split groups. See
+  /// core::MergeJoinNode.
   PlanBuilder& mergeJoin(
       const std::vector<std::string>& leftKeys,
       const std::vector<std::string>& rightKeys,
       const core::PlanNodePtr& build,
       const std::string& filter,
       const std::vector<std::string>& outputLayout,
-      core::JoinType joinType = core::JoinType::kInner);
+      core::JoinType joinType = core::JoinType::kInner,
+      const std::vector<variant>& keyRangeBoundaries = {});
 
   /// Add a NestedLoopJoinNode to join two inputs using filter as join
   /// condition to perform equal/non-equal join. Only supports inner/outer
@@ -693,6 +697,12 @@ class PlanBuilder {
   ///  rows between a + 10 preceding and 10 following)"
   PlanBuilder& window(const std::vector<std::string>& windowFunctions);
 
+  /// Adds a WindowNode whose input is already sorted by the partition keys
+  /// and the ORDER BY keys common to 'windowFunctions'. The operator outputs
+  /// each partition as soon as it is complete. Takes the same window function
+  /// strings as window().
+  PlanBuilder& streamingWindow(const std::vector<std::string>& windowFunctions);
+
   /// Add a RowNumberNode to compute single row_number window function with an
   /// optional limit and no sorting.
   PlanBuilder& rowNumber(
@@ -801,6 +811,10 @@ class PlanBuilder {
       core::AggregationNode::Step step,
       const core::AggregationNode* partialAggNode);
 
+  PlanBuilder& window(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
   struct AggregatesAndNames {
     std::vector<core::AggregationNode::Aggregate> aggregates;
     std::vector<std::string> names;
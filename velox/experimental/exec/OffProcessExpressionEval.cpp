@@ -16,12 +16,79 @@
 
 #include "velox/experimental/exec/OffProcessExpressionEval.h"
 
+#include <sys/mman.h>
+#include <cstring>
+
+#include <folly/String.h>
+
+#include "velox/common/base/BitUtil.h"
+
 namespace facebook::velox::exec {
 
 // Maximum buffer size in bytes for stream groups before they are
 // flushed.
 constexpr int32_t kMaxStreamGroupSizeBytes{50000};
 
+// Initial capacity of the shared memory for batches. Leaves room for the
+// serialization overhead of a full stream group.
+constexpr uint64_t kInitialSharedMemoryBytes{1 << 20};
+
+SharedMemoryBatch::SharedMemoryBatch(uint64_t capacity) {
+  grow(capacity);
+}
+
+SharedMemoryBatch::~SharedMemoryBatch() {
+  if (data_ != nullptr) {
+    ::munmap(data_, capacity_);
+  }
+}
+
+void SharedMemoryBatch::write(const char* s, std::streamsize count) {
+  if (position_ + count > capacity_) {
+    grow(std::max(capacity_ * 2, position_ + count));
+  }
+  std::memcpy(data_ + position_, s, count);
+  position_ += count;
+  size_ = std::max(size_, position_);
+  if (listener_) {
+    listener_->onWrite(s, count);
+  }
+}
+
+void SharedMemoryBatch::seekp(std::streampos pos) {
+  const uint64_t position = static_cast<std::streamoff>(pos);
+  VELOX_CHECK_LE(position, size_);
+  position_ = position;
+}
+
+void SharedMemoryBatch::setSize(uint64_t size) {
+  VELOX_CHECK_LE(size, capacity_);
+  position_ = size;
+  size_ = size;
+}
+
+void SharedMemoryBatch::grow(uint64_t capacity) {
+  capacity = bits::roundUp(capacity, 4096);
+  auto* data = ::mmap(
+      nullptr,
+      capacity,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS,
+      -1,
+      0);
+  VELOX_CHECK(
+      data != MAP_FAILED,
+      "mmap of {} bytes of shared memory failed with errno {}",
+      capacity,
+      folly::errnoStr(errno));
+  if (data_ != nullptr) {
+    std::memcpy(data, data_, size_);
+    ::munmap(data_, capacity_);
+  }
+  data_ = reinterpret_cast<uint8_t*>(data);
+  capacity_ = capacity;
+}
+
 void OffProcessExpressionEvalNode::addDetails(std::stringstream& stream) const {
   stream << "expressions: ";
   for (auto i = 0; i < expressions_.size(); i++) {
@@ -63,51 +130,58 @@ void OffProcessExpressionEvalOperator::addInput(RowVectorPtr input) {
 
 void OffProcessExpressionEvalOperator::flushStreamGroup() {
   if (streamGroup_) {
-    IOBufOutputStream stream(*pool());
-    streamGroup_->flush(&stream);
+    if (!batch_) {
+      batch_ = std::make_unique<SharedMemoryBatch>(kInitialSharedMemoryBytes);
+    }
+    // The previous result has been returned, so its memory is reused for the
+    // next batch.
+    VELOX_CHECK(!hasResult_);
+    batch_->clear();
+    streamGroup_->flush(batch_.get());
     addRuntimeStat(
         "dataFlushes",
         RuntimeCounter(streamGroup_->size(), RuntimeCounter::Unit::kBytes));
-
-    auto ioBuf = stream.getIOBuf();
     streamGroup_.reset();
 
-    ioBuf_ = sendOffProcess(expressions_, std::move(ioBuf));
+    sendOffProcess(expressions_, *batch_);
+    hasResult_ = true;
   }
 }
 
-std::unique_ptr<folly::IOBuf> OffProcessExpressionEvalOperator::sendOffProcess(
+void OffProcessExpressionEvalOperator::sendOffProcess(
     const std::vector<core::TypedExprPtr>& /* expressions */,
-    std::unique_ptr<folly::IOBuf>&& ioBuf) {
-  // TODO: Implement a pluggable logic to send data off-process.
-  return std::move(ioBuf);
+    SharedMemoryBatch& /* batch */) {
+  // TODO: Implement a pluggable logic to send data off-process. Until then
+  // the input is returned as the result.
 }
 
 void OffProcessExpressionEvalOperator::noMoreInput() {
-  flushStreamGroup();
   Operator::noMoreInput();
+  // A result which is not yet returned holds the shared memory. The rest of
+  // the input is then flushed after the result is returned.
+  if (!hasResult_) {
+    flushStreamGroup();
+  }
 }
 
 RowVectorPtr OffProcessExpressionEvalOperator::getOutput() {
-  if (!ioBuf_) {
+  if (!hasResult_) {
     return nullptr;
   }
 
-  auto outputVector = deserializeIOBuf(*ioBuf_);
-  ioBuf_.reset();
+  auto outputVector = deserializeBatch();
+  hasResult_ = false;
+  if (noMoreInput_) {
+    flushStreamGroup();
+  }
   return outputVector;
 }
 
-RowVectorPtr OffProcessExpressionEvalOperator::deserializeIOBuf(
-    const folly::IOBuf& ioBuf) {
-  std::vector<ByteRange> ranges;
-  ranges.reserve(4);
-
-  for (const auto& range : ioBuf) {
-    ranges.emplace_back(ByteRange{
-        const_cast<uint8_t*>(range.data()), (int32_t)range.size(), 0});
-  }
-  byteStream_.resetInput(std::move(ranges));
+RowVectorPtr OffProcessExpressionEvalOperator::deserializeBatch() {
+  // The result is read in place from the shared memory. The deserialized
+  // vectors copy the values, so the memory can be reused after this.
+  byteStream_.resetInput(
+      {ByteRange{batch_->data(), static_cast<int32_t>(batch_->size()), 0}});
 
   RowVectorPtr outputVector;
   VectorStreamGroup::read(&byteStream_, pool(), outputType_, &outputVector);
@@ -15,7 +15,6 @@
  */
 #pragma once
 
-#include <folly/io/IOBuf.h>
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Operator.h"
 #include "velox/vector/VectorStream.h"
@@ -27,6 +26,61 @@ namespace facebook::velox::exec {
 /// batches and sends them to a remote process along with the expressions
 /// specified in `expressions`.
 
+/// Memory mapped region shared with the remote process, which input batches
+/// are serialized into and results are read from. The mapping is shared, not
+/// private, so that its pages can be seen by a process that shares the
+/// mapping, e.g. a forked child. This is why it doesn't come from MmapArena,
+/// which maps private memory. The region is reused for all the batches of an
+/// operator and grows when a batch doesn't fit. It must not grow while the
+/// remote process is using it.
+class SharedMemoryBatch : public OutputStream {
+ public:
+  explicit SharedMemoryBatch(uint64_t capacity);
+
+  ~SharedMemoryBatch() override;
+
+  void write(const char* s, std::streamsize count) override;
+
+  std::streampos tellp() const override {
+    return position_;
+  }
+
+  void seekp(std::streampos pos) override;
+
+  uint8_t* data() const {
+    return data_;
+  }
+
+  uint64_t size() const {
+    return size_;
+  }
+
+  uint64_t capacity() const {
+    return capacity_;
+  }
+
+  /// Sets the size of the batch, e.g. after the remote process wrote a result
+  /// of 'size' bytes.
+  void setSize(uint64_t size);
+
+  void clear() {
+    position_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  // Maps a region of at least 'capacity' bytes and copies the contents of the
+  // previous region to it.
+  void grow(uint64_t capacity);
+
+  uint8_t* data_{nullptr};
+  uint64_t capacity_{0};
+  // Write position. May be less than 'size_' after seekp().
+  uint64_t position_{0};
+  // Number of bytes written.
+  uint64_t size_{0};
+};
+
 /// Off-process expression eval plan node. `expressions` control the expressions
 /// that will be remotely executed.
 class OffProcessExpressionEvalNode : public core::PlanNode {
@@ -76,7 +130,7 @@ class OffProcessExpressionEvalOperator : public exec::Operator {
   void noMoreInput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    return !noMoreInput_ && !hasResult_;
   }
 
   RowVectorPtr getOutput() override;
@@ -86,27 +140,32 @@ class OffProcessExpressionEvalOperator : public exec::Operator {
   }
 
   bool isFinished() override {
-    return noMoreInput_;
+    return noMoreInput_ && !hasResult_;
   }
 
  private:
-  // Sends the current IOBuf off-process, returning the result IOBuf received
-  // from the remote process.
+  // Sends the batch in 'batch' off-process. The remote process evaluates
+  // 'expressions' and writes the serialized result over the input in 'batch'.
   //
   // TODO: this function will need to return a future.
-  std::unique_ptr<folly::IOBuf> sendOffProcess(
+  void sendOffProcess(
       const std::vector<core::TypedExprPtr>& expressions,
-      std::unique_ptr<folly::IOBuf>&& ioBuf);
+      SharedMemoryBatch& batch);
 
   // Flushes the current stream group contents.
   void flushStreamGroup();
 
-  RowVectorPtr deserializeIOBuf(const folly::IOBuf& ioBuf);
+  RowVectorPtr deserializeBatch();
 
   std::unique_ptr<VectorStreamGroup> streamGroup_;
   ByteStream byteStream_;
 
-  std::unique_ptr<folly::IOBuf> ioBuf_;
+  // Holds the serialized input batch and then the result. Allocated on first
+  // flush.
+  std::unique_ptr<SharedMemoryBatch> batch_;
+
+  // True if 'batch_' holds a result which is not yet returned.
+  bool hasResult_{false};
 
   RowTypePtr inputType_;
   std::vector<core::TypedExprPtr> expressions_;
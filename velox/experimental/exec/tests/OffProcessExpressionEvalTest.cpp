@@ -83,6 +83,52 @@ TEST_F(OffProcessExpressionEvalTest, multipleBatches) {
   exec::test::AssertQueryBuilder(plan).assertResults(inputVectors);
 }
 
+TEST_F(OffProcessExpressionEvalTest, largeBatch) {
+  // A single batch that is larger than the initial shared memory.
+  auto rowVector = vectorMaker_.rowVector({
+      vectorMaker_.flatVector<int64_t>(100'000, [](auto row) { return row; }),
+      vectorMaker_.flatVector<std::string>(
+          100'000,
+          [](auto row) { return fmt::format("string value {}", row); }),
+  });
+
+  auto plan = exec::test::PlanBuilder()
+                  .values({rowVector, rowVector})
+                  .addNode([](std::string id, core::PlanNodePtr input) {
+                    return std::make_shared<OffProcessExpressionEvalNode>(
+                        id, std::vector<core::TypedExprPtr>{}, input);
+                  })
+                  .planNode();
+
+  exec::test::AssertQueryBuilder(plan).assertResults({rowVector, rowVector});
+}
+
+TEST_F(OffProcessExpressionEvalTest, sharedMemoryBatch) {
+  SharedMemoryBatch batch(4096);
+  std::string data(10'000, 'x');
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = 'a' + i % 26;
+  }
+  batch.write(data.data(), 100);
+  batch.write(data.data() + 100, data.size() - 100);
+  ASSERT_EQ(batch.size(), data.size());
+  ASSERT_GE(batch.capacity(), data.size());
+  ASSERT_EQ(
+      std::string(reinterpret_cast<char*>(batch.data()), batch.size()), data);
+
+  // Overwrites in the middle, as the serializer does for headers.
+  batch.seekp(4);
+  batch.write("1234", 4);
+  ASSERT_EQ(static_cast<std::streamoff>(batch.tellp()), 8);
+  ASSERT_EQ(batch.size(), data.size());
+  ASSERT_EQ(std::string(reinterpret_cast<char*>(batch.data()) + 4, 4), "1234");
+  batch.seekp(batch.size());
+  ASSERT_EQ(static_cast<std::streamoff>(batch.tellp()), data.size());
+
+  batch.clear();
+  ASSERT_EQ(batch.size(), 0);
+}
+
 TEST_F(OffProcessExpressionEvalTest, fuzzer) {
   for (size_t i = 0; i < 10; i++) {
     auto randType = VectorFuzzer({}, pool()).randRowType();
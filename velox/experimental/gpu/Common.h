@@ -74,6 +74,17 @@ struct CudaFreeDeleter<T[]> {
   }
 };
 
+template <typename T>
+struct CudaFreeHostDeleter;
+
+template <typename T>
+struct CudaFreeHostDeleter<T[]> {
+  std::enable_if_t<std::is_trivially_destructible_v<T>, void> operator()(
+      T* ptr) const {
+    CUDA_CHECK_LOG(cudaFreeHost(ptr));
+  }
+};
+
 struct CudaEventDestroyDeleter {
   void operator()(cudaEvent_t ptr) const {
     CUDA_CHECK_LOG(cudaEventDestroy(ptr));
@@ -95,6 +106,28 @@ struct CudaStreamDestroyDeleter {
 template <typename T>
 using CudaPtr = std::unique_ptr<T, detail::CudaFreeDeleter<T>>;
 
+/// A unique_ptr to page-locked host memory, which the GPU copies from and to
+/// asynchronously with the CPU.
+template <typename T>
+using CudaHostPtr = std::unique_ptr<T, detail::CudaFreeHostDeleter<T>>;
+
+/// Allocates uninitialized device memory for 'count' elements of 'T'.
+template <typename T>
+CudaPtr<T[]> allocateDevice(size_t count) {
+  T* ptr;
+  CUDA_CHECK_FATAL(cudaMalloc(&ptr, count * sizeof(T)));
+  return CudaPtr<T[]>(ptr);
+}
+
+/// Allocates uninitialized page-locked host memory for 'count' elements of
+/// 'T'.
+template <typename T>
+CudaHostPtr<T[]> allocateHost(size_t count) {
+  T* ptr;
+  CUDA_CHECK_FATAL(cudaMallocHost(&ptr, count * sizeof(T)));
+  return CudaHostPtr<T[]>(ptr);
+}
+
 using CudaEvent = std::unique_ptr<CUevent_st, detail::CudaEventDestroyDeleter>;
 
 inline CudaEvent createCudaEvent() {
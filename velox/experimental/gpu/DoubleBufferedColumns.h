@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "velox/experimental/gpu/Common.h"
+
+namespace facebook::velox::gpu {
+
+/// Streams batches of fixed width columns from the CPU to the GPU with two
+/// sets of buffers, so that the CPU fills the page-locked host buffers of one
+/// batch while the GPU copies and processes the other. The columns of a batch
+/// have the layout of the values of a FlatVector, i.e. 'count' contiguous
+/// elements of 'T'.
+template <typename T>
+class DoubleBufferedColumns {
+ public:
+  DoubleBufferedColumns(int32_t numColumns, size_t maxBatchSize)
+      : numColumns_(numColumns), maxBatchSize_(maxBatchSize) {
+    for (int i = 0; i < 2; ++i) {
+      host_[i] = allocateHost<T>(numColumns * maxBatchSize);
+      device_[i] = allocateDevice<T>(numColumns * maxBatchSize);
+      streams_[i] = createCudaStream();
+    }
+  }
+
+  /// Returns the host buffer of 'column' of the next batch. Waits for the GPU
+  /// to be done with the batch that used the buffers before.
+  T* hostColumn(int32_t column) {
+    waitForBuffers();
+    return host_[next_].get() + column * maxBatchSize_;
+  }
+
+  /// Copies the first 'count' rows of the host columns of the next batch to
+  /// the device and calls 'process' with the device columns, 'count' and the
+  /// stream on which to launch the kernels. Returns without waiting for the
+  /// copy or the kernels.
+  template <typename F>
+  void submit(size_t count, F&& process) {
+    waitForBuffers();
+    auto stream = streams_[next_].get();
+    std::vector<T*> columns(numColumns_);
+    for (int32_t i = 0; i < numColumns_; ++i) {
+      columns[i] = device_[next_].get() + i * maxBatchSize_;
+      CUDA_CHECK_FATAL(cudaMemcpyAsync(
+          columns[i],
+          host_[next_].get() + i * maxBatchSize_,
+          count * sizeof(T),
+          cudaMemcpyHostToDevice,
+          stream));
+    }
+    process(columns.data(), count, stream);
+    CUDA_CHECK_FATAL(cudaGetLastError());
+    next_ ^= 1;
+    waited_ = false;
+  }
+
+  /// Waits for all submitted batches.
+  void finish() {
+    for (auto& stream : streams_) {
+      CUDA_CHECK_FATAL(cudaStreamSynchronize(stream.get()));
+    }
+  }
+
+  size_t maxBatchSize() const {
+    return maxBatchSize_;
+  }
+
+ private:
+  void waitForBuffers() {
+    if (!waited_) {
+      CUDA_CHECK_FATAL(cudaStreamSynchronize(streams_[next_].get()));
+      waited_ = true;
+    }
+  }
+
+  const int32_t numColumns_;
+  const size_t maxBatchSize_;
+  CudaHostPtr<T[]> host_[2];
+  CudaPtr<T[]> device_[2];
+  CudaStream streams_[2];
+  // The buffers of the next batch.
+  int next_{0};
+  bool waited_{false};
+};
+
+} // namespace facebook::velox::gpu
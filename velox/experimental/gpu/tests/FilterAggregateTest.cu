@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <chrono>
+#include <random>
+#include "velox/experimental/gpu/DoubleBufferedColumns.h"
+
+DEFINE_int64(num_rows, 256 << 20, "");
+DEFINE_int64(batch_size, 4 << 20, "");
+DEFINE_int32(num_groups, 1024, "");
+DEFINE_int32(device, 0, "");
+DEFINE_bool(validate, false, "");
+
+constexpr int kBlockSize = 256;
+constexpr int64_t kMaxValue = 1'000'000;
+constexpr int64_t kLower = 100'000;
+constexpr int64_t kUpper = 700'000;
+
+namespace facebook::velox::gpu {
+namespace {
+
+// SELECT key, count(*), sum(value) FROM t WHERE value >= kLower AND value <
+// kUpper GROUP BY key, for keys in [0, numGroups). The groups are
+// accumulated in shared memory per block and then added to 'counts' and
+// 'sums'.
+__global__ void filterAggregate(
+    const int64_t* keys,
+    const int64_t* values,
+    size_t count,
+    int numGroups,
+    unsigned long long* counts,
+    unsigned long long* sums) {
+  extern __shared__ unsigned long long blockGroups[];
+  auto* blockCounts = blockGroups;
+  auto* blockSums = blockGroups + numGroups;
+  for (int i = threadIdx.x; i < numGroups; i += blockDim.x) {
+    blockCounts[i] = 0;
+    blockSums[i] = 0;
+  }
+  __syncthreads();
+  for (size_t i = threadIdx.x + 1ull * blockIdx.x * blockDim.x; i < count;
+       i += 1ull * blockDim.x * gridDim.x) {
+    auto value = values[i];
+    if (value >= kLower && value < kUpper) {
+      atomicAdd(&blockCounts[keys[i]], 1ull);
+      atomicAdd(&blockSums[keys[i]], (unsigned long long)value);
+    }
+  }
+  __syncthreads();
+  for (int i = threadIdx.x; i < numGroups; i += blockDim.x) {
+    if (blockCounts[i]) {
+      atomicAdd(&counts[i], blockCounts[i]);
+      atomicAdd(&sums[i], blockSums[i]);
+    }
+  }
+}
+
+void testFilterAggregate() {
+  CUDA_CHECK_FATAL(cudaSetDevice(FLAGS_device));
+  int numSms;
+  CUDA_CHECK_FATAL(cudaDeviceGetAttribute(
+      &numSms, cudaDevAttrMultiProcessorCount, FLAGS_device));
+  const auto numGroups = FLAGS_num_groups;
+  const size_t sharedBytes = 2 * numGroups * sizeof(unsigned long long);
+  auto counts = allocateDevice<unsigned long long>(numGroups);
+  auto sums = allocateDevice<unsigned long long>(numGroups);
+  CUDA_CHECK_FATAL(
+      cudaMemset(counts.get(), 0, numGroups * sizeof(unsigned long long)));
+  CUDA_CHECK_FATAL(
+      cudaMemset(sums.get(), 0, numGroups * sizeof(unsigned long long)));
+
+  std::vector<uint64_t> expectedCounts(numGroups);
+  std::vector<uint64_t> expectedSums(numGroups);
+  std::mt19937_64 rng(1);
+  DoubleBufferedColumns<int64_t> columns(2, FLAGS_batch_size);
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t row = 0; row < FLAGS_num_rows; row += FLAGS_batch_size) {
+    const auto count =
+        std::min<int64_t>(FLAGS_batch_size, FLAGS_num_rows - row);
+    // The CPU produces this batch while the GPU processes the previous one.
+    auto* keys = columns.hostColumn(0);
+    auto* values = columns.hostColumn(1);
+    for (int64_t i = 0; i < count; ++i) {
+      keys[i] = rng() % numGroups;
+      values[i] = rng() % kMaxValue;
+      if (FLAGS_validate && values[i] >= kLower && values[i] < kUpper) {
+        ++expectedCounts[keys[i]];
+        expectedSums[keys[i]] += values[i];
+      }
+    }
+    columns.submit(
+        count, [&](int64_t* const* deviceColumns, size_t n, cudaStream_t s) {
+          filterAggregate<<<numSms * 4, kBlockSize, sharedBytes, s>>>(
+              deviceColumns[0],
+              deviceColumns[1],
+              n,
+              numGroups,
+              counts.get(),
+              sums.get());
+        });
+  }
+  columns.finish();
+  auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+  printf(
+      "Filter and aggregate of %ld rows: %.2f M rows/s\n",
+      FLAGS_num_rows,
+      FLAGS_num_rows * 1.0 / micros);
+
+  if (FLAGS_validate) {
+    std::vector<unsigned long long> actualCounts(numGroups);
+    std::vector<unsigned long long> actualSums(numGroups);
+    CUDA_CHECK_FATAL(cudaMemcpy(
+        actualCounts.data(),
+        counts.get(),
+        numGroups * sizeof(unsigned long long),
+        cudaMemcpyDeviceToHost));
+    CUDA_CHECK_FATAL(cudaMemcpy(
+        actualSums.data(),
+        sums.get(),
+        numGroups * sizeof(unsigned long long),
+        cudaMemcpyDeviceToHost));
+    for (int i = 0; i < numGroups; ++i) {
+      if (actualCounts[i] != expectedCounts[i] ||
+          actualSums[i] != expectedSums[i]) {
+        fprintf(stderr, "Mismatch in group %d\n", i);
+        abort();
+      }
+    }
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::gpu
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  facebook::velox::gpu::testFilterAggregate();
+  return 0;
+}
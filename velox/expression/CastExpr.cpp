@@ -16,9 +16,11 @@
 
 #include "velox/expression/CastExpr.h"
 
+#include <optional>
 #include <stdexcept>
 
 #include <fmt/format.h>
+#include <folly/Conv.h>
 
 #include <velox/common/base/VeloxException.h>
 #include "velox/common/base/Exceptions.h"
@@ -122,6 +124,98 @@ void applyIntToDecimalCastKernel(
   });
 }
 
+template <TypeKind Kind>
+constexpr bool isIntegralKind() {
+  return Kind == TypeKind::TINYINT || Kind == TypeKind::SMALLINT ||
+      Kind == TypeKind::INTEGER || Kind == TypeKind::BIGINT;
+}
+
+template <TypeKind Kind>
+constexpr bool isFloatingPointKind() {
+  return Kind == TypeKind::REAL || Kind == TypeKind::DOUBLE;
+}
+
+/// Returns true if castNumbersAndStrings() casts from FromKind to ToKind with
+/// the same results as applyCastKernel() for the given 'truncate' setting.
+template <TypeKind ToKind, TypeKind FromKind>
+constexpr bool hasNumberAndStringCast(bool truncate) {
+  if constexpr (FromKind == TypeKind::VARCHAR) {
+    // Casts to integers by truncation parse strings differently.
+    return isFloatingPointKind<ToKind>() ||
+        (isIntegralKind<ToKind>() && !truncate);
+  } else if constexpr (ToKind == TypeKind::VARCHAR) {
+    // Casts of doubles by truncation append '.0' to whole numbers.
+    return isIntegralKind<FromKind>() ||
+        (isFloatingPointKind<FromKind>() && !truncate);
+  }
+  return false;
+}
+
+/// Writes the decimal digits of 'value' to 'buffer' and returns their count.
+/// 'buffer' must have space for 20 characters.
+template <typename T>
+size_t formatInteger(T value, char* buffer) {
+  if (value < 0) {
+    buffer[0] = '-';
+    // Negates in unsigned arithmetic so that the minimum value does not
+    // overflow.
+    return 1 +
+        folly::uint64ToBufferUnsafe(
+               ~static_cast<uint64_t>(value) + 1, buffer + 1);
+  }
+  return folly::uint64ToBufferUnsafe(value, buffer);
+}
+
+/// Casts strings to numbers and numbers to strings without the per row
+/// exception handling of applyCastKernel() and without a temporary string per
+/// row. Returns the rows that failed to convert, which the caller casts again
+/// with applyCastKernel() to report the errors, or std::nullopt if all rows
+/// converted.
+template <TypeKind ToKind, TypeKind FromKind>
+std::optional<SelectivityVector> castNumbersAndStrings(
+    const SelectivityVector& rows,
+    const SimpleVector<typename TypeTraits<FromKind>::NativeType>& input,
+    FlatVector<typename TypeTraits<ToKind>::NativeType>& result) {
+  using To = typename TypeTraits<ToKind>::NativeType;
+  std::optional<SelectivityVector> failedRows;
+  if constexpr (FromKind == TypeKind::VARCHAR) {
+    rows.applyToSelected([&](auto row) {
+      // Same parsing as folly::to() in Converter.
+      auto parsed = folly::tryTo<To>(folly::StringPiece(input.valueAt(row)));
+      if (parsed.hasValue()) {
+        result.set(row, parsed.value());
+        return;
+      }
+      if (!failedRows.has_value()) {
+        failedRows.emplace(rows.end(), false);
+      }
+      failedRows->setValid(row, true);
+    });
+  } else if constexpr (isIntegralKind<FromKind>()) {
+    rows.applyToSelected([&](auto row) {
+      exec::StringWriter<> writer(&result, row);
+      writer.resize(20);
+      writer.resize(formatInteger(input.valueAt(row), writer.data()));
+      writer.finalize();
+    });
+  } else {
+    // Same formatting as folly::to<std::string>() in Converter, which also
+    // calls toAppend().
+    std::string buffer;
+    rows.applyToSelected([&](auto row) {
+      buffer.clear();
+      folly::toAppend(input.valueAt(row), &buffer);
+      exec::StringWriter<> writer(&result, row);
+      writer.copy_from(buffer);
+      writer.finalize();
+    });
+  }
+  if (failedRows.has_value()) {
+    failedRows->updateBounds();
+  }
+  return failedRows;
+}
+
 template <TypeKind ToKind, TypeKind FromKind>
 void applyCastPrimitives(
     const SelectivityVector& rows,
@@ -135,8 +229,23 @@ void applyCastPrimitives(
 
   const auto& queryConfig = context.execCtx()->queryCtx()->queryConfig();
 
+  // Rows cast with applyCastKernel().
+  const SelectivityVector* kernelRows = &rows;
+  std::optional<SelectivityVector> failedRows;
+  if constexpr (hasNumberAndStringCast<ToKind, FromKind>(false)) {
+    if (hasNumberAndStringCast<ToKind, FromKind>(
+            queryConfig.isCastToIntByTruncate())) {
+      failedRows = castNumbersAndStrings<ToKind, FromKind>(
+          rows, *inputSimpleVector, *resultFlatVector);
+      if (!failedRows.has_value()) {
+        return;
+      }
+      kernelRows = &failedRows.value();
+    }
+  }
+
   if (!queryConfig.isCastToIntByTruncate()) {
-    context.applyToSelectedNoThrow(rows, [&](int row) {
+    context.applyToSelectedNoThrow(*kernelRows, [&](int row) {
       try {
         // Passing a false truncate flag
         applyCastKernel<ToKind, FromKind, false>(
@@ -156,7 +265,7 @@ void applyCastPrimitives(
       }
     });
   } else {
-    context.applyToSelectedNoThrow(rows, [&](int row) {
+    context.applyToSelectedNoThrow(*kernelRows, [&](int row) {
       try {
         // Passing a true truncate flag
         applyCastKernel<ToKind, FromKind, true>(
@@ -189,8 +298,9 @@ void applyCastPrimitives(
         auto* timeZone = date::locate_zone(sessionTzName);
         auto rawTimestamps = resultFlatVector->mutableRawValues();
 
+        TimeZoneConverter converter;
         rows.applyToSelected(
-            [&](int row) { rawTimestamps[row].toGMT(*timeZone); });
+            [&](int row) { converter.toGMT(rawTimestamps[row], *timeZone); });
       }
     }
   }
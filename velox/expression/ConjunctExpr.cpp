@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 #include "velox/expression/ConjunctExpr.h"
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
 #include "velox/expression/BooleanMix.h"
 #include "velox/expression/ScopedVarSetter.h"
 
@@ -21,6 +25,19 @@ namespace facebook::velox::exec {
 
 namespace {
 
+// Bound of the number of distinct inputs in the history. The history is
+// dropped when it is exceeded.
+constexpr size_t kMaxHistoryEntries = 10'000;
+
+// Statistics of the inputs of AND and OR keyed on their text, accumulated
+// over all the expressions that used the history.
+folly::Synchronized<folly::F14FastMap<std::string, SelectivityInfo>>&
+conjunctHistory() {
+  static folly::Synchronized<folly::F14FastMap<std::string, SelectivityInfo>>
+      history;
+  return history;
+}
+
 uint64_t* rowsWithError(
     const SelectivityVector& rows,
     const SelectivityVector& activeRows,
@@ -91,10 +108,26 @@ void finalizeErrors(
 }
 } // namespace
 
+ConjunctExpr::~ConjunctExpr() {
+  if (useHistory_) {
+    recordHistory();
+  }
+}
+
 void ConjunctExpr::evalSpecialForm(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result) {
+  if (!reorderEnabledChecked_) {
+    const auto& config = context.execCtx()->queryCtx()->queryConfig();
+    reorderEnabled_ = config.adaptiveFilterReorderingEnabled();
+    useHistory_ =
+        reorderEnabled_ && config.adaptiveFilterReorderingUseHistory();
+    reorderEnabledChecked_ = true;
+    if (useHistory_) {
+      seedInputOrder();
+    }
+  }
   // TODO Revisit error handling
   bool throwOnError = *context.mutableThrowOnError();
   ScopedVarSetter saveError(context.mutableThrowOnError(), false);
@@ -133,7 +166,9 @@ void ConjunctExpr::evalSpecialForm(
     }
 
     SelectivityTimer timer(selectivity_[inputOrder_[i]], numActive);
-    inputs_[inputOrder_[i]]->eval(*activeRows, context, inputResult);
+    const auto& input = inputs_[inputOrder_[i]];
+    loadMultiplyReferencedFields(*input, *activeRows, context);
+    input->eval(*activeRows, context, inputResult);
     if (context.errors()) {
       handleErrors = true;
     }
@@ -159,18 +194,31 @@ void ConjunctExpr::evalSpecialForm(
   }
   // Clear errors for 'rows' that are not in 'activeRows'.
   finalizeErrors(rows, *activeRows, throwOnError, context);
-  if (!reorderEnabledChecked_) {
-    reorderEnabled_ = context.execCtx()
-                          ->queryCtx()
-                          ->queryConfig()
-                          .adaptiveFilterReorderingEnabled();
-    reorderEnabledChecked_ = true;
-  }
   if (reorderEnabled_) {
     maybeReorderInputs();
   }
 }
 
+void ConjunctExpr::loadMultiplyReferencedFields(
+    const Expr& input,
+    const SelectivityVector& rows,
+    EvalCtx& context) {
+  if (multiplyReferencedFields_.empty()) {
+    return;
+  }
+  // An input that references the same fields as 'this' has empty
+  // distinctFields().
+  const auto& fields = input.distinctFields().empty()
+      ? distinctFields_
+      : input.distinctFields();
+  for (auto* field : fields) {
+    // Loading a field that is already loaded is a no-op.
+    if (multiplyReferencedFields_.count(field)) {
+      context.ensureFieldLoaded(field->index(context), rows);
+    }
+  }
+}
+
 void ConjunctExpr::maybeReorderInputs() {
   bool reorder = false;
   for (auto i = 1; i < inputs_.size(); ++i) {
@@ -267,6 +315,58 @@ void ConjunctExpr::updateResult(
   }
 }
 
+void ConjunctExpr::seedInputOrder() {
+  std::vector<SelectivityInfo> history(inputs_.size());
+  {
+    auto locked = conjunctHistory().rlock();
+    for (auto i = 0; i < inputs_.size(); ++i) {
+      auto it = locked->find(inputs_[i]->toString());
+      if (it == locked->end()) {
+        return;
+      }
+      history[i] = it->second;
+    }
+  }
+  std::stable_sort(
+      inputOrder_.begin(),
+      inputOrder_.end(),
+      [&](size_t left, size_t right) {
+        return history[left].timeToDropValue() <
+            history[right].timeToDropValue();
+      });
+}
+
+void ConjunctExpr::recordHistory() const {
+  auto locked = conjunctHistory().wlock();
+  if (locked->size() + inputs_.size() > kMaxHistoryEntries) {
+    locked->clear();
+  }
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    if (selectivity_[i].numIn() > 0) {
+      (*locked)[inputs_[i]->toString()].add(selectivity_[i]);
+    }
+  }
+}
+
+// static
+void ConjunctExpr::clearHistory() {
+  conjunctHistory().wlock()->clear();
+}
+
+void ConjunctExpr::addConjunctStats(
+    std::unordered_map<std::string, ConjunctStats>& stats) const {
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    const auto& selectivity = selectivity_[i];
+    if (selectivity.numIn() == 0) {
+      continue;
+    }
+    auto& inputStats = stats[inputs_[i]->toString()];
+    inputStats.numInputRows += selectivity.numIn();
+    inputStats.numPassedRows += selectivity.numOut();
+    inputStats.timeClocks += selectivity.timeClocks();
+  }
+}
+
 std::string ConjunctExpr::toSql(
     std::vector<VectorPtr>* complexConstants) const {
   std::stringstream out;
@@ -51,6 +51,8 @@ class ConjunctExpr : public SpecialForm {
     resolveType(inputTypes);
   }
 
+  ~ConjunctExpr() override;
+
   void evalSpecialForm(
       const SelectivityVector& rows,
       EvalCtx& context,
@@ -64,10 +66,23 @@ class ConjunctExpr : public SpecialForm {
     return true;
   }
 
+  bool evaluatesInputsOnNarrowingRows() const override {
+    return true;
+  }
+
   const SelectivityInfo& selectivityAt(int32_t index) {
     return selectivity_[inputOrder_[index]];
   }
 
+  /// Adds the statistics of the inputs that have been evaluated to 'stats',
+  /// keyed on the text of the input.
+  void addConjunctStats(
+      std::unordered_map<std::string, ConjunctStats>& stats) const;
+
+  /// Clears the statistics recorded for seeding the order of inputs. See
+  /// QueryConfig::kAdaptiveFilterReorderingUseHistory.
+  static void clearHistory();
+
   std::string toSql(
       std::vector<VectorPtr>* complexConstants = nullptr) const override;
 
@@ -75,6 +90,20 @@ class ConjunctExpr : public SpecialForm {
   static TypePtr resolveType(const std::vector<TypePtr>& argTypes);
 
   void maybeReorderInputs();
+
+  // Loads the lazy vectors referenced by 'input' and by other inputs for
+  // 'rows'. The inputs evaluated later need these for a subset of 'rows'.
+  void loadMultiplyReferencedFields(
+      const Expr& input,
+      const SelectivityVector& rows,
+      EvalCtx& context);
+
+  // Orders the inputs by the statistics recorded for them by earlier
+  // expressions. Keeps the order if an input has no statistics.
+  void seedInputOrder();
+
+  // Adds the statistics of the inputs to the ones used by seedInputOrder().
+  void recordHistory() const;
   void updateResult(
       BaseVector* inputResult,
       EvalCtx& context,
@@ -91,6 +120,9 @@ class ConjunctExpr : public SpecialForm {
   BufferPtr tempNulls_;
   bool reorderEnabledChecked_ = false;
   bool reorderEnabled_;
+  // True if the order of inputs is seeded from and recorded to the process
+  // wide statistics of earlier expressions.
+  bool useHistory_{false};
   std::vector<SelectivityInfo> selectivity_;
   std::vector<int32_t> inputOrder_;
 
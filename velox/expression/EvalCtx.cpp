@@ -51,6 +51,39 @@ EvalCtx::EvalCtx(core::ExecCtx* execCtx)
   VELOX_CHECK_NOT_NULL(execCtx);
 }
 
+EvalCtx::~EvalCtx() {
+  clearDecodedArgs();
+}
+
+DecodedVector* EvalCtx::getDecodedArg(
+    const VectorPtr& vector,
+    const SelectivityVector& rows) {
+  if (vector->encoding() != VectorEncoding::Simple::DICTIONARY) {
+    return nullptr;
+  }
+  for (auto& arg : decodedArgs_) {
+    if (arg.vector == vector) {
+      // A kept decoding is not redone for more rows because functions of
+      // enclosing calls may be using it.
+      return rows.isSubset(arg.rows) ? arg.decoded.get() : nullptr;
+    }
+  }
+  if (decodedArgs_.size() >= kMaxDecodedArgs) {
+    return nullptr;
+  }
+  auto decoded = execCtx_->getDecodedVector();
+  decoded->decode(*vector, rows);
+  decodedArgs_.push_back({vector, rows, std::move(decoded)});
+  return decodedArgs_.back().decoded.get();
+}
+
+void EvalCtx::clearDecodedArgs() {
+  for (auto& arg : decodedArgs_) {
+    execCtx_->releaseDecodedVector(std::move(arg.decoded));
+  }
+  decodedArgs_.clear();
+}
+
 void EvalCtx::saveAndReset(
     ScopedContextSaver& saver,
     const SelectivityVector& rows) {
@@ -44,6 +44,8 @@ class EvalCtx {
   /// For testing only.
   explicit EvalCtx(core::ExecCtx* FOLLY_NONNULL execCtx);
 
+  ~EvalCtx();
+
   const RowVector* FOLLY_NONNULL row() const {
     return row_;
   }
@@ -273,7 +275,32 @@ class EvalCtx {
     return peeledEncoding_.get();
   }
 
+  /// Returns 'vector' decoded for at least 'rows' if 'vector' is dictionary
+  /// encoded. The decoding is kept in 'this', so that all functions that take
+  /// the same dictionary as an argument decode it once. Returns nullptr for
+  /// other encodings, which are cheap to decode, and for rows that are not a
+  /// subset of the rows of the kept decoding. The caller must not modify the
+  /// result.
+  DecodedVector* FOLLY_NULLABLE getDecodedArg(
+      const VectorPtr& vector,
+      const SelectivityVector& rows);
+
+  /// Drops the decodings kept by getDecodedArg(). Called by ExprSet::eval()
+  /// at the start of each batch.
+  void clearDecodedArgs();
+
  private:
+  // Maximum number of dictionaries kept by getDecodedArg().
+  static constexpr int32_t kMaxDecodedArgs = 8;
+
+  struct DecodedArg {
+    // Referenced so that the vector is neither freed nor reused in place
+    // while decoded.
+    VectorPtr vector;
+    SelectivityVector rows;
+    std::unique_ptr<DecodedVector> decoded;
+  };
+
   core::ExecCtx* const FOLLY_NONNULL execCtx_;
   ExprSet* FOLLY_NULLABLE const exprSet_;
   const RowVector* FOLLY_NULLABLE row_;
@@ -304,6 +331,9 @@ class EvalCtx {
   // in a opaque flat vector, which will translate to a
   // std::shared_ptr<std::exception_ptr>.
   ErrorVectorPtr errors_;
+
+  // Decoded dictionary arguments of functions, see getDecodedArg().
+  std::vector<DecodedArg> decodedArgs_;
 };
 
 /// Utility wrapper struct that is used to temporarily reset the value of the an
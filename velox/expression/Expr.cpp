@@ -16,12 +16,14 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <algorithm>
 #include <fstream>
 
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/core/Expressions.h"
+#include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/ExprCompiler.h"
@@ -769,7 +771,7 @@ void Expr::eval(
     for (const auto& field : distinctFields_) {
       context.ensureFieldLoaded(field->index(context), rows);
     }
-  } else if (!propagatesNulls_) {
+  } else if (!propagatesNulls_ && !evaluatesInputsOnNarrowingRows()) {
     // Load multiply-referenced fields at common parent expr with "rows".
     // Delay loading fields that are not in multiplyReferencedFields_.
     for (const auto& field : multiplyReferencedFields_) {
@@ -1116,23 +1118,28 @@ void Expr::evalWithMemo(
   VectorPtr base;
   distinctFields_[0]->evalSpecialForm(rows, context, base);
   ++numCachableInput_;
-  if (baseDictionary_ == base) {
+  auto it = std::find_if(memos_.begin(), memos_.end(), [&](const auto& memo) {
+    return memo.baseDictionary == base;
+  });
+  if (it != memos_.end()) {
     ++numCacheableRepeats_;
-    if (cachedDictionaryIndices_) {
+    std::rotate(memos_.begin(), it, it + 1);
+    auto& memo = memos_.front();
+    if (memo.cachedDictionaryIndices) {
       LocalSelectivityVector cachedHolder(context, rows);
       auto cached = cachedHolder.get();
       VELOX_DCHECK(cached != nullptr);
-      cached->intersect(*cachedDictionaryIndices_);
+      cached->intersect(*memo.cachedDictionaryIndices);
       if (cached->hasSelections()) {
         context.ensureWritable(rows, type(), result);
-        result->copy(dictionaryCache_.get(), *cached, nullptr);
+        result->copy(memo.dictionaryCache.get(), *cached, nullptr);
       }
     }
     LocalSelectivityVector uncachedHolder(context, rows);
     auto uncached = uncachedHolder.get();
     VELOX_DCHECK(uncached != nullptr);
-    if (cachedDictionaryIndices_) {
-      uncached->deselect(*cachedDictionaryIndices_);
+    if (memo.cachedDictionaryIndices) {
+      uncached->deselect(*memo.cachedDictionaryIndices);
     }
     if (uncached->hasSelections()) {
       // Fix finalSelection at "rows" if uncached rows is a strict subset to
@@ -1143,47 +1150,67 @@ void Expr::evalWithMemo(
 
       evalWithNulls(*uncached, context, result);
       context.deselectErrors(*uncached);
-      context.exprSet()->addToMemo(this);
       auto newCacheSize = uncached->end();
 
-      // dictionaryCache_ is valid only for cachedDictionaryIndices_. Hence, a
+      // dictionaryCache is valid only for cachedDictionaryIndices. Hence, a
       // safe call to BaseVector::ensureWritable must include all the rows not
-      // covered by cachedDictionaryIndices_. If BaseVector::ensureWritable is
+      // covered by cachedDictionaryIndices. If BaseVector::ensureWritable is
       // called only for a subset of rows not covered by
-      // cachedDictionaryIndices_, it will attempt to copy rows that are not
+      // cachedDictionaryIndices, it will attempt to copy rows that are not
       // valid leading to a crash.
-      LocalSelectivityVector allUncached(context, dictionaryCache_->size());
+      LocalSelectivityVector allUncached(
+          context, memo.dictionaryCache->size());
       allUncached.get()->setAll();
-      allUncached.get()->deselect(*cachedDictionaryIndices_);
-      context.ensureWritable(*allUncached.get(), type(), dictionaryCache_);
+      allUncached.get()->deselect(*memo.cachedDictionaryIndices);
+      context.ensureWritable(
+          *allUncached.get(), type(), memo.dictionaryCache);
 
-      if (cachedDictionaryIndices_->size() < newCacheSize) {
-        cachedDictionaryIndices_->resize(newCacheSize, false);
+      if (memo.cachedDictionaryIndices->size() < newCacheSize) {
+        memo.cachedDictionaryIndices->resize(newCacheSize, false);
       }
 
-      cachedDictionaryIndices_->select(*uncached);
+      memo.cachedDictionaryIndices->select(*uncached);
 
-      // Resize the dictionaryCache_ to accommodate all the necessary rows.
-      if (dictionaryCache_->size() < uncached->end()) {
-        dictionaryCache_->resize(uncached->end());
+      // Resize the dictionaryCache to accommodate all the necessary rows.
+      if (memo.dictionaryCache->size() < uncached->end()) {
+        memo.dictionaryCache->resize(uncached->end());
       }
-      dictionaryCache_->copy(result.get(), *uncached, nullptr);
+      memo.dictionaryCache->copy(result.get(), *uncached, nullptr);
+      memo.bytes = memo.dictionaryCache->retainedSize();
+      evictMemos(context);
     }
     context.releaseVector(base);
     return;
   }
-  context.releaseVector(baseDictionary_);
-  baseDictionary_ = base;
   evalWithNulls(rows, context, result);
 
-  context.releaseVector(dictionaryCache_);
-  dictionaryCache_ = result;
-  if (!cachedDictionaryIndices_) {
-    cachedDictionaryIndices_ =
-        context.execCtx()->getSelectivityVector(rows.end());
+  Memo memo;
+  memo.baseDictionary = std::move(base);
+  memo.dictionaryCache = result;
+  memo.cachedDictionaryIndices =
+      context.execCtx()->getSelectivityVector(rows.end());
+  *memo.cachedDictionaryIndices = rows;
+  context.deselectErrors(*memo.cachedDictionaryIndices);
+  memo.bytes = result->retainedSize();
+  memos_.insert(memos_.begin(), std::move(memo));
+  context.exprSet()->addToMemo(this);
+  evictMemos(context);
+}
+
+void Expr::evictMemos(EvalCtx& context) {
+  const auto maxBytes = context.exprSet()->maxMemoBytes();
+  uint64_t totalBytes = 0;
+  for (const auto& memo : memos_) {
+    totalBytes += memo.bytes;
+  }
+  while (memos_.size() > 1 &&
+         (memos_.size() > kMaxMemoEntries || totalBytes > maxBytes)) {
+    auto& memo = memos_.back();
+    totalBytes -= memo.bytes;
+    context.releaseVector(memo.baseDictionary);
+    context.releaseVector(memo.dictionaryCache);
+    memos_.pop_back();
   }
-  *cachedDictionaryIndices_ = rows;
-  context.deselectErrors(*cachedDictionaryIndices_);
 }
 
 void Expr::setAllNulls(
@@ -1580,11 +1607,22 @@ bool Expr::isConstant() const {
   return true;
 }
 
+namespace {
+uint64_t maxMemoBytes(core::ExecCtx* execCtx) {
+  if (execCtx && execCtx->queryCtx()) {
+    return execCtx->queryCtx()->queryConfig().exprMaxMemoBytes();
+  }
+  static const core::QueryConfig kDefaultConfig{
+      std::unordered_map<std::string, std::string>{}};
+  return kDefaultConfig.exprMaxMemoBytes();
+}
+} // namespace
+
 ExprSet::ExprSet(
     const std::vector<core::TypedExprPtr>& sources,
     core::ExecCtx* execCtx,
     bool enableConstantFolding)
-    : execCtx_(execCtx) {
+    : execCtx_(execCtx), maxMemoBytes_(maxMemoBytes(execCtx)) {
   exprs_ = compileExpressions(sources, execCtx, this, enableConstantFolding);
   std::vector<FieldReference*> allDistinctFields;
   for (auto& expr : exprs_) {
@@ -1611,6 +1649,14 @@ void addStats(
     stats[expr.name()].add(expr.stats());
   }
 
+  if (auto* conjunct = dynamic_cast<const ConjunctExpr*>(&expr)) {
+    ExprStats conjunctStats;
+    conjunct->addConjunctStats(conjunctStats.conjuncts);
+    if (!conjunctStats.conjuncts.empty()) {
+      stats[expr.name()].add(conjunctStats);
+    }
+  }
+
   for (const auto& input : expr.inputs()) {
     addStats(*input, stats, uniqueExprs);
   }
@@ -1681,6 +1727,7 @@ void ExprSet::eval(
   result.resize(exprs_.size());
   if (initialize) {
     clearSharedSubexprs();
+    context.clearDecodedArgs();
   }
 
   // Make sure LazyVectors, referenced by multiple expressions, are loaded
@@ -1724,6 +1771,7 @@ void ExprSetSimplified::eval(
   result.resize(exprs_.size());
   if (initialize) {
     clearSharedSubexprs();
+    context.clearDecodedArgs();
   }
   for (int32_t i = begin; i < end; ++i) {
     exprs_[i]->evalSimplified(rows, context, result[i]);
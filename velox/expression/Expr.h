@@ -46,6 +46,40 @@ class ExprSet;
 class FieldReference;
 class VectorFunction;
 
+/// Statistics of an input of AND or OR. These drive the adaptive reordering
+/// of the inputs.
+struct ConjunctStats {
+  /// Number of rows the input was evaluated on.
+  uint64_t numInputRows{0};
+
+  /// Number of these rows that the input did not decide, i.e. that went on to
+  /// the next input.
+  uint64_t numPassedRows{0};
+
+  /// Time spent evaluating the input in CPU clock ticks.
+  uint64_t timeClocks{0};
+
+  void add(const ConjunctStats& other) {
+    numInputRows += other.numInputRows;
+    numPassedRows += other.numPassedRows;
+    timeClocks += other.timeClocks;
+  }
+
+  double passRate() const {
+    return numInputRows == 0 ? 1.0 : (double)numPassedRows / numInputRows;
+  }
+
+  std::string toString() const {
+    return fmt::format(
+        "numInputRows: {}, numPassedRows: {}, passRate: {:.3f}, "
+        "timeClocks: {}",
+        numInputRows,
+        numPassedRows,
+        passRate(),
+        timeClocks);
+  }
+};
+
 struct ExprStats {
   /// Requires QueryConfig.exprTrackCpuUsage() to be 'true'.
   CpuWallTiming timing;
@@ -57,18 +91,28 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// For AND and OR, the statistics of the inputs keyed on their text.
+  std::unordered_map<std::string, ConjunctStats> conjuncts;
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    for (const auto& [input, stats] : other.conjuncts) {
+      conjuncts[input].add(stats);
+    }
   }
 
   std::string toString() const {
-    return fmt::format(
+    auto out = fmt::format(
         "timing: {}, numProcessedRows: {}, numProcessedVectors: {}",
         timing.toString(),
         numProcessedRows,
         numProcessedVectors);
+    for (const auto& [input, stats] : conjuncts) {
+      out += fmt::format(", {}: {{{}}}", input, stats.toString());
+    }
+    return out;
   }
 };
 
@@ -239,9 +283,7 @@ class Expr {
   }
 
   void clearMemo() {
-    baseDictionary_ = nullptr;
-    dictionaryCache_ = nullptr;
-    cachedDictionaryIndices_ = nullptr;
+    memos_.clear();
   }
 
   const TypePtr& type() const {
@@ -264,6 +306,15 @@ class Expr {
     return false;
   }
 
+  /// True if the inputs are evaluated on successively smaller subsets of the
+  /// rows, each a subset of the rows of the previous input, e.g. AND and OR.
+  /// Then eval() does not load the lazy vectors referenced by several inputs
+  /// for all rows but the expression loads them for the rows of the first
+  /// input that references them.
+  virtual bool evaluatesInputsOnNarrowingRows() const {
+    return false;
+  }
+
   bool isDeterministic() const {
     return deterministic_;
   }
@@ -382,6 +433,11 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Drops the least recently used entries of 'memos_' that exceed
+  // kMaxMemoEntries or the memory limit of the ExprSet. Keeps the most
+  // recently used entry.
+  void evictMemos(EvalCtx& context);
+
   void evalWithNulls(
       const SelectivityVector& rows,
       EvalCtx& context,
@@ -553,14 +609,30 @@ class Expr {
   // evaluateSharedSubexpr() is called to the cached shared results.
   std::map<std::vector<const BaseVector*>, SharedResults> sharedSubexprResults_;
 
-  VectorPtr baseDictionary_;
+  // Results memoized for the base of a dictionary encoded input. Scans return
+  // the same dictionary for many batches, e.g. for all batches of a stripe,
+  // so these are kept across batches.
+  struct Memo {
+    VectorPtr baseDictionary;
 
-  // Values computed for the base dictionary, 1:1 to the positions in
-  // 'baseDictionary_'.
-  VectorPtr dictionaryCache_;
+    // Values computed for the base dictionary, 1:1 to the positions in
+    // 'baseDictionary'.
+    VectorPtr dictionaryCache;
 
-  // The indices that are valid in 'dictionaryCache_'.
-  std::unique_ptr<SelectivityVector> cachedDictionaryIndices_;
+    // The indices that are valid in 'dictionaryCache'.
+    std::unique_ptr<SelectivityVector> cachedDictionaryIndices;
+
+    // Retained size of 'dictionaryCache'.
+    uint64_t bytes{0};
+  };
+
+  // Maximum number of distinct base dictionaries memoized at a time. More
+  // than one is useful when batches over different dictionaries interleave,
+  // e.g. after a local exchange of several scans.
+  static constexpr int32_t kMaxMemoEntries = 4;
+
+  // Most recently used first.
+  std::vector<Memo> memos_;
 
   // Count of executions where this is wrapped in a dictionary so that
   // results could be cached.
@@ -648,6 +720,11 @@ class ExprSet {
     memoizingExprs_.insert(expr);
   }
 
+  // Memory limit for the results each Expr memoizes for dictionaries.
+  uint64_t maxMemoBytes() const {
+    return maxMemoBytes_;
+  }
+
   /// Returns text representation of the expression set.
   /// @param compact If true, uses one-line representation for each expression.
   /// Otherwise, prints a tree of expressions one node per line.
@@ -678,6 +755,7 @@ class ExprSet {
   // Exprs which retain memoized state, e.g. from running over dictionaries.
   std::unordered_set<Expr*> memoizingExprs_;
   core::ExecCtx* FOLLY_NONNULL const execCtx_;
+  uint64_t maxMemoBytes_;
 };
 
 class ExprSetSimplified : public ExprSet {
@@ -15,12 +15,19 @@
  */
 
 #include "velox/expression/ExprCompiler.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+#include <folly/hash/Hash.h>
+
 #include "velox/expression/CastExpr.h"
 #include "velox/expression/CoalesceExpr.h"
 #include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/FieldReference.h"
+#include "velox/expression/FusedExpr.h"
 #include "velox/expression/LambdaExpr.h"
 #include "velox/expression/SimpleFunctionRegistry.h"
 #include "velox/expression/SwitchExpr.h"
@@ -57,6 +64,11 @@ using ExprDedupMap = folly::F14FastMap<
     ITypedExprHasher,
     ITypedExprComparer>;
 
+// Compiled Exprs by the hash of their normalized form. See
+// getEquivalentCompiled().
+using NormalizedExprMap =
+    folly::F14FastMap<size_t, std::vector<std::shared_ptr<Expr>>>;
+
 /// Represents a lexical scope. A top level scope corresponds to a top
 /// level Expr and is shared among the Exprs of the ExprSet. Each
 /// lambda introduces a new Scope where the 'locals' are the formal
@@ -81,6 +93,8 @@ struct Scope {
   std::vector<const ITypedExpr*> captureFieldAccesses;
   // Deduplicatable ITypedExprs. Only applies within the one scope.
   ExprDedupMap visited;
+  // Deduplicatable compiled Exprs. Only applies within the one scope.
+  NormalizedExprMap normalized;
 
   Scope(std::vector<std::string>&& _locals, Scope* _parent, ExprSet* _exprSet)
       : locals(_locals), parent(_parent), exprSet(_exprSet) {}
@@ -136,6 +150,100 @@ ExprPtr getAlreadyCompiled(const ITypedExpr* expr, ExprDedupMap* visited) {
   return iter == visited->end() ? nullptr : iter->second;
 }
 
+void setMultiplyReferenced(const ExprPtr& expr, Scope* scope) {
+  if (!expr->isMultiplyReferenced()) {
+    scope->exprSet->addToReset(expr);
+    expr->setMultiplyReferenced();
+    // A property of this expression changed, namely isMultiplyReferenced_,
+    // that affects metadata, so we re-compute it.
+    expr->computeMetadata();
+  }
+}
+
+// Returns true if the result of function 'name' does not depend on the order
+// of its arguments. The name may have a prefix, e.g. 'presto.default.'.
+bool isCommutative(const std::string& name) {
+  static const std::unordered_set<std::string> kCommutative = {
+      "plus",
+      "multiply",
+      "eq",
+      "neq",
+      "bitwise_and",
+      "bitwise_or",
+      "bitwise_xor",
+  };
+  const auto pos = name.rfind('.');
+  return kCommutative.count(
+             pos == std::string::npos ? name : name.substr(pos + 1)) > 0;
+}
+
+// Returns true for the Exprs that are deduplicated after compilation:
+// literals, casts and deterministic calls of functions.
+bool isNormalizable(const Expr& expr) {
+  if (typeid(expr) == typeid(ConstantExpr)) {
+    return true;
+  }
+  return expr.isDeterministic() &&
+      (typeid(expr) == typeid(Expr) || typeid(expr) == typeid(CastExpr));
+}
+
+// Returns the inputs of 'expr', sorted if the order does not matter.
+std::vector<const Expr*> normalizedInputs(const Expr& expr) {
+  std::vector<const Expr*> inputs;
+  inputs.reserve(expr.inputs().size());
+  for (auto& input : expr.inputs()) {
+    inputs.push_back(input.get());
+  }
+  if (isCommutative(expr.name())) {
+    std::sort(inputs.begin(), inputs.end());
+  }
+  return inputs;
+}
+
+size_t normalizedHash(const Expr& expr) {
+  auto hash = folly::hash::hash_combine(
+      std::hash<std::string>{}(expr.name()), expr.type()->hashKind());
+  if (auto* constant = dynamic_cast<const ConstantExpr*>(&expr)) {
+    return folly::hash::hash_combine(hash, constant->value()->hashValueAt(0));
+  }
+  for (auto* input : normalizedInputs(expr)) {
+    hash = folly::hash::hash_combine(hash, input);
+  }
+  return hash;
+}
+
+bool isEquivalent(const Expr& lhs, const Expr& rhs) {
+  if (typeid(lhs) != typeid(rhs) || lhs.name() != rhs.name() ||
+      *lhs.type() != *rhs.type()) {
+    return false;
+  }
+  if (auto* constant = dynamic_cast<const ConstantExpr*>(&lhs)) {
+    return constant->value()->equalValueAt(
+        static_cast<const ConstantExpr&>(rhs).value().get(), 0, 0);
+  }
+  return normalizedInputs(lhs) == normalizedInputs(rhs);
+}
+
+// Returns an Expr compiled earlier in 'scope' that is equivalent to 'expr' or
+// 'expr' if there is none. Because the inputs are compiled and deduplicated
+// first, this finds common subexpressions that differ as ITypedExprs, e.g.
+// f(1 + 1) and f(2) after constant folding, f(cast(a as bigint)) and f(a) if
+// 'a' is a bigint, or a + b and b + a.
+ExprPtr getEquivalentCompiled(const ExprPtr& expr, Scope* scope) {
+  if (!isNormalizable(*expr)) {
+    return expr;
+  }
+  auto& candidates = scope->normalized[normalizedHash(*expr)];
+  for (auto& candidate : candidates) {
+    if (candidate != expr && isEquivalent(*candidate, *expr)) {
+      setMultiplyReferenced(candidate, scope);
+      return candidate;
+    }
+  }
+  candidates.push_back(expr);
+  return expr;
+}
+
 ExprPtr compileExpression(
     const TypedExprPtr& expr,
     Scope* scope,
@@ -352,13 +460,7 @@ ExprPtr compileExpression(
     bool enableConstantFolding) {
   ExprPtr alreadyCompiled = getAlreadyCompiled(expr.get(), &scope->visited);
   if (alreadyCompiled) {
-    if (!alreadyCompiled->isMultiplyReferenced()) {
-      scope->exprSet->addToReset(alreadyCompiled);
-      alreadyCompiled->setMultiplyReferenced();
-      // A property of this expression changed, namely isMultiplyReferenced_,
-      // that affects metadata, so we re-compute it.
-      alreadyCompiled->computeMetadata();
-    }
+    setMultiplyReferenced(alreadyCompiled, scope);
     return alreadyCompiled;
   }
 
@@ -375,6 +477,11 @@ ExprPtr compileExpression(
         resultType, std::move(compiledInputs), trackCpuUsage);
   } else if (auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
     VELOX_CHECK(!compiledInputs.empty());
+    if (*compiledInputs[0]->type() == *resultType) {
+      // A cast to the type of the input is a no-op.
+      scope->visited[expr.get()] = compiledInputs[0];
+      return compiledInputs[0];
+    }
     auto castExpr = std::make_shared<CastExpr>(
         resultType, std::move(compiledInputs[0]), trackCpuUsage);
     if (cast->nullOnFailure()) {
@@ -485,6 +592,10 @@ ExprPtr compileExpression(
   auto folded = enableConstantFolding && !isConstantExpr
       ? tryFoldIfConstant(result, scope)
       : result;
+  folded = getEquivalentCompiled(folded, scope);
+  if (config.exprFusedEvalEnabled()) {
+    folded = FusedExpr::tryFuse(std::move(folded));
+  }
   scope->visited[expr.get()] = folded;
   return folded;
 }
@@ -102,6 +102,8 @@ std::unique_ptr<T> asUniquePtr(std::unique_ptr<U> ptr) {
   return std::unique_ptr<T>(static_cast<T*>(ptr.release()));
 }
 
+} // namespace
+
 std::unique_ptr<common::Filter> makeOrFilter(
     std::unique_ptr<common::Filter> a,
     std::unique_ptr<common::Filter> b) {
@@ -135,6 +137,8 @@ std::unique_ptr<common::Filter> makeOrFilter(
   return orFilter(std::move(a), std::move(b));
 }
 
+namespace {
+
 std::unique_ptr<common::Filter> makeLessThanOrEqualFilter(
     const core::TypedExprPtr& upperExpr,
     core::ExpressionEvaluator* evaluator) {
@@ -326,4 +326,16 @@ std::string toString(
   return out.str();
 }
 
+bool FunctionCallKey::operator==(const FunctionCallKey& other) const {
+  if (name != other.name || argTypes.size() != other.argTypes.size()) {
+    return false;
+  }
+  for (auto i = 0; i < argTypes.size(); ++i) {
+    if (*argTypes[i] != *other.argTypes[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace facebook::velox::exec
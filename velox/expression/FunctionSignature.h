@@ -398,9 +398,32 @@ std::string toString(const std::vector<FunctionSignaturePtr>& signatures);
 std::string toString(
     const std::vector<std::shared_ptr<AggregateFunctionSignature>>& signatures);
 
+/// Name and argument types of a call. This is the key of the caches of
+/// resolved signatures in the function registries.
+struct FunctionCallKey {
+  std::string name;
+  std::vector<TypePtr> argTypes;
+
+  bool operator==(const FunctionCallKey& other) const;
+};
+
 } // namespace facebook::velox::exec
 
 namespace std {
+template <>
+struct hash<facebook::velox::exec::FunctionCallKey> {
+  using argument_type = facebook::velox::exec::FunctionCallKey;
+  using result_type = std::size_t;
+
+  result_type operator()(const argument_type& key) const noexcept {
+    size_t val = std::hash<std::string>{}(key.name);
+    for (const auto& type : key.argTypes) {
+      val = val * 31 + type->hashKind();
+    }
+    return val;
+  }
+};
+
 template <>
 struct hash<facebook::velox::exec::SignatureVariable> {
   using argument_type = facebook::velox::exec::SignatureVariable;
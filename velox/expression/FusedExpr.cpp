@@ -0,0 +1,651 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/FusedExpr.h"
+
+#include <limits>
+
+#include <folly/container/F14Map.h>
+
+#include "velox/expression/ConjunctExpr.h"
+#include "velox/expression/ConstantExpr.h"
+#include "velox/expression/FieldReference.h"
+
+namespace facebook::velox::exec {
+
+struct FusedExpr::Node {
+  enum class Op {
+    kField,
+    kConstant,
+    kPlus,
+    kMinus,
+    kMultiply,
+    kLt,
+    kLte,
+    kGt,
+    kGte,
+    kEq,
+    kNeq,
+    kAnd,
+    kOr,
+    kNot,
+  };
+
+  Op op;
+
+  // Kind of the result. BOOLEAN and integer results are held as int64_t and
+  // DOUBLE results as double.
+  TypeKind kind;
+
+  // Kind of the inputs of a comparison.
+  TypeKind inputKind{TypeKind::UNKNOWN};
+
+  FieldReference* field{nullptr};
+
+  int64_t intValue{0};
+  double doubleValue{0};
+
+  std::vector<std::shared_ptr<const Node>> inputs;
+};
+
+namespace {
+
+using Node = FusedExpr::Node;
+using Op = Node::Op;
+
+constexpr int32_t kBlockSize = 1024;
+
+bool isSupportedType(const Type& type) {
+  if (type.isDecimal() || type.isIntervalDayTime()) {
+    return false;
+  }
+  switch (type.kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::optional<Op> functionOp(const std::string& name) {
+  static const folly::F14FastMap<std::string, Op> kOps = {
+      {"plus", Op::kPlus},
+      {"minus", Op::kMinus},
+      {"multiply", Op::kMultiply},
+      {"lt", Op::kLt},
+      {"lte", Op::kLte},
+      {"gt", Op::kGt},
+      {"gte", Op::kGte},
+      {"eq", Op::kEq},
+      {"neq", Op::kNeq},
+      {"not", Op::kNot},
+  };
+  // Functions may be registered with a prefix, e.g. 'presto.default.plus'.
+  const auto pos = name.rfind('.');
+  auto it = kOps.find(pos == std::string::npos ? name : name.substr(pos + 1));
+  if (it == kOps.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+bool isArithmetic(Op op) {
+  return op == Op::kPlus || op == Op::kMinus || op == Op::kMultiply;
+}
+
+bool isComparison(Op op) {
+  return op >= Op::kLt && op <= Op::kNeq;
+}
+
+template <typename T>
+int64_t constantValue(const BaseVector& value) {
+  return value.as<ConstantVector<T>>()->valueAt(0);
+}
+
+// Returns the program for 'expr' or nullptr if 'expr' has parts that are not
+// supported.
+std::shared_ptr<const Node> makeNode(Expr* expr) {
+  if (auto fused = dynamic_cast<const FusedExpr*>(expr)) {
+    return fused->program();
+  }
+  const auto& type = expr->type();
+  if (!isSupportedType(*type)) {
+    return nullptr;
+  }
+
+  auto node = std::make_shared<Node>();
+  node->kind = type->kind();
+  if (auto field = dynamic_cast<FieldReference*>(expr)) {
+    // Only top level columns.
+    if (!field->inputs().empty()) {
+      return nullptr;
+    }
+    node->op = Op::kField;
+    node->field = field;
+    return node;
+  }
+
+  if (auto constant = dynamic_cast<const ConstantExpr*>(expr)) {
+    const auto& value = constant->value();
+    if (value->isNullAt(0)) {
+      return nullptr;
+    }
+    node->op = Op::kConstant;
+    switch (node->kind) {
+      case TypeKind::BOOLEAN:
+        node->intValue = constantValue<bool>(*value);
+        break;
+      case TypeKind::TINYINT:
+        node->intValue = constantValue<int8_t>(*value);
+        break;
+      case TypeKind::SMALLINT:
+        node->intValue = constantValue<int16_t>(*value);
+        break;
+      case TypeKind::INTEGER:
+        node->intValue = constantValue<int32_t>(*value);
+        break;
+      case TypeKind::BIGINT:
+        node->intValue = constantValue<int64_t>(*value);
+        break;
+      default:
+        node->doubleValue = value->as<ConstantVector<double>>()->valueAt(0);
+        break;
+    }
+    return node;
+  }
+
+  size_t numInputs = 2;
+  if (dynamic_cast<const ConjunctExpr*>(expr)) {
+    node->op = expr->name() == "and" ? Op::kAnd : Op::kOr;
+    numInputs = expr->inputs().size();
+  } else if (expr->isSpecialForm()) {
+    return nullptr;
+  } else if (auto op = functionOp(expr->name())) {
+    node->op = op.value();
+    if (node->op == Op::kNot) {
+      numInputs = 1;
+    }
+  } else {
+    return nullptr;
+  }
+
+  const auto& inputs = expr->inputs();
+  if (inputs.size() != numInputs) {
+    return nullptr;
+  }
+  if (isComparison(node->op)) {
+    node->inputKind = inputs[0]->type()->kind();
+  }
+  for (const auto& input : inputs) {
+    const auto inputKind = input->type()->kind();
+    if (isArithmetic(node->op)) {
+      if (inputKind != node->kind || node->kind == TypeKind::BOOLEAN) {
+        return nullptr;
+      }
+    } else if (isComparison(node->op)) {
+      if (inputKind != node->inputKind || node->kind != TypeKind::BOOLEAN) {
+        return nullptr;
+      }
+    } else if (
+        inputKind != TypeKind::BOOLEAN || node->kind != TypeKind::BOOLEAN) {
+      return nullptr;
+    }
+    auto inputNode = makeNode(input.get());
+    if (!inputNode) {
+      return nullptr;
+    }
+    node->inputs.push_back(std::move(inputNode));
+  }
+  return node;
+}
+
+// Block sized buffers for intermediate results. These are taken and returned
+// in LIFO order while evaluating a tree.
+template <typename T>
+class BufferPool {
+ public:
+  T* acquire() {
+    if (numUsed_ == buffers_.size()) {
+      buffers_.push_back(std::make_unique<T[]>(kBlockSize));
+    }
+    return buffers_[numUsed_++].get();
+  }
+
+  void release() {
+    VELOX_DCHECK_GT(numUsed_, 0);
+    --numUsed_;
+  }
+
+ private:
+  std::vector<std::unique_ptr<T[]>> buffers_;
+  size_t numUsed_{0};
+};
+
+template <typename T>
+bool inRange(const int64_t* values, int32_t numRows) {
+  bool result = true;
+  for (auto i = 0; i < numRows; ++i) {
+    result &= values[i] >= std::numeric_limits<T>::min() &&
+        values[i] <= std::numeric_limits<T>::max();
+  }
+  return result;
+}
+
+template <typename T, typename TOut>
+void gather(
+    const void* rawValues,
+    const vector_size_t* rows,
+    int32_t numRows,
+    TOut* result) {
+  auto* values = static_cast<const T*>(rawValues);
+  for (auto i = 0; i < numRows; ++i) {
+    result[i] = values[rows[i]];
+  }
+}
+
+class Evaluator {
+ public:
+  Evaluator(EvalCtx& context, const std::vector<const void*>& rawValues)
+      : context_(context), rawValues_(rawValues) {}
+
+  // Evaluates 'program' for 'rows' one block at a time and calls
+  // 'write(row, value)' for each row. Returns false if integer arithmetic
+  // overflows.
+  template <typename TStorage, typename TWrite>
+  bool run(
+      const Node& program,
+      const SelectivityVector& rows,
+      const TWrite& write) {
+    auto* values = acquire<TStorage>();
+    rowNumbers_.resize(kBlockSize);
+    int32_t numRows = 0;
+    auto flush = [&]() {
+      eval(program, rowNumbers_.data(), numRows, values);
+      for (auto i = 0; i < numRows; ++i) {
+        write(rowNumbers_[i], values[i]);
+      }
+      numRows = 0;
+    };
+    rows.applyToSelected([&](auto row) {
+      if (overflow_) {
+        return;
+      }
+      rowNumbers_[numRows++] = row;
+      if (numRows == kBlockSize) {
+        flush();
+      }
+    });
+    if (numRows > 0 && !overflow_) {
+      flush();
+    }
+    release<TStorage>();
+    return !overflow_;
+  }
+
+ private:
+  template <typename T>
+  T* acquire() {
+    if constexpr (std::is_same_v<T, double>) {
+      return doubles_.acquire();
+    } else {
+      return ints_.acquire();
+    }
+  }
+
+  template <typename T>
+  void release() {
+    if constexpr (std::is_same_v<T, double>) {
+      doubles_.release();
+    } else {
+      ints_.release();
+    }
+  }
+
+  // Writes the values of 'node' for 'rows' into 'result', which is an array
+  // of double for DOUBLE and of int64_t otherwise.
+  void eval(
+      const Node& node,
+      const vector_size_t* rows,
+      int32_t numRows,
+      void* result) {
+    switch (node.op) {
+      case Op::kField:
+        readField(node, rows, numRows, result);
+        return;
+      case Op::kConstant:
+        if (node.kind == TypeKind::DOUBLE) {
+          std::fill_n(static_cast<double*>(result), numRows, node.doubleValue);
+        } else {
+          std::fill_n(static_cast<int64_t*>(result), numRows, node.intValue);
+        }
+        return;
+      case Op::kPlus:
+      case Op::kMinus:
+      case Op::kMultiply:
+        if (node.kind == TypeKind::DOUBLE) {
+          arithmetic<double>(node, rows, numRows, result);
+        } else {
+          arithmetic<int64_t>(node, rows, numRows, result);
+        }
+        return;
+      case Op::kLt:
+      case Op::kLte:
+      case Op::kGt:
+      case Op::kGte:
+      case Op::kEq:
+      case Op::kNeq:
+        if (node.inputKind == TypeKind::DOUBLE) {
+          compare<double>(node, rows, numRows, result);
+        } else {
+          compare<int64_t>(node, rows, numRows, result);
+        }
+        return;
+      case Op::kAnd:
+      case Op::kOr:
+        conjunct(node, rows, numRows, static_cast<int64_t*>(result));
+        return;
+      case Op::kNot: {
+        auto* values = static_cast<int64_t*>(result);
+        eval(*node.inputs[0], rows, numRows, values);
+        for (auto i = 0; i < numRows; ++i) {
+          values[i] ^= 1;
+        }
+        return;
+      }
+    }
+  }
+
+  void readField(
+      const Node& node,
+      const vector_size_t* rows,
+      int32_t numRows,
+      void* result) {
+    const auto* raw = rawValues_[node.field->index(context_)];
+    auto* ints = static_cast<int64_t*>(result);
+    switch (node.kind) {
+      case TypeKind::BOOLEAN: {
+        auto* bits = static_cast<const uint64_t*>(raw);
+        for (auto i = 0; i < numRows; ++i) {
+          ints[i] = bits::isBitSet(bits, rows[i]);
+        }
+        return;
+      }
+      case TypeKind::TINYINT:
+        gather<int8_t>(raw, rows, numRows, ints);
+        return;
+      case TypeKind::SMALLINT:
+        gather<int16_t>(raw, rows, numRows, ints);
+        return;
+      case TypeKind::INTEGER:
+        gather<int32_t>(raw, rows, numRows, ints);
+        return;
+      case TypeKind::BIGINT:
+        gather<int64_t>(raw, rows, numRows, ints);
+        return;
+      case TypeKind::DOUBLE:
+        gather<double>(raw, rows, numRows, static_cast<double*>(result));
+        return;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+
+  template <typename T>
+  void arithmetic(
+      const Node& node,
+      const vector_size_t* rows,
+      int32_t numRows,
+      void* result) {
+    auto* left = acquire<T>();
+    auto* right = acquire<T>();
+    eval(*node.inputs[0], rows, numRows, left);
+    eval(*node.inputs[1], rows, numRows, right);
+    auto* values = static_cast<T*>(result);
+    if constexpr (std::is_same_v<T, double>) {
+      for (auto i = 0; i < numRows; ++i) {
+        values[i] = node.op == Op::kPlus ? left[i] + right[i]
+            : node.op == Op::kMinus      ? left[i] - right[i]
+                                         : left[i] * right[i];
+      }
+    } else {
+      // Overflow of the narrower types is detected by the range check below.
+      bool overflow = false;
+      switch (node.op) {
+        case Op::kPlus:
+          for (auto i = 0; i < numRows; ++i) {
+            overflow |= __builtin_add_overflow(left[i], right[i], &values[i]);
+          }
+          break;
+        case Op::kMinus:
+          for (auto i = 0; i < numRows; ++i) {
+            overflow |= __builtin_sub_overflow(left[i], right[i], &values[i]);
+          }
+          break;
+        default:
+          for (auto i = 0; i < numRows; ++i) {
+            overflow |= __builtin_mul_overflow(left[i], right[i], &values[i]);
+          }
+          break;
+      }
+      switch (node.kind) {
+        case TypeKind::TINYINT:
+          overflow |= !inRange<int8_t>(values, numRows);
+          break;
+        case TypeKind::SMALLINT:
+          overflow |= !inRange<int16_t>(values, numRows);
+          break;
+        case TypeKind::INTEGER:
+          overflow |= !inRange<int32_t>(values, numRows);
+          break;
+        default:
+          break;
+      }
+      overflow_ |= overflow;
+    }
+    release<T>();
+    release<T>();
+  }
+
+  template <typename T>
+  void compare(
+      const Node& node,
+      const vector_size_t* rows,
+      int32_t numRows,
+      void* result) {
+    auto* left = acquire<T>();
+    auto* right = acquire<T>();
+    eval(*node.inputs[0], rows, numRows, left);
+    eval(*node.inputs[1], rows, numRows, right);
+    auto* values = static_cast<int64_t*>(result);
+    switch (node.op) {
+      case Op::kLt:
+        for (auto i = 0; i < numRows; ++i) {
+          values[i] = left[i] < right[i];
+        }
+        break;
+      case Op::kLte:
+        for (auto i = 0; i < numRows; ++i) {
+          values[i] = left[i] <= right[i];
+        }
+        break;
+      case Op::kGt:
+        for (auto i = 0; i < numRows; ++i) {
+          values[i] = left[i] > right[i];
+        }
+        break;
+      case Op::kGte:
+        for (auto i = 0; i < numRows; ++i) {
+          values[i] = left[i] >= right[i];
+        }
+        break;
+      case Op::kEq:
+        for (auto i = 0; i < numRows; ++i) {
+          values[i] = left[i] == right[i];
+        }
+        break;
+      default:
+        for (auto i = 0; i < numRows; ++i) {
+          values[i] = left[i] != right[i];
+        }
+        break;
+    }
+    release<T>();
+    release<T>();
+  }
+
+  // Without nulls and errors, evaluating all conjuncts on all rows gives the
+  // same result as the regular evaluation, which skips decided rows.
+  void conjunct(
+      const Node& node,
+      const vector_size_t* rows,
+      int32_t numRows,
+      int64_t* result) {
+    eval(*node.inputs[0], rows, numRows, result);
+    auto* other = acquire<int64_t>();
+    for (auto i = 1; i < node.inputs.size(); ++i) {
+      eval(*node.inputs[i], rows, numRows, other);
+      if (node.op == Op::kAnd) {
+        for (auto j = 0; j < numRows; ++j) {
+          result[j] &= other[j];
+        }
+      } else {
+        for (auto j = 0; j < numRows; ++j) {
+          result[j] |= other[j];
+        }
+      }
+    }
+    release<int64_t>();
+  }
+
+  EvalCtx& context_;
+  const std::vector<const void*>& rawValues_;
+  BufferPool<int64_t> ints_;
+  BufferPool<double> doubles_;
+  std::vector<vector_size_t> rowNumbers_;
+  bool overflow_{false};
+};
+
+template <typename T>
+bool runFlat(
+    Evaluator& evaluator,
+    const Node& program,
+    const SelectivityVector& rows,
+    BaseVector& result) {
+  auto* rawResult = result.asUnchecked<FlatVector<T>>()->mutableRawValues();
+  using TStorage = std::conditional_t<std::is_same_v<T, double>, T, int64_t>;
+  return evaluator.run<TStorage>(
+      program, rows, [&](vector_size_t row, TStorage value) {
+        rawResult[row] = static_cast<T>(value);
+      });
+}
+
+} // namespace
+
+FusedExpr::FusedExpr(ExprPtr fallback, std::shared_ptr<const Node> program)
+    : SpecialForm(
+          fallback->type(),
+          {fallback},
+          "fused",
+          false /* supportsFlatNoNullsFastPath */,
+          false /* trackCpuUsage */),
+      program_(std::move(program)) {}
+
+// static
+ExprPtr FusedExpr::tryFuse(ExprPtr expr) {
+  if (dynamic_cast<const FieldReference*>(expr.get()) ||
+      dynamic_cast<const ConstantExpr*>(expr.get()) ||
+      dynamic_cast<const FusedExpr*>(expr.get())) {
+    return expr;
+  }
+  auto program = makeNode(expr.get());
+  if (!program) {
+    return expr;
+  }
+  auto fused = std::make_shared<FusedExpr>(std::move(expr), std::move(program));
+  fused->computeMetadata();
+  return fused;
+}
+
+void FusedExpr::evalSpecialForm(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  if (tryEvalFused(rows, context, result)) {
+    ++numFusedBatches_;
+    return;
+  }
+  ++numFallbackBatches_;
+  inputs_[0]->eval(rows, context, result);
+}
+
+bool FusedExpr::tryEvalFused(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  for (auto* reference : distinctFields()) {
+    const auto index = reference->index(context);
+    const auto& field = context.getField(index);
+    // Vectors that are not loaded are left to the regular evaluation, which
+    // loads them only for the rows that need them.
+    if (!field || isLazyNotLoaded(*field)) {
+      return false;
+    }
+    const auto* vector = field->loadedVector();
+    if (vector->encoding() != VectorEncoding::Simple::FLAT ||
+        vector->size() < rows.end() ||
+        BaseVector::countNulls(vector->nulls(), rows.begin(), rows.end()) >
+            0) {
+      return false;
+    }
+    if (index >= rawValues_.size()) {
+      rawValues_.resize(index + 1);
+    }
+    rawValues_[index] = vector->values()->as<void>();
+  }
+
+  context.ensureWritable(rows, type(), result);
+  result->clearNulls(rows);
+  Evaluator evaluator(context, rawValues_);
+  switch (type()->kind()) {
+    case TypeKind::BOOLEAN: {
+      auto* rawResult =
+          result->asUnchecked<FlatVector<bool>>()->mutableRawValues<uint64_t>();
+      return evaluator.run<int64_t>(
+          *program_, rows, [&](vector_size_t row, int64_t value) {
+            bits::setBit(rawResult, row, value != 0);
+          });
+    }
+    case TypeKind::TINYINT:
+      return runFlat<int8_t>(evaluator, *program_, rows, *result);
+    case TypeKind::SMALLINT:
+      return runFlat<int16_t>(evaluator, *program_, rows, *result);
+    case TypeKind::INTEGER:
+      return runFlat<int32_t>(evaluator, *program_, rows, *result);
+    case TypeKind::BIGINT:
+      return runFlat<int64_t>(evaluator, *program_, rows, *result);
+    case TypeKind::DOUBLE:
+      return runFlat<double>(evaluator, *program_, rows, *result);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/expression/SpecialForm.h"
+
+namespace facebook::velox::exec {
+
+/// Evaluates a tree of arithmetic, comparison and logical expressions over
+/// top level numeric columns and constants in one pass over blocks of rows.
+/// The intermediate results stay in small buffers instead of vectors and
+/// there is no function call per node. This is used for batches where the
+/// columns are flat and have no nulls. Other batches, and batches where
+/// integer arithmetic overflows, are evaluated by the regular expression
+/// tree, which is the only input of 'this'.
+class FusedExpr : public SpecialForm {
+ public:
+  struct Node;
+
+  FusedExpr(ExprPtr fallback, std::shared_ptr<const Node> program);
+
+  /// Returns 'expr' wrapped in a FusedExpr if the tree under it consists of
+  /// supported functions, columns and constants and has at least one
+  /// function. Returns 'expr' otherwise.
+  static ExprPtr tryFuse(ExprPtr expr);
+
+  void evalSpecialForm(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result) override;
+
+  std::string toString(bool recursive = true) const override {
+    return inputs_[0]->toString(recursive);
+  }
+
+  std::string toSql(std::vector<VectorPtr>* FOLLY_NULLABLE
+                        complexConstants = nullptr) const override {
+    return inputs_[0]->toSql(complexConstants);
+  }
+
+  const std::shared_ptr<const Node>& program() const {
+    return program_;
+  }
+
+  /// Number of batches evaluated by the fused loops.
+  uint64_t numFusedBatches() const {
+    return numFusedBatches_;
+  }
+
+  /// Number of batches evaluated by the regular expression tree.
+  uint64_t numFallbackBatches() const {
+    return numFallbackBatches_;
+  }
+
+ private:
+  // Evaluates 'program_' for 'rows'. Returns false without a complete
+  // 'result' if the inputs are not flat without nulls or if the integer
+  // arithmetic overflows.
+  bool tryEvalFused(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
+  const std::shared_ptr<const Node> program_;
+
+  // Raw values of the columns of the current batch by column index.
+  std::vector<const void*> rawValues_;
+
+  uint64_t numFusedBatches_{0};
+  uint64_t numFallbackBatches_{0};
+};
+
+} // namespace facebook::velox::exec
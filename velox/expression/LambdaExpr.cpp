@@ -41,6 +41,15 @@ class ExprCallable : public Callable {
     return capture_->childrenSize() > signature_->size();
   }
 
+  bool needsWrapCapture() const override {
+    for (auto i = signature_->size(); i < capture_->childrenSize(); ++i) {
+      if (!capture_->childAt(i)->isConstantEncoding()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   void apply(
       const SelectivityVector& rows,
       const SelectivityVector& finalSelection,
@@ -111,6 +120,9 @@ class ExprCallable : public Callable {
       if (wrapCapture) {
         values = BaseVector::wrapInDictionary(
             BufferPtr(nullptr), wrapCapture, size, values);
+      } else if (values->isConstantEncoding() && values->size() != size) {
+        // Constant captures are not wrapped, see needsWrapCapture().
+        values = BaseVector::wrapInConstant(size, 0, values);
       }
       allVectors.push_back(values);
     }
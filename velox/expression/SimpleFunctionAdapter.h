@@ -138,6 +138,41 @@ class SimpleFunctionAdapter : public VectorFunction {
   /// primitivies.
   static constexpr bool specializeForAllEncodings = FUNC::num_args <= 3;
 
+  /// True if callBatch() is used for batches where all rows in the range are
+  /// selected and all arguments are flat or constant and not null.
+  constexpr bool static isBatchIterationEligible() {
+    return FUNC::udf_has_callBatch && FUNC::is_default_null_behavior &&
+        fastPathIteration &&
+        return_type_traits::typeKind != TypeKind::BOOLEAN &&
+        allArgsFlatConstantFastPathEligible();
+  }
+
+  /// Number of rows passed to one callBatch().
+  static constexpr vector_size_t kBatchSize = 1'024;
+
+  /// Values of a flat or constant argument for callBatch(). Constants are
+  /// repeated for the size of a batch.
+  template <typename TValue>
+  class BatchArg {
+   public:
+    explicit BatchArg(const BaseVector& arg) {
+      if (arg.isConstantEncoding()) {
+        constants_.resize(
+            kBatchSize, arg.asUnchecked<ConstantVector<TValue>>()->valueAt(0));
+      } else {
+        values_ = arg.asUnchecked<FlatVector<TValue>>()->rawValues();
+      }
+    }
+
+    const TValue* values(vector_size_t offset) const {
+      return constants_.empty() ? values_ + offset : constants_.data();
+    }
+
+   private:
+    const TValue* values_{nullptr};
+    std::vector<TValue> constants_;
+  };
+
   /// If the initialize() method provided by functions throw, we don't (can't)
   /// throw immediately; rather, we capture the exception using this member
   /// variable and set that as error for every single active row. This is
@@ -330,8 +365,15 @@ class SimpleFunctionAdapter : public VectorFunction {
       }
     }
 
+    bool isBatchApplied = false;
+    if constexpr (isBatchIterationEligible()) {
+      isBatchApplied = tryApplyBatch(applyContext, args);
+    }
+
     std::vector<std::optional<LocalDecodedVector>> decoded;
-    if (allPrimitiveArgsFlatConstant(args)) {
+    if (isBatchApplied) {
+      // All rows were written by callBatch().
+    } else if (allPrimitiveArgsFlatConstant(args)) {
       if constexpr (
           allArgsFlatConstantFastPathEligible() && specializeForAllEncodings) {
         unpackSpecializeForAllEncodings<0>(applyContext, args);
@@ -430,6 +472,48 @@ class SimpleFunctionAdapter : public VectorFunction {
   }
 
  private:
+  // Calls callBatch() for up to kBatchSize rows at a time if all rows in the
+  // range of 'rows' are selected and all arguments are flat or constant and
+  // not null. Returns false without writing results otherwise.
+  bool tryApplyBatch(
+      ApplyContext& applyContext,
+      const std::vector<VectorPtr>& args) const {
+    const auto& rows = *applyContext.rows;
+    if (!rows.isAllSelected()) {
+      return false;
+    }
+    for (const auto& arg : args) {
+      if (arg->isConstantEncoding()) {
+        if (arg->isNullAt(0)) {
+          return false;
+        }
+      } else if (
+          !arg->isFlatEncoding() ||
+          BaseVector::countNulls(arg->nulls(), rows.begin(), rows.end()) > 0) {
+        return false;
+      }
+    }
+    applyBatch(applyContext, args, std::make_index_sequence<FUNC::num_args>());
+    return true;
+  }
+
+  template <size_t... Is>
+  void applyBatch(
+      ApplyContext& applyContext,
+      const std::vector<VectorPtr>& args,
+      std::index_sequence<Is...>) const {
+    std::tuple<BatchArg<exec_arg_at<Is>>...> batchArgs{
+        BatchArg<exec_arg_at<Is>>(*args[Is])...};
+    auto* data = applyContext.resultWriter.data_;
+    const auto end = applyContext.rows->end();
+    for (auto offset = applyContext.rows->begin(); offset < end;
+         offset += kBatchSize) {
+      const auto size = std::min(kBatchSize, end - offset);
+      (*fn_).callBatch(
+          data + offset, std::get<Is>(batchArgs).values(offset)..., size);
+    }
+  }
+
   // This is called only when we know that all args are flat or constant and are
   // eligible for the optimization and the optimization is enabled.
   template <int32_t POSITION, typename... TReader>
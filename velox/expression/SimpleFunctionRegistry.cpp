@@ -16,6 +16,8 @@
 
 #include "velox/expression/SimpleFunctionRegistry.h"
 
+#include <tuple>
+
 namespace facebook::velox::exec {
 namespace {
 
@@ -42,10 +44,14 @@ void SimpleFunctionRegistry::registerFunctionInternal(
     SignatureMap& signatureMap = map[sanitizedName];
     signatureMap[*metadata->signature()] =
         std::make_unique<const FunctionEntry>(metadata, factory);
+    resolvedFunctions_.wlock()->clear();
   });
 }
 
 namespace {
+// Upper bound of cached resolutions. The cache is cleared when full.
+constexpr size_t kMaxResolvedFunctions = 10'000;
+
 // This function is not thread safe should be called only from within a
 // syncrhronized read region of registeredFunctions_.
 const SignatureMap* getSignatureMap(
@@ -79,6 +85,15 @@ SimpleFunctionRegistry::resolveFunction(
   const FunctionEntry* selectedCandidate = nullptr;
   TypePtr selectedCandidateType = nullptr;
   registeredFunctions_.withRLock([&](const auto& map) {
+    FunctionCallKey key{sanitizeName(name), argTypes};
+    {
+      auto resolved = resolvedFunctions_.rlock();
+      auto it = resolved->find(key);
+      if (it != resolved->end()) {
+        std::tie(selectedCandidate, selectedCandidateType) = it->second;
+        return;
+      }
+    }
     if (const auto* signatureMap = getSignatureMap(name, map)) {
       for (const auto& [candidateSignature, functionEntry] : *signatureMap) {
         SignatureBinder binder(candidateSignature, argTypes);
@@ -93,6 +108,12 @@ SimpleFunctionRegistry::resolveFunction(
         }
       }
     }
+    resolvedFunctions_.withWLock([&](auto& resolved) {
+      if (resolved.size() >= kMaxResolvedFunctions) {
+        resolved.clear();
+      }
+      resolved[std::move(key)] = {selectedCandidate, selectedCandidateType};
+    });
   });
 
   VELOX_DCHECK(!selectedCandidate || selectedCandidateType);
@@ -85,7 +85,10 @@ class SimpleFunctionRegistry {
   }
 
   void clearRegistry() {
-    registeredFunctions_.withWLock([&](auto& map) { map.clear(); });
+    registeredFunctions_.withWLock([&](auto& map) {
+      map.clear();
+      resolvedFunctions_.wlock()->clear();
+    });
   }
 
   std::vector<const FunctionSignature*> getFunctionSignatures(
@@ -131,6 +134,15 @@ class SimpleFunctionRegistry {
       const FunctionFactory& factory);
 
   folly::Synchronized<FunctionMap> registeredFunctions_;
+
+  // Signatures resolved by resolveFunction(), nullptr if no signature
+  // matches. Entries are added while holding the read lock of
+  // 'registeredFunctions_' and cleared while holding its write lock, so that
+  // these never refer to replaced entries.
+  mutable folly::Synchronized<std::unordered_map<
+      FunctionCallKey,
+      std::pair<const FunctionEntry*, TypePtr>>>
+      resolvedFunctions_;
 };
 
 const SimpleFunctionRegistry& simpleFunctions();
@@ -38,20 +38,80 @@ std::optional<std::vector<FunctionSignaturePtr>> getVectorFunctionSignatures(
       });
 }
 
+namespace {
+// Return type of a call as resolved against 'signatures'. The resolution is
+// valid while the function has the same signatures.
+struct ResolvedVectorFunction {
+  std::vector<FunctionSignaturePtr> signatures;
+  TypePtr returnType;
+};
+
+// Upper bound of cached resolutions. The cache is cleared when full.
+constexpr size_t kMaxResolvedVectorFunctions = 10'000;
+
+folly::Synchronized<
+    std::unordered_map<FunctionCallKey, ResolvedVectorFunction>>&
+resolvedVectorFunctions() {
+  static folly::Synchronized<
+      std::unordered_map<FunctionCallKey, ResolvedVectorFunction>>
+      resolved;
+  return resolved;
+}
+
+bool isSameSignatures(
+    const std::vector<FunctionSignaturePtr>& left,
+    const std::vector<FunctionSignaturePtr>& right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (auto i = 0; i < left.size(); ++i) {
+    if (left[i] != right[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
 std::shared_ptr<const Type> resolveVectorFunction(
     const std::string& functionName,
     const std::vector<TypePtr>& argTypes) {
-  if (auto vectorFunctionSignatures =
-          exec::getVectorFunctionSignatures(functionName)) {
-    for (const auto& signature : vectorFunctionSignatures.value()) {
-      exec::SignatureBinder binder(*signature, argTypes);
-      if (binder.tryBind()) {
-        return binder.tryResolveReturnType();
-      }
+  auto vectorFunctionSignatures =
+      exec::getVectorFunctionSignatures(functionName);
+  if (!vectorFunctionSignatures) {
+    return nullptr;
+  }
+
+  // Binding the signatures is costly compared to the lookup, so the result
+  // is cached. The signatures are compared by identity, so that the cached
+  // result is not used after the function is registered again.
+  FunctionCallKey key{sanitizeName(functionName), argTypes};
+  const auto& signatures = vectorFunctionSignatures.value();
+  {
+    auto resolved = resolvedVectorFunctions().rlock();
+    auto it = resolved->find(key);
+    if (it != resolved->end() &&
+        isSameSignatures(it->second.signatures, signatures)) {
+      return it->second.returnType;
     }
   }
 
-  return nullptr;
+  TypePtr returnType;
+  for (const auto& signature : signatures) {
+    exec::SignatureBinder binder(*signature, argTypes);
+    if (binder.tryBind()) {
+      returnType = binder.tryResolveReturnType();
+      break;
+    }
+  }
+
+  resolvedVectorFunctions().withWLock([&](auto& resolved) {
+    if (resolved.size() >= kMaxResolvedVectorFunctions) {
+      resolved.clear();
+    }
+    resolved[std::move(key)] = {signatures, returnType};
+  });
+  return returnType;
 }
 
 std::shared_ptr<VectorFunction> getVectorFunction(
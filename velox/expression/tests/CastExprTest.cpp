@@ -539,6 +539,56 @@ TEST_F(CastExprTest, errorHandling) {
       "tinyint", {"1", "2", "3", "100", "-100.5"}, {1, 2, 3, 100, -100}, true);
 }
 
+TEST_F(CastExprTest, numbersAndStrings) {
+  // Only the invalid rows take the slow path and become null.
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"1", "-9223372036854775808", "x", "9223372036854775807", std::nullopt},
+      {1,
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt,
+       std::numeric_limits<int64_t>::max(),
+       std::nullopt},
+      false,
+      true);
+  testCast<std::string, int16_t>(
+      "smallint",
+      {"1", "32768", "-32768"},
+      {1, std::nullopt, -32768},
+      false,
+      true);
+  testCast<std::string, double>(
+      "double",
+      {"1.5", "abc", "-1e10", "", std::nullopt},
+      {1.5, std::nullopt, -1e10, std::nullopt, std::nullopt},
+      false,
+      true);
+  testCast<std::string, int32_t>("integer", {"1", "2", "3.5"}, {}, true);
+
+  testCast<int64_t, std::string>(
+      "varchar",
+      {0,
+       -1,
+       1234567890123,
+       std::numeric_limits<int64_t>::min(),
+       std::numeric_limits<int64_t>::max(),
+       std::nullopt},
+      {"0",
+       "-1",
+       "1234567890123",
+       "-9223372036854775808",
+       "9223372036854775807",
+       std::nullopt});
+  testCast<int8_t, std::string>("varchar", {-128, 127}, {"-128", "127"});
+  testCast<double, std::string>(
+      "varchar", {0.1, -2.0, 1.5e-3}, {"0.1", "-2", "0.0015"});
+
+  setCastIntByTruncate(true);
+  testCast<double, std::string>("varchar", {-2.0, 0.5}, {"-2.0", "0.5"});
+  testCast<int32_t, std::string>("varchar", {-7, 42}, {"-7", "42"});
+  setCastIntByTruncate(false);
+}
+
 constexpr vector_size_t kVectorSize = 1'000;
 
 TEST_F(CastExprTest, mapCast) {
@@ -18,6 +18,7 @@
 #include "gtest/gtest.h"
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/expression/DecodedArgs.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
@@ -53,6 +54,45 @@ TEST_F(EvalCtxTest, selectivityVectors) {
   EXPECT_EQ(all100, *local2.get());
 }
 
+TEST_F(EvalCtxTest, decodedArgs) {
+  EvalCtx context(&execCtx_);
+  auto flat = makeFlatVector<int64_t>(100, [](auto row) { return row; });
+  auto base = makeFlatVector<int64_t>(100, [](auto row) { return row * 10; });
+  VectorPtr dictionary =
+      wrapInDictionary(makeIndicesInReverse(100), 100, base);
+  SelectivityVector rows(100);
+  SelectivityVector firstHalf(100);
+  firstHalf.setValidRange(50, 100, false);
+  firstHalf.updateBounds();
+
+  // Flat vectors are not kept.
+  EXPECT_EQ(nullptr, context.getDecodedArg(flat, rows));
+
+  auto* decoded = context.getDecodedArg(dictionary, firstHalf);
+  ASSERT_NE(nullptr, decoded);
+  EXPECT_EQ(990, decoded->valueAt<int64_t>(0));
+  // Reused for the same or fewer rows but not for more rows.
+  EXPECT_EQ(decoded, context.getDecodedArg(dictionary, firstHalf));
+  EXPECT_EQ(nullptr, context.getDecodedArg(dictionary, rows));
+
+  {
+    DecodedArgs args(firstHalf, {flat, dictionary}, context);
+    EXPECT_NE(decoded, args.at(0));
+    EXPECT_EQ(decoded, args.at(1));
+    EXPECT_EQ(10, args.at(0)->valueAt<int64_t>(10));
+  }
+  {
+    DecodedArgs args(rows, {dictionary}, context);
+    EXPECT_NE(decoded, args.at(0));
+    EXPECT_EQ(0, args.at(0)->valueAt<int64_t>(99));
+  }
+
+  context.clearDecodedArgs();
+  decoded = context.getDecodedArg(dictionary, rows);
+  ASSERT_NE(nullptr, decoded);
+  EXPECT_EQ(0, decoded->valueAt<int64_t>(99));
+}
+
 TEST_F(EvalCtxTest, vectorPool) {
   EvalCtx context(&execCtx_);
 
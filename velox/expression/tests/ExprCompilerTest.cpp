@@ -183,6 +183,55 @@ TEST_F(ExprCompilerTest, concatFlattening) {
       compile(expression)->toString());
 }
 
+TEST_F(ExprCompilerTest, normalizedCommonSubexpressions) {
+  auto rowType = ROW({"a", "b"}, {BIGINT(), BIGINT()});
+
+  auto field = makeField(rowType);
+  auto castToBigint = [](const core::TypedExprPtr& input) {
+    return std::make_shared<core::CastTypedExpr>(
+        BIGINT(), std::vector<core::TypedExprPtr>{input}, false);
+  };
+
+  auto exprSet = std::make_unique<ExprSet>(
+      std::vector<core::TypedExprPtr>{
+          call("plus", {field("a"), field("b")}),
+          call("plus", {field("b"), field("a")}),
+          call("multiply", {field("a"), call("plus", {bigint(1), bigint(1)})}),
+          call("multiply", {field("a"), bigint(2)}),
+          call("plus", {castToBigint(field("a")), bigint(1)}),
+          call("plus", {field("a"), bigint(1)}),
+          call("minus", {field("a"), field("b")}),
+          call("minus", {field("b"), field("a")}),
+      },
+      execCtx_.get());
+  auto& exprs = exprSet->exprs();
+
+  // The arguments of a commutative function are not ordered.
+  ASSERT_EQ(exprs[0], exprs[1]);
+  ASSERT_TRUE(exprs[0]->isMultiplyReferenced());
+  // Constant folding makes equivalent inputs.
+  ASSERT_EQ(exprs[2], exprs[3]);
+  // A cast to the same type is a no-op.
+  ASSERT_EQ(exprs[4], exprs[5]);
+  ASSERT_EQ("plus(a, 1:BIGINT)", exprs[4]->toString());
+  // The order matters for other functions.
+  ASSERT_NE(exprs[6], exprs[7]);
+
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 3}),
+      makeFlatVector<int64_t>({10, 20, 30}),
+  });
+  exec::EvalCtx context(execCtx_.get(), exprSet.get(), data.get());
+  SelectivityVector rows(data->size());
+  std::vector<VectorPtr> result(exprs.size());
+  exprSet->eval(rows, context, result);
+  assertEqualVectors(makeFlatVector<int64_t>({11, 22, 33}), result[1]);
+  assertEqualVectors(makeFlatVector<int64_t>({2, 4, 6}), result[3]);
+  assertEqualVectors(makeFlatVector<int64_t>({2, 3, 4}), result[4]);
+  assertEqualVectors(makeFlatVector<int64_t>({-9, -18, -27}), result[6]);
+  assertEqualVectors(makeFlatVector<int64_t>({9, 18, 27}), result[7]);
+}
+
 TEST_F(ExprCompilerTest, functionNameNotRegistered) {
   auto expression = std::make_shared<core::CallTypedExpr>(
       VARCHAR(),
@@ -26,6 +26,7 @@
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/ConstantExpr.h"
+#include "velox/expression/FusedExpr.h"
 #include "velox/functions/Udf.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
@@ -452,6 +453,130 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, conjunctStats) {
+  constexpr int32_t kTestSize = 1'000;
+
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(kTestSize, [](auto row) { return row; }),
+       makeFlatVector<int64_t>(kTestSize, [](auto row) { return row; })});
+  auto rowType = asRowType(data->type());
+  const std::string expression = "c0 < 900 and c1 < 100";
+
+  // Returns the number of rows the conjunct on 'column' was evaluated on.
+  auto numInputRows = [](const exec::ExprSet& exprSet,
+                         const std::string& column) -> uint64_t {
+    auto stats = exprSet.stats();
+    for (const auto& [input, conjunct] : stats["and"].conjuncts) {
+      if (input.find(column) != std::string::npos) {
+        return conjunct.numInputRows;
+      }
+    }
+    return 0;
+  };
+
+  auto exprSet = compileExpression(expression, rowType);
+  evaluate(exprSet.get(), data);
+  auto stats = exprSet->stats();
+  ASSERT_EQ(stats["and"].conjuncts.size(), 2);
+  for (const auto& [input, conjunct] : stats["and"].conjuncts) {
+    if (input.find("c0") != std::string::npos) {
+      ASSERT_EQ(conjunct.numInputRows, kTestSize);
+      ASSERT_EQ(conjunct.numPassedRows, 900);
+    } else {
+      ASSERT_EQ(conjunct.numInputRows, 900);
+      ASSERT_EQ(conjunct.numPassedRows, 100);
+      ASSERT_DOUBLE_EQ(conjunct.passRate(), 100.0 / 900);
+    }
+  }
+
+  // Expressions that use the history start with the order learned by the
+  // earlier ones.
+  exec::ConjunctExpr::clearHistory();
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      nullptr,
+      std::unordered_map<std::string, std::string>{
+          {core::QueryConfig::kAdaptiveFilterReorderingUseHistory, "true"}});
+  core::ExecCtx execCtx(pool(), queryCtx.get());
+  auto evaluateWithHistory = [&](exec::ExprSet& exprSet) {
+    exec::EvalCtx context(&execCtx, &exprSet, data.get());
+    SelectivityVector rows(data->size());
+    std::vector<VectorPtr> result(1);
+    exprSet.eval(rows, context, result);
+  };
+  {
+    exec::ExprSet learning({parseExpression(expression, rowType)}, &execCtx);
+    for (auto i = 0; i < 10; ++i) {
+      evaluateWithHistory(learning);
+    }
+  }
+  exec::ExprSet seeded({parseExpression(expression, rowType)}, &execCtx);
+  evaluateWithHistory(seeded);
+  ASSERT_EQ(numInputRows(seeded, "c1"), kTestSize);
+  ASSERT_EQ(numInputRows(seeded, "c0"), 100);
+  exec::ConjunctExpr::clearHistory();
+}
+
+TEST_F(ExprTest, fusedEval) {
+  constexpr int32_t kTestSize = 3'000;
+
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(kTestSize, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(kTestSize, [](auto row) { return row % 7; }),
+      makeFlatVector<double>(kTestSize, [](auto row) { return row * 0.1; }),
+      makeFlatVector<int32_t>(
+          kTestSize, [](auto row) { return row == 10 ? 1 << 30 : row; }),
+      makeFlatVector<int32_t>(kTestSize, [](auto /*row*/) { return 4; }),
+  });
+  auto rowType = asRowType(data->type());
+
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      nullptr,
+      std::unordered_map<std::string, std::string>{
+          {core::QueryConfig::kExprFusedEvalEnabled, "true"}});
+  core::ExecCtx execCtx(pool(), queryCtx.get());
+  auto evaluateFused = [&](exec::ExprSet& exprSet, const RowVectorPtr& input) {
+    exec::EvalCtx context(&execCtx, &exprSet, input.get());
+    SelectivityVector rows(input->size());
+    std::vector<VectorPtr> result(1);
+    exprSet.eval(rows, context, result);
+    return result[0];
+  };
+
+  for (const auto& expression :
+       {"c0 + c1 * 3 > 100 and not (c2 < 5.5)",
+        "c0 * 3 - c1",
+        "c2 * 2.0 - c2 > 12.5 or c1 <> 2",
+        "c3 - c4"}) {
+    SCOPED_TRACE(expression);
+    exec::ExprSet exprSet({parseExpression(expression, rowType)}, &execCtx);
+    auto fused = dynamic_cast<exec::FusedExpr*>(exprSet.expr(0).get());
+    ASSERT_NE(fused, nullptr);
+    assertEqualVectors(
+        evaluate(expression, data), evaluateFused(exprSet, data));
+    ASSERT_EQ(fused->numFusedBatches(), 1);
+
+    // Inputs with nulls use the regular evaluation.
+    auto withNulls = makeRowVector({
+        makeNullableFlatVector<int64_t>({1, std::nullopt, 3}),
+        makeNullableFlatVector<int64_t>({1, std::nullopt, 3}),
+        makeNullableFlatVector<double>({1, std::nullopt, 3}),
+        makeNullableFlatVector<int32_t>({1, std::nullopt, 3}),
+        makeNullableFlatVector<int32_t>({1, std::nullopt, 3}),
+    });
+    assertEqualVectors(
+        evaluate(expression, withNulls), evaluateFused(exprSet, withNulls));
+    ASSERT_EQ(fused->numFallbackBatches(), 1);
+  }
+
+  // Overflow is reported by the regular evaluation.
+  exec::ExprSet exprSet({parseExpression("c3 * c4", rowType)}, &execCtx);
+  auto fused = dynamic_cast<exec::FusedExpr*>(exprSet.expr(0).get());
+  ASSERT_NE(fused, nullptr);
+  ASSERT_ANY_THROW(evaluateFused(exprSet, data));
+  ASSERT_EQ(fused->numFusedBatches(), 0);
+  ASSERT_EQ(fused->numFallbackBatches(), 1);
+}
+
 TEST_F(ExprTest, constant) {
   auto exprSet = compileExpression("1 + 2 + 3 + 4", ROW({}));
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(exprSet->expr(0).get());
@@ -1257,6 +1382,26 @@ TEST_F(ExprTest, selectiveLazyLoadingAnd) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ExprTest, selectiveLazyLoadingAndMultiplyReferenced) {
+  const vector_size_t size = 1'000;
+
+  // A vector referenced by several inputs of AND is loaded for the rows that
+  // pass the inputs before the first one that references it.
+  auto valueAt = [](auto row) { return row; };
+  auto a = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  auto b = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, ceil(size / 2.0), [](auto row) {
+        return row * 2;
+      });
+
+  auto result = evaluate(
+      "c0 % 2 = 0 AND c1 % 3 = 0 AND c1 % 5 = 0", makeRowVector({a, b}));
+  auto expected = makeFlatVector<bool>(
+      size, [](auto row) { return row % (2 * 3 * 5) == 0; });
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(ExprTest, selectiveLazyLoadingOr) {
   const vector_size_t size = 1'000;
 
@@ -2119,6 +2264,60 @@ TEST_F(ExprTest, memoNulls) {
   assertEqualVectors(expectedResult, result);
 }
 
+namespace {
+int64_t numCountingCalls = 0;
+
+template <typename T>
+struct CountingFunction {
+  void call(int64_t& out, const int64_t& in) {
+    ++numCountingCalls;
+    out = in * 2;
+  }
+};
+} // namespace
+
+// Batches over two dictionaries interleave. The results for each dictionary
+// are memoized across batches, so the function runs once per dictionary value.
+TEST_F(ExprTest, memoAcrossBatches) {
+  registerFunction<CountingFunction, int64_t, int64_t>({"counting_double"});
+  auto firstBase = makeFlatVector<int64_t>(10, [](auto row) { return row; });
+  auto secondBase =
+      makeFlatVector<int64_t>(10, [](auto row) { return row + 100; });
+  auto indices = makeIndices(20, [](auto row) { return row % 10; });
+
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  auto exprSet = compileExpression("counting_double(c0)", rowType);
+  numCountingCalls = 0;
+  for (auto i = 0; i < 4; ++i) {
+    auto& base = i % 2 == 0 ? firstBase : secondBase;
+    auto result = evaluate(
+        exprSet.get(), makeRowVector({wrapInDictionary(indices, 20, base)}));
+    auto expectedResult = makeFlatVector<int64_t>(
+        20, [&](auto row) { return base->valueAt(row % 10) * 2; });
+    assertEqualVectors(expectedResult, result);
+  }
+  ASSERT_EQ(numCountingCalls, 20);
+
+  // With no memory for memoized results, only the last dictionary is kept.
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      nullptr,
+      std::unordered_map<std::string, std::string>{
+          {core::QueryConfig::kExprMaxMemoBytes, "0"}});
+  core::ExecCtx execCtx(pool(), queryCtx.get());
+  exec::ExprSet noMemoryExprSet(
+      {parseExpression("counting_double(c0)", rowType)}, &execCtx);
+  numCountingCalls = 0;
+  for (auto i = 0; i < 4; ++i) {
+    auto& base = i % 2 == 0 ? firstBase : secondBase;
+    auto input = makeRowVector({wrapInDictionary(indices, 20, base)});
+    SelectivityVector rows(input->size());
+    exec::EvalCtx context(&execCtx, &noMemoryExprSet, input.get());
+    std::vector<VectorPtr> result(1);
+    noMemoryExprSet.eval(rows, context, result);
+  }
+  ASSERT_EQ(numCountingCalls, 40);
+}
+
 // This test is carefully constructed to exercise calling
 // applyFunctionWithPeeling in a situation where inputValues_ can be peeled
 // and applyRows and rows are distinct SelectivityVectors.  This test ensures
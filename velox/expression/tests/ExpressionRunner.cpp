@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include "velox/common/base/Fs.h"
+#include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -71,6 +72,49 @@ RowVectorPtr evaluateAndPrintResults(
   return rowResult;
 }
 
+// Evaluates each of 'typedExprs' 'numIterations' times and prints its wall
+// and CPU time per iteration, its throughput and its ExprStats.
+void benchmarkExpressions(
+    const std::vector<core::TypedExprPtr>& typedExprs,
+    const RowVectorPtr& inputVector,
+    const SelectivityVector& rows,
+    const std::vector<int>& columnsToWrapInLazy,
+    int32_t numIterations,
+    core::ExecCtx& execCtx) {
+  VELOX_CHECK_GT(numIterations, 0);
+  for (const auto& typedExpr : typedExprs) {
+    exec::ExprSet exprSet({typedExpr}, &execCtx);
+    CpuWallTiming timing;
+    for (auto i = 0; i < numIterations; ++i) {
+      // Lazy vectors are loaded by the first evaluation, so that each
+      // iteration gets new ones.
+      auto input = columnsToWrapInLazy.empty()
+          ? inputVector
+          : VectorFuzzer::fuzzRowChildrenToLazy(
+                inputVector, columnsToWrapInLazy);
+      exec::EvalCtx evalCtx(&execCtx, &exprSet, input.get());
+      std::vector<VectorPtr> results(1);
+      CpuWallTimer timer(timing);
+      exprSet.eval(rows, evalCtx, results);
+    }
+    const auto numRows = static_cast<uint64_t>(rows.countSelected());
+    const auto rowsPerSecond = timing.wallNanos == 0
+        ? 0
+        : numRows * numIterations * 1'000'000'000.0 / timing.wallNanos;
+    std::cout << "Expression: " << typedExpr->toString() << std::endl
+              << fmt::format(
+                     "{} iterations of {} rows: {} wall, {} CPU per "
+                     "iteration, {:.0f} rows/s",
+                     numIterations,
+                     numRows,
+                     succinctNanos(timing.wallNanos / numIterations),
+                     succinctNanos(timing.cpuNanos / numIterations),
+                     rowsPerSecond)
+              << std::endl
+              << exec::printExprWithStats(exprSet) << std::endl;
+  }
+}
+
 vector_size_t adjustNumRows(vector_size_t numRows, vector_size_t size) {
   return numRows > 0 && numRows < size ? numRows : size;
 }
@@ -115,11 +159,17 @@ void ExpressionRunner::run(
     vector_size_t numRows,
     const std::string& storeResultPath,
     const std::string& lazyColumnListPath,
-    bool findMinimalSubExpression) {
+    bool findMinimalSubExpression,
+    int32_t numIterations) {
   VELOX_CHECK(!sql.empty());
 
   std::shared_ptr<core::QueryCtx> queryCtx{std::make_shared<core::QueryCtx>()};
   std::shared_ptr<memory::MemoryPool> pool{memory::addDefaultLeafMemoryPool()};
+  if (mode == "benchmark") {
+    // Collects the timing in the ExprStats of each expression.
+    queryCtx->testingOverrideConfigUnsafe(
+        {{core::QueryConfig::kExprTrackCpuUsage, "true"}});
+  }
   core::ExecCtx execCtx{pool.get(), queryCtx.get()};
 
   RowVectorPtr inputVector;
@@ -222,6 +272,14 @@ void ExpressionRunner::run(
     if (!storeResultPath.empty()) {
       saveResults(results, storeResultPath);
     }
+  } else if (mode == "benchmark") {
+    benchmarkExpressions(
+        typedExprs,
+        inputVector,
+        rows,
+        columnsToWrapInLazy,
+        numIterations,
+        execCtx);
   } else {
     VELOX_FAIL("Unknown expression runner mode: [{}].", mode);
   }
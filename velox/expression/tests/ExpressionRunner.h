@@ -22,12 +22,14 @@ namespace facebook::velox::test {
 
 /// Utility class that helps to run any expressions standalone. It takes input
 /// data, SQL, and dirty result vector if any from disk and run the expression
-/// described by SQL. It supports 3 modes:
+/// described by SQL. It supports 4 modes:
 ///    - "verify": run expression and compare results between common and
 ///                simplified path
 ///    - "common": run expression only using common paths. (to be supported)
 ///    - "simplified": run expression only using simplified path. (to be
 ///                supported)
+///    - "benchmark": run each expression repeatedly using common path and
+///                print the throughput and the ExprStats of each.
 class ExpressionRunner {
  public:
   /// @param inputPath The path to the on-disk vector that will be used as input
@@ -40,15 +42,17 @@ class ExpressionRunner {
   ///        that will be used as the result buffer to which the expression
   ///        evaluation results will be written.
   /// @param mode The expression evaluation mode, one of ["verify", "common",
-  ///        "simplified"]
+  ///        "simplified", "benchmark"]
   /// @param numRows Maximum number of rows to process. 0 means 'all' rows.
-  ///         Applies to "common" and "simplified" modes only.
+  ///         Applies to "common", "simplified" and "benchmark" modes only.
   /// @param storeResultPath The path to a directory on disk where the results
   /// of expression or query evaluation will be stored. If empty, the results
   /// will not be stored.
   /// @param lazyColumnListPath The path to on-disk vector of column indices
   /// that specify which columns of the input row vector should be wrapped in
   /// lazy.
+  /// @param numIterations The number of times each expression is evaluated in
+  /// "benchmark" mode.
   ///
   /// User can refer to 'VectorSaver' class to see how to serialize/preserve
   /// vectors to disk.
@@ -61,7 +65,8 @@ class ExpressionRunner {
       vector_size_t numRows,
       const std::string& storeResultPath,
       const std::string& lazyColumnListPath,
-      bool findMinimalSubExpression = false);
+      bool findMinimalSubExpression = false,
+      int32_t numIterations = 100);
 
   /// Parse comma-separated SQL expressions. This should be treated as private
   /// except for tests.
@@ -70,7 +70,9 @@ DEFINE_string(
     "results.\n"
     "query: evaluate SQL query specified in --sql or --sql_path and print out "
     "results. If --input_path is specified, the query may reference it as "
-    "table 't'.");
+    "table 't'.\n"
+    "benchmark: evaluate each expression --num_iterations times using common "
+    "path and print out its throughput and runtime statistics.");
 
 DEFINE_string(
     lazy_column_list_path,
@@ -81,7 +83,7 @@ DEFINE_string(
 
 static bool validateMode(const char* flagName, const std::string& value) {
   static const std::unordered_set<std::string> kModes = {
-      "common", "simplified", "verify", "query"};
+      "common", "simplified", "verify", "query", "benchmark"};
   if (kModes.count(value) != 1) {
     std::cout << "Invalid value for --" << flagName << ": " << value << ". ";
     std::cout << "Valid values are: " << folly::join(", ", kModes) << "."
@@ -98,7 +100,13 @@ DEFINE_int32(
     num_rows,
     10,
     "Maximum number of rows to process. Zero means 'all rows'. Applies to "
-    "'common' and 'simplified' modes only. Ignored for 'verify' mode.");
+    "'common', 'simplified' and 'benchmark' modes only. Ignored for 'verify' "
+    "mode.");
+
+DEFINE_int32(
+    num_iterations,
+    100,
+    "Number of times to evaluate each expression in 'benchmark' mode.");
 
 DEFINE_string(
     store_result_path,
@@ -193,5 +201,6 @@ int main(int argc, char** argv) {
       FLAGS_num_rows,
       FLAGS_store_result_path,
       FLAGS_lazy_column_list_path,
-      FLAGS_find_minimal_subexpression);
+      FLAGS_find_minimal_subexpression,
+      FLAGS_num_iterations);
 }
@@ -62,6 +62,36 @@ TEST_F(ExpressionRunnerUnitTest, run) {
       inputPath, "length(c0)", "", resultPath, "verify", 0, "", ""));
 }
 
+TEST_F(ExpressionRunnerUnitTest, benchmark) {
+  auto inputFile = exec::test::TempFilePath::create();
+  auto lazyColumnsFile = exec::test::TempFilePath::create();
+  const char* inputPath = inputFile->path.data();
+  const char* lazyColumnsPath = lazyColumnsFile->path.data();
+
+  VectorMaker vectorMaker(pool_.get());
+  auto inputVector = vectorMaker.rowVector(
+      {vectorMaker.flatVector<int64_t>(100, [](auto row) { return row; }),
+       vectorMaker.flatVector<int64_t>(100, [](auto row) { return row * 2; })});
+  saveVectorToFile(inputVector.get(), inputPath);
+  saveStdVectorToFile<int>({1}, lazyColumnsPath);
+
+  EXPECT_NO_THROW(ExpressionRunner::run(
+      inputPath,
+      "c0 + c1, c0 > 10 and c1 < 100",
+      "",
+      "",
+      "benchmark",
+      0,
+      "",
+      lazyColumnsPath,
+      false,
+      3));
+  EXPECT_THROW(
+      ExpressionRunner::run(
+          inputPath, "c0 + c1", "", "", "benchmark", 0, "", "", false, 0),
+      VeloxRuntimeError);
+}
+
 TEST_F(ExpressionRunnerUnitTest, persistAndReproComplexSql) {
   // Create a constant vector of ARRAY(Dictionary-Encoded INT)
   auto dictionaryVector = wrapInDictionary(
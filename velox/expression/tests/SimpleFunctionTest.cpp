@@ -1109,6 +1109,60 @@ TEST_F(SimpleFunctionTest, testAllNotNull) {
   assertEqualVectors(expected, result);
 }
 
+template <typename T>
+struct BatchPlusFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  static inline int32_t numBatchRows = 0;
+
+  void call(int64_t& out, int64_t a, int64_t b) {
+    out = a + b;
+  }
+
+  void callBatch(int64_t* out, const int64_t* a, const int64_t* b, int32_t n) {
+    for (auto i = 0; i < n; ++i) {
+      out[i] = a[i] + b[i];
+    }
+    numBatchRows += n;
+  }
+};
+
+TEST_F(SimpleFunctionTest, callBatch) {
+  registerFunction<BatchPlusFunction, int64_t, int64_t, int64_t>(
+      {"batch_plus"});
+  auto& numBatchRows = BatchPlusFunction<exec::VectorExec>::numBatchRows;
+  constexpr vector_size_t kSize = 3'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row * 2; }),
+      makeFlatVector<int64_t>(
+          kSize, [](auto row) { return row; }, nullEvery(7)),
+  });
+
+  numBatchRows = 0;
+  auto result = evaluate("batch_plus(c0, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row * 3; }),
+      result);
+  ASSERT_EQ(numBatchRows, kSize);
+
+  numBatchRows = 0;
+  result = evaluate("batch_plus(c0, 5)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row + 5; }),
+      result);
+  ASSERT_EQ(numBatchRows, kSize);
+
+  // Rows with nulls are not all selected and are evaluated row by row.
+  numBatchRows = 0;
+  result = evaluate("batch_plus(c2, c0)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          kSize, [](auto row) { return row * 2; }, nullEvery(7)),
+      result);
+  ASSERT_EQ(numBatchRows, 0);
+}
+
 // Test that SimpleFunctionRegistry does not crash in multithreaded environment.
 TEST_F(SimpleFunctionTest, simpleFunctionRegistryThreadSafe) {
   std::vector<std::thread> threads;
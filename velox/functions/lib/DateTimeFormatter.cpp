@@ -949,6 +949,39 @@ void parseFromPattern(
 
 } // namespace
 
+// static
+int32_t DateTimeFormatter::countFixedFields(
+    const std::vector<DateTimeToken>& tokens) {
+  static const std::pair<DateTimeFormatSpecifier, size_t> kFields[] = {
+      {DateTimeFormatSpecifier::YEAR, 4},
+      {DateTimeFormatSpecifier::MONTH_OF_YEAR, 2},
+      {DateTimeFormatSpecifier::DAY_OF_MONTH, 2},
+      {DateTimeFormatSpecifier::HOUR_OF_DAY, 2},
+      {DateTimeFormatSpecifier::MINUTE_OF_HOUR, 2},
+      {DateTimeFormatSpecifier::SECOND_OF_MINUTE, 2}};
+  // Fields at even positions with single character literals in between.
+  if (tokens.size() != 5 && tokens.size() != 11) {
+    return 0;
+  }
+  for (auto i = 0; i < tokens.size(); ++i) {
+    const auto& token = tokens[i];
+    if (i % 2 == 1) {
+      if (token.type != DateTimeToken::Type::kLiteral ||
+          token.literal.size() != 1) {
+        return 0;
+      }
+      continue;
+    }
+    const auto& [specifier, numDigits] = kFields[i / 2];
+    if (token.type != DateTimeToken::Type::kPattern ||
+        token.pattern.specifier != specifier ||
+        token.pattern.minRepresentDigits != numDigits) {
+      return 0;
+    }
+  }
+  return (tokens.size() + 1) / 2;
+}
+
 std::string DateTimeFormatter::format(
     const Timestamp& timestamp,
     const date::time_zone* timezone) const {
@@ -962,6 +995,34 @@ std::string DateTimeFormatter::format(
   const date::year_month_day calDate(daysTimePoint);
   const date::weekday weekday(daysTimePoint);
 
+  if (numFixedFields_ > 0) {
+    const auto year = static_cast<signed>(calDate.year());
+    if (year >= 0 && year <= 9999) {
+      const int32_t values[] = {
+          year,
+          static_cast<int32_t>(static_cast<unsigned>(calDate.month())),
+          static_cast<int32_t>(static_cast<unsigned>(calDate.day())),
+          static_cast<int32_t>(durationInTheDay.hours().count()),
+          static_cast<int32_t>(durationInTheDay.minutes().count() % 60),
+          static_cast<int32_t>(durationInTheDay.seconds().count() % 60)};
+      char buffer[19];
+      char* out = buffer;
+      for (auto i = 0; i < numFixedFields_; ++i) {
+        if (i > 0) {
+          *out++ = tokens_[2 * i - 1].literal[0];
+        }
+        const auto numDigits = i == 0 ? 4 : 2;
+        auto value = values[i];
+        for (auto digit = numDigits - 1; digit >= 0; --digit) {
+          out[digit] = '0' + value % 10;
+          value /= 10;
+        }
+        out += numDigits;
+      }
+      return std::string(buffer, out - buffer);
+    }
+  }
+
   std::string result;
   for (auto& token : tokens_) {
     if (token.type == DateTimeToken::Type::kLiteral) {
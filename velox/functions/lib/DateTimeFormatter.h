@@ -159,7 +159,8 @@ class DateTimeFormatter {
       : literalBuf_(std::move(literalBuf)),
         bufSize_(bufSize),
         tokens_(std::move(tokens)),
-        type_(type) {}
+        type_(type),
+        numFixedFields_(countFixedFields(tokens_)) {}
 
   const std::unique_ptr<char[]>& literalBuf() const {
     return literalBuf_;
@@ -180,10 +181,19 @@ class DateTimeFormatter {
       const date::time_zone* timezone) const;
 
  private:
+  // Returns 3 if 'tokens' are exactly a 4 digit year, 2 digit month and 2
+  // digit day, e.g. %Y-%m-%d or yyyy-MM-dd, and 6 if these are followed by 2
+  // digit hour, minute and second. The fields must be separated by single
+  // character literals. Returns 0 for any other pattern.
+  static int32_t countFixedFields(const std::vector<DateTimeToken>& tokens);
+
   std::unique_ptr<char[]> literalBuf_;
   size_t bufSize_;
   std::vector<DateTimeToken> tokens_;
   DateTimeFormatterType type_;
+  // Number of fields of a pattern that format() writes directly into a fixed
+  // size buffer. See countFixedFields().
+  const int32_t numFixedFields_;
 };
 
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
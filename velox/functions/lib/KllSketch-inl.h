@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <queue>
 #include <type_traits>
@@ -309,6 +310,49 @@ void KllSketch<T, A, C>::doInsert(T value) {
   isLevelZeroSorted_ = false;
 }
 
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::insert(folly::Range<const T*> values) {
+  if (values.empty()) {
+    return;
+  }
+  auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end(), C());
+  if (n_ == 0) {
+    minValue_ = *minIt;
+    maxValue_ = *maxIt;
+  } else {
+    minValue_ = std::min(minValue_, *minIt, C());
+    maxValue_ = std::max(maxValue_, *maxIt, C());
+  }
+  doInsert(values);
+}
+
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::doInsert(folly::Range<const T*> values) {
+  VELOX_DCHECK_GT(k_, 0);
+  VELOX_DCHECK_GE(levels_.size(), 2);
+  auto* next = values.begin();
+  const auto* end = values.end();
+  if (numLevels() == 1 && items_.size() < k_) {
+    const auto count = std::min<size_t>(k_ - items_.size(), end - next);
+    items_.insert(items_.end(), next, next + count);
+    levels_[1] += count;
+    next += count;
+  }
+  while (next < end) {
+    if (levels_[0] == 0) {
+      // Compacts and makes room for at least one value in level zero.
+      items_[insertPosition()] = *next++;
+    }
+    // The free space in level zero is below levels_[0].
+    const auto count = std::min<size_t>(levels_[0], end - next);
+    levels_[0] -= count;
+    std::copy(next, next + count, items_.data() + levels_[0]);
+    next += count;
+  }
+  n_ += values.size();
+  isLevelZeroSorted_ = false;
+}
+
 template <typename T, typename A, typename C>
 uint32_t KllSketch<T, A, C>::insertPosition() {
   if (levels_[0] == 0) {
@@ -588,9 +632,9 @@ void KllSketch<T, A, C>::mergeViews(const folly::Range<const View*>& others) {
     if (other.n == 0) {
       continue;
     }
-    for (uint32_t j = other.levels[0]; j < other.levels[1]; ++j) {
-      doInsert(other.items[j]);
-    }
+    doInsert(folly::Range<const T*>(
+        other.items.data() + other.levels[0],
+        other.items.data() + other.levels[1]));
   }
   // Merge higher levels.
   auto tmpNumItems = getNumRetained();
@@ -615,33 +659,53 @@ void KllSketch<T, A, C>::mergeViews(const folly::Range<const View*>& others) {
         items_.data() + levels_[0], items_.data() + levels_[1], workbuf.data());
     worklevels[1] = safeLevelSize(0);
     // Merge each level, each level in all sketches are already sorted.
+    using Entry = std::pair<const T*, const T*>;
+    using AllocEntry =
+        typename std::allocator_traits<A>::template rebind_alloc<Entry>;
+    std::vector<Entry, AllocEntry> runs{AllocEntry(allocator_)};
     for (uint8_t lvl = 1; lvl < provisionalNumLevels; ++lvl) {
-      using Entry = std::pair<const T*, const T*>;
-      using AllocEntry =
-          typename std::allocator_traits<A>::template rebind_alloc<Entry>;
-      auto gt = [](const Entry& x, const Entry& y) {
-        return C()(*y.first, *x.first);
-      };
-      std::priority_queue<Entry, std::vector<Entry, AllocEntry>, decltype(gt)>
-          pq(gt, AllocEntry(allocator_));
+      runs.clear();
       if (auto sz = safeLevelSize(lvl); sz > 0) {
-        pq.emplace(
+        runs.emplace_back(
             items_.data() + levels_[lvl], items_.data() + levels_[lvl] + sz);
       }
       for (auto& other : others) {
         if (auto sz = other.safeLevelSize(lvl); sz > 0) {
-          pq.emplace(
+          runs.emplace_back(
               &other.items[other.levels[lvl]],
               &other.items[other.levels[lvl]] + sz);
         }
       }
       int outIndex = worklevels[lvl];
-      while (!pq.empty()) {
-        auto [s, t] = pq.top();
-        pq.pop();
-        workbuf[outIndex++] = *s++;
-        if (s < t) {
-          pq.emplace(s, t);
+      if (runs.size() <= 2) {
+        // Merging with one other sketch is the common case, a plain merge of
+        // the 2 runs avoids the heap.
+        auto* out = workbuf.data() + outIndex;
+        if (runs.size() == 1) {
+          out = std::copy(runs[0].first, runs[0].second, out);
+        } else if (runs.size() == 2) {
+          out = std::merge(
+              runs[0].first,
+              runs[0].second,
+              runs[1].first,
+              runs[1].second,
+              out,
+              C());
+        }
+        outIndex = out - workbuf.data();
+      } else {
+        auto gt = [](const Entry& x, const Entry& y) {
+          return C()(*y.first, *x.first);
+        };
+        std::priority_queue<Entry, std::vector<Entry, AllocEntry>, decltype(gt)>
+            pq(gt, std::move(runs));
+        while (!pq.empty()) {
+          auto [s, t] = pq.top();
+          pq.pop();
+          workbuf[outIndex++] = *s++;
+          if (s < t) {
+            pq.emplace(s, t);
+          }
         }
       }
       worklevels[lvl + 1] = outIndex;
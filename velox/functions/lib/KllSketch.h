@@ -60,6 +60,11 @@ struct KllSketch {
   /// Add one new value to the sketch.
   void insert(T value);
 
+  /// Add all of `values` to the sketch.  Equivalent to calling insert() on
+  /// each of them but copies runs of values into level zero at once instead
+  /// of finding the insert position for each value.
+  void insert(folly::Range<const T*> values);
+
   /// Call this before serialization can optimize the space used.
   void compact();
 
@@ -169,6 +174,7 @@ struct KllSketch {
  private:
   KllSketch(const Allocator&, uint32_t seed);
   void doInsert(T);
+  void doInsert(folly::Range<const T*>);
   uint32_t insertPosition();
   int findLevelToCompact() const;
   void addEmptyTopLevelToCompletelyFullSketch();
@@ -16,9 +16,11 @@
 #include "velox/functions/lib/Re2Functions.h"
 
 #include <re2/re2.h>
+#include <cctype>
 #include <optional>
 #include <string>
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorWriters.h"
 
 namespace facebook::velox::functions {
@@ -81,6 +83,15 @@ FlatVector<StringView>& ensureWritableStringView(
   return *flat;
 }
 
+// Returns false if 'str' can't match a pattern because it doesn't contain the
+// literal required by the pattern.
+bool containsLiteral(StringView str, std::string_view literal) {
+  return literal.empty() ||
+      simd::findSubstring(
+          str.data(), str.size(), literal.data(), literal.size()) !=
+      std::string_view::npos;
+}
+
 bool re2FullMatch(StringView str, const RE2& re) {
   return RE2::FullMatch(toStringPiece(str), re);
 }
@@ -96,10 +107,12 @@ bool re2Extract(
     const exec::LocalDecodedVector& strs,
     std::vector<re2::StringPiece>& groups,
     int32_t groupId,
-    bool emptyNoMatch) {
+    bool emptyNoMatch,
+    std::string_view requiredLiteral = {}) {
   const StringView str = strs->valueAt<StringView>(row);
   DCHECK_GT(groups.size(), groupId);
-  if (!re.Match(
+  if (!containsLiteral(str, requiredLiteral) ||
+      !re.Match(
           toStringPiece(str),
           0,
           str.size(),
@@ -180,7 +193,8 @@ template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
   explicit Re2MatchConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(toStringPiece(pattern), RE2::Quiet),
+        requiredLiteral_(re2RequiredLiteral(pattern)) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -198,13 +212,16 @@ class Re2MatchConstantPattern final : public VectorFunction {
       return;
     }
 
+    // Runs RE2 only on the strings that contain the required literal.
     context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-      result.set(i, Fn(toSearch->valueAt<StringView>(i), re_));
+      const auto str = toSearch->valueAt<StringView>(i);
+      result.set(i, containsLiteral(str, requiredLiteral_) && Fn(str, re_));
     });
   }
 
  private:
   RE2 re_;
+  const std::string requiredLiteral_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -246,7 +263,9 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   explicit Re2SearchAndExtractConstantPattern(
       StringView pattern,
       bool emptyNoMatch)
-      : re_(toStringPiece(pattern), RE2::Quiet), emptyNoMatch_(emptyNoMatch) {}
+      : re_(toStringPiece(pattern), RE2::Quiet),
+        emptyNoMatch_(emptyNoMatch),
+        requiredLiteral_(re2RequiredLiteral(pattern)) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -274,8 +293,15 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
     if (args.size() == 2) {
       groups.resize(1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-        mustRefSourceStrings |=
-            re2Extract(result, i, re_, toSearch, groups, 0, emptyNoMatch_);
+        mustRefSourceStrings |= re2Extract(
+            result,
+            i,
+            re_,
+            toSearch,
+            groups,
+            0,
+            emptyNoMatch_,
+            requiredLiteral_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -294,7 +320,14 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       groups.resize(*groupId + 1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
         mustRefSourceStrings |= re2Extract(
-            result, i, re_, toSearch, groups, *groupId, emptyNoMatch_);
+            result,
+            i,
+            re_,
+            toSearch,
+            groups,
+            *groupId,
+            emptyNoMatch_,
+            requiredLiteral_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -310,8 +343,15 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
     context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
       T group = groupIds->valueAt<T>(i);
       checkForBadGroupId(group, re_);
-      mustRefSourceStrings |=
-          re2Extract(result, i, re_, toSearch, groups, group, emptyNoMatch_);
+      mustRefSourceStrings |= re2Extract(
+          result,
+          i,
+          re_,
+          toSearch,
+          groups,
+          group,
+          emptyNoMatch_,
+          requiredLiteral_);
     });
     if (mustRefSourceStrings) {
       result.acquireSharedStringBuffers(toSearch->base());
@@ -321,6 +361,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
  private:
   RE2 re_;
   const bool emptyNoMatch_;
+  const std::string requiredLiteral_;
 }; // namespace
 
 // The factory function we provide returns a unique instance for each call, so
@@ -838,6 +879,124 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures() {
   };
 }
 
+std::string re2RequiredLiteral(StringView pattern) {
+  const std::string_view view(pattern.data(), pattern.size());
+  if (view.find('|') != std::string_view::npos) {
+    return "";
+  }
+  std::string longest;
+  // Literal characters seen since the last character that is not a literal.
+  std::string current;
+  auto endLiteral = [&]() {
+    if (current.size() > longest.size()) {
+      longest = current;
+    }
+    current.clear();
+  };
+  // Groups may be optional or repeated, so only the characters outside of
+  // groups are considered.
+  int32_t depth = 0;
+  for (size_t i = 0; i < view.size(); ++i) {
+    const char c = view[i];
+    switch (c) {
+      case '\\': {
+        if (i + 1 == view.size()) {
+          return "";
+        }
+        const char escaped = view[++i];
+        if (std::isalnum(static_cast<unsigned char>(escaped))) {
+          // Character classes and assertions. Other escapes, e.g. \x41 or
+          // \pN, are not parsed.
+          if (std::string_view("dDwWsSbBAz").find(escaped) ==
+              std::string_view::npos) {
+            return "";
+          }
+          endLiteral();
+        } else if (depth == 0 && !(escaped & 0x80)) {
+          current += escaped;
+        } else {
+          endLiteral();
+        }
+        break;
+      }
+      case '[': {
+        endLiteral();
+        // Skips the class. A ']' right after '[' or '[^' is a literal.
+        ++i;
+        if (i < view.size() && view[i] == '^') {
+          ++i;
+        }
+        if (i < view.size() && view[i] == ']') {
+          ++i;
+        }
+        while (i < view.size() && view[i] != ']') {
+          if (view[i] == '\\') {
+            ++i;
+          }
+          ++i;
+        }
+        if (i >= view.size()) {
+          return "";
+        }
+        break;
+      }
+      case '(':
+        endLiteral();
+        // Inline flags such as (?i) change the meaning of the rest of the
+        // pattern. Non-capturing and named groups are fine.
+        if (i + 1 < view.size() && view[i + 1] == '?' &&
+            (i + 2 >= view.size() ||
+             (view[i + 2] != ':' && view[i + 2] != 'P'))) {
+          return "";
+        }
+        ++depth;
+        break;
+      case ')':
+        endLiteral();
+        if (--depth < 0) {
+          return "";
+        }
+        break;
+      case '*':
+      case '?':
+      case '{':
+        // The repeated character is optional.
+        if (!current.empty()) {
+          current.pop_back();
+        }
+        endLiteral();
+        if (c == '{') {
+          const auto end = view.find('}', i);
+          if (end == std::string_view::npos) {
+            return "";
+          }
+          i = end;
+        }
+        break;
+      case '+':
+        // The repeated character is required, but what follows needn't come
+        // right after it.
+        endLiteral();
+        break;
+      case '.':
+      case '^':
+      case '$':
+        endLiteral();
+        break;
+      default:
+        // Multi-byte UTF-8 characters are not literals so that a following
+        // quantifier applies to no literal character.
+        if (depth == 0 && !(c & 0x80)) {
+          current += c;
+        } else {
+          endLiteral();
+        }
+    }
+  }
+  endLiteral();
+  return longest;
+}
+
 std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   vector_size_t patternLength = pattern.size();
   vector_size_t i = 0;
@@ -101,6 +101,12 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures();
 /// {kGenericPattern, 0} for generic patterns).
 std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern);
 
+/// Returns the longest literal substring that every string matching the RE2
+/// 'pattern' must contain, or an empty string if none is found. The analysis
+/// is conservative: patterns with alternation, inline flags or escapes other
+/// than the common character classes return an empty string.
+std::string re2RequiredLiteral(StringView pattern);
+
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs);
@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <ctime>
+#include <limits>
+
 #include <velox/type/Timestamp.h>
 #include "velox/core/QueryConfig.h"
 #include "velox/external/date/tz.h"
@@ -48,23 +51,91 @@ getSeconds(Timestamp timestamp, const date::time_zone* timeZone) {
 }
 } // namespace
 
+// Returns the number of days since epoch of the proleptic Gregorian
+// 'year'-'month'-'day'. 'month' is 1 based.
+FOLLY_ALWAYS_INLINE constexpr int64_t
+daysFromCivil(int64_t year, int32_t month, int32_t day) {
+  year -= month <= 2;
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const int64_t yearOfEra = year - era * 400;
+  const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 +
+      day - 1;
+  const int64_t dayOfEra =
+      yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+// Returns the seconds since epoch of the UTC date and time in 'dateTime'. Same
+// as timegm() for fields in their normal ranges.
+FOLLY_ALWAYS_INLINE int64_t secondsFromDateTime(const std::tm& dateTime) {
+  return daysFromCivil(
+             dateTime.tm_year + 1900LL, dateTime.tm_mon + 1, dateTime.tm_mday) *
+      kSecondsInDay +
+      dateTime.tm_hour * 3600 + dateTime.tm_min * 60 + dateTime.tm_sec;
+}
+
+// Breaks down 'seconds' since epoch into a UTC date and time. Same as
+// gmtime_r() but computes the civil date from the number of days arithmetically
+// instead of calling into libc. Returns false if the year does not fit in
+// std::tm.
+FOLLY_ALWAYS_INLINE bool civilFromSeconds(int64_t seconds, std::tm& dateTime) {
+  int64_t days = seconds / kSecondsInDay;
+  int64_t secondsOfDay = seconds % kSecondsInDay;
+  if (secondsOfDay < 0) {
+    secondsOfDay += kSecondsInDay;
+    --days;
+  }
+
+  // Days since 0000-03-01, so that the leap day is the last day of a year.
+  const int64_t shifted = days + 719468;
+  const int64_t era = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+  const int64_t dayOfEra = shifted - era * 146097;
+  const int64_t yearOfEra =
+      (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  const int64_t dayOfYear =
+      dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  const int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+  const int32_t day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+  const int32_t month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+  const int64_t year = yearOfEra + era * 400 + (month <= 2);
+  if (year - 1900 > std::numeric_limits<int32_t>::max() ||
+      year - 1900 < std::numeric_limits<int32_t>::min()) {
+    return false;
+  }
+
+  dateTime = std::tm{};
+  dateTime.tm_year = year - 1900;
+  dateTime.tm_mon = month - 1;
+  dateTime.tm_mday = day;
+  dateTime.tm_yday = days - daysFromCivil(year, 1, 1);
+  // 1970-01-01 was a Thursday.
+  dateTime.tm_wday = days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6;
+  dateTime.tm_hour = secondsOfDay / 3600;
+  dateTime.tm_min = secondsOfDay % 3600 / 60;
+  dateTime.tm_sec = secondsOfDay % 60;
+  return true;
+}
+
 FOLLY_ALWAYS_INLINE
-std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
-  int64_t seconds = getSeconds(timestamp, timeZone);
+std::tm getDateTime(int64_t seconds) {
   std::tm dateTime;
-  VELOX_USER_CHECK_NOT_NULL(
-      gmtime_r((const time_t*)&seconds, &dateTime),
+  VELOX_USER_CHECK(
+      civilFromSeconds(seconds, dateTime),
       "Timestamp is too large: {} seconds since epoch",
       seconds);
   return dateTime;
 }
 
+FOLLY_ALWAYS_INLINE
+std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
+  return getDateTime(getSeconds(timestamp, timeZone));
+}
+
 FOLLY_ALWAYS_INLINE
 std::tm getDateTime(Date date) {
-  int64_t seconds = date.days() * kSecondsInDay;
   std::tm dateTime;
-  VELOX_USER_CHECK_NOT_NULL(
-      gmtime_r((const time_t*)&seconds, &dateTime),
+  VELOX_USER_CHECK(
+      civilFromSeconds(date.days() * kSecondsInDay, dateTime),
       "Date is too large: {} days",
       date.days());
   return dateTime;
@@ -74,11 +145,22 @@ template <typename T>
 struct InitSessionTimezone {
   VELOX_DEFINE_FUNCTION_TYPES(T);
   const date::time_zone* timeZone_{nullptr};
+  TimeZoneConverter timeZoneConverter_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
       const arg_type<Timestamp>* /*timestamp*/) {
     timeZone_ = getTimeZoneFromConfig(config);
   }
+
+  // Returns the date and time of 'timestamp' in the session time zone.
+  FOLLY_ALWAYS_INLINE std::tm getLocalDateTime(const Timestamp& timestamp) {
+    if (timeZone_ == nullptr) {
+      return getDateTime(timestamp.getSeconds());
+    }
+    auto localTimestamp = timestamp;
+    timeZoneConverter_.toTimezone(localTimestamp, *timeZone_);
+    return getDateTime(localTimestamp.getSeconds());
+  }
 };
 } // namespace facebook::velox::functions
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <xsimd/xsimd.hpp>
+
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/AggregationHook.h"
 #include "velox/vector/DecodedVector.h"
@@ -114,13 +116,13 @@ class SimpleNumericAggregate : public exec::Aggregate {
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
         auto value = decoded.valueAt<TValue>(0);
-        rows.applyToSelected([&](vector_size_t i) {
+        applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
           updateNonNullValue<tableHasNulls, TData>(
               groups[i], TData(value), updateSingleValue);
         });
       }
     } else if (decoded.mayHaveNulls()) {
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         if (decoded.isNullAt(i)) {
           return;
         }
@@ -129,12 +131,12 @@ class SimpleNumericAggregate : public exec::Aggregate {
       });
     } else if (decoded.isIdentityMapping() && !std::is_same_v<TValue, bool>) {
       auto data = decoded.data<TValue>();
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         updateNonNullValue<tableHasNulls, TData>(
             groups[i], TData(data[i]), updateSingleValue);
       });
     } else {
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         updateNonNullValue<tableHasNulls, TData>(
             groups[i], TData(decoded.valueAt<TValue>(i)), updateSingleValue);
       });
@@ -192,6 +194,97 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
+  // Like updateOneGroup() but reduces the values of a flat or dictionary
+  // encoded 'arg' into a local value 64 rows at a time, using the selected
+  // rows and nulls as bit masks, and updates 'group' once. 'Reducer' has:
+  //
+  //  static void add(TData& result, TValue value): Adds one value. May skip
+  //  the overflow check if up to 64 values can't overflow.
+  //  static void combine(TData& result, TData value): Adds the result of 64
+  //  or fewer values.
+  //  static constexpr bool kSimd: True if TData is TValue and
+  //  addBatch(xsimd::batch<TValue> result, xsimd::batch<TValue> values)
+  //  adds 'values' lane by lane.
+  //
+  // 'initialValue' is the identity of 'combine'.
+  template <
+      typename Reducer,
+      typename TData = TResult,
+      typename TValue = TInput,
+      typename UpdateDuplicate>
+  void reduceOneGroup(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      UpdateDuplicate updateDuplicateValues,
+      TData initialValue) {
+    static_assert(!std::is_same_v<TValue, bool>);
+    DecodedVector decoded(*arg, rows);
+    if (decoded.isConstantMapping()) {
+      if (!decoded.isNullAt(0)) {
+        updateDuplicateValues(
+            initialValue,
+            TData(decoded.valueAt<TValue>(0)),
+            rows.countSelected());
+        updateNonNullValue<true, TData>(group, initialValue, &Reducer::combine);
+      }
+      return;
+    }
+
+    const auto* data = decoded.data<TValue>();
+    const vector_size_t* indices =
+        decoded.isIdentityMapping() ? nullptr : decoded.indices();
+    const uint64_t* nulls = decoded.mayHaveNulls() ? decoded.nulls() : nullptr;
+    const uint64_t* selected = rows.asRange().bits();
+    TData result = initialValue;
+    bool hasValue = false;
+    auto reduceWord = [&](int32_t index, uint64_t mask) {
+      uint64_t active = selected[index] & mask;
+      if (nulls) {
+        active &= nulls[index];
+      }
+      if (active == 0) {
+        return;
+      }
+      hasValue = true;
+      const auto begin = index * 64;
+      TData wordResult = initialValue;
+      if (active == ~0ULL && indices == nullptr) {
+        if constexpr (Reducer::kSimd) {
+          using Batch = xsimd::batch<TValue>;
+          static_assert(64 % Batch::size == 0);
+          auto batchResult = Batch::broadcast(initialValue);
+          for (auto i = 0; i < 64; i += Batch::size) {
+            batchResult = Reducer::addBatch(
+                batchResult, Batch::load_unaligned(data + begin + i));
+          }
+          alignas(Batch::arch_type::alignment()) TValue lanes[Batch::size];
+          batchResult.store_aligned(lanes);
+          for (auto lane : lanes) {
+            Reducer::combine(wordResult, lane);
+          }
+        } else {
+          for (auto i = 0; i < 64; ++i) {
+            Reducer::add(wordResult, data[begin + i]);
+          }
+        }
+      } else if (indices == nullptr) {
+        bits::forEachSetBit(&active, 0, 64, [&](int32_t i) {
+          Reducer::add(wordResult, data[begin + i]);
+        });
+      } else {
+        bits::forEachSetBit(&active, 0, 64, [&](int32_t i) {
+          Reducer::add(wordResult, data[indices[begin + i]]);
+        });
+      }
+      Reducer::combine(result, wordResult);
+    };
+    bits::forEachWord(rows.begin(), rows.end(), reduceWord);
+    if (hasValue) {
+      updateNonNullValue<true, TData>(group, result, &Reducer::combine);
+    }
+  }
+
   template <typename THook>
   void
   pushdown(char** groups, const SelectivityVector& rows, const VectorPtr& arg) {
@@ -18,6 +18,7 @@
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <xsimd/xsimd.hpp>
 #include "folly/CPortability.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
@@ -48,7 +49,19 @@ namespace stringCore {
 static bool isAscii(const char* str, size_t length);
 
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
+  using Batch = xsimd::batch<int8_t>;
+  size_t i = 0;
+  if (length >= Batch::size) {
+    // Bytes with the high bit set are negative as int8_t.
+    auto bits = Batch::broadcast(0);
+    for (; i + Batch::size <= length; i += Batch::size) {
+      bits |= Batch::load_unaligned(reinterpret_cast<const int8_t*>(str + i));
+    }
+    if (xsimd::any(bits < Batch::broadcast(0))) {
+      return false;
+    }
+  }
+  for (; i < length; i++) {
     if (str[i] & 0x80) {
       return false;
     }
@@ -56,6 +69,53 @@ FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
   return true;
 }
 
+/// Returns the number of leading ascii bytes in the 'length' bytes at 'str'.
+FOLLY_ALWAYS_INLINE size_t asciiPrefixLength(const char* str, size_t length) {
+  using Batch = xsimd::batch<int8_t>;
+  size_t i = 0;
+  for (; i + Batch::size <= length; i += Batch::size) {
+    auto batch =
+        Batch::load_unaligned(reinterpret_cast<const int8_t*>(str + i));
+    if (xsimd::any(batch < Batch::broadcast(0))) {
+      // The first non-ascii byte is in this batch.
+      break;
+    }
+  }
+  for (; i < length; i++) {
+    if (str[i] & 0x80) {
+      break;
+    }
+  }
+  return i;
+}
+
+namespace detail {
+/// Flips the case of the ascii letters in [first, last] of 'input'. 'output'
+/// may be the same as 'input'. Bytes outside of ascii are negative as int8_t
+/// and are never in range, so these are copied as is.
+template <char first, char last>
+FOLLY_ALWAYS_INLINE void
+flipCaseAscii(char* output, const char* input, size_t length) {
+  using Batch = xsimd::batch<int8_t>;
+  size_t i = 0;
+  for (; i + Batch::size <= length; i += Batch::size) {
+    auto chars =
+        Batch::load_unaligned(reinterpret_cast<const int8_t*>(input + i));
+    auto inRange =
+        (chars >= Batch::broadcast(first)) & (chars <= Batch::broadcast(last));
+    xsimd::select(inRange, chars ^ Batch::broadcast(0x20), chars)
+        .store_unaligned(reinterpret_cast<int8_t*>(output + i));
+  }
+  for (; i < length; i++) {
+    if (input[i] >= first && input[i] <= last) {
+      output[i] = input[i] ^ 0x20;
+    } else {
+      output[i] = input[i];
+    }
+  }
+}
+} // namespace detail
+
 /// Perform reverse for ascii string input
 FOLLY_ALWAYS_INLINE static void
 reverseAscii(char* output, const char* input, size_t length) {
@@ -89,28 +149,16 @@ reverseUnicode(char* output, const char* input, size_t length) {
   }
 }
 
-/// Perform upper for ascii string input
+/// Perform upper for ascii string input. 'output' may be the same as 'input'.
 FOLLY_ALWAYS_INLINE static void
 upperAscii(char* output, const char* input, size_t length) {
-  VECTORIZE_LOOP_IF_POSSIBLE for (auto i = 0; i < length; i++) {
-    if (input[i] >= 'a' && input[i] <= 'z') {
-      output[i] = input[i] - 32;
-    } else {
-      output[i] = input[i];
-    }
-  }
+  detail::flipCaseAscii<'a', 'z'>(output, input, length);
 }
 
-/// Perform lower for ascii string input
+/// Perform lower for ascii string input. 'output' may be the same as 'input'.
 FOLLY_ALWAYS_INLINE static void
 lowerAscii(char* output, const char* input, size_t length) {
-  VECTORIZE_LOOP_IF_POSSIBLE for (auto i = 0; i < length; i++) {
-    if (input[i] >= 'A' && input[i] <= 'Z') {
-      output[i] = input[i] + 32;
-    } else {
-      output[i] = input[i];
-    }
-  }
+  detail::flipCaseAscii<'A', 'Z'>(output, input, length);
 }
 
 /// Perform upper for utf8 string input, output should be pre-allocated and
@@ -222,6 +270,14 @@ lengthUnicode(const char* inputBuffer, size_t bufferLength) {
   auto currentChar = inputBuffer;
   int64_t size = 0;
   while (currentChar < buffEndAddress) {
+    if ((*currentChar & 0x80) == 0) {
+      // A run of ascii has one character per byte.
+      auto numAscii =
+          asciiPrefixLength(currentChar, buffEndAddress - currentChar);
+      currentChar += numAscii;
+      size += numAscii;
+      continue;
+    }
     auto chrOffset = utf8proc_char_length(currentChar);
     // Skip bad byte if we get utf length < 0.
     currentChar += UNLIKELY(chrOffset < 0) ? 1 : chrOffset;
@@ -91,6 +91,37 @@ TEST_F(StringImplTest, lowerAscii) {
   }
 }
 
+TEST_F(StringImplTest, longAscii) {
+  // Covers the full batches and the tails of the vectorized kernels.
+  std::string input;
+  std::string expectedUpper;
+  std::string expectedLower;
+  for (auto i = 0; i < 300; ++i) {
+    const char c = 32 + i % 95;
+    input += c;
+    expectedUpper += std::toupper(c);
+    expectedLower += std::tolower(c);
+    ASSERT_TRUE(isAscii(input.data(), input.size()));
+
+    std::string output(input.size(), '\0');
+    upperAscii(output.data(), input.data(), input.size());
+    ASSERT_EQ(output, expectedUpper);
+    lowerAscii(output.data(), input.data(), input.size());
+    ASSERT_EQ(output, expectedLower);
+  }
+
+  for (auto i = 0; i < input.size(); ++i) {
+    auto withUnicode = input;
+    withUnicode[i] = static_cast<char>(0xc3);
+    ASSERT_FALSE(isAscii(withUnicode.data(), withUnicode.size())) << i;
+
+    // Bytes outside of ascii are not changed.
+    std::string output(withUnicode.size(), '\0');
+    upperAscii(output.data(), withUnicode.data(), withUnicode.size());
+    ASSERT_EQ(output[i], withUnicode[i]);
+  }
+}
+
 TEST_F(StringImplTest, upperUnicode) {
   for (auto& testCase : getUpperUnicodeTestData()) {
     auto input = StringView(std::get<0>(testCase));
@@ -176,6 +207,24 @@ TEST_F(StringImplTest, length) {
   }
 }
 
+TEST_F(StringImplTest, mixedAsciiLength) {
+  // Runs of ascii longer and shorter than a SIMD batch between multi-byte and
+  // invalid characters.
+  for (auto asciiLength : {1, 15, 16, 17, 33, 100}) {
+    const std::string ascii(asciiLength, 'a');
+    ASSERT_EQ(
+        length</*isAscii*/ false>(ascii + "\u00A3" + ascii),
+        2 * asciiLength + 1);
+    ASSERT_EQ(
+        length</*isAscii*/ false>("\U0001D122" + ascii + "\u20AC"),
+        asciiLength + 2);
+    // A bad byte counts as one character.
+    ASSERT_EQ(
+        length</*isAscii*/ false>(ascii + "\xBF" + ascii),
+        2 * asciiLength + 1);
+  }
+}
+
 TEST_F(StringImplTest, badUnicodeLength) {
   ASSERT_EQ(0, length</*isAscii*/ false>(std::string("")));
   ASSERT_EQ(2, length</*isAscii*/ false>(std::string("ab")));
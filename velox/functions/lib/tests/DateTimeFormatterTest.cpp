@@ -1475,6 +1475,43 @@ TEST_F(MysqlDateTimeTest, formatYear) {
       VeloxUserError);
 }
 
+TEST_F(MysqlDateTimeTest, formatFixedFields) {
+  auto* timezone = date::locate_zone("GMT");
+  // The trailing literal makes the second formatter in each pair take the
+  // general path.
+  const std::vector<std::pair<std::string, std::string>> formats = {
+      {"%Y-%m-%d", "%Y-%m-%d."},
+      {"%Y/%m/%d %H:%i:%s", "%Y/%m/%d %H:%i:%s."},
+  };
+  for (const auto& [fixed, general] : formats) {
+    auto fixedFormatter = buildMysqlDateTimeFormatter(fixed);
+    auto generalFormatter = buildMysqlDateTimeFormatter(general);
+    for (const auto* timestamp :
+         {"0-01-01",
+          "1-10-24 01:02:03",
+          "1970-01-01",
+          "1969-12-31 23:59:59",
+          "2000-02-29 12:00:00",
+          "9999-12-31 23:59:59",
+          "-1-01-01",
+          "19999-01-01"}) {
+      auto ts = util::fromTimestampString(timestamp);
+      EXPECT_EQ(
+          fixedFormatter->format(ts, timezone) + ".",
+          generalFormatter->format(ts, timezone));
+    }
+  }
+
+  EXPECT_EQ(
+      buildMysqlDateTimeFormatter("%Y-%m-%d %H:%i:%s")
+          ->format(util::fromTimestampString("2023-04-05 06:07:08"), timezone),
+      "2023-04-05 06:07:08");
+  EXPECT_EQ(
+      buildJodaDateTimeFormatter("yyyy-MM-dd")
+          ->format(util::fromTimestampString("2023-04-05 06:07:08"), timezone),
+      "2023-04-05");
+}
+
 TEST_F(MysqlDateTimeTest, formatMonthDay) {
   auto* timezone = date::locate_zone("GMT");
 
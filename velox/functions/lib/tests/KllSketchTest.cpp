@@ -122,6 +122,38 @@ TEST(KllSketchTest, randomInput) {
   }
 }
 
+TEST(KllSketchTest, insertBatch) {
+  constexpr int N = 1e5;
+  KllSketch<double> expected(kDefaultK, {}, 0);
+  std::vector<double> values(N);
+  insertRandomData(0, N, expected, values.data());
+  KllSketch<double> kll(kDefaultK, {}, 0);
+  std::default_random_engine gen(0);
+  std::uniform_int_distribution<> batchSize(0, 1'000);
+  for (int i = 0; i < N;) {
+    auto size = std::min(batchSize(gen), N - i);
+    kll.insert(folly::Range<const double*>(&values[i], size));
+    i += size;
+  }
+  ASSERT_EQ(kll.totalCount(), N);
+  // Compactions happen at the same values and level zero is sorted before
+  // compacting, so the sketches are the same.
+  expected.finish();
+  kll.finish();
+  auto expectedView = expected.toView();
+  auto view = kll.toView();
+  EXPECT_EQ(view.minValue, expectedView.minValue);
+  EXPECT_EQ(view.maxValue, expectedView.maxValue);
+  ASSERT_EQ(
+      std::vector<uint32_t>(view.levels.begin(), view.levels.end()),
+      std::vector<uint32_t>(
+          expectedView.levels.begin(), expectedView.levels.end()));
+  ASSERT_EQ(
+      std::vector<double>(view.items.begin(), view.items.end()),
+      std::vector<double>(
+          expectedView.items.begin(), expectedView.items.end()));
+}
+
 TEST(KllSketchTest, merge) {
   constexpr int N = 1e4;
   constexpr int M = 1001;
@@ -270,6 +270,56 @@ TEST_F(Re2FunctionsTest, regexSearchBatch) {
   re2Search.testBatchAll();
 }
 
+TEST_F(Re2FunctionsTest, requiredLiteral) {
+  auto literal = [](const std::string& pattern) {
+    return re2RequiredLiteral(StringView(pattern));
+  };
+  EXPECT_EQ(literal("ERROR"), "ERROR");
+  EXPECT_EQ(literal("^ERROR: .*timeout$"), "ERROR: ");
+  EXPECT_EQ(literal("user_id=\\d+ status=failed"), " status=failed");
+  EXPECT_EQ(literal("abc?def"), "def");
+  EXPECT_EQ(literal("abcd*ef"), "abc");
+  EXPECT_EQ(literal("ab+cd"), "ab");
+  EXPECT_EQ(literal("ab{0,3}cd"), "cd");
+  EXPECT_EQ(literal("a\\.b\\.c"), "a.b.c");
+  EXPECT_EQ(literal("(optional)?xy[a-z]+"), "xy");
+  EXPECT_EQ(literal("(?:foo)+barbaz"), "barbaz");
+  EXPECT_EQ(literal("[)]abc"), "abc");
+  EXPECT_EQ(literal("xé?yz"), "yz");
+
+  // Patterns that are not analyzed.
+  EXPECT_EQ(literal(""), "");
+  EXPECT_EQ(literal("foo|bar"), "");
+  EXPECT_EQ(literal("(?i)error"), "");
+  EXPECT_EQ(literal("\\x41bc"), "");
+  EXPECT_EQ(literal("\\d+"), "");
+}
+
+TEST_F(Re2FunctionsTest, requiredLiteralPrefilter) {
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({makeFlatVector<std::string>(
+      size, [](auto row) {
+        return fmt::format(
+            "{} request {} took {}ms",
+            row % 3 == 0 ? "ERROR" : "INFO",
+            row,
+            row % 7);
+      })});
+
+  auto searchResult = evaluate<SimpleVector<bool>>(
+      "re2_search(c0, 'ERROR request \\d+ took [0-3]ms')", data);
+  auto extractResult = evaluate<SimpleVector<StringView>>(
+      "re2_extract(c0, 'ERROR request (\\d+) took', 1)", data);
+  for (vector_size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(searchResult->valueAt(i), i % 3 == 0 && i % 7 <= 3) << i;
+    if (i % 3 == 0) {
+      ASSERT_EQ(extractResult->valueAt(i), StringView(std::to_string(i)));
+    } else {
+      ASSERT_TRUE(extractResult->isNullAt(i)) << i;
+    }
+  }
+}
+
 template <typename F>
 void testRe2Extract(F&& regexExtract) {
   // Regex with no subgroup matches.
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/functions/lib/TimeUtils.h"
+
+#include <gtest/gtest.h>
+
+namespace facebook::velox::functions {
+namespace {
+
+void expectSameAsGmtime(int64_t seconds) {
+  std::tm expected;
+  ASSERT_NE(gmtime_r((const time_t*)&seconds, &expected), nullptr);
+  std::tm actual;
+  ASSERT_TRUE(civilFromSeconds(seconds, actual));
+  EXPECT_EQ(actual.tm_year, expected.tm_year) << seconds;
+  EXPECT_EQ(actual.tm_mon, expected.tm_mon) << seconds;
+  EXPECT_EQ(actual.tm_mday, expected.tm_mday) << seconds;
+  EXPECT_EQ(actual.tm_yday, expected.tm_yday) << seconds;
+  EXPECT_EQ(actual.tm_wday, expected.tm_wday) << seconds;
+  EXPECT_EQ(actual.tm_hour, expected.tm_hour) << seconds;
+  EXPECT_EQ(actual.tm_min, expected.tm_min) << seconds;
+  EXPECT_EQ(actual.tm_sec, expected.tm_sec) << seconds;
+  EXPECT_EQ(secondsFromDateTime(actual), seconds);
+}
+
+TEST(TimeUtilsTest, civilFromSeconds) {
+  // Every day in 1600 - 2400 at varying times of day, which covers leap years
+  // and the century rules in both directions from the epoch.
+  const auto begin = daysFromCivil(1600, 1, 1);
+  const auto end = daysFromCivil(2400, 1, 1);
+  for (auto day = begin; day < end; ++day) {
+    expectSameAsGmtime(day * kSecondsInDay + (day * 7'919) % kSecondsInDay);
+  }
+  for (int64_t seconds : {-1L, 0L, 1L, 86'399L, 86'400L, -86'400L, -86'401L}) {
+    expectSameAsGmtime(seconds);
+  }
+  expectSameAsGmtime(daysFromCivil(-10'000, 3, 1) * kSecondsInDay - 1);
+  expectSameAsGmtime(daysFromCivil(100'000, 12, 31) * kSecondsInDay);
+
+  std::tm dateTime;
+  EXPECT_FALSE(civilFromSeconds(std::numeric_limits<int64_t>::max(), dateTime));
+}
+
+} // namespace
+} // namespace facebook::velox::functions
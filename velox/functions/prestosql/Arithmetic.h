@@ -25,6 +25,7 @@
 
 #include "folly/CPortability.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/Macros.h"
 #include "velox/functions/prestosql/ArithmeticImpl.h"
 
@@ -54,6 +55,15 @@ struct PlusFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = plus(a, b);
   }
+
+  template <typename TInput>
+  void callBatch(
+      TInput* result,
+      const TInput* a,
+      const TInput* b,
+      int32_t size) {
+    simd::transform(a, b, result, size, [](auto x, auto y) { return x + y; });
+  }
 };
 
 template <typename T>
@@ -63,6 +73,15 @@ struct MinusFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = minus(a, b);
   }
+
+  template <typename TInput>
+  void callBatch(
+      TInput* result,
+      const TInput* a,
+      const TInput* b,
+      int32_t size) {
+    simd::transform(a, b, result, size, [](auto x, auto y) { return x - y; });
+  }
 };
 
 template <typename T>
@@ -72,6 +91,15 @@ struct MultiplyFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = multiply(a, b);
   }
+
+  template <typename TInput>
+  void callBatch(
+      TInput* result,
+      const TInput* a,
+      const TInput* b,
+      int32_t size) {
+    simd::transform(a, b, result, size, [](auto x, auto y) { return x * y; });
+  }
 };
 
 template <typename T>
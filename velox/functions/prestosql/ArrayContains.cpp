@@ -13,12 +13,30 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/vector/DecodedVector.h"
 
 namespace facebook::velox::functions {
 namespace {
 
+// Returns true if one of the 'size' non-null 'values' is equal to 'search'.
+template <typename T>
+bool contains(const T* values, vector_size_t size, const T& search) {
+  if constexpr (
+      std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+      sizeof(T) <= sizeof(int64_t)) {
+    return simd::indexOf(values, size, search) >= 0;
+  } else {
+    for (auto i = 0; i < size; i++) {
+      if (values[i] == search) {
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
 template <TypeKind kind>
 void applyTyped(
     const SelectivityVector& rows,
@@ -36,22 +54,19 @@ void applyTyped(
   constexpr bool isBoolType = std::is_same_v<bool, T>;
 
   if (!isBoolType && elementsDecoded.isIdentityMapping() &&
-      !elementsDecoded.mayHaveNulls() && searchDecoded.isConstantMapping()) {
+      !elementsDecoded.mayHaveNulls()) {
     auto rawElements = elementsDecoded.data<T>();
-    auto search = searchDecoded.valueAt<T>(0);
+    const bool constantSearch = searchDecoded.isConstantMapping();
+    const auto constantValue =
+        constantSearch ? searchDecoded.valueAt<T>(0) : T{};
 
     rows.applyToSelected([&](auto row) {
       auto size = rawSizes[indices[row]];
       auto offset = rawOffsets[indices[row]];
+      auto search =
+          constantSearch ? constantValue : searchDecoded.valueAt<T>(row);
 
-      for (auto i = 0; i < size; i++) {
-        if (rawElements[offset + i] == search) {
-          flatResult.set(row, true);
-          return;
-        }
-      }
-
-      flatResult.set(row, false);
+      flatResult.set(row, contains(rawElements + offset, size, search));
     });
   } else {
     rows.applyToSelected([&](auto row) {
@@ -71,6 +71,43 @@ class ArrayDistinctFunction : public exec::VectorFunction {
   }
 
  private:
+  // Arrays of at most this many elements are deduplicated by comparing each
+  // element with the distinct elements found before it instead of hashing.
+  static constexpr vector_size_t kMaxLinearScanSize = 16;
+
+  // Appends the indices of the first occurrences of the 'size' elements at
+  // 'offset' to 'rawNewIndices' at 'indicesCursor'.
+  static void addDistinctSmall(
+      DecodedVector& elements,
+      vector_size_t offset,
+      vector_size_t size,
+      vector_size_t* rawNewIndices,
+      vector_size_t& indicesCursor) {
+    const auto begin = indicesCursor;
+    bool hasNulls = false;
+    for (vector_size_t i = offset; i < offset + size; ++i) {
+      if (elements.isNullAt(i)) {
+        if (!hasNulls) {
+          hasNulls = true;
+          rawNewIndices[indicesCursor++] = i;
+        }
+        continue;
+      }
+      const auto value = elements.valueAt<T>(i);
+      bool found = false;
+      for (auto j = begin; j < indicesCursor; ++j) {
+        const auto index = rawNewIndices[j];
+        if (!elements.isNullAt(index) && elements.valueAt<T>(index) == value) {
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        rawNewIndices[indicesCursor++] = i;
+      }
+    }
+  }
+
   VectorPtr applyFlat(
       const SelectivityVector& rows,
       const VectorPtr& arg,
@@ -104,6 +141,12 @@ class ArrayDistinctFunction : public exec::VectorFunction {
       auto offset = arrayVector->offsetAt(row);
 
       rawOffsets[row] = indicesCursor;
+      if (size <= kMaxLinearScanSize) {
+        addDistinctSmall(
+            *elements.get(), offset, size, rawNewIndices, indicesCursor);
+        rawSizes[row] = indicesCursor - rawOffsets[row];
+        return;
+      }
       bool hasNulls = false;
       for (vector_size_t i = offset; i < offset + size; ++i) {
         if (elements->isNullAt(i)) {
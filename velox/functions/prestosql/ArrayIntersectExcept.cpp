@@ -19,6 +19,10 @@
 
 namespace facebook::velox::functions {
 namespace {
+// Rows where both arrays have at most this many elements are processed by
+// linear scans instead of hash sets.
+constexpr vector_size_t kMaxLinearScanSize = 16;
+
 template <typename T>
 
 struct SetWithNull {
@@ -209,6 +213,63 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
       rawNewLengths[row] = indicesCursor - rawNewOffsets[row];
     };
 
+    // Same as processRow for small arrays on both sides. Looks up values in
+    // the right-hand side and in the output so far by linear scan instead of
+    // building sets.
+    auto processSmallRow = [&](vector_size_t row,
+                               vector_size_t rightOffset,
+                               vector_size_t rightSize,
+                               DecodedVector& rightElements) {
+      auto idx = decodedLeftArray->index(row);
+      auto size = baseLeftArray->sizeAt(idx);
+      auto offset = baseLeftArray->offsetAt(idx);
+
+      rawNewOffsets[row] = indicesCursor;
+      const auto rightEnd = rightOffset + rightSize;
+      bool rightHasNull = false;
+      for (auto j = rightOffset; j < rightEnd; ++j) {
+        if (rightElements.isNullAt(j)) {
+          rightHasNull = true;
+          break;
+        }
+      }
+
+      bool outputHasNull = false;
+      for (vector_size_t i = offset; i < (offset + size); ++i) {
+        if (decodedLeftElements->isNullAt(i)) {
+          if (!outputHasNull && rightHasNull == isIntersect) {
+            bits::setNull(rawNewElementNulls, indicesCursor++, true);
+            outputHasNull = true;
+          }
+          continue;
+        }
+        auto val = decodedLeftElements->valueAt<T>(i);
+        bool found = false;
+        for (auto j = rightOffset; j < rightEnd; ++j) {
+          if (!rightElements.isNullAt(j) &&
+              rightElements.valueAt<T>(j) == val) {
+            found = true;
+            break;
+          }
+        }
+        if (found != isIntersect) {
+          continue;
+        }
+        bool added = false;
+        for (auto k = rawNewOffsets[row]; k < indicesCursor; ++k) {
+          if (!bits::isBitNull(rawNewElementNulls, k) &&
+              decodedLeftElements->valueAt<T>(rawNewIndices[k]) == val) {
+            added = true;
+            break;
+          }
+        }
+        if (!added) {
+          rawNewIndices[indicesCursor++] = i;
+        }
+      }
+      rawNewLengths[row] = indicesCursor - rawNewOffsets[row];
+    };
+
     SetWithNull<T> outputSet;
 
     // Optimized case when the right-hand side array is constant.
@@ -229,6 +290,16 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
       auto rightArrayVector = rightHolder.get()->base()->as<ArrayVector>();
       rows.applyToSelected([&](vector_size_t row) {
         auto idx = rightHolder.get()->index(row);
+        if (rightArrayVector->sizeAt(idx) <= kMaxLinearScanSize &&
+            baseLeftArray->sizeAt(decodedLeftArray->index(row)) <=
+                kMaxLinearScanSize) {
+          processSmallRow(
+              row,
+              rightArrayVector->offsetAt(idx),
+              rightArrayVector->sizeAt(idx),
+              *decodedRightElements);
+          return;
+        }
         generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
         processRow(row, rightSet, outputSet);
       });
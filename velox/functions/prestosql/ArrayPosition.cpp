@@ -15,6 +15,7 @@
  */
 #include <folly/CPortability.h>
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/vector/DecodedVector.h"
@@ -22,6 +23,24 @@
 namespace facebook::velox::functions {
 namespace {
 
+// Returns the index of the first of 'size' non-null 'values' equal to
+// 'search' or -1 if none is.
+template <typename T>
+int32_t firstMatch(const T* values, vector_size_t size, const T& search) {
+  if constexpr (
+      std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+      sizeof(T) <= sizeof(int64_t)) {
+    return simd::indexOf(values, size, search);
+  } else {
+    for (auto i = 0; i < size; i++) {
+      if (values[i] == search) {
+        return i;
+      }
+    }
+    return -1;
+  }
+}
+
 // Find the index of the first match for primitive types.
 template <
     TypeKind kind,
@@ -74,16 +93,7 @@ void applyTypedFirstMatch(
       auto size = rawSizes[indices[row]];
       auto offset = rawOffsets[indices[row]];
 
-      int i;
-      for (i = 0; i < size; i++) {
-        if (rawElements[offset + i] == search) {
-          flatResult.set(row, i + 1);
-          break;
-        }
-      }
-      if (i == size) {
-        flatResult.set(row, 0);
-      }
+      flatResult.set(row, firstMatch(rawElements + offset, size, search) + 1);
     });
     return;
   }
@@ -87,6 +87,23 @@ class ArraySumFunction : public exec::VectorFunction {
       const uint64_t* rawNulls,
       const TInput* rawElements,
       FlatVector<TOutput>* resultValues) const {
+    if constexpr (
+        !mayHaveNulls && std::is_integral_v<TInput> &&
+        sizeof(TInput) < sizeof(int64_t)) {
+      // The sum of fewer than 2^31 values narrower than 64 bits does not
+      // overflow int64_t. This saves the checked add per element and lets the
+      // loop vectorize.
+      context.applyToSelectedNoThrow(rows, [&](auto row) {
+        const auto start = arrayVector->offsetAt(row);
+        const auto end = start + arrayVector->sizeAt(row);
+        int64_t sum = 0;
+        for (auto i = start; i < end; ++i) {
+          sum += rawElements[i];
+        }
+        resultValues->set(row, sum);
+      });
+      return;
+    }
     applyCore<mayHaveNulls>(
         rows,
         context,
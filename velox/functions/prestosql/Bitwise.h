@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/Macros.h"
 namespace facebook::velox::functions {
 
@@ -25,6 +26,14 @@ struct BitwiseAndFunction {
     result = a & b;
     return true;
   }
+
+  void callBatch(
+      int64_t* result,
+      const int64_t* a,
+      const int64_t* b,
+      int32_t size) {
+    simd::transform(a, b, result, size, [](auto x, auto y) { return x & y; });
+  }
 };
 
 template <typename T>
@@ -57,6 +66,10 @@ struct BitwiseNotFunction {
     result = ~a;
     return true;
   }
+
+  void callBatch(int64_t* result, const int64_t* a, int32_t size) {
+    simd::transformUnary(a, result, size, [](auto x) { return ~x; });
+  }
 };
 
 template <typename T>
@@ -66,6 +79,14 @@ struct BitwiseOrFunction {
     result = a | b;
     return true;
   }
+
+  void callBatch(
+      int64_t* result,
+      const int64_t* a,
+      const int64_t* b,
+      int32_t size) {
+    simd::transform(a, b, result, size, [](auto x, auto y) { return x | y; });
+  }
 };
 
 template <typename T>
@@ -75,6 +96,14 @@ struct BitwiseXorFunction {
     result = a ^ b;
     return true;
   }
+
+  void callBatch(
+      int64_t* result,
+      const int64_t* a,
+      const int64_t* b,
+      int32_t size) {
+    simd::transform(a, b, result, size, [](auto x, auto y) { return x ^ y; });
+  }
 };
 
 template <typename T>
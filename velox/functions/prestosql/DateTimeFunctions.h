@@ -68,6 +68,10 @@ template <typename T>
 struct TimestampWithTimezoneSupport {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Distinct from the converter of InitSessionTimezone, which functions
+  // inherit alongside this.
+  TimeZoneConverter timestampWithTimezoneConverter_;
+
   // Convert timestampWithTimezone to a timestamp representing the moment at the
   // zone in timestampWithTimezone.
   FOLLY_ALWAYS_INLINE
@@ -75,7 +79,8 @@ struct TimestampWithTimezoneSupport {
       const arg_type<TimestampWithTimezone>& timestampWithTimezone) {
     const auto milliseconds = *timestampWithTimezone.template at<0>();
     Timestamp timestamp = Timestamp::fromMillis(milliseconds);
-    timestamp.toTimezone(*timestampWithTimezone.template at<1>());
+    timestampWithTimezoneConverter_.toTimezone(
+        timestamp, *timestampWithTimezone.template at<1>());
 
     return timestamp;
   }
@@ -170,7 +175,7 @@ struct WeekFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getWeek(getDateTime(timestamp, this->timeZone_));
+    result = getWeek(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -197,7 +202,7 @@ struct YearFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getYear(getDateTime(timestamp, this->timeZone_));
+    result = getYear(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -224,7 +229,7 @@ struct QuarterFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getQuarter(getDateTime(timestamp, this->timeZone_));
+    result = getQuarter(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -251,7 +256,7 @@ struct MonthFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getMonth(getDateTime(timestamp, this->timeZone_));
+    result = getMonth(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -274,7 +279,7 @@ struct DayFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_mday;
+    result = this->getLocalDateTime(timestamp).tm_mday;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -345,7 +350,7 @@ struct DayOfWeekFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDayOfWeek(getDateTime(timestamp, this->timeZone_));
+    result = getDayOfWeek(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -372,7 +377,7 @@ struct DayOfYearFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDayOfYear(getDateTime(timestamp, this->timeZone_));
+    result = getDayOfYear(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -416,7 +421,7 @@ struct YearOfWeekFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = computeYearOfWeek(getDateTime(timestamp, this->timeZone_));
+    result = computeYearOfWeek(this->getLocalDateTime(timestamp));
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -439,7 +444,7 @@ struct HourFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_hour;
+    result = this->getLocalDateTime(timestamp).tm_hour;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -462,7 +467,7 @@ struct MinuteFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_min;
+    result = this->getLocalDateTime(timestamp).tm_min;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -613,6 +618,7 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
   const date::time_zone* timeZone_ = nullptr;
+  TimeZoneConverter timeZoneConverter_;
   std::optional<DateTimeUnit> unit_;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -688,12 +694,16 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
       return;
     }
 
-    auto dateTime = getDateTime(timestamp, timeZone_);
+    auto localTimestamp = timestamp;
+    if (timeZone_ != nullptr) {
+      timeZoneConverter_.toTimezone(localTimestamp, *timeZone_);
+    }
+    auto dateTime = getDateTime(localTimestamp.getSeconds());
     adjustDateTime(dateTime, unit);
 
-    result = Timestamp(timegm(&dateTime), 0);
+    result = Timestamp(secondsFromDateTime(dateTime), 0);
     if (timeZone_ != nullptr) {
-      result.toGMT(*timeZone_);
+      timeZoneConverter_.toGMT(result, *timeZone_);
     }
   }
 
@@ -713,7 +723,7 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
     auto dateTime = getDateTime(date);
     adjustDateTime(dateTime, unit);
 
-    result = Date(timegm(&dateTime) / kSecondsInDay);
+    result = Date(secondsFromDateTime(dateTime) / kSecondsInDay);
   }
 
   FOLLY_ALWAYS_INLINE void call(
@@ -739,8 +749,9 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
     auto timestamp = this->toTimestamp(timestampWithTimezone);
     auto dateTime = getDateTime(timestamp, nullptr);
     adjustDateTime(dateTime, unit);
-    timestamp = Timestamp::fromMillis(timegm(&dateTime) * 1000);
-    timestamp.toGMT(*timestampWithTimezone.template at<1>());
+    timestamp = Timestamp::fromMillis(secondsFromDateTime(dateTime) * 1000);
+    timeZoneConverter_.toGMT(
+        timestamp, *timestampWithTimezone.template at<1>());
 
     result.template get_writer_at<0>() = timestamp.toMillis();
     result.template get_writer_at<1>() =
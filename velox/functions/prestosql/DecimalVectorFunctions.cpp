@@ -39,6 +39,12 @@ class DecimalBaseFunction : public exec::VectorFunction {
       exec::EvalCtx& context,
       VectorPtr& result) const override {
     auto rawResults = prepareResults(rows, resultType, context, result);
+    if constexpr (Operation::kCanDeferOverflowCheck) {
+      if (aRescale_ == 0 && bRescale_ == 0 &&
+          applyDeferOverflowCheck(rows, args, rawResults)) {
+        return;
+      }
+    }
     if (args[0]->isConstantEncoding() && args[1]->isFlatEncoding()) {
       // Fast path for (const, flat).
       auto constant = args[0]->asUnchecked<SimpleVector<A>>()->valueAt(0);
@@ -84,6 +90,70 @@ class DecimalBaseFunction : public exec::VectorFunction {
   }
 
  private:
+  // Computes flat and constant arguments that need no rescaling in a loop
+  // without per row overflow checks, which the compiler can vectorize. Returns
+  // false if the arguments are encoded or any row overflowed. The caller then
+  // computes all rows again with the checked Operation::apply() to report the
+  // errors.
+  bool applyDeferOverflowCheck(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      R* rawResults) const {
+    if (args[0]->isFlatEncoding() && args[1]->isFlatEncoding()) {
+      auto rawA = args[0]->asUnchecked<FlatVector<A>>()->rawValues();
+      auto rawB = args[1]->asUnchecked<FlatVector<B>>()->rawValues();
+      return applyDeferOverflowCheck(
+          rows,
+          rawResults,
+          [&](auto row) { return rawA[row]; },
+          [&](auto row) { return rawB[row]; });
+    }
+    if (args[0]->isFlatEncoding() && args[1]->isConstantEncoding()) {
+      auto rawA = args[0]->asUnchecked<FlatVector<A>>()->rawValues();
+      auto constant = args[1]->asUnchecked<SimpleVector<B>>()->valueAt(0);
+      return applyDeferOverflowCheck(
+          rows,
+          rawResults,
+          [&](auto row) { return rawA[row]; },
+          [&](auto /*row*/) { return constant; });
+    }
+    if (args[0]->isConstantEncoding() && args[1]->isFlatEncoding()) {
+      auto constant = args[0]->asUnchecked<SimpleVector<A>>()->valueAt(0);
+      auto rawB = args[1]->asUnchecked<FlatVector<B>>()->rawValues();
+      return applyDeferOverflowCheck(
+          rows,
+          rawResults,
+          [&](auto /*row*/) { return constant; },
+          [&](auto row) { return rawB[row]; });
+    }
+    return false;
+  }
+
+  template <typename AFunc, typename BFunc>
+  bool applyDeferOverflowCheck(
+      const SelectivityVector& rows,
+      R* rawResults,
+      AFunc a,
+      BFunc b) const {
+    bool overflow = false;
+    auto applyRow = [&](vector_size_t row) {
+      rawResults[row] =
+          Operation::template applyUnchecked<R>(R(a(row)), R(b(row)), overflow);
+      if constexpr (std::is_same_v<R, int128_t>) {
+        overflow |= (rawResults[row] < DecimalUtil::kLongDecimalMin) |
+            (rawResults[row] > DecimalUtil::kLongDecimalMax);
+      }
+    };
+    if (rows.isAllSelected()) {
+      for (auto row = rows.begin(); row < rows.end(); ++row) {
+        applyRow(row);
+      }
+    } else {
+      rows.applyToSelected(applyRow);
+    }
+    return !overflow;
+  }
+
   R* prepareResults(
       const SelectivityVector& rows,
       const TypePtr& resultType,
@@ -253,8 +323,26 @@ class DecimalBetweenFunction : public exec::VectorFunction {
   }
 };
 
+// Unsigned type of the same width as the short and long decimal type 'T'.
+template <typename T>
+using UnsignedDecimal =
+    std::conditional_t<std::is_same_v<T, int128_t>, __uint128_t, uint64_t>;
+
 class Addition {
  public:
+  static constexpr bool kCanDeferOverflowCheck = true;
+
+  /// Returns a + b of arguments that need no rescaling. Sets 'overflow' to
+  /// true on overflow and leaves it unchanged otherwise.
+  template <typename R>
+  inline static R applyUnchecked(R a, R b, bool& overflow) {
+    using U = UnsignedDecimal<R>;
+    const R r = static_cast<R>(static_cast<U>(a) + static_cast<U>(b));
+    // The sum overflows if its sign differs from the signs of both arguments.
+    overflow |= ((a ^ r) & (b ^ r)) < 0;
+    return r;
+  }
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale)
@@ -297,6 +385,20 @@ class Addition {
 
 class Subtraction {
  public:
+  static constexpr bool kCanDeferOverflowCheck = true;
+
+  /// Returns a - b of arguments that need no rescaling. Sets 'overflow' to
+  /// true on overflow and leaves it unchanged otherwise.
+  template <typename R>
+  inline static R applyUnchecked(R a, R b, bool& overflow) {
+    using U = UnsignedDecimal<R>;
+    const R r = static_cast<R>(static_cast<U>(a) - static_cast<U>(b));
+    // The difference overflows if the arguments have different signs and the
+    // sign of the difference differs from the sign of 'a'.
+    overflow |= ((a ^ b) & (a ^ r)) < 0;
+    return r;
+  }
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale)
@@ -335,6 +437,17 @@ class Subtraction {
 
 class Multiply {
  public:
+  static constexpr bool kCanDeferOverflowCheck = true;
+
+  /// Returns a * b. Sets 'overflow' to true on overflow and leaves it
+  /// unchanged otherwise.
+  template <typename R>
+  inline static R applyUnchecked(R a, R b, bool& overflow) {
+    R r;
+    overflow |= __builtin_mul_overflow(a, b, &r);
+    return r;
+  }
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale) {
@@ -360,6 +473,8 @@ class Multiply {
 
 class Divide {
  public:
+  static constexpr bool kCanDeferOverflowCheck = false;
+
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t /*bRescale*/) {
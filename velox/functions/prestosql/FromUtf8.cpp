@@ -16,6 +16,7 @@
 #include "velox/expression/DecodedArgs.h"
 #include "velox/expression/StringWriter.h"
 #include "velox/expression/VectorFunction.h"
+#include "velox/functions/lib/string/StringCore.h"
 #include "velox/functions/lib/string/StringImpl.h"
 #include "velox/functions/prestosql/Utf8Utils.h"
 
@@ -173,19 +174,10 @@ class FromUtf8Function : public exec::VectorFunction {
     std::optional<vector_size_t> firstInvalidRow;
     rows.testSelected([&](auto row) {
       auto value = decodedInput.valueAt<StringView>(row);
-
-      int32_t pos = 0;
-      while (pos < value.size()) {
-        auto charLength =
-            tryGetCharLength(value.data() + pos, value.size() - pos);
-        if (charLength < 0) {
-          firstInvalidRow = row;
-          return false;
-        }
-
-        pos += charLength;
+      if (!isValidUtf8(value.data(), value.size())) {
+        firstInvalidRow = row;
+        return false;
       }
-
       return true;
     });
     return firstInvalidRow;
@@ -255,6 +247,14 @@ class FromUtf8Function : public exec::VectorFunction {
 
     int32_t pos = 0;
     while (pos < input.size()) {
+      if ((input.data()[pos] & 0x80) == 0) {
+        // Copies a run of ASCII at once.
+        auto numAscii = stringCore::asciiPrefixLength(
+            input.data() + pos, input.size() - pos);
+        fixedWriter.append(std::string_view(input.data() + pos, numAscii));
+        pos += numAscii;
+        continue;
+      }
       auto charLength =
           tryGetCharLength(input.data() + pos, input.size() - pos);
       if (charLength > 0) {
@@ -174,7 +174,7 @@ class MapZipWithFunction : public exec::VectorFunction {
       elementRows.updateBounds();
 
       BufferPtr wrapCapture;
-      if (entry.callable->hasCapture()) {
+      if (entry.callable->needsWrapCapture()) {
         wrapCapture = makeWrapCapture(
             *entry.rows, index, mergeResults.rawNewSizes, context.pool());
       }
@@ -16,7 +16,9 @@
 #include "simdjson.h"
 #include "velox/functions/Macros.h"
 #include "velox/functions/UDFOutputString.h"
+#include "velox/functions/prestosql/json/JsonExtractor.h"
 #include "velox/functions/prestosql/json/JsonPathTokenizer.h"
+#include "velox/functions/prestosql/json/SIMDJsonExtractor.h"
 #include "velox/functions/prestosql/types/JsonType.h"
 
 namespace facebook::velox::functions {
@@ -58,6 +60,53 @@ struct SIMDIsJsonScalarFunction {
   }
 };
 
+// jsonExtractScalar(json, json_path) -> varchar
+// Same as JsonExtractScalarFunction. A constant path is tokenized once and the
+// documents are parsed with a SIMDJsonExtractor that is reused across rows.
+// Paths that the extractor doesn't support and documents that it can't parse
+// go through jsonExtractScalar().
+template <typename T>
+struct SIMDJsonExtractScalarFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Json>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    if (jsonPath != nullptr) {
+      extractor_ = SIMDJsonExtractor::create(
+          {std::string_view(jsonPath->data(), jsonPath->size())});
+    }
+  }
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Varchar>& result,
+      const arg_type<Json>& json,
+      const arg_type<Varchar>& jsonPath) {
+    if (extractor_) {
+      bool found = false;
+      if (extractor_->extractScalars(
+              std::string_view(json.data(), json.size()),
+              [&](size_t /*index*/, std::string_view value) {
+                UDFOutputString::assign(result, value);
+                found = true;
+              })) {
+        return found;
+      }
+    }
+    auto extractResult = jsonExtractScalar(
+        folly::StringPiece(json), folly::StringPiece(jsonPath));
+    if (extractResult.hasValue()) {
+      UDFOutputString::assign(result, *extractResult);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  std::unique_ptr<SIMDJsonExtractor> extractor_;
+};
+
 template <typename T>
 struct SIMDJsonArrayContainsFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <array>
+
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/StringWriter.h"
@@ -35,6 +37,9 @@ namespace {
 template <bool isLower /*instantiate for upper or lower*/>
 class UpperLowerTemplateFunction : public exec::VectorFunction {
  private:
+  // Max number of string buffers of an input converted buffer by buffer.
+  static constexpr size_t kMaxBuffers = 8;
+
   /// String encoding wrappable function
   template <bool isAscii>
   struct ApplyInternal {
@@ -56,6 +61,105 @@ class UpperLowerTemplateFunction : public exec::VectorFunction {
     }
   };
 
+  FOLLY_ALWAYS_INLINE static void
+  convertAscii(char* output, const char* input, size_t length) {
+    if constexpr (isLower) {
+      stringCore::lowerAscii(output, input, length);
+    } else {
+      stringCore::upperAscii(output, input, length);
+    }
+  }
+
+  // Converts the inlined strings of the selected rows of 'results' in the
+  // StringViews and rebuilds the others so that their prefixes match the
+  // converted string buffers. 'translate' maps the data of a non-inlined
+  // input string to the converted copy.
+  template <typename TTranslate>
+  static void convertStringViews(
+      const SelectivityVector& rows,
+      const FlatVector<StringView>& input,
+      FlatVector<StringView>* results,
+      TTranslate translate) {
+    auto* rawInput = input.rawValues();
+    auto* rawResults = results->mutableRawValues();
+    rows.applyToSelected([&](auto row) {
+      const auto value = rawInput[row];
+      if (value.isInline()) {
+        char converted[StringView::kInlineSize];
+        convertAscii(converted, value.data(), value.size());
+        rawResults[row] = StringView(converted, value.size());
+      } else {
+        rawResults[row] = StringView(translate(value.data()), value.size());
+      }
+    });
+  }
+
+  // Converts the string buffers of the flat ascii 'input' with one kernel
+  // call per buffer instead of one per row when the buffers are not much
+  // larger than the strings they hold. Returns false if not applied.
+  bool tryApplyToBuffers(
+      const SelectivityVector& rows,
+      const FlatVector<StringView>& input,
+      FlatVector<StringView>* results,
+      exec::EvalCtx& context,
+      bool inPlace) const {
+    const auto& buffers = input.stringBuffers();
+    if (buffers.empty() || buffers.size() > kMaxBuffers) {
+      return false;
+    }
+    uint64_t bufferBytes = 0;
+    for (const auto& buffer : buffers) {
+      bufferBytes += buffer->size();
+    }
+    // Returns the index of the buffer holding 'data' or -1.
+    auto findBuffer = [&](const char* data) {
+      for (auto i = 0; i < buffers.size(); ++i) {
+        auto* start = buffers[i]->as<char>();
+        if (data >= start && data < start + buffers[i]->size()) {
+          return i;
+        }
+      }
+      return -1;
+    };
+    uint64_t stringBytes = 0;
+    auto* rawInput = input.rawValues();
+    const bool allInBuffers = rows.testSelected([&](auto row) {
+      const auto& value = rawInput[row];
+      if (value.isInline()) {
+        return true;
+      }
+      stringBytes += value.size();
+      return findBuffer(value.data()) >= 0;
+    });
+    if (!allInBuffers || bufferBytes > 2 * stringBytes) {
+      return false;
+    }
+
+    if (inPlace) {
+      for (const auto& buffer : buffers) {
+        auto* data = buffer->asMutable<char>();
+        convertAscii(data, data, buffer->size());
+      }
+      convertStringViews(
+          rows, input, results, [](const char* data) { return data; });
+      return true;
+    }
+
+    std::array<char*, kMaxBuffers> copies;
+    for (auto i = 0; i < buffers.size(); ++i) {
+      auto copy =
+          AlignedBuffer::allocate<char>(buffers[i]->size(), context.pool());
+      copies[i] = copy->asMutable<char>();
+      convertAscii(copies[i], buffers[i]->as<char>(), buffers[i]->size());
+      results->addStringBuffer(copy);
+    }
+    convertStringViews(rows, input, results, [&](const char* data) {
+      const auto i = findBuffer(data);
+      return copies[i] + (data - buffers[i]->as<char>());
+    });
+    return true;
+  }
+
   void applyInternalInPlace(
       const SelectivityVector& rows,
       DecodedVector* decodedInput,
@@ -105,6 +209,13 @@ class UpperLowerTemplateFunction : public exec::VectorFunction {
     if (tryInplace &&
         prepareFlatResultsVector(result, rows, context, args.at(0))) {
       auto* resultFlatVector = result->as<FlatVector<StringView>>();
+      // Converting the buffers in place also converts the strings of the
+      // rows that are not selected, so this needs all rows.
+      if (rows.isAllSelected() && rows.size() == resultFlatVector->size() &&
+          tryApplyToBuffers(
+              rows, *resultFlatVector, resultFlatVector, context, true)) {
+        return;
+      }
       applyInternalInPlace(rows, decodedInput, resultFlatVector);
       return;
     }
@@ -114,6 +225,16 @@ class UpperLowerTemplateFunction : public exec::VectorFunction {
     prepareFlatResultsVector(result, rows, context, emptyVectorPtr);
     auto* resultFlatVector = result->as<FlatVector<StringView>>();
 
+    if (tryInplace &&
+        tryApplyToBuffers(
+            rows,
+            *inputStringsVector->asUnchecked<FlatVector<StringView>>(),
+            resultFlatVector,
+            context,
+            false)) {
+      return;
+    }
+
     StringEncodingTemplateWrapper<ApplyInternal>::apply(
         ascii, rows, decodedInput, resultFlatVector);
   }
@@ -15,10 +15,82 @@
  */
 
 #include "URLFunctions.h"
+
+#include <algorithm>
+
 #include "velox/type/Type.h"
 
 namespace facebook::velox::functions {
 
+namespace {
+bool isSchemeChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '+' || c == '.' ||
+      c == '-';
+}
+
+// Matches 'authority' without user info against the host and port part of
+// kAuthorityRegex in matchAuthorityAndPath().
+bool matchHostAndPort(std::string_view authority, std::string_view& host) {
+  size_t hostEnd;
+  if (!authority.empty() && authority[0] == '[') {
+    // IP-literal.
+    hostEnd = authority.find(']');
+    if (hostEnd == std::string_view::npos) {
+      return false;
+    }
+    ++hostEnd;
+  } else {
+    hostEnd = std::min(authority.find_first_of("[:"), authority.size());
+  }
+  const auto port = authority.substr(hostEnd);
+  if (!port.empty()) {
+    if (port[0] != ':') {
+      return false;
+    }
+    for (auto i = 1; i < port.size(); ++i) {
+      if (!std::isdigit(static_cast<unsigned char>(port[i]))) {
+        return false;
+      }
+    }
+  }
+  host = authority.substr(0, hostEnd);
+  return true;
+}
+} // namespace
+
+bool extractHost(std::string_view url, std::string_view& host) {
+  // Scheme.
+  const auto colon = url.find(':');
+  if (colon == std::string_view::npos || colon == 0 ||
+      !std::isalpha(static_cast<unsigned char>(url[0]))) {
+    return false;
+  }
+  for (auto i = 1; i < colon; ++i) {
+    if (!isSchemeChar(url[i])) {
+      return false;
+    }
+  }
+
+  // Authority and path end at the query or fragment.
+  auto authorityAndPath = url.substr(colon + 1);
+  authorityAndPath =
+      authorityAndPath.substr(0, authorityAndPath.find_first_of("?#"));
+  if (authorityAndPath.substr(0, 2) != "//") {
+    return false;
+  }
+  auto authority = authorityAndPath.substr(2);
+  authority = authority.substr(0, authority.find('/'));
+
+  // User info ends at the first '@'. If the rest is not a host and port, the
+  // whole authority is matched as one.
+  const auto at = authority.find('@');
+  if (at != std::string_view::npos &&
+      matchHostAndPort(authority.substr(at + 1), host)) {
+    return true;
+  }
+  return matchHostAndPort(authority, host);
+}
+
 bool matchAuthorityAndPath(
     const boost::cmatch& urlMatch,
     boost::cmatch& authAndPathMatch,
@@ -130,6 +130,12 @@ bool matchAuthorityAndPath(
     boost::cmatch& authorityMatch,
     bool& hasAuthority);
 
+/// Sets 'host' to the host in the authority of 'url' and returns true. Returns
+/// false if 'url' has no authority or the authority is invalid. Gives the same
+/// result as parse() followed by matchAuthorityAndPath() without running the
+/// regular expressions.
+bool extractHost(std::string_view url, std::string_view& host);
+
 template <typename T>
 struct UrlExtractProtocolFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
@@ -189,19 +195,9 @@ struct UrlExtractHostFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-      return true;
-    }
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
-        hasAuthority) {
-      result.setNoCopy(submatch(authorityMatch, 3));
+    std::string_view host;
+    if (extractHost(std::string_view(url.data(), url.size()), host)) {
+      result.setNoCopy(StringView(host.data(), host.size()));
     } else {
       result.setEmpty();
     }
@@ -16,6 +16,7 @@
 #include "velox/functions/prestosql/Utf8Utils.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
+#include "velox/functions/lib/string/StringCore.h"
 
 namespace facebook::velox::functions {
 
@@ -102,4 +103,20 @@ int32_t tryGetCharLength(const char* input, int64_t size) {
 
   VELOX_UNREACHABLE();
 }
+
+bool isValidUtf8(const char* input, int64_t size) {
+  int64_t pos = 0;
+  while (pos < size) {
+    if ((input[pos] & 0x80) == 0) {
+      pos += stringCore::asciiPrefixLength(input + pos, size - pos);
+      continue;
+    }
+    auto charLength = tryGetCharLength(input + pos, size - pos);
+    if (charLength < 0) {
+      return false;
+    }
+    pos += charLength;
+  }
+  return true;
+}
 } // namespace facebook::velox::functions
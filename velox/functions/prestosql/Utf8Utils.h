@@ -35,4 +35,9 @@ namespace facebook::velox::functions {
 /// https://github.com/airlift/slice/blob/master/src/main/java/io/airlift/slice/SliceUtf8.java
 int32_t tryGetCharLength(const char* input, int64_t size);
 
+/// Returns true if the 'size' bytes at 'input' are valid UTF-8. Runs of ASCII
+/// are checked a SIMD batch at a time and the other code points with
+/// tryGetCharLength.
+bool isValidUtf8(const char* input, int64_t size);
+
 } // namespace facebook::velox::functions
@@ -34,14 +34,29 @@ namespace facebook::velox::aggregate::prestosql {
 
 namespace {
 
+// Holds either a sparse or a dense HLL. Only one of the two is alive at a
+// time so that the fixed width part of the accumulator of each group, which
+// dominates memory with many small groups, stays small.
 struct HllAccumulator {
   explicit HllAccumulator(HashStringAllocator* allocator)
-      : sparseHll_{allocator}, denseHll_{allocator} {}
+      : allocator_{allocator} {
+    new (&sparseHll_) SparseHll(allocator);
+  }
+
+  ~HllAccumulator() {
+    if (isSparse_) {
+      sparseHll_.~SparseHll();
+    } else {
+      denseHll_.~DenseHll();
+    }
+  }
 
   void setIndexBitLength(int8_t indexBitLength) {
     indexBitLength_ = indexBitLength;
-    sparseHll_.setSoftMemoryLimit(
-        DenseHll::estimateInMemorySize(indexBitLength_));
+    if (isSparse_) {
+      sparseHll_.setSoftMemoryLimit(
+          DenseHll::estimateInMemorySize(indexBitLength_));
+    }
   }
 
   void append(uint64_t hash) {
@@ -58,7 +73,7 @@ struct HllAccumulator {
     return isSparse_ ? sparseHll_.cardinality() : denseHll_.cardinality();
   }
 
-  void mergeWith(StringView serialized, HashStringAllocator* allocator) {
+  void mergeWith(StringView serialized) {
     auto input = serialized.data();
     if (SparseHll::canDeserialize(input)) {
       if (isSparse_) {
@@ -70,8 +85,7 @@ struct HllAccumulator {
           toDense();
         }
       } else {
-        SparseHll other{input, allocator};
-        other.toDense(denseHll_);
+        SparseHll::toDense(input, denseHll_);
       }
     } else if (DenseHll::canDeserialize(input)) {
       if (isSparse_) {
@@ -97,16 +111,21 @@ struct HllAccumulator {
 
  private:
   void toDense() {
-    isSparse_ = false;
-    denseHll_.initialize(indexBitLength_);
-    sparseHll_.toDense(denseHll_);
+    DenseHll denseHll{indexBitLength_, allocator_};
+    sparseHll_.toDense(denseHll);
     sparseHll_.reset();
+    sparseHll_.~SparseHll();
+    new (&denseHll_) DenseHll(std::move(denseHll));
+    isSparse_ = false;
   }
 
+  HashStringAllocator* const allocator_;
   bool isSparse_{true};
   int8_t indexBitLength_{-1};
-  SparseHll sparseHll_;
-  DenseHll denseHll_;
+  union {
+    SparseHll sparseHll_;
+    DenseHll denseHll_;
+  };
 };
 
 template <typename T>
@@ -247,7 +266,7 @@ class ApproxDistinctAggregate : public exec::Aggregate {
       auto serialized = decodedHll_.valueAt<StringView>(row);
 
       auto accumulator = value<HllAccumulator>(group);
-      accumulator->mergeWith(serialized, allocator_);
+      accumulator->mergeWith(serialized);
     });
   }
 
@@ -295,7 +314,7 @@ class ApproxDistinctAggregate : public exec::Aggregate {
       auto serialized = decodedHll_.valueAt<StringView>(row);
 
       auto accumulator = value<HllAccumulator>(group);
-      accumulator->mergeWith(serialized, allocator_);
+      accumulator->mergeWith(serialized);
     });
   }
 
@@ -98,12 +98,12 @@ class AverageAggregate : public exec::Aggregate {
     if (decodedRaw_.isConstantMapping()) {
       if (!decodedRaw_.isNullAt(0)) {
         auto value = decodedRaw_.valueAt<TInput>(0);
-        rows.applyToSelected([&](vector_size_t i) {
+        applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
           updateNonNullValue(groups[i], TAccumulator(value));
         });
       }
     } else if (decodedRaw_.mayHaveNulls()) {
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         if (decodedRaw_.isNullAt(i)) {
           return;
         }
@@ -112,11 +112,11 @@ class AverageAggregate : public exec::Aggregate {
       });
     } else if (!exec::Aggregate::numNulls_ && decodedRaw_.isIdentityMapping()) {
       auto data = decodedRaw_.data<TInput>();
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         updateNonNullValue<false>(groups[i], data[i]);
       });
     } else {
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         updateNonNullValue(
             groups[i], TAccumulator(decodedRaw_.valueAt<TInput>(i)));
       });
@@ -234,12 +234,12 @@ class AverageAggregate : public exec::Aggregate {
         }
         auto count = baseCountVector->valueAt(decodedIndex);
         auto sum = baseSumVector->valueAt(decodedIndex);
-        rows.applyToSelected([&](vector_size_t i) {
+        applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
           updateNonNullValue(groups[i], count, sum);
         });
       }
     } else if (decodedPartial_.mayHaveNulls()) {
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         if (decodedPartial_.isNullAt(i)) {
           return;
         }
@@ -255,7 +255,7 @@ class AverageAggregate : public exec::Aggregate {
             baseSumVector->valueAt(decodedIndex));
       });
     } else {
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         auto decodedIndex = decodedPartial_.index(i);
         if constexpr (checkNullFields) {
           VELOX_USER_CHECK(
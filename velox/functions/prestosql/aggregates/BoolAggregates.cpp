@@ -72,6 +72,41 @@ class BoolAndOrAggregate : public SimpleNumericAggregate<bool, bool, bool> {
   }
 
  protected:
+  // Updates 'group' from a flat 'arg' a word of the value bits at a time.
+  // bool_and looks for a selected non-null false and bool_or for a true.
+  // Returns false if 'arg' is not flat.
+  template <bool isAnd>
+  bool updateOneGroupFlat(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& arg) {
+    if (arg->encoding() != VectorEncoding::Simple::FLAT) {
+      return false;
+    }
+    const auto* flat = arg->asUnchecked<FlatVector<bool>>();
+    const auto* selected = rows.asRange().bits();
+    const auto* values = flat->rawValues<uint64_t>();
+    const auto* nulls = flat->rawNulls();
+    bool hasValue = false;
+    bool found = false;
+    bits::forEachWord(
+        rows.begin(), rows.end(), [&](int32_t index, uint64_t mask) {
+          auto active = selected[index] & mask;
+          if (nulls) {
+            active &= nulls[index];
+          }
+          hasValue |= active != 0;
+          const auto word = isAnd ? ~values[index] : values[index];
+          found |= (word & active) != 0;
+        });
+    if (hasValue) {
+      clearNull(group);
+      auto& result = *value<bool>(group);
+      result = isAnd ? result && !found : result || found;
+    }
+    return true;
+  }
+
   const bool initialValue_;
 };
 
@@ -105,6 +140,9 @@ class BoolAndAggregate final : public BoolAndOrAggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if (updateOneGroupFlat<true>(group, rows, args[0])) {
+      return;
+    }
     BaseAggregate::updateOneGroup(
         group,
         rows,
@@ -156,6 +194,9 @@ class BoolOrAggregate final : public BoolAndOrAggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if (updateOneGroupFlat<false>(group, rows, args[0])) {
+      return;
+    }
     BaseAggregate::updateOneGroup(
         group,
         rows,
@@ -52,27 +52,35 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
     if (args.empty()) {
-      rows.applyToSelected([&](vector_size_t i) { addToGroup(groups[i], 1); });
+      applyToSelectedGroups(
+          groups, rows, [&](vector_size_t i) { addToGroup(groups[i], 1); });
+      return;
+    }
+
+    if (mayPushdown && args[0]->isLazy() &&
+        supportsPushdown(args[0]->typeKind())) {
+      pushdown<CountHook>(groups, rows, args[0]);
       return;
     }
 
     DecodedVector decoded(*args[0], rows);
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
-        rows.applyToSelected(
-            [&](vector_size_t i) { addToGroup(groups[i], 1); });
+        applyToSelectedGroups(
+            groups, rows, [&](vector_size_t i) { addToGroup(groups[i], 1); });
       }
     } else if (decoded.mayHaveNulls()) {
-      rows.applyToSelected([&](vector_size_t i) {
+      applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
         if (decoded.isNullAt(i)) {
           return;
         }
         addToGroup(groups[i], 1);
       });
     } else {
-      rows.applyToSelected([&](vector_size_t i) { addToGroup(groups[i], 1); });
+      applyToSelectedGroups(
+          groups, rows, [&](vector_size_t i) { addToGroup(groups[i], 1); });
     }
   }
 
@@ -82,7 +90,7 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
     decodedIntermediate_.decode(*args[0], rows);
-    rows.applyToSelected([&](vector_size_t i) {
+    applyToSelectedGroups(groups, rows, [&](vector_size_t i) {
       addToGroup(groups[i], decodedIntermediate_.valueAt<int64_t>(i));
     });
   }
@@ -103,12 +111,15 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
         addToGroup(group, rows.countSelected());
       }
     } else if (decoded.mayHaveNulls()) {
+      // Counts the selected non-null rows 64 at a time.
+      const auto* nulls = decoded.nulls();
+      const auto* selected = rows.asRange().bits();
       int64_t nonNullCount = 0;
-      rows.applyToSelected([&](vector_size_t i) {
-        if (!decoded.isNullAt(i)) {
-          ++nonNullCount;
-        }
-      });
+      bits::forEachWord(
+          rows.begin(), rows.end(), [&](int32_t index, uint64_t mask) {
+            nonNullCount +=
+                __builtin_popcountll(selected[index] & nulls[index] & mask);
+          });
       addToGroup(group, nonNullCount);
     } else {
       addToGroup(group, rows.countSelected());
@@ -139,6 +150,25 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
   }
 
  private:
+  // Returns true if column readers can feed values of 'kind' to a ValueHook.
+  // Complex types and timestamps are always materialized.
+  static bool supportsPushdown(TypeKind kind) {
+    switch (kind) {
+      case TypeKind::BOOLEAN:
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::REAL:
+      case TypeKind::DOUBLE:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        return true;
+      default:
+        return false;
+    }
+  }
+
   inline void addToGroup(char* group, int64_t count) {
     *value<int64_t>(group) += count;
   }
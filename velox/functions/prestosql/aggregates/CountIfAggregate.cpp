@@ -73,6 +73,15 @@ class CountIfAggregate : public exec::Aggregate {
         rows.applyToSelected(
             [&](vector_size_t i) { addToGroup(groups[i], 1); });
       }
+    } else if (decoded.isIdentityMapping()) {
+      // Visits only the selected non-null true rows, a word of the value bits
+      // at a time.
+      forEachTrueWord(rows, decoded, [&](int32_t index, uint64_t word) {
+        while (word) {
+          addToGroup(groups[index * 64 + __builtin_ctzll(word)], 1);
+          word &= word - 1;
+        }
+      });
     } else if (decoded.mayHaveNulls()) {
       rows.applyToSelected([&](vector_size_t i) {
         if (decoded.isNullAt(i)) {
@@ -130,7 +139,11 @@ class CountIfAggregate : public exec::Aggregate {
     }
 
     int64_t numTrue = 0;
-    if (decoded.mayHaveNulls()) {
+    if (decoded.isIdentityMapping()) {
+      forEachTrueWord(rows, decoded, [&](int32_t /*index*/, uint64_t word) {
+        numTrue += __builtin_popcountll(word);
+      });
+    } else if (decoded.mayHaveNulls()) {
       rows.applyToSelected([&](vector_size_t i) {
         if (decoded.isNullAt(i)) {
           return;
@@ -163,6 +176,28 @@ class CountIfAggregate : public exec::Aggregate {
   }
 
  private:
+  // Calls 'func' with the index and the bits of the selected rows of a flat
+  // input that are true and not null, a word at a time.
+  template <typename Func>
+  static void forEachTrueWord(
+      const SelectivityVector& rows,
+      DecodedVector& decoded,
+      Func func) {
+    const auto* selected = rows.asRange().bits();
+    const auto* values = decoded.data<uint64_t>();
+    const auto* nulls = decoded.nulls();
+    bits::forEachWord(
+        rows.begin(), rows.end(), [&](int32_t index, uint64_t mask) {
+          auto word = selected[index] & values[index] & mask;
+          if (nulls) {
+            word &= nulls[index];
+          }
+          if (word) {
+            func(index, word);
+          }
+        });
+  }
+
   inline void addToGroup(char* group, int64_t numTrue) {
     *value<int64_t>(group) += numTrue;
   }
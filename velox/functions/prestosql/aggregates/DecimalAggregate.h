@@ -150,10 +150,13 @@ class DecimalAggregate : public exec::Aggregate {
     } else if (!exec::Aggregate::numNulls_ && decodedRaw_.isIdentityMapping()) {
       const TInputType* data = decodedRaw_.data<TInputType>();
       LongDecimalWithOverflowState accumulator;
-      rows.applyToSelected([&](vector_size_t i) {
-        accumulator.overflow += DecimalUtil::addWithOverflow(
-            accumulator.sum, data[i], accumulator.sum);
-      });
+      if (!sumWithoutOverflow(rows, data, accumulator.sum)) {
+        accumulator.sum = 0;
+        rows.applyToSelected([&](vector_size_t i) {
+          accumulator.overflow += DecimalUtil::addWithOverflow(
+              accumulator.sum, data[i], accumulator.sum);
+        });
+      }
       accumulator.count = rows.countSelected();
       char rawData[LongDecimalWithOverflowState::serializedSize()];
       StringView serialized(
@@ -330,6 +333,38 @@ class DecimalAggregate : public exec::Aggregate {
   }
 
  private:
+  // Sums 'rows' of 'data' into 'sum' without a per row overflow check. Short
+  // decimals are summed as int128_t, which can't overflow for a vector of
+  // values. Long decimals are summed as separate signed upper and unsigned
+  // lower halves, which can't overflow either, and combined at the end.
+  // Returns false if the sum of long decimals doesn't fit in int128_t.
+  static bool sumWithoutOverflow(
+      const SelectivityVector& rows,
+      const TInputType* data,
+      int128_t& sum) {
+    if constexpr (std::is_same_v<TInputType, int128_t>) {
+      int128_t upperSum = 0;
+      __uint128_t lowerSum = 0;
+      rows.applyToSelected([&](vector_size_t i) {
+        upperSum += static_cast<int64_t>(HugeInt::upper(data[i]));
+        lowerSum += HugeInt::lower(data[i]);
+      });
+      upperSum += static_cast<int128_t>(lowerSum >> 64);
+      if (upperSum < std::numeric_limits<int64_t>::min() ||
+          upperSum > std::numeric_limits<int64_t>::max()) {
+        return false;
+      }
+      sum = HugeInt::build(
+          static_cast<uint64_t>(upperSum), static_cast<uint64_t>(lowerSum));
+      return true;
+    } else {
+      int128_t total = 0;
+      rows.applyToSelected([&](vector_size_t i) { total += data[i]; });
+      sum = total;
+      return true;
+    }
+  }
+
   inline LongDecimalWithOverflowState* decimalAccumulator(char* group) {
     return exec::Aggregate::value<LongDecimalWithOverflowState>(group);
   }
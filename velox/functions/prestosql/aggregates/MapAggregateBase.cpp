@@ -50,10 +50,8 @@ void MapAggregateBase::extractValues(
     if (mapSize) {
       ValueListReader keysReader(accumulator->keys);
       ValueListReader valuesReader(accumulator->values);
-      for (auto index = 0; index < mapSize; ++index) {
-        keysReader.next(*mapKeys, offset + index);
-        valuesReader.next(*mapValues, offset + index);
-      }
+      keysReader.readAll(*mapKeys, offset);
+      valuesReader.readAll(*mapValues, offset);
       mapVector->setOffsetAndSize(i, offset, mapSize);
       offset += mapSize;
     } else {
@@ -54,6 +54,37 @@ struct MinMaxTrait<Date> {
   }
 };
 
+// Reducer for SimpleNumericAggregate::reduceOneGroup(). The comparisons are
+// the same as in the row by row updates of MinAggregate and MaxAggregate.
+template <typename T, bool isMin>
+struct MinMaxReducer {
+  static constexpr bool kSimd = std::is_same_v<T, int8_t> ||
+      std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t> ||
+      std::is_same_v<T, int64_t> || std::is_same_v<T, float> ||
+      std::is_same_v<T, double>;
+
+  static void add(T& result, T value) {
+    if constexpr (isMin) {
+      result = result < value ? result : value;
+    } else if (result < value) {
+      result = value;
+    }
+  }
+
+  static void combine(T& result, T value) {
+    add(result, value);
+  }
+
+  template <typename Batch>
+  static Batch addBatch(Batch result, Batch values) {
+    if constexpr (isMin) {
+      return xsimd::select(result < values, result, values);
+    } else {
+      return xsimd::select(result < values, values, result);
+    }
+  }
+};
+
 template <typename T>
 class MinMaxAggregate : public SimpleNumericAggregate<T, T, T> {
   using BaseAggregate = SimpleNumericAggregate<T, T, T>;
@@ -158,18 +189,27 @@ class MaxAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::updateOneGroup(
-        group,
-        rows,
-        args[0],
-        [](T& result, T value) {
-          if (result < value) {
-            result = value;
-          }
-        },
-        [](T& result, T value, int /* unused */) { result = value; },
-        mayPushdown,
-        kInitialValue_);
+    if constexpr (std::is_same_v<T, bool>) {
+      BaseAggregate::updateOneGroup(
+          group,
+          rows,
+          args[0],
+          [](T& result, T value) {
+            if (result < value) {
+              result = value;
+            }
+          },
+          [](T& result, T value, int /* unused */) { result = value; },
+          mayPushdown,
+          kInitialValue_);
+    } else {
+      BaseAggregate::template reduceOneGroup<MinMaxReducer<T, false>>(
+          group,
+          rows,
+          args[0],
+          [](T& result, T value, int /* unused */) { result = value; },
+          kInitialValue_);
+    }
   }
 
   void addSingleGroupIntermediateResults(
@@ -238,14 +278,23 @@ class MinAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::updateOneGroup(
-        group,
-        rows,
-        args[0],
-        [](T& result, T value) { result = result < value ? result : value; },
-        [](T& result, T value, int /* unused */) { result = value; },
-        mayPushdown,
-        kInitialValue_);
+    if constexpr (std::is_same_v<T, bool>) {
+      BaseAggregate::updateOneGroup(
+          group,
+          rows,
+          args[0],
+          [](T& result, T value) { result = result < value ? result : value; },
+          [](T& result, T value, int /* unused */) { result = value; },
+          mayPushdown,
+          kInitialValue_);
+    } else {
+      BaseAggregate::template reduceOneGroup<MinMaxReducer<T, true>>(
+          group,
+          rows,
+          args[0],
+          [](T& result, T value, int /* unused */) { result = value; },
+          kInitialValue_);
+    }
   }
 
   void addSingleGroupIntermediateResults(
@@ -90,13 +90,13 @@ class SumAggregate
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::template updateOneGroup<TAccumulator>(
+    BaseAggregate::template reduceOneGroup<
+        Reducer<TAccumulator, TInput>,
+        TAccumulator>(
         group,
         rows,
         args[0],
-        &updateSingleValue<TAccumulator>,
         &updateDuplicateValues<TAccumulator>,
-        mayPushdown,
         TAccumulator(0));
   }
 
@@ -105,13 +105,14 @@ class SumAggregate
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    BaseAggregate::template updateOneGroup<TAccumulator, TAccumulator>(
+    BaseAggregate::template reduceOneGroup<
+        Reducer<TAccumulator, TAccumulator>,
+        TAccumulator,
+        TAccumulator>(
         group,
         rows,
         args[0],
-        &updateSingleValue<TAccumulator>,
         &updateDuplicateValues<TAccumulator>,
-        mayPushdown,
         TAccumulator(0));
   }
 
@@ -158,6 +159,32 @@ class SumAggregate
     }
   }
 
+  // Reducer of reduceOneGroup(). The sum of up to 64 integers narrower than
+  // the accumulator can't overflow, so these are added without a check.
+  template <typename TData, typename TValue>
+  struct Reducer {
+    static constexpr bool kSimd =
+        std::is_same_v<TData, double> && std::is_same_v<TValue, double>;
+
+    static void add(TData& result, TValue value) {
+      if constexpr (
+          std::is_floating_point_v<TData> || sizeof(TValue) < sizeof(TData)) {
+        result += value;
+      } else {
+        result = functions::checkedPlus<TData>(result, value);
+      }
+    }
+
+    static void combine(TData& result, TData value) {
+      updateSingleValue<TData>(result, value);
+    }
+
+    template <typename Batch>
+    static Batch addBatch(Batch result, Batch values) {
+      return result + values;
+    }
+  };
+
   template <typename TData>
   static void updateDuplicateValues(TData& result, TData value, int n) {
     if constexpr (
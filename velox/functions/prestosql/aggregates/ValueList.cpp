@@ -15,6 +15,7 @@
  */
 #include "velox/functions/prestosql/aggregates/ValueList.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::aggregate {
 void ValueList::prepareAppend(HashStringAllocator* allocator) {
@@ -89,13 +90,47 @@ void ValueList::appendRange(
     vector_size_t offset,
     vector_size_t size,
     HashStringAllocator* allocator) {
-  for (auto index = offset; index < offset + size; ++index) {
+  if (size == 0) {
+    return;
+  }
+  // Appends the null flags first and then writes all non-null values to
+  // 'data' in one go instead of starting a new write for each value.
+  vector_size_t numNonNulls = 0;
+  const auto end = offset + size;
+  for (auto index = offset; index < end; ++index) {
+    prepareAppend(allocator);
     if (vector->isNullAt(index)) {
-      appendNull(allocator);
+      lastNulls_ |= 1UL << (size_ % 64);
     } else {
-      appendNonNull(*vector, index, allocator);
+      ++numNonNulls;
+    }
+    ++size_;
+  }
+  if (numNonNulls == 0) {
+    return;
+  }
+
+  ByteStream stream(allocator);
+  allocator->extendWrite(dataCurrent_, stream);
+  if (numNonNulls == size && vector->isFlatEncoding() &&
+      vector->type()->isFixedWidth() &&
+      vector->typeKind() != TypeKind::BOOLEAN) {
+    // Flat fixed width values are serialized as their bytes in memory.
+    const auto valueSize = vector->type()->cppSizeInBytes();
+    stream.appendStringPiece(folly::StringPiece(
+        static_cast<const char*>(vector->valuesAsVoid()) + offset * valueSize,
+        size * valueSize));
+  } else {
+    const auto& serde = exec::ContainerRowSerde::instance();
+    for (auto index = offset; index < end; ++index) {
+      if (!vector->isNullAt(index)) {
+        serde.serialize(*vector, index, stream);
+      }
     }
   }
+  totalBytes_ += stream.size();
+  auto reserve = std::max<int32_t>(1024, std::min<int64_t>(128, totalBytes_));
+  dataCurrent_ = allocator->finishWrite(stream, reserve);
 }
 
 ValueListReader::ValueListReader(ValueList& values)
@@ -106,12 +141,16 @@ ValueListReader::ValueListReader(ValueList& values)
   HashStringAllocator::prepareRead(values.nullsBegin(), nullsStream_);
 }
 
-bool ValueListReader::next(BaseVector& output, vector_size_t outputIndex) {
+void ValueListReader::loadNulls() {
   if (pos_ == lastNullsStart_) {
     nulls_ = lastNulls_;
   } else if (pos_ % 64 == 0) {
     nulls_ = nullsStream_.read<uint64_t>();
   }
+}
+
+bool ValueListReader::next(BaseVector& output, vector_size_t outputIndex) {
+  loadNulls();
 
   if (nulls_ & (1UL << (pos_ % 64))) {
     output.setNull(outputIndex, true);
@@ -123,4 +162,56 @@ bool ValueListReader::next(BaseVector& output, vector_size_t outputIndex) {
   pos_++;
   return pos_ < size_;
 }
+
+template <TypeKind Kind>
+void ValueListReader::readAllFixedWidth(
+    BaseVector& output,
+    vector_size_t outputOffset) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  if constexpr (TypeTraits<Kind>::isFixedWidth && Kind != TypeKind::BOOLEAN) {
+    auto* rawValues = output.asUnchecked<FlatVector<T>>()->mutableRawValues();
+    // Output index of the value at 'pos_' is 'base + pos_'.
+    const auto base = outputOffset - pos_;
+    while (pos_ < size_) {
+      loadNulls();
+      // Reads the run of non-null values up to the next null or the end of
+      // the nulls word at once.
+      const auto wordEnd =
+          std::min<vector_size_t>(size_, pos_ - pos_ % 64 + 64);
+      auto runEnd = pos_;
+      while (runEnd < wordEnd && !(nulls_ & (1UL << (runEnd % 64)))) {
+        ++runEnd;
+      }
+      if (runEnd == pos_) {
+        output.setNull(base + pos_, true);
+        ++pos_;
+        continue;
+      }
+      dataStream_.readBytes(
+          rawValues + base + pos_, (runEnd - pos_) * sizeof(T));
+      if (output.rawNulls()) {
+        bits::fillBits(
+            output.mutableRawNulls(),
+            base + pos_,
+            base + runEnd,
+            bits::kNotNull);
+      }
+      pos_ = runEnd;
+    }
+  } else {
+    VELOX_UNREACHABLE();
+  }
+}
+
+void ValueListReader::readAll(BaseVector& output, vector_size_t outputOffset) {
+  if (output.isFlatEncoding() && output.type()->isFixedWidth() &&
+      output.typeKind() != TypeKind::BOOLEAN) {
+    VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        readAllFixedWidth, output.typeKind(), output, outputOffset);
+    return;
+  }
+  for (auto i = outputOffset; pos_ < size_; ++i) {
+    next(output, i);
+  }
+}
 } // namespace facebook::velox::aggregate
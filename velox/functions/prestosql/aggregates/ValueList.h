@@ -33,6 +33,9 @@ class ValueList {
       vector_size_t index,
       HashStringAllocator* allocator);
 
+  // Appends the values at 'offset' to 'offset + size' of 'vector'. The
+  // non-null values are written to 'data' together, as one copy if 'vector'
+  // is flat and fixed width without nulls.
   void appendRange(
       const VectorPtr& vector,
       vector_size_t offset,
@@ -109,7 +112,19 @@ class ValueListReader {
 
   bool next(BaseVector& output, vector_size_t outputIndex);
 
+  // Reads all remaining values into consecutive positions of 'output'
+  // starting at 'outputOffset'. Runs of non-null fixed width values are
+  // copied with a single read into a flat 'output'.
+  void readAll(BaseVector& output, vector_size_t outputOffset);
+
  private:
+  // Loads the null flags word of the value at 'pos_' into 'nulls_' if 'pos_'
+  // is at the start of a word.
+  void loadNulls();
+
+  template <TypeKind Kind>
+  void readAllFixedWidth(BaseVector& output, vector_size_t outputOffset);
+
   const vector_size_t size_;
   const vector_size_t lastNullsStart_;
   const uint64_t lastNulls_;
@@ -84,6 +84,30 @@ TEST_F(CountIfAggregationTest, oneAggregateMultipleGroups) {
       "SELECT c0, sum(if(c1, 1, 0)) FROM tmp GROUP BY c0");
 }
 
+TEST_F(CountIfAggregationTest, multipleGroupsWithNulls) {
+  // Flat input spanning several words of the value bits, with and without
+  // nulls.
+  auto vectors = {
+      makeRowVector({
+          makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+          makeFlatVector<bool>(1'000, [](auto row) { return row % 5 == 0; }),
+      }),
+      makeRowVector({
+          makeFlatVector<int32_t>(1'100, [](auto row) { return row % 11; }),
+          makeFlatVector<bool>(
+              1'100, [](auto row) { return row % 3 == 0; }, nullEvery(7)),
+      }),
+  };
+
+  createDuckDbTable(vectors);
+
+  testAggregations(
+      vectors,
+      {"c0"},
+      {"count_if(c1)"},
+      "SELECT c0, sum(if(c1, 1, 0)) FROM tmp GROUP BY c0");
+}
+
 TEST_F(CountIfAggregationTest, twoAggregatesSingleGroup) {
   auto vectors = makeVectors(rowType_, 10, 100);
   createDuckDbTable(vectors);
@@ -369,6 +369,31 @@ TEST_F(SumTest, sumDecimalOverflow) {
   VELOX_ASSERT_THROW(
       decimalSumOverflow(longDecimalInput, longDecimalOutput),
       "Value '-100000000000000000000000000000000000000' is not in the range of Decimal Type");
+
+  // The running sum overflows but the total doesn't.
+  longDecimalInput.clear();
+  longDecimalOutput.clear();
+  for (int i = 0; i < 1'000; ++i) {
+    longDecimalInput.push_back(DecimalUtil::kLongDecimalMax);
+  }
+  for (int i = 0; i < 1'000; ++i) {
+    longDecimalInput.push_back(DecimalUtil::kLongDecimalMin);
+  }
+  longDecimalInput.push_back(7);
+  longDecimalOutput.push_back(7);
+  decimalSumOverflow(longDecimalInput, longDecimalOutput);
+
+  // The lower 64 bits carry into the upper 64 bits.
+  longDecimalInput.clear();
+  longDecimalOutput.clear();
+  for (int i = 0; i < 3; ++i) {
+    longDecimalInput.push_back(
+        HugeInt::build(0, std::numeric_limits<uint64_t>::max()));
+    longDecimalInput.push_back(-1);
+  }
+  longDecimalOutput.push_back(
+      HugeInt::build(2, std::numeric_limits<uint64_t>::max() - 5));
+  decimalSumOverflow(longDecimalInput, longDecimalOutput);
 }
 
 TEST_F(SumTest, sumWithMask) {
@@ -518,6 +543,39 @@ TEST_F(SumTest, nulls) {
       "SELECT c0, sum(c1) as sum_c1 FROM tmp GROUP BY 1");
 }
 
+// Global aggregation over flat inputs with and without nulls and over
+// dictionaries, with the row counts not a multiple of 64.
+TEST_F(SumTest, globalNullsAndEncodings) {
+  vector_size_t size = 1'000 + 13;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+         makeFlatVector<int32_t>(
+             size, [](auto row) { return row * 7 - 3'000; }, nullEvery(5)),
+         makeFlatVector<int64_t>(size, [](auto row) { return row * 1'001; }),
+         makeFlatVector<double>(
+             size, [](auto row) { return row * 0.25; }, nullEvery(7)),
+         makeFlatVector<double>(size, [](auto row) { return row * 0.5; })}));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "sum(c1)", "sum(c2)", "sum(c3)", "sum(c4)"};
+  testAggregations(
+      vectors,
+      {},
+      aggregates,
+      "SELECT sum(c1), sum(c2), sum(c3), sum(c4) FROM tmp");
+
+  // The filter wraps the inputs in a dictionary.
+  testAggregations(
+      [&](auto& builder) { builder.values(vectors).filter("c0 % 3 <> 0"); },
+      {},
+      aggregates,
+      "SELECT sum(c1), sum(c2), sum(c3), sum(c4) FROM tmp WHERE c0 % 3 <> 0");
+}
+
 template <typename Type>
 struct SumRow {
   char nulls;
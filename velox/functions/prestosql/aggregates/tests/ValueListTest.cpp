@@ -39,6 +39,16 @@ class ValueListTest : public functions::test::FunctionBaseTest {
     return result;
   }
 
+  VectorPtr readAll(
+      aggregate::ValueList& values,
+      const TypePtr& type,
+      vector_size_t size) {
+    aggregate::ValueListReader reader(values);
+    auto result = BaseVector::create(type, size, pool());
+    reader.readAll(*result, 0);
+    return result;
+  }
+
   void testRoundTrip(const VectorPtr& data) {
     auto size = data->size();
 
@@ -54,6 +64,7 @@ class ValueListTest : public functions::test::FunctionBaseTest {
       auto result = read(values, data->type(), size);
 
       assertEqualVectors(data, result);
+      assertEqualVectors(data, readAll(values, data->type(), size));
     }
 
     // Use ValueList::appendRange.
@@ -65,6 +76,18 @@ class ValueListTest : public functions::test::FunctionBaseTest {
       auto result = read(values, data->type(), size);
 
       assertEqualVectors(data, result);
+      assertEqualVectors(data, readAll(values, data->type(), size));
+    }
+
+    // Use ValueList::appendRange for 2 parts.
+    {
+      aggregate::ValueList values;
+      values.appendRange(data, 0, size / 3, allocator());
+      values.appendRange(data, size / 3, size - size / 3, allocator());
+
+      ASSERT_EQ(size, values.size());
+      assertEqualVectors(data, read(values, data->type(), size));
+      assertEqualVectors(data, readAll(values, data->type(), size));
     }
   }
 
@@ -95,6 +95,27 @@ class ArrayContainsBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  // Arrays of a few hundred elements that mostly do not contain the key, so
+  // that the search scans whole arrays.
+  void runIntegerLongArrays(const std::string& functionName) {
+    folly::BenchmarkSuspender suspender;
+    vector_size_t size = 1'000;
+    auto arrayVector = vectorMaker_.arrayVector<int32_t>(
+        size,
+        [](auto row) { return 100 + row % 300; },
+        [](auto row) { return row % 397; });
+
+    auto elementVector =
+        BaseVector::createConstant(INTEGER(), 390, size, execCtx_.pool());
+
+    auto rowVector = vectorMaker_.rowVector({arrayVector, elementVector});
+    auto exprSet = compileExpression(
+        fmt::format("{}(c0, c1)", functionName), rowVector->type());
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
   void runVarchar(const std::string& functionName) {
     folly::BenchmarkSuspender suspender;
     vector_size_t size = 1'000;
@@ -144,6 +165,16 @@ BENCHMARK_RELATIVE(vectorFunctionInteger) {
   benchmark.runInteger("contains");
 }
 
+BENCHMARK(vectorSimpleFunctionLongArrays) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runIntegerLongArrays("contains_alt");
+}
+
+BENCHMARK_RELATIVE(vectorFunctionIntegerLongArrays) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runIntegerLongArrays("contains");
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
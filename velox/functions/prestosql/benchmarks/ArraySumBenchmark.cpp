@@ -51,6 +51,22 @@ class ArraySumBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  void runIntegerLongArrays(const std::string& functionName) {
+    folly::BenchmarkSuspender suspender;
+    vector_size_t size = 1'000;
+    auto arrayVector = vectorMaker_.arrayVector<int32_t>(
+        size,
+        [](auto row) { return 500 + row % 1'000; },
+        [](auto row) { return row % 23; });
+
+    auto rowVector = vectorMaker_.rowVector({arrayVector});
+    auto exprSet = compileExpression(
+        fmt::format("{}(c0)", functionName), rowVector->type());
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
   void runIntegerNulls(const std::string& functionName) {
     folly::BenchmarkSuspender suspender;
     vector_size_t size = 10'000;
@@ -88,6 +104,16 @@ BENCHMARK_RELATIVE(VectorFunction) {
   benchmark.runInteger("array_sum");
 }
 
+BENCHMARK(SimpleFunctionLongArrays) {
+  ArraySumBenchmark benchmark;
+  benchmark.runIntegerLongArrays("array_sum_alt");
+}
+
+BENCHMARK_RELATIVE(VectorFunctionLongArrays) {
+  ArraySumBenchmark benchmark;
+  benchmark.runIntegerLongArrays("array_sum");
+}
+
 BENCHMARK(SimpleFunctionNulls) {
   ArraySumBenchmark benchmark;
   benchmark.runIntegerNulls("array_sum_alt");
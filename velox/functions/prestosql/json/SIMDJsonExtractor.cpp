@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/prestosql/json/SIMDJsonExtractor.h"
+
+#include <cstring>
+
+#include "folly/Conv.h"
+#include "folly/String.h"
+#include "velox/functions/prestosql/json/JsonPathTokenizer.h"
+
+namespace facebook::velox::functions {
+
+// static
+std::unique_ptr<SIMDJsonExtractor> SIMDJsonExtractor::create(
+    const std::vector<std::string_view>& paths) {
+  std::vector<std::vector<std::string>> tokens(paths.size());
+  JsonPathTokenizer tokenizer;
+  for (auto i = 0; i < paths.size(); ++i) {
+    // Same as JsonExtractor.
+    const auto path = folly::trimWhitespace(
+        folly::StringPiece(paths[i].data(), paths[i].size()));
+    if (path.empty() || !tokenizer.reset(path)) {
+      return nullptr;
+    }
+    while (tokenizer.hasNext()) {
+      auto token = tokenizer.getNext();
+      if (!token || token.value() == "*") {
+        return nullptr;
+      }
+      tokens[i].push_back(std::move(token.value()));
+    }
+  }
+  return std::unique_ptr<SIMDJsonExtractor>(
+      new SIMDJsonExtractor(std::move(tokens)));
+}
+
+bool SIMDJsonExtractor::parse(std::string_view json) {
+  // The copy is cheap next to the parse and avoids allocating a padded
+  // string per document.
+  paddedJson_.resize(json.size() + simdjson::SIMDJSON_PADDING);
+  std::memcpy(paddedJson_.data(), json.data(), json.size());
+  return parser_.parse(paddedJson_.data(), json.size(), false).get(root_) ==
+      simdjson::SUCCESS;
+}
+
+bool SIMDJsonExtractor::extractScalar(
+    const std::vector<std::string>& path,
+    size_t index) {
+  auto element = root_;
+  for (const auto& token : path) {
+    if (element.is_object()) {
+      if (element.get_object().at_key(token).get(element) !=
+          simdjson::SUCCESS) {
+        return true;
+      }
+    } else if (element.is_array()) {
+      const auto arrayIndex = folly::tryTo<int32_t>(token);
+      if (!arrayIndex.hasValue() || arrayIndex.value() < 0 ||
+          element.get_array().at(arrayIndex.value()).get(element) !=
+              simdjson::SUCCESS) {
+        return true;
+      }
+    } else {
+      return true;
+    }
+  }
+
+  switch (element.type()) {
+    case simdjson::dom::element_type::STRING:
+      values_[index] = element.get_string().value_unsafe();
+      break;
+    case simdjson::dom::element_type::BOOL:
+      values_[index] = element.get_bool().value_unsafe() ? "true" : "false";
+      break;
+    case simdjson::dom::element_type::INT64:
+      numbers_[index] =
+          folly::to<std::string>(element.get_int64().value_unsafe());
+      values_[index] = numbers_[index];
+      break;
+    case simdjson::dom::element_type::DOUBLE:
+      numbers_[index] =
+          folly::to<std::string>(element.get_double().value_unsafe());
+      values_[index] = numbers_[index];
+      break;
+    case simdjson::dom::element_type::UINT64:
+      // Integers beyond int64_t fail to parse with folly.
+      return false;
+    default:
+      // Nulls, arrays and objects are not scalars.
+      break;
+  }
+  return true;
+}
+
+} // namespace facebook::velox::functions
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simdjson.h"
+
+namespace facebook::velox::functions {
+
+/// Extracts the scalar values at a set of JSON paths from JSON documents with
+/// simdjson. The paths are tokenized once and the parser and padded input
+/// buffer are reused across documents, so this is meant to be kept for a
+/// batch of documents. Several paths are extracted from one parse of the
+/// document. The results follow jsonExtractScalar().
+class SIMDJsonExtractor {
+ public:
+  /// Returns an extractor for 'paths' or nullptr if one of them is invalid
+  /// or uses a wildcard, which this doesn't support.
+  static std::unique_ptr<SIMDJsonExtractor> create(
+      const std::vector<std::string_view>& paths);
+
+  /// Parses 'json' and calls 'consumer(i, value)' for each path i that
+  /// references a scalar. 'value' is valid until the next call. Returns
+  /// false without calling 'consumer' if 'json' is not valid or has a value
+  /// that jsonExtractScalar() would not parse. The caller is expected to
+  /// fall back to jsonExtractScalar() in this case.
+  template <typename TConsumer>
+  bool extractScalars(std::string_view json, TConsumer consumer) {
+    if (!parse(json)) {
+      return false;
+    }
+    for (auto i = 0; i < paths_.size(); ++i) {
+      values_[i] = std::nullopt;
+      if (!extractScalar(paths_[i], i)) {
+        return false;
+      }
+    }
+    for (auto i = 0; i < paths_.size(); ++i) {
+      if (values_[i].has_value()) {
+        consumer(i, values_[i].value());
+      }
+    }
+    return true;
+  }
+
+  size_t numPaths() const {
+    return paths_.size();
+  }
+
+ private:
+  explicit SIMDJsonExtractor(std::vector<std::vector<std::string>> paths)
+      : paths_(std::move(paths)),
+        values_(paths_.size()),
+        numbers_(paths_.size()) {}
+
+  bool parse(std::string_view json);
+
+  // Sets 'values_[index]' to the scalar at 'path' if any. Returns false if
+  // the value is a number that jsonExtractScalar() would fail on.
+  bool extractScalar(const std::vector<std::string>& path, size_t index);
+
+  // Tokens of each path.
+  const std::vector<std::vector<std::string>> paths_;
+  simdjson::dom::parser parser_;
+  // Copy of the input with the padding that simdjson requires.
+  std::string paddedJson_;
+  simdjson::dom::element root_;
+  std::vector<std::optional<std::string_view>> values_;
+  // Formatted numbers referenced by 'values_'.
+  std::vector<std::string> numbers_;
+};
+
+} // namespace facebook::velox::functions
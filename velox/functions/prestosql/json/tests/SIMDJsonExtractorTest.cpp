@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/prestosql/json/SIMDJsonExtractor.h"
+
+#include "gtest/gtest.h"
+#include "velox/functions/prestosql/json/JsonExtractor.h"
+
+using namespace facebook::velox::functions;
+
+namespace {
+
+// Returns the values of 'paths' in 'json' or std::nullopt if 'extractor'
+// can't parse 'json'.
+std::optional<std::vector<std::optional<std::string>>> extract(
+    SIMDJsonExtractor& extractor,
+    const std::string& json) {
+  std::vector<std::optional<std::string>> values(extractor.numPaths());
+  if (!extractor.extractScalars(json, [&](size_t i, std::string_view value) {
+        values[i] = std::string(value);
+      })) {
+    return std::nullopt;
+  }
+  return values;
+}
+
+// Checks that the result matches jsonExtractScalar().
+void testSameAsJsonExtractScalar(
+    const std::string& json,
+    const std::string& path) {
+  auto extractor = SIMDJsonExtractor::create({path});
+  ASSERT_NE(extractor, nullptr) << path;
+  auto values = extract(*extractor, json);
+  ASSERT_TRUE(values.has_value()) << json;
+  auto expected = jsonExtractScalar(json, path);
+  ASSERT_EQ(values->at(0).has_value(), expected.hasValue())
+      << json << " " << path;
+  if (expected.hasValue()) {
+    ASSERT_EQ(values->at(0).value(), expected.value()) << json << " " << path;
+  }
+}
+
+} // namespace
+
+TEST(SIMDJsonExtractorTest, scalars) {
+  testSameAsJsonExtractScalar("123", "$");
+  testSameAsJsonExtractScalar("-1", "$");
+  testSameAsJsonExtractScalar("\"abc\"", "$");
+  testSameAsJsonExtractScalar("\"\"", "$");
+  testSameAsJsonExtractScalar("null", "$");
+  testSameAsJsonExtractScalar("true", "$");
+  testSameAsJsonExtractScalar("\"ab\\u0001c\"", "$");
+  testSameAsJsonExtractScalar("[1, 2, 3]", "$");
+  testSameAsJsonExtractScalar("{\"a\": 1}", "$");
+
+  testSameAsJsonExtractScalar("{}", "$");
+  testSameAsJsonExtractScalar("{\"fuu\": {\"bar\": 1}}", "$.fuu");
+  testSameAsJsonExtractScalar("{\"fuu\": 1}", "$.fuu");
+  testSameAsJsonExtractScalar("{\"fuu\": 1}", "$[fuu]");
+  testSameAsJsonExtractScalar("{\"fuu\": 1}", "$[\"fuu\"]");
+  testSameAsJsonExtractScalar(
+      "{\"ab\\\"cd\\\"ef\": 2}", "$[\"ab\\\"cd\\\"ef\"]");
+  testSameAsJsonExtractScalar("{\"fuu\": null}", "$.fuu");
+  testSameAsJsonExtractScalar("{\"fuu\": 1}", "$.bar");
+  testSameAsJsonExtractScalar("{\"fuu\": [\"\\u0001\"]}", "$.fuu[0]");
+  testSameAsJsonExtractScalar("{\"fuu\": 1, \"bar\": \"abc\"}", "$.bar");
+  testSameAsJsonExtractScalar("{\"fuu\": [0.1, 1, 2]}", "$.fuu[0]");
+  testSameAsJsonExtractScalar("{\"fuu\": [1.5e10, 1, 2]}", "$.fuu[0]");
+  testSameAsJsonExtractScalar("{\"fuu\": [0, [100, 101], 2]}", "$.fuu[1]");
+  testSameAsJsonExtractScalar("{\"fuu\": [0, [100, 101], 2]}", "$.fuu[1][1]");
+  testSameAsJsonExtractScalar("{\"fuu\": [0, 1, 2]}", "$.fuu[3]");
+  testSameAsJsonExtractScalar(
+      "{\"fuu\": [0, {\"bar\": {\"key\" : [\"value\"]}}, 2]}",
+      "$.fuu[1].bar.key[0]");
+
+  testSameAsJsonExtractScalar("[0, 1, 2]", "$[0]");
+  testSameAsJsonExtractScalar("[0, 1, 2]", "$.1");
+  testSameAsJsonExtractScalar("[0, 1, 2]", "$[\"1\"]");
+  testSameAsJsonExtractScalar("{\"0\" : 0, \"1\" : 1, \"2\" : 2 }", "$.1");
+  testSameAsJsonExtractScalar("{\"0\" : 0, \"1\" : 1, \"2\" : 2 }", "$[1]");
+  testSameAsJsonExtractScalar(
+      "{\"15day\" : 0, \"30day\" : 1, \"90day\" : 2 }", " $.30day ");
+}
+
+TEST(SIMDJsonExtractorTest, multiplePaths) {
+  auto extractor =
+      SIMDJsonExtractor::create({"$.a", "$.b[1]", "$.c.d", "$.missing"});
+  ASSERT_NE(extractor, nullptr);
+  ASSERT_EQ(extractor->numPaths(), 4);
+
+  using Values = std::vector<std::optional<std::string>>;
+  // The extractor is reused across documents.
+  EXPECT_EQ(
+      extract(
+          *extractor,
+          "{\"a\": 1, \"b\": [true, false], \"c\": {\"d\": \"x\"}}"),
+      (Values{"1", "false", "x", std::nullopt}));
+  EXPECT_EQ(
+      extract(*extractor, "{\"a\": \"long string value\", \"b\": []}"),
+      (Values{"long string value", std::nullopt, std::nullopt, std::nullopt}));
+}
+
+TEST(SIMDJsonExtractorTest, unsupported) {
+  EXPECT_EQ(SIMDJsonExtractor::create({""}), nullptr);
+  EXPECT_EQ(SIMDJsonExtractor::create({"a.b"}), nullptr);
+  EXPECT_EQ(SIMDJsonExtractor::create({"$.a[*].b"}), nullptr);
+  EXPECT_EQ(SIMDJsonExtractor::create({"$.a", "$["}), nullptr);
+
+  // Documents that are left to jsonExtractScalar().
+  auto extractor = SIMDJsonExtractor::create({"$.a"});
+  ASSERT_NE(extractor, nullptr);
+  EXPECT_EQ(extract(*extractor, "{\"a\": 1"), std::nullopt);
+  EXPECT_EQ(extract(*extractor, "{\"a\": 18446744073709551615}"), std::nullopt);
+}
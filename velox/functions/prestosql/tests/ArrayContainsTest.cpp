@@ -26,7 +26,28 @@ using namespace facebook::velox::functions::test;
 
 namespace {
 
-class ArrayContainsTest : public FunctionBaseTest {};
+class ArrayContainsTest : public FunctionBaseTest {
+ protected:
+  // Arrays longer than a SIMD batch with a different search value per row.
+  template <typename T>
+  void testLongArrays() {
+    const vector_size_t size = 100;
+    auto arrayVector = makeArrayVector<T>(
+        size,
+        [](auto row) { return row; },
+        [](auto /*row*/, auto index) { return T(index % 60); });
+    auto searchVector =
+        makeFlatVector<T>(size, [](auto row) { return T(row % 70); });
+
+    auto result = evaluate<SimpleVector<bool>>(
+        "contains(c0, c1)", makeRowVector({arrayVector, searchVector}));
+
+    auto expected = makeFlatVector<bool>(size, [](auto row) {
+      return row % 70 < std::min<vector_size_t>(row, 60);
+    });
+    assertEqualVectors(expected, result);
+  }
+};
 
 TEST_F(ArrayContainsTest, integerNoNulls) {
   auto arrayVector = makeArrayVector<int64_t>(
@@ -59,6 +80,15 @@ TEST_F(ArrayContainsTest, integerNoNulls) {
        std::nullopt});
 }
 
+TEST_F(ArrayContainsTest, longArrays) {
+  testLongArrays<int8_t>();
+  testLongArrays<int16_t>();
+  testLongArrays<int32_t>();
+  testLongArrays<int64_t>();
+  testLongArrays<float>();
+  testLongArrays<double>();
+}
+
 TEST_F(ArrayContainsTest, integerWithNulls) {
   auto arrayVector = makeNullableArrayVector<int64_t>(
       {{1, 2, 3, 4},
@@ -306,6 +306,25 @@ TEST_F(ArrayDistinctTest, nonContiguousRows) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ArrayDistinctTest, smallAndLargeArrays) {
+  // Arrays of up to 16 elements are deduplicated by linear scan, longer ones
+  // with a hash set.
+  auto input = makeArrayVector<int32_t>(
+      40,
+      [](auto row) { return row; },
+      [](auto row, auto index) { return index % (row / 2 + 1); },
+      nullEvery(7));
+  auto expected = makeArrayVector<int32_t>(
+      40,
+      [](auto row) { return std::min(row, row / 2 + 1); },
+      [](auto /*row*/, auto index) { return index; },
+      nullEvery(7));
+
+  auto result = evaluate<ArrayVector>(
+      "array_distinct(c0)", makeRowVector({input}));
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(ArrayDistinctTest, constant) {
   vector_size_t size = 1'000;
   auto data =
@@ -15,6 +15,7 @@
  */
 
 #include <optional>
+#include <unordered_set>
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 #include "velox/vector/tests/TestingDictionaryArrayElementsFunction.h"
 
@@ -136,6 +137,37 @@ TEST_F(ArrayIntersectTest, intArrays) {
   testInt<int64_t>();
 }
 
+TEST_F(ArrayIntersectTest, smallAndLargeArrays) {
+  // Rows with both arrays of up to 16 elements use linear scans, the others
+  // hash sets. Covers both and mixes of the two.
+  const vector_size_t size = 40;
+  auto leftSize = [](auto row) { return row; };
+  auto leftValue = [](auto row, auto index) { return index % (row / 2 + 1); };
+  auto rightSize = [](auto row) { return (row * 7) % 40; };
+  auto rightValue = [](auto /*row*/, auto index) { return 2 * index; };
+  auto left = makeArrayVector<int32_t>(size, leftSize, leftValue);
+  auto right = makeArrayVector<int32_t>(size, rightSize, rightValue);
+
+  std::vector<std::vector<int32_t>> expected(size);
+  for (auto row = 0; row < size; ++row) {
+    std::unordered_set<int32_t> rightValues;
+    for (auto i = 0; i < rightSize(row); ++i) {
+      rightValues.insert(rightValue(row, i));
+    }
+    std::unordered_set<int32_t> added;
+    for (auto i = 0; i < leftSize(row); ++i) {
+      const auto value = leftValue(row, i);
+      if (rightValues.count(value) && added.insert(value).second) {
+        expected[row].push_back(value);
+      }
+    }
+  }
+  testExpr(
+      makeArrayVector<int32_t>(expected),
+      "array_intersect(C0, C1)",
+      {left, right});
+}
+
 TEST_F(ArrayIntersectTest, floatArrays) {
   testFloatingPoint<float>();
   testFloatingPoint<double>();
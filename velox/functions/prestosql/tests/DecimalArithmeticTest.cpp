@@ -224,6 +224,30 @@ TEST_F(DecimalArithmeticTest, subtract) {
       "Decimal overflow: 1 - -99999999999999999999999999999999999999");
 }
 
+TEST_F(DecimalArithmeticTest, deferredOverflowCheck) {
+  // Only the rows that overflow fail when a batch without per row overflow
+  // checks is computed again.
+  auto longFlat = makeLongDecimalFlatVector(
+      {1, DecimalUtil::kLongDecimalMax, -2, DecimalUtil::kLongDecimalMin},
+      DECIMAL(38, 0));
+  auto ones = makeLongDecimalFlatVector({1, 1, 1, 1}, DECIMAL(38, 0));
+  auto result = evaluate("try(c0 + c1)", makeRowVector({longFlat, ones}));
+  assertEqualVectors(
+      makeNullableLongDecimalFlatVector(
+          {2, std::nullopt, -1, DecimalUtil::kLongDecimalMin + 1},
+          DECIMAL(38, 0)),
+      result);
+  result = evaluate("try(c0 - c1)", makeRowVector({longFlat, ones}));
+  assertEqualVectors(
+      makeNullableLongDecimalFlatVector(
+          {0, DecimalUtil::kLongDecimalMax - 1, -3, std::nullopt},
+          DECIMAL(38, 0)),
+      result);
+  VELOX_ASSERT_THROW(
+      evaluate("c0 - c1", makeRowVector({longFlat, ones})),
+      "Value '-100000000000000000000000000000000000000' is not in the range of Decimal Type");
+}
+
 TEST_F(DecimalArithmeticTest, multiply) {
   auto shortFlat = makeShortDecimalFlatVector({1000, 2000}, DECIMAL(17, 3));
   // Multiply short and short, returning long.
@@ -485,6 +485,36 @@ TEST_F(JsonFunctionsTest, invalidPath) {
   VELOX_ASSERT_THROW(jsonSize(R"({"k1":"v1)", "$.k1]"), "Invalid JSON path");
 }
 
+TEST_F(JsonFunctionsTest, jsonExtractScalarConstantPath) {
+  auto data = makeRowVector({makeFlatVector<std::string>({
+      R"({"k1": {"k2": "v2"}, "k3": 1})",
+      R"({"k1": {"k2": 1.5}})",
+      R"({"k1": {"k2": true}})",
+      R"({"k1": {"k2": [1, 2]}})",
+      R"({"k1": {"k2": null}})",
+      R"({"k1": {"k2": 18446744073709551615}})",
+      R"({"k1": {"k2": "v2"})",
+      R"({"k3": 1})",
+  })});
+
+  auto result = evaluate<SimpleVector<StringView>>(
+      "json_extract_scalar(c0, '$.k1.k2')", data);
+  ASSERT_EQ(result->valueAt(0), StringView("v2"));
+  ASSERT_EQ(result->valueAt(1), StringView("1.5"));
+  ASSERT_EQ(result->valueAt(2), StringView("true"));
+  // Not scalars, too large for folly and invalid JSON.
+  for (auto i = 3; i < data->size(); ++i) {
+    ASSERT_TRUE(result->isNullAt(i)) << i;
+  }
+
+  // Wildcards are evaluated the same as with a non-constant path.
+  result = evaluate<SimpleVector<StringView>>(
+      "json_extract_scalar(c0, '$.k1[*]')", data);
+  for (auto i = 0; i < data->size(); ++i) {
+    ASSERT_TRUE(result->isNullAt(i)) << i;
+  }
+}
+
 TEST_F(JsonFunctionsTest, jsonExtract) {
   auto jsonExtract = [&](std::optional<std::string> json,
                          const std::string& path) {
@@ -709,6 +709,40 @@ TEST_F(StringFunctionsTest, upper) {
   }
 }
 
+// Test upper and lower over the string buffers of flat ascii vectors with a
+// subset of rows selected.
+TEST_F(StringFunctionsTest, upperLowerAsciiBuffers) {
+  const vector_size_t size = 1'000;
+  auto makeString = [](vector_size_t row) {
+    return row % 5 == 0 ? fmt::format("sHoRt{}", row % 10)
+                        : fmt::format("{}_MiXeD_CaSe_StRiNg_{}", row, row * 7);
+  };
+  std::vector<std::string> inputs;
+  for (vector_size_t i = 0; i < size; ++i) {
+    inputs.push_back(makeString(i));
+  }
+  auto strings = makeFlatVector<std::string>(inputs);
+  strings->setAllIsAscii(true);
+  auto data = makeRowVector(
+      {strings, makeFlatVector<bool>(size, [](auto row) {
+         return row % 3 == 0;
+       })});
+
+  auto result = evaluate<SimpleVector<StringView>>(
+      "if(c1, upper(c0), lower(c0))", data);
+  for (vector_size_t i = 0; i < size; ++i) {
+    auto expected = inputs[i];
+    for (auto& c : expected) {
+      c = i % 3 == 0 ? std::toupper(c) : std::tolower(c);
+    }
+    ASSERT_EQ(result->valueAt(i), StringView(expected)) << i;
+  }
+  // The input is not changed.
+  for (vector_size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(strings->valueAt(i), StringView(inputs[i])) << i;
+  }
+}
+
 // Test lower vector function
 TEST_F(StringFunctionsTest, lower) {
   auto lowerStd = [](const std::string& input) {
@@ -136,6 +136,28 @@ TEST_F(TransformTest, dictionaryWithDuplicates) {
   assertEqualVectors(expectedResult, result);
 }
 
+TEST_F(TransformTest, constantCapture) {
+  vector_size_t size = 1'000;
+  auto array = makeArrayVector<int64_t>(size, modN(5), modN(7), nullEvery(11));
+
+  // Constant captures are not wrapped to align them with the elements.
+  auto input = makeRowVector({makeConstant<int64_t>(3, size), array});
+  auto result = evaluate<ArrayVector>("transform(c1, x -> x * c0)", input);
+  auto expectedResult = makeArrayVector<int64_t>(
+      size,
+      modN(5),
+      [](vector_size_t row) { return row % 7 * 3; },
+      nullEvery(11));
+  assertEqualVectors(expectedResult, result);
+
+  input = makeRowVector({makeNullConstant(TypeKind::BIGINT, size), array});
+  result = evaluate<ArrayVector>(
+      "transform(c1, x -> coalesce(x * c0, -1))", input);
+  expectedResult = makeArrayVector<int64_t>(
+      size, modN(5), [](vector_size_t /*row*/) { return -1; }, nullEvery(11));
+  assertEqualVectors(expectedResult, result);
+}
+
 TEST_F(TransformTest, try) {
   auto input = makeRowVector({
       makeArrayVector<int64_t>({
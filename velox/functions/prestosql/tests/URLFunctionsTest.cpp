@@ -101,6 +101,22 @@ TEST_F(URLFunctionsTest, validateURL) {
   validate("foo", "", "", "", "", "", std::nullopt);
 }
 
+TEST_F(URLFunctionsTest, extractHost) {
+  const auto extractHost = [&](const std::optional<string_t>& url) {
+    return evaluateOnce<string_t>("url_extract_host(c0)", url).value();
+  };
+  EXPECT_EQ("example.com", extractHost("http://user:pw@example.com:80/p"));
+  EXPECT_EQ("[::1]", extractHost("http://[::1]:8080/p?q#f"));
+  EXPECT_EQ("host", extractHost("a+b.c-d://host?q"));
+  EXPECT_EQ("b@c", extractHost("http://a@b@c/"));
+  EXPECT_EQ("", extractHost("http://a@b:1@b/"));
+  EXPECT_EQ("", extractHost("http://host:port/"));
+  EXPECT_EQ("", extractHost("http://[::1/"));
+  EXPECT_EQ("", extractHost("http://:80"));
+  EXPECT_EQ("", extractHost("1http://host/"));
+  EXPECT_EQ("", extractHost("http:host/"));
+}
+
 TEST_F(URLFunctionsTest, extractParameter) {
   const auto extractParam = [&](const std::optional<std::string>& a,
                                 const std::optional<std::string>& b) {
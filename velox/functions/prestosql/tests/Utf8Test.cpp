@@ -95,5 +95,39 @@ TEST(Utf8Test, tryCharLength) {
   ASSERT_EQ(-1, tryCharLength({0xBF}));
 }
 
+TEST(Utf8Test, isValidUtf8) {
+  auto isValidReference = [](const std::string& input) {
+    int64_t pos = 0;
+    while (pos < input.size()) {
+      auto charLength =
+          tryGetCharLength(input.data() + pos, input.size() - pos);
+      if (charLength < 0) {
+        return false;
+      }
+      pos += charLength;
+    }
+    return true;
+  };
+
+  ASSERT_TRUE(isValidUtf8("", 0));
+  // ASCII runs longer and shorter than a SIMD batch around multi-byte
+  // characters, and invalid sequences in and after the runs.
+  for (auto asciiLength : {0, 1, 15, 16, 17, 31, 32, 33, 100}) {
+    const std::string ascii(asciiLength, 'a');
+    for (const std::string& other :
+         {"", "\u00A3", "\u20AC", "\U0001D122", "\xBF", "\xE2\x82", "\xFF"}) {
+      for (const auto& input :
+           {ascii + other,
+            other + ascii,
+            ascii + other + ascii,
+            ascii + "\u00A3" + ascii + other + ascii}) {
+        ASSERT_EQ(
+            isValidUtf8(input.data(), input.size()), isValidReference(input))
+            << input;
+      }
+    }
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::functions
@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/functions/lib/window/tests/WindowTestBase.h"
 #include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
 
@@ -103,5 +107,84 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
     RankTest,
     testing::ValuesIn(getRankTestParams()));
 
+class StreamingRankTest : public WindowTestBase {
+ protected:
+  void SetUp() override {
+    WindowTestBase::SetUp();
+    window::prestosql::registerAllWindowFunctions();
+  }
+};
+
+// Tests all functions with the streaming window operator over input sorted by
+// an order by. Small output batches make partitions span input batches of the
+// window operator.
+TEST_F(StreamingRankTest, sortedInput) {
+  std::vector<RowVectorPtr> input = {
+      makeSimpleVector(100), makeSinglePartitionVector(30)};
+  createDuckDbTable(input);
+
+  const std::vector<std::pair<std::string, std::vector<std::string>>>
+      overClauses = {
+          {"partition by c0 order by c1 desc nulls last, c2, c3",
+           {"c0", "c1 DESC NULLS LAST", "c2", "c3"}},
+          {"order by c0, c1 nulls first, c2, c3",
+           {"c0", "c1 NULLS FIRST", "c2", "c3"}},
+      };
+  for (const auto& function : kRankFunctions) {
+    for (const auto& [overClause, sortingKeys] : overClauses) {
+      auto functionSql = fmt::format("{} over ({})", function, overClause);
+      SCOPED_TRACE(functionSql);
+      auto plan = PlanBuilder()
+                      .values(input)
+                      .orderBy(sortingKeys, false)
+                      .streamingWindow({functionSql})
+                      .planNode();
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kPreferredOutputBatchRows, "7")
+          .assertResults(
+              fmt::format("SELECT c0, c1, c2, c3, {} FROM tmp", functionSql));
+    }
+  }
+}
+
+// Tests all functions with a window operator that spills all of its input
+// batches but the last one and outputs the partitions from the sort merge of
+// the spilled runs.
+TEST_F(StreamingRankTest, spill) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeSimpleVector(100));
+  }
+  createDuckDbTable(input);
+
+  for (const auto& function : kRankFunctions) {
+    auto functionSql = fmt::format(
+        "{} over (partition by c0 order by c1 desc nulls last, c2, c3)",
+        function);
+    SCOPED_TRACE(functionSql);
+    core::PlanNodeId windowId;
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .window({functionSql})
+                    .capturePlanNodeId(windowId)
+                    .planNode();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kPreferredOutputBatchRows, "7")
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kWindowSpillEnabled, "true")
+            .spillDirectory(spillDirectory->path)
+            .assertResults(
+                fmt::format("SELECT c0, c1, c2, c3, {} FROM tmp", functionSql));
+    const auto windowStats = toPlanStats(task->taskStats()).at(windowId);
+    EXPECT_LT(0, windowStats.spilledBytes);
+    EXPECT_EQ(1, windowStats.spilledPartitions);
+    // NOTE: the last input batch won't go spilling.
+    EXPECT_GT(500, windowStats.spilledRows);
+  }
+}
+
 }; // namespace
 }; // namespace facebook::velox::window::test
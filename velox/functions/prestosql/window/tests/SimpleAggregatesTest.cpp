@@ -89,6 +89,19 @@ TEST_P(SimpleAggregatesTest, singlePartition) {
       {makeSinglePartitionVector(50), makeSinglePartitionVector(40)});
 }
 
+// Tests function with sliding frames over a single large partition. The
+// frames are aggregated using a segment tree of several levels.
+TEST_P(SimpleAggregatesTest, largeSlidingFrames) {
+  WindowTestBase::testWindowFunction(
+      {makeSinglePartitionVector(1'000), makeSinglePartitionVector(3'000)},
+      function_,
+      {overClause_},
+      {"rows between 100 preceding and current row",
+       "rows between 300 preceding and 20 following",
+       "rows between current row and 500 following",
+       "rows between 17 following and 1000 following"});
+}
+
 // Tests function with a dataset where all partitions have a single row.
 TEST_P(SimpleAggregatesTest, singleRowPartitions) {
   testWindowFunction({makeSingleRowPartitionsVector(40)});
@@ -18,12 +18,44 @@
 #include <folly/CPortability.h>
 
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/DecodedArgs.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::functions::sparksql {
 namespace {
 
+class Murmur3Hash;
+
+// Combines the hashes of the values of 'decoded' at the 'rows' into
+// 'rawResult'. 'hashFn' takes a value and the hash of the previous columns as
+// seed. Reads flat fixed width values directly.
+template <typename T, typename ReturnType, typename HashFn>
+void hashColumn(
+    const SelectivityVector& rows,
+    const DecodedVector& decoded,
+    ReturnType* rawResult,
+    HashFn hashFn) {
+  if constexpr (!std::is_same_v<T, bool> && !std::is_same_v<T, StringView>) {
+    if (decoded.isIdentityMapping()) {
+      const auto* values = decoded.data<T>();
+      rows.applyToSelected([&](auto row) {
+        rawResult[row] = hashFn(values[row], rawResult[row]);
+      });
+      return;
+    }
+  }
+  if (decoded.isConstantMapping()) {
+    const auto value = decoded.valueAt<T>(0);
+    rows.applyToSelected(
+        [&](auto row) { rawResult[row] = hashFn(value, rawResult[row]); });
+    return;
+  }
+  rows.applyToSelected([&](auto row) {
+    rawResult[row] = hashFn(decoded.valueAt<T>(row), rawResult[row]);
+  });
+}
+
 // ReturnType can be either int32_t or int64_t
 // HashClass contains the function like hashInt32
 template <typename ReturnType, typename HashClass, typename SeedType>
@@ -37,6 +69,7 @@ void applyWithType(
 
   auto& result = *resultRef->as<FlatVector<ReturnType>>();
   rows.applyToSelected([&](int row) { result.set(row, kSeed); });
+  auto* rawResult = result.mutableRawValues();
 
   exec::LocalSelectivityVector selectedMinusNulls(context);
 
@@ -50,15 +83,26 @@ void applyWithType(
           decoded->nulls(), rows.begin(), rows.end());
       selected = selectedMinusNulls.get();
     }
+    if constexpr (std::is_same_v<HashClass, Murmur3Hash>) {
+      if (args[i]->typeKind() == TypeKind::INTEGER &&
+          decoded->isIdentityMapping() && selected->isAllSelected()) {
+        // All rows from 0 are selected.
+        hash.hashInt32Batch(
+            decoded->data<int32_t>(),
+            selected->end(),
+            reinterpret_cast<uint32_t*>(rawResult));
+        continue;
+      }
+    }
     switch (args[i]->type()->kind()) {
 // Derived from InterpretedHashFunction.hash:
 // https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
 #define CASE(typeEnum, hashFn, inputType)                                      \
   case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
+    hashColumn<inputType>(                                                     \
+        *selected, *decoded, rawResult, [&](auto value, auto seed) {           \
+          return hashFn(value, seed);                                          \
+        });                                                                    \
     break;
       CASE(BOOLEAN, hash.hashInt32, bool);
       CASE(TINYINT, hash.hashInt32, int8_t);
@@ -120,6 +164,33 @@ class Murmur3Hash final {
         input == -0. ? 0 : *reinterpret_cast<uint64_t*>(&input), seed);
   }
 
+  // Same as 'hashes[i] = hashInt32(input[i], hashes[i])' for 'size' values,
+  // a batch of lanes at a time.
+  void hashInt32Batch(const int32_t* input, int32_t size, uint32_t* hashes) {
+    using Batch = xsimd::batch<uint32_t>;
+    int32_t i = 0;
+    for (; i + static_cast<int32_t>(Batch::size) <= size; i += Batch::size) {
+      auto k1 =
+          Batch::load_unaligned(reinterpret_cast<const uint32_t*>(input + i));
+      k1 *= Batch(0xcc9e2d51);
+      k1 = (k1 << 15) | (k1 >> 17);
+      k1 *= Batch(0x1b873593);
+      auto h1 = Batch::load_unaligned(hashes + i) ^ k1;
+      h1 = (h1 << 13) | (h1 >> 19);
+      h1 = h1 * Batch(5) + Batch(0xe6546b64);
+      h1 ^= Batch(4);
+      h1 ^= h1 >> 16;
+      h1 *= Batch(0x85ebca6b);
+      h1 ^= h1 >> 13;
+      h1 *= Batch(0xc2b2ae35);
+      h1 ^= h1 >> 16;
+      h1.store_unaligned(hashes + i);
+    }
+    for (; i < size; ++i) {
+      hashes[i] = hashInt32(input[i], hashes[i]);
+    }
+  }
+
   // Spark also has an hashUnsafeBytes2 function, but it was not used at the
   // time of implementation.
   uint32_t hashBytes(const StringView& input, uint32_t seed) {
@@ -58,6 +58,25 @@ TEST_F(HashTest, Int32) {
   EXPECT_EQ(hash<int32_t>(std::nullopt), 42);
 }
 
+TEST_F(HashTest, int32Batch) {
+  // Flat integers are hashed a SIMD batch at a time. Compares with the same
+  // values in a dictionary, which are hashed one at a time.
+  const vector_size_t size = 1'003;
+  auto strings = makeFlatVector<std::string>(
+      size, [](auto row) { return std::string(row % 17, 'x'); });
+  auto ints = makeFlatVector<int32_t>(size, [](auto row) {
+    return static_cast<int32_t>(row * 2'654'435'761U);
+  });
+  auto indices = makeIndices(size, [](auto row) { return row; });
+  auto dictionaryInts = wrapInDictionary(indices, size, ints);
+
+  auto expected = evaluate<SimpleVector<int32_t>>(
+      "hash(c0, c1)", makeRowVector({strings, dictionaryInts}));
+  auto result = evaluate<SimpleVector<int32_t>>(
+      "hash(c0, c1)", makeRowVector({strings, ints}));
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(HashTest, Int16) {
   EXPECT_EQ(hash<int16_t>(1), -559580957);
   EXPECT_EQ(hash<int16_t>(0), 933211791);
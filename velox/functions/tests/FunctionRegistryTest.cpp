@@ -494,6 +494,34 @@ struct TestFunction {
   }
 };
 
+TEST_F(FunctionRegistryTest, resolveAfterRegisteringAgain) {
+  // Resolutions are cached but not used after the function is registered
+  // again.
+  const std::string vectorFunc = "vector_func_registered_again";
+  exec::registerVectorFunction(
+      vectorFunc,
+      VectorFuncOne::signatures(),
+      std::make_unique<VectorFuncOne>());
+  testResolveVectorFunction(vectorFunc, {VARCHAR()}, BIGINT());
+  testResolveVectorFunction(vectorFunc, {VARCHAR()}, BIGINT());
+
+  exec::registerVectorFunction(
+      vectorFunc,
+      VectorFuncTwo::signatures(),
+      std::make_unique<VectorFuncTwo>());
+  testResolveVectorFunction(vectorFunc, {VARCHAR()}, nullptr);
+  testResolveVectorFunction(vectorFunc, {ARRAY(VARCHAR())}, ARRAY(BIGINT()));
+
+  const std::string simpleFunc = "func_registered_again";
+  registerFunction<FuncOne, Varchar, Varchar>({simpleFunc});
+  ASSERT_EQ(resolveFunction(simpleFunc, {BIGINT()}), nullptr);
+  ASSERT_EQ(resolveFunction(simpleFunc, {BIGINT()}), nullptr);
+
+  registerFunction<FuncFive, int64_t, int64_t>({simpleFunc});
+  ASSERT_EQ(*resolveFunction(simpleFunc, {BIGINT()}), *BIGINT());
+  ASSERT_EQ(*resolveFunction(simpleFunc, {VARCHAR()}), *VARCHAR());
+}
+
 TEST_F(FunctionRegistryTest, resolveFunctionsBasedOnPriority) {
   std::string func = "func_with_priority";
 
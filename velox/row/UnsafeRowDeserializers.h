@@ -236,6 +236,23 @@ struct StructBatchIterator : UnsafeRowDataBatchIterator {
     return columnData_;
   }
 
+  /**
+   * Advances past the next element without materializing its per-row views.
+   * Used by callers that decode the element directly from the struct data.
+   * @return the index of the skipped element.
+   */
+  size_t skipColumnBatch() {
+    VELOX_CHECK(hasNext());
+    return idx_++;
+  }
+
+  /**
+   * @return the serialized structs, one per row.
+   */
+  const std::vector<std::optional<std::string_view>>& structs() const {
+    return data_;
+  }
+
   /**
    * @return the number of elements in the idx-th row.
    */
@@ -665,6 +682,73 @@ struct UnsafeRowDeserializer {
         nullCount);
   }
 
+  /**
+   * Decodes the 'fieldIndex'-th primitive field of a batch of UnsafeRow
+   * structs straight into the values and nulls of a FlatVector. Fixed width
+   * values are copied from the field words and strings are referenced through
+   * their offset and size word, without going through per-row views of the
+   * field.
+   * @tparam Kind the field's type kind.
+   * @param structs the serialized structs, std::nullopt for null structs.
+   * @param fieldIndex the index of the field to decode.
+   * @param numFields the number of fields in the struct.
+   * @param type the field type.
+   * @param pool
+   * @return a FlatVector
+   */
+  template <TypeKind Kind>
+  static VectorPtr createFlatVectorFromStructs(
+      const std::vector<std::optional<std::string_view>>& structs,
+      size_t fieldIndex,
+      size_t numFields,
+      const TypePtr& type,
+      memory::MemoryPool* pool) {
+    using T = typename TypeTraits<Kind>::NativeType;
+
+    const auto size = structs.size();
+    auto vector = BaseVector::create<FlatVector<T>>(type, size, pool);
+    const size_t fieldOffset = UnsafeRow::getNullLength(numFields) +
+        fieldIndex * UnsafeRow::kFieldWidthBytes;
+
+    uint64_t* rawNulls = nullptr;
+    auto* rawValues = vector->mutableRawValues();
+    for (size_t i = 0; i < size; ++i) {
+      const auto& data = structs[i];
+      if (!data.has_value() || bits::isBitSet(data->data(), fieldIndex)) {
+        if (rawNulls == nullptr) {
+          rawNulls = vector->mutableRawNulls();
+        }
+        bits::setNull(rawNulls, i);
+        continue;
+      }
+
+      const char* rawData = data->data();
+      const char* fieldData = rawData + fieldOffset;
+      if constexpr (std::is_same_v<T, StringView>) {
+        const uint64_t offsetAndSize =
+            *reinterpret_cast<const uint64_t*>(fieldData);
+        // Copies the bytes. 'structs' may refer to memory that is freed
+        // after deserialization.
+        vector->set(
+            i,
+            StringView(
+                rawData + (offsetAndSize >> 32),
+                static_cast<uint32_t>(offsetAndSize)));
+      } else if constexpr (std::is_same_v<T, bool>) {
+        bits::setBit(
+            reinterpret_cast<uint64_t*>(rawValues),
+            i,
+            *reinterpret_cast<const bool*>(fieldData));
+      } else if constexpr (std::is_same_v<T, Timestamp>) {
+        rawValues[i] =
+            Timestamp::fromMicros(*reinterpret_cast<const int64_t*>(fieldData));
+      } else {
+        rawValues[i] = *reinterpret_cast<const T*>(fieldData);
+      }
+    }
+    return vector;
+  }
+
   /**
    * Converts a list of StructBatchIterators to Vectors.
    * @param dataIterator iterator that points to whole column batch of data.
@@ -684,10 +768,25 @@ struct UnsafeRowDeserializer {
 
     auto nulls = populateNulls(dataIterator, pool, numStructs);
 
+    // Primitive fields are decoded column by column directly from the structs.
+    // Complex fields go through per-row views of the field.
     std::vector<VectorPtr> columnVectors(numFields);
     for (size_t i = 0; i < numFields; ++i) {
+      const auto& childType = rowType.childAt(i);
+      if (childType->isPrimitiveType()) {
+        const auto fieldIndex = StructBatchIteratorPtr->skipColumnBatch();
+        columnVectors[i] = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+            createFlatVectorFromStructs,
+            childType->kind(),
+            StructBatchIteratorPtr->structs(),
+            fieldIndex,
+            numFields,
+            childType,
+            pool);
+        continue;
+      }
       columnVectors[i] = deserialize(
-          StructBatchIteratorPtr->nextColumnBatch(), rowType.childAt(i), pool);
+          StructBatchIteratorPtr->nextColumnBatch(), childType, pool);
     }
 
     return std::make_shared<RowVector>(
@@ -178,6 +178,91 @@ void UnsafeRowFast::serializeFixedWidth(
       valueBytes_ * size);
 }
 
+template <typename T>
+void UnsafeRowFast::writeFixedWidthColumn(
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) {
+  if (decoded_.isIdentityMapping() && !decoded_.mayHaveNulls()) {
+    auto values = decoded_.data<T>();
+    for (auto i = 0; i < rows.size(); ++i) {
+      *reinterpret_cast<T*>(buffer + offsets[i]) = values[rows[i]];
+    }
+    return;
+  }
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (!decoded_.isNullAt(rows[i])) {
+      *reinterpret_cast<T*>(buffer + offsets[i]) =
+          decoded_.valueAt<T>(rows[i]);
+    }
+  }
+}
+
+template <>
+void UnsafeRowFast::writeFixedWidthColumn<bool>(
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) {
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (!decoded_.isNullAt(rows[i])) {
+      *reinterpret_cast<bool*>(buffer + offsets[i]) =
+          decoded_.valueAt<bool>(rows[i]);
+    }
+  }
+}
+
+template <>
+void UnsafeRowFast::writeFixedWidthColumn<Timestamp>(
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) {
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (!decoded_.isNullAt(rows[i])) {
+      *reinterpret_cast<int64_t*>(buffer + offsets[i]) =
+          decoded_.valueAt<Timestamp>(rows[i]).toMicros();
+    }
+  }
+}
+
+void UnsafeRowFast::serializeFixedWidthColumn(
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) {
+  VELOX_DCHECK(fixedWidthTypeKind_);
+  switch (typeKind_) {
+    case TypeKind::BOOLEAN:
+      writeFixedWidthColumn<bool>(rows, offsets, buffer);
+      break;
+    case TypeKind::TINYINT:
+      writeFixedWidthColumn<int8_t>(rows, offsets, buffer);
+      break;
+    case TypeKind::SMALLINT:
+      writeFixedWidthColumn<int16_t>(rows, offsets, buffer);
+      break;
+    case TypeKind::INTEGER:
+      writeFixedWidthColumn<int32_t>(rows, offsets, buffer);
+      break;
+    case TypeKind::BIGINT:
+      writeFixedWidthColumn<int64_t>(rows, offsets, buffer);
+      break;
+    case TypeKind::REAL:
+      writeFixedWidthColumn<float>(rows, offsets, buffer);
+      break;
+    case TypeKind::DOUBLE:
+      writeFixedWidthColumn<double>(rows, offsets, buffer);
+      break;
+    case TypeKind::DATE:
+      writeFixedWidthColumn<Date>(rows, offsets, buffer);
+      break;
+    case TypeKind::TIMESTAMP:
+      writeFixedWidthColumn<Timestamp>(rows, offsets, buffer);
+      break;
+    default:
+      VELOX_UNREACHABLE(
+          "Unexpected type kind: {}", mapTypeKindToName(typeKind_));
+  }
+}
+
 int32_t UnsafeRowFast::serializeVariableWidth(
     vector_size_t index,
     char* buffer) {
@@ -364,6 +449,74 @@ int32_t UnsafeRowFast::rowRowSize(vector_size_t index) {
   return size;
 }
 
+void UnsafeRowFast::serializedRowSizes(
+    folly::Range<const vector_size_t*> rows,
+    vector_size_t* sizes) {
+  const int32_t fixedSize = rowNullBytes_ + children_.size() * kFieldWidth;
+  std::fill(sizes, sizes + rows.size(), fixedSize);
+  for (auto i = 0; i < children_.size(); ++i) {
+    if (childIsFixedWidth_[i]) {
+      continue;
+    }
+    auto& child = children_[i];
+    for (auto j = 0; j < rows.size(); ++j) {
+      auto childIndex = decoded_.index(rows[j]);
+      if (!child.isNullAt(childIndex)) {
+        sizes[j] += alignBytes(child.variableWidthRowSize(childIndex));
+      }
+    }
+  }
+}
+
+void UnsafeRowFast::serialize(
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) {
+  const auto numRows = rows.size();
+  std::vector<vector_size_t> childRows(numRows);
+  for (auto j = 0; j < numRows; ++j) {
+    childRows[j] = decoded_.index(rows[j]);
+  }
+  folly::Range<const vector_size_t*> childRange(childRows.data(), numRows);
+
+  // Offset of the next variable-width value within each row.
+  std::vector<int64_t> variableWidthOffsets(
+      numRows, rowNullBytes_ + kFieldWidth * children_.size());
+
+  for (auto i = 0; i < children_.size(); ++i) {
+    auto& child = children_[i];
+
+    // Write null bits.
+    if (child.decoded_.mayHaveNulls()) {
+      for (auto j = 0; j < numRows; ++j) {
+        if (child.isNullAt(childRows[j])) {
+          bits::setBit(buffer + offsets[j], i, true);
+        }
+      }
+    }
+
+    char* fields = buffer + rowNullBytes_ + i * kFieldWidth;
+    if (childIsFixedWidth_[i]) {
+      child.serializeFixedWidthColumn(childRange, offsets, fields);
+      continue;
+    }
+
+    for (auto j = 0; j < numRows; ++j) {
+      if (child.isNullAt(childRows[j])) {
+        continue;
+      }
+      auto& variableWidthOffset = variableWidthOffsets[j];
+      auto size = child.serializeVariableWidth(
+          childRows[j], buffer + offsets[j] + variableWidthOffset);
+      // Write size and offset.
+      uint64_t sizeAndOffset = variableWidthOffset << 32 | size;
+      *reinterpret_cast<uint64_t*>(fields + offsets[j]) = sizeAndOffset;
+
+      variableWidthOffset += alignBytes(size);
+    }
+  }
+}
+
 int32_t UnsafeRowFast::serializeRow(vector_size_t index, char* buffer) {
   auto childIndex = decoded_.index(index);
 
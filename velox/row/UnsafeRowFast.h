@@ -36,6 +36,22 @@ class UnsafeRowFast {
   /// 'buffer' must have sufficient capacity and set to all zeros.
   int32_t serialize(vector_size_t index, char* buffer);
 
+  /// Computes the serialized sizes of 'rows' into 'sizes' a column at a time.
+  /// 'sizes' must have space for rows.size() values. Returns the same sizes
+  /// as rowSize().
+  void serializedRowSizes(
+      folly::Range<const vector_size_t*> rows,
+      vector_size_t* sizes);
+
+  /// Serializes 'rows' a column at a time. Row 'rows[i]' is written to
+  /// 'buffer' + 'offsets[i]'. Each row must have the capacity returned by
+  /// serializedRowSizes() and be set to all zeros. Produces the same bytes as
+  /// serialize(index, buffer) for each row.
+  void serialize(
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer);
+
  protected:
   explicit UnsafeRowFast(const VectorPtr& vector);
 
@@ -57,6 +73,13 @@ class UnsafeRowFast {
   void
   serializeFixedWidth(vector_size_t offset, vector_size_t size, char* buffer);
 
+  /// Writes fixed-width values at 'rows' to 'buffer' + 'offsets[i]'. Skips
+  /// null values.
+  void serializeFixedWidthColumn(
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer);
+
   /// Returns serialized size of variable-width row.
   int32_t variableWidthRowSize(vector_size_t index);
 
@@ -101,6 +124,12 @@ class UnsafeRowFast {
   /// Serializes struct value to buffer. Value must not be null.
   int32_t serializeRow(vector_size_t index, char* buffer);
 
+  template <typename T>
+  void writeFixedWidthColumn(
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer);
+
   const TypeKind typeKind_;
   DecodedVector decoded_;
 
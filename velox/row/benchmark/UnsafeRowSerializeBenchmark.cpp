@@ -15,6 +15,7 @@
  */
 #include <folly/Benchmark.h>
 #include <folly/init/Init.h>
+#include <numeric>
 
 #include "velox/row/UnsafeRowFast.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
@@ -26,15 +27,7 @@ class SerializeBenchmark {
  public:
   void run(const RowTypePtr& rowType) {
     folly::BenchmarkSuspender suspender;
-
-    VectorFuzzer::Options options;
-    options.vectorSize = 1'000;
-
-    const auto seed = 1; // For reproducibility.
-    VectorFuzzer fuzzer(options, pool_.get(), seed);
-
-    auto data = fuzzer.fuzzInputRow(rowType);
-
+    auto data = makeData(rowType);
     suspender.dismiss();
 
     UnsafeRowFast fast(data);
@@ -62,7 +55,47 @@ class SerializeBenchmark {
     VELOX_CHECK_EQ(totalSize, offset);
   }
 
+  // Serializes all rows a column at a time.
+  void runBatch(const RowTypePtr& rowType) {
+    folly::BenchmarkSuspender suspender;
+    auto data = makeData(rowType);
+    std::vector<vector_size_t> rows(data->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    const folly::Range<const vector_size_t*> rowRange(rows.data(), rows.size());
+    suspender.dismiss();
+
+    UnsafeRowFast fast(data);
+
+    std::vector<vector_size_t> sizes(rows.size());
+    if (auto fixedRowSize =
+            UnsafeRowFast::fixedRowSize(asRowType(data->type()))) {
+      std::fill(sizes.begin(), sizes.end(), fixedRowSize.value());
+    } else {
+      fast.serializedRowSizes(rowRange, sizes.data());
+    }
+
+    std::vector<size_t> offsets(rows.size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      offsets[i] = totalSize;
+      totalSize += sizes[i];
+    }
+
+    auto buffer = AlignedBuffer::allocate<char>(totalSize, pool(), 0);
+    fast.serialize(rowRange, offsets.data(), buffer->asMutable<char>());
+  }
+
  private:
+  RowVectorPtr makeData(const RowTypePtr& rowType) {
+    VectorFuzzer::Options options;
+    options.vectorSize = 1'000;
+
+    const auto seed = 1; // For reproducibility.
+    VectorFuzzer fuzzer(options, pool_.get(), seed);
+
+    return fuzzer.fuzzInputRow(rowType);
+  }
+
   memory::MemoryPool* pool() {
     return pool_.get();
   }
@@ -75,6 +108,11 @@ BENCHMARK(fixedWidth5) {
   benchmark.run(ROW({BIGINT(), DOUBLE(), BOOLEAN(), TINYINT(), REAL()}));
 }
 
+BENCHMARK_RELATIVE(fixedWidth5Batch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({BIGINT(), DOUBLE(), BOOLEAN(), TINYINT(), REAL()}));
+}
+
 BENCHMARK(fixedWidth10) {
   SerializeBenchmark benchmark;
   benchmark.run(ROW({
@@ -91,6 +129,22 @@ BENCHMARK(fixedWidth10) {
   }));
 }
 
+BENCHMARK_RELATIVE(fixedWidth10Batch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({
+      BIGINT(),
+      BIGINT(),
+      BIGINT(),
+      BIGINT(),
+      BIGINT(),
+      BIGINT(),
+      DOUBLE(),
+      BIGINT(),
+      BIGINT(),
+      BIGINT(),
+  }));
+}
+
 BENCHMARK(fixedWidth20) {
   SerializeBenchmark benchmark;
   benchmark.run(ROW({
@@ -100,11 +154,25 @@ BENCHMARK(fixedWidth20) {
   }));
 }
 
+BENCHMARK_RELATIVE(fixedWidth20Batch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({
+      BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(),
+      BIGINT(), BIGINT(), BIGINT(), DOUBLE(), DOUBLE(), DOUBLE(), DOUBLE(),
+      DOUBLE(), DOUBLE(), DOUBLE(), DOUBLE(), BIGINT(), BIGINT(),
+  }));
+}
+
 BENCHMARK(strings1) {
   SerializeBenchmark benchmark;
   benchmark.run(ROW({BIGINT(), VARCHAR()}));
 }
 
+BENCHMARK_RELATIVE(strings1Batch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({BIGINT(), VARCHAR()}));
+}
+
 BENCHMARK(strings5) {
   SerializeBenchmark benchmark;
   benchmark.run(ROW({
@@ -117,27 +185,60 @@ BENCHMARK(strings5) {
   }));
 }
 
+BENCHMARK_RELATIVE(strings5Batch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({
+      BIGINT(),
+      VARCHAR(),
+      VARCHAR(),
+      VARCHAR(),
+      VARCHAR(),
+      VARCHAR(),
+  }));
+}
+
 BENCHMARK(arrays) {
   SerializeBenchmark benchmark;
   benchmark.run(ROW({BIGINT(), ARRAY(BIGINT())}));
 }
 
+BENCHMARK_RELATIVE(arraysBatch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({BIGINT(), ARRAY(BIGINT())}));
+}
+
 BENCHMARK(nestedArrays) {
   SerializeBenchmark benchmark;
   benchmark.run(ROW({BIGINT(), ARRAY(ARRAY(BIGINT()))}));
 }
 
+BENCHMARK_RELATIVE(nestedArraysBatch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({BIGINT(), ARRAY(ARRAY(BIGINT()))}));
+}
+
 BENCHMARK(maps) {
   SerializeBenchmark benchmark;
   benchmark.run(ROW({BIGINT(), MAP(BIGINT(), REAL())}));
 }
 
+BENCHMARK_RELATIVE(mapsBatch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(ROW({BIGINT(), MAP(BIGINT(), REAL())}));
+}
+
 BENCHMARK(structs) {
   SerializeBenchmark benchmark;
   benchmark.run(
       ROW({BIGINT(), ROW({BIGINT(), DOUBLE(), BOOLEAN(), TINYINT(), REAL()})}));
 }
 
+BENCHMARK_RELATIVE(structsBatch) {
+  SerializeBenchmark benchmark;
+  benchmark.runBatch(
+      ROW({BIGINT(), ROW({BIGINT(), DOUBLE(), BOOLEAN(), TINYINT(), REAL()})}));
+}
+
 } // namespace
 } // namespace facebook::velox::row
 
@@ -18,6 +18,7 @@
 
 #include <folly/Random.h>
 #include <folly/init/Init.h>
+#include <numeric>
 
 #include "velox/row/UnsafeRowDeserializers.h"
 #include "velox/row/UnsafeRowFast.h"
@@ -94,8 +95,8 @@ class UnsafeRowFuzzTests : public ::testing::Test {
       memory::addDefaultLeafMemoryPool();
 };
 
-TEST_F(UnsafeRowFuzzTests, fast) {
-  auto rowType = ROW({
+RowTypePtr fuzzRowType() {
+  return ROW({
       BOOLEAN(),
       TINYINT(),
       SMALLINT(),
@@ -143,8 +144,44 @@ TEST_F(UnsafeRowFuzzTests, fast) {
       ARRAY({ROW({BIGINT(), VARCHAR()})}),
       MAP(BIGINT(), ROW({BOOLEAN(), TINYINT(), REAL()})),
   });
+}
+
+TEST_F(UnsafeRowFuzzTests, stringsOutliveInput) {
+  VectorMaker maker(pool_.get());
+  auto data = maker.rowVector({
+      maker.flatVector<int64_t>({1, 2, 3}),
+      maker.flatVector<std::string>(
+          {"a string that is not inlined", "short", "another long string"}),
+      maker.rowVector({maker.flatVector<std::string>(
+          {"a nested string that is not inlined", "", "nested"})}),
+  });
+  const auto rowType = asRowType(data->type());
+
+  UnsafeRowFast fast(data);
+  auto buffer = std::make_unique<std::string>();
+  std::vector<size_t> offsets;
+  for (auto i = 0; i < data->size(); ++i) {
+    offsets.push_back(buffer->size());
+    buffer->resize(buffer->size() + fast.rowSize(i));
+  }
+  std::vector<std::optional<std::string_view>> serialized;
+  for (auto i = 0; i < data->size(); ++i) {
+    auto rowSize = fast.serialize(i, buffer->data() + offsets[i]);
+    serialized.push_back(
+        std::string_view(buffer->data() + offsets[i], rowSize));
+  }
 
-  doTest(rowType, [&](const RowVectorPtr& data) {
+  auto result =
+      UnsafeRowDeserializer::deserialize(serialized, rowType, pool_.get());
+
+  // The deserialized strings must not refer to the serialized bytes.
+  std::fill(buffer->begin(), buffer->end(), 'x');
+  buffer.reset();
+  assertEqualVectors(data, result);
+}
+
+TEST_F(UnsafeRowFuzzTests, fast) {
+  doTest(fuzzRowType(), [&](const RowVectorPtr& data) {
     std::vector<std::optional<std::string_view>> serialized;
     serialized.reserve(data->size());
 
@@ -161,5 +198,40 @@ TEST_F(UnsafeRowFuzzTests, fast) {
   });
 }
 
+TEST_F(UnsafeRowFuzzTests, fastBatch) {
+  std::string batchBuffer;
+  doTest(fuzzRowType(), [&](const RowVectorPtr& data) {
+    UnsafeRowFast fast(data);
+
+    std::vector<vector_size_t> rows(data->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    const folly::Range<const vector_size_t*> rowRange(rows.data(), rows.size());
+    std::vector<vector_size_t> sizes(rows.size());
+    fast.serializedRowSizes(rowRange, sizes.data());
+
+    std::vector<size_t> offsets(rows.size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      EXPECT_EQ(sizes[i], fast.rowSize(i)) << i << ", " << data->toString(i);
+      offsets[i] = totalSize;
+      totalSize += sizes[i];
+    }
+    batchBuffer.assign(totalSize, '\0');
+    fast.serialize(rowRange, offsets.data(), batchBuffer.data());
+
+    // The batch produces the same bytes as serializing a row at a time.
+    std::vector<std::optional<std::string_view>> serialized;
+    serialized.reserve(data->size());
+    for (auto i = 0; i < rows.size(); ++i) {
+      auto row = std::string_view(batchBuffer.data() + offsets[i], sizes[i]);
+      auto rowSize = fast.serialize(i, buffers_[i]);
+      EXPECT_EQ(row, std::string_view(buffers_[i], rowSize))
+          << i << ", " << data->toString(i);
+      serialized.push_back(row);
+    }
+    return serialized;
+  });
+}
+
 } // namespace
 } // namespace facebook::velox::row
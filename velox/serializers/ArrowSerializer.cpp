@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/ArrowSerializer.h"
+#include <folly/ScopeGuard.h>
+#include "velox/vector/arrow/Abi.h"
+#include "velox/vector/arrow/Bridge.h"
+
+namespace facebook::velox::serializer::arrow {
+
+namespace {
+
+// A record batch is laid out as:
+//
+//   int32 numRows
+//   int32 numColumns
+//   for each column:
+//     int8 column kind (kArrowColumn or kConstantColumn)
+//     schema tree, depth first: format, name, flags, numChildren,
+//       hasDictionary, children, dictionary
+//     array tree, depth first: length, nullCount, numBuffers, numChildren,
+//       hasDictionary, size of each buffer (-1 for a null buffer), children,
+//       dictionary
+//   int64 bodySize
+//   body: the buffers in the order of the array trees, each padded to
+//     kBufferAlignment bytes
+//
+// A constant column is written as a 1 row array.
+constexpr int8_t kArrowColumn = 0;
+constexpr int8_t kConstantColumn = 1;
+
+constexpr int64_t kBufferAlignment = 8;
+
+int64_t paddedSize(int64_t size) {
+  return bits::roundUp(size, kBufferAlignment);
+}
+
+// Returns true if the Arrow bridge can export 'vector' as is. Constant and
+// other encodings below the top level are not supported by the bridge and
+// are flattened before export.
+bool isExportable(const BaseVector& vector) {
+  switch (vector.encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      return true;
+    case VectorEncoding::Simple::ROW: {
+      auto row = vector.asUnchecked<RowVector>();
+      for (const auto& child : row->children()) {
+        if (!isExportable(*child->loadedVector())) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case VectorEncoding::Simple::ARRAY:
+      return isExportable(
+          *vector.asUnchecked<ArrayVector>()->elements()->loadedVector());
+    case VectorEncoding::Simple::MAP: {
+      auto map = vector.asUnchecked<MapVector>();
+      return isExportable(*map->mapKeys()->loadedVector()) &&
+          isExportable(*map->mapValues()->loadedVector());
+    }
+    case VectorEncoding::Simple::DICTIONARY:
+      return isExportable(*vector.valueVector()->loadedVector());
+    default:
+      return false;
+  }
+}
+
+// Returns the rows of 'column' in 'ranges', keeping constant and dictionary
+// encodings.
+VectorPtr selectRows(
+    const VectorPtr& column,
+    const folly::Range<const IndexRange*>& ranges,
+    vector_size_t numRows,
+    memory::MemoryPool* pool) {
+  if (column->isConstantEncoding()) {
+    return BaseVector::wrapInConstant(numRows, 0, column);
+  }
+  if (column->encoding() == VectorEncoding::Simple::DICTIONARY) {
+    auto indices = allocateIndices(numRows, pool);
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    auto sourceIndices = column->wrapInfo()->as<vector_size_t>();
+    BufferPtr nulls;
+    uint64_t* rawNulls = nullptr;
+    if (column->rawNulls()) {
+      nulls = allocateNulls(numRows, pool);
+      rawNulls = nulls->asMutable<uint64_t>();
+    }
+    vector_size_t row = 0;
+    for (const auto& range : ranges) {
+      for (auto i = range.begin; i < range.begin + range.size; ++i) {
+        rawIndices[row] = sourceIndices[i];
+        if (rawNulls && column->isNullAt(i)) {
+          bits::setNull(rawNulls, row);
+        }
+        ++row;
+      }
+    }
+    return BaseVector::wrapInDictionary(
+        std::move(nulls), std::move(indices), numRows, column->valueVector());
+  }
+  std::vector<BaseVector::CopyRange> copyRanges;
+  copyRanges.reserve(ranges.size());
+  vector_size_t targetIndex = 0;
+  for (const auto& range : ranges) {
+    copyRanges.push_back({range.begin, targetIndex, range.size});
+    targetIndex += range.size;
+  }
+  auto result = BaseVector::create(column->type(), numRows, pool);
+  result->copyRanges(column.get(), copyRanges);
+  return result;
+}
+
+class HeaderWriter {
+ public:
+  template <typename T>
+  void write(T value) {
+    header_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void write(std::string_view value) {
+    write<int32_t>(value.size());
+    header_.append(value.data(), value.size());
+  }
+
+  const std::string& header() const {
+    return header_;
+  }
+
+ private:
+  std::string header_;
+};
+
+void writeSchema(const ArrowSchema& schema, HeaderWriter& out) {
+  out.write(std::string_view(schema.format));
+  out.write(std::string_view(schema.name ? schema.name : ""));
+  out.write<int64_t>(schema.flags);
+  out.write<int32_t>(schema.n_children);
+  out.write<int8_t>(schema.dictionary != nullptr);
+  for (auto i = 0; i < schema.n_children; ++i) {
+    writeSchema(*schema.children[i], out);
+  }
+  if (schema.dictionary) {
+    writeSchema(*schema.dictionary, out);
+  }
+}
+
+struct BodyPiece {
+  const char* data;
+  int64_t size;
+};
+
+// Returns the sizes of the buffers of 'array', which has been exported from a
+// vector of 'type'.
+std::vector<int64_t> bufferSizes(const Type& type, const ArrowArray& array) {
+  std::vector<int64_t> sizes(array.n_buffers, 0);
+  if (array.n_buffers == 0) {
+    return sizes;
+  }
+  const auto length = array.length;
+  sizes[0] = bits::nbytes(length);
+  if (array.dictionary) {
+    VELOX_CHECK_EQ(array.n_buffers, 2);
+    sizes[1] = length * sizeof(vector_size_t);
+    return sizes;
+  }
+  switch (type.kind()) {
+    case TypeKind::ROW:
+      break;
+    case TypeKind::BOOLEAN:
+      VELOX_CHECK_EQ(array.n_buffers, 2);
+      sizes[1] = bits::nbytes(length);
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      VELOX_CHECK_EQ(array.n_buffers, 3);
+      sizes[1] = (length + 1) * sizeof(int32_t);
+      sizes[2] = static_cast<const int32_t*>(array.buffers[1])[length];
+      break;
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+      VELOX_CHECK_EQ(array.n_buffers, 2);
+      sizes[1] = (length + 1) * sizeof(int32_t);
+      break;
+    default:
+      VELOX_CHECK_EQ(array.n_buffers, 2);
+      sizes[1] = length * type.cppSizeInBytes();
+      break;
+  }
+  return sizes;
+}
+
+void writeArray(
+    const TypePtr& type,
+    const ArrowArray& array,
+    HeaderWriter& out,
+    std::vector<BodyPiece>& body) {
+  VELOX_CHECK_EQ(array.offset, 0);
+  out.write<int64_t>(array.length);
+  out.write<int64_t>(array.null_count);
+  out.write<int32_t>(array.n_buffers);
+  out.write<int32_t>(array.n_children);
+  out.write<int8_t>(array.dictionary != nullptr);
+  auto sizes = bufferSizes(*type, array);
+  for (auto i = 0; i < array.n_buffers; ++i) {
+    if (array.buffers[i] == nullptr) {
+      out.write<int64_t>(-1);
+      continue;
+    }
+    out.write<int64_t>(sizes[i]);
+    body.push_back({static_cast<const char*>(array.buffers[i]), sizes[i]});
+  }
+  if (array.dictionary) {
+    VELOX_CHECK_EQ(array.n_children, 0);
+    writeArray(type, *array.dictionary, out, body);
+    return;
+  }
+  switch (type->kind()) {
+    case TypeKind::ROW:
+      VELOX_CHECK_EQ(array.n_children, type->size());
+      for (auto i = 0; i < array.n_children; ++i) {
+        writeArray(type->childAt(i), *array.children[i], out, body);
+      }
+      break;
+    case TypeKind::ARRAY:
+      VELOX_CHECK_EQ(array.n_children, 1);
+      writeArray(type->childAt(0), *array.children[0], out, body);
+      break;
+    case TypeKind::MAP:
+      // The keys and values are children of a struct.
+      VELOX_CHECK_EQ(array.n_children, 1);
+      writeArray(
+          ROW({"key", "value"}, {type->childAt(0), type->childAt(1)}),
+          *array.children[0],
+          out,
+          body);
+      break;
+    default:
+      VELOX_CHECK_EQ(array.n_children, 0);
+      break;
+  }
+}
+
+class ArrowVectorSerializer : public VectorSerializer {
+ public:
+  explicit ArrowVectorSerializer(StreamArena* streamArena)
+      : pool_{streamArena->pool()} {}
+
+  void append(
+      const RowVectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges) override {
+    vector_size_t numRows = 0;
+    bool allRows = true;
+    for (const auto& range : ranges) {
+      allRows &= range.begin == numRows;
+      numRows += range.size;
+    }
+    if (numRows == 0) {
+      return;
+    }
+    if (allRows && numRows == vector->size()) {
+      batches_.push_back(vector);
+      return;
+    }
+    std::vector<VectorPtr> children;
+    children.reserve(vector->childrenSize());
+    for (const auto& child : vector->children()) {
+      children.push_back(selectRows(
+          BaseVector::loadedVectorShared(child), ranges, numRows, pool_));
+    }
+    batches_.push_back(std::make_shared<RowVector>(
+        pool_, vector->type(), nullptr, numRows, std::move(children)));
+  }
+
+  void flush(OutputStream* stream) override {
+    for (const auto& batch : batches_) {
+      writeBatch(*batch, stream);
+    }
+    batches_.clear();
+  }
+
+ private:
+  void writeBatch(const RowVector& batch, OutputStream* stream) {
+    HeaderWriter header;
+    std::vector<BodyPiece> body;
+    // The exported arrays reference the buffers in 'body' and are released
+    // after these are written.
+    std::vector<ArrowArray> arrays(batch.childrenSize());
+    SCOPE_EXIT {
+      for (auto& array : arrays) {
+        if (array.release) {
+          array.release(&array);
+        }
+      }
+    };
+    for (auto& array : arrays) {
+      array.release = nullptr;
+    }
+
+    header.write<int32_t>(batch.size());
+    header.write<int32_t>(batch.childrenSize());
+    for (auto i = 0; i < batch.childrenSize(); ++i) {
+      auto column = BaseVector::loadedVectorShared(batch.childAt(i));
+      const bool isConstant = column->isConstantEncoding();
+      if (isConstant) {
+        auto value = BaseVector::create(column->type(), 1, pool_);
+        value->copy(column.get(), 0, 0, 1);
+        column = std::move(value);
+      } else if (!isExportable(*column)) {
+        column = BaseVector::copy(*column);
+      }
+      header.write<int8_t>(isConstant ? kConstantColumn : kArrowColumn);
+
+      ArrowSchema schema;
+      exportToArrow(column, schema);
+      SCOPE_EXIT {
+        schema.release(&schema);
+      };
+      writeSchema(schema, header);
+
+      exportToArrow(column, arrays[i], pool_);
+      writeArray(column->type(), arrays[i], header, body);
+    }
+
+    int64_t bodySize = 0;
+    for (const auto& piece : body) {
+      bodySize += paddedSize(piece.size);
+    }
+    header.write<int64_t>(bodySize);
+    stream->write(header.header().data(), header.header().size());
+
+    static const char kPadding[kBufferAlignment] = {};
+    for (const auto& piece : body) {
+      stream->write(piece.data, piece.size);
+      stream->write(kPadding, paddedSize(piece.size) - piece.size);
+    }
+  }
+
+  memory::MemoryPool* const pool_;
+  std::vector<RowVectorPtr> batches_;
+};
+
+// Owns a deserialized ArrowSchema and its children. The root is released by
+// deleting the holder, the children are released with their root.
+struct ImportedSchema {
+  ArrowSchema schema;
+  std::string format;
+  std::string name;
+  std::vector<std::unique_ptr<ImportedSchema>> children;
+  std::vector<ArrowSchema*> childSchemas;
+  std::unique_ptr<ImportedSchema> dictionary;
+};
+
+// Owns a deserialized ArrowArray, its children and the body of the record
+// batch its buffers point to.
+struct ImportedArray {
+  ArrowArray array;
+  std::vector<int64_t> bufferOffsets;
+  std::vector<const void*> buffers;
+  std::vector<std::unique_ptr<ImportedArray>> children;
+  std::vector<ArrowArray*> childArrays;
+  std::unique_ptr<ImportedArray> dictionary;
+  BufferPtr body;
+};
+
+void releaseImportedSchema(ArrowSchema* schema) {
+  delete static_cast<ImportedSchema*>(schema->private_data);
+}
+
+void releaseImportedArray(ArrowArray* array) {
+  delete static_cast<ImportedArray*>(array->private_data);
+}
+
+template <typename T>
+void releaseChild(T* child) {
+  child->release = nullptr;
+}
+
+std::string readString(ByteStream* source) {
+  const auto size = source->read<int32_t>();
+  std::string result(size, '\0');
+  source->readBytes(result.data(), size);
+  return result;
+}
+
+std::unique_ptr<ImportedSchema> readSchema(ByteStream* source, bool isRoot) {
+  auto node = std::make_unique<ImportedSchema>();
+  node->format = readString(source);
+  node->name = readString(source);
+  auto& schema = node->schema;
+  schema.format = node->format.c_str();
+  schema.name = node->name.c_str();
+  schema.metadata = nullptr;
+  schema.flags = source->read<int64_t>();
+  schema.n_children = source->read<int32_t>();
+  const bool hasDictionary = source->read<int8_t>();
+  for (auto i = 0; i < schema.n_children; ++i) {
+    node->children.push_back(readSchema(source, false));
+    node->childSchemas.push_back(&node->children.back()->schema);
+  }
+  schema.children = node->childSchemas.data();
+  if (hasDictionary) {
+    node->dictionary = readSchema(source, false);
+  }
+  schema.dictionary = hasDictionary ? &node->dictionary->schema : nullptr;
+  schema.private_data = node.get();
+  schema.release = isRoot ? releaseImportedSchema : releaseChild<ArrowSchema>;
+  return node;
+}
+
+std::unique_ptr<ImportedArray>
+readArray(ByteStream* source, bool isRoot, int64_t& bodyOffset) {
+  auto node = std::make_unique<ImportedArray>();
+  auto& array = node->array;
+  array.length = source->read<int64_t>();
+  array.null_count = source->read<int64_t>();
+  array.offset = 0;
+  array.n_buffers = source->read<int32_t>();
+  array.n_children = source->read<int32_t>();
+  const bool hasDictionary = source->read<int8_t>();
+  for (auto i = 0; i < array.n_buffers; ++i) {
+    const auto size = source->read<int64_t>();
+    if (size < 0) {
+      node->bufferOffsets.push_back(-1);
+      continue;
+    }
+    node->bufferOffsets.push_back(bodyOffset);
+    bodyOffset += paddedSize(size);
+  }
+  for (auto i = 0; i < array.n_children; ++i) {
+    node->children.push_back(readArray(source, false, bodyOffset));
+    node->childArrays.push_back(&node->children.back()->array);
+  }
+  array.children = node->childArrays.data();
+  if (hasDictionary) {
+    node->dictionary = readArray(source, false, bodyOffset);
+  }
+  array.dictionary = hasDictionary ? &node->dictionary->array : nullptr;
+  array.private_data = node.get();
+  array.release = isRoot ? releaseImportedArray : releaseChild<ArrowArray>;
+  return node;
+}
+
+// Points the buffers of 'node' and its descendants into 'body'.
+void setBuffers(ImportedArray& node, const char* body) {
+  for (auto offset : node.bufferOffsets) {
+    node.buffers.push_back(offset < 0 ? nullptr : body + offset);
+  }
+  node.array.buffers = node.buffers.data();
+  for (auto& child : node.children) {
+    setBuffers(*child, body);
+  }
+  if (node.dictionary) {
+    setBuffers(*node.dictionary, body);
+  }
+}
+
+} // namespace
+
+void ArrowVectorSerde::estimateSerializedSize(
+    VectorPtr vector,
+    const folly::Range<const IndexRange*>& ranges,
+    vector_size_t** sizes) {
+  if (vector->size() == 0) {
+    return;
+  }
+  const auto rowSize = vector->estimateFlatSize() / vector->size();
+  for (auto i = 0; i < ranges.size(); ++i) {
+    *sizes[i] += rowSize * ranges[i].size;
+  }
+}
+
+std::unique_ptr<VectorSerializer> ArrowVectorSerde::createSerializer(
+    RowTypePtr /* type */,
+    int32_t /* numRows */,
+    StreamArena* streamArena,
+    const Options* /* options */) {
+  return std::make_unique<ArrowVectorSerializer>(streamArena);
+}
+
+void ArrowVectorSerde::deserialize(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    RowTypePtr type,
+    RowVectorPtr* result,
+    const Options* /* options */) {
+  const auto numRows = source->read<int32_t>();
+  const auto numColumns = source->read<int32_t>();
+  VELOX_CHECK_EQ(numColumns, type->size());
+
+  std::vector<int8_t> kinds;
+  std::vector<std::unique_ptr<ImportedSchema>> schemas;
+  std::vector<std::unique_ptr<ImportedArray>> arrays;
+  int64_t bodyOffset = 0;
+  for (auto i = 0; i < numColumns; ++i) {
+    kinds.push_back(source->read<int8_t>());
+    schemas.push_back(readSchema(source, true));
+    arrays.push_back(readArray(source, true, bodyOffset));
+  }
+  const auto bodySize = source->read<int64_t>();
+  VELOX_CHECK_EQ(bodySize, bodyOffset);
+  VELOX_CHECK_LE(bodySize, std::numeric_limits<int32_t>::max());
+  auto body = AlignedBuffer::allocate<char>(bodySize, pool);
+  source->readBytes(body->asMutable<char>(), bodySize);
+
+  std::vector<VectorPtr> children;
+  children.reserve(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    setBuffers(*arrays[i], body->as<char>());
+    arrays[i]->body = body;
+    // The imported vector owns the schema and the array from here on.
+    auto schema = schemas[i].release();
+    auto array = arrays[i].release();
+    auto column = importFromArrowAsOwner(schema->schema, array->array, pool);
+    if (kinds[i] == kConstantColumn) {
+      column = BaseVector::wrapInConstant(numRows, 0, std::move(column));
+    } else {
+      VELOX_CHECK_EQ(kinds[i], kArrowColumn);
+    }
+    children.push_back(std::move(column));
+  }
+  *result = std::make_shared<RowVector>(
+      pool, type, nullptr, numRows, std::move(children));
+}
+
+// static
+void ArrowVectorSerde::registerVectorSerde() {
+  velox::registerVectorSerde(std::make_unique<ArrowVectorSerde>());
+}
+
+} // namespace facebook::velox::serializer::arrow
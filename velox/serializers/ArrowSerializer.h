@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::serializer::arrow {
+
+/// Serializes vectors as a stream of record batches in the Arrow columnar
+/// format. Each appended batch is exported with the Arrow bridge and written
+/// as its schema followed by the Arrow buffers of its columns, so dictionary
+/// encoded columns stay dictionary encoded on the wire. Constant columns are
+/// written as a single value and are constant again after deserialization.
+///
+/// Each call to deserialize() reads one record batch. The body of the batch is
+/// read into a single buffer and the columns are imported with the Arrow
+/// bridge as views on that buffer, without further copies.
+class ArrowVectorSerde : public VectorSerde {
+ public:
+  ArrowVectorSerde() = default;
+
+  void estimateSerializedSize(
+      VectorPtr vector,
+      const folly::Range<const IndexRange*>& ranges,
+      vector_size_t** sizes) override;
+
+  std::unique_ptr<VectorSerializer> createSerializer(
+      RowTypePtr type,
+      int32_t numRows,
+      StreamArena* streamArena,
+      const Options* options) override;
+
+  void deserialize(
+      ByteStream* source,
+      velox::memory::MemoryPool* pool,
+      RowTypePtr type,
+      RowVectorPtr* result,
+      const Options* options) override;
+
+  static void registerVectorSerde();
+};
+} // namespace facebook::velox::serializer::arrow
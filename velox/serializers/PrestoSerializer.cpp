@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/serializers/PrestoSerializer.h"
+#include <folly/Random.h>
 #include "velox/common/base/Crc.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
@@ -29,6 +30,7 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -46,11 +48,12 @@ int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   bits::Crc32 crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -67,6 +70,39 @@ int64_t computeChecksum(
   return checksum;
 }
 
+// Computes the checksum of a page whose body is fully materialized in
+// 'payload'. Matches the byte order of the streaming variants above.
+int64_t computeChecksum(
+    const folly::IOBuf& payload,
+    int codecMarker,
+    int numRows,
+    int uncompressedSize) {
+  bits::Crc32 crc32;
+  for (auto range : payload) {
+    crc32.process_bytes(range.data(), range.size());
+  }
+  crc32.process_bytes(&codecMarker, 1);
+  crc32.process_bytes(&numRows, 4);
+  crc32.process_bytes(&uncompressedSize, 4);
+  return crc32.checksum();
+}
+
+// Reads 'size' bytes of 'source' into a possibly chained IOBuf.
+std::unique_ptr<folly::IOBuf> readIOBuf(ByteStream* source, int32_t size) {
+  std::unique_ptr<folly::IOBuf> result;
+  while (size > 0) {
+    auto data = source->nextView(size);
+    auto buf = folly::IOBuf::copyBuffer(data.data(), data.size());
+    if (result == nullptr) {
+      result = std::move(buf);
+    } else {
+      result->prependChain(std::move(buf));
+    }
+    size -= data.size();
+  }
+  return result;
+}
+
 char getCodecMarker() {
   char marker = 0;
   marker |= kCheckSumBitMask;
@@ -432,6 +468,26 @@ void readConstantVector(
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    bool useLosslessTimestamp) {
+  auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+
+  auto indices = allocateIndices(size, pool);
+  source->readBytes(
+      indices->asMutable<uint8_t>(), size * sizeof(vector_size_t));
+  // Skip the dictionary source id.
+  source->skip(3 * sizeof(int64_t));
+  *result = BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), size, std::move(children[0]));
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
@@ -704,8 +760,19 @@ void readColumns(
     if (encoding == kRLE) {
       readConstantVector(
           source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(
+          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
     } else {
       checkTypeEncoding(encoding, types[i]);
+      // A vector read from an RLE or DICTIONARY block of a previous page
+      // cannot be reused for a flat block.
+      auto& previous = (*result)[i];
+      if (previous &&
+          (previous->isConstantEncoding() ||
+           previous->encoding() == VectorEncoding::Simple::DICTIONARY)) {
+        previous.reset();
+      }
       auto it = readers.find(types[i]->kind());
       VELOX_CHECK(
           it != readers.end(),
@@ -738,6 +805,7 @@ class VectorStream {
       bool useLosslessTimestamp)
       : type_(type),
         useLosslessTimestamp_(useLosslessTimestamp),
+        streamArena_(streamArena),
         nulls_(streamArena, true, true),
         lengths_(streamArena),
         values_(streamArena) {
@@ -828,8 +896,27 @@ class VectorStream {
     return children_[index].get();
   }
 
+  // Adds the 'ranges' of 'vector' as a DICTIONARY or RLE block. This is done
+  // if 'this' is empty and 'vector' is a constant or a dictionary without
+  // nulls over at most as many values as there are rows, or if 'this'
+  // already holds the same constant or dictionary values. Otherwise the rows
+  // added so far are converted to the flat representation and false is
+  // returned. The caller is then expected to add 'ranges' with
+  // serializeColumn().
+  bool appendEncoded(
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges);
+
   // Writes out the accumulated contents. Does not change the state.
   void flush(OutputStream* out) {
+    if (encoding_ == VectorEncoding::Simple::DICTIONARY) {
+      flushDictionary(out);
+      return;
+    }
+    if (encoding_ == VectorEncoding::Simple::CONSTANT) {
+      flushRle(out);
+      return;
+    }
     out->write(reinterpret_cast<char*>(header_.buffer), header_.size);
     switch (type_->kind()) {
       case TypeKind::ROW:
@@ -908,11 +995,60 @@ class VectorStream {
   }
 
  private:
+  void appendIndices(
+      const BaseVector& vector,
+      const folly::Range<const IndexRange*>& ranges) {
+    auto rawIndices = vector.wrapInfo()->as<vector_size_t>();
+    for (const auto& range : ranges) {
+      indices_.insert(
+          indices_.end(),
+          rawIndices + range.begin,
+          rawIndices + range.begin + range.size);
+    }
+  }
+
+  // Adds the rows of the DICTIONARY or RLE block to the flat representation.
+  void flattenEncoded();
+
+  void flushDictionary(OutputStream* out) {
+    writeInt32(out, kDictionary.size());
+    out->write(kDictionary.data(), kDictionary.size());
+    writeInt32(out, indices_.size());
+    encodedValues_->flush(out);
+    out->write(
+        reinterpret_cast<const char*>(indices_.data()),
+        indices_.size() * sizeof(vector_size_t));
+    // Dictionary source id: two random longs and a sequence number.
+    writeInt64(out, dictionaryId_.first);
+    writeInt64(out, dictionaryId_.second);
+    writeInt64(out, 0);
+  }
+
+  void flushRle(OutputStream* out) {
+    writeInt32(out, kRLE.size());
+    out->write(kRLE.data(), kRLE.size());
+    writeInt32(out, rleCount_);
+    encodedValues_->flush(out);
+  }
+
   const TypePtr type_;
   /// Indicates whether to serialize timestamps with nanosecond precision.
   /// If false, they are serialized with millisecond precision which is
   /// compatible with presto.
   const bool useLosslessTimestamp_;
+  StreamArena* const streamArena_;
+  // DICTIONARY or CONSTANT if the rows are kept as a DICTIONARY or RLE block
+  // by appendEncoded(). FLAT otherwise.
+  VectorEncoding::Simple encoding_{VectorEncoding::Simple::FLAT};
+  // The dictionary values or the constant vector of the encoded block.
+  VectorPtr encodedBase_;
+  // The serialized dictionary values or constant value of the encoded block.
+  std::unique_ptr<VectorStream> encodedValues_;
+  // The dictionary indices of the rows of a DICTIONARY block.
+  std::vector<vector_size_t> indices_;
+  std::pair<int64_t, int64_t> dictionaryId_;
+  // The number of rows of an RLE block.
+  int32_t rleCount_{0};
   int32_t nonNullCount_{0};
   int32_t nullCount_{0};
   int32_t totalLength_{0};
@@ -1313,6 +1449,84 @@ void serializeColumn(
   }
 }
 
+bool VectorStream::appendEncoded(
+    const VectorPtr& vector,
+    const folly::Range<const IndexRange*>& ranges) {
+  const auto numRows = rangesTotalSize(ranges);
+  switch (encoding_) {
+    case VectorEncoding::Simple::DICTIONARY:
+      if (vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+          !vector->rawNulls() && vector->valueVector() == encodedBase_) {
+        appendIndices(*vector, ranges);
+        return true;
+      }
+      flattenEncoded();
+      return false;
+    case VectorEncoding::Simple::CONSTANT:
+      if (vector->isConstantEncoding() &&
+          vector->equalValueAt(encodedBase_.get(), 0, 0)) {
+        rleCount_ += numRows;
+        return true;
+      }
+      flattenEncoded();
+      return false;
+    default:
+      break;
+  }
+  if (nullCount_ + nonNullCount_ > 0) {
+    return false;
+  }
+
+  if (vector->isConstantEncoding()) {
+    encoding_ = VectorEncoding::Simple::CONSTANT;
+    encodedBase_ = vector;
+    rleCount_ = numRows;
+    encodedValues_ = std::make_unique<VectorStream>(
+        type_, streamArena_, 1, useLosslessTimestamp_);
+    IndexRange range{0, 1};
+    serializeColumn(
+        vector.get(), folly::Range(&range, 1), encodedValues_.get());
+    return true;
+  }
+
+  if (vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+      !vector->rawNulls() && vector->valueVector()->size() <= numRows) {
+    encoding_ = VectorEncoding::Simple::DICTIONARY;
+    encodedBase_ = vector->valueVector();
+    const auto numValues = encodedBase_->size();
+    encodedValues_ = std::make_unique<VectorStream>(
+        type_, streamArena_, numValues, useLosslessTimestamp_);
+    IndexRange range{0, numValues};
+    serializeColumn(
+        encodedBase_.get(), folly::Range(&range, 1), encodedValues_.get());
+    dictionaryId_ = {folly::Random::rand64(), folly::Random::rand64()};
+    appendIndices(*vector, ranges);
+    return true;
+  }
+  return false;
+}
+
+void VectorStream::flattenEncoded() {
+  const auto encoding = encoding_;
+  encoding_ = VectorEncoding::Simple::FLAT;
+  if (encoding == VectorEncoding::Simple::DICTIONARY) {
+    std::vector<IndexRange> ranges;
+    ranges.reserve(indices_.size());
+    for (auto index : indices_) {
+      ranges.push_back({index, 1});
+    }
+    serializeColumn(encodedBase_.get(), ranges, this);
+  } else {
+    auto constant = BaseVector::wrapInConstant(rleCount_, 0, encodedBase_);
+    IndexRange range{0, rleCount_};
+    serializeColumn(constant.get(), folly::Range(&range, 1), this);
+  }
+  encodedBase_.reset();
+  encodedValues_.reset();
+  indices_.clear();
+  rleCount_ = 0;
+}
+
 void expandRepeatedRanges(
     const BaseVector* vector,
     const vector_size_t* rawOffsets,
@@ -1583,7 +1797,17 @@ class PrestoVectorSerializer : public VectorSerializer {
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
       StreamArena* streamArena,
-      bool useLosslessTimestamp) {
+      bool useLosslessTimestamp,
+      common::CompressionKind compressionKind,
+      float minCompressionRatio,
+      bool preserveEncodings)
+      : streamArena_(streamArena),
+        codec_(
+            compressionKind == common::CompressionKind_NONE
+                ? nullptr
+                : common::compressionKindToCodec(compressionKind)),
+        minCompressionRatio_(minCompressionRatio),
+        preserveEncodings_(preserveEncodings) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
@@ -1600,7 +1824,13 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (newRows > 0) {
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
-        serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        const auto& child = vector->childAt(i);
+        if (preserveEncodings_ &&
+            streams_[i]->appendEncoded(
+                BaseVector::loadedVectorShared(child), ranges)) {
+          continue;
+        }
+        serializeColumn(child.get(), ranges, streams_[i].get());
       }
     }
   }
@@ -1615,14 +1845,40 @@ class PrestoVectorSerializer : public VectorSerializer {
       VELOX_CHECK(child->isConstantEncoding());
     }
 
-    std::vector<IndexRange> ranges{{0, 1}};
-    append(vector, folly::Range(ranges.data(), ranges.size()));
+    // The page is a single RLE block, the columns are written flat.
+    IndexRange range{0, 1};
+    for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+      serializeColumn(
+          vector->childAt(i).get(),
+          folly::Range(&range, 1),
+          streams_[i].get());
+    }
 
     flushInternal(vector->size(), true /*rle*/, out);
   }
 
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() override {
+    if (codec_ == nullptr) {
+      return {};
+    }
+    return {
+        {"compressionInputBytes",
+         RuntimeCounter(
+             compressionInputBytes_, RuntimeCounter::Unit::kBytes)},
+        {"compressedBytes",
+         RuntimeCounter(compressedBytes_, RuntimeCounter::Unit::kBytes)},
+        {"compressionSkippedBytes",
+         RuntimeCounter(
+             compressionSkippedBytes_, RuntimeCounter::Unit::kBytes)}};
+  }
+
   // Writes the contents to 'stream' in wire format
   void flushInternal(int32_t numRows, bool rle, OutputStream* out) {
+    if (codec_ != nullptr) {
+      flushCompressed(numRows, rle, out);
+      return;
+    }
+
     auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
     // Reset CRC computation
     if (listener) {
@@ -1653,19 +1909,7 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    writeInt32(out, streams_.size());
-
-    if (rle) {
-      // Write RLE encoding marker.
-      writeInt32(out, kRLE.size());
-      out->write(kRLE.data(), kRLE.size());
-      // Write number of RLE values.
-      writeInt32(out, numRows);
-    }
-
-    for (auto& stream : streams_) {
-      stream->flush(out);
-    }
+    flushBody(numRows, rle, out);
 
     // Pause CRC computation
     if (listener) {
@@ -1691,7 +1935,80 @@ class PrestoVectorSerializer : public VectorSerializer {
   static const int32_t kSizeInBytesOffset{4 + 1};
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
 
+  // Writes the number of columns, the optional RLE marker and the column
+  // streams. This is the part of the page covered by 'uncompressedSize'.
+  void flushBody(int32_t numRows, bool rle, OutputStream* out) {
+    writeInt32(out, streams_.size());
+
+    if (rle) {
+      // Write RLE encoding marker.
+      writeInt32(out, kRLE.size());
+      out->write(kRLE.data(), kRLE.size());
+      // Write number of RLE values.
+      writeInt32(out, numRows);
+    }
+
+    for (auto& stream : streams_) {
+      stream->flush(out);
+    }
+  }
+
+  // Serializes the page body into a temporary buffer and writes the header
+  // followed by the body compressed with 'codec_'. The checksum covers the
+  // bytes as they appear on the wire, i.e. the compressed body.
+  void flushCompressed(int32_t numRows, bool rle, OutputStream* out) {
+    IOBufOutputStream body(*streamArena_->pool());
+    flushBody(numRows, rle, &body);
+    auto uncompressed = body.getIOBuf();
+    const int32_t uncompressedSize = uncompressed->computeChainDataLength();
+    auto compressed = codec_->compress(uncompressed.get());
+    const auto compressedSize = compressed->computeChainDataLength();
+    const bool useCompressed =
+        compressedSize < uncompressedSize * minCompressionRatio_;
+    compressionInputBytes_ += uncompressedSize;
+    if (useCompressed) {
+      compressedBytes_ += compressedSize;
+    } else {
+      compressionSkippedBytes_ += uncompressedSize;
+    }
+    const auto& payload = useCompressed ? compressed : uncompressed;
+    const int32_t sizeInBytes = payload->computeChainDataLength();
+
+    auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
+    char codec = useCompressed ? kCompressedBitMask : 0;
+    int64_t crc = 0;
+    if (listener) {
+      // The checksum is computed from 'payload' directly so the listener does
+      // not need to see the bytes written below.
+      listener->reset();
+      listener->pause();
+      codec |= getCodecMarker();
+      crc = computeChecksum(*payload, codec, numRows, uncompressedSize);
+    }
+
+    writeInt32(out, numRows);
+    out->write(&codec, 1);
+    writeInt32(out, uncompressedSize);
+    writeInt32(out, sizeInBytes);
+    writeInt64(out, crc);
+    for (auto range : *payload) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
+  }
+
+  StreamArena* const streamArena_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  const float minCompressionRatio_;
+  const bool preserveEncodings_;
   int32_t numRows_{0};
+
+  // Bytes of uncompressed page bodies given to 'codec_'.
+  int64_t compressionInputBytes_{0};
+  // Bytes of compressed page bodies that were written compressed.
+  int64_t compressedBytes_{0};
+  // Bytes of uncompressed page bodies that were written uncompressed because
+  // they did not compress well enough.
+  int64_t compressionSkippedBytes_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
 };
 } // namespace
@@ -1711,8 +2028,23 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
   bool useLosslessTimestamp = options != nullptr
       ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
       : false;
+  const auto compressionKind = options != nullptr
+      ? static_cast<const PrestoOptions*>(options)->compressionKind
+      : common::CompressionKind_NONE;
+  const float minCompressionRatio = options != nullptr
+      ? static_cast<const PrestoOptions*>(options)->minCompressionRatio
+      : 1.0;
+  const bool preserveEncodings = options != nullptr
+      ? static_cast<const PrestoOptions*>(options)->preserveEncodings
+      : false;
   return std::make_unique<PrestoVectorSerializer>(
-      type, numRows, streamArena, useLosslessTimestamp);
+      type,
+      numRows,
+      streamArena,
+      useLosslessTimestamp,
+      compressionKind,
+      minCompressionRatio,
+      preserveEncodings);
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1745,25 +2077,45 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
-  // skip number of columns
-  source->skip(4);
-
   auto children = &(*result)->children();
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+  if (!isCompressedBitSet(pageCodecMarker)) {
+    // skip number of columns
+    source->skip(4);
+    readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+    return;
+  }
+
+  const auto compressionKind = options != nullptr
+      ? static_cast<const PrestoOptions*>(options)->compressionKind
+      : common::CompressionKind_NONE;
+  VELOX_CHECK_NE(
+      compressionKind,
+      common::CompressionKind_NONE,
+      "Received a compressed page but no compression codec is configured");
+  auto compressed = readIOBuf(source, sizeInBytes);
+  auto uncompressed = common::compressionKindToCodec(compressionKind)
+                          ->uncompress(compressed.get(), uncompressedSize);
+  auto range = uncompressed->coalesce();
+  ByteStream uncompressedSource;
+  uncompressedSource.setRange(
+      {const_cast<uint8_t*>(range.data()), (int32_t)range.size(), 0});
+  // skip number of columns
+  uncompressedSource.skip(4);
+  readColumns(
+      &uncompressedSource, pool, childTypes, children, useLosslessTimestamp);
 }
 
 // static
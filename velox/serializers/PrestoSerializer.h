@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "velox/common/base/Crc.h"
+#include "velox/common/compression/Compression.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::serializer::presto {
@@ -22,13 +23,37 @@ class PrestoVectorSerde : public VectorSerde {
  public:
   // Input options that the serializer recognizes.
   struct PrestoOptions : VectorSerde::Options {
-    explicit PrestoOptions(bool useLosslessTimestamp)
-        : useLosslessTimestamp(useLosslessTimestamp) {}
+    explicit PrestoOptions(
+        bool useLosslessTimestamp,
+        common::CompressionKind compressionKind = common::CompressionKind_NONE,
+        float minCompressionRatio = 1.0,
+        bool preserveEncodings = false)
+        : useLosslessTimestamp(useLosslessTimestamp),
+          compressionKind(compressionKind),
+          minCompressionRatio(minCompressionRatio),
+          preserveEncodings(preserveEncodings) {}
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
     // This option allows it to serialize with nanosecond precision and is
     // currently used for spilling. Is false by default.
     bool useLosslessTimestamp{false};
+
+    // Codec used to compress the body of each serialized page. The page
+    // header is left uncompressed and the compressed bit is set in the codec
+    // marker. A page whose compressed body is not smaller than
+    // 'minCompressionRatio' times the uncompressed one is written
+    // uncompressed. The reader must be configured with the same codec to read
+    // compressed pages.
+    common::CompressionKind compressionKind{common::CompressionKind_NONE};
+
+    float minCompressionRatio{1.0};
+
+    // Writes columns that are dictionary encoded or constant as DICTIONARY
+    // and RLE blocks instead of flattening them. A column keeps its
+    // encoding while all rows appended to it come from the same dictionary
+    // values or constant, and the dictionary is not larger than the number
+    // of rows in the first append. Nested columns are always flattened.
+    bool preserveEncodings{false};
   };
 
   void estimateSerializedSize(
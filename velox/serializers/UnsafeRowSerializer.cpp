@@ -38,42 +38,44 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
   void append(
       const RowVectorPtr& vector,
       const folly::Range<const IndexRange*>& ranges) override {
-    size_t totalSize = 0;
+    std::vector<vector_size_t> rows;
+    for (const auto& range : ranges) {
+      for (auto i = range.begin; i < range.begin + range.size; ++i) {
+        rows.push_back(i);
+      }
+    }
+    if (rows.empty()) {
+      return;
+    }
+
     row::UnsafeRowFast unsafeRow(vector);
+    const folly::Range<const vector_size_t*> rowRange(rows.data(), rows.size());
+    std::vector<vector_size_t> rowSizes(rows.size());
     if (auto fixedRowSize =
             row::UnsafeRowFast::fixedRowSize(asRowType(vector->type()))) {
-      for (const auto& range : ranges) {
-        totalSize += (fixedRowSize.value() + sizeof(TRowSize)) * range.size;
-      }
-
+      std::fill(rowSizes.begin(), rowSizes.end(), fixedRowSize.value());
     } else {
-      for (const auto& range : ranges) {
-        for (auto i = range.begin; i < range.begin + range.size; ++i) {
-          totalSize += unsafeRow.rowSize(i) + sizeof(TRowSize);
-        }
-      }
+      unsafeRow.serializedRowSizes(rowRange, rowSizes.data());
     }
 
-    if (totalSize == 0) {
-      return;
+    // Each row is preceded by its size.
+    std::vector<size_t> offsets(rows.size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      offsets[i] = totalSize + sizeof(TRowSize);
+      totalSize += sizeof(TRowSize) + rowSizes[i];
     }
 
     BufferPtr buffer = AlignedBuffer::allocate<char>(totalSize, pool_, 0);
     auto rawBuffer = buffer->asMutable<char>();
     buffers_.push_back(std::move(buffer));
 
-    size_t offset = 0;
-    for (auto& range : ranges) {
-      for (auto i = range.begin; i < range.begin + range.size; ++i) {
-        // Write row data.
-        TRowSize size =
-            unsafeRow.serialize(i, rawBuffer + offset + sizeof(TRowSize));
-
-        // Write raw size. Needs to be in big endian order.
-        *(TRowSize*)(rawBuffer + offset) = folly::Endian::big(size);
-        offset += sizeof(TRowSize) + size;
-      }
+    for (auto i = 0; i < rows.size(); ++i) {
+      // Write raw size. Needs to be in big endian order.
+      *(TRowSize*)(rawBuffer + offsets[i] - sizeof(TRowSize)) =
+          folly::Endian::big(static_cast<TRowSize>(rowSizes[i]));
     }
+    unsafeRow.serialize(rowRange, offsets.data(), rawBuffer);
   }
 
   void flush(OutputStream* stream) override {
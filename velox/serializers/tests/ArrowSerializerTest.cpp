@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/ArrowSerializer.h"
+#include <gtest/gtest.h>
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+class ArrowSerializerTest : public ::testing::Test, public VectorTestBase {
+ protected:
+  void SetUp() override {
+    serde_ = std::make_unique<serializer::arrow::ArrowVectorSerde>();
+  }
+
+  // Serializes the 'ranges' of each of 'batches' with one serializer.
+  std::string serialize(
+      const std::vector<RowVectorPtr>& batches,
+      const std::vector<IndexRange>& ranges = {}) {
+    auto arena = std::make_unique<StreamArena>(pool());
+    auto rowType = asRowType(batches[0]->type());
+    auto serializer = serde_->createSerializer(rowType, 0, arena.get(), {});
+    for (const auto& batch : batches) {
+      if (ranges.empty()) {
+        serializer->append(batch);
+      } else {
+        serializer->append(batch, folly::Range(ranges.data(), ranges.size()));
+      }
+    }
+    std::ostringstream output;
+    OStreamOutputStream out(&output);
+    serializer->flush(&out);
+    return output.str();
+  }
+
+  std::vector<RowVectorPtr> deserialize(
+      const RowTypePtr& rowType,
+      const std::string& input) {
+    ByteStream stream;
+    ByteRange range{
+        reinterpret_cast<uint8_t*>(const_cast<char*>(input.data())),
+        (int32_t)input.size(),
+        0};
+    stream.resetInput({range});
+    std::vector<RowVectorPtr> results;
+    while (!stream.atEnd()) {
+      RowVectorPtr result;
+      serde_->deserialize(&stream, pool(), rowType, &result, nullptr);
+      results.push_back(std::move(result));
+    }
+    return results;
+  }
+
+  RowVectorPtr roundTrip(const RowVectorPtr& vector) {
+    auto serialized = serialize({vector});
+    auto results = deserialize(asRowType(vector->type()), serialized);
+    EXPECT_EQ(results.size(), 1);
+    assertEqualVectors(vector, results[0]);
+    return results[0];
+  }
+
+  std::unique_ptr<VectorSerde> serde_;
+};
+
+TEST_F(ArrowSerializerTest, flat) {
+  auto data = makeRowVector({
+      makeFlatVector<bool>({true, false, true}),
+      makeNullableFlatVector<int32_t>({1, std::nullopt, 3}),
+      makeFlatVector<int64_t>({10, 20, 30}),
+      makeFlatVector<double>({1.5, 2.5, 3.5}),
+      makeNullableFlatVector<std::string>(
+          {"a", std::nullopt, "a longer string value"}),
+      makeArrayVector<int32_t>({{1, 2}, {}, {3}}),
+      makeMapVector<int32_t, int64_t>({{{1, 10}}, {{2, 20}, {3, 30}}, {}}),
+      makeRowVector({makeFlatVector<int16_t>({7, 8, 9})}),
+  });
+  roundTrip(data);
+
+  auto empty = makeRowVector({makeFlatVector<int64_t>({})});
+  ASSERT_TRUE(serialize({empty}).empty());
+}
+
+TEST_F(ArrowSerializerTest, encodings) {
+  auto base = makeFlatVector<std::string>({"apple", "banana", "cherry"});
+  auto data = makeRowVector({
+      wrapInDictionary(makeIndices({2, 0, 0, 1, 2}), 5, base),
+      makeConstant<int64_t>(11, 5),
+      makeNullConstant(TypeKind::VARCHAR, 5),
+      makeFlatVector<int32_t>({1, 2, 3, 4, 5}),
+  });
+  auto result = roundTrip(data);
+  EXPECT_EQ(
+      result->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  EXPECT_EQ(result->childAt(0)->valueVector()->size(), base->size());
+  EXPECT_TRUE(result->childAt(1)->isConstantEncoding());
+  EXPECT_TRUE(result->childAt(2)->isConstantEncoding());
+  EXPECT_EQ(result->childAt(3)->encoding(), VectorEncoding::Simple::FLAT);
+}
+
+TEST_F(ArrowSerializerTest, ranges) {
+  auto base = makeFlatVector<int32_t>({100, 200});
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(10, [](auto row) { return row; }),
+      wrapInDictionary(
+          makeIndices(10, [](auto row) { return row % 2; }), 10, base),
+      makeConstant<int32_t>(5, 10),
+  });
+  std::vector<IndexRange> ranges{{1, 2}, {6, 3}};
+  auto serialized = serialize({data, data}, ranges);
+  auto results = deserialize(asRowType(data->type()), serialized);
+
+  // Each appended batch is a record batch.
+  ASSERT_EQ(results.size(), 2);
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 6, 7, 8}),
+      makeFlatVector<int32_t>({200, 100, 100, 200, 100}),
+      makeConstant<int32_t>(5, 5),
+  });
+  for (const auto& result : results) {
+    assertEqualVectors(expected, result);
+    EXPECT_EQ(
+        result->childAt(1)->encoding(), VectorEncoding::Simple::DICTIONARY);
+    EXPECT_TRUE(result->childAt(2)->isConstantEncoding());
+  }
+}
@@ -320,6 +320,109 @@ TEST_F(PrestoSerializerTest, timestampWithNanosecondPrecision) {
   assertEqualVectors(deserialized, expectedOutputWithLostPrecision);
 }
 
+TEST_F(PrestoSerializerTest, compression) {
+  auto rowVector = makeTestVector(10'000);
+  auto rowType = asRowType(rowVector->type());
+
+  std::ostringstream uncompressedOut;
+  serialize(rowVector, &uncompressedOut, nullptr);
+  const auto uncompressedSize = uncompressedOut.str().size();
+  ASSERT_EQ(uncompressedOut.str()[sizeof(int32_t)] & 1, 0);
+
+  for (auto kind :
+       {common::CompressionKind_ZLIB,
+        common::CompressionKind_SNAPPY,
+        common::CompressionKind_ZSTD,
+        common::CompressionKind_LZ4,
+        common::CompressionKind_GZIP}) {
+    SCOPED_TRACE(common::compressionKindToString(kind));
+    const serializer::presto::PrestoVectorSerde::PrestoOptions options(
+        false, kind);
+    std::ostringstream out;
+    serialize(rowVector, &out, &options);
+    // The page is compressed: it is smaller than the uncompressed page and
+    // the compressed bit is set in the codec marker of its header, which
+    // follows the number of rows.
+    const auto page = out.str();
+    ASSERT_LT(page.size(), uncompressedSize);
+    ASSERT_EQ(page[sizeof(int32_t)] & 1, 1);
+
+    serialize(rowVector, &out, &options);
+    const auto bytes = out.str();
+    ASSERT_EQ(bytes.size(), 2 * page.size());
+
+    auto byteStream = toByteStream(bytes);
+    RowVectorPtr deserialized;
+    serde_->deserialize(
+        byteStream.get(), pool_.get(), rowType, &deserialized, &options);
+    assertEqualVectors(deserialized, rowVector);
+    ASSERT_FALSE(byteStream->atEnd());
+    serde_->deserialize(
+        byteStream.get(), pool_.get(), rowType, &deserialized, &options);
+    assertEqualVectors(deserialized, rowVector);
+    ASSERT_TRUE(byteStream->atEnd());
+
+    VELOX_ASSERT_THROW(
+        deserialize(rowType, bytes, nullptr),
+        "Received a compressed page but no compression codec is configured");
+  }
+
+  // A page that does not compress is written uncompressed and can be read
+  // without a codec.
+  const serializer::presto::PrestoVectorSerde::PrestoOptions options(
+      false, common::CompressionKind_ZSTD);
+  auto tiny = vectorMaker_->rowVector(
+      {vectorMaker_->flatVector<int64_t>({folly::Random::rand64()})});
+  std::ostringstream out;
+  serialize(tiny, &out, &options);
+  assertEqualVectors(
+      deserialize(asRowType(tiny->type()), out.str(), nullptr), tiny);
+}
+
+TEST_F(PrestoSerializerTest, minCompressionRatio) {
+  auto rowVector = makeTestVector(10'000);
+  auto rowType = asRowType(rowVector->type());
+
+  auto serializeWithStats = [&](float minCompressionRatio, std::string& bytes) {
+    const serializer::presto::PrestoVectorSerde::PrestoOptions options(
+        false, common::CompressionKind_LZ4, minCompressionRatio);
+    auto arena = std::make_unique<StreamArena>(pool_.get());
+    auto serializer = serde_->createSerializer(
+        rowType, rowVector->size(), arena.get(), &options);
+    serializer->append(rowVector);
+    std::ostringstream output;
+    serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream out(&output, &listener);
+    serializer->flush(&out);
+    bytes = output.str();
+    return serializer->runtimeStats();
+  };
+
+  std::string bytes;
+  auto stats = serializeWithStats(1.0, bytes);
+  ASSERT_GT(stats.at("compressionInputBytes").value, 0);
+  ASSERT_GT(stats.at("compressedBytes").value, 0);
+  ASSERT_LT(
+      stats.at("compressedBytes").value,
+      stats.at("compressionInputBytes").value);
+  ASSERT_EQ(stats.at("compressionSkippedBytes").value, 0);
+  ASSERT_EQ(stats.at("compressedBytes").unit, RuntimeCounter::Unit::kBytes);
+
+  // The page does not compress to 1% of its size and is written uncompressed.
+  stats = serializeWithStats(0.01, bytes);
+  ASSERT_EQ(stats.at("compressedBytes").value, 0);
+  ASSERT_EQ(
+      stats.at("compressionSkippedBytes").value,
+      stats.at("compressionInputBytes").value);
+  assertEqualVectors(deserialize(rowType, bytes, nullptr), rowVector);
+
+  // No stats are reported without compression.
+  auto arena = std::make_unique<StreamArena>(pool_.get());
+  auto serializer = serde_->createSerializer(
+      rowType, rowVector->size(), arena.get(), nullptr);
+  ASSERT_TRUE(serializer->runtimeStats().empty());
+}
+
 TEST_F(PrestoSerializerTest, longDecimal) {
   std::vector<int128_t> decimalValues(102);
   decimalValues[0] = DecimalUtil::kLongDecimalMin;
@@ -368,6 +471,70 @@ TEST_F(PrestoSerializerTest, rle) {
       MAP(VARCHAR(), INTEGER()), 17, pool_.get()));
 }
 
+TEST_F(PrestoSerializerTest, preserveEncodings) {
+  const serializer::presto::PrestoVectorSerde::PrestoOptions options(
+      false, common::CompressionKind_NONE, 1.0, true);
+  const vector_size_t size = 1'000;
+  auto makeDictionary = [&](const VectorPtr& base) {
+    BufferPtr indices =
+        AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < size; i++) {
+      rawIndices[i] = i % base->size();
+    }
+    return BaseVector::wrapInDictionary(nullptr, indices, size, base);
+  };
+  auto base = vectorMaker_->flatVector<std::string>(
+      {"a long string value", "another long string value", "third"});
+  auto data = vectorMaker_->rowVector({
+      makeDictionary(base),
+      BaseVector::createConstant(VARCHAR(), "constant", size, pool_.get()),
+      vectorMaker_->flatVector<int64_t>(size, [](auto row) { return row; }),
+  });
+  auto rowType = asRowType(data->type());
+
+  auto serializeBatches = [&](const std::vector<RowVectorPtr>& batches,
+                              const VectorSerde::Options* serdeOptions) {
+    auto arena = std::make_unique<StreamArena>(pool_.get());
+    auto serializer =
+        serde_->createSerializer(rowType, size, arena.get(), serdeOptions);
+    for (const auto& batch : batches) {
+      serializer->append(batch);
+    }
+    std::ostringstream output;
+    serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream out(&output, &listener);
+    serializer->flush(&out);
+    return output.str();
+  };
+
+  auto encoded = serializeBatches({data, data}, &options);
+  auto flat = serializeBatches({data, data}, nullptr);
+  ASSERT_LT(encoded.size(), flat.size() / 2);
+
+  auto result = deserialize(rowType, encoded, nullptr);
+  ASSERT_EQ(result->size(), 2 * size);
+  ASSERT_EQ(result->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  ASSERT_EQ(result->childAt(0)->valueVector()->size(), base->size());
+  ASSERT_TRUE(result->childAt(1)->isConstantEncoding());
+  ASSERT_EQ(result->childAt(2)->encoding(), VectorEncoding::Simple::FLAT);
+  assertEqualVectors(deserialize(rowType, flat, nullptr), result);
+
+  // A second dictionary and constant in the same page fall back to flat.
+  auto other = vectorMaker_->rowVector({
+      makeDictionary(vectorMaker_->flatVector<std::string>({"x", "y"})),
+      BaseVector::createConstant(VARCHAR(), "other", size, pool_.get()),
+      data->childAt(2),
+  });
+  encoded = serializeBatches({data, other}, &options);
+  result = deserialize(rowType, encoded, nullptr);
+  ASSERT_EQ(result->childAt(0)->encoding(), VectorEncoding::Simple::FLAT);
+  ASSERT_EQ(result->childAt(1)->encoding(), VectorEncoding::Simple::FLAT);
+  assertEqualVectors(
+      deserialize(rowType, serializeBatches({data, other}, nullptr), nullptr),
+      result);
+}
+
 TEST_F(PrestoSerializerTest, lazy) {
   constexpr int kSize = 1000;
   auto rowVector = makeTestVector(kSize);
@@ -166,20 +166,34 @@ SubstraitVeloxExprConverter::toVeloxExpr(
   switch (typeCase) {
     case ::substrait::Expression::FieldReference::ReferenceTypeCase::
         kDirectReference: {
-      const auto& directRef = substraitField.direct_reference();
-      int32_t colIdx = substraitParser_.parseReferenceSegment(directRef);
+      const auto* directRef = &substraitField.direct_reference();
+      int32_t colIdx = substraitParser_.parseReferenceSegment(*directRef);
       const auto& inputNames = inputType->names();
       const int64_t inputSize = inputNames.size();
-      if (colIdx <= inputSize) {
-        const auto& inputTypes = inputType->children();
-        // Convert type to row.
-        return std::make_shared<core::FieldAccessTypedExpr>(
-            inputTypes[colIdx],
-            std::make_shared<core::InputTypedExpr>(inputTypes[colIdx]),
-            inputNames[colIdx]);
-      } else {
+      if (colIdx >= inputSize) {
         VELOX_FAIL("Missing the column with id '{}' .", colIdx);
       }
+      const auto& inputTypes = inputType->children();
+      // Convert type to row.
+      auto field = std::make_shared<const core::FieldAccessTypedExpr>(
+          inputTypes[colIdx],
+          std::make_shared<core::InputTypedExpr>(inputTypes[colIdx]),
+          inputNames[colIdx]);
+      // A child segment references a field of the struct 'field', e.g. a.b.
+      while (directRef->has_struct_field() &&
+             directRef->struct_field().has_child()) {
+        directRef = &directRef->struct_field().child();
+        VELOX_CHECK(
+            field->type()->isRow(),
+            "Nested field reference into non-struct '{}'.",
+            field->name());
+        const auto& rowType = field->type()->asRow();
+        auto childIdx = substraitParser_.parseReferenceSegment(*directRef);
+        VELOX_CHECK_LT(childIdx, rowType.size());
+        field = std::make_shared<const core::FieldAccessTypedExpr>(
+            rowType.childAt(childIdx), field, rowType.nameOf(childIdx));
+      }
+      return field;
     }
     default:
       VELOX_NYI(
@@ -353,12 +367,36 @@ core::TypedExprPtr SubstraitVeloxExprConverter::toVeloxExpr(
       return toVeloxExpr(substraitExpr.cast(), inputType);
     case ::substrait::Expression::RexTypeCase::kIfThen:
       return toVeloxExpr(substraitExpr.if_then(), inputType);
+    case ::substrait::Expression::RexTypeCase::kSingularOrList:
+      return toVeloxExpr(substraitExpr.singular_or_list(), inputType);
     default:
       VELOX_NYI(
           "Substrait conversion not supported for Expression '{}'", typeCase);
   }
 }
 
+core::TypedExprPtr SubstraitVeloxExprConverter::toVeloxExpr(
+    const ::substrait::Expression::SingularOrList& singularOrList,
+    const RowTypePtr& inputType) {
+  VELOX_CHECK_GT(
+      singularOrList.options_size(), 0, "SingularOrList needs options.");
+  // The options become a constant array, which is what 'in' expects.
+  ::substrait::Expression::Literal listLiteral;
+  for (const auto& option : singularOrList.options()) {
+    VELOX_CHECK(
+        option.has_literal(),
+        "Only literal options are supported in SingularOrList.");
+    *listLiteral.mutable_list()->add_values() = option.literal();
+  }
+  auto options =
+      BaseVector::wrapInConstant(1, 0, literalsToArrayVector(listLiteral));
+  std::vector<core::TypedExprPtr> params{
+      toVeloxExpr(singularOrList.value(), inputType),
+      std::make_shared<const core::ConstantTypedExpr>(options)};
+  return std::make_shared<const core::CallTypedExpr>(
+      BOOLEAN(), std::move(params), "in");
+}
+
 core::TypedExprPtr SubstraitVeloxExprConverter::toVeloxExpr(
     const ::substrait::Expression_IfThen& substraitIfThen,
     const RowTypePtr& inputType) {
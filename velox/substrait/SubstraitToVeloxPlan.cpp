@@ -15,12 +15,95 @@
  */
 
 #include "velox/substrait/SubstraitToVeloxPlan.h"
+#include "velox/expression/Expr.h"
+#include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/substrait/TypeUtils.h"
 #include "velox/substrait/VariantToVectorConverter.h"
 #include "velox/type/Type.h"
 
 namespace facebook::velox::substrait {
 namespace {
+// Adds the conjuncts of 'expr' to 'conjuncts'.
+void flattenConjuncts(
+    const core::TypedExprPtr& expr,
+    std::vector<core::TypedExprPtr>& conjuncts) {
+  auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(expr);
+  if (call != nullptr && call->name() == "and") {
+    for (const auto& input : call->inputs()) {
+      flattenConjuncts(input, conjuncts);
+    }
+    return;
+  }
+  conjuncts.push_back(expr);
+}
+
+// Returns the filter on 'subfield' equivalent to 'expr' or nullptr if 'expr'
+// can't be pushed down. An OR is pushed down if all its terms are filters on
+// the same subfield. Unlike exec::toSubfieldFilter, this does not throw for
+// unsupported expressions, which are common in Substrait plans.
+std::unique_ptr<common::Filter> toSubfieldFilter(
+    const core::TypedExprPtr& expr,
+    common::Subfield& subfield,
+    core::ExpressionEvaluator* evaluator) {
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (call == nullptr) {
+    return nullptr;
+  }
+  if (call->name() == "or") {
+    std::unique_ptr<common::Filter> filter;
+    for (const auto& input : call->inputs()) {
+      common::Subfield inputSubfield;
+      auto inputFilter = toSubfieldFilter(input, inputSubfield, evaluator);
+      if (inputFilter == nullptr) {
+        return nullptr;
+      }
+      if (filter == nullptr) {
+        subfield = std::move(inputSubfield);
+        filter = std::move(inputFilter);
+      } else if (inputSubfield == subfield) {
+        filter = exec::makeOrFilter(std::move(filter), std::move(inputFilter));
+      } else {
+        return nullptr;
+      }
+    }
+    return filter;
+  }
+  if (call->name() == "is_not_null") {
+    core::CallTypedExpr isNull(BOOLEAN(), call->inputs(), "is_null");
+    return exec::leafCallToSubfieldFilter(isNull, subfield, evaluator, true);
+  }
+  if (call->name() == "not") {
+    auto* inner =
+        dynamic_cast<const core::CallTypedExpr*>(call->inputs()[0].get());
+    if (inner == nullptr) {
+      return nullptr;
+    }
+    return exec::leafCallToSubfieldFilter(*inner, subfield, evaluator, true);
+  }
+  return exec::leafCallToSubfieldFilter(*call, subfield, evaluator);
+}
+
+// The names of a Substrait NamedStruct are listed depth first and include
+// the names of the fields of nested structs. Returns 'type' with the names
+// of its struct fields set from 'names' starting at 'nameIdx', so that
+// filters on nested fields reference the field names of the file.
+TypePtr withFieldNames(
+    const TypePtr& type,
+    const ::google::protobuf::RepeatedPtrField<std::string>& names,
+    int32_t& nameIdx) {
+  if (!type->isRow()) {
+    return type;
+  }
+  std::vector<std::string> childNames;
+  std::vector<TypePtr> childTypes;
+  for (const auto& child : type->asRow().children()) {
+    VELOX_CHECK_LT(nameIdx, names.size());
+    childNames.push_back(names.Get(nameIdx++));
+    childTypes.push_back(withFieldNames(child, names, nameIdx));
+  }
+  return ROW(std::move(childNames), std::move(childTypes));
+}
+
 core::AggregationNode::Step toAggregationStep(
     const ::substrait::AggregateRel& sAgg) {
   if (sAgg.measures().size() == 0) {
@@ -365,14 +448,15 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
   std::vector<TypePtr> veloxTypeList;
   if (readRel.has_base_schema()) {
     const auto& baseSchema = readRel.base_schema();
-    colNameList.reserve(baseSchema.names().size());
-    for (const auto& name : baseSchema.names()) {
-      colNameList.emplace_back(name);
-    }
     auto substraitTypeList = substraitParser_->parseNamedStruct(baseSchema);
+    colNameList.reserve(substraitTypeList.size());
     veloxTypeList.reserve(substraitTypeList.size());
+    int32_t nameIdx = 0;
     for (const auto& substraitType : substraitTypeList) {
-      veloxTypeList.emplace_back(toVeloxType(substraitType->type));
+      VELOX_CHECK_LT(nameIdx, baseSchema.names_size());
+      colNameList.emplace_back(baseSchema.names(nameIdx++));
+      veloxTypeList.emplace_back(withFieldNames(
+          toVeloxType(substraitType->type), baseSchema.names(), nameIdx));
     }
   }
 
@@ -417,14 +501,15 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
         connector::hive::SubfieldFilters{},
         nullptr);
   } else {
-    connector::hive::SubfieldFilters filters =
-        toVeloxFilter(colNameList, veloxTypeList, readRel.filter());
+    core::TypedExprPtr remainingFilter;
+    connector::hive::SubfieldFilters filters = toVeloxFilter(
+        colNameList, veloxTypeList, readRel.filter(), remainingFilter);
     tableHandle = std::make_shared<connector::hive::HiveTableHandle>(
         kHiveConnectorId,
         "hive_table",
         filterPushdownEnabled,
         std::move(filters),
-        nullptr);
+        remainingFilter);
   }
 
   // Get assignments and out names.
@@ -583,173 +668,54 @@ std::string SubstraitVeloxPlanConverter::nextPlanNodeId() {
   return id;
 }
 
-// This class contains the needed infos for Filter Pushdown.
-// TODO: Support different types here.
-class FilterInfo {
- public:
-  // Used to set the left bound.
-  void setLeft(double left, bool isExclusive) {
-    left_ = left;
-    leftExclusive_ = isExclusive;
-    if (!isInitialized_) {
-      isInitialized_ = true;
-    }
-  }
-
-  // Used to set the right bound.
-  void setRight(double right, bool isExclusive) {
-    right_ = right;
-    rightExclusive_ = isExclusive;
-    if (!isInitialized_) {
-      isInitialized_ = true;
-    }
-  }
-
-  // Will fordis Null value if called once.
-  void forbidsNull() {
-    nullAllowed_ = false;
-    if (!isInitialized_) {
-      isInitialized_ = true;
-    }
-  }
-
-  // Return the initialization status.
-  bool isInitialized() {
-    return isInitialized_ ? true : false;
-  }
-
-  // The left bound.
-  std::optional<double> left_ = std::nullopt;
-  // The right bound.
-  std::optional<double> right_ = std::nullopt;
-  // The Null allowing.
-  bool nullAllowed_ = true;
-  // If true, left bound will be exclusive.
-  bool leftExclusive_ = false;
-  // If true, right bound will be exclusive.
-  bool rightExclusive_ = false;
-
- private:
-  bool isInitialized_ = false;
-};
-
 connector::hive::SubfieldFilters SubstraitVeloxPlanConverter::toVeloxFilter(
     const std::vector<std::string>& inputNameList,
     const std::vector<TypePtr>& inputTypeList,
-    const ::substrait::Expression& substraitFilter) {
+    const ::substrait::Expression& substraitFilter,
+    core::TypedExprPtr& remainingFilter) {
+  // The fields of the filter are named after the file columns, which are
+  // the names of the subfield filters and of the remaining filter.
+  auto inputType = ROW(
+      std::vector<std::string>(inputNameList),
+      std::vector<TypePtr>(inputTypeList));
+  std::vector<core::TypedExprPtr> conjuncts;
+  flattenConjuncts(
+      exprConverter_->toVeloxExpr(substraitFilter, inputType), conjuncts);
+
+  core::QueryCtx queryCtx;
+  exec::SimpleExpressionEvaluator evaluator(&queryCtx, pool_);
   connector::hive::SubfieldFilters filters;
-  // A map between the column index and the FilterInfo for that column.
-  std::unordered_map<int, std::shared_ptr<FilterInfo>> colInfoMap;
-  for (int idx = 0; idx < inputNameList.size(); idx++) {
-    colInfoMap[idx] = std::make_shared<FilterInfo>();
-  }
-
-  std::vector<::substrait::Expression_ScalarFunction> scalarFunctions;
-  flattenConditions(substraitFilter, scalarFunctions);
-  // Construct the FilterInfo for the related column.
-  for (const auto& scalarFunction : scalarFunctions) {
-    auto filterNameSpec = substraitParser_->findFunctionSpec(
-        functionMap_, scalarFunction.function_reference());
-    auto filterName = getNameBeforeDelimiter(filterNameSpec, ":");
-    int32_t colIdx;
-    // TODO: Add different types' support here.
-    double val;
-    for (auto& arg : scalarFunction.arguments()) {
-      auto argExpr = arg.value();
-      auto typeCase = argExpr.rex_type_case();
-      switch (typeCase) {
-        case ::substrait::Expression::RexTypeCase::kSelection: {
-          auto sel = argExpr.selection();
-          // TODO: Only direct reference is considered here.
-          auto dRef = sel.direct_reference();
-          colIdx = substraitParser_->parseReferenceSegment(dRef);
-          break;
-        }
-        case ::substrait::Expression::RexTypeCase::kLiteral: {
-          auto sLit = argExpr.literal();
-          // TODO: Only double is considered here.
-          val = sLit.fp64();
-          break;
-        }
-        default:
-          VELOX_NYI(
-              "Substrait conversion not supported for arg type '{}'", typeCase);
-      }
+  std::vector<core::TypedExprPtr> remainingConjuncts;
+  for (const auto& conjunct : conjuncts) {
+    common::Subfield subfield;
+    auto filter = toSubfieldFilter(conjunct, subfield, &evaluator);
+    if (filter == nullptr) {
+      remainingConjuncts.push_back(conjunct);
+      continue;
     }
-    if (filterName == "is_not_null") {
-      colInfoMap[colIdx]->forbidsNull();
-    } else if (filterName == "gte") {
-      colInfoMap[colIdx]->setLeft(val, false);
-    } else if (filterName == "gt") {
-      colInfoMap[colIdx]->setLeft(val, true);
-    } else if (filterName == "lte") {
-      colInfoMap[colIdx]->setRight(val, false);
-    } else if (filterName == "lt") {
-      colInfoMap[colIdx]->setRight(val, true);
-    } else {
-      VELOX_NYI(
-          "Substrait conversion not supported for filter name '{}'",
-          filterName);
+    auto it = filters.find(subfield);
+    if (it == filters.end()) {
+      filters[std::move(subfield)] = std::move(filter);
+      continue;
     }
-  }
-
-  // Construct the Filters.
-  for (int idx = 0; idx < inputNameList.size(); idx++) {
-    auto filterInfo = colInfoMap[idx];
-    double leftBound;
-    double rightBound;
-    bool leftUnbounded = true;
-    bool rightUnbounded = true;
-    bool leftExclusive = false;
-    bool rightExclusive = false;
-    if (filterInfo->isInitialized()) {
-      if (filterInfo->left_) {
-        leftUnbounded = false;
-        leftBound = filterInfo->left_.value();
-        leftExclusive = filterInfo->leftExclusive_;
-      }
-      if (filterInfo->right_) {
-        rightUnbounded = false;
-        rightBound = filterInfo->right_.value();
-        rightExclusive = filterInfo->rightExclusive_;
-      }
-      bool nullAllowed = filterInfo->nullAllowed_;
-      filters[common::Subfield(inputNameList[idx])] =
-          std::make_unique<common::DoubleRange>(
-              leftBound,
-              leftUnbounded,
-              leftExclusive,
-              rightBound,
-              rightUnbounded,
-              rightExclusive,
-              nullAllowed);
+    // Not all pairs of filters can be merged, e.g. a range with an IN list
+    // of another type. These stay in the remaining filter.
+    try {
+      it->second = it->second->mergeWith(filter.get());
+    } catch (const VeloxException&) {
+      remainingConjuncts.push_back(conjunct);
     }
   }
-  return filters;
-}
 
-void SubstraitVeloxPlanConverter::flattenConditions(
-    const ::substrait::Expression& substraitFilter,
-    std::vector<::substrait::Expression_ScalarFunction>& scalarFunctions) {
-  auto typeCase = substraitFilter.rex_type_case();
-  switch (typeCase) {
-    case ::substrait::Expression::RexTypeCase::kScalarFunction: {
-      auto sFunc = substraitFilter.scalar_function();
-      auto filterNameSpec = substraitParser_->findFunctionSpec(
-          functionMap_, sFunc.function_reference());
-      // TODO: Only and relation is supported here.
-      if (getNameBeforeDelimiter(filterNameSpec, ":") == "and") {
-        for (const auto& sCondition : sFunc.arguments()) {
-          flattenConditions(sCondition.value(), scalarFunctions);
-        }
-      } else {
-        scalarFunctions.emplace_back(sFunc);
-      }
-      break;
-    }
-    default:
-      VELOX_NYI("GetFlatConditions not supported for type '{}'", typeCase);
+  if (remainingConjuncts.empty()) {
+    remainingFilter = nullptr;
+  } else if (remainingConjuncts.size() == 1) {
+    remainingFilter = std::move(remainingConjuncts[0]);
+  } else {
+    remainingFilter = std::make_shared<const core::CallTypedExpr>(
+        BOOLEAN(), std::move(remainingConjuncts), "and");
   }
+  return filters;
 }
 
 void SubstraitVeloxPlanConverter::constructFunctionMap(
@@ -122,19 +122,16 @@ class SubstraitVeloxPlanConverter {
   std::string nextPlanNodeId();
 
   /// Used to convert Substrait Filter into Velox SubfieldFilters which will
-  /// be used in TableScan.
+  /// be used in TableScan. Each conjunct of the filter is pushed down as a
+  /// subfield filter if ExprToSubfieldFilter supports it, which covers
+  /// comparisons, ranges, IN lists, ORs on one column and nested fields.
+  /// The other conjuncts are returned in 'remainingFilter', which is nullptr
+  /// if all are pushed down.
   connector::hive::SubfieldFilters toVeloxFilter(
       const std::vector<std::string>& inputNameList,
       const std::vector<TypePtr>& inputTypeList,
-      const ::substrait::Expression& substraitFilter);
-
-  /// Multiple conditions are connected to a binary tree structure with
-  /// the relation key words, including AND, OR, and etc. Currently, only
-  /// AND is supported. This function is used to extract all the Substrait
-  /// conditions in the binary tree structure into a vector.
-  void flattenConditions(
       const ::substrait::Expression& substraitFilter,
-      std::vector<::substrait::Expression_ScalarFunction>& scalarFunctions);
+      core::TypedExprPtr& remainingFilter);
 
   /// The Substrait parser used to convert Substrait representations into
   /// recognizable representations.
@@ -286,3 +286,111 @@ TEST_F(Substrait2VeloxPlanConversionTest, q6) {
       .splits(makeSplits(planConverter, planNode))
       .assertResults(expectedResult);
 }
+
+// Converts a read of (a BIGINT, b BIGINT, s ROW(x BIGINT)) with the filter
+//
+//  (a < 10 OR a > 100) AND b IN (1, 2, 3) AND s.x > 5 AND (a > 1 OR b > 1)
+//
+// The first three conjuncts become subfield filters. The last one is on two
+// columns and stays in the remaining filter.
+TEST_F(Substrait2VeloxPlanConversionTest, filterPushdown) {
+  enum Function : uint32_t { kAnd = 1, kOr, kLt, kGt };
+  ::substrait::Plan substraitPlan;
+  for (const auto& [anchor, name] :
+       std::vector<std::pair<uint32_t, std::string>>{
+           {kAnd, "and:bool_bool"},
+           {kOr, "or:bool_bool"},
+           {kLt, "lt:i64_i64"},
+           {kGt, "gt:i64_i64"}}) {
+    auto* function =
+        substraitPlan.add_extensions()->mutable_extension_function();
+    function->set_function_anchor(anchor);
+    function->set_name(name);
+  }
+
+  auto field = [](int32_t index, std::optional<int32_t> child = {}) {
+    ::substrait::Expression expr;
+    auto* structField = expr.mutable_selection()
+                            ->mutable_direct_reference()
+                            ->mutable_struct_field();
+    structField->set_field(index);
+    if (child.has_value()) {
+      structField->mutable_child()->mutable_struct_field()->set_field(*child);
+    }
+    return expr;
+  };
+  auto literal = [](int64_t value) {
+    ::substrait::Expression expr;
+    expr.mutable_literal()->set_i64(value);
+    return expr;
+  };
+  auto call = [](uint32_t function,
+                 const std::vector<::substrait::Expression>& args) {
+    ::substrait::Expression expr;
+    auto* scalarFunction = expr.mutable_scalar_function();
+    scalarFunction->set_function_reference(function);
+    for (const auto& arg : args) {
+      *scalarFunction->add_arguments()->mutable_value() = arg;
+    }
+    scalarFunction->mutable_output_type()->mutable_bool_();
+    return expr;
+  };
+  ::substrait::Expression inList;
+  *inList.mutable_singular_or_list()->mutable_value() = field(1);
+  for (int64_t value : {1, 2, 3}) {
+    *inList.mutable_singular_or_list()->add_options() = literal(value);
+  }
+
+  auto* readRel = substraitPlan.add_relations()->mutable_rel()->mutable_read();
+  auto* baseSchema = readRel->mutable_base_schema();
+  for (const auto* name : {"a", "b", "s", "x"}) {
+    baseSchema->add_names(name);
+  }
+  auto* types = baseSchema->mutable_struct_()->mutable_types();
+  types->Add()->mutable_i64();
+  types->Add()->mutable_i64();
+  types->Add()->mutable_struct_()->add_types()->mutable_i64();
+  *readRel->mutable_filter() = call(
+      kAnd,
+      {call(
+           kOr,
+           {call(kLt, {field(0), literal(10)}),
+            call(kGt, {field(0), literal(100)})}),
+       call(
+           kAnd,
+           {inList,
+            call(kGt, {field(2, 0), literal(5)}),
+            call(
+                kOr,
+                {call(kGt, {field(0), literal(1)}),
+                 call(kGt, {field(1), literal(1)})})})});
+
+  facebook::velox::substrait::SubstraitVeloxPlanConverter planConverter(
+      pool_.get());
+  auto planNode = planConverter.toVeloxPlan(substraitPlan);
+  auto scanNode =
+      std::dynamic_pointer_cast<const core::TableScanNode>(planNode);
+  ASSERT_NE(scanNode, nullptr);
+  auto tableHandle =
+      std::dynamic_pointer_cast<const HiveTableHandle>(scanNode->tableHandle());
+  ASSERT_NE(tableHandle, nullptr);
+
+  const auto& filters = tableHandle->subfieldFilters();
+  ASSERT_EQ(filters.size(), 3);
+  const auto& a = filters.at(common::Subfield("a"));
+  EXPECT_TRUE(a->testInt64(5));
+  EXPECT_FALSE(a->testInt64(50));
+  EXPECT_TRUE(a->testInt64(500));
+  const auto& b = filters.at(common::Subfield("b"));
+  EXPECT_TRUE(b->testInt64(2));
+  EXPECT_FALSE(b->testInt64(4));
+  const auto& x = filters.at(common::Subfield("s.x"));
+  EXPECT_FALSE(x->testInt64(5));
+  EXPECT_TRUE(x->testInt64(6));
+
+  ASSERT_NE(tableHandle->remainingFilter(), nullptr);
+  auto remaining = std::dynamic_pointer_cast<const core::CallTypedExpr>(
+      tableHandle->remainingFilter());
+  ASSERT_NE(remaining, nullptr);
+  EXPECT_EQ(remaining->name(), "or");
+}
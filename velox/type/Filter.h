@@ -16,6 +16,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 #include <sstream>
@@ -24,7 +25,9 @@
 
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
+#include <folly/hash/Hash.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/serialization/Serializable.h"
@@ -55,6 +58,7 @@ enum class FilterKind {
   kBigintMultiRange,
   kMultiRange,
   kHugeintRange,
+  kBigintValuesUsingBloomFilter,
 };
 
 class Filter;
@@ -527,6 +531,26 @@ class IsNotNull final : public Filter {
     return true;
   }
 
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t>) const final {
+    return xsimd::batch_bool<int64_t>(true);
+  }
+
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t>) const final {
+    return xsimd::batch_bool<int32_t>(true);
+  }
+
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t>) const final {
+    return xsimd::batch_bool<int16_t>(true);
+  }
+
+  xsimd::batch_bool<double> testValues(xsimd::batch<double>) const final {
+    return xsimd::batch_bool<double>(true);
+  }
+
+  xsimd::batch_bool<float> testValues(xsimd::batch<float>) const final {
+    return xsimd::batch_bool<float>(true);
+  }
+
   bool testBool(bool /* unused */) const final {
     return true;
   }
@@ -973,6 +997,12 @@ class BigintValuesUsingBitmask final : public Filter {
 
   bool testInt64(int64_t value) const final;
 
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t>) const final;
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t>) const final;
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t> x) const final {
+    return Filter::testValues(x);
+  }
+
   bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
 
   std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
@@ -988,6 +1018,89 @@ class BigintValuesUsingBitmask final : public Filter {
   const int64_t max_;
 };
 
+/// Approximate IN-list filter for integral data types. Implemented as a Bloom
+/// filter over folly::hasher<int64_t> of the values. Passes all values in the
+/// list and a small fraction of other values between 'min' and 'max'. Used
+/// for dynamic filters from hash join build sides with too many distinct keys
+/// for an exact IN-list.
+class BigintValuesUsingBloomFilter final : public Filter {
+ public:
+  /// @param min Minimum value.
+  /// @param max Maximum value.
+  /// @param bloomFilter Bloom filter of the hashes of the values that pass.
+  /// Shared between copies of the filter and must not change after creation.
+  /// @param nullAllowed Null values are passing the filter if true.
+  BigintValuesUsingBloomFilter(
+      int64_t min,
+      int64_t max,
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(min),
+        max_(max),
+        bloomFilter_(std::move(bloomFilter)) {
+    VELOX_CHECK_LE(min_, max_);
+    VELOX_CHECK(bloomFilter_->isSet());
+  }
+
+  BigintValuesUsingBloomFilter(
+      const BigintValuesUsingBloomFilter& other,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(other.min_),
+        max_(other.max_),
+        bloomFilter_(other.bloomFilter_) {}
+
+  folly::dynamic serialize() const override;
+
+  static FilterPtr create(const folly::dynamic& obj);
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    if (nullAllowed) {
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          *this, nullAllowed.value());
+    } else {
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this);
+    }
+  }
+
+  bool testInt64(int64_t value) const final {
+    return value >= min_ && value <= max_ &&
+        bloomFilter_->mayContain(folly::hasher<int64_t>()(value));
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
+
+  /// Merging with an exact integer filter keeps the exact filter, narrowed
+  /// by the values or the range of 'this' where that is cheap. Bloom filters
+  /// cannot be intersected, so merging two of them keeps 'this'.
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  int64_t min() const {
+    return min_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BigintValuesUsingBloomFilter: [{}, {}] {}",
+        min_,
+        max_,
+        nullAllowed_ ? "with nulls" : "no nulls");
+  }
+
+  bool testingEquals(const Filter& other) const final;
+
+ private:
+  const int64_t min_;
+  const int64_t max_;
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+};
+
 // NOT IN-list filter for integral data types. Implemented as a hash table. Good
 // for large number of rejected values that do not fit within a small range.
 class NegatedBigintValuesUsingHashTable final : public Filter {
@@ -1110,6 +1223,18 @@ class NegatedBigintValuesUsingBitmask final : public Filter {
     return !nonNegated_->testInt64(value);
   }
 
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t> x) const final {
+    return ~nonNegated_->testValues(x);
+  }
+
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t> x) const final {
+    return ~nonNegated_->testValues(x);
+  }
+
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t> x) const final {
+    return ~nonNegated_->testValues(x);
+  }
+
   bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
 
   std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
@@ -1683,6 +1808,8 @@ class BytesValues final : public Filter {
     for (const auto& value : values) {
       lengths_.insert(value.size());
       values_.insert(value);
+      const auto bit = prefixBloomBit(value.data(), value.size());
+      prefixBloom_[bit / 64] |= 1ULL << (bit % 64);
     }
 
     lower_ = *std::min_element(values_.begin(), values_.end());
@@ -1694,7 +1821,8 @@ class BytesValues final : public Filter {
         lower_(other.lower_),
         upper_(other.upper_),
         values_(other.values_),
-        lengths_(other.lengths_) {}
+        lengths_(other.lengths_),
+        prefixBloom_(other.prefixBloom_) {}
 
   folly::dynamic serialize() const override;
 
@@ -1714,8 +1842,14 @@ class BytesValues final : public Filter {
   }
 
   bool testBytes(const char* value, int32_t length) const final {
+    // Most values not in a long list are rejected by the bloom filter on
+    // the prefix without hashing the whole value.
+    const auto bit = prefixBloomBit(value, length);
+    if ((prefixBloom_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
     return lengths_.contains(length) &&
-        values_.contains(std::string(value, length));
+        values_.find(std::string_view(value, length)) != values_.end();
   }
 
   bool testBytesRange(
@@ -1732,10 +1866,21 @@ class BytesValues final : public Filter {
   bool testingEquals(const Filter& other) const final;
 
  private:
+  static constexpr uint32_t kPrefixBloomBits = 4096;
+
+  // Returns the bit of 'prefixBloom_' for the length and the first 8 bytes
+  // of a value.
+  static uint32_t prefixBloomBit(const char* value, int32_t length) {
+    const auto prefix = bits::loadPartialWord(
+        reinterpret_cast<const uint8_t*>(value), std::min(length, 8));
+    return bits::hashMix(prefix, length) % kPrefixBloomBits;
+  }
+
   std::string lower_;
   std::string upper_;
   folly::F14FastSet<std::string> values_;
   folly::F14FastSet<uint32_t> lengths_;
+  std::array<uint64_t, kPrefixBloomBits / 64> prefixBloom_{};
 };
 
 /// Represents a combination of two of more range filters on integral types with
@@ -1761,6 +1906,18 @@ class BigintMultiRange final : public Filter {
 
   bool testInt64(int64_t value) const final;
 
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t> x) const final {
+    return testRanges(x);
+  }
+
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t> x) const final {
+    return testRanges(x);
+  }
+
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t> x) const final {
+    return testRanges(x);
+  }
+
   bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
 
   std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
@@ -1782,6 +1939,22 @@ class BigintMultiRange final : public Filter {
   bool testingEquals(const Filter& other) const final;
 
  private:
+  // Up to this many ranges are tested on a batch of values in SIMD. More
+  // ranges are binary searched one value at a time.
+  static constexpr size_t kMaxSimdRanges = 8;
+
+  template <typename T>
+  xsimd::batch_bool<T> testRanges(xsimd::batch<T> x) const {
+    if (ranges_.size() > kMaxSimdRanges) {
+      return Filter::testValues(x);
+    }
+    auto result = ranges_[0]->testValues(x);
+    for (auto i = 1; i < ranges_.size(); ++i) {
+      result = result | ranges_[i]->testValues(x);
+    }
+    return result;
+  }
+
   const std::vector<std::unique_ptr<BigintRange>> ranges_;
   std::vector<int64_t> lowerBounds_;
 };
@@ -1870,6 +2043,14 @@ class MultiRange final : public Filter {
 
   bool testFloat(float value) const final;
 
+  xsimd::batch_bool<double> testValues(xsimd::batch<double> x) const final {
+    return testFloatingPoints(x);
+  }
+
+  xsimd::batch_bool<float> testValues(xsimd::batch<float> x) const final {
+    return testFloatingPoints(x);
+  }
+
   bool testBytes(const char* value, int32_t length) const final;
 
   bool testLength(int32_t length) const final;
@@ -1894,6 +2075,18 @@ class MultiRange final : public Filter {
   bool testingEquals(const Filter& other) const final;
 
  private:
+  // Values pass if any of 'filters_' passes them. NaNs pass if
+  // 'nanAllowed_' without testing 'filters_'.
+  template <typename T>
+  xsimd::batch_bool<T> testFloatingPoints(xsimd::batch<T> x) const {
+    auto result = filters_[0]->testValues(x);
+    for (auto i = 1; i < filters_.size(); ++i) {
+      result = result | filters_[i]->testValues(x);
+    }
+    auto isNan = x != x;
+    return nanAllowed_ ? result | isNan : result & ~isNan;
+  }
+
   const std::vector<std::unique_ptr<Filter>> filters_;
   const bool nanAllowed_;
 };
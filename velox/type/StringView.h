@@ -17,6 +17,7 @@
 #pragma once
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -176,6 +177,26 @@ struct StringView {
     return (result != 0) ? result : size_ - other.size_;
   }
 
+  // Returns the result of compare() if it is decided by the sizes and the
+  // inlined parts of 'this' and 'other', i.e. the prefix or the whole string
+  // if inline. Returns std::nullopt if the out of line data must be compared.
+  // Does not dereference data(), so this works for views whose data is not
+  // contiguous, e.g. strings in a HashStringAllocator.
+  std::optional<int32_t> compareInlined(const StringView& other) const {
+    if (prefixAsInt() != other.prefixAsInt()) {
+      return memcmp(prefix_, other.prefix_, kPrefixSize);
+    }
+    int32_t size = std::min(size_, other.size_) - kPrefixSize;
+    if (size <= 0) {
+      return size_ - other.size_;
+    }
+    if (isInline() && other.isInline()) {
+      int32_t result = memcmp(value_.inlined, other.value_.inlined, size);
+      return (result != 0) ? result : size_ - other.size_;
+    }
+    return std::nullopt;
+  }
+
   bool operator<(const StringView& other) const {
     return compare(other) < 0;
   }
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/type/Timestamp.h"
+#include <array>
+#include <atomic>
 #include <chrono>
 #include "velox/common/base/Exceptions.h"
 #include "velox/external/date/tz.h"
@@ -33,6 +35,36 @@ inline int64_t getPrestoTZOffsetInSeconds(int16_t tzID) {
   return ((tzID <= 840) ? (tzID - 841) : (tzID - 840)) * 60;
 }
 
+// Magic number -2^39 + 24*3600. This number and any number lower than that
+// will cause time_zone::to_sys() to SIGABRT. We don't want that to happen.
+constexpr int64_t kMinToGMTSeconds = -1096193779200l + 86400l;
+
+// Upper bound of the change of the offset of a time zone at one transition.
+// Local times at least this far from the transitions of their interval are
+// neither skipped nor repeated, so they map to GMT with the offset of the
+// interval.
+constexpr int64_t kMaxOffsetChangeSeconds = 2 * 86400;
+
+// Largest id in TimeZoneDatabase.cpp.
+constexpr int16_t kMaxTimeZoneID = 2230;
+
+// Returns the zone of a Presto time zone id that is not a fixed offset. The
+// zones are looked up by name once per id.
+const date::time_zone* locateZone(int16_t tzID) {
+  static std::array<std::atomic<const date::time_zone*>, kMaxTimeZoneID + 1>
+      zones{};
+  if (tzID < 0 || tzID > kMaxTimeZoneID) {
+    return date::locate_zone(util::getTimeZoneName(tzID));
+  }
+  auto* zone = zones[tzID].load(std::memory_order_acquire);
+  if (zone == nullptr) {
+    // Zones are never freed, so racing threads store the same pointer.
+    zone = date::locate_zone(util::getTimeZoneName(tzID));
+    zones[tzID].store(zone, std::memory_order_release);
+  }
+  return zone;
+}
+
 } // namespace
 
 // static
@@ -45,9 +77,7 @@ Timestamp Timestamp::now() {
 }
 
 void Timestamp::toGMT(const date::time_zone& zone) {
-  // Magic number -2^39 + 24*3600. This number and any number lower than that
-  // will cause time_zone::to_sys() to SIGABRT. We don't want that to happen.
-  if (seconds_ <= (-1096193779200l + 86400l)) {
+  if (seconds_ <= kMinToGMTSeconds) {
     VELOX_UNSUPPORTED(
         "Timestamp out of bound for time zone adjustment {} seconds", seconds_);
   }
@@ -65,7 +95,7 @@ void Timestamp::toGMT(int16_t tzID) {
     seconds_ -= getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toGMT(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toGMT(*locateZone(tzID));
   }
 }
 
@@ -83,7 +113,80 @@ void Timestamp::toTimezone(int16_t tzID) {
     seconds_ += getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toTimezone(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toTimezone(*locateZone(tzID));
+  }
+}
+
+void TimeZoneConverter::loadInterval(
+    const date::time_zone& zone,
+    int64_t seconds) {
+  const auto info =
+      zone.get_info(date::sys_seconds{std::chrono::seconds(seconds)});
+  zone_ = &zone;
+  begin_ = info.begin.time_since_epoch().count();
+  end_ = info.end.time_since_epoch().count();
+  offset_ = info.offset.count();
+}
+
+void TimeZoneConverter::toTimezone(
+    Timestamp& timestamp,
+    const date::time_zone& zone) {
+  const auto seconds = timestamp.getSeconds();
+  if (&zone != zone_ || seconds < begin_ || seconds >= end_) {
+    loadInterval(zone, seconds);
+  }
+  timestamp = Timestamp(seconds + offset_, timestamp.getNanos());
+}
+
+void TimeZoneConverter::toTimezone(Timestamp& timestamp, int16_t tzID) {
+  if (tzID <= 1680) {
+    timestamp.toTimezone(tzID);
+  } else {
+    toTimezone(timestamp, *locateZone(tzID));
+  }
+}
+
+void TimeZoneConverter::toGMT(
+    Timestamp& timestamp,
+    const date::time_zone& zone) {
+  const auto localSeconds = timestamp.getSeconds();
+  if (&zone == zone_ && localSeconds > kMinToGMTSeconds) {
+    const auto seconds = localSeconds - offset_;
+    if (seconds >= begin_ + kMaxOffsetChangeSeconds &&
+        seconds < end_ - kMaxOffsetChangeSeconds) {
+      timestamp = Timestamp(seconds, timestamp.getNanos());
+      return;
+    }
+  }
+  // Near a transition a local time may be skipped or repeated. Leaves these
+  // to time_zone::to_sys().
+  timestamp.toGMT(zone);
+  loadInterval(zone, timestamp.getSeconds());
+}
+
+void TimeZoneConverter::toGMT(Timestamp& timestamp, int16_t tzID) {
+  if (tzID <= 1680) {
+    timestamp.toGMT(tzID);
+  } else {
+    toGMT(timestamp, *locateZone(tzID));
+  }
+}
+
+void TimeZoneConverter::toTimezone(
+    Timestamp* timestamps,
+    int32_t size,
+    const date::time_zone& zone) {
+  for (auto i = 0; i < size; ++i) {
+    toTimezone(timestamps[i], zone);
+  }
+}
+
+void TimeZoneConverter::toGMT(
+    Timestamp* timestamps,
+    int32_t size,
+    const date::time_zone& zone) {
+  for (auto i = 0; i < size; ++i) {
+    toGMT(timestamps[i], zone);
   }
 }
 
@@ -191,6 +191,47 @@ struct Timestamp {
   uint64_t nanos_;
 };
 
+/// Converts timestamps between GMT and time zones. Remembers the interval
+/// between two transitions of the zone that contains the last converted
+/// timestamp. Timestamps in the same interval, e.g. sorted or clustered runs
+/// in one zone, are then converted without searching the transitions of the
+/// zone. Not thread safe.
+class TimeZoneConverter {
+ public:
+  /// Same as 'timestamp.toTimezone(zone)'.
+  void toTimezone(Timestamp& timestamp, const date::time_zone& zone);
+
+  /// Same as 'timestamp.toTimezone(tzID)'.
+  void toTimezone(Timestamp& timestamp, int16_t tzID);
+
+  /// Same as 'timestamp.toGMT(zone)'.
+  void toGMT(Timestamp& timestamp, const date::time_zone& zone);
+
+  /// Same as 'timestamp.toGMT(tzID)'.
+  void toGMT(Timestamp& timestamp, int16_t tzID);
+
+  /// Converts 'size' GMT timestamps in place to the time in 'zone'.
+  void
+  toTimezone(Timestamp* timestamps, int32_t size, const date::time_zone& zone);
+
+  /// Converts 'size' timestamps in 'zone' in place to GMT.
+  void toGMT(Timestamp* timestamps, int32_t size, const date::time_zone& zone);
+
+ private:
+  // Sets the interval to the one of 'zone' that contains 'seconds' since
+  // epoch in GMT.
+  void loadInterval(const date::time_zone& zone, int64_t seconds);
+
+  // Zone of the interval. nullptr until the first conversion.
+  const date::time_zone* zone_{nullptr};
+  // GMT seconds since epoch of the first and after the last second of the
+  // interval.
+  int64_t begin_{0};
+  int64_t end_{0};
+  // Seconds from GMT to the time in 'zone_' in the interval.
+  int64_t offset_{0};
+};
+
 void parseTo(folly::StringPiece in, ::facebook::velox::Timestamp& out);
 
 template <typename T>
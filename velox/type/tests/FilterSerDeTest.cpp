@@ -80,7 +80,15 @@ TEST_F(FilterSerDeTest, valuesFilters) {
       strValues.emplace_back(std::to_string(num));
     }
 
+    auto bloomFilter = std::make_shared<BloomFilter<>>();
+    bloomFilter->reset(values.size());
+    for (auto value : values) {
+      bloomFilter->insert(folly::hasher<int64_t>()(value));
+    }
+
     for (auto nullAllowed : {false, true}) {
+      testSerde(
+          BigintValuesUsingBloomFilter(lower, upper, bloomFilter, nullAllowed));
       testSerde(BigintValuesUsingHashTable(lower, upper, values, nullAllowed));
       testSerde(BigintValuesUsingBitmask(lower, upper, values, nullAllowed));
       testSerde(
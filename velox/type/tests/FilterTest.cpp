@@ -452,6 +452,76 @@ TEST(FilterTest, bigintValuesUsingBitmask) {
   EXPECT_FALSE(filter->testInt64Range(11, 11, false));
   EXPECT_FALSE(filter->testInt64Range(-10, -5, false));
   EXPECT_FALSE(filter->testInt64Range(1234, 2000, false));
+
+  auto testInt64 = [&](int64_t x) { return filter->testInt64(x); };
+  int64_t n4[] = {1, 2, 1000, INT64_MAX};
+  checkSimd(filter.get(), n4, testInt64);
+  int32_t n8[] = {2, 1, 1000, -1000, 100, 10, 0, 1111};
+  checkSimd(filter.get(), n8, testInt64);
+  int16_t n16[] = {
+      2, 1, 1000, -1000, 100, 10, 0, 1111, 2, 1, 1000, -1000, 1, 1, 0, 999};
+  checkSimd(filter.get(), n16, testInt64);
+  auto negated = createNegatedBigintValues({1, 6, 1000, 8, 9, 100, 10}, false);
+  ASSERT_TRUE(dynamic_cast<NegatedBigintValuesUsingBitmask*>(negated.get()));
+  checkSimd(
+      negated.get(), n4, [&](int64_t x) { return negated->testInt64(x); });
+  checkSimd(
+      negated.get(), n8, [&](int64_t x) { return negated->testInt64(x); });
+}
+
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1'000);
+  for (auto i = 0; i < 1'000; ++i) {
+    bloomFilter->insert(folly::hasher<int64_t>()(i * 1'000'003));
+  }
+  auto filter = std::make_unique<BigintValuesUsingBloomFilter>(
+      0, 999 * 1'000'003, bloomFilter, false);
+
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(filter->testInt64(i * 1'000'003));
+    numFalsePositives += filter->testInt64(i * 1'000'003 + 1);
+  }
+  // About 2% false positives with 2 bytes per value.
+  EXPECT_LT(numFalsePositives, 100);
+
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-1'000'003));
+  EXPECT_FALSE(filter->testInt64(1'000 * 1'000'003));
+
+  EXPECT_TRUE(filter->testInt64Range(5, 50, false));
+  EXPECT_TRUE(filter->testInt64Range(1'000'003, 1'000'003, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -5, false));
+  EXPECT_FALSE(filter->testInt64Range(
+      1'000 * 1'000'003, 2'000 * 1'000'003LL, false));
+
+  // Merging with a range narrows the range of the Bloom filter.
+  auto merged = filter->mergeWith(
+      std::make_unique<BigintRange>(1'000'003, 10 * 1'000'003, false).get());
+  ASSERT_EQ(FilterKind::kBigintValuesUsingBloomFilter, merged->kind());
+  EXPECT_FALSE(merged->testInt64(0));
+  EXPECT_TRUE(merged->testInt64(1'000'003));
+  EXPECT_TRUE(merged->testInt64(10 * 1'000'003));
+  EXPECT_FALSE(merged->testInt64(11 * 1'000'003));
+
+  // Merging with an IN-list keeps the values that pass both.
+  auto values = createBigintValues({0, 1, 2 * 1'000'003, -1'000'003}, false);
+  merged = filter->mergeWith(values.get());
+  EXPECT_TRUE(merged->testInt64(0));
+  EXPECT_TRUE(merged->testInt64(2 * 1'000'003));
+  EXPECT_FALSE(merged->testInt64(-1'000'003));
+  EXPECT_FALSE(merged->testInt64(1'000'003));
+  ASSERT_EQ(merged->kind(), values->mergeWith(filter.get())->kind());
+
+  // Merging with a filter that cannot be narrowed keeps the exact filter.
+  auto negated = std::make_unique<NegatedBigintRange>(0, 10, true);
+  merged = filter->mergeWith(negated.get());
+  EXPECT_EQ(FilterKind::kNegatedBigintRange, merged->kind());
+  EXPECT_FALSE(merged->testNull());
+  EXPECT_EQ(
+      FilterKind::kNegatedBigintRange,
+      negated->mergeWith(filter.get())->kind());
 }
 
 TEST(FilterTest, negatedBigintValuesUsingBitmask) {
@@ -590,6 +660,15 @@ TEST(FilterTest, bigintMultiRange) {
   EXPECT_TRUE(filter->testInt64Range(105, 115, true));
   EXPECT_FALSE(filter->testInt64Range(15, 45, false));
   EXPECT_FALSE(filter->testInt64Range(15, 45, true));
+
+  auto testInt64 = [&](int64_t x) { return filter->testInt64(x); };
+  int64_t n4[] = {0, 5, 110, 121};
+  checkSimd(filter.get(), n4, testInt64);
+  int32_t n8[] = {2, 1, 1000, -1000, 100, 10, 0, 120};
+  checkSimd(filter.get(), n8, testInt64);
+  int16_t n16[] = {
+      2, 1, 1000, -1000, 100, 10, 0, 120, 11, 99, 101, -1, 1, 1, 0, 999};
+  checkSimd(filter.get(), n16, testInt64);
 }
 
 TEST(FilterTest, boolValue) {
@@ -946,6 +1025,31 @@ TEST(FilterTest, bytesValues) {
   EXPECT_FALSE(filter->testBytesRange(std::nullopt, "Banana", false));
 }
 
+TEST(FilterTest, bytesValuesLargeList) {
+  // Values share long prefixes so that the prefix bloom filter passes values
+  // that are then rejected by the set of values.
+  std::vector<std::string> values;
+  for (auto i = 0; i < 1'000; ++i) {
+    values.push_back(fmt::format("common prefix {}", i * 2));
+    values.push_back(std::to_string(i * 2));
+  }
+  auto filter = in(values);
+  for (auto i = 0; i < 1'000; ++i) {
+    for (auto n : {i * 2, i * 2 + 1}) {
+      const bool expected = n % 2 == 0;
+      auto value = fmt::format("common prefix {}", n);
+      EXPECT_EQ(expected, filter->testBytes(value.data(), value.size()))
+          << value;
+      value = std::to_string(n);
+      EXPECT_EQ(expected, filter->testBytes(value.data(), value.size()))
+          << value;
+    }
+  }
+  EXPECT_FALSE(filter->testBytes("", 0));
+  EXPECT_TRUE(filter->clone()->testBytes("1998", 4));
+  EXPECT_FALSE(filter->clone()->testBytes("1999", 4));
+}
+
 TEST(FilterTest, negatedBytesValues) {
   // create a filter
   std::vector<std::string> values(
@@ -1034,6 +1138,9 @@ TEST(FilterTest, multiRange) {
   EXPECT_FALSE(filter->testDouble(std::nan("nan")));
   EXPECT_FALSE(filter->testDouble(1.2));
 
+  double d4[] = {1.1, 1.2, 1.3, std::nan("nan")};
+  checkSimd(filter.get(), d4, [&](double x) { return filter->testDouble(x); });
+
   filter = orFilter(lessThanFloat(1.2), greaterThanFloat(1.2));
 
   EXPECT_FALSE(filter->testNull());
@@ -1042,6 +1149,9 @@ TEST(FilterTest, multiRange) {
   EXPECT_TRUE(filter->testFloat(1.3f));
   EXPECT_FALSE(filter->testFloat(std::nanf("nan")));
 
+  float f8[] = {1.1, 1.2, 1.3, std::nanf("nan"), -1, 1.2, 100, 0};
+  checkSimd(filter.get(), f8, [&](float x) { return filter->testFloat(x); });
+
   // != ''
   filter = orFilter(lessThan(""), greaterThan(""));
   EXPECT_FALSE(filter->testBytes(nullptr, 0));
@@ -1077,6 +1187,8 @@ TEST(FilterTest, multiRangeWithNaNs) {
   EXPECT_FALSE(filter->testFloat(1.3f));
   EXPECT_TRUE(filter->testFloat(1.4f));
   EXPECT_TRUE(filter->testFloat(1.1f));
+  float f8[] = {1.1, 1.2, 1.3, std::nanf("nan"), -1, 1.25, 100, 0};
+  checkSimd(filter.get(), f8, [&](float x) { return filter->testFloat(x); });
 
   filter = orFilter(lessThanDouble(1.2), greaterThanDouble(1.3), false, true);
   EXPECT_TRUE(filter->testDouble(std::nan("nan")));
@@ -156,3 +156,30 @@ TEST(StringView, negativeSizes) {
   EXPECT_THROW(StringView("abc", -10), VeloxException);
   EXPECT_NO_THROW(StringView(nullptr, 0));
 }
+
+TEST(StringView, compareInlined) {
+  auto sign = [](int32_t value) { return (value > 0) - (value < 0); };
+  auto expectDecided = [&](const char* left, const char* right) {
+    StringView leftView(left);
+    StringView rightView(right);
+    auto result = leftView.compareInlined(rightView);
+    ASSERT_TRUE(result.has_value()) << left << " " << right;
+    ASSERT_EQ(sign(leftView.compare(rightView)), sign(result.value()))
+        << left << " " << right;
+  };
+
+  // Inline strings and strings differing in the prefix.
+  expectDecided("abc", "abd");
+  expectDecided("abc", "abcd");
+  expectDecided("abcdefgh", "abcdefgi");
+  expectDecided("abcdefghijkl", "abcdefghijkl");
+  expectDecided("abcdefghijklmnop", "abceefghijklmnop");
+  expectDecided("abcd", "abcdefghijklmnop");
+  expectDecided("abcdefghijklmnop", "ab");
+
+  // Out of line strings with the same prefix need their data.
+  StringView left("abcdefghijklmnop");
+  StringView right("abcdefghijklmnoq");
+  ASSERT_FALSE(left.compareInlined(right).has_value());
+  ASSERT_FALSE(left.compareInlined(StringView("abcdefgh")).has_value());
+}
@@ -17,7 +17,9 @@
 #include <gtest/gtest.h>
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/external/date/tz.h"
 #include "velox/type/Timestamp.h"
+#include "velox/type/tz/TimeZoneMap.h"
 
 namespace facebook::velox {
 namespace {
@@ -137,5 +139,74 @@ TEST(TimestampTest, now) {
   EXPECT_GE(expectedEpochMs, now.toMillis());
 }
 
+TEST(TimestampTest, timeZoneConverter) {
+  const auto* zone = date::locate_zone("America/Los_Angeles");
+  const auto tzID = util::getTimeZoneID("America/Los_Angeles");
+  TimeZoneConverter converter;
+  auto expectSame = [&](int64_t seconds) {
+    Timestamp expected(seconds, 123);
+    expected.toTimezone(*zone);
+    Timestamp actual(seconds, 123);
+    converter.toTimezone(actual, *zone);
+    EXPECT_EQ(actual, expected) << seconds;
+    actual = Timestamp(seconds, 123);
+    converter.toTimezone(actual, tzID);
+    EXPECT_EQ(actual, expected) << seconds;
+
+    // Local times in the hours skipped or repeated at the transitions map to
+    // the later offset.
+    expected = Timestamp(seconds, 123);
+    expected.toGMT(*zone);
+    actual = Timestamp(seconds, 123);
+    converter.toGMT(actual, *zone);
+    EXPECT_EQ(actual, expected) << seconds;
+    actual = Timestamp(seconds, 123);
+    converter.toGMT(actual, tzID);
+    EXPECT_EQ(actual, expected) << seconds;
+  };
+
+  // Every 10 minutes over two years, crossing daylight saving time
+  // transitions, then the same in an order that jumps between intervals.
+  const int64_t begin = 1'640'995'200; // 2022-01-01
+  const int64_t end = begin + 2 * 365 * 86'400;
+  for (auto seconds = begin; seconds < end; seconds += 600) {
+    expectSame(seconds);
+  }
+  for (auto i = 0; i < 10'000; ++i) {
+    expectSame(begin + (i * 7'919'993L) % (end - begin));
+  }
+
+  std::vector<Timestamp> timestamps;
+  for (auto seconds = begin; seconds < end; seconds += 3'599) {
+    timestamps.emplace_back(seconds, 0);
+  }
+  auto converted = timestamps;
+  converter.toTimezone(converted.data(), converted.size(), *zone);
+  for (auto i = 0; i < timestamps.size(); ++i) {
+    auto expected = timestamps[i];
+    expected.toTimezone(*zone);
+    EXPECT_EQ(converted[i], expected);
+  }
+  converter.toGMT(converted.data(), converted.size(), *zone);
+  for (auto i = 0; i < timestamps.size(); ++i) {
+    auto expected = timestamps[i];
+    expected.toTimezone(*zone);
+    expected.toGMT(*zone);
+    EXPECT_EQ(converted[i], expected);
+  }
+
+  // Fixed offset ids.
+  Timestamp timestamp(begin, 0);
+  converter.toTimezone(timestamp, util::getTimeZoneID("+01:00"));
+  EXPECT_EQ(timestamp, Timestamp(begin + 3'600, 0));
+  converter.toGMT(timestamp, util::getTimeZoneID("+01:00"));
+  EXPECT_EQ(timestamp, Timestamp(begin, 0));
+
+  timestamp = Timestamp(-1096193779200L, 0);
+  VELOX_ASSERT_THROW(
+      converter.toGMT(timestamp, *zone),
+      "Timestamp out of bound for time zone adjustment");
+}
+
 } // namespace
 } // namespace facebook::velox
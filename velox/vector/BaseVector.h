@@ -435,6 +435,34 @@ class BaseVector {
     VELOX_UNSUPPORTED("Can only copy into flat or complex vectors");
   }
 
+  // Calls 'func' with each range made by merging consecutive 'ranges' that
+  // are adjacent in both source and target, so that callers copy as few and
+  // as large blocks as possible.
+  template <typename Func>
+  static void forEachCoalescedRange(
+      const folly::Range<const CopyRange*>& ranges,
+      Func func) {
+    if (ranges.empty()) {
+      return;
+    }
+    auto current = ranges[0];
+    for (auto i = 1; i < ranges.size(); ++i) {
+      const auto& next = ranges[i];
+      if (next.sourceIndex == current.sourceIndex + current.count &&
+          next.targetIndex == current.targetIndex + current.count) {
+        current.count += next.count;
+        continue;
+      }
+      if (current.count > 0) {
+        func(current);
+      }
+      current = next;
+    }
+    if (current.count > 0) {
+      func(current);
+    }
+  }
+
   // Construct a zero-copy slice of the vector with the indicated offset and
   // length.
   virtual VectorPtr slice(vector_size_t offset, vector_size_t length) const = 0;
@@ -553,7 +553,11 @@ template <typename Func>
 void DecodedVector::applyToRows(const SelectivityVector* rows, Func&& func)
     const {
   if (rows) {
-    rows->applyToSelected([&](vector_size_t row) { func(row); });
+    rows->applyToSelectedRanges([&](vector_size_t begin, vector_size_t end) {
+      for (auto row = begin; row < end; ++row) {
+        func(row);
+      }
+    });
   } else {
     for (auto i = 0; i < size_; i++) {
       func(i);
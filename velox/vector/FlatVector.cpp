@@ -403,6 +403,13 @@ void FlatVector<StringView>::acquireSharedStringBuffersRecursive(
   }
 }
 
+template <>
+bool FlatVector<StringView>::canShareStringBuffers(
+    const BaseVector& source) const {
+  auto* sourcePool = source.pool();
+  return pool_ == sourcePool || pool_->root() == sourcePool->root();
+}
+
 template <>
 void FlatVector<StringView>::copy(
     const BaseVector* source,
@@ -429,7 +436,7 @@ void FlatVector<StringView>::copy(
 
   auto leaf = source->wrappedVector()->asUnchecked<SimpleVector<StringView>>();
 
-  if (pool_ == leaf->pool()) {
+  if (canShareStringBuffers(*leaf)) {
     // We copy referencing the storage of 'source'.
     copyValuesAndNulls(source, rows, toSourceRow);
     acquireSharedStringBuffers(source);
@@ -478,11 +485,12 @@ void FlatVector<StringView>::copyRanges(
     const BaseVector* source,
     const folly::Range<const CopyRange*>& ranges) {
   auto leaf = source->wrappedVector()->asUnchecked<SimpleVector<StringView>>();
-  if (pool_ == leaf->pool()) {
-    // We copy referencing the storage of 'source'.
-    for (auto& r : ranges) {
+  if (canShareStringBuffers(*leaf)) {
+    // We copy referencing the storage of 'source'. Only the StringView
+    // headers are copied, in one block per run of adjacent ranges.
+    forEachCoalescedRange(ranges, [&](const auto& r) {
       copyValuesAndNulls(source, r.targetIndex, r.sourceIndex, r.count);
-    }
+    });
     acquireSharedStringBuffers(source);
   } else {
     for (auto& r : ranges) {
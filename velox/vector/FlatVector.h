@@ -234,9 +234,10 @@ class FlatVector final : public SimpleVector<T> {
   void copyRanges(
       const BaseVector* source,
       const folly::Range<const BaseVector::CopyRange*>& ranges) override {
-    for (auto& range : ranges) {
-      copy(source, range.targetIndex, range.sourceIndex, range.count);
-    }
+    BaseVector::forEachCoalescedRange(ranges, [&](const auto& range) {
+      copyValuesAndNulls(
+          source, range.targetIndex, range.sourceIndex, range.count);
+    });
   }
 
   void resize(vector_size_t newSize, bool setNotNull = true) override;
@@ -401,6 +402,11 @@ class FlatVector final : public SimpleVector<T> {
   // of its children recursively. The function throws if input encoding is lazy.
   void acquireSharedStringBuffersRecursive(const BaseVector* source);
 
+  // Returns true if 'this' can reference the string buffers of 'source'
+  // instead of copying the strings. This is the case if both belong to the
+  // same memory pool or to pools of the same query.
+  bool canShareStringBuffers(const BaseVector& source) const;
+
   Buffer* getBufferWithSpace(vector_size_t /* unused */) {
     return nullptr;
   }
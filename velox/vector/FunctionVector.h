@@ -31,6 +31,14 @@ class Callable {
 
   virtual bool hasCapture() const = 0;
 
+  /// Returns true if the captures need to be aligned with the rows passed to
+  /// apply() by a 'wrapCapture'. This is false if there are no captures or if
+  /// all the captures are constant, since these have the same value for all
+  /// rows.
+  virtual bool needsWrapCapture() const {
+    return hasCapture();
+  }
+
   /// Applies 'this' to 'args' for 'rows' and returns the result in
   /// '*result'.
   /// @param rows The rows that this callable applies to. It is the element rows
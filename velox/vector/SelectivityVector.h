@@ -339,6 +339,12 @@ class SelectivityVector {
   template <typename Callable>
   bool testSelected(Callable func) const;
 
+  /// Invokes a function on each run of consecutive selected rows in
+  /// order. The function takes the first row of the run and the row after
+  /// its last row. Lets callers use plain loops over dense selections.
+  template <typename Callable>
+  void applyToSelectedRanges(Callable func) const;
+
   friend std::ostream& operator<<(
       std::ostream& os,
       const SelectivityVector& selectivityVector) {
@@ -446,6 +452,17 @@ inline bool SelectivityVector::testSelected(Callable func) const {
   return bits::testSetBits(bits_.data(), begin_, end_, func);
 }
 
+template <typename Callable>
+inline void SelectivityVector::applyToSelectedRanges(Callable func) const {
+  if (isAllSelected()) {
+    if (begin_ < end_) {
+      func(begin_, end_);
+    }
+  } else {
+    bits::forEachSetRange(bits_.data(), begin_, end_, func);
+  }
+}
+
 void translateToInnerRows(
     const SelectivityVector& outerRows,
     const vector_size_t* indices,
@@ -15,6 +15,8 @@
  */
 #include "velox/vector/VectorPool.h"
 
+#include "velox/vector/ComplexVector.h"
+
 namespace facebook::velox {
 
 namespace {
@@ -47,14 +49,73 @@ FOLLY_ALWAYS_INLINE int32_t toCacheIndex(const TypePtr& type) {
 
   return -1;
 }
+
+/// Resets the nulls and string views of a recycled 'vector' and resizes it
+/// and, for a row vector, its children to 'size' to match a vector made by
+/// BaseVector::create().
+void resetForReuse(BaseVector& vector, vector_size_t size) {
+  const auto numReset = std::min<int32_t>(size, vector.size());
+  if (UNLIKELY(vector.rawNulls() != nullptr)) {
+    // This is a recyclable vector, no need to check uniqueness.
+    simd::memset(
+        const_cast<uint64_t*>(vector.rawNulls()),
+        bits::kNotNullByte,
+        bits::roundUp(numReset, 64) / 8);
+  }
+  if (UNLIKELY(
+          vector.isFlatEncoding() &&
+          (vector.typeKind() == TypeKind::VARCHAR ||
+           vector.typeKind() == TypeKind::VARBINARY))) {
+    simd::memset(
+        const_cast<void*>(vector.valuesAsVoid()),
+        0,
+        numReset * sizeof(StringView));
+  }
+  if (vector.size() != size) {
+    vector.resize(size);
+  }
+  if (vector.encoding() == VectorEncoding::Simple::ROW) {
+    for (auto& child : vector.asUnchecked<RowVector>()->children()) {
+      if (child) {
+        resetForReuse(*child, size);
+      }
+    }
+  }
+}
 } // namespace
 
-VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
+VectorPool::TypePool* VectorPool::typePool(const TypePtr& type, bool add) {
   auto cacheIndex = toCacheIndex(type);
-  if (cacheIndex >= 0 && size <= kMaxRecycleSize) {
-    return vectors_[cacheIndex].pop(type, size, *pool_);
+  if (cacheIndex >= 0) {
+    return &vectors_[cacheIndex];
+  }
+  // Other types are matched by identity. Operators make their vectors from
+  // the same output type and equivalent types may differ in child names.
+  for (auto& [cachedType, typePool] : otherTypes_) {
+    if (cachedType.get() == type.get()) {
+      return &typePool;
+    }
+  }
+  if (!add || otherTypes_.size() >= kMaxOtherTypes) {
+    return nullptr;
   }
-  return BaseVector::create(type, size, pool_);
+  otherTypes_.emplace_back(type, TypePool{});
+  return &otherTypes_.back().second;
+}
+
+VectorPtr VectorPool::get(
+    const TypePtr& type,
+    vector_size_t size,
+    memory::MemoryPool* pool) {
+  if (pool == nullptr) {
+    pool = pool_;
+  }
+  if (size <= kMaxRecycleSize) {
+    if (auto* cache = typePool(type, false)) {
+      return cache->pop(type, size, *pool);
+    }
+  }
+  return BaseVector::create(type, size, pool);
 }
 
 bool VectorPool::release(VectorPtr& vector) {
@@ -65,11 +126,11 @@ bool VectorPool::release(VectorPtr& vector) {
     return false;
   }
 
-  auto cacheIndex = toCacheIndex(vector->type());
-  if (cacheIndex < 0) {
+  auto* cache = typePool(vector->type(), true);
+  if (cache == nullptr) {
     return false;
   }
-  return vectors_[cacheIndex].maybePushBack(vector);
+  return cache->maybePushBack(vector);
 }
 
 size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
@@ -84,12 +145,44 @@ size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
   return numReleased;
 }
 
+size_t VectorPool::clear() {
+  size_t numCleared = 0;
+  auto clearTypePool = [&](TypePool& typePool) {
+    for (auto i = 0; i < typePool.size; ++i) {
+      typePool.vectors[i] = nullptr;
+    }
+    numCleared += typePool.size;
+    typePool.size = 0;
+  };
+  for (auto& typePool : vectors_) {
+    clearTypePool(typePool);
+  }
+  for (auto& [type, typePool] : otherTypes_) {
+    clearTypePool(typePool);
+  }
+  return numCleared;
+}
+
 bool VectorPool::TypePool::maybePushBack(VectorPtr& vector) {
   // Check that this is a Flat Vector with an initialized, unique, and mutable
-  // values Buffer and an uninitialized or unique and mutable nulls Buffer.
-  if (!vector->isWritable() || !vector->isFlatEncoding() || !vector->values()) {
+  // values Buffer and an uninitialized or unique and mutable nulls Buffer, or
+  // a row, array or map vector with recursively unique and mutable buffers.
+  if (!vector->isWritable()) {
     return false;
   }
+  switch (vector->encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      if (!vector->values()) {
+        return false;
+      }
+      break;
+    case VectorEncoding::Simple::ROW:
+    case VectorEncoding::Simple::ARRAY:
+    case VectorEncoding::Simple::MAP:
+      break;
+    default:
+      return false;
+  }
   if (size >= kNumPerType) {
     return false;
   }
@@ -105,24 +198,7 @@ VectorPtr VectorPool::TypePool::pop(
     memory::MemoryPool& pool) {
   if (size) {
     auto result = std::move(vectors[--size]);
-    if (UNLIKELY(result->rawNulls() != nullptr)) {
-      // This is a recyclable vector, no need to check uniqueness.
-      simd::memset(
-          const_cast<uint64_t*>(result->rawNulls()),
-          bits::kNotNullByte,
-          bits::roundUp(std::min<int32_t>(vectorSize, result->size()), 64) / 8);
-    }
-    if (UNLIKELY(
-            result->typeKind() == TypeKind::VARCHAR ||
-            result->typeKind() == TypeKind::VARBINARY)) {
-      simd::memset(
-          const_cast<void*>(result->valuesAsVoid()),
-          0,
-          std::min<int32_t>(vectorSize, result->size()) * sizeof(StringView));
-    }
-    if (result->size() != vectorSize) {
-      result->resize(vectorSize);
-    }
+    resetForReuse(*result, vectorSize);
     return result;
   }
   return BaseVector::create(type, vectorSize, &pool);
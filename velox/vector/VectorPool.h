@@ -20,20 +20,30 @@
 
 namespace facebook::velox {
 
-/// A thread-level cache of pre-allocated flat vectors of different types.
-/// Keeps up to 10 recyclable vectors of each type. A vector is
-/// recyclable if it is flat and recursively singly-referenced.
-/// Only singleton built-in types are supported. Decimal types, fixed-size array
-/// type, complex and custom types are not supported. Calling 'get' for an
-/// unsupported type already returns a newly allocated vector. Calling 'release'
-/// for an unsupported type is a no-op.
+/// A thread-level cache of pre-allocated vectors of different types.
+/// Keeps up to 10 recyclable vectors of each type. A vector is recyclable if
+/// it is flat, row, array or map and recursively singly-referenced. Vectors of
+/// singleton built-in types are looked up by type kind. Vectors of other
+/// types, e.g. complex, decimal and custom types, are looked up by the
+/// identity of their type for up to 16 distinct types. Calling 'get' for a
+/// type without cached vectors returns a newly allocated vector. Calling
+/// 'release' for a vector whose type doesn't fit is a no-op. Flat string
+/// vectors keep their first string buffer if small, see
+/// FlatVector<StringView>::prepareForReuse().
+///
+/// Besides the pool of each ExecCtx, a Driver has one pool shared by the
+/// operators of its pipeline, so that a vector released by one operator can
+/// be reused by another.
 class VectorPool {
  public:
   explicit VectorPool(memory::MemoryPool* pool) : pool_{pool} {}
 
   /// Gets a possibly recycled vector of 'type and 'size'. Allocates from
-  /// 'pool_' if no pre-allocated vector or type is a complex type.
-  VectorPtr get(const TypePtr& type, vector_size_t size);
+  /// 'pool', or 'pool_' if 'pool' is null, if no pre-allocated vector.
+  VectorPtr get(
+      const TypePtr& type,
+      vector_size_t size,
+      memory::MemoryPool* pool = nullptr);
 
   /// Moves vector into 'this' if it is flat, recursively singly referenced and
   /// there is space. The function returns true if 'vector' is not null and has
@@ -42,11 +52,17 @@ class VectorPool {
 
   size_t release(std::vector<VectorPtr>& vectors);
 
+  /// Frees all the cached vectors, e.g. to give back memory to the memory
+  /// arbitrator. Returns the number of freed vectors.
+  size_t clear();
+
  private:
   /// Max number of elements for a vector to be recyclable. The larger
   /// the batch the less the win from recycling.
   static constexpr vector_size_t kMaxRecycleSize = 64 * 1024;
   static constexpr int32_t kNumPerType = 10;
+  /// Max number of distinct types in 'otherTypes_'.
+  static constexpr int32_t kMaxOtherTypes = 16;
 
   struct TypePool {
     int32_t size{0};
@@ -65,8 +81,16 @@ class VectorPool {
   static constexpr int32_t kNumCachedVectorTypes =
       static_cast<int32_t>(TypeKind::DATE) + 1;
 
+  /// Returns the cache for 'type'. Adds one for a type that isn't a built-in
+  /// singleton type if 'add' is true and there is space. Returns nullptr if
+  /// there is no cache for 'type'.
+  TypePool* typePool(const TypePtr& type, bool add);
+
   /// Caches of pre-allocated vectors indexed by typeKind.
   std::array<TypePool, kNumCachedVectorTypes> vectors_;
+
+  /// Caches of pre-allocated vectors of the other types.
+  std::vector<std::pair<TypePtr, TypePool>> otherTypes_;
 };
 
 /// A simple vector ptr wrapper with an associated vector pool. It releases
@@ -115,6 +115,11 @@ void VectorStreamGroup::flush(OutputStream* out) {
   serializer_->flush(out);
 }
 
+std::unordered_map<std::string, RuntimeCounter>
+VectorStreamGroup::runtimeStats() {
+  return serializer_->runtimeStats();
+}
+
 // static
 void VectorStreamGroup::estimateSerializedSize(
     VectorPtr vector,
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/buffer/Buffer.h"
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/common/memory/MemoryAllocator.h"
@@ -45,6 +46,12 @@ class VectorSerializer {
 
   /// Write serialized data to 'stream'.
   virtual void flush(OutputStream* stream) = 0;
+
+  /// Returns serde specific statistics, e.g. about compression, for the data
+  /// flushed so far.
+  virtual std::unordered_map<std::string, RuntimeCounter> runtimeStats() {
+    return {};
+  }
 };
 
 class VectorSerde {
@@ -124,6 +131,10 @@ class VectorStreamGroup : public StreamArena {
   // Writes the contents to 'stream' in wire format.
   void flush(OutputStream* stream);
 
+  // Returns the runtime stats of the serializer, see
+  // VectorSerializer::runtimeStats().
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats();
+
   // Reads data in wire format. Returns the RowVector in 'result'.
   static void read(
       ByteStream* source,
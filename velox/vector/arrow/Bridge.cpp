@@ -16,6 +16,8 @@
 
 #include "velox/vector/arrow/Bridge.h"
 
+#include <limits>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CheckedArithmetic.h"
@@ -922,15 +924,24 @@ VectorPtr createStringFlatVector(
   bool shouldAcquireStringBuffer = false;
 
   for (size_t i = 0; i < length; ++i) {
-    rawStringViews[i] =
-        StringView(values + offsets[i], offsets[i + 1] - offsets[i]);
+    const auto size = offsets[i + 1] - offsets[i];
+    if constexpr (sizeof(TOffset) > sizeof(int32_t)) {
+      VELOX_USER_CHECK_LE(
+          size,
+          std::numeric_limits<int32_t>::max(),
+          "Large string of {} bytes does not fit in a StringView.",
+          size);
+    }
+    rawStringViews[i] = StringView(values + offsets[i], size);
     shouldAcquireStringBuffer |= !rawStringViews[i].isInline();
   }
 
+  // The StringViews point into the Arrow values buffer, which is shared with
+  // the vector instead of copied. 'offsets' has 'length' + 1 entries, the last
+  // of which is the end of the values buffer.
   std::vector<BufferPtr> stringViewBuffers;
   if (shouldAcquireStringBuffer) {
-    stringViewBuffers.emplace_back(
-        wrapInBufferView(values, offsets[length + 1]));
+    stringViewBuffers.emplace_back(wrapInBufferView(values, offsets[length]));
   }
 
   return std::make_shared<FlatVector<StringView>>(
@@ -1050,6 +1061,28 @@ MapVectorPtr createMapVector(
       optionalNullCount(arrowArray.null_count));
 }
 
+// Copies the 'TIndex' dictionary indices of 'arrowArray' into Velox int32
+// indices. Only int32 indices can be shared with the Arrow buffer.
+template <typename TIndex>
+BufferPtr widenDictionaryIndices(
+    const ArrowArray& arrowArray,
+    memory::MemoryPool* pool) {
+  auto indices =
+      AlignedBuffer::allocate<vector_size_t>(arrowArray.length, pool);
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  auto arrowIndices = static_cast<const TIndex*>(arrowArray.buffers[1]);
+  for (int64_t i = 0; i < arrowArray.length; ++i) {
+    if constexpr (sizeof(TIndex) > sizeof(vector_size_t)) {
+      VELOX_USER_CHECK_LE(
+          arrowIndices[i],
+          std::numeric_limits<vector_size_t>::max(),
+          "Dictionary index out of range for arrow conversion.");
+    }
+    rawIndices[i] = arrowIndices[i];
+  }
+  return indices;
+}
+
 VectorPtr createDictionaryVector(
     memory::MemoryPool* pool,
     const TypePtr& indexType,
@@ -1061,12 +1094,27 @@ VectorPtr createDictionaryVector(
   VELOX_CHECK_EQ(arrowArray.n_buffers, 2);
   VELOX_CHECK_NOT_NULL(arrowArray.dictionary);
   static_assert(sizeof(vector_size_t) == sizeof(int32_t));
-  VELOX_CHECK_EQ(
-      indexType->kind(),
-      TypeKind::INTEGER,
-      "Only int32 indices are supported for arrow conversion");
-  auto indices = wrapInBufferView(
-      arrowArray.buffers[1], arrowArray.length * sizeof(vector_size_t));
+  BufferPtr indices;
+  switch (indexType->kind()) {
+    case TypeKind::INTEGER:
+      // Same layout as Velox indices, so these are shared without a copy.
+      indices = wrapInBufferView(
+          arrowArray.buffers[1], arrowArray.length * sizeof(vector_size_t));
+      break;
+    case TypeKind::TINYINT:
+      indices = widenDictionaryIndices<int8_t>(arrowArray, pool);
+      break;
+    case TypeKind::SMALLINT:
+      indices = widenDictionaryIndices<int16_t>(arrowArray, pool);
+      break;
+    case TypeKind::BIGINT:
+      indices = widenDictionaryIndices<int64_t>(arrowArray, pool);
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported dictionary index type for arrow conversion: {}",
+          indexType->toString());
+  }
   auto type = importFromArrow(*arrowSchema.dictionary);
   auto wrapped = importFromArrowImpl(
       *arrowSchema.dictionary, *arrowArray.dictionary, pool, isViewer);
@@ -1123,6 +1171,18 @@ VectorPtr importFromArrowImpl(
         arrowArray.n_buffers,
         3,
         "Expecting three buffers as input for string types.");
+    // Large utf-8 and large binary have 64 bit offsets.
+    if (arrowSchema.format[0] == 'U' || arrowSchema.format[0] == 'Z') {
+      return createStringFlatVector(
+          pool,
+          type,
+          nulls,
+          arrowArray.length,
+          static_cast<const int64_t*>(arrowArray.buffers[1]), // offsets
+          static_cast<const char*>(arrowArray.buffers[2]), // values
+          arrowArray.null_count,
+          wrapInBufferView);
+    }
     return createStringFlatVector(
         pool,
         type,
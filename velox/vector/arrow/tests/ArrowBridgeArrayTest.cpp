@@ -1074,6 +1074,88 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
     });
   }
 
+  // Imports 'array' and releases the Arrow structures if they are not owned
+  // by the result.
+  template <typename F>
+  void testArrowImportFromArray(
+      const arrow::Array& array,
+      F validateVector) {
+    ArrowSchema schema;
+    ArrowArray data;
+    ASSERT_OK(arrow::ExportType(*array.type(), &schema));
+    ASSERT_OK(arrow::ExportArray(array, &data));
+    auto vec = importFromArrow(schema, data, pool_.get());
+    validateVector(*vec);
+    if (isViewer()) {
+      schema.release(&schema);
+      data.release(&data);
+    }
+  }
+
+  void testImportLargeString() {
+    arrow::LargeStringBuilder b;
+    for (int i = 0; i < 50; ++i) {
+      if (i % 5 == 0) {
+        ASSERT_OK(b.AppendNull());
+      } else {
+        ASSERT_OK(b.Append(fmt::format("large string value {}", i)));
+      }
+    }
+    ASSERT_OK_AND_ASSIGN(auto array, b.Finish());
+    auto values = array->data()->buffers[2];
+    testArrowImportFromArray(*array, [&](const BaseVector& vec) {
+      ASSERT_EQ(*vec.type(), *VARCHAR());
+      ASSERT_EQ(vec.size(), 50);
+      auto flat = vec.asFlatVector<StringView>();
+      for (int i = 0; i < 50; ++i) {
+        if (i % 5 == 0) {
+          EXPECT_TRUE(vec.isNullAt(i));
+          continue;
+        }
+        auto value = flat->valueAt(i);
+        EXPECT_EQ(value.str(), fmt::format("large string value {}", i));
+        // Not inlined, so this points into the Arrow values buffer.
+        EXPECT_GE(value.data(), (const char*)values->data());
+        EXPECT_LT(value.data(), (const char*)values->data() + values->size());
+      }
+    });
+  }
+
+  void testImportDictionaryIndices() {
+    auto dictionary = arrow::ArrayFromJSON(
+        arrow::utf8(), R"(["apple", "banana", "cherry", "durian"])");
+    for (auto& indexType :
+         {arrow::int8(), arrow::int16(), arrow::int32(), arrow::int64()}) {
+      auto indices =
+          arrow::ArrayFromJSON(indexType, "[3, null, 0, 1, 1, 2, null, 3]");
+      ASSERT_OK_AND_ASSIGN(
+          auto array,
+          arrow::DictionaryArray::FromArrays(
+              arrow::dictionary(indexType, arrow::utf8()),
+              indices,
+              dictionary));
+      testArrowImportFromArray(*array, [&](const BaseVector& vec) {
+        ASSERT_EQ(*vec.type(), *VARCHAR());
+        ASSERT_EQ(vec.encoding(), VectorEncoding::Simple::DICTIONARY);
+        auto expected = vectorMaker_.flatVectorNullable<std::string>(
+            {"durian",
+             std::nullopt,
+             "apple",
+             "banana",
+             "banana",
+             "cherry",
+             std::nullopt,
+             "durian"});
+        ASSERT_EQ(vec.size(), expected->size());
+        for (vector_size_t i = 0; i < vec.size(); ++i) {
+          ASSERT_TRUE(expected->equalValueAt(&vec, i, i))
+              << "at " << i << ": " << expected->toString(i) << " vs. "
+              << vec.toString(i);
+        }
+      });
+    }
+  }
+
   void testImportFailures() {
     ArrowSchema arrowSchema;
     ArrowArray arrowArray;
@@ -1177,6 +1259,14 @@ TEST_F(ArrowBridgeArrayImportAsViewerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsViewerTest, largeString) {
+  testImportLargeString();
+}
+
+TEST_F(ArrowBridgeArrayImportAsViewerTest, dictionaryIndices) {
+  testImportDictionaryIndices();
+}
+
 TEST_F(ArrowBridgeArrayImportAsViewerTest, failures) {
   testImportFailures();
 }
@@ -1224,6 +1314,14 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, largeString) {
+  testImportLargeString();
+}
+
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, dictionaryIndices) {
+  testImportDictionaryIndices();
+}
+
 TEST_F(ArrowBridgeArrayImportAsOwnerTest, failures) {
   testImportFailures();
 }
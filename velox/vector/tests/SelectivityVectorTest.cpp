@@ -360,6 +360,28 @@ TEST(SelectivityVectorTest, iterator) {
   EXPECT_EQ(count, bits::countBits(&contiguous[0], 0, 240));
 }
 
+TEST(SelectivityVectorTest, applyToSelectedRanges) {
+  auto ranges = [](const SelectivityVector& rows) {
+    std::vector<std::pair<vector_size_t, vector_size_t>> result;
+    rows.applyToSelectedRanges(
+        [&](auto begin, auto end) { result.emplace_back(begin, end); });
+    return result;
+  };
+  using Ranges = std::vector<std::pair<vector_size_t, vector_size_t>>;
+
+  SelectivityVector rows(1000);
+  EXPECT_EQ(Ranges({{0, 1000}}), ranges(rows));
+
+  rows.setValidRange(100, 300, false);
+  rows.setValid(500, false);
+  rows.setValid(999, false);
+  rows.updateBounds();
+  EXPECT_EQ(Ranges({{0, 100}, {300, 500}, {501, 999}}), ranges(rows));
+
+  rows.clearAll();
+  EXPECT_TRUE(ranges(rows).empty());
+}
+
 TEST(SelectivityVectorTest, resize) {
   SelectivityVector vector(64, false);
   vector.resize(128, /* value */ true);
@@ -99,6 +99,28 @@ TEST_F(VectorPoolTest, limit) {
   ASSERT_EQ(vectorPool.release(vectors), 10);
 }
 
+TEST_F(VectorPoolTest, clear) {
+  VectorPool vectorPool(pool());
+  std::vector<VectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(vectorPool.get(BIGINT(), 1'000));
+  }
+  vectors.push_back(vectorPool.get(VARCHAR(), 1'000));
+  const auto bytesBeforeRelease = pool()->currentBytes();
+  ASSERT_EQ(vectorPool.release(vectors), 4);
+  ASSERT_EQ(pool()->currentBytes(), bytesBeforeRelease);
+
+  ASSERT_EQ(vectorPool.clear(), 4);
+  ASSERT_LT(pool()->currentBytes(), bytesBeforeRelease);
+  ASSERT_EQ(vectorPool.clear(), 0);
+
+  // The pool still recycles after clear.
+  auto vector = vectorPool.get(BIGINT(), 1'000);
+  auto* vectorPtr = vector.get();
+  ASSERT_TRUE(vectorPool.release(vector));
+  ASSERT_EQ(vectorPool.get(BIGINT(), 1'000).get(), vectorPtr);
+}
+
 TEST_F(VectorPoolTest, vectorRecycler) {
   VectorPool vectorPool(pool());
 
@@ -146,4 +168,55 @@ TEST_F(VectorPoolTest, customTypes) {
   ASSERT_EQ(1'000, vector->size());
   ASSERT_TRUE(isJsonType(vector->type()));
 }
+
+TEST_F(VectorPoolTest, complexTypes) {
+  VectorPool vectorPool(pool());
+
+  const auto rowType = ROW({"a", "b"}, {BIGINT(), VARCHAR()});
+  auto vector = vectorPool.get(rowType, 1'000);
+  ASSERT_EQ(1'000, vector->size());
+  auto* vectorPtr = vector.get();
+  ASSERT_TRUE(vectorPool.release(vector));
+
+  // Other types are matched by identity. The children are resized with the
+  // row.
+  ASSERT_NE(
+      vectorPtr,
+      vectorPool.get(ROW({"a", "b"}, {BIGINT(), VARCHAR()}), 2'000).get());
+  auto recycled = vectorPool.get(rowType, 2'000);
+  ASSERT_EQ(vectorPtr, recycled.get());
+  ASSERT_EQ(2'000, recycled->size());
+  auto* row = recycled->as<RowVector>();
+  ASSERT_EQ(2'000, row->childAt(0)->size());
+  ASSERT_EQ(2'000, row->childAt(1)->size());
+  ASSERT_EQ(
+      StringView(), row->childAt(1)->asFlatVector<StringView>()->valueAt(0));
+
+  // A row with a child shared elsewhere is not recyclable.
+  auto child = row->childAt(0);
+  ASSERT_FALSE(vectorPool.release(recycled));
+  child.reset();
+  ASSERT_TRUE(vectorPool.release(recycled));
+
+  auto arrayVector = makeArrayVector<int32_t>({{1, 2}, {3}});
+  VectorPtr array = arrayVector;
+  arrayVector.reset();
+  const auto arrayType = array->type();
+  auto* arrayPtr = array.get();
+  ASSERT_TRUE(vectorPool.release(array));
+  array = vectorPool.get(arrayType, 10);
+  ASSERT_EQ(arrayPtr, array.get());
+  ASSERT_EQ(10, array->size());
+  ASSERT_EQ(0, array->as<ArrayVector>()->sizeAt(0));
+  ASSERT_EQ(0, array->as<ArrayVector>()->elements()->size());
+
+  const auto decimalType = DECIMAL(10, 2);
+  VectorPtr decimal = vectorPool.get(decimalType, 100);
+  auto* decimalPtr = decimal.get();
+  ASSERT_TRUE(vectorPool.release(decimal));
+  ASSERT_NE(decimalPtr, vectorPool.get(DECIMAL(12, 2), 100).get());
+  ASSERT_EQ(decimalPtr, vectorPool.get(decimalType, 100).get());
+
+  ASSERT_EQ(vectorPool.clear(), 1);
+}
 } // namespace facebook::velox::test
@@ -1364,6 +1364,61 @@ TEST_F(VectorTest, setFlatVectorStringView) {
   EXPECT_EQ(newString.size(), flatCopy->stringBuffers()[1]->size());
 }
 
+TEST_F(VectorTest, copyStringsAcrossPools) {
+  const std::string longString = "This string is too long to be inlined";
+  auto source = makeFlatVector<std::string>(
+      100, [&](auto row) { return fmt::format("{} {}", longString, row); });
+  auto sourceFlat = source->asFlatVector<StringView>();
+  ASSERT_EQ(1, sourceFlat->stringBuffers().size());
+
+  // A pool of the same query references the strings of 'source'. Adjacent
+  // ranges are copied as one.
+  auto otherLeaf = rootPool_->addLeafChild("otherLeaf");
+  auto target = BaseVector::create(VARCHAR(), 100, otherLeaf.get());
+  std::vector<BaseVector::CopyRange> ranges;
+  for (auto i = 0; i < 50; ++i) {
+    ranges.push_back({i, i + 50, 1});
+  }
+  for (auto i = 0; i < 50; ++i) {
+    ranges.push_back({i + 50, i, 1});
+  }
+  target->copyRanges(source.get(), ranges);
+  auto targetFlat = target->asFlatVector<StringView>();
+  ASSERT_EQ(1, targetFlat->stringBuffers().size());
+  ASSERT_EQ(
+      sourceFlat->stringBuffers()[0].get(),
+      targetFlat->stringBuffers()[0].get());
+  for (auto i = 0; i < 100; ++i) {
+    ASSERT_EQ(sourceFlat->valueAt(i), targetFlat->valueAt((i + 50) % 100));
+  }
+
+  // A pool of another query gets its own copy of the strings.
+  auto otherRoot = memory::defaultMemoryManager().addRootPool();
+  auto otherQueryLeaf = otherRoot->addLeafChild("otherQueryLeaf");
+  auto copy = BaseVector::create(VARCHAR(), 100, otherQueryLeaf.get());
+  copy->copy(source.get(), 0, 0, 100);
+  auto copyFlat = copy->asFlatVector<StringView>();
+  ASSERT_LE(1, copyFlat->stringBuffers().size());
+  ASSERT_NE(
+      sourceFlat->stringBuffers()[0].get(),
+      copyFlat->stringBuffers()[0].get());
+  test::assertEqualVectors(source, copy);
+}
+
+TEST_F(VectorTest, coalescedCopyRanges) {
+  auto source = makeFlatVector<int64_t>(
+      100, [](auto row) { return row; }, nullEvery(7));
+  auto target = BaseVector::create(BIGINT(), 100, pool());
+  // Adjacent, non-adjacent and empty ranges.
+  std::vector<BaseVector::CopyRange> ranges = {
+      {0, 0, 10}, {10, 10, 20}, {30, 30, 0}, {30, 40, 10}, {40, 30, 10}};
+  target->copyRanges(source.get(), ranges);
+  for (auto i = 0; i < 50; ++i) {
+    const auto sourceRow = i < 30 ? i : (i < 40 ? i + 10 : i - 10);
+    ASSERT_TRUE(target->equalValueAt(source.get(), i, sourceRow)) << i;
+  }
+}
+
 TEST_F(VectorTest, resizeAtConstruction) {
   const size_t realSize = 10;
 